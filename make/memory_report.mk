@@ -0,0 +1,30 @@
+#
+# Static RAM use per subsystem, from the linker map and the symbols of the ELF,
+# see src/utils/memory_report.py.
+#
+
+TARGET_MEMORY    = $(OBJECT_DIR)/$(FORKNAME)_$(TARGET)_memory.txt
+
+CLEAN_ARTIFACTS += $(TARGET_MEMORY)
+
+$(TARGET_MEMORY): $(TARGET_ELF) $(ROOT)/src/utils/memory_report.py
+	$(V1) python3 $(ROOT)/src/utils/memory_report.py $(TARGET_MAP) $(TARGET_ELF) $(NM) > $@
+
+## memory            : write the RAM use per subsystem of the target to obj/
+memory: $(TARGET_MEMORY)
+
+## memory_report     : print the RAM use per subsystem of the target
+memory_report: $(TARGET_MEMORY)
+	$(V0) cat $(TARGET_MEMORY)
+
+TARGETS_MEMORY = $(addsuffix _memory,$(VALID_TARGETS))
+
+## <TARGET>_memory   : print the RAM use per subsystem of one specific target
+$(TARGETS_MEMORY):
+	$(V0) $(MAKE) TARGET=$(subst _memory,,$@) memory_report
+
+## all_memory        : write the RAM use per subsystem of all currently built targets
+all_memory:
+	$(V0) for target in $(CI_TARGETS); do $(MAKE) TARGET=$$target memory || exit 1; done
+
+.PHONY: memory memory_report all_memory $(TARGETS_MEMORY)
@@ -27,6 +27,8 @@ COMMON_SRC = \
             drivers/buttons.c \
             drivers/display.c \
             drivers/display_canvas.c \
+            drivers/dma_buffer.c \
+            drivers/dma_plan.c \
             drivers/dma_reqmap.c \
             drivers/exti.c \
             drivers/io.c \
@@ -62,9 +64,13 @@ COMMON_SRC = \
             msp/msp.c \
             msp/msp_box.c \
             msp/msp_serial.c \
+            msp/msp_settings.c \
             scheduler/scheduler.c \
+            scheduler/profile.c \
+            scheduler/benchmark.c \
             sensors/adcinternal.c \
             sensors/battery.c \
+            sensors/battery_resistance.c \
             sensors/current.c \
             sensors/voltage.c \
             target/config_helper.c \
@@ -75,25 +81,37 @@ COMMON_SRC = \
             drivers/pwm_output.c \
             drivers/rx/rx_spi.c \
             drivers/rx/rx_xn297.c \
+            drivers/rx/rx_ppm.c \
             drivers/rx/rx_pwm.c \
             drivers/serial_softserial.c \
             fc/core.c \
+            fc/loop_timing.c \
+            fc/looptime_check.c \
             fc/rc.c \
             fc/rc_adjustments.c \
             fc/rc_controls.c \
+            fc/rc_curves.c \
             fc/rc_modes.c \
             flight/position.c \
             flight/failsafe.c \
+            flight/flight_state.c \
             flight/gps_rescue.c \
+            flight/governor.c \
             flight/gyroanalyse.c \
+            flight/collective.c \
             flight/imu.c \
             flight/interpolated_setpoint.c \
             flight/mixer.c \
             flight/mixer_tricopter.c \
             flight/pid.c \
+            flight/rescue.c \
             flight/rpm_filter.c \
             flight/servos.c \
             flight/servos_tricopter.c \
+            flight/swash.c \
+            flight/tailmotor.c \
+            flight/vibration.c \
+            flight/sysid.c \
             io/serial_4way.c \
             io/serial_4way_avrootloader.c \
             io/serial_4way_stk500v2.c \
@@ -118,7 +136,9 @@ COMMON_SRC = \
             sensors/boardalignment.c \
             sensors/compass.c \
             sensors/gyro.c \
+            sensors/gyro_bias.c \
             sensors/initialisation.c \
+            sensors/rpm_source.c \
             blackbox/blackbox.c \
             blackbox/blackbox_encoding.c \
             blackbox/blackbox_io.c \
@@ -153,6 +173,8 @@ COMMON_SRC = \
             sensors/barometer.c \
             sensors/rangefinder.c \
             telemetry/telemetry.c \
+            telemetry/snapshot.c \
+            telemetry/schedule.c \
             telemetry/crsf.c \
             telemetry/srxl.c \
             telemetry/frsky_hub.c \
@@ -236,6 +258,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             rx/xbus.c \
             rx/fport.c \
             scheduler/scheduler.c \
+            scheduler/profile.c \
             sensors/acceleration.c \
             sensors/boardalignment.c \
             sensors/gyro.c \
@@ -0,0 +1,43 @@
+#
+# ITCM / DTCM placement profile for the STM32F7 and STM32H7 linker scripts,
+# see src/utils/tcm_profile.py for the profile format.
+#
+# Off unless asked for, the linker scripts in src/link are used as they are:
+#   make TARGET=<target> TCM_PROFILE=yes         the target's tcm_profile.txt, or src/main/target/tcm_profile.txt
+#   make TARGET=<target> TCM_PROFILE=<file>      the given profile
+#
+
+ifneq ($(filter STM32F7 STM32H7,$(TARGET_MCU)),)
+
+ifneq ($(TCM_PROFILE),)
+
+ifeq ($(TCM_PROFILE),yes)
+TCM_PROFILE_FILE := $(firstword $(wildcard $(TARGET_DIR)/tcm_profile.txt) $(SRC_DIR)/target/tcm_profile.txt)
+else
+TCM_PROFILE_FILE := $(TCM_PROFILE)
+endif
+
+TCM_PROFILE_BASE_LD := $(LD_SCRIPT)
+TCM_PROFILE_LD      := $(OBJECT_DIR)/$(TARGET)/$(basename $(notdir $(LD_SCRIPT)))_tcm.ld
+
+LD_SCRIPT        = $(TCM_PROFILE_LD)
+
+CLEAN_ARTIFACTS += $(TCM_PROFILE_LD)
+
+$(TCM_PROFILE_LD): $(TCM_PROFILE_BASE_LD) $(TCM_PROFILE_FILE) $(ROOT)/src/utils/tcm_profile.py
+	$(V1) mkdir -p $(dir $@)
+	$(V1) python3 $(ROOT)/src/utils/tcm_profile.py ld $(TCM_PROFILE_FILE) $(TCM_PROFILE_BASE_LD) $(LINKER_DIR) $@
+
+endif
+
+tcm_report: $(TARGET_ELF)
+	$(V0) python3 $(ROOT)/src/utils/tcm_profile.py report $(TARGET_MAP)
+
+else
+
+tcm_report:
+	@echo "tcm_report is only available for STM32F7 and STM32H7 targets"
+
+endif
+
+.PHONY: tcm_report
@@ -39,6 +39,8 @@
 #include "common/axis.h"
 #include "common/encoding.h"
 #include "common/maths.h"
+#include "common/printf.h"
+#include "common/spsc_queue.h"
 #include "common/time.h"
 #include "common/utils.h"
 
@@ -54,16 +56,20 @@
 
 #include "config/config.h"
 #include "fc/controlrate_profile.h"
+#include "fc/loop_timing.h"
 #include "fc/rc.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
 
+#include "flight/collective.h"
 #include "flight/failsafe.h"
+#include "flight/governor.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
 #include "flight/servos.h"
+#include "flight/vibration.h"
 
 #include "io/beeper.h"
 #include "io/gps.h"
@@ -71,6 +77,8 @@
 
 #include "rx/rx.h"
 
+#include "scheduler/scheduler.h"
+
 #include "sensors/acceleration.h"
 #include "sensors/barometer.h"
 #include "sensors/battery.h"
@@ -86,13 +94,16 @@
 #define DEFAULT_BLACKBOX_DEVICE     BLACKBOX_DEVICE_SERIAL
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 4);
 
 PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
     .p_ratio = 32,
     .device = DEFAULT_BLACKBOX_DEVICE,
     .record_acc = 1,
-    .mode = BLACKBOX_MODE_NORMAL
+    .mode = BLACKBOX_MODE_NORMAL,
+    .fast_denom = 0,
+    .compression = BLACKBOX_COMPRESSION_NONE,
+    .heli_denom = 0,
 );
 
 #define BLACKBOX_SHUTDOWN_TIMEOUT_MILLIS 200
@@ -161,91 +172,243 @@ typedef struct blackboxDeltaFieldDefinition_s {
     uint8_t Ppredict;
     uint8_t Pencode;
     uint8_t condition; // Decide whether this field should appear in the log
+
+    // Where the value is found in blackboxMainState_t
+    uint16_t stateOffset;
+    uint8_t stateType;
 } blackboxDeltaFieldDefinition_t;
 
+typedef enum {
+    BLACKBOX_FIELD_TYPE_ITERATION = 0,  // the loop iteration, not stored in the state
+    BLACKBOX_FIELD_TYPE_U32,
+    BLACKBOX_FIELD_TYPE_S32,
+    BLACKBOX_FIELD_TYPE_U16,
+    BLACKBOX_FIELD_TYPE_S16,
+} blackboxFieldType_e;
+
+#define MAIN_STATE(field, type) .stateOffset = offsetof(blackboxMainState_t, field), .stateType = CONCAT(BLACKBOX_FIELD_TYPE_, type)
+#define FAST_STATE(field, type) .stateOffset = offsetof(blackboxFastState_t, field), .stateType = CONCAT(BLACKBOX_FIELD_TYPE_, type)
+#define HELI_STATE(field, type) .stateOffset = offsetof(blackboxHeliState_t, field), .stateType = CONCAT(BLACKBOX_FIELD_TYPE_, type)
+
+// One field of a main frame, with its condition resolved when the log is started
+typedef struct blackboxFieldOp_s {
+    uint16_t stateOffset;
+    uint8_t stateType;
+    uint8_t predict;
+    uint8_t encode;
+} blackboxFieldOp_t;
+
+// The main frames have a field for up to this many motors, the state has room for all of them
+#define BLACKBOX_MOTOR_FIELD_COUNT 8
+
+typedef struct blackboxMainState_s {
+    uint32_t time;
+
+    int32_t axisPID_P[XYZ_AXIS_COUNT];
+    int32_t axisPID_I[XYZ_AXIS_COUNT];
+    int32_t axisPID_D[XYZ_AXIS_COUNT];
+    int32_t axisPID_F[XYZ_AXIS_COUNT];
+
+    int16_t rcCommand[5];
+    int16_t setpoint[4];
+    int16_t gyroADC[XYZ_AXIS_COUNT];
+    int16_t accADC[XYZ_AXIS_COUNT];
+    int16_t debug[DEBUG16_VALUE_COUNT];
+#ifdef USE_DEBUG_CHANNELS
+    int16_t debugChannel[DEBUG_CHANNEL_COUNT];
+#endif
+#if MAX_SUPPORTED_MOTORS > BLACKBOX_MOTOR_FIELD_COUNT
+    int16_t motor[MAX_SUPPORTED_MOTORS];
+#else
+    int16_t motor[BLACKBOX_MOTOR_FIELD_COUNT];
+#endif
+    int16_t servo[MAX_SUPPORTED_SERVOS];
+
+    uint16_t vbatLatest;
+    int32_t amperageLatest;
+
+#ifdef USE_BARO
+    int32_t BaroAlt;
+#endif
+#ifdef USE_MAG
+    int16_t magADC[XYZ_AXIS_COUNT];
+#endif
+#ifdef USE_RANGEFINDER
+    int32_t surfaceRaw;
+#endif
+    uint16_t rssi;
+    
+    uint16_t headspeed;
+} blackboxMainState_t;
+
+// The high rate gyro and setpoint capture of the fast (F) frames
+typedef struct blackboxFastState_s {
+    uint32_t time;
+
+    int16_t gyroUnfilt[XYZ_AXIS_COUNT];
+    int16_t gyroADC[XYZ_AXIS_COUNT];
+    int16_t setpoint[XYZ_AXIS_COUNT];
+} blackboxFastState_t;
+
+// The rotor and governor state of the heli (R) frames, throttle terms in 1/1000 of full throttle
+typedef struct blackboxHeliState_s {
+    uint16_t govState;
+    uint16_t govSetpoint;
+    int32_t govPidSum;
+    int32_t govI;
+    int32_t govFeedForward;
+    int32_t govTailAssist;
+    int16_t swashRing;          // 1/1000 of the swash ring limit
+    int16_t collective;         // 1/10 percent of the collective throw
+    int16_t collectivePulse;    // 1/10 percent
+    uint16_t vibGyro[3];        // 0.1 deg/s at the main 1x, main 2x and tail 1x harmonics
+    uint16_t vibAcc[3];         // 1/1000 g
+    int16_t vibPhase[3];        // degrees, gyro pitch relative to roll
+} blackboxHeliState_t;
+
 /**
  * Description of the blackbox fields we are writing in our main intra (I) and inter (P) frames. This description is
- * written into the flight log header so the log can be properly interpreted (but these definitions don't actually cause
- * the encoding to happen, we have to encode the flight log ourselves in write{Inter|Intra}frame() in a way that matches
- * the encoding we've promised here).
+ * written into the flight log header so the log can be properly interpreted, and it is compiled into the programs
+ * that write{Inter|Intra}frame() run when logging starts, so a new field only needs a line here and a member in
+ * blackboxMainState_t.
+ *
+ * Consecutive fields with a grouped P-frame encoding (TAG2_3S32, TAG8_4S16, TAG8_8SVB) are packed together.
  */
 static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
     /* loopIteration doesn't appear in P frames since it always increments */
-    {"loopIteration",-1, UNSIGNED, .Ipredict = PREDICT(0),     .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(INC),           .Pencode = FLIGHT_LOG_FIELD_ENCODING_NULL, CONDITION(ALWAYS)},
+    {"loopIteration",-1, UNSIGNED, .Ipredict = PREDICT(0),     .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(INC),           .Pencode = FLIGHT_LOG_FIELD_ENCODING_NULL, CONDITION(ALWAYS), .stateType = BLACKBOX_FIELD_TYPE_ITERATION},
     /* Time advances pretty steadily so the P-frame prediction is a straight line */
-    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(time, U32)},
+    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_P[0], S32)},
+    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_P[1], S32)},
+    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_P[2], S32)},
     /* I terms get special packed encoding in P frames: */
-    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_0)},
-    {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_1)},
-    {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_2)},
-    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), MAIN_STATE(axisPID_I[0], S32)},
+    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), MAIN_STATE(axisPID_I[1], S32)},
+    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), MAIN_STATE(axisPID_I[2], S32)},
+    {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_0), MAIN_STATE(axisPID_D[0], S32)},
+    {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_1), MAIN_STATE(axisPID_D[1], S32)},
+    {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_2), MAIN_STATE(axisPID_D[2], S32)},
+    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_F[0], S32)},
+    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_F[1], S32)},
+    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_F[2], S32)},
     /* rcCommands are encoded together as a group in P-frames, except rcCommand[COLLECTIVE]: */
-    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   4, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(rcCommand[0], S16)},
+    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(rcCommand[1], S16)},
+    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(rcCommand[2], S16)},
+    {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(rcCommand[3], S16)},
+    {"rcCommand",   4, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(rcCommand[4], S16)},
 
     // setpoint - define 4 fields like rcCommand to use the same encoding. setpoint[4] contains the mixer throttle
-    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(setpoint[0], S16)},
+    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(setpoint[1], S16)},
+    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(setpoint[2], S16)},
+    {"setpoint",    3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(setpoint[3], S16)},
 
-    {"vbatLatest",    -1, UNSIGNED, .Ipredict = PREDICT(VBATREF),  .Iencode = ENCODING(NEG_14BIT),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_VBAT},
-    {"amperageLatest",-1, SIGNED,   .Ipredict = PREDICT(0),        .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC},
+    {"vbatLatest",    -1, UNSIGNED, .Ipredict = PREDICT(VBATREF),  .Iencode = ENCODING(NEG_14BIT),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_VBAT, MAIN_STATE(vbatLatest, U16)},
+    {"amperageLatest",-1, SIGNED,   .Ipredict = PREDICT(0),        .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC, MAIN_STATE(amperageLatest, S32)},
 
 #ifdef USE_MAG
-    {"magADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
-    {"magADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
-    {"magADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
+    {"magADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, MAIN_STATE(magADC[0], S16)},
+    {"magADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, MAIN_STATE(magADC[1], S16)},
+    {"magADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, MAIN_STATE(magADC[2], S16)},
 #endif
 #ifdef USE_BARO
-    {"BaroAlt",    -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_BARO},
+    {"BaroAlt",    -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_BARO, MAIN_STATE(BaroAlt, S32)},
 #endif
 #ifdef USE_RANGEFINDER
-    {"surfaceRaw",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER},
+    {"surfaceRaw",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER, MAIN_STATE(surfaceRaw, S32)},
 #endif
-    {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RSSI},
+    {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RSSI, MAIN_STATE(rssi, U16)},
 
     /* Gyros and accelerometers base their P-predictions on the average of the previous 2 frames to reduce noise impact */
-    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"accSmooth",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"accSmooth",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"accSmooth",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"debug",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
+    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(gyroADC[0], S16)},
+    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(gyroADC[1], S16)},
+    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(gyroADC[2], S16)},
+    {"accSmooth",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, MAIN_STATE(accADC[0], S16)},
+    {"accSmooth",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, MAIN_STATE(accADC[1], S16)},
+    {"accSmooth",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, MAIN_STATE(accADC[2], S16)},
+    {"debug",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, MAIN_STATE(debug[0], S16)},
+    {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, MAIN_STATE(debug[1], S16)},
+    {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, MAIN_STATE(debug[2], S16)},
+    {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, MAIN_STATE(debug[3], S16)},
+#ifdef USE_DEBUG_CHANNELS
+    /* The debug channels that are not configured stay zero and cost no P-frame bytes in the 8SVB group */
+    {"debugChannel", 0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS, MAIN_STATE(debugChannel[0], S16)},
+    {"debugChannel", 1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS, MAIN_STATE(debugChannel[1], S16)},
+    {"debugChannel", 2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS, MAIN_STATE(debugChannel[2], S16)},
+    {"debugChannel", 3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS, MAIN_STATE(debugChannel[3], S16)},
+    {"debugChannel", 4, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS, MAIN_STATE(debugChannel[4], S16)},
+    {"debugChannel", 5, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS, MAIN_STATE(debugChannel[5], S16)},
+    {"debugChannel", 6, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS, MAIN_STATE(debugChannel[6], S16)},
+    {"debugChannel", 7, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS, MAIN_STATE(debugChannel[7], S16)},
+#endif
     /* Motors only rarely drops under minthrottle (when stick falls below mincommand), so predict minthrottle for it and use *unsigned* encoding (which is large for negative numbers but more compact for positive ones): */
-    {"motor",       0, UNSIGNED, .Ipredict = PREDICT(MINMOTOR), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(AVERAGE_2), .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_1)},
+    {"motor",       0, UNSIGNED, .Ipredict = PREDICT(MINMOTOR), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(AVERAGE_2), .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_1), MAIN_STATE(motor[0], S16)},
     /* Subsequent motors base their I-frame values on the first one, P-frame values on the average of last two frames: */
-    {"motor",       1, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_2)},
-    {"motor",       2, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_3)},
-    {"motor",       3, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_4)},
-    {"motor",       4, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_5)},
-    {"motor",       5, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_6)},
-    {"motor",       6, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_7)},
-    {"motor",       7, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_8)},
+    {"motor",       1, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_2), MAIN_STATE(motor[1], S16)},
+    {"motor",       2, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_3), MAIN_STATE(motor[2], S16)},
+    {"motor",       3, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_4), MAIN_STATE(motor[3], S16)},
+    {"motor",       4, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_5), MAIN_STATE(motor[4], S16)},
+    {"motor",       5, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_6), MAIN_STATE(motor[5], S16)},
+    {"motor",       6, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_7), MAIN_STATE(motor[6], S16)},
+    {"motor",       7, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_8), MAIN_STATE(motor[7], S16)},
 
     /* Helicopter servos when using MIXER_CUSTOM_AIRPLANE */
     // Ipredict set to Zero for now due to mix of 1500/760uS servos
-    {"servo",       2, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"servo",       3, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"servo",       4, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"servo",       5, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"servo",       2, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(servo[2], S16)},
+    {"servo",       3, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(servo[3], S16)},
+    {"servo",       4, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(servo[4], S16)},
+    {"servo",       5, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(servo[5], S16)},
     
-    {"headspeed",  -1, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"headspeed",  -1, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(headspeed, U16)},
+};
+
+/**
+ * The fast frames log the raw and filtered gyro and the setpoint every blackbox_fast_denom PID loop iterations, for
+ * filter tuning at rates the main frames can't be logged at. They form a stream of their own: an "F" frame follows
+ * every main I-frame and the "f" frames in between are predicted with a straight line through the previous two fast
+ * frames, so only the delta-of-delta of each field is stored.
+ */
+static const blackboxDeltaFieldDefinition_t blackboxFastFields[] = {
+    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FAST_STATE(time, U32)},
+    {"gyroUnfilt",  0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FAST_STATE(gyroUnfilt[0], S16)},
+    {"gyroUnfilt",  1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FAST_STATE(gyroUnfilt[1], S16)},
+    {"gyroUnfilt",  2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FAST_STATE(gyroUnfilt[2], S16)},
+    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FAST_STATE(gyroADC[0], S16)},
+    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FAST_STATE(gyroADC[1], S16)},
+    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FAST_STATE(gyroADC[2], S16)},
+    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FAST_STATE(setpoint[0], S16)},
+    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FAST_STATE(setpoint[1], S16)},
+    /* The TAG8_4S16 groups above are full, the last setpoint goes on its own */
+    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FAST_STATE(setpoint[2], S16)},
+};
+
+/**
+ * The heli frames log the governor loop and the rotor load every blackbox_heli_denom main frames. These change slowly
+ * compared to the main frames, so they come at a sub-rate of their own: an "R" frame follows every main I-frame and
+ * the "r" frames in between are predicted from the previous heli frame. The headspeed and the servos stay in the
+ * main frames.
+ */
+static const blackboxDeltaFieldDefinition_t blackboxHeliFields[] = {
+    {"govState",       -1, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(HELI), HELI_STATE(govState, U16)},
+    {"govSetpoint",    -1, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(HELI), HELI_STATE(govSetpoint, U16)},
+    {"govPidSum",      -1, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(HELI), HELI_STATE(govPidSum, S32)},
+    {"govI",           -1, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(HELI), HELI_STATE(govI, S32)},
+    {"govFF",          -1, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(HELI), HELI_STATE(govFeedForward, S32)},
+    {"govTailAssist",  -1, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(HELI), HELI_STATE(govTailAssist, S32)},
+    {"swashRing",      -1, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(HELI), HELI_STATE(swashRing, S16)},
+    {"collective",     -1, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(HELI), HELI_STATE(collective, S16)},
+    {"collectivePulse",-1, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(SIGNED_VB), CONDITION(HELI), HELI_STATE(collectivePulse, S16)},
+    {"vibGyro",         0, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibGyro[0], U16)},
+    {"vibGyro",         1, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibGyro[1], U16)},
+    {"vibGyro",         2, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibGyro[2], U16)},
+    {"vibAcc",          0, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibAcc[0], U16)},
+    {"vibAcc",          1, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibAcc[1], U16)},
+    {"vibAcc",          2, UNSIGNED, .Ipredict = PREDICT(0),    .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibAcc[2], U16)},
+    {"vibPhase",        0, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibPhase[0], S16)},
+    {"vibPhase",        1, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibPhase[1], S16)},
+    {"vibPhase",        2, SIGNED,   .Ipredict = PREDICT(0),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS), .Pencode = ENCODING(TAG8_8SVB), CONDITION(VIBRATION), HELI_STATE(vibPhase[2], S16)},
 };
 
 #ifdef USE_GPS
@@ -286,6 +449,8 @@ typedef enum BlackboxState {
     BLACKBOX_STATE_SEND_GPS_H_HEADER,
     BLACKBOX_STATE_SEND_GPS_G_HEADER,
     BLACKBOX_STATE_SEND_SLOW_HEADER,
+    BLACKBOX_STATE_SEND_FAST_HEADER,
+    BLACKBOX_STATE_SEND_HELI_HEADER,
     BLACKBOX_STATE_SEND_SYSINFO,
     BLACKBOX_STATE_PAUSED,
     BLACKBOX_STATE_RUNNING,
@@ -295,40 +460,6 @@ typedef enum BlackboxState {
     BLACKBOX_STATE_ERASED
 } BlackboxState;
 
-
-typedef struct blackboxMainState_s {
-    uint32_t time;
-
-    int32_t axisPID_P[XYZ_AXIS_COUNT];
-    int32_t axisPID_I[XYZ_AXIS_COUNT];
-    int32_t axisPID_D[XYZ_AXIS_COUNT];
-    int32_t axisPID_F[XYZ_AXIS_COUNT];
-
-    int16_t rcCommand[5];
-    int16_t setpoint[4];
-    int16_t gyroADC[XYZ_AXIS_COUNT];
-    int16_t accADC[XYZ_AXIS_COUNT];
-    int16_t debug[DEBUG16_VALUE_COUNT];
-    int16_t motor[MAX_SUPPORTED_MOTORS];
-    int16_t servo[MAX_SUPPORTED_SERVOS];
-
-    uint16_t vbatLatest;
-    int32_t amperageLatest;
-
-#ifdef USE_BARO
-    int32_t BaroAlt;
-#endif
-#ifdef USE_MAG
-    int16_t magADC[XYZ_AXIS_COUNT];
-#endif
-#ifdef USE_RANGEFINDER
-    int32_t surfaceRaw;
-#endif
-    uint16_t rssi;
-    
-    uint16_t headspeed;
-} blackboxMainState_t;
-
 typedef struct blackboxGpsState_s {
     int32_t GPS_home[2];
     int32_t GPS_coord[2];
@@ -351,6 +482,7 @@ static BlackboxState blackboxState = BLACKBOX_STATE_DISABLED;
 
 static uint32_t blackboxLastArmingBeep = 0;
 static uint32_t blackboxLastFlightModeFlags = 0; // New event tracking of flight modes
+static uint8_t blackboxLastLoadShedLevel;
 
 static struct {
     uint32_t headerIndex;
@@ -368,17 +500,26 @@ static struct {
 static uint32_t blackboxConditionCache;
 
 STATIC_ASSERT((sizeof(blackboxConditionCache) * 8) >= FLIGHT_LOG_FIELD_CONDITION_LAST, too_many_flight_log_conditions);
+#ifdef USE_DEBUG_CHANNELS
+STATIC_ASSERT(DEBUG_CHANNEL_COUNT == 8, debug_channel_fields_and_header_lines_expect_8_channels);
+#endif
 
 static uint32_t blackboxIteration;
 static uint16_t blackboxLoopIndex;
 static uint16_t blackboxPFrameIndex;
 static uint16_t blackboxIFrameIndex;
+static uint8_t blackboxFastFrameIndex;
+static uint8_t blackboxHeliFrameIndex;
 // number of flight loop iterations before logging I-frame
 // typically 32 for 1kHz loop, 64 for 2kHz loop etc
 STATIC_UNIT_TESTED int16_t blackboxIInterval = 0;
 // number of flight loop iterations before logging P-frame
 STATIC_UNIT_TESTED int16_t blackboxPInterval = 0;
 STATIC_UNIT_TESTED int32_t blackboxSInterval = 0;
+// number of flight loop iterations before logging a fast frame, zero when they are off
+STATIC_UNIT_TESTED uint8_t blackboxFastInterval = 0;
+// number of main frames before logging a heli frame, zero when they are off
+STATIC_UNIT_TESTED uint8_t blackboxHeliInterval = 0;
 STATIC_UNIT_TESTED int32_t blackboxSlowFrameIterationTimer;
 static bool blackboxLoggedAnyFrames;
 
@@ -398,8 +539,76 @@ static blackboxMainState_t blackboxHistoryRing[3];
 // These point into blackboxHistoryRing, use them to know where to store history of a given age (0, 1 or 2 generations old)
 static blackboxMainState_t* blackboxHistory[3];
 
+static blackboxFieldOp_t blackboxIFrameProgram[ARRAYLEN(blackboxMainFields)];
+static blackboxFieldOp_t blackboxPFrameProgram[ARRAYLEN(blackboxMainFields)];
+static uint8_t blackboxIFrameProgramLength;
+static uint8_t blackboxPFrameProgramLength;
+
+static blackboxFastState_t blackboxFastHistoryRing[3];
+static blackboxFastState_t* blackboxFastHistory[3];
+static bool blackboxFastIntraDue;
+
+static blackboxFieldOp_t blackboxFastIFrameProgram[ARRAYLEN(blackboxFastFields)];
+static blackboxFieldOp_t blackboxFastPFrameProgram[ARRAYLEN(blackboxFastFields)];
+static uint8_t blackboxFastIFrameProgramLength;
+static uint8_t blackboxFastPFrameProgramLength;
+
+static blackboxHeliState_t blackboxHeliHistoryRing[2];
+static blackboxHeliState_t* blackboxHeliHistory[2];
+static bool blackboxHeliIntraDue;
+
+static blackboxFieldOp_t blackboxHeliIFrameProgram[ARRAYLEN(blackboxHeliFields)];
+static blackboxFieldOp_t blackboxHeliPFrameProgram[ARRAYLEN(blackboxHeliFields)];
+static uint8_t blackboxHeliIFrameProgramLength;
+static uint8_t blackboxHeliPFrameProgramLength;
+
 static bool blackboxModeActivationConditionPresent = false;
 
+#ifdef USE_BLACKBOX_OFFLOAD
+/*
+ * The blackbox is split in two to keep the logging cost out of the PID loop. The PID loop only captures the
+ * main state of the iterations that are logged into a queue, the blackbox task drains the queue in the
+ * background and does all the encoding and the device I/O. This also works when the PID loop runs in the
+ * gyro interrupt.
+ */
+#define BLACKBOX_CAPTURE_QUEUE_SIZE 32   // power of two
+#define BLACKBOX_FAST_QUEUE_SIZE 64      // power of two, fast frames come in bursts of up to a PID loop rate / task rate
+
+#define BLACKBOX_CAPTURE_FLAG_IFRAME  (1 << 0)
+#define BLACKBOX_CAPTURE_FLAG_RESUME  (1 << 1)   // first frame after a gap in the captured iterations
+#define BLACKBOX_CAPTURE_FLAG_HELI    (1 << 2)   // heli frame due, the heli state is valid
+
+typedef enum {
+    BLACKBOX_CAPTURE_OFF = 0,
+    BLACKBOX_CAPTURE_PAUSED,
+    BLACKBOX_CAPTURE_RUNNING,
+} blackboxCaptureRequest_e;
+
+typedef struct blackboxCaptureEntry_s {
+    blackboxMainState_t state;
+    blackboxHeliState_t heli;
+    uint32_t iteration;
+    uint8_t flags;
+} blackboxCaptureEntry_t;
+
+static bool blackboxOffloaded;
+static spscQueue_t blackboxCaptureQueue;
+static blackboxCaptureEntry_t blackboxCaptureBuffer[BLACKBOX_CAPTURE_QUEUE_SIZE];
+static spscQueue_t blackboxFastQueue;
+static blackboxFastState_t blackboxFastBuffer[BLACKBOX_FAST_QUEUE_SIZE];
+
+// Written by the background task only
+static volatile uint8_t blackboxCaptureRequest = BLACKBOX_CAPTURE_OFF;
+static uint32_t blackboxLastCapturedIteration;
+static uint32_t blackboxCapturedIFrameCount;
+
+// Written by the PID loop only
+static bool blackboxCapturing;
+static bool blackboxCaptureResume;
+
+static volatile bool blackboxFinishPending;
+#endif
+
 /**
  * Return true if it is safe to edit the Blackbox configuration.
  */
@@ -476,6 +685,23 @@ static bool testBlackboxConditionUncached(FlightLogFieldCondition condition)
     case FLIGHT_LOG_FIELD_CONDITION_DEBUG:
         return debugMode != DEBUG_NONE;
 
+    case FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS:
+#ifdef USE_DEBUG_CHANNELS
+        return debugChannelsActive();
+#else
+        return false;
+#endif
+
+    case FLIGHT_LOG_FIELD_CONDITION_HELI:
+        return blackboxHeliInterval != 0;
+
+    case FLIGHT_LOG_FIELD_CONDITION_VIBRATION:
+#ifdef USE_VIBRATION_MONITOR
+        return blackboxHeliInterval != 0 && vibrationConfig()->vibration_monitor;
+#else
+        return false;
+#endif
+
     case FLIGHT_LOG_FIELD_CONDITION_NEVER:
         return false;
 
@@ -515,6 +741,8 @@ static void blackboxSetState(BlackboxState newState)
     case BLACKBOX_STATE_SEND_GPS_G_HEADER:
     case BLACKBOX_STATE_SEND_GPS_H_HEADER:
     case BLACKBOX_STATE_SEND_SLOW_HEADER:
+    case BLACKBOX_STATE_SEND_FAST_HEADER:
+    case BLACKBOX_STATE_SEND_HELI_HEADER:
         xmitState.headerIndex = 0;
         xmitState.u.fieldIndex = -1;
         break;
@@ -531,107 +759,170 @@ static void blackboxSetState(BlackboxState newState)
         ;
     }
     blackboxState = newState;
+
+#ifdef USE_BLACKBOX_OFFLOAD
+    if (newState == BLACKBOX_STATE_RUNNING) {
+        blackboxCaptureRequest = BLACKBOX_CAPTURE_RUNNING;
+    } else if (newState == BLACKBOX_STATE_PAUSED) {
+        blackboxCaptureRequest = BLACKBOX_CAPTURE_PAUSED;
+    } else {
+        blackboxCaptureRequest = BLACKBOX_CAPTURE_OFF;
+    }
+#endif
 }
 
-static void writeIntraframe(void)
+static int32_t blackboxReadStateField(const void *state, const blackboxFieldOp_t *op, uint32_t iteration)
 {
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-
-    blackboxWrite('I');
-
-    blackboxWriteUnsignedVB(blackboxIteration);
-    blackboxWriteUnsignedVB(blackboxCurrent->time);
-
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_P, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_I, XYZ_AXIS_COUNT);
-
-    // Don't bother writing the current D term if the corresponding PID setting is zero
-    for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-        if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
-            blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x]);
-        }
+    const void *field = (const uint8_t *)state + op->stateOffset;
+
+    switch (op->stateType) {
+    case BLACKBOX_FIELD_TYPE_ITERATION:
+        return iteration;
+    case BLACKBOX_FIELD_TYPE_U32:
+        return *(const uint32_t *)field;
+    case BLACKBOX_FIELD_TYPE_S32:
+        return *(const int32_t *)field;
+    case BLACKBOX_FIELD_TYPE_U16:
+        return *(const uint16_t *)field;
+    case BLACKBOX_FIELD_TYPE_S16:
+    default:
+        return *(const int16_t *)field;
     }
+}
 
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_F, XYZ_AXIS_COUNT);
-
-    // Write roll, pitch and yaw first:
-    blackboxWriteSigned16VBArray(blackboxCurrent->rcCommand, 3);
-
-    /*
-     * Write the throttle separately from the rest of the RC data as it's unsigned.
-     * Throttle lies in range [PWM_RANGE_MIN..PWM_RANGE_MAX]:
-     */
-    blackboxWriteUnsignedVB(blackboxCurrent->rcCommand[THROTTLE]);
+// Returns the difference between the current value of the field and its prediction from the state history
+static int32_t blackboxPredictField(const blackboxFieldOp_t *op, const void * const history[3], uint32_t iteration)
+{
+    const int32_t value = blackboxReadStateField(history[0], op, iteration);
+
+    switch (op->predict) {
+    case FLIGHT_LOG_FIELD_PREDICTOR_PREVIOUS:
+        return value - blackboxReadStateField(history[1], op, iteration);
+    case FLIGHT_LOG_FIELD_PREDICTOR_STRAIGHT_LINE:
+        // Unsigned so that the time can wrap
+        return (int32_t)((uint32_t)value - 2 * (uint32_t)blackboxReadStateField(history[1], op, iteration)
+            + (uint32_t)blackboxReadStateField(history[2], op, iteration));
+    case FLIGHT_LOG_FIELD_PREDICTOR_AVERAGE_2:
+        return value - (blackboxReadStateField(history[1], op, iteration) + blackboxReadStateField(history[2], op, iteration)) / 2;
+    case FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR:
+        return value - motorOutputLow;
+    case FLIGHT_LOG_FIELD_PREDICTOR_MOTOR_0:
+        // Only used by the main frames
+        return value - ((const blackboxMainState_t *)history[0])->motor[0];
+    case FLIGHT_LOG_FIELD_PREDICTOR_VBATREF:
+        return value - vbatReference;
+    case FLIGHT_LOG_FIELD_PREDICTOR_0:
+    default:
+        return value;
+    }
+}
 
-    // Write rcCommand[COLLECTIVE]
-    blackboxWriteSignedVB(blackboxCurrent->rcCommand[COLLECTIVE]);
+static int blackboxEncodingGroupSize(uint8_t encode)
+{
+    switch (encode) {
+    case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+        return 3;
+    case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+        return 4;
+    case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB:
+        return 8;
+    default:
+        return 1;
+    }
+}
 
-    // Write setpoint roll, pitch, yaw, and throttle
-    blackboxWriteSigned16VBArray(blackboxCurrent->setpoint, 4);
+static void blackboxWriteFrameProgram(const blackboxFieldOp_t *program, int programLength, const void * const history[3], uint32_t iteration)
+{
+    int32_t values[8];
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
-        /*
-         * Our voltage is expected to decrease over the course of the flight, so store our difference from
-         * the reference:
-         *
-         * Write 14 bits even if the number is negative (which would otherwise result in 32 bits)
-         */
-        blackboxWriteUnsignedVB((vbatReference - blackboxCurrent->vbatLatest) & 0x3FFF);
-    }
+    for (int i = 0; i < programLength; ) {
+        const uint8_t encode = program[i].encode;
+        const int groupSize = blackboxEncodingGroupSize(encode);
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC)) {
-        // 12bit value directly from ADC
-        blackboxWriteSignedVB(blackboxCurrent->amperageLatest);
-    }
+        int count = 0;
+        while (count < groupSize && i < programLength && program[i].encode == encode) {
+            values[count++] = blackboxPredictField(&program[i++], history, iteration);
+        }
+        for (int j = count; j < groupSize; j++) {
+            values[j] = 0;
+        }
 
-#ifdef USE_MAG
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_MAG)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->magADC, XYZ_AXIS_COUNT);
+        switch (encode) {
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+            blackboxWriteSignedVB(values[0]);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_UNSIGNED_VB:
+            blackboxWriteUnsignedVB(values[0]);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_NEG_14BIT:
+            // Write 14 bits even if the number is negative (which would otherwise result in 32 bits)
+            blackboxWriteUnsignedVB(-values[0] & 0x3FFF);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+            blackboxWriteTag2_3S32(values);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+            blackboxWriteTag8_4S16(values);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB:
+            blackboxWriteTag8_8SVB(values, count);
+            break;
+        default:
+            break;
+        }
     }
-#endif
+}
 
-#ifdef USE_BARO
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_BARO)) {
-        blackboxWriteSignedVB(blackboxCurrent->BaroAlt);
-    }
-#endif
+static void blackboxBuildFrameProgram(const blackboxDeltaFieldDefinition_t *fields, int fieldCount,
+        blackboxFieldOp_t *iProgram, uint8_t *iProgramLength, blackboxFieldOp_t *pProgram, uint8_t *pProgramLength)
+{
+    *iProgramLength = 0;
+    *pProgramLength = 0;
 
-#ifdef USE_RANGEFINDER
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER)) {
-        blackboxWriteSignedVB(blackboxCurrent->surfaceRaw);
-    }
-#endif
+    for (int i = 0; i < fieldCount; i++) {
+        const blackboxDeltaFieldDefinition_t *field = &fields[i];
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RSSI)) {
-        blackboxWriteUnsignedVB(blackboxCurrent->rssi);
-    }
+        if (!testBlackboxCondition(field->condition)) {
+            continue;
+        }
 
-    blackboxWriteSigned16VBArray(blackboxCurrent->gyroADC, XYZ_AXIS_COUNT);
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->accADC, XYZ_AXIS_COUNT);
+        blackboxFieldOp_t *op = &iProgram[(*iProgramLength)++];
+        op->stateOffset = field->stateOffset;
+        op->stateType = field->stateType;
+        op->predict = field->Ipredict;
+        op->encode = field->Iencode;
+
+        // Fields the decoder can work out by itself are left out of the P-frames
+        if (field->Pencode != FLIGHT_LOG_FIELD_ENCODING_NULL) {
+            op = &pProgram[(*pProgramLength)++];
+            op->stateOffset = field->stateOffset;
+            op->stateType = field->stateType;
+            op->predict = field->Ppredict;
+            op->encode = field->Pencode;
+        }
     }
+}
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->debug, DEBUG16_VALUE_COUNT);
-    }
+// Resolves the field conditions, which can't change during a log, into the main, fast and heli frame programs
+static void blackboxBuildFramePrograms(void)
+{
+    blackboxBuildFrameProgram(blackboxMainFields, ARRAYLEN(blackboxMainFields),
+        blackboxIFrameProgram, &blackboxIFrameProgramLength, blackboxPFrameProgram, &blackboxPFrameProgramLength);
+    blackboxBuildFrameProgram(blackboxFastFields, ARRAYLEN(blackboxFastFields),
+        blackboxFastIFrameProgram, &blackboxFastIFrameProgramLength, blackboxFastPFrameProgram, &blackboxFastPFrameProgramLength);
+    blackboxBuildFrameProgram(blackboxHeliFields, ARRAYLEN(blackboxHeliFields),
+        blackboxHeliIFrameProgram, &blackboxHeliIFrameProgramLength, blackboxHeliPFrameProgram, &blackboxHeliPFrameProgramLength);
+}
 
-    //Motors can be below minimum output when disarmed, but that doesn't happen much
-    blackboxWriteUnsignedVB(blackboxCurrent->motor[0] - motorOutputLow);
+static void writeIntraframe(uint32_t iteration)
+{
+    const void *history[3] = { blackboxHistory[0], blackboxHistory[1], blackboxHistory[2] };
 
-    //Motors tend to be similar to each other so use the first motor's value as a predictor of the others
-    const int motorCount = getMotorCount();
-    for (int x = 1; x < motorCount; x++) {
-        blackboxWriteSignedVB(blackboxCurrent->motor[x] - blackboxCurrent->motor[0]);
-    }
+    blackboxFrameBegin();
+    blackboxWrite('I');
 
-    // Write the servo I frames as unsigned since they will always be somewhere between 0 and 2020
-    blackboxWriteUnsignedVB(blackboxCurrent->servo[2]);
-    blackboxWriteUnsignedVB(blackboxCurrent->servo[3]);
-    blackboxWriteUnsignedVB(blackboxCurrent->servo[4]);
-    blackboxWriteUnsignedVB(blackboxCurrent->servo[5]);
-    
-    // Write helicopter headspeed
-    blackboxWriteUnsignedVB(blackboxCurrent->headspeed);
+    blackboxWriteFrameProgram(blackboxIFrameProgram, blackboxIFrameProgramLength, history, iteration);
+    blackboxFrameCommit();
 
     //Rotate our history buffers:
 
@@ -642,142 +933,76 @@ static void writeIntraframe(void)
     //And advance the current state over to a blank space ready to be filled
     blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
 
+    // The fast and heli frame streams restart along with the main one
+    blackboxFastIntraDue = true;
+    blackboxHeliIntraDue = true;
     blackboxLoggedAnyFrames = true;
 }
 
-static void blackboxWriteMainStateArrayUsingAveragePredictor(int arrOffsetInHistory, int count)
-{
-    int16_t *curr  = (int16_t*) ((char*) (blackboxHistory[0]) + arrOffsetInHistory);
-    int16_t *prev1 = (int16_t*) ((char*) (blackboxHistory[1]) + arrOffsetInHistory);
-    int16_t *prev2 = (int16_t*) ((char*) (blackboxHistory[2]) + arrOffsetInHistory);
-
-    for (int i = 0; i < count; i++) {
-        // Predictor is the average of the previous two history states
-        int32_t predictor = (prev1[i] + prev2[i]) / 2;
-
-        blackboxWriteSignedVB(curr[i] - predictor);
-    }
-}
-
 static void writeInterframe(void)
 {
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-    blackboxMainState_t *blackboxLast = blackboxHistory[1];
+    const void *history[3] = { blackboxHistory[0], blackboxHistory[1], blackboxHistory[2] };
 
+    blackboxFrameBegin();
     blackboxWrite('P');
 
     //No need to store iteration count since its delta is always 1
+    blackboxWriteFrameProgram(blackboxPFrameProgram, blackboxPFrameProgramLength, history, 0);
+    blackboxFrameCommit();
 
-    /*
-     * Since the difference between the difference between successive times will be nearly zero (due to consistent
-     * looptime spacing), use second-order differences.
-     */
-    blackboxWriteSignedVB((int32_t) (blackboxHistory[0]->time - 2 * blackboxHistory[1]->time + blackboxHistory[2]->time));
-
-    int32_t deltas[8];
-    int32_t setpointDeltas[4];
-    
-    arraySubInt32(deltas, blackboxCurrent->axisPID_P, blackboxLast->axisPID_P, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
-
-    /*
-     * The PID I field changes very slowly, most of the time +-2, so use an encoding
-     * that can pack all three fields into one byte in that situation.
-     */
-    arraySubInt32(deltas, blackboxCurrent->axisPID_I, blackboxLast->axisPID_I, XYZ_AXIS_COUNT);
-    blackboxWriteTag2_3S32(deltas);
-
-    /*
-     * The PID D term is frequently set to zero for yaw, which makes the result from the calculation
-     * always zero. So don't bother recording D results when PID D terms are zero.
-     */
-    for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-        if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
-            blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x] - blackboxLast->axisPID_D[x]);
-        }
-    }
-
-    arraySubInt32(deltas, blackboxCurrent->axisPID_F, blackboxLast->axisPID_F, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
-
-    /*
-     * RC tends to stay the same or fairly small for many frames at a time, so use an encoding that
-     * can pack multiple values per byte:
-     */
-    for (int x = 0; x < 4; x++) {
-        deltas[x] = blackboxCurrent->rcCommand[x] - blackboxLast->rcCommand[x];
-        setpointDeltas[x] = blackboxCurrent->setpoint[x] - blackboxLast->setpoint[x];
-    }
-    // HF3D:  Calculate collective delta
-    int32_t collectiveDelta = blackboxCurrent->rcCommand[COLLECTIVE] - blackboxLast->rcCommand[COLLECTIVE];
-
-    blackboxWriteTag8_4S16(deltas);
-    blackboxWriteSignedVB(collectiveDelta);   // HF3D:  Write delta for collective channel as signed variable byte
-    blackboxWriteTag8_4S16(setpointDeltas);
-
-    //Check for sensors that are updated periodically (so deltas are normally zero)
-    int optionalFieldCount = 0;
-
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
-        deltas[optionalFieldCount++] = (int32_t) blackboxCurrent->vbatLatest - blackboxLast->vbatLatest;
-    }
+    //Rotate our history buffers
+    blackboxHistory[2] = blackboxHistory[1];
+    blackboxHistory[1] = blackboxHistory[0];
+    blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->amperageLatest - blackboxLast->amperageLatest;
-    }
+    blackboxLoggedAnyFrames = true;
+}
 
-#ifdef USE_MAG
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_MAG)) {
-        for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-            deltas[optionalFieldCount++] = blackboxCurrent->magADC[x] - blackboxLast->magADC[x];
-        }
-    }
-#endif
+// Write the fast state in blackboxFastHistory[0] as an "F" frame if one is due, otherwise as an "f" frame
+static void writeFastFrame(void)
+{
+    const void *history[3] = { blackboxFastHistory[0], blackboxFastHistory[1], blackboxFastHistory[2] };
 
-#ifdef USE_BARO
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_BARO)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->BaroAlt - blackboxLast->BaroAlt;
-    }
-#endif
+    blackboxFrameBegin();
+    if (blackboxFastIntraDue) {
+        blackboxWrite('F');
+        blackboxWriteFrameProgram(blackboxFastIFrameProgram, blackboxFastIFrameProgramLength, history, 0);
 
-#ifdef USE_RANGEFINDER
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->surfaceRaw - blackboxLast->surfaceRaw;
-    }
-#endif
+        blackboxFastHistory[1] = blackboxFastHistory[0];
+        blackboxFastHistory[2] = blackboxFastHistory[0];
+        blackboxFastIntraDue = false;
+    } else {
+        blackboxWrite('f');
+        blackboxWriteFrameProgram(blackboxFastPFrameProgram, blackboxFastPFrameProgramLength, history, 0);
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RSSI)) {
-        deltas[optionalFieldCount++] = (int32_t) blackboxCurrent->rssi - blackboxLast->rssi;
+        blackboxFastHistory[2] = blackboxFastHistory[1];
+        blackboxFastHistory[1] = blackboxFastHistory[0];
     }
+    blackboxFrameCommit();
 
-    blackboxWriteTag8_8SVB(deltas, optionalFieldCount);
+    blackboxFastHistory[0] = ((blackboxFastHistory[0] - blackboxFastHistoryRing + 1) % 3) + blackboxFastHistoryRing;
+}
 
-    //Since gyros, accs and motors are noisy, base their predictions on the average of the history:
-    blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroADC),   XYZ_AXIS_COUNT);
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, accADC), XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG)) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, debug), DEBUG16_VALUE_COUNT);
-    }
-    blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, motor),     getMotorCount());
+// Write the heli state in blackboxHeliHistory[0] as an "R" frame if one is due, otherwise as an "r" frame
+static void writeHeliFrame(void)
+{
+    const void *history[3] = { blackboxHeliHistory[0], blackboxHeliHistory[1], blackboxHeliHistory[1] };
 
-    // Calculate helicopter servo deltas from last BB frame and write as a group of 4 to this P interframe
-    for (int x = 0; x < 4; x++) {
-        // +2 for MIXER_CUSTOM_AIRPLANE used with custom smix
-        deltas[x] = blackboxCurrent->servo[x+2] - blackboxLast->servo[x+2];
+    blackboxFrameBegin();
+    if (blackboxHeliIntraDue) {
+        blackboxWrite('R');
+        blackboxWriteFrameProgram(blackboxHeliIFrameProgram, blackboxHeliIFrameProgramLength, history, 0);
+        blackboxHeliIntraDue = false;
+    } else {
+        blackboxWrite('r');
+        blackboxWriteFrameProgram(blackboxHeliPFrameProgram, blackboxHeliPFrameProgramLength, history, 0);
     }
-    blackboxWriteTag8_4S16(deltas);
-    
-    // Write helicopter headspeed with delta from last frame
-    blackboxWriteSignedVB(blackboxCurrent->headspeed - blackboxLast->headspeed);
- 
-    //Rotate our history buffers
-    blackboxHistory[2] = blackboxHistory[1];
-    blackboxHistory[1] = blackboxHistory[0];
-    blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
+    blackboxFrameCommit();
 
-    blackboxLoggedAnyFrames = true;
+    // Only predicted from the previous frame, so two buffers are enough
+    blackboxHeliState_t *previous = blackboxHeliHistory[1];
+    blackboxHeliHistory[1] = blackboxHeliHistory[0];
+    blackboxHeliHistory[0] = previous;
 }
 
 /* Write the contents of the global "slowHistory" to the log as an "S" frame. Because this data is logged so
@@ -786,6 +1011,7 @@ static void writeSlowFrame(void)
 {
     int32_t values[3];
 
+    blackboxFrameBegin();
     blackboxWrite('S');
 
     blackboxWriteUnsignedVB(slowHistory.flightModeFlags);
@@ -798,6 +1024,7 @@ static void writeSlowFrame(void)
     values[1] = slowHistory.rxSignalReceived ? 1 : 0;
     values[2] = slowHistory.rxFlightChannelsValid ? 1 : 0;
     blackboxWriteTag2_3S32(values);
+    blackboxFrameCommit();
 
     blackboxSlowFrameIterationTimer = 0;
 }
@@ -871,6 +1098,8 @@ static void blackboxResetIterationTimers(void)
     blackboxLoopIndex = 0;
     blackboxIFrameIndex = 0;
     blackboxPFrameIndex = 0;
+    blackboxFastFrameIndex = 0;
+    blackboxHeliFrameIndex = 0;
     blackboxSlowFrameIterationTimer = 0;
 }
 
@@ -892,6 +1121,29 @@ static void blackboxStart(void)
     blackboxHistory[1] = &blackboxHistoryRing[1];
     blackboxHistory[2] = &blackboxHistoryRing[2];
 
+    blackboxFastHistory[0] = &blackboxFastHistoryRing[0];
+    blackboxFastHistory[1] = &blackboxFastHistoryRing[1];
+    blackboxFastHistory[2] = &blackboxFastHistoryRing[2];
+    blackboxFastIntraDue = true;
+
+    blackboxHeliHistory[0] = &blackboxHeliHistoryRing[0];
+    blackboxHeliHistory[1] = &blackboxHeliHistoryRing[1];
+    blackboxHeliIntraDue = true;
+
+#ifdef USE_BLACKBOX_OFFLOAD
+    // Frames captured for the previous log are stale
+    while (spscQueueConsumerPeek(&blackboxCaptureQueue)) {
+        spscQueueConsumerRelease(&blackboxCaptureQueue);
+    }
+    while (spscQueueConsumerPeek(&blackboxFastQueue)) {
+        spscQueueConsumerRelease(&blackboxFastQueue);
+    }
+#endif
+
+#ifdef USE_LOOP_TIMING
+    loopTimingDropEvents();
+#endif
+
     vbatReference = getBatteryVoltageLatest();
 
     //No need to clear the content of blackboxHistoryRing since our first frame will be an intra which overwrites it
@@ -902,6 +1154,7 @@ static void blackboxStart(void)
      * cache those now.
      */
     blackboxBuildConditionCache();
+    blackboxBuildFramePrograms();
 
     blackboxModeActivationConditionPresent = isModeActivationConditionPresent(BOXBLACKBOX);
 
@@ -913,14 +1166,12 @@ static void blackboxStart(void)
      */
     blackboxLastArmingBeep = getArmingBeepTimeMicros();
     memcpy(&blackboxLastFlightModeFlags, &rcModeActivationMask, sizeof(blackboxLastFlightModeFlags)); // record startup status
+    blackboxLastLoadShedLevel = 0;
 
     blackboxSetState(BLACKBOX_STATE_PREPARE_LOG_FILE);
 }
 
-/**
- * Begin Blackbox shutdown.
- */
-void blackboxFinish(void)
+static void blackboxFinishLog(void)
 {
     switch (blackboxState) {
     case BLACKBOX_STATE_DISABLED:
@@ -937,6 +1188,21 @@ void blackboxFinish(void)
     }
 }
 
+/**
+ * Begin Blackbox shutdown.
+ */
+void blackboxFinish(void)
+{
+#ifdef USE_BLACKBOX_OFFLOAD
+    if (blackboxOffloaded) {
+        // Disarming may happen in the PID loop, leave the log I/O to the background task
+        blackboxFinishPending = true;
+        return;
+    }
+#endif
+    blackboxFinishLog();
+}
+
 /**
  * Test Motors Blackbox Logging
  */
@@ -989,10 +1255,12 @@ static bool inMotorTestMode(void) {
 #ifdef USE_GPS
 static void writeGPSHomeFrame(void)
 {
+    blackboxFrameBegin();
     blackboxWrite('H');
 
     blackboxWriteSignedVB(GPS_home[0]);
     blackboxWriteSignedVB(GPS_home[1]);
+    blackboxFrameCommit();
     //TODO it'd be great if we could grab the GPS current time and write that too
 
     gpsHistory.GPS_home[0] = GPS_home[0];
@@ -1001,6 +1269,7 @@ static void writeGPSHomeFrame(void)
 
 static void writeGPSFrame(timeUs_t currentTimeUs)
 {
+    blackboxFrameBegin();
     blackboxWrite('G');
 
     /*
@@ -1020,6 +1289,7 @@ static void writeGPSFrame(timeUs_t currentTimeUs)
     blackboxWriteUnsignedVB(gpsSol.llh.altCm / 10); // was originally designed to transport meters in int16, but +-3276.7m is a good compromise
     blackboxWriteUnsignedVB(gpsSol.groundSpeed);
     blackboxWriteUnsignedVB(gpsSol.groundCourse);
+    blackboxFrameCommit();
 
     gpsHistory.GPS_numSat = gpsSol.numSat;
     gpsHistory.GPS_coord[LAT] = gpsSol.llh.lat;
@@ -1030,11 +1300,9 @@ static void writeGPSFrame(timeUs_t currentTimeUs)
 /**
  * Fill the current state of the blackbox using values read from the flight controller
  */
-static void loadMainState(timeUs_t currentTimeUs)
+static void loadMainState(blackboxMainState_t *blackboxCurrent, timeUs_t currentTimeUs)
 {
 #ifndef UNIT_TEST
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-
     blackboxCurrent->time = currentTimeUs;
 
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
@@ -1066,6 +1334,11 @@ static void loadMainState(timeUs_t currentTimeUs)
     for (int i = 0; i < DEBUG16_VALUE_COUNT; i++) {
         blackboxCurrent->debug[i] = debug[i];
     }
+#ifdef USE_DEBUG_CHANNELS
+    for (int i = 0; i < DEBUG_CHANNEL_COUNT; i++) {
+        blackboxCurrent->debugChannel[i] = debugChannel[i];
+    }
+#endif
 
     const int motorCount = getMotorCount();
     for (int i = 0; i < motorCount; i++) {
@@ -1096,10 +1369,56 @@ static void loadMainState(timeUs_t currentTimeUs)
     blackboxCurrent->headspeed = headspeed;
 
 #else
+    UNUSED(blackboxCurrent);
     UNUSED(currentTimeUs);
 #endif // UNIT_TEST
 }
 
+static void loadFastState(blackboxFastState_t *fastCurrent, timeUs_t currentTimeUs)
+{
+#ifndef UNIT_TEST
+    fastCurrent->time = currentTimeUs;
+
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        fastCurrent->gyroUnfilt[i] = lrintf(gyro.gyroADC[i]);
+        fastCurrent->gyroADC[i] = lrintf(gyro.gyroADCf[i]);
+        fastCurrent->setpoint[i] = lrintf(pidGetPreviousSetpoint(i));
+    }
+#else
+    UNUSED(fastCurrent);
+    UNUSED(currentTimeUs);
+#endif // UNIT_TEST
+}
+
+static void loadHeliState(blackboxHeliState_t *heliCurrent)
+{
+#ifndef UNIT_TEST
+    heliCurrent->govState = governorGetState();
+    heliCurrent->govSetpoint = lrintf(governorGetSetpoint());
+    heliCurrent->govPidSum = lrintf(governorGetPidSum() * 1000.0f);
+    heliCurrent->govI = lrintf(governorGetI() * 1000.0f);
+    heliCurrent->govFeedForward = lrintf(governorGetFeedForward() * 1000.0f);
+    heliCurrent->govTailAssist = lrintf(governorGetTailmotorAssist() * 1000.0f);
+#ifdef USE_SERVOS
+    heliCurrent->swashRing = lrintf(servosGetSwashRingValue() * 1000.0f);
+#endif
+
+    const collective_t *collective = collectiveGet();
+    heliCurrent->collective = lrintf(collective->percent * 10.0f);
+    heliCurrent->collectivePulse = lrintf(collective->pulse * 10.0f);
+
+#ifdef USE_VIBRATION_MONITOR
+    for (int harmonic = 0; harmonic < VIBRATION_HARMONIC_COUNT; harmonic++) {
+        heliCurrent->vibGyro[harmonic] = lrintf(constrainf(vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, harmonic) * 10.0f, 0, UINT16_MAX));
+        heliCurrent->vibAcc[harmonic] = lrintf(constrainf(vibrationGetAmplitude(VIBRATION_SOURCE_ACC, harmonic) * 1000.0f, 0, UINT16_MAX));
+        heliCurrent->vibPhase[harmonic] = lrintf(vibrationGetPhase(VIBRATION_SOURCE_GYRO, harmonic));
+    }
+#endif
+#else
+    UNUSED(heliCurrent);
+#endif // UNIT_TEST
+}
+
 /**
  * Transmit the header information for the given field definitions. Transmitted header lines look like:
  *
@@ -1241,6 +1560,21 @@ STATIC_UNIT_TESTED char *blackboxGetStartDateTime(char *buf)
                                                break;
 #endif
 
+#ifndef UNIT_TEST
+// One gain schedule line, the rpm breakpoints or the percentages of one axis, whichever is given
+static void blackboxPrintGainScheduleHeaderLine(const char *name, const uint16_t *rpm, const uint8_t *percent)
+{
+    char buf[PID_GAIN_SCHEDULE_POINTS * 6 + 1];
+    char *pos = buf;
+
+    for (int i = 0; i < PID_GAIN_SCHEDULE_POINTS; i++) {
+        pos += tfp_sprintf(pos, i ? ",%d" : "%d", rpm ? rpm[i] : percent[i]);
+    }
+
+    blackboxPrintfHeaderLine(name, "%s", buf);
+}
+#endif
+
 /**
  * Transmit a portion of the system information headers. Call the first time with xmitState.headerIndex == 0. Returns
  * true iff transmission is complete, otherwise call again later to continue transmission.
@@ -1272,6 +1606,11 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("I interval", "%d",                      blackboxIInterval);
         BLACKBOX_PRINT_HEADER_LINE("P interval", "%d",                      blackboxPInterval);
         BLACKBOX_PRINT_HEADER_LINE("P ratio", "%d",                         blackboxConfig()->p_ratio);
+        BLACKBOX_PRINT_HEADER_LINE("F interval", "%d",                      blackboxFastInterval);
+        BLACKBOX_PRINT_HEADER_LINE("R interval", "%d",                      blackboxHeliInterval);
+#ifdef USE_BLACKBOX_COMPRESSION
+        BLACKBOX_PRINT_HEADER_LINE("Data compression", "%d",                blackboxConfig()->compression);
+#endif
         BLACKBOX_PRINT_HEADER_LINE("minthrottle", "%d",                     motorConfig()->minthrottle);
         BLACKBOX_PRINT_HEADER_LINE("maxthrottle", "%d",                     motorConfig()->maxthrottle);
         BLACKBOX_PRINT_HEADER_LINE("gyro_scale","0x%x",                     castFloatBytesToInt(1.0f));
@@ -1301,6 +1640,16 @@ static bool blackboxWriteSysinfo(void)
 
         BLACKBOX_PRINT_HEADER_LINE("looptime", "%d",                        gyro.targetLooptime);
         BLACKBOX_PRINT_HEADER_LINE("gyro_sync_denom", "%d",                 gyroConfig()->gyro_sync_denom);
+#ifdef USE_GYRO_FIFO
+        BLACKBOX_PRINT_HEADER_LINE("gyro_fifo_decimation", "%d",            gyroConfig()->gyro_fifo_decimation);
+#endif
+#ifdef USE_GYRO_ISR_READ
+        BLACKBOX_PRINT_HEADER_LINE("gyro_isr_read", "%d",                   gyroConfig()->gyro_isr_read);
+#endif
+#ifdef USE_GYRO_ISR_PID
+        BLACKBOX_PRINT_HEADER_LINE("gyro_isr_pid", "%d",                    gyroConfig()->gyro_isr_pid);
+#endif
+        BLACKBOX_PRINT_HEADER_LINE("rx_inline_pid", "%d",                   rxInlineDecodeEnabled());
         BLACKBOX_PRINT_HEADER_LINE("pid_process_denom", "%d",               pidConfig()->pid_process_denom);
         BLACKBOX_PRINT_HEADER_LINE("thr_mid", "%d",                         currentControlRateProfile->thrMid8);
         BLACKBOX_PRINT_HEADER_LINE("thr_expo", "%d",                        currentControlRateProfile->thrExpo8);
@@ -1331,6 +1680,27 @@ static bool blackboxWriteSysinfo(void)
                                                                             currentPidProfile->pid[PID_LEVEL].I,
                                                                             currentPidProfile->pid[PID_LEVEL].D);
         BLACKBOX_PRINT_HEADER_LINE("magPID", "%d",                          currentPidProfile->pid[PID_MAG].P);
+        BLACKBOX_PRINT_HEADER_LINE_CUSTOM(
+            blackboxPrintGainScheduleHeaderLine("gain_schedule_rpm", currentPidProfile->gain_schedule_rpm, NULL);
+            );
+        BLACKBOX_PRINT_HEADER_LINE_CUSTOM(
+            blackboxPrintGainScheduleHeaderLine("gain_schedule_roll", NULL, currentPidProfile->gain_schedule_percent[FD_ROLL]);
+            );
+        BLACKBOX_PRINT_HEADER_LINE_CUSTOM(
+            blackboxPrintGainScheduleHeaderLine("gain_schedule_pitch", NULL, currentPidProfile->gain_schedule_percent[FD_PITCH]);
+            );
+        BLACKBOX_PRINT_HEADER_LINE_CUSTOM(
+            blackboxPrintGainScheduleHeaderLine("gain_schedule_yaw", NULL, currentPidProfile->gain_schedule_percent[FD_YAW]);
+            );
+        BLACKBOX_PRINT_HEADER_LINE("smith_delay_ms", "%d,%d,%d",            currentPidProfile->smith_delay_ms[ROLL],
+                                                                            currentPidProfile->smith_delay_ms[PITCH],
+                                                                            currentPidProfile->smith_delay_ms[YAW]);
+        BLACKBOX_PRINT_HEADER_LINE("smith_lag_ms", "%d,%d,%d",              currentPidProfile->smith_lag_ms[ROLL],
+                                                                            currentPidProfile->smith_lag_ms[PITCH],
+                                                                            currentPidProfile->smith_lag_ms[YAW]);
+        BLACKBOX_PRINT_HEADER_LINE("smith_gain", "%d,%d,%d",                currentPidProfile->smith_gain[ROLL],
+                                                                            currentPidProfile->smith_gain[PITCH],
+                                                                            currentPidProfile->smith_gain[YAW]);
 #ifdef USE_D_MIN
         BLACKBOX_PRINT_HEADER_LINE("d_min", "%d,%d,%d",                     currentPidProfile->d_min[ROLL],
                                                                             currentPidProfile->d_min[PITCH],
@@ -1376,6 +1746,8 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("ff_interpolate_sp", "%d",               currentPidProfile->ff_interpolate_sp);
         BLACKBOX_PRINT_HEADER_LINE("ff_spike_limit", "%d",                  currentPidProfile->ff_spike_limit);
         BLACKBOX_PRINT_HEADER_LINE("ff_max_rate_limit", "%d",               currentPidProfile->ff_max_rate_limit);
+        BLACKBOX_PRINT_HEADER_LINE("ff_prediction", "%d",                   currentPidProfile->ff_prediction);
+        BLACKBOX_PRINT_HEADER_LINE("ff_lookahead_ms", "%d",                 currentPidProfile->ff_lookahead_ms);
 #endif
         BLACKBOX_PRINT_HEADER_LINE("ff_boost", "%d",                        currentPidProfile->ff_boost);
 
@@ -1406,6 +1778,8 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("dyn_notch_width_percent", "%d",         gyroConfig()->dyn_notch_width_percent);
         BLACKBOX_PRINT_HEADER_LINE("dyn_notch_q", "%d",                     gyroConfig()->dyn_notch_q);
         BLACKBOX_PRINT_HEADER_LINE("dyn_notch_min_hz", "%d",                gyroConfig()->dyn_notch_min_hz);
+        BLACKBOX_PRINT_HEADER_LINE("dyn_notch_window", "%d",                gyroConfig()->dyn_notch_window);
+        BLACKBOX_PRINT_HEADER_LINE("dyn_notch_count", "%d",                 gyroConfig()->dyn_notch_count);
 #endif
 #ifdef USE_DSHOT_TELEMETRY
         BLACKBOX_PRINT_HEADER_LINE("dshot_bidir", "%d",                     motorConfig()->dev.useDshotTelemetry);
@@ -1499,6 +1873,23 @@ static bool blackboxWriteSysinfo(void)
                                                                             rpmFilterConfig()->filter_bank_max_hz[13],
                                                                             rpmFilterConfig()->filter_bank_max_hz[14],
                                                                             rpmFilterConfig()->filter_bank_max_hz[15]);
+        BLACKBOX_PRINT_HEADER_LINE("gyro_rpm_filter_bank_harmonics", "%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d",
+                                                                            rpmFilterConfig()->filter_bank_harmonics[0],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[1],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[2],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[3],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[4],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[5],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[6],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[7],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[8],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[9],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[10],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[11],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[12],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[13],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[14],
+                                                                            rpmFilterConfig()->filter_bank_harmonics[15]);
 #endif
 #if defined(USE_ACC)
         BLACKBOX_PRINT_HEADER_LINE("acc_lpf_hz", "%d",                 (int)(accelerometerConfig()->acc_lpf_hz * 100.0f));
@@ -1521,6 +1912,24 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("motor_pwm_rate", "%d",                  motorConfig()->dev.motorPwmRate);
         BLACKBOX_PRINT_HEADER_LINE("dshot_idle_value", "%d",                motorConfig()->digitalIdleOffsetValue);
         BLACKBOX_PRINT_HEADER_LINE("debug_mode", "%d",                      debugMode);
+#ifdef USE_DEBUG_CHANNELS
+        BLACKBOX_PRINT_HEADER_LINE("debug_channel_mode", "%d,%d,%d,%d,%d,%d,%d,%d", systemConfig()->debug_channel_mode[0],
+                                                                            systemConfig()->debug_channel_mode[1],
+                                                                            systemConfig()->debug_channel_mode[2],
+                                                                            systemConfig()->debug_channel_mode[3],
+                                                                            systemConfig()->debug_channel_mode[4],
+                                                                            systemConfig()->debug_channel_mode[5],
+                                                                            systemConfig()->debug_channel_mode[6],
+                                                                            systemConfig()->debug_channel_mode[7]);
+        BLACKBOX_PRINT_HEADER_LINE("debug_channel_slot", "%d,%d,%d,%d,%d,%d,%d,%d", systemConfig()->debug_channel_slot[0],
+                                                                            systemConfig()->debug_channel_slot[1],
+                                                                            systemConfig()->debug_channel_slot[2],
+                                                                            systemConfig()->debug_channel_slot[3],
+                                                                            systemConfig()->debug_channel_slot[4],
+                                                                            systemConfig()->debug_channel_slot[5],
+                                                                            systemConfig()->debug_channel_slot[6],
+                                                                            systemConfig()->debug_channel_slot[7]);
+#endif
         BLACKBOX_PRINT_HEADER_LINE("features", "%d",                        featureConfig()->enabledFeatures);
 
 #ifdef USE_RC_SMOOTHING_FILTER
@@ -1557,6 +1966,7 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
     }
 
     //Shared header for event frames
+    blackboxFrameBegin();
     blackboxWrite('E');
     blackboxWrite(event);
 
@@ -1582,11 +1992,28 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
         blackboxWriteUnsignedVB(data->loggingResume.logIteration);
         blackboxWriteUnsignedVB(data->loggingResume.currentTime);
         break;
+    case FLIGHT_LOG_EVENT_LOAD_SHED:
+        blackboxWrite(data->loadShed.level);
+        blackboxWriteUnsignedVB(data->loadShed.systemLoad);
+        break;
+    case FLIGHT_LOG_EVENT_LOOP_TIMING:
+        blackboxWriteUnsignedVB(data->loopTiming.avgLatencyUs);
+        blackboxWriteUnsignedVB(data->loopTiming.maxLatencyUs);
+        blackboxWriteUnsignedVB(data->loopTiming.avgPidTimeUs);
+        blackboxWriteUnsignedVB(data->loopTiming.maxPidTimeUs);
+        blackboxWriteUnsignedVB(data->loopTiming.overruns);
+        break;
+    case FLIGHT_LOG_EVENT_LOOP_OVERRUN:
+        blackboxWrite(data->loopOverrun.taskId);
+        blackboxWriteUnsignedVB(data->loopOverrun.lateUs);
+        blackboxWriteUnsignedVB(data->loopOverrun.taskTimeUs);
+        break;
     case FLIGHT_LOG_EVENT_LOG_END:
         blackboxWriteString("End of log");
         blackboxWrite(0);
         break;
     }
+    blackboxFrameCommit();
 }
 
 /* If an arming beep has played since it was last logged, write the time of the arming beep to the log as a synchronization point */
@@ -1614,6 +2041,44 @@ static void blackboxCheckAndLogFlightMode(void)
     }
 }
 
+/* log the scheduler slowing down or restoring the non-critical tasks */
+static void blackboxCheckAndLogLoadShed(void)
+{
+    const uint8_t loadShedLevel = schedulerGetLoadShedLevel();
+    if (loadShedLevel != blackboxLastLoadShedLevel) {
+        blackboxLastLoadShedLevel = loadShedLevel;
+        flightLogEvent_loadShed_t eventData;
+        eventData.level = loadShedLevel;
+        eventData.systemLoad = averageSystemLoadPercent;
+        blackboxLogEvent(FLIGHT_LOG_EVENT_LOAD_SHED, (flightLogEventData_t *)&eventData);
+    }
+}
+
+#ifdef USE_LOOP_TIMING
+/* log the loop timing summaries and the gyro loop overruns queued since the last frame */
+static void blackboxCheckAndLogLoopTiming(void)
+{
+    const loopTimingEvent_t *event;
+    while ((event = loopTimingPeekEvent())) {
+        flightLogEventData_t eventData;
+        if (event->type == LOOP_TIMING_EVENT_OVERRUN) {
+            eventData.loopOverrun.taskId = event->taskId;
+            eventData.loopOverrun.lateUs = event->lateUs;
+            eventData.loopOverrun.taskTimeUs = event->taskTimeUs;
+            blackboxLogEvent(FLIGHT_LOG_EVENT_LOOP_OVERRUN, &eventData);
+        } else {
+            eventData.loopTiming.avgLatencyUs = event->avgLatencyUs;
+            eventData.loopTiming.maxLatencyUs = event->maxLatencyUs;
+            eventData.loopTiming.avgPidTimeUs = event->avgPidTimeUs;
+            eventData.loopTiming.maxPidTimeUs = event->maxPidTimeUs;
+            eventData.loopTiming.overruns = event->overruns;
+            blackboxLogEvent(FLIGHT_LOG_EVENT_LOOP_TIMING, &eventData);
+        }
+        loopTimingReleaseEvent();
+    }
+}
+#endif
+
 STATIC_UNIT_TESTED bool blackboxShouldLogPFrame(void)
 {
     return blackboxPFrameIndex == 0 && blackboxConfig()->p_ratio != 0;
@@ -1624,6 +2089,27 @@ STATIC_UNIT_TESTED bool blackboxShouldLogIFrame(void)
     return blackboxLoopIndex == 0;
 }
 
+STATIC_UNIT_TESTED bool blackboxShouldLogFastFrame(void)
+{
+    return blackboxFastFrameIndex == 0 && blackboxFastInterval != 0;
+}
+
+// Called for every main frame that is logged. An I-frame always carries a heli frame, so that the "r" frames have a base.
+STATIC_UNIT_TESTED bool blackboxShouldLogHeliFrame(bool intraframe)
+{
+    if (blackboxHeliInterval == 0) {
+        return false;
+    }
+    if (intraframe) {
+        blackboxHeliFrameIndex = 0;
+    }
+    const bool due = blackboxHeliFrameIndex == 0;
+    if (++blackboxHeliFrameIndex >= blackboxHeliInterval) {
+        blackboxHeliFrameIndex = 0;
+    }
+    return due;
+}
+
 /*
  * If the GPS home point has been updated, or every 128 I-frames (~10 seconds), write the
  * GPS home position.
@@ -1642,10 +2128,8 @@ STATIC_UNIT_TESTED bool blackboxShouldLogGpsHomeFrame(void)
 }
 #endif // GPS
 
-// Called once every FC loop in order to keep track of how many FC loop iterations have passed
-STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void)
+static void blackboxAdvanceLoopIndexes(void)
 {
-    ++blackboxSlowFrameIterationTimer;
     ++blackboxIteration;
 
     if (++blackboxLoopIndex >= blackboxIInterval) {
@@ -1655,6 +2139,17 @@ STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void)
     } else if (++blackboxPFrameIndex >= blackboxPInterval) {
         blackboxPFrameIndex = 0;
     }
+
+    if (++blackboxFastFrameIndex >= blackboxFastInterval) {
+        blackboxFastFrameIndex = 0;
+    }
+}
+
+// Called once every FC loop in order to keep track of how many FC loop iterations have passed
+STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void)
+{
+    ++blackboxSlowFrameIterationTimer;
+    blackboxAdvanceLoopIndexes();
 }
 
 // Called once every FC loop in order to log the current state
@@ -1670,11 +2165,20 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
             writeSlowFrameIfNeeded();
         }
 
-        loadMainState(currentTimeUs);
-        writeIntraframe();
+        loadMainState(blackboxHistory[0], currentTimeUs);
+        writeIntraframe(blackboxIteration);
+
+        if (blackboxShouldLogHeliFrame(true)) {
+            loadHeliState(blackboxHeliHistory[0]);
+            writeHeliFrame();
+        }
     } else {
         blackboxCheckAndLogArmingBeep();
         blackboxCheckAndLogFlightMode(); // Check for FlightMode status change event
+        blackboxCheckAndLogLoadShed();
+#ifdef USE_LOOP_TIMING
+        blackboxCheckAndLogLoopTiming();
+#endif
 
         if (blackboxShouldLogPFrame()) {
             /*
@@ -1683,8 +2187,13 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
              */
             writeSlowFrameIfNeeded();
 
-            loadMainState(currentTimeUs);
+            loadMainState(blackboxHistory[0], currentTimeUs);
             writeInterframe();
+
+            if (blackboxShouldLogHeliFrame(false)) {
+                loadHeliState(blackboxHeliHistory[0]);
+                writeHeliFrame();
+            }
         }
 #ifdef USE_GPS
         if (featureIsEnabled(FEATURE_GPS)) {
@@ -1701,14 +2210,171 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
 #endif
     }
 
+    if (blackboxShouldLogFastFrame()) {
+        loadFastState(blackboxFastHistory[0], currentTimeUs);
+        writeFastFrame();
+    }
+
     //Flush every iteration so that our runtime variance is minimized
     blackboxDeviceFlush();
 }
 
-/**
- * Call each flight loop iteration to perform blackbox logging.
- */
-void blackboxUpdate(timeUs_t currentTimeUs)
+#ifdef USE_BLACKBOX_OFFLOAD
+// Called from the PID loop, captures the state of the iterations that are logged
+static void blackboxCapture(timeUs_t currentTimeUs)
+{
+    const uint8_t request = blackboxCaptureRequest;
+
+    if (request == BLACKBOX_CAPTURE_OFF) {
+        blackboxCapturing = false;
+        blackboxCaptureResume = false;
+        return;
+    }
+
+    if (request == BLACKBOX_CAPTURE_PAUSED) {
+        if (blackboxCapturing) {
+            blackboxCapturing = false;
+            blackboxCaptureResume = true;
+        }
+    } else if (blackboxShouldLogIFrame() || (blackboxCapturing && blackboxShouldLogPFrame())) {
+        // Capturing (re)starts on an I-frame, so that the encoder has an "I" base to work from
+        blackboxCaptureEntry_t *entry = spscQueueProducerSlot(&blackboxCaptureQueue);
+        if (entry) {
+            loadMainState(&entry->state, currentTimeUs);
+            entry->iteration = blackboxIteration;
+            entry->flags = (blackboxShouldLogIFrame() ? BLACKBOX_CAPTURE_FLAG_IFRAME : 0)
+                | (blackboxCaptureResume ? BLACKBOX_CAPTURE_FLAG_RESUME : 0);
+            if (blackboxShouldLogHeliFrame(blackboxShouldLogIFrame())) {
+                loadHeliState(&entry->heli);
+                entry->flags |= BLACKBOX_CAPTURE_FLAG_HELI;
+            }
+            spscQueueProducerCommit(&blackboxCaptureQueue);
+
+            blackboxCapturing = true;
+            blackboxCaptureResume = false;
+        } else {
+            // The background task fell behind, drop frames until the next I-frame
+            blackboxCapturing = false;
+            blackboxCaptureResume = true;
+        }
+    }
+
+    // The fast frames are predicted from the ones that were logged, so a full queue just skips one
+    if (blackboxCapturing && blackboxShouldLogFastFrame()) {
+        blackboxFastState_t *fast = spscQueueProducerSlot(&blackboxFastQueue);
+        if (fast) {
+            loadFastState(fast, currentTimeUs);
+            spscQueueProducerCommit(&blackboxFastQueue);
+        }
+    }
+
+    // Keep the logging timers ticking while paused so our log iteration continues to advance
+    blackboxAdvanceLoopIndexes();
+}
+
+// Called from the blackbox task, encodes the captured frames
+static void blackboxLogCaptured(timeUs_t currentTimeUs)
+{
+    bool loggedFrames = false;
+    bool homeFrameDue = false;
+
+    blackboxCaptureEntry_t *entry;
+    while ((entry = spscQueueConsumerPeek(&blackboxCaptureQueue))) {
+        if (entry->flags & BLACKBOX_CAPTURE_FLAG_RESUME) {
+            // Write a log entry so the decoder is aware that our large time/iteration skip is intended
+            flightLogEvent_loggingResume_t resume;
+
+            resume.logIteration = entry->iteration;
+            resume.currentTime = entry->state.time;
+
+            blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RESUME, (flightLogEventData_t *) &resume);
+        }
+
+        const uint32_t iterations = entry->iteration - blackboxLastCapturedIteration;
+        blackboxLastCapturedIteration = entry->iteration;
+        if (iterations < (uint32_t)blackboxSInterval) {
+            blackboxSlowFrameIterationTimer += iterations;
+        } else {
+            blackboxSlowFrameIterationTimer = blackboxSInterval;
+        }
+
+        *blackboxHistory[0] = entry->state;
+
+        if (entry->flags & BLACKBOX_CAPTURE_FLAG_IFRAME) {
+            if (blackboxIsOnlyLoggingIntraframes()) {
+                writeSlowFrameIfNeeded();
+            }
+            writeIntraframe(entry->iteration);
+            homeFrameDue = (++blackboxCapturedIFrameCount % 128 == 0);
+        } else {
+            writeSlowFrameIfNeeded();
+            writeInterframe();
+        }
+
+        if (entry->flags & BLACKBOX_CAPTURE_FLAG_HELI) {
+            *blackboxHeliHistory[0] = entry->heli;
+            writeHeliFrame();
+        }
+
+        spscQueueConsumerRelease(&blackboxCaptureQueue);
+        loggedFrames = true;
+    }
+
+    blackboxFastState_t *fast;
+    while ((fast = spscQueueConsumerPeek(&blackboxFastQueue))) {
+        *blackboxFastHistory[0] = *fast;
+        writeFastFrame();
+
+        spscQueueConsumerRelease(&blackboxFastQueue);
+        loggedFrames = true;
+    }
+
+    if (!loggedFrames) {
+        return;
+    }
+
+    blackboxCheckAndLogArmingBeep();
+    blackboxCheckAndLogFlightMode();
+    blackboxCheckAndLogLoadShed();
+#ifdef USE_LOOP_TIMING
+    blackboxCheckAndLogLoopTiming();
+#endif
+
+#ifdef USE_GPS
+    if (featureIsEnabled(FEATURE_GPS)) {
+        if (homeFrameDue || GPS_home[0] != gpsHistory.GPS_home[0] || GPS_home[1] != gpsHistory.GPS_home[1]) {
+            writeGPSHomeFrame();
+            writeGPSFrame(currentTimeUs);
+        } else if (gpsSol.numSat != gpsHistory.GPS_numSat
+                || gpsSol.llh.lat != gpsHistory.GPS_coord[LAT]
+                || gpsSol.llh.lon != gpsHistory.GPS_coord[LON]) {
+            writeGPSFrame(currentTimeUs);
+        }
+    }
+#else
+    UNUSED(homeFrameDue);
+    UNUSED(currentTimeUs);
+#endif
+
+    blackboxDeviceFlush();
+}
+
+static void blackboxUpdateOffloaded(timeUs_t currentTimeUs)
+{
+    if (blackboxState == BLACKBOX_STATE_PAUSED) {
+        if (IS_RC_MODE_ACTIVE(BOXBLACKBOX)) {
+            blackboxSetState(BLACKBOX_STATE_RUNNING);
+        }
+    } else if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX) && !startedLoggingInTestMode) {
+        blackboxSetState(BLACKBOX_STATE_PAUSED);
+    }
+
+    // Frames captured before a pause are still written
+    blackboxLogCaptured(currentTimeUs);
+}
+#endif
+
+static void blackboxProcess(timeUs_t currentTimeUs)
 {
     switch (blackboxState) {
     case BLACKBOX_STATE_STOPPED:
@@ -1719,6 +2385,8 @@ void blackboxUpdate(timeUs_t currentTimeUs)
 #ifdef USE_FLASHFS
         if (IS_RC_MODE_ACTIVE(BOXBLACKBOXERASE)) {
             blackboxSetState(BLACKBOX_STATE_START_ERASE);
+        } else if (blackboxState == BLACKBOX_STATE_STOPPED) {
+            blackboxEraseAhead();
         }
 #endif
         break;
@@ -1783,6 +2451,32 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
         if (!sendFieldDefinition('S', 0, blackboxSlowFields, blackboxSlowFields + 1, ARRAYLEN(blackboxSlowFields),
                 NULL, NULL)) {
+            if (blackboxFastInterval) {
+                blackboxSetState(BLACKBOX_STATE_SEND_FAST_HEADER);
+            } else if (blackboxHeliInterval) {
+                blackboxSetState(BLACKBOX_STATE_SEND_HELI_HEADER);
+            } else {
+                blackboxSetState(BLACKBOX_STATE_SEND_SYSINFO);
+            }
+        }
+        break;
+    case BLACKBOX_STATE_SEND_FAST_HEADER:
+        blackboxReplenishHeaderBudget();
+        //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
+        if (!sendFieldDefinition('F', 'f', blackboxFastFields, blackboxFastFields + 1, ARRAYLEN(blackboxFastFields),
+                &blackboxFastFields[0].condition, &blackboxFastFields[1].condition)) {
+            if (blackboxHeliInterval) {
+                blackboxSetState(BLACKBOX_STATE_SEND_HELI_HEADER);
+            } else {
+                blackboxSetState(BLACKBOX_STATE_SEND_SYSINFO);
+            }
+        }
+        break;
+    case BLACKBOX_STATE_SEND_HELI_HEADER:
+        blackboxReplenishHeaderBudget();
+        //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
+        if (!sendFieldDefinition('R', 'r', blackboxHeliFields, blackboxHeliFields + 1, ARRAYLEN(blackboxHeliFields),
+                &blackboxHeliFields[0].condition, &blackboxHeliFields[1].condition)) {
             blackboxSetState(BLACKBOX_STATE_SEND_SYSINFO);
         }
         break;
@@ -1798,11 +2492,19 @@ void blackboxUpdate(timeUs_t currentTimeUs)
              * could wipe out the end of the header if we weren't careful)
              */
             if (blackboxDeviceFlushForce()) {
+                // The headers stay readable as text, only the frames are compressed
+                blackboxDeviceSetCompression(true);
                 blackboxSetState(BLACKBOX_STATE_RUNNING);
             }
         }
         break;
     case BLACKBOX_STATE_PAUSED:
+#ifdef USE_BLACKBOX_OFFLOAD
+        if (blackboxOffloaded) {
+            blackboxUpdateOffloaded(currentTimeUs);
+            break;
+        }
+#endif
         // Only allow resume to occur during an I-frame iteration, so that we have an "I" base to work from
         if (IS_RC_MODE_ACTIVE(BOXBLACKBOX) && blackboxShouldLogIFrame()) {
             // Write a log entry so the decoder is aware that our large time/iteration skip is intended
@@ -1820,6 +2522,12 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         blackboxAdvanceIterationTimers();
         break;
     case BLACKBOX_STATE_RUNNING:
+#ifdef USE_BLACKBOX_OFFLOAD
+        if (blackboxOffloaded) {
+            blackboxUpdateOffloaded(currentTimeUs);
+            break;
+        }
+#endif
         // On entry to this state, blackboxIteration, blackboxPFrameIndex and blackboxIFrameIndex are reset to 0
         // Prevent the Pausing of the log on the mode switch if in Motor Test Mode
         if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX) && !startedLoggingInTestMode) {
@@ -1908,6 +2616,84 @@ void blackboxUpdate(timeUs_t currentTimeUs)
     }
 }
 
+/**
+ * Call each flight loop iteration to perform blackbox logging.
+ */
+void blackboxUpdate(timeUs_t currentTimeUs)
+{
+#ifdef USE_BLACKBOX_OFFLOAD
+    if (blackboxOffloaded) {
+        blackboxCapture(currentTimeUs);
+        return;
+    }
+#endif
+    blackboxProcess(currentTimeUs);
+}
+
+#ifdef USE_BENCHMARK
+// Load the current state for blackboxBenchmarkFrame(). Only while not logging, it takes over the history.
+bool blackboxBenchmarkPrepare(void)
+{
+    if (!blackboxMayEditConfig()) {
+        return false;
+    }
+
+    blackboxBuildConditionCache();
+    blackboxBuildFramePrograms();
+
+    loadMainState(&blackboxHistoryRing[0], micros());
+    for (int i = 0; i < 3; i++) {
+        blackboxHistory[i] = &blackboxHistoryRing[0];
+    }
+
+    return true;
+}
+
+// Encode the state as an I-frame into the frame buffer and drop it, nothing reaches the device
+void blackboxBenchmarkFrame(void)
+{
+    const void *history[3] = { blackboxHistory[0], blackboxHistory[1], blackboxHistory[2] };
+
+    blackboxFrameBeginScratch();
+    blackboxWrite('I');
+    blackboxWriteFrameProgram(blackboxIFrameProgram, blackboxIFrameProgramLength, history, blackboxIteration);
+    blackboxFrameDiscard();
+}
+#endif
+
+#ifdef USE_BLACKBOX_OFFLOAD
+/**
+ * Moves the encoding and the device I/O out of blackboxUpdate() into blackboxBackgroundUpdate(). Call before
+ * the PID loop starts running.
+ */
+void blackboxSetOffload(bool enabled)
+{
+    blackboxOffloaded = enabled;
+}
+
+bool blackboxIsOffloaded(void)
+{
+    return blackboxOffloaded;
+}
+
+/**
+ * Call from the background blackbox task when the blackbox is offloaded.
+ */
+void blackboxBackgroundUpdate(timeUs_t currentTimeUs)
+{
+    if (!blackboxOffloaded) {
+        return;
+    }
+
+    if (blackboxFinishPending) {
+        blackboxFinishPending = false;
+        blackboxFinishLog();
+    }
+
+    blackboxProcess(currentTimeUs);
+}
+#endif
+
 int blackboxCalculatePDenom(int rateNum, int rateDenom)
 {
     return blackboxIInterval * rateNum / rateDenom;
@@ -1925,6 +2711,12 @@ uint8_t blackboxGetRateDenom(void)
 void blackboxInit(void)
 {
     blackboxResetIterationTimers();
+#ifdef USE_BLACKBOX_OFFLOAD
+    spscQueueInit(&blackboxCaptureQueue, blackboxCaptureBuffer, sizeof(blackboxCaptureBuffer[0]), BLACKBOX_CAPTURE_QUEUE_SIZE);
+    spscQueueInit(&blackboxFastQueue, blackboxFastBuffer, sizeof(blackboxFastBuffer[0]), BLACKBOX_FAST_QUEUE_SIZE);
+    spscQueueRegister(&blackboxCaptureQueue, "BLACKBOX_CAPTURE");
+    spscQueueRegister(&blackboxFastQueue, "BLACKBOX_FAST");
+#endif
 
     // an I-frame is written every 32ms
     // blackboxUpdate() is run in synchronisation with the PID loop
@@ -1951,5 +2743,7 @@ void blackboxInit(void)
         blackboxSetState(BLACKBOX_STATE_DISABLED);
     }
     blackboxSInterval = blackboxIInterval * 256; // S-frame is written every 256*32 = 8192ms, approx every 8 seconds
+    blackboxFastInterval = blackboxConfig()->fast_denom;
+    blackboxHeliInterval = blackboxConfig()->heli_denom;
 }
 #endif
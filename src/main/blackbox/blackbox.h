@@ -38,10 +38,18 @@ typedef enum BlackboxMode {
     BLACKBOX_MODE_ALWAYS_ON
 } BlackboxMode;
 
+typedef enum BlackboxCompression {
+    BLACKBOX_COMPRESSION_NONE = 0,
+    BLACKBOX_COMPRESSION_HUFFMAN
+} BlackboxCompression_e;
+
 typedef enum FlightLogEvent {
     FLIGHT_LOG_EVENT_SYNC_BEEP = 0,
     FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT = 13,
     FLIGHT_LOG_EVENT_LOGGING_RESUME = 14,
+    FLIGHT_LOG_EVENT_LOAD_SHED = 16,
+    FLIGHT_LOG_EVENT_LOOP_TIMING = 17,
+    FLIGHT_LOG_EVENT_LOOP_OVERRUN = 18,
     FLIGHT_LOG_EVENT_FLIGHTMODE = 30, // Add new event type for flight mode status.
     FLIGHT_LOG_EVENT_LOG_END = 255
 } FlightLogEvent;
@@ -51,6 +59,9 @@ typedef struct blackboxConfig_s {
     uint8_t device;
     uint8_t record_acc;
     uint8_t mode;
+    uint8_t fast_denom; // log a fast gyro/setpoint frame every fast_denom PID loop iterations, 0 = off
+    uint8_t compression; // BLACKBOX_COMPRESSION_*, applied to the logged frames but not the headers
+    uint8_t heli_denom; // log a heli rotor/governor frame every heli_denom main frames, 0 = off
 } blackboxConfig_t;
 
 PG_DECLARE(blackboxConfig_t, blackboxConfig);
@@ -66,10 +77,23 @@ uint8_t blackboxGetRateDenom(void);
 void blackboxValidateConfig(void);
 void blackboxFinish(void);
 bool blackboxMayEditConfig(void);
+#ifdef USE_BLACKBOX_OFFLOAD
+#define BLACKBOX_TASK_RATE_HZ 1000
+
+void blackboxSetOffload(bool enabled);
+bool blackboxIsOffloaded(void);
+void blackboxBackgroundUpdate(timeUs_t currentTimeUs);
+#endif
+#ifdef USE_BENCHMARK
+bool blackboxBenchmarkPrepare(void);
+void blackboxBenchmarkFrame(void);
+#endif
 #ifdef UNIT_TEST
 STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs);
 STATIC_UNIT_TESTED bool blackboxShouldLogPFrame(void);
 STATIC_UNIT_TESTED bool blackboxShouldLogIFrame(void);
+STATIC_UNIT_TESTED bool blackboxShouldLogFastFrame(void);
+STATIC_UNIT_TESTED bool blackboxShouldLogHeliFrame(bool intraframe);
 STATIC_UNIT_TESTED bool blackboxShouldLogGpsHomeFrame(void);
 STATIC_UNIT_TESTED bool writeSlowFrameIfNeeded(void);
 // Called once every FC loop in order to keep track of how many FC loop iterations have passed
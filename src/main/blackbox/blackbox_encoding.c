@@ -69,6 +69,7 @@ void blackboxPrintfHeaderLine(const char *name, const char *fmt, ...)
 {
     va_list va;
 
+    blackboxFrameBegin();
     blackboxWrite('H');
     blackboxWrite(' ');
     blackboxWriteString(name);
@@ -81,6 +82,7 @@ void blackboxPrintfHeaderLine(const char *name, const char *fmt, ...)
     va_end(va);
 
     blackboxWrite('\n');
+    blackboxFrameCommit();
 
     blackboxHeaderBudget -= written + 3;
 }
@@ -90,12 +92,16 @@ void blackboxPrintfHeaderLine(const char *name, const char *fmt, ...)
  */
 void blackboxWriteUnsignedVB(uint32_t value)
 {
+    uint8_t *buf = blackboxReserve(5);
+
     //While this isn't the final byte (we can only write 7 bits at a time)
     while (value > 127) {
-        blackboxWrite((uint8_t) (value | 0x80)); // Set the high bit to mean "more bytes follow"
+        *buf++ = (uint8_t) (value | 0x80); // Set the high bit to mean "more bytes follow"
         value >>= 7;
     }
-    blackboxWrite(value);
+    *buf++ = value;
+
+    blackboxCommit(buf);
 }
 
 /**
@@ -123,8 +129,12 @@ void blackboxWriteSigned16VBArray(int16_t *array, int count)
 
 void blackboxWriteS16(int16_t value)
 {
-    blackboxWrite(value & 0xFF);
-    blackboxWrite((value >> 8) & 0xFF);
+    uint8_t *buf = blackboxReserve(2);
+
+    *buf++ = value & 0xFF;
+    *buf++ = (value >> 8) & 0xFF;
+
+    blackboxCommit(buf);
 }
 
 /**
@@ -151,6 +161,8 @@ void blackboxWriteTag2_3S32(int32_t *values)
 
     int selector = BITS_2, selector2;
 
+    uint8_t *buf = blackboxReserve(13);
+
     /*
      * Find out how many bits the largest value requires to encode, and use it to choose one of the packing schemes
      * below:
@@ -183,16 +195,16 @@ void blackboxWriteTag2_3S32(int32_t *values)
 
     switch (selector) {
     case BITS_2:
-        blackboxWrite((selector << 6) | ((values[0] & 0x03) << 4) | ((values[1] & 0x03) << 2) | (values[2] & 0x03));
+        *buf++ = (selector << 6) | ((values[0] & 0x03) << 4) | ((values[1] & 0x03) << 2) | (values[2] & 0x03);
         break;
     case BITS_4:
-        blackboxWrite((selector << 6) | (values[0] & 0x0F));
-        blackboxWrite((values[1] << 4) | (values[2] & 0x0F));
+        *buf++ = (selector << 6) | (values[0] & 0x0F);
+        *buf++ = (values[1] << 4) | (values[2] & 0x0F);
         break;
     case BITS_6:
-        blackboxWrite((selector << 6) | (values[0] & 0x3F));
-        blackboxWrite((uint8_t)values[1]);
-        blackboxWrite((uint8_t)values[2]);
+        *buf++ = (selector << 6) | (values[0] & 0x3F);
+        *buf++ = (uint8_t)values[1];
+        *buf++ = (uint8_t)values[2];
         break;
     case BITS_32:
         /*
@@ -222,33 +234,35 @@ void blackboxWriteTag2_3S32(int32_t *values)
         }
 
         //Write the selectors
-        blackboxWrite((selector << 6) | selector2);
+        *buf++ = (selector << 6) | selector2;
 
         //And now the values according to the selectors we picked for them
         for (int x = 0; x < NUM_FIELDS; x++, selector2 >>= 2) {
             switch (selector2 & 0x03) {
             case BYTES_1:
-                blackboxWrite(values[x]);
+                *buf++ = values[x];
                 break;
             case BYTES_2:
-                blackboxWrite(values[x]);
-                blackboxWrite(values[x] >> 8);
+                *buf++ = values[x];
+                *buf++ = values[x] >> 8;
                 break;
             case BYTES_3:
-                blackboxWrite(values[x]);
-                blackboxWrite(values[x] >> 8);
-                blackboxWrite(values[x] >> 16);
+                *buf++ = values[x];
+                *buf++ = values[x] >> 8;
+                *buf++ = values[x] >> 16;
                 break;
             case BYTES_4:
-                blackboxWrite(values[x]);
-                blackboxWrite(values[x] >> 8);
-                blackboxWrite(values[x] >> 16);
-                blackboxWrite(values[x] >> 24);
+                *buf++ = values[x];
+                *buf++ = values[x] >> 8;
+                *buf++ = values[x] >> 16;
+                *buf++ = values[x] >> 24;
                 break;
             }
         }
         break;
     }
+
+    blackboxCommit(buf);
 }
 
 /**
@@ -285,6 +299,7 @@ int blackboxWriteTag2_3SVariable(int32_t *values)
      */
     int selector = BITS_2;
     int selector2 = 0;
+    uint8_t *buf = blackboxReserve(13);
     // Require more than 877 bits?
     if (values[0] >= 256 || values[0] < -256
             || values[1] >= 128 || values[1] < -128
@@ -304,18 +319,18 @@ int blackboxWriteTag2_3SVariable(int32_t *values)
 
     switch (selector) {
     case BITS_2:
-        blackboxWrite((selector << 6) | ((values[0] & 0x03) << 4) | ((values[1] & 0x03) << 2) | (values[2] & 0x03));
+        *buf++ = (selector << 6) | ((values[0] & 0x03) << 4) | ((values[1] & 0x03) << 2) | (values[2] & 0x03);
         break;
     case BITS_554:
         // 554 bits per field  ss11 1112 2222 3333
-        blackboxWrite((selector << 6) | ((values[0] & 0x1F) << 1) | ((values[1] & 0x1F) >> 4));
-        blackboxWrite(((values[1] & 0x0F) << 4) | (values[2] & 0x0F));
+        *buf++ = (selector << 6) | ((values[0] & 0x1F) << 1) | ((values[1] & 0x1F) >> 4);
+        *buf++ = ((values[1] & 0x0F) << 4) | (values[2] & 0x0F);
         break;
     case BITS_877:
         // 877 bits per field  ss11 1111 1122 2222 2333 3333
-        blackboxWrite((selector << 6) | ((values[0] & 0xFF) >> 2));
-        blackboxWrite(((values[0] & 0x03) << 6) | ((values[1] & 0x7F) >> 1));
-        blackboxWrite(((values[1] & 0x01) << 7) | (values[2] & 0x7F));
+        *buf++ = (selector << 6) | ((values[0] & 0xFF) >> 2);
+        *buf++ = ((values[0] & 0x03) << 6) | ((values[1] & 0x7F) >> 1);
+        *buf++ = ((values[1] & 0x01) << 7) | (values[2] & 0x7F);
         break;
     case BITS_32:
         /*
@@ -344,33 +359,36 @@ int blackboxWriteTag2_3SVariable(int32_t *values)
         }
 
         //Write the selectors
-        blackboxWrite((selector << 6) | selector2);
+        *buf++ = (selector << 6) | selector2;
 
         //And now the values according to the selectors we picked for them
         for (int x = 0; x < FIELD_COUNT; x++, selector2 >>= 2) {
             switch (selector2 & 0x03) {
             case BYTES_1:
-                blackboxWrite(values[x]);
+                *buf++ = values[x];
                 break;
             case BYTES_2:
-                blackboxWrite(values[x]);
-                blackboxWrite(values[x] >> 8);
+                *buf++ = values[x];
+                *buf++ = values[x] >> 8;
                 break;
             case BYTES_3:
-                blackboxWrite(values[x]);
-                blackboxWrite(values[x] >> 8);
-                blackboxWrite(values[x] >> 16);
+                *buf++ = values[x];
+                *buf++ = values[x] >> 8;
+                *buf++ = values[x] >> 16;
                 break;
             case BYTES_4:
-                blackboxWrite(values[x]);
-                blackboxWrite(values[x] >> 8);
-                blackboxWrite(values[x] >> 16);
-                blackboxWrite(values[x] >> 24);
+                *buf++ = values[x];
+                *buf++ = values[x] >> 8;
+                *buf++ = values[x] >> 16;
+                *buf++ = values[x] >> 24;
                 break;
             }
         }
     break;
     }
+
+    blackboxCommit(buf);
+
     return selector;
 }
 
@@ -404,7 +422,9 @@ void blackboxWriteTag8_4S16(int32_t *values)
         }
     }
 
-    blackboxWrite(selector);
+    uint8_t *buf = blackboxReserve(9);
+
+    *buf++ = selector;
 
     int nibbleIndex = 0;
     uint8_t buffer = 0;
@@ -419,16 +439,16 @@ void blackboxWriteTag8_4S16(int32_t *values)
                 buffer = values[x] << 4;
                 nibbleIndex = 1;
             } else {
-                blackboxWrite(buffer | (values[x] & 0x0F));
+                *buf++ = buffer | (values[x] & 0x0F);
                 nibbleIndex = 0;
             }
             break;
         case FIELD_8BIT:
             if (nibbleIndex == 0) {
-                blackboxWrite(values[x]);
+                *buf++ = values[x];
             } else {
                 //Write the high bits of the value first (mask to avoid sign extension)
-                blackboxWrite(buffer | ((values[x] >> 4) & 0x0F));
+                *buf++ = buffer | ((values[x] >> 4) & 0x0F);
                 //Now put the leftover low bits into the top of the next buffer entry
                 buffer = values[x] << 4;
             }
@@ -436,13 +456,13 @@ void blackboxWriteTag8_4S16(int32_t *values)
         case FIELD_16BIT:
             if (nibbleIndex == 0) {
                 //Write high byte first
-                blackboxWrite(values[x] >> 8);
-                blackboxWrite(values[x]);
+                *buf++ = values[x] >> 8;
+                *buf++ = values[x];
             } else {
                 //First write the highest 4 bits
-                blackboxWrite(buffer | ((values[x] >> 12) & 0x0F));
+                *buf++ = buffer | ((values[x] >> 12) & 0x0F);
                 // Then the middle 8
-                blackboxWrite(values[x] >> 4);
+                *buf++ = values[x] >> 4;
                 //Only the smallest 4 bits are still left to write
                 buffer = values[x] << 4;
             }
@@ -451,8 +471,10 @@ void blackboxWriteTag8_4S16(int32_t *values)
     }
     //Anything left over to write?
     if (nibbleIndex == 1) {
-        blackboxWrite(buffer);
+        *buf++ = buffer;
     }
+
+    blackboxCommit(buf);
 }
 
 /**
@@ -496,10 +518,14 @@ void blackboxWriteTag8_8SVB(int32_t *values, int valueCount)
 /** Write unsigned integer **/
 void blackboxWriteU32(int32_t value)
 {
-    blackboxWrite(value & 0xFF);
-    blackboxWrite((value >> 8) & 0xFF);
-    blackboxWrite((value >> 16) & 0xFF);
-    blackboxWrite((value >> 24) & 0xFF);
+    uint8_t *buf = blackboxReserve(4);
+
+    *buf++ = value & 0xFF;
+    *buf++ = (value >> 8) & 0xFF;
+    *buf++ = (value >> 16) & 0xFF;
+    *buf++ = (value >> 24) & 0xFF;
+
+    blackboxCommit(buf);
 }
 
 /** Write float value in the integer form **/
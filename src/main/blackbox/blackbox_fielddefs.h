@@ -47,6 +47,10 @@ typedef enum FlightLogFieldCondition {
 
     FLIGHT_LOG_FIELD_CONDITION_ACC,
     FLIGHT_LOG_FIELD_CONDITION_DEBUG,
+    FLIGHT_LOG_FIELD_CONDITION_DEBUG_CHANNELS,
+
+    FLIGHT_LOG_FIELD_CONDITION_HELI,
+    FLIGHT_LOG_FIELD_CONDITION_VIBRATION,
 
     FLIGHT_LOG_FIELD_CONDITION_NEVER,
 
@@ -130,6 +134,25 @@ typedef struct flightLogEvent_loggingResume_s {
     uint32_t currentTime;
 } flightLogEvent_loggingResume_t;
 
+typedef struct flightLogEvent_loadShed_s {
+    uint8_t level;
+    uint16_t systemLoad;
+} flightLogEvent_loadShed_t;
+
+typedef struct flightLogEvent_loopTiming_s {
+    uint16_t avgLatencyUs;
+    uint16_t maxLatencyUs;
+    uint16_t avgPidTimeUs;
+    uint16_t maxPidTimeUs;
+    uint16_t overruns;
+} flightLogEvent_loopTiming_t;
+
+typedef struct flightLogEvent_loopOverrun_s {
+    uint8_t taskId;
+    uint16_t lateUs;
+    uint16_t taskTimeUs;
+} flightLogEvent_loopOverrun_t;
+
 #define FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT_FUNCTION_FLOAT_VALUE_FLAG 128
 
 typedef union flightLogEventData_u {
@@ -137,6 +160,9 @@ typedef union flightLogEventData_u {
     flightLogEvent_flightMode_t flightMode; // New event data
     flightLogEvent_inflightAdjustment_t inflightAdjustment;
     flightLogEvent_loggingResume_t loggingResume;
+    flightLogEvent_loadShed_t loadShed;
+    flightLogEvent_loopTiming_t loopTiming;
+    flightLogEvent_loopOverrun_t loopOverrun;
 } flightLogEventData_t;
 
 typedef struct flightLogEvent_s {
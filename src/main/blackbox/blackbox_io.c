@@ -45,6 +45,7 @@
 #include "blackbox.h"
 #include "blackbox_io.h"
 
+#include "common/huffman.h"
 #include "common/maths.h"
 
 #include "flight/pid.h"
@@ -93,6 +94,15 @@ static struct {
 
 #endif // USE_SDCARD
 
+#ifdef USE_FLASHFS_LOG_INDEX
+// The log being written to flash, for its log index entry
+static struct {
+    bool open;
+    uint32_t offset;
+    timeMs_t startTime;
+} blackboxFlashLog;
+#endif
+
 void blackboxOpen(void)
 {
     serialPort_t *sharedBlackboxAndMspPort = findSharedSerialPort(FUNCTION_BLACKBOX, FUNCTION_MSP);
@@ -105,44 +115,51 @@ void blackboxOpen(void)
 static uint32_t bbBits;
 static timeMs_t bbLastclearMs;
 static uint16_t bbRateMax;
-static uint32_t bbDrops;
 #endif
 
-void blackboxWrite(uint8_t value)
+// Bytes the serial port or the SD card had no room for since boot
+static uint32_t bbDrops;
+
+static uint8_t blackboxFrameBuffer[BLACKBOX_FRAME_BUFFER_SIZE];
+static int blackboxFrameLength;
+static bool blackboxFrameOpen;
+static bool blackboxFrameScratch;     // the frame is dropped, never passed on
+
+// Hand a contiguous block of log data to the device with a single write
+static void blackboxDeviceWrite(const uint8_t *data, int length)
 {
 #ifdef DEBUG_BB_OUTPUT
-    bbBits += 8;
+    bbBits += length * 8;
 #endif
 
     switch (blackboxConfig()->device) {
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
-        flashfsWriteByte(value); // Write byte asynchronously
+        flashfsWrite(data, length, false); // Write asynchronously
         break;
 #endif
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
-        afatfs_fputc(blackboxSDCard.logFile, value);
+        bbDrops += length - afatfs_fwrite(blackboxSDCard.logFile, data, length); // Counted as dropped when the buffers are full
         break;
 #endif
     case BLACKBOX_DEVICE_SERIAL:
     default:
         {
-            int txBytesFree = serialTxBytesFree(blackboxPort);
+            const int txBytesFree = serialTxBytesFree(blackboxPort);
+            const int written = MIN(txBytesFree, length);
+
+            bbDrops += length - written;
 
 #ifdef DEBUG_BB_OUTPUT
-            bbBits += 2;
+            bbBits += length * 2;
+            DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 2, bbDrops);
             DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 3, txBytesFree);
 #endif
 
-            if (txBytesFree == 0) {
-#ifdef DEBUG_BB_OUTPUT
-                ++bbDrops;
-                DEBUG_SET(DEBUG_BLACKBOX_OUTPUT, 2, bbDrops);
-#endif
-                return;
+            if (written > 0) {
+                serialWriteBuf(blackboxPort, data, written);
             }
-            serialWrite(blackboxPort, value);
         }
         break;
     }
@@ -163,13 +180,264 @@ void blackboxWrite(uint8_t value)
 #endif
 }
 
+#ifdef USE_BLACKBOX_COMPRESSION
+/*
+ * With compression enabled the logged frames are collected into blocks which are huffman coded with the static table
+ * before they are handed to the device. Each block is written as
+ *
+ *     'Z', uncompressed length (U16), compressed length (U16), payload
+ *
+ * A compressed length of zero means the payload is stored uncompressed, when coding didn't make the block smaller.
+ *
+ * A block only reaches the log whole. It is written in pieces that fit the free space of the device buffers, a new
+ * block is dropped as long as the device hasn't taken all of the previous one.
+ */
+#define BLACKBOX_COMPRESSION_BLOCK_SIZE    512
+#define BLACKBOX_COMPRESSION_BLOCK_MARKER  'Z'
+#define BLACKBOX_COMPRESSION_HEADER_SIZE   5
+
+static bool blackboxCompressing;
+static uint8_t blackboxBlock[BLACKBOX_COMPRESSION_BLOCK_SIZE];
+static int blackboxBlockLength;
+static uint8_t blackboxCompressedBlock[BLACKBOX_COMPRESSION_HEADER_SIZE + BLACKBOX_COMPRESSION_BLOCK_SIZE];
+static int blackboxCompressedLength;
+static int blackboxCompressedWritten;
+
+/**
+ * Hand as much of the compressed block to the device as it has room for right now.
+ *
+ * Returns true once the device has taken all of it.
+ */
+static bool blackboxWriteCompressedBlock(void)
+{
+    while (blackboxCompressedWritten < blackboxCompressedLength) {
+        const uint8_t *data = blackboxCompressedBlock + blackboxCompressedWritten;
+        const int remaining = blackboxCompressedLength - blackboxCompressedWritten;
+        int written = 0;
+
+        switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+        case BLACKBOX_DEVICE_FLASH:
+            // flashfs drops an asynchronous write that doesn't fit its buffer, so never hand it more than that
+            written = MIN(remaining, (int)flashfsGetWriteBufferFreeSpace());
+            if (written > 0) {
+                flashfsWrite(data, written, false);
+            } else {
+                flashfsFlushAsync();
+            }
+            break;
+#endif
+#ifdef USE_SDCARD
+        case BLACKBOX_DEVICE_SDCARD:
+            written = afatfs_fwrite(blackboxSDCard.logFile, data, remaining);
+            break;
+#endif
+        default:
+            // Only the flash and the SD card log compressed
+            UNUSED(data);
+            bbDrops += remaining;
+            written = remaining;
+            break;
+        }
+
+        if (written == 0) {
+            return false;
+        }
+
+#ifdef DEBUG_BB_OUTPUT
+        bbBits += written * 8;
+#endif
+        blackboxCompressedWritten += written;
+    }
+
+    blackboxCompressedLength = 0;
+    blackboxCompressedWritten = 0;
+    return true;
+}
+
+static void blackboxWriteBlock(void)
+{
+    if (blackboxBlockLength == 0) {
+        return;
+    }
+
+    if (!blackboxWriteCompressedBlock()) {
+        // The device is behind, drop this block whole to keep the log decodable
+        bbDrops += blackboxBlockLength;
+        blackboxBlockLength = 0;
+        return;
+    }
+
+    uint8_t *payload = blackboxCompressedBlock + BLACKBOX_COMPRESSION_HEADER_SIZE;
+
+    // The encoder clears the byte after the last one it counts, so leave it room for that
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = payload,
+        .outBufLen = blackboxBlockLength - 1,
+        .outBit = 0x80,
+    };
+    *state.outByte = 0;
+
+    int compressedLength = 0;
+    if (huffmanEncodeBufStreaming(&state, blackboxBlock, blackboxBlockLength, huffmanTable) == 0) {
+        compressedLength = state.bytesWritten + (state.outBit != 0x80 ? 1 : 0);
+    }
+
+    int payloadLength;
+    if (compressedLength > 0 && compressedLength < blackboxBlockLength) {
+        payloadLength = compressedLength;
+    } else {
+        memcpy(payload, blackboxBlock, blackboxBlockLength);
+        payloadLength = blackboxBlockLength;
+        compressedLength = 0;
+    }
+
+    blackboxCompressedBlock[0] = BLACKBOX_COMPRESSION_BLOCK_MARKER;
+    blackboxCompressedBlock[1] = blackboxBlockLength & 0xFF;
+    blackboxCompressedBlock[2] = blackboxBlockLength >> 8;
+    blackboxCompressedBlock[3] = compressedLength & 0xFF;
+    blackboxCompressedBlock[4] = compressedLength >> 8;
+
+    blackboxCompressedLength = BLACKBOX_COMPRESSION_HEADER_SIZE + payloadLength;
+    blackboxBlockLength = 0;
+
+    blackboxWriteCompressedBlock();
+}
+#endif
+
+/**
+ * Start compressing the log data that follows (if configured), or write out the last partial block and stop.
+ */
+void blackboxDeviceSetCompression(bool enabled)
+{
+#ifdef USE_BLACKBOX_COMPRESSION
+    if (!enabled) {
+        blackboxWriteBlock();
+    }
+    // Serial has no backpressure that would keep the blocks whole
+    blackboxCompressing = enabled && blackboxConfig()->compression == BLACKBOX_COMPRESSION_HUFFMAN
+        && (blackboxConfig()->device == BLACKBOX_DEVICE_FLASH || blackboxConfig()->device == BLACKBOX_DEVICE_SDCARD);
+#else
+    UNUSED(enabled);
+#endif
+}
+
+// Pass log data on towards the device, through the compression stage when it is enabled
+static void blackboxOutput(const uint8_t *data, int length)
+{
+#ifdef USE_BLACKBOX_COMPRESSION
+    if (blackboxCompressing) {
+        // Make progress on the previous block while the device has room
+        blackboxWriteCompressedBlock();
+
+        while (length > 0) {
+            const int chunk = MIN(length, BLACKBOX_COMPRESSION_BLOCK_SIZE - blackboxBlockLength);
+
+            memcpy(blackboxBlock + blackboxBlockLength, data, chunk);
+            blackboxBlockLength += chunk;
+            data += chunk;
+            length -= chunk;
+
+            if (blackboxBlockLength == BLACKBOX_COMPRESSION_BLOCK_SIZE) {
+                blackboxWriteBlock();
+            }
+        }
+        return;
+    }
+#endif
+
+    blackboxDeviceWrite(data, length);
+}
+
+/**
+ * Start assembling a frame. Everything written until blackboxFrameCommit() is collected in the frame buffer and
+ * handed to the device in one go.
+ */
+void blackboxFrameBegin(void)
+{
+    blackboxFrameOpen = true;
+}
+
+void blackboxFrameCommit(void)
+{
+    blackboxFrameOpen = false;
+
+    if (blackboxFrameLength > 0) {
+        blackboxOutput(blackboxFrameBuffer, blackboxFrameLength);
+        blackboxFrameLength = 0;
+    }
+}
+
+/**
+ * Start a frame that is dropped by blackboxFrameDiscard(), nothing of it reaches the device. A frame that
+ * outgrows the buffer wraps around in it.
+ */
+void blackboxFrameBeginScratch(void)
+{
+    blackboxFrameOpen = true;
+    blackboxFrameScratch = true;
+}
+
+void blackboxFrameDiscard(void)
+{
+    blackboxFrameOpen = false;
+    blackboxFrameScratch = false;
+    blackboxFrameLength = 0;
+}
+
+/**
+ * Reserve room for up to 'bytes' (at most BLACKBOX_MAX_RESERVE) bytes of encoded data and return where to write
+ * them. Pass the end of what was actually written to blackboxCommit().
+ */
+uint8_t *blackboxReserve(int bytes)
+{
+    if (blackboxFrameLength + bytes > BLACKBOX_FRAME_BUFFER_SIZE) {
+        // The frame outgrew the buffer, pass on what we have so far
+        if (!blackboxFrameScratch) {
+            blackboxOutput(blackboxFrameBuffer, blackboxFrameLength);
+        }
+        blackboxFrameLength = 0;
+    }
+
+    return blackboxFrameBuffer + blackboxFrameLength;
+}
+
+void blackboxCommit(uint8_t *end)
+{
+    blackboxFrameLength = end - blackboxFrameBuffer;
+
+    // Outside of a frame the data goes straight through
+    if (!blackboxFrameOpen) {
+        blackboxOutput(blackboxFrameBuffer, blackboxFrameLength);
+        blackboxFrameLength = 0;
+    }
+}
+
+void blackboxWrite(uint8_t value)
+{
+    uint8_t *buf = blackboxReserve(1);
+
+    *buf++ = value;
+
+    blackboxCommit(buf);
+}
+
 // Print the null-terminated string 's' to the blackbox device and return the number of bytes written
 int blackboxWriteString(const char *s)
 {
     int length;
     const uint8_t *pos;
 
-    switch (blackboxConfig()->device) {
+    // Inside a frame or a compressed block the string has to go through the frame buffer to keep its place in the log
+#ifdef USE_BLACKBOX_COMPRESSION
+    const bool buffered = blackboxFrameOpen || blackboxCompressing;
+#else
+    const bool buffered = blackboxFrameOpen;
+#endif
+    const uint8_t device = buffered ? BLACKBOX_DEVICE_SERIAL : blackboxConfig()->device;
+
+    switch (device) {
 
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
@@ -230,6 +498,17 @@ void blackboxDeviceFlush(void)
  */
 bool blackboxDeviceFlushForce(void)
 {
+#ifdef USE_BLACKBOX_COMPRESSION
+    // Everything that is forced out has to include the partially filled block, behind the one still being written
+    if (!blackboxWriteCompressedBlock()) {
+        return false;
+    }
+    blackboxWriteBlock();
+    if (!blackboxWriteCompressedBlock()) {
+        return false;
+    }
+#endif
+
     switch (blackboxConfig()->device) {
     case BLACKBOX_DEVICE_SERIAL:
         // Nothing to speed up flushing on serial, as serial is continuously being drained out of its buffer
@@ -309,9 +588,16 @@ bool blackboxDeviceOpen(void)
                 // assume OpenLager in use, so do not constrain writes
                 blackboxMaxHeaderBytesPerIteration = BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION;
                 break;
-            default:
-                blackboxMaxHeaderBytesPerIteration = constrain((targetPidLooptime * 3) / 500, 1, BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION);
+            default: {
+                // when offloaded the header is sent from the blackbox task instead of the PID loop
+#ifdef USE_BLACKBOX_OFFLOAD
+                const uint32_t iterationTime = blackboxIsOffloaded() ? 1000000 / BLACKBOX_TASK_RATE_HZ : targetPidLooptime;
+#else
+                const uint32_t iterationTime = targetPidLooptime;
+#endif
+                blackboxMaxHeaderBytesPerIteration = constrain((iterationTime * 3) / 500, 1, BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION);
                 break;
+            }
             };
 
             return blackboxPort != NULL;
@@ -375,6 +661,20 @@ bool isBlackboxErased(void)
         break;
     }
 }
+
+/**
+ * Called while the blackbox is stopped, prepares the device for the next log in the background
+ */
+void blackboxEraseAhead(void)
+{
+    switch (blackboxConfig()->device) {
+    case BLACKBOX_DEVICE_FLASH:
+        flashfsEraseUpdate(true);
+        break;
+    default:
+        break;
+    }
+}
 #endif
 
 /**
@@ -382,6 +682,13 @@ bool isBlackboxErased(void)
  */
 void blackboxDeviceClose(void)
 {
+#ifdef USE_BLACKBOX_COMPRESSION
+    blackboxCompressing = false;
+    blackboxBlockLength = 0;
+    blackboxCompressedLength = 0;
+    blackboxCompressedWritten = 0;
+#endif
+
     switch (blackboxConfig()->device) {
     case BLACKBOX_DEVICE_SERIAL:
         // Can immediately close without attempting to flush any remaining data.
@@ -401,6 +708,17 @@ void blackboxDeviceClose(void)
     case BLACKBOX_DEVICE_FLASH:
         // Some flash device, e.g., NAND devices, require explicit close to flush internally buffered data.
         flashfsClose();
+
+#ifdef USE_FLASHFS_LOG_INDEX
+        // Index the log only now the data has made it to the flash
+        if (blackboxFlashLog.open) {
+            const uint32_t size = flashfsGetOffset() - blackboxFlashLog.offset;
+            if (size > 0) {
+                flashfsLogIndexAppend(blackboxFlashLog.offset, size, millis() - blackboxFlashLog.startTime);
+            }
+            blackboxFlashLog.open = false;
+        }
+#endif
         break;
 #endif
     default:
@@ -538,6 +856,13 @@ bool blackboxDeviceBeginLog(void)
     case BLACKBOX_DEVICE_SDCARD:
         return blackboxSDCardBeginLog();
 #endif // USE_SDCARD
+#ifdef USE_FLASHFS_LOG_INDEX
+    case BLACKBOX_DEVICE_FLASH:
+        blackboxFlashLog.open = true;
+        blackboxFlashLog.offset = flashfsGetOffset();
+        blackboxFlashLog.startTime = millis();
+        return true;
+#endif
     default:
         return true;
     }
@@ -632,6 +957,16 @@ int32_t blackboxGetLogNumber(void)
     }
 }
 
+// Log data lost since boot because the device could not take it, on every device type
+uint32_t blackboxGetDroppedBytes(void)
+{
+#ifdef USE_FLASHFS
+    return bbDrops + flashfsGetDroppedBytes();
+#else
+    return bbDrops;
+#endif
+}
+
 /**
  * Call once every loop iteration in order to maintain the global blackboxHeaderBudget with the number of bytes we can
  * transmit this iteration.
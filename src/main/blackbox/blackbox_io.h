@@ -38,9 +38,24 @@ typedef enum {
  */
 #define BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION 64
 
+/*
+ * Frames are assembled in a contiguous buffer and handed to the device with a single write when committed. Frames
+ * larger than the buffer are passed on in buffer sized pieces.
+ */
+#define BLACKBOX_FRAME_BUFFER_SIZE 256
+
+// Largest single reservation, a TAG2_3S32 group with three 32 bit fields
+#define BLACKBOX_MAX_RESERVE 13
+
 extern int32_t blackboxHeaderBudget;
 
 void blackboxOpen(void);
+void blackboxFrameBegin(void);
+void blackboxFrameCommit(void);
+void blackboxFrameBeginScratch(void);
+void blackboxFrameDiscard(void);
+uint8_t *blackboxReserve(int bytes);
+void blackboxCommit(uint8_t *end);
 void blackboxWrite(uint8_t value);
 int blackboxWriteString(const char *s);
 
@@ -48,9 +63,11 @@ void blackboxDeviceFlush(void);
 bool blackboxDeviceFlushForce(void);
 bool blackboxDeviceOpen(void);
 void blackboxDeviceClose(void);
+void blackboxDeviceSetCompression(bool enabled);
 
 void blackboxEraseAll(void);
 bool isBlackboxErased(void);
+void blackboxEraseAhead(void);
 
 bool blackboxDeviceBeginLog(void);
 bool blackboxDeviceEndLog(bool retainLog);
@@ -58,6 +75,7 @@ bool blackboxDeviceEndLog(bool retainLog);
 bool isBlackboxDeviceFull(void);
 bool isBlackboxDeviceWorking(void);
 int32_t blackboxGetLogNumber(void);
+uint32_t blackboxGetDroppedBytes(void);
 
 void blackboxReplenishHeaderBudget(void);
 blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes);
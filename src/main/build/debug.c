@@ -18,7 +18,9 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -31,6 +33,40 @@ uint8_t debugMode;
 uint32_t sectionTimes[2][4];
 #endif
 
+#ifdef USE_DEBUG_CHANNELS
+int16_t debugChannel[DEBUG_CHANNEL_COUNT];
+FAST_RAM_ZERO_INIT uint8_t debugChannelIndex[DEBUG_COUNT][DEBUG16_VALUE_COUNT];
+FAST_RAM_ZERO_INIT uint8_t debugChannelModeActive[DEBUG_COUNT];
+static bool debugChannelsConfigured;
+
+// Route the (modes[i], slots[i]) pairs to the channels. Pairs of debugMode are in debug[] already, a pair on
+// two channels goes to the first.
+void debugInitChannels(const uint8_t *modes, const uint8_t *slots)
+{
+    memset(debugChannelIndex, 0, sizeof(debugChannelIndex));
+    memset(debugChannelModeActive, 0, sizeof(debugChannelModeActive));
+    memset(debugChannel, 0, sizeof(debugChannel));
+    debugChannelsConfigured = false;
+
+    for (int i = 0; i < DEBUG_CHANNEL_COUNT; i++) {
+        const uint8_t mode = modes[i];
+        const uint8_t slot = slots[i];
+        if (mode == DEBUG_NONE || mode >= DEBUG_COUNT || DEBUG_MODE_EXCLUDED(mode) || mode == debugMode
+            || slot >= DEBUG16_VALUE_COUNT || debugChannelIndex[mode][slot]) {
+            continue;
+        }
+        debugChannelIndex[mode][slot] = i + 1;
+        debugChannelModeActive[mode] = true;
+        debugChannelsConfigured = true;
+    }
+}
+
+bool debugChannelsActive(void)
+{
+    return debugChannelsConfigured;
+}
+#endif
+
 // Please ensure that these names are aligned with the enum values defined in 'debug.h'
 // These values must also be in sync with Betaflight Configurator and Blackbox Explorer
 const char * const debugModeNames[DEBUG_COUNT] = {
@@ -96,4 +132,12 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     "FF_INTERPOLATED",
     "BLACKBOX_OUTPUT",
     "FREQ_SENSOR",
+    "DYN_NOTCH",
+    "SMITH_PREDICTOR",
+    "COLLECTIVE",
+    "GOVERNOR",
+    "TAIL_MOTOR",
+    "BATTERY_RESISTANCE",
+    "VIBRATION",
+    "SYSID",
 };
@@ -20,11 +20,42 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #define DEBUG16_VALUE_COUNT 4
 extern int16_t debug[DEBUG16_VALUE_COUNT];
 extern uint8_t debugMode;
 
-#define DEBUG_SET(mode, index, value) {if (debugMode == (mode)) {debug[(index)] = (value);}}
+#define DEBUG_CHANNEL_COUNT 8
+
+/*
+ * A target or a release build can compile debug modes out, e.g. EXTRA_FLAGS="-D'DEBUG_MODE_EXCLUDED(mode)=((mode)==DEBUG_FFT)'".
+ * DEBUG_SET() and DEBUG_MODE_ACTIVE() of an excluded mode fold to nothing.
+ */
+#ifndef DEBUG_MODE_EXCLUDED
+#define DEBUG_MODE_EXCLUDED(mode) false
+#endif
+
+#ifdef USE_DEBUG_CHANNELS
+/*
+ * Besides debug[] of debugMode, each debug channel logs one (mode, slot) pair of another mode. The channel a
+ * pair goes to is looked up in a table built once by debugInitChannels().
+ */
+#define DEBUG_SET(mode, index, value) { \
+    if (!DEBUG_MODE_EXCLUDED(mode)) { \
+        if (debugMode == (mode)) { \
+            debug[(index)] = (value); \
+        } else if ((index) < DEBUG16_VALUE_COUNT && debugChannelIndex[(mode)][(index)]) { \
+            debugChannel[debugChannelIndex[(mode)][(index)] - 1] = (value); \
+        } \
+    } \
+}
+#define DEBUG_MODE_ACTIVE(mode) (!DEBUG_MODE_EXCLUDED(mode) && (debugMode == (mode) || debugChannelModeActive[(mode)]))
+#else
+#define DEBUG_SET(mode, index, value) {if (!DEBUG_MODE_EXCLUDED(mode) && debugMode == (mode)) {debug[(index)] = (value);}}
+#define DEBUG_MODE_ACTIVE(mode) (!DEBUG_MODE_EXCLUDED(mode) && debugMode == (mode))
+#endif
 
 #define DEBUG_SECTION_TIMES
 
@@ -113,7 +144,24 @@ typedef enum {
     DEBUG_FF_INTERPOLATED,
     DEBUG_BLACKBOX_OUTPUT,
     DEBUG_FREQ_SENSOR,
+    DEBUG_DYN_NOTCH,
+    DEBUG_SMITH_PREDICTOR,
+    DEBUG_COLLECTIVE,
+    DEBUG_GOVERNOR,
+    DEBUG_TAIL_MOTOR,
+    DEBUG_BATTERY_RESISTANCE,
+    DEBUG_VIBRATION,
+    DEBUG_SYSID,
     DEBUG_COUNT
 } debugType_e;
 
 extern const char * const debugModeNames[DEBUG_COUNT];
+
+#ifdef USE_DEBUG_CHANNELS
+extern int16_t debugChannel[DEBUG_CHANNEL_COUNT];
+extern uint8_t debugChannelIndex[DEBUG_COUNT][DEBUG16_VALUE_COUNT];    // channel + 1, 0 if not logged
+extern uint8_t debugChannelModeActive[DEBUG_COUNT];
+
+void debugInitChannels(const uint8_t *modes, const uint8_t *slots);
+bool debugChannelsActive(void);
+#endif
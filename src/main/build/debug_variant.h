@@ -0,0 +1,53 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Builds a hot function twice, once with its debug values and once without, so that the flight loop does not
+ * test debugMode for every DEBUG_SET() when no debug mode of the function is logged. The function body lives
+ * in an _impl.c file that names the function DEBUG_VARIANT(name) and sets its debug values with
+ * DEBUG_VARIANT_SET():
+ *
+ *     #define DEBUG_VARIANT_IMPL "flight/rpm_filter_impl.c"
+ *     #include "build/debug_variant.h"
+ *
+ * defines name() and nameDebug(). The caller picks one once, when debugMode and the debug channels are set.
+ *
+ * No include guard, this file is included once for every specialised function.
+ */
+
+#include "common/utils.h"
+
+#ifndef DEBUG_VARIANT_IMPL
+#error "DEBUG_VARIANT_IMPL must name the file to build"
+#endif
+
+#define DEBUG_VARIANT(name) name
+#define DEBUG_VARIANT_SET(mode, index, value) { UNUSED(mode); UNUSED(index); UNUSED(value); }
+#include DEBUG_VARIANT_IMPL
+#undef DEBUG_VARIANT
+#undef DEBUG_VARIANT_SET
+
+#define DEBUG_VARIANT(name) name##Debug
+#define DEBUG_VARIANT_SET DEBUG_SET
+#include DEBUG_VARIANT_IMPL
+#undef DEBUG_VARIANT
+#undef DEBUG_VARIANT_SET
+
+#undef DEBUG_VARIANT_IMPL
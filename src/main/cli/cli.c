@@ -46,9 +46,12 @@ bool cliMode = false;
 
 #include "common/axis.h"
 #include "common/color.h"
+#include "common/crc.h"
 #include "common/maths.h"
 #include "common/printf.h"
 #include "common/printf_serial.h"
+#include "common/scratch.h"
+#include "common/spsc_queue.h"
 #include "common/strtol.h"
 #include "common/time.h"
 #include "common/typeconversion.h"
@@ -62,6 +65,7 @@ bool cliMode = false;
 #include "drivers/buf_writer.h"
 #include "drivers/bus_spi.h"
 #include "drivers/dma.h"
+#include "drivers/dma_plan.h"
 #include "drivers/dma_reqmap.h"
 #include "drivers/dshot.h"
 #include "drivers/dshot_command.h"
@@ -94,17 +98,21 @@ bool cliMode = false;
 #include "config/config.h"
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/looptime_check.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
+#include "fc/tasks.h"
 
 #include "flight/failsafe.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/position.h"
+#include "flight/rpm_filter.h"
 #include "flight/servos.h"
+#include "flight/sysid.h"
 
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
@@ -151,6 +159,8 @@ bool cliMode = false;
 #include "rx/rx_spi_common.h"
 #include "rx/srxl2.h"
 
+#include "scheduler/benchmark.h"
+#include "scheduler/profile.h"
 #include "scheduler/scheduler.h"
 
 #include "sensors/acceleration.h"
@@ -216,6 +226,33 @@ extern char __custom_defaults_end;
 
 static bool processingCustomDefaults = false;
 static char cliBufferTemp[CLI_IN_BUFFER_SIZE];
+
+/*
+ * Binary board description
+ *
+ * The PG changes a text custom defaults file makes, in the layout of this build,
+ * produced on the board by 'defaults compile'. Stored in the custom defaults region
+ * in place of the text, the records are copied into the PGs straight from flash.
+ */
+#define BOARD_DESCRIPTION_MAGIC         0x44424648      // "HFBD"
+#define BOARD_DESCRIPTION_VERSION       1
+#define BOARD_DESCRIPTION_LINE_BYTES    32
+
+typedef struct boardDescriptionHeader_s {
+    uint32_t magic;
+    uint16_t formatVersion;
+    uint16_t length;                    // of the records that follow
+    uint16_t crc;                       // CCITT of the records
+    char manufacturerId[MAX_MANUFACTURER_ID_LENGTH + 1];
+    char boardName[MAX_BOARD_NAME_LENGTH + 1];
+} boardDescriptionHeader_t;
+
+// Followed by length bytes to copy to offset in the PG
+typedef struct boardDescriptionRecord_s {
+    uint16_t pgn;                       // with the version, as registered
+    uint16_t offset;
+    uint16_t length;
+} boardDescriptionRecord_t;
 #endif
 
 #if defined(USE_CUSTOM_DEFAULTS_ADDRESS)
@@ -282,6 +319,29 @@ typedef enum dumpFlags_e {
 
 typedef bool printFn(dumpFlags_t dumpMask, bool equalsDefault, const char *format, ...);
 
+// The value sections of a dump or diff are printed from cliProcess() as the CLI port drains
+#define CLI_DUMP_TX_RESERVE 128     // free TX buffer space kept for the longest line of a value
+
+typedef enum {
+    DUMP_STEP_IDLE = 0,
+    DUMP_STEP_MASTER,
+    DUMP_STEP_PID_PROFILE,
+    DUMP_STEP_RATE_PROFILE,
+} dumpStep_e;
+
+static struct {
+    dumpStep_e step;
+    dumpFlags_t dumpMask;
+    uint8_t profileIndex;
+    uint16_t valueSection;
+    uint16_t valueIndex;        // next value of the section to print
+    const char *headingStr;     // section heading that hasn't been printed yet
+    char heading[16];
+#ifdef USE_CLI_BATCH
+    bool batchModeEnabled;
+#endif
+} dumpState;
+
 typedef enum {
     REBOOT_TARGET_FIRMWARE,
     REBOOT_TARGET_BOOTLOADER_ROM,
@@ -643,6 +703,17 @@ static void backupConfigs(void)
     configIsInCopy = true;
 }
 
+static void swapConfigs(void)
+{
+    PG_FOREACH(pg) {
+        for (int i = 0; i < pgSize(pg); i++) {
+            const uint8_t byte = pg->address[i];
+            pg->address[i] = pg->copy[i];
+            pg->copy[i] = byte;
+        }
+    }
+}
+
 static void restoreConfigs(void)
 {
     if (!configIsInCopy) {
@@ -758,17 +829,71 @@ static const char *dumpPgValue(const clivalue_t *value, dumpFlags_t dumpMask, co
     return headingStr;
 }
 
-static void dumpAllValues(uint16_t valueSection, dumpFlags_t dumpMask, const char *headingStr)
+static bool pgProfileDiffersFromDefault(const pgRegistry_t *pg, const clivalue_t *value)
 {
-    headingStr = cliPrintSectionHeading(dumpMask, false, headingStr);
+    // compare the profile the value is dumped from, or the whole group for the master section
+    uint16_t offset = 0;
+    uint16_t size = pgSize(pg);
+    switch (value->type & VALUE_SECTION_MASK) {
+    case PROFILE_VALUE:
+        size = sizeof(pidProfile_t);
+        offset = size * getPidProfileIndexToUse();
+        break;
+    case PROFILE_RATE_VALUE:
+        size = sizeof(controlRateConfig_t);
+        offset = size * getRateProfileIndexToUse();
+        break;
+    }
 
-    for (uint32_t i = 0; i < valueTableEntryCount; i++) {
-        const clivalue_t *value = &valueTable[i];
-        cliWriterFlush();
+    return memcmp(pg->copy + offset, pg->address + offset, size) != 0;
+}
+
+static bool cliOutputIsFull(void)
+{
+    cliWriterFlush();
+
+    return cliPort && serialTxBytesFree(cliPort) < CLI_DUMP_TX_RESERVE;
+}
+
+static void startDumpValues(uint16_t valueSection, const char *headingStr)
+{
+    dumpState.valueSection = valueSection;
+    dumpState.valueIndex = 0;
+    dumpState.headingStr = cliPrintSectionHeading(dumpState.dumpMask, false, headingStr);
+}
+
+// Prints values of the section until it is complete or the CLI port is full, returns true once it is complete
+static bool dumpValuesContinue(void)
+{
+    const uint16_t valueSection = dumpState.valueSection;
+    const dumpFlags_t dumpMask = dumpState.dumpMask;
+    const uint16_t firstIndex = dumpState.valueIndex;
+
+    // a diff skips the values of a group that matches its defaults, the values of a group are mostly adjacent in the table
+    const pgRegistry_t *pg = NULL;
+    bool pgDiffers = true;
+
+    for (; dumpState.valueIndex < valueTableEntryCount; dumpState.valueIndex++) {
+        const clivalue_t *value = &valueTable[dumpState.valueIndex];
         if ((value->type & VALUE_SECTION_MASK) == valueSection || ((valueSection == MASTER_VALUE) && (value->type & VALUE_SECTION_MASK) == HARDWARE_VALUE)) {
-            headingStr = dumpPgValue(value, dumpMask, headingStr);
+            if (dumpMask & DO_DIFF) {
+                if (!pg || pgN(pg) != value->pgn) {
+                    pg = pgFind(value->pgn);
+                    pgDiffers = !pg || pgProfileDiffersFromDefault(pg, value);
+                }
+                if (!pgDiffers) {
+                    continue;
+                }
+            }
+            // print at least one value per call, ports with a small TX buffer fall back to blocking writes
+            if (dumpState.valueIndex > firstIndex && cliOutputIsFull()) {
+                return false;
+            }
+            dumpState.headingStr = dumpPgValue(value, dumpMask, dumpState.headingStr);
         }
     }
+
+    return true;
 }
 
 static void cliPrintVar(const clivalue_t *var, bool full)
@@ -2140,6 +2265,7 @@ static void cliServo(char *cmdline)
         servo->middle = arguments[MIDDLE];
         servo->rate = arguments[RATE];
         servo->forwardFromChannel = arguments[FORWARD];
+        servoMixerCompile();
 
         cliDumpPrintLinef(0, false, format,
             i,
@@ -2208,6 +2334,7 @@ static void cliServoMix(char *cmdline)
         for (uint32_t i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
             servoParamsMutable(i)->reversedSources = 0;
         }
+        servoMixerCompile();
     } else if (strncasecmp(cmdline, "load", 4) == 0) {
         const char *ptr = nextArg(cmdline);
         if (ptr) {
@@ -2265,6 +2392,7 @@ static void cliServoMix(char *cmdline)
             } else {
                 servoParamsMutable(args[SERVO])->reversedSources &= ~(1 << args[INPUT]);
             }
+            servoMixerCompile();
         } else {
             cliShowParseError();
             return;
@@ -2430,6 +2558,7 @@ static void cliFlashErase(char *cmdline)
 
 #ifndef MINIMAL_CLI
     uint32_t i = 0;
+    uint32_t polls = 0;
     cliPrintLine("Erasing, please wait ... ");
 #else
     cliPrintLine("Erasing,");
@@ -2438,17 +2567,20 @@ static void cliFlashErase(char *cmdline)
     cliWriterFlush();
     flashfsEraseCompletely();
 
+    // Polling the flash drives the erase
     while (!flashfsIsReady()) {
 #ifndef MINIMAL_CLI
-        cliPrintf(".");
-        if (i++ > 120) {
-            i=0;
-            cliPrintLinefeed();
-        }
+        if (++polls % 10 == 0) {
+            cliPrintf(".");
+            if (i++ > 120) {
+                i=0;
+                cliPrintLinefeed();
+            }
 
-        cliWriterFlush();
+            cliWriterFlush();
+        }
 #endif
-        delay(100);
+        delay(10);
     }
     beeper(BEEPER_BLACKBOX_ERASE);
     cliPrintLinefeed();
@@ -2646,6 +2778,35 @@ static void cliMcuId(char *cmdline)
     cliPrintLinef("mcu_id %08x%08x%08x", U_ID_0, U_ID_1, U_ID_2);
 }
 
+// Runtime memory use, the static RAM use per subsystem is the <target>_memory.txt build artifact
+static void cliMemory(char *cmdline)
+{
+    UNUSED(cmdline);
+
+    const uint32_t stackSize = stackTotalSize();
+    const uint32_t stackUsed = stackHighWaterSize();
+    cliPrintLinef("Stack: %d bytes at 0x%x, max used %d (%d%%)", stackSize, stackHighMem(), stackUsed, stackSize ? stackUsed * 100 / stackSize : 0);
+    cliPrintLinef("Scratch: %d bytes, used %d, max used %d", SCRATCH_SIZE, scratchUsed(), scratchMaxUsed());
+
+#ifdef USE_TASK_STACK_CHECK
+    cliPrintLine("              Task  Stack");
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        if (taskInfo.isEnabled) {
+            cliPrintLinef("%18s  %5d", taskInfo.taskName, taskInfo.maxStackUsage);
+        }
+    }
+#endif
+
+    cliPrintLine("             Queue  Size   Now   Max");
+    const char *name;
+    const spscQueue_t *queue;
+    for (unsigned i = 0; (queue = spscQueueRegistered(i, &name)); i++) {
+        cliPrintLinef("%18s  %4d  %4d  %4d", name, spscQueueSize(queue), spscQueueCount(queue), spscQueueMaxCount(queue));
+    }
+}
+
 static void printFeature(dumpFlags_t dumpMask, const uint32_t mask, const uint32_t defaultMask, const char *headingStr)
 {
     headingStr = cliPrintSectionHeading(dumpMask, false, headingStr);
@@ -3071,11 +3232,11 @@ static void cliPrintGyroRegisters(uint8_t whichSensor)
 static void cliDumpGyroRegisters(char *cmdline)
 {
 #ifdef USE_MULTI_GYRO
-    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_1) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH)) {
+    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_1) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_FUSED)) {
         cliPrintLinef("\r\n# Gyro 1");
         cliPrintGyroRegisters(GYRO_CONFIG_USE_GYRO_1);
     }
-    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_2) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH)) {
+    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_2) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_FUSED)) {
         cliPrintLinef("\r\n# Gyro 2");
         cliPrintGyroRegisters(GYRO_CONFIG_USE_GYRO_2);
     }
@@ -3303,7 +3464,11 @@ static void executeEscInfoCommand(uint8_t escIndex)
         // KISS ESC PROTOCOL
         cliPrintLinef("Info for ESC %d:", escIndex);
 
-        uint8_t escInfoBuffer[ESC_INFO_BLHELI32_EXPECTED_FRAME_SIZE];
+        uint8_t *escInfoBuffer = scratchAlloc(ESC_INFO_BLHELI32_EXPECTED_FRAME_SIZE);
+        if (!escInfoBuffer) {
+            cliPrintErrorLinef("OUT OF SCRATCH MEMORY");
+            return;
+        }
 
         startEscDataRead(escInfoBuffer, ESC_INFO_BLHELI32_EXPECTED_FRAME_SIZE);
 
@@ -3312,6 +3477,8 @@ static void executeEscInfoCommand(uint8_t escIndex)
         delay(10);
 
         printEscInfo(escInfoBuffer, getNumberEscBytesRead());
+
+        scratchFree(escInfoBuffer);
     }
 }
 #endif // USE_ESC_SENSOR && USE_ESC_SENSOR_INFO
@@ -3741,44 +3908,6 @@ static void cliRateProfile(char *cmdline)
     }
 }
 
-static void cliDumpPidProfile(uint8_t pidProfileIndex, dumpFlags_t dumpMask)
-{
-    if (pidProfileIndex >= PID_PROFILE_COUNT) {
-        // Faulty values
-        return;
-    }
-
-    pidProfileIndexToUse = pidProfileIndex;
-
-    cliPrintLinefeed();
-    cliProfile("");
-    
-    char profileStr[10];
-    tfp_sprintf(profileStr, "profile %d", pidProfileIndex);
-    dumpAllValues(PROFILE_VALUE, dumpMask, profileStr);
-
-    pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
-}
-
-static void cliDumpRateProfile(uint8_t rateProfileIndex, dumpFlags_t dumpMask)
-{
-    if (rateProfileIndex >= CONTROL_RATE_PROFILE_COUNT) {
-        // Faulty values
-        return;
-    }
-
-    rateProfileIndexToUse = rateProfileIndex;
-
-    cliPrintLinefeed();
-    cliRateProfile("");
-
-    char rateProfileStr[14];
-    tfp_sprintf(rateProfileStr, "rateprofile %d", rateProfileIndex);
-    dumpAllValues(PROFILE_RATE_VALUE, dumpMask, rateProfileStr);
-
-    rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
-}
-
 #ifdef USE_CLI_BATCH
 static void cliPrintCommandBatchWarning(const char *warning)
 {
@@ -3891,9 +4020,157 @@ static bool isCustomDefaults(char *ptr)
     return strncmp(ptr, "# " FC_FIRMWARE_NAME, 12) == 0;
 }
 
+static bool isBoardDescription(const char *ptr)
+{
+    boardDescriptionHeader_t header;
+    memcpy(&header, ptr, sizeof(header));
+
+    return header.magic == BOARD_DESCRIPTION_MAGIC
+        && header.formatVersion == BOARD_DESCRIPTION_VERSION
+        && ptr + sizeof(header) + header.length <= customDefaultsEnd
+        && crc16_ccitt_update(0, ptr + sizeof(header), header.length) == header.crc;
+}
+
 bool hasCustomDefaults(void)
 {
-    return isCustomDefaults(customDefaultsStart);
+    return isCustomDefaults(customDefaultsStart) || isBoardDescription(customDefaultsStart);
+}
+
+// Records of PGs this build does not have, or has in another version, are skipped
+static unsigned applyBoardDescription(const char *ptr)
+{
+    boardDescriptionHeader_t header;
+    memcpy(&header, ptr, sizeof(header));
+
+    const char *record = ptr + sizeof(header);
+    const char *end = record + header.length;
+    unsigned skipped = 0;
+
+    while (record + sizeof(boardDescriptionRecord_t) <= end) {
+        boardDescriptionRecord_t desc;
+        memcpy(&desc, record, sizeof(desc));
+        record += sizeof(desc);
+
+        const pgRegistry_t *pg = pgFind(desc.pgn & PGR_PGN_MASK);
+        if (pg && pg->pgn == desc.pgn && desc.offset + desc.length <= pgSize(pg) && record + desc.length <= end) {
+            memcpy(pg->address + desc.offset, record, desc.length);
+        } else {
+            skipped++;
+        }
+        record += desc.length;
+    }
+
+#if defined(USE_BOARD_INFO)
+    if (!configIsInCopy && !boardInformationIsSet()) {
+        setManufacturerId(header.manufacturerId);
+        setBoardName(header.boardName);
+        boardInformationUpdated = true;
+    }
+#endif
+
+    return skipped;
+}
+
+typedef void boardDescriptionEmitFn(const void *data, unsigned length);
+
+// Every run of bytes the PGs differ from their copy in, runs closer than a record header merged
+static void walkBoardDescription(boardDescriptionEmitFn *emit)
+{
+    PG_FOREACH(pg) {
+        const unsigned size = pgSize(pg);
+        for (unsigned i = 0; i < size; i++) {
+            if (pg->address[i] == pg->copy[i]) {
+                continue;
+            }
+            unsigned end = i + 1;
+            for (unsigned j = end; j < size && j < end + sizeof(boardDescriptionRecord_t); j++) {
+                if (pg->address[j] != pg->copy[j]) {
+                    end = j + 1;
+                }
+            }
+            const boardDescriptionRecord_t desc = {
+                .pgn = pg->pgn,
+                .offset = i,
+                .length = end - i,
+            };
+            emit(&desc, sizeof(desc));
+            emit(&pg->address[i], desc.length);
+            i = end - 1;
+        }
+    }
+}
+
+static struct {
+    uint16_t length;
+    uint16_t crc;
+    uint8_t line[BOARD_DESCRIPTION_LINE_BYTES];
+    unsigned lineIndex;
+} boardDescriptionOutput;
+
+static void measureBoardDescription(const void *data, unsigned length)
+{
+    boardDescriptionOutput.length += length;
+    boardDescriptionOutput.crc = crc16_ccitt_update(boardDescriptionOutput.crc, data, length);
+}
+
+static void flushBoardDescriptionLine(void)
+{
+    if (boardDescriptionOutput.lineIndex) {
+        cliPrint("#bd ");
+        for (unsigned i = 0; i < boardDescriptionOutput.lineIndex; i++) {
+            cliPrintf("%02x", boardDescriptionOutput.line[i]);
+        }
+        cliPrintLinefeed();
+        boardDescriptionOutput.lineIndex = 0;
+    }
+}
+
+static void printBoardDescription(const void *data, unsigned length)
+{
+    for (unsigned i = 0; i < length; i++) {
+        boardDescriptionOutput.line[boardDescriptionOutput.lineIndex++] = ((const uint8_t *)data)[i];
+        if (boardDescriptionOutput.lineIndex == BOARD_DESCRIPTION_LINE_BYTES) {
+            flushBoardDescriptionLine();
+        }
+    }
+}
+
+// Leaves the custom defaults in the running config, as 'defaults nosave' does
+static void cliCompileBoardDescription(void)
+{
+    if (!isCustomDefaults(customDefaultsStart)) {
+        cliPrintError("NO TEXT CUSTOM DEFAULTS FOUND");
+
+        return;
+    }
+
+    resetConfig();
+    backupConfigs();
+    cliProcessCustomDefaults();
+
+    boardDescriptionOutput.length = 0;
+    boardDescriptionOutput.crc = 0;
+    boardDescriptionOutput.lineIndex = 0;
+    walkBoardDescription(measureBoardDescription);
+
+    boardDescriptionHeader_t header = {
+        .magic = BOARD_DESCRIPTION_MAGIC,
+        .formatVersion = BOARD_DESCRIPTION_VERSION,
+        .length = boardDescriptionOutput.length,
+        .crc = boardDescriptionOutput.crc,
+    };
+#if defined(USE_BOARD_INFO)
+    strncpy(header.manufacturerId, getManufacturerId(), MAX_MANUFACTURER_ID_LENGTH);
+    strncpy(header.boardName, getBoardName(), MAX_BOARD_NAME_LENGTH);
+#endif
+
+    cliPrintHashLine("board description, load the #bd lines into the custom defaults region");
+    printBoardDescription(&header, sizeof(header));
+    walkBoardDescription(printBoardDescription);
+    flushBoardDescriptionLine();
+    cliPrintLinef("# %u bytes", (unsigned)(sizeof(header) + header.length));
+
+    configIsInCopy = false;
 }
 #endif
 
@@ -3915,9 +4192,17 @@ static void cliDefaults(char *cmdline)
 #if defined(USE_CUSTOM_DEFAULTS)
     } else if (strncasecmp(cmdline, "bare", 4) == 0) {
         useCustomDefaults = false;
+    } else if (strncasecmp(cmdline, "compile", 7) == 0) {
+        cliCompileBoardDescription();
+
+        return;
     } else if (strncasecmp(cmdline, "show", 4) == 0) {
         char *customDefaultsPtr = customDefaultsStart;
-        if (isCustomDefaults(customDefaultsPtr)) {
+        if (isBoardDescription(customDefaultsPtr)) {
+            boardDescriptionHeader_t header;
+            memcpy(&header, customDefaultsPtr, sizeof(header));
+            cliPrintLinef("# board description %s %s, %u bytes", header.manufacturerId, header.boardName, (unsigned)(sizeof(header) + header.length));
+        } else if (isCustomDefaults(customDefaultsPtr)) {
             while (*customDefaultsPtr && *customDefaultsPtr != 0xFF && customDefaultsPtr < customDefaultsEnd) {
                 if (*customDefaultsPtr != '\n') {
                     cliPrintf("%c", *customDefaultsPtr++);
@@ -4081,6 +4366,8 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline)
 
         bool valueChanged = false;
         int16_t value  = 0;
+        // the load of new task rates is checked against the rates in use
+        const taskConfig_t previousTaskConfig = *taskConfig();
         switch (val->type & VALUE_MODE_MASK) {
         case MODE_DIRECT: {
                 if ((val->type & VALUE_TYPE_MASK) == VAR_UINT32) {
@@ -4225,6 +4512,16 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline)
             break;
         }
 
+        if (valueChanged && val->pgn == PG_TASK_CONFIG) {
+            taskConfig_t newTaskConfig = *taskConfig();
+            *taskConfigMutable() = previousTaskConfig;
+            if (!tasksConfigFits(&newTaskConfig)) {
+                cliPrintErrorLinef("TASK RATES EXCEED %d%% PROJECTED LOAD", TASK_CONFIG_LOAD_LIMIT_PERCENT);
+                return;
+            }
+            *taskConfigMutable() = newTaskConfig;
+        }
+
         if (valueChanged) {
             cliPrintf("%s set to ", val->name);
             cliPrintVar(val, 0);
@@ -4336,6 +4633,19 @@ static void cliStatus(char *cmdline)
     const int systemRate = getTaskDeltaTime(TASK_SYSTEM) == 0 ? 0 : (int)(1000000.0f / ((float)getTaskDeltaTime(TASK_SYSTEM)));
     cliPrintLinef("CPU:%d%%, cycle time: %d, GYRO rate: %d, RX rate: %d, System rate: %d",
             constrain(averageSystemLoadPercent, 0, 100), getTaskDeltaTime(TASK_GYROPID), gyroRate, rxRate, systemRate);
+#ifdef USE_LOOPTIME_CHECK
+    if (!looptimeCheckPending() && pidConfig()->pid_looptime_check != LOOPTIME_CHECK_OFF) {
+        cliPrintLinef("Looptime check: gyro max %dus, PID loop max %dus, lowest pid_process_denom %d%s",
+            looptimeCheckMaxGyroTimeUs(), looptimeCheckMaxLoopTimeUs(), looptimeCheckSafePidDenom(),
+            looptimeCheckOverrun() ? " (PID loop rate too high)" : "");
+    }
+#endif
+
+#ifdef USE_RPM_FILTER
+    if (rpmFilterDroppedNotchCount()) {
+        cliPrintLinef("RPM filter: %d harmonics dropped, only %d notches", rpmFilterDroppedNotchCount(), RPM_FILTER_NOTCH_COUNT);
+    }
+#endif
 
     // Battery meter
 
@@ -4364,7 +4674,64 @@ static void cliStatus(char *cmdline)
     cliPrintLinefeed();
 }
 
+#ifdef USE_SYSTEM_ID
+static void cliPrintSysidValue(const char *name, float value, const char *unit)
+{
+    const int tenths = lrintf(value * 10);
+    cliPrintLinef("%s: %s%d.%d %s", name, tenths < 0 ? "-" : "", ABS(tenths) / 10, ABS(tenths) % 10, unit);
+}
+
+static void cliSysid(char *cmdline)
+{
+    UNUSED(cmdline);
+
+    static const char * const stateNames[] = { "IDLE", "RUNNING", "DONE", "ABORTED" };
+    static const char * const axisNames[] = { "ROLL", "PITCH", "YAW" };
+
+    const sysidResult_t *result = sysidGetResult();
+    cliPrintLinef("State: %s, axis: %s", stateNames[result->state], axisNames[result->axis]);
+    if (result->state != SYSID_STATE_DONE) {
+        return;
+    }
+
+    cliPrintSysidValue("Bandwidth", result->bandwidthHz, "Hz");
+    cliPrintSysidValue("Crossover", result->crossoverHz, "Hz");
+    cliPrintSysidValue("Phase margin", result->phaseMarginDeg, "deg");
+    cliPrintSysidValue("Dead time", result->deadTimeMs, "ms");
+
+    cliPrintLine("    Hz   gain  phase");
+    for (int bin = 0; bin < SYSID_BIN_COUNT; bin++) {
+        const sysidBin_t *point = &result->bins[bin];
+        const int frequency = lrintf(point->frequency * 10);
+        const int gain = lrintf(point->gain * 1000);
+        cliPrintLinef("%4d.%d %2d.%03d %6d", frequency / 10, frequency % 10, gain / 1000, gain % 1000, (int)lrintf(point->phase));
+    }
+}
+#endif
+
 #if defined(USE_TASK_STATISTICS)
+#ifdef USE_TASK_PROFILE
+static void cliTaskProfiles(void)
+{
+    cliPrintLine("Task profile            count  p50/cyc  p99/cyc  max/cyc");
+    for (profileId_e id = 0; id < PROFILE_COUNT; id++) {
+        profileInfo_t profileInfo;
+        profileGetInfo(id, &profileInfo);
+        if (profileInfo.count) {
+            const char *name = profileGetSubTaskName(id);
+            if (!name) {
+                cfTaskInfo_t taskInfo;
+                getTaskInfo((cfTaskId_e)id, &taskInfo);
+                name = taskInfo.taskName;
+            }
+            cliPrintLinef("%02d - (%15s) %6d %8d %8d %8d", id, name,
+                    profileInfo.count, profileInfo.p50Cycles, profileInfo.p99Cycles, profileInfo.maxCycles);
+        }
+        profileReset(id);
+    }
+}
+#endif
+
 static void cliTasks(char *cmdline)
 {
     UNUSED(cmdline);
@@ -4420,8 +4787,45 @@ static void cliTasks(char *cmdline)
     if (systemConfig()->task_statistics) {
         cfCheckFuncInfo_t checkFuncInfo;
         getCheckFuncInfo(&checkFuncInfo);
-        cliPrintLinef("RX Check Function %19d %7d %25d", checkFuncInfo.maxExecutionTime, checkFuncInfo.averageExecutionTime, checkFuncInfo.totalExecutionTime / 1000);
+        cliPrintLinef("Check Functions %21d %7d %25d", checkFuncInfo.maxExecutionTime, checkFuncInfo.averageExecutionTime, checkFuncInfo.totalExecutionTime / 1000);
         cliPrintLinef("Total (excluding SERIAL) %25d.%1d%% %4d.%1d%%", maxLoadSum/10, maxLoadSum%10, averageLoadSum/10, averageLoadSum%10);
+#ifdef USE_TASK_PROFILE
+        cliTaskProfiles();
+#endif
+    }
+}
+#endif
+
+#ifdef USE_BENCHMARK
+static void cliBenchmark(char *cmdline)
+{
+    int iterations = BENCHMARK_ITERATIONS_DEFAULT;
+
+    if (!isEmpty(cmdline)) {
+        iterations = atoi(cmdline);
+        if (iterations < 1 || iterations > BENCHMARK_ITERATIONS_MAX) {
+            cliShowArgumentRangeError("ITERATIONS", 1, BENCHMARK_ITERATIONS_MAX);
+            return;
+        }
+    }
+
+    if (ARMING_FLAG(ARMED)) {
+        cliPrintErrorLinef("NOT AVAILABLE WHILE ARMED");
+        return;
+    }
+
+    const uint32_t cyclesPerMicro = clockMicrosToCycles(1);
+    cliPrintLinef("# %d MHz, %d iterations", cyclesPerMicro, iterations);
+    cliPrintLine("              Kernel   min/cyc  med/cyc  max/cyc   med/us");
+    for (benchmarkId_e id = 0; id < BENCHMARK_COUNT; id++) {
+        benchmarkResult_t result;
+        if (benchmarkRun(id, iterations, &result)) {
+            const uint32_t medianNanos = result.medianCycles * 1000 / cyclesPerMicro;
+            cliPrintLinef("%20s %9d %8d %8d %4d.%02d", benchmarkGetName(id),
+                    result.minCycles, result.medianCycles, result.maxCycles, medianNanos / 1000, (medianNanos % 1000) / 10);
+        } else {
+            cliPrintLinef("%20s not available", benchmarkGetName(id));
+        }
     }
 }
 #endif
@@ -4793,6 +5197,32 @@ static void showDma(void)
             cliPrintLinef(" %s", ownerNames[owner->owner]);
         }
     }
+
+#ifdef USE_DMA_SPEC
+    bool headingPrinted = false;
+    const dmaPlanRequest_t *request;
+    for (unsigned i = 0; (request = dmaPlanGetRequest(i)); i++) {
+        if (request->assigned == request->configured) {
+            continue;
+        }
+
+        if (!headingPrinted) {
+            cliPrintLinefeed();
+            cliPrintLine("DMA conflicts:");
+            headingPrinted = true;
+        }
+
+        cliPrintf("%s", ownerNames[request->owner.owner]);
+        if (request->owner.resourceIndex > 0) {
+            cliPrintf(" %d", request->owner.resourceIndex);
+        }
+        if (request->assigned == DMA_OPT_UNUSED) {
+            cliPrintLinef(": option %d taken, no DMA left", request->configured);
+        } else {
+            cliPrintLinef(": option %d taken, using %d", request->configured, request->assigned);
+        }
+    }
+#endif
 }
 #endif
 
@@ -5624,6 +6054,153 @@ static void cliDshotTelemetryInfo(char *cmdline)
 }
 #endif
 
+static void startDumpStep(dumpStep_e step, uint8_t profileIndex)
+{
+    dumpState.step = step;
+    dumpState.profileIndex = profileIndex;
+
+    switch (step) {
+    case DUMP_STEP_MASTER:
+        startDumpValues((dumpState.dumpMask & HARDWARE_ONLY) ? HARDWARE_VALUE : MASTER_VALUE, "master");
+
+        break;
+    case DUMP_STEP_PID_PROFILE:
+        if (profileIndex >= PID_PROFILE_COUNT) {
+            // Faulty values
+            dumpState.valueIndex = valueTableEntryCount;
+            break;
+        }
+
+        pidProfileIndexToUse = profileIndex;
+
+        cliPrintLinefeed();
+        cliProfile("");
+
+        tfp_sprintf(dumpState.heading, "profile %d", profileIndex);
+        startDumpValues(PROFILE_VALUE, dumpState.heading);
+
+        break;
+    case DUMP_STEP_RATE_PROFILE:
+        if (profileIndex >= CONTROL_RATE_PROFILE_COUNT) {
+            // Faulty values
+            dumpState.valueIndex = valueTableEntryCount;
+            break;
+        }
+
+        rateProfileIndexToUse = profileIndex;
+
+        cliPrintLinefeed();
+        cliRateProfile("");
+
+        tfp_sprintf(dumpState.heading, "rateprofile %d", profileIndex);
+        startDumpValues(PROFILE_RATE_VALUE, dumpState.heading);
+
+        break;
+    default:
+        break;
+    }
+}
+
+static void finishDump(void)
+{
+#ifdef USE_CLI_BATCH
+    if (dumpState.batchModeEnabled) {
+        cliPrintHashLine("end the command batch");
+        cliPrintLine("batch end");
+    }
+#endif
+
+    // restore configs from copies
+    restoreConfigs();
+
+    dumpState.step = DUMP_STEP_IDLE;
+}
+
+static void finishDumpStep(void)
+{
+    const dumpFlags_t dumpMask = dumpState.dumpMask;
+
+    switch (dumpState.step) {
+    case DUMP_STEP_MASTER:
+        if (dumpMask & HARDWARE_ONLY) {
+            finishDump();
+        } else {
+            startDumpStep(DUMP_STEP_PID_PROFILE, (dumpMask & DUMP_ALL) ? 0 : systemConfig_Copy.pidProfileIndex);
+        }
+
+        break;
+    case DUMP_STEP_PID_PROFILE:
+        pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
+
+        if (!(dumpMask & (DUMP_MASTER | DUMP_ALL))) {
+            finishDump();
+        } else if (!(dumpMask & DUMP_ALL)) {
+            startDumpStep(DUMP_STEP_RATE_PROFILE, systemConfig_Copy.activeRateProfile);
+        } else if (dumpState.profileIndex + 1 < PID_PROFILE_COUNT) {
+            startDumpStep(DUMP_STEP_PID_PROFILE, dumpState.profileIndex + 1);
+        } else {
+            pidProfileIndexToUse = systemConfig_Copy.pidProfileIndex;
+
+            if (!(dumpMask & BARE)) {
+                cliPrintHashLine("restore original profile selection");
+
+                cliProfile("");
+            }
+
+            pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
+
+            startDumpStep(DUMP_STEP_RATE_PROFILE, 0);
+        }
+
+        break;
+    case DUMP_STEP_RATE_PROFILE:
+        rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
+
+        if (!(dumpMask & DUMP_ALL)) {
+            finishDump();
+        } else if (dumpState.profileIndex + 1 < CONTROL_RATE_PROFILE_COUNT) {
+            startDumpStep(DUMP_STEP_RATE_PROFILE, dumpState.profileIndex + 1);
+        } else {
+            rateProfileIndexToUse = systemConfig_Copy.activeRateProfile;
+
+            if (!(dumpMask & BARE)) {
+                cliPrintHashLine("restore original rateprofile selection");
+
+                cliRateProfile("");
+
+                cliPrintHashLine("save configuration");
+                cliPrint("save");
+#ifdef USE_CLI_BATCH
+                dumpState.batchModeEnabled = false;
+#endif
+            }
+
+            rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
+
+            finishDump();
+        }
+
+        break;
+    default:
+        finishDump();
+
+        break;
+    }
+}
+
+// Continues a dump or diff, returns false when it stopped to let the CLI port drain
+static bool printConfigContinue(void)
+{
+    while (dumpState.step != DUMP_STEP_IDLE) {
+        if (!dumpValuesContinue()) {
+            return false;
+        }
+        finishDumpStep();
+    }
+
+    return true;
+}
+
 static void printConfig(char *cmdline, bool doDiff)
 {
     dumpFlags_t dumpMask = DUMP_MASTER;
@@ -5654,8 +6231,9 @@ static void printConfig(char *cmdline, bool doDiff)
 
     backupAndResetConfigs((dumpMask & BARE) == 0);
 
+    dumpState.dumpMask = dumpMask;
 #ifdef USE_CLI_BATCH
-    bool batchModeEnabled = false;
+    dumpState.batchModeEnabled = false;
 #endif
     if ((dumpMask & DUMP_MASTER) || (dumpMask & DUMP_ALL)) {
         cliPrintHashLine("version");
@@ -5665,7 +6243,7 @@ static void printConfig(char *cmdline, bool doDiff)
 #ifdef USE_CLI_BATCH
             cliPrintHashLine("start the command batch");
             cliPrintLine("batch start");
-            batchModeEnabled = true;
+            dumpState.batchModeEnabled = true;
 #endif
 
             if ((dumpMask & (DUMP_ALL | DO_DIFF)) == (DUMP_ALL | DO_DIFF)) {
@@ -5759,66 +6337,19 @@ static void printConfig(char *cmdline, bool doDiff)
             printRxFailsafe(dumpMask, rxFailsafeChannelConfigs_CopyArray, rxFailsafeChannelConfigs(0), "rxfail");
         }
 
-        if (dumpMask & HARDWARE_ONLY) {
-            dumpAllValues(HARDWARE_VALUE, dumpMask, "master");
-        } else {
-            dumpAllValues(MASTER_VALUE, dumpMask, "master");
-
-            if (dumpMask & DUMP_ALL) {
-                for (uint32_t pidProfileIndex = 0; pidProfileIndex < PID_PROFILE_COUNT; pidProfileIndex++) {
-                    cliDumpPidProfile(pidProfileIndex, dumpMask);
-                }
-
-                pidProfileIndexToUse = systemConfig_Copy.pidProfileIndex;
-
-                if (!(dumpMask & BARE)) {
-                    cliPrintHashLine("restore original profile selection");
-
-                    cliProfile("");
-                }
-
-                pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
-
-                for (uint32_t rateIndex = 0; rateIndex < CONTROL_RATE_PROFILE_COUNT; rateIndex++) {
-                    cliDumpRateProfile(rateIndex, dumpMask);
-                }
-
-                rateProfileIndexToUse = systemConfig_Copy.activeRateProfile;
-
-                if (!(dumpMask & BARE)) {
-                    cliPrintHashLine("restore original rateprofile selection");
-
-                    cliRateProfile("");
-
-                    cliPrintHashLine("save configuration");
-                    cliPrint("save");
-#ifdef USE_CLI_BATCH
-                    batchModeEnabled = false;
-#endif
-                }
-
-                rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
-            } else {
-                cliDumpPidProfile(systemConfig_Copy.pidProfileIndex, dumpMask);
-
-                cliDumpRateProfile(systemConfig_Copy.activeRateProfile, dumpMask);
-            }
-        }
+        startDumpStep(DUMP_STEP_MASTER, 0);
     } else if (dumpMask & DUMP_PROFILE) {
-        cliDumpPidProfile(systemConfig_Copy.pidProfileIndex, dumpMask);
+        startDumpStep(DUMP_STEP_PID_PROFILE, systemConfig_Copy.pidProfileIndex);
     } else if (dumpMask & DUMP_RATES) {
-        cliDumpRateProfile(systemConfig_Copy.activeRateProfile, dumpMask);
+        startDumpStep(DUMP_STEP_RATE_PROFILE, systemConfig_Copy.activeRateProfile);
+    } else {
+        finishDump();
     }
 
-#ifdef USE_CLI_BATCH
-    if (batchModeEnabled) {
-        cliPrintHashLine("end the command batch");
-        cliPrintLine("batch end");
+    if (!printConfigContinue()) {
+        // put the live config back in place until the dump continues
+        swapConfigs();
     }
-#endif
-
-    // restore configs from copies
-    restoreConfigs();
 }
 
 static void cliDump(char *cmdline)
@@ -5904,6 +6435,9 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("beeper", "enable/disable beeper for a condition", "list\r\n"
         "\t<->[name]", cliBeeper),
 #endif // USE_BEEPER
+#ifdef USE_BENCHMARK
+    CLI_COMMAND_DEF("bench", "run the hot path kernels on the target", "[<iterations>]", cliBenchmark),
+#endif
 #if defined(USE_RX_SPI) || defined (USE_SERIALRX_SRXL2)
     CLI_COMMAND_DEF("bind_rx", "initiate binding for RX SPI or SRXL2", NULL, cliRxBind),
 #endif
@@ -5919,7 +6453,7 @@ const clicmd_t cmdTable[] = {
         CLI_COMMAND_DEF("color", "configure colors", NULL, cliColor),
 #endif
 #if defined(USE_CUSTOM_DEFAULTS)
-    CLI_COMMAND_DEF("defaults", "reset to defaults and reboot", "[nosave|bare|show]", cliDefaults),
+    CLI_COMMAND_DEF("defaults", "reset to defaults and reboot", "[nosave|bare|show|compile]", cliDefaults),
 #else
     CLI_COMMAND_DEF("defaults", "reset to defaults and reboot", "[nosave|show]", cliDefaults),
 #endif
@@ -5975,6 +6509,7 @@ const clicmd_t cmdTable[] = {
 #endif
     CLI_COMMAND_DEF("map", "configure rc channel order", "[<map>]", cliMap),
     CLI_COMMAND_DEF("mcu_id", "id of the microcontroller", NULL, cliMcuId),
+    CLI_COMMAND_DEF("memory", "show stack and queue usage", NULL, cliMemory),
 #ifndef USE_QUAD_MIXER_ONLY
     CLI_COMMAND_DEF("mixer", "configure mixer", "list\r\n\t<name>", cliMixer),
 #endif
@@ -6031,6 +6566,9 @@ const clicmd_t cmdTable[] = {
         "\treverse <servo> <source> r|n", cliServoMix),
 #endif
     CLI_COMMAND_DEF("status", "show status", NULL, cliStatus),
+#ifdef USE_SYSTEM_ID
+    CLI_COMMAND_DEF("sysid", "show the last system identification result", NULL, cliSysid),
+#endif
 #if defined(USE_TASK_STATISTICS)
     CLI_COMMAND_DEF("tasks", "show task stats", NULL, cliTasks),
 #endif
@@ -6122,8 +6660,8 @@ static void processCharacter(const char c)
 
         memset(cliBuffer, 0, sizeof(cliBuffer));
 
-        // 'exit' will reset this flag, so we don't need to print prompt again
-        if (!cliMode) {
+        // 'exit' will reset this flag, so we don't need to print prompt again, a suspended dump prints it when it completes
+        if (!cliMode || dumpState.step != DUMP_STEP_IDLE) {
             return;
         }
 
@@ -6203,7 +6741,17 @@ void cliProcess(void)
     // Flush the buffer to get rid of any MSP data polls sent by configurator after CLI was invoked
     cliWriterFlush();
 
-    while (serialRxBytesWaiting(cliPort)) {
+    if (dumpState.step != DUMP_STEP_IDLE) {
+        swapConfigs();
+        if (!printConfigContinue()) {
+            swapConfigs();
+            return;
+        }
+        cliPrompt();
+    }
+
+    // input waits until a dump completes
+    while (dumpState.step == DUMP_STEP_IDLE && serialRxBytesWaiting(cliPort)) {
         uint8_t c = serialRead(cliPort);
 
         processCharacterInteractive(c);
@@ -6214,7 +6762,20 @@ void cliProcess(void)
 static bool cliProcessCustomDefaults(void)
 {
     char *customDefaultsPtr = customDefaultsStart;
-    if (processingCustomDefaults || !isCustomDefaults(customDefaultsPtr)) {
+    if (processingCustomDefaults) {
+        return false;
+    }
+
+    if (isBoardDescription(customDefaultsPtr)) {
+        if (applyBoardDescription(customDefaultsPtr)) {
+            cliPrintLine("###WARNING: BOARD DESCRIPTION DOES NOT MATCH THIS FIRMWARE###");
+        }
+        systemConfigMutable()->configurationState = CONFIGURATION_STATE_DEFAULTS_CUSTOM;
+
+        return true;
+    }
+
+    if (!isCustomDefaults(customDefaultsPtr)) {
         return false;
     }
 
@@ -45,15 +45,21 @@
 #include "fc/core.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
+#include "fc/rc_curves.h"
+#include "fc/tasks.h"
 
 #include "flight/failsafe.h"
 #include "flight/gps_rescue.h"
+#include "flight/governor.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/position.h"
 #include "flight/rpm_filter.h"
 #include "flight/servos.h"
+#include "flight/swash.h"
+#include "flight/sysid.h"
+#include "flight/vibration.h"
 
 #include "io/beeper.h"
 #include "io/gimbal.h"
@@ -172,7 +178,7 @@ static const char * const lookupTableAlignment[] = {
 
 #ifdef USE_MULTI_GYRO
 static const char * const lookupTableGyro[] = {
-    "FIRST", "SECOND", "BOTH"
+    "FIRST", "SECOND", "BOTH", "FUSED"
 };
 #endif
 
@@ -202,6 +208,12 @@ static const char * const lookupTableBlackboxMode[] = {
 };
 #endif
 
+#ifdef USE_BLACKBOX_COMPRESSION
+static const char * const lookupTableBlackboxCompression[] = {
+    "OFF", "HUFFMAN"
+};
+#endif
+
 #ifdef USE_SERIAL_RX
 static const char * const lookupTableSerialRX[] = {
     "SPEK1024",
@@ -282,7 +294,11 @@ static const char * const lookupTableAntiGravityMode[] = {
 };
 
 static const char * const lookupTableFailsafe[] = {
-    "AUTO-LAND", "DROP", "GPS-RESCUE"
+    "AUTO-LAND", "DROP",
+#ifdef USE_GPS_RESCUE
+    "GPS-RESCUE",
+#endif
+    "HELI"
 };
 
 static const char * const lookupTableFailsafeSwitchMode[] = {
@@ -391,6 +407,10 @@ static const char * const lookupTableRcSmoothingDerivativeType[] = {
 static const char * const lookupTableDynamicFilterRange[] = {
     "HIGH", "MEDIUM", "LOW", "AUTO"
 };
+
+static const char * const lookupTableDynamicFilterWindow[] = {
+    "32", "128", "256"
+};
 #endif // USE_GYRO_DATA_ANALYSE
 
 #ifdef USE_SDCARD
@@ -466,7 +486,41 @@ static const char * const lookupTableOsdLogoOnArming[] = {
 
 #ifdef USE_ESC_SENSOR
 static const char * const lookupTableEscSensorProtocol[] = {
-    "KISS", "HOBBYWINGV4"
+    "KISS", "HOBBYWINGV4", "DSHOT"
+};
+#endif
+
+#ifdef USE_FREQ_SENSOR
+static const char * const lookupTableFreqCaptureEdges[] = {
+    "1", "2", "4", "8"
+};
+#endif
+
+#ifdef USE_SERVOS
+static const char * const lookupTableSwashType[] = {
+    "NONE", "H1", "CCPM120", "CCPM135", "CCPM140", "H4_90", "H4_45"
+};
+#endif
+
+static const char * const lookupTableTaskPriority[] = {
+    "DEFAULT", "IDLE", "LOW", "MEDIUM", "MEDIUM_HIGH", "HIGH"
+};
+
+#ifdef USE_LOOPTIME_CHECK
+static const char * const lookupTableLooptimeCheck[] = {
+    "OFF", "WARN", "AUTO"
+};
+#endif
+
+#ifdef USE_GYRO_TEMP_COMP
+static const char * const lookupTableGyroTempComp[] = {
+    "OFF", "ON", "SKIP_CALIBRATION"
+};
+#endif
+
+#ifdef USE_SYSTEM_ID
+static const char * const lookupTableSysidAxis[] = {
+    "ROLL", "PITCH", "YAW"
 };
 #endif
 
@@ -487,6 +541,9 @@ const lookupTableEntry_t lookupTables[] = {
 #ifdef USE_BLACKBOX
     LOOKUP_TABLE_ENTRY(lookupTableBlackboxDevice),
     LOOKUP_TABLE_ENTRY(lookupTableBlackboxMode),
+#endif
+#ifdef USE_BLACKBOX_COMPRESSION
+    LOOKUP_TABLE_ENTRY(lookupTableBlackboxCompression),
 #endif
     LOOKUP_TABLE_ENTRY(currentMeterSourceNames),
     LOOKUP_TABLE_ENTRY(voltageMeterSourceNames),
@@ -559,6 +616,7 @@ const lookupTableEntry_t lookupTables[] = {
 #endif // USE_RC_SMOOTHING_FILTER
 #ifdef USE_GYRO_DATA_ANALYSE
     LOOKUP_TABLE_ENTRY(lookupTableDynamicFilterRange),
+    LOOKUP_TABLE_ENTRY(lookupTableDynamicFilterWindow),
 #endif // USE_GYRO_DATA_ANALYSE
     LOOKUP_TABLE_ENTRY(lookupTableGyroHardware),
 #ifdef USE_SDCARD
@@ -586,6 +644,22 @@ const lookupTableEntry_t lookupTables[] = {
 #ifdef USE_ESC_SENSOR
     LOOKUP_TABLE_ENTRY(lookupTableEscSensorProtocol),
 #endif
+#ifdef USE_FREQ_SENSOR
+    LOOKUP_TABLE_ENTRY(lookupTableFreqCaptureEdges),
+#endif
+#ifdef USE_SERVOS
+    LOOKUP_TABLE_ENTRY(lookupTableSwashType),
+#endif
+    LOOKUP_TABLE_ENTRY(lookupTableTaskPriority),
+#ifdef USE_LOOPTIME_CHECK
+    LOOKUP_TABLE_ENTRY(lookupTableLooptimeCheck),
+#endif
+#ifdef USE_GYRO_TEMP_COMP
+    LOOKUP_TABLE_ENTRY(lookupTableGyroTempComp),
+#endif
+#ifdef USE_SYSTEM_ID
+    LOOKUP_TABLE_ENTRY(lookupTableSysidAxis),
+#endif
 };
 
 #undef LOOKUP_TABLE_ENTRY
@@ -620,6 +694,19 @@ const clivalue_t valueTable[] = {
     { "yaw_spin_threshold",         VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 500,  1950 }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, yaw_spin_threshold) },
 #endif
 
+#ifdef USE_GYRO_FIFO
+    { "gyro_fifo_decimation",       VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 1, GYRO_FIFO_DECIMATION_MAX }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, gyro_fifo_decimation) },
+#endif
+#ifdef USE_GYRO_ISR_READ
+    { "gyro_isr_read",              VAR_UINT8  | HARDWARE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, gyro_isr_read) },
+#endif
+#ifdef USE_GYRO_ISR_PID
+    { "gyro_isr_pid",               VAR_UINT8  | HARDWARE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, gyro_isr_pid) },
+#endif
+#ifdef USE_GYRO_TEMP_COMP
+    { "gyro_temp_comp",             VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_GYRO_TEMP_COMP }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, gyro_temp_comp) },
+#endif
+
 #ifdef USE_MULTI_GYRO
     { "gyro_to_use",                VAR_UINT8  | HARDWARE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_GYRO }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, gyro_to_use) },
 #endif
@@ -627,7 +714,9 @@ const clivalue_t valueTable[] = {
     { "dyn_notch_range",           VAR_UINT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DYNAMIC_FILTER_RANGE }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, dyn_notch_range) },
     { "dyn_notch_width_percent",   VAR_UINT8   | MASTER_VALUE, .config.minmaxUnsigned = { 0, 20 }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, dyn_notch_width_percent) },
     { "dyn_notch_q",               VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 1, 1000 }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, dyn_notch_q) },
-    { "dyn_notch_min_hz",          VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 60, 1000 }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, dyn_notch_min_hz) },
+    { "dyn_notch_min_hz",          VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 20, 1000 }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, dyn_notch_min_hz) },
+    { "dyn_notch_window",          VAR_UINT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DYNAMIC_FILTER_WINDOW }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, dyn_notch_window) },
+    { "dyn_notch_count",           VAR_UINT8   | MASTER_VALUE, .config.minmaxUnsigned = { 1, DYN_NOTCH_COUNT_MAX }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, dyn_notch_count) },
 #endif
 #ifdef USE_DYN_LPF
     { "dyn_lpf_gyro_min_hz",        VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_GYRO_CONFIG, offsetof(gyroConfig_t, dyn_lpf_gyro_min_hz) },
@@ -642,6 +731,9 @@ const clivalue_t valueTable[] = {
     { "acc_high_range",             VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_ACCELEROMETER_CONFIG, offsetof(accelerometerConfig_t, acc_high_fsr) },
 #endif
     { "acc_lpf_hz",                 VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 400 }, PG_ACCELEROMETER_CONFIG, offsetof(accelerometerConfig_t, acc_lpf_hz) },
+#ifdef USE_RPM_FILTER
+    { "acc_rpm_filter",             VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_ACCELEROMETER_CONFIG, offsetof(accelerometerConfig_t, acc_rpm_filter) },
+#endif
     { "acc_trim_pitch",             VAR_INT16  | MASTER_VALUE, .config.minmax = { -300, 300 }, PG_ACCELEROMETER_CONFIG, offsetof(accelerometerConfig_t, accelerometerTrims.values.pitch) },
     { "acc_trim_roll",              VAR_INT16  | MASTER_VALUE, .config.minmax = { -300, 300 }, PG_ACCELEROMETER_CONFIG, offsetof(accelerometerConfig_t, accelerometerTrims.values.roll) },
 
@@ -717,6 +809,7 @@ const clivalue_t valueTable[] = {
 #if defined(USE_SERIALRX_SBUS)
     { "sbus_baud_fast",           VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_RX_CONFIG, offsetof(rxConfig_t, sbus_baud_fast) },
 #endif
+    { "rx_inline_pid",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_RX_CONFIG, offsetof(rxConfig_t, rx_inline_pid) },
     { "airmode_start_throttle_percent",     VAR_UINT8 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_RX_CONFIG, offsetof(rxConfig_t, airModeActivateThreshold) },
     { "rx_min_usec",                VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { PWM_PULSE_MIN, PWM_PULSE_MAX }, PG_RX_CONFIG, offsetof(rxConfig_t, rx_min_usec) },
     { "rx_max_usec",                VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { PWM_PULSE_MIN, PWM_PULSE_MAX }, PG_RX_CONFIG, offsetof(rxConfig_t, rx_max_usec) },
@@ -733,6 +826,9 @@ const clivalue_t valueTable[] = {
     { "adc_vrefint_calibration",    VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 2000 }, PG_ADC_CONFIG, offsetof(adcConfig_t, vrefIntCalibration) },
     { "adc_tempsensor_calibration30", VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 2000 }, PG_ADC_CONFIG, offsetof(adcConfig_t, tempSensorCalibration1) },
     { "adc_tempsensor_calibration110", VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 2000 }, PG_ADC_CONFIG, offsetof(adcConfig_t, tempSensorCalibration2) },
+#ifdef USE_ADC_MOTOR_SYNC
+    { "adc_motor_sync",             VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_ADC_CONFIG, offsetof(adcConfig_t, motorSync) },
+#endif
 #endif
 
 // PG_PWM_CONFIG
@@ -746,6 +842,11 @@ const clivalue_t valueTable[] = {
     { "blackbox_device",            VAR_UINT8  | HARDWARE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_BLACKBOX_DEVICE }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, device) },
     { "blackbox_record_acc",        VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, record_acc) },
     { "blackbox_mode",              VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_BLACKBOX_MODE }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, mode) },
+    { "blackbox_fast_denom",        VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 128 }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, fast_denom) },
+    { "blackbox_heli_denom",        VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 128 }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, heli_denom) },
+#ifdef USE_BLACKBOX_COMPRESSION
+    { "blackbox_compression",       VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_BLACKBOX_COMPRESSION }, PG_BLACKBOX_CONFIG, offsetof(blackboxConfig_t, compression) },
+#endif
 #endif
 
 // PG_MOTOR_CONFIG
@@ -770,6 +871,7 @@ const clivalue_t valueTable[] = {
     { "motor_pwm_rate",             VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 200, 32000 }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, dev.motorPwmRate) },
     { "motor_pwm_inversion",        VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, dev.motorPwmInversion) },
     { "motor_poles",                VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = MAX_SUPPORTED_MOTORS, PG_MOTOR_CONFIG, offsetof(motorConfig_t, motorPoleCount) },
+    { "motor_output_phase_us",      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_MOTOR_CONFIG, offsetof(motorConfig_t, outputPhaseUs) },
 
 // PG_THROTTLE_CORRECTION_CONFIG
     { "thr_corr_value",             VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0,  150 }, PG_THROTTLE_CORRECTION_CONFIG, offsetof(throttleCorrectionConfig_t, throttle_correction_value) },
@@ -784,6 +886,12 @@ const clivalue_t valueTable[] = {
     { "failsafe_procedure",         VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_FAILSAFE }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_procedure) },
     { "failsafe_recovery_delay",    VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 200 }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_recovery_delay) },
     { "failsafe_stick_threshold",   VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 50 }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_stick_threshold) },
+    { "failsafe_heli_hold_time",    VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 200 }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_heli_hold_time) },
+    { "failsafe_heli_min_headspeed",VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 10000 }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_heli_min_headspeed) },
+    { "failsafe_heli_flare_alt",    VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_heli_flare_alt) },
+    { "failsafe_heli_autorotation_collective", VAR_INT16 | MASTER_VALUE, .config.minmax = { -500, 500 }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_heli_autorotation_collective) },
+    { "failsafe_heli_flare_collective", VAR_INT16 | MASTER_VALUE, .config.minmax = { -500, 500 }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_heli_flare_collective) },
+    { "failsafe_heli_landing_time", VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 1, 255 }, PG_FAILSAFE_CONFIG, offsetof(failsafeConfig_t, failsafe_heli_landing_time) },
 
 // PG_BOARDALIGNMENT_CONFIG
     { "align_board_roll",           VAR_INT16  | MASTER_VALUE, .config.minmax = { -180, 360 }, PG_BOARD_ALIGNMENT, offsetof(boardAlignment_t, rollDegrees) },
@@ -814,6 +922,7 @@ const clivalue_t valueTable[] = {
     { "ibat_lpf_period",            VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT8_MAX }, PG_BATTERY_CONFIG, offsetof(batteryConfig_t, ibatLpfPeriod) },
     { "vbat_duration_for_warning",  VAR_UINT8  | MASTER_VALUE, .config.minmax = { 0, 150 }, PG_BATTERY_CONFIG, offsetof(batteryConfig_t, vbatDurationForWarning) },
     { "vbat_duration_for_critical",  VAR_UINT8  | MASTER_VALUE, .config.minmax = { 0, 150 }, PG_BATTERY_CONFIG, offsetof(batteryConfig_t, vbatDurationForCritical) },
+    { "vbat_sag_compensation",      VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_BATTERY_CONFIG, offsetof(batteryConfig_t, vbatSagCompensation) },
 
 //  PG_VOLTAGE_SENSOR_ADC_CONFIG
     { "vbat_scale",                 VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { VBAT_SCALE_MIN, VBAT_SCALE_MAX }, PG_VOLTAGE_SENSOR_ADC_CONFIG, offsetof(voltageSensorADCConfig_t, vbatscale) },
@@ -857,6 +966,14 @@ const clivalue_t valueTable[] = {
     { "gov_collective_ff_impulse_gain",  VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 500 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_collective_ff_impulse_gain) },
     { "spoolup_time",               VAR_UINT8 |  MASTER_VALUE,  .config.minmaxUnsigned = { 0, 15 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, spoolup_time) },
     { "gov_tailmotor_assist_gain",  VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 300 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_tailmotor_assist_gain) },
+    { "gov_update_hz",              VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { GOV_UPDATE_HZ_MIN, GOV_UPDATE_HZ_MAX }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_update_hz) },
+    { "gov_bailout_time",           VAR_UINT8  |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_bailout_time) },
+    { "gov_bailout_percent",        VAR_UINT8  |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_bailout_percent) },
+    { "gov_vbat_comp",              VAR_UINT8  |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_vbat_comp) },
+    { "gov_current_ff_gain",        VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, gov_current_ff_gain) },
+    { "tail_rpm_max",               VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 50000 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, tail_rpm_max) },
+    { "tail_rpm_p_gain",            VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 500 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, tail_rpm_p_gain) },
+    { "tail_rpm_i_gain",            VAR_UINT16 |  MASTER_VALUE, .config.minmaxUnsigned = { 0, 500 }, PG_MIXER_CONFIG, offsetof(mixerConfig_t, tail_rpm_i_gain) },
 
 // PG_MOTOR_3D_CONFIG
     { "3d_deadband_low",            VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { PWM_PULSE_MIN, PWM_RANGE_MIDDLE }, PG_MOTOR_3D_CONFIG, offsetof(flight3DConfig_t, deadband3d_low) },
@@ -872,9 +989,18 @@ const clivalue_t valueTable[] = {
     // HF3D TODO:  Servo center pulse no longer used.  Port is initialized to 0 pulse width until servo mixer provides a desired output.  Consider removing this parameter.
     { "servo_center_pulse",         VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { PWM_PULSE_MIN, PWM_PULSE_MAX }, PG_SERVO_CONFIG, offsetof(servoConfig_t, dev.servoCenterPulse) },
     { "servo_pwm_rate",             VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 50, 493 }, PG_SERVO_CONFIG, offsetof(servoConfig_t, dev.servoPwmRate) },
+    { "servo_frame_average",        VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_SERVO_CONFIG, offsetof(servoConfig_t, dev.servoFrameAverage) },
     { "servo_lowpass_hz",           VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 400}, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_lowpass_freq) },
     { "tri_unarmed_servo",          VAR_INT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_SERVO_CONFIG, offsetof(servoConfig_t, tri_unarmed_servo) },
     { "channel_forwarding_start",   VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { AUX1, MAX_SUPPORTED_RC_CHANNEL_COUNT }, PG_SERVO_CONFIG, offsetof(servoConfig_t, channelForwardingStartChannel) },
+    { "servo_arm_length",           VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = MAX_SUPPORTED_SERVOS, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_arm_length) },
+    { "servo_link_length",          VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = MAX_SUPPORTED_SERVOS, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_link_length) },
+    { "servo_throw",                VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = MAX_SUPPORTED_SERVOS, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_throw) },
+    { "servo_slew_rate",            VAR_UINT16 | MASTER_VALUE | MODE_ARRAY, .config.array.length = MAX_SUPPORTED_SERVOS, PG_SERVO_CONFIG, offsetof(servoConfig_t, servo_slew_rate) },
+
+// PG_SWASH_CONFIG
+    { "swash_type",                 VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_SWASH_TYPE }, PG_SWASH_CONFIG, offsetof(swashConfig_t, swash_type) },
+    { "swash_phase",                VAR_INT16  | MASTER_VALUE, .config.minmax = { -SWASH_PHASE_MAX, SWASH_PHASE_MAX }, PG_SWASH_CONFIG, offsetof(swashConfig_t, swash_phase) },
 #endif
 
 // PG_CONTROLRATE_PROFILES
@@ -907,11 +1033,13 @@ const clivalue_t valueTable[] = {
 // PG_SERIAL_CONFIG
     { "reboot_character",           VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 48, 126 }, PG_SERIAL_CONFIG, offsetof(serialConfig_t, reboot_character) },
     { "serial_update_rate_hz",      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 100, 2000 }, PG_SERIAL_CONFIG, offsetof(serialConfig_t, serial_update_rate_hz) },
+    { "serial_buffer_ms",           VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 1, 100 }, PG_SERIAL_CONFIG, offsetof(serialConfig_t, buffer_ms) },
 
 // PG_IMU_CONFIG
     { "imu_dcm_kp",                 VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 32000 }, PG_IMU_CONFIG, offsetof(imuConfig_t, dcm_kp) },
     { "imu_dcm_ki",                 VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 32000 }, PG_IMU_CONFIG, offsetof(imuConfig_t, dcm_ki) },
     { "small_angle",                VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 180 }, PG_IMU_CONFIG, offsetof(imuConfig_t, small_angle) },
+    { "imu_gyro_update_hz",         VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 8000 }, PG_IMU_CONFIG, offsetof(imuConfig_t, gyro_update_hz) },
 
 // PG_ARMING_CONFIG
     { "auto_disarm_delay",          VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 60 }, PG_ARMING_CONFIG, offsetof(armingConfig_t, auto_disarm_delay) },
@@ -927,6 +1055,8 @@ const clivalue_t valueTable[] = {
     { "gps_ublox_use_galileo",      VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_GPS_CONFIG, offsetof(gpsConfig_t, gps_ublox_use_galileo) },
     { "gps_set_home_point_once",    VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_GPS_CONFIG, offsetof(gpsConfig_t, gps_set_home_point_once) },
     { "gps_use_3d_speed",           VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_GPS_CONFIG, offsetof(gpsConfig_t, gps_use_3d_speed) },
+    { "gps_ublox_use_pvt",          VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_GPS_CONFIG, offsetof(gpsConfig_t, gps_ublox_use_pvt) },
+    { "gps_ublox_nav_hz",           VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 1, GPS_UBLOX_NAV_HZ_MAX }, PG_GPS_CONFIG, offsetof(gpsConfig_t, gps_ublox_nav_hz) },
 
 #ifdef USE_GPS_RESCUE
     // PG_GPS_RESCUE
@@ -949,6 +1079,9 @@ const clivalue_t valueTable[] = {
     { "gps_rescue_ascend_rate",     VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 100, 2500 }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, ascendRate) },
     { "gps_rescue_descend_rate",    VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 100, 500 }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, descendRate) },
     { "gps_rescue_throttle_hover",  VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 1000, 2000 }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, throttleHover) },
+    { "gps_rescue_collective_min",  VAR_INT16  | MASTER_VALUE, .config.minmax = { -500, 500 }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, collectiveMin) },
+    { "gps_rescue_collective_max",  VAR_INT16  | MASTER_VALUE, .config.minmax = { -500, 500 }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, collectiveMax) },
+    { "gps_rescue_collective_hover", VAR_INT16 | MASTER_VALUE, .config.minmax = { -500, 500 }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, collectiveHover) },
     { "gps_rescue_sanity_checks",   VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_GPS_RESCUE_SANITY_CHECK }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, sanityChecks) },
     { "gps_rescue_min_sats",        VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 5, 50 }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, minSats) },
     { "gps_rescue_min_dth",         VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 50, 1000 }, PG_GPS_RESCUE, offsetof(gpsRescueConfig_t, minRescueDth) },
@@ -966,6 +1099,11 @@ const clivalue_t valueTable[] = {
 
 // PG_PID_CONFIG
     { "pid_process_denom",          VAR_UINT8  | MASTER_VALUE,  .config.minmaxUnsigned = { 1, MAX_PID_PROCESS_DENOM }, PG_PID_CONFIG, offsetof(pidConfig_t, pid_process_denom) },
+    { "pid_cyclic_denom",           VAR_UINT8  | MASTER_VALUE,  .config.minmaxUnsigned = { 1, MAX_PID_AXIS_DENOM }, PG_PID_CONFIG, offsetof(pidConfig_t, pid_cyclic_denom) },
+    { "pid_yaw_denom",              VAR_UINT8  | MASTER_VALUE,  .config.minmaxUnsigned = { 1, MAX_PID_AXIS_DENOM }, PG_PID_CONFIG, offsetof(pidConfig_t, pid_yaw_denom) },
+#ifdef USE_LOOPTIME_CHECK
+    { "pid_looptime_check",         VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_LOOPTIME_CHECK }, PG_PID_CONFIG, offsetof(pidConfig_t, pid_looptime_check) },
+#endif
 #ifdef USE_RUNAWAY_TAKEOFF
     { "runaway_takeoff_prevention", VAR_UINT8  | MODE_LOOKUP,  .config.lookup = { TABLE_OFF_ON }, PG_PID_CONFIG, offsetof(pidConfig_t, runaway_takeoff_prevention) },    // enables/disables runaway takeoff prevention
     { "runaway_takeoff_deactivate_delay",  VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 100, 1000 }, PG_PID_CONFIG, offsetof(pidConfig_t, runaway_takeoff_deactivate_delay) },           // deactivate time in ms
@@ -1084,6 +1222,8 @@ const clivalue_t valueTable[] = {
     { "ff_spike_limit",             VAR_UINT8 | PROFILE_VALUE, .config.minmaxUnsigned = {0, 255}, PG_PID_PROFILE, offsetof(pidProfile_t, ff_spike_limit) },
     { "ff_max_rate_limit",          VAR_UINT8 | PROFILE_VALUE, .config.minmaxUnsigned = {0, 150}, PG_PID_PROFILE, offsetof(pidProfile_t, ff_max_rate_limit) },
     { "ff_smooth_factor",           VAR_UINT8 | PROFILE_VALUE, .config.minmaxUnsigned = {0, 75}, PG_PID_PROFILE, offsetof(pidProfile_t, ff_smooth_factor) },
+    { "ff_prediction",              VAR_UINT8 | PROFILE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_PID_PROFILE, offsetof(pidProfile_t, ff_prediction) },
+    { "ff_lookahead_ms",            VAR_UINT8 | PROFILE_VALUE, .config.minmaxUnsigned = {0, 50}, PG_PID_PROFILE, offsetof(pidProfile_t, ff_lookahead_ms) },
 #endif
     { "ff_boost",                   VAR_UINT8 | PROFILE_VALUE,  .config.minmaxUnsigned = { 0, 50 }, PG_PID_PROFILE, offsetof(pidProfile_t, ff_boost) },
 
@@ -1099,10 +1239,14 @@ const clivalue_t valueTable[] = {
     { "yaw_collective_ff_gain",         VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 2000 },PG_PID_PROFILE, offsetof(pidProfile_t, yawColKf) },
     { "yaw_collective_ff_impulse_gain", VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 2000 },PG_PID_PROFILE, offsetof(pidProfile_t, yawColPulseKf) },
     { "yaw_cyclic_ff_gain",             VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 1000 },PG_PID_PROFILE, offsetof(pidProfile_t, yawCycKf) },
+    { "yaw_collective_ff_curve",        VAR_UINT8  | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_PID_PROFILE, offsetof(pidProfile_t, yaw_collective_ff_curve) },
+    { "yaw_headspeed_ff_gain",          VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_PID_PROFILE, offsetof(pidProfile_t, yaw_headspeed_ff_gain) },
     { "yaw_base_thrust",                VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 3000 },PG_PID_PROFILE, offsetof(pidProfile_t, yawBaseThrust) },
     { "rescue_collective",              VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 50, 500 },PG_PID_PROFILE, offsetof(pidProfile_t, rescue_collective) },
     { "rescue_collective_boost",        VAR_UINT8 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 150 },PG_PID_PROFILE, offsetof(pidProfile_t, rescue_collective_boost) },
     { "rescue_delay",               	VAR_UINT8 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 35 }, PG_PID_PROFILE, offsetof(pidProfile_t, rescue_delay) },
+    { "rescue_max_rate",                VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 50, 1000 }, PG_PID_PROFILE, offsetof(pidProfile_t, rescue_max_rate) },
+    { "rescue_max_accel",               VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 100, 20000 }, PG_PID_PROFILE, offsetof(pidProfile_t, rescue_max_accel) },
     { "error_decay_always",             VAR_UINT8  | PROFILE_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_PID_PROFILE, offsetof(pidProfile_t, error_decay_always) },
     { "error_decay_rate",               VAR_UINT8  | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 45 },PG_PID_PROFILE, offsetof(pidProfile_t, error_decay_rate) },
     { "collective_ff_impulse_freq",     VAR_UINT16 | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 1000 }, PG_PID_PROFILE, offsetof(pidProfile_t, collective_ff_impulse_freq) },
@@ -1110,6 +1254,13 @@ const clivalue_t valueTable[] = {
     { "elevator_filter_window_time",    VAR_UINT8  | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 255 },PG_PID_PROFILE, offsetof(pidProfile_t, elevator_filter_window_time) },
     { "elevator_filter_window_size",    VAR_UINT8  | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 100 },PG_PID_PROFILE, offsetof(pidProfile_t, elevator_filter_window_size) },
     { "elevator_filter_hz",             VAR_UINT8  | PROFILE_VALUE, .config.minmaxUnsigned = { 0, 100 },PG_PID_PROFILE, offsetof(pidProfile_t, elevator_filter_hz) },
+    { "gain_schedule_rpm",              VAR_UINT16 | PROFILE_VALUE | MODE_ARRAY, .config.array.length = PID_GAIN_SCHEDULE_POINTS, PG_PID_PROFILE, offsetof(pidProfile_t, gain_schedule_rpm) },
+    { "gain_schedule_roll",             VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array.length = PID_GAIN_SCHEDULE_POINTS, PG_PID_PROFILE, offsetof(pidProfile_t, gain_schedule_percent[FD_ROLL]) },
+    { "gain_schedule_pitch",            VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array.length = PID_GAIN_SCHEDULE_POINTS, PG_PID_PROFILE, offsetof(pidProfile_t, gain_schedule_percent[FD_PITCH]) },
+    { "smith_delay_ms",                 VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array.length = XYZ_AXIS_COUNT, PG_PID_PROFILE, offsetof(pidProfile_t, smith_delay_ms) },
+    { "smith_lag_ms",                   VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array.length = XYZ_AXIS_COUNT, PG_PID_PROFILE, offsetof(pidProfile_t, smith_lag_ms) },
+    { "smith_gain",                     VAR_UINT16 | PROFILE_VALUE | MODE_ARRAY, .config.array.length = XYZ_AXIS_COUNT, PG_PID_PROFILE, offsetof(pidProfile_t, smith_gain) },
+    { "gain_schedule_yaw",              VAR_UINT8  | PROFILE_VALUE | MODE_ARRAY, .config.array.length = PID_GAIN_SCHEDULE_POINTS, PG_PID_PROFILE, offsetof(pidProfile_t, gain_schedule_percent[FD_YAW]) },
     
     
 // PG_TELEMETRY_CONFIG
@@ -1158,6 +1309,10 @@ const clivalue_t valueTable[] = {
     { "telemetry_disabled_esc_rpm",         VAR_UINT32  | MASTER_VALUE | MODE_BITSET, .config.bitpos = LOG2(ESC_SENSOR_RPM),         PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, disabledSensors)},
     { "telemetry_disabled_esc_temperature", VAR_UINT32  | MASTER_VALUE | MODE_BITSET, .config.bitpos = LOG2(ESC_SENSOR_TEMPERATURE), PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, disabledSensors)},
     { "telemetry_disabled_temperature",     VAR_UINT32  | MASTER_VALUE | MODE_BITSET, .config.bitpos = LOG2(SENSOR_TEMPERATURE),     PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, disabledSensors)},
+    { "telemetry_disabled_headspeed",       VAR_UINT32  | MASTER_VALUE | MODE_BITSET, .config.bitpos = LOG2(SENSOR_HEADSPEED),       PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, disabledSensors)},
+    { "telemetry_disabled_governor",        VAR_UINT32  | MASTER_VALUE | MODE_BITSET, .config.bitpos = LOG2(SENSOR_GOVERNOR),        PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, disabledSensors)},
+    { "telemetry_disabled_bec_voltage",     VAR_UINT32  | MASTER_VALUE | MODE_BITSET, .config.bitpos = LOG2(SENSOR_BEC_VOLTAGE),     PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, disabledSensors)},
+    { "telemetry_disabled_vibration",       VAR_UINT32  | MASTER_VALUE | MODE_BITSET, .config.bitpos = LOG2(SENSOR_VIBRATION),       PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, disabledSensors)},
 #else
     { "telemetry_disabled_sensors", VAR_UINT32 | MASTER_VALUE, .config.u32Max = SENSOR_ALL, PG_TELEMETRY_CONFIG, offsetof(telemetryConfig_t, disabledSensors)},
 #endif
@@ -1328,6 +1483,10 @@ const clivalue_t valueTable[] = {
 
     { "osd_rcchannels_pos",     VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 0, OSD_POSCFG_MAX }, PG_OSD_ELEMENT_CONFIG, offsetof(osdElementConfig_t, item_pos[OSD_RC_CHANNELS]) },
     { "osd_camera_frame_pos",   VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 0, OSD_POSCFG_MAX }, PG_OSD_ELEMENT_CONFIG, offsetof(osdElementConfig_t, item_pos[OSD_CAMERA_FRAME]) },
+    { "osd_headspeed_pos",      VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 0, OSD_POSCFG_MAX }, PG_OSD_ELEMENT_CONFIG, offsetof(osdElementConfig_t, item_pos[OSD_HEADSPEED]) },
+    { "osd_governor_pos",       VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 0, OSD_POSCFG_MAX }, PG_OSD_ELEMENT_CONFIG, offsetof(osdElementConfig_t, item_pos[OSD_GOVERNOR]) },
+    { "osd_collective_pitch_pos", VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, OSD_POSCFG_MAX }, PG_OSD_ELEMENT_CONFIG, offsetof(osdElementConfig_t, item_pos[OSD_COLLECTIVE_PITCH]) },
+    { "osd_swash_ring_pos",     VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 0, OSD_POSCFG_MAX }, PG_OSD_ELEMENT_CONFIG, offsetof(osdElementConfig_t, item_pos[OSD_SWASH_RING]) },
 
     // OSD stats enabled flags are stored as bitmapped values inside a 32bit parameter
     // It is recommended to keep the settings order the same as the enumeration. This way the settings are displayed in the cli in the same order making it easier on the users
@@ -1374,6 +1533,7 @@ const clivalue_t valueTable[] = {
     { "osd_rcchannels",             VAR_INT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = OSD_RCCHANNELS_COUNT, PG_OSD_CONFIG, offsetof(osdConfig_t, rcChannels) },
     { "osd_camera_frame_width",     VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { OSD_CAMERA_FRAME_MIN_WIDTH, OSD_CAMERA_FRAME_MAX_WIDTH }, PG_OSD_CONFIG, offsetof(osdConfig_t, camera_frame_width) },
     { "osd_camera_frame_height",    VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { OSD_CAMERA_FRAME_MIN_HEIGHT, OSD_CAMERA_FRAME_MAX_HEIGHT }, PG_OSD_CONFIG, offsetof(osdConfig_t, camera_frame_height) },
+    { "osd_collective_max_pitch",   VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 10, 250 }, PG_OSD_CONFIG, offsetof(osdConfig_t, collective_max_pitch) },
 #endif // end of #ifdef USE_OSD
 
 // PG_SYSTEM_CONFIG
@@ -1384,14 +1544,54 @@ const clivalue_t valueTable[] = {
     { "task_statistics",            VAR_INT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, task_statistics) },
 #endif
     { "debug_mode",                 VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_mode) },
+#ifdef USE_DEBUG_CHANNELS
+    { "debug_channel_1",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_mode[0]) },
+    { "debug_channel_2",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_mode[1]) },
+    { "debug_channel_3",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_mode[2]) },
+    { "debug_channel_4",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_mode[3]) },
+    { "debug_channel_5",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_mode[4]) },
+    { "debug_channel_6",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_mode[5]) },
+    { "debug_channel_7",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_mode[6]) },
+    { "debug_channel_8",            VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_DEBUG }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_mode[7]) },
+    { "debug_channel_slots",        VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = DEBUG_CHANNEL_COUNT, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, debug_channel_slot) },
+#endif
     { "rate_6pos_switch",           VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, rateProfile6PosSwitch) },
 #ifdef USE_OVERCLOCK
     { "cpu_overclock",              VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OVERCLOCK }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, cpu_overclock) },
 #endif
     { "pwr_on_arm_grace",           VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 30 }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, powerOnArmingGraceTime) },
     { "scheduler_optimize_rate",    VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON_AUTO }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, schedulerOptimizeRate) },
+    { "scheduler_deadline",         VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, schedulerDeadline) },
+    { "scheduler_shed_load",        VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, schedulerShedLoad) },
+
+// PG_TASK_CONFIG
+#ifdef USE_OSD
+    { "osd_task_rate",              VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, TASK_CONFIG_RATE_MAX }, PG_TASK_CONFIG, offsetof(taskConfig_t, rateHz[TASK_CONFIG_OSD]) },
+    { "osd_task_priority",          VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_TASK_PRIORITY }, PG_TASK_CONFIG, offsetof(taskConfig_t, priority[TASK_CONFIG_OSD]) },
+#endif
+#ifdef USE_TELEMETRY
+    { "telemetry_task_rate",        VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, TASK_CONFIG_RATE_MAX }, PG_TASK_CONFIG, offsetof(taskConfig_t, rateHz[TASK_CONFIG_TELEMETRY]) },
+    { "telemetry_task_priority",    VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_TASK_PRIORITY }, PG_TASK_CONFIG, offsetof(taskConfig_t, priority[TASK_CONFIG_TELEMETRY]) },
+#endif
+#ifdef USE_ESC_SENSOR
+    { "esc_sensor_task_rate",       VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, TASK_CONFIG_RATE_MAX }, PG_TASK_CONFIG, offsetof(taskConfig_t, rateHz[TASK_CONFIG_ESC_SENSOR]) },
+    { "esc_sensor_task_priority",   VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_TASK_PRIORITY }, PG_TASK_CONFIG, offsetof(taskConfig_t, priority[TASK_CONFIG_ESC_SENSOR]) },
+#endif
+    { "battery_load_task_rate",     VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, TASK_CONFIG_RATE_MAX }, PG_TASK_CONFIG, offsetof(taskConfig_t, rateHz[TASK_CONFIG_BATTERY_LOAD]) },
+    { "battery_load_task_priority", VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_TASK_PRIORITY }, PG_TASK_CONFIG, offsetof(taskConfig_t, priority[TASK_CONFIG_BATTERY_LOAD]) },
     { "enable_stick_arming",        VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_SYSTEM_CONFIG, offsetof(systemConfig_t, enableStickArming) },
 
+// PG_RC_CURVE_CONFIG
+    { "rc_curves",                  VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, enabled) },
+    { "thr_curve_normal",           VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = RC_CURVE_POINT_COUNT, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, throttle[RC_CURVE_BANK_NORMAL]) },
+    { "thr_curve_idleup1",          VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = RC_CURVE_POINT_COUNT, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, throttle[RC_CURVE_BANK_IDLEUP1]) },
+    { "thr_curve_idleup2",          VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = RC_CURVE_POINT_COUNT, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, throttle[RC_CURVE_BANK_IDLEUP2]) },
+    { "thr_curve_hold",             VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = RC_CURVE_POINT_COUNT, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, throttle[RC_CURVE_BANK_HOLD]) },
+    { "coll_curve_normal",          VAR_INT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = RC_CURVE_POINT_COUNT, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, collective[RC_CURVE_BANK_NORMAL]) },
+    { "coll_curve_idleup1",         VAR_INT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = RC_CURVE_POINT_COUNT, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, collective[RC_CURVE_BANK_IDLEUP1]) },
+    { "coll_curve_idleup2",         VAR_INT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = RC_CURVE_POINT_COUNT, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, collective[RC_CURVE_BANK_IDLEUP2]) },
+    { "coll_curve_hold",            VAR_INT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = RC_CURVE_POINT_COUNT, PG_RC_CURVE_CONFIG, offsetof(rcCurveConfig_t, collective[RC_CURVE_BANK_HOLD]) },
+
 // PG_VCD_CONFIG
 #ifdef USE_MAX7456
     { "vcd_video_system",           VAR_UINT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_VIDEO_SYSTEM }, PG_VCD_CONFIG, offsetof(vcdProfile_t, video_system) },
@@ -1412,6 +1612,9 @@ const clivalue_t valueTable[] = {
     { "displayport_msp_row_adjust", VAR_INT8    | MASTER_VALUE, .config.minmax = { -3, 0 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, rowAdjust) },
     { "displayport_msp_serial",     VAR_INT8    | MASTER_VALUE, .config.minmax = { SERIAL_PORT_NONE, SERIAL_PORT_IDENTIFIER_MAX }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, displayPortSerial) },
     { "displayport_msp_attrs",      VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = 4, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, attrValues) },
+    { "displayport_msp_refresh_hz", VAR_UINT8   | MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, refreshHz) },
+    { "displayport_msp_alert_refresh_hz", VAR_UINT8 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 100 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, alertRefreshHz) },
+    { "displayport_msp_max_bps",    VAR_UINT16  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 50000 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, maxBytesPerSecond) },
 #ifdef USE_DISPLAYPORT_MSP_VENDOR_SPECIFIC
     { "displayport_msp_vendor_init", VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = 253, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, vendorInit) },
     { "displayport_msp_vendor_init_length", VAR_UINT8   | MASTER_VALUE, .config.minmaxUnsigned = { 0, 252 }, PG_DISPLAY_PORT_MSP_CONFIG, offsetof(displayPortProfile_t, vendorInitLength) },
@@ -1436,6 +1639,10 @@ const clivalue_t valueTable[] = {
     { "esc_sensor_hobbywing_currscale", VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 0, 254 }, PG_ESC_SENSOR_CONFIG, offsetof(escSensorConfig_t, esc_sensor_hobbywing_currscale) },
 #endif
 
+#ifdef USE_FREQ_SENSOR
+    { "freq_capture_edges",             VAR_UINT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_FREQ_CAPTURE_EDGES }, PG_FREQ_CONFIG, offsetof(freqConfig_t, captureEdges) },
+#endif
+
 #ifdef USE_RX_FRSKY_SPI
     { "frsky_spi_autobind",             VAR_UINT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, autoBind) },
     { "frsky_spi_tx_id",                VAR_UINT8   | MASTER_VALUE | MODE_ARRAY, .config.array.length = 2, PG_RX_CC2500_SPI_CONFIG, offsetof(rxCc2500SpiConfig_t, bindTxId) },
@@ -1529,6 +1736,21 @@ const clivalue_t valueTable[] = {
     { "gyro_rpm_filter_bank_notch_q",     VAR_UINT16 | MASTER_VALUE | MODE_ARRAY, .config.array.length = RPM_FILTER_BANK_COUNT, PG_RPM_FILTER_CONFIG, offsetof(rpmFilterConfig_t, filter_bank_notch_q) },
     { "gyro_rpm_filter_bank_min_hz",      VAR_UINT16 | MASTER_VALUE | MODE_ARRAY, .config.array.length = RPM_FILTER_BANK_COUNT, PG_RPM_FILTER_CONFIG, offsetof(rpmFilterConfig_t, filter_bank_min_hz) },
     { "gyro_rpm_filter_bank_max_hz",      VAR_UINT16 | MASTER_VALUE | MODE_ARRAY, .config.array.length = RPM_FILTER_BANK_COUNT, PG_RPM_FILTER_CONFIG, offsetof(rpmFilterConfig_t, filter_bank_max_hz) },
+    { "gyro_rpm_filter_bank_harmonics",   VAR_UINT8  | MASTER_VALUE | MODE_ARRAY, .config.array.length = RPM_FILTER_BANK_COUNT, PG_RPM_FILTER_CONFIG, offsetof(rpmFilterConfig_t, filter_bank_harmonics) },
+#endif
+
+#ifdef USE_VIBRATION_MONITOR
+    { "vibration_monitor",          VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_OFF_ON }, PG_VIBRATION_CONFIG, offsetof(vibrationConfig_t, vibration_monitor) },
+    { "vibration_tail_ratio",       VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, 20000 }, PG_VIBRATION_CONFIG, offsetof(vibrationConfig_t, vibration_tail_ratio) },
+    { "vibration_bandwidth",        VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 1, 50 }, PG_VIBRATION_CONFIG, offsetof(vibrationConfig_t, vibration_bandwidth) },
+#endif
+
+#ifdef USE_SYSTEM_ID
+    { "sysid_axis",                 VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_SYSID_AXIS }, PG_SYSID_CONFIG, offsetof(sysidConfig_t, sysid_axis) },
+    { "sysid_amplitude",            VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 1, 200 }, PG_SYSID_CONFIG, offsetof(sysidConfig_t, sysid_amplitude) },
+    { "sysid_min_hz",               VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 1, 50 }, PG_SYSID_CONFIG, offsetof(sysidConfig_t, sysid_min_hz) },
+    { "sysid_max_hz",               VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 2, 100 }, PG_SYSID_CONFIG, offsetof(sysidConfig_t, sysid_max_hz) },
+    { "sysid_duration",             VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 5, 60 }, PG_SYSID_CONFIG, offsetof(sysidConfig_t, sysid_duration) },
 #endif
 
 #ifdef USE_RX_FLYSKY
@@ -1542,6 +1764,27 @@ const clivalue_t valueTable[] = {
 
     { "stats_total_time_s",     VAR_UINT32 | MASTER_VALUE, .config.u32Max = UINT32_MAX, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_total_time_s) },
     { "stats_total_dist_m",     VAR_UINT32 | MASTER_VALUE, .config.u32Max = UINT32_MAX, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_total_dist_m) },
+#ifdef USE_LOOP_TIMING
+    { "stats_total_overruns",   VAR_UINT32 | MASTER_VALUE, .config.u32Max = UINT32_MAX, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_total_overruns) },
+    { "stats_max_latency_us",   VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_max_latency_us) },
+    { "stats_max_pid_time_us",  VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_max_pid_time_us) },
+    { "stats_flight_max_pid_time_us",  VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_max_pid_time_us) },
+    { "stats_flight_p99_pid_time_us",  VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_p99_pid_time_us) },
+    { "stats_flight_overruns",         VAR_UINT32 | MASTER_VALUE, .config.u32Max = UINT32_MAX, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_overruns) },
+#endif
+#ifdef USE_BLACKBOX
+    { "stats_flight_bb_dropped",       VAR_UINT32 | MASTER_VALUE, .config.u32Max = UINT32_MAX, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_bb_dropped) },
+#endif
+    { "stats_flight_max_droop_rpm",    VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_max_droop_rpm) },
+    { "stats_flight_gov_saturated_ms", VAR_UINT32 | MASTER_VALUE, .config.u32Max = UINT32_MAX, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_gov_saturated_ms) },
+    { "stats_flight_rpm_dropouts",     VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_rpm_dropouts) },
+    { "stats_flight_i2c_errors",       VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_i2c_errors) },
+    { "stats_flight_spi_errors",       VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_spi_errors) },
+#ifdef USE_VIBRATION_MONITOR
+    { "stats_flight_vib_main_1x",      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_vib_main_1x) },
+    { "stats_flight_vib_main_2x",      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_vib_main_2x) },
+    { "stats_flight_vib_tail_1x",      VAR_UINT16 | MASTER_VALUE, .config.minmaxUnsigned = { 0, UINT16_MAX }, PG_STATS_CONFIG, offsetof(statsConfig_t, stats_flight_vib_tail_1x) },
+#endif
 #endif
     { "name",             VAR_UINT8  | MASTER_VALUE | MODE_STRING, .config.string = { 1, MAX_NAME_LENGTH, STRING_FLAGS_NONE }, PG_PILOT_CONFIG, offsetof(pilotConfig_t, name) },
 #ifdef USE_OSD
@@ -1550,6 +1793,7 @@ const clivalue_t valueTable[] = {
 
 // PG_POSITION
     { "position_alt_source",           VAR_INT8   | MASTER_VALUE | MODE_LOOKUP, .config.lookup = { TABLE_POSITION_ALT_SOURCE }, PG_POSITION, offsetof(positionConfig_t, altSource) },
+    { "position_alt_fusion_cutoff",    VAR_UINT8  | MASTER_VALUE, .config.minmaxUnsigned = { 1, 50 }, PG_POSITION, offsetof(positionConfig_t, altFusionCutoff) },
 };
 
 const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
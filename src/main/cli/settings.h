@@ -40,6 +40,9 @@ typedef enum {
 #ifdef USE_BLACKBOX
     TABLE_BLACKBOX_DEVICE,
     TABLE_BLACKBOX_MODE,
+#endif
+#ifdef USE_BLACKBOX_COMPRESSION
+    TABLE_BLACKBOX_COMPRESSION,
 #endif
     TABLE_CURRENT_METER,
     TABLE_VOLTAGE_METER,
@@ -112,6 +115,7 @@ typedef enum {
 #endif // USE_RC_SMOOTHING_FILTER
 #ifdef USE_GYRO_DATA_ANALYSE
     TABLE_DYNAMIC_FILTER_RANGE,
+    TABLE_DYNAMIC_FILTER_WINDOW,
 #endif // USE_GYRO_DATA_ANALYSE
     TABLE_GYRO_HARDWARE,
 #ifdef USE_SDCARD
@@ -136,6 +140,22 @@ typedef enum {
 #ifdef USE_ESC_SENSOR
     TABLE_ESC_SENSOR_PROTOCOL,
 #endif
+#ifdef USE_FREQ_SENSOR
+    TABLE_FREQ_CAPTURE_EDGES,
+#endif
+#ifdef USE_SERVOS
+    TABLE_SWASH_TYPE,
+#endif
+    TABLE_TASK_PRIORITY,
+#ifdef USE_LOOPTIME_CHECK
+    TABLE_LOOPTIME_CHECK,
+#endif
+#ifdef USE_GYRO_TEMP_COMP
+    TABLE_GYRO_TEMP_COMP,
+#endif
+#ifdef USE_SYSTEM_ID
+    TABLE_SYSID_AXIS,
+#endif
 
     LOOKUP_TABLE_COUNT
 } lookupTableIndex_e;
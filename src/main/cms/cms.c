@@ -247,6 +247,7 @@ static uint8_t cmsCursorAbsolute(displayPort_t *instance)
 }
 
 uint8_t runtimeEntryFlags[CMS_MAX_ROWS] = { 0 };
+static uint32_t runtimeEntryValue[CMS_MAX_ROWS]; // value of each row when it was last drawn
 
 static void cmsPageSelect(displayPort_t *instance, int8_t newpage)
 {
@@ -366,11 +367,12 @@ static int cmsDrawMenuItemValue(displayPort_t *pDisplay, char *buff, uint8_t row
     return cnt;
 }
 
+#define CMS_CURSOR_BLINK_DELAY_MS 500
+
 static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t row, bool selectedRow, uint8_t *flags)
 {
     #define CMS_DRAW_BUFFER_LEN 12
     #define CMS_NUM_FIELD_LEN 5
-    #define CMS_CURSOR_BLINK_DELAY_MS 500
 
     char buff[CMS_DRAW_BUFFER_LEN +1]; // Make room for null terminator.
     int cnt = 0;
@@ -538,6 +540,63 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     return cnt;
 }
 
+// Reads the raw value an entry is drawn from, so a polled row is only formatted and
+// drawn again when it changed. Returns false for entries that must always be drawn.
+static bool cmsEntryValue(const OSD_Entry *p, bool selectedRow, uint32_t *value)
+{
+#ifndef USE_OSD
+    UNUSED(selectedRow);
+#endif
+
+    if (!p->data) {
+        return false;
+    }
+
+    switch (p->type) {
+    case OME_Bool:
+        *value = *((uint8_t *)(p->data));
+        return true;
+
+    case OME_TAB:
+        *value = *((OSD_TAB_t *)p->data)->val;
+        return true;
+
+    case OME_UINT8:
+        *value = *((OSD_UINT8_t *)p->data)->val;
+        return true;
+
+    case OME_INT8:
+        *value = (uint8_t)*((OSD_INT8_t *)p->data)->val;
+        return true;
+
+    case OME_UINT16:
+        *value = *((OSD_UINT16_t *)p->data)->val;
+        return true;
+
+    case OME_INT16:
+        *value = (uint16_t)*((OSD_INT16_t *)p->data)->val;
+        return true;
+
+    case OME_FLOAT:
+        *value = *((OSD_FLOAT_t *)p->data)->val;
+        return true;
+
+#ifdef USE_OSD
+    case OME_VISIBLE:
+        *value = *((uint16_t *)p->data);
+        if (osdElementEditing && selectedRow) {
+            // the profile cursor blinks
+            const bool cursorBlink = millis() % (2 * CMS_CURSOR_BLINK_DELAY_MS) < CMS_CURSOR_BLINK_DELAY_MS;
+            *value |= (cursorBlink << 16) | (osdProfileCursor << 17);
+        }
+        return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
 static void cmsMenuCountPage(displayPort_t *pDisplay)
 {
     UNUSED(pDisplay);
@@ -604,8 +663,10 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs)
         pDisplay->cleared = false;
     } else if (drawPolled) {
         for (p = pageTop, i = 0; (p <= pageTop + pageMaxRow); p++, i++) {
-            if (IS_DYNAMIC(p))
+            uint32_t value;
+            if (IS_DYNAMIC(p) && (!cmsEntryValue(p, i == currentCtx.cursorRow, &value) || value != runtimeEntryValue[i])) {
                 SET_PRINTVALUE(runtimeEntryFlags[i]);
+            }
         }
     }
 
@@ -664,6 +725,7 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs)
 
         if (IS_PRINTVALUE(runtimeEntryFlags[i])) {
             bool selectedRow = i == currentCtx.cursorRow;
+            cmsEntryValue(p, selectedRow, &runtimeEntryValue[i]);
             room -= cmsDrawMenuEntry(pDisplay, p, top + i * linesPerMenuItem, selectedRow, &runtimeEntryFlags[i]);
             if (room < 30)
                 return;
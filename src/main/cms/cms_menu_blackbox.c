@@ -164,7 +164,7 @@ static const void *cmsx_EraseFlash(displayPort_t *pDisplay, const void *ptr)
 
     flashfsEraseCompletely();
     while (!flashfsIsReady()) {
-        delay(100);
+        delay(10);
     }
 
     beeper(BEEPER_BLACKBOX_ERASE);
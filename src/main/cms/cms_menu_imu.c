@@ -46,6 +46,7 @@
 #include "config/config.h"
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/rc.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 
@@ -243,6 +244,7 @@ static const void *cmsx_RateProfileWriteback(const OSD_Entry *self)
     UNUSED(self);
 
     memcpy(controlRateProfilesMutable(rateProfileIndex), &rateProfile, sizeof(controlRateConfig_t));
+    initRcProcessing();
 
     return NULL;
 }
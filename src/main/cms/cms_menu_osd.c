@@ -92,6 +92,10 @@ const OSD_Entry menuOsdActiveElemsEntries[] =
     {"FLY MODE",           OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_FLYMODE], DYNAMIC},
     {"NAME",               OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_CRAFT_NAME], DYNAMIC},
     {"THROTTLE",           OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_THROTTLE_POS], DYNAMIC},
+    {"HEADSPEED",          OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_HEADSPEED], DYNAMIC},
+    {"GOVERNOR",           OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_GOVERNOR], DYNAMIC},
+    {"COLLECTIVE PITCH",   OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_COLLECTIVE_PITCH], DYNAMIC},
+    {"SWASH RING",         OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_SWASH_RING], DYNAMIC},
     {"CURRENT (A)",        OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_CURRENT_DRAW], DYNAMIC},
     {"USED MAH",           OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_MAH_DRAWN], DYNAMIC},
 #ifdef USE_GPS
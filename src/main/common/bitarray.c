@@ -58,3 +58,23 @@ void bitArrayCopy(void *array, unsigned from, unsigned to)
         bitArrayClr(array, to);
     }
 }
+
+// Unpack count little-endian bit fields of width (<= 16) bits, as laid out by
+// packed gcc bitfields, with a bit accumulator instead of per-field shifts
+void bitArrayUnpack(uint16_t *dest, const void *src, unsigned count, unsigned width)
+{
+    const uint8_t *bytes = src;
+    const uint32_t mask = (1 << width) - 1;
+    uint32_t bits = 0;
+    unsigned bitCount = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+        while (bitCount < width) {
+            bits |= (uint32_t)*bytes++ << bitCount;
+            bitCount += 8;
+        }
+        dest[i] = bits & mask;
+        bits >>= width;
+        bitCount -= width;
+    }
+}
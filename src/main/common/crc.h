@@ -24,11 +24,16 @@ struct sbuf_s;
 
 uint16_t crc16_ccitt(uint16_t crc, unsigned char a);
 uint16_t crc16_ccitt_update(uint16_t crc, const void *data, uint32_t length);
+// Same as crc16_ccitt_update(), runs long buffers through the CRC unit where there is one. Not for interrupt context.
+uint16_t crc16_ccitt_bulk_update(uint16_t crc, const void *data, uint32_t length);
 struct sbuf_s;
 void crc16_ccitt_sbuf_append(struct sbuf_s *dst, uint8_t *start);
+uint16_t crc16_arc(uint16_t crc, unsigned char a);
+uint16_t crc16_arc_update(uint16_t crc, const void *data, uint32_t length);
 
 uint8_t crc8_dvb_s2(uint8_t crc, unsigned char a);
 uint8_t crc8_dvb_s2_update(uint8_t crc, const void *data, uint32_t length);
 void crc8_dvb_s2_sbuf_append(struct sbuf_s *dst, uint8_t *start);
+uint8_t crc8_smbus_update(uint8_t crc, const void *data, uint32_t length);
 uint8_t crc8_xor_update(uint8_t crc, const void *data, uint32_t length);
 void crc8_xor_sbuf_append(struct sbuf_s *dst, uint8_t *start);
@@ -156,21 +156,108 @@ void biquadFilterInit(biquadFilter_t *filter, float filterFreq, uint32_t refresh
     filter->y1 = filter->y2 = 0;
 }
 
-FAST_CODE void biquadFilterUpdate(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType)
+/*
+ * Runtime coefficient updates, for the filters that track a frequency from the PID loop. They take the
+ * normalised omega = 2 * PI * f / fs, which must be within 0..PI, and qScale = 1 / (2 * Q), both of which
+ * the caller computes once per filter bank. No libm, no branches and one division per filter; the
+ * filter state is kept.
+ */
+
+// sin(x) for -PI/2..PI/2, the coefficients of sin_approx()
+#define BIQUAD_SIN_COEF3   -1.666665710e-1f
+#define BIQUAD_SIN_COEF5    8.333017292e-3f
+#define BIQUAD_SIN_COEF7   -1.980661520e-4f
+#define BIQUAD_SIN_COEF9    2.600054768e-6f
+// cos(x) for -PI/2..PI/2, the Taylor series, error below 5e-7
+#define BIQUAD_COS_COEF2   -5.000000000e-1f
+#define BIQUAD_COS_COEF4    4.166666667e-2f
+#define BIQUAD_COS_COEF6   -1.388888889e-3f
+#define BIQUAD_COS_COEF8    2.480158730e-5f
+#define BIQUAD_COS_COEF10  -2.755731922e-7f
+
+// Both from x = PI/2 - omega, which is always within the range of the polynomials
+FAST_CODE void biquadFilterSinCos(float omega, float *sn, float *cs)
+{
+    const float x = 0.5f * M_PIf - omega;
+    const float x2 = x * x;
+
+    *cs = x + x * x2 * (BIQUAD_SIN_COEF3 + x2 * (BIQUAD_SIN_COEF5 + x2 * (BIQUAD_SIN_COEF7 + x2 * BIQUAD_SIN_COEF9)));
+    *sn = 1.0f + x2 * (BIQUAD_COS_COEF2 + x2 * (BIQUAD_COS_COEF4 + x2 * (BIQUAD_COS_COEF6 + x2 * (BIQUAD_COS_COEF8 + x2 * BIQUAD_COS_COEF10))));
+}
+
+FAST_CODE void biquadFilterSetLPF(biquadFilter_t *filter, float omega, float qScale)
+{
+    float sn, cs;
+    biquadFilterSinCos(omega, &sn, &cs);
+
+    const float a0inv = 1.0f / (1.0f + sn * qScale);
+
+    filter->b1 = (1.0f - cs) * a0inv;
+    filter->b0 = filter->b1 * 0.5f;
+    filter->b2 = filter->b0;
+    filter->a1 = -2.0f * cs * a0inv;
+    filter->a2 = (1.0f - sn * qScale) * a0inv;
+}
+
+FAST_CODE void biquadFilterSetNotch(biquadFilter_t *filter, float omega, float qScale)
+{
+    float sn, cs;
+    biquadFilterSinCos(omega, &sn, &cs);
+
+    const float a0inv = 1.0f / (1.0f + sn * qScale);
+
+    filter->b0 = a0inv;
+    filter->b1 = -2.0f * cs * a0inv;
+    filter->b2 = a0inv;
+    filter->a1 = filter->b1;
+    filter->a2 = (1.0f - sn * qScale) * a0inv;
+}
+
+FAST_CODE void biquadFilterSetBPF(biquadFilter_t *filter, float omega, float qScale)
 {
-    // backup state
-    float x1 = filter->x1;
-    float x2 = filter->x2;
-    float y1 = filter->y1;
-    float y2 = filter->y2;
+    float sn, cs;
+    biquadFilterSinCos(omega, &sn, &cs);
 
-    biquadFilterInit(filter, filterFreq, refreshRate, Q, filterType);
+    const float alpha = sn * qScale;
+    const float a0inv = 1.0f / (1.0f + alpha);
 
-    // restore state
-    filter->x1 = x1;
-    filter->x2 = x2;
-    filter->y1 = y1;
-    filter->y2 = y2;
+    filter->b0 = alpha * a0inv;
+    filter->b1 = 0;
+    filter->b2 = -filter->b0;
+    filter->a1 = -2.0f * cs * a0inv;
+    filter->a2 = (1.0f - alpha) * a0inv;
+}
+
+// A bank of notches with the same Q, as the dynamic notches of one axis
+FAST_CODE void biquadFilterSetNotches(biquadFilter_t * const *filters, const float *omegas, int count, float qScale)
+{
+    for (int i = 0; i < count; i++) {
+        biquadFilterSetNotch(filters[i], omegas[i], qScale);
+    }
+}
+
+// omega of filterFreq for the refreshRate (us), limited to the range the coefficient updates take
+float biquadFilterOmega(float filterFreq, uint32_t refreshRate)
+{
+    return constrainf(2.0f * M_PIf * filterFreq * refreshRate * 0.000001f, 0.0f, M_PIf);
+}
+
+FAST_CODE void biquadFilterUpdate(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType)
+{
+    const float omega = biquadFilterOmega(filterFreq, refreshRate);
+    const float qScale = 0.5f / Q;
+
+    switch (filterType) {
+    case FILTER_LPF:
+        biquadFilterSetLPF(filter, omega, qScale);
+        break;
+    case FILTER_NOTCH:
+        biquadFilterSetNotch(filter, omega, qScale);
+        break;
+    case FILTER_BPF:
+        biquadFilterSetBPF(filter, omega, qScale);
+        break;
+    }
 }
 
 FAST_CODE void biquadFilterUpdateLPF(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate)
@@ -178,6 +265,16 @@ FAST_CODE void biquadFilterUpdateLPF(biquadFilter_t *filter, float filterFreq, u
     biquadFilterUpdate(filter, filterFreq, refreshRate, BIQUAD_Q, FILTER_LPF);
 }
 
+// Filters of the same cutoff on several axes only need the coefficients computed once, the state is kept
+FAST_CODE void biquadFilterCopyCoefficients(biquadFilter_t *filter, const biquadFilter_t *source)
+{
+    filter->b0 = source->b0;
+    filter->b1 = source->b1;
+    filter->b2 = source->b2;
+    filter->a1 = source->a1;
+    filter->a2 = source->a2;
+}
+
 /* Computes a biquadFilter_t filter on a sample (slightly less precise than df2 but works in dynamic mode) */
 FAST_CODE float biquadFilterApplyDF1(biquadFilter_t *filter, float input)
 {
@@ -204,6 +301,64 @@ FAST_CODE float biquadFilterApply(biquadFilter_t *filter, float input)
     return result;
 }
 
+/*
+ * Coefficient morphing: after each update the coefficients move in equal steps from
+ * their current values to the target, reaching it after the given number of samples.
+ * A linear blend of two stable sets {a1,a2} is stable too, the stability region is convex.
+ * Zero samples sets the target at once.
+ */
+FAST_CODE void biquadMorphSetTarget(biquadMorph_t *morph, const biquadFilter_t *target, uint16_t samples)
+{
+    if (samples) {
+        const float step = 1.0f / samples;
+        morph->db0 = (target->b0 - morph->b0) * step;
+        morph->db1 = (target->b1 - morph->b1) * step;
+        morph->db2 = (target->b2 - morph->b2) * step;
+        morph->da1 = (target->a1 - morph->a1) * step;
+        morph->da2 = (target->a2 - morph->a2) * step;
+    } else {
+        morph->b0 = target->b0;
+        morph->b1 = target->b1;
+        morph->b2 = target->b2;
+        morph->a1 = target->a1;
+        morph->a2 = target->a2;
+    }
+    morph->count = samples;
+}
+
+// Advance the coefficients by one sample
+FAST_CODE void biquadMorphStep(biquadMorph_t *morph)
+{
+    if (morph->count) {
+        morph->b0 += morph->db0;
+        morph->b1 += morph->db1;
+        morph->b2 += morph->db2;
+        morph->a1 += morph->da1;
+        morph->a2 += morph->da2;
+        morph->count--;
+    }
+}
+
+void biquadMorphFilterInit(biquadMorphFilter_t *filter, const biquadFilter_t *coeffs)
+{
+    biquadMorphSetTarget(&filter->coeffs, coeffs, 0);
+    filter->s1 = 0;
+    filter->s2 = 0;
+}
+
+/* Computes a biquadMorphFilter_t filter in transposed direct form 2 on a sample. The state holds
+   partial sums of the output scale, which keeps it well conditioned in float when the coefficients move. */
+FAST_CODE float biquadMorphFilterApply(biquadMorphFilter_t *filter, float input)
+{
+    biquadMorph_t *c = &filter->coeffs;
+    biquadMorphStep(c);
+
+    const float result = c->b0 * input + filter->s1;
+    filter->s1 = c->b1 * input - c->a1 * result + filter->s2;
+    filter->s2 = c->b2 * input - c->a2 * result;
+    return result;
+}
+
 void laggedMovingAverageInit(laggedMovingAverage_t *filter, uint16_t windowSize, float *buf)
 {
     filter->movingWindowIndex = 0;
@@ -226,3 +381,57 @@ FAST_CODE float laggedMovingAverageUpdate(laggedMovingAverage_t *filter, float i
     const uint16_t denom = filter->primed ? filter->windowSize : filter->movingWindowIndex;
     return filter->movingSum  / denom;
 }
+
+void filterChainAdd(filterChain_t *chain, filterStageType_e type, void *filter, size_t filterSize)
+{
+    if (chain->stageCount < FILTER_CHAIN_SIZE) {
+        filterStage_t *stage = &chain->stage[chain->stageCount++];
+        stage->type = type;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            stage->filter[axis] = (uint8_t *)filter + axis * filterSize;
+        }
+    }
+}
+
+// Runs every enabled stage of the chain on all three axes. The kernels are inlined
+// here so the hot path makes no indirect calls and skips disabled stages entirely.
+FAST_CODE void filterChainApply(const filterChain_t *chain, float *data)
+{
+    for (int i = 0; i < chain->stageCount; i++) {
+        const filterStage_t *stage = &chain->stage[i];
+
+        switch (stage->type) {
+        case FILTER_STAGE_PT1:
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                pt1Filter_t *filter = stage->filter[axis];
+                filter->state = filter->state + filter->k * (data[axis] - filter->state);
+                data[axis] = filter->state;
+            }
+            break;
+
+        case FILTER_STAGE_BIQUAD:
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                biquadFilter_t *filter = stage->filter[axis];
+                const float input = data[axis];
+                const float result = filter->b0 * input + filter->x1;
+                filter->x1 = filter->b1 * input - filter->a1 * result + filter->x2;
+                filter->x2 = filter->b2 * input - filter->a2 * result;
+                data[axis] = result;
+            }
+            break;
+
+        case FILTER_STAGE_BIQUAD_DF1:
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                biquadFilter_t *filter = stage->filter[axis];
+                const float input = data[axis];
+                const float result = filter->b0 * input + filter->b1 * filter->x1 + filter->b2 * filter->x2 - filter->a1 * filter->y1 - filter->a2 * filter->y2;
+                filter->x2 = filter->x1;
+                filter->x1 = input;
+                filter->y2 = filter->y1;
+                filter->y1 = result;
+                data[axis] = result;
+            }
+            break;
+        }
+    }
+}
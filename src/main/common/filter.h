@@ -20,6 +20,10 @@
 
 #pragma once
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/axis.h"
 
 struct filter_s;
 typedef struct filter_s filter_t;
@@ -41,6 +45,19 @@ typedef struct biquadFilter_s {
     float x1, x2, y1, y2;
 } biquadFilter_t;
 
+// Biquad coefficients that move linearly to the last target set over a number of samples
+typedef struct biquadMorph_s {
+    float b0, b1, b2, a1, a2;
+    float db0, db1, db2, da1, da2;
+    uint16_t count;
+} biquadMorph_t;
+
+// Transposed direct form 2 biquad on morphing coefficients, the state is kept across updates
+typedef struct biquadMorphFilter_s {
+    biquadMorph_t coeffs;
+    float s1, s2;
+} biquadMorphFilter_t;
+
 typedef struct laggedMovingAverage_s {
     uint16_t movingWindowIndex;
     uint16_t windowSize;
@@ -68,9 +85,21 @@ void biquadFilterInitLPF(biquadFilter_t *filter, float filterFreq, uint32_t refr
 void biquadFilterInit(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
 void biquadFilterUpdate(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
 void biquadFilterUpdateLPF(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate);
+float biquadFilterOmega(float filterFreq, uint32_t refreshRate);
+void biquadFilterSinCos(float omega, float *sn, float *cs);
+void biquadFilterSetLPF(biquadFilter_t *filter, float omega, float qScale);
+void biquadFilterSetNotch(biquadFilter_t *filter, float omega, float qScale);
+void biquadFilterSetBPF(biquadFilter_t *filter, float omega, float qScale);
+void biquadFilterSetNotches(biquadFilter_t * const *filters, const float *omegas, int count, float qScale);
+void biquadFilterCopyCoefficients(biquadFilter_t *filter, const biquadFilter_t *source);
 
 float biquadFilterApplyDF1(biquadFilter_t *filter, float input);
 float biquadFilterApply(biquadFilter_t *filter, float input);
+
+void biquadMorphSetTarget(biquadMorph_t *morph, const biquadFilter_t *target, uint16_t samples);
+void biquadMorphStep(biquadMorph_t *morph);
+void biquadMorphFilterInit(biquadMorphFilter_t *filter, const biquadFilter_t *coeffs);
+float biquadMorphFilterApply(biquadMorphFilter_t *filter, float input);
 float filterGetNotchQ(float centerFreq, float cutoffFreq);
 
 void laggedMovingAverageInit(laggedMovingAverage_t *filter, uint16_t windowSize, float *buf);
@@ -83,3 +112,26 @@ float pt1FilterApply(pt1Filter_t *filter, float input);
 
 void slewFilterInit(slewFilter_t *filter, float slewLimit, float threshold);
 float slewFilterApply(slewFilter_t *filter, float input);
+
+typedef enum {
+    FILTER_STAGE_PT1 = 0,
+    FILTER_STAGE_BIQUAD,
+    FILTER_STAGE_BIQUAD_DF1,
+} filterStageType_e;
+
+#define FILTER_CHAIN_SIZE 4
+
+// One enabled filter stage, with the per-axis filter states it runs on
+typedef struct filterStage_s {
+    filterStageType_e type;
+    void *filter[XYZ_AXIS_COUNT];
+} filterStage_t;
+
+// List of enabled stages applied to all three axes in one call. Disabled stages are not present.
+typedef struct filterChain_s {
+    uint8_t stageCount;
+    filterStage_t stage[FILTER_CHAIN_SIZE];
+} filterChain_t;
+
+void filterChainAdd(filterChain_t *chain, filterStageType_e type, void *filter, size_t filterSize);
+void filterChainApply(const filterChain_t *chain, float *data);
@@ -36,6 +36,13 @@ typedef struct huffmanState_s {
 } huffmanState_t;
 
 extern const huffmanTable_t huffmanTable[HUFFMAN_TABLE_SIZE];
+extern const huffmanTable_t huffmanTableText[HUFFMAN_TABLE_SIZE];
+
+// Table ids of the compressed MSP replies
+typedef enum {
+    HUFFMAN_TABLE_BINARY = 0,
+    HUFFMAN_TABLE_TEXT = 1,
+} huffmanTableId_e;
 
 struct huffmanInfo_s {
     uint16_t uncompressedByteCount;
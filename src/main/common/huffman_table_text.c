@@ -0,0 +1,290 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "huffman.h"
+
+/*
+ * Huffman Table for text, the setting names, box names and lookup values of
+ * the MSP replies. Built from their byte frequencies with every symbol present.
+ */
+const huffmanTable_t huffmanTableText[HUFFMAN_TABLE_SIZE] = {
+//   Len    Code       Char Bitcode
+    {  5, 0x2000 }, // 0x00 00100
+    { 15, 0xFF0C }, // 0x01 111111110000110
+    { 15, 0xFF0E }, // 0x02 111111110000111
+    { 15, 0xFF10 }, // 0x03 111111110001000
+    { 15, 0xFF12 }, // 0x04 111111110001001
+    { 15, 0xFF14 }, // 0x05 111111110001010
+    { 15, 0xFF16 }, // 0x06 111111110001011
+    { 15, 0xFF18 }, // 0x07 111111110001100
+    { 15, 0xFF1A }, // 0x08 111111110001101
+    { 15, 0xFF1C }, // 0x09 111111110001110
+    { 15, 0xFF1E }, // 0x0A 111111110001111
+    { 15, 0xFF20 }, // 0x0B 111111110010000
+    { 15, 0xFF22 }, // 0x0C 111111110010001
+    { 15, 0xFF24 }, // 0x0D 111111110010010
+    { 15, 0xFF26 }, // 0x0E 111111110010011
+    { 15, 0xFF28 }, // 0x0F 111111110010100
+    { 15, 0xFF2A }, // 0x10 111111110010101
+    { 15, 0xFF2C }, // 0x11 111111110010110
+    { 15, 0xFF2E }, // 0x12 111111110010111
+    { 15, 0xFF30 }, // 0x13 111111110011000
+    { 15, 0xFF32 }, // 0x14 111111110011001
+    { 15, 0xFF34 }, // 0x15 111111110011010
+    { 15, 0xFF36 }, // 0x16 111111110011011
+    { 15, 0xFF38 }, // 0x17 111111110011100
+    { 15, 0xFF3A }, // 0x18 111111110011101
+    { 15, 0xFF3C }, // 0x19 111111110011110
+    { 15, 0xFF3E }, // 0x1A 111111110011111
+    { 15, 0xFF40 }, // 0x1B 111111110100000
+    { 15, 0xFF42 }, // 0x1C 111111110100001
+    { 15, 0xFF44 }, // 0x1D 111111110100010
+    { 15, 0xFF46 }, // 0x1E 111111110100011
+    { 15, 0xFF48 }, // 0x1F 111111110100100
+    {  5, 0x2800 }, // 0x20 00101
+    { 15, 0xFF4A }, // 0x21 111111110100101
+    { 15, 0xFF4C }, // 0x22 111111110100110
+    { 15, 0xFF4E }, // 0x23 111111110100111
+    { 15, 0xFF50 }, // 0x24 111111110101000
+    { 15, 0xFF52 }, // 0x25 111111110101001
+    { 15, 0xFF54 }, // 0x26 111111110101010
+    { 15, 0xFF56 }, // 0x27 111111110101011
+    { 10, 0xFB80 }, // 0x28 1111101110
+    { 10, 0xFBC0 }, // 0x29 1111101111
+    { 15, 0xFF58 }, // 0x2A 111111110101100
+    { 15, 0xFF5A }, // 0x2B 111111110101101
+    { 15, 0xFF5C }, // 0x2C 111111110101110
+    { 12, 0xFDE0 }, // 0x2D 111111011110
+    {  9, 0xF900 }, // 0x2E 111110010
+    {  8, 0xF000 }, // 0x2F 11110000
+    {  8, 0xF100 }, // 0x30 11110001
+    {  8, 0xF200 }, // 0x31 11110010
+    {  7, 0xDC00 }, // 0x32 1101110
+    {  7, 0xDE00 }, // 0x33 1101111
+    {  9, 0xF980 }, // 0x34 111110011
+    { 10, 0xFC00 }, // 0x35 1111110000
+    { 10, 0xFC40 }, // 0x36 1111110001
+    { 11, 0xFD80 }, // 0x37 11111101100
+    { 10, 0xFC80 }, // 0x38 1111110010
+    { 11, 0xFDA0 }, // 0x39 11111101101
+    { 15, 0xFF5E }, // 0x3A 111111110101111
+    {  5, 0x3000 }, // 0x3B 00110
+    { 15, 0xFF60 }, // 0x3C 111111110110000
+    { 15, 0xFF62 }, // 0x3D 111111110110001
+    { 10, 0xFCC0 }, // 0x3E 1111110011
+    { 15, 0xFF64 }, // 0x3F 111111110110010
+    { 15, 0xFF66 }, // 0x40 111111110110011
+    {  5, 0x3800 }, // 0x41 00111
+    {  6, 0x9800 }, // 0x42 100110
+    {  6, 0x9C00 }, // 0x43 100111
+    {  6, 0xA000 }, // 0x44 101000
+    {  4, 0x0000 }, // 0x45 0000
+    {  7, 0xE000 }, // 0x46 1110000
+    {  6, 0xA400 }, // 0x47 101001
+    {  6, 0xA800 }, // 0x48 101010
+    {  6, 0xAC00 }, // 0x49 101011
+    { 10, 0xFD00 }, // 0x4A 1111110100
+    {  9, 0xFA00 }, // 0x4B 111110100
+    {  5, 0x4000 }, // 0x4C 01000
+    {  6, 0xB000 }, // 0x4D 101100
+    {  6, 0xB400 }, // 0x4E 101101
+    {  5, 0x4800 }, // 0x4F 01001
+    {  6, 0xB800 }, // 0x50 101110
+    { 12, 0xFDF0 }, // 0x51 111111011111
+    {  5, 0x5000 }, // 0x52 01010
+    {  5, 0x5800 }, // 0x53 01011
+    {  5, 0x6000 }, // 0x54 01100
+    {  6, 0xBC00 }, // 0x55 101111
+    {  7, 0xE200 }, // 0x56 1110001
+    {  8, 0xF300 }, // 0x57 11110011
+    {  8, 0xF400 }, // 0x58 11110100
+    {  8, 0xF500 }, // 0x59 11110101
+    {  9, 0xFA80 }, // 0x5A 111110101
+    { 15, 0xFF68 }, // 0x5B 111111110110100
+    { 15, 0xFF6A }, // 0x5C 111111110110101
+    { 15, 0xFF6C }, // 0x5D 111111110110110
+    { 15, 0xFF6E }, // 0x5E 111111110110111
+    {  4, 0x1000 }, // 0x5F 0001
+    { 15, 0xFF70 }, // 0x60 111111110111000
+    {  5, 0x6800 }, // 0x61 01101
+    {  7, 0xE400 }, // 0x62 1110010
+    {  6, 0xC000 }, // 0x63 110000
+    {  6, 0xC400 }, // 0x64 110001
+    {  5, 0x7000 }, // 0x65 01110
+    {  7, 0xE600 }, // 0x66 1110011
+    {  7, 0xE800 }, // 0x67 1110100
+    {  7, 0xEA00 }, // 0x68 1110101
+    {  6, 0xC800 }, // 0x69 110010
+    { 12, 0xFE00 }, // 0x6A 111111100000
+    {  9, 0xFB00 }, // 0x6B 111110110
+    {  6, 0xCC00 }, // 0x6C 110011
+    {  6, 0xD000 }, // 0x6D 110100
+    {  6, 0xD400 }, // 0x6E 110101
+    {  5, 0x7800 }, // 0x6F 01111
+    {  6, 0xD800 }, // 0x70 110110
+    { 11, 0xFDC0 }, // 0x71 11111101110
+    {  5, 0x8000 }, // 0x72 10000
+    {  5, 0x8800 }, // 0x73 10001
+    {  5, 0x9000 }, // 0x74 10010
+    {  7, 0xEC00 }, // 0x75 1110110
+    {  8, 0xF600 }, // 0x76 11110110
+    {  8, 0xF700 }, // 0x77 11110111
+    {  8, 0xF800 }, // 0x78 11111000
+    {  7, 0xEE00 }, // 0x79 1110111
+    { 10, 0xFD40 }, // 0x7A 1111110101
+    { 15, 0xFF72 }, // 0x7B 111111110111001
+    { 15, 0xFF74 }, // 0x7C 111111110111010
+    { 15, 0xFF76 }, // 0x7D 111111110111011
+    { 15, 0xFF78 }, // 0x7E 111111110111100
+    { 15, 0xFF7A }, // 0x7F 111111110111101
+    { 15, 0xFF7C }, // 0x80 111111110111110
+    { 15, 0xFF7E }, // 0x81 111111110111111
+    { 15, 0xFF80 }, // 0x82 111111111000000
+    { 15, 0xFF82 }, // 0x83 111111111000001
+    { 15, 0xFF84 }, // 0x84 111111111000010
+    { 15, 0xFF86 }, // 0x85 111111111000011
+    { 15, 0xFF88 }, // 0x86 111111111000100
+    { 15, 0xFF8A }, // 0x87 111111111000101
+    { 15, 0xFF8C }, // 0x88 111111111000110
+    { 15, 0xFF8E }, // 0x89 111111111000111
+    { 15, 0xFF90 }, // 0x8A 111111111001000
+    { 15, 0xFF92 }, // 0x8B 111111111001001
+    { 15, 0xFF94 }, // 0x8C 111111111001010
+    { 15, 0xFF96 }, // 0x8D 111111111001011
+    { 15, 0xFF98 }, // 0x8E 111111111001100
+    { 15, 0xFF9A }, // 0x8F 111111111001101
+    { 15, 0xFF9C }, // 0x90 111111111001110
+    { 15, 0xFF9E }, // 0x91 111111111001111
+    { 15, 0xFFA0 }, // 0x92 111111111010000
+    { 15, 0xFFA2 }, // 0x93 111111111010001
+    { 15, 0xFFA4 }, // 0x94 111111111010010
+    { 15, 0xFFA6 }, // 0x95 111111111010011
+    { 15, 0xFFA8 }, // 0x96 111111111010100
+    { 15, 0xFFAA }, // 0x97 111111111010101
+    { 15, 0xFFAC }, // 0x98 111111111010110
+    { 15, 0xFFAE }, // 0x99 111111111010111
+    { 15, 0xFFB0 }, // 0x9A 111111111011000
+    { 15, 0xFFB2 }, // 0x9B 111111111011001
+    { 15, 0xFFB4 }, // 0x9C 111111111011010
+    { 15, 0xFFB6 }, // 0x9D 111111111011011
+    { 15, 0xFFB8 }, // 0x9E 111111111011100
+    { 15, 0xFFBA }, // 0x9F 111111111011101
+    { 15, 0xFFBC }, // 0xA0 111111111011110
+    { 15, 0xFFBE }, // 0xA1 111111111011111
+    { 15, 0xFFC0 }, // 0xA2 111111111100000
+    { 15, 0xFFC2 }, // 0xA3 111111111100001
+    { 15, 0xFFC4 }, // 0xA4 111111111100010
+    { 15, 0xFFC6 }, // 0xA5 111111111100011
+    { 15, 0xFFC8 }, // 0xA6 111111111100100
+    { 15, 0xFFCA }, // 0xA7 111111111100101
+    { 15, 0xFFCC }, // 0xA8 111111111100110
+    { 15, 0xFFCE }, // 0xA9 111111111100111
+    { 15, 0xFFD0 }, // 0xAA 111111111101000
+    { 15, 0xFFD2 }, // 0xAB 111111111101001
+    { 15, 0xFFD4 }, // 0xAC 111111111101010
+    { 15, 0xFFD6 }, // 0xAD 111111111101011
+    { 15, 0xFFD8 }, // 0xAE 111111111101100
+    { 15, 0xFFDA }, // 0xAF 111111111101101
+    { 15, 0xFFDC }, // 0xB0 111111111101110
+    { 15, 0xFFDE }, // 0xB1 111111111101111
+    { 15, 0xFFE0 }, // 0xB2 111111111110000
+    { 15, 0xFFE2 }, // 0xB3 111111111110001
+    { 15, 0xFFE4 }, // 0xB4 111111111110010
+    { 15, 0xFFE6 }, // 0xB5 111111111110011
+    { 15, 0xFFE8 }, // 0xB6 111111111110100
+    { 15, 0xFFEA }, // 0xB7 111111111110101
+    { 15, 0xFFEC }, // 0xB8 111111111110110
+    { 15, 0xFFEE }, // 0xB9 111111111110111
+    { 15, 0xFFF0 }, // 0xBA 111111111111000
+    { 15, 0xFFF2 }, // 0xBB 111111111111001
+    { 15, 0xFFF4 }, // 0xBC 111111111111010
+    { 15, 0xFFF6 }, // 0xBD 111111111111011
+    { 15, 0xFFF8 }, // 0xBE 111111111111100
+    { 15, 0xFFFA }, // 0xBF 111111111111101
+    { 15, 0xFFFC }, // 0xC0 111111111111110
+    { 15, 0xFFFE }, // 0xC1 111111111111111
+    { 14, 0xFE10 }, // 0xC2 11111110000100
+    { 14, 0xFE14 }, // 0xC3 11111110000101
+    { 14, 0xFE18 }, // 0xC4 11111110000110
+    { 14, 0xFE1C }, // 0xC5 11111110000111
+    { 14, 0xFE20 }, // 0xC6 11111110001000
+    { 14, 0xFE24 }, // 0xC7 11111110001001
+    { 14, 0xFE28 }, // 0xC8 11111110001010
+    { 14, 0xFE2C }, // 0xC9 11111110001011
+    { 14, 0xFE30 }, // 0xCA 11111110001100
+    { 14, 0xFE34 }, // 0xCB 11111110001101
+    { 14, 0xFE38 }, // 0xCC 11111110001110
+    { 14, 0xFE3C }, // 0xCD 11111110001111
+    { 14, 0xFE40 }, // 0xCE 11111110010000
+    { 14, 0xFE44 }, // 0xCF 11111110010001
+    { 14, 0xFE48 }, // 0xD0 11111110010010
+    { 14, 0xFE4C }, // 0xD1 11111110010011
+    { 14, 0xFE50 }, // 0xD2 11111110010100
+    { 14, 0xFE54 }, // 0xD3 11111110010101
+    { 14, 0xFE58 }, // 0xD4 11111110010110
+    { 14, 0xFE5C }, // 0xD5 11111110010111
+    { 14, 0xFE60 }, // 0xD6 11111110011000
+    { 14, 0xFE64 }, // 0xD7 11111110011001
+    { 14, 0xFE68 }, // 0xD8 11111110011010
+    { 14, 0xFE6C }, // 0xD9 11111110011011
+    { 14, 0xFE70 }, // 0xDA 11111110011100
+    { 14, 0xFE74 }, // 0xDB 11111110011101
+    { 14, 0xFE78 }, // 0xDC 11111110011110
+    { 14, 0xFE7C }, // 0xDD 11111110011111
+    { 14, 0xFE80 }, // 0xDE 11111110100000
+    { 14, 0xFE84 }, // 0xDF 11111110100001
+    { 14, 0xFE88 }, // 0xE0 11111110100010
+    { 14, 0xFE8C }, // 0xE1 11111110100011
+    { 14, 0xFE90 }, // 0xE2 11111110100100
+    { 14, 0xFE94 }, // 0xE3 11111110100101
+    { 14, 0xFE98 }, // 0xE4 11111110100110
+    { 14, 0xFE9C }, // 0xE5 11111110100111
+    { 14, 0xFEA0 }, // 0xE6 11111110101000
+    { 14, 0xFEA4 }, // 0xE7 11111110101001
+    { 14, 0xFEA8 }, // 0xE8 11111110101010
+    { 14, 0xFEAC }, // 0xE9 11111110101011
+    { 14, 0xFEB0 }, // 0xEA 11111110101100
+    { 14, 0xFEB4 }, // 0xEB 11111110101101
+    { 14, 0xFEB8 }, // 0xEC 11111110101110
+    { 14, 0xFEBC }, // 0xED 11111110101111
+    { 14, 0xFEC0 }, // 0xEE 11111110110000
+    { 14, 0xFEC4 }, // 0xEF 11111110110001
+    { 14, 0xFEC8 }, // 0xF0 11111110110010
+    { 14, 0xFECC }, // 0xF1 11111110110011
+    { 14, 0xFED0 }, // 0xF2 11111110110100
+    { 14, 0xFED4 }, // 0xF3 11111110110101
+    { 14, 0xFED8 }, // 0xF4 11111110110110
+    { 14, 0xFEDC }, // 0xF5 11111110110111
+    { 14, 0xFEE0 }, // 0xF6 11111110111000
+    { 14, 0xFEE4 }, // 0xF7 11111110111001
+    { 14, 0xFEE8 }, // 0xF8 11111110111010
+    { 14, 0xFEEC }, // 0xF9 11111110111011
+    { 14, 0xFEF0 }, // 0xFA 11111110111100
+    { 14, 0xFEF4 }, // 0xFB 11111110111101
+    { 14, 0xFEF8 }, // 0xFC 11111110111110
+    { 14, 0xFEFC }, // 0xFD 11111110111111
+    { 14, 0xFF00 }, // 0xFE 11111111000000
+    { 14, 0xFF04 }, // 0xFF 11111111000001
+    { 14, 0xFF08 }, // EOF  11111111000010
+};
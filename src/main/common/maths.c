@@ -64,6 +64,29 @@ float cos_approx(float x)
     return sin_approx(x + (0.5f * M_PIf));
 }
 
+// Sine and cosine of the same angle with a single range reduction, same error as sin_approx()
+void sin_cos_approx(float x, float *sinx, float *cosx)
+{
+    int32_t xint = x;
+    if (xint < -32 || xint > 32) {                                          // Stop here on error input (5 * 360 Deg)
+        *sinx = 0.0f;
+        *cosx = 0.0f;
+        return;
+    }
+    while (x >  M_PIf) x -= (2.0f * M_PIf);                                 // always wrap input angle to -PI..PI
+    while (x < -M_PIf) x += (2.0f * M_PIf);
+
+    // cos(x) = sin(PI/2 - |x|), already within -90..+90 Degree
+    float c = (0.5f * M_PIf) - fabsf(x);
+    if (x >  (0.5f * M_PIf)) x =  M_PIf - x;
+    else if (x < -(0.5f * M_PIf)) x = -M_PIf - x;
+
+    const float x2 = x * x;
+    const float c2 = c * c;
+    *sinx = x + x * x2 * (sinPolyCoef3 + x2 * (sinPolyCoef5 + x2 * (sinPolyCoef7 + x2 * sinPolyCoef9)));
+    *cosx = c + c * c2 * (sinPolyCoef3 + c2 * (sinPolyCoef5 + c2 * (sinPolyCoef7 + c2 * sinPolyCoef9)));
+}
+
 // Initial implementation by Crashpilot1000 (https://github.com/Crashpilot1000/HarakiriWebstore1/blob/396715f73c6fcf859e0db0f34e12fe44bace6483/src/mw.c#L1292)
 // Polynomial coefficients by Andor (http://www.dsprelated.com/showthread/comp.dsp/21872-1.php) optimized by Ledvinap to save one multiplication
 // Max absolute error 0,000027 degree
@@ -159,6 +182,27 @@ void devPush(stdev_t *dev, float x)
     }
 }
 
+// Adds the samples of other to dev, as if they had been pushed one by one
+void devMerge(stdev_t *dev, const stdev_t *other)
+{
+    if (other->m_n == 0) {
+        return;
+    }
+    if (dev->m_n == 0) {
+        *dev = *other;
+        return;
+    }
+
+    const int n = dev->m_n + other->m_n;
+    const float delta = other->m_oldM - dev->m_oldM;
+
+    dev->m_newM = dev->m_oldM + delta * other->m_n / n;
+    dev->m_newS = dev->m_oldS + other->m_oldS + delta * delta * dev->m_n * other->m_n / n;
+    dev->m_oldM = dev->m_newM;
+    dev->m_oldS = dev->m_newS;
+    dev->m_n = n;
+}
+
 float devVariance(stdev_t *dev)
 {
     return ((dev->m_n > 1) ? dev->m_newS / (dev->m_n - 1) : 0.0f);
@@ -21,6 +21,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <math.h>
 
 #ifndef sq
 #define sq(x) ((x)*(x))
@@ -104,6 +105,7 @@ float fapplyDeadband(float value, float deadband);
 
 void devClear(stdev_t *dev);
 void devPush(stdev_t *dev, float x);
+void devMerge(stdev_t *dev, const stdev_t *other);
 float devVariance(stdev_t *dev);
 float devStandardDeviation(stdev_t *dev);
 float degreesToRadians(int16_t degrees);
@@ -130,6 +132,7 @@ float quickMedianFilter9f(float * v);
 #if defined(FAST_MATH) || defined(VERY_FAST_MATH)
 float sin_approx(float x);
 float cos_approx(float x);
+void sin_cos_approx(float x, float *sinx, float *cosx);
 float atan2_approx(float y, float x);
 float acos_approx(float x);
 #define tan_approx(x)       (sin_approx(x) / cos_approx(x))
@@ -139,6 +142,7 @@ float pow_approx(float a, float b);
 #else
 #define sin_approx(x)   sinf(x)
 #define cos_approx(x)   cosf(x)
+#define sin_cos_approx(x, sinx, cosx)   (*(sinx) = sinf(x), *(cosx) = cosf(x))
 #define atan2_approx(y,x)   atan2f(y,x)
 #define acos_approx(x)      acosf(x)
 #define tan_approx(x)       tanf(x)
@@ -172,3 +176,9 @@ static inline float constrainf(float amt, float low, float high)
     else
         return amt;
 }
+
+// With -ffast-math sqrtf() is a single VSQRT on FPU targets, exact to float precision
+static inline float invSqrt(float x)
+{
+    return 1.0f / sqrtf(x);
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "scratch.h"
+
+#define SCRATCH_ALIGNMENT 4
+
+static uint32_t scratchBuffer[SCRATCH_SIZE / sizeof(uint32_t)];
+static unsigned scratchTop;
+static unsigned scratchHighWater;
+
+// Returns NULL if the request does not fit, the caller reports the command as failed
+void *scratchAlloc(unsigned size)
+{
+    const unsigned aligned = (size + SCRATCH_ALIGNMENT - 1) & ~(SCRATCH_ALIGNMENT - 1);
+    if (aligned > SCRATCH_SIZE - scratchTop) {
+        return NULL;
+    }
+
+    void *ptr = (uint8_t *)scratchBuffer + scratchTop;
+    scratchTop += aligned;
+    if (scratchTop > scratchHighWater) {
+        scratchHighWater = scratchTop;
+    }
+    return ptr;
+}
+
+void scratchFree(void *ptr)
+{
+    const unsigned offset = (uint8_t *)ptr - (uint8_t *)scratchBuffer;
+    if (ptr && offset < scratchTop) {
+        scratchTop = offset;
+    }
+}
+
+unsigned scratchUsed(void)
+{
+    return scratchTop;
+}
+
+unsigned scratchMaxUsed(void)
+{
+    return scratchHighWater;
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Scratch memory for the large temporary buffers of the MSP and CLI handlers, which would otherwise have to fit on
+ * the stack of every target. The handlers run from main loop tasks, which never preempt each other, so the buffers
+ * are never needed at the same time. Allocations are freed in the reverse order, freeing one frees everything
+ * allocated after it.
+ */
+
+#define SCRATCH_SIZE 256
+
+void *scratchAlloc(unsigned size);
+void scratchFree(void *ptr);
+unsigned scratchUsed(void);
+unsigned scratchMaxUsed(void);
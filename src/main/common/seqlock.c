@@ -0,0 +1,71 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "seqlock.h"
+
+// Orders the accesses to the data against the updates of the sequence around them
+#define seqlockBarrier() __sync_synchronize()
+
+void seqlockInit(seqlock_t *lock)
+{
+    lock->sequence = 0;
+}
+
+FAST_CODE void seqlockWriteBegin(seqlock_t *lock)
+{
+    lock->sequence = lock->sequence + 1;
+    seqlockBarrier();
+}
+
+FAST_CODE void seqlockWriteEnd(seqlock_t *lock)
+{
+    seqlockBarrier();
+    lock->sequence = lock->sequence + 1;
+}
+
+// Copies a coherent version of data to dst, false if every attempt overlapped a write
+bool seqlockRead(const seqlock_t *lock, void *dst, const void *data, unsigned size)
+{
+    for (int attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; attempt++) {
+        const uint32_t sequence = lock->sequence;
+        if (sequence & 1) {
+            continue;
+        }
+        seqlockBarrier();
+        memcpy(dst, data, size);
+        seqlockBarrier();
+        if (lock->sequence == sequence) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Number of completed writes, lets a reader skip data it has already seen
+uint32_t seqlockVersion(const seqlock_t *lock)
+{
+    return lock->sequence >> 1;
+}
@@ -0,0 +1,46 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Sequence lock for data with a single writer and any number of readers. The writer never waits:
+ * it makes the sequence odd, updates the data in place and makes it even again. A reader copies
+ * the data and keeps the copy only if the sequence was even and unchanged around it, so a write
+ * that preempted the copy is detected instead of giving a torn value.
+ *
+ * A reader that preempts the writer sees the write in progress on every attempt, so readers have
+ * to run at a lower priority than the writer. seqlockRead() gives up after SEQLOCK_READ_ATTEMPTS.
+ */
+
+#define SEQLOCK_READ_ATTEMPTS 4
+
+typedef struct seqlock_s {
+    volatile uint32_t sequence;     // odd while a write is in progress
+} seqlock_t;
+
+void seqlockInit(seqlock_t *lock);
+void seqlockWriteBegin(seqlock_t *lock);
+void seqlockWriteEnd(seqlock_t *lock);
+bool seqlockRead(const seqlock_t *lock, void *dst, const void *data, unsigned size);
+uint32_t seqlockVersion(const seqlock_t *lock);
@@ -0,0 +1,121 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "spsc_queue.h"
+
+// Orders the accesses to the slot against the update of the index that publishes or frees it
+#define spscQueueBarrier() __sync_synchronize()
+
+typedef struct spscQueueRegistryEntry_s {
+    const spscQueue_t *queue;
+    const char *name;
+} spscQueueRegistryEntry_t;
+
+static spscQueueRegistryEntry_t spscQueueRegistry[SPSC_QUEUE_REGISTRY_COUNT];
+
+void spscQueueInit(spscQueue_t *queue, void *buffer, unsigned elementSize, unsigned elementCount)
+{
+    queue->head = 0;
+    queue->tail = 0;
+    queue->mask = elementCount - 1;
+    queue->elementSize = elementSize;
+    queue->maxCount = 0;
+    queue->buffer = buffer;
+}
+
+// Returns the slot to be written next, or NULL if the queue is full
+void *spscQueueProducerSlot(spscQueue_t *queue)
+{
+    const uint16_t head = queue->head;
+    if ((uint16_t)(head - queue->tail) > queue->mask) {
+        return NULL;
+    }
+    return queue->buffer + (head & queue->mask) * queue->elementSize;
+}
+
+void spscQueueProducerCommit(spscQueue_t *queue)
+{
+    const uint16_t head = queue->head + 1;
+    const uint16_t count = head - queue->tail;
+    if (count > queue->maxCount) {
+        queue->maxCount = count;
+    }
+
+    spscQueueBarrier();
+    queue->head = head;
+}
+
+// Returns the oldest element, or NULL if the queue is empty
+void *spscQueueConsumerPeek(spscQueue_t *queue)
+{
+    const uint16_t tail = queue->tail;
+    if (tail == queue->head) {
+        return NULL;
+    }
+    spscQueueBarrier();
+    return queue->buffer + (tail & queue->mask) * queue->elementSize;
+}
+
+void spscQueueConsumerRelease(spscQueue_t *queue)
+{
+    spscQueueBarrier();
+    queue->tail = queue->tail + 1;
+}
+
+unsigned spscQueueCount(const spscQueue_t *queue)
+{
+    return (uint16_t)(queue->head - queue->tail);
+}
+
+unsigned spscQueueSize(const spscQueue_t *queue)
+{
+    return queue->mask + 1;
+}
+
+unsigned spscQueueMaxCount(const spscQueue_t *queue)
+{
+    return queue->maxCount;
+}
+
+void spscQueueRegister(const spscQueue_t *queue, const char *name)
+{
+    for (unsigned i = 0; i < SPSC_QUEUE_REGISTRY_COUNT; i++) {
+        if (!spscQueueRegistry[i].queue || spscQueueRegistry[i].queue == queue) {
+            spscQueueRegistry[i].queue = queue;
+            spscQueueRegistry[i].name = name;
+            return;
+        }
+    }
+}
+
+// Returns NULL past the last registered queue
+const spscQueue_t *spscQueueRegistered(unsigned index, const char **name)
+{
+    if (index >= SPSC_QUEUE_REGISTRY_COUNT || !spscQueueRegistry[index].queue) {
+        return NULL;
+    }
+    *name = spscQueueRegistry[index].name;
+    return spscQueueRegistry[index].queue;
+}
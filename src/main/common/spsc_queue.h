@@ -0,0 +1,58 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Lock-free queue of fixed size elements between one producer and one consumer, which may run in
+ * different execution contexts, for example an interrupt handler and the main loop. The producer
+ * only writes the head and the consumer only writes the tail, so neither side ever waits.
+ *
+ * The producer fills the slot returned by spscQueueProducerSlot() in place and publishes it with
+ * spscQueueProducerCommit(); the consumer reads the slot returned by spscQueueConsumerPeek() and
+ * hands it back with spscQueueConsumerRelease().
+ */
+
+typedef struct spscQueue_s {
+    volatile uint16_t head;     // next slot to be written, written by the producer only
+    volatile uint16_t tail;     // next slot to be read, written by the consumer only
+    uint16_t mask;              // element count - 1, the count is a power of two
+    uint16_t elementSize;
+    uint16_t maxCount;          // most elements queued at once since init, written by the producer only
+    uint8_t *buffer;
+} spscQueue_t;
+
+#define SPSC_QUEUE_REGISTRY_COUNT 8
+
+void spscQueueInit(spscQueue_t *queue, void *buffer, unsigned elementSize, unsigned elementCount);
+void *spscQueueProducerSlot(spscQueue_t *queue);
+void spscQueueProducerCommit(spscQueue_t *queue);
+void *spscQueueConsumerPeek(spscQueue_t *queue);
+void spscQueueConsumerRelease(spscQueue_t *queue);
+unsigned spscQueueCount(const spscQueue_t *queue);
+unsigned spscQueueSize(const spscQueue_t *queue);
+unsigned spscQueueMaxCount(const spscQueue_t *queue);
+
+// Named queues are listed by the memory cli command
+void spscQueueRegister(const spscQueue_t *queue, const char *name);
+const spscQueue_t *spscQueueRegistered(unsigned index, const char **name);
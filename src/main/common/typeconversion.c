@@ -27,24 +27,56 @@
 #include "build/build_config.h"
 #include "maths.h"
 
-#ifdef REQUIRE_PRINTF_LONG_SUPPORT
+static const char lowerDigits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+static const char upperDigits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 
-void uli2a(unsigned long int num, unsigned int base, int uc, char *bf)
+#define ULONG_DIGITS_MAX (sizeof(unsigned long) * 8)
+
+/*
+ * Write the digits of num backwards from end, which is terminated, and return the first digit. There is no
+ * division by a variable: base 10 divides by a constant, which the compiler turns into a multiply by the reciprocal,
+ * and base 16 is shifted.
+ */
+static char *ul2digits(unsigned long num, unsigned int base, const char *digits, char *end)
 {
-    unsigned int d = 1;
+    char *p = end;
+    *p = 0;
+
+    if (base == 10) {
+        do {
+            const unsigned long q = num / 10;
+            *--p = '0' + (num - q * 10);
+            num = q;
+        } while (num);
+    } else if (base == 16) {
+        do {
+            *--p = digits[num & 0xf];
+            num >>= 4;
+        } while (num);
+    } else {
+        do {
+            *--p = digits[num % base];
+            num /= base;
+        } while (num);
+    }
 
-    while (num / d >= base)
-        d *= base;
+    return p;
+}
 
-    while (d != 0) {
-        int dgt = num / d;
-    *bf++ = dgt + (dgt < 10 ? '0' : (uc ? 'A' : 'a') - 10);
+static void ul2a(unsigned long num, unsigned int base, int uc, char *bf)
+{
+    char buf[ULONG_DIGITS_MAX + 1];
+    char *end = buf + ULONG_DIGITS_MAX;
+    const char *p = ul2digits(num, base, uc ? upperDigits : lowerDigits, end);
 
-    // Next digit
-        num %= d;
-        d /= base;
-    }
-    *bf = 0;
+    memcpy(bf, p, end - p + 1);
+}
+
+#ifdef REQUIRE_PRINTF_LONG_SUPPORT
+
+void uli2a(unsigned long int num, unsigned int base, int uc, char *bf)
+{
+    ul2a(num, base, uc, bf);
 }
 
 void li2a(long num, char *bf)
@@ -60,20 +92,7 @@ void li2a(long num, char *bf)
 
 void ui2a(unsigned int num, unsigned int base, int uc, char *bf)
 {
-    unsigned int d = 1;
-
-    while (num / d >= base)
-        d *= base;
-
-    while (d != 0) {
-        int dgt = num / d;
-    *bf++ = dgt + (dgt < 10 ? '0' : (uc ? 'A' : 'a') - 10);
-
-    // Next digit
-        num %= d;
-        d /= base;
-    }
-    *bf = 0;
+    ul2a(num, base, uc, bf);
 }
 
 void i2a(int num, char *bf)
@@ -116,36 +135,23 @@ char a2i(char ch, const char **src, int base, int *nump)
 #ifndef HAVE_ITOA_FUNCTION
 
 /*
- ** The following two functions together make up an itoa()
- ** implementation. Function i2a() is a 'private' function
- ** called by the public itoa() function.
- **
  ** itoa() takes three arguments:
  **        1) the integer to be converted,
  **        2) a pointer to a character conversion buffer,
  **        3) the radix for the conversion
  **           which can range between 2 and 36 inclusive
  **           range errors on the radix default it to base10
- ** Code from http://groups.google.com/group/comp.lang.c/msg/66552ef8b04fe1ab?pli=1
  */
 
-static char *_i2a(unsigned i, char *a, unsigned base)
-{
-    if (i / base > 0)
-        a = _i2a(i / base, a, base);
-    *a = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[i % base];
-    return a + 1;
-}
-
 char *itoa(int i, char *a, int base)
 {
     if ((base < 2) || (base > 36))
         base = 10;
     if (i < 0) {
         *a = '-';
-        *_i2a(-(unsigned) i, a + 1, base) = 0;
+        ul2a(-(unsigned) i, base, 1, a + 1);
     } else
-        *_i2a(i, a, base) = 0;
+        ul2a(i, base, 1, a);
     return a;
 }
 
@@ -104,7 +104,7 @@ PG_RESET_TEMPLATE(pilotConfig_t, pilotConfig,
     .displayName = { 0 },
 );
 
-PG_REGISTER_WITH_RESET_TEMPLATE(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 5);
 
 PG_RESET_TEMPLATE(systemConfig_t, systemConfig,
     .pidProfileIndex = 0,
@@ -119,6 +119,8 @@ PG_RESET_TEMPLATE(systemConfig_t, systemConfig,
     .configurationState = CONFIGURATION_STATE_DEFAULTS_BARE,
     .schedulerOptimizeRate = SCHEDULER_OPTIMIZE_RATE_AUTO,
     .enableStickArming = false,
+    .schedulerDeadline = false,
+    .schedulerShedLoad = 80,
 );
 
 uint8_t getCurrentPidProfileIndex(void)
@@ -153,6 +155,8 @@ void resetConfig(void)
 static void activateConfig(void)
 {
     schedulerOptimizeRate(systemConfig()->schedulerOptimizeRate == SCHEDULER_OPTIMIZE_RATE_ON || (systemConfig()->schedulerOptimizeRate == SCHEDULER_OPTIMIZE_RATE_AUTO && motorConfig()->dev.useDshotTelemetry));
+    schedulerSetDeadline(systemConfig()->schedulerDeadline);
+    schedulerSetLoadShedding(systemConfig()->schedulerShedLoad);
     loadPidProfile();
     loadControlRateProfile();
 
@@ -186,7 +190,17 @@ static void adjustFilterLimit(uint16_t *parm, uint16_t resetValue)
 
 static void validateAndFixConfig(void)
 {
-#if !defined(USE_QUAD_MIXER_ONLY)
+#if defined(USE_HELI_ONLY)
+    // Only the heli mixers are built, reset the multirotor and fixed wing mixer modes
+    const mixerMode_e mixerMode = mixerConfig()->mixerMode;
+
+    if (mixerMode != MIXER_HELI_120_CCPM && mixerMode != MIXER_CUSTOM && mixerMode != MIXER_CUSTOM_AIRPLANE) {
+        mixerConfigMutable()->mixerMode = MIXER_HELI_120_CCPM;
+    }
+
+    // Reversible motors make no sense on a single main rotor
+    featureDisableImmediate(FEATURE_3D);
+#elif !defined(USE_QUAD_MIXER_ONLY)
     // Reset unsupported mixer mode to default.
     // This check will be gone when motor/servo mixers are loaded dynamically
     // by configurator as a part of configuration procedure.
@@ -373,6 +387,11 @@ static void validateAndFixConfig(void)
         }
     }
 
+    // The HELI failsafe needs time left for the descent after the hold
+    if (failsafeConfig()->failsafe_heli_hold_time * MILLIS_PER_TENTH_SECOND >= failsafeConfig()->failsafe_heli_landing_time * MILLIS_PER_SECOND) {
+        failsafeConfigMutable()->failsafe_heli_hold_time = failsafeConfig()->failsafe_heli_landing_time * 10 / 2;   // half of it, in 0.1sec
+    }
+
 #if defined(USE_ESC_SENSOR)
     if (!findSerialPortConfig(FUNCTION_ESC_SENSOR)) {
         featureDisableImmediate(FEATURE_ESC_SENSOR);
@@ -747,8 +766,52 @@ void ensureEEPROMStructureIsValid(void)
     resetEEPROM(false);
 }
 
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+// Saves the changed PGs from the config save task instead of blocking, so it can be done while armed.
+// Returns false when the stored config would have to be erased first, which has to wait until disarmed.
+bool saveConfigInBackground(void)
+{
+    systemConfigMutable()->configurationState = CONFIGURATION_STATE_CONFIGURED;
+
+    if (!startWriteConfigToEEPROM()) {
+        return false;
+    }
+
+    // changes made from here on are not part of this save
+    configIsDirty = false;
+    setTaskEnabled(TASK_CONFIG_SAVE, true);
+
+    return true;
+}
+
+void configSaveProcess(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    const eepromWriteState_e state = continueWriteConfigToEEPROM();
+    if (state == EEPROM_WRITE_BUSY) {
+        return;
+    }
+
+    if (state == EEPROM_WRITE_DONE) {
+        beeperConfirmationBeeps(1);
+    } else {
+        configIsDirty = true;
+    }
+
+    setTaskEnabled(TASK_CONFIG_SAVE, false);
+}
+#endif
+
 void saveConfigAndNotify(void)
 {
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+    if (ARMING_FLAG(ARMED)) {
+        saveConfigInBackground();
+        return;
+    }
+#endif
+
     writeEEPROM();
     readEEPROM();
     beeperConfirmationBeeps(1);
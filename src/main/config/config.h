@@ -23,6 +23,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "build/debug.h"
+
+#include "common/time.h"
+
 #include "pg/pg.h"
 
 #define MAX_NAME_LENGTH 16u
@@ -61,6 +65,12 @@ typedef struct systemConfig_s {
     uint8_t configurationState; // The state of the configuration (defaults / configured)
     uint8_t schedulerOptimizeRate;
     uint8_t enableStickArming; // boolean that determines whether stick arming can be used
+    uint8_t schedulerDeadline; // only start tasks that are expected to finish before the next realtime task is due
+    uint8_t schedulerShedLoad; // system load in percent above which the non-critical tasks are slowed down, 0 = off
+#ifdef USE_DEBUG_CHANNELS
+    uint8_t debug_channel_mode[DEBUG_CHANNEL_COUNT];    // debug mode logged by each debug channel, NONE = off
+    uint8_t debug_channel_slot[DEBUG_CHANNEL_COUNT];    // debug[] index of that mode
+#endif
 } systemConfig_t;
 
 PG_DECLARE(systemConfig_t, systemConfig);
@@ -76,6 +86,10 @@ void writeUnmodifiedConfigToEEPROM(void);
 void ensureEEPROMStructureIsValid(void);
 
 void saveConfigAndNotify(void);
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+bool saveConfigInBackground(void);
+void configSaveProcess(timeUs_t currentTimeUs);
+#endif
 void validateAndFixGyroConfig(void);
 
 void setConfigDirty(void);
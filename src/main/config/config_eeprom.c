@@ -27,6 +27,7 @@
 #include "build/build_config.h"
 
 #include "common/crc.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "config/config_eeprom.h"
@@ -41,8 +42,19 @@
 #include "drivers/flash.h"
 #include "drivers/system.h"
 
+#if defined(CONFIG_IN_FLASH) || defined(CONFIG_IN_FILE)
+// Changed PGs are appended behind the saved copy instead of erasing and rewriting it on every save
+#define USE_CONFIG_DELTA_SEGMENTS
+#endif
+
 static uint16_t eepromConfigSize;
 
+#ifdef USE_CONFIG_DELTA_SEGMENTS
+static uint16_t eepromBaseConfigSize;       // size of the saved copy, without the delta segments behind it
+static uint16_t eepromDeltaSequence;        // sequence of the last intact delta segment, 0 if there is none
+static bool eepromDeltaAppendable;          // storage behind the last intact segment is still erased
+#endif
+
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
     CR_CLASSICATION_PROFILE_LAST = CR_CLASSICATION_SYSTEM,
@@ -77,6 +89,34 @@ typedef struct {
 } PG_PACKED configFooter_t;
 // checksum is appended just after footer. It is not included in footer to make checksum calculation consistent
 
+#define CONFIG_DELTA_SEQUENCE_ERASED    0xFFFF
+
+// Header for each delta segment appended behind the saved copy.
+typedef struct {
+    uint16_t sequence;          // 1 for the first segment behind the saved copy, incremented by one for each following segment
+} PG_PACKED configDeltaHeader_t;
+// A delta segment starts on a write boundary and holds the changed PGs as records, followed by a footer and a checksum
+// like the saved copy. Its checksum is seeded with the checksum of the saved copy, so segments left over from an
+// earlier copy are never replayed.
+
+#ifdef USE_CONFIG_DELTA_SEGMENTS
+#ifndef CONFIG_DELTA_BUFFER_SIZE
+#define CONFIG_DELTA_BUFFER_SIZE        1024    // larger changes rewrite the whole config
+#endif
+
+#define CONFIG_WRITE_SLICE_SIZE         (4 * CONFIG_STREAMER_BUFFER_SIZE)   // bytes programmed per background slice
+
+// The delta segment is built in RAM first, so the PGs can keep changing while it is programmed
+static struct {
+    uint8_t data[CONFIG_DELTA_BUFFER_SIZE];
+    uint16_t size;
+    uint16_t written;
+    uint16_t sequence;
+    config_streamer_t streamer;
+    eepromWriteState_e state;
+} eepromDelta;
+#endif
+
 // Used to check the compiler packing at build time.
 typedef struct {
     uint8_t byte;
@@ -281,8 +321,125 @@ bool isEEPROMVersionValid(void)
     return true;
 }
 
-// Scan the EEPROM config. Returns true if the config is valid.
-bool isEEPROMStructureValid(void)
+#ifdef USE_CONFIG_DELTA_SEGMENTS
+static const uint8_t *alignToWriteBoundary(const uint8_t *p)
+{
+    const uintptr_t offset = p - &__config_start;
+    return &__config_start + ((offset + CONFIG_STREAMER_BUFFER_SIZE - 1) & ~(uintptr_t)(CONFIG_STREAMER_BUFFER_SIZE - 1));
+}
+
+// Walk the delta segments behind the saved copy up to the first one that is missing or not intact.
+// Returns where the next segment goes.
+static const uint8_t *scanDeltaSegments(uint16_t baseCrc)
+{
+    const uint8_t *p = alignToWriteBoundary(&__config_start + eepromBaseConfigSize);
+
+    while (p + sizeof(configDeltaHeader_t) <= &__config_end) {
+        const configDeltaHeader_t *header = (const configDeltaHeader_t *)p;
+
+        // a page that is yet to be written gets erased as soon as the streamer gets there
+        eepromDeltaAppendable = header->sequence == CONFIG_DELTA_SEQUENCE_ERASED || config_streamer_erases_at((uintptr_t)p);
+
+        if (header->sequence != eepromDeltaSequence + 1) {
+            break;
+        }
+
+        uint16_t crc = crc16_ccitt_bulk_update(CRC_START_VALUE, &baseCrc, sizeof(baseCrc));
+        crc = crc16_ccitt_bulk_update(crc, header, sizeof(*header));
+        const uint8_t *q = p + sizeof(*header);
+
+        for (;;) {
+            const configRecord_t *record = (const configRecord_t *)q;
+
+            if (q + sizeof(configFooter_t) > &__config_end || record->size == 0) {
+                break;
+            }
+            if (q + record->size >= &__config_end
+                || record->size < sizeof(*record)) {
+                return p;
+            }
+
+            crc = crc16_ccitt_bulk_update(crc, q, record->size);
+            q += record->size;
+        }
+
+        if (q + sizeof(configFooter_t) + sizeof(uint16_t) > &__config_end) {
+            break;
+        }
+        crc = crc16_ccitt_bulk_update(crc, q, sizeof(configFooter_t) + sizeof(uint16_t));
+        if (crc != CRC_CHECK_VALUE) {
+            break;
+        }
+
+        eepromDeltaSequence = header->sequence;
+        p = alignToWriteBoundary(q + sizeof(configFooter_t) + sizeof(uint16_t));
+    }
+
+    return p;
+}
+#endif
+
+// Records are stored in registry order, so the search starts behind the previous match.
+static const pgRegistry_t *findRegistry(pgn_t pgn, const pgRegistry_t **hint)
+{
+    const pgRegistry_t *reg = *hint;
+    for (int count = 0; count < PG_REGISTRY_SIZE; count++, reg++) {
+        if (reg >= __pg_registry_end) {
+            reg = __pg_registry_start;
+        }
+        if (pgN(reg) == pgn) {
+            *hint = reg + 1;
+            return reg;
+        }
+    }
+    return NULL;
+}
+
+// Point the PGs at the records starting at p, returns the end of the records.
+static const uint8_t *mapRecords(const uint8_t *p, const pgRegistry_t **hint)
+{
+    while (true) {
+        const configRecord_t *record = (const configRecord_t *)p;
+        if (record->size == 0
+            || p + record->size >= &__config_end
+            || record->size < sizeof(*record))
+            break;
+        if ((record->flags & CR_CLASSIFICATION_MASK) == CR_CLASSICATION_SYSTEM) {
+            const pgRegistry_t *reg = findRegistry(record->pgn, hint);
+            if (reg) {
+                reg->state->stored = record;
+            }
+        }
+        p += record->size;
+    }
+    return p;
+}
+
+// Point each PG at its latest stored record, so loading and saving don't have to scan the stored config for it.
+static void mapStoredRecords(bool valid)
+{
+    PG_FOREACH(reg) {
+        reg->state->stored = NULL;
+    }
+
+    if (!valid) {
+        return;
+    }
+
+    const pgRegistry_t *hint = __pg_registry_start;
+    mapRecords(&__config_start + sizeof(configHeader_t), &hint);
+
+#ifdef USE_CONFIG_DELTA_SEGMENTS
+    // records in later segments replace the earlier ones
+    const uint8_t *p = alignToWriteBoundary(&__config_start + eepromBaseConfigSize);
+    while (p < &__config_start + eepromConfigSize) {
+        p = mapRecords(p + sizeof(configDeltaHeader_t), &hint);
+        p = alignToWriteBoundary(p + sizeof(configFooter_t) + sizeof(uint16_t));
+    }
+#endif
+}
+
+static bool checkEEPROMStructure(void)
 {
     const uint8_t *p = &__config_start;
     const configHeader_t *header = (const configHeader_t *)p;
@@ -292,7 +449,7 @@ bool isEEPROMStructureValid(void)
     }
 
     uint16_t crc = CRC_START_VALUE;
-    crc = crc16_ccitt_update(crc, header, sizeof(*header));
+    crc = crc16_ccitt_bulk_update(crc, header, sizeof(*header));
     p += sizeof(*header);
 
     for (;;) {
@@ -308,24 +465,47 @@ bool isEEPROMStructureValid(void)
             return false;
         }
 
-        crc = crc16_ccitt_update(crc, p, record->size);
+        crc = crc16_ccitt_bulk_update(crc, p, record->size);
 
         p += record->size;
     }
 
     const configFooter_t *footer = (const configFooter_t *)p;
-    crc = crc16_ccitt_update(crc, footer, sizeof(*footer));
+    crc = crc16_ccitt_bulk_update(crc, footer, sizeof(*footer));
     p += sizeof(*footer);
 
     // include stored CRC in the CRC calculation
     const uint16_t *storedCrc = (const uint16_t *)p;
-    crc = crc16_ccitt_update(crc, storedCrc, sizeof(*storedCrc));
-    p += sizeof(storedCrc);
+    crc = crc16_ccitt_bulk_update(crc, storedCrc, sizeof(*storedCrc));
+    p += sizeof(*storedCrc);
 
     eepromConfigSize = p - &__config_start;
+#ifdef USE_CONFIG_DELTA_SEGMENTS
+    eepromBaseConfigSize = eepromConfigSize;
+    eepromDeltaSequence = 0;
+    eepromDeltaAppendable = false;
+#endif
 
     // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    if (crc != CRC_CHECK_VALUE) {
+        return false;
+    }
+
+#ifdef USE_CONFIG_DELTA_SEGMENTS
+    eepromConfigSize = scanDeltaSegments(*storedCrc) - &__config_start;
+#endif
+
+    return true;
+}
+
+// Scan the EEPROM config. Returns true if the config is valid.
+bool isEEPROMStructureValid(void)
+{
+    const bool valid = checkEEPROMStructure();
+
+    mapStoredRecords(valid);
+
+    return valid;
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -352,26 +532,15 @@ size_t getEEPROMStorageSize(void)
 // this function assumes that EEPROM content is valid
 static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
 {
-    const uint8_t *p = &__config_start;
-    p += sizeof(configHeader_t);             // skip header
-    while (true) {
-        const configRecord_t *record = (const configRecord_t *)p;
-        if (record->size == 0
-            || p + record->size >= &__config_end
-            || record->size < sizeof(*record))
-            break;
-        if (pgN(reg) == record->pgn
-            && (record->flags & CR_CLASSIFICATION_MASK) == classification)
-            return record;
-        p += record->size;
+    if (classification != CR_CLASSICATION_SYSTEM) {
+        return NULL;
     }
-    // record not found
-    return NULL;
+
+    return reg->state->stored;
 }
 
 // Initialize all PG records from EEPROM.
-// This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
-//   but each PG is loaded/initialized exactly once and in defined order.
+// This functions processes all PGs sequentially, each PG is loaded/initialized exactly once and in defined order.
 bool loadEEPROM(void)
 {
     bool success = true;
@@ -393,8 +562,202 @@ bool loadEEPROM(void)
     return success;
 }
 
+#ifdef USE_CONFIG_DELTA_SEGMENTS
+static bool isPgStored(const pgRegistry_t *reg)
+{
+    const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+    const uint16_t regSize = pgSize(reg);
+
+    return rec
+        && rec->size == sizeof(configRecord_t) + regSize
+        && rec->version == pgVersion(reg)
+        && memcmp(rec->pg, reg->address, regSize) == 0;
+}
+
+// Build a delta segment of the PGs that differ from the stored config, size is left 0 when nothing has changed.
+// Returns false when the stored config can't be appended to, so it has to be rewritten as a whole.
+static bool buildDeltaSegment(void)
+{
+    eepromDelta.size = 0;
+
+    if (!isEEPROMVersionValid() || !isEEPROMStructureValid() || !eepromDeltaAppendable) {
+        return false;
+    }
+
+    const configDeltaHeader_t header = {
+        .sequence = eepromDeltaSequence + 1,
+    };
+
+    uint8_t *p = eepromDelta.data;
+    const uint8_t *recordsEnd = ARRAYEND(eepromDelta.data) - sizeof(configFooter_t) - sizeof(uint16_t);
+    bool changed = false;
+
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    PG_FOREACH(reg) {
+        if (isPgStored(reg)) {
+            continue;
+        }
+
+        const uint16_t regSize = pgSize(reg);
+        if (p + sizeof(configRecord_t) + regSize > recordsEnd) {
+            return false;
+        }
+
+        const configRecord_t record = {
+            .size = sizeof(configRecord_t) + regSize,
+            .pgn = pgN(reg),
+            .version = pgVersion(reg),
+            .flags = CR_CLASSICATION_SYSTEM,
+        };
+
+        memcpy(p, &record, sizeof(record));
+        p += sizeof(record);
+        memcpy(p, reg->address, regSize);
+        p += regSize;
+        changed = true;
+    }
+
+    if (!changed) {
+        return true;
+    }
+
+    const configFooter_t footer = {
+        .terminator = 0,
+    };
+
+    memcpy(p, &footer, sizeof(footer));
+    p += sizeof(footer);
+
+    const uint16_t baseCrc = *(const uint16_t *)(&__config_start + eepromBaseConfigSize - sizeof(uint16_t));
+    uint16_t crc = crc16_ccitt_bulk_update(CRC_START_VALUE, &baseCrc, sizeof(baseCrc));
+    crc = crc16_ccitt_bulk_update(crc, eepromDelta.data, p - eepromDelta.data);
+
+    const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
+    memcpy(p, &invertedBigEndianCrc, sizeof(invertedBigEndianCrc));
+    p += sizeof(invertedBigEndianCrc);
+
+    eepromDelta.size = p - eepromDelta.data;
+    eepromDelta.sequence = header.sequence;
+
+    // keep the offsets within what eepromConfigSize can hold
+    return eepromConfigSize + eepromDelta.size <= MIN(getEEPROMStorageSize(), (size_t)UINT16_MAX);
+}
+
+static void startDeltaSegmentWrite(void)
+{
+    const size_t offset = eepromConfigSize;
+
+    eepromDelta.written = 0;
+    eepromDelta.state = EEPROM_WRITE_BUSY;
+
+    config_streamer_init(&eepromDelta.streamer);
+
+    // only storage behind the stored config is written, and erased where the streamer crosses into a new page
+    config_streamer_start(&eepromDelta.streamer, (uintptr_t)&__config_start + offset, getEEPROMStorageSize() - offset);
+}
+
+static eepromWriteState_e continueDeltaSegmentWrite(uint16_t length)
+{
+    length = MIN(length, eepromDelta.size - eepromDelta.written);
+    config_streamer_write(&eepromDelta.streamer, eepromDelta.data + eepromDelta.written, length);
+    eepromDelta.written += length;
+
+    if (config_streamer_status(&eepromDelta.streamer) != 0) {
+        config_streamer_finish(&eepromDelta.streamer);
+        eepromDelta.state = EEPROM_WRITE_FAILED;
+    } else if (eepromDelta.written == eepromDelta.size) {
+        config_streamer_flush(&eepromDelta.streamer);
+
+        const bool success = config_streamer_finish(&eepromDelta.streamer) == 0;
+
+        // the segment only counts once it reads back intact
+        if (success && isEEPROMStructureValid() && eepromDeltaSequence == eepromDelta.sequence) {
+            eepromDelta.state = EEPROM_WRITE_DONE;
+        } else {
+            eepromDelta.state = EEPROM_WRITE_FAILED;
+        }
+    }
+
+    return eepromDelta.state;
+}
+
+// Append the PGs that differ from the stored config as a new delta segment, without erasing.
+// Returns false when that is not possible, and the whole config has to be rewritten.
+static bool appendSettingsToEEPROM(void)
+{
+    if (!buildDeltaSegment()) {
+        return false;
+    }
+    if (eepromDelta.size == 0) {
+        // nothing has changed
+        return true;
+    }
+
+    startDeltaSegmentWrite();
+
+    return continueDeltaSegmentWrite(eepromDelta.size) == EEPROM_WRITE_DONE;
+}
+#endif
+
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+// true when programming the delta segment would erase a page, which stalls the CPU for too long while armed
+static bool deltaSegmentErases(void)
+{
+    for (size_t offset = 0; offset < eepromDelta.size; offset += CONFIG_STREAMER_BUFFER_SIZE) {
+        if (config_streamer_erases_at((uintptr_t)&__config_start + eepromConfigSize + offset)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Snapshot the changed PGs for writing them out in slices with continueWriteConfigToEEPROM().
+// Only appends to the stored config, returns false when it would have to be erased and rewritten.
+bool startWriteConfigToEEPROM(void)
+{
+    if (eepromDelta.state == EEPROM_WRITE_BUSY) {
+        return false;
+    }
+
+    if (!buildDeltaSegment() || deltaSegmentErases()) {
+        eepromDelta.state = EEPROM_WRITE_FAILED;
+        return false;
+    }
+
+    if (eepromDelta.size == 0) {
+        eepromDelta.state = EEPROM_WRITE_DONE;
+    } else {
+        startDeltaSegmentWrite();
+    }
+
+    return true;
+}
+
+eepromWriteState_e continueWriteConfigToEEPROM(void)
+{
+    if (eepromDelta.state != EEPROM_WRITE_BUSY) {
+        return eepromDelta.state;
+    }
+
+    return continueDeltaSegmentWrite(CONFIG_WRITE_SLICE_SIZE);
+}
+
+eepromWriteState_e getWriteConfigToEEPROMState(void)
+{
+    return eepromDelta.state;
+}
+#endif
+
 static bool writeSettingsToEEPROM(void)
 {
+#ifdef USE_CONFIG_DELTA_SEGMENTS
+    if (appendSettingsToEEPROM()) {
+        return true;
+    }
+#endif
+
     config_streamer_t streamer;
     config_streamer_init(&streamer);
 
@@ -407,7 +770,7 @@ static bool writeSettingsToEEPROM(void)
 
     config_streamer_write(&streamer, (uint8_t *)&header, sizeof(header));
     uint16_t crc = CRC_START_VALUE;
-    crc = crc16_ccitt_update(crc, (uint8_t *)&header, sizeof(header));
+    crc = crc16_ccitt_bulk_update(crc, (uint8_t *)&header, sizeof(header));
     PG_FOREACH(reg) {
         const uint16_t regSize = pgSize(reg);
         configRecord_t record = {
@@ -419,9 +782,9 @@ static bool writeSettingsToEEPROM(void)
 
         record.flags |= CR_CLASSICATION_SYSTEM;
         config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record));
-        crc = crc16_ccitt_update(crc, (uint8_t *)&record, sizeof(record));
+        crc = crc16_ccitt_bulk_update(crc, (uint8_t *)&record, sizeof(record));
         config_streamer_write(&streamer, reg->address, regSize);
-        crc = crc16_ccitt_update(crc, reg->address, regSize);
+        crc = crc16_ccitt_bulk_update(crc, reg->address, regSize);
     }
 
     configFooter_t footer = {
@@ -429,7 +792,7 @@ static bool writeSettingsToEEPROM(void)
     };
 
     config_streamer_write(&streamer, (uint8_t *)&footer, sizeof(footer));
-    crc = crc16_ccitt_update(crc, (uint8_t *)&footer, sizeof(footer));
+    crc = crc16_ccitt_bulk_update(crc, (uint8_t *)&footer, sizeof(footer));
 
     // include inverted CRC in big endian format in the CRC
     const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
@@ -445,6 +808,12 @@ static bool writeSettingsToEEPROM(void)
 void writeConfigToEEPROM(void)
 {
     bool success = false;
+
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+    // finish a background write first, it appends behind what is stored now
+    while (continueWriteConfigToEEPROM() == EEPROM_WRITE_BUSY);
+#endif
+
     // write it
     for (int attempt = 0; attempt < 3 && !success; attempt++) {
         if (writeSettingsToEEPROM()) {
@@ -25,10 +25,22 @@
 
 #define EEPROM_CONF_VERSION 172
 
+typedef enum {
+    EEPROM_WRITE_IDLE = 0,
+    EEPROM_WRITE_BUSY,
+    EEPROM_WRITE_DONE,
+    EEPROM_WRITE_FAILED,
+} eepromWriteState_e;
+
 bool isEEPROMVersionValid(void);
 bool isEEPROMStructureValid(void);
 bool loadEEPROM(void);
 void writeConfigToEEPROM(void);
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+bool startWriteConfigToEEPROM(void);
+eepromWriteState_e continueWriteConfigToEEPROM(void);
+eepromWriteState_e getWriteConfigToEEPROMState(void);
+#endif
 
 uint16_t getEEPROMConfigSize(void);
 size_t getEEPROMStorageSize(void);
@@ -22,6 +22,8 @@
 
 #include "platform.h"
 
+#include "common/utils.h"
+
 #include "drivers/system.h"
 #include "drivers/flash.h"
 
@@ -487,6 +489,17 @@ static int write_word(config_streamer_t *c, config_streamer_buffer_align_type_t
     return 0;
 }
 
+// true when writing a word at address erases the page it starts first
+bool config_streamer_erases_at(uintptr_t address)
+{
+#if defined(CONFIG_IN_FLASH) || defined(CONFIG_IN_FILE)
+    return address % FLASH_PAGE_SIZE == 0;
+#else
+    UNUSED(address);
+    return false;
+#endif
+}
+
 int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size)
 {
     for (const uint8_t *pat = p; pat != (uint8_t*)p + size; pat++) {
@@ -52,6 +52,7 @@ typedef struct config_streamer_s {
 void config_streamer_init(config_streamer_t *c);
 
 void config_streamer_start(config_streamer_t *c, uintptr_t base, int size);
+bool config_streamer_erases_at(uintptr_t address);
 int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size);
 int config_streamer_flush(config_streamer_t *c);
 
@@ -25,6 +25,8 @@
 #include "common/axis.h"
 #include "common/maths.h"
 #include "common/sensor_alignment.h"
+#include "common/seqlock.h"
+#include "common/time.h"
 #include "drivers/exti.h"
 #include "drivers/bus.h"
 #include "drivers/sensor.h"
@@ -79,6 +81,29 @@ typedef enum {
     GYRO_RATE_32_kHz,
 } gyroRateKHz_e;
 
+#ifdef USE_GYRO_FIFO
+#define GYRO_FIFO_SAMPLES_MAX 16            // samples read per loop, covers decimation 8 with a late loop
+#define GYRO_FIFO_DECIMATION_MAX 8
+#endif
+
+#ifdef USE_GYRO_ISR_READ
+#define GYRO_ISR_RING_SIZE 8                // must be a power of 2
+
+// Sample taken by the data ready interrupt
+typedef struct gyroIsrSample_s {
+    timeUs_t timeUs;
+    int16_t gyroADCRaw[XYZ_AXIS_COUNT];
+    int16_t accADCRaw[XYZ_AXIS_COUNT];
+} gyroIsrSample_t;
+
+// Single producer (interrupt) / single consumer (gyro task) ring, no locking needed
+typedef struct gyroIsrRing_s {
+    volatile uint8_t head;                  // written by the interrupt only
+    volatile uint8_t tail;                  // written by the gyro task only
+    volatile gyroIsrSample_t sample[GYRO_ISR_RING_SIZE];
+} gyroIsrRing_t;
+#endif
+
 typedef struct gyroDev_s {
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_MULTITHREAD)
     pthread_mutex_t lock;
@@ -90,7 +115,7 @@ typedef struct gyroDev_s {
     busDevice_t bus;
     float scale;                                             // scalefactor
     float gyroZero[XYZ_AXIS_COUNT];
-    float gyroADC[XYZ_AXIS_COUNT];                           // gyro data after calibration and alignment
+    float gyroADC[XYZ_AXIS_COUNT];                           // gyro data after calibration, alignment and scaling (deg/s)
     int32_t gyroADCRawPrevious[XYZ_AXIS_COUNT];
     int16_t gyroADCRaw[XYZ_AXIS_COUNT];                      // raw data from sensor
     int16_t temperature;
@@ -106,6 +131,31 @@ typedef struct gyroDev_s {
     uint8_t gyroHasOverflowProtection;
     gyroHardware_e gyroHardware;
     fp_rotationMatrix_t rotationMatrix;
+#ifdef USE_GYRO_FIFO
+    bool fifoSupported;                                      // set by the driver's detect function
+    uint8_t fifoDecimation;                                  // sensor samples per loop, FIFO is used when > 1
+    uint8_t fifoSampleCount;                                 // samples read by the last readFn call
+    int16_t fifoData[GYRO_FIFO_SAMPLES_MAX][XYZ_AXIS_COUNT];
+#endif
+#ifdef USE_GYRO_ISR_READ
+    bool isrRead;                                            // samples are read by the data ready interrupt
+    uint8_t isrReadIndex;                                    // slot of the interrupt read bus sequence
+    gyroIsrRing_t isrRing;
+    volatile int16_t isrTemperatureRaw;                      // temperature from the latest interrupt read
+    timeUs_t sampleTimeUs;                                   // time the latest consumed sample was taken
+#endif
+#ifdef USE_GYRO_ACC_BURST
+    uint8_t accBurstDenom;                                   // gyro reads per acc sample taken with them, 0 if the acc reads the bus itself
+    uint8_t accBurstCount;
+    volatile bool accBurstUpdated;                           // accADCRaw is new since the acc last read it
+    seqlock_t accBurstLock;                                  // the gyro read may run in the data ready interrupt
+    int16_t accADCRaw[XYZ_AXIS_COUNT];                       // acc data of the latest gyro read that took it
+#endif
+#ifdef USE_GYRO_ISR_PID
+    void (*isrTaskFn)(timeUs_t currentTimeUs);              // run from the data ready interrupt after the sample is read
+    uint8_t isrTaskDenom;                                    // interrupts per isrTaskFn call
+    uint8_t isrTaskCount;
+#endif
 } gyroDev_t;
 
 typedef struct accDev_s {
@@ -125,8 +175,34 @@ typedef struct accDev_s {
     char revisionCode;                                      // a revision code for the sensor, if known
     uint8_t filler[2];
     fp_rotationMatrix_t rotationMatrix;
+#ifdef USE_GYRO_ACC_BURST
+    gyroDev_t *burstGyro;                                   // gyro whose reads fetch the acc data, NULL if the acc reads the bus itself
+#endif
 } accDev_t;
 
+#ifdef USE_GYRO_ACC_BURST
+// Counts the gyro reads, true on those that are to fetch the acc data as well
+static inline bool gyroAccBurstDue(gyroDev_t *gyro)
+{
+    if (!gyro->accBurstDenom || ++gyro->accBurstCount < gyro->accBurstDenom) {
+        return false;
+    }
+    gyro->accBurstCount = 0;
+    return true;
+}
+
+// Only the raw sample is stored in the gyro read, the acc task runs accUpdate() on it
+static inline void gyroAccBurstPublish(gyroDev_t *gyro, const int16_t *accADCRaw)
+{
+    seqlockWriteBegin(&gyro->accBurstLock);
+    gyro->accADCRaw[X] = accADCRaw[X];
+    gyro->accADCRaw[Y] = accADCRaw[Y];
+    gyro->accADCRaw[Z] = accADCRaw[Z];
+    seqlockWriteEnd(&gyro->accBurstLock);
+    gyro->accBurstUpdated = true;
+}
+#endif
+
 static inline void accDevLock(accDev_t *acc)
 {
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_MULTITHREAD)
@@ -18,6 +18,7 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -58,6 +59,8 @@
 
 #include "pg/pg.h"
 #include "pg/gyrodev.h"
+#include "pg/sdcard.h"
+#include "pg/sensor_cache.h"
 
 #ifndef MPU_ADDRESS
 #define MPU_ADDRESS             0x68
@@ -65,6 +68,8 @@
 
 #define MPU_INQUIRY_MASK   0x7E
 
+#define MPU_STARTUP_TIME_MS 35
+
 #ifdef USE_I2C_GYRO
 static void mpu6050FindRevision(gyroDev_t *gyro)
 {
@@ -101,10 +106,72 @@ static void mpu6050FindRevision(gyroDev_t *gyro)
 }
 #endif
 
+#ifdef USE_SPI_GYRO
+// accel, temperature and gyro registers are contiguous and read in one burst
+#define MPU_BURST_READ_LENGTH   14
+#define MPU_BURST_TEMP_OFFSET   6
+#define MPU_BURST_GYRO_OFFSET   8
+
+static const uint8_t mpuBurstReadCommand[1 + MPU_BURST_READ_LENGTH] = {
+    MPU_RA_ACCEL_XOUT_H | 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+#endif
+
 /*
  * Gyro interrupt service routine
  */
 #ifdef USE_GYRO_EXTI
+#ifdef USE_GYRO_ISR_READ
+
+static gyroDev_t *isrReadGyro[MAX_GYRODEV_COUNT];
+static uint8_t isrReadGyroCount;
+
+// Bus sequences of the interrupt reads, one per gyro, indexed like isrReadGyro
+static spiSequence_t isrReadSequence[MAX_GYRODEV_COUNT];
+static busSegment_t isrReadSegments[MAX_GYRODEV_COUNT][2];
+static uint8_t isrReadData[MAX_GYRODEV_COUNT][1 + MPU_BURST_READ_LENGTH];
+static timeUs_t isrReadTimeUs[MAX_GYRODEV_COUNT];
+
+// Producer, runs when the burst read completes. That is in the data ready interrupt when the
+// bus is free, otherwise in whichever context releases the bus next.
+static void mpuGyroIsrReadComplete(spiSequence_t *sequence)
+{
+    const int index = sequence - isrReadSequence;
+    gyroDev_t *gyro = isrReadGyro[index];
+    const uint8_t *data = isrReadData[index];
+    gyroIsrRing_t *ring = &gyro->isrRing;
+
+    gyro->isrTemperatureRaw = (int16_t)((data[1 + MPU_BURST_TEMP_OFFSET] << 8) | data[2 + MPU_BURST_TEMP_OFFSET]);
+
+    const uint8_t head = ring->head;
+    const uint8_t nextHead = (head + 1) & (GYRO_ISR_RING_SIZE - 1);
+    if (nextHead == ring->tail) {
+        // gyro task is not keeping up, drop the sample
+        return;
+    }
+
+    volatile gyroIsrSample_t *sample = &ring->sample[head];
+    sample->timeUs = isrReadTimeUs[index];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        sample->accADCRaw[axis] = (int16_t)((data[1 + axis * 2] << 8) | data[2 + axis * 2]);
+        sample->gyroADCRaw[axis] = (int16_t)((data[1 + MPU_BURST_GYRO_OFFSET + axis * 2] << 8) | data[2 + MPU_BURST_GYRO_OFFSET + axis * 2]);
+    }
+    ring->head = nextHead;
+}
+
+// Runs in the data ready interrupt, the read queues at high priority if another device holds the bus
+static void mpuGyroIsrRead(gyroDev_t *gyro, timeUs_t timeUs)
+{
+    spiSequence_t *sequence = &isrReadSequence[gyro->isrReadIndex];
+    if (spiSequenceIsPending(sequence)) {
+        // the previous read is still waiting for the bus, it will fetch the latest data
+        return;
+    }
+    isrReadTimeUs[gyro->isrReadIndex] = timeUs;
+    spiSequenceStart(sequence);
+}
+#endif
+
 static void mpuIntExtiHandler(extiCallbackRec_t *cb)
 {
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
@@ -115,6 +182,25 @@ static void mpuIntExtiHandler(extiCallbackRec_t *cb)
 #endif
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
     gyro->dataReady = true;
+#ifdef USE_GYRO_ISR_READ
+    if (gyro->isrRead) {
+        const timeUs_t sampleTimeUs = microsISR();
+        mpuGyroIsrRead(gyro, sampleTimeUs);
+#ifdef USE_GYRO_ISR_PID
+        // Another device holding the shared bus defers the read until it releases it. The loop then
+        // waits for the next interrupt rather than run on the previous sample.
+        if (gyro->isrTaskFn) {
+            if (gyro->isrTaskCount < gyro->isrTaskDenom) {
+                gyro->isrTaskCount++;
+            }
+            if (gyro->isrTaskCount >= gyro->isrTaskDenom && !spiSequenceIsPending(&isrReadSequence[gyro->isrReadIndex])) {
+                gyro->isrTaskCount = 0;
+                gyro->isrTaskFn(sampleTimeUs);
+            }
+        }
+#endif
+    }
+#endif
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
     const uint32_t now2Us = micros();
     debug[1] = (uint16_t)(now2Us - nowUs);
@@ -179,7 +265,22 @@ bool mpuGyroRead(gyroDev_t *gyro)
 bool mpuGyroReadSPI(gyroDev_t *gyro)
 {
     static const uint8_t dataToSend[7] = {MPU_RA_GYRO_XOUT_H | 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-    uint8_t data[7];
+    uint8_t data[1 + MPU_BURST_READ_LENGTH];
+
+#ifdef USE_GYRO_ACC_BURST
+    if (gyroAccBurstDue(gyro)) {
+        if (!spiBusTransfer(&gyro->bus, mpuBurstReadCommand, data, sizeof(mpuBurstReadCommand))) {
+            return false;
+        }
+        int16_t accADCRaw[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            accADCRaw[axis] = (int16_t)((data[1 + axis * 2] << 8) | data[2 + axis * 2]);
+            gyro->gyroADCRaw[axis] = (int16_t)((data[1 + MPU_BURST_GYRO_OFFSET + axis * 2] << 8) | data[2 + MPU_BURST_GYRO_OFFSET + axis * 2]);
+        }
+        gyroAccBurstPublish(gyro, accADCRaw);
+        return true;
+    }
+#endif
 
     const bool ack = spiBusTransfer(&gyro->bus, dataToSend, data, 7);
     if (!ack) {
@@ -193,6 +294,105 @@ bool mpuGyroReadSPI(gyroDev_t *gyro)
     return true;
 }
 
+#ifdef USE_GYRO_ISR_READ
+// Consumer, drains every sample posted since the last call. The newest one becomes the
+// current sample, all of them feed the FIFO decimation stage when it is compiled in.
+static bool mpuGyroReadIsrRing(gyroDev_t *gyro)
+{
+    gyroIsrRing_t *ring = &gyro->isrRing;
+    const uint8_t head = ring->head;
+    uint8_t tail = ring->tail;
+
+    if (tail == head) {
+        return false;
+    }
+
+    int count = 0;
+#ifdef USE_GYRO_ACC_BURST
+    int16_t accADCRaw[XYZ_AXIS_COUNT];
+#endif
+    while (tail != head) {
+        const volatile gyroIsrSample_t *sample = &ring->sample[tail];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyro->gyroADCRaw[axis] = sample->gyroADCRaw[axis];
+#ifdef USE_GYRO_ACC_BURST
+            accADCRaw[axis] = sample->accADCRaw[axis];
+#endif
+#ifdef USE_GYRO_FIFO
+            if (count < GYRO_FIFO_SAMPLES_MAX) {
+                gyro->fifoData[count][axis] = sample->gyroADCRaw[axis];
+            }
+#endif
+        }
+        gyro->sampleTimeUs = sample->timeUs;
+        count++;
+        tail = (tail + 1) & (GYRO_ISR_RING_SIZE - 1);
+    }
+    ring->tail = tail;
+
+#ifdef USE_GYRO_ACC_BURST
+    // every sample has the acc data, it is handed on at the acc sampling rate
+    if (gyroAccBurstDue(gyro)) {
+        gyroAccBurstPublish(gyro, accADCRaw);
+    }
+#endif
+
+#ifdef USE_GYRO_FIFO
+    gyro->fifoSampleCount = MIN(count, GYRO_FIFO_SAMPLES_MAX);
+#else
+    UNUSED(count);
+#endif
+
+    return true;
+}
+
+// The SD card keeps its chip select asserted from one poll to the next without claiming the bus, and
+// claiming it for that long would hold the gyro reads off for milliseconds. The two can't share a bus.
+static bool mpuGyroBusSharedWithSdcard(const gyroDev_t *gyro)
+{
+#if defined(USE_SDCARD_SPI)
+    return sdcardConfig()->mode == SDCARD_MODE_SPI
+        && spiDeviceByInstance(gyro->bus.busdev_u.spi.instance) == SPI_CFG_TO_DEV(sdcardConfig()->device);
+#else
+    UNUSED(gyro);
+    return false;
+#endif
+}
+
+// Moves the SPI read of an MPU family gyro into its data ready interrupt. The read is queued on the bus
+// arbitration, so it never runs inside a transfer of another device that claims the bus.
+bool mpuGyroIsrReadInit(gyroDev_t *gyro)
+{
+    if (gyro->bus.bustype != BUSTYPE_SPI || gyro->readFn != mpuGyroReadSPI || !gyro->exti.fn
+        || isrReadGyroCount >= MAX_GYRODEV_COUNT || mpuGyroBusSharedWithSdcard(gyro)) {
+        return false;
+    }
+
+    const uint8_t index = isrReadGyroCount++;
+    busSegment_t *segments = isrReadSegments[index];
+    segments[0] = (busSegment_t){ .txData = mpuBurstReadCommand, .rxData = isrReadData[index], .len = sizeof(mpuBurstReadCommand), .negateCS = true };
+    segments[1] = (busSegment_t){ .len = 0 };
+    isrReadSequence[index] = (spiSequence_t){
+        .bus = &gyro->bus,
+        .segments = segments,
+        .callback = mpuGyroIsrReadComplete,
+        .priority = SPI_PRIORITY_HIGH,
+    };
+
+    gyro->isrRing.head = 0;
+    gyro->isrRing.tail = 0;
+    gyro->readFn = mpuGyroReadIsrRing;
+    gyro->isrReadIndex = index;
+    isrReadGyro[index] = gyro;
+
+    // enable last, the interrupt may fire at any time from here
+    gyro->isrRead = true;
+
+    return true;
+}
+
+#endif
+
 typedef uint8_t (*gyroSpiDetectFn_t)(const busDevice_t *bus);
 
 static gyroSpiDetectFn_t gyroSpiDetectFnTable[] = {
@@ -239,6 +439,20 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro, const gyro
 
     uint8_t sensor = MPU_NONE;
 
+#ifdef USE_SENSOR_HARDWARE_CACHE
+    // Most detect functions reset the chip and wait for it, the one that answered
+    // on the last boot goes first
+    uint8_t *cachedDetect = &sensorHardwareCacheMutable()->gyroSpiDetect[config->index];
+    if (*cachedDetect && *cachedDetect < ARRAYLEN(gyroSpiDetectFnTable)) {
+        sensor = (gyroSpiDetectFnTable[*cachedDetect - 1])(&gyro->bus);
+        if (sensor != MPU_NONE) {
+            gyro->mpuDetectionResult.sensor = sensor;
+
+            return true;
+        }
+    }
+#endif
+
     // It is hard to use hardware to optimize the detection loop here,
     // as hardware type and detection function name doesn't match.
     // May need a bitmap of hardware to detection function to do it right?
@@ -247,11 +461,18 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro, const gyro
         sensor = (gyroSpiDetectFnTable[index])(&gyro->bus);
         if (sensor != MPU_NONE) {
             gyro->mpuDetectionResult.sensor = sensor;
+#ifdef USE_SENSOR_HARDWARE_CACHE
+            *cachedDetect = index + 1;
+#endif
 
             return true;
         }
     }
 
+#ifdef USE_SENSOR_HARDWARE_CACHE
+    *cachedDetect = 0;
+#endif
+
     // Detection failed, disable CS pin again
 
     spiPreinitByTag(config->csnTag);
@@ -271,8 +492,12 @@ void mpuPreInit(const struct gyroDeviceConfig_s *config)
 
 bool mpuDetect(gyroDev_t *gyro, const gyroDeviceConfig_t *config)
 {
-    // MPU datasheet specifies 30ms.
-    delay(35);
+    // MPU datasheet specifies 30ms from power up. The sensors are powered with the MCU,
+    // so only what is left of it since boot needs waiting for.
+    const timeMs_t now = millis();
+    if (now < MPU_STARTUP_TIME_MS) {
+        delay(MPU_STARTUP_TIME_MS - now);
+    }
 
     if (config->bustype == BUSTYPE_NONE) {
         return false;
@@ -323,8 +548,53 @@ bool mpuDetect(gyroDev_t *gyro, const gyroDeviceConfig_t *config)
 #endif
 }
 
+#ifdef USE_GYRO_TEMP_COMP
+static bool mpuGyroReadTemperature(gyroDev_t *gyro, int16_t *temperature)
+{
+    int16_t raw;
+
+#ifdef USE_GYRO_ISR_READ
+    if (gyro->isrRead) {
+        // the bus belongs to the interrupt reads, which fetch the temperature anyway
+        if (!gyro->sampleTimeUs) {
+            return false;
+        }
+        raw = gyro->isrTemperatureRaw;
+    } else
+#endif
+    {
+        uint8_t data[2];
+        if (!busReadRegisterBuffer(&gyro->bus, MPU_RA_TEMP_OUT_H, data, 2)) {
+            return false;
+        }
+        raw = (int16_t)((data[0] << 8) | data[1]);
+    }
+
+    switch (gyro->gyroHardware) {
+    case GYRO_MPU6050:
+    case GYRO_MPU6000:
+        *temperature = lrintf(raw / 340.0f + 36.53f);
+        break;
+    case GYRO_ICM20689:
+        *temperature = lrintf(raw / 326.8f + 25.0f);
+        break;
+    default:
+        *temperature = lrintf(raw / 333.87f + 21.0f);
+        break;
+    }
+
+    return true;
+}
+#endif
+
 void mpuGyroInit(gyroDev_t *gyro)
 {
+#ifdef USE_GYRO_TEMP_COMP
+    // the ICM42605 uses this for the interrupt only, its register map is different
+    if (!gyro->temperatureFn && gyro->gyroHardware != GYRO_ICM42605) {
+        gyro->temperatureFn = mpuGyroReadTemperature;
+    }
+#endif
 #ifdef USE_GYRO_EXTI
     mpuIntExtiInit(gyro);
 #else
@@ -376,3 +646,60 @@ uint8_t mpuGyroReadRegister(const busDevice_t *bus, uint8_t reg)
 
 }
 #endif
+
+#ifdef USE_GYRO_ACC_BURST
+static bool mpuAccReadBurst(accDev_t *acc)
+{
+    gyroDev_t *gyro = acc->burstGyro;
+    if (!gyro->accBurstUpdated) {
+        return false;
+    }
+    gyro->accBurstUpdated = false;
+
+    int16_t accADCRaw[XYZ_AXIS_COUNT];
+    if (!seqlockRead(&gyro->accBurstLock, accADCRaw, gyro->accADCRaw, sizeof(accADCRaw))) {
+        return false;
+    }
+
+    acc->ADCRaw[X] = accADCRaw[X];
+    acc->ADCRaw[Y] = accADCRaw[Y];
+    acc->ADCRaw[Z] = accADCRaw[Z];
+
+    return true;
+}
+
+// Moves the acc read into the gyro reads of the same chip, one in denom of them fetches the acc
+// registers as well. Fails if the gyro driver or its mode reads the gyro registers only.
+bool mpuAccBurstReadInit(accDev_t *acc, gyroDev_t *gyro, uint8_t denom)
+{
+    if (acc->bus.bustype != BUSTYPE_SPI || gyro->bus.bustype != BUSTYPE_SPI
+        || acc->bus.busdev_u.spi.csnPin != gyro->bus.busdev_u.spi.csnPin) {
+        return false;
+    }
+
+    bool burstRead = false;
+#ifdef USE_SPI_GYRO
+    burstRead = burstRead || gyro->readFn == mpuGyroReadSPI;
+#endif
+#ifdef USE_GYRO_ISR_READ
+    burstRead = burstRead || gyro->isrRead;
+#endif
+#ifdef USE_GYRO_SPI_ICM42605
+    burstRead = burstRead || gyro->readFn == icm42605GyroReadSPI;
+#endif
+    if (!burstRead) {
+        return false;
+    }
+
+    acc->burstGyro = gyro;
+    acc->readFn = mpuAccReadBurst;
+    gyro->accBurstCount = 0;
+    gyro->accBurstUpdated = false;
+    seqlockInit(&gyro->accBurstLock);
+
+    // set last, the interrupt read may hand on samples from here
+    gyro->accBurstDenom = MAX(denom, 1);
+
+    return true;
+}
+#endif
@@ -136,6 +136,12 @@
 #define MPU_RA_FIFO_COUNTH      0x72
 #define MPU_RA_FIFO_COUNTL      0x73
 #define MPU_RA_FIFO_R_W         0x74
+
+// FIFO_EN / USER_CTRL bits
+#define MPU_BIT_FIFO_GYRO_XYZ   0x70
+#define MPU_BIT_USER_FIFO_EN    0x40
+#define MPU_BIT_USER_FIFO_RST   0x04
+#define MPU_FIFO_SIZE           512
 #define MPU_RA_WHO_AM_I         0x75
 
 // RF = Register Flag
@@ -226,3 +232,9 @@ uint8_t mpuGyroReadRegister(const busDevice_t *bus, uint8_t reg);
 
 struct accDev_s;
 bool mpuAccRead(struct accDev_s *acc);
+#ifdef USE_GYRO_ISR_READ
+bool mpuGyroIsrReadInit(struct gyroDev_s *gyro);
+#endif
+#ifdef USE_GYRO_ACC_BURST
+bool mpuAccBurstReadInit(struct accDev_s *acc, struct gyroDev_s *gyro, uint8_t denom);
+#endif
@@ -250,7 +250,24 @@ void icm42605GyroInit(gyroDev_t *gyro)
 bool icm42605GyroReadSPI(gyroDev_t *gyro)
 {
     static const uint8_t dataToSend[7] = {ICM42605_RA_GYRO_DATA_X1 | 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-    uint8_t data[7];
+    uint8_t data[13];
+
+#ifdef USE_GYRO_ACC_BURST
+    // accel and gyro registers are contiguous
+    if (gyroAccBurstDue(gyro)) {
+        static const uint8_t burstToSend[13] = {ICM42605_RA_ACCEL_DATA_X1 | 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+        if (!spiBusTransfer(&gyro->bus, burstToSend, data, 13)) {
+            return false;
+        }
+        int16_t accADCRaw[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            accADCRaw[axis] = (int16_t)((data[1 + axis * 2] << 8) | data[2 + axis * 2]);
+            gyro->gyroADCRaw[axis] = (int16_t)((data[7 + axis * 2] << 8) | data[8 + axis * 2]);
+        }
+        gyroAccBurstPublish(gyro, accADCRaw);
+        return true;
+    }
+#endif
 
     const bool ack = spiBusTransfer(&gyro->bus, dataToSend, data, 7);
     if (!ack) {
@@ -32,3 +32,4 @@ uint8_t icm42605SpiDetect(const busDevice_t *bus);
 
 bool icm42605SpiAccDetect(accDev_t *acc);
 bool icm42605SpiGyroDetect(gyroDev_t *gyro);
+bool icm42605GyroReadSPI(gyroDev_t *gyro);
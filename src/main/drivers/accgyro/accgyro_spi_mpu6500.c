@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -39,6 +40,13 @@
 
 #define BIT_SLEEP                   0x40
 
+#ifdef USE_GYRO_FIFO
+#define MPU_FIFO_BYTES_PER_SAMPLE   6       // gyro X, Y, Z only
+
+static uint8_t fifoTxBuf[1 + GYRO_FIFO_SAMPLES_MAX * MPU_FIFO_BYTES_PER_SAMPLE];
+static uint8_t fifoRxBuf[1 + GYRO_FIFO_SAMPLES_MAX * MPU_FIFO_BYTES_PER_SAMPLE];
+#endif
+
 static void mpu6500SpiInit(const busDevice_t *bus)
 {
 
@@ -94,10 +102,70 @@ void mpu6500SpiGyroInit(gyroDev_t *gyro)
     spiBusWriteRegister(&gyro->bus, MPU_RA_USER_CTRL, MPU6500_BIT_I2C_IF_DIS);
     delay(100);
 
+#ifdef USE_GYRO_FIFO
+    if (gyro->fifoDecimation > 1) {
+        // queue gyro samples in the FIFO, they are burst read once per loop
+        spiBusWriteRegister(&gyro->bus, MPU_RA_FIFO_EN, 0);
+        spiBusWriteRegister(&gyro->bus, MPU_RA_USER_CTRL, MPU6500_BIT_I2C_IF_DIS | MPU_BIT_USER_FIFO_RST);
+        delay(1);
+        spiBusWriteRegister(&gyro->bus, MPU_RA_FIFO_EN, MPU_BIT_FIFO_GYRO_XYZ);
+        spiBusWriteRegister(&gyro->bus, MPU_RA_USER_CTRL, MPU6500_BIT_I2C_IF_DIS | MPU_BIT_USER_FIFO_EN);
+
+        memset(fifoTxBuf, 0xFF, sizeof(fifoTxBuf));
+        fifoTxBuf[0] = MPU_RA_FIFO_R_W | 0x80;
+        gyro->readFn = mpu6500SpiGyroReadFifo;
+    }
+#endif
+
     spiSetDivisor(gyro->bus.busdev_u.spi.instance, SPI_CLOCK_FAST);
     delayMicroseconds(1);
 }
 
+#ifdef USE_GYRO_FIFO
+// Reads every sample queued since the last call in a single transfer
+bool mpu6500SpiGyroReadFifo(gyroDev_t *gyro)
+{
+    uint8_t count[2];
+
+    gyro->fifoSampleCount = 0;
+
+    if (!spiBusReadRegisterBuffer(&gyro->bus, MPU_RA_FIFO_COUNTH, count, 2)) {
+        return false;
+    }
+
+    const uint16_t fifoBytes = ((count[0] << 8) | count[1]) & 0x1FFF;
+    if (fifoBytes >= MPU_FIFO_SIZE - MPU_FIFO_BYTES_PER_SAMPLE) {
+        // FIFO overflowed and the sample alignment is lost, start over
+        spiBusWriteRegister(&gyro->bus, MPU_RA_USER_CTRL, MPU6500_BIT_I2C_IF_DIS | MPU_BIT_USER_FIFO_EN | MPU_BIT_USER_FIFO_RST);
+        return false;
+    }
+
+    const int samples = MIN(fifoBytes / MPU_FIFO_BYTES_PER_SAMPLE, GYRO_FIFO_SAMPLES_MAX);
+    if (samples == 0) {
+        return false;
+    }
+
+    if (!spiBusTransfer(&gyro->bus, fifoTxBuf, fifoRxBuf, 1 + samples * MPU_FIFO_BYTES_PER_SAMPLE)) {
+        return false;
+    }
+
+    for (int i = 0; i < samples; i++) {
+        const uint8_t *data = &fifoRxBuf[1 + i * MPU_FIFO_BYTES_PER_SAMPLE];
+        gyro->fifoData[i][X] = (int16_t)((data[0] << 8) | data[1]);
+        gyro->fifoData[i][Y] = (int16_t)((data[2] << 8) | data[3]);
+        gyro->fifoData[i][Z] = (int16_t)((data[4] << 8) | data[5]);
+    }
+    gyro->fifoSampleCount = samples;
+
+    // latest sample, the decimated value is computed by the gyro task
+    gyro->gyroADCRaw[X] = gyro->fifoData[samples - 1][X];
+    gyro->gyroADCRaw[Y] = gyro->fifoData[samples - 1][Y];
+    gyro->gyroADCRaw[Z] = gyro->fifoData[samples - 1][Z];
+
+    return true;
+}
+#endif
+
 bool mpu6500SpiAccDetect(accDev_t *acc)
 {
     // MPU6500 is used as a equivalent of other accelerometers by some flight controllers
@@ -138,6 +206,9 @@ bool mpu6500SpiGyroDetect(gyroDev_t *gyro)
 
     gyro->initFn = mpu6500SpiGyroInit;
     gyro->readFn = mpuGyroReadSPI;
+#ifdef USE_GYRO_FIFO
+    gyro->fifoSupported = true;
+#endif
 
     return true;
 }
@@ -29,3 +29,6 @@ bool mpu6500SpiGyroDetect(gyroDev_t *gyro);
 
 void mpu6500SpiGyroInit(gyroDev_t *gyro);
 void mpu6500SpiAccInit(accDev_t *acc);
+#ifdef USE_GYRO_FIFO
+bool mpu6500SpiGyroReadFifo(gyroDev_t *gyro);
+#endif
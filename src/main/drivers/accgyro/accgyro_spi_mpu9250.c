@@ -52,11 +52,13 @@ static void mpu9250AccAndGyroInit(gyroDev_t *gyro);
 
 bool mpu9250SpiWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data)
 {
+    spiBusClaim(bus);
     IOLo(bus->busdev_u.spi.csnPin);
     delayMicroseconds(1);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransferByte(bus->busdev_u.spi.instance, data);
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
     delayMicroseconds(1);
 
     return true;
@@ -64,11 +66,13 @@ bool mpu9250SpiWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data)
 
 static bool mpu9250SpiSlowReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length)
 {
+    spiBusClaim(bus);
     IOLo(bus->busdev_u.spi.csnPin);
     delayMicroseconds(1);
     spiTransferByte(bus->busdev_u.spi.instance, reg | 0x80); // read transaction
     spiTransfer(bus->busdev_u.spi.instance, NULL, data, length);
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
     delayMicroseconds(1);
 
     return true;
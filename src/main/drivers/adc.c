@@ -41,10 +41,11 @@
 adcOperatingConfig_t adcOperatingConfig[ADC_CHANNEL_COUNT];
 
 #if defined(STM32F7)
-volatile FAST_RAM_ZERO_INIT uint16_t adcValues[ADC_CHANNEL_COUNT];
+volatile FAST_RAM_ZERO_INIT uint16_t adcValues[ADC_SCAN_BUFFER_LENGTH(ADC_CHANNEL_COUNT)];
 #else
-volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
+volatile uint16_t adcValues[ADC_SCAN_BUFFER_LENGTH(ADC_CHANNEL_COUNT)];
 #endif
+uint8_t adcScanLength;
 
 uint8_t adcChannelByTag(ioTag_t ioTag)
 {
@@ -80,6 +81,19 @@ ADCDevice adcDeviceByInstance(ADC_TypeDef *instance)
     return ADCINVALID;
 }
 
+static uint16_t adcGetOversampled(uint8_t dmaIndex)
+{
+#if ADC_OVERSAMPLE_SCANS > 1
+    uint32_t sum = 0;
+    for (int scan = 0; scan < ADC_OVERSAMPLE_SCANS; scan++) {
+        sum += adcValues[scan * adcScanLength + dmaIndex];
+    }
+    return (sum + ADC_OVERSAMPLE_SCANS / 2) / ADC_OVERSAMPLE_SCANS;
+#else
+    return adcValues[dmaIndex];
+#endif
+}
+
 uint16_t adcGetChannel(uint8_t channel)
 {
     adcGetChannelValues();
@@ -98,7 +112,7 @@ uint16_t adcGetChannel(uint8_t channel)
         debug[3] = adcValues[adcOperatingConfig[3].dmaIndex];
     }
 #endif
-    return adcValues[adcOperatingConfig[channel].dmaIndex];
+    return adcGetOversampled(adcOperatingConfig[channel].dmaIndex);
 }
 
 // Verify a pin designated by tag has connection to an ADC instance designated by device
@@ -102,3 +102,8 @@ int16_t adcInternalComputeTemperature(uint16_t tempAdcValue, uint16_t vrefValue)
 #if !defined(SIMULATOR_BUILD)
 ADCDevice adcDeviceByInstance(ADC_TypeDef *instance);
 #endif
+
+#ifdef USE_ADC_MOTOR_SYNC
+// Trigger the regular conversions from the update event of the given timer
+bool adcSyncToTimer(TIM_TypeDef *tim);
+#endif
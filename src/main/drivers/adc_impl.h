@@ -89,7 +89,21 @@ extern int32_t adcTSSlopeK;
 extern const adcDevice_t adcHardware[];
 extern const adcTagMap_t adcTagMap[ADC_TAG_MAP_COUNT];
 extern adcOperatingConfig_t adcOperatingConfig[ADC_CHANNEL_COUNT];
-extern volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
+/*
+ * The DMA fills a circular buffer of ADC_OVERSAMPLE_SCANS scans of the configured channels, and adcGetChannel()
+ * returns their average, so a reading is 8x oversampled without any CPU time spent on the conversions.
+ * The H7 oversamples in hardware instead and keeps a single scan.
+ */
+#if defined(STM32H7)
+#define ADC_OVERSAMPLE_SCANS 1
+#elif !defined(ADC_OVERSAMPLE_SCANS)
+#define ADC_OVERSAMPLE_SCANS 8
+#endif
+
+#define ADC_SCAN_BUFFER_LENGTH(channels) ((channels) * ADC_OVERSAMPLE_SCANS)
+
+extern volatile uint16_t adcValues[ADC_SCAN_BUFFER_LENGTH(ADC_CHANNEL_COUNT)];
+extern uint8_t adcScanLength;       // channels in one scan, the stride between scans in adcValues
 
 uint8_t adcChannelByTag(ioTag_t ioTag);
 ADCDevice adcDeviceByInstance(ADC_TypeDef *instance);
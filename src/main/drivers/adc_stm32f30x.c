@@ -30,6 +30,7 @@
 
 #include "drivers/adc_impl.h"
 #include "drivers/dma.h"
+#include "drivers/dma_plan.h"
 #include "drivers/dma_reqmap.h"
 #include "drivers/io.h"
 #include "drivers/rcc.h"
@@ -174,7 +175,7 @@ void adcInit(const adcConfig_t *config)
     RCC_ClockCmd(adc.rccADC, ENABLE);
 
 #if defined(USE_DMA_SPEC)
-    const dmaChannelSpec_t *dmaSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_ADC, device, config->dmaopt[device]);
+    const dmaChannelSpec_t *dmaSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_ADC, device, dmaPlanPeripheralOption(DMA_PERIPH_ADC, device, config->dmaopt[device]));
 
     if (!dmaSpec) {
         return;
@@ -189,13 +190,15 @@ void adcInit(const adcConfig_t *config)
     xDMA_DeInit(adc.dmaResource);
 #endif
 
+    adcScanLength = adcChannelCount;
+
     DMA_StructInit(&DMA_InitStructure);
     DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&adc.ADCx->DR;
     DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)adcValues;
     DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
-    DMA_InitStructure.DMA_BufferSize = adcChannelCount;
+    DMA_InitStructure.DMA_BufferSize = ADC_SCAN_BUFFER_LENGTH(adcChannelCount);
     DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
-    DMA_InitStructure.DMA_MemoryInc = adcChannelCount > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = ADC_SCAN_BUFFER_LENGTH(adcChannelCount) > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
     DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
     DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
     DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
@@ -28,6 +28,7 @@
 
 #include "build/debug.h"
 
+#include "drivers/dma_plan.h"
 #include "drivers/dma_reqmap.h"
 
 #include "drivers/io.h"
@@ -129,6 +130,8 @@ const adcTagMap_t adcTagMap[] = {
 #define TS_CAL1_ADDR      0x1FFF7A2C
 #define TS_CAL2_ADDR      0x1FFF7A2E
 
+static ADC_TypeDef *adcRegularInstance;
+
 void adcInitDevice(ADC_TypeDef *adcdev, int channelCount)
 {
     ADC_InitTypeDef ADC_InitStructure;
@@ -302,7 +305,7 @@ void adcInit(const adcConfig_t *config)
     ADC_Cmd(adc.ADCx, ENABLE);
 
 #ifdef USE_DMA_SPEC
-    const dmaChannelSpec_t *dmaSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_ADC, device, config->dmaopt[device]);
+    const dmaChannelSpec_t *dmaSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_ADC, device, dmaPlanPeripheralOption(DMA_PERIPH_ADC, device, config->dmaopt[device]));
 
     if (!dmaSpec) {
         return;
@@ -319,6 +322,8 @@ void adcInit(const adcConfig_t *config)
 
     DMA_InitTypeDef DMA_InitStructure;
 
+    adcScanLength = configuredAdcChannels;
+
     DMA_StructInit(&DMA_InitStructure);
     DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&adc.ADCx->DR;
 
@@ -330,9 +335,9 @@ void adcInit(const adcConfig_t *config)
 
     DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)adcValues;
     DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
-    DMA_InitStructure.DMA_BufferSize = configuredAdcChannels;
+    DMA_InitStructure.DMA_BufferSize = ADC_SCAN_BUFFER_LENGTH(configuredAdcChannels);
     DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
-    DMA_InitStructure.DMA_MemoryInc = configuredAdcChannels > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = ADC_SCAN_BUFFER_LENGTH(configuredAdcChannels) > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
     DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
     DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
     DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
@@ -346,9 +351,40 @@ void adcInit(const adcConfig_t *config)
     xDMA_Cmd(adc.dmaResource, ENABLE);
 #endif
 
+    adcRegularInstance = adc.ADCx;
+
     ADC_SoftwareStartConv(adc.ADCx);
 }
 
+#ifdef USE_ADC_MOTOR_SYNC
+bool adcSyncToTimer(TIM_TypeDef *tim)
+{
+    uint32_t trigger;
+
+    if (tim == TIM2) {
+        trigger = ADC_ExternalTrigConv_T2_TRGO;
+    } else if (tim == TIM3) {
+        trigger = ADC_ExternalTrigConv_T3_TRGO;
+    } else if (tim == TIM8) {
+        trigger = ADC_ExternalTrigConv_T8_TRGO;
+    } else {
+        return false;
+    }
+
+    if (!adcRegularInstance) {
+        return false;
+    }
+
+    // Timer update event on TRGO
+    tim->CR2 = (tim->CR2 & ~TIM_CR2_MMS) | TIM_TRGOSource_Update;
+
+    // Clearing CONT lets the scan in progress complete, so the DMA stays aligned to the sequence
+    adcRegularInstance->CR2 = (adcRegularInstance->CR2 & ~(ADC_CR2_CONT | ADC_CR2_EXTSEL | ADC_CR2_EXTEN)) | trigger | ADC_ExternalTrigConvEdge_Rising;
+
+    return true;
+}
+#endif
+
 void adcGetChannelValues(void)
 {
     // Nothing to do
@@ -27,6 +27,7 @@
 #ifdef USE_ADC
 
 #include "drivers/dma.h"
+#include "drivers/dma_plan.h"
 #include "drivers/dma_reqmap.h"
 #include "drivers/io.h"
 #include "drivers/io_impl.h"
@@ -124,6 +125,7 @@ void adcInitDevice(adcDevice_t *adcdev, int channelCount)
 }
 
 static adcDevice_t adc;
+static bool adcRegularActive;
 
 #ifdef USE_ADC_INTERNAL
 
@@ -286,7 +288,7 @@ void adcInit(const adcConfig_t *config)
     }
 
 #ifdef USE_DMA_SPEC
-    const dmaChannelSpec_t *dmaspec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_ADC, device, config->dmaopt[device]);
+    const dmaChannelSpec_t *dmaspec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_ADC, device, dmaPlanPeripheralOption(DMA_PERIPH_ADC, device, config->dmaopt[device]));
 
     if (!dmaspec) {
         return;
@@ -303,7 +305,7 @@ void adcInit(const adcConfig_t *config)
 
     adc.DmaHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
     adc.DmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
-    adc.DmaHandle.Init.MemInc = configuredAdcChannels > 1 ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
+    adc.DmaHandle.Init.MemInc = ADC_SCAN_BUFFER_LENGTH(configuredAdcChannels) > 1 ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
     adc.DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.Mode = DMA_CIRCULAR;
@@ -323,11 +325,50 @@ void adcInit(const adcConfig_t *config)
 
     //HAL_CLEANINVALIDATECACHE((uint32_t*)&adcValues, configuredAdcChannels);
 
-    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, configuredAdcChannels) != HAL_OK)
+    adcScanLength = configuredAdcChannels;
+
+    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, ADC_SCAN_BUFFER_LENGTH(configuredAdcChannels)) != HAL_OK)
     {
         /* Start Conversion Error */
+        return;
+    }
+
+    adcRegularActive = true;
+}
+
+#ifdef USE_ADC_MOTOR_SYNC
+bool adcSyncToTimer(TIM_TypeDef *tim)
+{
+    uint32_t trigger;
+
+    if (tim == TIM1) {
+        trigger = ADC_EXTERNALTRIGCONV_T1_TRGO;
+    } else if (tim == TIM2) {
+        trigger = ADC_EXTERNALTRIGCONV_T2_TRGO;
+    } else if (tim == TIM4) {
+        trigger = ADC_EXTERNALTRIGCONV_T4_TRGO;
+    } else if (tim == TIM5) {
+        trigger = ADC_EXTERNALTRIGCONV_T5_TRGO;
+    } else if (tim == TIM8) {
+        trigger = ADC_EXTERNALTRIGCONV_T8_TRGO;
+    } else {
+        return false;
+    }
+
+    if (!adcRegularActive) {
+        return false;
     }
+
+    // Timer update event on TRGO
+    tim->CR2 = (tim->CR2 & ~TIM_CR2_MMS) | TIM_TRGO_UPDATE;
+
+    // Clearing CONT lets the scan in progress complete, so the DMA stays aligned to the sequence
+    ADC_TypeDef *adcx = adc.ADCHandle.Instance;
+    adcx->CR2 = (adcx->CR2 & ~(ADC_CR2_CONT | ADC_CR2_EXTSEL | ADC_CR2_EXTEN)) | trigger | ADC_EXTERNALTRIGCONVEDGE_RISING;
+
+    return true;
 }
+#endif
 
 void adcGetChannelValues(void)
 {
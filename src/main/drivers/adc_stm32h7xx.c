@@ -28,6 +28,8 @@
 
 #include "build/debug.h"
 
+#include "drivers/dma_buffer.h"
+#include "drivers/dma_plan.h"
 #include "drivers/dma_reqmap.h"
 #include "drivers/io.h"
 #include "drivers/io_impl.h"
@@ -193,7 +195,12 @@ void adcInitDevice(adcDevice_t *adcdev, int channelCount)
     hadc->Init.ExternalTrigConvEdge     = ADC_EXTERNALTRIGCONVEDGE_NONE; // Don't care
     hadc->Init.ConversionDataManagement = ADC_CONVERSIONDATA_DMA_CIRCULAR;
     hadc->Init.Overrun                  = ADC_OVR_DATA_OVERWRITTEN;
-    hadc->Init.OversamplingMode         = DISABLE;
+    // 16x hardware oversampling, shifted back to 12 bits
+    hadc->Init.OversamplingMode         = ENABLE;
+    hadc->Init.Oversampling.Ratio       = ADC_OVERSAMPLING_RATIO_16;
+    hadc->Init.Oversampling.RightBitShift = ADC_RIGHTBITSHIFT_4;
+    hadc->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    hadc->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
 
     // Initialize this ADC peripheral
 
@@ -230,10 +237,15 @@ void adcInitCalibrationValues(void)
 // Need this separate from the main adcValue[] array, because channels are numbered
 // by ADC instance order that is different from ADC_xxx numbering.
 
-static volatile DMA_RAM uint16_t adcConversionBuffer[ADC_CHANNEL_COUNT] __attribute__((aligned(32)));
+static volatile uint16_t *adcConversionBuffer;
 
 void adcInit(const adcConfig_t *config)
 {
+    adcConversionBuffer = dmaBufferAllocate(sizeof(uint16_t) * ADC_CHANNEL_COUNT);
+    if (!adcConversionBuffer) {
+        return;
+    }
+
     memset(adcOperatingConfig, 0, sizeof(adcOperatingConfig));
     memcpy(adcDevice, adcHardware, sizeof(adcDevice));
 
@@ -378,7 +390,7 @@ void adcInit(const adcConfig_t *config)
 
         dmaIdentifier_e dmaIdentifier;
 #ifdef USE_DMA_SPEC
-        const dmaChannelSpec_t *dmaSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_ADC, dev, config->dmaopt[dev]);
+        const dmaChannelSpec_t *dmaSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_ADC, dev, dmaPlanPeripheralOption(DMA_PERIPH_ADC, dev, config->dmaopt[dev]));
 
         if (!dmaSpec) {
             return;
@@ -450,7 +462,13 @@ void adcInit(const adcConfig_t *config)
 void adcGetChannelValues(void)
 {
     // Transfer values in conversion buffer into adcValues[]
-    // Cache coherency should be maintained by MPU facility
+    // The buffer is in write-through D2 SRAM, its cache lines are never dirty and can always be invalidated
+
+    if (!adcConversionBuffer) {
+        return;
+    }
+
+    dmaCacheInvalidate(adcConversionBuffer, sizeof(uint16_t) * ADC_CHANNEL_COUNT);
 
     for (int i = 0; i < ADC_CHANNEL_INTERNAL; i++) {
         adcValues[i] = adcConversionBuffer[adcOperatingConfig[i].dmaIndex];
@@ -471,8 +489,14 @@ void adcInternalStartConversion(void)
 
 uint16_t adcInternalRead(int channel)
 {
+    if (!adcConversionBuffer) {
+        return 0;
+    }
+
     int dmaIndex = adcOperatingConfig[channel].dmaIndex;
 
+    dmaCacheInvalidate(&adcConversionBuffer[dmaIndex], sizeof(uint16_t));
+
     return adcConversionBuffer[dmaIndex];
 }
 
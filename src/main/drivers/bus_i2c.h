@@ -65,3 +65,36 @@ bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t*
 bool i2cBusy(I2CDevice device, bool *error);
 
 uint16_t i2cGetErrorCounter(void);
+
+//
+// Transaction queue
+//
+
+struct busDevice_s;
+
+// One register access, with its own start and stop condition
+typedef struct i2cSegment_s {
+    uint8_t reg;                // 0xFF for devices without register addressing
+    uint8_t *data;
+    uint8_t len;                // a zero length segment ends the sequence
+    bool read;
+} i2cSegment_t;
+
+struct i2cSequence_s;
+typedef void (*i2cSequenceCallbackFn)(struct i2cSequence_s *sequence);
+
+typedef struct i2cSequence_s {
+    const struct busDevice_s *bus;
+    const i2cSegment_t *segments;
+    i2cSequenceCallbackFn callback; // run once the segments are done, may be from an interrupt
+    volatile bool pending;
+    volatile bool error;            // a segment failed or timed out, the rest were skipped
+    struct i2cSequence_s *next;
+} i2cSequence_t;
+
+// A segment still unfinished after this long is abandoned and the bus reinitialised
+#define I2C_SEQUENCE_TIMEOUT_US     20000
+
+bool i2cSequenceStart(i2cSequence_t *sequence);
+bool i2cSequenceIsPending(const i2cSequence_t *sequence);
+void i2cSequenceWait(const i2cSequence_t *sequence);
@@ -26,44 +26,370 @@
 
 #if defined(USE_I2C)
 
+#include "build/atomic.h"
+
+#include "common/time.h"
+
 #include "drivers/bus.h"
 #include "drivers/bus_i2c.h"
+#include "drivers/bus_i2c_impl.h"
+#include "drivers/nvic.h"
+#include "drivers/time.h"
 
-bool i2cBusWriteRegister(const busDevice_t *busdev, uint8_t reg, uint8_t data)
+/*
+ * Transaction queue
+ *
+ * Each bus runs its sequences in FIFO order, one segment per transfer. The interrupt
+ * driven drivers report the end of a transfer from their completion interrupt, which
+ * starts the next segment straight away, so no task waits for the bus. The others
+ * finish the transfer before returning and the queue runs in the caller's context.
+ * A transfer the driver refuses, because a direct user of the i2cRead()/i2cWrite()
+ * API holds the bus, is retried whenever the sequence is polled.
+ */
+typedef struct i2cQueue_s {
+    i2cSequence_t *head;                // in progress, the rest follow through next
+    i2cSequence_t *tail;
+    const i2cSegment_t *segment;        // of the head sequence
+    timeUs_t segmentStartUs;            // when the segment became current
+    volatile bool started;              // handed to the driver, awaiting its completion
+    bool owned;                         // a context is starting transfers or recovering the bus
+} i2cQueue_t;
+
+static i2cQueue_t i2cQueue[I2CDEV_COUNT];
+
+static I2CDevice i2cSequenceDevice(const i2cSequence_t *sequence)
 {
-    return i2cWrite(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, data);
+    const I2CDevice device = sequence->bus->busdev_u.i2c.device;
+    return (device >= I2CDEV_1 && device < I2CDEV_COUNT) ? device : I2CINVALID;
 }
 
-bool i2cBusWriteRegisterStart(const busDevice_t *busdev, uint8_t reg, uint8_t data)
+// With interrupts masked, returns the sequence if that was its last segment
+static i2cSequence_t *i2cFinishSegment(i2cQueue_t *queue, bool error)
+{
+    i2cSequence_t *sequence = queue->head;
+
+    queue->started = false;
+    queue->segment++;
+    queue->segmentStartUs = micros();
+
+    if (!error && queue->segment->len) {
+        return NULL;
+    }
+
+    queue->head = sequence->next;
+    if (!queue->head) {
+        queue->tail = NULL;
+    }
+    queue->segment = queue->head ? queue->head->segments : NULL;
+
+    sequence->error = error;
+
+    return sequence;
+}
+
+static void i2cCompleteSequence(i2cSequence_t *sequence)
+{
+    sequence->pending = false;
+    if (sequence->callback) {
+        sequence->callback(sequence);
+    }
+}
+
+static bool i2cStartTransfer(const i2cSequence_t *sequence, const i2cSegment_t *segment)
 {
-    // Need a static value, not on the stack
-    static uint8_t byte;
+    const I2CDevice device = sequence->bus->busdev_u.i2c.device;
+    const uint8_t address = sequence->bus->busdev_u.i2c.address;
 
-    byte = data;
+    if (segment->read) {
+        return i2cReadBuffer(device, address, segment->reg, segment->len, segment->data);
+    }
 
-    return i2cWriteBuffer(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, sizeof (byte), &byte);
+    return i2cWriteBuffer(device, address, segment->reg, segment->len, segment->data);
+}
+
+// Hand segments to the driver until one is in flight or the queue is empty
+static void i2cRunQueue(I2CDevice device)
+{
+    i2cQueue_t *queue = &i2cQueue[device];
+    bool owner = false;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (!queue->owned) {
+            queue->owned = owner = true;
+        }
+    }
+    if (!owner) {
+        // The owner picks up whatever this caller queued or completed
+        return;
+    }
+
+    for (;;) {
+        const i2cSequence_t *sequence = NULL;
+        const i2cSegment_t *segment = NULL;
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            if (queue->head && !queue->started) {
+                sequence = queue->head;
+                segment = queue->segment;
+                queue->started = true;
+            } else {
+                queue->owned = false;
+            }
+        }
+        if (!segment) {
+            return;
+        }
+
+        const bool accepted = i2cStartTransfer(sequence, segment);
+
+#ifdef USE_I2C_ASYNC_TRANSFER
+        if (!accepted) {
+            // Bus held outside the queue, retry on the next poll
+            ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+                queue->started = false;
+                queue->owned = false;
+            }
+            return;
+        }
+#else
+        i2cSequenceTransferDone(device, !accepted);
+#endif
+    }
+}
+
+// From the driver once the transfer started by the queue is over
+void i2cSequenceTransferDone(I2CDevice device, bool error)
+{
+    i2cQueue_t *queue = &i2cQueue[device];
+    i2cSequence_t *sequence = NULL;
+    bool finished = false;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (queue->started) {
+            sequence = i2cFinishSegment(queue, error);
+            finished = true;
+        }
+    }
+    if (!finished) {
+        // A transfer of a direct API user, or one abandoned on timeout
+        return;
+    }
+
+    if (sequence) {
+        i2cCompleteSequence(sequence);
+    }
+
+    i2cRunQueue(device);
+}
+
+// Recover a stuck bus and retry refused transfers, from the polling context
+static void i2cServiceQueue(I2CDevice device)
+{
+    i2cQueue_t *queue = &i2cQueue[device];
+    bool timedOut = false;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (!queue->owned && queue->head && cmpTimeUs(micros(), queue->segmentStartUs) > I2C_SEQUENCE_TIMEOUT_US) {
+            // Completions of the abandoned transfer are ignored from here on
+            queue->owned = timedOut = true;
+            queue->started = false;
+        }
+    }
+
+    if (timedOut) {
+        i2cInit(device);
+
+        i2cSequence_t *sequence;
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            sequence = i2cFinishSegment(queue, true);
+            queue->owned = false;
+        }
+        i2cCompleteSequence(sequence);
+    }
+
+    i2cRunQueue(device);
+}
+
+// Queue a sequence behind the others on its bus, false if it is still pending
+bool i2cSequenceStart(i2cSequence_t *sequence)
+{
+    const I2CDevice device = i2cSequenceDevice(sequence);
+    if (device == I2CINVALID || sequence->pending || !sequence->segments->len) {
+        return false;
+    }
+
+#ifdef USE_I2C_ASYNC_TRANSFER
+    if (!i2cDevice[device].hardware) {
+        // Would be refused until the timeout
+        return false;
+    }
+#endif
+
+    i2cQueue_t *queue = &i2cQueue[device];
+
+    sequence->next = NULL;
+    sequence->error = false;
+    sequence->pending = true;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (queue->tail) {
+            queue->tail->next = sequence;
+        } else {
+            queue->head = sequence;
+            queue->segment = sequence->segments;
+            queue->segmentStartUs = micros();
+        }
+        queue->tail = sequence;
+    }
+
+    i2cRunQueue(device);
+
+    return true;
+}
+
+bool i2cSequenceIsPending(const i2cSequence_t *sequence)
+{
+    if (sequence->pending) {
+        i2cServiceQueue(i2cSequenceDevice(sequence));
+    }
+
+    return sequence->pending;
+}
+
+// Only from a context that cannot have preempted the transfer completion interrupt
+void i2cSequenceWait(const i2cSequence_t *sequence)
+{
+    while (i2cSequenceIsPending(sequence));
+}
+
+//
+// BusDevice API
+//
+
+static bool i2cBusTransfer(const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length, bool read)
+{
+    const i2cSegment_t segments[] = {
+        { .reg = reg, .data = data, .len = length, .read = read },
+        { .len = 0 },
+    };
+    i2cSequence_t sequence = {
+        .bus = busdev,
+        .segments = segments,
+    };
+
+    if (!i2cSequenceStart(&sequence)) {
+        return false;
+    }
+
+    i2cSequenceWait(&sequence);
+
+    return !sequence.error;
+}
+
+bool i2cBusWriteRegister(const busDevice_t *busdev, uint8_t reg, uint8_t data)
+{
+    return i2cBusTransfer(busdev, reg, &data, sizeof(data), false);
 }
 
 bool i2cBusReadRegisterBuffer(const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length)
 {
-    return i2cRead(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, length, data);
+    return i2cBusTransfer(busdev, reg, data, length, true);
 }
 
 uint8_t i2cBusReadRegister(const busDevice_t *busdev, uint8_t reg)
 {
-    uint8_t data;
-    i2cRead(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, 1, &data);
+    uint8_t data = 0;
+    i2cBusTransfer(busdev, reg, &data, sizeof(data), true);
     return data;
 }
 
+#define I2C_BUSDEV_SLOT_COUNT   4
+
+// The transfer a device started without waiting, polled through i2cBusBusy()
+typedef struct i2cBusdevSlot_s {
+    bool used;
+    I2CDevice device;
+    uint8_t address;
+    uint8_t byte;                       // of a register write, the caller's is on the stack
+    i2cSegment_t segments[2];
+    i2cSequence_t sequence;
+} i2cBusdevSlot_t;
+
+static i2cBusdevSlot_t i2cBusdevSlot[I2C_BUSDEV_SLOT_COUNT];
+
+static i2cBusdevSlot_t *i2cBusdevGetSlot(const busDevice_t *busdev, bool allocate)
+{
+    for (int i = 0; i < I2C_BUSDEV_SLOT_COUNT; i++) {
+        i2cBusdevSlot_t *slot = &i2cBusdevSlot[i];
+        if (slot->used && slot->device == busdev->busdev_u.i2c.device && slot->address == busdev->busdev_u.i2c.address) {
+            return slot;
+        }
+    }
+
+    if (allocate) {
+        for (int i = 0; i < I2C_BUSDEV_SLOT_COUNT; i++) {
+            i2cBusdevSlot_t *slot = &i2cBusdevSlot[i];
+            if (!slot->used) {
+                slot->used = true;
+                slot->device = busdev->busdev_u.i2c.device;
+                slot->address = busdev->busdev_u.i2c.address;
+                return slot;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// Slot of a device without a transfer outstanding
+static i2cBusdevSlot_t *i2cBusdevIdleSlot(const busDevice_t *busdev)
+{
+    i2cBusdevSlot_t *slot = i2cBusdevGetSlot(busdev, true);
+    return (slot && !slot->sequence.pending) ? slot : NULL;
+}
+
+static bool i2cBusdevSlotStart(i2cBusdevSlot_t *slot, const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length, bool read)
+{
+    slot->segments[0] = (i2cSegment_t) { .reg = reg, .data = data, .len = length, .read = read };
+    slot->segments[1].len = 0;
+    slot->sequence.bus = busdev;
+    slot->sequence.segments = slot->segments;
+
+    return i2cSequenceStart(&slot->sequence);
+}
+
+bool i2cBusWriteRegisterStart(const busDevice_t *busdev, uint8_t reg, uint8_t data)
+{
+    i2cBusdevSlot_t *slot = i2cBusdevIdleSlot(busdev);
+    if (!slot) {
+        return false;
+    }
+
+    slot->byte = data;
+
+    return i2cBusdevSlotStart(slot, busdev, reg, &slot->byte, sizeof(slot->byte), false);
+}
+
 bool i2cBusReadRegisterBufferStart(const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length)
 {
-    return i2cReadBuffer(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, length, data);
+    i2cBusdevSlot_t *slot = i2cBusdevIdleSlot(busdev);
+    if (!slot) {
+        return false;
+    }
+
+    return i2cBusdevSlotStart(slot, busdev, reg, data, length, true);
 }
 
+// True while the transfer this device started is queued or in flight
 bool i2cBusBusy(const busDevice_t *busdev, bool *error)
 {
-    return i2cBusy(busdev->busdev_u.i2c.device, error);
+    const i2cBusdevSlot_t *slot = i2cBusdevGetSlot(busdev, false);
+    const bool busy = slot && i2cSequenceIsPending(&slot->sequence);
+
+    if (error) {
+        *error = slot && slot->sequence.error;
+    }
+
+    return busy;
 }
 
 #endif
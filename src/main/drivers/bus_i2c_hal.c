@@ -251,7 +251,10 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
 
     HAL_StatusTypeDef status;
 
-    status = HAL_I2C_Mem_Write_IT(pHandle ,addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT,data, len_);
+    if (reg_ == 0xFF)
+        status = HAL_I2C_Master_Transmit_IT(pHandle ,addr_ << 1, data, len_);
+    else
+        status = HAL_I2C_Mem_Write_IT(pHandle ,addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT,data, len_);
 
     if (status == HAL_BUSY) {
         return false;
@@ -307,7 +310,10 @@ bool i2cReadBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, u
 
     HAL_StatusTypeDef status;
 
-    status = HAL_I2C_Mem_Read_IT(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT,buf, len);
+    if (reg_ == 0xFF)
+        status = HAL_I2C_Master_Receive_IT(pHandle ,addr_ << 1, buf, len);
+    else
+        status = HAL_I2C_Mem_Read_IT(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT,buf, len);
 
     if (status == HAL_BUSY) {
         return false;
@@ -320,6 +326,44 @@ bool i2cReadBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, u
     return true;
 }
 
+// HAL completion callbacks of the non-blocking transfers, from the EV and ER interrupts
+
+static void i2cTransferDone(I2C_HandleTypeDef *pHandle, bool error)
+{
+    for (int device = 0; device < I2CDEV_COUNT; device++) {
+        if (pHandle == &i2cDevice[device].handle) {
+            i2cSequenceTransferDone(device, error);
+            return;
+        }
+    }
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferDone(pHandle, false);
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferDone(pHandle, false);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferDone(pHandle, false);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cTransferDone(pHandle, false);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *pHandle)
+{
+    i2cErrorCount++;
+    i2cTransferDone(pHandle, true);
+}
+
 bool i2cBusy(I2CDevice device, bool *error)
 {
     I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
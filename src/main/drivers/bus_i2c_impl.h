@@ -96,3 +96,10 @@ typedef struct i2cDevice_s {
 } i2cDevice_t;
 
 extern i2cDevice_t i2cDevice[];
+
+// Drivers that finish transfers in their interrupt handlers report each one to the queue
+#if !defined(SOFT_I2C) && (defined(STM32F1) || defined(STM32F4) || defined(USE_HAL_DRIVER))
+#define USE_I2C_ASYNC_TRANSFER
+#endif
+
+void i2cSequenceTransferDone(I2CDevice device, bool error);
@@ -119,6 +119,11 @@ bool quadSpiTransmitWithAddress1LINE(QUADSPI_TypeDef *instance, uint8_t instruct
 
 bool quadSpiInstructionWithAddress1LINE(QUADSPI_TypeDef *instance, uint8_t instruction, uint8_t dummyCycles, uint32_t address, uint8_t addressSize);
 
+// Memory mapped reads, the flash is read with the given instruction at the offset of the access into the returned window.
+// No other command can be sent until the memory mapped mode is disabled.
+const uint8_t *quadSpiEnableMemoryMapped4LINES(QUADSPI_TypeDef *instance, uint8_t instruction, uint8_t dummyCycles, uint8_t addressSize);
+void quadSpiDisableMemoryMapped(QUADSPI_TypeDef *instance);
+
 //bool quadSpiIsBusBusy(SPI_TypeDef *instance);
 
 uint16_t quadSpiGetErrorCounter(QUADSPI_TypeDef *instance);
@@ -32,6 +32,7 @@
 #include "dma.h"
 #include "io.h"
 #include "io_impl.h"
+#include "memprot.h"
 #include "nvic.h"
 #include "rcc.h"
 
@@ -440,6 +441,56 @@ bool quadSpiInstructionWithAddress1LINE(QUADSPI_TypeDef *instance, uint8_t instr
     return true;
 }
 
+const uint8_t *quadSpiEnableMemoryMapped4LINES(QUADSPI_TypeDef *instance, uint8_t instruction, uint8_t dummyCycles, uint8_t addressSize)
+{
+    QUADSPIDevice device = quadSpiDeviceByInstance(instance);
+    HAL_StatusTypeDef status;
+
+    QSPI_CommandTypeDef cmd;
+    cmd.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+    cmd.AddressMode       = QSPI_ADDRESS_1_LINE;
+    cmd.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+    cmd.DataMode          = QSPI_DATA_4_LINES;
+    cmd.DummyCycles       = dummyCycles;
+    cmd.DdrMode           = QSPI_DDR_MODE_DISABLE;
+    cmd.DdrHoldHalfCycle  = QSPI_DDR_HHC_ANALOG_DELAY;
+    cmd.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+
+    cmd.Instruction       = instruction;
+    cmd.AddressSize       = quadSpi_addressSizeFromValue(addressSize);
+
+    // CS stays low until the mode is disabled, the access sequence is ended by the abort
+    QSPI_MemoryMappedTypeDef mapped;
+    mapped.TimeOutActivation = QSPI_TIMEOUT_COUNTER_DISABLE;
+    mapped.TimeOutPeriod     = 0;
+
+    quadSpiSelectDevice(instance);
+
+    status = HAL_QSPI_MemoryMapped(&quadSpiDevice[device].hquadSpi, &cmd, &mapped);
+
+    if (status != HAL_OK) {
+        quadSpiDeselectDevice(instance);
+        quadSpiTimeoutUserCallback(instance);
+        return NULL;
+    }
+
+    memProtSetQuadSpiMapped(true);
+
+    return (const uint8_t *)QSPI_BASE;
+}
+
+void quadSpiDisableMemoryMapped(QUADSPI_TypeDef *instance)
+{
+    QUADSPIDevice device = quadSpiDeviceByInstance(instance);
+
+    if (quadSpiDevice[device].hquadSpi.State == HAL_QSPI_STATE_BUSY_MEM_MAPPED) {
+        // Closed before the abort, no access of the window may reach the QSPI in indirect mode
+        memProtSetQuadSpiMapped(false);
+        HAL_QSPI_Abort(&quadSpiDevice[device].hquadSpi);
+        quadSpiDeselectDevice(instance);
+    }
+}
+
 bool quadSpiInstructionWithData1LINE(QUADSPI_TypeDef *instance, uint8_t instruction, uint8_t dummyCycles, const uint8_t *out, int length)
 {
     QUADSPIDevice device = quadSpiDeviceByInstance(instance);
@@ -26,11 +26,14 @@
 
 #ifdef USE_SPI
 
+#include "build/atomic.h"
+
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
 #include "drivers/bus_spi_impl.h"
 #include "drivers/exti.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 #include "drivers/rcc.h"
 
 spiDevice_t spiDevice[SPIDEV_COUNT];
@@ -136,11 +139,141 @@ uint32_t spiTimeoutUserCallback(SPI_TypeDef *instance)
     return spiDevice[device].errorCount;
 }
 
+/*
+ * Bus arbitration
+ *
+ * Blocking users claim the bus around each chip select period. A sequence started
+ * while the bus is claimed, typically from an interrupt that preempted a blocking
+ * user, is queued and run by that user when it releases the bus. A sequence started
+ * on a free bus runs straight away in the caller's context.
+ */
+static spiDevice_t *spiBusController(const busDevice_t *bus)
+{
+    const SPIDevice device = spiDeviceByInstance(bus->busdev_u.spi.instance);
+    return (device == SPIINVALID) ? NULL : &spiDevice[device];
+}
+
+static void spiRunSegments(const spiSequence_t *sequence)
+{
+    const busDevice_t *bus = sequence->bus;
+    bool csAsserted = false;
+
+    for (const busSegment_t *segment = sequence->segments; segment->len; segment++) {
+        if (!csAsserted) {
+            IOLo(bus->busdev_u.spi.csnPin);
+            csAsserted = true;
+        }
+        spiTransfer(bus->busdev_u.spi.instance, segment->txData, segment->rxData, segment->len);
+        if (segment->negateCS) {
+            IOHi(bus->busdev_u.spi.csnPin);
+            csAsserted = false;
+        }
+    }
+
+    if (csAsserted) {
+        IOHi(bus->busdev_u.spi.csnPin);
+    }
+}
+
+// Drain the queue while nobody holds the bus, from whichever context freed it
+static void spiRunQueue(spiDevice_t *spi)
+{
+    for (;;) {
+        spiSequence_t *sequence = NULL;
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            if (spi->claimCount == 0 && spi->queue) {
+                sequence = spi->queue;
+                spi->queue = sequence->next;
+                spi->claimCount++;
+            }
+        }
+        if (!sequence) {
+            return;
+        }
+
+        spiRunSegments(sequence);
+
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            spi->claimCount--;
+        }
+        sequence->pending = false;
+        if (sequence->callback) {
+            sequence->callback(sequence);
+        }
+    }
+}
+
+void spiBusClaim(const busDevice_t *bus)
+{
+    spiDevice_t *spi = spiBusController(bus);
+    if (spi) {
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            spi->claimCount++;
+        }
+    }
+}
+
+void spiBusRelease(const busDevice_t *bus)
+{
+    spiDevice_t *spi = spiBusController(bus);
+    if (spi) {
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            spi->claimCount--;
+        }
+        if (spi->queue) {
+            spiRunQueue(spi);
+        }
+    }
+}
+
+// Queue a sequence behind those of equal or higher priority, false if it is still pending
+bool spiSequenceStart(spiSequence_t *sequence)
+{
+    spiDevice_t *spi = spiBusController(sequence->bus);
+    if (!spi || sequence->pending) {
+        return false;
+    }
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        spiSequence_t *volatile *link = &spi->queue;
+        while (*link && (*link)->priority >= sequence->priority) {
+            link = &(*link)->next;
+        }
+        sequence->next = *link;
+        sequence->pending = true;
+        *link = sequence;
+    }
+
+    spiRunQueue(spi);
+
+    return true;
+}
+
+bool spiSequenceIsPending(const spiSequence_t *sequence)
+{
+    return sequence->pending;
+}
+
+// Only from a context that cannot have preempted the bus holder, ie. not from an interrupt
+void spiSequenceWait(const spiSequence_t *sequence)
+{
+    while (sequence->pending);
+}
+
+// True while a sequence waits for the bus, bulk users release between chunks when it is
+bool spiBusIsContended(const busDevice_t *bus)
+{
+    const spiDevice_t *spi = spiBusController(bus);
+    return spi && spi->queue;
+}
+
 bool spiBusTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int length)
 {
+    spiBusClaim(bus);
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransfer(bus->busdev_u.spi.instance, txData, rxData, length);
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
     return true;
 }
 
@@ -173,9 +306,11 @@ uint8_t spiBusTransferByte(const busDevice_t *bus, uint8_t data)
 
 void spiBusWriteByte(const busDevice_t *bus, uint8_t data)
 {
+    spiBusClaim(bus);
     IOLo(bus->busdev_u.spi.csnPin);
     spiBusTransferByte(bus, data);
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
 }
 
 bool spiBusRawTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int len)
@@ -185,20 +320,24 @@ bool spiBusRawTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *r
 
 bool spiBusWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data)
 {
+    spiBusClaim(bus);
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransferByte(bus->busdev_u.spi.instance, data);
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
 
     return true;
 }
 
 bool spiBusRawReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length)
 {
+    spiBusClaim(bus);
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransfer(bus->busdev_u.spi.instance, NULL, data, length);
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
 
     return true;
 }
@@ -210,19 +349,23 @@ bool spiBusReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data
 
 void spiBusWriteRegisterBuffer(const busDevice_t *bus, uint8_t reg, const uint8_t *data, uint8_t length)
 {
+    spiBusClaim(bus);
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransfer(bus->busdev_u.spi.instance, data, NULL, length);
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
 }
 
 uint8_t spiBusRawReadRegister(const busDevice_t *bus, uint8_t reg)
 {
     uint8_t data;
+    spiBusClaim(bus);
     IOLo(bus->busdev_u.spi.csnPin);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransfer(bus->busdev_u.spi.instance, NULL, &data, 1);
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
 
     return data;
 }
@@ -249,6 +392,7 @@ void spiBusSetDivisor(busDevice_t *bus, uint16_t divisor)
 
 void spiBusTransactionBegin(const busDevice_t *bus)
 {
+    spiBusClaim(bus);
     spiBusTransactionSetup(bus);
     IOLo(bus->busdev_u.spi.csnPin);
 }
@@ -256,6 +400,7 @@ void spiBusTransactionBegin(const busDevice_t *bus)
 void spiBusTransactionEnd(const busDevice_t *bus)
 {
     IOHi(bus->busdev_u.spi.csnPin);
+    spiBusRelease(bus);
 }
 
 bool spiBusTransactionTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int length)
@@ -113,6 +113,36 @@ typedef enum SPIDevice {
 
 #endif
 
+// Sequences queued on a claimed bus run in priority order, FIFO within a priority
+typedef enum {
+    SPI_PRIORITY_LOW = 0,       // bulk transfers, OSD and flash
+    SPI_PRIORITY_NORMAL,
+    SPI_PRIORITY_HIGH,          // gyro
+} spiPriority_e;
+
+// One chip select period, or part of one when negateCS is clear
+typedef struct busSegment_s {
+    const uint8_t *txData;      // NULL sends 0xFF
+    uint8_t *rxData;            // NULL discards
+    uint16_t len;               // a zero length segment ends the sequence
+    bool negateCS;              // release CS after this segment
+} busSegment_t;
+
+struct spiSequence_s;
+typedef void (*spiSequenceCallbackFn)(struct spiSequence_s *sequence);
+
+typedef struct spiSequence_s {
+    const busDevice_t *bus;
+    const busSegment_t *segments;
+    spiSequenceCallbackFn callback; // run once the segments are done, may start another sequence
+    spiPriority_e priority;
+    volatile bool pending;
+    struct spiSequence_s *next;
+} spiSequence_t;
+
+// Longest chip select period a bulk transfer holds while a sequence is waiting, about 40us at 10.5MHz
+#define SPI_BULK_CHUNK_BYTES 48
+
 // Macros to convert between CLI bus number and SPIDevice.
 #define SPI_CFG_TO_DEV(x)   ((x) - 1)
 #define SPI_DEV_TO_CFG(x)   ((x) + 1)
@@ -141,6 +171,13 @@ SPI_TypeDef *spiInstanceByDevice(SPIDevice device);
 
 bool spiBusIsBusBusy(const busDevice_t *bus);
 
+void spiBusClaim(const busDevice_t *bus);
+void spiBusRelease(const busDevice_t *bus);
+bool spiSequenceStart(spiSequence_t *sequence);
+bool spiSequenceIsPending(const spiSequence_t *sequence);
+void spiSequenceWait(const spiSequence_t *sequence);
+bool spiBusIsContended(const busDevice_t *bus);
+
 bool spiBusTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int length);
 
 uint8_t spiBusTransferByte(const busDevice_t *bus, uint8_t data);
@@ -79,6 +79,8 @@ typedef struct SPIDevice_s {
 #ifdef USE_SPI_TRANSACTION
     uint16_t cr1SoftCopy;   // Copy of active CR1 value for this SPI instance
 #endif
+    volatile uint8_t claimCount;            // blocking users or a running sequence holding the bus
+    struct spiSequence_s *volatile queue;   // sequences waiting for the bus, highest priority first
 } spiDevice_t;
 
 extern spiDevice_t spiDevice[SPIDEV_COUNT];
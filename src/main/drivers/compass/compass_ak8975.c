@@ -116,37 +116,41 @@ static int16_t parseMag(uint8_t *raw, int16_t gain) {
 
 static bool ak8975Read(magDev_t *mag, int16_t *magData)
 {
-    bool ack;
-    uint8_t status;
-    uint8_t buf[6];
+    // ST1, the data from AK8975_MAG_REG_HXL to AK8975_MAG_REG_HZH and ST2, read in one transfer
+    static uint8_t buf[AK8975_MAG_REG_ST2 - AK8975_MAG_REG_ST1 + 1];
+    static bool pendingRead = true;
 
     busDevice_t *busdev = &mag->busdev;
 
-    ack = busReadRegisterBuffer(busdev, AK8975_MAG_REG_ST1, &status, 1);
-    if (!ack || (status & ST1_REG_DATA_READY) == 0) {
+    // Start the transfer, the data is picked up on a later call once the bus is idle
+    if (pendingRead) {
+        if (busReadRegisterBufferStart(busdev, AK8975_MAG_REG_ST1, buf, sizeof(buf))) {
+            pendingRead = false;
+        }
         return false;
     }
 
-    busReadRegisterBuffer(busdev, AK8975_MAG_REG_HXL, buf, 6); // read from AK8975_MAG_REG_HXL to AK8975_MAG_REG_HZH
+    pendingRead = true;
 
-    ack = busReadRegisterBuffer(busdev, AK8975_MAG_REG_ST2, &status, 1);
-    if (!ack) {
+    if ((buf[0] & ST1_REG_DATA_READY) == 0) {
         return false;
     }
 
-    busWriteRegister(busdev, AK8975_MAG_REG_CNTL, CNTL_BIT_16_BIT | CNTL_MODE_ONCE); // start reading again    uint8_t status2 = buf[6];
+    busWriteRegisterStart(busdev, AK8975_MAG_REG_CNTL, CNTL_BIT_16_BIT | CNTL_MODE_ONCE); // start reading again
+
+    const uint8_t status2 = buf[AK8975_MAG_REG_ST2 - AK8975_MAG_REG_ST1];
 
-    if (status & ST2_REG_DATA_ERROR) {
+    if (status2 & ST2_REG_DATA_ERROR) {
         return false;
     }
 
-    if (status & ST2_REG_MAG_SENSOR_OVERFLOW) {
+    if (status2 & ST2_REG_MAG_SENSOR_OVERFLOW) {
         return false;
     }
 
-    magData[X] = -parseMag(buf + 0, mag->magGain[X]);
-    magData[Y] = -parseMag(buf + 2, mag->magGain[Y]);
-    magData[Z] = -parseMag(buf + 4, mag->magGain[Z]);
+    magData[X] = -parseMag(buf + 1, mag->magGain[X]);
+    magData[Y] = -parseMag(buf + 3, mag->magGain[Y]);
+    magData[Z] = -parseMag(buf + 5, mag->magGain[Z]);
 
     return true;
 }
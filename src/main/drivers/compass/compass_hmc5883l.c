@@ -200,16 +200,21 @@ static void hmc5883SpiInit(busDevice_t *busdev)
 
 static bool hmc5883lRead(magDev_t *mag, int16_t *magData)
 {
-    uint8_t buf[6];
+    static uint8_t buf[6];
+    static bool pendingRead = true;
 
     busDevice_t *busdev = &mag->busdev;
 
-    bool ack = busReadRegisterBuffer(busdev, HMC58X3_REG_DATA, buf, 6);
-
-    if (!ack) {
+    // Start the transfer, the data is picked up on a later call once the bus is idle
+    if (pendingRead) {
+        if (busReadRegisterBufferStart(busdev, HMC58X3_REG_DATA, buf, sizeof(buf))) {
+            pendingRead = false;
+        }
         return false;
     }
 
+    pendingRead = true;
+
     magData[X] = (int16_t)(buf[0] << 8 | buf[1]);
     magData[Z] = (int16_t)(buf[2] << 8 | buf[3]);
     magData[Y] = (int16_t)(buf[4] << 8 | buf[5]);
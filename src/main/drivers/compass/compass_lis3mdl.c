@@ -103,16 +103,21 @@
 
 static bool lis3mdlRead(magDev_t * mag, int16_t *magData)
 {
-    uint8_t buf[6];
+    static uint8_t buf[6];
+    static bool pendingRead = true;
 
     busDevice_t *busdev = &mag->busdev;
 
-    bool ack = busReadRegisterBuffer(busdev, LIS3MDL_REG_OUT_X_L, buf, 6);
-
-    if (!ack) {
+    // Start the transfer, the data is picked up on a later call once the bus is idle
+    if (pendingRead) {
+        if (busReadRegisterBufferStart(busdev, LIS3MDL_REG_OUT_X_L, buf, sizeof(buf))) {
+            pendingRead = false;
+        }
         return false;
     }
 
+    pendingRead = true;
+
     magData[X] = (int16_t)(buf[1] << 8 | buf[0]) / 4;
     magData[Y] = (int16_t)(buf[3] << 8 | buf[2]) / 4;
     magData[Z] = (int16_t)(buf[5] << 8 | buf[4]) / 4;
@@ -91,24 +91,24 @@ static bool qmc5883lInit(magDev_t *magDev)
 
 static bool qmc5883lRead(magDev_t *magDev, int16_t *magData)
 {
-    uint8_t status;
-    uint8_t buf[6];
-
-    // set magData to zero for case of failed read
-    magData[X] = 0;
-    magData[Y] = 0;
-    magData[Z] = 0;
+    // data output registers followed by the status register, read in one transfer
+    static uint8_t buf[QMC5883L_REG_STATUS - QMC5883L_REG_DATA_OUTPUT_X + 1];
+    static bool pendingRead = true;
 
     busDevice_t *busdev = &magDev->busdev;
 
-    bool ack = busReadRegisterBuffer(busdev, QMC5883L_REG_STATUS, &status, 1);
-
-    if (!ack || (status & 0x04) == 0) {
+    // Start the transfer, the data is picked up on a later call once the bus is idle
+    if (pendingRead) {
+        if (busReadRegisterBufferStart(busdev, QMC5883L_REG_DATA_OUTPUT_X, buf, sizeof(buf))) {
+            pendingRead = false;
+        }
         return false;
     }
 
-    ack = busReadRegisterBuffer(busdev, QMC5883L_REG_DATA_OUTPUT_X, buf, 6);
-    if (!ack) {
+    pendingRead = true;
+
+    const uint8_t status = buf[QMC5883L_REG_STATUS - QMC5883L_REG_DATA_OUTPUT_X];
+    if ((status & 0x04) == 0) {
         return false;
     }
 
@@ -0,0 +1,84 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/utils.h"
+
+#include "drivers/dma_buffer.h"
+
+#if defined(STM32H7)
+#define DMA_BUFFER_ATTRIBUTE DMA_RAM            // D2 SRAM, write-through, reads need invalidating
+#elif defined(STM32F7)
+#define DMA_BUFFER_ATTRIBUTE FAST_RAM_ZERO_INIT // DTCM RAM, not cached
+#else
+#define DMA_BUFFER_ATTRIBUTE                    // NONE
+#endif
+
+#define DMA_CACHE_LINE_MASK (DMA_CACHE_LINE_SIZE - 1)
+
+static DMA_BUFFER_ATTRIBUTE uint8_t dmaBufferPool[DMA_BUFFER_POOL_SIZE] __attribute__((aligned(DMA_CACHE_LINE_SIZE)));
+static size_t dmaBufferPoolUsed;
+
+void *dmaBufferAllocate(size_t size)
+{
+    const size_t alignedSize = (size + DMA_CACHE_LINE_MASK) & ~(size_t)DMA_CACHE_LINE_MASK;
+
+    if (size == 0 || alignedSize > DMA_BUFFER_POOL_SIZE - dmaBufferPoolUsed) {
+        return NULL;
+    }
+
+    void *buffer = &dmaBufferPool[dmaBufferPoolUsed];
+    dmaBufferPoolUsed += alignedSize;
+
+    return buffer;
+}
+
+size_t dmaBufferPoolFree(void)
+{
+    return DMA_BUFFER_POOL_SIZE - dmaBufferPoolUsed;
+}
+
+void dmaCacheClean(const volatile void *buffer, size_t length)
+{
+#if defined(STM32F7) || defined(STM32H7)
+    const uint32_t start = (uint32_t)buffer & ~DMA_CACHE_LINE_MASK;
+
+    SCB_CleanDCache_by_Addr((uint32_t *)start, (int32_t)(length + ((uint32_t)buffer - start)));
+#else
+    UNUSED(buffer);
+    UNUSED(length);
+#endif
+}
+
+void dmaCacheInvalidate(volatile void *buffer, size_t length)
+{
+#if defined(STM32F7) || defined(STM32H7)
+    const uint32_t start = (uint32_t)buffer & ~DMA_CACHE_LINE_MASK;
+
+    SCB_InvalidateDCache_by_Addr((uint32_t *)start, (int32_t)(length + ((uint32_t)buffer - start)));
+#else
+    UNUSED(buffer);
+    UNUSED(length);
+#endif
+}
@@ -0,0 +1,43 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#define DMA_CACHE_LINE_SIZE 32
+
+#ifndef DMA_BUFFER_POOL_SIZE
+#define DMA_BUFFER_POOL_SIZE 256
+#endif
+
+// Buffers are cache line aligned and padded, so cache maintenance on one never touches its neighbours.
+// They are handed out once at init and never freed.
+void *dmaBufferAllocate(size_t size);
+size_t dmaBufferPoolFree(void);
+
+// D-cache maintenance by address range, no-ops on MCUs without a D-cache.
+// Clean before a DMA transfer reads the buffer, invalidate before the CPU reads what a DMA transfer wrote.
+// Invalidate widens the range to whole cache lines, so use it only on line aligned buffers.
+void dmaCacheClean(const volatile void *buffer, size_t length);
+void dmaCacheInvalidate(volatile void *buffer, size_t length);
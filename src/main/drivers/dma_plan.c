@@ -0,0 +1,190 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_DMA_SPEC
+
+#include "drivers/timer.h"
+
+#include "dma_plan.h"
+
+static dmaPlanRequest_t dmaPlanRequests[DMA_PLAN_MAX_REQUESTS];
+static uint8_t dmaPlanRequestCount;
+static bool dmaPlanSolved;
+
+static dmaPlanRequest_t *dmaPlanAdd(resourceOwner_e owner, uint8_t resourceIndex, dmaoptValue_t opt, dmaPlanPriority_e priority)
+{
+    if (dmaPlanSolved || dmaPlanRequestCount >= DMA_PLAN_MAX_REQUESTS || opt == DMA_OPT_UNUSED) {
+        return NULL;
+    }
+
+    dmaPlanRequest_t *request = &dmaPlanRequests[dmaPlanRequestCount++];
+
+    request->configured = opt;
+    request->assigned = opt;
+    request->priority = priority;
+    request->owner.owner = owner;
+    request->owner.resourceIndex = resourceIndex;
+
+    return request;
+}
+
+void dmaPlanAddPeripheral(resourceOwner_e owner, uint8_t resourceIndex, dmaPeripheral_e device, uint8_t index, dmaoptValue_t opt, dmaPlanPriority_e priority)
+{
+    dmaPlanRequest_t *request = dmaPlanAdd(owner, resourceIndex, opt, priority);
+
+    if (request) {
+        request->timer = NULL;
+        request->device = device;
+        request->index = index;
+    }
+}
+
+void dmaPlanAddTimer(resourceOwner_e owner, uint8_t resourceIndex, const timerHardware_t *timer, dmaoptValue_t opt, dmaPlanPriority_e priority)
+{
+    if (!timer) {
+        return;
+    }
+
+    dmaPlanRequest_t *request = dmaPlanAdd(owner, resourceIndex, opt, priority);
+
+    if (request) {
+        request->timer = timer;
+    }
+}
+
+static dmaIdentifier_e dmaPlanIdentifier(const dmaPlanRequest_t *request, dmaoptValue_t opt)
+{
+    const dmaChannelSpec_t *dmaSpec;
+
+    if (request->timer) {
+        dmaSpec = dmaGetChannelSpecByTimerValue(request->timer->tim, request->timer->channel, opt);
+    } else {
+        dmaSpec = dmaGetChannelSpecByPeripheral(request->device, request->index, opt);
+    }
+
+    return dmaSpec ? dmaGetIdentifier(dmaSpec->ref) : DMA_NONE;
+}
+
+static bool dmaPlanIsClaimed(dmaIdentifier_e identifier, const bool *placed)
+{
+    for (unsigned i = 0; i < dmaPlanRequestCount; i++) {
+        if (placed[i] && dmaPlanIdentifier(&dmaPlanRequests[i], dmaPlanRequests[i].assigned) == identifier) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool dmaPlanPlace(dmaPlanRequest_t *request, dmaoptValue_t opt, const bool *placed)
+{
+    const dmaIdentifier_e identifier = dmaPlanIdentifier(request, opt);
+
+    if (identifier == DMA_NONE || dmaPlanIsClaimed(identifier, placed)) {
+        return false;
+    }
+
+    request->assigned = opt;
+
+    return true;
+}
+
+void dmaPlanSolve(void)
+{
+    bool placed[DMA_PLAN_MAX_REQUESTS] = { false };
+
+    for (int priority = DMA_PLAN_PRIORITY_HIGH; priority >= DMA_PLAN_PRIORITY_LOW; priority--) {
+        for (unsigned i = 0; i < dmaPlanRequestCount; i++) {
+            dmaPlanRequest_t *request = &dmaPlanRequests[i];
+
+            if (request->priority != priority) {
+                continue;
+            }
+
+            // Keep the configured option when its stream is free, otherwise take the first free alternative
+            placed[i] = dmaPlanPlace(request, request->configured, placed);
+
+            const int optionCount = request->timer ? MAX_TIMER_DMA_OPTIONS : MAX_PERIPHERAL_DMA_OPTIONS;
+            for (int opt = 0; !placed[i] && opt < optionCount; opt++) {
+                if (opt != request->configured) {
+                    placed[i] = dmaPlanPlace(request, opt, placed);
+                }
+            }
+
+            if (!placed[i]) {
+                request->assigned = DMA_OPT_UNUSED;
+            }
+        }
+    }
+
+    dmaPlanSolved = true;
+}
+
+dmaoptValue_t dmaPlanPeripheralOption(dmaPeripheral_e device, uint8_t index, dmaoptValue_t opt)
+{
+    for (unsigned i = 0; i < dmaPlanRequestCount; i++) {
+        const dmaPlanRequest_t *request = &dmaPlanRequests[i];
+
+        if (!request->timer && request->device == device && request->index == index) {
+            return request->assigned;
+        }
+    }
+
+    return opt;
+}
+
+dmaoptValue_t dmaPlanTimerOption(const timerHardware_t *timer, dmaoptValue_t opt)
+{
+    for (unsigned i = 0; i < dmaPlanRequestCount; i++) {
+        const dmaPlanRequest_t *request = &dmaPlanRequests[i];
+
+        if (request->timer && request->timer->tim == timer->tim && request->timer->channel == timer->channel) {
+            return request->assigned;
+        }
+    }
+
+    return opt;
+}
+
+// Streams promised to a driver that has not started yet, for users that pick a stream at run time
+bool dmaPlanIsReserved(dmaIdentifier_e identifier)
+{
+    for (unsigned i = 0; i < dmaPlanRequestCount; i++) {
+        const dmaPlanRequest_t *request = &dmaPlanRequests[i];
+
+        if (request->assigned != DMA_OPT_UNUSED && dmaPlanIdentifier(request, request->assigned) == identifier) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const dmaPlanRequest_t *dmaPlanGetRequest(unsigned index)
+{
+    return index < dmaPlanRequestCount ? &dmaPlanRequests[index] : NULL;
+}
+
+#endif // USE_DMA_SPEC
@@ -0,0 +1,59 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "drivers/dma.h"
+#include "drivers/dma_reqmap.h"
+#include "drivers/resource.h"
+
+#define DMA_PLAN_MAX_REQUESTS 24
+
+typedef enum {
+    DMA_PLAN_PRIORITY_LOW = 0,
+    DMA_PLAN_PRIORITY_NORMAL,
+    DMA_PLAN_PRIORITY_HIGH,
+} dmaPlanPriority_e;
+
+typedef struct dmaPlanRequest_s {
+    const struct timerHardware_s *timer;    // set for timer channel requests
+    dmaPeripheral_e device;                 // peripheral requests only
+    uint8_t index;
+    dmaoptValue_t configured;               // option from the config
+    dmaoptValue_t assigned;                 // option after planning, DMA_OPT_UNUSED if no stream was left
+    uint8_t priority;
+    resourceOwner_t owner;
+} dmaPlanRequest_t;
+
+// Requests are gathered at init before the drivers are started, dmaPlanSolve() then
+// hands out the streams, higher priorities first. Drivers look up their option with
+// dmaPlanPeripheralOption() / dmaPlanTimerOption(), unplanned users get their own option back.
+void dmaPlanAddPeripheral(resourceOwner_e owner, uint8_t resourceIndex, dmaPeripheral_e device, uint8_t index, dmaoptValue_t opt, dmaPlanPriority_e priority);
+void dmaPlanAddTimer(resourceOwner_e owner, uint8_t resourceIndex, const struct timerHardware_s *timer, dmaoptValue_t opt, dmaPlanPriority_e priority);
+void dmaPlanSolve(void);
+
+dmaoptValue_t dmaPlanPeripheralOption(dmaPeripheral_e device, uint8_t index, dmaoptValue_t opt);
+dmaoptValue_t dmaPlanTimerOption(const struct timerHardware_s *timer, dmaoptValue_t opt);
+bool dmaPlanIsReserved(dmaIdentifier_e identifier);
+
+const dmaPlanRequest_t *dmaPlanGetRequest(unsigned index);
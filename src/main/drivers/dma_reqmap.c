@@ -32,6 +32,7 @@
 
 #include "pg/timerio.h"
 
+#include "dma_plan.h"
 #include "dma_reqmap.h"
 
 typedef struct dmaPeripheralMapping_s {
@@ -457,7 +458,7 @@ const dmaChannelSpec_t *dmaGetChannelSpecByTimer(const timerHardware_t *timer)
         return NULL;
     }
 
-    dmaoptValue_t dmaopt = dmaoptByTag(timer->tag);
+    dmaoptValue_t dmaopt = dmaPlanTimerOption(timer, dmaoptByTag(timer->tag));
     return dmaGetChannelSpecByTimerValue(timer->tim, timer->channel, dmaopt);
 }
 
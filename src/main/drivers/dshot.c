@@ -141,6 +141,51 @@ uint16_t getDshotTelemetry(uint8_t index)
     return dshotTelemetryState.motorState[index].telemetryValue;
 }
 
+// Stores the 12 bit telemetry value (eeem mmmm mmmm) of a GCR frame, returns false for an invalid value.
+// Extended telemetry frames have a clear mantissa MSB with a non zero exponent,
+// an encoding a normalised eRPM period never uses.
+FAST_CODE bool dshotTelemetryDecodeValue(uint8_t motorIndex, uint32_t value)
+{
+    dshotTelemetryMotorState_t *state = &dshotTelemetryState.motorState[motorIndex];
+    uint16_t erpm = 0;
+
+    if (!(value & 0x0100) && (value & 0x0e00)) {
+        const uint8_t data = value & 0xff;
+        switch (value >> 8) {
+        case DSHOT_EDT_TEMPERATURE:
+            state->edtTemperature = data;
+            break;
+        case DSHOT_EDT_VOLTAGE:
+            state->edtVoltage = data;
+            break;
+        case DSHOT_EDT_CURRENT:
+            state->edtCurrent = data;
+            break;
+        case DSHOT_EDT_STATUS:
+            state->edtStatus = data;
+            break;
+        default:
+            break;
+        }
+        state->edtFrameCount++;
+        return true;
+    }
+
+    if (value != 0x0fff) {
+        const uint32_t period = (value & 0x01ff) << ((value & 0x0e00) >> 9);
+        if (!period) {
+            return false;
+        }
+        // Convert period to erpm * 100
+        erpm = (1000000 * 60 / 100 + period / 2) / period;
+    }
+
+    state->telemetryValue = erpm;
+    state->telemetryActive = true;
+
+    return true;
+}
+
 #endif
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
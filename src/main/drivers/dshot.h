@@ -62,9 +62,29 @@ uint16_t prepareDshotPacket(dshotProtocolControl_t *pcb);
 #ifdef USE_DSHOT_TELEMETRY
 extern bool useDshotTelemetry;
 
+// Extended DShot telemetry frame types, sent in place of an eRPM frame
+typedef enum {
+    DSHOT_EDT_TEMPERATURE = 0x02,   // 1C per step
+    DSHOT_EDT_VOLTAGE     = 0x04,   // 0.25V per step
+    DSHOT_EDT_CURRENT     = 0x06,   // 1A per step
+    DSHOT_EDT_DEBUG1      = 0x08,
+    DSHOT_EDT_DEBUG2      = 0x0A,
+    DSHOT_EDT_STRESS      = 0x0C,
+    DSHOT_EDT_STATUS      = 0x0E,
+} dshotEdtType_e;
+
+#define DSHOT_EDT_STATUS_ALERT      (1 << 7)
+#define DSHOT_EDT_STATUS_WARNING    (1 << 6)
+#define DSHOT_EDT_STATUS_ERROR      (1 << 5)
+
 typedef struct dshotTelemetryMotorState_s {
     uint16_t telemetryValue;
     bool telemetryActive;
+    uint8_t edtFrameCount;      // incremented for every extended telemetry frame
+    uint8_t edtTemperature;
+    uint8_t edtVoltage;
+    uint8_t edtCurrent;
+    uint8_t edtStatus;
 } dshotTelemetryMotorState_t;
 
 
@@ -78,6 +98,8 @@ typedef struct dshotTelemetryState_s {
 
 extern dshotTelemetryState_t dshotTelemetryState;
 
+bool dshotTelemetryDecodeValue(uint8_t motorIndex, uint32_t value);
+
 #ifdef USE_DSHOT_TELEMETRY_STATS
 void updateDshotTelemetryQuality(dshotTelemetryQuality_t *qualityStats, bool packetValid, timeMs_t currentTimeMs);
 #endif
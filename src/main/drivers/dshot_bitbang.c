@@ -31,6 +31,8 @@
 #include "drivers/io.h"
 #include "drivers/io_impl.h"
 #include "drivers/dma.h"
+#include "drivers/dma_buffer.h"
+#include "drivers/dma_plan.h"
 #include "drivers/dma_reqmap.h"
 #include "drivers/dshot.h"
 #include "drivers/dshot_bitbang.h"
@@ -65,10 +67,8 @@ FAST_RAM_ZERO_INIT bbMotor_t bbMotors[MAX_SUPPORTED_MOTORS];
 static FAST_RAM_ZERO_INIT int motorCount;
 dshotBitbangStatus_e bbStatus;
 
-// For MCUs that use MPU to control DMA coherency, there might be a performance hit
-// on manipulating input buffer content especially if it is read multiple times,
-// as the buffer region is attributed as not cachable.
-// If this is not desirable, we should use manual cache invalidation.
+// On H7 the buffers are in write-through D2 SRAM, the input buffer is invalidated
+// before decoding. F7 keeps them in DTCM, which is not cached.
 
 #if defined(STM32F4)
 #define BB_OUTPUT_BUFFER_ATTRIBUTE
@@ -133,29 +133,37 @@ static void bbOutputDataInit(uint32_t *buffer, uint16_t portMask, bool inverted)
     }
 }
 
-static void bbOutputDataSet(uint32_t *buffer, int pinNumber, uint16_t value, bool inverted)
+static uint32_t bbOutputMiddleMask(int pinNumber, bool inverted)
 {
-    uint32_t middleBit;
-
     if (inverted) {
-        middleBit = (1 << (pinNumber + 0));
+        return (1 << (pinNumber + 0));
     } else {
-        middleBit = (1 << (pinNumber + 16));
-    }
-
-    for (int pos = 0; pos < 16; pos++) {
-        if (!(value & 0x8000)) {
-            buffer[pos * 3 + 1] |= middleBit;
-        }
-        value <<= 1;
+        return (1 << (pinNumber + 16));
     }
 }
 
-static void bbOutputDataClear(uint32_t *buffer)
+// Encodes the packets of all motors on a port in one pass, the middle word of
+// every bit is written whole so the buffer needs no clearing in between
+static void bbOutputDataSet(const bbPort_t *bbPort)
 {
-    // Middle position to no change
-    for (int bitpos = 0; bitpos < 16; bitpos++) {
-        buffer[bitpos * 3 + 1] = 0;
+    uint32_t *buffer = bbPort->portOutputBuffer;
+    uint32_t middleMask[MAX_SUPPORTED_MOTORS];
+    uint32_t zeroBits[MAX_SUPPORTED_MOTORS];
+    const int count = bbPort->motorCount;
+
+    for (int i = 0; i < count; i++) {
+        const bbMotor_t *bbmotor = &bbMotors[bbPort->motorIndex[i]];
+        middleMask[i] = bbmotor->middleMask;
+        zeroBits[i] = (uint16_t)~bbmotor->packet;
+    }
+
+    for (int pos = 0; pos < 16; pos++) {
+        uint32_t middle = 0;
+        for (int i = 0; i < count; i++) {
+            // all ones for a zero bit, MSB first
+            middle |= middleMask[i] & -((zeroBits[i] >> (15 - pos)) & 1);
+        }
+        buffer[pos * 3 + 1] = middle;
     }
 }
 
@@ -350,7 +358,11 @@ static void bbFindPacerTimer(void)
             dmaResource_t *dma = timer->dmaRef;
 #endif
             dmaIdentifier_e dmaIdentifier = dmaGetIdentifier(dma);
-            if (dmaGetOwner(dmaIdentifier)->owner == OWNER_FREE) {
+            if (dmaGetOwner(dmaIdentifier)->owner == OWNER_FREE
+#ifdef USE_DMA_SPEC
+                && !dmaPlanIsReserved(dmaIdentifier)
+#endif
+                ) {
                 bbPorts[bbPortIndex].timhw = timer;
 
                 break;
@@ -420,6 +432,7 @@ static bool bbMotorConfig(IO_t io, uint8_t motorIndex, motorPwmProtocolTypes_e p
     bbMotors[motorIndex].io = io;
     bbMotors[motorIndex].output = output;
     bbMotors[motorIndex].bbPort = bbPort;
+    bbPort->motorIndex[bbPort->motorCount++] = motorIndex;
 
     IOInit(io, OWNER_MOTOR, RESOURCE_INDEX(motorIndex));
 
@@ -430,10 +443,12 @@ static bool bbMotorConfig(IO_t io, uint8_t motorIndex, motorPwmProtocolTypes_e p
 #ifdef USE_DSHOT_TELEMETRY
     if (useDshotTelemetry) {
         bbOutputDataInit(bbPort->portOutputBuffer, (1 << pinIndex), DSHOT_BITBANG_INVERTED);
+        bbMotors[motorIndex].middleMask = bbOutputMiddleMask(pinIndex, DSHOT_BITBANG_INVERTED);
     } else
 #endif
     {
         bbOutputDataInit(bbPort->portOutputBuffer, (1 << pinIndex), DSHOT_BITBANG_NONINVERTED);
+        bbMotors[motorIndex].middleMask = bbOutputMiddleMask(pinIndex, DSHOT_BITBANG_NONINVERTED);
     }
 
     bbSwitchToOutput(bbPort);
@@ -456,6 +471,10 @@ static bool bbUpdateStart(void)
             return false;
         }
 
+        for (int i = 0; i < usedMotorPorts; i++) {
+            dmaCacheInvalidate(bbPorts[i].portInputBuffer, DSHOT_BITBANG_PORT_INPUT_BUFFER_LENGTH * sizeof(uint16_t));
+        }
+
         for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
 #ifdef STM32F4
             uint32_t value = decode_bb_bitband(
@@ -473,12 +492,11 @@ static bool bbUpdateStart(void)
             }
             dshotTelemetryState.readCount++;
 
-            if (value != BB_INVALID) {
-                dshotTelemetryState.motorState[motorIndex].telemetryValue = value;
-                dshotTelemetryState.motorState[motorIndex].telemetryActive = true;
+            const bool validTelemetryPacket = value != BB_INVALID && dshotTelemetryDecodeValue(motorIndex, value);
+            if (validTelemetryPacket) {
                 if (motorIndex < 2) {
-                    // erpm/100 (value) should never exceed ~32,767 (3.27M erpm)
-                    DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, (int16_t) value);   
+                    // erpm/100 should never exceed ~32,767 (3.27M erpm)
+                    DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, (int16_t) dshotTelemetryState.motorState[motorIndex].telemetryValue);
                     // HF3D:  Also log invalid packet count on debug 2 & 3 since we only have a maximum of 2 motors.
                     DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex+2, dshotTelemetryState.invalidPacketCount);
                 }
@@ -486,14 +504,13 @@ static bool bbUpdateStart(void)
                 dshotTelemetryState.invalidPacketCount++;
             }
 #ifdef USE_DSHOT_TELEMETRY_STATS
-            updateDshotTelemetryQuality(&dshotTelemetryQuality[motorIndex], value != BB_INVALID, currentTimeMs);
+            updateDshotTelemetryQuality(&dshotTelemetryQuality[motorIndex], validTelemetryPacket, currentTimeMs);
 #endif
         }
     }
 #endif
     for (int i = 0; i < usedMotorPorts; i++) {
         bbDMA_Cmd(&bbPorts[i], DISABLE);
-        bbOutputDataClear(bbPorts[i].portOutputBuffer);
     }
 
     return true;
@@ -522,18 +539,7 @@ static void bbWriteInt(uint8_t motorIndex, uint16_t value)
 
     bbmotor->protocolControl.value = value;
 
-    uint16_t packet = prepareDshotPacket(&bbmotor->protocolControl);
-
-    bbPort_t *bbPort = bbmotor->bbPort;
-
-#ifdef USE_DSHOT_TELEMETRY
-    if (useDshotTelemetry) {
-        bbOutputDataSet(bbPort->portOutputBuffer, bbmotor->pinIndex, packet, DSHOT_BITBANG_INVERTED);
-    } else
-#endif
-    {
-        bbOutputDataSet(bbPort->portOutputBuffer, bbmotor->pinIndex, packet, DSHOT_BITBANG_NONINVERTED);
-    }
+    bbmotor->packet = prepareDshotPacket(&bbmotor->protocolControl);
 }
 
 static void bbWrite(uint8_t motorIndex, float value)
@@ -551,6 +557,10 @@ static void bbUpdateComplete(void)
         }
     }
 
+    for (int i = 0; i < usedMotorPorts; i++) {
+        bbOutputDataSet(&bbPorts[i]);
+    }
+
 #ifdef USE_DSHOT_TELEMETRY
     for (int i = 0; i < usedMotorPorts; i++) {
         bbPort_t *bbPort = &bbPorts[i];
@@ -71,18 +71,8 @@ static uint32_t decode_bb_value(uint32_t value, uint16_t buffer[], uint32_t coun
 #endif
         value = BB_INVALID;
     } else {
+        // 12 bit telemetry value (eeem mmmm mmmm), converted by dshotTelemetryDecodeValue()
         value = decodedValue >> 4;
-        
-        if (value == 0x0fff) {
-            return 0;
-        }
-        // Convert value to 16 bit from the GCR telemetry format (eeem mmmm mmmm)
-        value = (value & 0x000001ff) << ((value & 0xfffffe00) >> 9);
-        if (!value) {
-            return BB_INVALID;
-        }
-        // Convert period to erpm * 100
-        value = (1000000 * 60 / 100 + value / 2) / value;
     }
     return value;
 }
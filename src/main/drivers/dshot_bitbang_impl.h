@@ -151,6 +151,10 @@ typedef struct bbPort_s {
     uint32_t portInputCount;
     bool inputActive;
 
+    // Motors on this port, their packets are encoded together by bbOutputDataSet()
+    uint8_t motorCount;
+    uint8_t motorIndex[MAX_SUPPORTED_MOTORS];
+
     // Misc
 #ifdef DEBUG_COUNT_INTERRUPT
     uint32_t outputIrq;
@@ -169,6 +173,8 @@ typedef struct bbMotor_s {
     uint8_t output;
     uint32_t iocfg;
     bbPort_t *bbPort;
+    uint32_t middleMask;     // BSRR bit that ends a zero bit early, set for this pin's polarity
+    uint16_t packet;         // next packet, written to the port buffer in bbUpdateComplete()
     bool configured;
     bool enabled;
 } bbMotor_t;
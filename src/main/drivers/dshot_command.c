@@ -56,6 +56,7 @@ typedef struct dshotCommandControl_s {
     uint32_t nextCommandCycleDelay;
     timeUs_t delayAfterCommandUs;
     uint8_t repeats;
+    uint8_t id;                             // reported by dshotCommandGetCompletedId() once sent
     uint8_t command[MAX_SUPPORTED_MOTORS];
 } dshotCommandControl_t;
 
@@ -71,6 +72,9 @@ static dshotCommandControl_t commandQueue[DSHOT_MAX_COMMANDS + 1];
 static uint8_t commandQueueHead;
 static uint8_t commandQueueTail;
 
+static uint8_t lastQueuedId;
+static uint8_t lastCompletedId;
+
 void dshotSetPidLoopTime(uint32_t pidLoopTime)
 {
     dshotCommandPidLoopTimeUs = pidLoopTime;
@@ -106,6 +110,7 @@ FAST_CODE bool dshotCommandIsProcessing(void)
 static FAST_CODE bool dshotCommandQueueUpdate(void)
 {   
     if (!dshotCommandQueueEmpty()) {
+        lastCompletedId = commandQueue[commandQueueTail].id;
         commandQueueTail = (commandQueueTail + 1) % (DSHOT_MAX_COMMANDS + 1);
         if (!dshotCommandQueueEmpty()) {
             // There is another command in the queue so update it so it's ready to output in   
@@ -139,6 +144,25 @@ static dshotCommandControl_t* addCommand()
     return control;
 }
 
+// A queued command that has not started yet takes more motors with the same
+// timing, so commands for single motors issued together are sent together.
+static dshotCommandControl_t* mergeCommand(uint8_t index, uint8_t motorCount, uint8_t repeats, timeUs_t delayAfterCommandUs)
+{
+    if (dshotCommandQueueEmpty() || index == ALL_MOTORS) {
+        return NULL;
+    }
+
+    dshotCommandControl_t* control = &commandQueue[(commandQueueHead + DSHOT_MAX_COMMANDS) % (DSHOT_MAX_COMMANDS + 1)];
+    // no frame of the command has been sent before it is active
+    const bool notStarted = control->state == DSHOT_COMMAND_STATE_IDLEWAIT || control->state == DSHOT_COMMAND_STATE_STARTDELAY;
+    if (!notStarted || index >= motorCount || control->command[index] != DSHOT_CMD_MOTOR_STOP
+        || control->repeats != repeats || control->delayAfterCommandUs != delayAfterCommandUs) {
+        return NULL;
+    }
+
+    return control;
+}
+
 static bool allMotorsAreIdle(void)
 {
     for (unsigned i = 0; i < dshotPwmDevice.count; i++) {
@@ -160,10 +184,11 @@ bool dshotCommandsAreEnabled(void)
     }
 }
 
-void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, bool blocking)
+// Returns false when the command could not be sent or queued
+bool dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, bool blocking)
 {
-    if (!isMotorProtocolDshot() || !dshotCommandsAreEnabled() || (command > DSHOT_MAX_COMMAND) || dshotCommandQueueFull()) {
-        return;
+    if (!isMotorProtocolDshot() || !dshotCommandsAreEnabled() || (command > DSHOT_MAX_COMMAND)) {
+        return false;
     }
 
     uint8_t repeats = 1;
@@ -175,6 +200,8 @@ void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, bool
     case DSHOT_CMD_3D_MODE_OFF:
     case DSHOT_CMD_3D_MODE_ON:
     case DSHOT_CMD_SAVE_SETTINGS:
+    case DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE:
+    case DSHOT_CMD_EXTENDED_TELEMETRY_DISABLE:
     case DSHOT_CMD_SPIN_DIRECTION_NORMAL:
     case DSHOT_CMD_SPIN_DIRECTION_REVERSED:
     case DSHOT_CMD_SIGNAL_LINE_TELEMETRY_DISABLE:
@@ -192,6 +219,18 @@ void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, bool
         break;
     }
 
+    if (!blocking) {
+        dshotCommandControl_t *commandControl = mergeCommand(index, motorCount, repeats, delayAfterCommandUs);
+        if (commandControl) {
+            commandControl->command[index] = command;
+            return true;
+        }
+    }
+
+    if (dshotCommandQueueFull()) {
+        return false;
+    }
+
     if (blocking) {
         delayMicroseconds(DSHOT_INITIAL_DELAY_US - DSHOT_COMMAND_DELAY_US);
         for (; repeats; repeats--) {
@@ -216,6 +255,7 @@ void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, bool
     } else {
         dshotCommandControl_t *commandControl = addCommand();
         if (commandControl) {
+            commandControl->id = ++lastQueuedId;
             commandControl->repeats = repeats;
             commandControl->delayAfterCommandUs = delayAfterCommandUs;
             for (unsigned i = 0; i < motorCount; i++) {
@@ -235,6 +275,23 @@ void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, bool
             }
         }
     }
+
+    return true;
+}
+
+uint8_t dshotCommandGetQueuedId(void)
+{
+    return lastQueuedId;
+}
+
+uint8_t dshotCommandGetCompletedId(void)
+{
+    return lastCompletedId;
+}
+
+uint8_t dshotCommandQueueCount(void)
+{
+    return (commandQueueHead + DSHOT_MAX_COMMANDS + 1 - commandQueueTail) % (DSHOT_MAX_COMMANDS + 1);
 }
 
 uint8_t dshotCommandGetCurrent(uint8_t index)
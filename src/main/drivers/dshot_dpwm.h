@@ -132,7 +132,8 @@ typedef struct motorDmaOutput_s {
 #ifdef USE_DSHOT_TELEMETRY
     volatile bool isInput;
     timeDelta_t dshotTelemetryDeadtimeUs;
-    uint8_t dmaInputLen;
+    uint8_t dmaInputLen;        // edges captured in dmaInputBuffer, decoded from the output DMA complete interrupt
+    DSHOT_DMA_BUFFER_UNIT *dmaInputBuffer;
 
 #ifdef USE_HAL_DRIVER
     LL_TIM_OC_InitTypeDef ocInitStruct;
@@ -326,6 +326,15 @@ static void flashConfigurePartitions(void)
     startSector = 0;
 #endif
 
+#if defined(USE_FLASHFS_LOG_INDEX)
+    // The log index takes the sector just past the end of the flashfs, as long as that leaves some room to log
+    if (endSector > startSector) {
+        flashPartitionSet(FLASH_PARTITION_TYPE_FLASHFS_INDEX, endSector, endSector);
+
+        endSector--;
+    }
+#endif
+
 #ifdef USE_FLASHFS
     flashPartitionSet(FLASH_PARTITION_TYPE_FLASHFS, startSector, endSector);
 #endif
@@ -376,6 +385,7 @@ static const char *flashPartitionNames[] = {
     "BBMGMT   ",
     "FIRMWARE ",
     "CONFIG   ",
+    "LOGINDEX ",
 };
 
 const char *flashPartitionGetTypeName(flashPartitionType_e type)
@@ -88,10 +88,12 @@ static void m25p16_disable(busDevice_t *bus)
 {
     IOHi(bus->busdev_u.spi.csnPin);
     __NOP();
+    spiBusRelease(bus);
 }
 
 static void m25p16_enable(busDevice_t *bus)
 {
+    spiBusClaim(bus);
     __NOP();
     IOLo(bus->busdev_u.spi.csnPin);
 }
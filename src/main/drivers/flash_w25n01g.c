@@ -22,11 +22,14 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
 #include "build/debug.h"
 
+#include "common/maths.h"
+
 #ifdef USE_FLASH_W25N01G
 
 #include "flash.h"
@@ -34,6 +37,7 @@
 #include "flash_w25n01g.h"
 #include "drivers/bus_spi.h"
 #include "drivers/bus_quadspi.h"
+#include "drivers/dma_buffer.h"
 #include "drivers/io.h"
 #include "drivers/time.h"
 
@@ -137,8 +141,9 @@ typedef struct bblut_s {
 
 // These will be gone
 
-#define DISABLE(busdev)       IOHi((busdev)->busdev_u.spi.csnPin); __NOP()
-#define ENABLE(busdev)        __NOP(); IOLo((busdev)->busdev_u.spi.csnPin)
+// The bus is claimed while CS is low so that queued sequences of other devices wait
+#define DISABLE(busdev)       IOHi((busdev)->busdev_u.spi.csnPin); __NOP(); spiBusRelease(busdev)
+#define ENABLE(busdev)        spiBusClaim(busdev); __NOP(); IOLo((busdev)->busdev_u.spi.csnPin)
 
 static bool w25n01g_waitForReady(flashDevice_t *fdevice);
 
@@ -169,8 +174,10 @@ static void w25n01g_performOneByteCommand(flashDeviceIO_t *io, uint8_t command)
 #endif
 }
 
-static void w25n01g_performCommandWithPageAddress(flashDeviceIO_t *io, uint8_t command, uint32_t pageAddress)
+static void w25n01g_performCommandWithPageAddress(flashDevice_t *fdevice, uint8_t command, uint32_t pageAddress)
 {
+    flashDeviceIO_t *io = &fdevice->io;
+
     if (io->mode == FLASHIO_SPI) {
         busDevice_t *busdev = io->handle.busdev;
 
@@ -187,6 +194,9 @@ static void w25n01g_performCommandWithPageAddress(flashDeviceIO_t *io, uint8_t c
         quadSpiInstructionWithAddress1LINE(quadSpi, command, 0, pageAddress & 0xffff, W28N01G_STATUS_PAGE_ADDRESS_SIZE + 8);
     }
 #endif
+
+    // Block erase, program execute and page data read all keep the device busy for a while
+    fdevice->couldBeBusy = true;
 }
 
 static uint8_t w25n01g_readRegister(flashDeviceIO_t *io, uint8_t reg)
@@ -242,6 +252,7 @@ static void w25n01g_deviceReset(flashDevice_t *fdevice)
     flashDeviceIO_t *io = &fdevice->io;
 
     w25n01g_performOneByteCommand(io, W25N01G_INSTRUCTION_DEVICE_RESET);
+    fdevice->couldBeBusy = true;
 
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_RESET_MS);
     w25n01g_waitForReady(fdevice);
@@ -259,9 +270,10 @@ static void w25n01g_deviceReset(flashDevice_t *fdevice)
 
 bool w25n01g_isReady(flashDevice_t *fdevice)
 {
-    uint8_t status = w25n01g_readRegister(&fdevice->io, W25N01G_STAT_REG);
+    // If couldBeBusy is false, don't bother to poll the flash chip for its status
+    fdevice->couldBeBusy = fdevice->couldBeBusy && ((w25n01g_readRegister(&fdevice->io, W25N01G_STAT_REG) & W25N01G_STATUS_FLAG_BUSY) != 0);
 
-    return ((status & W25N01G_STATUS_FLAG_BUSY) == 0);
+    return !fdevice->couldBeBusy;
 }
 
 static bool w25n01g_waitForReady(flashDevice_t *fdevice)
@@ -280,13 +292,13 @@ static bool w25n01g_waitForReady(flashDevice_t *fdevice)
 /**
  * The flash requires this write enable command to be sent before commands that would cause
  * a write like program and erase.
+ *
+ * Unlike the NOR parts, loading the page buffer doesn't make the device busy, only the program execute
+ * or erase that follows does. So the data loads in between don't have to poll the status register.
  */
 static void w25n01g_writeEnable(flashDevice_t *fdevice)
 {
     w25n01g_performOneByteCommand(&fdevice->io, W25N01G_INSTRUCTION_WRITE_ENABLE);
-
-    // Assume that we're about to do some writing, so the device is just about to become busy
-    fdevice->couldBeBusy = true;
 }
 
 /**
@@ -360,7 +372,7 @@ void w25n01g_eraseSector(flashDevice_t *fdevice, uint32_t address)
 
     w25n01g_writeEnable(fdevice);
 
-    w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_BLOCK_ERASE, W25N01G_LINEAR_TO_PAGE(address));
+    w25n01g_performCommandWithPageAddress(fdevice, W25N01G_INSTRUCTION_BLOCK_ERASE, W25N01G_LINEAR_TO_PAGE(address));
 
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS);
 }
@@ -376,19 +388,36 @@ void w25n01g_eraseCompletely(flashDevice_t *fdevice)
     }
 }
 
-static void w25n01g_programDataLoad(flashDevice_t *fdevice, uint16_t columnAddress, const uint8_t *data, int length)
+// Load the page buffer in chunks. When a sequence is waiting the bus is released between chunks
+// and the load carries on with a random load at the next column, which keeps the data already loaded.
+static void w25n01g_spiDataLoad(busDevice_t *busdev, uint8_t instruction, uint16_t columnAddress, const uint8_t *data, int length)
 {
+    int offset = 0;
 
-    w25n01g_waitForReady(fdevice);
-
-    if (fdevice->io.mode == FLASHIO_SPI) {
-        busDevice_t *busdev = fdevice->io.handle.busdev;
-        const uint8_t cmd[] = { W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD, columnAddress >> 8, columnAddress & 0xff };
+    while (offset < length) {
+        const uint16_t column = columnAddress + offset;
+        const uint8_t cmd[] = { instruction, column >> 8, column & 0xff };
 
         ENABLE(busdev);
         spiTransfer(busdev->busdev_u.spi.instance, cmd, NULL, sizeof(cmd));
-        spiTransfer(busdev->busdev_u.spi.instance, data, NULL, length);
+        do {
+            const int chunk = MIN(length - offset, SPI_BULK_CHUNK_BYTES);
+            spiTransfer(busdev->busdev_u.spi.instance, data + offset, NULL, chunk);
+            offset += chunk;
+        } while (offset < length && !spiBusIsContended(busdev));
         DISABLE(busdev);
+
+        instruction = W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD;
+    }
+}
+
+static void w25n01g_programDataLoad(flashDevice_t *fdevice, uint16_t columnAddress, const uint8_t *data, int length)
+{
+
+    w25n01g_waitForReady(fdevice);
+
+    if (fdevice->io.mode == FLASHIO_SPI) {
+        w25n01g_spiDataLoad(fdevice->io.handle.busdev, W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD, columnAddress, data, length);
    }
 #ifdef USE_QUADSPI
    else if (fdevice->io.mode == FLASHIO_QUADSPI) {
@@ -403,18 +432,10 @@ static void w25n01g_programDataLoad(flashDevice_t *fdevice, uint16_t columnAddre
 
 static void w25n01g_randomProgramDataLoad(flashDevice_t *fdevice, uint16_t columnAddress, const uint8_t *data, int length)
 {
-    const uint8_t cmd[] = { W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD, columnAddress >> 8, columnAddress & 0xff };
-
     w25n01g_waitForReady(fdevice);
 
     if (fdevice->io.mode == FLASHIO_SPI) {
-        busDevice_t *busdev = fdevice->io.handle.busdev;
-
-        ENABLE(busdev);
-        spiTransfer(busdev->busdev_u.spi.instance, cmd, NULL, sizeof(cmd));
-        spiTransfer(busdev->busdev_u.spi.instance, data, NULL, length);
-        DISABLE(busdev);
-
+        w25n01g_spiDataLoad(fdevice->io.handle.busdev, W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD, columnAddress, data, length);
     }
 #ifdef USE_QUADSPI
     else if (fdevice->io.mode == FLASHIO_QUADSPI) {
@@ -432,7 +453,7 @@ static void w25n01g_programExecute(flashDevice_t *fdevice, uint32_t pageAddress)
 {
     w25n01g_waitForReady(fdevice);
 
-    w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, pageAddress);
+    w25n01g_performCommandWithPageAddress(fdevice, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, pageAddress);
 
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
 }
@@ -609,7 +630,7 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
 
         currentPage = UINT32_MAX;
 
-        w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PAGE_DATA_READ, targetPage);
+        w25n01g_performCommandWithPageAddress(fdevice, W25N01G_INSTRUCTION_PAGE_DATA_READ, targetPage);
 
         w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_READ_MS);
         if (!w25n01g_waitForReady(fdevice)) {
@@ -639,7 +660,7 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
 
         ENABLE(busdev);
         spiTransfer(busdev->busdev_u.spi.instance, cmd, NULL, sizeof(cmd));
-        spiTransfer(busdev->busdev_u.spi.instance, NULL, buffer, length);
+        spiTransfer(busdev->busdev_u.spi.instance, NULL, buffer, transferLength);
         DISABLE(busdev);
 
     }
@@ -647,8 +668,16 @@ int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer,
     else if (fdevice->io.mode == FLASHIO_QUADSPI) {
         QUADSPI_TypeDef *quadSpi = fdevice->io.handle.quadSpi;
 
-        //quadSpiReceiveWithAddress1LINE(quadSpi, W25N01G_INSTRUCTION_READ_DATA, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, length);
-        quadSpiReceiveWithAddress4LINES(quadSpi, W25N01G_INSTRUCTION_FAST_READ_QUAD_OUTPUT, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, length);
+        // The page buffer is mapped at the column addresses, the copy runs at the bus speed without a command per
+        // transfer. The window is cached, the lines of the previous page are dropped first.
+        const uint8_t *window = quadSpiEnableMemoryMapped4LINES(quadSpi, W25N01G_INSTRUCTION_FAST_READ_QUAD_OUTPUT, 8, W28N01G_STATUS_COLUMN_ADDRESS_SIZE);
+        if (window) {
+            dmaCacheInvalidate((uint8_t *)window + column, transferLength);
+            memcpy(buffer, window + column, transferLength);
+            quadSpiDisableMemoryMapped(quadSpi);
+        } else {
+            quadSpiReceiveWithAddress4LINES(quadSpi, W25N01G_INSTRUCTION_FAST_READ_QUAD_OUTPUT, 8, column, W28N01G_STATUS_COLUMN_ADDRESS_SIZE, buffer, transferLength);
+        }
     }
 #endif
 
@@ -684,7 +713,7 @@ int w25n01g_readExtensionBytes(flashDevice_t *fdevice, uint32_t address, uint8_t
         return 0;
     }
 
-    w25n01g_performCommandWithPageAddress(&fdevice->io, W25N01G_INSTRUCTION_PAGE_DATA_READ, W25N01G_LINEAR_TO_PAGE(address));
+    w25n01g_performCommandWithPageAddress(fdevice, W25N01G_INSTRUCTION_PAGE_DATA_READ, W25N01G_LINEAR_TO_PAGE(address));
 
     uint32_t column = 2048;
 
@@ -806,6 +835,7 @@ void w25n01g_writeBBLUT(flashDevice_t *fdevice, uint16_t lba, uint16_t pba)
         quadSpiInstructionWithData1LINE(quadSpi, W25N01G_INSTRUCTION_BB_MANAGEMENT, 0, data, sizeof(data));
     }
 #endif
+    fdevice->couldBeBusy = true;
 
     w25n01g_setTimeout(fdevice, W25N01G_TIMEOUT_PAGE_PROGRAM_MS);
 }
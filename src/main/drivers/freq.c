@@ -27,9 +27,11 @@
 
 #if defined(USE_FREQ_SENSOR)
 
+#include "build/atomic.h"
 #include "build/build_config.h"
 #include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/io.h"
@@ -60,7 +62,7 @@
 // Period init value
 #define FREQ_PERIOD_INIT      0x2000
 
-// Freq filtering coefficient - 6 is best for 3-phase motor
+// Freq filtering coefficient in signal periods - 6 is best for 3-phase motor
 #define FREQ_FILTER_COEFF     6
 
 // Maximum number of overflow failures
@@ -74,9 +76,6 @@
 #define FILTER_UPDATE(_var,_value,_coef) \
     ((_var) += ((_value)-(_var))/(_coef))
 
-#define UPDATE_FREQ_FILTER(_input,_freq) \
-    FILTER_UPDATE((_input)->freq, _freq, FREQ_FILTER_COEFF)
-
 #define UPDATE_PERIOD_FILTER(_input,_period) \
     FILTER_UPDATE((_input)->period, (int32_t)_period, (_input)->percoef)
 
@@ -93,6 +92,18 @@ typedef struct {
     uint16_t capture;
     uint32_t prescaler;
 
+    // signal periods per capture, the timer input capture prescaler
+    uint32_t edges;
+
+    // capture periods giving a frequency within FREQ_RANGE_MIN..FREQ_RANGE_MAX
+    uint32_t periodRangeMin;
+    uint32_t periodRangeMax;
+
+    // valid captures since the last freqUpdate(), shared with the ISR
+    volatile uint32_t periodSum;
+    volatile uint32_t periodCount;
+    volatile bool signalLost;
+
     uint32_t failures;
     uint32_t overflows;
 
@@ -149,6 +160,12 @@ static void freqSetBaseClock(freqInputPort_t *input, uint32_t prescaler)
     input->prescaler = prescaler;
     input->percoef = perCoeffs[(__builtin_clz(prescaler) - 15)];
     input->clock = (float)timerClock(input->timerHardware->tim) / prescaler;
+    input->periodRangeMin = input->clock * input->edges / FREQ_RANGE_MAX;
+    input->periodRangeMax = input->clock * input->edges / FREQ_RANGE_MIN;
+
+    // the accumulated periods are in the previous timer clock
+    input->periodSum = 0;
+    input->periodCount = 0;
     
     tim->PSC = prescaler - 1;
     tim->EGR = TIM_EGR_UG;
@@ -156,15 +173,13 @@ static void freqSetBaseClock(freqInputPort_t *input, uint32_t prescaler)
 
 static void freqReset(freqInputPort_t *input)
 {
-    input->freq = 0.0f;
     input->period = FREQ_PERIOD_INIT;
     input->capture = 0;
     input->failures = 0;
     input->overflows = 0;
-    
-    freqSetBaseClock(input, FREQ_PRESCALER_MAX);
+    input->signalLost = true;
 
-    freqDebug(input);
+    freqSetBaseClock(input, FREQ_PRESCALER_MAX);
 }
 
 static void freqEdgeCallback(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
@@ -178,16 +193,14 @@ static void freqEdgeCallback(timerCCHandlerRec_t *cbRec, captureCompare_t captur
 
         UPDATE_PERIOD_FILTER(input, period);
 
-        // Signal conditioning. Update freq filter only if period within acceptable range.
-        if (period > FREQ_PERIOD_MIN(input->period) && period < FREQ_PERIOD_MAX(input->period)) {
-            float freq = input->clock / period;
-            if (freq > FREQ_RANGE_MIN && freq < FREQ_RANGE_MAX) {
-                UPDATE_FREQ_FILTER(input, freq);
-            }
+        // Signal conditioning. Accumulate the period only if within acceptable range,
+        // the frequency is calculated from the sum in freqUpdate().
+        if (period > FREQ_PERIOD_MIN(input->period) && period < FREQ_PERIOD_MAX(input->period) &&
+            period > input->periodRangeMin && period < input->periodRangeMax) {
+            input->periodSum += period;
+            input->periodCount++;
         }
 
-        freqDebug(input);
-
         // Filtered period out of range. Change prescaler.
         if (input->period < FREQ_SHIFT_MIN && input->prescaler > FREQ_PRESCALER_MIN) {
             freqSetBaseClock(input, input->prescaler >> 1);
@@ -230,7 +243,11 @@ static void freqOverflowCallback(timerOvrHandlerRec_t *cbRec, captureCompare_t c
 }
 
 #if defined(USE_HAL_DRIVER)
-void freqICConfig(const timerHardware_t *timer, bool rising, uint16_t filter)
+static const uint32_t freqICPrescaler[] = {
+    TIM_ICPSC_DIV1, TIM_ICPSC_DIV2, TIM_ICPSC_DIV4, TIM_ICPSC_DIV8,
+};
+
+void freqICConfig(const timerHardware_t *timer, bool rising, uint16_t filter, uint8_t edgesLog2)
 {
     TIM_HandleTypeDef *handle = timerFindTimerHandle(timer->tim);
     if (handle == NULL)
@@ -240,13 +257,17 @@ void freqICConfig(const timerHardware_t *timer, bool rising, uint16_t filter)
     memset(&sInitStructure, 0, sizeof(sInitStructure));
     sInitStructure.ICPolarity = rising ? TIM_ICPOLARITY_RISING : TIM_ICPOLARITY_FALLING;
     sInitStructure.ICSelection = TIM_ICSELECTION_DIRECTTI;
-    sInitStructure.ICPrescaler = TIM_ICPSC_DIV1;
+    sInitStructure.ICPrescaler = freqICPrescaler[edgesLog2];
     sInitStructure.ICFilter = filter;
     HAL_TIM_IC_ConfigChannel(handle, &sInitStructure, timer->channel);
     HAL_TIM_IC_Start_IT(handle, timer->channel);
 }
 #else
-void freqICConfig(const timerHardware_t *timer, bool rising, uint16_t filter)
+static const uint16_t freqICPrescaler[] = {
+    TIM_ICPSC_DIV1, TIM_ICPSC_DIV2, TIM_ICPSC_DIV4, TIM_ICPSC_DIV8,
+};
+
+void freqICConfig(const timerHardware_t *timer, bool rising, uint16_t filter, uint8_t edgesLog2)
 {
     TIM_ICInitTypeDef sInitStructure;
 
@@ -254,7 +275,7 @@ void freqICConfig(const timerHardware_t *timer, bool rising, uint16_t filter)
     sInitStructure.TIM_Channel = timer->channel;
     sInitStructure.TIM_ICPolarity = rising ? TIM_ICPolarity_Rising : TIM_ICPolarity_Falling;
     sInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
-    sInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    sInitStructure.TIM_ICPrescaler = freqICPrescaler[edgesLog2];
     sInitStructure.TIM_ICFilter = filter;
 
     TIM_ICInit(timer->tim, &sInitStructure);
@@ -270,6 +291,7 @@ void freqInit(const freqConfig_t *freqConfig)
             input->timerHardware = timer;
             input->freq = 0.0f;
             input->period = FREQ_PERIOD_INIT;
+            input->edges = 1 << freqConfig->captureEdges;
     
             IO_t io = IOGetByTag(freqConfig->ioTag[port]);
             IOInit(io, OWNER_FREQ, RESOURCE_INDEX(port));
@@ -282,7 +304,7 @@ void freqInit(const freqConfig_t *freqConfig)
             timerChOvrHandlerInit(&input->overflowCb, freqOverflowCallback);
             timerChConfigCallbacks(timer, &input->edgeCb, &input->overflowCb);
             
-            freqICConfig(timer, true, 4);
+            freqICConfig(timer, true, 4, freqConfig->captureEdges);
             freqReset(input);
 
             input->enabled = true;
@@ -290,6 +312,44 @@ void freqInit(const freqConfig_t *freqConfig)
     }
 }
 
+// Called from the PID loop, turns the periods captured since the last call into the frequency
+void freqUpdate(void)
+{
+    for (int port = 0; port < FREQ_SENSOR_PORT_COUNT; port++) {
+        freqInputPort_t *input = &freqInputPorts[port];
+
+        if (!input->enabled) {
+            continue;
+        }
+
+        uint32_t periodSum;
+        uint32_t periodCount;
+        float clock;
+        bool signalLost;
+
+        ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+            periodSum = input->periodSum;
+            periodCount = input->periodCount;
+            clock = input->clock;
+            signalLost = input->signalLost;
+            input->periodSum = 0;
+            input->periodCount = 0;
+            input->signalLost = false;
+        }
+
+        if (signalLost) {
+            input->freq = 0.0f;
+        } else if (periodCount) {
+            const uint32_t periods = periodCount * input->edges;
+            const float freq = clock * periods / periodSum;
+            // equivalent of the former per edge filter
+            input->freq += (freq - input->freq) * MIN(periods, (uint32_t)FREQ_FILTER_COEFF) / FREQ_FILTER_COEFF;
+        }
+
+        freqDebug(input);
+    }
+}
+
 // HF3D: The freq sensor number MUST match the motor number.
 // The resource configuration should reflect this requirement.
 
@@ -44,6 +44,12 @@
 
 #include "light_ws2811strip.h"
 
+#if defined(STM32F1) || defined(STM32F3)
+typedef uint8_t ledStripDMAWord_t;
+#else
+typedef uint32_t ledStripDMAWord_t;
+#endif
+
 #if defined(STM32F1) || defined(STM32F3)
 uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #elif defined(STM32F7)
@@ -65,6 +71,17 @@ uint16_t BIT_COMPARE_0 = 0;
 
 static hsvColor_t ledColorBuffer[WS2811_DATA_BUFFER_SIZE];
 
+// Colours as last encoded into the DMA buffer, unchanged LEDs are not converted and encoded again
+static hsvColor_t encodedColorBuffer[WS2811_DATA_BUFFER_SIZE];
+static ledStripFormatRGB_e encodedFormat;
+
+// Compare values for the four bits of each nibble, MSB first
+#define WS2811_BITS_PER_NIBBLE 4
+static ledStripDMAWord_t nibbleCompareLut[16][WS2811_BITS_PER_NIBBLE];
+static uint16_t lutCompare1;
+static uint16_t lutCompare0;
+static bool lutValid = false;
+
 #if !defined(USE_WS2811_SINGLE_COLOUR)
 void setLedHsv(uint16_t index, const hsvColor_t *color)
 {
@@ -138,8 +155,25 @@ bool isWS2811LedStripReady(void)
     return ws2811Initialised && !ws2811LedDataTransferInProgress;
 }
 
+static void updateNibbleCompareLut(void)
+{
+    for (unsigned nibble = 0; nibble < 16; nibble++) {
+        for (unsigned bit = 0; bit < WS2811_BITS_PER_NIBBLE; bit++) {
+            nibbleCompareLut[nibble][bit] = (nibble & (1 << (WS2811_BITS_PER_NIBBLE - 1 - bit))) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+        }
+    }
+
+    lutCompare1 = BIT_COMPARE_1;
+    lutCompare0 = BIT_COMPARE_0;
+    lutValid = true;
+}
+
 STATIC_UNIT_TESTED void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex)
 {
+    // the compare values are set by the timer setup
+    if (!lutValid || lutCompare1 != BIT_COMPARE_1 || lutCompare0 != BIT_COMPARE_0) {
+        updateNibbleCompareLut();
+    }
 
     uint32_t packed_colour;
 
@@ -154,9 +188,10 @@ STATIC_UNIT_TESTED void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbCol
         break;
     }
 
-    unsigned dmaBufferOffset = 0;
-    for (int index = 23; index >= 0; index--) {
-        ledStripDMABuffer[ledIndex * WS2811_BITS_PER_LED + dmaBufferOffset++] = (packed_colour & (1 << index)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+    ledStripDMAWord_t *dmaBuffer = &ledStripDMABuffer[ledIndex * WS2811_BITS_PER_LED];
+    for (int shift = WS2811_BITS_PER_LED - WS2811_BITS_PER_NIBBLE; shift >= 0; shift -= WS2811_BITS_PER_NIBBLE) {
+        memcpy(dmaBuffer, nibbleCompareLut[(packed_colour >> shift) & 0x0F], sizeof(nibbleCompareLut[0]));
+        dmaBuffer += WS2811_BITS_PER_NIBBLE;
     }
 }
 
@@ -176,13 +211,26 @@ void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat)
     // fill transmit buffer with correct compare values to achieve
     // correct pulse widths according to color values
     const unsigned ledUpdateCount = needsFullRefresh ? WS2811_DATA_BUFFER_SIZE : usedLedCount;
+#if defined(USE_WS2811_SINGLE_COLOUR)
+    // the DMA handler clears the buffer for the reset delay
+    const bool encodeAll = true;
+#else
+    const bool encodeAll = needsFullRefresh || ledFormat != encodedFormat;
+#endif
     const hsvColor_t hsvBlack = { 0, 0, 0 };
     while (ledIndex < ledUpdateCount) {
-        rgbColor24bpp_t *rgb24 = hsvToRgb24(ledIndex < usedLedCount ? &ledColorBuffer[ledIndex] : &hsvBlack);
+        const hsvColor_t *hsv = ledIndex < usedLedCount ? &ledColorBuffer[ledIndex] : &hsvBlack;
+        hsvColor_t *encoded = &encodedColorBuffer[ledIndex];
 
-        updateLEDDMABuffer(ledFormat, rgb24, ledIndex++);
+        if (encodeAll || hsv->h != encoded->h || hsv->s != encoded->s || hsv->v != encoded->v) {
+            rgbColor24bpp_t *rgb24 = hsvToRgb24(hsv);
+            updateLEDDMABuffer(ledFormat, rgb24, ledIndex);
+            *encoded = *hsv;
+        }
+        ledIndex++;
     }
     needsFullRefresh = false;
+    encodedFormat = ledFormat;
 
     ws2811LedDataTransferInProgress = true;
     ws2811LedStripDMAEnable();
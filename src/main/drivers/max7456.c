@@ -28,6 +28,8 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
+
 #include "pg/max7456.h"
 #include "pg/vcd.h"
 
@@ -178,8 +180,8 @@
     #define __spiBusTransactionBegin(busdev)        spiBusTransactionBegin(busdev)
     #define __spiBusTransactionEnd(busdev)          spiBusTransactionEnd(busdev)
 #else
-    #define __spiBusTransactionBegin(busdev)        {spiBusSetDivisor(busdev, max7456SpiClock);IOLo((busdev)->busdev_u.spi.csnPin);}
-    #define __spiBusTransactionEnd(busdev)       {IOHi((busdev)->busdev_u.spi.csnPin);spiSetDivisor((busdev)->busdev_u.spi.instance, MAX7456_RESTORE_CLK);}
+    #define __spiBusTransactionBegin(busdev)        {spiBusClaim(busdev);spiBusSetDivisor(busdev, max7456SpiClock);IOLo((busdev)->busdev_u.spi.csnPin);}
+    #define __spiBusTransactionEnd(busdev)       {IOHi((busdev)->busdev_u.spi.csnPin);spiSetDivisor((busdev)->busdev_u.spi.instance, MAX7456_RESTORE_CLK);spiBusRelease(busdev);}
 #endif
 
 #define MAX7456_SUPPORTED_LAYER_COUNT (DISPLAYPORT_LAYER_BACKGROUND + 1)
@@ -205,13 +207,29 @@ uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 
 static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
 
+// Rows changed since they were last compared with the shadow buffer, rows
+// without changes are skipped by max7456DrawScreen()
+static uint16_t dirtyRows = 0xFFFF;
+
+#define ROW_BIT(y)          (1 << (y))
+#define ALL_ROWS_DIRTY      0xFFFF
+
 //Max chars to update in one idle
 
 #define MAX_CHARS2UPDATE    100
+// runs of at least this many changed characters are sent in auto-increment mode
+#define MAX7456_AUTO_INCREMENT_RUN_MIN 3
 #ifdef MAX7456_DMA_CHANNEL_TX
 volatile bool dmaTransactionInProgress = false;
+
+// Screen updates go out in chunks, releasing the bus in between so a queued gyro read waits for one chunk at most
+static uint8_t *dmaChunkNext;
+static uint16_t dmaChunkRemaining;
 #endif
 
+// Whole DMAH/DMAL/DMDI character writes per chunk
+#define MAX7456_CHUNK_BYTES (SPI_BULK_CHUNK_BYTES / 6 * 6)
+
 static uint8_t spiBuff[MAX_CHARS2UPDATE*6];
 
 static uint8_t  videoSignalCfg;
@@ -257,7 +275,6 @@ static void max7456SendDma(void* tx_buffer, void* rx_buffer, uint16_t buffer_siz
 #else
     UNUSED(rx_buffer);
 #endif
-    while (dmaTransactionInProgress); // Wait for prev DMA transaction
 
     DMA_DeInit(MAX7456_DMA_CHANNEL_TX);
 #ifdef MAX7456_DMA_CHANNEL_RX
@@ -322,6 +339,17 @@ static void max7456SendDma(void* tx_buffer, void* rx_buffer, uint16_t buffer_siz
             SPI_I2S_DMAReq_Tx, ENABLE);
 }
 
+static void max7456SendDmaChunk(void)
+{
+    const uint16_t length = MIN(dmaChunkRemaining, MAX7456_CHUNK_BYTES);
+    uint8_t *chunk = dmaChunkNext;
+
+    dmaChunkNext += length;
+    dmaChunkRemaining -= length;
+
+    max7456SendDma(chunk, NULL, length);
+}
+
 void max7456_dma_irq_handler(dmaChannelDescriptor_t* descriptor)
 {
     if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
@@ -351,7 +379,12 @@ void max7456_dma_irq_handler(dmaChannelDescriptor_t* descriptor)
                 SPI_I2S_DMAReq_Tx, DISABLE);
 
         __spiBusTransactionEnd(busdev);
-        dmaTransactionInProgress = false;
+
+        if (dmaChunkRemaining) {
+            max7456SendDmaChunk();
+        } else {
+            dmaTransactionInProgress = false;
+        }
     }
 
     if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF)) {
@@ -374,12 +407,14 @@ uint8_t max7456GetRowsCount(void)
 static void max7456ClearShadowBuffer(void)
 {
     memset(shadowBuffer, 0, maxScreenSize);
+    dirtyRows = ALL_ROWS_DIRTY;
 }
 
 // Buffer is filled with the whitespace character (0x20)
 static void max7456ClearLayer(displayPortLayer_e layer)
 {
     memset(getLayerBuffer(layer), 0x20, VIDEO_BUFFER_CHARS_PAL);
+    dirtyRows = ALL_ROWS_DIRTY;
 }
 
 
@@ -613,8 +648,9 @@ void max7456ClearScreen(void)
 void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c)
 {
     uint8_t *buffer = getActiveLayerBuffer();
-    if (x < CHARS_PER_LINE && y < VIDEO_LINES_PAL) {
+    if (x < CHARS_PER_LINE && y < VIDEO_LINES_PAL && buffer[y * CHARS_PER_LINE + x] != c) {
         buffer[y * CHARS_PER_LINE + x] = c;
+        dirtyRows |= ROW_BIT(y);
     }
 }
 
@@ -623,7 +659,10 @@ void max7456Write(uint8_t x, uint8_t y, const char *buff)
     if (y < VIDEO_LINES_PAL) {
         uint8_t *buffer = getActiveLayerBuffer();
         for (int i = 0; buff[i] && x + i < CHARS_PER_LINE; i++) {
-            buffer[y * CHARS_PER_LINE + x + i] = buff[i];
+            if (buffer[y * CHARS_PER_LINE + x + i] != (uint8_t)buff[i]) {
+                buffer[y * CHARS_PER_LINE + x + i] = buff[i];
+                dirtyRows |= ROW_BIT(y);
+            }
         }
     }
 }
@@ -640,6 +679,10 @@ bool max7456LayerSupported(displayPortLayer_e layer)
 bool max7456LayerSelect(displayPortLayer_e layer)
 {
     if (max7456LayerSupported(layer)) {
+        if (layer != activeLayer) {
+            // the screen is drawn from the active layer, all of it has to be compared with the shadow again
+            dirtyRows = ALL_ROWS_DIRTY;
+        }
         activeLayer = layer;
         return true;
     } else {
@@ -650,7 +693,15 @@ bool max7456LayerSelect(displayPortLayer_e layer)
 bool max7456LayerCopy(displayPortLayer_e destLayer, displayPortLayer_e sourceLayer)
 {
     if ((sourceLayer != destLayer) && max7456LayerSupported(sourceLayer) && max7456LayerSupported(destLayer)) {
-        memcpy(getLayerBuffer(destLayer), getLayerBuffer(sourceLayer), VIDEO_BUFFER_CHARS_PAL);
+        uint8_t *dest = getLayerBuffer(destLayer);
+        const uint8_t *source = getLayerBuffer(sourceLayer);
+        // only the rows that differ need to be compared with the shadow buffer again
+        for (int y = 0; y < VIDEO_LINES_PAL; y++) {
+            if (memcmp(dest + y * CHARS_PER_LINE, source + y * CHARS_PER_LINE, CHARS_PER_LINE)) {
+                memcpy(dest + y * CHARS_PER_LINE, source + y * CHARS_PER_LINE, CHARS_PER_LINE);
+                dirtyRows |= ROW_BIT(y);
+            }
+        }
         return true;
     } else {
         return false;
@@ -731,6 +782,43 @@ void max7456ReInitIfRequired(bool forceStallCheck)
     //------------   end of (re)init-------------------------------------
 }
 
+// Appends the SPI writes for a run of changed characters. Short runs are written with
+// direct addressing, 6 bytes per character. Longer runs use the auto-increment mode,
+// 2 bytes per character plus 10 bytes to enter and leave the mode.
+static int max7456AppendRun(int len, const uint8_t *buffer, uint16_t start, uint8_t count)
+{
+    if (count < MAX7456_AUTO_INCREMENT_RUN_MIN) {
+        for (uint16_t pos = start; pos < start + count; pos++) {
+            spiBuff[len++] = MAX7456ADD_DMAH;
+            spiBuff[len++] = pos >> 8;
+            spiBuff[len++] = MAX7456ADD_DMAL;
+            spiBuff[len++] = pos & 0xff;
+            spiBuff[len++] = MAX7456ADD_DMDI;
+            spiBuff[len++] = buffer[pos];
+            shadowBuffer[pos] = buffer[pos];
+        }
+        return len;
+    }
+
+    spiBuff[len++] = MAX7456ADD_DMAH;
+    spiBuff[len++] = start >> 8;
+    spiBuff[len++] = MAX7456ADD_DMAL;
+    spiBuff[len++] = start & 0xff;
+    spiBuff[len++] = MAX7456ADD_DMM;
+    spiBuff[len++] = displayMemoryModeReg | 1;
+    for (uint16_t pos = start; pos < start + count; pos++) {
+        spiBuff[len++] = MAX7456ADD_DMDI;
+        spiBuff[len++] = buffer[pos];
+        shadowBuffer[pos] = buffer[pos];
+    }
+    spiBuff[len++] = MAX7456ADD_DMDI;
+    spiBuff[len++] = END_STRING;
+    spiBuff[len++] = MAX7456ADD_DMM;
+    spiBuff[len++] = displayMemoryModeReg;
+
+    return len;
+}
+
 void max7456DrawScreen(void)
 {
     static uint16_t pos = 0;
@@ -744,15 +832,38 @@ void max7456DrawScreen(void)
         uint8_t *buffer = getActiveLayerBuffer();
 
         int buff_len = 0;
+        uint16_t runStart = 0;
+        uint8_t runCount = 0;
         for (int k = 0; k < MAX_CHARS2UPDATE; k++) {
+            if (pos % CHARS_PER_LINE == 0) {
+                const uint16_t rowBit = ROW_BIT(pos / CHARS_PER_LINE);
+                if (!(dirtyRows & rowBit)) {
+                    // nothing written to this row, skip it without using up the update budget
+                    k--;
+                    pos += CHARS_PER_LINE;
+                    if (pos >= maxScreenSize) {
+                        pos = 0;
+                        break;
+                    }
+                    continue;
+                }
+                // cleared before the compare, a write during a sliced compare marks the row again
+                dirtyRows &= ~rowBit;
+            }
+
             if (buffer[pos] != shadowBuffer[pos]) {
-                spiBuff[buff_len++] = MAX7456ADD_DMAH;
-                spiBuff[buff_len++] = pos >> 8;
-                spiBuff[buff_len++] = MAX7456ADD_DMAL;
-                spiBuff[buff_len++] = pos & 0xff;
-                spiBuff[buff_len++] = MAX7456ADD_DMDI;
-                spiBuff[buff_len++] = buffer[pos];
-                shadowBuffer[pos] = buffer[pos];
+                if (runCount && runStart + runCount == pos && buffer[pos] != END_STRING) {
+                    runCount++;
+                } else {
+                    buff_len = max7456AppendRun(buff_len, buffer, runStart, runCount);
+                    runStart = pos;
+                    runCount = 1;
+                    if (buffer[pos] == END_STRING) {
+                        // 0xFF ends auto-increment mode, it is always written on its own
+                        buff_len = max7456AppendRun(buff_len, buffer, runStart, runCount);
+                        runCount = 0;
+                    }
+                }
             }
 
             if (++pos >= maxScreenSize) {
@@ -760,13 +871,23 @@ void max7456DrawScreen(void)
                 break;
             }
         }
+        buff_len = max7456AppendRun(buff_len, buffer, runStart, runCount);
 
         if (buff_len) {
 #ifdef MAX7456_DMA_CHANNEL_TX
-            max7456SendDma(spiBuff, NULL, buff_len);
+            while (dmaTransactionInProgress); // Wait for prev DMA transaction
+            dmaChunkNext = spiBuff;
+            dmaChunkRemaining = buff_len;
+            max7456SendDmaChunk();
 #else
             __spiBusTransactionBegin(busdev);
-            spiTransfer(busdev->busdev_u.spi.instance, spiBuff, NULL, buff_len);
+            for (int offset = 0; offset < buff_len; offset += MAX7456_CHUNK_BYTES) {
+                if (offset && spiBusIsContended(busdev)) {
+                    __spiBusTransactionEnd(busdev);
+                    __spiBusTransactionBegin(busdev);
+                }
+                spiTransfer(busdev->busdev_u.spi.instance, spiBuff + offset, NULL, MIN(buff_len - offset, MAX7456_CHUNK_BYTES));
+            }
             __spiBusTransactionEnd(busdev);
 #endif // MAX7456_DMA_CHANNEL_TX
         }
@@ -20,6 +20,9 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 typedef struct mpuRegion_s {
     uint32_t start;
     uint32_t end;        // Zero if determined by size member (MPU_REGION_SIZE_xxx)
@@ -36,3 +39,8 @@ extern unsigned mpuRegionCount;
 
 void memProtReset(void);
 void memProtConfigure(mpuRegion_t *mpuRegions, unsigned regionCount);
+void memProtUpdateRegion(unsigned number, const mpuRegion_t *region);
+
+#ifdef USE_QUADSPI
+void memProtSetQuadSpiMapped(bool mapped);
+#endif
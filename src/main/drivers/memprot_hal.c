@@ -29,65 +29,81 @@ static void memProtConfigError(void)
     for (;;) {}
 }
 
-void memProtConfigure(mpuRegion_t *regions, unsigned regionCount)
+static void memProtConfigureRegionNumber(unsigned number, const mpuRegion_t *region)
 {
     MPU_Region_InitTypeDef MPU_InitStruct;
 
-    if (regionCount > MAX_MPU_REGIONS) {
+    if (region->end == 0 && region->size == 0) {
         memProtConfigError();
     }
 
-    HAL_MPU_Disable();
-
     // Setup common members
     MPU_InitStruct.Enable           = MPU_REGION_ENABLE;
     MPU_InitStruct.SubRegionDisable = 0x00;
     MPU_InitStruct.TypeExtField     = MPU_TEX_LEVEL0;
 
-    for (unsigned number = 0; number < regionCount; number++) {
-        mpuRegion_t *region = &regions[number];
+    MPU_InitStruct.Number      = number;
+    MPU_InitStruct.BaseAddress = region->start;
+
+    if (region->size) {
+        MPU_InitStruct.Size = region->size;
+    } else {
+        // Adjust start of the region to align with cache line size.
+        uint32_t start = region->start & ~0x1F;
+        uint32_t length = region->end - start;
 
-        if (region->end == 0 && region->size == 0) {
-            memProtConfigError();
+        if (length < 32) {
+            // This will also prevent flsl from returning negative (case length == 0)
+            length = 32;
         }
 
-        MPU_InitStruct.Number      = number;
-        MPU_InitStruct.BaseAddress = region->start;
+        int msbpos = flsl(length) - 1;
 
-        if (region->size) {
-            MPU_InitStruct.Size = region->size;
-        } else {
-            // Adjust start of the region to align with cache line size.
-            uint32_t start = region->start & ~0x1F;
-            uint32_t length = region->end - start;
+        if (length == (1U << msbpos)) {
+            msbpos += 1;
+        }
 
-            if (length < 32) {
-                // This will also prevent flsl from returning negative (case length == 0)
-                length = 32;
-            }
+        MPU_InitStruct.Size = msbpos;
+    }
 
-            int msbpos = flsl(length) - 1;
+    // Copy per region attributes
+    MPU_InitStruct.AccessPermission = region->perm;
+    MPU_InitStruct.DisableExec      = region->exec;
+    MPU_InitStruct.IsShareable      = region->shareable;
+    MPU_InitStruct.IsCacheable      = region->cacheable;
+    MPU_InitStruct.IsBufferable     = region->bufferable;
 
-            if (length == (1U << msbpos)) {
-                msbpos += 1;
-            }
+    HAL_MPU_ConfigRegion(&MPU_InitStruct);
+}
 
-            MPU_InitStruct.Size = msbpos;
-        }
+void memProtConfigure(mpuRegion_t *regions, unsigned regionCount)
+{
+    if (regionCount > MAX_MPU_REGIONS) {
+        memProtConfigError();
+    }
 
-        // Copy per region attributes
-        MPU_InitStruct.AccessPermission = region->perm;
-        MPU_InitStruct.DisableExec      = region->exec;
-        MPU_InitStruct.IsShareable      = region->shareable;
-        MPU_InitStruct.IsCacheable      = region->cacheable;
-        MPU_InitStruct.IsBufferable     = region->bufferable;
+    HAL_MPU_Disable();
 
-        HAL_MPU_ConfigRegion(&MPU_InitStruct);
+    for (unsigned number = 0; number < regionCount; number++) {
+        memProtConfigureRegionNumber(number, &regions[number]);
     }
 
     HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
 }
 
+// Changes one region while the MPU stays enabled, the accesses after the call see the new attributes
+void memProtUpdateRegion(unsigned number, const mpuRegion_t *region)
+{
+    if (number >= MAX_MPU_REGIONS) {
+        memProtConfigError();
+    }
+
+    __DSB();
+    memProtConfigureRegionNumber(number, region);
+    __DSB();
+    __ISB();
+}
+
 void memProtReset(void)
 {
     MPU_Region_InitTypeDef MPU_InitStruct;
@@ -29,7 +29,26 @@ extern uint8_t dmaram_end;
 extern uint8_t dmarwaxi_start;
 extern uint8_t dmarwaxi_end;
 
+#ifdef USE_QUADSPI
+#define MPU_REGION_QUADSPI  0   // first entry of mpuRegions
+#endif
+
 mpuRegion_t mpuRegions[] = {
+#ifdef USE_QUADSPI
+    {
+        // QSPI memory mapped window, strongly ordered without access while the QSPI is in indirect mode.
+        // A speculative read of the window is only allowed from normal memory, so none is made that
+        // could stall the QSPI in indirect mode. Opened by memProtSetQuadSpiMapped().
+        .start      = QSPI_BASE,
+        .end        = 0, // Size defined by "size"
+        .size       = MPU_REGION_SIZE_256MB,
+        .perm       = MPU_REGION_NO_ACCESS,
+        .exec       = MPU_INSTRUCTION_ACCESS_DISABLE,
+        .shareable  = MPU_ACCESS_SHAREABLE,
+        .cacheable  = MPU_ACCESS_NOT_CACHEABLE,
+        .bufferable = MPU_ACCESS_NOT_BUFFERABLE,
+    },
+#endif
 #ifdef USE_ITCM_RAM
     {
         //  Mark ITCM-RAM as read-only
@@ -75,3 +94,19 @@ mpuRegion_t mpuRegions[] = {
 unsigned mpuRegionCount = ARRAYLEN(mpuRegions);
 
 STATIC_ASSERT(ARRAYLEN(mpuRegions) <= MAX_MPU_REGIONS, MPU_region_count_exceeds_limit);
+
+#ifdef USE_QUADSPI
+// Read only and cacheable while memory mapped, no access otherwise
+void memProtSetQuadSpiMapped(bool mapped)
+{
+    mpuRegion_t region = mpuRegions[MPU_REGION_QUADSPI];
+
+    if (mapped) {
+        region.perm = MPU_REGION_PRIV_RO_URO;
+        region.shareable = MPU_ACCESS_NOT_SHAREABLE;
+        region.cacheable = MPU_ACCESS_CACHEABLE;
+    }
+
+    memProtUpdateRegion(MPU_REGION_QUADSPI, &region);
+}
+#endif
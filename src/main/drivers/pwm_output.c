@@ -292,14 +292,52 @@ pwmOutputPort_t *pwmGetMotors(void)
 
 #ifdef USE_SERVOS
 static pwmOutputPort_t servos[MAX_SUPPORTED_SERVOS];
+static uint16_t servoPulses[MAX_SUPPORTED_SERVOS];  // staged by pwmWriteServo(), committed by pwmCompleteServoUpdate()
+static uint8_t servoOutputCount;
+static TIM_TypeDef *servoFrameTimer;                // all servo timers are restarted together, the first one times the frame
+static uint16_t servoFramePeriodUs;
+static timeUs_t servoLastCommitUs;
+static bool servoFrameAverage;
+static float servoPulseSum[MAX_SUPPORTED_SERVOS];   // of the writes since the last commit
+static uint16_t servoPulseCount[MAX_SUPPORTED_SERVOS];
 
 void pwmWriteServo(uint8_t index, float value)
 {
-    if (index < MAX_SUPPORTED_SERVOS && servos[index].channel.ccr) {
-        *servos[index].channel.ccr = lrintf(value);
+    if (index < MAX_SUPPORTED_SERVOS) {
+        servoPulses[index] = lrintf(value);
+        servoPulseSum[index] += value;
+        servoPulseCount[index]++;
     }
 }
 
+// Commit the staged pulses to the compare registers. The registers are preloaded and latched at the timer update,
+// so only the last commit before the update counts. With a window the commit is done only when the frame ends
+// within it, so the pulse always carries the freshest output. A frame without a commit is caught up right away.
+// With servo_frame_average the pulse is the mean of the outputs of the frame instead of the last one. The boxcar
+// over the frame period is the anti-alias filter of the servo frame rate, for half a frame of delay.
+void pwmCompleteServoUpdate(uint32_t windowUs)
+{
+    const timeUs_t currentTimeUs = micros();
+
+    if (windowUs && servoFrameTimer) {
+        const uint32_t frameRemainingUs = servoFrameTimer->ARR - servoFrameTimer->CNT;
+        if (frameRemainingUs > windowUs && cmpTimeUs(currentTimeUs, servoLastCommitUs) < servoFramePeriodUs) {
+            return;
+        }
+    }
+
+    for (int index = 0; index < servoOutputCount; index++) {
+        if (servoFrameAverage && servoPulseCount[index]) {
+            servoPulses[index] = lrintf(servoPulseSum[index] / servoPulseCount[index]);
+        }
+        servoPulseSum[index] = 0;
+        servoPulseCount[index] = 0;
+        *servos[index].channel.ccr = servoPulses[index];
+    }
+
+    servoLastCommitUs = currentTimeUs;
+}
+
 void servoDevInit(const servoDevConfig_t *servoConfig)
 {
     for (uint8_t servoIndex = 0; servoIndex < MAX_SUPPORTED_SERVOS; servoIndex++) {
@@ -329,6 +367,15 @@ void servoDevInit(const servoDevConfig_t *servoConfig)
         // HF3D:  Initialize with zero output to support servos with different center pulse widths (removed servoConfig->servoCenterPulse from next to last parameter)
         pwmOutConfig(&servos[servoIndex].channel, timer, PWM_TIMER_1MHZ, PWM_TIMER_1MHZ / servoConfig->servoPwmRate, 0, 0);
         servos[servoIndex].enabled = true;
+        servoOutputCount = servoIndex + 1;
+    }
+
+    // Restart the servo timers back to back so all the servo frames start together
+    servoFramePeriodUs = PWM_TIMER_1MHZ / servoConfig->servoPwmRate;
+    servoFrameAverage = servoConfig->servoFrameAverage;
+    servoFrameTimer = servoOutputCount ? servos[0].channel.tim : NULL;
+    for (int index = 0; index < servoOutputCount; index++) {
+        servos[index].channel.tim->EGR = TIM_EGR_UG;
     }
 }
 #endif // USE_SERVOS
@@ -64,6 +64,7 @@ typedef struct servoDevConfig_s {
     // PWM values, in milliseconds, common range is 1000-2000 (1ms to 2ms)
     uint16_t servoCenterPulse;              // HF3D TODO:  This was the value the servos are initialized to momentarily, but is no longer used.  Remove?
     uint16_t servoPwmRate;                  // The update rate of servo outputs (50-498Hz)
+    uint8_t  servoFrameAverage;             // output the mean of the frame instead of the last value
     ioTag_t  ioTags[MAX_SUPPORTED_SERVOS];
 } servoDevConfig_t;
 
@@ -74,6 +75,7 @@ void pwmServoConfig(const struct timerHardware_s *timerHardware, uint8_t servoIn
 void pwmOutConfig(timerChannel_t *channel, const timerHardware_t *timerHardware, uint32_t hz, uint16_t period, uint16_t value, uint8_t inversion);
 
 void pwmWriteServo(uint8_t index, float value);
+void pwmCompleteServoUpdate(uint32_t windowUs);
 
 pwmOutputPort_t *pwmGetMotors(void);
 bool pwmIsSynced(void);
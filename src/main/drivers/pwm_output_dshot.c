@@ -100,8 +100,14 @@ FAST_CODE void pwmDshotSetDirectionOutput(
     if (useBurstDshot) {
 #if defined(STM32F3)
         pDmaInit->DMA_DIR = DMA_DIR_PeripheralDST;
+#ifdef USE_DSHOT_TELEMETRY
+        pDmaInit->DMA_MemoryBaseAddr = (uint32_t)motor->timer->dmaBurstBuffer;
+#endif
 #else
         pDmaInit->DMA_DIR = DMA_DIR_MemoryToPeripheral;
+#ifdef USE_DSHOT_TELEMETRY
+        pDmaInit->DMA_Memory0BaseAddr = (uint32_t)motor->timer->dmaBurstBuffer;
+#endif
 #endif
     } else
 #endif
@@ -109,8 +115,14 @@ FAST_CODE void pwmDshotSetDirectionOutput(
 #if defined(STM32F3)
         pDmaInit->DMA_DIR = DMA_DIR_PeripheralDST;
         pDmaInit->DMA_M2M = DMA_M2M_Disable;
+#ifdef USE_DSHOT_TELEMETRY
+        pDmaInit->DMA_MemoryBaseAddr = (uint32_t)motor->dmaBuffer;
+#endif
 #elif defined(STM32F4)
         pDmaInit->DMA_DIR = DMA_DIR_MemoryToPeripheral;
+#ifdef USE_DSHOT_TELEMETRY
+        pDmaInit->DMA_Memory0BaseAddr = (uint32_t)motor->dmaBuffer;
+#endif
 #endif
     }
 
@@ -150,8 +162,10 @@ static void pwmDshotSetDirectionInput(
 #if defined(STM32F3)
     motor->dmaInitStruct.DMA_DIR = DMA_DIR_PeripheralSRC;
     motor->dmaInitStruct.DMA_M2M = DMA_M2M_Disable;
+    motor->dmaInitStruct.DMA_MemoryBaseAddr = (uint32_t)motor->dmaInputBuffer;
 #elif defined(STM32F4)
     motor->dmaInitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    motor->dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)motor->dmaInputBuffer;
 #endif
 
     xDMA_Init(dmaRef, pDmaInit);
@@ -213,6 +227,8 @@ static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor)
 
 #ifdef USE_DSHOT_TELEMETRY
         if (useDshotTelemetry) {
+            // the previous reply is still in the input buffer, decode it before capturing the next one
+            dshotDecodeTelemetry(motor);
             pwmDshotSetDirectionInput(motor);
             xDMA_SetCurrDataCounter(motor->dmaRef, GCR_TELEMETRY_INPUT_LEN);
             xDMA_Cmd(motor->dmaRef, ENABLE);
@@ -408,6 +424,7 @@ bool pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     motor->dmaRef = dmaRef;
 
 #ifdef USE_DSHOT_TELEMETRY
+    motor->dmaInputBuffer = &dshotDmaInputBuffer[motorIndex][0];
     motor->dshotTelemetryDeadtimeUs = DSHOT_TELEMETRY_DEADTIME_US + 1000000 *
         (16 * MOTOR_BITLENGTH) / getDshotHz(pwmProtocolType);
     motor->timer->outputPeriod = (pwmProtocolType == PWM_TYPE_PROSHOT1000 ? (MOTOR_NIBBLE_LENGTH_PROSHOT) : MOTOR_BITLENGTH) - 1;
@@ -92,6 +92,16 @@ void pwmDshotSetDirectionOutput(
     LL_TIM_OC_EnablePreload(timer, motor->llChannel);
 
     motor->dmaInitStruct.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+#ifdef USE_DSHOT_TELEMETRY
+#ifdef USE_DSHOT_DMAR
+    if (useBurstDshot) {
+        motor->dmaInitStruct.MemoryOrM2MDstAddress = (uint32_t)motor->timer->dmaBurstBuffer;
+    } else
+#endif
+    {
+        motor->dmaInitStruct.MemoryOrM2MDstAddress = (uint32_t)motor->dmaBuffer;
+    }
+#endif
 
     xLL_EX_DMA_Init(motor->dmaRef, pDmaInit);
     xLL_EX_DMA_EnableIT_TC(motor->dmaRef);
@@ -127,6 +137,7 @@ FAST_CODE static void pwmDshotSetDirectionInput(
 #endif
 
     motor->dmaInitStruct.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    motor->dmaInitStruct.MemoryOrM2MDstAddress = (uint32_t)motor->dmaInputBuffer;
     xLL_EX_DMA_Init(motor->dmaRef, pDmaInit);
 }
 #endif
@@ -185,6 +196,8 @@ FAST_CODE static void motor_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
 
 #ifdef USE_DSHOT_TELEMETRY
             if (useDshotTelemetry) {
+                // the previous reply is still in the input buffer, decode it before capturing the next one
+                dshotDecodeTelemetry(motor);
                 pwmDshotSetDirectionInput(motor);
                 xLL_EX_DMA_SetDataLength(motor->dmaRef, GCR_TELEMETRY_INPUT_LEN);
                 xLL_EX_DMA_EnableResource(motor->dmaRef);
@@ -376,6 +389,7 @@ bool pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     motor->dmaRef = dmaRef;
 
 #ifdef USE_DSHOT_TELEMETRY
+    motor->dmaInputBuffer = &dshotDmaInputBuffer[motorIndex][0];
     motor->dshotTelemetryDeadtimeUs = DSHOT_TELEMETRY_DEADTIME_US + 1000000 *
         ( 16 * MOTOR_BITLENGTH) / getDshotHz(pwmProtocolType);
     motor->timer->outputPeriod = (pwmProtocolType == PWM_TYPE_PROSHOT1000 ? (MOTOR_NIBBLE_LENGTH_PROSHOT) : MOTOR_BITLENGTH) - 1;
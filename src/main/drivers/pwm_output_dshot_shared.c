@@ -178,30 +178,59 @@ static uint32_t decodeTelemetryPacket(uint32_t buffer[], uint32_t count)
     if ((csum & 0xf) != 0xf) {
         return 0xffff;
     }
-    decodedValue >>= 4;
 
-    if (decodedValue == 0x0fff) {
-        return 0;
-    }
-    decodedValue = (decodedValue & 0x000001ff) << ((decodedValue & 0xfffffe00) >> 9);
-    if (!decodedValue) {
-        return 0xffff;
-    }
-    uint32_t ret = (1000000 * 60 / 100 + decodedValue / 2) / decodedValue;
-    return ret;
+    // 12 bit telemetry value, converted by dshotTelemetryDecodeValue()
+    return decodedValue >> 4;
 }
 
 #endif
 
 #ifdef USE_DSHOT_TELEMETRY
+// Called from the output DMA complete interrupt, before the input buffer is re-armed.
+// The reply was captured during the previous cycle, so its decode no longer delays the motor update.
+FAST_CODE void dshotDecodeTelemetry(motorDmaOutput_t *motor)
+{
+    const uint32_t edges = motor->dmaInputLen;
+    const uint8_t i = motor->index;
+
+    if (edges <= MIN_GCR_EDGES) {
+        return;
+    }
+    motor->dmaInputLen = 0;
+
+    dshotTelemetryState.readCount++;
+    const uint32_t value = decodeTelemetryPacket(motor->dmaInputBuffer, edges);
+
+#ifdef USE_DSHOT_TELEMETRY_STATS
+    bool validTelemetryPacket = false;
+#endif
+    // the stored values are single halfword or byte stores, readers never see a torn value
+    if (value != 0xffff && dshotTelemetryDecodeValue(i, value)) {
+        if (i < 2) {
+            // erpm/100 should never exceed ~32,767 (3.27M erpm)
+            DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i, (int16_t) dshotTelemetryState.motorState[i].telemetryValue);
+            // HF3D:  Also log invalid packet count on debug 2 & 3 since we only have a maximum of 2 motors.
+            DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i+2, dshotTelemetryState.invalidPacketCount);
+        }
+#ifdef USE_DSHOT_TELEMETRY_STATS
+        validTelemetryPacket = true;
+#endif
+    } else {
+        dshotTelemetryState.invalidPacketCount++;
+        if (i == 0) {
+            memcpy(dshotTelemetryState.inputBuffer, motor->dmaInputBuffer, sizeof(dshotTelemetryState.inputBuffer));
+        }
+    }
+#ifdef USE_DSHOT_TELEMETRY_STATS
+    updateDshotTelemetryQuality(&dshotTelemetryQuality[i], validTelemetryPacket, millis());
+#endif
+}
+
 FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(void)
 {
     if (!useDshotTelemetry) {
         return true;
     }
-#ifdef USE_DSHOT_TELEMETRY_STATS
-    const timeMs_t currentTimeMs = millis();
-#endif
     const timeUs_t currentUs = micros();
     for (int i = 0; i < dshotPwmDevice.count; i++) {
         timeDelta_t usSinceInput = cmpTimeUs(currentUs, inputStampUs);
@@ -210,9 +239,9 @@ FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(void)
         }
         if (dmaMotors[i].isInput) {
 #ifdef USE_FULL_LL_DRIVER
-            uint32_t edges = GCR_TELEMETRY_INPUT_LEN - xLL_EX_DMA_GetDataLength(dmaMotors[i].dmaRef);
+            const uint32_t edges = GCR_TELEMETRY_INPUT_LEN - xLL_EX_DMA_GetDataLength(dmaMotors[i].dmaRef);
 #else
-            uint32_t edges = GCR_TELEMETRY_INPUT_LEN - xDMA_GetCurrDataCounter(dmaMotors[i].dmaRef);
+            const uint32_t edges = GCR_TELEMETRY_INPUT_LEN - xDMA_GetCurrDataCounter(dmaMotors[i].dmaRef);
 #endif
 
 #ifdef USE_FULL_LL_DRIVER
@@ -220,38 +249,8 @@ FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(void)
 #else
             TIM_DMACmd(dmaMotors[i].timerHardware->tim, dmaMotors[i].timerDmaSource, DISABLE);
 #endif
-
-            uint16_t value = 0xffff;
-
-            if (edges > MIN_GCR_EDGES) {
-                dshotTelemetryState.readCount++;
-                value = decodeTelemetryPacket(dmaMotors[i].dmaBuffer, edges);
-                
-#ifdef USE_DSHOT_TELEMETRY_STATS
-                bool validTelemetryPacket = false;
-#endif
-                if (value != 0xffff) {
-                    dshotTelemetryState.motorState[i].telemetryValue = value;
-                    dshotTelemetryState.motorState[i].telemetryActive = true;
-                    if (i < 2) {
-                        // erpm/100 (value) should never exceed ~32,767 (3.27M erpm)
-                        DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i, (int16_t) value);
-                        // HF3D:  Also log invalid packet count on debug 2 & 3 since we only have a maximum of 2 motors.
-                        DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i+2, dshotTelemetryState.invalidPacketCount);
-                    }
-#ifdef USE_DSHOT_TELEMETRY_STATS
-                    validTelemetryPacket = true;
-#endif
-                } else {
-                    dshotTelemetryState.invalidPacketCount++;
-                    if (i == 0) {
-                        memcpy(dshotTelemetryState.inputBuffer,dmaMotors[i].dmaBuffer,sizeof(dshotTelemetryState.inputBuffer));
-                    }
-                }
-#ifdef USE_DSHOT_TELEMETRY_STATS
-                updateDshotTelemetryQuality(&dshotTelemetryQuality[i], validTelemetryPacket, currentTimeMs);
-            }
-#endif
+            // only latch the capture length here, dshotDecodeTelemetry() decodes it once the output is sent
+            dmaMotors[i].dmaInputLen = edges;
         }
         pwmDshotSetDirectionOutput(&dmaMotors[i]);
     }
@@ -72,6 +72,7 @@ void pwmDshotSetDirectionOutput(
 );
 
 bool pwmStartDshotMotorUpdate(void);
+void dshotDecodeTelemetry(motorDmaOutput_t *motor);
 
 #endif
 #endif
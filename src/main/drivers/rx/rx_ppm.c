@@ -0,0 +1,207 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#if defined(USE_PWM) || defined(USE_PPM)
+
+#include "drivers/rx/rx_pwm.h"
+
+#include "rx_ppm.h"
+
+// Longer than this without edges and the next DMA capture can not be trusted
+// (the 16 bit capture wraps every 65ms at 1MHz)
+#define PPM_SIGNAL_GAP_US           30000
+
+#define PPM_IN_MIN_SYNC_PULSE_US    2700    // microseconds
+#define PPM_IN_MIN_CHANNEL_PULSE_US 750     // microseconds
+#define PPM_IN_MAX_CHANNEL_PULSE_US 2250    // microseconds
+#define PPM_STABLE_FRAMES_REQUIRED_COUNT    25
+#define PPM_IN_MIN_NUM_CHANNELS     4
+#define PPM_IN_MAX_NUM_CHANNELS     PPM_CAPTURE_COUNT
+
+typedef struct ppmDecoder_s {
+    uint32_t captures[PPM_CAPTURE_COUNT];
+    uint8_t  pulseIndex;
+    int8_t   numChannels;
+    int8_t   numChannelsPrevFrame;
+    uint8_t  stableFramesSeenCount;
+
+    bool     tracking;
+} ppmDecoder_t;
+
+static ppmDecoder_t ppmDecoder;
+
+static uint16_t ppmChannels[PPM_CAPTURE_COUNT];
+
+static uint8_t ppmFrameCount = 0;
+static uint8_t lastPPMFrameCount = 0;
+
+static volatile uint16_t ppmRing[PPM_RING_SIZE];
+static volatile uint8_t ppmRingHead;
+static uint8_t ppmRingTail;
+
+static timeUs_t ppmLastEdgeUs;
+
+static uint16_t ppmLastCapture;
+static bool ppmCaptureValid;
+
+bool isPPMDataBeingReceived(void)
+{
+    return (ppmFrameCount != lastPPMFrameCount);
+}
+
+void resetPPMDataReceivedState(void)
+{
+    lastPPMFrameCount = ppmFrameCount;
+}
+
+void ppmDecoderReset(void)
+{
+    ppmDecoder.pulseIndex   = 0;
+    ppmDecoder.numChannels  = -1;
+    ppmDecoder.numChannelsPrevFrame = -1;
+    ppmDecoder.stableFramesSeenCount = 0;
+    ppmDecoder.tracking     = false;
+
+    ppmRingHead = 0;
+    ppmRingTail = 0;
+    ppmCaptureValid = false;
+}
+
+static void ppmDecodePulse(uint32_t deltaTime)
+{
+    int32_t i;
+
+    /* Sync pulse detection */
+    if (deltaTime > PPM_IN_MIN_SYNC_PULSE_US) {
+        if (ppmDecoder.pulseIndex == ppmDecoder.numChannelsPrevFrame
+            && ppmDecoder.pulseIndex >= PPM_IN_MIN_NUM_CHANNELS
+            && ppmDecoder.pulseIndex <= PPM_IN_MAX_NUM_CHANNELS) {
+            /* If we see n simultaneous frames of the same
+               number of channels we save it as our frame size */
+            if (ppmDecoder.stableFramesSeenCount < PPM_STABLE_FRAMES_REQUIRED_COUNT) {
+                ppmDecoder.stableFramesSeenCount++;
+            } else {
+                ppmDecoder.numChannels = ppmDecoder.pulseIndex;
+            }
+        } else {
+            ppmDecoder.stableFramesSeenCount = 0;
+        }
+
+        /* Check if the last frame was well formed */
+        if (ppmDecoder.pulseIndex == ppmDecoder.numChannels && ppmDecoder.tracking) {
+            /* The last frame was well formed */
+            for (i = 0; i < ppmDecoder.numChannels; i++) {
+                ppmChannels[i] = ppmDecoder.captures[i];
+            }
+            for (i = ppmDecoder.numChannels; i < PPM_IN_MAX_NUM_CHANNELS; i++) {
+                ppmChannels[i] = PPM_RCVR_TIMEOUT;
+            }
+            ppmFrameCount++;
+        }
+
+        ppmDecoder.tracking   = true;
+        ppmDecoder.numChannelsPrevFrame = ppmDecoder.pulseIndex;
+        ppmDecoder.pulseIndex = 0;
+
+        /* We rely on the supervisor to set captureValue to invalid
+           if no valid frame is found otherwise we ride over it */
+    } else if (ppmDecoder.tracking) {
+        /* Valid pulse duration 0.75 to 2.5 ms*/
+        if (deltaTime > PPM_IN_MIN_CHANNEL_PULSE_US
+            && deltaTime < PPM_IN_MAX_CHANNEL_PULSE_US
+            && ppmDecoder.pulseIndex < PPM_IN_MAX_NUM_CHANNELS) {
+            ppmDecoder.captures[ppmDecoder.pulseIndex] = deltaTime;
+            ppmDecoder.pulseIndex++;
+        } else {
+            /* Not a valid pulse duration */
+            ppmDecoder.tracking = false;
+            for (i = 0; i < PPM_CAPTURE_COUNT; i++) {
+                ppmDecoder.captures[i] = PPM_RCVR_TIMEOUT;
+            }
+        }
+    }
+}
+
+// Called from the edge ISR, a sync pulse may not fit in 16 bits
+void ppmQueuePulse(uint16_t width)
+{
+    ppmRing[ppmRingHead] = width;
+    ppmRingHead = (ppmRingHead + 1) & PPM_RING_MASK;
+}
+
+// The buffer the input capture DMA writes to, PPM_RING_SIZE half words
+volatile uint16_t *ppmCaptureRing(void)
+{
+    return ppmRing;
+}
+
+static void ppmDecodeRing(uint8_t head, timeUs_t currentTimeUs, bool rawCaptures)
+{
+    if (ppmRingTail == head) {
+        if (cmpTimeUs(currentTimeUs, ppmLastEdgeUs) > PPM_SIGNAL_GAP_US) {
+            ppmDecoder.tracking = false;
+            ppmCaptureValid = false;
+        }
+        return;
+    }
+
+    ppmLastEdgeUs = currentTimeUs;
+
+    while (ppmRingTail != head) {
+        const uint16_t sample = ppmRing[ppmRingTail];
+        ppmRingTail = (ppmRingTail + 1) & PPM_RING_MASK;
+
+        if (rawCaptures) {
+            const uint16_t previousCapture = ppmLastCapture;
+            ppmLastCapture = sample;
+            if (!ppmCaptureValid) {
+                ppmCaptureValid = true;
+                continue;
+            }
+            // 16 bit wraparound, the timer runs at 1MHz over the full period
+            ppmDecodePulse((uint16_t)(sample - previousCapture));
+        } else {
+            ppmDecodePulse(sample);
+        }
+    }
+}
+
+// Decodes the pulse widths queued by the edge ISR since the last call
+void ppmDecodePulses(timeUs_t currentTimeUs)
+{
+    ppmDecodeRing(ppmRingHead, currentTimeUs, false);
+}
+
+// Decodes the raw captures the DMA wrote up to head since the last call
+void ppmDecodeCaptures(uint8_t head, timeUs_t currentTimeUs)
+{
+    ppmDecodeRing(head & PPM_RING_MASK, currentTimeUs, true);
+}
+
+uint16_t ppmRead(uint8_t channel)
+{
+    return ppmChannels[channel];
+}
+#endif
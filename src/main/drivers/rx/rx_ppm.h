@@ -0,0 +1,41 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define PPM_CAPTURE_COUNT           12
+
+// Edges are queued in a ring and decoded by the rx task. With USE_PPM_DMA the
+// timer input capture DMA writes the raw captures into the ring in circular
+// mode, otherwise the edge ISR queues the pulse widths.
+#define PPM_RING_SIZE               64
+#define PPM_RING_MASK               (PPM_RING_SIZE - 1)
+
+void ppmDecoderReset(void);
+
+void ppmQueuePulse(uint16_t width);
+void ppmDecodePulses(timeUs_t currentTimeUs);
+
+volatile uint16_t *ppmCaptureRing(void);
+void ppmDecodeCaptures(uint8_t head, timeUs_t currentTimeUs);
@@ -28,27 +28,24 @@
 #include "build/build_config.h"
 #include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
+#include "drivers/dma.h"
+#include "drivers/dma_reqmap.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
 #include "drivers/pwm_output.h"
+#include "drivers/time.h"
 #include "drivers/timer.h"
 
 #include "pg/rx_pwm.h"
 
+#include "rx_ppm.h"
 #include "rx_pwm.h"
 
 #define DEBUG_PPM_ISR
 
-#define PPM_CAPTURE_COUNT 12
-
-#if PPM_CAPTURE_COUNT > PWM_INPUT_PORT_COUNT
-#define PWM_PORTS_OR_PPM_CAPTURE_COUNT PPM_CAPTURE_COUNT
-#else
-#define PWM_PORTS_OR_PPM_CAPTURE_COUNT PWM_INPUT_PORT_COUNT
-#endif
-
 // TODO - change to timer clocks ticks
 #define INPUT_FILTER_TO_HELP_WITH_NOISE_FROM_OPENLRS_TELEMETRY_RX 0x03
 
@@ -79,13 +76,11 @@ typedef struct {
 
 static pwmInputPort_t pwmInputPorts[PWM_INPUT_PORT_COUNT];
 
-static uint16_t captures[PWM_PORTS_OR_PPM_CAPTURE_COUNT];
+static uint16_t captures[PWM_INPUT_PORT_COUNT];
 
 #define PPM_TIMER_PERIOD 0x10000
 #define PWM_TIMER_PERIOD 0x10000
 
-static uint8_t ppmFrameCount = 0;
-static uint8_t lastPPMFrameCount = 0;
 static uint8_t ppmCountDivisor = 1;
 
 typedef struct ppmDevice_s {
@@ -93,35 +88,16 @@ typedef struct ppmDevice_s {
     uint32_t currentCapture;
     uint32_t currentTime;
     uint32_t deltaTime;
-    uint32_t captures[PWM_PORTS_OR_PPM_CAPTURE_COUNT];
     uint32_t largeCounter;
-    uint8_t  pulseIndex;
-    int8_t   numChannels;
-    int8_t   numChannelsPrevFrame;
-    uint8_t  stableFramesSeenCount;
 
-    bool     tracking;
     bool     overflowed;
 } ppmDevice_t;
 
 static ppmDevice_t ppmDev;
 
-#define PPM_IN_MIN_SYNC_PULSE_US    2700    // microseconds
-#define PPM_IN_MIN_CHANNEL_PULSE_US 750     // microseconds
-#define PPM_IN_MAX_CHANNEL_PULSE_US 2250    // microseconds
-#define PPM_STABLE_FRAMES_REQUIRED_COUNT    25
-#define PPM_IN_MIN_NUM_CHANNELS     4
-#define PPM_IN_MAX_NUM_CHANNELS     PWM_PORTS_OR_PPM_CAPTURE_COUNT
-
-bool isPPMDataBeingReceived(void)
-{
-    return (ppmFrameCount != lastPPMFrameCount);
-}
-
-void resetPPMDataReceivedState(void)
-{
-    lastPPMFrameCount = ppmFrameCount;
-}
+#ifdef USE_PPM_DMA
+static dmaResource_t *ppmDmaRef;
+#endif
 
 #define MIN_CHANNELS_BEFORE_PPM_FRAME_CONSIDERED_VALID 4
 
@@ -152,16 +128,13 @@ void ppmISREvent(eventSource_e source, uint32_t capture) {}
 
 static void ppmResetDevice(void)
 {
-    ppmDev.pulseIndex   = 0;
     ppmDev.currentCapture = 0;
     ppmDev.currentTime  = 0;
     ppmDev.deltaTime    = 0;
     ppmDev.largeCounter = 0;
-    ppmDev.numChannels  = -1;
-    ppmDev.numChannelsPrevFrame = -1;
-    ppmDev.stableFramesSeenCount = 0;
-    ppmDev.tracking     = false;
     ppmDev.overflowed   = false;
+
+    ppmDecoderReset();
 }
 
 static void ppmOverflowCallback(timerOvrHandlerRec_t* cbRec, captureCompare_t capture)
@@ -180,8 +153,6 @@ static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture
     UNUSED(cbRec);
     ppmISREvent(SOURCE_EDGE, capture);
 
-    int32_t i;
-
     uint32_t previousTime = ppmDev.currentTime;
     uint32_t previousCapture = ppmDev.currentCapture;
 
@@ -214,55 +185,20 @@ static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture
     ppmDev.currentTime = currentTime;
     ppmDev.currentCapture = capture;
 
-    /* Sync pulse detection */
-    if (ppmDev.deltaTime > PPM_IN_MIN_SYNC_PULSE_US) {
-        if (ppmDev.pulseIndex == ppmDev.numChannelsPrevFrame
-            && ppmDev.pulseIndex >= PPM_IN_MIN_NUM_CHANNELS
-            && ppmDev.pulseIndex <= PPM_IN_MAX_NUM_CHANNELS) {
-            /* If we see n simultaneous frames of the same
-               number of channels we save it as our frame size */
-            if (ppmDev.stableFramesSeenCount < PPM_STABLE_FRAMES_REQUIRED_COUNT) {
-                ppmDev.stableFramesSeenCount++;
-            } else {
-                ppmDev.numChannels = ppmDev.pulseIndex;
-            }
-        } else {
-            ppmDev.stableFramesSeenCount = 0;
-        }
-
-        /* Check if the last frame was well formed */
-        if (ppmDev.pulseIndex == ppmDev.numChannels && ppmDev.tracking) {
-            /* The last frame was well formed */
-            for (i = 0; i < ppmDev.numChannels; i++) {
-                captures[i] = ppmDev.captures[i];
-            }
-            for (i = ppmDev.numChannels; i < PPM_IN_MAX_NUM_CHANNELS; i++) {
-                captures[i] = PPM_RCVR_TIMEOUT;
-            }
-            ppmFrameCount++;
-        }
+    /* Queue the pulse width for ppmRxProcess() */
+    ppmQueuePulse(MIN(ppmDev.deltaTime, 0xFFFFU));
+}
 
-        ppmDev.tracking   = true;
-        ppmDev.numChannelsPrevFrame = ppmDev.pulseIndex;
-        ppmDev.pulseIndex = 0;
-
-        /* We rely on the supervisor to set captureValue to invalid
-           if no valid frame is found otherwise we ride over it */
-    } else if (ppmDev.tracking) {
-        /* Valid pulse duration 0.75 to 2.5 ms*/
-        if (ppmDev.deltaTime > PPM_IN_MIN_CHANNEL_PULSE_US
-            && ppmDev.deltaTime < PPM_IN_MAX_CHANNEL_PULSE_US
-            && ppmDev.pulseIndex < PPM_IN_MAX_NUM_CHANNELS) {
-            ppmDev.captures[ppmDev.pulseIndex] = ppmDev.deltaTime;
-            ppmDev.pulseIndex++;
-        } else {
-            /* Not a valid pulse duration */
-            ppmDev.tracking = false;
-            for (i = 0; i < PWM_PORTS_OR_PPM_CAPTURE_COUNT; i++) {
-                ppmDev.captures[i] = PPM_RCVR_TIMEOUT;
-            }
-        }
+// Called from the rx task, decodes the edges queued since the last call
+void ppmRxProcess(void)
+{
+#ifdef USE_PPM_DMA
+    if (ppmDmaRef) {
+        ppmDecodeCaptures(PPM_RING_SIZE - xDMA_GetCurrDataCounter(ppmDmaRef), micros());
+        return;
     }
+#endif
+    ppmDecodePulses(micros());
 }
 
 #define MAX_MISSED_PWM_EVENTS 10
@@ -270,7 +206,7 @@ static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture
 bool isPWMDataBeingReceived(void)
 {
     int channel;
-    for (channel = 0; channel < PWM_PORTS_OR_PPM_CAPTURE_COUNT; channel++) {
+    for (channel = 0; channel < PWM_INPUT_PORT_COUNT; channel++) {
         if (captures[channel] != PPM_RCVR_TIMEOUT) {
             return true;
         }
@@ -422,6 +358,49 @@ void ppmAvoidPWMTimerClash(TIM_TypeDef *pwmTimer)
 }
 #endif
 
+#ifdef USE_PPM_DMA
+// Timer input capture into the ring by DMA, no interrupt per edge
+static bool ppmDmaInit(const timerHardware_t *timer)
+{
+    const dmaChannelSpec_t *dmaSpec = dmaGetChannelSpecByTimer(timer);
+    if (!dmaSpec) {
+        return false;
+    }
+
+    const dmaIdentifier_e identifier = dmaGetIdentifier(dmaSpec->ref);
+    if (dmaGetOwner(identifier)->owner != OWNER_FREE) {
+        return false;
+    }
+
+    dmaInit(identifier, OWNER_PPMINPUT, 0);
+
+    DMA_InitTypeDef dmaInitStruct;
+    DMA_StructInit(&dmaInitStruct);
+    dmaInitStruct.DMA_Channel = dmaSpec->channel;
+    dmaInitStruct.DMA_PeripheralBaseAddr = (uint32_t)timerChCCR(timer);
+    dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)ppmCaptureRing();
+    dmaInitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    dmaInitStruct.DMA_BufferSize = PPM_RING_SIZE;
+    dmaInitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dmaInitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dmaInitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    dmaInitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    dmaInitStruct.DMA_Mode = DMA_Mode_Circular;
+    dmaInitStruct.DMA_Priority = DMA_Priority_Low;
+    dmaInitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+
+    xDMA_DeInit(dmaSpec->ref);
+    xDMA_Init(dmaSpec->ref, &dmaInitStruct);
+    xDMA_Cmd(dmaSpec->ref, ENABLE);
+
+    TIM_DMACmd(timer->tim, timerDmaSource(timer->channel), ENABLE);
+
+    ppmDmaRef = dmaSpec->ref;
+
+    return true;
+}
+#endif
+
 void ppmRxInit(const ppmConfig_t *ppmConfig)
 {
     ppmResetDevice();
@@ -450,6 +429,15 @@ void ppmRxInit(const ppmConfig_t *ppmConfig)
 #endif
 
     timerConfigure(timer, (uint16_t)PPM_TIMER_PERIOD, PWM_TIMER_1MHZ);
+
+#ifdef USE_PPM_DMA
+    // A timer shared with the motors does not run at 1MHz over the full 16 bit period
+    if (ppmCountDivisor == 1 && ppmDmaInit(timer)) {
+        pwmICConfig(timer->tim, timer->channel, TIM_ICPolarity_Rising);
+        return;
+    }
+#endif
+
     timerChCCHandlerInit(&port->edgeCb, ppmEdgeCallback);
     timerChOvrHandlerInit(&port->overflowCb, ppmOverflowCallback);
     timerChConfigCallbacks(timer, &port->edgeCb, &port->overflowCb);
@@ -461,11 +449,6 @@ void ppmRxInit(const ppmConfig_t *ppmConfig)
 #endif
 }
 
-uint16_t ppmRead(uint8_t channel)
-{
-    return captures[channel];
-}
-
 uint16_t pwmRead(uint8_t channel)
 {
     return captures[channel];
@@ -35,6 +35,7 @@ void pwmRxInit(const struct pwmConfig_s *pwmConfig);
 
 uint16_t pwmRead(uint8_t channel);
 uint16_t ppmRead(uint8_t channel);
+void ppmRxProcess(void);
 
 bool isPPMDataBeingReceived(void);
 void resetPPMDataReceivedState(void);
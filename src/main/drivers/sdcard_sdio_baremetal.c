@@ -44,8 +44,10 @@
 #include "drivers/sdmmc_sdio.h"
 
 // Use this to speed up writing to SDCARD... asyncfatfs has limited support for multiblock write
+// The consecutive blocks of a multi-block write are collected and sent with one CMD25 DMA transfer. The cache is in the
+// RAM that the H7 IDMA can reach, aligned to the cache lines that are cleaned before the transfer.
 #define FATFS_BLOCK_CACHE_SIZE 16
-uint8_t writeCache[512 * FATFS_BLOCK_CACHE_SIZE] __attribute__ ((aligned (4)));
+static DMA_RW_AXI uint8_t writeCache[512 * FATFS_BLOCK_CACHE_SIZE] __attribute__ ((aligned (32)));
 uint32_t cacheCount = 0;
 
 void cache_write(uint8_t *buffer)
@@ -85,6 +87,9 @@ static bool sdcardSdio_isFunctional(void)
  */
 static void sdcard_reset(void)
 {
+    // The blocks still in the cache were reported as written, they are lost with the card
+    cache_reset();
+
     if (SD_Init() != 0) {
         sdcard.failureCount++;
         if (sdcard.failureCount >= SDCARD_MAX_CONSECUTIVE_FAILURES || !sdcard_isInserted()) {
@@ -267,11 +272,49 @@ static bool sdcard_isReady()
  *                                    the SDCARD_READY state.
  *
  */
+/**
+ * Send the blocks collected in the cache, that the caller was already told are written, as one multi-block write.
+ * They end at the next block of the chain.
+ */
+static bool sdcard_writeCachedBlocks(void)
+{
+    const uint16_t blockCount = cache_getCount();
+
+    sdcard.pendingOperation.buffer = writeCache;
+    sdcard.pendingOperation.blockIndex = sdcard.multiWriteNextBlock - blockCount;
+    sdcard.pendingOperation.callback = NULL;
+    sdcard.pendingOperation.callbackData = 0;
+    sdcard.state = SDCARD_STATE_SENDING_WRITE;
+
+    if (SD_WriteBlocks_DMA(sdcard.pendingOperation.blockIndex, (uint32_t *)writeCache, 512, blockCount) != SD_OK) {
+        sdcard_reset();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Start sending the cached blocks of an ended chain. Returns false if the cache was empty.
+ * The card is busy until that write completes, reads and new writes wait for it.
+ */
+static bool sdcard_flushCache(void)
+{
+    if (!sdcard.useCache || !cache_getCount()) {
+        return false;
+    }
+
+    sdcard_writeCachedBlocks();
+    return true;
+}
+
 static sdcardOperationStatus_e sdcard_endWriteBlocks()
 {
     sdcard.multiWriteBlocksRemain = 0;
-    if (sdcard.useCache) {
-        cache_reset();
+
+    if (sdcard.useCache && cache_getCount()) {
+        // The chain ends early, flush the cache instead of dropping it. The card is busy until that write completes.
+        return sdcard_writeCachedBlocks() ? SDCARD_OPERATION_IN_PROGRESS : SDCARD_OPERATION_FAILURE;
     }
 
     // 8 dummy clocks to guarantee N_WR clocks between the last card response and this token
@@ -362,13 +405,13 @@ static bool sdcardSdio_poll(void)
 
                 sdcard.failureCount = 0; // Assume the card is good if it can complete a write
 
+                // The cached blocks of that write are on the card now
+                cache_reset();
+
                 // Still more blocks left to write in a multi-block chain?
                 if (sdcard.multiWriteBlocksRemain > 1) {
                     sdcard.multiWriteBlocksRemain--;
                     sdcard.multiWriteNextBlock++;
-                    if (sdcard.useCache) {
-                        cache_reset();
-                    }
                     sdcard.state = SDCARD_STATE_WRITING_MULTIPLE_BLOCKS;
                 } else if (sdcard.multiWriteBlocksRemain == 1) {
                     // This function changes the sd card state for us whether immediately succesful or delayed:
@@ -490,6 +533,10 @@ static sdcardOperationStatus_e sdcardSdio_writeBlock(uint32_t blockIndex, uint8_
             // We're continuing a multi-block write
         break;
         case SDCARD_STATE_READY:
+            // Cached blocks only exist within a chain, but never write around them
+            if (sdcard_flushCache()) {
+                return SDCARD_OPERATION_BUSY;
+            }
         break;
         default:
             return SDCARD_OPERATION_BUSY;
@@ -498,9 +545,10 @@ static sdcardOperationStatus_e sdcardSdio_writeBlock(uint32_t blockIndex, uint8_
     sdcard.pendingOperation.buffer = buffer;
     sdcard.pendingOperation.blockIndex = blockIndex;
 
+    // Only the consecutive blocks of a chain are cached, the contiguity was checked above
     uint16_t block_count = 1;
-    if ((cache_getCount() < FATFS_BLOCK_CACHE_SIZE) &&
-        (sdcard.multiWriteBlocksRemain != 0) && sdcard.useCache) {
+    if (sdcard.state == SDCARD_STATE_WRITING_MULTIPLE_BLOCKS && sdcard.useCache &&
+        (cache_getCount() < FATFS_BLOCK_CACHE_SIZE) && (sdcard.multiWriteBlocksRemain != 0)) {
         cache_write(buffer);
         if (cache_getCount() == FATFS_BLOCK_CACHE_SIZE || sdcard.multiWriteBlocksRemain == 1) {
             //Relocate buffer
@@ -509,9 +557,9 @@ static sdcardOperationStatus_e sdcardSdio_writeBlock(uint32_t blockIndex, uint8_
             blockIndex -= cache_getCount() - 1;
             block_count = cache_getCount();
         } else {
+            // The chain continues, the next block must follow this one
             sdcard.multiWriteBlocksRemain--;
             sdcard.multiWriteNextBlock++;
-            sdcard.state = SDCARD_STATE_READY;
             return SDCARD_OPERATION_SUCCESS;
         }
     }
@@ -563,6 +611,8 @@ static sdcardOperationStatus_e sdcardSdio_beginWriteBlocks(uint32_t blockIndex,
         } else {
             return SDCARD_OPERATION_BUSY;
         }
+    } else if (sdcard_flushCache()) {
+        return SDCARD_OPERATION_BUSY;
     }
 
     sdcard.state = SDCARD_STATE_WRITING_MULTIPLE_BLOCKS;
@@ -593,6 +643,9 @@ static bool sdcardSdio_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_op
 		} else {
 			return false;
 		}
+    } else if (sdcard_flushCache()) {
+        // The block may be in the cache, read it from the card once the cache is written
+        return false;
     }
 
 #ifdef SDCARD_PROFILING
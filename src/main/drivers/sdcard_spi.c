@@ -46,6 +46,7 @@
 
 #define SDCARD_INIT_NUM_DUMMY_BYTES                 10
 #define SDCARD_MAXIMUM_BYTE_DELAY_FOR_CMD_REPLY     8
+#define SDCARD_POWER_UP_TIME_MS                     1000
 // Chosen so that CMD8 will have the same CRC as CMD0:
 #define SDCARD_IF_COND_CHECK_PATTERN                0xAB
 
@@ -550,8 +551,12 @@ static void sdcardSpi_init(const sdcardConfig_t *config, const spiPinConfig_t *s
     spiSetDivisor(sdcard.busdev.busdev_u.spi.instance, SDCARD_SPI_INITIALIZATION_CLOCK_DIVIDER);
 #endif
 
-    // SDCard wants 1ms minimum delay after power is applied to it
-    delay(1000);
+    // SDCard wants 1ms minimum delay after power is applied to it, slow cards take longer.
+    // The card is powered with the board, so only what is left of that since boot needs waiting for.
+    const timeMs_t now = millis();
+    if (now < SDCARD_POWER_UP_TIME_MS) {
+        delay(SDCARD_POWER_UP_TIME_MS - now);
+    }
 
     // Transmit at least 74 dummy clock cycles with CS high so the SD card can start up
     IOHi(sdcard.busdev.busdev_u.spi.csnPin);
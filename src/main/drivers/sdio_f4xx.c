@@ -1684,7 +1684,7 @@ bool SD_Init(void)
             ErrorState = SD_WideBusOperationConfig(SD_BUS_WIDE_1B);
         }
         if (ErrorState == SD_OK && sdioConfig()->clockBypass) {
-            if (SD_HighSpeed()) {
+            if (SD_HighSpeed() == SD_OK) {
                 SDIO->CLKCR |= SDIO_CLKCR_BYPASS;
                 SDIO->CLKCR |= SDIO_CLKCR_NEGEDGE;
             }
@@ -235,6 +235,7 @@ static SD_Error_t       SD_InitializeCard           (void);
 
 static SD_Error_t       SD_PowerON                  (void);
 static SD_Error_t       SD_WideBusOperationConfig   (uint32_t WideMode);
+static SD_Error_t       SD_HighSpeed                (void);
 static SD_Error_t       SD_FindSCR                  (uint32_t *pSCR);
 
 void SDMMC_DMA_ST3_IRQHandler(dmaChannelDescriptor_t *dma);
@@ -1113,8 +1114,7 @@ static SD_Error_t SD_WideBusOperationConfig(uint32_t WideMode)
   *         This API must be used after "Transfer State"
   * @retval SD Card error state
   */
-/*
-SD_Error_t HAL_SD_HighSpeed(void)
+static SD_Error_t SD_HighSpeed(void)
 {
     SD_Error_t  ErrorState;
     uint8_t     SD_hs[64]  = {0};
@@ -1138,16 +1138,16 @@ SD_Error_t HAL_SD_HighSpeed(void)
     if(SD_SPEC != SD_ALLZERO)
     {
         // Set Block Size for Card
-        if((ErrorState = SD_TransmitCommand((SD_CMD_SET_BLOCKLEN | SDMMC_CMD_RESPONSE_SHORT), 64, 1)) != SD_OK)
+        if((ErrorState = SD_TransmitCommand((SD_CMD_SET_BLOCKLEN | SD_CMD_RESPONSE_SHORT), 64, 1)) != SD_OK)
         {
             return ErrorState;
         }
 
         // Configure the SD DPSM (Data Path State Machine)
-        SD_DataTransferInit(64, SDMMC_DATABLOCK_SIZE_64B, true);
+        SD_DataTransferInit(64, SD_DATABLOCK_SIZE_64B, true);
 
         // Send CMD6 switch mode
-        if((ErrorState =SD_TransmitCommand((SD_CMD_HS_SWITCH | SDMMC_CMD_RESPONSE_SHORT), 0x80FFFF01, 1)) != SD_OK)
+        if((ErrorState =SD_TransmitCommand((SD_CMD_HS_SWITCH | SD_CMD_RESPONSE_SHORT), 0x80FFFF01, 1)) != SD_OK)
         {
             return ErrorState;
         }
@@ -1188,8 +1188,6 @@ SD_Error_t HAL_SD_HighSpeed(void)
     return ErrorState;
 }
 
-*/
-
 
 /** -----------------------------------------------------------------------------------------------------------------*/
 /**
@@ -1666,6 +1664,12 @@ bool SD_Init(void)
         } else {
             ErrorState = SD_WideBusOperationConfig(SD_BUS_WIDE_1B);
         }
+        // High speed cards take the 48MHz SDMMC clock undivided
+        if (ErrorState == SD_OK && sdioConfig()->clockBypass) {
+            if (SD_HighSpeed() == SD_OK) {
+                SDMMC1->CLKCR |= SDMMC_CLKCR_BYPASS;
+            }
+        }
     }
 
     // Configure the SDCARD device
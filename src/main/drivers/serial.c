@@ -20,9 +20,12 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "common/maths.h"
+
 #include "serial.h"
 
 void serialPrint(serialPort_t *instance, const char *str)
@@ -48,6 +51,19 @@ void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
 {
     if (instance->vTable->writeBuf) {
         instance->vTable->writeBuf(instance, data, count);
+    } else if (instance->vTable->reserveWrite) {
+        while (count > 0) {
+            uint32_t available;
+            uint8_t *buffer = instance->vTable->reserveWrite(instance, &available);
+            const uint32_t length = MIN(available, (uint32_t)count);
+
+            if (length) {
+                memcpy(buffer, data, length);
+                instance->vTable->commitWrite(instance, length);
+                data += length;
+                count -= length;
+            }
+        }
     } else {
         for (const uint8_t *p = data; count > 0; count--, p++) {
 
@@ -123,3 +139,20 @@ void serialEndWrite(serialPort_t *instance)
     if (instance->vTable->endWrite)
         instance->vTable->endWrite(instance);
 }
+
+uint8_t *serialReserveWrite(serialPort_t *instance, uint32_t *available)
+{
+    if (instance->vTable->reserveWrite) {
+        return instance->vTable->reserveWrite(instance, available);
+    }
+
+    *available = 0;
+    return NULL;
+}
+
+void serialCommitWrite(serialPort_t *instance, uint32_t count)
+{
+    if (instance->vTable->commitWrite && count) {
+        instance->vTable->commitWrite(instance, count);
+    }
+}
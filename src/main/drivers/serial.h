@@ -126,6 +126,10 @@ struct serialPortVTable {
     // Optional functions used to buffer large writes.
     void (*beginWrite)(serialPort_t *instance);
     void (*endWrite)(serialPort_t *instance);
+
+    // Optional zero-copy writes, contiguous TX buffer space is handed out and sent once committed.
+    uint8_t *(*reserveWrite)(serialPort_t *instance, uint32_t *available);
+    void (*commitWrite)(serialPort_t *instance, uint32_t count);
 };
 
 void serialWrite(serialPort_t *instance, uint8_t ch);
@@ -145,3 +149,6 @@ uint32_t serialGetBaudRate(serialPort_t *instance);
 void serialWriteBufShim(void *instance, const uint8_t *data, int count);
 void serialBeginWrite(serialPort_t *instance);
 void serialEndWrite(serialPort_t *instance);
+// Reserve returns NULL when the port has no zero-copy support, commit at most the reserved count
+uint8_t *serialReserveWrite(serialPort_t *instance, uint32_t *available);
+void serialCommitWrite(serialPort_t *instance, uint32_t count);
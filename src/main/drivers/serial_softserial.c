@@ -35,8 +35,11 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
+#include "drivers/dma.h"
+#include "drivers/dma_reqmap.h"
 #include "drivers/nvic.h"
 #include "drivers/io.h"
 #include "drivers/serial.h"
@@ -61,6 +64,21 @@ typedef enum {
 #define ICPOLARITY_RISING true
 #define ICPOLARITY_FALLING false
 
+#ifdef USE_SOFTSERIAL_DMA
+#define SOFTSERIAL_DMA_TICKS_PER_BIT    16
+#define SOFTSERIAL_DMA_RX_EDGES         256     // power of two
+#define SOFTSERIAL_DMA_RX_HALF          (SOFTSERIAL_DMA_RX_EDGES / 2)
+#define SOFTSERIAL_DMA_TX_BYTES         8
+#define SOFTSERIAL_DMA_TX_LEAD_BITS     2       // delay of the first transition, covers the setup
+
+typedef enum {
+    SOFTSERIAL_TX_IDLE = 0,
+    SOFTSERIAL_TX_SENDING,      // the output compare is reloaded by DMA
+    SOFTSERIAL_TX_LAST_EDGE,    // waiting for the last transition
+    SOFTSERIAL_TX_STOP_BIT,     // waiting for the end of the last stop bit
+} softSerialTxState_e;
+#endif
+
 typedef struct softSerial_s {
     serialPort_t     port;
 
@@ -90,12 +108,40 @@ typedef struct softSerial_s {
 
     uint16_t         transmissionErrors;
     uint16_t         receiveErrors;
+    uint16_t         receiveOverruns;   // bytes or captured edges overwritten before they were read
 
     uint8_t          softSerialPortIndex;
     timerMode_e      timerMode;
 
     timerOvrHandlerRec_t overCb;
     timerCCHandlerRec_t edgeCb;
+
+#ifdef USE_SOFTSERIAL_DMA
+    // DMA engine, NULL streams when the interrupt engine is used
+    dmaResource_t   *rxDmaRef;
+    dmaResource_t   *txDmaRef;          // same stream as rxDmaRef in half-duplex
+    uint32_t         rxDmaChannel;
+    uint32_t         txDmaChannel;
+    const timerHardware_t *txTimerHardware;
+    uint32_t         rxBitTicks;        // timer ticks per bit, 8 bit fraction
+    uint32_t         txBitTicks;
+
+    volatile uint16_t rxEdges[SOFTSERIAL_DMA_RX_EDGES]; // captures of both edges
+    dmaChannelDescriptor_t *rxDmaDescriptor;
+    uint16_t         rxEdgeTail;
+    uint8_t          rxEdgeFlagsPending; // half and complete flags the last head passed, not set yet when read
+    uint16_t         rxFrameStart;
+    uint16_t         rxFrame;
+    uint8_t          rxFrameBits;
+    bool             rxInFrame;
+    bool             rxMark;            // line level after the last decoded edge
+    volatile bool    rxRestart;         // set when the capture restarts at the start of the buffer
+
+    uint32_t         txEdges[2][SOFTSERIAL_DMA_TX_BYTES * TX_TOTAL_BITS];   // word writes, TIM2/TIM5 have 32 bit compares
+    uint32_t         txFrameTime;       // start of the next frame, 8 bit fraction
+    uint8_t          txBlock;
+    volatile uint8_t txState;
+#endif
 } softSerial_t;
 
 static const struct serialPortVTable softSerialVTable; // Forward
@@ -231,6 +277,497 @@ static void resetBuffers(softSerial_t *softSerial)
     softSerial->port.txBufferHead = 0;
 }
 
+static void softSerialStoreRxByte(softSerial_t *softSerial, uint8_t rxByte)
+{
+    if (softSerial->port.rxCallback) {
+        softSerial->port.rxCallback(rxByte, softSerial->port.rxCallbackData);
+    } else {
+        const uint32_t head = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+        if (head == softSerial->port.rxBufferTail) {
+            // Full, a wrapped head would discard the whole buffer
+            softSerial->receiveOverruns++;
+            return;
+        }
+        softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
+        softSerial->port.rxBufferHead = head;
+    }
+}
+
+#ifdef USE_SOFTSERIAL_DMA
+/*
+ * DMA engine
+ *
+ * The receiver captures both edges of the line into a ring by DMA, the
+ * softserial task decodes the frames from the edge times afterwards.
+ * The transmitter precomputes the times of the line transitions of up to
+ * SOFTSERIAL_DMA_TX_BYTES bytes, DMA reloads the output compare of a
+ * channel in toggle mode with them. There are no per bit interrupts, only
+ * one per block of transitions and two at the end of a transmission.
+ */
+
+static void softSerialDmaConfigureTimebase(const timerHardware_t *timer, uint32_t baud, uint32_t *bitTicks)
+{
+    const uint32_t clock = timerClock(timer->tim);
+    const uint32_t divider = MAX(clock / (baud * SOFTSERIAL_DMA_TICKS_PER_BIT), 1U);
+
+    timerConfigure(timer, 0, clock / divider);
+
+    *bitTicks = ((uint64_t)clock << 8) / ((uint64_t)divider * baud);
+}
+
+static void softSerialDmaConfigureTimebases(softSerial_t *softSerial, uint32_t baud)
+{
+    if (softSerial->rxDmaRef) {
+        softSerialDmaConfigureTimebase(softSerial->timerHardware, baud, &softSerial->rxBitTicks);
+    }
+
+    if (softSerial->txTimerHardware) {
+        if (softSerial->rxDmaRef && softSerial->txTimerHardware->tim == softSerial->timerHardware->tim) {
+            softSerial->txBitTicks = softSerial->rxBitTicks;
+        } else {
+            softSerialDmaConfigureTimebase(softSerial->txTimerHardware, baud, &softSerial->txBitTicks);
+        }
+    }
+}
+
+static void softSerialDmaStartRx(softSerial_t *softSerial)
+{
+    const timerHardware_t *timer = softSerial->timerHardware;
+
+    TIM_ICInitTypeDef icInit;
+    TIM_ICStructInit(&icInit);
+    icInit.TIM_Channel = timer->channel;
+    icInit.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+    icInit.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    icInit.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    icInit.TIM_ICFilter = 2;
+    TIM_ICInit(timer->tim, &icInit);
+
+    DMA_InitTypeDef dmaInitStruct;
+    DMA_StructInit(&dmaInitStruct);
+    dmaInitStruct.DMA_Channel = softSerial->rxDmaChannel;
+    dmaInitStruct.DMA_PeripheralBaseAddr = (uint32_t)timerChCCR(timer);
+    dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)softSerial->rxEdges;
+    dmaInitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    dmaInitStruct.DMA_BufferSize = SOFTSERIAL_DMA_RX_EDGES;
+    dmaInitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dmaInitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dmaInitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    dmaInitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    dmaInitStruct.DMA_Mode = DMA_Mode_Circular;
+    dmaInitStruct.DMA_Priority = DMA_Priority_Low;
+    dmaInitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+
+    xDMA_DeInit(softSerial->rxDmaRef);
+    xDMA_Init(softSerial->rxDmaRef, &dmaInitStruct);
+    xDMA_ITConfig(softSerial->rxDmaRef, DMA_IT_TC, DISABLE);
+
+    // The ring restarts at its first entry, the decoder follows
+    dmaChannelDescriptor_t *descriptor = softSerial->rxDmaDescriptor;
+    DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF | DMA_IT_HTIF);
+    softSerial->rxRestart = true;
+
+    xDMA_Cmd(softSerial->rxDmaRef, ENABLE);
+    TIM_DMACmd(timer->tim, timerDmaSource(timer->channel), ENABLE);
+
+    serialInputPortActivate(softSerial);
+}
+
+static void softSerialDmaStopRx(softSerial_t *softSerial)
+{
+    const timerHardware_t *timer = softSerial->timerHardware;
+
+    TIM_DMACmd(timer->tim, timerDmaSource(timer->channel), DISABLE);
+    xDMA_Cmd(softSerial->rxDmaRef, DISABLE);
+
+    serialInputPortDeActivate(softSerial);
+}
+
+// Set the output compare mode without going through a full channel init
+static void softSerialDmaSetOCMode(const timerHardware_t *timer, uint16_t ocMode)
+{
+    const uint8_t shift = (timer->channel == TIM_Channel_2 || timer->channel == TIM_Channel_4) ? 8 : 0;
+    volatile uint16_t *ccmr = (timer->channel < TIM_Channel_3) ? &timer->tim->CCMR1 : &timer->tim->CCMR2;
+
+    *ccmr = (*ccmr & ~(TIM_CCMR1_OC1M << shift)) | (ocMode << shift);
+}
+
+static void softSerialDmaConfigTx(softSerial_t *softSerial)
+{
+    const timerHardware_t *timer = softSerial->txTimerHardware;
+
+    TIM_OCInitTypeDef ocInit;
+    TIM_OCStructInit(&ocInit);
+    ocInit.TIM_OCMode = TIM_OCMode_Timing;
+    ocInit.TIM_OutputState = TIM_OutputState_Disable;
+    ocInit.TIM_OCPolarity = (softSerial->port.options & SERIAL_INVERTED) ? TIM_OCPolarity_Low : TIM_OCPolarity_High;
+    ocInit.TIM_Pulse = 0;
+    timerOCInit(timer->tim, timer->channel, &ocInit);
+    timerOCPreloadConfig(timer->tim, timer->channel, TIM_OCPreload_Disable);
+
+    // The line idles at mark
+    softSerialDmaSetOCMode(timer, TIM_ForcedAction_Active);
+    TIM_CCxCmd(timer->tim, timer->channel, TIM_CCx_Enable);
+    TIM_CtrlPWMOutputs(timer->tim, ENABLE);
+
+    IOConfigGPIOAF(softSerial->txIO, IOCFG_AF_PP, timer->alternateFunction);
+
+    DMA_InitTypeDef dmaInitStruct;
+    DMA_StructInit(&dmaInitStruct);
+    dmaInitStruct.DMA_Channel = softSerial->txDmaChannel;
+    dmaInitStruct.DMA_PeripheralBaseAddr = (uint32_t)timerChCCR(timer);
+    dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)softSerial->txEdges[0];
+    dmaInitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    dmaInitStruct.DMA_BufferSize = 1;
+    dmaInitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dmaInitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dmaInitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    dmaInitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    dmaInitStruct.DMA_Mode = DMA_Mode_Normal;
+    dmaInitStruct.DMA_Priority = DMA_Priority_High;
+    dmaInitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+
+    xDMA_DeInit(softSerial->txDmaRef);
+    xDMA_Init(softSerial->txDmaRef, &dmaInitStruct);
+    xDMA_ITConfig(softSerial->txDmaRef, DMA_IT_TC, ENABLE);
+}
+
+// Times of the transitions of the next bytes of the tx buffer, returns their count
+static unsigned softSerialDmaEncode(softSerial_t *softSerial, uint32_t *edges)
+{
+    unsigned count = 0;
+
+    for (int byte = 0; byte < SOFTSERIAL_DMA_TX_BYTES && softSerial->port.txBufferTail != softSerial->port.txBufferHead; byte++) {
+        const uint16_t frame = BIT(TX_TOTAL_BITS - 1) | (softSerial->port.txBuffer[softSerial->port.txBufferTail] << 1);
+        softSerial->port.txBufferTail = (softSerial->port.txBufferTail + 1) % softSerial->port.txBufferSize;
+
+        bool mark = true;
+        for (int bit = 0; bit < TX_TOTAL_BITS; bit++) {
+            const bool level = frame & BIT(bit);
+            if (level != mark) {
+                edges[count++] = ((softSerial->txFrameTime + bit * softSerial->txBitTicks) >> 8) & 0xFFFF;
+                mark = level;
+            }
+        }
+
+        softSerial->txFrameTime += TX_TOTAL_BITS * softSerial->txBitTicks;
+    }
+
+    return count;
+}
+
+// Starts the transmission of the tx buffer on an idle line
+static void softSerialDmaStartTx(softSerial_t *softSerial)
+{
+    const timerHardware_t *timer = softSerial->txTimerHardware;
+
+    softSerial->txFrameTime = (timer->tim->CNT << 8) + SOFTSERIAL_DMA_TX_LEAD_BITS * softSerial->txBitTicks;
+    softSerial->txBlock = 0;
+
+    uint32_t *edges = softSerial->txEdges[0];
+    const unsigned count = softSerialDmaEncode(softSerial, edges);
+    if (count == 0) {
+        softSerial->txState = SOFTSERIAL_TX_IDLE;
+        return;
+    }
+
+    // The first transition is set directly, DMA loads the following ones at each match
+    TIM_DMACmd(timer->tim, timerDmaSource(timer->channel), DISABLE);
+    *timerChCCR(timer) = edges[0];
+    timerChClearCCFlag(timer);
+    softSerialDmaSetOCMode(timer, TIM_OCMode_Toggle);
+
+    softSerial->txState = SOFTSERIAL_TX_SENDING;
+
+    if (count > 1) {
+        xDMA_Cmd(softSerial->txDmaRef, DISABLE);
+        xDMA_MemoryTargetConfig(softSerial->txDmaRef, (uint32_t)&edges[1], DMA_Memory_0);
+        xDMA_SetCurrDataCounter(softSerial->txDmaRef, count - 1);
+        xDMA_Cmd(softSerial->txDmaRef, ENABLE);
+        TIM_DMACmd(timer->tim, timerDmaSource(timer->channel), ENABLE);
+    } else {
+        softSerial->txState = SOFTSERIAL_TX_LAST_EDGE;
+        timerChITConfig(timer, ENABLE);
+    }
+}
+
+// Called from the compare interrupt and when a wait is entered, as the match may have passed already
+static void softSerialDmaTxEvent(softSerial_t *softSerial)
+{
+    const timerHardware_t *timer = softSerial->txTimerHardware;
+
+    while (softSerial->txState == SOFTSERIAL_TX_LAST_EDGE || softSerial->txState == SOFTSERIAL_TX_STOP_BIT) {
+        if ((int16_t)(timer->tim->CNT - *timerChCCR(timer)) < 0) {
+            return;
+        }
+
+        if (softSerial->txState == SOFTSERIAL_TX_LAST_EDGE) {
+            // Back at mark, hold the line through the last stop bit
+            softSerialDmaSetOCMode(timer, TIM_OCMode_Timing);
+            timerChClearCCFlag(timer);
+            *timerChCCR(timer) = (softSerial->txFrameTime >> 8) & 0xFFFF;
+            softSerial->txState = SOFTSERIAL_TX_STOP_BIT;
+        } else {
+            timerChITConfig(timer, DISABLE);
+            if (softSerial->port.txBufferTail != softSerial->port.txBufferHead) {
+                softSerialDmaStartTx(softSerial);
+            } else {
+                softSerial->txState = SOFTSERIAL_TX_IDLE;
+                if ((softSerial->port.options & SERIAL_BIDIR) && softSerial->rxDmaRef) {
+                    softSerialDmaStartRx(softSerial);
+                }
+            }
+        }
+    }
+}
+
+static void onSerialDmaTxCompare(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
+{
+    UNUSED(capture);
+
+    softSerialDmaTxEvent(container_of(cbRec, softSerial_t, edgeCb));
+}
+
+static void softSerialDmaTxIrqHandler(dmaChannelDescriptor_t *descriptor)
+{
+    if (!DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        return;
+    }
+    DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF | DMA_IT_HTIF);
+
+    softSerial_t *softSerial = &softSerialPorts[descriptor->userParam];
+    const timerHardware_t *timer = softSerial->txTimerHardware;
+
+    if (softSerial->txState != SOFTSERIAL_TX_SENDING) {
+        return;
+    }
+
+    // The compare holds the last transition of the block, the next block
+    // is loaded at its match
+    softSerial->txBlock ^= 1;
+    uint32_t *edges = softSerial->txEdges[softSerial->txBlock];
+    const unsigned count = softSerialDmaEncode(softSerial, edges);
+
+    if (count) {
+        xDMA_MemoryTargetConfig(softSerial->txDmaRef, (uint32_t)edges, DMA_Memory_0);
+        xDMA_SetCurrDataCounter(softSerial->txDmaRef, count);
+        xDMA_Cmd(softSerial->txDmaRef, ENABLE);
+    } else {
+        TIM_DMACmd(timer->tim, timerDmaSource(timer->channel), DISABLE);
+        softSerial->txState = SOFTSERIAL_TX_LAST_EDGE;
+        timerChClearCCFlag(timer);
+        timerChITConfig(timer, ENABLE);
+        softSerialDmaTxEvent(softSerial);
+    }
+}
+
+// Samples the bits of the current frame whose centres are before time
+static void softSerialDmaSample(softSerial_t *softSerial, uint16_t time)
+{
+    while (softSerial->rxInFrame) {
+        const uint32_t offset = ((2 * softSerial->rxFrameBits + 1) * softSerial->rxBitTicks) >> 9;
+        const uint16_t centre = softSerial->rxFrameStart + offset;
+        if ((int16_t)(time - centre) < 0) {
+            return;
+        }
+
+        if (softSerial->rxMark) {
+            softSerial->rxFrame |= BIT(softSerial->rxFrameBits);
+        }
+        softSerial->rxFrameBits++;
+
+        if (softSerial->rxFrameBits == 1 && softSerial->rxMark) {
+            // Glitch, the start bit did not last
+            softSerial->rxInFrame = false;
+        } else if (softSerial->rxFrameBits == RX_TOTAL_BITS) {
+            if (softSerial->rxMark) {
+                softSerialStoreRxByte(softSerial, (softSerial->rxFrame >> 1) & 0xFF);
+            } else {
+                softSerial->receiveErrors++;
+            }
+            softSerial->rxInFrame = false;
+        }
+    }
+}
+
+#define SOFTSERIAL_DMA_RX_FLAG_HALF     (1 << 0)
+#define SOFTSERIAL_DMA_RX_FLAG_COMPLETE (1 << 1)
+
+// The half and complete transfer flags the capture sets on its way from tail to head, without a lap
+static uint8_t softSerialDmaRxBoundariesPassed(uint16_t tail, uint16_t head)
+{
+    const uint16_t count = (head - tail) & (SOFTSERIAL_DMA_RX_EDGES - 1);
+    uint8_t passed = 0;
+
+    if (((SOFTSERIAL_DMA_RX_HALF - tail - 1) & (SOFTSERIAL_DMA_RX_EDGES - 1)) < count) {
+        passed |= SOFTSERIAL_DMA_RX_FLAG_HALF;
+    }
+    if (((SOFTSERIAL_DMA_RX_EDGES - tail - 1) & (SOFTSERIAL_DMA_RX_EDGES - 1)) < count) {
+        passed |= SOFTSERIAL_DMA_RX_FLAG_COMPLETE;
+    }
+
+    return passed;
+}
+
+static void softSerialDmaProcessRx(softSerial_t *softSerial)
+{
+    if (!softSerial->rxActive) {
+        return;
+    }
+
+    if (softSerial->rxRestart) {
+        softSerial->rxRestart = false;
+        softSerial->rxEdgeTail = 0;
+        softSerial->rxInFrame = false;
+        softSerial->rxMark = true;
+        softSerial->rxEdgeFlagsPending = 0;
+    }
+
+    // The flags are read before the head, the boundaries the head passed after that show up next time
+    dmaChannelDescriptor_t *descriptor = softSerial->rxDmaDescriptor;
+    const uint8_t flags = (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF) ? SOFTSERIAL_DMA_RX_FLAG_HALF : 0)
+        | (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF) ? SOFTSERIAL_DMA_RX_FLAG_COMPLETE : 0);
+    const uint16_t now = softSerial->timerHardware->tim->CNT;
+    const uint16_t head = (SOFTSERIAL_DMA_RX_EDGES - xDMA_GetCurrDataCounter(softSerial->rxDmaRef)) & (SOFTSERIAL_DMA_RX_EDGES - 1);
+    if (flags) {
+        DMA_CLEAR_FLAG(descriptor, (flags & SOFTSERIAL_DMA_RX_FLAG_HALF ? DMA_IT_HTIF : 0) | (flags & SOFTSERIAL_DMA_RX_FLAG_COMPLETE ? DMA_IT_TCIF : 0));
+    }
+
+    const uint8_t passed = softSerialDmaRxBoundariesPassed(softSerial->rxEdgeTail, head);
+    if (flags & ~(passed | softSerial->rxEdgeFlagsPending)) {
+        // The capture passed a boundary the unread edges don't reach, it lapped the decoder
+        softSerial->receiveOverruns++;
+        softSerial->rxEdgeTail = head;
+        softSerial->rxInFrame = false;
+    }
+    softSerial->rxEdgeFlagsPending = passed & ~flags;
+
+    const bool idle = (softSerial->rxEdgeTail == head) && !softSerial->rxInFrame;
+
+    while (softSerial->rxEdgeTail != head) {
+        const uint16_t time = softSerial->rxEdges[softSerial->rxEdgeTail];
+        softSerial->rxEdgeTail = (softSerial->rxEdgeTail + 1) & (SOFTSERIAL_DMA_RX_EDGES - 1);
+
+        softSerialDmaSample(softSerial, time);
+
+        softSerial->rxMark = !softSerial->rxMark;
+        if (!softSerial->rxInFrame && !softSerial->rxMark) {
+            softSerial->rxInFrame = true;
+            softSerial->rxFrameStart = time;
+            softSerial->rxFrame = 0;
+            softSerial->rxFrameBits = 0;
+        }
+    }
+
+    softSerialDmaSample(softSerial, now);
+
+    if (idle) {
+        // Follow the line level in case an edge went missing
+        const bool mark = !IORead(softSerial->rxIO) == !!(softSerial->port.options & SERIAL_INVERTED);
+        const uint16_t check = (SOFTSERIAL_DMA_RX_EDGES - xDMA_GetCurrDataCounter(softSerial->rxDmaRef)) & (SOFTSERIAL_DMA_RX_EDGES - 1);
+        if (check == head) {
+            softSerial->rxMark = mark;
+        }
+    }
+}
+
+void softSerialDmaProcess(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    for (int i = 0; i < MAX_SOFTSERIAL_PORTS; i++) {
+        if (softSerialPorts[i].rxDmaRef) {
+            softSerialDmaProcessRx(&softSerialPorts[i]);
+        }
+    }
+}
+
+static bool softSerialDmaClaim(const dmaChannelSpec_t *dmaSpec, resourceOwner_e owner, uint8_t resourceIndex)
+{
+    const dmaIdentifier_e identifier = dmaGetIdentifier(dmaSpec->ref);
+    const resourceOwner_t *current = dmaGetOwner(identifier);
+
+    if (current->owner != OWNER_FREE && !(current->owner == owner && current->resourceIndex == resourceIndex)) {
+        return false;
+    }
+
+    dmaInit(identifier, owner, resourceIndex);
+
+    return true;
+}
+
+// Sets the port up on the DMA engine, false to keep the interrupt engine
+static bool softSerialDmaInit(softSerial_t *softSerial)
+{
+    const portMode_e mode = softSerial->port.mode;
+    const bool bidir = softSerial->port.options & SERIAL_BIDIR;
+    const uint8_t resourceIndex = RESOURCE_INDEX(softSerial->softSerialPortIndex + RESOURCE_SOFT_OFFSET);
+
+    softSerial->rxDmaRef = NULL;
+    softSerial->txDmaRef = NULL;
+    softSerial->txTimerHardware = NULL;
+
+    const timerHardware_t *rxTimer = (mode & MODE_RX) ? softSerial->timerHardware : NULL;
+    const timerHardware_t *txTimer = NULL;
+
+    if (mode & MODE_TX) {
+        txTimer = (bidir || !(mode & MODE_RX)) ? softSerial->timerHardware : softSerial->exTimerHardware;
+        if (!txTimer || (txTimer->output & TIMER_OUTPUT_N_CHANNEL)) {
+            return false;
+        }
+        if (!bidir && rxTimer && softSerial->rxIO == softSerial->txIO) {
+            return false;
+        }
+    }
+
+    const dmaChannelSpec_t *rxDmaSpec = rxTimer ? dmaGetChannelSpecByTimer(rxTimer) : NULL;
+    const dmaChannelSpec_t *txDmaSpec = txTimer ? dmaGetChannelSpecByTimer(txTimer) : NULL;
+
+    if ((rxTimer && !rxDmaSpec) || (txTimer && !txDmaSpec)) {
+        return false;
+    }
+    if (rxDmaSpec && txDmaSpec && rxTimer != txTimer && rxDmaSpec->ref == txDmaSpec->ref) {
+        return false;
+    }
+
+    // Half-duplex runs both directions on the stream of the tx pin
+    if ((rxDmaSpec && !softSerialDmaClaim(rxDmaSpec, bidir ? OWNER_SERIAL_TX : OWNER_SERIAL_RX, resourceIndex)) ||
+        (txDmaSpec && rxTimer != txTimer && !softSerialDmaClaim(txDmaSpec, OWNER_SERIAL_TX, resourceIndex))) {
+        return false;
+    }
+
+    if (rxDmaSpec) {
+        softSerial->rxDmaRef = rxDmaSpec->ref;
+        softSerial->rxDmaDescriptor = dmaGetDescriptorByIdentifier(dmaGetIdentifier(rxDmaSpec->ref));
+        softSerial->rxDmaChannel = rxDmaSpec->channel;
+    }
+
+    if (txDmaSpec) {
+        softSerial->txDmaRef = txDmaSpec->ref;
+        softSerial->txDmaChannel = txDmaSpec->channel;
+        softSerial->txTimerHardware = txTimer;
+        softSerial->txState = SOFTSERIAL_TX_IDLE;
+
+        dmaSetHandler(dmaGetIdentifier(txDmaSpec->ref), softSerialDmaTxIrqHandler, NVIC_PRIO_TIMER, softSerial->softSerialPortIndex);
+
+        timerChCCHandlerInit(&softSerial->edgeCb, onSerialDmaTxCompare);
+        timerChConfigCallbacks(txTimer, &softSerial->edgeCb, NULL);
+        timerChITConfig(txTimer, DISABLE);
+    }
+
+    softSerialDmaConfigureTimebases(softSerial, softSerial->port.baudRate);
+
+    if (rxTimer) {
+        softSerialDmaStartRx(softSerial);
+    }
+    if (txTimer && !(bidir && rxTimer)) {
+        softSerialDmaConfigTx(softSerial);
+    }
+
+    return true;
+}
+#endif
+
 serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baud, portMode_e mode, portOptions_e options)
 {
     softSerial_t *softSerial = &(softSerialPorts[portIndex]);
@@ -305,10 +842,17 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
 
     softSerial->transmissionErrors = 0;
     softSerial->receiveErrors = 0;
+    softSerial->receiveOverruns = 0;
 
     softSerial->rxActive = false;
     softSerial->isTransmittingData = false;
 
+#ifdef USE_SOFTSERIAL_DMA
+    if (softSerialDmaInit(softSerial)) {
+        return &softSerial->port;
+    }
+#endif
+
     // Configure master timer (on RX); time base and input capture
 
     serialTimerConfigureTimebase(softSerial->timerHardware, baud);
@@ -450,12 +994,7 @@ void extractAndStoreRxByte(softSerial_t *softSerial)
 
     uint8_t rxByte = (softSerial->internalRxBuffer >> 1) & 0xFF;
 
-    if (softSerial->port.rxCallback) {
-        softSerial->port.rxCallback(rxByte, softSerial->port.rxCallbackData);
-    } else {
-        softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
-        softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
-    }
+    softSerialStoreRxByte(softSerial, rxByte);
 }
 
 void processRxState(softSerial_t *softSerial)
@@ -568,6 +1107,12 @@ uint32_t softSerialRxBytesWaiting(const serialPort_t *instance)
 
     softSerial_t *s = (softSerial_t *)instance;
 
+#ifdef USE_SOFTSERIAL_DMA
+    if (s->rxDmaRef) {
+        softSerialDmaProcessRx(s);
+    }
+#endif
+
     return (s->port.rxBufferHead - s->port.rxBufferTail) & (s->port.rxBufferSize - 1);
 }
 
@@ -609,6 +1154,25 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch)
 
     s->txBuffer[s->txBufferHead] = ch;
     s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
+
+#ifdef USE_SOFTSERIAL_DMA
+    softSerial_t *softSerial = (softSerial_t *)s;
+
+    if (softSerial->txDmaRef && softSerial->txState == SOFTSERIAL_TX_IDLE) {
+        if ((softSerial->port.options & SERIAL_BIDIR) && softSerial->rxActive) {
+            // Half-duplex, take what has been received before turning the line around
+            softSerialDmaProcessRx(softSerial);
+            softSerialDmaStopRx(softSerial);
+            softSerialDmaConfigTx(softSerial);
+        }
+
+        ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+            if (softSerial->txState == SOFTSERIAL_TX_IDLE) {
+                softSerialDmaStartTx(softSerial);
+            }
+        }
+    }
+#endif
 }
 
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
@@ -617,6 +1181,13 @@ void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
 
     softSerial->port.baudRate = baudRate;
 
+#ifdef USE_SOFTSERIAL_DMA
+    if (softSerial->rxDmaRef || softSerial->txDmaRef) {
+        softSerialDmaConfigureTimebases(softSerial, baudRate);
+        return;
+    }
+#endif
+
     serialTimerConfigureTimebase(softSerial->timerHardware, baudRate);
 }
 
@@ -627,6 +1198,14 @@ void softSerialSetMode(serialPort_t *instance, portMode_e mode)
 
 bool isSoftSerialTransmitBufferEmpty(const serialPort_t *instance)
 {
+#ifdef USE_SOFTSERIAL_DMA
+    // The DMA engine takes bytes from the buffer a block ahead of the line
+    const softSerial_t *s = (const softSerial_t *)instance;
+    if (s->txDmaRef && s->txState != SOFTSERIAL_TX_IDLE) {
+        return false;
+    }
+#endif
+
     return instance->txBufferHead == instance->txBufferTail;
 }
 
@@ -642,7 +1221,9 @@ static const struct serialPortVTable softSerialVTable = {
     .setBaudRateCb = NULL,
     .writeBuf = NULL,
     .beginWrite = NULL,
-    .endWrite = NULL
+    .endWrite = NULL,
+    .reserveWrite = NULL,
+    .commitWrite = NULL,
 };
 
 #endif
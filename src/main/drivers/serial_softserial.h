@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 #define SOFTSERIAL_BUFFER_SIZE 256
 
 typedef enum {
@@ -36,3 +38,7 @@ uint32_t softSerialTxBytesFree(const serialPort_t *instance);
 uint8_t softSerialReadByte(serialPort_t *instance);
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate);
 bool isSoftSerialTransmitBufferEmpty(const serialPort_t *s);
+
+#ifdef USE_SOFTSERIAL_DMA
+void softSerialDmaProcess(timeUs_t currentTimeUs);
+#endif
@@ -34,9 +34,11 @@
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/dma.h"
+#include "drivers/dma_plan.h"
 #include "drivers/dma_reqmap.h"
 #include "drivers/rcc.h"
 #include "drivers/serial.h"
@@ -55,46 +57,60 @@
 #error Undefined UART_BUFFER_ATTRIBUTE for this MCU
 #endif
 
-#define UART_BUFFERS(n) \
-    UART_BUFFER(UART_BUFFER_ATTRIBUTE, n, R); \
-    UART_BUFFER(UART_BUFFER_ATTRIBUTE, n, T); struct dummy_s
+static UART_BUFFER_ATTRIBUTE volatile uint8_t uartBufferPool[UART_BUFFER_POOL_SIZE] __attribute__((aligned(4)));
+static uint32_t uartBufferPoolUsed;
 
-#ifdef USE_UART1
-UART_BUFFERS(1);
-#endif
+// Hands out up to the requested size, less when the pool runs short, NULL below UART_BUFFER_SIZE_MIN
+static volatile uint8_t *uartBufferAllocate(uint16_t *size)
+{
+    const uint32_t available = UART_BUFFER_POOL_SIZE - uartBufferPoolUsed;
 
-#ifdef USE_UART2
-UART_BUFFERS(2);
-#endif
+    if (*size > available) {
+        *size = available;
+    }
+    if (*size < UART_BUFFER_SIZE_MIN) {
+        return NULL;
+    }
 
-#ifdef USE_UART3
-UART_BUFFERS(3);
-#endif
+    volatile uint8_t *buffer = &uartBufferPool[uartBufferPoolUsed];
+    // Keep the next buffer word aligned for the DMA
+    uartBufferPoolUsed += MIN((uint32_t)(*size + 3) & ~3U, available);
 
-#ifdef USE_UART4
-UART_BUFFERS(4);
-#endif
+    return buffer;
+}
 
-#ifdef USE_UART5
-UART_BUFFERS(5);
-#endif
+uint32_t uartBufferPoolFree(void)
+{
+    return UART_BUFFER_POOL_SIZE - uartBufferPoolUsed;
+}
 
-#ifdef USE_UART6
-UART_BUFFERS(6);
-#endif
+// Ports are closed and reopened at will, so the first allocation is kept and later calls reuse it
+bool uartAllocateBuffers(UARTDevice_e device, uint16_t rxBufferSize, uint16_t txBufferSize)
+{
+    uartDevice_t *uart = uartDevmap[device];
+    if (!uart) {
+        return false;
+    }
 
-#ifdef USE_UART7
-UART_BUFFERS(7);
-#endif
+    if (!uart->rxBuffer) {
+        uart->rxBuffer = uartBufferAllocate(&rxBufferSize);
+        uart->rxBufferSize = rxBufferSize;
+    }
 
-#ifdef USE_UART8
-UART_BUFFERS(8);
-#endif
+    if (!uart->txBuffer) {
+        uart->txBuffer = uartBufferAllocate(&txBufferSize);
+        uart->txBufferSize = txBufferSize;
+    }
 
-#undef UART_BUFFERS
+    return uart->rxBuffer && uart->txBuffer;
+}
 
 serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baudRate, portMode_e mode, portOptions_e options)
 {   
+    if (!uartAllocateBuffers(device, UART_RX_BUFFER_SIZE, UART_TX_BUFFER_SIZE)) {
+        return NULL;
+    }
+
     uartPort_t *s = serialUART(device, baudRate, mode, options);
     
     if (!s)
@@ -107,7 +123,7 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
     // common serial initialisation code should move to serialPort::init()
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
-    // callback works for IRQ-based RX ONLY
+    // with RX DMA the callback gets the bytes received before an idle line, see uartRxDmaIdle()
     s->port.rxCallback = rxCallback;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
@@ -146,10 +162,11 @@ static uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
         uint32_t rxDMAHead = xDMA_GetCurrDataCounter(s->rxDMAResource);
 #endif
 
-        if (rxDMAHead >= s->rxDMAPos) {
-            return rxDMAHead - s->rxDMAPos;
+        // s->rxDMAPos and rxDMAHead are distances from the end of the buffer, they count down as they advance
+        if (s->rxDMAPos >= rxDMAHead) {
+            return s->rxDMAPos - rxDMAHead;
         } else {
-            return s->port.rxBufferSize + rxDMAHead - s->rxDMAPos;
+            return s->port.rxBufferSize + s->rxDMAPos - rxDMAHead;
         }
     }
 #endif
@@ -239,18 +256,20 @@ static uint8_t uartRead(serialPort_t *instance)
     return ch;
 }
 
-static void uartWrite(serialPort_t *instance, uint8_t ch)
+#ifdef USE_DMA
+// Called on an idle line, hands the bytes the RX DMA stored since the last idle line to the receive callback
+void uartRxDmaIdle(uartPort_t *s)
 {
-    uartPort_t *s = (uartPort_t *)instance;
-
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
+    if (s->rxDMAResource && s->port.rxCallback) {
+        for (uint32_t count = uartTotalRxBytesWaiting(&s->port); count > 0; count--) {
+            s->port.rxCallback(uartRead(&s->port), s->port.rxCallbackData);
+        }
     }
+}
+#endif
 
+static void uartStartTx(uartPort_t *s)
+{
 #ifdef USE_DMA
     if (s->txDMAResource) {
         uartTryStartTxDMA(s);
@@ -265,6 +284,44 @@ static void uartWrite(serialPort_t *instance, uint8_t ch)
     }
 }
 
+static void uartWrite(serialPort_t *instance, uint8_t ch)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    s->port.txBuffer[s->port.txBufferHead] = ch;
+
+    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
+        s->port.txBufferHead = 0;
+    } else {
+        s->port.txBufferHead++;
+    }
+
+    uartStartTx(s);
+}
+
+// Free space from the head up to the tail or the end of the ring, whichever comes first
+static uint8_t *uartReserveWrite(serialPort_t *instance, uint32_t *available)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    *available = MIN(uartTotalTxBytesFree(instance), s->port.txBufferSize - s->port.txBufferHead);
+
+    return (uint8_t *)&s->port.txBuffer[s->port.txBufferHead];
+}
+
+static void uartCommitWrite(serialPort_t *instance, uint32_t count)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    if (s->port.txBufferHead + count >= s->port.txBufferSize) {
+        s->port.txBufferHead = 0;
+    } else {
+        s->port.txBufferHead += count;
+    }
+
+    uartStartTx(s);
+}
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -279,6 +336,8 @@ const struct serialPortVTable uartVTable[] = {
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .reserveWrite = uartReserveWrite,
+        .commitWrite = uartCommitWrite,
     }
 };
 
@@ -291,17 +350,19 @@ void uartConfigureDma(uartDevice_t *uartdev)
 #ifdef USE_DMA_SPEC
     UARTDevice_e device = hardware->device;
     const dmaChannelSpec_t *dmaChannelSpec;
+    const dmaoptValue_t txDmaopt = dmaPlanPeripheralOption(DMA_PERIPH_UART_TX, device, serialUartConfig(device)->txDmaopt);
+    const dmaoptValue_t rxDmaopt = dmaPlanPeripheralOption(DMA_PERIPH_UART_RX, device, serialUartConfig(device)->rxDmaopt);
 
-    if (serialUartConfig(device)->txDmaopt != DMA_OPT_UNUSED) {
-        dmaChannelSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_UART_TX, device, serialUartConfig(device)->txDmaopt);
+    if (txDmaopt != DMA_OPT_UNUSED) {
+        dmaChannelSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_UART_TX, device, txDmaopt);
         if (dmaChannelSpec) {
             s->txDMAResource = dmaChannelSpec->ref;
             s->txDMAChannel = dmaChannelSpec->channel;
         }
     }
 
-    if (serialUartConfig(device)->rxDmaopt != DMA_OPT_UNUSED) {
-        dmaChannelSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_UART_RX, device, serialUartConfig(device)->txDmaopt);
+    if (rxDmaopt != DMA_OPT_UNUSED) {
+        dmaChannelSpec = dmaGetChannelSpecByPeripheral(DMA_PERIPH_UART_RX, device, rxDmaopt);
         if (dmaChannelSpec) {
             s->rxDMAResource = dmaChannelSpec->ref;
             s->rxDMAChannel = dmaChannelSpec->channel;
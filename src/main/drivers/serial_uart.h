@@ -22,12 +22,18 @@
 
 #include "drivers/dma.h" // For dmaResource_t
 
-// Since serial ports can be used for any function these buffer sizes should be equal
+// Default ring sizes, for a port opened without uartAllocateBuffers().
 // The two largest things that need to be sent are: 1, MSP responses, 2, UBLOX SVINFO packet.
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE     128
+#endif
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE     256
+#endif
 
-// Size must be a power of two due to various optimizations which use 'and' instead of 'mod'
-// Various serial routines return the buffer occupied size as uint8_t which would need to be extended in order to
-// increase size further.
+// Range of the ring sizes taken from the buffer pool, a ring shrinks towards the minimum when the pool runs short
+#define UART_BUFFER_SIZE_MIN    32
+#define UART_BUFFER_SIZE_MAX    2048
 
 typedef enum {
     UARTDEV_1 = 0,
@@ -72,4 +78,7 @@ typedef struct uartPort_s {
 } uartPort_t;
 
 void uartPinConfigure(const serialPinConfig_t *pSerialPinConfig);
+// Ring buffer sizes for a UART, before it is first opened. uartOpen() falls back to the default sizes.
+bool uartAllocateBuffers(UARTDevice_e device, uint16_t rxBufferSize, uint16_t txBufferSize);
+uint32_t uartBufferPoolFree(void);
 serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baudRate, portMode_e mode, portOptions_e options);
@@ -111,7 +111,7 @@ void uartReconfigure(uartPort_t *uartPort)
 #if !defined(STM32H7)
             uartPort->rxDMAHandle.Init.Channel = uartPort->rxDMAChannel;
 #else 
-            uartPort->txDMAHandle.Init.Request = uartPort->rxDMAChannel;
+            uartPort->rxDMAHandle.Init.Request = uartPort->rxDMAChannel;
 #endif
             uartPort->rxDMAHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
             uartPort->rxDMAHandle.Init.PeriphInc = DMA_PINC_DISABLE;
@@ -134,6 +134,12 @@ void uartReconfigure(uartPort_t *uartPort)
             HAL_UART_Receive_DMA(&uartPort->Handle, (uint8_t*)uartPort->port.rxBuffer, uartPort->port.rxBufferSize);
 
             uartPort->rxDMAPos = __HAL_DMA_GET_COUNTER(&uartPort->rxDMAHandle);
+
+            if (uartPort->port.rxCallback) {
+                // receive callbacks get the bytes of a frame from the idle line interrupt
+                __HAL_UART_CLEAR_IDLEFLAG(&uartPort->Handle);
+                SET_BIT(uartPort->USARTx->CR1, USART_CR1_IDLEIE);
+            }
         } else
 #endif
         {
@@ -318,6 +324,9 @@ void uartIrqHandler(uartPort_t *s)
     }
 
     if (__HAL_UART_GET_IT(huart, UART_IT_IDLE)) {
+#ifdef USE_DMA
+        uartRxDmaIdle(s);
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
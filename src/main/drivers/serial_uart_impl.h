@@ -25,48 +25,18 @@
 #if defined(STM32F1)
 #define UARTDEV_COUNT_MAX 3
 #define UARTHARDWARE_MAX_PINS 3
-#ifndef UART_RX_BUFFER_SIZE
-#define UART_RX_BUFFER_SIZE     128
-#endif
-#ifndef UART_TX_BUFFER_SIZE
-#define UART_TX_BUFFER_SIZE     256
-#endif
 #elif defined(STM32F3)
 #define UARTDEV_COUNT_MAX 5
 #define UARTHARDWARE_MAX_PINS 4
-#ifndef UART_RX_BUFFER_SIZE
-#define UART_RX_BUFFER_SIZE     128
-#endif
-#ifndef UART_TX_BUFFER_SIZE
-#define UART_TX_BUFFER_SIZE     256
-#endif
 #elif defined(STM32F4)
 #define UARTDEV_COUNT_MAX 6
 #define UARTHARDWARE_MAX_PINS 4
-#ifndef UART_RX_BUFFER_SIZE
-#define UART_RX_BUFFER_SIZE     128
-#endif
-#ifndef UART_TX_BUFFER_SIZE
-#define UART_TX_BUFFER_SIZE     256
-#endif
 #elif defined(STM32F7)
 #define UARTDEV_COUNT_MAX 8
 #define UARTHARDWARE_MAX_PINS 4
-#ifndef UART_RX_BUFFER_SIZE
-#define UART_RX_BUFFER_SIZE     128
-#endif
-#ifndef UART_TX_BUFFER_SIZE
-#define UART_TX_BUFFER_SIZE     256
-#endif
 #elif defined(STM32H7)
 #define UARTDEV_COUNT_MAX 8
 #define UARTHARDWARE_MAX_PINS 5
-#ifndef UART_RX_BUFFER_SIZE
-#define UART_RX_BUFFER_SIZE     128
-#endif
-#ifndef UART_TX_BUFFER_SIZE
-#define UART_TX_BUFFER_SIZE     256
-#endif
 #else
 #error unknown MCU family
 #endif
@@ -123,6 +93,11 @@
 
 #define UARTDEV_COUNT (UARTDEV_COUNT_1 + UARTDEV_COUNT_2 + UARTDEV_COUNT_3 + UARTDEV_COUNT_4 + UARTDEV_COUNT_5 + UARTDEV_COUNT_6 + UARTDEV_COUNT_7 + UARTDEV_COUNT_8)
 
+// RAM shared by the ring buffers of the UARTs in use, the default fits every UART at the default sizes
+#ifndef UART_BUFFER_POOL_SIZE
+#define UART_BUFFER_POOL_SIZE (UARTDEV_COUNT * (UART_RX_BUFFER_SIZE + UART_TX_BUFFER_SIZE))
+#endif
+
 typedef struct uartPinDef_s {
     ioTag_t pin;
 #if defined(STM32F7) || defined(STM32H7)
@@ -166,11 +141,6 @@ typedef struct uartHardware_s {
 #endif
     uint8_t txPriority;
     uint8_t rxPriority;
-
-    volatile uint8_t *txBuffer;
-    volatile uint8_t *rxBuffer;
-    uint16_t txBufferSize;
-    uint16_t rxBufferSize;
 } uartHardware_t;
 
 extern const uartHardware_t uartHardware[];
@@ -183,8 +153,11 @@ typedef struct uartDevice_s {
     const uartHardware_t *hardware;
     uartPinDef_t rx;
     uartPinDef_t tx;
+    // Taken from the buffer pool when the UART is first opened and kept from then on
     volatile uint8_t *rxBuffer;
     volatile uint8_t *txBuffer;
+    uint16_t rxBufferSize;
+    uint16_t txBufferSize;
 } uartDevice_t;
 
 extern uartDevice_t *uartDevmap[];
@@ -192,6 +165,7 @@ extern uartDevice_t *uartDevmap[];
 extern const struct serialPortVTable uartVTable[];
 
 void uartTryStartTxDMA(uartPort_t *s);
+void uartRxDmaIdle(uartPort_t *s);
 
 uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options);
 
@@ -210,43 +184,3 @@ void uartDmaIrqHandler(dmaChannelDescriptor_t* descriptor);
 #define UART_REG_RXD(base) ((base)->DR)
 #define UART_REG_TXD(base) ((base)->DR)
 #endif
-
-#define UART_BUFFER(type, n, rxtx) type volatile uint8_t uart ## n ## rxtx ## xBuffer[UART_ ## rxtx ## X_BUFFER_SIZE]
-
-#define UART_BUFFERS_EXTERN(n) \
-    UART_BUFFER(extern, n, R); \
-    UART_BUFFER(extern, n, T); struct dummy_s
-
-#ifdef USE_UART1
-UART_BUFFERS_EXTERN(1);
-#endif
-
-#ifdef USE_UART2
-UART_BUFFERS_EXTERN(2);
-#endif
-
-#ifdef USE_UART3
-UART_BUFFERS_EXTERN(3);
-#endif
-
-#ifdef USE_UART4
-UART_BUFFERS_EXTERN(4);
-#endif
-
-#ifdef USE_UART5
-UART_BUFFERS_EXTERN(5);
-#endif
-
-#ifdef USE_UART6
-UART_BUFFERS_EXTERN(6);
-#endif
-
-#ifdef USE_UART7
-UART_BUFFERS_EXTERN(7);
-#endif
-
-#ifdef USE_UART8
-UART_BUFFERS_EXTERN(8);
-#endif
-
-#undef UART_BUFFERS_EXTERN
@@ -74,10 +74,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART1_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART1_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART1,
-        .txBuffer = uart1TxBuffer,
-        .rxBuffer = uart1RxBuffer,
-        .txBufferSize = sizeof(uart1TxBuffer),
-        .rxBufferSize = sizeof(uart1RxBuffer),
     },
 #endif
 #ifdef USE_UART2
@@ -93,10 +89,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART2_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART2,
         .rxPriority = NVIC_PRIO_SERIALUART2,
-        .txBuffer = uart2TxBuffer,
-        .rxBuffer = uart2RxBuffer,
-        .txBufferSize = sizeof(uart2TxBuffer),
-        .rxBufferSize = sizeof(uart2RxBuffer),
     },
 #endif
 #ifdef USE_UART3
@@ -112,10 +104,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART3_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART3,
         .rxPriority = NVIC_PRIO_SERIALUART3,
-        .txBuffer = uart3TxBuffer,
-        .rxBuffer = uart3RxBuffer,
-        .txBufferSize = sizeof(uart3TxBuffer),
-        .rxBufferSize = sizeof(uart3RxBuffer),
     },
 #endif
 };
@@ -148,10 +136,10 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
     s->USARTx = hardware->reg;
 
-    s->port.rxBuffer = hardware->rxBuffer;
-    s->port.txBuffer = hardware->txBuffer;
-    s->port.rxBufferSize = hardware->rxBufferSize;
-    s->port.txBufferSize = hardware->txBufferSize;
+    s->port.rxBuffer = uartdev->rxBuffer;
+    s->port.txBuffer = uartdev->txBuffer;
+    s->port.rxBufferSize = uartdev->rxBufferSize;
+    s->port.txBufferSize = uartdev->txBufferSize;
 
     RCC_ClockCmd(hardware->rcc, ENABLE);
 
@@ -175,8 +163,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-    // RX/TX Interrupt
-    if (!hardware->rxDMAResource || !hardware->txDMAResource) {
+    // RX/TX Interrupt, also needed with RX DMA for the idle line interrupt
+    {
         NVIC_InitTypeDef NVIC_InitStructure;
 
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
@@ -204,7 +192,7 @@ void uartIrqHandler(uartPort_t *s)
             }
         }
     }
-    if (SR & USART_FLAG_TXE) {
+    if (SR & USART_FLAG_TXE && !s->txDMAResource) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             s->USARTx->DR = s->port.txBuffer[s->port.txBufferTail++];
             if (s->port.txBufferTail >= s->port.txBufferSize) {
@@ -215,6 +203,9 @@ void uartIrqHandler(uartPort_t *s)
         }
     }
     if (SR & USART_FLAG_IDLE) {
+#ifdef USE_DMA
+        uartRxDmaIdle(s);
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
@@ -109,10 +109,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART1_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART1_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART1_RXDMA,
-        .txBuffer = uart1TxBuffer,
-        .rxBuffer = uart1RxBuffer,
-        .txBufferSize = sizeof(uart1TxBuffer),
-        .rxBufferSize = sizeof(uart1RxBuffer),
     },
 #endif
 
@@ -129,10 +125,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART2_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART2_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART2_RXDMA,
-        .txBuffer = uart2TxBuffer,
-        .rxBuffer = uart2RxBuffer,
-        .txBufferSize = sizeof(uart2TxBuffer),
-        .rxBufferSize = sizeof(uart2RxBuffer),
     },
 #endif
 
@@ -149,10 +141,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART3_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART3_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART3_RXDMA,
-        .txBuffer = uart3TxBuffer,
-        .rxBuffer = uart3RxBuffer,
-        .txBufferSize = sizeof(uart3TxBuffer),
-        .rxBufferSize = sizeof(uart3RxBuffer),
     },
 #endif
 
@@ -170,10 +158,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = UART4_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART4_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART4_RXDMA,
-        .txBuffer = uart4TxBuffer,
-        .rxBuffer = uart4RxBuffer,
-        .txBufferSize = sizeof(uart4TxBuffer),
-        .rxBufferSize = sizeof(uart4RxBuffer),
     },
 #endif
 
@@ -191,10 +175,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = UART5_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART5,
         .rxPriority = NVIC_PRIO_SERIALUART5,
-        .txBuffer = uart5TxBuffer,
-        .rxBuffer = uart5RxBuffer,
-        .txBufferSize = sizeof(uart5TxBuffer),
-        .rxBufferSize = sizeof(uart5RxBuffer),
     },
 #endif
 };
@@ -254,10 +234,10 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
     s->USARTx = hardware->reg;
 
 
-    s->port.rxBuffer = hardware->rxBuffer;
-    s->port.txBuffer = hardware->txBuffer;
-    s->port.rxBufferSize = hardware->rxBufferSize;
-    s->port.txBufferSize = hardware->txBufferSize;
+    s->port.rxBuffer = uartDev->rxBuffer;
+    s->port.txBuffer = uartDev->txBuffer;
+    s->port.rxBufferSize = uartDev->rxBufferSize;
+    s->port.txBufferSize = uartDev->txBufferSize;
 
     RCC_ClockCmd(hardware->rcc, ENABLE);
 
@@ -265,7 +245,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
     serialUARTInitIO(IOGetByTag(uartDev->tx.pin), IOGetByTag(uartDev->rx.pin), mode, options, hardware->af, device);
 
-    if (!s->rxDMAResource || !s->txDMAResource) {
+    // RX/TX Interrupt, also needed with RX DMA for the idle line interrupt
+    {
         NVIC_InitTypeDef NVIC_InitStructure;
 
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
@@ -310,6 +291,9 @@ void uartIrqHandler(uartPort_t *s)
     }
 
     if (ISR & USART_FLAG_IDLE) {
+#ifdef USE_DMA
+        uartRxDmaIdle(s);
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
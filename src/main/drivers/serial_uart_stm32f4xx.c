@@ -67,10 +67,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART1_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART1_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART1,
-        .txBuffer = uart1TxBuffer,
-        .rxBuffer = uart1RxBuffer,
-        .txBufferSize = sizeof(uart1TxBuffer),
-        .rxBufferSize = sizeof(uart1RxBuffer),
     },
 #endif
 
@@ -93,10 +89,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART2_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART2_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART2,
-        .txBuffer = uart2TxBuffer,
-        .rxBuffer = uart2RxBuffer,
-        .txBufferSize = sizeof(uart2TxBuffer),
-        .rxBufferSize = sizeof(uart2RxBuffer),
     },
 #endif
 
@@ -119,10 +111,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART3_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART3_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART3,
-        .txBuffer = uart3TxBuffer,
-        .rxBuffer = uart3RxBuffer,
-        .txBufferSize = sizeof(uart3TxBuffer),
-        .rxBufferSize = sizeof(uart3RxBuffer),
     },
 #endif
 
@@ -145,10 +133,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = UART4_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART4_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART4,
-        .txBuffer = uart4TxBuffer,
-        .rxBuffer = uart4RxBuffer,
-        .txBufferSize = sizeof(uart4TxBuffer),
-        .rxBufferSize = sizeof(uart4RxBuffer),
     },
 #endif
 
@@ -171,10 +155,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = UART5_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART5_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART5,
-        .txBuffer = uart5TxBuffer,
-        .rxBuffer = uart5RxBuffer,
-        .txBufferSize = sizeof(uart5TxBuffer),
-        .rxBufferSize = sizeof(uart5RxBuffer),
     },
 #endif
 
@@ -209,10 +189,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .irqn = USART6_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART6_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART6,
-        .txBuffer = uart6TxBuffer,
-        .rxBuffer = uart6RxBuffer,
-        .txBufferSize = sizeof(uart6TxBuffer),
-        .rxBufferSize = sizeof(uart6RxBuffer),
     },
 #endif
 };
@@ -261,10 +237,10 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBuffer = hardware->rxBuffer;
-    s->port.txBuffer = hardware->txBuffer;
-    s->port.rxBufferSize = hardware->rxBufferSize;
-    s->port.txBufferSize = hardware->txBufferSize;
+    s->port.rxBuffer = uart->rxBuffer;
+    s->port.txBuffer = uart->txBuffer;
+    s->port.rxBufferSize = uart->rxBufferSize;
+    s->port.txBufferSize = uart->txBufferSize;
 
     s->USARTx = hardware->reg;
 
@@ -294,17 +270,14 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-#ifdef USE_DMA
-    if (!(s->rxDMAResource)) {
-        NVIC_InitTypeDef NVIC_InitStructure;
-
-        NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
-        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
-        NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
-        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-        NVIC_Init(&NVIC_InitStructure);
-    }
-#endif
+    // also needed with RX DMA, the idle line interrupt hands the received bytes to the receive callback
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
 
     return s;
 }
@@ -334,6 +307,9 @@ void uartIrqHandler(uartPort_t *s)
     }
 
     if (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET) {
+#ifdef USE_DMA
+        uartRxDmaIdle(s);
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
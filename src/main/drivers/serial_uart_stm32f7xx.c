@@ -75,10 +75,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .rxIrq = USART1_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART1_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART1,
-        .txBuffer = uart1TxBuffer,
-        .rxBuffer = uart1RxBuffer,
-        .txBufferSize = sizeof(uart1TxBuffer),
-        .rxBufferSize = sizeof(uart1RxBuffer),
     },
 #endif
 
@@ -109,10 +105,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .rxIrq = USART2_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART2_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART2,
-        .txBuffer = uart2TxBuffer,
-        .rxBuffer = uart2RxBuffer,
-        .txBufferSize = sizeof(uart2TxBuffer),
-        .rxBufferSize = sizeof(uart2RxBuffer),
     },
 #endif
 
@@ -145,10 +137,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .rxIrq = USART3_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART3_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART3,
-        .txBuffer = uart3TxBuffer,
-        .rxBuffer = uart3RxBuffer,
-        .txBufferSize = sizeof(uart3TxBuffer),
-        .rxBufferSize = sizeof(uart3RxBuffer),
     },
 #endif
 
@@ -187,10 +175,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .rxIrq = UART4_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART4_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART4,
-        .txBuffer = uart4TxBuffer,
-        .rxBuffer = uart4RxBuffer,
-        .txBufferSize = sizeof(uart4TxBuffer),
-        .rxBufferSize = sizeof(uart4RxBuffer),
     },
 #endif
 
@@ -229,10 +213,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .rxIrq = UART5_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART5_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART5,
-        .txBuffer = uart5TxBuffer,
-        .rxBuffer = uart5RxBuffer,
-        .txBufferSize = sizeof(uart5TxBuffer),
-        .rxBufferSize = sizeof(uart5RxBuffer),
     },
 #endif
 
@@ -263,10 +243,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .rxIrq = USART6_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART6_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART6,
-        .txBuffer = uart6TxBuffer,
-        .rxBuffer = uart6RxBuffer,
-        .txBufferSize = sizeof(uart6TxBuffer),
-        .rxBufferSize = sizeof(uart6RxBuffer),
     },
 #endif
 
@@ -305,10 +281,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .rxIrq = UART7_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART7_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART7,
-        .txBuffer = uart7TxBuffer,
-        .rxBuffer = uart7RxBuffer,
-        .txBufferSize = sizeof(uart7TxBuffer),
-        .rxBufferSize = sizeof(uart7RxBuffer),
     },
 #endif
 
@@ -337,10 +309,6 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
         .rxIrq = UART8_IRQn,
         .txPriority = NVIC_PRIO_SERIALUART8_TXDMA,
         .rxPriority = NVIC_PRIO_SERIALUART8,
-        .txBuffer = uart8TxBuffer,
-        .rxBuffer = uart8RxBuffer,
-        .txBufferSize = sizeof(uart8TxBuffer),
-        .rxBufferSize = sizeof(uart8RxBuffer),
     },
 #endif
 };
@@ -364,10 +332,10 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
     s->USARTx = hardware->reg;
 
-    s->port.rxBuffer = hardware->rxBuffer;
-    s->port.txBuffer = hardware->txBuffer;
-    s->port.rxBufferSize = hardware->rxBufferSize;
-    s->port.txBufferSize = hardware->txBufferSize;
+    s->port.rxBuffer = uartdev->rxBuffer;
+    s->port.txBuffer = uartdev->txBuffer;
+    s->port.rxBufferSize = uartdev->rxBufferSize;
+    s->port.txBufferSize = uartdev->txBufferSize;
 
 #ifdef USE_DMA
     uartConfigureDma(uartdev);
@@ -400,12 +368,9 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-#ifdef USE_DMA
-    if (!s->rxDMAResource) {
-        HAL_NVIC_SetPriority(hardware->rxIrq, NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
-        HAL_NVIC_EnableIRQ(hardware->rxIrq);
-    }
-#endif
+    // also needed with RX DMA, the idle line interrupt hands the received bytes to the receive callback
+    HAL_NVIC_SetPriority(hardware->rxIrq, NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
+    HAL_NVIC_EnableIRQ(hardware->rxIrq);
 
     return s;
 }
@@ -199,6 +199,27 @@ static void usbVcpEndWrite(serialPort_t *instance)
     usbVcpFlush(port);
 }
 
+#if defined(STM32F4) || defined(STM32F7) || defined(STM32H7)
+static uint8_t *usbVcpReserveWrite(serialPort_t *instance, uint32_t *available)
+{
+    vcpPort_t *port = container_of(instance, vcpPort_t, port);
+
+    // Bytes buffered by usbVcpWrite() go out first
+    if (!usbVcpFlush(port) || !usbIsConnected() || !usbIsConfigured()) {
+        *available = 0;
+        return NULL;
+    }
+
+    return CDC_Send_Reserve(available);
+}
+
+static void usbVcpCommitWrite(serialPort_t *instance, uint32_t count)
+{
+    UNUSED(instance);
+    CDC_Send_Commit(count);
+}
+#endif
+
 static const struct serialPortVTable usbVTable[] = {
     {
         .serialWrite = usbVcpWrite,
@@ -212,7 +233,14 @@ static const struct serialPortVTable usbVTable[] = {
         .setBaudRateCb = usbVcpSetBaudRateCb,
         .writeBuf = usbVcpWriteBuf,
         .beginWrite = usbVcpBeginWrite,
-        .endWrite = usbVcpEndWrite
+        .endWrite = usbVcpEndWrite,
+#if defined(STM32F4) || defined(STM32F7) || defined(STM32H7)
+        .reserveWrite = usbVcpReserveWrite,
+        .commitWrite = usbVcpCommitWrite,
+#else
+        .reserveWrite = NULL,
+        .commitWrite = NULL,
+#endif
     }
 };
 
@@ -251,7 +279,7 @@ serialPort_t *usbVcpOpen(void)
         break;
 #endif
     default:
-        USBD_RegisterClass(&USBD_Device, USBD_CDC_CLASS);
+        USBD_RegisterClass(&USBD_Device, CDC_Itf_Class());
         break;
     }
 
@@ -39,7 +39,7 @@ typedef struct {
     serialPort_t port;
 
     // Buffer used during bulk writes.
-    uint8_t txBuf[20];
+    uint8_t txBuf[64];
     uint8_t txAt;
     // Set if the port is in bulk write mode and can buffer.
     bool buffering;
@@ -26,6 +26,7 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/stack_check.h"
@@ -58,6 +59,92 @@ extern char _Min_Stack_Size; // declared in .LD file
  * See the linker scripts for actual stack configuration.
  */
 
+#ifndef SIMULATOR_BUILD
+// Lowest address written since reset, the startup code fills the stack with STACK_FILL_CHAR
+static char *stackScanLowest(char *stackLowMem, const char *stackCurrent)
+{
+    char *p;
+    for (p = stackLowMem; p < stackCurrent; ++p) {
+        if ((uint8_t)*p != STACK_FILL_CHAR) {
+            break;
+        }
+    }
+    return p;
+}
+
+#ifdef USE_TASK_STACK_CHECK
+#define STACK_FILL_WORD 0xa5a5a5a5
+#define STACK_PAINT_MARGIN 32       // bytes below the frame of stackPaint() that are left alone
+
+static uint32_t *stackPainted;      // the stack below is known to hold the fill pattern
+static uint32_t *stackLowestUsed;   // lowest address written since reset
+
+static uint32_t *stackScanLowestWord(void)
+{
+    uint32_t *p = (uint32_t *)(&_estack - (uint32_t)&_Min_Stack_Size);
+    while (*p == STACK_FILL_WORD) {
+        p++;
+    }
+    return p;
+}
+
+/*
+ * Fills the free stack below the caller with the pattern again and returns the reference point for
+ * stackMeasure(). Only the part written since the last measurement is painted, everything below it
+ * still holds the pattern.
+ */
+NOINLINE uint32_t *stackPaint(void)
+{
+    volatile uint32_t marker = 0;
+    uint32_t * const base = (uint32_t *)&marker;
+
+    if (!stackPainted) {
+        // the first call keeps what the startup pattern recorded before the scheduler
+        stackPainted = stackScanLowestWord();
+        stackLowestUsed = stackPainted;
+    }
+
+    for (uint32_t *p = stackPainted; p < base - STACK_PAINT_MARGIN / sizeof(uint32_t); p++) {
+        *p = STACK_FILL_WORD;
+    }
+    stackPainted = base - STACK_PAINT_MARGIN / sizeof(uint32_t);
+
+    return base;
+}
+
+// Bytes used below the reference point from stackPaint(), interrupts taken meanwhile are included
+uint32_t stackMeasure(const uint32_t *base)
+{
+    uint32_t * const p = stackScanLowestWord();
+
+    stackPainted = MIN(stackPainted, p);
+    stackLowestUsed = MIN(stackLowestUsed, p);
+
+    return p < base ? (base - p) * sizeof(uint32_t) : 0;
+}
+#endif
+
+uint32_t stackHighWaterSize(void)
+{
+    char * const stackHighMem = &_estack;
+    char * const stackLowMem = stackHighMem - (uint32_t)&_Min_Stack_Size;
+    const char * const stackCurrent = (char *)&stackLowMem;
+
+    char *lowest = stackScanLowest(stackLowMem, stackCurrent);
+#ifdef USE_TASK_STACK_CHECK
+    if (stackLowestUsed) {
+        lowest = MIN(lowest, (char *)stackLowestUsed);
+    }
+#endif
+    return (uint32_t)stackHighMem - (uint32_t)lowest;
+}
+#else
+uint32_t stackHighWaterSize(void)
+{
+    return 0;
+}
+#endif
+
 #ifdef STACK_CHECK
 
 static uint32_t usedStackSize;
@@ -71,12 +158,7 @@ void taskStackCheck(timeUs_t currentTimeUs)
     char * const stackLowMem = stackHighMem - stackSize;
     const char * const stackCurrent = (char *)&stackLowMem;
 
-    char *p;
-    for (p = stackLowMem; p < stackCurrent; ++p) {
-        if (*p != STACK_FILL_CHAR) {
-            break;
-        }
-    }
+    char * const p = stackScanLowest(stackLowMem, stackCurrent);
 
     usedStackSize = (uint32_t)stackHighMem - (uint32_t)p;
 
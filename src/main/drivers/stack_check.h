@@ -24,5 +24,11 @@
 
 void taskStackCheck(timeUs_t currentTimeUs);
 uint32_t stackUsedSize(void);
+uint32_t stackHighWaterSize(void);
 uint32_t stackTotalSize(void);
 uint32_t stackHighMem(void);
+
+#ifdef USE_TASK_STACK_CHECK
+uint32_t *stackPaint(void);
+uint32_t stackMeasure(const uint32_t *base);
+#endif
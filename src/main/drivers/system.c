@@ -153,6 +153,11 @@ uint32_t clockCyclesToMicros(uint32_t clockCycles)
     return clockCycles / usTicks;
 }
 
+uint32_t clockMicrosToCycles(uint32_t micros)
+{
+    return micros * usTicks;
+}
+
 // Return system uptime in milliseconds (rollover in 49 days)
 uint32_t millis(void)
 {
@@ -52,23 +52,31 @@
 #include "config/config.h"
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/loop_timing.h"
+#include "fc/looptime_check.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 #include "fc/stats.h"
 
+#include "flight/collective.h"
 #include "flight/failsafe.h"
+#include "flight/flight_state.h"
 #include "flight/gps_rescue.h"
+#include "flight/governor.h"
 #if defined(USE_GYRO_DATA_ANALYSE)
 #include "flight/gyroanalyse.h"
 #endif
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
+#include "flight/rescue.h"
 #include "flight/position.h"
 #include "flight/rpm_filter.h"
 #include "flight/servos.h"
+#include "flight/sysid.h"
+#include "flight/vibration.h"
 
 #include "io/beeper.h"
 #include "io/gps.h"
@@ -89,6 +97,7 @@
 
 #include "rx/rx.h"
 
+#include "scheduler/profile.h"
 #include "scheduler/scheduler.h"
 
 #include "sensors/acceleration.h"
@@ -97,6 +106,7 @@
 #include "sensors/boardalignment.h"
 #include "sensors/compass.h"
 #include "sensors/gyro.h"
+#include "sensors/rpm_source.h"
 
 #include "telemetry/telemetry.h"
 
@@ -146,6 +156,9 @@ static int lastArmingDisabledReason = 0;
 static timeUs_t lastDisarmTimeUs;
 static int tryingToArm = ARMING_DELAYED_DISARMED;
 
+static bool motorOutputPhase;           // the motors are written by subTaskMotorOutput()
+static timeDelta_t gyroUpdateTimeUs;    // time the last gyro update took
+
 #ifdef USE_RUNAWAY_TAKEOFF
 static timeUs_t runawayTakeoffDeactivateUs = 0;
 static timeUs_t runawayTakeoffAccumulatedUs = 0;
@@ -335,6 +348,15 @@ void updateArmingStatus(void)
         }
 #endif
 
+#ifdef USE_LOOPTIME_CHECK
+        looptimeCheckUpdate(micros());
+        if (looptimeCheckBlocksArming()) {
+            setArmingDisabled(ARMING_DISABLED_LOOPTIME);
+        } else {
+            unsetArmingDisabled(ARMING_DISABLED_LOOPTIME);
+        }
+#endif
+
         if (IS_RC_MODE_ACTIVE(BOXPARALYZE)) {
             setArmingDisabled(ARMING_DISABLED_PARALYZE);
         }
@@ -509,6 +531,9 @@ void tryArm(void)
         beeper(BEEPER_ARMING);
 #endif
 
+#ifdef USE_LOOP_TIMING
+        loopTimingOnArm();
+#endif
 #ifdef USE_PERSISTENT_STATS
         statsOnArm();
 #endif
@@ -664,6 +689,27 @@ bool isAirmodeActivated()
 
 
 
+/*
+ * processRxFrame hands a decoded frame to the setpoint calculation, from
+ * taskUpdateRxMain or, with rx_inline_pid, from the start of the PID loop
+ */
+void processRxFrame(timeUs_t currentTimeUs)
+{
+    static timeUs_t lastRxTimeUs;
+
+    timeDelta_t rxFrameDeltaUs;
+    if (!rxGetFrameDelta(&rxFrameDeltaUs)) {
+        rxFrameDeltaUs = cmpTimeUs(currentTimeUs, lastRxTimeUs); // calculate a delta here if not supplied by the protocol
+    }
+    lastRxTimeUs = currentTimeUs;
+    currentRxRefreshRate = constrain(rxFrameDeltaUs, 1000, 30000);
+    rxFrameTimingUpdate(currentTimeUs, currentRxRefreshRate);
+    isRXDataNew = true;
+
+    // updateRcCommands sets rcCommand, which is needed by updateAltHoldState and updateSonarAltHoldState
+    updateRcCommands();
+}
+
 /*
  * processRx called from taskUpdateRxMain
  */
@@ -868,7 +914,7 @@ bool processRx(timeUs_t currentTimeUs)
 
     bool canUseHorizonMode = true;
 
-    if ((IS_RC_MODE_ACTIVE(BOXANGLE) || failsafeIsActive()) && (sensors(SENSOR_ACC))) {
+    if ((IS_RC_MODE_ACTIVE(BOXANGLE) || failsafeIsLevelling()) && (sensors(SENSOR_ACC))) {
         // bumpless transfer to Level mode
         canUseHorizonMode = false;
 
@@ -890,6 +936,13 @@ bool processRx(timeUs_t currentTimeUs)
         DISABLE_FLIGHT_MODE(HORIZON_MODE);
     }
 
+    // HF3D:  advance the angle (rescue) mode state machine at RC rate
+    rescueUpdate(currentTimeUs);
+
+#ifdef USE_SYSTEM_ID
+    sysidUpdateMode(IS_RC_MODE_ACTIVE(BOXSYSID) && !failsafeIsActive());
+#endif
+
 #ifdef USE_GPS_RESCUE
     if (ARMING_FLAG(ARMED) && (IS_RC_MODE_ACTIVE(BOXGPSRESCUE) || (failsafeIsActive() && failsafeConfig()->failsafe_procedure == FAILSAFE_PROCEDURE_GPS_RESCUE))) {
         if (!FLIGHT_MODE(GPS_RESCUE_MODE)) {
@@ -986,7 +1039,12 @@ bool processRx(timeUs_t currentTimeUs)
 static FAST_CODE void subTaskPidController(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_PIDLOOP) {startTime = micros();}
+    if (DEBUG_MODE_ACTIVE(DEBUG_PIDLOOP)) {startTime = micros();}
+    // HF3D:  Choose the HELI failsafe recovery before the collective and throttle are derived from it
+    failsafeHeliUpdate(currentTimeUs);
+    // HF3D:  Derive the collective signals once for the PID controller, governor and swash mixer
+    collectiveUpdate();
+
     // PID - note this is function pointer set by setPIDController()
     pidController(currentPidProfile, currentTimeUs);
     DEBUG_SET(DEBUG_PIDLOOP, 1, micros() - startTime);
@@ -1040,7 +1098,7 @@ static FAST_CODE void subTaskPidController(timeUs_t currentTimeUs)
 static FAST_CODE_NOINLINE void subTaskPidSubprocesses(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_PIDLOOP) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
 
@@ -1050,6 +1108,10 @@ static FAST_CODE_NOINLINE void subTaskPidSubprocesses(timeUs_t currentTimeUs)
     }
 #endif
 
+#ifdef USE_VIBRATION_MONITOR
+    vibrationUpdateGyro(gyro.gyroADC);
+#endif
+
 #ifdef USE_BLACKBOX
     if (!cliMode && blackboxConfig()->device) {
         blackboxUpdate(currentTimeUs);
@@ -1074,14 +1136,15 @@ void subTaskTelemetryPollSensors(timeUs_t currentTimeUs)
 static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_CYCLETIME) {
-        startTime = micros();
+    if (DEBUG_MODE_ACTIVE(DEBUG_CYCLETIME)) {
         static uint32_t previousMotorUpdateTime;
-        const uint32_t currentDeltaTime = startTime - previousMotorUpdateTime;
-        debug[2] = currentDeltaTime;
-        debug[3] = currentDeltaTime - targetPidLooptime;
-        previousMotorUpdateTime = startTime;
-    } else if (debugMode == DEBUG_PIDLOOP) {
+        const uint32_t currentTime = micros();
+        const uint32_t currentDeltaTime = currentTime - previousMotorUpdateTime;
+        DEBUG_SET(DEBUG_CYCLETIME, 2, currentDeltaTime);
+        DEBUG_SET(DEBUG_CYCLETIME, 3, currentDeltaTime - targetPidLooptime);
+        previousMotorUpdateTime = currentTime;
+    }
+    if (DEBUG_MODE_ACTIVE(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
 
@@ -1094,13 +1157,16 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
     }
 #endif
 
-    writeMotors();
+    // with motor_output_phase_us the outputs are written by subTaskMotorOutput() instead
+    if (!motorOutputPhase) {
+        writeMotors();
+    }
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
-    if (debugMode == DEBUG_DSHOT_RPM_ERRORS && useDshotTelemetry) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_DSHOT_RPM_ERRORS) && useDshotTelemetry) {
         const uint8_t motorCount = MIN(getMotorCount(), 4);
         for (uint8_t i = 0; i < motorCount; i++) {
-            debug[i] = getDshotTelemetryMotorInvalidPercent(i);
+            DEBUG_SET(DEBUG_DSHOT_RPM_ERRORS, i, getDshotTelemetryMotorInvalidPercent(i));
         }
     }
 #endif
@@ -1108,16 +1174,41 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
     DEBUG_SET(DEBUG_PIDLOOP, 2, micros() - startTime);
 }
 
+// Writes the motors at a fixed time after the gyro sample, so the actuation latency
+// does not follow the filter and PID load. The subprocesses run before the wait.
+static FAST_CODE void subTaskMotorOutput(void)
+{
+    // never wait into the next gyro sample, whatever the pid_process_denom, and leave the
+    // time the last gyro update took for the next one
+    const timeDelta_t phaseLimitUs = MAX((timeDelta_t)gyro.targetLooptime - gyroUpdateTimeUs, 0);
+    const timeUs_t phaseUs = MIN(motorConfig()->outputPhaseUs, (timeUs_t)phaseLimitUs);
+    const timeUs_t outputAtUs = gyro.sampleTimeUs + phaseUs;
+
+    const timeDelta_t lateUs = cmpTimeUs(micros(), outputAtUs);
+    if (lateUs < 0 && lateUs >= -(timeDelta_t)phaseUs) {
+        while (cmpTimeUs(outputAtUs, micros()) > 0) {
+        }
+    }
+
+    writeMotors();
+}
+
 static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
+    // bound the failsafe reaction time independently of the RX task rate
+    rxSignalWatchdog(currentTimeUs);
+
+    // with rx_inline_pid a completed frame is decoded here, stick latency is then bounded by one PID period
+    if (rxInlineDecodeEnabled() && rxDecodeInlineFrame(currentTimeUs)) {
+        processRxFrame(currentTimeUs);
+    }
 
     // If we're armed, at minimum throttle, and we do arming via the
     // sticks, do not process yaw input from the rx.  We do this so the
     // motors do not spin up while we are trying to arm or disarm.
     // Allow yaw control for tricopters if the user wants the servo to move even when unarmed.
     if (isUsingSticksForArming() && rcData[THROTTLE] <= rxConfig()->mincheck
-#ifndef USE_QUAD_MIXER_ONLY
+#if !defined(USE_QUAD_MIXER_ONLY) && !defined(USE_HELI_ONLY)
 #ifdef USE_SERVOS
                 && !((mixerConfig()->mixerMode == MIXER_TRI || mixerConfig()->mixerMode == MIXER_CUSTOM_TRI) && servoConfig()->tri_unarmed_servo)
 #endif
@@ -1145,20 +1236,54 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
     // 1 - subTaskPidController()
     // 2 - subTaskMotorUpdate()
     // 3 - subTaskPidSubprocesses()
+    const timeUs_t loopStartTimeUs = micros();
+    PROFILE_BEGIN(PROFILE_GYRO_UPDATE);
     gyroUpdate(currentTimeUs);
+    PROFILE_END(PROFILE_GYRO_UPDATE);
     DEBUG_SET(DEBUG_PIDLOOP, 0, micros() - currentTimeUs);
+    gyroUpdateTimeUs = cmpTimeUs(micros(), loopStartTimeUs);
 
-    if (pidUpdateCounter++ % pidConfig()->pid_process_denom == 0) {
+    const bool pidIteration = (pidUpdateCounter++ % pidConfig()->pid_process_denom == 0);
+    if (pidIteration) {
+        rpmSourceUpdate(currentTimeUs);
+#ifdef USE_ACC
+        imuUpdateGyroAttitude();
+#endif
+        PROFILE_BEGIN(PROFILE_RC_COMMAND);
         subTaskRcCommand(currentTimeUs);
+        PROFILE_END(PROFILE_RC_COMMAND);
+        PROFILE_BEGIN(PROFILE_PID_CONTROLLER);
         subTaskPidController(currentTimeUs);
+        PROFILE_END(PROFILE_PID_CONTROLLER);
+        PROFILE_BEGIN(PROFILE_MOTOR_UPDATE);
         subTaskMotorUpdate(currentTimeUs);
+        PROFILE_END(PROFILE_MOTOR_UPDATE);
+        flightStatePublish(currentTimeUs);
+#ifdef USE_LOOP_TIMING
+        timeUs_t motorWriteTimeUs = micros();
+#endif
         subTaskPidSubprocesses(currentTimeUs);
+#ifdef USE_LOOP_TIMING
+        // the wait for the output phase is not part of the cost
+        const timeDelta_t pidTimeUs = cmpTimeUs(micros(), loopStartTimeUs);
+#endif
+        if (motorOutputPhase) {
+            subTaskMotorOutput();
+#ifdef USE_LOOP_TIMING
+            motorWriteTimeUs = micros();
+#endif
+        }
+#ifdef USE_LOOP_TIMING
+        loopTimingSample(currentTimeUs, cmpTimeUs(motorWriteTimeUs, gyro.sampleTimeUs), pidTimeUs);
+#endif
     }
 
-    if (debugMode == DEBUG_CYCLETIME) {
-        debug[0] = getTaskDeltaTime(TASK_SELF);
-        debug[1] = averageSystemLoadPercent;
-    }
+#ifdef USE_LOOPTIME_CHECK
+    looptimeCheckSample(gyroUpdateTimeUs, cmpTimeUs(micros(), loopStartTimeUs), pidIteration);
+#endif
+
+    DEBUG_SET(DEBUG_CYCLETIME, 0, getTaskDeltaTime(TASK_GYROPID));
+    DEBUG_SET(DEBUG_CYCLETIME, 1, averageSystemLoadPercent);
 }
 
 bool isFlipOverAfterCrashActive(void)
@@ -1181,3 +1306,9 @@ void resetTryingToArm()
     tryingToArm = ARMING_DELAYED_DISARMED;
 }
 
+// The motor output phase busy-waits in the PID loop, it is not used when the loop runs in the gyro interrupt
+void setMotorOutputPhase(bool enabled)
+{
+    motorOutputPhase = enabled;
+}
+
@@ -44,6 +44,7 @@ void resetArmingDisabled(void);
 void disarm(void);
 void tryArm(void);
 
+void processRxFrame(timeUs_t currentTimeUs);
 bool processRx(timeUs_t currentTimeUs);
 void updateArmingStatus(void);
 
@@ -58,6 +59,7 @@ bool isAirmodeActivated();
 timeUs_t getLastDisarmTimeUs(void);
 bool isTryingToArm();
 void resetTryingToArm();
+void setMotorOutputPhase(bool enabled);
 
 void subTaskTelemetryPollSensors(timeUs_t currentTimeUs);
 
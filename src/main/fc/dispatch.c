@@ -43,6 +43,14 @@ void dispatchEnable(void)
     dispatchEnabled = true;
 }
 
+// The dispatch task is event driven, it is only run once the first entry of the queue falls due
+bool dispatchCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentDeltaTimeUs);
+
+    return head && cmp32(currentTimeUs, head->delayedUntil) >= 0;
+}
+
 void dispatchProcess(uint32_t currentTime)
 {
     for (dispatchEntry_t **p = &head; *p; ) {
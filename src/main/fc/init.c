@@ -50,6 +50,8 @@
 #include "drivers/buttons.h"
 #include "drivers/compass/compass.h"
 #include "drivers/dma.h"
+#include "drivers/dma_plan.h"
+#include "drivers/dma_reqmap.h"
 #include "drivers/exti.h"
 #include "drivers/flash.h"
 #include "drivers/inverter.h"
@@ -82,17 +84,20 @@
 #include "config/config.h"
 #include "fc/dispatch.h"
 #include "fc/init.h"
+#include "fc/loop_timing.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 #include "fc/stats.h"
 #include "fc/tasks.h"
 
 #include "flight/failsafe.h"
+#include "flight/flight_state.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
 #include "flight/servos.h"
+#include "flight/vibration.h"
 
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
@@ -137,6 +142,7 @@
 #include "pg/rx_pwm.h"
 #include "pg/rx_spi.h"
 #include "pg/sdcard.h"
+#include "pg/serial_uart.h"
 #include "pg/vcd.h"
 #include "pg/freq.h"
 
@@ -153,6 +159,7 @@
 #include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
 #include "sensors/initialisation.h"
+#include "sensors/rpm_source.h"
 
 #include "telemetry/telemetry.h"
 
@@ -280,6 +287,81 @@ void sdCardAndFSInit()
 }
 #endif
 
+#ifdef USE_DMA_SPEC
+// Gather the DMA users before any of them starts, so a conflict moves the less
+// important one to another stream instead of leaving it in interrupt mode.
+static void planDmaAssignments(void)
+{
+#ifdef USE_ADC
+    const ADCDevice adcDevice = ADC_CFG_TO_DEV(adcConfig()->device);
+    if (adcDevice != ADCINVALID) {
+        // The ADC has no interrupt driven fallback
+        dmaPlanAddPeripheral(OWNER_ADC, RESOURCE_INDEX(adcDevice), DMA_PERIPH_ADC, adcDevice, adcConfig()->dmaopt[adcDevice], DMA_PLAN_PRIORITY_HIGH);
+    }
+#endif
+
+#if defined(USE_UART) && !defined(SIMULATOR_BUILD)
+    for (int i = 0; i < SERIAL_PORT_COUNT; i++) {
+        const serialPortConfig_t *portConfig = &serialConfig()->portConfigs[i];
+        if (portConfig->identifier < SERIAL_PORT_USART1 || portConfig->identifier > SERIAL_PORT_USART8 || !portConfig->functionMask) {
+            continue;
+        }
+
+        const UARTDevice_e device = SERIAL_PORT_IDENTIFIER_TO_UARTDEV(portConfig->identifier);
+        const dmaPlanPriority_e rxPriority = (portConfig->functionMask & FUNCTION_RX_SERIAL) ? DMA_PLAN_PRIORITY_HIGH : DMA_PLAN_PRIORITY_NORMAL;
+        dmaPlanAddPeripheral(OWNER_SERIAL_TX, RESOURCE_INDEX(device), DMA_PERIPH_UART_TX, device, serialUartConfig(device)->txDmaopt, DMA_PLAN_PRIORITY_NORMAL);
+        dmaPlanAddPeripheral(OWNER_SERIAL_RX, RESOURCE_INDEX(device), DMA_PERIPH_UART_RX, device, serialUartConfig(device)->rxDmaopt, rxPriority);
+    }
+#endif
+
+#if defined(USE_DSHOT) && defined(USE_TIMER)
+    bool dshotTimerDma = motorConfig()->dev.motorPwmProtocol >= PWM_TYPE_DSHOT150;
+#ifdef USE_DSHOT_BITBANG
+    dshotTimerDma = dshotTimerDma && !isDshotBitbangActive(&motorConfig()->dev);
+#endif
+    if (dshotTimerDma) {
+        for (int i = 0; i < getMotorCount(); i++) {
+            const ioTag_t tag = motorConfig()->dev.ioTags[i];
+            dmaPlanAddTimer(OWNER_MOTOR, RESOURCE_INDEX(i), timerGetByTag(tag), dmaoptByTag(tag), DMA_PLAN_PRIORITY_HIGH);
+        }
+    }
+#endif
+
+#ifdef USE_PPM_DMA
+    if (featureIsEnabled(FEATURE_RX_PPM)) {
+        const ioTag_t tag = ppmConfig()->ioTag;
+        dmaPlanAddTimer(OWNER_PPMINPUT, 0, timerGetByTag(tag), dmaoptByTag(tag), DMA_PLAN_PRIORITY_LOW);
+    }
+#endif
+
+#ifdef USE_SOFTSERIAL_DMA
+    if (featureIsEnabled(FEATURE_SOFTSERIAL)) {
+        for (int i = 0; i < SERIAL_PORT_MAX_INDEX - RESOURCE_SOFT_OFFSET; i++) {
+            const serialPortConfig_t *portConfig = serialFindPortConfiguration(SERIAL_PORT_SOFTSERIAL1 + i);
+            if (!portConfig || !portConfig->functionMask) {
+                continue;
+            }
+            const ioTag_t tagRx = serialPinConfig()->ioTagRx[RESOURCE_SOFT_OFFSET + i];
+            const ioTag_t tagTx = serialPinConfig()->ioTagTx[RESOURCE_SOFT_OFFSET + i];
+            dmaPlanAddTimer(OWNER_SERIAL_TX, RESOURCE_INDEX(RESOURCE_SOFT_OFFSET + i), timerGetByTag(tagTx), dmaoptByTag(tagTx), DMA_PLAN_PRIORITY_LOW);
+            if (tagRx != tagTx) {
+                dmaPlanAddTimer(OWNER_SERIAL_RX, RESOURCE_INDEX(RESOURCE_SOFT_OFFSET + i), timerGetByTag(tagRx), dmaoptByTag(tagRx), DMA_PLAN_PRIORITY_LOW);
+            }
+        }
+    }
+#endif
+
+#if defined(USE_LED_STRIP) && defined(USE_TIMER)
+    if (featureIsEnabled(FEATURE_LED_STRIP)) {
+        const ioTag_t tag = ledStripConfig()->ioTag;
+        dmaPlanAddTimer(OWNER_LED_STRIP, 0, timerGetByTag(tag), dmaoptByTag(tag), DMA_PLAN_PRIORITY_LOW);
+    }
+#endif
+
+    dmaPlanSolve();
+}
+#endif
+
 void init(void)
 {
 #ifdef SERIAL_PORT_COUNT
@@ -430,6 +512,9 @@ void init(void)
 #endif
 
     debugMode = systemConfig()->debug_mode;
+#ifdef USE_DEBUG_CHANNELS
+    debugInitChannels(systemConfig()->debug_channel_mode, systemConfig()->debug_channel_slot);
+#endif
 
 #ifdef TARGET_PREINIT
     targetPreInit();
@@ -546,6 +631,10 @@ void init(void)
     mixerInit(mixerConfig()->mixerMode);
     mixerConfigureOutput();
 
+#ifdef USE_DMA_SPEC
+    planDmaAssignments();
+#endif
+
     uint16_t idlePulse = motorConfig()->mincommand;
     if (featureIsEnabled(FEATURE_3D)) {
         idlePulse = flight3DConfig()->neutral3d;
@@ -674,6 +763,13 @@ void init(void)
 
 #ifdef USE_ADC
     adcInit(adcConfig());
+
+#if defined(USE_ADC_MOTOR_SYNC) && defined(USE_MOTOR)
+    // Only the standard PWM timer runs free at a fixed period
+    if (adcConfig()->motorSync && motorConfig()->dev.motorPwmProtocol == PWM_TYPE_STANDARD && motors[0].enabled) {
+        adcSyncToTimer(motors[0].channel.tim);
+    }
+#endif
 #endif
 
     initBoardAlignment(boardAlignment());
@@ -705,6 +801,9 @@ void init(void)
 #ifdef USE_ACC
     accInitFilters();
 #endif
+#ifdef USE_VIBRATION_MONITOR
+    vibrationInit();
+#endif
 
 #ifdef USE_PID_AUDIO
     pidAudioInit();
@@ -757,6 +856,8 @@ void init(void)
 
     failsafeInit();
 
+    flightStateInit();
+
     rxInit();
 
 #ifdef USE_GPS
@@ -848,6 +949,9 @@ void init(void)
 
     batteryInit(); // always needs doing, regardless of features.
 
+#ifdef USE_LOOP_TIMING
+    loopTimingInit();
+#endif
 #ifdef USE_PERSISTENT_STATS
     statsInit();
 #endif
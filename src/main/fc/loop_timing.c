@@ -0,0 +1,201 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Loop timing telemetry while armed: the gyro sample to motor write latency and the cost of the PID loop,
+ * summarised once per window, and every time the gyro loop started late with the task that held it off.
+ * The events are queued for the blackbox, the flight totals are kept for the persistent stats.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LOOP_TIMING
+
+#include "common/maths.h"
+#include "common/spsc_queue.h"
+
+#include "fc/runtime_config.h"
+
+#include "loop_timing.h"
+
+// Written by the PID loop and the scheduler, which are never in two contexts at the same time
+static loopTimingEvent_t loopTimingEventBuffer[LOOP_TIMING_EVENT_COUNT];
+static spscQueue_t loopTimingQueue;
+
+static FAST_RAM_ZERO_INIT timeUs_t windowStartUs;
+static FAST_RAM_ZERO_INIT uint32_t windowSamples;
+static FAST_RAM_ZERO_INIT uint32_t windowLatencySumUs;
+static FAST_RAM_ZERO_INIT uint32_t windowPidTimeSumUs;
+static FAST_RAM_ZERO_INIT timeDelta_t windowMaxLatencyUs;
+static FAST_RAM_ZERO_INIT timeDelta_t windowMaxPidTimeUs;
+static FAST_RAM_ZERO_INIT uint16_t windowOverruns;
+
+static loopTimingFlight_t flight;
+static uint32_t flightHistogram[LOOP_TIMING_HISTOGRAM_BINS];
+static uint32_t flightSamples;
+
+void loopTimingInit(void)
+{
+    spscQueueInit(&loopTimingQueue, loopTimingEventBuffer, sizeof(loopTimingEventBuffer[0]), LOOP_TIMING_EVENT_COUNT);
+    spscQueueRegister(&loopTimingQueue, "LOOP_TIMING");
+}
+
+static void loopTimingResetWindow(timeUs_t currentTimeUs)
+{
+    windowStartUs = currentTimeUs;
+    windowSamples = 0;
+    windowLatencySumUs = 0;
+    windowPidTimeSumUs = 0;
+    windowMaxLatencyUs = 0;
+    windowMaxPidTimeUs = 0;
+    windowOverruns = 0;
+}
+
+void loopTimingOnArm(void)
+{
+    memset(&flight, 0, sizeof(flight));
+    memset(flightHistogram, 0, sizeof(flightHistogram));
+    flightSamples = 0;
+    windowSamples = 0;
+}
+
+// Events that don't fit are dropped, the summary still counts the overruns
+static loopTimingEvent_t *loopTimingNewEvent(loopTimingEventType_e type)
+{
+    loopTimingEvent_t *event = spscQueueProducerSlot(&loopTimingQueue);
+    if (event) {
+        memset(event, 0, sizeof(*event));
+        event->type = type;
+    }
+    return event;
+}
+
+// Called once per PID loop iteration
+FAST_CODE void loopTimingSample(timeUs_t currentTimeUs, timeDelta_t latencyUs, timeDelta_t pidTimeUs)
+{
+    if (!ARMING_FLAG(ARMED)) {
+        return;
+    }
+
+    if (windowSamples == 0) {
+        loopTimingResetWindow(currentTimeUs);
+    }
+
+    windowSamples++;
+    windowLatencySumUs += latencyUs;
+    windowPidTimeSumUs += pidTimeUs;
+    windowMaxLatencyUs = MAX(windowMaxLatencyUs, latencyUs);
+    windowMaxPidTimeUs = MAX(windowMaxPidTimeUs, pidTimeUs);
+
+    flightHistogram[MIN((uint32_t)pidTimeUs / LOOP_TIMING_HISTOGRAM_US, (uint32_t)LOOP_TIMING_HISTOGRAM_BINS - 1)]++;
+    flightSamples++;
+
+    if (cmpTimeUs(currentTimeUs, windowStartUs) >= LOOP_TIMING_WINDOW_US) {
+        flight.maxLatencyUs = MAX(flight.maxLatencyUs, MIN(windowMaxLatencyUs, UINT16_MAX));
+        flight.maxPidTimeUs = MAX(flight.maxPidTimeUs, MIN(windowMaxPidTimeUs, UINT16_MAX));
+
+        loopTimingEvent_t *event = loopTimingNewEvent(LOOP_TIMING_EVENT_SUMMARY);
+        if (event) {
+            event->overruns = windowOverruns;
+            event->avgLatencyUs = windowLatencySumUs / windowSamples;
+            event->maxLatencyUs = MIN(windowMaxLatencyUs, UINT16_MAX);
+            event->avgPidTimeUs = windowPidTimeSumUs / windowSamples;
+            event->maxPidTimeUs = MIN(windowMaxPidTimeUs, UINT16_MAX);
+            spscQueueProducerCommit(&loopTimingQueue);
+        }
+
+        loopTimingResetWindow(currentTimeUs);
+    }
+}
+
+// Called by the scheduler when the gyro loop started late, with the task it is blamed on
+FAST_CODE void loopTimingOverrun(cfTaskId_e taskId, timeDelta_t lateUs, timeDelta_t taskTimeUs)
+{
+    if (!ARMING_FLAG(ARMED)) {
+        return;
+    }
+
+    flight.overruns++;
+    windowOverruns = MIN(windowOverruns + 1, UINT16_MAX);
+
+    loopTimingEvent_t *event = loopTimingNewEvent(LOOP_TIMING_EVENT_OVERRUN);
+    if (event) {
+        event->taskId = taskId;
+        event->lateUs = MIN(lateUs, UINT16_MAX);
+        event->taskTimeUs = constrain(taskTimeUs, 0, UINT16_MAX);
+        spscQueueProducerCommit(&loopTimingQueue);
+    }
+}
+
+// Oldest event not logged yet, or NULL
+const loopTimingEvent_t *loopTimingPeekEvent(void)
+{
+    return spscQueueConsumerPeek(&loopTimingQueue);
+}
+
+void loopTimingReleaseEvent(void)
+{
+    spscQueueConsumerRelease(&loopTimingQueue);
+}
+
+// Drop the events queued while no log was running
+void loopTimingDropEvents(void)
+{
+    while (spscQueueConsumerPeek(&loopTimingQueue)) {
+        spscQueueConsumerRelease(&loopTimingQueue);
+    }
+}
+
+// Totals since arming, including the window that is still open
+void loopTimingGetFlight(loopTimingFlight_t *flightOut)
+{
+    *flightOut = flight;
+
+    if (windowSamples) {
+        flightOut->maxLatencyUs = MAX(flightOut->maxLatencyUs, MIN(windowMaxLatencyUs, UINT16_MAX));
+        flightOut->maxPidTimeUs = MAX(flightOut->maxPidTimeUs, MIN(windowMaxPidTimeUs, UINT16_MAX));
+    }
+
+    if (flightSamples == 0) {
+        flightOut->p99PidTimeUs = 0;
+        return;
+    }
+
+    // Smallest bin edge that 99% of the samples are below
+    const uint32_t limit = flightSamples - flightSamples / 100;
+    uint32_t count = 0;
+    int bin = 0;
+    while (bin < LOOP_TIMING_HISTOGRAM_BINS - 1 && (count += flightHistogram[bin]) < limit) {
+        bin++;
+    }
+
+    if (bin == LOOP_TIMING_HISTOGRAM_BINS - 1) {
+        // The last bin has no upper edge, the longest loop is the only bound there is
+        flightOut->p99PidTimeUs = MAX(flightOut->maxPidTimeUs, LOOP_TIMING_HISTOGRAM_BINS * LOOP_TIMING_HISTOGRAM_US);
+    } else {
+        flightOut->p99PidTimeUs = (bin + 1) * LOOP_TIMING_HISTOGRAM_US;
+    }
+}
+
+#endif // USE_LOOP_TIMING
@@ -0,0 +1,63 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/time.h"
+
+#include "scheduler/scheduler.h"
+
+#define LOOP_TIMING_WINDOW_US           1000000 // a summary event for every second armed
+#define LOOP_TIMING_EVENT_COUNT         16      // power of two
+#define LOOP_TIMING_HISTOGRAM_BINS      64      // PID loop time distribution of a flight...
+#define LOOP_TIMING_HISTOGRAM_US        4       // ...in bins of this width, the last bin takes everything longer
+
+typedef enum {
+    LOOP_TIMING_EVENT_SUMMARY = 0,      // latency and PID loop cost over the last window
+    LOOP_TIMING_EVENT_OVERRUN,          // the gyro loop started late
+} loopTimingEventType_e;
+
+typedef struct loopTimingEvent_s {
+    uint8_t type;
+    uint8_t taskId;                     // overrun: the task that held the gyro loop off
+    uint16_t overruns;                  // summary: overruns in the window
+    uint16_t lateUs;                    // overrun: how late the gyro loop started
+    uint16_t taskTimeUs;                // overrun: run time of the task it is blamed on
+    uint16_t avgLatencyUs;              // summary: gyro sample to motor write
+    uint16_t maxLatencyUs;
+    uint16_t avgPidTimeUs;              // summary: one whole PID loop iteration
+    uint16_t maxPidTimeUs;
+} loopTimingEvent_t;
+
+typedef struct loopTimingFlight_s {
+    uint32_t overruns;
+    uint16_t maxLatencyUs;
+    uint16_t maxPidTimeUs;
+    uint16_t p99PidTimeUs;              // upper edge of the histogram bin, filled by loopTimingGetFlight()
+} loopTimingFlight_t;
+
+void loopTimingInit(void);
+void loopTimingOnArm(void);
+void loopTimingSample(timeUs_t currentTimeUs, timeDelta_t latencyUs, timeDelta_t pidTimeUs);
+void loopTimingOverrun(cfTaskId_e taskId, timeDelta_t lateUs, timeDelta_t taskTimeUs);
+const loopTimingEvent_t *loopTimingPeekEvent(void);
+void loopTimingReleaseEvent(void);
+void loopTimingDropEvents(void);
+void loopTimingGetFlight(loopTimingFlight_t *flight);
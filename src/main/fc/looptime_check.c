@@ -0,0 +1,192 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures the execution time of the gyro and PID loop while disarmed after boot, with all the configured
+ * filters and features running, and checks that the configured PID loop rate leaves enough time for the
+ * other tasks. The longest few samples of the window are left out, so a single interrupt burst or flash
+ * access does not decide the result.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LOOPTIME_CHECK
+
+#include "common/maths.h"
+
+#include "config/config.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/pid.h"
+
+#include "sensors/gyro.h"
+
+#include "looptime_check.h"
+
+typedef enum {
+    LOOPTIME_CHECK_STATE_WAITING = 0,   // waiting for the gyro calibration to finish
+    LOOPTIME_CHECK_STATE_MEASURING,
+    LOOPTIME_CHECK_STATE_PASSED,
+    LOOPTIME_CHECK_STATE_OVERRUN,
+    LOOPTIME_CHECK_STATE_ADJUSTED,      // the PID loop rate was lowered, a reboot applies it
+} looptimeCheckState_e;
+
+#define LONGEST_SAMPLE_COUNT (LOOPTIME_CHECK_OUTLIER_COUNT + 1)
+
+static FAST_RAM_ZERO_INIT volatile uint8_t checkState;
+// the longest samples of the window, longest first
+static FAST_RAM_ZERO_INIT timeDelta_t longestGyroTimeUs[LONGEST_SAMPLE_COUNT];
+static FAST_RAM_ZERO_INIT timeDelta_t longestLoopTimeUs[LONGEST_SAMPLE_COUNT];
+static timeDelta_t maxGyroTimeUs;
+static timeDelta_t maxLoopTimeUs;
+static timeUs_t checkStartTimeUs;
+static uint8_t safePidDenom;
+
+static FAST_CODE void insertLongestSample(timeDelta_t *longest, timeDelta_t sampleUs)
+{
+    // most samples are shorter than all the kept ones
+    if (sampleUs <= longest[LONGEST_SAMPLE_COUNT - 1]) {
+        return;
+    }
+
+    int i = LONGEST_SAMPLE_COUNT - 1;
+    while (i > 0 && longest[i - 1] < sampleUs) {
+        longest[i] = longest[i - 1];
+        i--;
+    }
+    longest[i] = sampleUs;
+}
+
+// Called from the gyro and PID loop with the time spent in gyroUpdate() and in the whole iteration
+FAST_CODE void looptimeCheckSample(timeDelta_t gyroTimeUs, timeDelta_t loopTimeUs, bool pidIteration)
+{
+    if (checkState != LOOPTIME_CHECK_STATE_MEASURING) {
+        return;
+    }
+
+    insertLongestSample(longestGyroTimeUs, gyroTimeUs);
+    if (pidIteration) {
+        insertLongestSample(longestLoopTimeUs, loopTimeUs);
+    }
+}
+
+// One PID iteration and pidDenom - 1 gyro only iterations have to fit into pidDenom gyro loop times
+static bool looptimeFits(uint8_t pidDenom)
+{
+    const int32_t budgetUs = gyro.targetLooptime * pidDenom * LOOPTIME_CHECK_LOAD_PERCENT / 100;
+
+    return maxLoopTimeUs + (pidDenom - 1) * maxGyroTimeUs <= budgetUs;
+}
+
+static void looptimeCheckEvaluate(void)
+{
+    const looptimeCheckMode_e mode = pidConfig()->pid_looptime_check;
+    const uint8_t pidDenom = pidConfig()->pid_process_denom;
+
+    // the shortest kept sample is the longest one after leaving out the outliers
+    maxGyroTimeUs = longestGyroTimeUs[LONGEST_SAMPLE_COUNT - 1];
+    maxLoopTimeUs = longestLoopTimeUs[LONGEST_SAMPLE_COUNT - 1];
+
+    // The configured rate is the highest one allowed, search downwards from it
+    safePidDenom = 0;
+    for (int denom = pidDenom; denom <= MAX_PID_PROCESS_DENOM; denom++) {
+        if (looptimeFits(denom)) {
+            safePidDenom = denom;
+            break;
+        }
+    }
+
+    if (safePidDenom == pidDenom) {
+        checkState = LOOPTIME_CHECK_STATE_PASSED;
+    } else if (mode == LOOPTIME_CHECK_AUTO && safePidDenom) {
+        pidConfigMutable()->pid_process_denom = safePidDenom;
+        saveConfigAndNotify();
+        setRebootRequired();
+        checkState = LOOPTIME_CHECK_STATE_ADJUSTED;
+    } else {
+        // only reported, a lower rate has to be set by hand
+        checkState = LOOPTIME_CHECK_STATE_OVERRUN;
+    }
+}
+
+void looptimeCheckUpdate(timeUs_t currentTimeUs)
+{
+    if (pidConfig()->pid_looptime_check == LOOPTIME_CHECK_OFF) {
+        checkState = LOOPTIME_CHECK_STATE_PASSED;
+        return;
+    }
+
+    switch (checkState) {
+    case LOOPTIME_CHECK_STATE_WAITING:
+        if (gyroIsCalibrationComplete() && !ARMING_FLAG(ARMED)) {
+            memset(longestGyroTimeUs, 0, sizeof(longestGyroTimeUs));
+            memset(longestLoopTimeUs, 0, sizeof(longestLoopTimeUs));
+            checkStartTimeUs = currentTimeUs;
+            checkState = LOOPTIME_CHECK_STATE_MEASURING;
+        }
+        break;
+    case LOOPTIME_CHECK_STATE_MEASURING:
+        if (cmpTimeUs(currentTimeUs, checkStartTimeUs) >= LOOPTIME_CHECK_DURATION_US) {
+            looptimeCheckEvaluate();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+bool looptimeCheckPending(void)
+{
+    return checkState == LOOPTIME_CHECK_STATE_WAITING || checkState == LOOPTIME_CHECK_STATE_MEASURING;
+}
+
+// Only the auto mode holds arming off, until it knows whether it has to change the PID loop rate.
+// A rate that does not fit is reported, it does not block arming.
+bool looptimeCheckBlocksArming(void)
+{
+    return pidConfig()->pid_looptime_check == LOOPTIME_CHECK_AUTO && looptimeCheckPending();
+}
+
+bool looptimeCheckOverrun(void)
+{
+    return checkState == LOOPTIME_CHECK_STATE_OVERRUN;
+}
+
+// Lowest PID process denom that fits, 0 if none does or the check has not finished
+uint8_t looptimeCheckSafePidDenom(void)
+{
+    return safePidDenom;
+}
+
+timeDelta_t looptimeCheckMaxGyroTimeUs(void)
+{
+    return maxGyroTimeUs;
+}
+
+timeDelta_t looptimeCheckMaxLoopTimeUs(void)
+{
+    return maxLoopTimeUs;
+}
+#endif // USE_LOOPTIME_CHECK
@@ -0,0 +1,42 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/time.h"
+
+#define LOOPTIME_CHECK_DURATION_US      500000  // measuring window after the gyro calibration
+#define LOOPTIME_CHECK_LOAD_PERCENT     80      // share of the loop time the gyro and PID loop may use
+#define LOOPTIME_CHECK_OUTLIER_COUNT    4       // longest samples of the window that are left out
+
+typedef enum {
+    LOOPTIME_CHECK_OFF = 0,
+    LOOPTIME_CHECK_WARN,        // report in the CLI status when the configured PID loop rate does not fit
+    LOOPTIME_CHECK_AUTO,        // lower the PID loop rate until it fits, takes effect after a reboot
+} looptimeCheckMode_e;
+
+void looptimeCheckSample(timeDelta_t gyroTimeUs, timeDelta_t loopTimeUs, bool pidIteration);
+void looptimeCheckUpdate(timeUs_t currentTimeUs);
+bool looptimeCheckPending(void);
+bool looptimeCheckOverrun(void);
+bool looptimeCheckBlocksArming(void);
+uint8_t looptimeCheckSafePidDenom(void);
+timeDelta_t looptimeCheckMaxGyroTimeUs(void);
+timeDelta_t looptimeCheckMaxLoopTimeUs(void);
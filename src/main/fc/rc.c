@@ -39,6 +39,7 @@
 #include "fc/core.h"
 #include "fc/rc.h"
 #include "fc/rc_controls.h"
+#include "fc/rc_curves.h"
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
 
@@ -47,6 +48,7 @@
 #include "flight/interpolated_setpoint.h"
 #include "flight/gps_rescue.h"
 #include "flight/pid.h"
+#include "flight/rescue.h"
 
 #include "pg/rx.h"
 
@@ -70,6 +72,10 @@ static float setpointRate[3], rcDeflection[3], rcDeflectionAbs[3];
 static float throttlePIDAttenuation;
 static bool reverseMotors = false;
 static applyRatesFn *applyRates;
+
+// Rate curve sampled over the absolute stick deflection [0, 1], all rate types are odd in the deflection
+#define RATE_CURVE_TABLE_STEPS 256
+static FAST_RAM_ZERO_INIT float rateCurveTable[XYZ_AXIS_COUNT][RATE_CURVE_TABLE_STEPS + 1];
 uint16_t currentRxRefreshRate;
 
 FAST_RAM_ZERO_INIT uint8_t interpolationChannels;
@@ -93,6 +99,7 @@ enum {
 #define RC_SMOOTHING_RX_RATE_CHANGE_PERCENT     20    // Look for samples varying this much from the current detected frame rate to initiate retraining
 #define RC_SMOOTHING_RX_RATE_MIN_US             1000  // 1ms
 #define RC_SMOOTHING_RX_RATE_MAX_US             50000 // 50ms or 20hz
+#define RC_SMOOTHING_RX_JITTER_LIMIT            4     // Samples further than this many link jitters and 25% from the link frame interval are lost or late frames
 #define RC_SMOOTHING_INTERPOLATED_FEEDFORWARD_DERIVATIVE_PT1_HZ 100 // The value to use for "auto" when interpolated feedforward is enabled
 
 static FAST_RAM_ZERO_INIT rcSmoothingFilter_t rcSmoothingData;
@@ -193,14 +200,32 @@ float applyKissRates(const int axis, float rcCommandf, const float rcCommandfAbs
     return kissAngle;
 }
 
-float applyCurve(int axis, float deflection)
+static void initRateCurveTable(void)
+{
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        for (int i = 0; i <= RATE_CURVE_TABLE_STEPS; i++) {
+            const float deflection = (float)i / RATE_CURVE_TABLE_STEPS;
+            rateCurveTable[axis][i] = applyRates(axis, deflection, deflection);
+        }
+    }
+}
+
+FAST_CODE float applyCurve(int axis, float deflection)
 {
-    return applyRates(axis, deflection, fabsf(deflection));
+    const float position = MIN(fabsf(deflection), 1.0f) * RATE_CURVE_TABLE_STEPS;
+    const int index = MIN((int)position, RATE_CURVE_TABLE_STEPS - 1);
+    const float *table = &rateCurveTable[axis][index];
+    const float rate = table[0] + (position - index) * (table[1] - table[0]);
+
+    return (deflection < 0) ? -rate : rate;
 }
 
 float getRcCurveSlope(int axis, float deflection)
 {
-    return (applyCurve(axis, deflection + 0.01f) - applyCurve(axis, deflection)) * 100.0f;
+    // slope of the table segment, in deg/s per unit of deflection
+    const int index = MIN((int)(MIN(fabsf(deflection), 1.0f) * RATE_CURVE_TABLE_STEPS), RATE_CURVE_TABLE_STEPS - 1);
+
+    return (rateCurveTable[axis][index + 1] - rateCurveTable[axis][index]) * RATE_CURVE_TABLE_STEPS;
 }
 
 static void calculateSetpointRate(int axis)
@@ -222,10 +247,9 @@ static void calculateSetpointRate(int axis)
         // scale rcCommandf to range [-1.0, 1.0]
         float rcCommandf = rcCommand[axis] / 500.0f;
         rcDeflection[axis] = rcCommandf;
-        const float rcCommandfAbs = fabsf(rcCommandf);
-        rcDeflectionAbs[axis] = rcCommandfAbs;
+        rcDeflectionAbs[axis] = fabsf(rcCommandf);
 
-        angleRate = applyRates(axis, rcCommandf, rcCommandfAbs);
+        angleRate = applyCurve(axis, rcCommandf);
     }
     // Rate limit from profile (deg/sec)
     setpointRate[axis] = constrainf(angleRate, -1.0f * currentControlRateProfile->rate_limit[axis], 1.0f * currentControlRateProfile->rate_limit[axis]);
@@ -446,6 +470,16 @@ static FAST_CODE bool rcSmoothingAccumulateSample(rcSmoothingFilter_t *smoothing
     return false;
 }
 
+// The link frame interval and jitter come from the protocol timestamps, a sample far outside of them is a lost or
+// late frame and would skew the trained frame rate
+static bool rcSmoothingSampleIsOutlier(int rxFrameTimeUs)
+{
+    const float frameIntervalUs = rxGetFrameIntervalUs();
+    const float limitUs = MAX(RC_SMOOTHING_RX_JITTER_LIMIT * rxGetFrameJitterUs(), 0.25f * frameIntervalUs);
+
+    return fabsf(rxFrameTimeUs - frameIntervalUs) > limitUs;
+}
+
 // Determine if we need to caclulate filter cutoffs. If not then we can avoid
 // examining the rx frame times completely 
 FAST_CODE_NOINLINE bool rcSmoothingAutoCalculate(void)
@@ -506,7 +540,7 @@ static FAST_CODE uint8_t processRcSmoothingFilter(void)
                 float derivativeCutoff = RC_SMOOTHING_INTERPOLATED_FEEDFORWARD_DERIVATIVE_PT1_HZ * cutoffFactor;  // PT1 cutoff frequency
                 if (rcSmoothingData.derivativeFilterType == RC_SMOOTHING_DERIVATIVE_BIQUAD) {
                     // convert to an equivalent BIQUAD cutoff
-                    derivativeCutoff = sqrt(derivativeCutoff * RC_SMOOTHING_IDENTITY_FREQUENCY);
+                    derivativeCutoff = sqrtf(derivativeCutoff * RC_SMOOTHING_IDENTITY_FREQUENCY);
                 }
                 rcSmoothingData.derivativeCutoffFrequency = lrintf(derivativeCutoff);
             } else {
@@ -567,7 +601,7 @@ static FAST_CODE uint8_t processRcSmoothingFilter(void)
                         }
 
                         // accumlate the sample into the average
-                        if (accumulateSample) {
+                        if (accumulateSample && !rcSmoothingSampleIsOutlier(currentRxRefreshRate)) {
                             if (rcSmoothingAccumulateSample(&rcSmoothingData, currentRxRefreshRate)) {
                                 // the required number of samples were collected so set the filter cutoffs
                                 rcSmoothingSetFilterCutoffs(&rcSmoothingData);
@@ -584,7 +618,7 @@ static FAST_CODE uint8_t processRcSmoothingFilter(void)
             }
 
             // rx frame rate training blackbox debugging
-            if (debugMode == DEBUG_RC_SMOOTHING_RATE) {
+            if (DEBUG_MODE_ACTIVE(DEBUG_RC_SMOOTHING_RATE)) {
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 0, currentRxRefreshRate);              // log each rx frame interval
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 1, rcSmoothingData.training.count);    // log the training step count
                 DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 2, rcSmoothingData.averageFrameTimeUs);// the current calculated average
@@ -593,7 +627,7 @@ static FAST_CODE uint8_t processRcSmoothingFilter(void)
         }
     }
 
-    if (rcSmoothingData.filterInitialized && (debugMode == DEBUG_RC_SMOOTHING)) {
+    if (rcSmoothingData.filterInitialized && DEBUG_MODE_ACTIVE(DEBUG_RC_SMOOTHING)) {
         // after training has completed then log the raw rc channel and the calculated
         // average rx frame rate that was used to calculate the automatic filter cutoffs
         DEBUG_SET(DEBUG_RC_SMOOTHING, 0, lrintf(lastRxData[rcSmoothingData.debugAxis]));
@@ -642,8 +676,7 @@ FAST_CODE void processRcCommand(void)
         for (int i = FD_ROLL; i <= FD_YAW; i++) {
             oldRcCommand[i] = rcCommand[i];
             const float rcCommandf = rcCommand[i] / 500.0f;
-            const float rcCommandfAbs = fabsf(rcCommandf);
-            rawSetpoint[i] = applyRates(i, rcCommandf, rcCommandfAbs);
+            rawSetpoint[i] = applyCurve(i, rcCommandf);
             rawDeflection[i] = rcCommandf;
         }
     }
@@ -740,7 +773,11 @@ FAST_CODE_NOINLINE void updateRcCommands(void)
         tmp = tmp * getLowVoltageCutoff()->percentage / 100;
     }
 
-    rcCommand[THROTTLE] = rcLookupThrottle(tmp);
+    if (rcCurvesEnabled()) {
+        rcCommand[THROTTLE] = PWM_RANGE_MIN + rcCurveThrottle(tmp);
+    } else {
+        rcCommand[THROTTLE] = rcLookupThrottle(tmp);
+    }
 
     if (featureIsEnabled(FEATURE_3D) && !failsafeIsActive()) {
         if (!flight3DConfig()->switched_mode3d) {
@@ -780,44 +817,24 @@ FAST_CODE_NOINLINE void updateRcCommands(void)
     
     // HF3D:  Adding collective to rcCommands, constrain to -500/+500 range around midrc
     tmp = constrain(rcData[COLLECTIVE] - rxConfig()->midrc, -500, 500);
-    rcCommand[COLLECTIVE] = tmp;
+    rcCommand[COLLECTIVE] = rcCurveCollective(tmp);
     
 #if defined(USE_ACC)
     // HF3D:  Rescue (angle) mode overrides user's collective pitch rcCommand
     // Check if rescue (angle) mode is active
     if (FLIGHT_MODE(ANGLE_MODE)) {    // || FLIGHT_MODE(GPS_RESCUE_MODE)
-        // attitude.values.roll/pitch = 0 when level, 1800 when fully inverted (decidegrees)
-        // Pitch is +90 / -90 at straight down and straight up.  Invert the absolute value of that so 0 = straight up/down
-        const float pitchCurrentInclination = 90.0f - (ABS(attitude.values.pitch) / 10.0f);
-        // Roll is +90/-90 when sideways, and +180/-180 when inverted
-        float rollCurrentInclination = 0.0f;
-        if (ABS(attitude.values.roll) > 900.0f) {
-            rollCurrentInclination = 90.0f - (180.0f - (ABS(attitude.values.roll) / 10.0f));
-        } else {
-            rollCurrentInclination = 90.0f - (ABS(attitude.values.roll) / 10.0f);
-        }
-        const float vertCurrentInclination = MIN(pitchCurrentInclination, rollCurrentInclination);
-
-        // adjust collective pitch so heli has no collective while past vertical, and pitch is added as it approaches level
-        // vertCurrentInclination between 0 (vertical) and 90 (level)  -- inverted from normal attitude values
-        // Hover pitch on my M2 test rig is around +100, full pitch pumps are around +240
-        // Desired collective at various rescue pitches:
+        // No collective while sideways, rising with the square of the inclination to the rescue collective when level.
+        // Positive towards upright, negative towards inverted. Scheduled by rescueUpdateSetpoint() at PID rate.
+        // Desired collective at various rescue inclinations from level, on a 240 rescue_collective:
         //   90deg = 0 collective, 60deg=25col, 45deg=60col, 30deg=110col, 10deg=190col, 0deg=240col
-        //   ... output of this equation is 240, so normalize it and then multiply by rescue_collective setting.
-        // HF3D TODO:  Add rescue collective agression parameter to reduce tail blowout from large collective swings
-        //   Or just rate limit the collective change?  Basically it's the big load and governor change that can overwhelm
-        //   the tail authority of the heli.
-        // HF3D TODO:  acc angleTrim setting isn't taken into account here... but is in pidLevel.
-        //   Same issue up above.  It's minor as long as angleTrim is small, so maybe not worth the calculation overhead?
-        if ( ((attitude.values.roll / 10.0f) > 90.0f) || ((attitude.values.roll / 10.0f) < -90.0f) ) {
-            // We're closer to inverted and pidLevel will be rolling to inverted.
-            // Use negative collective pitch.
-            rcCommand[COLLECTIVE] = pidGetRescueCollectiveSetting() * (-0.02963f * vertCurrentInclination * vertCurrentInclination) / 240.0f;
-        } else {
-            // We're closer to upright and pidLevel will be rolling to upright.
-            // Use positive collective pitch.
-            rcCommand[COLLECTIVE] = pidGetRescueCollectiveSetting() * (0.02963f * vertCurrentInclination * vertCurrentInclination) / 240.0f;
-        }
+        rcCommand[COLLECTIVE] = rescueGetCollective();
+    }
+#endif
+
+#ifdef USE_GPS_RESCUE
+    // HF3D:  GPS rescue flies altitude on collective, the rotor throttle is held
+    if (FLIGHT_MODE(GPS_RESCUE_MODE)) {
+        rcCommand[COLLECTIVE] = gpsRescueGetCollective();
     }
 #endif
     
@@ -863,6 +880,9 @@ void initRcProcessing(void)
         break;
     }
 
+    initRateCurveTable();
+    rcCurvesInit();
+
     interpolationChannels = 0;
     switch (rxConfig()->rcInterpolationChannels) {
     case INTERPOLATION_CHANNELS_RPYT:
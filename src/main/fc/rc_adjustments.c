@@ -19,6 +19,7 @@
  */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -44,7 +45,10 @@
 #include "fc/rc_controls.h"
 #include "fc/rc.h"
 
+#include "flight/governor.h"
+#include "flight/mixer.h"
 #include "flight/pid.h"
+#include "flight/tailmotor.h"
 
 #include "io/beeper.h"
 #include "io/ledstrip.h"
@@ -224,6 +228,22 @@ static const adjustmentConfig_t defaultAdjustmentConfigs[ADJUSTMENT_FUNCTION_COU
         .adjustmentFunction = ADJUSTMENT_LED_PROFILE,
         .mode = ADJUSTMENT_MODE_SELECT,
         .data = { .switchPositions = 3 }
+    }, {
+        .adjustmentFunction = ADJUSTMENT_GOV_P_GAIN,
+        .mode = ADJUSTMENT_MODE_STEP,
+        .data = { .step = 1 }
+    }, {
+        .adjustmentFunction = ADJUSTMENT_GOV_I_GAIN,
+        .mode = ADJUSTMENT_MODE_STEP,
+        .data = { .step = 1 }
+    }, {
+        .adjustmentFunction = ADJUSTMENT_TAIL_RPM_P_GAIN,
+        .mode = ADJUSTMENT_MODE_STEP,
+        .data = { .step = 1 }
+    }, {
+        .adjustmentFunction = ADJUSTMENT_TAIL_RPM_I_GAIN,
+        .mode = ADJUSTMENT_MODE_STEP,
+        .data = { .step = 1 }
     }
 };
 
@@ -262,332 +282,211 @@ static const char * const adjustmentLabels[] = {
     "ROLL F",
     "YAW F",
     "OSD PROFILE",
+    "LED PROFILE",
+    "GOV P GAIN",
+    "GOV I GAIN",
+    "TAIL RPM P GAIN",
+    "TAIL RPM I GAIN",
 };
 
+STATIC_ASSERT(ARRAYLEN(adjustmentLabels) == ADJUSTMENT_FUNCTION_COUNT - 1, adjustment_labels_out_of_sync);
+
 static int adjustmentRangeNameIndex = 0;
 static int adjustmentRangeValue = -1;
 #endif
 
-static int applyStepAdjustment(controlRateConfig_t *controlRateConfig, uint8_t adjustmentFunction, int delta)
+/*
+ * Registry of the settings the step and absolute adjustments change. Each entry is one
+ * field of the current rate profile, the current PID profile or the mixer config, with
+ * its limits and the refresh that recomputes only what depends on it, so a change takes
+ * effect on the next PID cycle without re-initialising the whole PID config.
+ */
+typedef enum {
+    ADJUSTMENT_TARGET_NONE = 0,
+    ADJUSTMENT_TARGET_RATE_PROFILE,
+    ADJUSTMENT_TARGET_PID_PROFILE,
+    ADJUSTMENT_TARGET_MIXER_CONFIG,
+} adjustmentTarget_e;
+
+// What has to be recomputed after a setting changed, see adjustmentRefresh()
+typedef enum {
+    ADJUSTMENT_REFRESH_NONE = 0,
+    ADJUSTMENT_REFRESH_RC_PROCESSING,
+    ADJUSTMENT_REFRESH_PID_GAIN,
+    ADJUSTMENT_REFRESH_FEEDFORWARD_TRANSITION,
+    ADJUSTMENT_REFRESH_LEVEL_GAINS,
+    ADJUSTMENT_REFRESH_GOVERNOR_GAINS,
+    ADJUSTMENT_REFRESH_TAIL_MOTOR_GAINS,
+} adjustmentRefresh_e;
+
+typedef struct adjustmentSetting_s {
+    uint8_t target;                 // adjustmentTarget_e
+    uint8_t size;                   // of the field, 1 or 2 bytes
+    uint16_t offset;                // of the field in the target
+    int16_t min;
+    int16_t max;
+    uint8_t refresh;                // adjustmentRefresh_e
+    uint8_t axis;                   // for the refresh, a PID gain only
+    uint8_t gain;
+} adjustmentSetting_t;
+
+#define ADJUSTMENT_FIELD(type, field) \
+    .size = sizeof(((type *)0)->field), .offset = offsetof(type, field)
+
+// Every rate setting feeds the precomputed rate curves, so all of them rebuild the RC processing
+#define ADJUSTMENT_RATE(field, lo, hi) \
+    { .target = ADJUSTMENT_TARGET_RATE_PROFILE, ADJUSTMENT_FIELD(controlRateConfig_t, field), .min = lo, .max = hi, .refresh = ADJUSTMENT_REFRESH_RC_PROCESSING }
+
+#define ADJUSTMENT_PID(pidAxis, term, lo, hi) \
+    { .target = ADJUSTMENT_TARGET_PID_PROFILE, ADJUSTMENT_FIELD(pidProfile_t, pid[pidAxis].term), .min = lo, .max = hi, \
+      .refresh = ADJUSTMENT_REFRESH_PID_GAIN, .axis = pidAxis, .gain = PID_GAIN_ ## term }
+
+#define ADJUSTMENT_MIXER(field, lo, hi, what) \
+    { .target = ADJUSTMENT_TARGET_MIXER_CONFIG, ADJUSTMENT_FIELD(mixerConfig_t, field), .min = lo, .max = hi, .refresh = what }
+
+/*
+ * The one path an adjusted gain or rate takes into the flight code. A PID gain goes through
+ * pidInitGain(), which keeps its corrections and the headspeed schedule, the rates rebuild
+ * the RC processing with the rate curves.
+ */
+static void adjustmentRefresh(adjustmentRefresh_e refresh, int axis, pidGain_e gain)
 {
-    beeperConfirmationBeeps(delta > 0 ? 2 : 1);
-    int newValue;
-    switch (adjustmentFunction) {
-    case ADJUSTMENT_RC_RATE:
-    case ADJUSTMENT_ROLL_RC_RATE:
-        newValue = constrain((int)controlRateConfig->rcRates[FD_ROLL] + delta, 1, CONTROL_RATE_CONFIG_RC_RATES_MAX);
-        controlRateConfig->rcRates[FD_ROLL] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_RC_RATE, newValue);
-        if (adjustmentFunction == ADJUSTMENT_ROLL_RC_RATE) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_RC_EXPO
-        FALLTHROUGH;
-    case ADJUSTMENT_PITCH_RC_RATE:
-        newValue = constrain((int)controlRateConfig->rcRates[FD_PITCH] + delta, 1, CONTROL_RATE_CONFIG_RC_RATES_MAX);
-        controlRateConfig->rcRates[FD_PITCH] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_RC_RATE, newValue);
-        break;
-    case ADJUSTMENT_RC_EXPO:
-    case ADJUSTMENT_ROLL_RC_EXPO:
-        newValue = constrain((int)controlRateConfig->rcExpo[FD_ROLL] + delta, 0, CONTROL_RATE_CONFIG_RC_EXPO_MAX);
-        controlRateConfig->rcExpo[FD_ROLL] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_RC_EXPO, newValue);
-        if (adjustmentFunction == ADJUSTMENT_ROLL_RC_EXPO) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_RC_EXPO
-        FALLTHROUGH;
-    case ADJUSTMENT_PITCH_RC_EXPO:
-        newValue = constrain((int)controlRateConfig->rcExpo[FD_PITCH] + delta, 0, CONTROL_RATE_CONFIG_RC_EXPO_MAX);
-        controlRateConfig->rcExpo[FD_PITCH] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_RC_EXPO, newValue);
-        break;
-    case ADJUSTMENT_THROTTLE_EXPO:
-        newValue = constrain((int)controlRateConfig->thrExpo8 + delta, 0, 100); // FIXME magic numbers repeated in cli.c
-        controlRateConfig->thrExpo8 = newValue;
+    switch (refresh) {
+    case ADJUSTMENT_REFRESH_RC_PROCESSING:
         initRcProcessing();
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_THROTTLE_EXPO, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_RATE:
-    case ADJUSTMENT_PITCH_RATE:
-        newValue = constrain((int)controlRateConfig->rates[FD_PITCH] + delta, 0, CONTROL_RATE_CONFIG_RATE_MAX);
-        controlRateConfig->rates[FD_PITCH] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_RATE, newValue);
-        if (adjustmentFunction == ADJUSTMENT_PITCH_RATE) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_RATE
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_RATE:
-        newValue = constrain((int)controlRateConfig->rates[FD_ROLL] + delta, 0, CONTROL_RATE_CONFIG_RATE_MAX);
-        controlRateConfig->rates[FD_ROLL] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_RATE, newValue);
-        break;
-    case ADJUSTMENT_YAW_RATE:
-        newValue = constrain((int)controlRateConfig->rates[FD_YAW] + delta, 0, CONTROL_RATE_CONFIG_RATE_MAX);
-        controlRateConfig->rates[FD_YAW] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_RATE, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_P:
-    case ADJUSTMENT_PITCH_P:
-        newValue = constrain((int)currentPidProfile->pid[PID_PITCH].P + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_PITCH].P = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_P, newValue);
-
-        if (adjustmentFunction == ADJUSTMENT_PITCH_P) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_P
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_P:
-        newValue = constrain((int)currentPidProfile->pid[PID_ROLL].P + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_ROLL].P = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_P, newValue);
         break;
-    case ADJUSTMENT_PITCH_ROLL_I:
-    case ADJUSTMENT_PITCH_I:
-        newValue = constrain((int)currentPidProfile->pid[PID_PITCH].I + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_PITCH].I = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_I, newValue);
-        if (adjustmentFunction == ADJUSTMENT_PITCH_I) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_I
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_I:
-        newValue = constrain((int)currentPidProfile->pid[PID_ROLL].I + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_ROLL].I = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_I, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_D:
-    case ADJUSTMENT_PITCH_D:
-        newValue = constrain((int)currentPidProfile->pid[PID_PITCH].D + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_PITCH].D = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_D, newValue);
-        if (adjustmentFunction == ADJUSTMENT_PITCH_D) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_D
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_D:
-        newValue = constrain((int)currentPidProfile->pid[PID_ROLL].D + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_ROLL].D = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_D, newValue);
+    case ADJUSTMENT_REFRESH_PID_GAIN:
+        pidInitGain(currentPidProfile, axis, gain);
         break;
-    case ADJUSTMENT_YAW_P:
-        newValue = constrain((int)currentPidProfile->pid[PID_YAW].P + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_YAW].P = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_P, newValue);
+    case ADJUSTMENT_REFRESH_FEEDFORWARD_TRANSITION:
+        pidInitFeedForwardTransition(currentPidProfile);
         break;
-    case ADJUSTMENT_YAW_I:
-        newValue = constrain((int)currentPidProfile->pid[PID_YAW].I + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_YAW].I = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_I, newValue);
+    case ADJUSTMENT_REFRESH_LEVEL_GAINS:
+        pidInitLevelGains(currentPidProfile);
         break;
-    case ADJUSTMENT_YAW_D:
-        newValue = constrain((int)currentPidProfile->pid[PID_YAW].D + delta, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_YAW].D = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_D, newValue);
+    case ADJUSTMENT_REFRESH_GOVERNOR_GAINS:
+        governorInitGains();
         break;
-    case ADJUSTMENT_RC_RATE_YAW:
-        newValue = constrain((int)controlRateConfig->rcRates[FD_YAW] + delta, 1, CONTROL_RATE_CONFIG_RC_RATES_MAX);
-        controlRateConfig->rcRates[FD_YAW] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_RC_RATE_YAW, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_F:
-    case ADJUSTMENT_PITCH_F:
-        newValue = constrain(currentPidProfile->pid[PID_PITCH].F + delta, 0, 2000);
-        currentPidProfile->pid[PID_PITCH].F = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_F, newValue);
-
-        if (adjustmentFunction == ADJUSTMENT_PITCH_F) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_F
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_F:
-        newValue = constrain(currentPidProfile->pid[PID_ROLL].F + delta, 0, 2000);
-        currentPidProfile->pid[PID_ROLL].F = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_F, newValue);
-        break;
-    case ADJUSTMENT_YAW_F:
-        newValue = constrain(currentPidProfile->pid[PID_YAW].F + delta, 0, 2000);
-        currentPidProfile->pid[PID_YAW].F = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_F, newValue);
-        break;
-    case ADJUSTMENT_FEEDFORWARD_TRANSITION:
-        newValue = constrain(currentPidProfile->feedForwardTransition + delta, 1, 100); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->feedForwardTransition = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_FEEDFORWARD_TRANSITION, newValue);
+    case ADJUSTMENT_REFRESH_TAIL_MOTOR_GAINS:
+        tailMotorInitGains();
         break;
     default:
-        newValue = -1;
         break;
-    };
+    }
+}
+
+// FIXME PID and throttle expo limits repeated in cli.c
+static const adjustmentSetting_t adjustmentSettings[ADJUSTMENT_FUNCTION_COUNT] = {
+    [ADJUSTMENT_ROLL_RC_RATE]           = ADJUSTMENT_RATE(rcRates[FD_ROLL], 1, CONTROL_RATE_CONFIG_RC_RATES_MAX),
+    [ADJUSTMENT_PITCH_RC_RATE]          = ADJUSTMENT_RATE(rcRates[FD_PITCH], 1, CONTROL_RATE_CONFIG_RC_RATES_MAX),
+    [ADJUSTMENT_RC_RATE_YAW]            = ADJUSTMENT_RATE(rcRates[FD_YAW], 1, CONTROL_RATE_CONFIG_RC_RATES_MAX),
+    [ADJUSTMENT_ROLL_RC_EXPO]           = ADJUSTMENT_RATE(rcExpo[FD_ROLL], 0, CONTROL_RATE_CONFIG_RC_EXPO_MAX),
+    [ADJUSTMENT_PITCH_RC_EXPO]          = ADJUSTMENT_RATE(rcExpo[FD_PITCH], 0, CONTROL_RATE_CONFIG_RC_EXPO_MAX),
+    [ADJUSTMENT_THROTTLE_EXPO]          = ADJUSTMENT_RATE(thrExpo8, 0, 100),
+    [ADJUSTMENT_ROLL_RATE]              = ADJUSTMENT_RATE(rates[FD_ROLL], 0, CONTROL_RATE_CONFIG_RATE_MAX),
+    [ADJUSTMENT_PITCH_RATE]             = ADJUSTMENT_RATE(rates[FD_PITCH], 0, CONTROL_RATE_CONFIG_RATE_MAX),
+    [ADJUSTMENT_YAW_RATE]               = ADJUSTMENT_RATE(rates[FD_YAW], 0, CONTROL_RATE_CONFIG_RATE_MAX),
+    [ADJUSTMENT_ROLL_P]                 = ADJUSTMENT_PID(PID_ROLL, P, 0, 200),
+    [ADJUSTMENT_ROLL_I]                 = ADJUSTMENT_PID(PID_ROLL, I, 0, 200),
+    [ADJUSTMENT_ROLL_D]                 = ADJUSTMENT_PID(PID_ROLL, D, 0, 200),
+    [ADJUSTMENT_ROLL_F]                 = ADJUSTMENT_PID(PID_ROLL, F, 0, 2000),
+    [ADJUSTMENT_PITCH_P]                = ADJUSTMENT_PID(PID_PITCH, P, 0, 200),
+    [ADJUSTMENT_PITCH_I]                = ADJUSTMENT_PID(PID_PITCH, I, 0, 200),
+    [ADJUSTMENT_PITCH_D]                = ADJUSTMENT_PID(PID_PITCH, D, 0, 200),
+    [ADJUSTMENT_PITCH_F]                = ADJUSTMENT_PID(PID_PITCH, F, 0, 2000),
+    [ADJUSTMENT_YAW_P]                  = ADJUSTMENT_PID(PID_YAW, P, 0, 200),
+    [ADJUSTMENT_YAW_I]                  = ADJUSTMENT_PID(PID_YAW, I, 0, 200),
+    [ADJUSTMENT_YAW_D]                  = ADJUSTMENT_PID(PID_YAW, D, 0, 200),
+    [ADJUSTMENT_YAW_F]                  = ADJUSTMENT_PID(PID_YAW, F, 0, 2000),
+    [ADJUSTMENT_FEEDFORWARD_TRANSITION] = {
+        .target = ADJUSTMENT_TARGET_PID_PROFILE, ADJUSTMENT_FIELD(pidProfile_t, feedForwardTransition),
+        .min = 1, .max = 100, .refresh = ADJUSTMENT_REFRESH_FEEDFORWARD_TRANSITION
+    },
+    [ADJUSTMENT_GOV_P_GAIN]             = ADJUSTMENT_MIXER(gov_p_gain, 0, 500, ADJUSTMENT_REFRESH_GOVERNOR_GAINS),
+    [ADJUSTMENT_GOV_I_GAIN]             = ADJUSTMENT_MIXER(gov_i_gain, 0, 500, ADJUSTMENT_REFRESH_GOVERNOR_GAINS),
+    [ADJUSTMENT_TAIL_RPM_P_GAIN]        = ADJUSTMENT_MIXER(tail_rpm_p_gain, 0, 500, ADJUSTMENT_REFRESH_TAIL_MOTOR_GAINS),
+    [ADJUSTMENT_TAIL_RPM_I_GAIN]        = ADJUSTMENT_MIXER(tail_rpm_i_gain, 0, 500, ADJUSTMENT_REFRESH_TAIL_MOTOR_GAINS),
+};
+
+// Functions that adjust two settings together, in this order
+static const uint8_t adjustmentPairs[][3] = {
+    { ADJUSTMENT_RC_RATE,           ADJUSTMENT_ROLL_RC_RATE,    ADJUSTMENT_PITCH_RC_RATE },
+    { ADJUSTMENT_RC_EXPO,           ADJUSTMENT_ROLL_RC_EXPO,    ADJUSTMENT_PITCH_RC_EXPO },
+    { ADJUSTMENT_PITCH_ROLL_RATE,   ADJUSTMENT_PITCH_RATE,      ADJUSTMENT_ROLL_RATE },
+    { ADJUSTMENT_PITCH_ROLL_P,      ADJUSTMENT_PITCH_P,         ADJUSTMENT_ROLL_P },
+    { ADJUSTMENT_PITCH_ROLL_I,      ADJUSTMENT_PITCH_I,         ADJUSTMENT_ROLL_I },
+    { ADJUSTMENT_PITCH_ROLL_D,      ADJUSTMENT_PITCH_D,         ADJUSTMENT_ROLL_D },
+    { ADJUSTMENT_PITCH_ROLL_F,      ADJUSTMENT_PITCH_F,         ADJUSTMENT_ROLL_F },
+};
+
+static void *adjustmentTarget(const adjustmentSetting_t *setting, controlRateConfig_t *controlRateConfig)
+{
+    switch (setting->target) {
+    case ADJUSTMENT_TARGET_RATE_PROFILE:
+        return (uint8_t *)controlRateConfig + setting->offset;
+    case ADJUSTMENT_TARGET_PID_PROFILE:
+        return (uint8_t *)currentPidProfile + setting->offset;
+    case ADJUSTMENT_TARGET_MIXER_CONFIG:
+        return (uint8_t *)mixerConfigMutable() + setting->offset;
+    default:
+        return NULL;
+    }
+}
+
+// Set one registered setting to value, or to its value plus value for a step. Returns the new value, -1 if there is no such setting.
+static int applyAdjustmentSetting(controlRateConfig_t *controlRateConfig, adjustmentFunction_e adjustmentFunction, int value, bool step)
+{
+    const adjustmentSetting_t *setting = &adjustmentSettings[adjustmentFunction];
+    void *field = adjustmentTarget(setting, controlRateConfig);
+
+    if (!field) {
+        return -1;
+    }
+
+    if (step) {
+        value += (setting->size == 1) ? *(uint8_t *)field : *(uint16_t *)field;
+    }
+
+    const int newValue = constrain(value, setting->min, setting->max);
+    if (setting->size == 1) {
+        *(uint8_t *)field = newValue;
+    } else {
+        *(uint16_t *)field = newValue;
+    }
+
+    adjustmentRefresh(setting->refresh, setting->axis, setting->gain);
+
+    blackboxLogInflightAdjustmentEvent(adjustmentFunction, newValue);
 
     return newValue;
 }
 
-static int applyAbsoluteAdjustment(controlRateConfig_t *controlRateConfig, adjustmentFunction_e adjustmentFunction, int value)
+static int applyAdjustment(controlRateConfig_t *controlRateConfig, adjustmentFunction_e adjustmentFunction, int value, bool step)
 {
-    int newValue;
+    if (adjustmentFunction >= ADJUSTMENT_FUNCTION_COUNT) {
+        return -1;
+    }
 
-    switch (adjustmentFunction) {
-    case ADJUSTMENT_RC_RATE:
-    case ADJUSTMENT_ROLL_RC_RATE:
-        newValue = constrain(value, 1, CONTROL_RATE_CONFIG_RC_RATES_MAX);
-        controlRateConfig->rcRates[FD_ROLL] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_RC_RATE, newValue);
-        if (adjustmentFunction == ADJUSTMENT_ROLL_RC_RATE) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_RC_EXPO
-        FALLTHROUGH;
-    case ADJUSTMENT_PITCH_RC_RATE:
-        newValue = constrain(value, 1, CONTROL_RATE_CONFIG_RC_RATES_MAX);
-        controlRateConfig->rcRates[FD_PITCH] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_RC_RATE, newValue);
-        break;
-    case ADJUSTMENT_RC_EXPO:
-    case ADJUSTMENT_ROLL_RC_EXPO:
-        newValue = constrain(value, 1, CONTROL_RATE_CONFIG_RC_EXPO_MAX);
-        controlRateConfig->rcExpo[FD_ROLL] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_RC_EXPO, newValue);
-        if (adjustmentFunction == ADJUSTMENT_ROLL_RC_EXPO) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_RC_EXPO
-        FALLTHROUGH;
-    case ADJUSTMENT_PITCH_RC_EXPO:
-        newValue = constrain(value, 0, CONTROL_RATE_CONFIG_RC_EXPO_MAX);
-        controlRateConfig->rcExpo[FD_PITCH] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_RC_EXPO, newValue);
-        break;
-    case ADJUSTMENT_THROTTLE_EXPO:
-        newValue = constrain(value, 0, 100); // FIXME magic numbers repeated in cli.c
-        controlRateConfig->thrExpo8 = newValue;
-        initRcProcessing();
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_THROTTLE_EXPO, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_RATE:
-    case ADJUSTMENT_PITCH_RATE:
-        newValue = constrain(value, 0, CONTROL_RATE_CONFIG_RATE_MAX);
-        controlRateConfig->rates[FD_PITCH] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_RATE, newValue);
-        if (adjustmentFunction == ADJUSTMENT_PITCH_RATE) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_RATE
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_RATE:
-        newValue = constrain(value, 0, CONTROL_RATE_CONFIG_RATE_MAX);
-        controlRateConfig->rates[FD_ROLL] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_RATE, newValue);
-        break;
-    case ADJUSTMENT_YAW_RATE:
-        newValue = constrain(value, 0, CONTROL_RATE_CONFIG_RATE_MAX);
-        controlRateConfig->rates[FD_YAW] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_RATE, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_P:
-    case ADJUSTMENT_PITCH_P:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_PITCH].P = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_P, newValue);
-
-        if (adjustmentFunction == ADJUSTMENT_PITCH_P) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_P
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_P:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_ROLL].P = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_P, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_I:
-    case ADJUSTMENT_PITCH_I:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_PITCH].I = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_I, newValue);
-        if (adjustmentFunction == ADJUSTMENT_PITCH_I) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_I
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_I:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_ROLL].I = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_I, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_D:
-    case ADJUSTMENT_PITCH_D:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_PITCH].D = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_D, newValue);
-        if (adjustmentFunction == ADJUSTMENT_PITCH_D) {
-            break;
+    for (unsigned i = 0; i < ARRAYLEN(adjustmentPairs); i++) {
+        if (adjustmentPairs[i][0] == adjustmentFunction) {
+            applyAdjustmentSetting(controlRateConfig, adjustmentPairs[i][1], value, step);
+            return applyAdjustmentSetting(controlRateConfig, adjustmentPairs[i][2], value, step);
         }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_D
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_D:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_ROLL].D = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_D, newValue);
-        break;
-    case ADJUSTMENT_YAW_P:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_YAW].P = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_P, newValue);
-        break;
-    case ADJUSTMENT_YAW_I:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_YAW].I = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_I, newValue);
-        break;
-    case ADJUSTMENT_YAW_D:
-        newValue = constrain(value, 0, 200); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->pid[PID_YAW].D = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_D, newValue);
-        break;
-    case ADJUSTMENT_RC_RATE_YAW:
-        newValue = constrain(value, 1, CONTROL_RATE_CONFIG_RC_RATES_MAX);
-        controlRateConfig->rcRates[FD_YAW] = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_RC_RATE_YAW, newValue);
-        break;
-    case ADJUSTMENT_PITCH_ROLL_F:
-    case ADJUSTMENT_PITCH_F:
-        newValue = constrain(value, 0, 2000);
-        currentPidProfile->pid[PID_PITCH].F = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_PITCH_F, newValue);
-
-        if (adjustmentFunction == ADJUSTMENT_PITCH_F) {
-            break;
-        }
-        // fall through for combined ADJUSTMENT_PITCH_ROLL_F
-        FALLTHROUGH;
-    case ADJUSTMENT_ROLL_F:
-        newValue = constrain(value, 0, 2000);
-        currentPidProfile->pid[PID_ROLL].F = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_ROLL_F, newValue);
-        break;
-    case ADJUSTMENT_YAW_F:
-        newValue = constrain(value, 0, 2000);
-        currentPidProfile->pid[PID_YAW].F = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_YAW_F, newValue);
-        break;
-    case ADJUSTMENT_FEEDFORWARD_TRANSITION:
-        newValue = constrain(value, 1, 100); // FIXME magic numbers repeated in cli.c
-        currentPidProfile->feedForwardTransition = newValue;
-        blackboxLogInflightAdjustmentEvent(ADJUSTMENT_FEEDFORWARD_TRANSITION, newValue);
-        break;
-    default:
-        newValue = -1;
-        break;
-    };
+    }
 
-    return newValue;
+    return applyAdjustmentSetting(controlRateConfig, adjustmentFunction, value, step);
+}
+
+static int applyStepAdjustment(controlRateConfig_t *controlRateConfig, adjustmentFunction_e adjustmentFunction, int delta)
+{
+    beeperConfirmationBeeps(delta > 0 ? 2 : 1);
+
+    return applyAdjustment(controlRateConfig, adjustmentFunction, delta, true);
+}
+
+static int applyAbsoluteAdjustment(controlRateConfig_t *controlRateConfig, adjustmentFunction_e adjustmentFunction, int value)
+{
+    return applyAdjustment(controlRateConfig, adjustmentFunction, value, false);
 }
 
 static uint8_t applySelectAdjustment(adjustmentFunction_e adjustmentFunction, uint8_t position)
@@ -609,6 +508,7 @@ static uint8_t applySelectAdjustment(adjustmentFunction_e adjustmentFunction, ui
             if (currentPidProfile->pid[PID_LEVEL].D != newValue) {
                 beeps = ((newValue - currentPidProfile->pid[PID_LEVEL].D) / 8) + 1;
                 currentPidProfile->pid[PID_LEVEL].D = newValue;
+                adjustmentRefresh(ADJUSTMENT_REFRESH_LEVEL_GAINS, 0, 0);
                 blackboxLogInflightAdjustmentEvent(ADJUSTMENT_HORIZON_STRENGTH, position);
             }
         }
@@ -660,7 +560,8 @@ static void calcActiveAdjustmentRanges(void)
     continuosAdjustmentCount = 0;
     for (int i = 0; i < MAX_ADJUSTMENT_RANGE_COUNT; i++) {
         const adjustmentRange_t * const adjustmentRange = adjustmentRanges(i);
-        if (memcmp(adjustmentRange, &defaultAdjustmentRange, sizeof(defaultAdjustmentRange)) != 0) {
+        if (memcmp(adjustmentRange, &defaultAdjustmentRange, sizeof(defaultAdjustmentRange)) != 0 &&
+            adjustmentRange->adjustmentConfig > ADJUSTMENT_NONE && adjustmentRange->adjustmentConfig < ADJUSTMENT_FUNCTION_COUNT) {
             const adjustmentConfig_t *adjustmentConfig = &defaultAdjustmentConfigs[adjustmentRange->adjustmentConfig - ADJUSTMENT_FUNCTION_CONFIG_INDEX_OFFSET];
             if (adjustmentRange->adjustmentCenter == 0 && adjustmentConfig->mode != ADJUSTMENT_MODE_SELECT) {
                 timedAdjustmentState_t *adjustmentState = &stepwiseAdjustments[stepwiseAdjustmentCount++];
@@ -752,8 +653,6 @@ static void processStepwiseAdjustments(controlRateConfig_t *controlRateConfig, c
 
             setConfigDirty();
 
-            pidInitConfig(currentPidProfile);
-
             adjustmentState->ready = false;
 
 #if defined(USE_OSD) && defined(USE_OSD_ADJUSTMENTS)
@@ -807,8 +706,6 @@ static void processContinuosAdjustments(controlRateConfig_t *controlRateConfig)
                         newValue = applyAbsoluteAdjustment(controlRateConfig, adjustmentFunction, value);
 
                         setConfigDirtyIfNotPermanent(&adjustmentRange->range);
-
-                        pidInitConfig(currentPidProfile);
                     }
                 }
 #if defined(USE_OSD) && defined(USE_OSD_ADJUSTMENTS)
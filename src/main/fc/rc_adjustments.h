@@ -62,6 +62,10 @@ typedef enum {
     ADJUSTMENT_YAW_F,
     ADJUSTMENT_OSD_PROFILE,
     ADJUSTMENT_LED_PROFILE,
+    ADJUSTMENT_GOV_P_GAIN,
+    ADJUSTMENT_GOV_I_GAIN,
+    ADJUSTMENT_TAIL_RPM_P_GAIN,
+    ADJUSTMENT_TAIL_RPM_I_GAIN,
     ADJUSTMENT_FUNCTION_COUNT
 } adjustmentFunction_e;
 
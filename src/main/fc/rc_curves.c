@@ -0,0 +1,150 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "fc/rc_modes.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "rc_curves.h"
+
+PG_REGISTER_WITH_RESET_TEMPLATE(rcCurveConfig_t, rcCurveConfig, PG_RC_CURVE_CONFIG, 0);
+
+PG_RESET_TEMPLATE(rcCurveConfig_t, rcCurveConfig,
+    .enabled = false,
+    .throttle = {
+        [RC_CURVE_BANK_NORMAL]  = { 0, 13, 25, 38, 50, 63, 75, 88, 100 },
+        [RC_CURVE_BANK_IDLEUP1] = { 80, 80, 80, 80, 80, 80, 80, 80, 80 },
+        [RC_CURVE_BANK_IDLEUP2] = { 100, 100, 100, 100, 100, 100, 100, 100, 100 },
+        [RC_CURVE_BANK_HOLD]    = { 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    },
+    .collective = {
+        [RC_CURVE_BANK_NORMAL]  = { -100, -75, -50, -25, 0, 25, 50, 75, 100 },
+        [RC_CURVE_BANK_IDLEUP1] = { -100, -75, -50, -25, 0, 25, 50, 75, 100 },
+        [RC_CURVE_BANK_IDLEUP2] = { -100, -75, -50, -25, 0, 25, 50, 75, 100 },
+        [RC_CURVE_BANK_HOLD]    = { -100, -75, -50, -25, 0, 25, 50, 75, 100 },
+    },
+);
+
+// The curves are smoothed and sampled once into dense tables, so switching banks only
+// switches tables and a lookup is one linear interpolation at any point count
+#define RC_CURVE_TABLE_STEPS 32
+
+static FAST_RAM_ZERO_INIT float throttleCurveTable[RC_CURVE_BANK_COUNT][RC_CURVE_TABLE_STEPS + 1];
+static FAST_RAM_ZERO_INIT float collectiveCurveTable[RC_CURVE_BANK_COUNT][RC_CURVE_TABLE_STEPS + 1];
+static FAST_RAM_ZERO_INIT bool curvesEnabled;
+
+// Samples a monotone cubic through count evenly spaced points (Fritsch-Butland tangents),
+// the curve keeps the shape of the points without overshooting between them
+static void rcCurveBuildTable(float *table, const float *points, int count)
+{
+    float tangent[RC_CURVE_POINT_COUNT];
+
+    tangent[0] = points[1] - points[0];
+    tangent[count - 1] = points[count - 1] - points[count - 2];
+    for (int i = 1; i < count - 1; i++) {
+        const float left = points[i] - points[i - 1];
+        const float right = points[i + 1] - points[i];
+        tangent[i] = (left * right > 0) ? 2 * left * right / (left + right) : 0;
+    }
+
+    const int segments = count - 1;
+    for (int i = 0; i <= RC_CURVE_TABLE_STEPS; i++) {
+        const float position = (float)i * segments / RC_CURVE_TABLE_STEPS;
+        const int k = MIN((int)position, segments - 1);
+        const float t = position - k;
+        const float t2 = t * t;
+        const float t3 = t2 * t;
+
+        table[i] = (2 * t3 - 3 * t2 + 1) * points[k] + (t3 - 2 * t2 + t) * tangent[k]
+            + (3 * t2 - 2 * t3) * points[k + 1] + (t3 - t2) * tangent[k + 1];
+    }
+}
+
+void rcCurvesInit(void)
+{
+    curvesEnabled = rcCurveConfig()->enabled;
+
+    for (int bank = 0; bank < RC_CURVE_BANK_COUNT; bank++) {
+        float points[RC_CURVE_POINT_COUNT];
+
+        // throttle [0;1000], collective [-500;500]
+        for (int i = 0; i < RC_CURVE_POINT_COUNT; i++) {
+            points[i] = MIN(rcCurveConfig()->throttle[bank][i], 100) * 10.0f;
+        }
+        rcCurveBuildTable(throttleCurveTable[bank], points, RC_CURVE_POINT_COUNT);
+
+        for (int i = 0; i < RC_CURVE_POINT_COUNT; i++) {
+            points[i] = constrain(rcCurveConfig()->collective[bank][i], -100, 100) * 5.0f;
+        }
+        rcCurveBuildTable(collectiveCurveTable[bank], points, RC_CURVE_POINT_COUNT);
+    }
+}
+
+bool rcCurvesEnabled(void)
+{
+    return curvesEnabled;
+}
+
+rcCurveBank_e rcCurveGetBank(void)
+{
+    if (RC_MODE_FLAG(RC_MODE_FLAG_THROTTLEHOLD)) {
+        return RC_CURVE_BANK_HOLD;
+    }
+    if (RC_MODE_FLAG(RC_MODE_FLAG_IDLEUP2)) {
+        return RC_CURVE_BANK_IDLEUP2;
+    }
+    if (RC_MODE_FLAG(RC_MODE_FLAG_IDLEUP1)) {
+        return RC_CURVE_BANK_IDLEUP1;
+    }
+    return RC_CURVE_BANK_NORMAL;
+}
+
+// input is the stick position scaled to [0;1]
+static float rcCurveLookup(const float *table, float input)
+{
+    const float position = constrainf(input, 0.0f, 1.0f) * RC_CURVE_TABLE_STEPS;
+    const int index = MIN((int)position, RC_CURVE_TABLE_STEPS - 1);
+
+    return table[index] + (position - index) * (table[index + 1] - table[index]);
+}
+
+// throttle stick [0;1000] to throttle [0;1000]
+float rcCurveThrottle(float throttle)
+{
+    return rcCurveLookup(throttleCurveTable[rcCurveGetBank()], throttle / 1000.0f);
+}
+
+// collective stick [-500;500] to collective [-500;500]
+float rcCurveCollective(float collective)
+{
+    if (!curvesEnabled) {
+        return collective;
+    }
+
+    return rcCurveLookup(collectiveCurveTable[rcCurveGetBank()], (collective + 500.0f) / 1000.0f);
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pg/pg.h"
+
+#define RC_CURVE_POINT_COUNT 9      // points evenly spaced over the stick throw
+
+typedef enum {
+    RC_CURVE_BANK_NORMAL = 0,
+    RC_CURVE_BANK_IDLEUP1,
+    RC_CURVE_BANK_IDLEUP2,
+    RC_CURVE_BANK_HOLD,
+    RC_CURVE_BANK_COUNT
+} rcCurveBank_e;
+
+typedef struct rcCurveConfig_s {
+    uint8_t enabled;                                                // use the curves instead of thr_mid / thr_expo
+    uint8_t throttle[RC_CURVE_BANK_COUNT][RC_CURVE_POINT_COUNT];    // percent, [0, 100]
+    int8_t collective[RC_CURVE_BANK_COUNT][RC_CURVE_POINT_COUNT];   // percent, [-100, 100]
+} rcCurveConfig_t;
+
+PG_DECLARE(rcCurveConfig_t, rcCurveConfig);
+
+void rcCurvesInit(void);
+bool rcCurvesEnabled(void);
+rcCurveBank_e rcCurveGetBank(void);
+float rcCurveThrottle(float throttle);
+float rcCurveCollective(float collective);
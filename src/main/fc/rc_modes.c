@@ -28,6 +28,7 @@
 
 #include "common/bitarray.h"
 #include "common/maths.h"
+#include "common/utils.h"
 #include "drivers/time.h"
 
 #include "config/feature.h"
@@ -45,12 +46,61 @@
 boxBitmask_t rcModeActivationMask; // one bit per mode defined in boxId_e
 static boxBitmask_t stickyModesEverDisabled;
 
+uint16_t rcModeFlags;
+
 static bool airmodeEnabled;
 
-static int activeMacCount = 0;
-static uint8_t activeMacArray[MAX_MODE_ACTIVATION_CONDITION_COUNT];
-static int activeLinkedMacCount = 0;
-static uint8_t activeLinkedMacArray[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+/*
+ * The mode activation conditions are compiled by analyzeModeActivationConditions() into:
+ *  - per used AUX channel, a table of the steps where any of its ranges start or end,
+ *    with the set of conditions active from that step up to the next one
+ *  - per used box, the OR and the AND conditions as bitmasks, one bit per condition
+ *  - the linked conditions, which follow the state of another box
+ * updateActivatedModes() then looks up one table entry per channel and masks the boxes.
+ */
+typedef uint32_t modeConditionMask_t;
+
+STATIC_ASSERT(MAX_MODE_ACTIVATION_CONDITION_COUNT <= 32, mode_condition_mask_too_small);
+
+// A channel has a segment at step 0 and one at each range start and end
+#define MODE_SEGMENT_COUNT  (3 * MAX_MODE_ACTIVATION_CONDITION_COUNT)
+#define MODE_BOX_NONE       255
+
+typedef struct modeChannel_s {
+    uint8_t auxChannelIndex;
+    uint8_t firstSegment;
+    uint8_t segmentCount;
+} modeChannel_t;
+
+typedef struct modeBox_s {
+    uint8_t boxId;
+    modeConditionMask_t orMask;
+    modeConditionMask_t andMask;
+} modeBox_t;
+
+typedef struct modeLink_s {
+    uint8_t condition;
+    uint8_t linkedTo;
+} modeLink_t;
+
+static modeChannel_t modeChannels[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static uint8_t modeChannelCount;
+
+static uint8_t modeSegmentStep[MODE_SEGMENT_COUNT];
+static modeConditionMask_t modeSegmentActive[MODE_SEGMENT_COUNT];
+
+static modeBox_t modeBoxes[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static uint8_t modeBoxCount;
+static uint8_t modeBoxIndex[CHECKBOX_ITEM_COUNT];
+
+static modeLink_t modeLinks[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static uint8_t modeLinkCount;
+static modeConditionMask_t modeLinkedMask;
+
+// Boxes copied to rcModeFlags, in rcModeFlags_e order
+static const uint8_t rcModeFlagBoxes[] = {
+    BOXSERVO1, BOXSERVO2, BOXSERVO3, BOX3D, BOXGOVBAILOUT, BOXTHROTTLEHOLD, BOXIDLEUP1, BOXIDLEUP2,
+};
 
 PG_REGISTER_ARRAY(modeActivationCondition_t, MAX_MODE_ACTIVATION_CONDITION_COUNT, modeActivationConditions, PG_MODE_ACTIVATION_PROFILE, 2);
 
@@ -62,6 +112,14 @@ bool IS_RC_MODE_ACTIVE(boxId_e boxId)
 void rcModeUpdate(boxBitmask_t *newState)
 {
     rcModeActivationMask = *newState;
+
+    uint16_t flags = 0;
+    for (unsigned i = 0; i < ARRAYLEN(rcModeFlagBoxes); i++) {
+        if (bitArrayGet(&rcModeActivationMask, rcModeFlagBoxes[i])) {
+            flags |= 1 << i;
+        }
+    }
+    rcModeFlags = flags;
 }
 
 bool airmodeIsEnabled(void) {
@@ -78,83 +136,82 @@ bool isRangeActive(uint8_t auxChannelIndex, const channelRange_t *range) {
             channelValue < 900 + (range->endStep * 25));
 }
 
-/*
- *  updateMasksForMac:
- * 
- *  The following are the possible logic states at each MAC update:
- *      AND     NEW
- *      ---     ---
- *       F       F      - no previous AND macs evaluated, no previous active OR macs
- *       F       T      - at least 1 previous active OR mac (***this state is latched True***)
- *       T       F      - all previous AND macs active, no previous active OR macs
- *       T       T      - at least 1 previous inactive AND mac, no previous active OR macs
- */
-void updateMasksForMac(const modeActivationCondition_t *mac, boxBitmask_t *andMask, boxBitmask_t *newMask, bool bActive)
+static bool modeBoxActive(const modeBox_t *box, modeConditionMask_t active, modeConditionMask_t evaluated)
 {
-    if (bitArrayGet(andMask, mac->modeId) || !bitArrayGet(newMask, mac->modeId)) {
-        bool bAnd = mac->modeLogic == MODELOGIC_AND;
-        
-        if (!bAnd) {    // OR mac
-            if (bActive) {
-                bitArrayClr(andMask, mac->modeId);
-                bitArraySet(newMask, mac->modeId);
-            }
-        } else {        // AND mac
-            bitArraySet(andMask, mac->modeId);
-            if (!bActive) {
-                bitArraySet(newMask, mac->modeId);
-            }
-        }
-    }
+    const modeConditionMask_t orMask = box->orMask & evaluated;
+    const modeConditionMask_t andMask = box->andMask & evaluated;
+
+    // Any OR condition active, or all of the AND conditions
+    return (active & orMask) || (andMask && (active & andMask) == andMask);
 }
 
-void updateMasksForStickyModes(const modeActivationCondition_t *mac, boxBitmask_t *andMask, boxBitmask_t *newMask)
+// Sticky modes stay on once active from a switch, and the switches only count after
+// they were seen off after boot. Linked conditions are not sticky.
+static bool modeStickyBoxActive(const modeBox_t *box, modeConditionMask_t active, modeConditionMask_t evaluated)
 {
-    if (IS_RC_MODE_ACTIVE(mac->modeId)) {
-        bitArrayClr(andMask, mac->modeId);
-        bitArraySet(newMask, mac->modeId);
-    } else {
-        bool bActive = isRangeActive(mac->auxChannelIndex, &mac->range);
+    const modeConditionMask_t sticky = (box->orMask | box->andMask) & ~modeLinkedMask;
 
-        if (bitArrayGet(&stickyModesEverDisabled, mac->modeId)) {
-            updateMasksForMac(mac, andMask, newMask, bActive);
-        } else {
-            if (micros() >= STICKY_MODE_BOOT_DELAY_US && !bActive) {
-                bitArraySet(&stickyModesEverDisabled, mac->modeId);
-            }
+    if (sticky && IS_RC_MODE_ACTIVE(box->boxId)) {
+        return true;
+    }
+
+    if (!bitArrayGet(&stickyModesEverDisabled, box->boxId)) {
+        if (micros() >= STICKY_MODE_BOOT_DELAY_US && (active & sticky) != sticky) {
+            bitArraySet(&stickyModesEverDisabled, box->boxId);
         }
+        evaluated &= modeLinkedMask;
+    }
+
+    return modeBoxActive(box, active, evaluated);
+}
+
+static bool modeBoxUpdate(const modeBox_t *box, modeConditionMask_t active, modeConditionMask_t evaluated)
+{
+    if (box->boxId == BOXPARALYZE) {
+        return modeStickyBoxActive(box, active, evaluated);
     }
+
+    return modeBoxActive(box, active, evaluated);
 }
 
 void updateActivatedModes(void)
 {
-    boxBitmask_t newMask, andMask, stickyModes;
-    memset(&andMask, 0, sizeof(andMask));
-    memset(&newMask, 0, sizeof(newMask));
-    memset(&stickyModes, 0, sizeof(stickyModes));
-    bitArraySet(&stickyModes, BOXPARALYZE);
-
-    // determine which conditions set/clear the mode
-    for (int i = 0; i < activeMacCount; i++) {
-        const modeActivationCondition_t *mac = modeActivationConditions(activeMacArray[i]);
-
-        if (bitArrayGet(&stickyModes, mac->modeId)) {
-            updateMasksForStickyModes(mac, &andMask, &newMask);
-        } else if (mac->modeId < CHECKBOX_ITEM_COUNT) {
-            bool bActive = isRangeActive(mac->auxChannelIndex, &mac->range);
-            updateMasksForMac(mac, &andMask, &newMask, bActive);
+    modeConditionMask_t active = 0;
+
+    for (int i = 0; i < modeChannelCount; i++) {
+        const modeChannel_t *channel = &modeChannels[i];
+        const uint16_t channelValue = constrain(rcData[channel->auxChannelIndex + NON_AUX_CHANNEL_COUNT], CHANNEL_RANGE_MIN, CHANNEL_RANGE_MAX - 1);
+        const uint8_t step = (channelValue - CHANNEL_RANGE_MIN) / 25;
+
+        // The first segment of a channel is at step 0
+        int segment = channel->firstSegment + channel->segmentCount - 1;
+        while (modeSegmentStep[segment] > step) {
+            segment--;
         }
+        active |= modeSegmentActive[segment];
     }
 
-    // Update linked modes
-    for (int i = 0; i < activeLinkedMacCount; i++) {
-        const modeActivationCondition_t *mac = modeActivationConditions(activeLinkedMacArray[i]);
-        bool bActive = bitArrayGet(&andMask, mac->linkedTo) != bitArrayGet(&newMask, mac->linkedTo);
+    // Linked conditions in order, each one sees the conditions evaluated before it
+    modeConditionMask_t evaluated = ~modeLinkedMask;
+    for (int i = 0; i < modeLinkCount; i++) {
+        const modeLink_t *link = &modeLinks[i];
+        const uint8_t index = modeBoxIndex[link->linkedTo];
+        const modeConditionMask_t bit = 1U << link->condition;
 
-        updateMasksForMac(mac, &andMask, &newMask, bActive);
+        if (index != MODE_BOX_NONE && modeBoxUpdate(&modeBoxes[index], active, evaluated)) {
+            active |= bit;
+        }
+        evaluated |= bit;
     }
 
-    bitArrayXor(&newMask, sizeof(newMask), &newMask, &andMask);
+    boxBitmask_t newMask;
+    memset(&newMask, 0, sizeof(newMask));
+
+    for (int i = 0; i < modeBoxCount; i++) {
+        if (modeBoxUpdate(&modeBoxes[i], active, ~0)) {
+            bitArraySet(&newMask, modeBoxes[i].boxId);
+        }
+    }
 
     rcModeUpdate(&newMask);
 
@@ -220,22 +277,121 @@ bool isModeActivationConditionConfigured(const modeActivationCondition_t *mac, c
     }
 }
 
-// Build the list of used modeActivationConditions indices
-// We can then use this to speed up processing by only evaluating used conditions
+static modeBox_t *modeBoxGet(uint8_t boxId)
+{
+    if (modeBoxIndex[boxId] == MODE_BOX_NONE) {
+        modeBox_t *box = &modeBoxes[modeBoxCount];
+        box->boxId = boxId;
+        box->orMask = 0;
+        box->andMask = 0;
+        modeBoxIndex[boxId] = modeBoxCount++;
+    }
+
+    return &modeBoxes[modeBoxIndex[boxId]];
+}
+
+// Segment table of one AUX channel, from the usable ranges of the unlinked conditions on it
+static void compileModeChannel(uint8_t auxChannelIndex, modeConditionMask_t linked)
+{
+    modeChannel_t *channel = &modeChannels[modeChannelCount++];
+    channel->auxChannelIndex = auxChannelIndex;
+    channel->firstSegment = modeChannelCount > 1 ? channel[-1].firstSegment + channel[-1].segmentCount : 0;
+    channel->segmentCount = 0;
+
+    uint8_t *steps = &modeSegmentStep[channel->firstSegment];
+    steps[channel->segmentCount++] = 0;
+
+    for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
+        const modeActivationCondition_t *mac = modeActivationConditions(i);
+
+        if ((linked & (1U << i)) || mac->auxChannelIndex != auxChannelIndex || !IS_RANGE_USABLE(&mac->range)) {
+            continue;
+        }
+
+        const uint8_t bounds[2] = { mac->range.startStep, mac->range.endStep };
+        for (int b = 0; b < 2; b++) {
+            // Sorted insert, without duplicates
+            int pos = channel->segmentCount;
+            while (pos > 0 && steps[pos - 1] > bounds[b]) {
+                pos--;
+            }
+            if (steps[pos - 1] != bounds[b]) {
+                memmove(&steps[pos + 1], &steps[pos], channel->segmentCount - pos);
+                steps[pos] = bounds[b];
+                channel->segmentCount++;
+            }
+        }
+    }
+
+    for (int segment = 0; segment < channel->segmentCount; segment++) {
+        modeConditionMask_t mask = 0;
+
+        for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
+            const modeActivationCondition_t *mac = modeActivationConditions(i);
+
+            if (!(linked & (1U << i)) && mac->auxChannelIndex == auxChannelIndex &&
+                steps[segment] >= mac->range.startStep && steps[segment] < mac->range.endStep) {
+                mask |= 1U << i;
+            }
+        }
+
+        modeSegmentActive[channel->firstSegment + segment] = mask;
+    }
+}
+
+// Compile the configured modeActivationConditions for updateActivatedModes().
+// Must be called after any change to the conditions.
 void analyzeModeActivationConditions(void)
 {
     modeActivationCondition_t emptyMac;
     memset(&emptyMac, 0, sizeof(emptyMac));
 
-    activeMacCount = 0;
-    activeLinkedMacCount = 0;
+    modeChannelCount = 0;
+    modeBoxCount = 0;
+    modeLinkCount = 0;
+    modeLinkedMask = 0;
+    memset(modeBoxIndex, MODE_BOX_NONE, sizeof(modeBoxIndex));
+
+    uint8_t channels[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+    int channelCount = 0;
 
     for (uint8_t i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
         const modeActivationCondition_t *mac = modeActivationConditions(i);
+
+        if (mac->modeId >= CHECKBOX_ITEM_COUNT) {
+            continue;
+        }
+
         if (mac->linkedTo) {
-            activeLinkedMacArray[activeLinkedMacCount++] = i;
-        } else if (isModeActivationConditionConfigured(mac, &emptyMac)) {
-            activeMacArray[activeMacCount++] = i;
+            if (mac->linkedTo >= CHECKBOX_ITEM_COUNT) {
+                continue;
+            }
+            modeLinks[modeLinkCount].condition = i;
+            modeLinks[modeLinkCount].linkedTo = mac->linkedTo;
+            modeLinkCount++;
+            modeLinkedMask |= 1U << i;
+        } else if (!isModeActivationConditionConfigured(mac, &emptyMac)) {
+            continue;
+        } else if (IS_RANGE_USABLE(&mac->range)) {
+            int c = 0;
+            while (c < channelCount && channels[c] != mac->auxChannelIndex) {
+                c++;
+            }
+            if (c == channelCount) {
+                channels[channelCount++] = mac->auxChannelIndex;
+            }
         }
+
+        // Conditions with an unusable range are never active, they still count for the AND logic
+
+        modeBox_t *box = modeBoxGet(mac->modeId);
+        if (mac->modeLogic == MODELOGIC_AND) {
+            box->andMask |= 1U << i;
+        } else {
+            box->orMask |= 1U << i;
+        }
+    }
+    for (int c = 0; c < channelCount; c++) {
+        compileModeChannel(channels[c], modeLinkedMask);
     }
 }
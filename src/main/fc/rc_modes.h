@@ -73,6 +73,11 @@ typedef enum {
     BOXPIDAUDIO,
     BOXACROTRAINER,
     BOXVTXCONTROLDISABLE,
+    BOXGOVBAILOUT,
+    BOXIDLEUP1,
+    BOXIDLEUP2,
+    BOXTHROTTLEHOLD,
+    BOXSYSID,
 //    BOXLAUNCHCONTROL,     // HF3D: Removed.
     CHECKBOX_ITEM_COUNT
 } boxId_e;
@@ -121,6 +126,22 @@ typedef struct modeActivationProfile_s {
 
 #define IS_RANGE_USABLE(range) ((range)->startStep < (range)->endStep)
 
+// Boxes read every PID cycle, copied from the activation mask on each update
+typedef enum {
+    RC_MODE_FLAG_SERVO1         = (1 << 0),
+    RC_MODE_FLAG_SERVO2         = (1 << 1),
+    RC_MODE_FLAG_SERVO3         = (1 << 2),
+    RC_MODE_FLAG_3D             = (1 << 3),
+    RC_MODE_FLAG_GOVBAILOUT     = (1 << 4),
+    RC_MODE_FLAG_THROTTLEHOLD   = (1 << 5),
+    RC_MODE_FLAG_IDLEUP1        = (1 << 6),
+    RC_MODE_FLAG_IDLEUP2        = (1 << 7),
+} rcModeFlags_e;
+
+extern uint16_t rcModeFlags;
+
+#define RC_MODE_FLAG(mask) (rcModeFlags & (mask))
+
 bool IS_RC_MODE_ACTIVE(boxId_e boxId);
 void rcModeUpdate(boxBitmask_t *newState);
 
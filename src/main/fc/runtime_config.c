@@ -58,6 +58,7 @@ const char *armingDisableFlagNames[]= {
     "REBOOT_REQD",
     "DSHOT_BBANG",
     "ACC_CALIB",
+    "LOOPTIME",
     "ARMSWITCH",
 };
 
@@ -18,22 +18,37 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "platform.h"
 
 #ifdef USE_PERSISTENT_STATS
 
+#include "blackbox/blackbox_io.h"
+
+#include "common/maths.h"
+
+#include "drivers/bus_i2c.h"
+#include "drivers/bus_spi.h"
 #include "drivers/time.h"
 
 #include "config/config.h"
 #include "fc/dispatch.h"
+#include "fc/loop_timing.h"
 #include "fc/runtime_config.h"
 #include "fc/stats.h"
 
+#include "flight/governor.h"
+#include "flight/vibration.h"
+
 #include "io/beeper.h"
 #include "io/gps.h"
 
 #include "pg/stats.h"
 
+#include "sensors/rpm_source.h"
+
 
 #define MIN_FLIGHT_TIME_TO_RECORD_STATS_S 10 // Prevent recording stats for that short "flights" [s]
 #define STATS_SAVE_DELAY_US 500000 // Let disarming complete and save stats after this time
@@ -41,6 +56,12 @@
 static timeMs_t arm_millis;
 static uint32_t arm_distance_cm;
 
+// Counters since boot at arming, the flight gets the difference
+static uint32_t arm_bb_dropped;
+static uint32_t arm_rpm_dropouts;
+static uint16_t arm_i2c_errors;
+static uint16_t arm_spi_errors;
+
 static bool saveRequired = false;
 
 #ifdef USE_GPS
@@ -76,11 +97,82 @@ dispatchEntry_t writeStatsEntry =
     writeStats, 0, NULL, false
 };
 
+static uint32_t statsBlackboxDropped(void)
+{
+#ifdef USE_BLACKBOX
+    return blackboxGetDroppedBytes();
+#else
+    return 0;
+#endif
+}
+
+static uint16_t statsI2cErrors(void)
+{
+#ifdef USE_I2C
+    return i2cGetErrorCounter();
+#else
+    return 0;
+#endif
+}
+
+static uint16_t statsSpiErrors(void)
+{
+    uint16_t errors = 0;
+#ifdef USE_SPI
+    for (SPIDevice device = SPIDEV_1; device < SPIDEV_COUNT; device++) {
+        errors += spiGetErrorCounter(spiInstanceByDevice(device));
+    }
+#endif
+    return errors;
+}
+
+static void statsRecordFlight(void)
+{
+    statsConfig_t *stats = statsConfigMutable();
+
+#ifdef USE_LOOP_TIMING
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+    stats->stats_total_overruns += flight.overruns;
+    stats->stats_max_latency_us = MAX(stats->stats_max_latency_us, flight.maxLatencyUs);
+    stats->stats_max_pid_time_us = MAX(stats->stats_max_pid_time_us, flight.maxPidTimeUs);
+    stats->stats_flight_max_pid_time_us = flight.maxPidTimeUs;
+    stats->stats_flight_p99_pid_time_us = flight.p99PidTimeUs;
+    stats->stats_flight_overruns = flight.overruns;
+#endif
+
+    governorFlight_t governor;
+    governorGetFlight(&governor);
+    stats->stats_flight_max_droop_rpm = governor.maxDroopRpm;
+    stats->stats_flight_gov_saturated_ms = governor.saturatedMs;
+
+    stats->stats_flight_bb_dropped = statsBlackboxDropped() - arm_bb_dropped;
+    stats->stats_flight_rpm_dropouts = MIN(getRpmSourceDropouts() - arm_rpm_dropouts, (uint32_t)UINT16_MAX);
+    stats->stats_flight_i2c_errors = statsI2cErrors() - arm_i2c_errors;
+    stats->stats_flight_spi_errors = statsSpiErrors() - arm_spi_errors;
+
+#ifdef USE_VIBRATION_MONITOR
+    vibrationFlight_t vibration;
+    vibrationGetFlight(&vibration);
+    stats->stats_flight_vib_main_1x = vibration.maxGyro[VIBRATION_MAIN_1X];
+    stats->stats_flight_vib_main_2x = vibration.maxGyro[VIBRATION_MAIN_2X];
+    stats->stats_flight_vib_tail_1x = vibration.maxGyro[VIBRATION_TAIL_1X];
+#endif
+}
 
 void statsOnArm(void)
 {
     arm_millis      = millis();
     arm_distance_cm = DISTANCE_FLOWN_CM;
+
+    arm_bb_dropped   = statsBlackboxDropped();
+    arm_rpm_dropouts = getRpmSourceDropouts();
+    arm_i2c_errors   = statsI2cErrors();
+    arm_spi_errors   = statsSpiErrors();
+    governorResetFlight();
+#ifdef USE_VIBRATION_MONITOR
+    vibrationResetFlight();
+#endif
 }
 
 void statsOnDisarm(void)
@@ -91,6 +183,7 @@ void statsOnDisarm(void)
             statsConfigMutable()->stats_total_flights += 1;    //arm/flight counter
             statsConfigMutable()->stats_total_time_s += dt;   //[s]
             statsConfigMutable()->stats_total_dist_m += (DISTANCE_FLOWN_CM - arm_distance_cm) / 100;   //[m]
+            statsRecordFlight();
 
             saveRequired = true;
         }
@@ -24,6 +24,8 @@
 
 #include "platform.h"
 
+#include "blackbox/blackbox.h"
+
 #include "build/debug.h"
 
 #include "cli/cli.h"
@@ -39,6 +41,7 @@
 #include "drivers/compass/compass.h"
 #include "drivers/sensor.h"
 #include "drivers/serial.h"
+#include "drivers/serial_softserial.h"
 #include "drivers/serial_usb_vcp.h"
 #include "drivers/stack_check.h"
 #include "drivers/usb_io.h"
@@ -54,6 +57,7 @@
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
+#include "flight/vibration.h"
 
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
@@ -68,6 +72,8 @@
 
 #include "osd/osd.h"
 
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
 #include "pg/rx.h"
 #include "pg/motor.h"
 
@@ -104,6 +110,24 @@
 
 #include "tasks.h"
 
+#ifdef USE_GYRO_ISR_PID
+#include "build/atomic.h"
+#include "drivers/nvic.h"
+
+// With the PID loop in the gyro interrupt, tasks that change the state it reads hold the interrupt off,
+// so the loop sees that state change between two iterations: rc commands and arming (RX), settings and
+// profiles (serial), attitude and acc, the battery meters and states, and the ESC sensor telemetry.
+// The gyro interrupt has the lowest priority, the UART, DMA and timer interrupts still preempt both.
+#define PID_STATE_BLOCK ATOMIC_BLOCK(NVIC_PRIO_MPU_INT_EXTI)
+
+static void taskMainPidLoopIsr(timeUs_t currentTimeUs)
+{
+    schedulerExecuteIsrTask(TASK_GYROPID, currentTimeUs);
+}
+#else
+#define PID_STATE_BLOCK
+#endif
+
 static void taskMain(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
@@ -122,60 +146,125 @@ static void taskHandleSerial(timeUs_t currentTimeUs)
     DEBUG_SET(DEBUG_USB, 1, usbVcpIsConnected());
 #endif
 
+    PID_STATE_BLOCK {
 #ifdef USE_CLI
-    // in cli mode, all serial stuff goes to here. enter cli mode by sending #
-    if (cliMode) {
-        cliProcess();
-        return;
-    }
+        // in cli mode, all serial stuff goes to here. enter cli mode by sending #
+        if (cliMode) {
+            cliProcess();
+            return;
+        }
 #endif
-    bool evaluateMspData = ARMING_FLAG(ARMED) ? MSP_SKIP_NON_MSP_DATA : MSP_EVALUATE_NON_MSP_DATA;
-    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply);
+        bool evaluateMspData = ARMING_FLAG(ARMED) ? MSP_SKIP_NON_MSP_DATA : MSP_EVALUATE_NON_MSP_DATA;
+        mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply);
+    }
 }
 
 static void taskBatteryAlerts(timeUs_t currentTimeUs)
 {
-    if (!ARMING_FLAG(ARMED)) {
-        // the battery *might* fall out in flight, but if that happens the FC will likely be off too unless the user has battery backup.
-        batteryUpdatePresence();
+    PID_STATE_BLOCK {
+        if (!ARMING_FLAG(ARMED)) {
+            // the battery *might* fall out in flight, but if that happens the FC will likely be off too unless the user has battery backup.
+            batteryUpdatePresence();
+        }
+        batteryUpdateStates(currentTimeUs);
+        batteryUpdateAlarms();
+    }
+}
+
+static void taskBatteryVoltage(timeUs_t currentTimeUs)
+{
+    PID_STATE_BLOCK {
+        batteryUpdateVoltage(currentTimeUs);
+    }
+}
+
+static void taskBatteryCurrent(timeUs_t currentTimeUs)
+{
+    PID_STATE_BLOCK {
+        batteryUpdateCurrentMeter(currentTimeUs);
+    }
+}
+
+static void taskBatteryLoad(timeUs_t currentTimeUs)
+{
+    PID_STATE_BLOCK {
+        batteryUpdateLoad(currentTimeUs);
     }
-    batteryUpdateStates(currentTimeUs);
-    batteryUpdateAlarms();
 }
 
 #ifdef USE_ACC
 static void taskUpdateAccelerometer(timeUs_t currentTimeUs)
 {
-    accUpdate(currentTimeUs, &accelerometerConfigMutable()->accelerometerTrims);
+    PID_STATE_BLOCK {
+        accUpdate(currentTimeUs, &accelerometerConfigMutable()->accelerometerTrims);
+    }
+}
+
+// The gyro reads that fetch the acc data signal the task, the gyro loop only stores the raw sample
+static bool taskUpdateAccelerometerCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentTimeUs);
+    UNUSED(currentDeltaTimeUs);
+
+    return accBurstSampleReady();
 }
 #endif
 
 static void taskUpdateRxMain(timeUs_t currentTimeUs)
 {
-    static timeUs_t lastRxTimeUs;
+    PID_STATE_BLOCK {
+        if (!processRx(currentTimeUs)) {
+            return;
+        }
 
-    if (!processRx(currentTimeUs)) {
-        return;
-    }
+        if (!rxInlineDecodeEnabled()) {
+            processRxFrame(currentTimeUs);
+        }
 
-    timeDelta_t rxFrameDeltaUs;
-    if (!rxGetFrameDelta(&rxFrameDeltaUs)) {
-        rxFrameDeltaUs = cmpTimeUs(currentTimeUs, lastRxTimeUs); // calculate a delta here if not supplied by the protocol
+#ifdef USE_USB_CDC_HID
+        if (!ARMING_FLAG(ARMED)) {
+            sendRcDataToHid();
+        }
+#endif
+
+        updateArmingStatus();
     }
-    lastRxTimeUs = currentTimeUs;
-    currentRxRefreshRate = constrain(rxFrameDeltaUs, 1000, 30000);
-    isRXDataNew = true;
+}
 
-#ifdef USE_USB_CDC_HID
-    if (!ARMING_FLAG(ARMED)) {
-        sendRcDataToHid();
+#ifdef USE_GPS
+// Runs on every burst of GPS messages, and at the task rate for the GPS state machine
+static bool taskGpsCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    return gpsFrameReceived(currentTimeUs) || currentDeltaTimeUs >= cfTasks[TASK_GPS].desiredPeriod;
+}
+#endif
+
+#ifdef USE_ESC_SENSOR
+// Runs on every ESC telemetry frame, and at the task rate for the KISS requests and the data age
+static bool taskEscSensorCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    return escSensorFrameReceived() || currentDeltaTimeUs >= cfTasks[TASK_ESC_SENSOR].desiredPeriod;
+}
+
+static void taskEscSensor(timeUs_t currentTimeUs)
+{
+    PID_STATE_BLOCK {
+        escSensorProcess(currentTimeUs);
     }
+}
 #endif
 
-    // updateRcCommands sets rcCommand, which is needed by updateAltHoldState and updateSonarAltHoldState
-    updateRcCommands();
-    updateArmingStatus();
+#ifdef USE_MAG
+static void taskUpdateMag(timeUs_t currentTimeUs)
+{
+    if (sensors(SENSOR_MAG)) {
+        const uint32_t newDeadline = compassUpdate(currentTimeUs);
+        rescheduleTask(TASK_SELF, newDeadline);
+    }
 }
+#endif
 
 #ifdef USE_BARO
 static void taskUpdateBaro(timeUs_t currentTimeUs)
@@ -198,6 +287,20 @@ static void taskCalculateAltitude(timeUs_t currentTimeUs)
 }
 #endif // USE_BARO || USE_GPS
 
+#ifdef USE_ACC
+static void taskUpdateAttitude(timeUs_t currentTimeUs)
+{
+    PID_STATE_BLOCK {
+        imuUpdateAttitude(currentTimeUs);
+    }
+
+#if defined(USE_BARO) || defined(USE_GPS)
+    // the vertical state follows the freshly rotated acceleration
+    updateEstimatedAltitude(currentTimeUs);
+#endif
+}
+#endif
+
 #ifdef USE_TELEMETRY
 static void taskTelemetry(timeUs_t currentTimeUs)
 {
@@ -209,6 +312,124 @@ static void taskTelemetry(timeUs_t currentTimeUs)
 }
 #endif
 
+#ifdef USE_BLACKBOX_OFFLOAD
+static void taskBlackbox(timeUs_t currentTimeUs)
+{
+    if (!cliMode && blackboxConfig()->device) {
+        blackboxBackgroundUpdate(currentTimeUs);
+    }
+}
+#endif
+
+PG_REGISTER_WITH_RESET_TEMPLATE(taskConfig_t, taskConfig, PG_TASK_CONFIG, 1);
+
+PG_RESET_TEMPLATE(taskConfig_t, taskConfig,
+    .rateHz = { 0 },
+    .priority = { TASK_CONFIG_PRIORITY_DEFAULT },
+);
+
+static const cfTaskId_e taskConfigTaskIds[TASK_CONFIG_COUNT] = {
+#ifdef USE_OSD
+    [TASK_CONFIG_OSD] = TASK_OSD,
+#else
+    [TASK_CONFIG_OSD] = TASK_NONE,
+#endif
+#ifdef USE_TELEMETRY
+    [TASK_CONFIG_TELEMETRY] = TASK_TELEMETRY,
+#else
+    [TASK_CONFIG_TELEMETRY] = TASK_NONE,
+#endif
+#ifdef USE_ESC_SENSOR
+    [TASK_CONFIG_ESC_SENSOR] = TASK_ESC_SENSOR,
+#else
+    [TASK_CONFIG_ESC_SENSOR] = TASK_NONE,
+#endif
+    [TASK_CONFIG_BATTERY_LOAD] = TASK_BATTERY_LOAD,
+};
+
+static const uint8_t taskConfigPriorities[TASK_CONFIG_PRIORITY_COUNT] = {
+    [TASK_CONFIG_PRIORITY_IDLE] = TASK_PRIORITY_IDLE,
+    [TASK_CONFIG_PRIORITY_LOW] = TASK_PRIORITY_LOW,
+    [TASK_CONFIG_PRIORITY_MEDIUM] = TASK_PRIORITY_MEDIUM,
+    [TASK_CONFIG_PRIORITY_MEDIUM_HIGH] = TASK_PRIORITY_MEDIUM_HIGH,
+    [TASK_CONFIG_PRIORITY_HIGH] = TASK_PRIORITY_HIGH,
+};
+
+// rates and priorities chosen by tasksInit, used where the config asks for the default
+static timeDelta_t taskConfigDefaultPeriod[TASK_CONFIG_COUNT];
+static uint8_t taskConfigDefaultPriority[TASK_CONFIG_COUNT];
+
+static void taskConfigStoreDefaults(void)
+{
+    for (int index = 0; index < TASK_CONFIG_COUNT; index++) {
+        const cfTaskId_e taskId = taskConfigTaskIds[index];
+        if (taskId != TASK_NONE) {
+            taskConfigDefaultPeriod[index] = cfTasks[taskId].desiredPeriod;
+            taskConfigDefaultPriority[index] = cfTasks[taskId].staticPriority;
+        }
+    }
+}
+
+#if defined(USE_TASK_STATISTICS)
+// Load the enabled tasks would put on the system at the given rates, from their average execution times
+static uint32_t tasksConfigLoadPermille(const taskConfig_t *config)
+{
+    uint32_t loadPermille = 0;
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        // the PID loop may be run from the gyro interrupt instead of the queue
+        if (taskInfo.isEnabled || taskId == TASK_GYROPID) {
+            uint32_t rateHz = taskInfo.desiredPeriod ? TASK_PERIOD_HZ(taskInfo.desiredPeriod) : 0;
+            for (int index = 0; index < TASK_CONFIG_COUNT; index++) {
+                if (taskConfigTaskIds[index] == taskId) {
+                    rateHz = config->rateHz[index] ? config->rateHz[index] : TASK_PERIOD_HZ(taskConfigDefaultPeriod[index]);
+                }
+            }
+            loadPermille += taskInfo.averageExecutionTime * rateHz / 1000;
+        }
+    }
+    return loadPermille;
+}
+#endif
+
+/*
+ * Checks the load the tasks would put on the system with the given rates. A config above the limit
+ * still fits when it doesn't load the system more than the one in use, so that a board that is over
+ * the limit already can be tuned down. Without task statistics there is nothing to project from and
+ * any config fits.
+ */
+bool tasksConfigFits(const taskConfig_t *config)
+{
+#if defined(USE_TASK_STATISTICS)
+    const uint32_t loadPermille = tasksConfigLoadPermille(config);
+    return loadPermille <= TASK_CONFIG_LOAD_LIMIT_PERCENT * 10 || loadPermille <= tasksConfigLoadPermille(taskConfig());
+#else
+    UNUSED(config);
+    return true;
+#endif
+}
+
+void tasksApplyConfig(void)
+{
+    for (int index = 0; index < TASK_CONFIG_COUNT; index++) {
+        const cfTaskId_e taskId = taskConfigTaskIds[index];
+        if (taskId == TASK_NONE) {
+            continue;
+        }
+
+        const uint16_t rateHz = taskConfig()->rateHz[index];
+        rescheduleTask(taskId, rateHz ? TASK_PERIOD_HZ(rateHz) : taskConfigDefaultPeriod[index]);
+
+        const uint8_t priority = taskConfig()->priority[index];
+        if (priority != TASK_CONFIG_PRIORITY_DEFAULT && priority < TASK_CONFIG_PRIORITY_COUNT) {
+            setTaskPriority(taskId, taskConfigPriorities[priority]);
+        } else {
+            setTaskPriority(taskId, taskConfigDefaultPriority[index]);
+        }
+    }
+}
+
 void tasksInit(void)
 {
     schedulerInit();
@@ -224,18 +445,40 @@ void tasksInit(void)
     setTaskEnabled(TASK_BATTERY_CURRENT, useBatteryCurrent);
     const bool useBatteryAlerts = batteryConfig()->useVBatAlerts || batteryConfig()->useConsumptionAlerts || featureIsEnabled(FEATURE_OSD);
     setTaskEnabled(TASK_BATTERY_ALERTS, (useBatteryVoltage || useBatteryCurrent) && useBatteryAlerts);
+    setTaskEnabled(TASK_BATTERY_LOAD, useBatteryVoltage || useBatteryCurrent);
 
 #ifdef STACK_CHECK
     setTaskEnabled(TASK_STACK_CHECK, true);
 #endif
 
+#ifdef USE_BLACKBOX_OFFLOAD
+    // the PID loop only captures the blackbox frames, the blackbox task encodes and writes them
+    blackboxSetOffload(true);
+    setTaskEnabled(TASK_BLACKBOX, true);
+#endif
+
+    bool pidLoopInIsr = false;
     if (sensors(SENSOR_GYRO)) {
         rescheduleTask(TASK_GYROPID, gyro.targetLooptime);
-        setTaskEnabled(TASK_GYROPID, true);
+#ifdef USE_GYRO_ISR_PID
+        // the gyro interrupt runs the PID loop, the cooperative scheduler only runs the background tasks
+        pidLoopInIsr = gyroConfig()->gyro_isr_pid && gyroSetIsrTask(taskMainPidLoopIsr);
+#endif
+        if (!pidLoopInIsr) {
+            setTaskEnabled(TASK_GYROPID, true);
+        }
+#ifdef USE_GYRO_TEMP_COMP
+        setTaskEnabled(TASK_GYRO_TEMP_COMP, gyroConfig()->gyro_temp_comp != GYRO_TEMP_COMP_OFF);
+#endif
+#ifdef USE_VIBRATION_MONITOR
+        setTaskEnabled(TASK_VIBRATION, vibrationConfig()->vibration_monitor);
+#endif
     }
 
 #if defined(USE_ACC)
     if (sensors(SENSOR_ACC)) {
+        // an acc read with the gyro is event driven, before the task is queued
+        cfTasks[TASK_ACCEL].checkFunc = acc.gyroBurst ? taskUpdateAccelerometerCheck : NULL;
         setTaskEnabled(TASK_ACCEL, true);
         rescheduleTask(TASK_ACCEL, acc.accSamplingInterval);
         setTaskEnabled(TASK_ATTITUDE, true);
@@ -249,6 +492,10 @@ void tasksInit(void)
 #endif
 
     setTaskEnabled(TASK_RX, true);
+    // a PID loop in the gyro interrupt could preempt the frame status check, so it never decodes frames itself
+    rxSetInlineDecode(rxConfig()->rx_inline_pid && !pidLoopInIsr);
+    // nor waits for the motor output phase
+    setMotorOutputPhase(motorConfig()->outputPhaseUs && !pidLoopInIsr);
 
     setTaskEnabled(TASK_DISPATCH, dispatchIsEnabled());
 
@@ -301,6 +548,10 @@ void tasksInit(void)
     setTaskEnabled(TASK_ESC_SENSOR, featureIsEnabled(FEATURE_ESC_SENSOR));
 #endif
 
+#ifdef USE_SOFTSERIAL_DMA
+    setTaskEnabled(TASK_SOFTSERIAL, featureIsEnabled(FEATURE_SOFTSERIAL));
+#endif
+
 #ifdef USE_ADC_INTERNAL
     setTaskEnabled(TASK_ADC_INTERNAL, true);
 #endif
@@ -317,6 +568,8 @@ void tasksInit(void)
 #endif
 #endif
 
+    taskConfigStoreDefaults();
+    tasksApplyConfig();
 }
 
 #if defined(USE_TASK_STATISTICS)
@@ -343,8 +596,9 @@ cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_MAIN] = DEFINE_TASK("SYSTEM", "UPDATE", NULL, taskMain, TASK_PERIOD_HZ(1000), TASK_PRIORITY_MEDIUM_HIGH),
     [TASK_SERIAL] = DEFINE_TASK("SERIAL", NULL, NULL, taskHandleSerial, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW), // 100 Hz should be enough to flush up to 115 bytes @ 115200 baud
     [TASK_BATTERY_ALERTS] = DEFINE_TASK("BATTERY_ALERTS", NULL, NULL, taskBatteryAlerts, TASK_PERIOD_HZ(5), TASK_PRIORITY_MEDIUM),
-    [TASK_BATTERY_VOLTAGE] = DEFINE_TASK("BATTERY_VOLTAGE", NULL, NULL, batteryUpdateVoltage, TASK_PERIOD_HZ(50), TASK_PRIORITY_MEDIUM),
-    [TASK_BATTERY_CURRENT] = DEFINE_TASK("BATTERY_CURRENT", NULL, NULL, batteryUpdateCurrentMeter, TASK_PERIOD_HZ(50), TASK_PRIORITY_MEDIUM), 
+    [TASK_BATTERY_VOLTAGE] = DEFINE_TASK("BATTERY_VOLTAGE", NULL, NULL, taskBatteryVoltage, TASK_PERIOD_HZ(50), TASK_PRIORITY_MEDIUM),
+    [TASK_BATTERY_CURRENT] = DEFINE_TASK("BATTERY_CURRENT", NULL, NULL, taskBatteryCurrent, TASK_PERIOD_HZ(50), TASK_PRIORITY_MEDIUM), 
+    [TASK_BATTERY_LOAD] = DEFINE_TASK("BATTERY_LOAD", NULL, NULL, taskBatteryLoad, TASK_PERIOD_HZ(500), TASK_PRIORITY_MEDIUM),
 
 #ifdef STACK_CHECK
     [TASK_STACK_CHECK] = DEFINE_TASK("STACKCHECK", NULL, NULL, taskStackCheck, TASK_PERIOD_HZ(10), TASK_PRIORITY_IDLE),
@@ -353,21 +607,21 @@ cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_GYROPID] = DEFINE_TASK("PID", "GYRO", NULL, taskMainPidLoop, TASK_GYROPID_DESIRED_PERIOD, TASK_PRIORITY_REALTIME),
 #ifdef USE_ACC
     [TASK_ACCEL] = DEFINE_TASK("ACC", NULL, NULL, taskUpdateAccelerometer, TASK_PERIOD_HZ(1000), TASK_PRIORITY_MEDIUM),
-    [TASK_ATTITUDE] = DEFINE_TASK("ATTITUDE", NULL, NULL, imuUpdateAttitude, TASK_PERIOD_HZ(100), TASK_PRIORITY_MEDIUM),
+    [TASK_ATTITUDE] = DEFINE_TASK("ATTITUDE", NULL, NULL, taskUpdateAttitude, TASK_PERIOD_HZ(100), TASK_PRIORITY_MEDIUM),
 #endif
     [TASK_RX] = DEFINE_TASK("RX", NULL, rxUpdateCheck, taskUpdateRxMain, TASK_PERIOD_HZ(33), TASK_PRIORITY_HIGH), // If event-based scheduling doesn't work, fallback to periodic scheduling
-    [TASK_DISPATCH] = DEFINE_TASK("DISPATCH", NULL, NULL, dispatchProcess, TASK_PERIOD_HZ(1000), TASK_PRIORITY_HIGH),
+    [TASK_DISPATCH] = DEFINE_TASK("DISPATCH", NULL, dispatchCheck, dispatchProcess, TASK_PERIOD_HZ(1000), TASK_PRIORITY_HIGH),
 
 #ifdef USE_BEEPER
-    [TASK_BEEPER] = DEFINE_TASK("BEEPER", NULL, NULL, beeperUpdate, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+    [TASK_BEEPER] = DEFINE_TASK("BEEPER", NULL, beeperCheck, beeperUpdate, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
 #endif
 
 #ifdef USE_GPS
-    [TASK_GPS] = DEFINE_TASK("GPS", NULL, NULL, gpsUpdate, TASK_PERIOD_HZ(100), TASK_PRIORITY_MEDIUM), // Required to prevent buffer overruns if running at 115200 baud (115 bytes / period < 256 bytes buffer)
+    [TASK_GPS] = DEFINE_TASK("GPS", NULL, taskGpsCheck, gpsUpdate, TASK_PERIOD_HZ(100), TASK_PRIORITY_MEDIUM), // Required to prevent buffer overruns if running at 115200 baud (115 bytes / period < 256 bytes buffer)
 #endif
 
 #ifdef USE_MAG
-    [TASK_COMPASS] = DEFINE_TASK("COMPASS", NULL, NULL, compassUpdate,TASK_PERIOD_HZ(10), TASK_PRIORITY_LOW),
+    [TASK_COMPASS] = DEFINE_TASK("COMPASS", NULL, NULL, taskUpdateMag, TASK_PERIOD_HZ(COMPASS_TASK_RATE_HZ), TASK_PRIORITY_LOW),
 #endif
 
 #ifdef USE_BARO
@@ -395,7 +649,11 @@ cfTask_t cfTasks[TASK_COUNT] = {
 #endif
 
 #ifdef USE_ESC_SENSOR
-    [TASK_ESC_SENSOR] = DEFINE_TASK("ESC_SENSOR", NULL, NULL, escSensorProcess, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+    [TASK_ESC_SENSOR] = DEFINE_TASK("ESC_SENSOR", NULL, taskEscSensorCheck, taskEscSensor, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+#endif
+
+#ifdef USE_SOFTSERIAL_DMA
+    [TASK_SOFTSERIAL] = DEFINE_TASK("SOFTSERIAL", NULL, NULL, softSerialDmaProcess, TASK_PERIOD_HZ(1000), TASK_PRIORITY_MEDIUM),
 #endif
 
 #ifdef USE_CMS
@@ -410,6 +668,23 @@ cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_PINIOBOX] = DEFINE_TASK("PINIOBOX", NULL, NULL, pinioBoxUpdate, TASK_PERIOD_HZ(20), TASK_PRIORITY_IDLE),
 #endif
 
+#ifdef USE_BLACKBOX_OFFLOAD
+    [TASK_BLACKBOX] = DEFINE_TASK("BLACKBOX", NULL, NULL, taskBlackbox, TASK_PERIOD_HZ(BLACKBOX_TASK_RATE_HZ), TASK_PRIORITY_MEDIUM_HIGH),
+#endif
+
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+    // enabled by saveConfigInBackground() until the save is done
+    [TASK_CONFIG_SAVE] = DEFINE_TASK("CONFIGSAVE", NULL, NULL, configSaveProcess, TASK_PERIOD_HZ(500), TASK_PRIORITY_IDLE),
+#endif
+
+#ifdef USE_GYRO_TEMP_COMP
+    [TASK_GYRO_TEMP_COMP] = DEFINE_TASK("GYROTEMP", NULL, NULL, gyroTempCompUpdate, TASK_PERIOD_HZ(10), TASK_PRIORITY_LOW),
+#endif
+
+#ifdef USE_VIBRATION_MONITOR
+    [TASK_VIBRATION] = DEFINE_TASK("VIBRATION", NULL, NULL, vibrationUpdate, TASK_PERIOD_HZ(VIBRATION_UPDATE_HZ), TASK_PRIORITY_LOW),
+#endif
+
 #ifdef USE_RANGEFINDER
     [TASK_RANGEFINDER] = DEFINE_TASK("RANGEFINDER", NULL, NULL, rangefinderUpdate, TASK_PERIOD_HZ(10), TASK_PRIORITY_IDLE),
 #endif
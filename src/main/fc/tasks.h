@@ -20,6 +20,39 @@
 
 #pragma once
 
+#include "pg/pg.h"
+
 #define LOOPTIME_SUSPEND_TIME 3  // Prevent too long busy wait times
 
+#define TASK_CONFIG_RATE_MAX 1000
+#define TASK_CONFIG_LOAD_LIMIT_PERCENT 75   // projected load of all enabled tasks a new task config may reach
+
+// Tasks whose rates and priorities can be tuned, the order is stored in the config
+typedef enum {
+    TASK_CONFIG_OSD = 0,
+    TASK_CONFIG_TELEMETRY,
+    TASK_CONFIG_ESC_SENSOR,
+    TASK_CONFIG_BATTERY_LOAD,
+    TASK_CONFIG_COUNT
+} taskConfigIndex_e;
+
+typedef enum {
+    TASK_CONFIG_PRIORITY_DEFAULT = 0,
+    TASK_CONFIG_PRIORITY_IDLE,
+    TASK_CONFIG_PRIORITY_LOW,
+    TASK_CONFIG_PRIORITY_MEDIUM,
+    TASK_CONFIG_PRIORITY_MEDIUM_HIGH,
+    TASK_CONFIG_PRIORITY_HIGH,
+    TASK_CONFIG_PRIORITY_COUNT
+} taskConfigPriority_e;
+
+typedef struct taskConfig_s {
+    uint16_t rateHz[TASK_CONFIG_COUNT];     // 0 = the rate chosen by the firmware
+    uint8_t priority[TASK_CONFIG_COUNT];    // taskConfigPriority_e
+} taskConfig_t;
+
+PG_DECLARE(taskConfig_t, taskConfig);
+
 void tasksInit(void);
+bool tasksConfigFits(const taskConfig_t *config);
+void tasksApplyConfig(void);
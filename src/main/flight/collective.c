@@ -0,0 +1,112 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+
+#include "fc/rc_controls.h"
+
+#include "flight/failsafe.h"
+#include "flight/pid.h"
+
+#include "rx/rx.h"
+
+#include "collective.h"
+
+// HF3D:  Collective is derived once per PID cycle here. The tail precompensation, the governor
+//  feedforward and the swash mixer all read the same sample, so their timing stays coherent.
+static FAST_RAM_ZERO_INIT collective_t collective;
+static FAST_RAM_ZERO_INIT float collectivePulseFilterGain;
+static FAST_RAM_ZERO_INIT float collectiveLPF;
+static FAST_RAM_ZERO_INIT float pidFrequency;
+
+// Torque vs. absolute collective throw. Blends linear with the induced power of momentum theory,
+// which grows with thrust^1.5 and thrust roughly with blade pitch.
+#define COLLECTIVE_TORQUE_TABLE_STEPS 32
+static FAST_RAM_ZERO_INIT float collectiveTorqueTable[COLLECTIVE_TORQUE_TABLE_STEPS + 1];
+
+void collectiveInitConfig(const pidProfile_t *pidProfile)
+{
+    const float dT = pidGetDT();
+
+    pidFrequency = pidGetPidFrequency();
+
+    // Collective input impulse high-pass filter.  Setting is for cutoff frequency in Hz * 100.
+    // Calculate similar to pt1FilterGain with cutoff frequency of 0.05Hz (20s)
+    //   RC = 1 / ( 2 * M_PI_FLOAT * f_cut);  ==> RC = 3.183
+    //   k = dT / (RC + dT);                  ==>  k = 0.0000393 for 8kHz
+    collectivePulseFilterGain = dT / (dT + (1 / ( 2 * M_PIf * (float)pidProfile->collective_ff_impulse_freq / 100.0f)));
+
+    const float curve = pidProfile->yaw_collective_ff_curve / 100.0f;
+    for (int i = 0; i <= COLLECTIVE_TORQUE_TABLE_STEPS; i++) {
+        const float stick = (float)i / COLLECTIVE_TORQUE_TABLE_STEPS;
+        collectiveTorqueTable[i] = stick + curve * (stick * sqrtf(stick) - stick);
+    }
+}
+
+static float collectiveTorque(float percent)
+{
+    const float position = percent * (COLLECTIVE_TORQUE_TABLE_STEPS / 100.0f);
+    const int index = MIN((int)position, COLLECTIVE_TORQUE_TABLE_STEPS - 1);
+
+    return collectiveTorqueTable[index] + (position - index) * (collectiveTorqueTable[index + 1] - collectiveTorqueTable[index]);
+}
+
+FAST_CODE void collectiveUpdate(void)
+{
+    const float command = failsafeHeliApplyCollective(rcCommand[COLLECTIVE]);
+
+    float pitch;
+    if (command >= 0) {
+        pitch = command * 100.0f / (PWM_RANGE_MAX - rxConfig()->midrc);
+    } else {
+        pitch = command * 100.0f / (rxConfig()->midrc - PWM_RANGE_MIN);
+    }
+    pitch = constrainf(pitch, -100.0f, 100.0f);
+
+    collective.rate = (pitch - collective.pitch) * pidFrequency;
+    collective.command = command;
+    collective.pitch = pitch;
+    collective.percent = fabsf(pitch);
+
+    // Subtract the low passed throw from the throw to get the impulse.
+    // It is <60% or so of the throw and smaller the slower the stick moves.
+    collectiveLPF += collectivePulseFilterGain * (collective.percent - collectiveLPF);
+    collective.pulse = collective.percent - collectiveLPF;
+
+    collective.torque = collectiveTorque(collective.percent);
+
+    DEBUG_SET(DEBUG_COLLECTIVE, 0, lrintf(collective.pitch * 10));
+    DEBUG_SET(DEBUG_COLLECTIVE, 1, lrintf(collective.rate));
+    DEBUG_SET(DEBUG_COLLECTIVE, 2, lrintf(collective.pulse * 10));
+    DEBUG_SET(DEBUG_COLLECTIVE, 3, lrintf(collective.torque * 1000));
+}
+
+const collective_t *collectiveGet(void)
+{
+    return &collective;
+}
@@ -0,0 +1,35 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+typedef struct collective_s {
+    float command;      // rcCommand[COLLECTIVE], [-500, 500]
+    float pitch;        // signed collective stick throw in percent, [-100, 100]
+    float percent;      // absolute collective stick throw in percent, [0, 100]
+    float rate;         // change of pitch in percent per second
+    float pulse;        // high passed percent, the collective impulse
+    float torque;       // main rotor torque estimate from the throw, 0.0 - 1.0
+} collective_t;
+
+struct pidProfile_s;
+void collectiveInitConfig(const struct pidProfile_s *pidProfile);
+void collectiveUpdate(void);
+const collective_t *collectiveGet(void);
@@ -40,12 +40,16 @@
 #include "fc/runtime_config.h"
 
 #include "flight/failsafe.h"
+#include "flight/governor.h"
+#include "flight/position.h"
 
 #include "io/beeper.h"
 #include "io/motors.h"
 
 #include "rx/rx.h"
 
+#include "sensors/sensors.h"
+
 #include "flight/pid.h"
 
 /*
@@ -61,7 +65,27 @@
 
 static failsafeState_t failsafeState;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(failsafeConfig_t, failsafeConfig, PG_FAILSAFE_CONFIG, 2);
+// HF3D:  Recovery of the HELI procedure. The limits are converted once in failsafeReset(),
+//  so the action is chosen with a table lookup at PID rate instead of at the RX task's.
+static FAST_RAM_ZERO_INIT failsafeHeliAction_e failsafeHeliAction;
+static FAST_RAM_ZERO_INIT timeUs_t failsafeHeliEngagedAtUs;
+static FAST_RAM_ZERO_INIT float failsafeHeliThrottle;
+static FAST_RAM_ZERO_INIT float failsafeHeliCollective;
+static FAST_RAM_ZERO_INIT timeDelta_t failsafeHeliHoldUs;
+static FAST_RAM_ZERO_INIT uint32_t failsafeHeliDescentMs;
+static FAST_RAM_ZERO_INIT uint32_t failsafeHeliLandingShouldBeFinishedAt;
+static FAST_RAM_ZERO_INIT float failsafeHeliMinHeadspeed;
+static FAST_RAM_ZERO_INIT int32_t failsafeHeliFlareAltitudeCm;
+static FAST_RAM_ZERO_INIT float failsafeHeliAutorotationCollective;
+static FAST_RAM_ZERO_INIT float failsafeHeliFlareCollective;
+
+// Indexed by [powered][low altitude]
+static const failsafeHeliAction_e failsafeHeliPolicy[2][2] = {
+    [false] = { FAILSAFE_HELI_AUTOROTATE, FAILSAFE_HELI_FLARE },
+    [true]  = { FAILSAFE_HELI_RESCUE, FAILSAFE_HELI_RESCUE },
+};
+
+PG_REGISTER_WITH_RESET_TEMPLATE(failsafeConfig_t, failsafeConfig, PG_FAILSAFE_CONFIG, 4);
 
 PG_RESET_TEMPLATE(failsafeConfig_t, failsafeConfig,
     .failsafe_throttle = 1000,                       // default throttle off.
@@ -71,7 +95,13 @@ PG_RESET_TEMPLATE(failsafeConfig_t, failsafeConfig,
     .failsafe_switch_mode = 0,                       // default failsafe switch action is identical to rc link loss
     .failsafe_procedure = FAILSAFE_PROCEDURE_DROP_IT,// default full failsafe procedure is 0: auto-landing
     .failsafe_recovery_delay = 20,                   // 2 sec of valid rx data (plus 200ms) needed to allow recovering from failsafe procedure
-    .failsafe_stick_threshold = 30                   // 30 percent of stick deflection to exit GPS Rescue procedure
+    .failsafe_stick_threshold = 30,                  // 30 percent of stick deflection to exit GPS Rescue procedure
+    .failsafe_heli_hold_time = 10,                   // 1sec
+    .failsafe_heli_min_headspeed = 0,                // spooled up is enough for a powered rescue
+    .failsafe_heli_flare_alt = 3,                    // 3m
+    .failsafe_heli_autorotation_collective = -100,
+    .failsafe_heli_flare_collective = 300,
+    .failsafe_heli_landing_time = 30,                // 30sec
 );
 
 const char * const failsafeProcedureNames[FAILSAFE_PROCEDURE_COUNT] = {
@@ -80,6 +110,7 @@ const char * const failsafeProcedureNames[FAILSAFE_PROCEDURE_COUNT] = {
 #ifdef USE_GPS_RESCUE
     "GPS-RESCUE",
 #endif
+    "HELI",
 };
 
 /*
@@ -97,6 +128,16 @@ void failsafeReset(void)
     failsafeState.receivingRxDataPeriodPreset = 0;
     failsafeState.phase = FAILSAFE_IDLE;
     failsafeState.rxLinkState = FAILSAFE_RXLINK_DOWN;
+
+    failsafeHeliAction = FAILSAFE_HELI_NONE;
+    failsafeHeliHoldUs = failsafeConfig()->failsafe_heli_hold_time * 100000;
+    // validateAndFixConfig() keeps the hold shorter than the landing time
+    failsafeHeliDescentMs = failsafeConfig()->failsafe_heli_landing_time * MILLIS_PER_SECOND - failsafeConfig()->failsafe_heli_hold_time * MILLIS_PER_TENTH_SECOND;
+    failsafeHeliLandingShouldBeFinishedAt = 0;
+    failsafeHeliMinHeadspeed = failsafeConfig()->failsafe_heli_min_headspeed;
+    failsafeHeliFlareAltitudeCm = failsafeConfig()->failsafe_heli_flare_alt * 100;
+    failsafeHeliAutorotationCollective = failsafeConfig()->failsafe_heli_autorotation_collective;
+    failsafeHeliFlareCollective = failsafeConfig()->failsafe_heli_flare_collective;
 }
 
 void failsafeInit(void)
@@ -127,11 +168,103 @@ void failsafeStartMonitoring(void)
     failsafeState.monitoring = true;
 }
 
+// Levelling follows the recovery action in the HELI procedure, any active failsafe otherwise
+bool failsafeIsLevelling(void)
+{
+    if (failsafeState.phase == FAILSAFE_HELI) {
+        return (failsafeHeliAction >= FAILSAFE_HELI_RESCUE);
+    }
+    return failsafeState.active;
+}
+
+failsafeHeliAction_e failsafeHeliGetAction(void)
+{
+    return failsafeHeliAction;
+}
+
+FAST_CODE void failsafeHeliUpdate(timeUs_t currentTimeUs)
+{
+    if (failsafeState.phase != FAILSAFE_HELI) {
+        failsafeHeliAction = FAILSAFE_HELI_NONE;
+        return;
+    }
+
+    if (failsafeHeliAction == FAILSAFE_HELI_NONE) {
+        failsafeHeliEngagedAtUs = currentTimeUs;
+        failsafeHeliAction = FAILSAFE_HELI_HOLD;
+    }
+
+    if (failsafeHeliAction == FAILSAFE_HELI_HOLD && cmpTimeUs(currentTimeUs, failsafeHeliEngagedAtUs) < failsafeHeliHoldUs) {
+        return;
+    }
+
+    // Once the throttle is cut the rotor is not powered again until the link recovers
+    const bool powered = failsafeHeliAction < FAILSAFE_HELI_AUTOROTATE && isHeliSpooledUp() && headspeed >= failsafeHeliMinHeadspeed;
+    // A flare is not undone by a noisy altitude reading
+    const bool low = failsafeHeliAction == FAILSAFE_HELI_FLARE ||
+        (failsafeHeliFlareAltitudeCm && sensors(SENSOR_BARO) && getEstimatedAltitudeCm() <= failsafeHeliFlareAltitudeCm);
+
+    const failsafeHeliAction_e action = failsafeHeliPolicy[powered][low];
+
+    // The descent is timed from the throttle cut, a powered rescue is never disarmed on time
+    if (action >= FAILSAFE_HELI_AUTOROTATE && failsafeHeliAction < FAILSAFE_HELI_AUTOROTATE) {
+        failsafeHeliLandingShouldBeFinishedAt = currentTimeUs / 1000 + failsafeHeliDescentMs;
+    }
+
+    failsafeHeliAction = action;
+
+    // Nothing to level with, keep holding the last commands
+    if (failsafeHeliAction == FAILSAFE_HELI_RESCUE && !sensors(SENSOR_ACC)) {
+        failsafeHeliAction = FAILSAFE_HELI_HOLD;
+    }
+}
+
+FAST_CODE float failsafeHeliApplyThrottle(float throttle)
+{
+    switch (failsafeHeliAction) {
+    case FAILSAFE_HELI_NONE:
+        if (rxIsReceivingSignal()) {
+            failsafeHeliThrottle = throttle;
+        }
+        return throttle;
+    case FAILSAFE_HELI_HOLD:
+    case FAILSAFE_HELI_RESCUE:
+        return failsafeHeliThrottle;
+    default:
+        // Throttle cut, the governor goes to bailout
+        return 0.0f;
+    }
+}
+
+FAST_CODE float failsafeHeliApplyCollective(float collective)
+{
+    switch (failsafeHeliAction) {
+    case FAILSAFE_HELI_NONE:
+        if (rxIsReceivingSignal()) {
+            failsafeHeliCollective = collective;
+        }
+        return collective;
+    case FAILSAFE_HELI_HOLD:
+        return failsafeHeliCollective;
+    case FAILSAFE_HELI_RESCUE:
+        return collective;
+    case FAILSAFE_HELI_AUTOROTATE:
+        return failsafeHeliAutorotationCollective;
+    default:
+        return failsafeHeliFlareCollective;
+    }
+}
+
 static bool failsafeShouldHaveCausedLandingByNow(void)
 {
     return (millis() > failsafeState.landingShouldBeFinishedAt);
 }
 
+static bool failsafeHeliShouldHaveLandedByNow(void)
+{
+    return (failsafeHeliAction >= FAILSAFE_HELI_AUTOROTATE && millis() > failsafeHeliLandingShouldBeFinishedAt);
+}
+
 static void failsafeActivate(void)
 {
     failsafeState.active = true;
@@ -280,6 +413,11 @@ void failsafeUpdateState(void)
                             failsafeState.phase = FAILSAFE_GPS_RESCUE;
                             break;
 #endif
+                        case FAILSAFE_PROCEDURE_HELI:
+                            // Recovery is chosen by failsafeHeliUpdate()
+                            failsafeActivate();
+                            failsafeState.phase = FAILSAFE_HELI;
+                            break;
                     }
                 }
                 reprocessState = true;
@@ -318,6 +456,22 @@ void failsafeUpdateState(void)
                 }
                 break;
 #endif
+            case FAILSAFE_HELI:
+                if (receivingRxData) {
+                    failsafeState.phase = FAILSAFE_RX_LOSS_RECOVERED;
+                    reprocessState = true;
+                }
+                if (armed) {
+                    beeperMode = BEEPER_RX_LOST_LANDING;
+                }
+                // failsafe_off_delay does not apply, the rotor may still be powered or the heli still descending
+                if (failsafeHeliShouldHaveLandedByNow() || !armed) {
+                    failsafeState.receivingRxDataPeriodPreset = PERIOD_OF_30_SECONDS; // require 30 seconds of valid rxData
+                    failsafeState.phase = FAILSAFE_LANDED;
+                    reprocessState = true;
+                }
+                break;
+
             case FAILSAFE_LANDED:
                 setArmingDisabled(ARMING_DISABLED_FAILSAFE); // To prevent accidently rearming by an intermittent rx link
                 disarm();
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 #include "pg/pg.h"
 
 #define FAILSAFE_POWER_ON_DELAY_US (1000 * 1000 * 5)
@@ -41,6 +43,12 @@ typedef struct failsafeConfig_s {
     uint8_t failsafe_procedure;             // selected full failsafe procedure is 0: auto-landing, 1: Drop it
     uint16_t failsafe_recovery_delay;       // Time (in 0.1sec) of valid rx data (plus 200ms) needed to allow recovering from failsafe procedure
     uint8_t failsafe_stick_threshold;       // Stick deflection percentage to exit GPS Rescue procedure
+    uint8_t failsafe_heli_hold_time;        // Time (in 0.1sec) the HELI procedure holds the last commands before acting on the policy
+    uint16_t failsafe_heli_min_headspeed;   // Headspeed (rpm) the rotor needs for a powered rescue, 0 = spooled up is enough
+    uint8_t failsafe_heli_flare_alt;        // Altitude (m) below which an autorotation flares, 0 = never
+    int16_t failsafe_heli_autorotation_collective;  // Collective command while autorotating, -500..500
+    int16_t failsafe_heli_flare_collective; // Collective command while flaring, -500..500
+    uint8_t failsafe_heli_landing_time;     // Time (in 1sec) from failsafe activation until the HELI procedure disarms, longer than the hold time
 } failsafeConfig_t;
 
 PG_DECLARE(failsafeConfig_t, failsafeConfig);
@@ -52,7 +60,8 @@ typedef enum {
     FAILSAFE_LANDED,
     FAILSAFE_RX_LOSS_MONITORING,
     FAILSAFE_RX_LOSS_RECOVERED,
-    FAILSAFE_GPS_RESCUE
+    FAILSAFE_GPS_RESCUE,
+    FAILSAFE_HELI
 } failsafePhase_e;
 
 typedef enum {
@@ -66,6 +75,7 @@ typedef enum {
 #ifdef USE_GPS_RESCUE
     FAILSAFE_PROCEDURE_GPS_RESCUE,
 #endif
+    FAILSAFE_PROCEDURE_HELI,
     FAILSAFE_PROCEDURE_COUNT   // must be last
 } failsafeProcedure_e;
 
@@ -77,6 +87,15 @@ typedef enum {
     FAILSAFE_SWITCH_MODE_STAGE2
 } failsafeSwitchMode_e;
 
+// Recovery of the HELI procedure, chosen at PID rate
+typedef enum {
+    FAILSAFE_HELI_NONE = 0,
+    FAILSAFE_HELI_HOLD,                     // last collective and throttle, cyclic and yaw as the RX holds them
+    FAILSAFE_HELI_RESCUE,                   // rescue levels and climbs, the governor keeps the held throttle
+    FAILSAFE_HELI_AUTOROTATE,               // throttle cut to governor bailout, rescue levels, autorotation collective
+    FAILSAFE_HELI_FLARE,                    // as autorotating, with the flare collective near the ground
+} failsafeHeliAction_e;
+
 typedef struct failsafeState_s {
     int16_t events;
     bool monitoring;
@@ -108,3 +127,9 @@ void failsafeOnRxResume(void);
 
 void failsafeOnValidDataReceived(void);
 void failsafeOnValidDataFailed(void);
+
+void failsafeHeliUpdate(timeUs_t currentTimeUs);
+failsafeHeliAction_e failsafeHeliGetAction(void);
+bool failsafeIsLevelling(void);
+float failsafeHeliApplyThrottle(float throttle);
+float failsafeHeliApplyCollective(float collective);
@@ -0,0 +1,146 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/seqlock.h"
+
+#include "fc/rc.h"
+#include "fc/rc_controls.h"
+
+#include "flight/collective.h"
+#include "flight/failsafe.h"
+#include "flight/flight_state.h"
+#include "flight/governor.h"
+#include "flight/imu.h"
+#include "flight/mixer.h"
+#include "flight/pid.h"
+#include "flight/servos.h"
+
+#include "sensors/gyro.h"
+
+static seqlock_t flightStateLock[FLIGHT_STATE_TOPIC_COUNT];
+
+static flightStateGyro_t flightStateGyro;
+static flightStateAttitude_t flightStateAttitude;
+static flightStateCommand_t flightStateCommand;
+static flightStatePid_t flightStatePid;
+static flightStateOutput_t flightStateOutput;
+static flightStateHeli_t flightStateHeli;
+
+typedef struct flightStateTopic_s {
+    void *data;
+    unsigned size;
+} flightStateTopic_t;
+
+static const flightStateTopic_t flightStateTopics[FLIGHT_STATE_TOPIC_COUNT] = {
+    [FLIGHT_STATE_GYRO]     = { &flightStateGyro, sizeof(flightStateGyro) },
+    [FLIGHT_STATE_ATTITUDE] = { &flightStateAttitude, sizeof(flightStateAttitude) },
+    [FLIGHT_STATE_COMMAND]  = { &flightStateCommand, sizeof(flightStateCommand) },
+    [FLIGHT_STATE_PID]      = { &flightStatePid, sizeof(flightStatePid) },
+    [FLIGHT_STATE_OUTPUT]   = { &flightStateOutput, sizeof(flightStateOutput) },
+    [FLIGHT_STATE_HELI]     = { &flightStateHeli, sizeof(flightStateHeli) },
+};
+
+void flightStateInit(void)
+{
+    for (int topic = 0; topic < FLIGHT_STATE_TOPIC_COUNT; topic++) {
+        seqlockInit(&flightStateLock[topic]);
+    }
+}
+
+// Called by the PID loop after the mixer, the only writer of the topics
+FAST_CODE void flightStatePublish(timeUs_t currentTimeUs)
+{
+    seqlockWriteBegin(&flightStateLock[FLIGHT_STATE_GYRO]);
+    flightStateGyro.timeUs = currentTimeUs;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        flightStateGyro.gyroADCf[axis] = gyro.gyroADCf[axis];
+    }
+    seqlockWriteEnd(&flightStateLock[FLIGHT_STATE_GYRO]);
+
+    seqlockWriteBegin(&flightStateLock[FLIGHT_STATE_ATTITUDE]);
+    flightStateAttitude.timeUs = currentTimeUs;
+    flightStateAttitude.roll = attitude.values.roll;
+    flightStateAttitude.pitch = attitude.values.pitch;
+    flightStateAttitude.yaw = attitude.values.yaw;
+    seqlockWriteEnd(&flightStateLock[FLIGHT_STATE_ATTITUDE]);
+
+    seqlockWriteBegin(&flightStateLock[FLIGHT_STATE_COMMAND]);
+    flightStateCommand.timeUs = currentTimeUs;
+    for (int i = 0; i < 5; i++) {
+        flightStateCommand.rcCommand[i] = rcCommand[i];
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        flightStateCommand.setpointRate[axis] = getSetpointRate(axis);
+    }
+    flightStateCommand.collectivePitch = collectiveGet()->pitch;
+    seqlockWriteEnd(&flightStateLock[FLIGHT_STATE_COMMAND]);
+
+    seqlockWriteBegin(&flightStateLock[FLIGHT_STATE_PID]);
+    flightStatePid.timeUs = currentTimeUs;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        flightStatePid.P[axis] = pidData[axis].P;
+        flightStatePid.I[axis] = pidData[axis].I;
+        flightStatePid.D[axis] = pidData[axis].D;
+        flightStatePid.F[axis] = pidData[axis].F;
+        flightStatePid.Sum[axis] = pidData[axis].Sum;
+    }
+    seqlockWriteEnd(&flightStateLock[FLIGHT_STATE_PID]);
+
+    seqlockWriteBegin(&flightStateLock[FLIGHT_STATE_OUTPUT]);
+    flightStateOutput.timeUs = currentTimeUs;
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        flightStateOutput.motor[i] = motor[i];
+    }
+#ifdef USE_SERVOS
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        flightStateOutput.servo[i] = servo[i];
+    }
+#endif
+    seqlockWriteEnd(&flightStateLock[FLIGHT_STATE_OUTPUT]);
+
+    seqlockWriteBegin(&flightStateLock[FLIGHT_STATE_HELI]);
+    flightStateHeli.timeUs = currentTimeUs;
+    flightStateHeli.headspeed = headspeed;
+    flightStateHeli.governorOutput = governorGetOutput();
+    flightStateHeli.swashRing = servosGetSwashRingValue();
+    flightStateHeli.governorState = governorGetState();
+    flightStateHeli.failsafeAction = failsafeHeliGetAction();
+    seqlockWriteEnd(&flightStateLock[FLIGHT_STATE_HELI]);
+}
+
+// Copies the topic from one PID cycle into dst, false if it could not be read coherently
+bool flightStateRead(flightStateTopic_e topic, void *dst, unsigned size)
+{
+    if (topic >= FLIGHT_STATE_TOPIC_COUNT || size != flightStateTopics[topic].size) {
+        return false;
+    }
+    return seqlockRead(&flightStateLock[topic], dst, flightStateTopics[topic].data, size);
+}
+
+// Number of times the topic has been published
+uint32_t flightStateVersion(flightStateTopic_e topic)
+{
+    return seqlockVersion(&flightStateLock[topic]);
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Flight state published by the PID loop once per PID cycle, after the mixer. Each topic is a
+ * seqlock protected copy, so a consumer outside the PID loop gets a coherent snapshot of all the
+ * values of a topic from the same cycle, however the loop preempts it. The globals the values
+ * come from remain the hot path for the PID loop itself.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+#include "common/time.h"
+
+#include "platform.h"
+
+typedef enum {
+    FLIGHT_STATE_GYRO = 0,
+    FLIGHT_STATE_ATTITUDE,
+    FLIGHT_STATE_COMMAND,
+    FLIGHT_STATE_PID,
+    FLIGHT_STATE_OUTPUT,
+    FLIGHT_STATE_HELI,
+    FLIGHT_STATE_TOPIC_COUNT
+} flightStateTopic_e;
+
+typedef struct flightStateGyro_s {
+    timeUs_t timeUs;                    // of the PID cycle
+    float gyroADCf[XYZ_AXIS_COUNT];     // deg/s, filtered
+} flightStateGyro_t;
+
+typedef struct flightStateAttitude_s {
+    timeUs_t timeUs;
+    int16_t roll;                       // decidegrees
+    int16_t pitch;
+    int16_t yaw;                        // decidegrees, 0..3600
+} flightStateAttitude_t;
+
+typedef struct flightStateCommand_s {
+    timeUs_t timeUs;
+    float rcCommand[5];                 // roll, pitch, yaw, throttle, collective
+    float setpointRate[XYZ_AXIS_COUNT]; // deg/s
+    float collectivePitch;              // signed percent of the collective throw
+} flightStateCommand_t;
+
+typedef struct flightStatePid_s {
+    timeUs_t timeUs;
+    float P[XYZ_AXIS_COUNT];
+    float I[XYZ_AXIS_COUNT];
+    float D[XYZ_AXIS_COUNT];
+    float F[XYZ_AXIS_COUNT];
+    float Sum[XYZ_AXIS_COUNT];
+} flightStatePid_t;
+
+typedef struct flightStateOutput_s {
+    timeUs_t timeUs;
+    float motor[MAX_SUPPORTED_MOTORS];
+#ifdef USE_SERVOS
+    int16_t servo[MAX_SUPPORTED_SERVOS];
+#endif
+} flightStateOutput_t;
+
+typedef struct flightStateHeli_s {
+    timeUs_t timeUs;
+    float headspeed;                    // rpm
+    float governorOutput;               // 0..1, main motor throttle of the governor
+    float swashRing;                    // 0..1, part of the cyclic ring in use
+    uint8_t governorState;              // govState_e
+    uint8_t failsafeAction;             // failsafeHeliAction_e
+} flightStateHeli_t;
+
+void flightStateInit(void);
+void flightStatePublish(timeUs_t currentTimeUs);
+
+bool flightStateRead(flightStateTopic_e topic, void *dst, unsigned size);
+uint32_t flightStateVersion(flightStateTopic_e topic);
@@ -0,0 +1,531 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+
+#include "fc/rc_modes.h"
+#include "fc/runtime_config.h"
+
+#include "flight/collective.h"
+#include "flight/mixer.h"
+#include "flight/pid.h"
+#include "flight/servos.h"
+
+#include "sensors/battery.h"
+#include "sensors/rpm_source.h"
+
+#include "governor.h"
+
+#define GOV_ROTOR_TURNING_RPM           1000.0f     // headspeed that counts as a turning rotor
+#define GOV_ENGAGE_THROTTLE             0.50f       // stick throttle above which the headspeed is governed
+#define GOV_SPOOLUP_TOLERANCE           0.97f       // spoolup ends within 3% of the headspeed setpoint...
+#define GOV_SPOOLUP_THROTTLE_MAX        0.90f       // ...or when this much throttle didn't get there
+#define GOV_BAILOUT_HOLD_US             3000000     // bailout ends this long after the rotor was last turning, unless held by the mode
+#define GOV_SPOOLED_UP_HOLD_US          3000000     // spooled up is kept this long after the headspeed was last above GOV_ROTOR_TURNING_RPM
+#define GOV_TAILMOTOR_ASSIST_MAX        0.15f       // keep in sync with mixerGetYawPidsumAssistLimit()
+#define GOV_PASSTHROUGH_SPOOLUP_TIME    8           // seconds assumed for an external governor / ESC
+#define GOV_MODEL_TIME_CONSTANT         2.0f        // seconds, forgetting time of the throttle -> headspeed fit
+#define GOV_MODEL_MIN_THROTTLE_SPAN     0.02f       // throttle standard deviation needed for a valid fit
+#define GOV_SPOOLUP_LAG_TOLERANCE       0.10f       // hold the ramp while headspeed is this far below the model
+#define GOV_VBAT_COMP_MAX               1.33f       // same limit as the vbat PID compensation
+#define GOV_LOAD_FF_MAX                 0.25f
+
+float FAST_RAM_ZERO_INIT headspeed = 0;
+
+// Configuration, precomputed for the governor update rate
+static FAST_RAM_ZERO_INIT uint16_t govUpdateDecimation;
+static FAST_RAM_ZERO_INIT float govDT;
+static FAST_RAM_ZERO_INIT bool govPassthrough;
+static FAST_RAM_ZERO_INIT float govThrottleRampRate;        // throttle per update for spoolup_time
+static FAST_RAM_ZERO_INIT float govSetpointRampRate;        // rpm per update for spoolup_time
+static FAST_RAM_ZERO_INIT float govBailoutRampRate;         // rpm per update for gov_bailout_time
+static FAST_RAM_ZERO_INIT float govBailoutHeadspeed;        // minimum headspeed for a bailout recovery
+static FAST_RAM_ZERO_INIT uint16_t govMaxHeadspeed;
+static FAST_RAM_ZERO_INIT float govGearRatio;
+static FAST_RAM_ZERO_INIT float govKp;
+static FAST_RAM_ZERO_INIT float govKi;
+static FAST_RAM_ZERO_INIT float govCycKf;
+static FAST_RAM_ZERO_INIT float govColKf;
+static FAST_RAM_ZERO_INIT float govColPulseKf;
+static FAST_RAM_ZERO_INIT float govTailmotorAssistKf;
+static FAST_RAM_ZERO_INIT float govVbatCompGain;
+static FAST_RAM_ZERO_INIT float govCurrentKf;
+
+// State
+static FAST_RAM_ZERO_INIT govState_e govState;
+static FAST_RAM_ZERO_INIT uint16_t govUpdateCount;
+static FAST_RAM_ZERO_INIT float govOutput;
+static FAST_RAM_ZERO_INIT float govSpoolThrottle;
+static FAST_RAM_ZERO_INIT float governorSetpoint;
+static FAST_RAM_ZERO_INIT float governorSetpointLimited;
+static FAST_RAM_ZERO_INIT float govBaseThrottle;
+static FAST_RAM_ZERO_INIT float govVbatRef;                 // battery voltage when govBaseThrottle was set
+static FAST_RAM_ZERO_INIT float govI;
+static FAST_RAM_ZERO_INIT float govPidSum;
+static FAST_RAM_ZERO_INIT float govFeedForward;
+static FAST_RAM_ZERO_INIT float govTailmotorAssist;
+static FAST_RAM_ZERO_INIT bool govGoverning;
+static FAST_RAM_ZERO_INIT bool govBailout;
+static FAST_RAM_ZERO_INIT timeUs_t govRotorTurningTimeUs;
+static FAST_RAM_ZERO_INIT timeUs_t govHeadspeedSeenTimeUs;     // last time the headspeed was above GOV_ROTOR_TURNING_RPM
+static FAST_RAM_ZERO_INIT bool govHeadspeedSeen;
+
+// Since governorResetFlight(), for the persistent stats
+static FAST_RAM_ZERO_INIT float govFlightMaxDroop;
+static FAST_RAM_ZERO_INIT uint32_t govFlightSaturatedUpdates;
+
+// Online fit of headspeed = slope * throttle + offset during spoolup, exponentially weighted
+typedef struct govModel_s {
+    float decay;
+    float weight;
+    float sumX;
+    float sumY;
+    float sumXX;
+    float sumXY;
+    float slope;
+    float offset;
+    bool valid;
+} govModel_t;
+
+static FAST_RAM_ZERO_INIT govModel_t govModel;
+
+// The speed loop gains alone, they can be adjusted in flight
+void governorInitGains(void)
+{
+    govKp = (float)mixerConfig()->gov_p_gain / 10.0f;
+    govKi = (float)mixerConfig()->gov_i_gain / 10.0f;
+}
+
+// Called when the PID loop rate is set. Only configuration is recomputed, the state is kept.
+void governorInit(void)
+{
+    const uint16_t updateHz = constrain(mixerConfig()->gov_update_hz, GOV_UPDATE_HZ_MIN, GOV_UPDATE_HZ_MAX);
+    govUpdateDecimation = MAX(lrintf(pidGetPidFrequency() / updateHz), 1);
+    govDT = pidGetDT() * govUpdateDecimation;
+
+    // spoolup_time is how many seconds to go from 0% to 100% throttle.
+    // With spoolup_time = 0 the throttle is passed through, but spooled up is still tracked on headspeed.
+    govPassthrough = (mixerConfig()->spoolup_time == 0);
+    govThrottleRampRate = govDT / (govPassthrough ? GOV_PASSTHROUGH_SPOOLUP_TIME : mixerConfig()->spoolup_time);
+
+    // If ramp is set to 5s then this will allow 20% change in 1 second, or 10% headspeed in 0.5 seconds.
+    govMaxHeadspeed = mixerConfig()->gov_max_headspeed;
+    govSetpointRampRate = govThrottleRampRate * govMaxHeadspeed;
+
+    // Bailout ramps the full headspeed range in gov_bailout_time (1/10 s)
+    govBailoutRampRate = mixerConfig()->gov_bailout_time ? govMaxHeadspeed * govDT * 10.0f / mixerConfig()->gov_bailout_time : govSetpointRampRate;
+    govBailoutHeadspeed = MAX(govMaxHeadspeed * mixerConfig()->gov_bailout_percent / 100.0f, GOV_ROTOR_TURNING_RPM);
+
+    govGearRatio = (float)mixerConfig()->gov_gear_ratio / 1000.0f;
+    governorInitGains();
+    govCycKf = (float)mixerConfig()->gov_cyclic_ff_gain / 100.0f;
+    govColKf = (float)mixerConfig()->gov_collective_ff_gain / 10000.0f;
+    govColPulseKf = (float)mixerConfig()->gov_collective_ff_impulse_gain / 10000.0f;
+    govTailmotorAssistKf = (float)mixerConfig()->gov_tailmotor_assist_gain / 100.0f;
+
+    // Sag compensation needs a voltage meter, the load feedforward a measured current (not the throttle based virtual meter)
+    govVbatCompGain = isBatteryVoltageConfigured() ? (float)mixerConfig()->gov_vbat_comp / 100.0f : 0.0f;
+    const bool currentMeasured = (batteryConfig()->currentMeterSource == CURRENT_METER_ADC || batteryConfig()->currentMeterSource == CURRENT_METER_ESC);
+    govCurrentKf = (currentMeasured && isBatteryVoltageConfigured()) ? (float)mixerConfig()->gov_current_ff_gain / 1000.0f : 0.0f;
+
+    govModel.decay = 1.0f - govDT / GOV_MODEL_TIME_CONSTANT;
+    govUpdateCount = 0;
+}
+
+static void governorModelReset(void)
+{
+    const float decay = govModel.decay;
+    memset(&govModel, 0, sizeof(govModel));
+    govModel.decay = decay;
+}
+
+static void governorModelUpdate(float throttle)
+{
+    govModel.weight = govModel.weight * govModel.decay + 1.0f;
+    govModel.sumX = govModel.sumX * govModel.decay + throttle;
+    govModel.sumY = govModel.sumY * govModel.decay + headspeed;
+    govModel.sumXX = govModel.sumXX * govModel.decay + throttle * throttle;
+    govModel.sumXY = govModel.sumXY * govModel.decay + throttle * headspeed;
+
+    const float meanX = govModel.sumX / govModel.weight;
+    const float meanY = govModel.sumY / govModel.weight;
+    const float varX = govModel.sumXX / govModel.weight - meanX * meanX;
+
+    govModel.valid = false;
+    if (varX > GOV_MODEL_MIN_THROTTLE_SPAN * GOV_MODEL_MIN_THROTTLE_SPAN) {
+        const float slope = (govModel.sumXY / govModel.weight - meanX * meanY) / varX;
+        if (slope > 0.0f) {
+            govModel.slope = slope;
+            govModel.offset = meanY - slope * meanX;
+            govModel.valid = true;
+        }
+    }
+}
+
+// Throttle the model needs for a headspeed, or the fallback without a valid fit
+static float governorModelThrottle(float rpm, float fallback)
+{
+    if (govModel.valid) {
+        return constrainf((rpm - govModel.offset) / govModel.slope, 0.0f, 1.0f);
+    }
+
+    return fallback;
+}
+
+// Steady state throttle the governor works around, at the present battery voltage
+static void governorSetBaseThrottle(float throttle)
+{
+    govBaseThrottle = throttle;
+    govVbatRef = getBatteryVoltageOpenCircuit();
+    govI = 0.0f;
+}
+
+// Headspeed setpoint from the stick, and its rate limited version the governor follows
+static void governorUpdateSetpoint(float throttle)
+{
+    if (throttle > GOV_ENGAGE_THROTTLE && govMaxHeadspeed > 0 && headspeed > 0) {
+        governorSetpoint = throttle * govMaxHeadspeed;
+
+        // If we don't have a non-zero rate limited setpoint yet, start from the headspeed
+        if (governorSetpointLimited <= 0) {
+            governorSetpointLimited = headspeed;
+        }
+
+        const float rampRate = govBailout ? govBailoutRampRate : govSetpointRampRate;
+        governorSetpointLimited += constrainf(governorSetpoint - governorSetpointLimited, -rampRate, rampRate);
+        if (governorSetpointLimited == governorSetpoint) {
+            govBailout = false;
+        }
+    } else {
+        governorSetpoint = 0;
+        governorSetpointLimited = 0;
+    }
+}
+
+static float governorApplyPid(float tailAssistDemand)
+{
+    // If using a motor-driven tail, allow the governor to help the tail motor to yaw in the main motor torque direction
+    //   It's more important that we maintain tail authority than it is to prevent overspeeds.
+    float tailmotorAssist = 0.0f;
+    if (tailAssistDemand > 0.0f) {
+        tailmotorAssist = constrainf(govTailmotorAssistKf * tailAssistDemand, 0.0f, GOV_TAILMOTOR_ASSIST_MAX);
+        // Don't allow the governor to regulate down while we're assisting the tail motor unless we're more than 15% over our governor's headspeed setpoint
+        if ((headspeed > governorSetpointLimited) && (headspeed < governorSetpoint * 1.15f)) {
+            // Track the headspeed up so the P-term doesn't cancel the assist. 6x because the setpoint ramp takes 1x back next update.
+            governorSetpointLimited = constrainf(governorSetpointLimited + 6.0f * govSetpointRampRate, governorSetpointLimited, headspeed);
+        }
+    }
+
+    // Collective and cyclic pitch feedforward for the main motor (always positive adders)
+    //   Reasonable value would be 0.15 throttle addition for 12-degree collective throw..
+    //   So gains in the 0.0015 - 0.0032 range depending on where max collective pitch is on the heli
+    const collective_t *collective = collectiveGet();
+    const float feedForward = govColKf * collective->percent + govColPulseKf * collective->pulse + govCycKf * servosGetSwashRingValue();
+
+    // Battery sag and load feedforward from the fast battery filters, so the I-term doesn't have to catch up on a punch-out
+    //   The base throttle is scaled by the open circuit voltage drop since it was set, the load adds the I*R drop of
+    //   the motor and ESC, and of the pack once its resistance is known. Until then the open circuit voltage is the
+    //   load voltage and the pack sag is in the scaling.
+    const float vbat = getBatteryVoltageOpenCircuit();
+    float vbatComp = 1.0f;
+    float loadFeedForward = 0.0f;
+    if (vbat > 0.0f) {
+        if (govVbatRef > 0.0f) {
+            vbatComp = constrainf(1.0f + govVbatCompGain * (govVbatRef / vbat - 1.0f), 1.0f / GOV_VBAT_COMP_MAX, GOV_VBAT_COMP_MAX);
+        }
+        // gov_current_ff_gain = 20 (20 mOhm) at 100A and 50V adds 4% throttle
+        const float resistance = govCurrentKf + govVbatCompGain * getBatteryResistance();
+        loadFeedForward = constrainf(resistance * getAmperageLoad() / vbat, 0.0f, GOV_LOAD_FF_MAX);
+    }
+
+    // Error as a fraction of the max headspeed, since 100% throttle should be close to max headspeed
+    const float govError = (governorSetpointLimited - headspeed) / (float)govMaxHeadspeed;
+
+    // gov_p_gain = 10 (govKp = 1) gives 1% change in throttle for 1% error in headspeed
+    const float govP = govKp * govError;
+    // gov_i_gain = 10 (govKi = 1) gives 1% change in throttle for 1% error in headspeed after 1 second
+    const float govIChange = govKi * govError * govDT;
+    govI = constrainf(govI + govIChange, -50.0f, 50.0f);
+    govPidSum = govP + govI;
+    govFeedForward = feedForward;
+    govTailmotorAssist = tailmotorAssist;
+
+    float throttle = (govBaseThrottle + feedForward) * vbatComp + loadFeedForward + govPidSum + tailmotorAssist;
+
+    // Remove the last I-term addition if it was winding up into the limit
+    if (throttle > 1.0f) {
+        if (govError > 0.0f) {
+            govI -= govIChange;
+        }
+        throttle = 1.0f;
+        govFlightSaturatedUpdates++;
+    } else if (throttle < 0.0f) {
+        if (govError < 0.0f) {
+            govI -= govIChange;
+        }
+        throttle = 0.0f;
+    }
+
+    DEBUG_SET(DEBUG_SMARTAUDIO, 2, govPidSum * 1000.0f);             // Max pidsum will be around 1, so increase by 1000x
+
+    return throttle;
+}
+
+// Recover from a throttle cut with the rotor still turning: jump to the throttle the model predicts
+// for the setpoint and ramp the setpoint from the current headspeed at the bailout rate.
+static void governorStartBailout(void)
+{
+    if (governorSetpoint) {
+        if (govModel.valid) {
+            governorSetBaseThrottle(governorModelThrottle(governorSetpoint, govBaseThrottle));
+        }
+        govGoverning = true;
+        govBailout = true;
+    }
+    govState = GOV_STATE_ACTIVE;
+}
+
+static void governorStateUpdate(timeUs_t currentTimeUs, float throttle, float tailAssistDemand)
+{
+    const bool throttleCut = (throttle == 0.0f) || !ARMING_FLAG(ARMED);
+    const bool bailoutMode = RC_MODE_FLAG(RC_MODE_FLAG_GOVBAILOUT);
+
+    if (headspeed >= GOV_ROTOR_TURNING_RPM) {
+        govRotorTurningTimeUs = currentTimeUs;
+        govHeadspeedSeenTimeUs = currentTimeUs;
+        govHeadspeedSeen = true;
+    } else if (govHeadspeedSeen && cmpTimeUs(currentTimeUs, govHeadspeedSeenTimeUs) > GOV_SPOOLED_UP_HOLD_US) {
+        govHeadspeedSeen = false;
+    }
+
+    governorUpdateSetpoint(throttle);
+
+    switch (govState) {
+    case GOV_STATE_IDLE:
+        govSpoolThrottle = 0.0f;
+        govOutput = 0.0f;
+        if (!throttleCut) {
+            if (bailoutMode && headspeed >= govBailoutHeadspeed) {
+                governorStartBailout();
+            } else {
+                governorModelReset();
+                govState = GOV_STATE_SPOOLUP;
+            }
+        }
+        break;
+
+    case GOV_STATE_SPOOLUP:
+        if (throttleCut) {
+            // Require re-spooling to start from zero
+            govState = GOV_STATE_IDLE;
+            govSpoolThrottle = 0.0f;
+        } else if (governorSetpoint) {
+            // Governor is enabled, spool on headspeed
+            if (headspeed >= GOV_ROTOR_TURNING_RPM) {
+                governorModelUpdate(govSpoolThrottle);
+            }
+            if (headspeed > governorSetpoint * GOV_SPOOLUP_TOLERANCE || govSpoolThrottle > GOV_SPOOLUP_THROTTLE_MAX) {
+                // HF3D TODO:  Flag and alert user after flight if 90% throttle didn't reach the setpoint (gov_max_headspeed too high).
+                governorSetpointLimited = MIN(headspeed, governorSetpoint * GOV_SPOOLUP_TOLERANCE);
+                // Seed the governor with the steady state throttle for the setpoint, the I-term starts clean
+                governorSetBaseThrottle(governorModelThrottle(governorSetpointLimited, govSpoolThrottle));
+                govGoverning = true;
+                govState = GOV_STATE_ACTIVE;
+            } else if (!govModel.valid || headspeed >= (govModel.slope * govSpoolThrottle + govModel.offset) * (1.0f - GOV_SPOOLUP_LAG_TOLERANCE)) {
+                // Hold the ramp while the rotor lags the fit, so the throttle doesn't run away from a slow ESC
+                govSpoolThrottle += govThrottleRampRate;
+            }
+        } else {
+            // Governor is disabled, spool on throttle % only
+            if (govSpoolThrottle >= throttle) {
+                govSpoolThrottle = throttle;
+                govGoverning = false;
+                govState = GOV_STATE_ACTIVE;
+            } else {
+                govSpoolThrottle = MIN(govSpoolThrottle + govThrottleRampRate, throttle);
+            }
+        }
+        govOutput = govSpoolThrottle;
+        break;
+
+    case GOV_STATE_ACTIVE:
+        if (throttleCut) {
+            govState = GOV_STATE_BAILOUT;
+            govRotorTurningTimeUs = currentTimeUs;
+            govOutput = 0.0f;
+        } else if (govGoverning && throttle > GOV_ENGAGE_THROTTLE && headspeed == 0) {
+            // Fall back to the commanded throttle until the headspeed signal returns
+            govState = GOV_STATE_LOST_SIGNAL;
+            govOutput = throttle;
+        } else if (governorSetpoint) {
+            if (!govGoverning) {
+                // Stick moved into the governed range, start from the current throttle
+                governorSetBaseThrottle(govOutput);
+            }
+            govGoverning = true;
+            govOutput = governorApplyPid(tailAssistDemand);
+            // Droop under load, not while the setpoint is still ramping up to the target
+            if (governorSetpointLimited >= governorSetpoint) {
+                govFlightMaxDroop = MAX(govFlightMaxDroop, governorSetpoint - headspeed);
+            }
+        } else {
+            govGoverning = false;
+            govBailout = false;
+            govOutput = throttle;
+        }
+        govSpoolThrottle = govOutput;
+        break;
+
+    case GOV_STATE_BAILOUT:
+        if (!throttleCut) {
+            if (headspeed >= govBailoutHeadspeed) {
+                governorStartBailout();
+            } else {
+                // Rotor has slowed down too much, spool up again from the throttle it still needs
+                govSpoolThrottle = governorModelThrottle(headspeed, 0.0f);
+                govState = GOV_STATE_SPOOLUP;
+            }
+            break;
+        } else if (!bailoutMode && cmpTimeUs(currentTimeUs, govRotorTurningTimeUs) > GOV_BAILOUT_HOLD_US) {
+            govBailout = false;
+            govState = GOV_STATE_IDLE;
+        }
+        govSpoolThrottle = 0.0f;
+        govOutput = 0.0f;
+        break;
+
+    case GOV_STATE_LOST_SIGNAL:
+        if (throttleCut) {
+            govState = GOV_STATE_BAILOUT;
+            govRotorTurningTimeUs = currentTimeUs;
+            govOutput = 0.0f;
+        } else if (headspeed > 0) {
+            govState = GOV_STATE_ACTIVE;
+            govOutput = throttle;
+        } else {
+            govOutput = throttle;
+        }
+        govSpoolThrottle = govOutput;
+        break;
+    }
+
+    DEBUG_SET(DEBUG_GOVERNOR, 0, govState);
+    DEBUG_SET(DEBUG_GOVERNOR, 1, lrintf(govSpoolThrottle * 1000));
+    DEBUG_SET(DEBUG_GOVERNOR, 2, govModel.valid ? lrintf(govModel.slope / 10) : 0);
+    DEBUG_SET(DEBUG_GOVERNOR, 3, govModel.valid ? lrintf(govModel.offset) : 0);
+
+    // HF3D TODO:  Rename debug_smartaudio entry eventually
+    DEBUG_SET(DEBUG_SMARTAUDIO, 0, governorSetpointLimited);
+    DEBUG_SET(DEBUG_SMARTAUDIO, 1, headspeed);
+    DEBUG_SET(DEBUG_SMARTAUDIO, 3, getFilteredMotorRPM(1));  // Tail motor RPM
+}
+
+// Called every PID cycle from the mixer. Headspeed follows the RPM filter every cycle,
+// the state machine and governor loop run at gov_update_hz.
+float governorUpdate(timeUs_t currentTimeUs, float throttle, float tailAssistDemand)
+{
+    headspeed = getHeadspeedRPM();
+
+    if (++govUpdateCount >= govUpdateDecimation) {
+        govUpdateCount = 0;
+        governorStateUpdate(currentTimeUs, throttle, tailAssistDemand);
+    }
+
+    // Pass-through of the throttle signal if spoolup_time setting = 0 and we are armed.
+    //   Must be used in conjunction with setting gov_max_headspeed = 0 to have the spooled up state follow an RPM sensor/telemetry.
+    if (govPassthrough && ARMING_FLAG(ARMED)) {
+        return throttle;
+    }
+
+    return govOutput;
+}
+
+govState_e governorGetState(void)
+{
+    return govState;
+}
+
+// Main motor throttle commanded by the governor, 0..1
+float governorGetOutput(void)
+{
+    return govOutput;
+}
+
+// Very critical that this status is correct, because core.c checks it to force
+//     the pid controller to reset it's I term on each pass if this is not set.
+// Spooled up also needs a headspeed above 1000rpm, held for a few seconds so a throttle cut
+//     or a short headspeed signal loss keeps the I term. Without an RPM source the heli never spools up.
+uint8_t isHeliSpooledUp(void)
+{
+    return govHeadspeedSeen && (govState == GOV_STATE_ACTIVE || govState == GOV_STATE_BAILOUT || govState == GOV_STATE_LOST_SIGNAL);
+}
+
+float governorGetGearRatio(void)
+{
+    return govGearRatio;
+}
+
+// Governor loop terms for the blackbox, the throttle terms are fractions of full throttle
+
+float governorGetSetpoint(void)
+{
+    return governorSetpointLimited;
+}
+
+float governorGetPidSum(void)
+{
+    return govPidSum;
+}
+
+float governorGetI(void)
+{
+    return govI;
+}
+
+float governorGetFeedForward(void)
+{
+    return govFeedForward;
+}
+
+float governorGetTailmotorAssist(void)
+{
+    return govTailmotorAssist;
+}
+
+void governorResetFlight(void)
+{
+    govFlightMaxDroop = 0;
+    govFlightSaturatedUpdates = 0;
+}
+
+void governorGetFlight(governorFlight_t *flight)
+{
+    flight->maxDroopRpm = lrintf(constrainf(govFlightMaxDroop, 0, UINT16_MAX));
+    flight->saturatedMs = lrintf(govFlightSaturatedUpdates * govDT * 1000.0f);
+}
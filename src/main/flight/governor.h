@@ -0,0 +1,56 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/time.h"
+
+#define GOV_UPDATE_HZ_MIN 50
+#define GOV_UPDATE_HZ_MAX 8000
+
+typedef enum {
+    GOV_STATE_IDLE = 0,         // disarmed or throttle cut, rotor stopped
+    GOV_STATE_SPOOLUP,          // ramping the throttle up to the stick or to the headspeed setpoint
+    GOV_STATE_ACTIVE,           // spooled up, following the stick or governing the headspeed
+    GOV_STATE_BAILOUT,          // throttle cut while spooled up, fast recovery while the rotor turns
+    GOV_STATE_LOST_SIGNAL,      // governing without a headspeed reading, following the stick
+} govState_e;
+
+typedef struct governorFlight_s {
+    uint16_t maxDroopRpm;       // worst headspeed below the setpoint while governing
+    uint32_t saturatedMs;       // time the governor wanted more than full throttle
+} governorFlight_t;
+
+extern float headspeed;
+
+void governorInit(void);
+void governorInitGains(void);
+float governorUpdate(timeUs_t currentTimeUs, float throttle, float tailAssistDemand);
+govState_e governorGetState(void);
+float governorGetOutput(void);
+uint8_t isHeliSpooledUp(void);
+float governorGetGearRatio(void);
+float governorGetSetpoint(void);
+float governorGetPidSum(void);
+float governorGetI(void);
+float governorGetFeedForward(void);
+float governorGetTailmotorAssist(void);
+void governorResetFlight(void);
+void governorGetFlight(governorFlight_t *flight);
@@ -128,6 +128,15 @@ typedef struct {
     float Kd;
 } throttle_s;
 
+// Return leg and descent, planned once at activation and tracked against the distance to home
+typedef struct {
+    int32_t cruiseAltitudeCm;
+    uint16_t descentDistanceM;
+    float descentSlope;         // cm of altitude per m of distance on the descent line
+    float descentOffsetCm;
+    float slowdownScale;        // groundspeed per m of distance inside the slowdown distance
+} rescuePlan_s;
+
 #define GPS_RESCUE_MAX_YAW_RATE         180 // deg/sec max yaw rate
 #define GPS_RESCUE_RATE_SCALE_DEGREES    45 // Scale the commanded yaw rate when the error is less then this angle
 #define GPS_RESCUE_SLOWDOWN_DISTANCE_M  200 // distance from home to start decreasing speed
@@ -139,6 +148,7 @@ typedef struct {
 #define GPS_RESCUE_SLOWDOWN_ALT         500 // the altitude after which the quad begins to slow down the descend velocity
 #define GPS_RESCUE_MINIMUM_ZVELOCITY     50 // minimum speed for final landing phase
 #define GPS_RESCUE_ALMOST_LANDING_ALT   100 // altitude after which the quad increases ground detection sensitivity
+#define GPS_RESCUE_MIN_LIFT_COS_TILT   0.5f // no collective beyond 60 degrees of tilt, the level controller brings the rotor upright first
 
 #define GPS_RESCUE_THROTTLE_P_SCALE 0.0003125f // pid scaler for P term
 #define GPS_RESCUE_THROTTLE_I_SCALE 0.1f       // pid scaler for I term
@@ -150,7 +160,7 @@ typedef struct {
 #define GPS_RESCUE_USE_MAG              false
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gpsRescueConfig_t, gpsRescueConfig, PG_GPS_RESCUE, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(gpsRescueConfig_t, gpsRescueConfig, PG_GPS_RESCUE, 2);
 
 PG_RESET_TEMPLATE(gpsRescueConfig_t, gpsRescueConfig,
     .angle = 32,
@@ -177,21 +187,24 @@ PG_RESET_TEMPLATE(gpsRescueConfig_t, gpsRescueConfig,
     .altitudeMode = MAX_ALT,
     .ascendRate = 500,
     .descendRate = 150,
+    .collectiveMin = -100,
+    .collectiveMax = 400,
+    .collectiveHover = 150,
 );
 
 static uint16_t rescueThrottle;
+static float    rescueCollective;
 static float    rescueYaw;
 
 int32_t       gpsRescueAngle[ANGLE_INDEX_COUNT] = { 0, 0 };
-uint16_t      hoverThrottle = 0;
-float         averageThrottle = 0.0;
-float         altitudeError = 0.0;
-uint32_t      throttleSamples = 0;
+float         hoverCollective = 0.0;
+uint32_t      collectiveSamples = 0;
 bool          magForceDisable = false;
 
 static bool newGPSData = false;
 
 rescueState_s rescueState;
+rescuePlan_s rescuePlan;
 altitudeMode_e altitudeMode;
 throttle_s throttle;
 
@@ -237,25 +250,24 @@ static void idleTasks()
     // Store the max distance to home during normal flight so we know if a flyaway is happening
     rescueState.sensor.maxDistanceToHomeM = MAX(rescueState.sensor.distanceToHomeM, rescueState.sensor.maxDistanceToHomeM);
 
+    // The rotor throttle (or governor setpoint) is held at its last value during the rescue,
+    // altitude is flown on collective
     rescueThrottle = rcCommand[THROTTLE];
 
-    //to do: have a default value for hoverThrottle
-
     // FIXME: GPS Rescue throttle handling should take into account min_check as the
     // active throttle is from min_check through PWM_RANGE_MAX. Currently adjusting for this
     // in gpsRescueGetThrottle() but it would be better handled here.
 
     const float ct = getCosTiltAngle();
-    if (ct > 0.5 && ct < 0.96 && throttleSamples < 1E6 && rescueThrottle > 1070) { //5 to 45 degrees tilt
+    if (ct > 0.5 && ct < 0.96 && collectiveSamples < 1E6 && rescueThrottle >= gpsRescueConfig()->throttleMin) { //5 to 45 degrees tilt, rotor running
         //TO DO: only sample when acceleration is low
-        uint16_t adjustedThrottle = 1000 + (rescueThrottle - PWM_RANGE_MIN) * ct;
-        if (throttleSamples == 0) {
-            averageThrottle = adjustedThrottle;
+        const float adjustedCollective = rcCommand[COLLECTIVE] * ct;
+        if (collectiveSamples == 0) {
+            hoverCollective = adjustedCollective;
         } else {
-            averageThrottle += (adjustedThrottle - averageThrottle) / (throttleSamples + 1);
+            hoverCollective += (adjustedCollective - hoverCollective) / (collectiveSamples + 1);
         }
-        hoverThrottle = lrintf(averageThrottle);
-        throttleSamples++;
+        collectiveSamples++;
     }
 }
 
@@ -288,7 +300,7 @@ static void rescueAttainPosition()
     static int previousZVelocityError = 0;
     static float zVelocityIntegral = 0;
     static float scalingRate = 0;
-    static int16_t altitudeAdjustment = 0;
+    static float altitudeAdjustment = 0;
 
     if (rescueState.phase == RESCUE_INITIALIZE) {
         // Initialize internal variables each time GPS Rescue is started
@@ -324,7 +336,8 @@ static void rescueAttainPosition()
 
     gpsRescueAngle[AI_PITCH] = constrain(gpsRescueAngle[AI_PITCH] + MIN(angleAdjustment, 80), rescueState.intent.minAngleDeg * 100, rescueState.intent.maxAngleDeg * 100);
 
-    const float ct = cos(DECIDEGREES_TO_RADIANS(gpsRescueAngle[AI_PITCH] / 10));
+    // Lift compensation from the tilt the IMU already tracks, rather than the cosine of the commanded pitch
+    const float ct = getCosTiltAngle();
 
     /**
         Altitude controller
@@ -362,13 +375,23 @@ static void rescueAttainPosition()
     const int zVelocityDerivative = zVelocityError - previousZVelocityError;
     previousZVelocityError = zVelocityError;
 
-    const int16_t hoverAdjustment = (hoverThrottle - 1000) / ct;
-    altitudeAdjustment = constrain(altitudeAdjustment + (throttle.Kp * zVelocityError + throttle.Ki * zVelocityIntegral + throttle.Kd * zVelocityDerivative),
-                                    gpsRescueConfig()->throttleMin - 1000 - hoverAdjustment, gpsRescueConfig()->throttleMax - 1000 - hoverAdjustment);
+    const float collectiveMin = gpsRescueConfig()->collectiveMin;
+    const float collectiveMax = gpsRescueConfig()->collectiveMax;
+
+    if (ct < GPS_RESCUE_MIN_LIFT_COS_TILT) {
+        // Upside down or too far over for lift, hold the collective flat until the rotor is brought level
+        altitudeAdjustment = 0;
+        zVelocityIntegral = 0;
+        rescueCollective = 0;
+    } else {
+        const float hoverAdjustment = hoverCollective / ct;
+        altitudeAdjustment = constrainf(altitudeAdjustment + (throttle.Kp * zVelocityError + throttle.Ki * zVelocityIntegral + throttle.Kd * zVelocityDerivative),
+                                        collectiveMin - hoverAdjustment, collectiveMax - hoverAdjustment);
 
-    rescueThrottle = constrain(1000 + altitudeAdjustment + hoverAdjustment, gpsRescueConfig()->throttleMin, gpsRescueConfig()->throttleMax);
+        rescueCollective = constrainf(altitudeAdjustment + hoverAdjustment, collectiveMin, collectiveMax);
+    }
 
-    DEBUG_SET(DEBUG_RTH, 0, rescueThrottle);
+    DEBUG_SET(DEBUG_RTH, 0, lrintf(rescueCollective));
     DEBUG_SET(DEBUG_RTH, 1, gpsRescueAngle[AI_PITCH]);
     DEBUG_SET(DEBUG_RTH, 2, altitudeAdjustment);
 
@@ -465,27 +488,18 @@ static void sensorUpdate()
     rescueState.sensor.currentAltitudeCm = getEstimatedAltitudeCm();
     rescueState.sensor.healthy = gpsIsHealthy();
 
-    // Calculate altitude velocity
-    static uint32_t previousTimeUs;
-    static int32_t previousAltitudeCm;
-
-    const uint32_t currentTimeUs = micros();
-    const float dTime = currentTimeUs - previousTimeUs;
-
-    if (newGPSData) { // Calculate velocity at lowest common denominator
+    if (newGPSData) {
         rescueState.sensor.distanceToHomeM = GPS_distanceToHome;
         rescueState.sensor.directionToHome = GPS_directionToHome;
         rescueState.sensor.numSat = gpsSol.numSat;
         rescueState.sensor.groundSpeed = gpsSol.groundSpeed;
 
-        rescueState.sensor.zVelocity = (rescueState.sensor.currentAltitudeCm - previousAltitudeCm) * 1000000.0f / dTime;
+        // Climb rate from the acceleration fused altitude estimate
+        rescueState.sensor.zVelocity = getEstimatedClimbRateCms();
         rescueState.sensor.zVelocityAvg = 0.8f * rescueState.sensor.zVelocityAvg + rescueState.sensor.zVelocity * 0.2f;
 
         rescueState.sensor.accMagnitude = (float) sqrtf(sq(acc.accADC[Z]) + sq(acc.accADC[X]) + sq(acc.accADC[Y])) * acc.dev.acc_1G_rec;
         rescueState.sensor.accMagnitudeAvg = (rescueState.sensor.accMagnitudeAvg * 0.8f) + (rescueState.sensor.accMagnitude * 0.2f);
-
-        previousAltitudeCm = rescueState.sensor.currentAltitudeCm;
-        previousTimeUs = currentTimeUs;
     }
 }
 
@@ -542,11 +556,7 @@ static bool checkGPSRescueIsAvailable(void)
 */
 void updateGPSRescueState(void)
 {
-    static uint16_t newDescentDistanceM;
-    static float_t lineSlope;
-    static float_t lineOffsetM;
     static int32_t newSpeed;
-    static int32_t newAltitude;
     float magnitudeTrigger;
 
     if (!FLIGHT_MODE(GPS_RESCUE_MODE)) {
@@ -568,8 +578,12 @@ void updateGPSRescueState(void)
         idleTasks();
         break;
     case RESCUE_INITIALIZE:
-        if (hoverThrottle == 0) { //no actual throttle data yet, let's use the default.
-            hoverThrottle = gpsRescueConfig()->throttleHover;
+        if (collectiveSamples == 0) { //no actual collective data yet, let's use the default.
+            hoverCollective = gpsRescueConfig()->collectiveHover;
+        }
+
+        if (rescueThrottle < gpsRescueConfig()->throttleMin) { //rotor throttle lost with the link, fall back to the configured one
+            rescueThrottle = gpsRescueConfig()->throttleHover;
         }
 
         throttle.Kp = gpsRescueConfig()->throttleP * GPS_RESCUE_THROTTLE_P_SCALE;
@@ -597,26 +611,27 @@ void updateGPSRescueState(void)
         newSpeed = gpsRescueConfig()->rescueGroundspeed;
         //set new descent distance if actual distance to home is lower 
         if (rescueState.sensor.distanceToHomeM < gpsRescueConfig()->descentDistanceM) {
-            newDescentDistanceM = MAX(rescueState.sensor.distanceToHomeM - 5, GPS_RESCUE_MIN_DESCENT_DIST_M);
+            rescuePlan.descentDistanceM = MAX(rescueState.sensor.distanceToHomeM - 5, GPS_RESCUE_MIN_DESCENT_DIST_M);
         } else {
-            newDescentDistanceM = gpsRescueConfig()->descentDistanceM;
+            rescuePlan.descentDistanceM = gpsRescueConfig()->descentDistanceM;
         }
         
         switch (altitudeMode) {
             case MAX_ALT:
-                newAltitude = MAX(gpsRescueConfig()->initialAltitudeM * 100, rescueState.sensor.maxAltitudeCm + 1500);
+                rescuePlan.cruiseAltitudeCm = MAX(gpsRescueConfig()->initialAltitudeM * 100, rescueState.sensor.maxAltitudeCm + 1500);
                 break;
             case FIXED_ALT:
-                newAltitude = gpsRescueConfig()->initialAltitudeM * 100;
+                rescuePlan.cruiseAltitudeCm = gpsRescueConfig()->initialAltitudeM * 100;
                 break;
             case CURRENT_ALT:
-                newAltitude = rescueState.sensor.currentAltitudeCm;
+                rescuePlan.cruiseAltitudeCm = rescueState.sensor.currentAltitudeCm;
                 break;
         }
 
         //Calculate angular coefficient and offset for equation of line from 2 points needed for RESCUE_LANDING_APPROACH
-        lineSlope = ((float)gpsRescueConfig()->initialAltitudeM - gpsRescueConfig()->targetLandingAltitudeM) / (newDescentDistanceM - gpsRescueConfig()->targetLandingDistanceM);
-        lineOffsetM = gpsRescueConfig()->initialAltitudeM - lineSlope * newDescentDistanceM;
+        rescuePlan.descentSlope = ((float)gpsRescueConfig()->initialAltitudeM - gpsRescueConfig()->targetLandingAltitudeM) * 100 / (rescuePlan.descentDistanceM - gpsRescueConfig()->targetLandingDistanceM);
+        rescuePlan.descentOffsetCm = gpsRescueConfig()->initialAltitudeM * 100 - rescuePlan.descentSlope * rescuePlan.descentDistanceM;
+        rescuePlan.slowdownScale = (float)gpsRescueConfig()->rescueGroundspeed / GPS_RESCUE_SLOWDOWN_DISTANCE_M;
 
         rescueState.phase = RESCUE_ATTAIN_ALT;
         FALLTHROUGH;
@@ -627,20 +642,20 @@ void updateGPSRescueState(void)
         }
 
         rescueState.intent.targetGroundspeed = 500;
-        rescueState.intent.targetAltitudeCm = newAltitude;
+        rescueState.intent.targetAltitudeCm = rescuePlan.cruiseAltitudeCm;
         rescueState.intent.crosstrack = true;
         rescueState.intent.minAngleDeg = 10;
         rescueState.intent.maxAngleDeg = 15;
         break;
     case RESCUE_CROSSTRACK:
-        if (rescueState.sensor.distanceToHomeM <= newDescentDistanceM) {
+        if (rescueState.sensor.distanceToHomeM <= rescuePlan.descentDistanceM) {
             rescueState.phase = RESCUE_LANDING_APPROACH;
         }
 
         // We can assume at this point that we are at or above our RTH height, so we need to try and point to home and tilt while maintaining alt
         // Is our altitude way off?  We should probably kick back to phase RESCUE_ATTAIN_ALT
         rescueState.intent.targetGroundspeed = gpsRescueConfig()->rescueGroundspeed;
-        rescueState.intent.targetAltitudeCm = newAltitude;
+        rescueState.intent.targetAltitudeCm = rescuePlan.cruiseAltitudeCm;
         rescueState.intent.crosstrack = true;
         rescueState.intent.minAngleDeg = 15;
         rescueState.intent.maxAngleDeg = gpsRescueConfig()->angle;
@@ -652,11 +667,11 @@ void updateGPSRescueState(void)
         }
 
         // Only allow new altitude and new speed to be equal or lower than the current values (to prevent parabolic movement on overshoot)
-        const int32_t newAlt = MAX((lineSlope * rescueState.sensor.distanceToHomeM + lineOffsetM) * 100, 0);
+        const int32_t newAlt = MAX(rescuePlan.descentSlope * rescueState.sensor.distanceToHomeM + rescuePlan.descentOffsetCm, 0);
         
         // Start to decrease proportionally the quad's speed when the distance to home is less or equal than GPS_RESCUE_SLOWDOWN_DISTANCE_M
         if (rescueState.sensor.distanceToHomeM <= GPS_RESCUE_SLOWDOWN_DISTANCE_M) {
-            newSpeed = gpsRescueConfig()->rescueGroundspeed * rescueState.sensor.distanceToHomeM / GPS_RESCUE_SLOWDOWN_DISTANCE_M;
+            newSpeed = rescuePlan.slowdownScale * rescueState.sensor.distanceToHomeM;
         }
 
         rescueState.intent.targetAltitudeCm = constrain(newAlt, 100, rescueState.intent.targetAltitudeCm);
@@ -713,6 +728,12 @@ float gpsRescueGetYawRate(void)
     return rescueYaw;
 }
 
+float gpsRescueGetCollective(void)
+{
+    // Collective in rcCommand units, flown by the altitude controller
+    return rescueCollective;
+}
+
 float gpsRescueGetThrottle(void)
 {
     // Calculated a desired commanded throttle scaled from 0.0 to 1.0 for use in the mixer.
@@ -42,6 +42,9 @@ typedef struct gpsRescue_s {
     uint8_t altitudeMode;
     uint16_t ascendRate;
     uint16_t descendRate;
+    int16_t collectiveMin;
+    int16_t collectiveMax;
+    int16_t collectiveHover;
 } gpsRescueConfig_t;
 
 PG_DECLARE(gpsRescueConfig_t, gpsRescueConfig);
@@ -53,6 +56,7 @@ void rescueNewGpsData(void);
 
 float gpsRescueGetYawRate(void);
 float gpsRescueGetThrottle(void);
+float gpsRescueGetCollective(void);
 bool gpsRescueIsConfigured(void);
 bool gpsRescueIsAvailable(void);
 bool gpsRescueIsDisabled(void);
@@ -49,7 +49,8 @@
 // Eg [0,31), [31,62), [62, 93) etc
 // for gyro loop >= 4KHz, sample rate 2000 defines FFT range to 1000Hz, 16 bins each 62.5 Hz wide
 // NB  FFT_WINDOW_SIZE is set to 32 in gyroanalyse.h
-#define FFT_BIN_COUNT             (FFT_WINDOW_SIZE / 2)
+// The larger windows (128/256) give 4-8x finer bins for main rotor frequencies. They are analysed
+// once every half window (50% overlap) instead of on every new sample.
 // smoothing frequency for FFT centre frequency
 #define DYN_NOTCH_SMOOTH_FREQ_HZ  50
 // we need 4 steps for each axis
@@ -58,20 +59,34 @@
 // we won't update dynNotchMaxFFT unless throttle percent is above this value
 #define DYN_NOTCH_OSD_MIN_THROTTLE 20
 
+// multi-peak tracker: a new peak must be this much stronger than the weakest tracked one to replace it
+#define DYN_NOTCH_PEAK_HYSTERESIS  1.5f
+// tracked peak magnitude decay per analysis when the peak is not seen
+#define DYN_NOTCH_PEAK_DECAY       0.9f
+// peaks closer than this many bins are considered the same peak
+#define DYN_NOTCH_PEAK_MATCH_BINS  2.0f
+
 static uint16_t FAST_RAM_ZERO_INIT   fftSamplingRateHz;
+static uint16_t FAST_RAM_ZERO_INIT   fftWindowSize;
+static uint16_t FAST_RAM_ZERO_INIT   fftBinCount;
+static uint16_t FAST_RAM_ZERO_INIT   fftHopSize;
 static float FAST_RAM_ZERO_INIT      fftResolution;
 static uint8_t FAST_RAM_ZERO_INIT    fftStartBin;
 static uint16_t FAST_RAM_ZERO_INIT   dynNotchMaxCtrHz;
 static uint8_t dynamicFilterRange;
-static float FAST_RAM_ZERO_INIT      dynNotchQ;
+static float FAST_RAM_ZERO_INIT      dynNotchQScale;         // 1 / (2 * Q) for the coefficient updates
+static float FAST_RAM_ZERO_INIT      dynNotchOmegaScale;     // notch Hz to omega at the gyro rate
 static float FAST_RAM_ZERO_INIT      dynNotch1Ctr;
 static float FAST_RAM_ZERO_INIT      dynNotch2Ctr;
 static uint16_t FAST_RAM_ZERO_INIT   dynNotchMinHz;
 static bool FAST_RAM dualNotch = true;
+static bool FAST_RAM_ZERO_INIT       multiPeak;
+static uint8_t FAST_RAM_ZERO_INIT    dynNotchCount;
+static float FAST_RAM_ZERO_INIT      dynNotchPeakGain;
 static uint16_t FAST_RAM_ZERO_INIT dynNotchMaxFFT;
 
 // Hanning window, see https://en.wikipedia.org/wiki/Window_function#Hann_.28Hanning.29_window
-static FAST_RAM_ZERO_INIT float hanningWindow[FFT_WINDOW_SIZE];
+static FAST_RAM_ZERO_INIT float hanningWindow[FFT_WINDOW_SIZE_MAX];
 
 void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
 {
@@ -84,17 +99,36 @@ void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
     gyroAnalyseInitialized = true;
 #endif
 
+    switch (gyroConfig()->dyn_notch_window) {
+    case DYN_NOTCH_WINDOW_256:
+        fftWindowSize = MIN(256, FFT_WINDOW_SIZE_MAX);
+        break;
+    case DYN_NOTCH_WINDOW_128:
+        fftWindowSize = 128;
+        break;
+    default:
+        fftWindowSize = FFT_WINDOW_SIZE;
+        break;
+    }
+    fftBinCount = fftWindowSize / 2;
+    fftHopSize = (fftWindowSize > FFT_WINDOW_SIZE) ? fftWindowSize / 2 : 1;
+
     dynamicFilterRange = gyroConfig()->dyn_notch_range;
     fftSamplingRateHz = DYN_NOTCH_RANGE_HZ_LOW;
     dynNotch1Ctr = 1 - gyroConfig()->dyn_notch_width_percent / 100.0f;
     dynNotch2Ctr = 1 + gyroConfig()->dyn_notch_width_percent / 100.0f;
-    dynNotchQ = gyroConfig()->dyn_notch_q / 100.0f;
+    dynNotchQScale = 0.5f / (gyroConfig()->dyn_notch_q / 100.0f);
+    dynNotchOmegaScale = 2.0f * M_PIf * gyro.targetLooptime * 1e-6f;
     dynNotchMinHz = gyroConfig()->dyn_notch_min_hz;
 
     if (gyroConfig()->dyn_notch_width_percent == 0) {
         dualNotch = false;
     }
 
+    // more than one notch per axis switches to the multi-peak tracker, one notch per peak
+    dynNotchCount = gyroDataAnalyseNotchCount();
+    multiPeak = gyroConfig()->dyn_notch_count > 1;
+
     if (dynamicFilterRange == DYN_NOTCH_RANGE_AUTO) {
         if (gyroConfig()->dyn_lpf_gyro_max_hz > 333) {
             fftSamplingRateHz = DYN_NOTCH_RANGE_HZ_MEDIUM;
@@ -116,14 +150,15 @@ void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
     
     fftSamplingRateHz = MIN((gyroLoopRateHz / 3), fftSamplingRateHz);
 
-    fftResolution = (float)fftSamplingRateHz / FFT_WINDOW_SIZE;
+    fftResolution = (float)fftSamplingRateHz / fftWindowSize;
 
-    fftStartBin = dynNotchMinHz / lrintf(fftResolution);
+    // peak search looks at the previous bin, so never start at bin 0
+    fftStartBin = MAX(1, dynNotchMinHz / MAX(1, lrintf(fftResolution)));
 
     dynNotchMaxCtrHz = fftSamplingRateHz / 2; //Nyquist
 
-    for (int i = 0; i < FFT_WINDOW_SIZE; i++) {
-        hanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (FFT_WINDOW_SIZE - 1)));
+    for (int i = 0; i < fftWindowSize; i++) {
+        hanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (fftWindowSize - 1)));
     }
 }
 
@@ -137,18 +172,38 @@ void gyroDataAnalyseStateInit(gyroAnalyseState_t *state, uint32_t targetLooptime
     state->maxSampleCount = samplingFrequency / fftSamplingRateHz;
     state->maxSampleCountRcp = 1.f / state->maxSampleCount;
 
-    arm_rfft_fast_init_f32(&state->fftInstance, FFT_WINDOW_SIZE);
+    arm_rfft_fast_init_f32(&state->fftInstance, fftWindowSize);
+
+    state->circularBufferIdx = 0;
+    state->hopSampleCount = 0;
 
 //    recalculation of filters takes 4 calls per axis => each filter gets updated every DYN_NOTCH_CALC_TICKS calls
 //    at 4khz gyro loop rate this means 4khz / 4 / 3 = 333Hz => update every 3ms
 //    for gyro rate > 16kHz, we have update frequency of 1kHz => 1ms
-    const float looptime = MAX(1000000u / fftSamplingRateHz, targetLooptimeUs * DYN_NOTCH_CALC_TICKS);
+//    with overlapped windows the filters are updated once per hop instead
+    const float looptime = MAX(1000000u * fftHopSize / fftSamplingRateHz, targetLooptimeUs * DYN_NOTCH_CALC_TICKS);
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         // any init value
         state->centerFreq[axis] = dynNotchMaxCtrHz;
         state->prevCenterFreq[axis] = dynNotchMaxCtrHz;
         biquadFilterInitLPF(&state->detectedFrequencyFilter[axis], DYN_NOTCH_SMOOTH_FREQ_HZ, looptime);
+
+        for (int i = 0; i < DYN_NOTCH_COUNT_MAX; i++) {
+            state->peaks[axis][i].freq = dynNotchMaxCtrHz;
+            state->peaks[axis][i].value = 0;
+            state->peaks[axis][i].notchFreq = 0;
+        }
     }
+    dynNotchPeakGain = pt1FilterGain(DYN_NOTCH_SMOOTH_FREQ_HZ, looptime * 1e-6f);
+}
+
+// number of dynamic notches per axis needed by the current config
+uint8_t gyroDataAnalyseNotchCount(void)
+{
+    if (gyroConfig()->dyn_notch_count > 1) {
+        return MIN(gyroConfig()->dyn_notch_count, DYN_NOTCH_COUNT_MAX);
+    }
+    return (gyroConfig()->dyn_notch_width_percent != 0) ? 2 : 1;
 }
 
 // receive gyro data samples for each axis from gyro_filter_impl.c
@@ -157,12 +212,23 @@ void gyroDataAnalysePush(gyroAnalyseState_t *state, const int axis, const float
     state->oversampledGyroAccumulator[axis] += sample;
 }
 
-static void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn, biquadFilter_t *notchFilterDyn2);
+enum {
+    STEP_ARM_CFFT_F32,
+    STEP_BITREVERSAL,
+    STEP_STAGE_RFFT_F32,
+    STEP_ARM_CMPLX_MAG_F32,
+    STEP_CALC_FREQUENCIES,
+    STEP_UPDATE_FILTERS,
+    STEP_HANNING,
+    STEP_COUNT
+};
+
+static void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t (*notchFilterDyn)[XYZ_AXIS_COUNT]);
 
 /*
  * Collect gyro data, to be analysed in gyroDataAnalyseUpdate function
  */
-void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn, biquadFilter_t *notchFilterDyn2)
+void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t (*notchFilterDyn)[XYZ_AXIS_COUNT])
 {
     // samples should have been pushed by `gyroDataAnalysePush`
     // if gyro sampling is > 1kHz, accumulate multiple samples
@@ -183,15 +249,24 @@ void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn,
             state->oversampledGyroAccumulator[axis] = 0;
         }
 
-        state->circularBufferIdx = (state->circularBufferIdx + 1) % FFT_WINDOW_SIZE;
-
-        // We need DYN_NOTCH_CALC_TICKS tick to update all axis with newly sampled value
-        state->updateTicks = DYN_NOTCH_CALC_TICKS;
+        state->circularBufferIdx = (state->circularBufferIdx + 1) % fftWindowSize;
+
+        if (fftHopSize == 1) {
+            // We need DYN_NOTCH_CALC_TICKS tick to update all axis with newly sampled value
+            state->updateTicks = DYN_NOTCH_CALC_TICKS;
+        } else if (++state->hopSampleCount >= fftHopSize) {
+            state->hopSampleCount = 0;
+            // Previous analysis is long finished. Restart from windowing the first axis so that
+            // every axis is analysed on the newest window, one extra tick for that.
+            state->updateAxis = 0;
+            state->updateStep = STEP_HANNING;
+            state->updateTicks = DYN_NOTCH_CALC_TICKS + 1;
+        }
     }
 
     // calculate FFT and update filters
     if (state->updateTicks > 0) {
-        gyroDataAnalyseUpdate(state, notchFilterDyn, notchFilterDyn2);
+        gyroDataAnalyseUpdate(state, notchFilterDyn);
         --state->updateTicks;
     }
 }
@@ -203,25 +278,98 @@ void arm_radix8_butterfly_f32(float32_t *pSrc, uint16_t fftLen, const float32_t
 void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable);
 
 /*
- * Analyse last gyro data from the last FFT_WINDOW_SIZE milliseconds
+ * Find the strongest spectral peaks of one axis and merge them into the tracked peak set
  */
-static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn, biquadFilter_t *notchFilterDyn2)
+static FAST_CODE_NOINLINE void gyroDataAnalyseTrackPeaks(gyroAnalyseState_t *state, int axis)
 {
-    enum {
-        STEP_ARM_CFFT_F32,
-        STEP_BITREVERSAL,
-        STEP_STAGE_RFFT_F32,
-        STEP_ARM_CMPLX_MAG_F32,
-        STEP_CALC_FREQUENCIES,
-        STEP_UPDATE_FILTERS,
-        STEP_HANNING,
-        STEP_COUNT
-    };
+    dynNotchPeak_t *peaks = state->peaks[axis];
+    dynNotchPeak_t found[DYN_NOTCH_COUNT_MAX];
+    int foundCount = 0;
+
+    // local maxima, strongest first
+    for (int i = fftStartBin; i < fftBinCount - 1; i++) {
+        const float value = state->fftData[i];
+        if (value > state->fftData[i - 1] && value >= state->fftData[i + 1]) {
+            int pos = foundCount;
+            while (pos > 0 && found[pos - 1].value < value) {
+                if (pos < dynNotchCount) {
+                    found[pos] = found[pos - 1];
+                }
+                pos--;
+            }
+            if (pos < dynNotchCount) {
+                // parabolic interpolation between neighbour bins
+                const float y0 = state->fftData[i - 1];
+                const float y2 = state->fftData[i + 1];
+                const float denom = y0 - 2 * value + y2;
+                const float delta = (denom != 0) ? 0.5f * (y0 - y2) / denom : 0;
+                found[pos].freq = (i + delta) * fftResolution;
+                found[pos].value = value;
+                foundCount = MIN(foundCount + 1, dynNotchCount);
+            }
+        }
+    }
+
+    for (int i = 0; i < dynNotchCount; i++) {
+        peaks[i].value *= DYN_NOTCH_PEAK_DECAY;
+    }
+
+    const float matchHz = DYN_NOTCH_PEAK_MATCH_BINS * fftResolution;
+
+    for (int n = 0; n < foundCount; n++) {
+        int nearest = -1;
+        int weakest = 0;
+        for (int i = 0; i < dynNotchCount; i++) {
+            if (peaks[i].value > 0 && fabsf(peaks[i].freq - found[n].freq) < matchHz &&
+                (nearest < 0 || fabsf(peaks[i].freq - found[n].freq) < fabsf(peaks[nearest].freq - found[n].freq))) {
+                nearest = i;
+            }
+            if (peaks[i].value < peaks[weakest].value) {
+                weakest = i;
+            }
+        }
+        if (nearest >= 0) {
+            // same peak, follow it smoothly
+            peaks[nearest].freq += dynNotchPeakGain * (found[n].freq - peaks[nearest].freq);
+            peaks[nearest].value = MAX(peaks[nearest].value, found[n].value);
+        } else if (found[n].value > peaks[weakest].value * DYN_NOTCH_PEAK_HYSTERESIS) {
+            // new peak, replaces the weakest one
+            peaks[weakest].freq = found[n].freq;
+            peaks[weakest].value = found[n].value;
+        }
+    }
+
+    // keep the set sorted by frequency
+    for (int i = 1; i < dynNotchCount; i++) {
+        const dynNotchPeak_t peak = peaks[i];
+        int j = i;
+        while (j > 0 && peaks[j - 1].freq > peak.freq) {
+            peaks[j] = peaks[j - 1];
+            j--;
+        }
+        peaks[j] = peak;
+    }
 
+    // strongest peak is reported as the axis center frequency
+    int strongest = 0;
+    for (int i = 1; i < dynNotchCount; i++) {
+        if (peaks[i].value > peaks[strongest].value) {
+            strongest = i;
+        }
+    }
+    state->prevCenterFreq[axis] = state->centerFreq[axis];
+    state->centerFreq[axis] = MAX(peaks[strongest].freq, dynNotchMinHz);
+}
+
+/*
+ * Analyse last gyro data from the last FFT_WINDOW_SIZE milliseconds
+ */
+static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t (*notchFilterDyn)[XYZ_AXIS_COUNT])
+{
     arm_cfft_instance_f32 *Sint = &(state->fftInstance.Sint);
 
     uint32_t startTime = 0;
-    if (debugMode == (DEBUG_FFT_TIME)) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_FFT_TIME)) {
         startTime = micros();
     }
 
@@ -229,7 +377,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
     switch (state->updateStep) {
         case STEP_ARM_CFFT_F32:
         {
-            switch (FFT_BIN_COUNT) {
+            switch (fftBinCount) {
             case 16:
                 // 16us
                 arm_cfft_radix8by2_f32(Sint, state->fftData);
@@ -240,7 +388,10 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
                 break;
             case 64:
                 // 70us
-                arm_radix8_butterfly_f32(state->fftData, FFT_BIN_COUNT, Sint->pTwiddle, 1);
+                arm_radix8_butterfly_f32(state->fftData, fftBinCount, Sint->pTwiddle, 1);
+                break;
+            case 128:
+                arm_cfft_radix8by2_f32(Sint, state->fftData);
                 break;
             }
             DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
@@ -265,19 +416,33 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
         case STEP_ARM_CMPLX_MAG_F32:
         {
             // 8us
-            arm_cmplx_mag_f32(state->rfftData, state->fftData, FFT_BIN_COUNT);
+            arm_cmplx_mag_f32(state->rfftData, state->fftData, fftBinCount);
             DEBUG_SET(DEBUG_FFT_TIME, 2, micros() - startTime);
             state->updateStep++;
             FALLTHROUGH;
         }
         case STEP_CALC_FREQUENCIES:
         {
+            if (multiPeak) {
+                gyroDataAnalyseTrackPeaks(state, state->updateAxis);
+                if (state->updateAxis == gyroConfig()->gyro_filter_debug_axis) {
+                    for (int i = 0; i < MIN(dynNotchCount, 4); i++) {
+                        DEBUG_SET(DEBUG_DYN_NOTCH, i, lrintf(state->peaks[state->updateAxis][i].freq));
+                    }
+                }
+                if (calculateThrottlePercentAbs() > DYN_NOTCH_OSD_MIN_THROTTLE) {
+                    dynNotchMaxFFT = MAX(dynNotchMaxFFT, state->centerFreq[state->updateAxis]);
+                }
+                DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+                break;
+            }
+
             bool fftIncreased = false;
             float dataMax = 0;
-            uint8_t binStart = 0;
-            uint8_t binMax = 0;
+            uint16_t binStart = 0;
+            uint16_t binMax = 0;
             //for bins after initial decline, identify start bin and max bin 
-            for (int i = fftStartBin; i < FFT_BIN_COUNT; i++) {
+            for (int i = fftStartBin; i < fftBinCount; i++) {
                 if (fftIncreased || (state->fftData[i] > state->fftData[i - 1])) {
                     if (!fftIncreased) {
                         binStart = i; // first up-step bin
@@ -294,7 +459,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
             float fftSum = cubedData;
             float fftWeightedSum = cubedData * (binMax + 1);
             // accumulate upper shoulder
-            for (int i = binMax; i < FFT_BIN_COUNT - 1; i++) {
+            for (int i = binMax; i < fftBinCount - 1; i++) {
                 if (state->fftData[i] > state->fftData[i + 1]) {
                     cubedData = state->fftData[i] * state->fftData[i] * state->fftData[i];
                     fftSum += cubedData;
@@ -350,12 +515,23 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
         {
             // 7us
             // calculate cutoffFreq and notch Q, update notch filter  =1.8+((A2-150)*0.004)
-            if (state->prevCenterFreq[state->updateAxis] != state->centerFreq[state->updateAxis]) {
+            if (multiPeak) {
+                for (int i = 0; i < dynNotchCount; i++) {
+                    dynNotchPeak_t *peak = &state->peaks[state->updateAxis][i];
+                    const float notchFreq = constrainf(peak->freq, dynNotchMinHz, dynNotchMaxCtrHz);
+                    if (fabsf(notchFreq - peak->notchFreq) >= 1.0f) {
+                        biquadFilterSetNotch(&notchFilterDyn[i][state->updateAxis], notchFreq * dynNotchOmegaScale, dynNotchQScale);
+                        peak->notchFreq = notchFreq;
+                    }
+                }
+            } else if (state->prevCenterFreq[state->updateAxis] != state->centerFreq[state->updateAxis]) {
+                const float centerOmega = state->centerFreq[state->updateAxis] * dynNotchOmegaScale;
                 if (dualNotch) {
-                    biquadFilterUpdate(&notchFilterDyn[state->updateAxis], state->centerFreq[state->updateAxis] * dynNotch1Ctr, gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
-                    biquadFilterUpdate(&notchFilterDyn2[state->updateAxis], state->centerFreq[state->updateAxis] * dynNotch2Ctr, gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
+                    biquadFilter_t * const filters[2] = { &notchFilterDyn[0][state->updateAxis], &notchFilterDyn[1][state->updateAxis] };
+                    const float omegas[2] = { centerOmega * dynNotch1Ctr, centerOmega * dynNotch2Ctr };
+                    biquadFilterSetNotches(filters, omegas, 2, dynNotchQScale);
                 } else {
-                    biquadFilterUpdate(&notchFilterDyn[state->updateAxis], state->centerFreq[state->updateAxis], gyro.targetLooptime, dynNotchQ, FILTER_NOTCH);
+                    biquadFilterSetNotch(&notchFilterDyn[0][state->updateAxis], centerOmega, dynNotchQScale);
                 }
             }
             DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
@@ -369,7 +545,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
             // 5us
             // apply hanning window to gyro samples and store result in fftData
             // hanning starts and ends with 0, could be skipped for minor speed improvement
-            const uint8_t ringBufIdx = FFT_WINDOW_SIZE - state->circularBufferIdx;
+            const uint16_t ringBufIdx = fftWindowSize - state->circularBufferIdx;
             arm_mult_f32(&state->downsampledGyroData[state->updateAxis][state->circularBufferIdx], &hanningWindow[0], &state->fftData[0], ringBufIdx);
             if (state->circularBufferIdx > 0) {
                 arm_mult_f32(&state->downsampledGyroData[state->updateAxis][0], &hanningWindow[ringBufIdx], &state->fftData[ringBufIdx], state->circularBufferIdx);
@@ -25,9 +25,31 @@
 #include "common/filter.h"
 
 
-// max for F3 targets
+// default window, max for F3 targets
 #define FFT_WINDOW_SIZE 32
 
+// largest window for the overlapped analyser
+#if defined(STM32F7) || defined(STM32H7)
+#define FFT_WINDOW_SIZE_MAX 256
+#else
+#define FFT_WINDOW_SIZE_MAX 128
+#endif
+
+typedef enum {
+    DYN_NOTCH_WINDOW_32 = 0,
+    DYN_NOTCH_WINDOW_128,
+    DYN_NOTCH_WINDOW_256,
+} dynNotchWindow_e;
+
+// max number of dynamic notches per axis
+#define DYN_NOTCH_COUNT_MAX 4
+
+typedef struct dynNotchPeak_s {
+    float freq;         // smoothed peak frequency, Hz
+    float value;        // peak magnitude, decays when the peak is not seen
+    float notchFreq;    // frequency the notch was last set to
+} dynNotchPeak_t;
+
 typedef struct gyroAnalyseState_s {
     // accumulator for oversampled data => no aliasing and less noise
     uint8_t sampleCount;
@@ -36,8 +58,11 @@ typedef struct gyroAnalyseState_s {
     float oversampledGyroAccumulator[XYZ_AXIS_COUNT];
 
     // downsampled gyro data circular buffer for frequency analysis
-    uint8_t circularBufferIdx;
-    float downsampledGyroData[XYZ_AXIS_COUNT][FFT_WINDOW_SIZE];
+    uint16_t circularBufferIdx;
+    float downsampledGyroData[XYZ_AXIS_COUNT][FFT_WINDOW_SIZE_MAX];
+
+    // new samples since the last analysis, for the overlapped windows
+    uint16_t hopSampleCount;
 
     // update state machine step information
     uint8_t updateTicks;
@@ -45,18 +70,22 @@ typedef struct gyroAnalyseState_s {
     uint8_t updateAxis;
 
     arm_rfft_fast_instance_f32 fftInstance;
-    float fftData[FFT_WINDOW_SIZE];
-    float rfftData[FFT_WINDOW_SIZE];
+    float fftData[FFT_WINDOW_SIZE_MAX];
+    float rfftData[FFT_WINDOW_SIZE_MAX];
 
     biquadFilter_t detectedFrequencyFilter[XYZ_AXIS_COUNT];
     uint16_t centerFreq[XYZ_AXIS_COUNT];
     uint16_t prevCenterFreq[XYZ_AXIS_COUNT];
+
+    // multi-peak tracker, peaks sorted by frequency
+    dynNotchPeak_t peaks[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
 } gyroAnalyseState_t;
 
-STATIC_ASSERT(FFT_WINDOW_SIZE <= (uint8_t) -1, window_size_greater_than_underlying_type);
+STATIC_ASSERT(FFT_WINDOW_SIZE_MAX <= (uint16_t) -1, window_size_greater_than_underlying_type);
 
 void gyroDataAnalyseStateInit(gyroAnalyseState_t *gyroAnalyse, uint32_t targetLooptime);
 void gyroDataAnalysePush(gyroAnalyseState_t *gyroAnalyse, int axis, float sample);
-void gyroDataAnalyse(gyroAnalyseState_t *gyroAnalyse, biquadFilter_t *notchFilterDyn, biquadFilter_t *notchFilterDyn2);
+void gyroDataAnalyse(gyroAnalyseState_t *gyroAnalyse, biquadFilter_t (*notchFilterDyn)[XYZ_AXIS_COUNT]);
+uint8_t gyroDataAnalyseNotchCount(void);
 uint16_t getMaxFFT(void);
 void resetMaxFFT(void);
@@ -84,6 +84,7 @@ static bool imuUpdated = false;
 #define ATTITUDE_RESET_KP_GAIN    25.0     // dcmKpGain value to use during attitude reset
 #define ATTITUDE_RESET_ACTIVE_TIME 500000  // 500ms - Time to wait for attitude to converge at high gain
 #define GPS_COG_MIN_GROUNDSPEED 500        // 500cm/s minimum groundspeed for a gps heading to be considered valid
+#define GRAVITY_CMSS 980.665f
 
 int32_t accSum[XYZ_AXIS_COUNT];
 float accAverage[XYZ_AXIS_COUNT];
@@ -113,12 +114,26 @@ quaternion offset = QUATERNION_INITIALIZE;
 // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
 attitudeEulerAngles_t attitude = EULER_INITIALIZE;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 1);
+// earth frame vertical acceleration of the last correction, gravity removed, in cm/s^2 (up positive)
+static float accelerationZ = 0;
+
+// gyro integration step, run from the PID loop when gyro_update_hz is set
+static FAST_RAM_ZERO_INIT uint16_t imuGyroUpdateDenom;
+static FAST_RAM_ZERO_INIT uint16_t imuGyroUpdateCount;
+static FAST_RAM_ZERO_INIT float imuGyroUpdateDt;
+
+#ifdef USE_ACC
+// feedback rate (rad/s) from the last accelerometer/mag correction, applied by the gyro step
+static FAST_RAM_ZERO_INIT float imuCorrectionRate[XYZ_AXIS_COUNT];
+#endif
+
+PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 2);
 
 PG_RESET_TEMPLATE(imuConfig_t, imuConfig,
     .dcm_kp = 2500,                // 1.0 * 10000
     .dcm_ki = 0,                   // 0.003 * 10000
     .small_angle = 25,
+    .gyro_update_hz = 1000,
 );
 
 static void imuQuaternionComputeProducts(quaternion *quat, quaternionProducts *quatProd)
@@ -192,6 +207,14 @@ void imuInit(void)
 
     imuComputeRotationMatrix();
 
+    // Decimate the PID loop down to gyro_update_hz, never above the PID rate
+    imuGyroUpdateDenom = 0;
+    if (imuConfig()->gyro_update_hz && targetPidLooptime) {
+        imuGyroUpdateDenom = MAX(1, lrintf(1e6f / (imuConfig()->gyro_update_hz * targetPidLooptime)));
+        imuGyroUpdateDt = imuGyroUpdateDenom * targetPidLooptime * 1e-6f;
+    }
+    imuGyroUpdateCount = 0;
+
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_MULTITHREAD)
     if (pthread_mutex_init(&imuUpdateLock, NULL) != 0) {
         printf("Create imuUpdateLock error!\n");
@@ -209,11 +232,6 @@ void imuResetAccelerationSum(void)
 }
 
 #if defined(USE_ACC)
-static float invSqrt(float x)
-{
-    return 1.0f / sqrtf(x);
-}
-
 static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
                                 bool useAcc, float ax, float ay, float az,
                                 bool useMag,
@@ -235,7 +253,9 @@ static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
             courseOverGround += (2.0f * M_PIf);
         }
 
-        const float ez_ef = (- sin_approx(courseOverGround) * rMat[0][0] - cos_approx(courseOverGround) * rMat[1][0]);
+        float sinCog, cosCog;
+        sin_cos_approx(courseOverGround, &sinCog, &cosCog);
+        const float ez_ef = (- sinCog * rMat[0][0] - cosCog * rMat[1][0]);
 
         ex = rMat[2][0] * ez_ef;
         ey = rMat[2][1] * ez_ef;
@@ -306,6 +326,14 @@ static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
         integralFBz = 0.0f;
     }
 
+    // The gyro step integrates the rates, leave it the feedback only
+    if (imuGyroUpdateDenom) {
+        imuCorrectionRate[X] = dcmKpGain * ex + integralFBx;
+        imuCorrectionRate[Y] = dcmKpGain * ey + integralFBy;
+        imuCorrectionRate[Z] = dcmKpGain * ez + integralFBz;
+        return;
+    }
+
     // Apply proportional and integral feedback
     gx += dcmKpGain * ex + integralFBx;
     gy += dcmKpGain * ey + integralFBy;
@@ -558,7 +586,12 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
                         useMag,
                         useCOG, courseOverGround,  imuCalcKpGain(currentTimeUs, useAcc, gyroAverage));
 
-    imuUpdateEulerAngles();
+    // accAverage is in the body frame, the up row of the rotation matrix brings it to the earth vertical
+    accelerationZ = ((rMat[2][X] * accAverage[X] + rMat[2][Y] * accAverage[Y] + rMat[2][Z] * accAverage[Z]) * acc.dev.acc_1G_rec - 1.0f) * GRAVITY_CMSS;
+
+    if (!imuGyroUpdateDenom) {
+        imuUpdateEulerAngles();
+    }
 #endif
 }
 
@@ -608,6 +641,50 @@ void imuUpdateAttitude(timeUs_t currentTimeUs)
         acc.accADC[Z] = 0;
     }
 }
+
+// Integrate the filtered gyro into the attitude between the slower
+// accelerometer/mag corrections, so that the level modes see a fresh attitude.
+// Only this step writes the quaternion while it is enabled.
+FAST_CODE void imuUpdateGyroAttitude(void)
+{
+    if (!imuGyroUpdateDenom || !sensors(SENSOR_ACC) || !acc.isAccelUpdatedAtLeastOnce) {
+        return;
+    }
+
+    if (++imuGyroUpdateCount < imuGyroUpdateDenom) {
+        return;
+    }
+    imuGyroUpdateCount = 0;
+
+#if defined(SIMULATOR_BUILD) && !defined(USE_IMU_CALC)
+    // attitude comes from the simulator
+#else
+    IMU_LOCK;
+
+    const float halfDt = 0.5f * imuGyroUpdateDt;
+    const float gx = (DEGREES_TO_RADIANS(gyro.gyroADCf[X]) + imuCorrectionRate[X]) * halfDt;
+    const float gy = (DEGREES_TO_RADIANS(gyro.gyroADCf[Y]) + imuCorrectionRate[Y]) * halfDt;
+    const float gz = (DEGREES_TO_RADIANS(gyro.gyroADCf[Z]) + imuCorrectionRate[Z]) * halfDt;
+
+    const quaternion buffer = q;
+
+    q.w += (-buffer.x * gx - buffer.y * gy - buffer.z * gz);
+    q.x += (+buffer.w * gx + buffer.y * gz - buffer.z * gy);
+    q.y += (+buffer.w * gy - buffer.x * gz + buffer.z * gx);
+    q.z += (+buffer.w * gz + buffer.x * gy - buffer.y * gx);
+
+    const float recipNorm = invSqrt(sq(q.w) + sq(q.x) + sq(q.y) + sq(q.z));
+    q.w *= recipNorm;
+    q.x *= recipNorm;
+    q.y *= recipNorm;
+    q.z *= recipNorm;
+
+    imuComputeRotationMatrix();
+    imuUpdateEulerAngles();
+
+    IMU_UNLOCK;
+#endif
+}
 #endif // USE_ACC
 
 bool shouldInitializeGPSHeading()
@@ -628,6 +705,19 @@ float getCosTiltAngle(void)
     return rMat[2][2];
 }
 
+float getAccelerationZ(void)
+{
+    return accelerationZ;
+}
+
+// Earth up axis in the body frame, (0,0,1) when level
+void getUpVector(float *up)
+{
+    up[X] = rMat[2][X];
+    up[Y] = rMat[2][Y];
+    up[Z] = rMat[2][Z];
+}
+
 void getQuaternion(quaternion *quat)
 {
    quat->w = q.w;
@@ -59,6 +59,7 @@ typedef struct imuConfig_s {
     uint16_t dcm_kp;                        // DCM filter proportional gain ( x 10000)
     uint16_t dcm_ki;                        // DCM filter integral gain ( x 10000)
     uint8_t small_angle;
+    uint16_t gyro_update_hz;                // rate of the gyro quaternion integration between corrections, 0 = off
 } imuConfig_t;
 
 PG_DECLARE(imuConfig_t, imuConfig);
@@ -71,8 +72,11 @@ typedef struct imuRuntimeConfig_s {
 void imuConfigure(uint16_t throttle_correction_angle, uint8_t throttle_correction_value);
 
 float getCosTiltAngle(void);
+float getAccelerationZ(void);
+void getUpVector(float *up);
 void getQuaternion(quaternion * q);
 void imuUpdateAttitude(timeUs_t currentTimeUs);
+void imuUpdateGyroAttitude(void);
 
 void imuResetAccelerationSum(void);
 void imuInit(void);
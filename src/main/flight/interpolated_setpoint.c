@@ -27,6 +27,7 @@
 #include "common/maths.h"
 #include "fc/rc.h"
 #include "flight/interpolated_setpoint.h"
+#include "rx/rx.h"
 
 #define PREV_BIG_STEP 1000.0f //threshold for size of jump of packet before the identical data packet
 
@@ -46,14 +47,19 @@ static float prevAcceleration[XYZ_AXIS_COUNT];
 static float prevRawSetpoint[XYZ_AXIS_COUNT];
 static float prevDeltaImpl[XYZ_AXIS_COUNT];
 static bool bigStep[XYZ_AXIS_COUNT];
+static float setpointDeltaSlope[XYZ_AXIS_COUNT];    // change of setpointDelta per second, extrapolated between frames
 
 // Configuration
 static float ffMaxRateLimit[XYZ_AXIS_COUNT];
 static float ffMaxRate[XYZ_AXIS_COUNT];
+static bool ffPrediction;
+static float ffLookaheadUs;
 
 void interpolatedSpInit(const pidProfile_t *pidProfile) {
     const float ffMaxRateScale = pidProfile->ff_max_rate_limit * 0.01f;
     uint8_t j = pidProfile->ff_interpolate_sp;
+    ffPrediction = pidProfile->ff_prediction;
+    ffLookaheadUs = pidProfile->ff_lookahead_ms * 1000.0f;
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
         ffMaxRate[i] = applyCurve(i, 1.0f);
         ffMaxRateLimit[i] = ffMaxRate[i] * ffMaxRateScale;
@@ -61,7 +67,7 @@ void interpolatedSpInit(const pidProfile_t *pidProfile) {
     }
 }
 
-FAST_CODE_NOINLINE float interpolatedSpApply(int axis, bool newRcFrame, ffInterpolationType_t type) {
+FAST_CODE_NOINLINE float interpolatedSpApply(int axis, bool newRcFrame, ffInterpolationType_t type, timeUs_t currentTimeUs) {
 
     if (newRcFrame) {
         float rawSetpoint = getRawSetpoint(axis); 
@@ -150,7 +156,21 @@ FAST_CODE_NOINLINE float interpolatedSpApply(int axis, bool newRcFrame, ffInterp
         } else {
             setpointDelta[axis] = laggedMovingAverageUpdate(&setpointDeltaAvg[axis].filter, setpointDeltaImpl[axis]);
         }
+
+        // held or stepping sticks are not extrapolated
+        setpointDeltaSlope[axis] = (holdCount[axis] > holdSteps || bigStep[axis]) ? 0.0f : prevAcceleration[axis] * rxRate * pidGetDT();
+    }
+
+    if (ffPrediction) {
+        // The frame speed is a backward difference, half a frame old when it arrives. Extrapolate it to
+        // the current PID cycle plus the lookahead, so the FF latency does not depend on the link rate.
+        // Limited to a frame and a half plus jitter, in case frames are late or lost.
+        const float frameIntervalUs = rxGetFrameIntervalUs();
+        const float horizonUs = 1.5f * frameIntervalUs + 2.0f * rxGetFrameJitterUs() + ffLookaheadUs;
+        const float predictUs = cmpTimeUs(currentTimeUs, rxGetFrameTimeUs()) + 0.5f * frameIntervalUs + ffLookaheadUs;
+        return setpointDelta[axis] + setpointDeltaSlope[axis] * constrainf(predictUs, 0.0f, horizonUs) * 1e-6f;
     }
+
     return setpointDelta[axis];
 }
 
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #include "common/axis.h"
+#include "common/time.h"
 #include "flight/pid.h"
 
 typedef enum ffInterpolationType_e {
@@ -34,6 +35,6 @@ typedef enum ffInterpolationType_e {
 } ffInterpolationType_t;
 
 void interpolatedSpInit(const pidProfile_t *pidProfile);
-float interpolatedSpApply(int axis, bool newRcFrame, ffInterpolationType_t type);
+float interpolatedSpApply(int axis, bool newRcFrame, ffInterpolationType_t type, timeUs_t currentTimeUs);
 float applyFfLimit(int axis, float value, float Kp, float currentPidSetpoint);
 bool shouldApplyFfLimits(int axis);
@@ -53,25 +53,28 @@
 #include "fc/core.h"
 #include "fc/rc.h"
 
+#include "flight/collective.h"
 #include "flight/failsafe.h"
 #include "flight/imu.h"
 #include "flight/gps_rescue.h"
+#include "flight/governor.h"
 #include "flight/mixer.h"
 #include "flight/mixer_tricopter.h"
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
 #include "flight/servos.h"
+#include "flight/tailmotor.h"
 
 #include "rx/rx.h"
 
 #include "sensors/battery.h"
 #include "sensors/gyro.h"
+#include "sensors/rpm_source.h"
 #include "sensors/esc_sensor.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 4);
 
-#define DYN_LPF_THROTTLE_STEPS           100
-#define DYN_LPF_THROTTLE_UPDATE_DELAY_US 5000 // minimum of 5ms between updates
+#define DYN_LPF_UPDATE_DELAY_US          5000 // minimum of 5ms between updates
 
 PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
     .mixerMode = DEFAULT_MIXER,
@@ -86,7 +89,15 @@ PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
     .gov_collective_ff_gain = 0,
     .gov_collective_ff_impulse_gain = 0,
     .gov_tailmotor_assist_gain = 0,
-    .spoolup_time = 10
+    .spoolup_time = 10,
+    .gov_update_hz = 500,
+    .gov_bailout_time = 5,
+    .gov_bailout_percent = 50,
+    .gov_vbat_comp = 0,
+    .gov_current_ff_gain = 0,
+    .tail_rpm_max = 0,
+    .tail_rpm_p_gain = 20,
+    .tail_rpm_i_gain = 50,
 );
 
 PG_REGISTER_ARRAY(motorMixer_t, MAX_SUPPORTED_MOTORS, customMotorMixer, PG_MOTOR_MIXER, 0);
@@ -98,14 +109,27 @@ static FAST_RAM_ZERO_INIT uint8_t motorCount;
 float FAST_RAM_ZERO_INIT motor[MAX_SUPPORTED_MOTORS];
 float motor_disarmed[MAX_SUPPORTED_MOTORS];
 
-uint8_t motorRpmSource;
-pt1Filter_t motorRpmFilter[MAX_SUPPORTED_MOTORS];
-
 mixerMode_e currentMixerMode;
 static motorMixer_t currentMixer[MAX_SUPPORTED_MOTORS];
 
 static FAST_RAM_ZERO_INIT int throttleAngleCorrection;
 
+#if defined(USE_HELI_ONLY)
+// Main motor on motor[0], the tail motor of a custom mmix on motor[1]
+static const motorMixer_t mixerSingleProp[] = {
+    { 1.0f,  0.0f,  0.0f, 0.0f },
+};
+
+// Only the heli layouts are built, validateAndFixConfig() resets the other mixer modes.
+// The table still spans all of mixerMode_e so that it is indexed the same way.
+const mixer_t mixers[] = {
+    // motors, use servo, motor mixer
+    [MIXER_HELI_120_CCPM]   = { 1, true,  mixerSingleProp },
+    [MIXER_CUSTOM]          = { 0, false, NULL },
+    [MIXER_CUSTOM_AIRPLANE] = { 2, true,  NULL },
+    [MIXER_QUADX_1234]      = { 0, false, NULL },
+};
+#else
 // HF3D TODO:  Remove all the useless mixers and replace them with CCPM mixes for helicopters
 //     May require updating configurator?
 static const motorMixer_t mixerQuadX[] = {
@@ -114,7 +138,9 @@ static const motorMixer_t mixerQuadX[] = {
     { 1.0f,  1.0f,  1.0f,  1.0f },          // REAR_L
     { 1.0f,  1.0f, -1.0f, -1.0f },          // FRONT_L
 };
-#ifndef USE_QUAD_MIXER_ONLY
+#endif // USE_HELI_ONLY
+
+#if !defined(USE_QUAD_MIXER_ONLY) && !defined(USE_HELI_ONLY)
 static const motorMixer_t mixerTricopter[] = {
     { 1.0f,  0.0f,  1.333333f,  0.0f },     // REAR
     { 1.0f, -1.0f, -0.666667f,  0.0f },     // RIGHT
@@ -293,7 +319,7 @@ const mixer_t mixers[] = {
     { 3, true,  NULL },                // MIXER_CUSTOM_TRI
     { 4, false, mixerQuadX1234 },
 };
-#endif // !USE_QUAD_MIXER_ONLY
+#endif // !USE_QUAD_MIXER_ONLY && !USE_HELI_ONLY
 
 FAST_RAM_ZERO_INIT float motorOutputHigh, motorOutputLow;
 
@@ -305,26 +331,11 @@ static FAST_RAM_ZERO_INIT float idleThrottleOffset;
 static FAST_RAM_ZERO_INIT float idleMinMotorRps;
 static FAST_RAM_ZERO_INIT float idleP;
 #endif
-// Governor & Spool-up
-static FAST_RAM_ZERO_INIT float rampRate;                   // Used for spool-up logic.
-static FAST_RAM_ZERO_INIT uint16_t govMaxHeadspeed;
-static FAST_RAM_ZERO_INIT float govGearRatio;
-static FAST_RAM_ZERO_INIT float govKp;
-static FAST_RAM_ZERO_INIT float govKi;
-static FAST_RAM_ZERO_INIT float govCycKf;
-static FAST_RAM_ZERO_INIT float govColKf;
-static FAST_RAM_ZERO_INIT float govColPulseKf;
-
 uint8_t getMotorCount(void)
 {
     return motorCount;
 }
 
-float getFilteredMotorRPM(uint8_t motor)
-{
-    return motorRpmFilter[motor].state;
-}
-
 float getMotorMixRange(void)
 {
     //return motorMixRange;     // HF3D TODO:  Remove motorMixRange completely
@@ -352,7 +363,11 @@ bool areMotorsRunning(void)
 #ifdef USE_SERVOS
 bool mixerIsTricopter(void)
 {
+#ifdef USE_HELI_ONLY
+    return false;
+#else
     return (currentMixerMode == MIXER_TRI || currentMixerMode == MIXER_CUSTOM_TRI);
+#endif
 }
 #endif
 
@@ -376,7 +391,7 @@ void mixerInit(mixerMode_e mixerMode)
     currentMixerMode = mixerMode;
 
     initEscEndpoints();
-#ifdef USE_SERVOS
+#if defined(USE_SERVOS) && !defined(USE_HELI_ONLY)
     if (mixerIsTricopter()) {
         mixerTricopterInit();
     }
@@ -387,70 +402,6 @@ void mixerInit(mixerMode_e mixerMode)
     idleThrottleOffset = motorConfig()->digitalIdleOffsetValue * 0.0001f;
     idleP = currentPidProfile->idle_p * 0.0001f;
 #endif
-    
-    // Initialize governor settings
-    //  NOTE:  MixerInit is called from init.c well before pidInit, so don't depend on anything from there (like pidGetDT())
-    // Determine rampRate that will increase throttle on each loop to go from 0% throttle to 100% throttle in rampTime seconds
-    // We're stealing the mmix throttle% section on motor 0 to be our ramp-up time instead. 
-    // rampTime is how many seconds to go from 0rpm to 100% pwm output
-    // mmix 1 throttle = 5.0 ==> 5 seconds to spool up from 0% to 100% throttle
-    //   activemixer.throttle = floating point value between 0-1.00
-    // targetPidLooptime is in units of microseconds...  (8kHz => targetPidLooptime = 125)
-    //   5 seconds = @ 8kHz ==> 40,000 loops for full spool-up from 0% to 100%
-    //rampRate = targetPidLooptime / (currentMixer[0].throttle * 1e6f);    
-    //rampRate = 0.000025f;    // HF3D TODO:  Figure out why the line of code above doesn't work.
-        // targetPidLooptime should be (uint32_t) 125
-        // currentMixer[0].throttle should be  (float) 5.0
-        // 1e6f should be 1000000
-        // SO WHY DOESN'T IT WORK?????  Result should be 0.000025f, but instead the stupid heli just won't spool up.
-    
-    //rampRate = 0.000025f;
-    //rampRate = pidGetDT() / (float)mixerConfig()->spoolup_time;
-    // HF3D TODO:  lol... rampRate STILL not working.  Wtf.
-    govMaxHeadspeed = mixerConfig()->gov_max_headspeed;     // stays uint16_t
-    govGearRatio = (float)mixerConfig()->gov_gear_ratio / 1000.0f;
-    govKp = (float)mixerConfig()->gov_p_gain / 10.0f;
-    govKi = (float)mixerConfig()->gov_i_gain / 10.0f;
-    govCycKf = (float)mixerConfig()->gov_cyclic_ff_gain / 100.0f;
-    govColKf = (float)mixerConfig()->gov_collective_ff_gain / 10000.0f;
-    govColPulseKf = (float)mixerConfig()->gov_collective_ff_impulse_gain / 10000.0f;
-    
-    // Setup filter for governor base throttle
-    // Calculate similar to pt1FilterGain with cutoff frequency of 0.05Hz (20s)
-    //   RC = 1 / ( 2 * M_PI_FLOAT * f_cut);  ==> RC = 3.183
-    //   k = dT / (RC + dT);                  ==>  k = 0.0000393 for 8kHz
-    //govBaseThrottleFilterGain = pidGetDT() / (pidGetDT() + (1 / ( 2 * 3.14159f * 0.05f)));
-}
-
-// called from init at FC startup.
-void rpmSourceInit(void)
-{
-    // HF3D: TODO make this motor specific
-#ifdef USE_DSHOT_TELEMETRY
-    if (motorConfig()->dev.useDshotTelemetry) {
-        motorRpmSource = RPM_SRC_DSHOT_TELEM;
-    }
-    else
-#endif
-#ifdef USE_FREQ_SENSOR
-    if (featureIsEnabled(FEATURE_FREQ_SENSOR)) {
-        motorRpmSource = RPM_SRC_FREQ_SENSOR;
-    }
-    else
-#endif
-#ifdef USE_ESC_SENSOR
-    if (featureIsEnabled(FEATURE_ESC_SENSOR)) {
-        motorRpmSource = RPM_SRC_ESC_SENSOR;
-    }
-    else
-#endif
-    {
-        motorRpmSource = RPM_SRC_NONE;
-    }
-
-    for (int motor=0; motor<MAX_SUPPORTED_MOTORS; motor++) {
-        pt1FilterInit(&motorRpmFilter[motor], pt1FilterGain(mixerConfig()->gov_rpm_lpf, pidGetDT()));
-    }
 }
 
 #ifndef USE_QUAD_MIXER_ONLY
@@ -550,14 +501,19 @@ static FAST_RAM_ZERO_INIT int8_t motorOutputMixSign;
 
 static void calculateThrottleAndCurrentMotorEndpoints(timeUs_t currentTimeUs)
 {
+#ifndef USE_HELI_ONLY
     static uint16_t rcThrottlePrevious = 0;   // Store the last throttle direction for deadband transitions
     static timeUs_t reversalTimeUs = 0; // time when motors last reversed in 3D mode
+#endif
     static float motorRangeMinIncrease = 0;
 #ifdef USE_DYN_IDLE
     static float oldMinRps;
 #endif
     float currentThrottleInputRange = 0;
 
+#ifdef USE_HELI_ONLY
+    UNUSED(currentTimeUs);
+#else
     if (featureIsEnabled(FEATURE_3D)) {
         uint16_t rcCommand3dDeadBandLow;
         uint16_t rcCommand3dDeadBandHigh;
@@ -566,7 +522,7 @@ static void calculateThrottleAndCurrentMotorEndpoints(timeUs_t currentTimeUs)
             rcThrottlePrevious = rxConfig()->midrc; // When disarmed set to mid_rc. It always results in positive direction after arming.
         }
 
-        if (IS_RC_MODE_ACTIVE(BOX3D) || flight3DConfig()->switched_mode3d) {
+        if (RC_MODE_FLAG(RC_MODE_FLAG_3D) || flight3DConfig()->switched_mode3d) {
             // The min_check range is halved because the output throttle is scaled to 500us.
             // So by using half of min_check we maintain the same low-throttle deadband
             // stick travel as normal non-3D mode.
@@ -659,7 +615,9 @@ static void calculateThrottleAndCurrentMotorEndpoints(timeUs_t currentTimeUs)
             // keep iterm zero for 250ms after motor reversal
             pidResetIterm();
         }
-    } else {
+    } else
+#endif // USE_HELI_ONLY
+    {
         throttle = rcCommand[THROTTLE] - PWM_RANGE_MIN + throttleAngleCorrection;
 #ifdef USE_DYN_IDLE
         if (idleMinMotorRps > 0.0f) {
@@ -701,20 +659,7 @@ static void calculateThrottleAndCurrentMotorEndpoints(timeUs_t currentTimeUs)
     //    Essentially just converting throttle from a value in microseconds to a float between 0.0 and 1.0
 }
 
-// HF3D TODO:  Move governor logic to separate source file
-static FAST_RAM_ZERO_INIT float lastSpoolThrottle = 0;
-static FAST_RAM_ZERO_INIT uint8_t spooledUp = 0;
-static FAST_RAM_ZERO_INIT float governorSetpoint;
-static FAST_RAM_ZERO_INIT float governorSetpointLimited = 0.0f;
-static FAST_RAM_ZERO_INIT float govBaseThrottle;
-static FAST_RAM_ZERO_INIT float govPidSum = 0;
-static FAST_RAM_ZERO_INIT float govI = 0;
-static FAST_RAM_ZERO_INIT float govCollectiveFF = 0;
-static FAST_RAM_ZERO_INIT float govCollectivePulseFF = 0;
-static FAST_RAM_ZERO_INIT timeMs_t lastSpoolEndTime = 0;
-float FAST_RAM_ZERO_INIT headspeed = 0;
-
-static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t *activeMixer)
+static void applyMixToMotors(timeUs_t currentTimeUs, float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t *activeMixer)
 {
     UNUSED(activeMixer);
 
@@ -727,267 +672,19 @@ static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t
     //     * mmix 1 (tail motor) uses the Throttle% to determine tailMotorBaseThrustGain
     //     *    1.0 would be way too high.  Full tail thrust when head is at 100% rpm.
     
-    // Store mainMotorThrottle so we can override setting later if we're in pass-through mode
     float mainMotorThrottle = throttle;         // Used later by the tail code to set the base tail motor output as a fraction of main motor output
 
-    // Calculate rampRate.  Must do it here vs. in init because when mixer is initialized we don't know dT yet.
-    //  HF3D TODO:  This could be moved to a separate "init" function that's called from pid.c's function that sets the dT variable.
-    //     Not sure that complication would really help reduce CPU load much.
-    if (mixerConfig()->spoolup_time > 0) {
-        rampRate = pidGetDT() / (float)mixerConfig()->spoolup_time;
-    } else {
-        // Assume a ramprate of 8 seconds for external governor / ESC when in pass-through mode.
-        // Will allow us to set spooled-up flag if we see headspeed > 1000rpm on a RPM sensor or telemetry.
-        rampRate = pidGetDT() / 8.0f;
-    }
-
     // Handle MAIN motor (motor[0]) throttle output & spool-up
     if (motorCount > 0) {
 
-        // Calculate headspeed
-        headspeed = getFilteredMotorRPM(0) / govGearRatio;
-        
-        // Some logic to help us come back from a stage 1 failsafe / glitch / RPM loss / accidental throttle hold quickly
-        // We're going to use this time to lock in our spooledUp state for a few seconds after throttle = 0 when we were just spooledUp on the last pass through
-        // Also gives us a few second window if we lose headspeed signal... in that case we'll fall back to the commanded throttle value
-        if (spooledUp && (throttle == 0.0f || headspeed < 1000.0f) && cmp32(millis(), lastSpoolEndTime) > 5500) {
-            // Time check above must be set just a little longer than any of the lastSpoolEndTime checks below.
-            // HF3D TODO:  Maybe change the throttle check above to something >0.0f or add some more logic to allow for a faster ramp for autorotation bailout of some kind?
-            lastSpoolEndTime = millis();
-        }
-                
-        // Determine governor setpoint (use governor if throttle setting is >50%)
-        // HF3D TODO:  Check !isDshotMotorTelemetryActive(i)
-        float govRampRate = 0.0f;          
-        if (throttle > 0.50 && govMaxHeadspeed > 0) {
-
-            // Set the user requested governor headspeed setting
-            governorSetpoint = throttle * (float)govMaxHeadspeed;
-            
-            // If we don't have a non-zero rate limited setpoint yet, set it to the headspeed
-            if (governorSetpointLimited <= 0) {
-                governorSetpointLimited = headspeed;
-            }
-            
-            // Increment or decrement the rate limited governor setpoint if needed
-            // If ramp is set to 5s then this will allow 20% change in 1 second, or 10% headspeed in 0.5 seconds.
-            govRampRate = rampRate * (float)govMaxHeadspeed;
-            // Check to see if we've been spooledUp recently.  If so, increase our govRampRate greatly to help recover from temporary loss of throttle signal.
-            // HF3D TODO:  If someone immediately plugged in their heli, armed, and took off throttle hold we could accidentally hit this fast governor ramp.  That would be crazy... but possible I guess?
-            if ( spooledUp && cmp32(millis(), lastSpoolEndTime) < 5000 ) {
-                govRampRate *= 7.0f;
-            }
-            if ((governorSetpoint - governorSetpointLimited) > govRampRate) {
-                // Setpoint is higher than the rate limited setpoint, so increment limited setpoint higher
-                governorSetpointLimited = constrainf(governorSetpointLimited + govRampRate, governorSetpointLimited, governorSetpoint);                
-            
-            } else if ((governorSetpointLimited - governorSetpoint) > govRampRate)  {
-                // Setpoint is lower than the rate limited setpoint, so decrement limited setpoint lower
-                governorSetpointLimited = constrainf(governorSetpointLimited - govRampRate, governorSetpoint, governorSetpointLimited);
-            }
-        } else {
-            // Throttle is less than 50%, don't use governor.
-            governorSetpoint = 0;
-            governorSetpointLimited = 0;
-        }
-
-        if (headspeed == 0) {
-            // Disable governor if main motor RPM is not available
-            governorSetpoint = 0;
-            governorSetpointLimited = 0;
-        }
-    
-        //----------------- Spoolup Logic ----------------
-        // MVP:  If Main Motor RPM <1000, then reset spooledUp flag and use spooledUp logic
-        // HF3D TODO:  Add auto-rotation mode that ignores this check, or at least decreases the ramp time significantly.
-        // HF3D TODO:  Clean-up spool-up logic that allows for 2 modes:  Spool on throttle % only (no RPM telemetry), and Spool on Governor (Headspeed)
-        //    May be easier to just have 2 sets of code... 1 for spooling on governor and one for spooling without governor??
-        // HF3D TODO:
-        //  Idea for RPM-based spool-up logic when governor is active...
-        //  Bring throttle up to ~25%.  If no RPM detected, then disarm.
-        //  Once RPM is detected, start tracking PWM vs. RPM.  
-        //  If there becomes a large discrepency between PWM ramp and RPM ramp, then stop ramping PWM until ratio comes back in line.
-        //  This will prevent the "lag" that sometimes occurs where we end up ramping PWM into oblivion and then the ESC "catches up" later on.
-        //  See 4/9/20 log #7
-
-        // Spool-up using governorSetpoint (not the rate limited GovernorSetpoint)
-        // Determine spoolup status
-        if (headspeed < 1000.0f && cmp32(millis(), lastSpoolEndTime) > 3000) {
-            // Require heli to spin up slowly if it's been more than 3 seconds since we last had a headspeed below 1000 rpm
-            spooledUp = 0;
-
-        } else if (!governorSetpoint && throttle <= lastSpoolThrottle) {
-            // Governor is disabled, running on throttle % only.
-            // If user spools up above 1000rpm, then lowers throttle below the last spool target, allow the heli to be considered spooled up
-            spooledUp = 1;
-            lastSpoolThrottle = throttle;        // Allow spool target to reduce with throttle freely even if already spooledUp.
-            // HF3D TODO:  There's a bug with this block....
-            //   If you spool up above 1000rpm and then come back below that throttle setting (normal mode)
-            //   lastSpoolThrottle will ONLY go down since that's all it's allowed to do here.
-            //   Then when the governor turns on it gets this really low lastSpoolThrottle value (maybe even zero)
-            //      and then throttle drops to zero and the i-term has to wind up the entire amount.
-            
-        } else if (!spooledUp && governorSetpoint && (headspeed > governorSetpoint*0.97)) {
-            // Governor is enabled, running on headspeed
-            // If headspeed is within 3% of governorSetpoint, consider the heli to be spooled up
-            spooledUp = 1;
-            // Set the governor's base throttle % to our last spooled throttle value
-            govBaseThrottle = lastSpoolThrottle;
-            // Jump the rate limited Setpoint up to the setpoint.
-            governorSetpointLimited = governorSetpoint*0.97f;
-        
-        } else if (!spooledUp && governorSetpoint && (lastSpoolThrottle > 0.90f)) {
-            // Governor is enabled, and we've hit 90% throttle trying to get within 97% the requested headspeed.
-            // HF3D TODO:  Flag and alert user in the logs and/or with beep tones after flight that govMaxHeadspeed is set too high.
-            spooledUp = 1;
-            govBaseThrottle = lastSpoolThrottle;
-            governorSetpointLimited = headspeed;
-        }
-
-        // Handle ramping of throttle
-        // HF3D TODO:  Eventually add a "govEnabled" user setting flag.  If the user doesn't have the governor enabled then we need to not use headspeed to perform our spooledUp check.
-        //   Right now we have governor enabled all of of the time, but eventually the code needs to support running with or without an RPM signal (gov or no gov)
-        // Skip spooling logic if no throttle signal or if we're disarmed
-        if ((throttle == 0.0f) || !ARMING_FLAG(ARMED)) {
-            // Don't reset spooledUp flag because we want throttle to respond quickly if user drops throttle in normal mode or re-arms while blades are still spinning > 1000rpm
-            //   spooledUp flag will reset anyway if RPM < 1000
-            lastSpoolThrottle = 0.0f;         // Require re-spooling to start from zero if RPM<1000 and throttle=0 or disarmed
-        
-        // If not spooled up and throttle is higher than our last spooled-up output, spool some more
-        } else if (!governorSetpoint && !spooledUp && (lastSpoolThrottle < throttle)) {
-            // Governor is disabled, running on throttle % only.
-            throttle = lastSpoolThrottle + rampRate;    // rampRate defined in mixerConfigureOutput up above
-            lastSpoolThrottle = throttle;
-
-        // If not spooled up and headspeed is lower than our governorSetpoint, spool some more
-        } else if (governorSetpoint && !spooledUp && (headspeed < governorSetpoint)) {
-            // Governor is enabled, running on headspeed.
-            throttle = lastSpoolThrottle + rampRate;    // rampRate defined in mixerConfigureOutput up above
-            lastSpoolThrottle = throttle;
-        
-        }
-        // --------------- End of Spoolup Logic --------------
-        
-        // --------------- Feedforward Calculations ----------
-        
-        // Quick and dirty collective pitch linear feed-forward for the main motor
-        // Calculate linear feedforward vs. collective stick position (always positive adder)
-        //   Reasonable value would be 0.15 throttle addition for 12-degree collective throw..
-        //   So gains in the 0.0015 - 0.0032 range depending on where max collective pitch is on the heli
-        //   HF3D TODO:  Set this up so works off of a calibrated pitch value for the heli taken during setup
-        govCollectiveFF = govColKf * pidGetCollectiveStickPercent();
-        
-        // Collective pitch impulse feed-forward for the main motor
-        govCollectivePulseFF = govColPulseKf * pidGetCollectiveStickHPF();
-
-        // HF3D TODO:  Add a cyclic stick feedforward to the governor - linear gain should be fine.
-        // Additional torque is required from the motor when adding cyclic pitch, just like collective (although less)
-        // Maybe use this?:  float transition = feedForwardTransition > 0 ? MIN(1.f, getRcDeflectionAbs(axis) * feedForwardTransition) : 1;
-        // It's calculated like this in the pid.c code:
-        //   Calculate absolute value of the percentage of cyclic stick throw (both combined... but swash ring is the real issue).
-		//   float tailCyclicFF = -1.0f * servosGetSwashRingValue() * 100.0f * pidProfile->yawCycKf / 100.0f;
-        //   servosGetSwashRingValue() is a 0-1.0f value that is a fraction of the total cyclic travel allowed (usually 10 degrees)
-        float govCyclicFF = govCycKf * servosGetSwashRingValue();
-        
-        // --------------- End of Feedforward Calculations ---
-
-        // --------------- Governor Logic --------------------
-        if (spooledUp && governorSetpointLimited) {
-
-            // If using a motor-driven tail, allow the governor to help the tail motor to yaw in the main motor torque direction
-            //   It's more important that we maintain tail authority than it is to prevent overspeeds.
-            //   Constrain the main motor throttle assist to 15%
-            // HF3D TODO:  Using governorSetpointLimited to handle the ramp back down after tailmotor assist is a bit of a hack...
-            float govTailmotorAssist = 0.0f;
-            if ((motorCount > 1) && (motorMix[1] < 0.0f)) {
-                // NOTE:  Make sure to update mixerGetYawPidsumAssist() if the 0.15f constraint is changed.
-                govTailmotorAssist = constrainf((float)mixerConfig()->gov_tailmotor_assist_gain / 100.0f * motorOutputMixSign * -motorMix[1], 0.0f, 0.15f);
-                // Don't allow the governor to regulate down while we're assisting the tail motor unless we're more than 15% over our governor's headspeed setpoint
-                if ((headspeed > governorSetpointLimited) && (headspeed < governorSetpoint*1.15f)) {
-                    // Increase the rate-limited setpoint so that it tracks the headspeed higher and prevents the govPgain from offsetting our tailmotor assist
-                    //   5x govRampRate was chosen because that's about how fast you need to be able to track the headspeed increase for a fast burst of throttle                    
-                    //   Need to increase governorSetpointLimited 1x faster than desired govRampRate because it will be decremented by govRampRate in the governor spoolup code above
-                    governorSetpointLimited = constrainf(governorSetpointLimited + 6.0f*govRampRate, governorSetpointLimited, headspeed);
-                    //governorSetpointLimited = headspeed;
-                }
-            }
-
-            // Calculate error as a percentage of the max headspeed, since 100% throttle should be close to max headspeed
-            // HF3D TODO:  Do we really want the governor to respond the same even if setpoint is only 60% of max?
-            //   100 rpm error on 60% of max would "feel" a lot different than 100 rpm error on 90% of max headspeed.
-            //   But would it really require any torque differences for the same response??  Maybe, since less inertia in head?
-            float govError = (governorSetpointLimited - headspeed) / (float)govMaxHeadspeed;
-
-            // if (govError < 0.0f) {
-                // govError = govError * (1 - govTailmotorAssist);
-            // }
-
-            // Setting divider is 1/10, so if gov_p_gain = 10 (govKp = 1), we will get 1% change in throttle for 1% error in headspeed
-            float govP = govKp * govError;
-            // Setting divider is 1/10, so if gov_i_gain = 10 (govKi = 1), we will get 1% change in throttle for 1% error in headspeed after 1 second
-            govI = constrainf(govI + govKi * govError * pidGetDT(), -50.0f, 50.0f);
-            govPidSum = govP + govI;
-            // float govPidSum = govP + govI;
-            
-            // HF3D TODO:  Scale the sums based on the average battery voltage?
-            //  Note:  This should NOT apply to the tail feedforward compensations that go into the PID controller!
-            //         Those compensations are related to the amount of TORQUE only... and this comp would be trying
-            //            to keep torque equal, so those shouldn't have to change.
-            
-            // Generate our new governed throttle signal
-            throttle = govBaseThrottle + govCollectiveFF + govCollectivePulseFF + govCyclicFF + govPidSum + govTailmotorAssist;
-            // Reset any wind-up due to excess control signal
-            if (throttle > 1.0f) {
-                // Remove last addition to I-term to prevent further wind-up if it was moving us towards this over-control
-                if (govError > 0.0f) {
-                    govI = govI - govKi * govError * pidGetDT();
-                }
-                throttle = 1.0f;
-           
-            } else if (throttle < 0.0f) {
-                // Remove last addition to I-term to prevent further wind-up if it was moving us towards this over-control
-                // HF3D TODO:  What if I-term was at contraints before we did this?
-                if (govError < 0.0f) {
-                    govI = govI - govKi * govError * pidGetDT();
-                }
-
-                throttle = 0.0f;
-            }
+        // Tail motor demand in the main motor torque direction, for the governor tail assist. A closed loop tail holds its own authority.
+        const float tailAssistDemand = (motorCount > 1 && !tailMotorIsClosedLoop()) ? motorOutputMixSign * -motorMix[1] : 0.0f;
 
-            // pidGetdT() = targetPidLooptime * 1e-6f;  // 0.00125 for 8kHz
-            // Calculate similar to pt1FilterGain with cutoff frequency of 0.05Hz (20s)
-            //   RC = 1 / ( 2 * M_PI_FLOAT * f_cut);  ==> RC = 3.183
-            //   k = dT / (RC + dT);                  ==>  k = 0.0000393
-            // Slowly adapt our govBaseThrottle over time (LPF) as a fallback in case we lose RPM data.
-            // HF3D TODO:  If always flying at high collective pitch, that govCollectiveFF will end up adding into the govBaseThrottle
-            //    This means the base throttle will be ramped way up if then go back towards a lower average pitch... is that a problem?
-            //float govBaseThrottleChange = (throttle - govBaseThrottle) * govBaseThrottleFilterGain;
-            //govBaseThrottle += govBaseThrottleChange;
-            // Adjust the I-term to account for the base throttle adjustment we just made
-            // HF3D TODO:  What if I-term was at contraints before we did this?
-            //govI -= govBaseThrottleChange;
-        
-            // Set lastSpoolThrottle to track the governor throttle signal when the governor is active
-            lastSpoolThrottle = throttle;
+        // Spool-up, governor or pass-through of the throttle signal
+        throttle = governorUpdate(currentTimeUs, throttle, tailAssistDemand);
 
-            DEBUG_SET(DEBUG_SMARTAUDIO, 2, govPidSum*1000.0f);             // Max pidsum will be around 1, so increase by 1000x
-        }
-        
-        // Enable pass-through of throttle signal if spoolup_time setting = 0 and we are armed.
-        //   Must be used in conjunction with setting   gov_max_headspeed = 0 to have the spoolUp flag be set if an RPM sensor/telemetry is working.
-        //   spooledUp flag will be set 8 seconds after throttle hold is released if headspeed > 1000 rpm.
-        if ((mixerConfig()->spoolup_time == 0) && (ARMING_FLAG(ARMED))) {
-            throttle = mainMotorThrottle;    // We stored the original value of the throttle signal into mainMotorThrottle variable at the beginning of the governor/spoolup code
-        }
-        
         mainMotorThrottle = throttle;        // Used by the tail motor code to set the base tail motor output as a fraction of main motor output
 
-        // HF3D TODO:  Rename debug_smartaudio entry eventually
-        DEBUG_SET(DEBUG_SMARTAUDIO, 0, governorSetpointLimited);
-        DEBUG_SET(DEBUG_SMARTAUDIO, 1, headspeed);
-        //DEBUG_SET(DEBUG_SMARTAUDIO, 2, govPidSum*1000.0f);             // Max pidsum will be around 1, so increase by 1000x
-        DEBUG_SET(DEBUG_SMARTAUDIO, 3, getFilteredMotorRPM(1));  // Tail motor RPM
-
         // HF3D:  Modified original code to ignore any idle offset value when scaling main motor output -- we should always ensure that the main motor will be 100% stopped at zero throttle.
         //   motorOutputMin = motorRangeMin = motorOutputLow = DSHOT_MIN_THROTTLE
         float motorOutput;
@@ -1037,17 +734,22 @@ static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS], motorMixer_t
         
         //  For a tail motor.. we don't really want it spinning like crazy from base thrust anytime we're armed,
         //   so tone the motorOutput down a bit using the mainMotorThrottle as a gain until we're at half our throttle setting or something.
-        if (!spooledUp) {
+        if (!isHeliSpooledUp()) {
             // Track the main motor output while spooling up so that we don't have our tail motor going nuts at zero throttle
             motorOutput = mainMotorThrottle * motorOutput;
         }
         
-        // Linearize the tail motor thrust  (pidApplyThrustLinearization)
+        if (tailMotorIsClosedLoop()) {
+            // Thrust demand to a tail rpm setpoint, held by the tail motor speed loop
+            motorOutput = tailMotorUpdate(motorOutput);
+        } else {
+            // Linearize the tail motor thrust  (pidApplyThrustLinearization)
 #ifdef USE_THRUST_LINEARIZATION
-        // Scale PID sums and throttle to linearize the system (thrust varies with rpm^2)
-        //   https://github.com/betaflight/betaflight/pull/7304
-        motorOutput = pidApplyThrustLinearization(motorOutput);
+            // Scale PID sums and throttle to linearize the system (thrust varies with rpm^2)
+            //   https://github.com/betaflight/betaflight/pull/7304
+            motorOutput = pidApplyThrustLinearization(motorOutput);
 #endif
+        }
 
         // Just using the base thrust from the PID controller now.  Eventually need to revisit this.
         // Base thrust should vary with main motor RPM^2, but our tail motor also has thrust^2, so increase in base thrust will be linear
@@ -1133,19 +835,27 @@ static void applyMotorStop(void)
 }
 
 #ifdef USE_DYN_LPF
+// The rotor vibrations follow the headspeed, which a governor holds while the throttle follows the load.
+// The cutoffs follow the headspeed whenever there is an rpm source, the throttle only without one.
 static void updateDynLpfCutoffs(timeUs_t currentTimeUs, float throttle)
 {
     static timeUs_t lastDynLpfUpdateUs = 0;
-    static int dynLpfPreviousQuantizedThrottle = -1;  // to allow an initial zero throttle to set the filter cutoff
-
-    if (cmpTimeUs(currentTimeUs, lastDynLpfUpdateUs) >= DYN_LPF_THROTTLE_UPDATE_DELAY_US) {
-        const int quantizedThrottle = lrintf(throttle * DYN_LPF_THROTTLE_STEPS); // quantize the throttle reduce the number of filter updates
-        if (quantizedThrottle != dynLpfPreviousQuantizedThrottle) {
-            // scale the quantized value back to the throttle range so the filter cutoff steps are repeatable
-            const float dynLpfThrottle = (float)quantizedThrottle / DYN_LPF_THROTTLE_STEPS;
-            dynLpfGyroUpdate(dynLpfThrottle);
-            dynLpfDTermUpdate(dynLpfThrottle);
-            dynLpfPreviousQuantizedThrottle = quantizedThrottle;
+    static int dynLpfPreviousStep = -1;  // to allow an initial zero step to set the filter cutoff
+
+    if (cmpTimeUs(currentTimeUs, lastDynLpfUpdateUs) >= DYN_LPF_UPDATE_DELAY_US) {
+        float position;
+        if (isRpmSourceActive() && mixerConfig()->gov_max_headspeed) {
+            position = constrainf(getHeadspeedRPM() / mixerConfig()->gov_max_headspeed, 0.0f, 1.0f);
+        } else {
+            position = dynThrottle(throttle);
+        }
+
+        // the filter coefficients are only computed when the quantized position changes
+        const int step = lrintf(position * DYN_LPF_STEPS);
+        if (step != dynLpfPreviousStep) {
+            dynLpfGyroUpdate(step);
+            dynLpfDTermUpdate(step);
+            dynLpfPreviousStep = step;
             lastDynLpfUpdateUs = currentTimeUs;
         }
     }
@@ -1164,11 +874,6 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
         // return;
     // }
 
-    // HF3D: Update motor RPM filters - TODO: move somewhere else
-    for (int motor = 0; motor < motorCount; motor++) {
-        pt1FilterApply(&motorRpmFilter[motor], getMotorRPM(motor));
-    }
-
     motorMixer_t * activeMixer = &currentMixer[0];
     
     // Calculate and Limit the PID sum
@@ -1217,6 +922,14 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
 
     // Find roll/pitch/yaw desired output
     float motorMix[MAX_SUPPORTED_MOTORS];
+#ifdef USE_HELI_ONLY
+    // The main motor follows the governor, only the tail motor (motor[1]) takes a mix
+    if (motorCount > 1) {
+        motorMix[1] = (scaledAxisPidRoll  * activeMixer[1].roll +
+                       scaledAxisPidPitch * activeMixer[1].pitch +
+                       scaledAxisPidYaw   * activeMixer[1].yaw) * vbatCompensationFactor;
+    }
+#else
     for (int i = 0; i < motorCount; i++) {
 
         float mix =
@@ -1230,10 +943,10 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
 
         motorMix[i] = mix;
     }
+#endif
 
     //pidUpdateAntiGravityThrottleFilter(throttle);
 
-    // HF3D TODO:  Fix this for use with Helicopters (make dependent on headspeed or remove functionality)
 #ifdef USE_DYN_LPF
     updateDynLpfCutoffs(currentTimeUs, throttle);
 #endif
@@ -1254,13 +967,18 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     }
 #endif
 
+    throttle = failsafeHeliApplyThrottle(throttle);
+
     mixerThrottle = throttle;
 
     if (featureIsEnabled(FEATURE_MOTOR_STOP)
         && ARMING_FLAG(ARMED)
+#ifndef USE_HELI_ONLY
         && !featureIsEnabled(FEATURE_3D)
+#endif
         && !airmodeEnabled
         && !FLIGHT_MODE(GPS_RESCUE_MODE)   // disable motor_stop while GPS Rescue is active
+        && failsafeHeliGetAction() == FAILSAFE_HELI_NONE   // the HELI failsafe holds or cuts the throttle itself, the tail keeps running
         && (rcData[THROTTLE] < rxConfig()->mincheck)) {
         // Stop all motors by setting them to disarmMotorOutput value.
         // HF3D:  It's very important that this be done so that tail motor will stop as well.  Tail motor may still have yaw Pidsum mix even if throttle = 0!
@@ -1268,7 +986,7 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
         // HF3D TODO:  Call governor function to tell it we are in a stopped state
     } else {
         // Apply the mix to motor endpoints
-        applyMixToMotors(motorMix, activeMixer);
+        applyMixToMotors(currentTimeUs, motorMix, activeMixer);
     }
 }
 
@@ -1290,6 +1008,9 @@ mixerMode_e getMixerMode(void)
 
 bool isFixedWing(void)
 {
+#ifdef USE_HELI_ONLY
+    return false;
+#else
     switch (currentMixerMode) {
     case MIXER_FLYING_WING:
     case MIXER_AIRPLANE:
@@ -1302,24 +1023,7 @@ bool isFixedWing(void)
 
         break;
     }
-}
-
-// HF3D TODO:  Move this to governor/spoolup source file eventually
-// Return the status of whether the heli is spooled up
-// Very critical that this status is correct, because core.c checks it to force 
-//     the pid controller to reset it's I term on each pass if this is set.
-uint8_t isHeliSpooledUp(void)
-{
-    // Spooled Up is reset to 0 if (mainMotorRPM < 1000.0f)
-    // spooledUp will set to "1" the first time if it's a "clean" spoolup where you arm and spool to a single throttle setpoint
-    //   Jacking around with the throttle during spoolup could cause it to set the spooledUp flag instantly if you're already above 1000rpm
-    //   If user spools up above 1000rpm, then lowers throttle below the last spool target reached, the heli will be considered spooled up
-    return spooledUp;
-}
-
-float mixerGetGovGearRatio(void)
-{
-    return govGearRatio;
+#endif
 }
 
 // If we're using a tail motor, let the pid controller know about our maximum ability to assist in the main motor torque direction
@@ -1329,43 +1033,10 @@ float mixerGetGovGearRatio(void)
 // HF3D TODO:  Calculate this once on mixer init
 uint16_t mixerGetYawPidsumAssistLimit(void)
 {
-    if (motorCount > 1 && mixerConfig()->gov_tailmotor_assist_gain > 0) {
+    if (motorCount > 1 && mixerConfig()->gov_tailmotor_assist_gain > 0 && !tailMotorIsClosedLoop()) {
         float pidsumAssist = 0.15f * PID_MIXER_SCALING / ((float)mixerConfig()->gov_tailmotor_assist_gain / 100.0f);
         return constrain(pidsumAssist, 0, currentPidProfile->pidSumLimitYaw);
     }
 
     return currentPidProfile->pidSumLimitYaw;
 }
-
-int getMotorRPM(uint8_t motor)
-{
-    int erpm;
-#ifdef USE_DSHOT_TELEMETRY
-    if (motorRpmSource == RPM_SRC_DSHOT_TELEM) {
-        erpm = getDshotTelemetry(motor);
-    }
-    else
-#endif
-#ifdef USE_FREQ_SENSOR
-    if (motorRpmSource == RPM_SRC_FREQ_SENSOR) {
-        erpm = getFreqSensorRPM(motor);
-    }
-    else
-#endif
-#ifdef USE_ESC_SENSOR
-    if (motorRpmSource == RPM_SRC_ESC_SENSOR) {
-        erpm = getEscSensorRPM(motor);
-    }
-    else
-#endif
-    {
-        erpm = 0;
-    }
-    return calcEscRpm(motor,erpm);
-}
-
-bool isRpmSourceActive(void)
-{
-    return (motorRpmSource != RPM_SRC_NONE);
-}
-
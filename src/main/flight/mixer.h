@@ -29,13 +29,6 @@
 
 #define QUAD_MOTOR_COUNT 4
 
-typedef enum {
-    RPM_SRC_NONE = 0,
-    RPM_SRC_DSHOT_TELEM,
-    RPM_SRC_FREQ_SENSOR,
-    RPM_SRC_ESC_SENSOR,
-} rpmSource_e;
-
 // Note: this is called MultiType/MULTITYPE_* in baseflight.
 typedef enum mixerMode
 {
@@ -98,6 +91,14 @@ typedef struct mixerConfig_s {
     uint16_t gov_collective_ff_impulse_gain;
     uint16_t spoolup_time;
     uint16_t gov_tailmotor_assist_gain;
+    uint16_t gov_update_hz;             // governor and spoolup loop rate, decimated from the PID loop
+    uint8_t gov_bailout_time;           // time in 1/10 s for the bailout ramp over the full headspeed range
+    uint8_t gov_bailout_percent;        // headspeed in percent of gov_max_headspeed needed for a bailout recovery
+    uint8_t gov_vbat_comp;              // percent of the battery sag since engage compensated on the base throttle
+    uint16_t gov_current_ff_gain;       // load feedforward as motor and ESC resistance in milliohms
+    uint16_t tail_rpm_max;              // tail motor rpm at full thrust, 0 = open loop tail motor
+    uint16_t tail_rpm_p_gain;
+    uint16_t tail_rpm_i_gain;
 } mixerConfig_t;
 
 PG_DECLARE(mixerConfig_t, mixerConfig);
@@ -132,14 +133,6 @@ float mixerGetThrottle(void);
 mixerMode_e getMixerMode(void);
 bool isFixedWing(void);
 
-extern float headspeed;
-
 // HF3D
-void rpmSourceInit(void);
-uint8_t isHeliSpooledUp(void);
-float mixerGetGovGearRatio(void);
 float mixerGetGovCollectivePulseFilterGain(void);
 uint16_t mixerGetYawPidsumAssistLimit(void);
-int getMotorRPM(uint8_t motor);
-float getFilteredMotorRPM(uint8_t motor);
-bool isRpmSourceActive(void);
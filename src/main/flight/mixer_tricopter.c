@@ -23,7 +23,7 @@
 
 #include "platform.h"
 
-#ifdef USE_SERVOS
+#if defined(USE_SERVOS) && !defined(USE_HELI_ONLY)
 
 #include "common/utils.h"
 
@@ -58,4 +58,4 @@ void mixerTricopterInit(void)
 
 }
 
-#endif // USE_SERVOS
+#endif // USE_SERVOS && !USE_HELI_ONLY
@@ -41,16 +41,22 @@
 
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/looptime_check.h"
 #include "fc/rc.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 
+#include "flight/collective.h"
 #include "flight/gps_rescue.h"
+#include "flight/governor.h"
+#include "flight/tailmotor.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/rpm_filter.h"
 #include "flight/interpolated_setpoint.h"
+#include "flight/rescue.h"
 #include "flight/servos.h"
+#include "flight/sysid.h"
 
 #include "io/gps.h"
 
@@ -93,6 +99,13 @@ static FAST_RAM_ZERO_INIT bool inCrashRecoveryMode = false;
 static FAST_RAM_ZERO_INIT float dT;
 static FAST_RAM_ZERO_INIT float pidFrequency;
 
+// HF3D:  Each axis runs at its own fraction of the PID loop rate, following the bandwidth of its actuator
+static FAST_RAM_ZERO_INIT uint8_t pidAxisDenom[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT uint8_t pidAxisCount[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT uint32_t pidAxisLooptime[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float pidAxisDT[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float pidAxisFrequency[XYZ_AXIS_COUNT];
+
 //static FAST_RAM_ZERO_INIT uint8_t antiGravityMode;
 //static FAST_RAM_ZERO_INIT float antiGravityThrottleHpf;
 //static FAST_RAM_ZERO_INIT uint16_t itermAcceleratorGain;
@@ -100,7 +113,7 @@ static FAST_RAM_ZERO_INIT float pidFrequency;
 //static FAST_RAM_ZERO_INIT bool antiGravityEnabled;
 static FAST_RAM_ZERO_INIT bool zeroThrottleItermReset;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 4);
 
 #ifdef STM32F10X
 #define PID_PROCESS_DENOM_DEFAULT       1
@@ -121,11 +134,17 @@ PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
     .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
     .runaway_takeoff_prevention = true,
     .runaway_takeoff_deactivate_throttle = 20,  // throttle level % needed to accumulate deactivation time
-    .runaway_takeoff_deactivate_delay = 500     // Accumulated time (in milliseconds) before deactivation in successful takeoff
+    .runaway_takeoff_deactivate_delay = 500,    // Accumulated time (in milliseconds) before deactivation in successful takeoff
+    .pid_looptime_check = LOOPTIME_CHECK_WARN,
+    .pid_cyclic_denom = 1,
+    .pid_yaw_denom = 1,
 );
 #else
 PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
-    .pid_process_denom = PID_PROCESS_DENOM_DEFAULT
+    .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
+    .pid_looptime_check = LOOPTIME_CHECK_WARN,
+    .pid_cyclic_denom = 1,
+    .pid_yaw_denom = 1,
 );
 #endif
 
@@ -142,7 +161,8 @@ static FAST_RAM_ZERO_INIT float airmodeThrottleOffsetLimit;
 
 #define CRASH_RECOVERY_DETECTION_DELAY_US 1000000  // 1 second delay before crash recovery detection is active after entering a self-level mode
 
-PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, PID_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 13);
+// The version is 4 bits wide, it wraps to 0 after 15
+PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, PID_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 2);
 
 void resetPidProfile(pidProfile_t *pidProfile)
 {
@@ -223,15 +243,21 @@ void resetPidProfile(pidProfile_t *pidProfile)
         .ff_spike_limit = 60,
         .ff_max_rate_limit = 100,
         .ff_smooth_factor = 37,
+        .ff_prediction = false,
+        .ff_lookahead_ms = 0,
         .ff_boost = 15,
         // HF3D parameters
         .yawColKf = 300,
         .yawColPulseKf = 300,
         .yawCycKf = 0,
         .yawBaseThrust = 900,
+        .yaw_collective_ff_curve = 0,
+        .yaw_headspeed_ff_gain = 0,
         .rescue_collective = 200,
 		.rescue_collective_boost = 50,
 		.rescue_delay = 35,          				// Non Inverted rescue: disabled by default
+        .rescue_max_rate = 500,
+        .rescue_max_accel = 5000,
         .error_decay_always = 0,
         .error_decay_rate = 7,
         .collective_ff_impulse_freq = 100,
@@ -239,6 +265,15 @@ void resetPidProfile(pidProfile_t *pidProfile)
         .elevator_filter_window_time = 75,
         .elevator_filter_window_size = 30,
         .elevator_filter_hz = 15,
+        .gain_schedule_rpm = { 0, 0, 0, 0 },
+        .gain_schedule_percent = {
+            { 100, 100, 100, 100 },
+            { 100, 100, 100, 100 },
+            { 100, 100, 100, 100 },
+        },
+        .smith_delay_ms = { 0, 0, 0 },
+        .smith_lag_ms = { 10, 10, 10 },
+        .smith_gain = { 100, 100, 100 },
     );
 #ifndef USE_D_MIN
     pidProfile->pid[PID_ROLL].D = 30;
@@ -258,6 +293,15 @@ static void pidSetTargetLooptime(uint32_t pidLooptime)
     targetPidLooptime = pidLooptime;
     dT = targetPidLooptime * 1e-6f;
     pidFrequency = 1.0f / dT;
+
+    pidAxisDenom[FD_ROLL] = pidAxisDenom[FD_PITCH] = constrain(pidConfig()->pid_cyclic_denom, 1, MAX_PID_AXIS_DENOM);
+    pidAxisDenom[FD_YAW] = constrain(pidConfig()->pid_yaw_denom, 1, MAX_PID_AXIS_DENOM);
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        pidAxisCount[axis] = 0;
+        pidAxisLooptime[axis] = targetPidLooptime * pidAxisDenom[axis];
+        pidAxisDT[axis] = dT * pidAxisDenom[axis];
+        pidAxisFrequency[axis] = pidFrequency / pidAxisDenom[axis];
+    }
 #ifdef USE_DSHOT
     dshotSetPidLoopTime(targetPidLooptime);
 #endif
@@ -290,11 +334,10 @@ typedef union dtermLowpass_u {
 
 static FAST_RAM_ZERO_INIT float previousPidSetpoint[XYZ_AXIS_COUNT];
 
-static FAST_RAM_ZERO_INIT filterApplyFnPtr dtermNotchApplyFn;
+// D-term filters applied in order: notch, lowpass, lowpass2
+static FAST_RAM_ZERO_INIT filterChain_t dtermFilterChain;
 static FAST_RAM_ZERO_INIT biquadFilter_t dtermNotch[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT filterApplyFnPtr dtermLowpassApplyFn;
 static FAST_RAM_ZERO_INIT dtermLowpass_t dtermLowpass[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT filterApplyFnPtr dtermLowpass2ApplyFn;
 static FAST_RAM_ZERO_INIT dtermLowpass_t dtermLowpass2[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT filterApplyFnPtr ptermYawLowpassApplyFn;
 static FAST_RAM_ZERO_INIT pt1Filter_t ptermYawLowpass;
@@ -342,7 +385,6 @@ static FAST_RAM_ZERO_INIT float ffBoostFactor;
 static FAST_RAM_ZERO_INIT float ffSmoothFactor;
 static FAST_RAM_ZERO_INIT float ffSpikeLimitInverse;
 
-static FAST_RAM_ZERO_INIT float collectivePulseFilterGain;
 
 static FAST_RAM_ZERO_INIT filterApplyFnPtr elevatorFilterLowpassApplyFn;
 static FAST_RAM_ZERO_INIT pt1Filter_t elevatorFilterLowpass;
@@ -364,21 +406,76 @@ float pidGetFfSmoothFactor()
 }
 
 
+// Loop time the filter states were last built for, they are only carried over while it is unchanged
+static uint32_t pidFiltersLooptime;
+
+// HF3D:  Main rotor acceleration for the tail torque precompensation
+#define TAIL_HEADSPEED_ACCEL_CUTOFF_HZ 5
+static FAST_RAM_ZERO_INIT pt1Filter_t tailHeadspeedAccelLpf;
+static FAST_RAM_ZERO_INIT float tailHeadspeedPrevious;
+static FAST_RAM_ZERO_INIT float tailHeadspeedKf;
+
+// A filter that runs with the same type before and after a re-init keeps its state and only gets
+// new coefficients, so switching profiles in flight does not restart every filter from zero
+static void pidPt1FilterInit(pt1Filter_t *filter, float k, bool keepState)
+{
+    if (keepState) {
+        pt1FilterUpdateCutoff(filter, k);
+    } else {
+        pt1FilterInit(filter, k);
+    }
+}
+
+static void pidBiquadFilterInit(biquadFilter_t *filter, float filterFreq, float Q, biquadFilterType_e filterType, bool keepState)
+{
+    if (keepState) {
+        biquadFilterUpdate(filter, filterFreq, targetPidLooptime, Q, filterType);
+    } else {
+        biquadFilterInit(filter, filterFreq, targetPidLooptime, Q, filterType);
+    }
+}
+
+static void pidBiquadFilterInitLPF(biquadFilter_t *filter, float filterFreq, uint32_t looptime, bool keepState)
+{
+    if (keepState) {
+        biquadFilterUpdateLPF(filter, filterFreq, looptime);
+    } else {
+        biquadFilterInitLPF(filter, filterFreq, looptime);
+    }
+}
+
+static bool pidFilterChainHasStage(const filterChain_t *chain, filterStageType_e type, const void *filter)
+{
+    for (int i = 0; i < chain->stageCount; i++) {
+        if (chain->stage[i].type == type && chain->stage[i].filter[0] == filter) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void pidInitFilters(const pidProfile_t *pidProfile)
 {
     STATIC_ASSERT(FD_YAW == 2, FD_YAW_incorrect); // ensure yaw axis is 2
 
     if (targetPidLooptime == 0) {
         // no looptime set, so set all the filters to null
-        dtermNotchApplyFn = nullFilterApply;
-        dtermLowpassApplyFn = nullFilterApply;
+        dtermFilterChain.stageCount = 0;
         ptermYawLowpassApplyFn = nullFilterApply;
         elevatorFilterLowpassApplyFn = nullFilterApply;
+        pidFiltersLooptime = 0;
         return;
     }
 
     const uint32_t pidFrequencyNyquist = pidFrequency / 2; // No rounding needed
 
+    const bool keepState = (pidFiltersLooptime == targetPidLooptime);
+    const filterChain_t previousDtermChain = dtermFilterChain;
+    dtermFilterChain.stageCount = 0;
+    const filterApplyFnPtr previousYawLowpassApplyFn = ptermYawLowpassApplyFn;
+    const filterApplyFnPtr previousElevatorApplyFn = elevatorFilterLowpassApplyFn;
+    pidFiltersLooptime = targetPidLooptime;
+
     uint16_t dTermNotchHz;
     if (pidProfile->dterm_notch_hz <= pidFrequencyNyquist) {
         dTermNotchHz = pidProfile->dterm_notch_hz;
@@ -391,13 +488,12 @@ void pidInitFilters(const pidProfile_t *pidProfile)
     }
 
     if (dTermNotchHz != 0 && pidProfile->dterm_notch_cutoff != 0) {
-        dtermNotchApplyFn = (filterApplyFnPtr)biquadFilterApply;
+        const bool keepNotchState = keepState && pidFilterChainHasStage(&previousDtermChain, FILTER_STAGE_BIQUAD, dtermNotch);
         const float notchQ = filterGetNotchQ(dTermNotchHz, pidProfile->dterm_notch_cutoff);
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-            biquadFilterInit(&dtermNotch[axis], dTermNotchHz, targetPidLooptime, notchQ, FILTER_NOTCH);
+            pidBiquadFilterInit(&dtermNotch[axis], dTermNotchHz, notchQ, FILTER_NOTCH, keepNotchState);
         }
-    } else {
-        dtermNotchApplyFn = nullFilterApply;
+        filterChainAdd(&dtermFilterChain, FILTER_STAGE_BIQUAD, dtermNotch, sizeof(biquadFilter_t));
     }
 
     //1st Dterm Lowpass Filter
@@ -411,58 +507,62 @@ void pidInitFilters(const pidProfile_t *pidProfile)
 
     if (dterm_lowpass_hz > 0 && dterm_lowpass_hz < pidFrequencyNyquist) {
         switch (pidProfile->dterm_filter_type) {
-        case FILTER_PT1:
-            dtermLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
+        case FILTER_PT1: {
+            const bool keepLowpassState = keepState && pidFilterChainHasStage(&previousDtermChain, FILTER_STAGE_PT1, dtermLowpass);
             for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                pt1FilterInit(&dtermLowpass[axis].pt1Filter, pt1FilterGain(dterm_lowpass_hz, dT));
+                pidPt1FilterInit(&dtermLowpass[axis].pt1Filter, pt1FilterGain(dterm_lowpass_hz, dT), keepLowpassState);
             }
+            filterChainAdd(&dtermFilterChain, FILTER_STAGE_PT1, dtermLowpass, sizeof(dtermLowpass_t));
             break;
-        case FILTER_BIQUAD:
+        }
+        case FILTER_BIQUAD: {
 #ifdef USE_DYN_LPF
-            dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApplyDF1;
+            const filterStageType_e stageType = FILTER_STAGE_BIQUAD_DF1;
 #else
-            dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApply;
+            const filterStageType_e stageType = FILTER_STAGE_BIQUAD;
 #endif
+            const bool keepLowpassState = keepState && pidFilterChainHasStage(&previousDtermChain, stageType, dtermLowpass);
             for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                biquadFilterInitLPF(&dtermLowpass[axis].biquadFilter, dterm_lowpass_hz, targetPidLooptime);
+                pidBiquadFilterInitLPF(&dtermLowpass[axis].biquadFilter, dterm_lowpass_hz, targetPidLooptime, keepLowpassState);
             }
+            filterChainAdd(&dtermFilterChain, stageType, dtermLowpass, sizeof(dtermLowpass_t));
             break;
+        }
         default:
-            dtermLowpassApplyFn = nullFilterApply;
             break;
         }
-    } else {
-        dtermLowpassApplyFn = nullFilterApply;
     }
 
     //2nd Dterm Lowpass Filter
-    if (pidProfile->dterm_lowpass2_hz == 0 || pidProfile->dterm_lowpass2_hz > pidFrequencyNyquist) {
-    	dtermLowpass2ApplyFn = nullFilterApply;
-    } else {
+    if (pidProfile->dterm_lowpass2_hz != 0 && pidProfile->dterm_lowpass2_hz <= pidFrequencyNyquist) {
         switch (pidProfile->dterm_filter2_type) {
-        case FILTER_PT1:
-            dtermLowpass2ApplyFn = (filterApplyFnPtr)pt1FilterApply;
+        case FILTER_PT1: {
+            const bool keepLowpass2State = keepState && pidFilterChainHasStage(&previousDtermChain, FILTER_STAGE_PT1, dtermLowpass2);
             for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                pt1FilterInit(&dtermLowpass2[axis].pt1Filter, pt1FilterGain(pidProfile->dterm_lowpass2_hz, dT));
+                pidPt1FilterInit(&dtermLowpass2[axis].pt1Filter, pt1FilterGain(pidProfile->dterm_lowpass2_hz, dT), keepLowpass2State);
             }
+            filterChainAdd(&dtermFilterChain, FILTER_STAGE_PT1, dtermLowpass2, sizeof(dtermLowpass_t));
             break;
-        case FILTER_BIQUAD:
-            dtermLowpass2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
+        }
+        case FILTER_BIQUAD: {
+            const bool keepLowpass2State = keepState && pidFilterChainHasStage(&previousDtermChain, FILTER_STAGE_BIQUAD, dtermLowpass2);
             for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                biquadFilterInitLPF(&dtermLowpass2[axis].biquadFilter, pidProfile->dterm_lowpass2_hz, targetPidLooptime);
+                pidBiquadFilterInitLPF(&dtermLowpass2[axis].biquadFilter, pidProfile->dterm_lowpass2_hz, targetPidLooptime, keepLowpass2State);
             }
+            filterChainAdd(&dtermFilterChain, FILTER_STAGE_BIQUAD, dtermLowpass2, sizeof(dtermLowpass_t));
             break;
+        }
         default:
-            dtermLowpass2ApplyFn = nullFilterApply;
             break;
         }
     }
 
-    if (pidProfile->yaw_lowpass_hz == 0 || pidProfile->yaw_lowpass_hz > pidFrequencyNyquist) {
+    // The filters inside the axis loop run at the rate of their axis, the D term chain before it at the PID loop rate
+    if (pidProfile->yaw_lowpass_hz == 0 || pidProfile->yaw_lowpass_hz > pidAxisFrequency[FD_YAW] / 2) {
         ptermYawLowpassApplyFn = nullFilterApply;
     } else {
         ptermYawLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-        pt1FilterInit(&ptermYawLowpass, pt1FilterGain(pidProfile->yaw_lowpass_hz, dT));
+        pidPt1FilterInit(&ptermYawLowpass, pt1FilterGain(pidProfile->yaw_lowpass_hz, pidAxisDT[FD_YAW]), keepState && previousYawLowpassApplyFn == ptermYawLowpassApplyFn);
     }
 
 // #if defined(USE_THROTTLE_BOOST)
@@ -471,14 +571,14 @@ void pidInitFilters(const pidProfile_t *pidProfile)
 #if defined(USE_ITERM_RELAX)
     if (itermRelax) {
         for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, dT));
+            pidPt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, pidAxisDT[i]), keepState);
         }
     }
 #endif
 #if defined(USE_ABSOLUTE_CONTROL)
     if (itermRelax) {
         for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            pt1FilterInit(&acLpf[i], pt1FilterGain(acCutoff, dT));
+            pidPt1FilterInit(&acLpf[i], pt1FilterGain(acCutoff, pidAxisDT[i]), keepState);
         }
     }
 #endif
@@ -489,14 +589,16 @@ void pidInitFilters(const pidProfile_t *pidProfile)
     // in-flight adjustments and transition from 0 to > 0 in flight the feature
     // won't work because the filter wasn't initialized.
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        biquadFilterInitLPF(&dMinRange[axis], D_MIN_RANGE_HZ, targetPidLooptime);
-        pt1FilterInit(&dMinLowpass[axis], pt1FilterGain(D_MIN_LOWPASS_HZ, dT));
+        pidBiquadFilterInitLPF(&dMinRange[axis], D_MIN_RANGE_HZ, pidAxisLooptime[axis], keepState);
+        pidPt1FilterInit(&dMinLowpass[axis], pt1FilterGain(D_MIN_LOWPASS_HZ, pidAxisDT[axis]), keepState);
      }
 #endif
+
+    pidPt1FilterInit(&tailHeadspeedAccelLpf, pt1FilterGain(TAIL_HEADSPEED_ACCEL_CUTOFF_HZ, pidAxisDT[FD_YAW]), keepState);
 #if defined(USE_AIRMODE_LPF)
     if (pidProfile->transient_throttle_limit) {
-        pt1FilterInit(&airmodeThrottleLpf1, pt1FilterGain(7.0f, dT));
-        pt1FilterInit(&airmodeThrottleLpf2, pt1FilterGain(20.0f, dT));
+        pidPt1FilterInit(&airmodeThrottleLpf1, pt1FilterGain(7.0f, dT), keepState);
+        pidPt1FilterInit(&airmodeThrottleLpf2, pt1FilterGain(20.0f, dT), keepState);
     }
 #endif
 
@@ -505,19 +607,16 @@ void pidInitFilters(const pidProfile_t *pidProfile)
     ffBoostFactor = (float)pidProfile->ff_boost / 10.0f;
     ffSpikeLimitInverse = pidProfile->ff_spike_limit ? 1.0f / ((float)pidProfile->ff_spike_limit / 10.0f) : 0.0f;
     
-    // HF3D
-    // Collective input impulse high-pass filter.  Setting is for cutoff frequency in Hz * 100.
-    // Calculate similar to pt1FilterGain with cutoff frequency of 0.05Hz (20s)
-    //   RC = 1 / ( 2 * M_PI_FLOAT * f_cut);  ==> RC = 3.183
-    //   k = dT / (RC + dT);                  ==>  k = 0.0000393 for 8kHz
-    collectivePulseFilterGain = dT / (dT + (1 / ( 2 * 3.14159f * (float)pidProfile->collective_ff_impulse_freq / 100.0f)));
-    
+    // HF3D:  Collective impulse high-pass filter and torque model
+    collectiveInitConfig(pidProfile);
+    tailHeadspeedKf = pidProfile->yaw_headspeed_ff_gain / 10000.0f;
+
     // HF3D:  Elevator Filter (helicopter tail de-bounce)
-    if (pidProfile->elevator_filter_hz == 0 || pidProfile->elevator_filter_hz > pidFrequencyNyquist) {
+    if (pidProfile->elevator_filter_hz == 0 || pidProfile->elevator_filter_hz > pidAxisFrequency[FD_PITCH] / 2) {
         elevatorFilterLowpassApplyFn = nullFilterApply;
     } else {
         elevatorFilterLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-        pt1FilterInit(&elevatorFilterLowpass, pt1FilterGain(pidProfile->elevator_filter_hz, dT));
+        pidPt1FilterInit(&elevatorFilterLowpass, pt1FilterGain(pidProfile->elevator_filter_hz, pidAxisDT[FD_PITCH]), keepState && previousElevatorApplyFn == elevatorFilterLowpassApplyFn);
     }
 }
 
@@ -531,10 +630,10 @@ void pidInitSetpointDerivativeLpf(uint16_t filterCutoff, uint8_t debugAxis, uint
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
             switch (rcSmoothingFilterType) {
                 case RC_SMOOTHING_DERIVATIVE_PT1:
-                    pt1FilterInit(&setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, dT));
+                    pt1FilterInit(&setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, pidAxisDT[axis]));
                     break;
                 case RC_SMOOTHING_DERIVATIVE_BIQUAD:
-                    biquadFilterInitLPF(&setpointDerivativeBiquad[axis], filterCutoff, targetPidLooptime);
+                    biquadFilterInitLPF(&setpointDerivativeBiquad[axis], filterCutoff, pidAxisLooptime[axis]);
                     break;
             }
         }
@@ -547,10 +646,10 @@ void pidUpdateSetpointDerivativeLpf(uint16_t filterCutoff)
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
             switch (rcSmoothingFilterType) {
                 case RC_SMOOTHING_DERIVATIVE_PT1:
-                    pt1FilterUpdateCutoff(&setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, dT));
+                    pt1FilterUpdateCutoff(&setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, pidAxisDT[axis]));
                     break;
                 case RC_SMOOTHING_DERIVATIVE_BIQUAD:
-                    biquadFilterUpdateLPF(&setpointDerivativeBiquad[axis], filterCutoff, targetPidLooptime);
+                    biquadFilterUpdateLPF(&setpointDerivativeBiquad[axis], filterCutoff, pidAxisLooptime[axis]);
                     break;
             }
         }
@@ -566,6 +665,14 @@ typedef struct pidCoefficient_s {
 } pidCoefficient_t;
 
 static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficientBase[XYZ_AXIS_COUNT];  // profile gains before the headspeed schedule
+
+// Headspeed gain schedule, interpolated linearly between the breakpoints and clamped outside them
+static FAST_RAM_ZERO_INIT uint8_t gainSchedulePoints;
+static FAST_RAM_ZERO_INIT float gainScheduleRpm[PID_GAIN_SCHEDULE_POINTS];
+static FAST_RAM_ZERO_INIT float gainScheduleFactor[PID_GAIN_SCHEDULE_POINTS][XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float gainScheduleSlope[PID_GAIN_SCHEDULE_POINTS][XYZ_AXIS_COUNT];      // factor per rpm up to the next breakpoint
+static FAST_RAM float gainScheduleCurrent[XYZ_AXIS_COUNT] = { 1.0f, 1.0f, 1.0f };
 static FAST_RAM_ZERO_INIT float maxVelocity[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float feedForwardTransition;
 static FAST_RAM_ZERO_INIT float levelGain, horizonGain, horizonTransition, horizonCutoffDegrees, horizonFactorRatio;
@@ -591,6 +698,62 @@ static FAST_RAM_ZERO_INIT bool useIntegratedYaw;
 static FAST_RAM_ZERO_INIT uint8_t integratedYawRelax;
 #endif
 
+// HF3D:  Smith predictor style compensation of the swash and tail servo latency.
+//  The actuator is modelled as gain, first order lag and dead time. The model output without the
+//  dead time minus the same output delayed is the rate change that is already commanded but not yet
+//  visible on the gyro. It is added to the measured rate so P, I and D do not react to it again.
+#define SMITH_PREDICTOR_BUFFER_SIZE 32  // delayed model samples, decimated to span the dead time
+
+typedef struct smithPredictor_s {
+    bool enabled;
+    float gain;
+    float lagK;
+    float model;                        // predicted rate without the dead time
+    float delayed[SMITH_PREDICTOR_BUFFER_SIZE];
+    uint8_t length;
+    uint8_t index;
+    uint8_t stride;
+    uint8_t strideCount;
+} smithPredictor_t;
+
+static FAST_RAM_ZERO_INIT smithPredictor_t smithPredictor[XYZ_AXIS_COUNT];
+
+static void smithPredictorInit(smithPredictor_t *smith, uint8_t delayMs, uint8_t lagMs, uint16_t gain, uint32_t looptime)
+{
+    const uint32_t delayCycles = looptime ? (delayMs * 1000) / looptime : 0;
+
+    smith->enabled = (delayCycles > 0);
+    if (!smith->enabled) {
+        return;
+    }
+
+    const uint8_t stride = (delayCycles + SMITH_PREDICTOR_BUFFER_SIZE - 1) / SMITH_PREDICTOR_BUFFER_SIZE;
+    const uint8_t length = MAX(delayCycles / stride, 1U);
+    if (smith->stride != stride || smith->length != length) {
+        // the delay line only restarts when its timing changes
+        memset(smith, 0, sizeof(*smith));
+        smith->stride = stride;
+        smith->length = length;
+    }
+    smith->enabled = true;
+    smith->gain = gain / 100.0f;
+    smith->lagK = pt1FilterGain(1000.0f / (2.0f * M_PIf * MAX(lagMs, 1)), looptime * 1e-6f);
+}
+
+static FAST_CODE float smithPredictorApply(smithPredictor_t *smith, float output)
+{
+    smith->model += smith->lagK * (smith->gain * output - smith->model);
+
+    const float delayedModel = smith->delayed[smith->index];
+    if (++smith->strideCount >= smith->stride) {
+        smith->strideCount = 0;
+        smith->delayed[smith->index] = smith->model;
+        smith->index = (smith->index + 1) % smith->length;
+    }
+
+    return smith->model - delayedModel;
+}
+
 void pidResetIterm(void)
 {
     for (int axis = 0; axis < 3; axis++) {
@@ -625,8 +788,7 @@ FAST_RAM_ZERO_INIT float thrustLinearizationB;
 
 #ifdef USE_DYN_LPF
 static FAST_RAM uint8_t dynLpfFilter = DYN_LPF_NONE;
-static FAST_RAM_ZERO_INIT uint16_t dynLpfMin;
-static FAST_RAM_ZERO_INIT uint16_t dynLpfMax;
+static uint16_t dynLpfCutoff[DYN_LPF_STEPS + 1];
 #endif
 
 #ifdef USE_D_MIN
@@ -640,26 +802,151 @@ static FAST_RAM_ZERO_INIT ffInterpolationType_t ffFromInterpolatedSetpoint;
 #endif
 
 // HF3D
-static FAST_RAM_ZERO_INIT uint16_t rescueCollective;
-static FAST_RAM_ZERO_INIT uint16_t rescueCollectiveBoost;
-uint8_t rescueDelay = 35;   
-static 	FAST_RAM_ZERO_INIT uint16_t 	rescueDelayTarget; 
-static 	FAST_RAM_ZERO_INIT uint16_t 	rescueDelayCurrent = 0;
-static 	bool	rescue_Invert = false;
 
-void pidInitConfig(const pidProfile_t *pidProfile)
+// Per-axis stages of the PID loop that only change with flight modes, mode switches or the profile
+#define PID_PLAN_LEVEL              (1 << 0)    // setpoint from the self-level controller
+#define PID_PLAN_RESCUE_YAW_HOLD    (1 << 1)    // yaw stick ignored while the rescue is levelling
+#define PID_PLAN_ACRO_TRAINER       (1 << 2)
+#define PID_PLAN_FLAT_PIRO          (1 << 3)    // roll/pitch compensation from the yaw setpoint
+#define PID_PLAN_ITERM_RELAX        (1 << 4)
+#define PID_PLAN_ELEVATOR_FILTER    (1 << 5)
+
+// Rebuilt by pidPlanUpdate() when one of its inputs changes, so the per-axis loop only tests flags
+typedef struct pidPlan_s {
+    bool valid;
+    uint16_t flightModeFlags;
+    bool crashRecovery;
+    const pidProfile_t *pidProfile;
+
+    uint8_t axis[XYZ_AXIS_COUNT];   // PID_PLAN_* stages enabled on each axis
+    bool levelMode;
+    bool errorDecayAlways;
+    float flatPiroGain;
+} pidPlan_t;
+
+static FAST_RAM_ZERO_INIT pidPlan_t pidPlan;
+
+static void pidInitGainSchedule(const pidProfile_t *pidProfile)
+{
+    gainSchedulePoints = 0;
+    for (int i = 0; i < PID_GAIN_SCHEDULE_POINTS; i++) {
+        const uint16_t rpm = pidProfile->gain_schedule_rpm[i];
+        if (rpm == 0 || (i > 0 && rpm <= pidProfile->gain_schedule_rpm[i - 1])) {
+            break;
+        }
+        gainScheduleRpm[i] = rpm;
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            gainScheduleFactor[i][axis] = pidProfile->gain_schedule_percent[axis][i] / 100.0f;
+        }
+        gainSchedulePoints++;
+    }
+
+    for (int i = 0; i < gainSchedulePoints; i++) {
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            if (i + 1 < gainSchedulePoints) {
+                gainScheduleSlope[i][axis] = (gainScheduleFactor[i + 1][axis] - gainScheduleFactor[i][axis]) / (gainScheduleRpm[i + 1] - gainScheduleRpm[i]);
+            } else {
+                gainScheduleSlope[i][axis] = 0.0f;
+            }
+        }
+    }
+
+    if (!gainSchedulePoints) {
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            gainScheduleCurrent[axis] = 1.0f;
+        }
+    }
+}
+
+// Scale the PIDF coefficients with the headspeed. Without a headspeed reading the last factors are held,
+// so a telemetry dropout does not step the gains.
+static FAST_CODE void pidUpdateGainSchedule(void)
+{
+    if (gainSchedulePoints && headspeed > 0.0f) {
+        int i = gainSchedulePoints - 1;
+        while (i > 0 && headspeed < gainScheduleRpm[i]) {
+            i--;
+        }
+        const float rpmDelta = MAX(headspeed - gainScheduleRpm[i], 0.0f);
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            gainScheduleCurrent[axis] = gainScheduleFactor[i][axis] + gainScheduleSlope[i][axis] * rpmDelta;
+        }
+    }
+
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        const float factor = gainScheduleCurrent[axis];
+        pidCoefficient[axis].Kp = pidCoefficientBase[axis].Kp * factor;
+        pidCoefficient[axis].Ki = pidCoefficientBase[axis].Ki * factor;
+        pidCoefficient[axis].Kd = pidCoefficientBase[axis].Kd * factor;
+        pidCoefficient[axis].Kf = pidCoefficientBase[axis].Kf * factor;
+    }
+}
+
+// One PIDF coefficient of one axis from the profile, so an in-flight adjustment only recomputes what it changed.
+// The base holds every correction of the profile gain, the scheduled coefficient is the base times the headspeed factor.
+void pidInitGain(const pidProfile_t *pidProfile, int axis, pidGain_e gain)
+{
+    // Scale down Roll & Pitch axis PID terms for helicopters.  Leave Yaw axis alone.
+    const bool yaw = (axis == FD_YAW);
+    pidCoefficient_t *base = &pidCoefficientBase[axis];
+    const float factor = gainScheduleCurrent[axis];
+
+    switch (gain) {
+    case PID_GAIN_P:
+        base->Kp = PTERM_SCALE * pidProfile->pid[axis].P / (yaw ? 1.0f : 10.0f);
+        pidCoefficient[axis].Kp = base->Kp * factor;
+        break;
+    case PID_GAIN_I:
+        base->Ki = ITERM_SCALE * pidProfile->pid[axis].I / (yaw ? 1.0f : 5.0f);
+        break;
+    case PID_GAIN_D:
+        base->Kd = DTERM_SCALE * pidProfile->pid[axis].D / (yaw ? 1.0f : 10.0f);
+        pidCoefficient[axis].Kd = base->Kd * factor;
+        break;
+    case PID_GAIN_F:
+        base->Kf = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
+        pidCoefficient[axis].Kf = base->Kf * factor;
+        break;
+    }
+
+#if defined(USE_ABSOLUTE_CONTROL)
+    // The I correction follows P, and goes into the base so pidUpdateGainSchedule() keeps it
+    if (gain == PID_GAIN_P || gain == PID_GAIN_I) {
+        const float iCorrection = -acGain * PTERM_SCALE / ITERM_SCALE * base->Kp;
+        base->Ki = MAX(0.0f, ITERM_SCALE * pidProfile->pid[axis].I / (yaw ? 1.0f : 5.0f) + iCorrection);
+    }
+#endif
+
+    if (gain == PID_GAIN_P || gain == PID_GAIN_I) {
+        pidCoefficient[axis].Ki = base->Ki * factor;
+    }
+}
+
+void pidInitFeedForwardTransition(const pidProfile_t *pidProfile)
 {
     if (pidProfile->feedForwardTransition == 0) {
         feedForwardTransition = 0;
     } else {
         feedForwardTransition = 100.0f / pidProfile->feedForwardTransition;
     }
+}
+
+void pidInitLevelGains(const pidProfile_t *pidProfile)
+{
+    levelGain = pidProfile->pid[PID_LEVEL].P / 10.0f;
+    horizonGain = pidProfile->pid[PID_LEVEL].I / 10.0f;
+    horizonTransition = (float)pidProfile->pid[PID_LEVEL].D;
+}
+
+void pidInitConfig(const pidProfile_t *pidProfile)
+{
+    pidInitFeedForwardTransition(pidProfile);
+
+    pidInitGainSchedule(pidProfile);
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        // Scale down Roll & Pitch axis PID terms for helicopters.  Leave Yaw axis alone.
-        pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P / ((axis == FD_YAW) ? 1.0f : 10.0f);
-        pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I / ((axis == FD_YAW) ? 1.0f : 5.0f);
-        pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D / ((axis == FD_YAW) ? 1.0f : 10.0f);
-        pidCoefficient[axis].Kf = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
+        for (int gain = PID_GAIN_P; gain <= PID_GAIN_F; gain++) {
+            pidInitGain(pidProfile, axis, gain);
+        }
     }
     
     // HF3D:  Yaw integral gain does NOT need boosted on a helicopter.
@@ -670,14 +957,13 @@ void pidInitConfig(const pidProfile_t *pidProfile)
         // pidCoefficient[FD_YAW].Ki *= 2.5f;
     // }
 
-    levelGain = pidProfile->pid[PID_LEVEL].P / 10.0f;
-    horizonGain = pidProfile->pid[PID_LEVEL].I / 10.0f;
-    horizonTransition = (float)pidProfile->pid[PID_LEVEL].D;
+    pidInitLevelGains(pidProfile);
     horizonTiltExpertMode = pidProfile->horizon_tilt_expert_mode;
     horizonCutoffDegrees = (175 - pidProfile->horizon_tilt_effect) * 1.8f;
     horizonFactorRatio = (100 - pidProfile->horizon_tilt_effect) * 0.01f;
-    maxVelocity[FD_ROLL] = maxVelocity[FD_PITCH] = pidProfile->rateAccelLimit * 100 * dT;
-    maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * dT;
+    maxVelocity[FD_ROLL] = pidProfile->rateAccelLimit * 100 * pidAxisDT[FD_ROLL];
+    maxVelocity[FD_PITCH] = pidProfile->rateAccelLimit * 100 * pidAxisDT[FD_PITCH];
+    maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * pidAxisDT[FD_YAW];
     itermWindupPointInv = 1.0f;
     if (pidProfile->itermWindupPointPercent < 100) {
         const float itermWindupPoint = pidProfile->itermWindupPointPercent / 100.0f;
@@ -730,8 +1016,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     acErrorLimit = (float)pidProfile->abs_control_error_limit;
     acCutoff = (float)pidProfile->abs_control_cutoff;
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        float iCorrection = -acGain * PTERM_SCALE / ITERM_SCALE * pidCoefficient[axis].Kp;
-        pidCoefficient[axis].Ki = MAX(0.0f, pidCoefficient[axis].Ki + iCorrection);
+        pidInitGain(pidProfile, axis, PID_GAIN_I);
     }
 #endif
 
@@ -751,8 +1036,9 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     } else {
         dynLpfFilter = DYN_LPF_NONE;
     }
-    dynLpfMin = pidProfile->dyn_lpf_dterm_min_hz;
-    dynLpfMax = pidProfile->dyn_lpf_dterm_max_hz;
+    for (int step = 0; step <= DYN_LPF_STEPS; step++) {
+        dynLpfCutoff[step] = MAX(step * pidProfile->dyn_lpf_dterm_max_hz / DYN_LPF_STEPS, pidProfile->dyn_lpf_dterm_min_hz);
+    }
 #endif
 
 #ifdef USE_INTEGRATED_YAW_CONTROL
@@ -777,7 +1063,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
         }
     }
     dMinGyroGain = pidProfile->d_min_gain * D_MIN_GAIN_FACTOR / D_MIN_LOWPASS_HZ;
-    dMinSetpointGain = pidProfile->d_min_gain * D_MIN_SETPOINT_GAIN_FACTOR * pidProfile->d_min_advance * pidFrequency / (100 * D_MIN_LOWPASS_HZ);
+    dMinSetpointGain = pidProfile->d_min_gain * D_MIN_SETPOINT_GAIN_FACTOR * pidProfile->d_min_advance / (100 * D_MIN_LOWPASS_HZ);
     // lowpass included inversely in gain since stronger lowpass decreases peak effect
 #endif
 #if defined(USE_AIRMODE_LPF)
@@ -790,9 +1076,13 @@ void pidInitConfig(const pidProfile_t *pidProfile)
 #endif
 
     // HF3D
-    rescueCollective = pidProfile->rescue_collective;
-	rescueCollectiveBoost = pidProfile->rescue_collective_boost;
-	rescueDelay = pidProfile->rescue_delay;
+    rescueInitConfig(pidProfile);
+
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        smithPredictorInit(&smithPredictor[axis], pidProfile->smith_delay_ms[axis], pidProfile->smith_lag_ms[axis], pidProfile->smith_gain[axis], pidAxisLooptime[axis]);
+    }
+
+    pidPlan.valid = false;
 }
 
 void pidInit(const pidProfile_t *pidProfile)
@@ -801,6 +1091,10 @@ void pidInit(const pidProfile_t *pidProfile)
     pidInitFilters(pidProfile);
     pidInitConfig(pidProfile);
 
+    // HF3D:  The governor runs decimated from the PID loop, its ramps follow the loop rate
+    governorInit();
+    tailMotorInit();
+
     // HF3D:  Setup our PID Delay Compensation Alpha multiplier with a maximum of 0.10 and a minimum of 0.001
     //  280 samples ==> 0.0036 would give the average of the last 280 samples of control output = subtracted off the output
     //  2.5x average is where you probably want to be... around 0.009, or a setting of 9
@@ -897,50 +1191,17 @@ STATIC_UNIT_TESTED float calcHorizonLevelStrength(void)
 STATIC_UNIT_TESTED float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, float currentPidSetpoint) {
 
     if (FLIGHT_MODE(ANGLE_MODE)) {
-        // Angle mode is now rescue mode.
-        float errorAngle = 0.0f;
-
-        // -90 Pitch is straight up and +90 is straight down
-        // We are always pitching to "zero" whether up-right or inverted
-        //   but the control direction needed to get to up-right is different than inverted
-        // Determine if we're closer to up-right or inverted by checking for abs(roll attitude) > 90
-        if ((((attitude.raw[FD_ROLL] - angleTrim->raw[FD_ROLL]) / 10.0f) > (90.0f)) &! rescue_Invert) {
-			// Rolled right closer to inverted, continue to roll right to inverted (+180 degrees)
-            if (axis == FD_PITCH) {
-                errorAngle = 0.0f + ((attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f);
-            } else if (axis == FD_ROLL) {
-                errorAngle = 180.0f - ((attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f);
-            }
-        } else if ((((attitude.raw[FD_ROLL] - angleTrim->raw[FD_ROLL]) / 10.0f) < (-90.0f)) &! rescue_Invert) {
-            // Rolled left closer to inverted, continue to roll left to inverted (-180 degrees)
-			if (axis == FD_PITCH) {
-                errorAngle = 0.0f + ((attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f);
-            } else if (axis == FD_ROLL) {
-                errorAngle = -180.0f - ((attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f);
-            }
-        } else {
-            // We're rolled left or right between -90 and 90, and thus are closer to up-right (0 degrees aka skids down)
-			// If we are inverted and Rescue_Invert active. Pitch will be 0 and roll +-180 so we will roll to upright.....
-			if (axis == FD_PITCH) {
-                errorAngle = 0.0f - ((attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f);
-            } else if (axis == FD_ROLL) {
-                errorAngle = 0.0f - ((attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f);
-            }
-        }
-        // NOTE: With each cycle in ANGLE mode increment the counter. When count is > than RescueDelay 
-		// we set Rescue_Invert to True. This disables the level inverted component. As we should be at pitch near 0 and 
-		// roll near +-180 the heli will start to roll to level
-		
-        currentPidSetpoint = errorAngle * levelGain;   
-        return currentPidSetpoint;
+        // Angle mode is now rescue mode, the setpoint trajectory is built once per cycle by rescueUpdateSetpoint()
+        UNUSED(angleTrim);
+        return rescueGetSetpoint(axis);
 
     } else {
         // Horizon and GPS Rescue modes
         // calculate error angle and limit the angle to the max inclination
         // rcDeflection is in range [-1.0, 1.0]
         float angle = pidProfile->levelAngleLimit * getRcDeflection(axis);
-				
-		// HF3D TODO:  Think about fixing GPS rescue for level/inverted rescue... probably just need to only make it worth it non-inverted rescue
+
+        // GPS rescue only levels upright, it holds the collective flat until the rotor is within lift range
 #ifdef USE_GPS_RESCUE
         angle += gpsRescueAngle[axis] / 100; // ANGLE IS IN CENTIDEGREES
 #endif
@@ -1164,7 +1425,7 @@ STATIC_UNIT_TESTED void rotateItermAndAxisError()
 {
     if (itermRotation
 #if defined(USE_ABSOLUTE_CONTROL)
-        || acGain > 0 || debugMode == DEBUG_AC_ERROR
+        || acGain > 0 || DEBUG_MODE_ACTIVE(DEBUG_AC_ERROR)
 #endif
         ) {
         const float gyroToAngle = dT * RAD;
@@ -1174,7 +1435,7 @@ STATIC_UNIT_TESTED void rotateItermAndAxisError()
             rotationRads[i] = gyro.gyroADCf[i] * gyroToAngle;
         }
 #if defined(USE_ABSOLUTE_CONTROL)
-        if (acGain > 0 || debugMode == DEBUG_AC_ERROR) {
+        if (acGain > 0 || DEBUG_MODE_ACTIVE(DEBUG_AC_ERROR)) {
             // Rotate the calculated absolute control error for each axis based on the 3d rotation sensed by the gryo during the last time step
             rotateVector(axisError, rotationRads);
         }
@@ -1235,7 +1496,7 @@ float FAST_CODE applyRcSmoothingDerivativeFilter(int axis, float pidSetpointDelt
 #if defined(USE_ABSOLUTE_CONTROL)
 STATIC_UNIT_TESTED void applyAbsoluteControl(const int axis, const float gyroRate, float *currentPidSetpoint, float *itermErrorRate)
 {
-    if (acGain > 0 || debugMode == DEBUG_AC_ERROR) {
+    if (acGain > 0 || DEBUG_MODE_ACTIVE(DEBUG_AC_ERROR)) {
         // Apply low-pass filter that was initialized with the pidProfile->abs_control_cutoff frequency to the roll rate command on this axis
         const float setpointLpf = pt1FilterApply(&acLpf[axis], *currentPidSetpoint);
         // Create high-pass filter by subtracting the commanded roll rate from the low-pass filtered version of itself
@@ -1266,8 +1527,8 @@ STATIC_UNIT_TESTED void applyAbsoluteControl(const int axis, const float gyroRat
             } else {
                 acErrorRate = acErrorRate2;
             }
-            if (fabsf(acErrorRate * dT) > fabsf(axisError[axis]) ) {
-                acErrorRate = -axisError[axis] * pidFrequency;
+            if (fabsf(acErrorRate * pidAxisDT[axis]) > fabsf(axisError[axis]) ) {
+                acErrorRate = -axisError[axis] * pidAxisFrequency[axis];
             }
         } else {
             // Roll rate sensed by gyro was outside of the window around the user's commanded Setpoint
@@ -1286,7 +1547,7 @@ STATIC_UNIT_TESTED void applyAbsoluteControl(const int axis, const float gyroRat
 					acErrorRate = 0;
 				}
 			}
-            axisError[axis] = constrainf(axisError[axis] + acErrorRate * dT,
+            axisError[axis] = constrainf(axisError[axis] + acErrorRate * pidAxisDT[axis],
                 -acErrorLimit, acErrorLimit);
             // Apply a proportional gain (abs_control_gain) to get a desired amount of correction
             //  Limit the total correction to the range defined by pidProfile->abs_control_limit
@@ -1416,15 +1677,72 @@ float pidGetAirmodeThrottleOffset()
 // Called from subTaskPidController() in pid.c
 //   Runs at equal to or slower than the gyro loop update frequency
 static FAST_RAM_ZERO_INIT float yawPidSetpoint;         // HF3D:  Hold the previous corrected Yaw setpoint for flat piro compensation
-static FAST_RAM_ZERO_INIT float collectiveStickPercent;        // HF3D
-static FAST_RAM_ZERO_INIT float collectiveStickLPF;            // HF3D:  Collective stick values
-static FAST_RAM_ZERO_INIT float collectiveStickHPF;
+
+static void pidPlanBuild(const pidProfile_t *pidProfile)
+{
+    pidPlan.valid = true;
+    pidPlan.flightModeFlags = flightModeFlags;
+    pidPlan.crashRecovery = inCrashRecoveryMode;
+    pidPlan.pidProfile = pidProfile;
+
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        pidPlan.axis[axis] = 0;
+    }
+
+#if defined(USE_ACC)
+    pidPlan.levelMode = FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE) || FLIGHT_MODE(GPS_RESCUE_MODE);
+    if (pidPlan.levelMode) {
+        pidPlan.axis[FD_ROLL] |= PID_PLAN_LEVEL;
+        pidPlan.axis[FD_PITCH] |= PID_PLAN_LEVEL;
+    }
+    if (FLIGHT_MODE(ANGLE_MODE)) {
+        pidPlan.axis[FD_YAW] |= PID_PLAN_RESCUE_YAW_HOLD;
+    }
+#endif
+
+#ifdef USE_ACRO_TRAINER
+    if (acroTrainerActive && !inCrashRecoveryMode) {
+        pidPlan.axis[FD_ROLL] |= PID_PLAN_ACRO_TRAINER;
+        pidPlan.axis[FD_PITCH] |= PID_PLAN_ACRO_TRAINER;
+    }
+#endif
+
+    if (throttleBoost > 1.0f) {
+        pidPlan.flatPiroGain = 1.0f / throttleBoost;
+        pidPlan.axis[FD_ROLL] |= PID_PLAN_FLAT_PIRO;
+        pidPlan.axis[FD_PITCH] |= PID_PLAN_FLAT_PIRO;
+    }
+
+#if defined(USE_ITERM_RELAX)
+    if (!inCrashRecoveryMode) {
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            pidPlan.axis[axis] |= PID_PLAN_ITERM_RELAX;
+        }
+    }
+#endif
+
+    if (pidProfile->elevator_filter_gain > 0) {
+        pidPlan.axis[FD_PITCH] |= PID_PLAN_ELEVATOR_FILTER;
+    }
+
+    pidPlan.errorDecayAlways = pidProfile->error_decay_always;
+}
+
+static FAST_CODE void pidPlanUpdate(const pidProfile_t *pidProfile)
+{
+    if (!pidPlan.valid || pidPlan.flightModeFlags != flightModeFlags
+        || pidPlan.crashRecovery != inCrashRecoveryMode || pidPlan.pidProfile != pidProfile) {
+        pidPlanBuild(pidProfile);
+    }
+}
 
 void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTimeUs)
 {
     static float previousGyroRateDterm[XYZ_AXIS_COUNT];
+    static FAST_RAM_ZERO_INIT float gyroRateSum[XYZ_AXIS_COUNT];
+    static FAST_RAM_ZERO_INIT float gyroRateDtermSum[XYZ_AXIS_COUNT];
 #ifdef USE_INTERPOLATED_SP
-    static FAST_RAM_ZERO_INIT uint32_t lastFrameNumber;
+    static FAST_RAM_ZERO_INIT uint32_t lastFrameNumber[XYZ_AXIS_COUNT];
 #endif
 
 #if defined(USE_ACC)
@@ -1453,9 +1771,16 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
     const bool yawSpinActive = gyroYawSpinDetected();
 #endif
 
+    pidPlanUpdate(pidProfile);
+
+    // HF3D:  Blade thrust varies with RPM^2, follow the headspeed with the scheduled gains
+    if (gainSchedulePoints) {
+        pidUpdateGainSchedule();
+    }
+
 #if defined(USE_ACC)
     const bool gpsRescueIsActive = FLIGHT_MODE(GPS_RESCUE_MODE);
-    const bool levelModeActive = FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE) || gpsRescueIsActive;
+    const bool levelModeActive = pidPlan.levelMode;
 
     // Keep track of when we entered a self-level mode so that we can
     // add a guard time before crash recovery can activate.
@@ -1488,10 +1813,8 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
     float gyroRateDterm[XYZ_AXIS_COUNT];
     for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
         gyroRateDterm[axis] = gyro.gyroADCf[axis];
-        gyroRateDterm[axis] = dtermNotchApplyFn((filter_t *) &dtermNotch[axis], gyroRateDterm[axis]);
-        gyroRateDterm[axis] = dtermLowpassApplyFn((filter_t *) &dtermLowpass[axis], gyroRateDterm[axis]);
-        gyroRateDterm[axis] = dtermLowpass2ApplyFn((filter_t *) &dtermLowpass2[axis], gyroRateDterm[axis]);
     }
+    filterChainApply(&dtermFilterChain, gyroRateDterm);
 
     // HF3D:  iTermRotation acts as FFF Pirouette Compensation on a heli.
     //   Will not work properly unless the hover roll compensation is outside of the roll integral in the PID controller.
@@ -1501,34 +1824,32 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
     rpmFilterUpdate();
 #endif
 
-#ifdef USE_INTERPOLATED_SP
-    bool newRcFrame = false;
-    if (lastFrameNumber != getRcFrameNumber()) {
-        lastFrameNumber = getRcFrameNumber();
-        newRcFrame = true;
+#if defined(USE_ACC)
+    // HF3D:  Rescue state is advanced by rescueUpdate() at RC rate, the setpoints follow at PID rate
+    const bool rescueUpright = rescueIsUpright();
+    if (FLIGHT_MODE(ANGLE_MODE)) {
+        rescueUpdateSetpoint(angleTrim);
     }
 #endif
 
-    // HF3D TODO:  Roll/Pitch PID compensation based on main rotor RPM
-    //  Blade thrust varies with RPM^2.  Servos should need to move further at lower headspeeds to offset a given rotational error?
-    //  Compensating PID gains with RPM (possibly throttle as a backup) might be helpful in reducing the need for banks of gains for each headspeed.
-    //  Yaw axis PID RPM compensation would depend on whether it was a motor driven or variable pitch tail?
-
     // ----------PID controller----------
     for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+        // HF3D:  A decimated axis runs on the mean gyro of its period, the boxcar is the anti-alias filter
+        //  matched to its rate, with a null at every multiple of it. The outputs hold in between.
+        gyroRateSum[axis] += gyro.gyroADCf[axis];
+        gyroRateDtermSum[axis] += gyroRateDterm[axis];
+        if (++pidAxisCount[axis] < pidAxisDenom[axis]) {
+            continue;
+        }
+        const float axisGyroRate = gyroRateSum[axis] / pidAxisCount[axis];
+        const float axisGyroRateDterm = gyroRateDtermSum[axis] / pidAxisCount[axis];
+        gyroRateSum[axis] = 0;
+        gyroRateDtermSum[axis] = 0;
+        pidAxisCount[axis] = 0;
 
-		if (!FLIGHT_MODE(ANGLE_MODE)||(rescueDelay > 30)) { //HF3D Non inverted rescue. More than 3 seconds disables non inverted rescue
-			rescueDelayCurrent = 0;
-			rescue_Invert = false;
-			rescueDelayTarget = rescueDelay/dT/5 ; // allow for different loop frequencies.... 
-			// Ummm not really sure why 4kHz rate is 500mS but whatever...    
-		} else {
-			rescueDelayCurrent++;
-			if (rescueDelayCurrent >= rescueDelayTarget) {
-				rescueDelayCurrent = rescueDelayTarget;
-				rescue_Invert = true;				
-			}
-		}
+        const float axisDT = pidAxisDT[axis];
+        const float axisFrequency = pidAxisFrequency[axis];
+        const uint8_t plan = pidPlan.axis[axis];
 
         // Get the user's roll rate command on this axis after expo and other rate modifications have been made
         //  Units are deg/s... maximum set in profile, default max rate is 1998 deg/s
@@ -1538,16 +1859,16 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         }
         // Yaw control is GYRO based, direct sticks control is applied to rate PID
 #if defined(USE_ACC)
-        if (levelModeActive && (axis != FD_YAW)) {
+        if (plan & PID_PLAN_LEVEL) {
             currentPidSetpoint = pidLevel(axis, pidProfile, angleTrim, currentPidSetpoint);
-        } else if (FLIGHT_MODE(ANGLE_MODE) && (axis == FD_YAW) && (!rescue_Invert)) {
+        } else if ((plan & PID_PLAN_RESCUE_YAW_HOLD) && !rescueUpright) {
             // HF3D:  Don't allow user to give yaw input while rescue (angle) mode corrections are occuring
             currentPidSetpoint = 0.0f;
         }
 #endif
 
 #ifdef USE_ACRO_TRAINER
-        if ((axis != FD_YAW) && acroTrainerActive && !inCrashRecoveryMode) {
+        if (plan & PID_PLAN_ACRO_TRAINER) {
             currentPidSetpoint = applyAcroTrainer(axis, angleTrim, currentPidSetpoint);
         }
 #endif // USE_ACRO_TRAINER
@@ -1563,15 +1884,28 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         // HF3D TODO:  Flat pirouette compensation
         //  Compensate for the fact that the main shaft axis is not aligned with the Z axis due to the roll tilt required to compensate for tail blade thrust
         //  Create a wobble of the main shaft axis around the Z axis by adding roll and pitch commands proportional to the yaw rotation rate
-        if (axis == FD_ROLL && throttleBoost > 1.0f) {
-            // HF3D TODO:  Change roll compensation sign based on main motor rotation direction (tail thrust direction)
-            currentPidSetpoint += fabsf(yawPidSetpoint) / throttleBoost;    // Roll compensation direction is same regardless of yaw direction
-        } else if (axis == FD_PITCH && throttleBoost > 1.0f) {
-            currentPidSetpoint += yawPidSetpoint / throttleBoost;          // Pitch compensation direction depends on yaw direction
+        if (plan & PID_PLAN_FLAT_PIRO) {
+            if (axis == FD_ROLL) {
+                // HF3D TODO:  Change roll compensation sign based on main motor rotation direction (tail thrust direction)
+                currentPidSetpoint += fabsf(yawPidSetpoint) * pidPlan.flatPiroGain;    // Roll compensation direction is same regardless of yaw direction
+            } else {
+                currentPidSetpoint += yawPidSetpoint * pidPlan.flatPiroGain;           // Pitch compensation direction depends on yaw direction
+            }
+        }
+
+#ifdef USE_SYSTEM_ID
+        currentPidSetpoint = sysidApply(axis, currentPidSetpoint);
+#endif
+
+        // Rate change already commanded but still inside the actuator delay, from last cycle's output
+        float smithCorrection = 0.0f;
+        if (smithPredictor[axis].enabled) {
+            smithCorrection = smithPredictorApply(&smithPredictor[axis], pidData[axis].Sum);
+            DEBUG_SET(DEBUG_SMITH_PREDICTOR, axis, lrintf(smithCorrection * 10));
         }
 
         // -----calculate error rate
-        const float gyroRate = gyro.gyroADCf[axis]; // Process variable from gyro output in deg/sec
+        const float gyroRate = axisGyroRate + smithCorrection; // Process variable from gyro output in deg/sec
         float errorRate = currentPidSetpoint - gyroRate; // r - y
 /* #if defined(USE_ACC)
         handleCrashRecovery(
@@ -1586,7 +1920,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
 #endif
 
 #if defined(USE_ITERM_RELAX)
-        if (!inCrashRecoveryMode) {
+        if (plan & PID_PLAN_ITERM_RELAX) {
             // Absolute Control is applied after iTermRelax as part of this function
             applyItermRelax(axis, previousIterm, gyroRate, &itermErrorRate, &currentPidSetpoint);
             errorRate = currentPidSetpoint - gyroRate;
@@ -1625,13 +1959,13 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
             }
         }
         // dynCi = dT if airmode disabled and iterm_windup = 100
-        pidData[axis].I = constrainf(previousIterm + Ki * itermErrorRate * dynCi, -itermLimit, itermLimit);
+        pidData[axis].I = constrainf(previousIterm + Ki * itermErrorRate * dynCi * pidAxisDenom[axis], -itermLimit, itermLimit);
         
         // Decay accumulated error if appropriate
 #define signorzero(x) ((x < 0) ? -1 : (x > 0) ? 1 : 0)
-        if (!isHeliSpooledUp() || pidProfile->error_decay_always) {
+        if (pidPlan.errorDecayAlways || !isHeliSpooledUp()) {
             // Calculate number of degrees to remove from the accumulated error
-            const float decayFactor = pidProfile->error_decay_rate * dT;
+            const float decayFactor = pidProfile->error_decay_rate * axisDT;
 
             pidData[axis].I -= signorzero(pidData[axis].I) * decayFactor * Ki;
 #if defined(USE_ABSOLUTE_CONTROL)
@@ -1643,7 +1977,10 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         float pidSetpointDelta = 0;
 #ifdef USE_INTERPOLATED_SP
         if (ffFromInterpolatedSetpoint) {
-            pidSetpointDelta = interpolatedSpApply(axis, newRcFrame, ffFromInterpolatedSetpoint);
+            const bool newRcFrame = (lastFrameNumber[axis] != getRcFrameNumber());
+            lastFrameNumber[axis] = getRcFrameNumber();
+            // the interpolated delta is per PID loop
+            pidSetpointDelta = interpolatedSpApply(axis, newRcFrame, ffFromInterpolatedSetpoint, currentTimeUs) * pidAxisDenom[axis];
         } else {
             pidSetpointDelta = currentPidSetpoint - previousPidSetpoint[axis];
         }
@@ -1666,7 +2003,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
             // calculated deltaT whenever another task causes the PID
             // loop execution to be delayed.
             const float delta =
-                - (gyroRateDterm[axis] - previousGyroRateDterm[axis]) * pidFrequency;
+                - (axisGyroRateDterm + smithCorrection - previousGyroRateDterm[axis]) * axisFrequency;
 
 /* #if defined(USE_ACC)
             if (cmpTimeUs(currentTimeUs, levelModeStartTimeUs) > CRASH_RECOVERY_DETECTION_DELAY_US) {
@@ -1679,7 +2016,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
             if (dMinPercent[axis] > 0) {
                 float dMinGyroFactor = biquadFilterApply(&dMinRange[axis], delta);
                 dMinGyroFactor = fabsf(dMinGyroFactor) * dMinGyroGain;
-                const float dMinSetpointFactor = (fabsf(pidSetpointDelta)) * dMinSetpointGain;
+                const float dMinSetpointFactor = (fabsf(pidSetpointDelta)) * axisFrequency * dMinSetpointGain;
                 dMinFactor = MAX(dMinGyroFactor, dMinSetpointFactor);
                 dMinFactor = dMinPercent[axis] + (1.0f - dMinPercent[axis]) * dMinFactor;
                 dMinFactor = pt1FilterApply(&dMinLowpass[axis], dMinFactor);
@@ -1697,7 +2034,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         } else {
             pidData[axis].D = 0;
         }
-        previousGyroRateDterm[axis] = gyroRateDterm[axis];
+        previousGyroRateDterm[axis] = axisGyroRateDterm + smithCorrection;
 
         // -----calculate feedforward component
 #ifdef USE_ABSOLUTE_CONTROL
@@ -1720,7 +2057,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
             // Apply elevator filter to stop bounces due to sudden stops on the pitch axis near zero deg/s
             //  These do not seem to be related to I term or Absolute control, or really any of the PID terms
             //  High feedforward gain seems to make them worse due to the aggressive nature of the return to zero.
-            if (axis == FD_PITCH && pidProfile->elevator_filter_gain > 0) {
+            if (plan & PID_PLAN_ELEVATOR_FILTER) {
                 
                 float elevatorSetpointLPF = elevatorFilterLowpassApplyFn((filter_t *) &elevatorFilterLowpass, currentPidSetpoint);
                 
@@ -1756,7 +2093,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
                 DEBUG_SET(DEBUG_AC_CORRECTION, 3, lrintf(eleOffset));
             } else if (axis == FD_YAW) {
                 // Stick delta feedforward for the yaw axis.
-                feedForward = feedforwardGain * transition * pidSetpointDelta * pidFrequency;    //  Kf * 1 * 20 deg/s * 8000
+                feedForward = feedforwardGain * transition * pidSetpointDelta * axisFrequency;    //  Kf * 1 * 20 deg/s * 8000
             }
 
 #ifdef USE_INTERPOLATED_SP
@@ -1776,34 +2113,22 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         
          // HF3D:  Calculate tail feedforward precompensation and add it to the pidSum on the Yaw channel
         if (axis == FD_YAW) {
-            
-            // Calculate absolute value of the percentage of collective stick throw
-            if ((rcCommand[COLLECTIVE] >= 500) || (rcCommand[COLLECTIVE] <= -500)) {
-                collectiveStickPercent = 100.0f;
-            } else {
-                if (rcCommand[COLLECTIVE] >= 0) {
-                    collectiveStickPercent = (rcCommand[COLLECTIVE] * 100.0f) / (PWM_RANGE_MAX - rxConfig()->midrc);
-                } else if (rcCommand[COLLECTIVE] < 0) {
-                    collectiveStickPercent = (rcCommand[COLLECTIVE] * -100.0f) / (rxConfig()->midrc - PWM_RANGE_MIN);
-                }
-            }
-            
-            // Collective pitch impulse feed-forward for the main motor
-            // Run our collectiveStickPercent through a low pass filter
-            collectiveStickLPF = collectiveStickLPF + collectivePulseFilterGain * (collectiveStickPercent - collectiveStickLPF);
-            // Subtract LPF from the original value to get a high pass filter
-            // HPF value will be <60% or so of the collectiveStickPercent, and will be smaller the slower the stick movement is.
-            //  Cutoff frequency determines this action.
-            collectiveStickHPF = collectiveStickPercent - collectiveStickLPF;
+            const collective_t *collective = collectiveGet();
 
             // HF3D TODO:  Negative because of clockwise main rotor spin direction -> CCW body torque on helicopter
             //   Implement a configuration parameter for rotor rotation direction
-            float tailCollectiveFF = -1.0f * collectiveStickPercent * pidProfile->yawColKf / 100.0f;
-            float tailCollectivePulseFF = -1.0f * collectiveStickHPF * pidProfile->yawColPulseKf / 100.0f;
+            float tailCollectiveFF = -1.0f * collective->torque * pidProfile->yawColKf;
+            float tailCollectivePulseFF = -1.0f * collective->pulse * pidProfile->yawColPulseKf / 100.0f;
             float tailBaseThrust = -1.0f * pidProfile->yawBaseThrust / 10.0f;
             
             // Calculate absolute value of the percentage of cyclic stick throw (both combined... but swash ring is the real issue).
 			float tailCyclicFF = -1.0f * servosGetSwashRingValue() * 100.0f * pidProfile->yawCycKf / 100.0f;
+
+            // The motor accelerating the rotor reacts on the body in the same direction as the rotor drag.
+            // Known from headspeed before the gyro sees it, which keeps the yaw I-term out of collective pumps.
+            const float headspeedAccel = pt1FilterApply(&tailHeadspeedAccelLpf, (headspeed - tailHeadspeedPrevious) * axisFrequency);
+            tailHeadspeedPrevious = headspeed;
+            float tailHeadspeedFF = -1.0f * headspeedAccel * tailHeadspeedKf;
             
             // Main motor torque increase from the ESC is proportional to the absolute change in average voltage (NOT percent change in average voltage)
             //     and it is linear with the amount of change.
@@ -1833,7 +2158,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
             // HF3D TODO:  Add a configurable override for this check in case someone wants to run an external governor without passing the throttle signal through the flight controller?
             if ((calculateThrottlePercentAbs() > 15) || (!ARMING_FLAG(ARMED))) {
                 // if disarmed, show the user what they will get regardless of throttle value
-                pidData[FD_YAW].F += tailCollectiveFF + tailCollectivePulseFF + tailBaseThrust + tailCyclicFF;
+                pidData[FD_YAW].F += tailCollectiveFF + tailCollectivePulseFF + tailBaseThrust + tailCyclicFF + tailHeadspeedFF;
             } 
             // HF3D TODO:  Do some integration of the motor driven tail code here for motorCount == 2...
             //   But have to be careful, because if main motor throttle goes near zero then we'll never get the tail back if we're
@@ -1857,8 +2182,8 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         const float pidSum = pidData[axis].P + pidData[axis].I + pidData[axis].D + pidData[axis].F;
 #ifdef USE_INTEGRATED_YAW_CONTROL
         if (axis == FD_YAW && useIntegratedYaw) {
-            pidData[axis].Sum += pidSum * dT * 100.0f;
-            pidData[axis].Sum -= pidData[axis].Sum * integratedYawRelax / 100000.0f * dT / 0.000125f;
+            pidData[axis].Sum += pidSum * axisDT * 100.0f;
+            pidData[axis].Sum -= pidData[axis].Sum * integratedYawRelax / 100000.0f * axisDT / 0.000125f;
         } else
 #endif
         {
@@ -1906,7 +2231,10 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
     } else if (zeroThrottleItermReset) {
         pidResetIterm();
     }
-    
+
+#ifdef USE_SYSTEM_ID
+    sysidUpdate();
+#endif
 }
 
 bool crashRecoveryModeActive(void)
@@ -1922,6 +2250,7 @@ void pidSetAcroTrainerState(bool newState)
             pidAcroTrainerInit();
         }
         acroTrainerActive = newState;
+        pidPlan.valid = false;
     }
 }
 #endif // USE_ACRO_TRAINER
@@ -1941,18 +2270,21 @@ void pidSetAcroTrainerState(bool newState)
 } */
 
 #ifdef USE_DYN_LPF
-void dynLpfDTermUpdate(float throttle)
+// step is 0..DYN_LPF_STEPS, the position of the cutoff between dyn_lpf_dterm_min_hz and dyn_lpf_dterm_max_hz
+void dynLpfDTermUpdate(int step)
 {
     if (dynLpfFilter != DYN_LPF_NONE) {
-        const unsigned int cutoffFreq = fmax(dynThrottle(throttle) * dynLpfMax, dynLpfMin);
+        const unsigned int cutoffFreq = dynLpfCutoff[constrain(step, 0, DYN_LPF_STEPS)];
 
-         if (dynLpfFilter == DYN_LPF_PT1) {
+        if (dynLpfFilter == DYN_LPF_PT1) {
+            const float gain = pt1FilterGain(cutoffFreq, dT);
             for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                pt1FilterUpdateCutoff(&dtermLowpass[axis].pt1Filter, pt1FilterGain(cutoffFreq, dT));
+                pt1FilterUpdateCutoff(&dtermLowpass[axis].pt1Filter, gain);
             }
         } else if (dynLpfFilter == DYN_LPF_BIQUAD) {
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                biquadFilterUpdateLPF(&dtermLowpass[axis].biquadFilter, cutoffFreq, targetPidLooptime);
+            biquadFilterUpdateLPF(&dtermLowpass[FD_ROLL].biquadFilter, cutoffFreq, targetPidLooptime);
+            for (int axis = FD_PITCH; axis < XYZ_AXIS_COUNT; axis++) {
+                biquadFilterCopyCoefficients(&dtermLowpass[axis].biquadFilter, &dtermLowpass[FD_ROLL].biquadFilter);
             }
         }
     }
@@ -1979,26 +2311,15 @@ float pidGetPidFrequency()
     return pidFrequency;
 }
 
-float pidGetCollectiveStickPercent()
-{
-    return collectiveStickPercent;
-}
-
-float pidGetCollectiveStickHPF()
-{
-    return collectiveStickHPF;
-}
-
-uint16_t pidGetRescueCollectiveSetting()
+float pidGetAxisDT(int axis)
 {
-    if (rescue_Invert) {
-		return rescueCollective ;
-	} else {	
-		return constrain( rescueCollective + rescueCollectiveBoost, 50, 500) ;
-	}
+    return pidAxisDT[axis];
 }
 
-float pidGetCollectivePulseFilterGain(void)
+// Scheduled gains of the axis, in pidSum units per deg/s, per deg and per deg/s^2
+void pidGetCoefficients(int axis, float *kp, float *ki, float *kd)
 {
-    return collectivePulseFilterGain;
+    *kp = pidCoefficient[axis].Kp;
+    *ki = pidCoefficient[axis].Ki;
+    *kd = pidCoefficient[axis].Kd;
 }
@@ -27,6 +27,7 @@
 #include "pg/pg.h"
 
 #define MAX_PID_PROCESS_DENOM       16
+#define MAX_PID_AXIS_DENOM          8
 #define PID_CONTROLLER_BETAFLIGHT   1
 #define PID_MIXER_SCALING           1000.0f
 #define PID_SERVO_MIXER_SCALING     0.7f
@@ -48,6 +49,13 @@
 #define ITERM_RELAX_SETPOINT_THRESHOLD 40.0f
 #define ITERM_RELAX_CUTOFF_DEFAULT 20
 
+typedef enum {
+    PID_GAIN_P,
+    PID_GAIN_I,
+    PID_GAIN_D,
+    PID_GAIN_F,
+} pidGain_e;
+
 typedef enum {
     PID_ROLL,
     PID_PITCH,
@@ -104,6 +112,8 @@ typedef enum {
 
 #define MAX_PROFILE_NAME_LENGTH 8u
 
+#define PID_GAIN_SCHEDULE_POINTS 4          // headspeed breakpoints of the gain schedule
+
 typedef struct pidProfile_s {
     uint16_t yaw_lowpass_hz;                // Additional yaw filter when yaw axis too noisy
     uint16_t dterm_lowpass_hz;              // Delta Filter in hz
@@ -180,16 +190,22 @@ typedef struct pidProfile_s {
     uint8_t ff_max_rate_limit;              // Maximum setpoint rate percentage for FF
     uint8_t ff_spike_limit;                 // FF stick extrapolation lookahead period in ms
     uint8_t ff_smooth_factor;               // Amount of smoothing for interpolated FF steps
+    uint8_t ff_prediction;                  // Extrapolate the interpolated FF between RC frames
+    uint8_t ff_lookahead_ms;                // Extra FF prediction time to cover the servo latency
     
     // HF3D parameters
     uint16_t yawColKf;                      // Feedforward for collective into Yaw
     uint16_t yawColPulseKf;                 // Feedforward for collective impulse into Yaw
     uint16_t yawCycKf;                      // Feedforward for cyclic into Yaw
     uint16_t yawBaseThrust;                 // Base thrust for the tail
+    uint8_t yaw_collective_ff_curve;        // Blend of the collective torque model from linear (0) to induced power (100)
+    uint16_t yaw_headspeed_ff_gain;         // Feedforward for the main rotor acceleration reaction torque into Yaw
     uint16_t rescue_collective;             // Collective pitch command when rescue is fully upright
 	uint8_t rescue_collective_boost;        // Collective pitch boost until rescue_delay has expired
 	uint8_t rescue_delay;             		// T/10 before rolling non inverted :if==0, heli will immediately go to upright, 
 											// 30==3s inverted rescue before roll to upright: 35==disabe upright. Will just continue.
+    uint16_t rescue_max_rate;               // Roll/pitch rate limit of the rescue setpoint in deg/s
+    uint16_t rescue_max_accel;              // Roll/pitch acceleration limit of the rescue setpoint in deg/s^2
     uint8_t error_decay_always;             // Always decay accumulated I term and Abs Control error?
     uint8_t error_decay_rate;               // Rate to decay accumulated error in deg/s
     uint16_t collective_ff_impulse_freq;    // Collective input impulse high-pass filter cutoff frequency
@@ -197,6 +213,11 @@ typedef struct pidProfile_s {
     uint8_t elevator_filter_window_time;    // Time in ms that we no longer apply de-bounce inside our window
     uint8_t elevator_filter_window_size;    // Size of the de-bounce window around center stick (0 deg/s) in degrees/second
     uint8_t elevator_filter_hz;             // Low-pass filter cutoff frequency that is applied to our elevator setpoint.  Lower Hz = more delay on stop.
+    uint16_t gain_schedule_rpm[PID_GAIN_SCHEDULE_POINTS];                       // Headspeed breakpoints in rpm, ascending, 0 ends the table
+    uint8_t gain_schedule_percent[XYZ_AXIS_COUNT][PID_GAIN_SCHEDULE_POINTS];    // PIDF gain in percent at each breakpoint
+    uint8_t smith_delay_ms[XYZ_AXIS_COUNT];     // Actuator dead time of the delay compensation model, 0 = off
+    uint8_t smith_lag_ms[XYZ_AXIS_COUNT];       // Actuator first order lag time constant
+    uint16_t smith_gain[XYZ_AXIS_COUNT];        // Rate response in deg/s per 100 units of pidsum
 
 } pidProfile_t;
 
@@ -207,6 +228,9 @@ typedef struct pidConfig_s {
     uint8_t runaway_takeoff_prevention;          // off, on - enables pidsum runaway disarm logic
     uint16_t runaway_takeoff_deactivate_delay;   // delay in ms for "in-flight" conditions before deactivation (successful flight)
     uint8_t runaway_takeoff_deactivate_throttle; // minimum throttle percent required during deactivation phase
+    uint8_t pid_looptime_check;                  // off, warn, auto - checks the PID loop rate fits after boot
+    uint8_t pid_cyclic_denom;               // Roll and pitch run every Nth PID loop
+    uint8_t pid_yaw_denom;                  // Yaw runs every Nth PID loop
 } pidConfig_t;
 
 PG_DECLARE(pidConfig_t, pidConfig);
@@ -237,6 +261,9 @@ void pidStabilisationState(pidStabilisationState_e pidControllerState);
 //void pidSetItermAccelerator(float newItermAccelerator);
 void pidInitFilters(const pidProfile_t *pidProfile);
 void pidInitConfig(const pidProfile_t *pidProfile);
+void pidInitGain(const pidProfile_t *pidProfile, int axis, pidGain_e gain);
+void pidInitFeedForwardTransition(const pidProfile_t *pidProfile);
+void pidInitLevelGains(const pidProfile_t *pidProfile);
 void pidInit(const pidProfile_t *pidProfile);
 void pidCopyProfile(uint8_t dstPidProfileIndex, uint8_t srcPidProfileIndex);
 bool crashRecoveryModeActive(void);
@@ -268,16 +295,13 @@ float pidLevel(int axis, const pidProfile_t *pidProfile,
     const rollAndPitchTrims_t *angleTrim, float currentPidSetpoint);
 float calcHorizonLevelStrength(void);
 #endif
-void dynLpfDTermUpdate(float throttle);
+void dynLpfDTermUpdate(int step);
 void pidSetItermReset(bool enabled);
 float pidGetPreviousSetpoint(int axis);
 float pidGetDT();
 float pidGetPidFrequency();
+float pidGetAxisDT(int axis);
+void pidGetCoefficients(int axis, float *kp, float *ki, float *kd);
 float pidGetFfBoostFactor();
 float pidGetFfSmoothFactor();
 float pidGetSpikeLimitInverse();
-// HF3D
-float pidGetCollectiveStickPercent();
-float pidGetCollectiveStickHPF();
-uint16_t pidGetRescueCollectiveSetting();
-float pidGetCollectivePulseFilterGain();
\ No newline at end of file
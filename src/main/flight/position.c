@@ -50,14 +50,28 @@ typedef enum {
     GPS_ONLY
 } altSource_e;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(positionConfig_t, positionConfig, PG_POSITION, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(positionConfig_t, positionConfig, PG_POSITION, 2);
 
 PG_RESET_TEMPLATE(positionConfig_t, positionConfig,
     .altSource = DEFAULT,
+    .altFusionCutoff = 5,
 );
 
 static int32_t estimatedAltitudeCm = 0;                // in cm
 
+#if defined(USE_BARO) || defined(USE_GPS)
+// baro/GPS altitude the vertical acceleration is fused against
+static float altitudeReferenceCm = 0;
+static bool haveAltitudeReference = false;
+static bool altitudeReferenceReset = true;
+
+// complementary filter state and its critically damped gains
+static float altitudeCm = 0;
+static float climbRateCms = 0;
+static float altitudeGainP = 0;
+static float altitudeGainV = 0;
+#endif
+
 #define BARO_UPDATE_FREQUENCY_40HZ (1000 * 25)
 
 #ifdef USE_VARIO
@@ -138,33 +152,46 @@ void calculateEstimatedAltitude(timeUs_t currentTimeUs)
         baroAltOffset = baroAlt;
         gpsAltOffset = gpsAlt;
         altitudeOffsetSet = true;
+        altitudeReferenceReset = true;
     } else if (!ARMING_FLAG(ARMED) && altitudeOffsetSet) {
         altitudeOffsetSet = false;
+        altitudeReferenceReset = true;
     }
     baroAlt -= baroAltOffset;
     gpsAlt -= gpsAltOffset;
     
     
+    haveAltitudeReference = true;
     if (haveGpsAlt && haveBaroAlt && positionConfig()->altSource == DEFAULT) {
-        estimatedAltitudeCm = gpsAlt * gpsTrust + baroAlt * (1 - gpsTrust);
+        altitudeReferenceCm = gpsAlt * gpsTrust + baroAlt * (1 - gpsTrust);
 #ifdef USE_VARIO
         // baro is a better source for vario, so ignore gpsVertSpeed
         estimatedVario = calculateEstimatedVario(baroAlt, dTime);
 #endif
     } else if (haveGpsAlt && (positionConfig()->altSource == GPS_ONLY || positionConfig()->altSource == DEFAULT )) {
-        estimatedAltitudeCm = gpsAlt;
+        altitudeReferenceCm = gpsAlt;
 #if defined(USE_VARIO) && defined(USE_GPS)
         estimatedVario = gpsVertSpeed;
 #endif
     } else if (haveBaroAlt && (positionConfig()->altSource == BARO_ONLY || positionConfig()->altSource == DEFAULT)) {
-        estimatedAltitudeCm = baroAlt;
+        altitudeReferenceCm = baroAlt;
 #ifdef USE_VARIO
         estimatedVario = calculateEstimatedVario(baroAlt, dTime);
 #endif
+    } else {
+        haveAltitudeReference = false;
     }
-    
-	
-    
+
+    const float omega = 2.0f * M_PIf * positionConfig()->altFusionCutoff / 10.0f;
+    altitudeGainP = 2.0f * omega;
+    altitudeGainV = sq(omega);
+
+    // without an acc there is no attitude task to run the fusion, it follows the reference
+    // here at the reference rate with no acceleration input
+    if (!sensors(SENSOR_ACC)) {
+        updateEstimatedAltitude(currentTimeUs);
+    }
+
     DEBUG_SET(DEBUG_ALTITUDE, 0, (int32_t)(100 * gpsTrust));
     DEBUG_SET(DEBUG_ALTITUDE, 1, baroAlt);
     DEBUG_SET(DEBUG_ALTITUDE, 2, gpsAlt);
@@ -173,6 +200,33 @@ void calculateEstimatedAltitude(timeUs_t currentTimeUs)
 #endif
 }
 
+// Fuse the IMU vertical acceleration with the slower baro/GPS reference, run at the attitude rate.
+// Acceleration carries the fast changes, the reference removes the drift below the cutoff.
+void updateEstimatedAltitude(timeUs_t currentTimeUs)
+{
+    static timeUs_t previousTimeUs = 0;
+
+    const float dT = (currentTimeUs - previousTimeUs) * 1e-6f;
+    previousTimeUs = currentTimeUs;
+
+    if (!haveAltitudeReference) {
+        return;
+    }
+
+    if (altitudeReferenceReset || dT > 0.1f) {
+        // restart on the reference after an offset change or a gap in the updates
+        altitudeCm = altitudeReferenceCm;
+        climbRateCms = 0;
+        altitudeReferenceReset = false;
+    } else {
+        const float altitudeError = altitudeReferenceCm - altitudeCm;
+        altitudeCm += (climbRateCms + altitudeGainP * altitudeError) * dT;
+        climbRateCms += (getAccelerationZ() + altitudeGainV * altitudeError) * dT;
+    }
+
+    estimatedAltitudeCm = lrintf(altitudeCm);
+}
+
 bool isAltitudeOffset(void)
 {
     return altitudeOffsetSet;
@@ -184,6 +238,15 @@ int32_t getEstimatedAltitudeCm(void)
     return estimatedAltitudeCm;
 }
 
+float getEstimatedClimbRateCms(void)
+{
+#if defined(USE_BARO) || defined(USE_GPS)
+    return climbRateCms;
+#else
+    return 0;
+#endif
+}
+
 // This should be removed or fixed, but it would require changing a lot of other things to get rid of.
 int16_t getEstimatedVario(void)
 {
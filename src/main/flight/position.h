@@ -24,11 +24,14 @@
 
 typedef struct positionConfig_s {
     uint8_t altSource;
+    uint8_t altFusionCutoff;                // crossover of the acceleration and baro/GPS altitude fusion in 0.1 Hz
 } positionConfig_t;
 
 PG_DECLARE(positionConfig_t, positionConfig);
 
 bool isAltitudeOffset(void);
 void calculateEstimatedAltitude(timeUs_t currentTimeUs);
+void updateEstimatedAltitude(timeUs_t currentTimeUs);
 int32_t getEstimatedAltitudeCm(void);
+float getEstimatedClimbRateCms(void);
 int16_t getEstimatedVario(void);
@@ -0,0 +1,167 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/axis.h"
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/imu.h"
+#include "flight/pid.h"
+
+#include "sensors/acceleration.h"
+#include "sensors/gyro.h"
+
+#include "rescue.h"
+
+// HF3D:  Angle mode is rescue mode. It first levels to whichever of upright or inverted was closer
+//  at activation, then after rescue_delay (in 1/10 s) rolls to upright. The state is advanced from
+//  the RX task, the setpoints and the collective are evaluated once per PID cycle.
+static rescueState_e rescueState = RESCUE_STATE_OFF;
+static timeUs_t rescueStartTimeUs;
+static timeDelta_t rescueDelayUs;
+static bool rescueUprightEnabled;
+
+static float rescueLevelGain;
+static float rescueMaxRate;
+static float rescueMaxStep;             // setpoint change per PID cycle, from rescue_max_accel
+static float rescueCollectiveUpright;
+static float rescueCollectiveBoosted;
+
+static float rescueTargetSign;          // +1 levelling upright, -1 levelling inverted
+static float rescueSetpoint[2];         // roll, pitch in deg/s
+static float rescueCollective;
+
+void rescueInitConfig(const pidProfile_t *pidProfile)
+{
+    rescueUprightEnabled = (pidProfile->rescue_delay <= RESCUE_DELAY_MAX);
+    rescueDelayUs = pidProfile->rescue_delay * 100000;
+
+    rescueLevelGain = pidProfile->pid[PID_LEVEL].P / 10.0f;
+    rescueMaxRate = pidProfile->rescue_max_rate;
+    rescueMaxStep = pidProfile->rescue_max_accel * pidGetDT();
+    rescueCollectiveUpright = pidProfile->rescue_collective;
+    rescueCollectiveBoosted = constrain(pidProfile->rescue_collective + pidProfile->rescue_collective_boost, 50, 500);
+}
+
+void rescueUpdate(timeUs_t currentTimeUs)
+{
+    if (!FLIGHT_MODE(ANGLE_MODE)) {
+        rescueState = RESCUE_STATE_OFF;
+        return;
+    }
+
+    switch (rescueState) {
+    case RESCUE_STATE_OFF:
+        // Level to the nearest of upright or inverted, decided once from the attitude at activation
+        rescueTargetSign = (getCosTiltAngle() < 0) ? -1.0f : 1.0f;
+        // Start from the current rates, no step in the setpoint. Set before the state, the PID loop
+        // doesn't touch the setpoint while the rescue is off.
+        rescueSetpoint[FD_ROLL] = gyro.gyroADCf[FD_ROLL];
+        rescueSetpoint[FD_PITCH] = gyro.gyroADCf[FD_PITCH];
+        rescueStartTimeUs = currentTimeUs;
+        rescueState = RESCUE_STATE_LEVEL;
+        FALLTHROUGH;
+
+    case RESCUE_STATE_LEVEL:
+        if (rescueUprightEnabled && cmpTimeUs(currentTimeUs, rescueStartTimeUs) >= rescueDelayUs) {
+            rescueTargetSign = 1.0f;
+            rescueState = RESCUE_STATE_UPRIGHT;
+        }
+        break;
+
+    case RESCUE_STATE_UPRIGHT:
+        break;
+    }
+}
+
+// Called by pidController() once per PID cycle while the rescue is active
+void rescueUpdateSetpoint(const rollAndPitchTrims_t *angleTrim)
+{
+    if (rescueState == RESCUE_STATE_OFF) {
+        return;
+    }
+
+    // Earth up axis in the body frame, the target is +-Z. The error rotation is up x target.
+    float up[XYZ_AXIS_COUNT];
+    getUpVector(up);
+
+    const float ex = up[Y] * rescueTargetSign;
+    const float ey = -up[X] * rescueTargetSign;
+    const float sinError = sqrtf(sq(ex) + sq(ey));
+    const float cosError = up[Z] * rescueTargetSign;
+
+    float target[2] = { 0, 0 };
+    if (sinError > 0.001f) {
+        const float scale = -rescueLevelGain * atan2_approx(sinError, cosError) * (180.0f / M_PIf) / sinError;
+        target[FD_ROLL] = ex * scale;
+        target[FD_PITCH] = ey * scale;
+    } else if (cosError < 0) {
+        // Exactly opposite to the target, any axis is shortest, roll over
+        target[FD_ROLL] = rescueLevelGain * 180.0f;
+    }
+
+    // The acc trims offset the level attitude, the pitch trim flips with the target
+    target[FD_ROLL] += rescueLevelGain * angleTrim->raw[FD_ROLL] / 10.0f;
+    target[FD_PITCH] += rescueLevelGain * rescueTargetSign * angleTrim->raw[FD_PITCH] / 10.0f;
+
+    for (int axis = FD_ROLL; axis <= FD_PITCH; axis++) {
+        const float rate = constrainf(target[axis], -rescueMaxRate, rescueMaxRate);
+        rescueSetpoint[axis] += constrainf(rate - rescueSetpoint[axis], -rescueMaxStep, rescueMaxStep);
+    }
+
+    // Collective towards the nearest of upright or inverted, none while sideways.
+    // Scheduled with the square of the inclination from vertical, full collective when level.
+    const float inclination = 1.0f - acos_approx(fabsf(up[Z])) / (0.5f * M_PIf);
+    const float collective = (rescueState == RESCUE_STATE_UPRIGHT) ? rescueCollectiveUpright : rescueCollectiveBoosted;
+    rescueCollective = (up[Z] < 0 ? -collective : collective) * sq(inclination);
+}
+
+float rescueGetSetpoint(int axis)
+{
+    if (axis > FD_PITCH) {
+        return 0.0f;
+    }
+
+    // Angle mode is set before rescueUpdate() runs, hold the current rate until then
+    return (rescueState == RESCUE_STATE_OFF) ? gyro.gyroADCf[axis] : rescueSetpoint[axis];
+}
+
+float rescueGetCollective(void)
+{
+    return rescueCollective;
+}
+
+rescueState_e rescueGetState(void)
+{
+    return rescueState;
+}
+
+bool rescueIsUpright(void)
+{
+    return rescueState == RESCUE_STATE_UPRIGHT;
+}
@@ -0,0 +1,42 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common/time.h"
+
+#define RESCUE_DELAY_MAX 30     // rescue_delay above this never rolls upright
+
+typedef enum {
+    RESCUE_STATE_OFF = 0,
+    RESCUE_STATE_LEVEL,         // levelling to the nearest of upright or inverted, boosted collective
+    RESCUE_STATE_UPRIGHT,       // rolling to and holding upright after rescue_delay
+} rescueState_e;
+
+struct pidProfile_s;
+void rescueInitConfig(const struct pidProfile_s *pidProfile);
+void rescueUpdate(timeUs_t currentTimeUs);
+union rollAndPitchTrims_u;
+void rescueUpdateSetpoint(const union rollAndPitchTrims_u *angleTrim);
+float rescueGetSetpoint(int axis);
+float rescueGetCollective(void);
+rescueState_e rescueGetState(void);
+bool rescueIsUpright(void);
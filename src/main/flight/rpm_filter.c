@@ -20,6 +20,7 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -32,9 +33,13 @@
 
 #include "config/feature.h"
 
+#include "fc/runtime_config.h"
+
 #include "scheduler/scheduler.h"
+#include "sensors/acceleration.h"
 #include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
+#include "sensors/rpm_source.h"
 #include "drivers/dshot.h"
 #include "drivers/freq.h"
 #include "flight/mixer.h"
@@ -44,28 +49,54 @@
 #include "rpm_filter.h"
 
 
-typedef struct rpmFilterBank_s
+// TDF2 state per stage: {s1, s2}
+#define RPM_NOTCH_STATE_COUNT   2
+
+typedef struct rpmNotch_s
 {
     uint8_t  motorIndex;
 
-    float    rpmRatio;
+    float    freqScale;     // motor rpm to notch Hz, gear ratio and harmonic folded in
     float    minHz;
     float    maxHz;
-    float    Q;
+    float    qScale;        // 1 / (2 * Q)
+    float    freq;          // last frequency set, tracked by the accelerometer notches
 
-    biquadFilter_t notch[XYZ_AXIS_COUNT];
+} rpmNotch_t;
 
-} rpmFilterBank_t;
 
-
-FAST_RAM_ZERO_INIT static rpmFilterBank_t filterBank[RPM_FILTER_BANK_COUNT];
+FAST_RAM_ZERO_INIT static rpmNotch_t notch[RPM_FILTER_NOTCH_COUNT];
 FAST_RAM_ZERO_INIT static pt1Filter_t motorFilter[MAX_SUPPORTED_MOTORS];
 
-FAST_RAM_ZERO_INIT static uint8_t activeBankCount;
-FAST_RAM_ZERO_INIT static uint8_t currentBank;
+// Coefficients are shared by all axes, each axis has its own state. The coefficients
+// morph to each update over the samples until the same notch is updated again.
+FAST_RAM_ZERO_INIT static biquadMorph_t notchCoeffs[RPM_FILTER_NOTCH_COUNT];
+FAST_RAM_ZERO_INIT static float notchState[RPM_FILTER_NOTCH_COUNT][XYZ_AXIS_COUNT][RPM_NOTCH_STATE_COUNT];
+
+FAST_RAM_ZERO_INIT static uint8_t notchCount;
+static uint8_t droppedNotchCount;       // harmonics configured beyond RPM_FILTER_NOTCH_COUNT
+FAST_RAM_ZERO_INIT static uint8_t notchUpdateCount;
+FAST_RAM_ZERO_INIT static uint16_t notchMorphSamples;
+FAST_RAM_ZERO_INIT static uint8_t currentNotch;
+FAST_RAM_ZERO_INIT static bool rpmFilterDebug;
+
+FAST_RAM_ZERO_INIT static float notchOmegaScale;
+
+#ifdef USE_ACC
+// Accelerometer notches follow a subset of the gyro notches at the acc sample rate
+static uint8_t accNotchIndex[RPM_FILTER_ACC_NOTCH_COUNT];
+static biquadMorph_t accNotchCoeffs[RPM_FILTER_ACC_NOTCH_COUNT];
+static float accNotchState[RPM_FILTER_ACC_NOTCH_COUNT][XYZ_AXIS_COUNT][RPM_NOTCH_STATE_COUNT];
+
+static uint8_t accNotchCount;
+static uint8_t currentAccNotch;
+
+static float accNotchOmegaScale;
+static float accNotchMaxHz;
+#endif
 
 
-PG_REGISTER_WITH_RESET_FN(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 4);
+PG_REGISTER_WITH_RESET_FN(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 5);
 
 void pgResetFn_rpmFilterConfig(rpmFilterConfig_t *config)
 {
@@ -75,97 +106,184 @@ void pgResetFn_rpmFilterConfig(rpmFilterConfig_t *config)
         config->filter_bank_notch_q[i]     = 250;
         config->filter_bank_min_hz[i]      = 20;
         config->filter_bank_max_hz[i]      = 4000;
+        config->filter_bank_harmonics[i]   = 1;
+    }
+}
+
+// Notch coefficients for omega, always within 0..PI here, reached after the given number of samples
+static FAST_CODE void rpmNotchCalcCoeffs(biquadMorph_t *coeffs, float omega, float qScale, uint16_t samples)
+{
+    biquadFilter_t target;
+    biquadFilterSetNotch(&target, omega, qScale);
+    biquadMorphSetTarget(coeffs, &target, samples);
+}
+
+static FAST_CODE void rpmNotchSetFrequency(int index, float freq, uint16_t samples)
+{
+    notch[index].freq = freq;
+    rpmNotchCalcCoeffs(&notchCoeffs[index], freq * notchOmegaScale, notch[index].qScale, samples);
+}
+
+#ifdef USE_ACC
+static void rpmAccNotchSetFrequency(int index, float freq)
+{
+    const rpmNotch_t *filt = &notch[accNotchIndex[index]];
+    rpmNotchCalcCoeffs(&accNotchCoeffs[index], MIN(freq, accNotchMaxHz) * accNotchOmegaScale, filt->qScale, 0);
+}
+
+static void rpmFilterInitAcc(void)
+{
+    accNotchCount = 0;
+    currentAccNotch = 0;
+
+    if (!sensors(SENSOR_ACC) || !accelerometerConfig()->acc_rpm_filter || !acc.accSamplingInterval) {
+        return;
+    }
+
+    accNotchOmegaScale = 2.0f * M_PIf * acc.accSamplingInterval * 1e-6f;
+    accNotchMaxHz = 0.45e6f / acc.accSamplingInterval;
+
+    // Only the notches that can fall below the acc Nyquist frequency, the rotor harmonics
+    for (int index = 0; index < notchCount && accNotchCount < RPM_FILTER_ACC_NOTCH_COUNT; index++) {
+        if (notch[index].minHz < accNotchMaxHz) {
+            accNotchIndex[accNotchCount] = index;
+            rpmAccNotchSetFrequency(accNotchCount, notch[index].minHz);
+            accNotchCount++;
+        }
     }
+
+    memset(accNotchState, 0, sizeof(accNotchState));
 }
+#endif
 
 void rpmFilterInit(const rpmFilterConfig_t *config)
 {
+    notchCount = 0;
+    droppedNotchCount = 0;
+    rpmFilterDebug = DEBUG_MODE_ACTIVE(DEBUG_RPM_FILTER);
+    notchOmegaScale = 2.0f * M_PIf * gyro.targetLooptime * 1e-6f;
+
     for (int bank = 0; bank < RPM_FILTER_BANK_COUNT; bank++) {
         if (config->filter_bank_motor_index[bank]) {
-            rpmFilterBank_t *filt = &filterBank[bank];
-            
-            // Force bank config into reasonable limits
-            filt->motorIndex = constrain(config->filter_bank_motor_index[bank], 1, getMotorCount());
-            filt->rpmRatio   = constrainf(config->filter_bank_gear_ratio[bank], 1, 50000) / 1000 * 60;
-            filt->Q          = constrainf(config->filter_bank_notch_q[bank], 10, 10000) / 100;
-            filt->minHz      = constrainf(config->filter_bank_min_hz[bank], 20, 1000);
-            filt->maxHz      = constrainf(config->filter_bank_max_hz[bank], 100, 0.45e6 / gyro.targetLooptime);
-            
-            // Init all filters @minHz. As soon as the motor is running, the filters are updated to the real RPM.
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                biquadFilterInit(&filt->notch[axis], filt->minHz, gyro.targetLooptime, filt->Q, FILTER_NOTCH);
+            const int harmonics = constrain(config->filter_bank_harmonics[bank], 1, RPM_FILTER_HARMONICS_MAX);
+
+            // Each harmonic of the bank gets its own notch at n x the fundamental
+            for (int harmonic = 1; harmonic <= harmonics; harmonic++) {
+                if (notchCount >= RPM_FILTER_NOTCH_COUNT) {
+                    droppedNotchCount++;
+                    continue;
+                }
+
+                rpmNotch_t *filt = &notch[notchCount];
+
+                // Force bank config into reasonable limits
+                filt->motorIndex = constrain(config->filter_bank_motor_index[bank], 1, getMotorCount());
+                filt->freqScale  = harmonic / (constrainf(config->filter_bank_gear_ratio[bank], 1, 50000) / 1000 * 60);
+                filt->qScale     = 0.5f / (constrainf(config->filter_bank_notch_q[bank], 10, 10000) / 100);
+                filt->minHz      = constrainf(config->filter_bank_min_hz[bank], 20, 1000);
+                filt->maxHz      = constrainf(config->filter_bank_max_hz[bank], 100, 0.45e6 / gyro.targetLooptime);
+
+                // Init all filters @minHz. As soon as the motor is running, the filters are updated to the real RPM.
+                rpmNotchSetFrequency(notchCount, filt->minHz, 0);
+
+                notchCount++;
             }
-            
-            currentBank = bank;
-            activeBankCount++;
         }
     }
-    
-    if (activeBankCount > 0) {
-        float pid_dt = gyro.targetLooptime * pidConfig()->pid_process_denom * 1e-6;
-        float cutoff = 0.25 / (pid_dt * activeBankCount);
-        
+
+    memset(notchState, 0, sizeof(notchState));
+    currentNotch = 0;
+
+    if (notchCount > 0) {
+        const uint32_t pidLooptime = gyro.targetLooptime * pidConfig()->pid_process_denom;
+
+        // Update enough notches per PID cycle to refresh all of them within RPM_FILTER_UPDATE_PERIOD_US
+        const int updateCycles = constrain(RPM_FILTER_UPDATE_PERIOD_US / pidLooptime, 1, notchCount);
+        notchUpdateCount = (notchCount + updateCycles - 1) / updateCycles;
+
+        // Gyro samples between two updates of the same notch
+        notchMorphSamples = ((notchCount + notchUpdateCount - 1) / notchUpdateCount) * pidConfig()->pid_process_denom;
+
+        float pid_dt = pidLooptime * 1e-6;
+        float cutoff = 0.25 / (pid_dt * updateCycles);
+
         for (int motor=0; motor<getMotorCount(); motor++) {
             pt1FilterInit(&motorFilter[motor], pt1FilterGain(cutoff, pid_dt));
         }
     }
+
+#ifdef USE_ACC
+    rpmFilterInitAcc();
+#endif
+}
+
+// Harmonics of the configured banks that got no notch, the later banks lose theirs first
+uint8_t rpmFilterDroppedNotchCount(void)
+{
+    return droppedNotchCount;
 }
 
 
-// Called by gyroUpdate() in gyro.c - runs at Gyro looptime
-FAST_CODE_NOINLINE float rpmFilterGyro(int axis, float value)
+// Cascade of TDF2 biquads sharing one coefficient set per stage, as biquadMorphFilterApply().
+// The coefficients of each stage advance once per sample for all three axes.
+static FAST_CODE void rpmFilterCascade(biquadMorph_t *coeffs, float (*state)[XYZ_AXIS_COUNT][RPM_NOTCH_STATE_COUNT], int stages, float *values)
 {
-    if (activeBankCount > 0) {
-        for (int bank=0; bank<RPM_FILTER_BANK_COUNT; bank++) {
-            if (filterBank[bank].motorIndex) {
-                value = biquadFilterApplyDF1(&filterBank[bank].notch[axis], value);
-            }
+    for (int stage = 0; stage < stages; stage++) {
+        biquadMorph_t *c = &coeffs[stage];
+        biquadMorphStep(c);
+
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            float *s = state[stage][axis];
+            const float input = values[axis];
+            const float result = c->b0 * input + s[0];
+            s[0] = c->b1 * input - c->a1 * result + s[1];
+            s[1] = c->b2 * input - c->a2 * result;
+            values[axis] = result;
         }
     }
-    return value;
 }
 
+// Called by gyroUpdate() in gyro.c - runs at Gyro looptime
+FAST_CODE_NOINLINE void rpmFilterGyro(float *values)
+{
+    if (notchCount > 0) {
+        rpmFilterCascade(notchCoeffs, notchState, notchCount, values);
+    }
+}
+
+
+#ifdef USE_ACC
+// Called by accUpdate() in acceleration.c - runs at the acc sample rate
+void rpmFilterAcc(float *values)
+{
+    if (accNotchCount > 0) {
+        // Follow one gyro notch per sample, the gyro notches track the rpm
+        rpmAccNotchSetFrequency(currentAccNotch, notch[accNotchIndex[currentAccNotch]].freq);
+        currentAccNotch = (currentAccNotch + 1) % accNotchCount;
+
+        rpmFilterCascade(accNotchCoeffs, accNotchState, accNotchCount, values);
+    }
+}
+#endif
+
+// rpmFilterUpdateNotches() and rpmFilterUpdateNotchesDebug()
+#define DEBUG_VARIANT_IMPL "flight/rpm_filter_impl.c"
+#include "build/debug_variant.h"
 
 // rpmFilterUpdate() is called by pidController() in pid.c - runs at PID looptime
 void rpmFilterUpdate()
 {
-    if (activeBankCount > 0) {
+    if (notchCount > 0) {
         // Loop over all the motors and low-pass filter their RPM values
         for (int motor = 0; motor < getMotorCount(); motor++) {
             pt1FilterApply(&motorFilter[motor], getMotorRPM(motor));
         }
-        
-        // Update one filter bank per cycle
-        rpmFilterBank_t *filt = &filterBank[currentBank];
-
-        // Calculate filter frequency
-        float rpm  = motorFilter[filt->motorIndex - 1].state;
-        float freq = constrainf(rpm / filt->rpmRatio, filt->minHz, filt->maxHz);
-        
-        // Notches for Roll,Pitch,Yaw
-        biquadFilter_t *R = &filt->notch[0];
-        biquadFilter_t *P = &filt->notch[1];
-        biquadFilter_t *Y = &filt->notch[2];
-        
-        // Update the filter coefficients
-        biquadFilterUpdate(R, freq, gyro.targetLooptime, filt->Q, FILTER_NOTCH);
-        
-        // Transfer the filter coefficients from Roll axis filter into Pitch and Yaw
-        P->b0 = Y->b0 = R->b0;
-        P->b1 = Y->b1 = R->b1;
-        P->b2 = Y->b2 = R->b2;
-        P->a1 = Y->a1 = R->a1;
-        P->a2 = Y->a2 = R->a2;
-        
-        DEBUG_SET(DEBUG_RPM_FILTER, 0, currentBank);
-        DEBUG_SET(DEBUG_RPM_FILTER, 1, filt->motorIndex);
-        DEBUG_SET(DEBUG_RPM_FILTER, 2, rpm);
-        DEBUG_SET(DEBUG_RPM_FILTER, 3, freq);
-
-        // Find next active bank - there must be at least one
-        do {
-            currentBank = (currentBank + 1) % RPM_FILTER_BANK_COUNT;
-        } while (filterBank[currentBank].motorIndex == 0);
+
+        if (rpmFilterDebug) {
+            rpmFilterUpdateNotchesDebug();
+        } else {
+            rpmFilterUpdateNotches();
+        }
     }
 }
 
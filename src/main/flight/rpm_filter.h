@@ -23,7 +23,12 @@
 #include "common/axis.h"
 #include "pg/pg.h"
 
-#define RPM_FILTER_BANK_COUNT 16
+#define RPM_FILTER_BANK_COUNT       16
+#define RPM_FILTER_NOTCH_COUNT      16
+#define RPM_FILTER_HARMONICS_MAX    3
+#define RPM_FILTER_ACC_NOTCH_COUNT  4
+
+#define RPM_FILTER_UPDATE_PERIOD_US 1000    // Every notch is refreshed at least this often
 
 typedef struct rpmFilteConfig_s
 {
@@ -32,6 +37,7 @@ typedef struct rpmFilteConfig_s
     uint16_t filter_bank_notch_q[RPM_FILTER_BANK_COUNT];        // Filter Q * 100
     uint16_t filter_bank_min_hz[RPM_FILTER_BANK_COUNT];         // Filter minimum frequency
     uint16_t filter_bank_max_hz[RPM_FILTER_BANK_COUNT];         // Filter maximum frequency
+    uint8_t  filter_bank_harmonics[RPM_FILTER_BANK_COUNT];      // Number of harmonics (1x,2x,3x) notched by the bank
 
 } rpmFilterConfig_t;
 
@@ -39,7 +45,9 @@ typedef struct rpmFilteConfig_s
 PG_DECLARE(rpmFilterConfig_t, rpmFilterConfig);
 
 void  rpmFilterInit(const rpmFilterConfig_t *config);
-float rpmFilterGyro(int axis, float values);
+void  rpmFilterGyro(float *values);
+void  rpmFilterAcc(float *values);
 void  rpmFilterUpdate();
+uint8_t rpmFilterDroppedNotchCount(void);
 
 float rpmMinMotorFrequency(void);
@@ -0,0 +1,45 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform.h"
+
+// Update a fixed batch of notches per cycle
+static FAST_CODE void DEBUG_VARIANT(rpmFilterUpdateNotches)(void)
+{
+    for (int i = 0; i < notchUpdateCount; i++) {
+        rpmNotch_t *filt = &notch[currentNotch];
+
+        // Calculate filter frequency
+        float rpm  = motorFilter[filt->motorIndex - 1].state;
+        float freq = constrainf(rpm * filt->freqScale, filt->minHz, filt->maxHz);
+
+        // Update the filter coefficients, shared by Roll,Pitch,Yaw
+        rpmNotchSetFrequency(currentNotch, freq, notchMorphSamples);
+
+        if (i == 0) {
+            DEBUG_VARIANT_SET(DEBUG_RPM_FILTER, 0, currentNotch);
+            DEBUG_VARIANT_SET(DEBUG_RPM_FILTER, 1, filt->motorIndex);
+            DEBUG_VARIANT_SET(DEBUG_RPM_FILTER, 2, rpm);
+            DEBUG_VARIANT_SET(DEBUG_RPM_FILTER, 3, freq);
+        }
+
+        currentNotch = (currentNotch + 1) % notchCount;
+    }
+}
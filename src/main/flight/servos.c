@@ -42,10 +42,12 @@
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
 
+#include "flight/collective.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/servos.h"
+#include "flight/swash.h"
 
 #include "io/gimbal.h"
 
@@ -56,12 +58,13 @@
 #include "rx/rx.h"
 
 
-PG_REGISTER_WITH_RESET_FN(servoConfig_t, servoConfig, PG_SERVO_CONFIG, 0);
+PG_REGISTER_WITH_RESET_FN(servoConfig_t, servoConfig, PG_SERVO_CONFIG, 3);
 
 void pgResetFn_servoConfig(servoConfig_t *servoConfig)
 {
     servoConfig->dev.servoCenterPulse = 1500;
     servoConfig->dev.servoPwmRate = 50;
+    servoConfig->dev.servoFrameAverage = false;
     servoConfig->tri_unarmed_servo = 1;
     servoConfig->servo_lowpass_freq = 0;
     servoConfig->channelForwardingStartChannel = AUX1;
@@ -71,7 +74,7 @@ void pgResetFn_servoConfig(servoConfig_t *servoConfig)
     }
 }
 
-PG_REGISTER_ARRAY(servoMixer_t, MAX_SERVO_RULES, customServoMixers, PG_SERVO_MIXER, 0);
+PG_REGISTER_ARRAY(servoMixer_t, MAX_SERVO_RULES, customServoMixers, PG_SERVO_MIXER, 1);
 
 PG_REGISTER_ARRAY_WITH_RESET_FN(servoParam_t, MAX_SUPPORTED_SERVOS, servoParams, PG_SERVO_PARAMS, 0);
 
@@ -95,12 +98,59 @@ int16_t servo[MAX_SUPPORTED_SERVOS];
 
 static uint8_t servoRuleCount = 0;
 static servoMixer_t currentServoMixer[MAX_SERVO_RULES];
+
+// smix rules compiled against the servo params, so the mixer only multiplies, limits and adds
+typedef struct servoMixerRule_s {
+    uint8_t target;
+    uint8_t input;
+    uint8_t box;
+    float speed;                            // input change per PID cycle, 0 = unlimited
+    float scale;                            // rate and servo direction
+    float min;                              // rule limits in the servo direction
+    float max;
+} servoMixerRule_t;
+
+static servoMixerRule_t servoMixerRules[MAX_SERVO_RULES];
+static uint8_t servoMixerRuleCount;
+static uint32_t servoInputMask;             // inputs referenced by a rule
+
+// Output linearisation of the servo arm and ball link geometry, arm rotation against travel
+typedef struct servoGeometry_s {
+    bool enabled;
+    float halfRange;
+    float table[SERVO_GEOMETRY_TABLE_POINTS];       // arm rotation over full throw for a linear travel of -1 to 1
+} servoGeometry_t;
+
+static servoGeometry_t servoGeometry[MAX_SUPPORTED_SERVOS];
 static int useServo;
 int servo_override[MAX_SUPPORTED_SERVOS];
 int servo_input_override[5];
 
 #define COUNT_SERVO_RULES(rules) (sizeof(rules) / sizeof(servoMixer_t))
 // mixer rule format servo, input, rate, speed, min, max, box
+#if defined(USE_UNCOMMON_MIXERS) || defined(USE_HELI_ONLY)
+static const servoMixer_t servoMixerHeli[] = {
+    { SERVO_HELI_LEFT, INPUT_STABILIZED_PITCH,   -50, 0, 0, 100, 0 },
+    { SERVO_HELI_LEFT, INPUT_STABILIZED_ROLL,    -87, 0, 0, 100, 0 },
+    { SERVO_HELI_LEFT, INPUT_RC_AUX1,    100, 0, 0, 100, 0 },
+    { SERVO_HELI_RIGHT, INPUT_STABILIZED_PITCH,  -50, 0, 0, 100, 0 },
+    { SERVO_HELI_RIGHT, INPUT_STABILIZED_ROLL,  87, 0, 0, 100, 0 },
+    { SERVO_HELI_RIGHT, INPUT_RC_AUX1,    100, 0, 0, 100, 0 },
+    { SERVO_HELI_TOP, INPUT_STABILIZED_PITCH,   100, 0, 0, 100, 0 },
+    { SERVO_HELI_TOP, INPUT_RC_AUX1,    100, 0, 0, 100, 0 },
+    { SERVO_HELI_RUD, INPUT_STABILIZED_YAW, 100, 0, 0, 100, 0 },
+};
+#else
+#define servoMixerHeli NULL
+#endif
+
+#if defined(USE_HELI_ONLY)
+// Only the heli layouts are built, indexed the same way as the full table
+const mixerRules_t servoMixers[] = {
+    [MIXER_HELI_120_CCPM] = { COUNT_SERVO_RULES(servoMixerHeli), servoMixerHeli },
+    [MIXER_QUADX_1234]    = { 0, NULL },
+};
+#else
 static const servoMixer_t servoMixerAirplane[] = {
     { SERVO_FLAPPERON_1, INPUT_STABILIZED_ROLL,  100, 0, 0, 100, 0 },
     { SERVO_FLAPPERON_2, INPUT_STABILIZED_ROLL,  100, 0, 0, 100, 0 },
@@ -144,23 +194,10 @@ static const servoMixer_t servoMixerSingle[] = {
     { SERVO_SINGLECOPTER_4, INPUT_STABILIZED_YAW,   100, 0, 0, 100, 0 },
     { SERVO_SINGLECOPTER_4, INPUT_STABILIZED_ROLL,  100, 0, 0, 100, 0 },
 };
-
-static const servoMixer_t servoMixerHeli[] = {
-    { SERVO_HELI_LEFT, INPUT_STABILIZED_PITCH,   -50, 0, 0, 100, 0 },
-    { SERVO_HELI_LEFT, INPUT_STABILIZED_ROLL,    -87, 0, 0, 100, 0 },
-    { SERVO_HELI_LEFT, INPUT_RC_AUX1,    100, 0, 0, 100, 0 },
-    { SERVO_HELI_RIGHT, INPUT_STABILIZED_PITCH,  -50, 0, 0, 100, 0 },
-    { SERVO_HELI_RIGHT, INPUT_STABILIZED_ROLL,  87, 0, 0, 100, 0 },
-    { SERVO_HELI_RIGHT, INPUT_RC_AUX1,    100, 0, 0, 100, 0 },
-    { SERVO_HELI_TOP, INPUT_STABILIZED_PITCH,   100, 0, 0, 100, 0 },
-    { SERVO_HELI_TOP, INPUT_RC_AUX1,    100, 0, 0, 100, 0 },
-    { SERVO_HELI_RUD, INPUT_STABILIZED_YAW, 100, 0, 0, 100, 0 },
-};
 #else
 #define servoMixerBI NULL
 #define servoMixerDual NULL
 #define servoMixerSingle NULL
-#define servoMixerHeli NULL
 #endif // USE_UNCOMMON_MIXERS
 
 static const servoMixer_t servoMixerGimbal[] = {
@@ -197,6 +234,7 @@ const mixerRules_t servoMixers[] = {
     { 0, NULL },                // MULTITYPE_CUSTOM_TRI
     { 0, NULL },
 };
+#endif // USE_HELI_ONLY
 
 int16_t determineServoMiddleOrForwardFromChannel(servoIndex_e servoIndex)
 {
@@ -241,9 +279,101 @@ void servosInit(void)
         servo[i] = DEFAULT_SERVO_MIDDLE;
     }
 
+#ifndef USE_HELI_ONLY
     if (mixerIsTricopter()) {
         servosTricopterInit();
     }
+#endif
+}
+
+// Ball travel of an arm of length r rotated by angle, pushing a link of length l
+static float servoGeometryTravel(float angle, float r, float l)
+{
+    const float travel = r * sin_approx(angle);
+
+    if (l > 0.0f) {
+        // The arm tip also moves sideways, tilting the link and shortening the travel along the link
+        const float side = r * (1.0f - cos_approx(angle));
+        return travel + sqrtf(l * l - side * side) - l;
+    }
+
+    return travel;
+}
+
+// Invert the geometry for evenly spaced travels. The travel at both ends is limited to the shorter side,
+// so the corrected output stays symmetrical and reaches min or max only on the long side.
+static void servoGeometryInit(int index)
+{
+    servoGeometry_t *geo = &servoGeometry[index];
+    const float r = servoConfig()->servo_arm_length[index];
+    const float armThrow = degreesToRadians(MIN(servoConfig()->servo_throw[index], MAX_SERVO_THROW));
+    const float l = servoConfig()->servo_link_length[index] ? MAX(servoConfig()->servo_link_length[index], r) : 0.0f;
+
+    geo->enabled = (r > 0 && armThrow > 0);
+    geo->halfRange = (servoParams(index)->max - servoParams(index)->min) / 2.0f;
+
+    if (!geo->enabled) {
+        return;
+    }
+
+    const float travelMax = MIN(servoGeometryTravel(armThrow, r, l), -servoGeometryTravel(-armThrow, r, l));
+
+    for (int i = 0; i < SERVO_GEOMETRY_TABLE_POINTS; i++) {
+        const float travel = travelMax * (2.0f * i / (SERVO_GEOMETRY_TABLE_POINTS - 1) - 1.0f);
+        // Travel is monotonic in the arm angle over +-MAX_SERVO_THROW, bisect for the angle
+        float low = -armThrow;
+        float high = armThrow;
+        for (int j = 0; j < 24; j++) {
+            const float mid = (low + high) / 2.0f;
+            if (servoGeometryTravel(mid, r, l) < travel) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        geo->table[i] = (low + high) / (2.0f * armThrow);
+    }
+}
+
+// Compile the current smix rules, the swash mixer and the servo geometry. Must be called when the rules or the servo params change.
+void servoMixerCompile(void)
+{
+    swashInit();
+
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        servoGeometryInit(i);
+    }
+
+    servoInputMask = 0;
+    servoMixerRuleCount = 0;
+
+    for (int i = 0; i < servoRuleCount; i++) {
+        const servoMixer_t *mix = &currentServoMixer[i];
+
+        // Swash servos are mixed natively when a swash type is set
+        if (swashGetServoMask() & BIT(mix->targetChannel)) {
+            continue;
+        }
+
+        servoMixerRule_t *rule = &servoMixerRules[servoMixerRuleCount++];
+        const servoParam_t *params = servoParams(mix->targetChannel);
+        const float direction = servoDirection(mix->targetChannel, mix->inputSource);
+
+        // min/max range is 0-100% of the servo range, typical min: 0*1000/100-1000/2 = -500, max: 100*1000/100-1000/2 = 500
+        const float servoWidth = params->max - params->min;
+        const float min = mix->min * servoWidth / 100.0f - servoWidth / 2.0f;
+        const float max = mix->max * servoWidth / 100.0f - servoWidth / 2.0f;
+
+        rule->target = mix->targetChannel;
+        rule->input = mix->inputSource;
+        rule->box = mix->box;
+        rule->speed = mix->speed * pidGetDT() * 1000.0f;    // smix speed is in input units per ms
+        rule->scale = direction * mix->rate / 100.0f;
+        rule->min = (direction > 0) ? min : -max;
+        rule->max = (direction > 0) ? max : -min;
+
+        servoInputMask |= BIT(mix->inputSource);
+    }
 }
 
 void loadCustomServoMixer(void)
@@ -261,6 +391,8 @@ void loadCustomServoMixer(void)
         currentServoMixer[i] = *customServoMixers(i);
         servoRuleCount++;
     }
+
+    servoMixerCompile();
 }
 
 void servoConfigureOutput(void)
@@ -271,6 +403,7 @@ void servoConfigureOutput(void)
             for (int i = 0; i < servoRuleCount; i++)
                 currentServoMixer[i] = servoMixers[getMixerMode()].rule[i];
         }
+        servoMixerCompile();
     }
 
     switch (getMixerMode()) {
@@ -335,6 +468,22 @@ void writeServos(void)
     filterServos();
 
     uint8_t servoIndex = 0;
+#ifdef USE_HELI_ONLY
+    // Swash and tail servos of the 120 CCPM layout, or the servos of a custom smix
+    if (getMixerMode() == MIXER_HELI_120_CCPM) {
+        writeServoWithTracking(servoIndex++, SERVO_HELI_LEFT);
+        writeServoWithTracking(servoIndex++, SERVO_HELI_RIGHT);
+        writeServoWithTracking(servoIndex++, SERVO_HELI_TOP);
+        writeServoWithTracking(servoIndex++, SERVO_HELI_RUD);
+        if (swashGetServoCount() == SWASH_SERVO_COUNT_MAX) {
+            writeServoWithTracking(servoIndex++, SERVO_HELI_REAR);
+        }
+    } else if (getMixerMode() == MIXER_CUSTOM_AIRPLANE) {
+        for (int i = SERVO_PLANE_INDEX_MIN; i <= SERVO_PLANE_INDEX_MAX; i++) {
+            writeServoWithTracking(servoIndex++, i);
+        }
+    }
+#else
     switch (getMixerMode()) {
     case MIXER_TRI:
     case MIXER_CUSTOM_TRI:
@@ -368,6 +517,9 @@ void writeServos(void)
         writeServoWithTracking(servoIndex++, SERVO_HELI_RIGHT);
         writeServoWithTracking(servoIndex++, SERVO_HELI_TOP);
         writeServoWithTracking(servoIndex++, SERVO_HELI_RUD);
+        if (swashGetServoCount() == SWASH_SERVO_COUNT_MAX) {
+            writeServoWithTracking(servoIndex++, SERVO_HELI_REAR);
+        }
         break;
 
     case MIXER_DUALCOPTER:
@@ -385,6 +537,7 @@ void writeServos(void)
     default:
         break;
     }
+#endif // USE_HELI_ONLY
 
     // Two servos for SERVO_TILT, if enabled
     if (featureIsEnabled(FEATURE_SERVO_TILT) || getMixerMode() == MIXER_GIMBAL) {
@@ -405,6 +558,9 @@ void writeServos(void)
         forwardAuxChannelsToServos(servoIndex);
         servoIndex += MAX_AUX_CHANNEL_COUNT;
     }
+
+    // Latch the outputs in the last PID cycle before the next servo pulse
+    pwmCompleteServoUpdate(targetPidLooptime);
 }
 
 int32_t swashRingTotal = 0;
@@ -412,8 +568,9 @@ int32_t swashRingTotal = 0;
 // Generic servo mixing from Cleanflight using user-defined smix values for each servo
 void servoMixer(void)
 {
-    int16_t input[INPUT_SOURCE_COUNT];    // Range [-500:+500]
-    static int16_t currentOutput[MAX_SERVO_RULES];
+    float input[INPUT_SOURCE_COUNT];      // Range [-500:+500], only the inputs referenced by a rule are set
+    float output[MAX_SUPPORTED_SERVOS];
+    static float currentOutput[MAX_SERVO_RULES];
 
     if (FLIGHT_MODE(PASSTHRU_MODE)) {
         // Direct passthru from RX
@@ -431,15 +588,19 @@ void servoMixer(void)
 		// NOTE:  WIth servo mixer scaling applied to yaw, it means that a pidSum of 1428 (143% in BB Explorer) is needed to max out the yaw channel.
         input[INPUT_STABILIZED_YAW] = pidData[FD_YAW].Sum * PID_SERVO_MIXER_SCALING;
 
+#ifndef USE_HELI_ONLY
         // Reverse yaw servo when inverted in 3D mode (Betaflight code meant for FPV)
         // HF3D:  LOL - Remove this in case somebody enables the 3D mode.  It would kind of be hilarious though.
         if (featureIsEnabled(FEATURE_3D) && (rcData[THROTTLE] < rxConfig()->midrc)) {
             input[INPUT_STABILIZED_YAW] *= -1;
         }
+#endif
     }
     
-    input[INPUT_GIMBAL_PITCH] = scaleRange(attitude.values.pitch, -1800, 1800, -500, +500);
-    input[INPUT_GIMBAL_ROLL] = scaleRange(attitude.values.roll, -1800, 1800, -500, +500);
+    if (servoInputMask & (BIT(INPUT_GIMBAL_PITCH) | BIT(INPUT_GIMBAL_ROLL))) {
+        input[INPUT_GIMBAL_PITCH] = scaleRange(attitude.values.pitch, -1800, 1800, -500, +500);
+        input[INPUT_GIMBAL_ROLL] = scaleRange(attitude.values.roll, -1800, 1800, -500, +500);
+    }
 
     input[INPUT_STABILIZED_THROTTLE] = motor[0] - 1000 - 500;  // Since it derives from rcCommand or mincommand and must be [-500:+500]
 
@@ -449,18 +610,17 @@ void servoMixer(void)
     // 2000 - 1500 = +500
     // 1500 - 1500 = 0
     // 1000 - 1500 = -500
-    input[INPUT_RC_ROLL]     = rcData[ROLL]     - rxConfig()->midrc;
-    input[INPUT_RC_PITCH]    = rcData[PITCH]    - rxConfig()->midrc;
-    input[INPUT_RC_YAW]      = rcData[YAW]      - rxConfig()->midrc;
-    input[INPUT_RC_THROTTLE] = rcData[THROTTLE] - rxConfig()->midrc;
-    input[INPUT_RC_AUX1]     = rcCommand[COLLECTIVE];                   // HF3D: Updated to use interpolated rcCommand[COLLECTIVE] value
-    input[INPUT_RC_AUX2]     = rcData[AUX2]     - rxConfig()->midrc;
-    input[INPUT_RC_AUX3]     = rcData[AUX3]     - rxConfig()->midrc;
-    input[INPUT_RC_AUX4]     = rcData[AUX4]     - rxConfig()->midrc;
+    const uint16_t midrc = rxConfig()->midrc;
+    for (int channel = ROLL; channel <= AUX4; channel++) {
+        if (servoInputMask & BIT(INPUT_RC_ROLL + channel)) {
+            input[INPUT_RC_ROLL + channel] = rcData[channel] - midrc;
+        }
+    }
+    input[INPUT_RC_AUX1] = collectiveGet()->command;        // HF3D: Interpolated collective, sampled with the PID cycle
 
     // initialize our output value for each servo to zero
     for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
-        servo[i] = 0;
+        output[i] = 0;
     }
 
     // HF3D TODO:  Implement collective max/min limit settings and then scale the input RC command to those limits.
@@ -473,7 +633,7 @@ void servoMixer(void)
     //   Default pidSum limit = 500 * 0.7 scale factor = 350 for each of roll and pitch
     //   Combined output for both axis = sqrt(350^2+350^2) = 495 for the maximum roll+pitch command from the pid loop.  
     //   Divide each by the combined total to scale them down such that the total combined cyclic command equals the max in one axis.
-    swashRingTotal = sqrt(input[INPUT_STABILIZED_ROLL]*input[INPUT_STABILIZED_ROLL] + input[INPUT_STABILIZED_PITCH]*input[INPUT_STABILIZED_PITCH]);
+    swashRingTotal = sqrtf(input[INPUT_STABILIZED_ROLL]*input[INPUT_STABILIZED_ROLL] + input[INPUT_STABILIZED_PITCH]*input[INPUT_STABILIZED_PITCH]);
     
     // Check if swashRingTotal combination exceeds the maximum possible deflection in any one direction
     // HF3D TODO:  Be very cautious of increasing PID_SERVO_MIXER_SCALING in the future code!!  
@@ -483,8 +643,9 @@ void servoMixer(void)
     const float swashRingLimit = currentPidProfile->pidSumLimit * PID_SERVO_MIXER_SCALING;
     if (swashRingTotal > swashRingLimit) {
         // Limit deflection off-axis if total requested servo deflection is greater than the maximum deflection on any one axis.
-        input[INPUT_STABILIZED_ROLL] = input[INPUT_STABILIZED_ROLL] * swashRingLimit / swashRingTotal;
-        input[INPUT_STABILIZED_PITCH] = input[INPUT_STABILIZED_PITCH] * swashRingLimit / swashRingTotal;
+        const float swashRingScale = swashRingLimit / swashRingTotal;
+        input[INPUT_STABILIZED_ROLL] *= swashRingScale;
+        input[INPUT_STABILIZED_PITCH] *= swashRingScale;
     }    
     // NOTE:  pidSumLimit for roll & pitch should be increased until exactly 10 degrees of cyclic pitch is achieved at maximum swash deflection and zero collective pitch
     //   .... Actually, maybe the rates should be increased/decreased instead of pidSumLimit.  This would allow very similar gains to be used across different size helis as long as max cyclic pitch is similar.
@@ -502,50 +663,47 @@ void servoMixer(void)
 
     }
 
-    // mix servos according to smix rules
+    // HF3D:  Native swashplate mixing, a no-op without a swash type
+    swashMix(input[INPUT_STABILIZED_ROLL], input[INPUT_STABILIZED_PITCH], input[INPUT_RC_AUX1], output);
+
+    // mix servos according to the compiled smix rules
     //   https://github.com/cleanflight/cleanflight/blob/master/docs/Mixer.md
-    for (int i = 0; i < servoRuleCount; i++) {
+    for (int i = 0; i < servoMixerRuleCount; i++) {
+        const servoMixerRule_t *rule = &servoMixerRules[i];
 
-        //HF3D:  Skip collective smix rules on the first loop through our smix rules
-        // Was going to use this to process collective after the roll/pitch is processed, but not sure I want to go that route now.
-        // if (currentServoMixer[i].inputSource == INPUT_RC_AUX1) {
-            // continue;
-        // }
-        
         // consider rule if no box assigned or if box is active
-        if (currentServoMixer[i].box == 0 || IS_RC_MODE_ACTIVE(BOXSERVO1 + currentServoMixer[i].box - 1)) {
-            uint8_t target = currentServoMixer[i].targetChannel;    // output servo channel (0-7)
-            uint8_t from = currentServoMixer[i].inputSource;        // number of the input source for this rule
-            uint16_t servo_width = servoParams(target)->max - servoParams(target)->min;     // we will scale mixer to full range of the associated servo (typically min 1000, max 2000)
-            int16_t min = currentServoMixer[i].min * servo_width / 100 - servo_width / 2;   // min/max range is 0-100.  Typical min:  0*1000/2-1000/2 = -500
-            int16_t max = currentServoMixer[i].max * servo_width / 100 - servo_width / 2;   // Typical max:  100*1000/100-1000/2 = 500
+        if (rule->box == 0 || RC_MODE_FLAG(RC_MODE_FLAG_SERVO1 << (rule->box - 1))) {
+            const float in = input[rule->input];
 
             // See if the smix was setup as being speed limited.
-            if (currentServoMixer[i].speed == 0)
-                currentOutput[i] = input[from];       // no speed limit, just store the input to the temporary output
-            else {                                    // speed limit, so increment only up to the allowed amount
-                if (currentOutput[i] < input[from])
-                    currentOutput[i] = constrain(currentOutput[i] + currentServoMixer[i].speed, currentOutput[i], input[from]);
-                else if (currentOutput[i] > input[from])
-                    currentOutput[i] = constrain(currentOutput[i] - currentServoMixer[i].speed, input[from], currentOutput[i]);
+            if (rule->speed == 0.0f) {
+                currentOutput[i] = in;                // no speed limit, just store the input to the temporary output
+            } else {                                  // speed limit, so increment only up to the allowed amount
+                currentOutput[i] += constrainf(in - currentOutput[i], -rule->speed, rule->speed);
             }
 
-            // add the result of this mix to the servo output accumulator, taking into account the rate (%mix) and min/max limits set for this smix+servo combo
-            servo[target] += servoDirection(target, from) * constrain(((int32_t)currentOutput[i] * currentServoMixer[i].rate) / 100, min, max);
+            // add the result of this mix to the servo output accumulator, taking into account the rate (%mix), direction and min/max limits set for this smix+servo combo
+            output[rule->target] += constrainf(currentOutput[i] * rule->scale, rule->min, rule->max);
         } else {
             currentOutput[i] = 0;    // don't change servo output for this rule if wrong box is active
         }
     }
 
     for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
-        servo[i] = ((int32_t)servoParams(i)->rate * servo[i]) / 100L;        // multiply the calculated servo mixer output by the servo gain (rate) for this servo (usually the result is usually no change)
-        servo[i] += determineServoMiddleOrForwardFromChannel(i);             // add our result to the center of the servo's range (or to forwarded rcCommand value if forwarding is assigned for this channel)
+        servo[i] = lrintf(servoParams(i)->rate * output[i] / 100.0f);     // multiply the calculated servo mixer output by the servo gain (rate) for this servo (usually the result is usually no change)
+        servo[i] += determineServoMiddleOrForwardFromChannel(i);            // add our result to the center of the servo's range (or to forwarded rcCommand value if forwarding is assigned for this channel)
     }
 }
 
 
 static void servoTable(void)
 {
+#ifdef USE_HELI_ONLY
+    // All the heli layouts mix through the smix rules and the native swash mixing
+    if (getMixerMode() != MIXER_CUSTOM) {
+        servoMixer();
+    }
+#else
     // airplane / servo mixes
     switch (getMixerMode()) {
     case MIXER_CUSTOM_TRI:
@@ -573,6 +731,7 @@ static void servoTable(void)
     default:
         break;
     }
+#endif // USE_HELI_ONLY
 
     // camera stabilization
     if (featureIsEnabled(FEATURE_SERVO_TILT)) {
@@ -617,27 +776,50 @@ bool isMixerUsingServos(void)
 }
 
 static biquadFilter_t servoFilter[MAX_SUPPORTED_SERVOS];
+static float servoSlewStep[MAX_SUPPORTED_SERVOS];       // pulse change per PID cycle, 0 = unlimited
+static float servoSlewOutput[MAX_SUPPORTED_SERVOS];
 
 void servosFilterInit(void)
 {
-    if (servoConfig()->servo_lowpass_freq) {
-        for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
+    for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
+        if (servoConfig()->servo_lowpass_freq) {
             biquadFilterInitLPF(&servoFilter[servoIdx], servoConfig()->servo_lowpass_freq, targetPidLooptime);
         }
+        // servo_slew_rate is in us of pulse per ms, the step is independent of the PID loop rate
+        servoSlewStep[servoIdx] = servoConfig()->servo_slew_rate[servoIdx] * targetPidLooptime / 1000.0f;
+        servoSlewOutput[servoIdx] = servoParams(servoIdx)->middle;
     }
-
 }
+
+// Geometry correction, slew limit and lowpass of the servo outputs in one pass
 static void filterServos(void)
 {
 #if defined(MIXER_DEBUG)
     uint32_t startTime = micros();
 #endif
-    if (servoConfig()->servo_lowpass_freq) {
-        for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
-            servo[servoIdx] = lrintf(biquadFilterApply(&servoFilter[servoIdx], (float)servo[servoIdx]));
-            // Sanity check
-            servo[servoIdx] = constrain(servo[servoIdx], servoParams(servoIdx)->min, servoParams(servoIdx)->max);
+    for (int servoIdx = 0; servoIdx < MAX_SUPPORTED_SERVOS; servoIdx++) {
+        float output = servo[servoIdx];
+
+        // Correct for the arm and link geometry, so the swash travel is linear in the mixer output
+        const servoGeometry_t *geo = &servoGeometry[servoIdx];
+        if (geo->enabled && geo->halfRange > 0) {
+            const int16_t middle = servoParams(servoIdx)->middle;
+            const float pos = (constrainf((output - middle) / geo->halfRange, -1.0f, 1.0f) + 1.0f) * (SERVO_GEOMETRY_TABLE_POINTS - 1) / 2.0f;
+            const int index = MIN((int)pos, SERVO_GEOMETRY_TABLE_POINTS - 2);
+            output = middle + (geo->table[index] + (pos - index) * (geo->table[index + 1] - geo->table[index])) * geo->halfRange;
         }
+
+        if (servoSlewStep[servoIdx] > 0) {
+            servoSlewOutput[servoIdx] += constrainf(output - servoSlewOutput[servoIdx], -servoSlewStep[servoIdx], servoSlewStep[servoIdx]);
+            output = servoSlewOutput[servoIdx];
+        }
+
+        if (servoConfig()->servo_lowpass_freq) {
+            output = biquadFilterApply(&servoFilter[servoIdx], output);
+        }
+
+        // Sanity check
+        servo[servoIdx] = constrain(lrintf(output), servoParams(servoIdx)->min, servoParams(servoIdx)->max);
     }
 #if defined(MIXER_DEBUG)
     debug[0] = (int16_t)(micros() - startTime);
@@ -68,7 +68,8 @@ typedef enum {
     SERVO_HELI_LEFT = 0,
     SERVO_HELI_RIGHT = 1,
     SERVO_HELI_TOP = 2,
-    SERVO_HELI_RUD = 3
+    SERVO_HELI_RUD = 3,
+    SERVO_HELI_REAR = 4,        // fourth swash servo of the H4 swash types
 
 } servoIndex_e; // FIXME rename to servoChannel_e
 
@@ -90,7 +91,7 @@ typedef struct servoMixer_s {
     uint8_t targetChannel;                  // servo that receives the output of the rule
     uint8_t inputSource;                    // input channel for this rule
     int8_t rate;                            // range [-125;+125] ; can be used to adjust a rate 0-125% and a direction
-    uint8_t speed;                          // reduces the speed of the rule, 0=unlimited speed
+    uint8_t speed;                          // reduces the speed of the rule in input units per ms, 0=unlimited speed
     int8_t min;                             // lower bound of rule range [0;100]% of servo max-min
     int8_t max;                             // lower bound of rule range [0;100]% of servo max-min
     uint8_t box;                            // active rule if box is enabled, range [0;3], 0=no box, 1=BOXSERVO1, 2=BOXSERVO2, 3=BOXSERVO3
@@ -99,6 +100,8 @@ typedef struct servoMixer_s {
 PG_DECLARE_ARRAY(servoMixer_t, MAX_SERVO_RULES, customServoMixers);
 
 #define MAX_SERVO_SPEED UINT8_MAX
+#define MAX_SERVO_THROW 80
+#define SERVO_GEOMETRY_TABLE_POINTS 33
 #define MAX_SERVO_BOXES 3
 
 // Custom mixer configuration
@@ -125,6 +128,10 @@ typedef struct servoConfig_s {
     uint16_t servo_lowpass_freq;            // lowpass servo filter frequency selection; 1/1000ths of loop freq
     uint8_t tri_unarmed_servo;              // send tail servo correction pulses even when unarmed
     uint8_t channelForwardingStartChannel;
+    uint8_t servo_arm_length[MAX_SUPPORTED_SERVOS];     // servo arm (horn) radius in mm, 0 = linear output
+    uint8_t servo_link_length[MAX_SUPPORTED_SERVOS];    // ball link length in mm, 0 = link always parallel to its travel
+    uint8_t servo_throw[MAX_SUPPORTED_SERVOS];          // servo arm rotation in degrees from middle to min or max
+    uint16_t servo_slew_rate[MAX_SUPPORTED_SERVOS];     // output slew limit in us of pulse per ms, 0 = unlimited
 } servoConfig_t;
 
 PG_DECLARE(servoConfig_t, servoConfig);
@@ -141,6 +148,7 @@ bool isMixerUsingServos(void);
 void writeServos(void);
 void servoMixerLoadMix(int index);
 void loadCustomServoMixer(void);
+void servoMixerCompile(void);
 int servoDirection(int servoIndex, int fromChannel);
 void servoConfigureOutput(void);
 void servosInit(void);
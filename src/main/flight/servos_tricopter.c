@@ -23,7 +23,7 @@
 
 #include "platform.h"
 
-#ifdef USE_SERVOS
+#if defined(USE_SERVOS) && !defined(USE_HELI_ONLY)
 
 #include "flight/mixer.h"
 #include "flight/mixer_tricopter.h"
@@ -45,4 +45,4 @@ void servosTricopterInit(void)
 
 }
 
-#endif // USE_SERVOS
+#endif // USE_SERVOS && !USE_HELI_ONLY
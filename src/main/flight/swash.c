@@ -0,0 +1,134 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_SERVOS
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "flight/mixer.h"
+#include "flight/servos.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "swash.h"
+
+PG_REGISTER_WITH_RESET_TEMPLATE(swashConfig_t, swashConfig, PG_SWASH_CONFIG, 1);
+
+PG_RESET_TEMPLATE(swashConfig_t, swashConfig,
+    .swash_type = SWASH_TYPE_NONE,
+    .swash_phase = 0,
+);
+
+typedef struct swashServo_s {
+    uint8_t index;              // servo driven by this row of the mixing matrix
+    float collective;
+    float roll;
+    float pitch;
+} swashServo_t;
+
+// Servo positions around the swashplate in degrees, 0 = the SERVO_HELI_TOP position, positive to SERVO_HELI_RIGHT.
+//   A servo at angle a moves with collective + pitch * cos(a) + roll * sin(a), as the smix rules of the heli mixer do for 120.
+static const int16_t swashServoAngles[SWASH_TYPE_COUNT][SWASH_SERVO_COUNT_MAX] = {
+    [SWASH_TYPE_CCPM120] = { -120, 120,    0 },
+    [SWASH_TYPE_CCPM135] = { -135, 135,    0 },
+    [SWASH_TYPE_CCPM140] = { -140, 140,    0 },
+    [SWASH_TYPE_H4_90]   = {  -90,  90,    0, 180 },
+    [SWASH_TYPE_H4_45]   = {  -45,  45,  135, -135 },
+};
+
+static const uint8_t swashServoIndex[SWASH_SERVO_COUNT_MAX] = {
+    SERVO_HELI_LEFT, SERVO_HELI_RIGHT, SERVO_HELI_TOP, SERVO_HELI_REAR,
+};
+
+static swashServo_t swashServos[SWASH_SERVO_COUNT_MAX];
+static uint8_t swashServoCount;
+static uint32_t swashServoMask;
+
+// Builds the mixing matrix from the swash geometry. Called by servoMixerCompile().
+void swashInit(void)
+{
+    const uint8_t type = swashConfig()->swash_type;
+
+    swashServoCount = 0;
+    swashServoMask = 0;
+
+    if (type == SWASH_TYPE_NONE || type >= SWASH_TYPE_COUNT || getMixerMode() != MIXER_HELI_120_CCPM) {
+        return;
+    }
+
+    swashServoCount = (type == SWASH_TYPE_H4_90 || type == SWASH_TYPE_H4_45) ? 4 : 3;
+
+    // Phase rotates the cyclic command, folded into the roll and pitch columns
+    const float phase = constrain(swashConfig()->swash_phase, -SWASH_PHASE_MAX, SWASH_PHASE_MAX) * (M_PIf / 1800.0f);
+    const float phaseSin = sin_approx(phase);
+    const float phaseCos = cos_approx(phase);
+
+    for (int i = 0; i < swashServoCount; i++) {
+        swashServo_t *s = &swashServos[i];
+
+        float pitch, roll;
+        if (type == SWASH_TYPE_H1) {
+            pitch = (i == 1) ? 1.0f : 0.0f;
+            roll = (i == 0) ? 1.0f : 0.0f;
+            s->collective = (i == 2) ? 1.0f : 0.0f;
+        } else {
+            const float angle = degreesToRadians(swashServoAngles[type][i]);
+            pitch = cos_approx(angle);
+            roll = sin_approx(angle);
+            s->collective = 1.0f;
+        }
+
+        s->index = swashServoIndex[i];
+        s->pitch = pitch * phaseCos - roll * phaseSin;
+        s->roll = pitch * phaseSin + roll * phaseCos;
+
+        swashServoMask |= BIT(s->index);
+    }
+}
+
+uint8_t swashGetServoCount(void)
+{
+    return swashServoCount;
+}
+
+// Servos driven by the swash mixer, the smix rules for them are ignored
+uint32_t swashGetServoMask(void)
+{
+    return swashServoMask;
+}
+
+// Cyclic ring limited roll and pitch and the collective in, servo mixer output in the [-500:+500] range out
+void swashMix(float roll, float pitch, float collective, float *output)
+{
+    for (int i = 0; i < swashServoCount; i++) {
+        const swashServo_t *s = &swashServos[i];
+        output[s->index] = s->collective * collective + s->roll * roll + s->pitch * pitch;
+    }
+}
+
+#endif // USE_SERVOS
@@ -0,0 +1,49 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pg/pg.h"
+
+#define SWASH_SERVO_COUNT_MAX       4
+#define SWASH_PHASE_MAX             1800    // 0.1 degrees
+
+typedef enum {
+    SWASH_TYPE_NONE = 0,        // swash mixed with smix rules
+    SWASH_TYPE_H1,              // mechanical mixing, roll on SERVO_HELI_LEFT, pitch on SERVO_HELI_RIGHT, collective on SERVO_HELI_TOP
+    SWASH_TYPE_CCPM120,
+    SWASH_TYPE_CCPM135,
+    SWASH_TYPE_CCPM140,
+    SWASH_TYPE_H4_90,           // four servos at 90 degrees, the fourth on SERVO_HELI_REAR
+    SWASH_TYPE_H4_45,           // four servos at 45 degrees off the axes, the fourth on SERVO_HELI_REAR
+    SWASH_TYPE_COUNT
+} swashType_e;
+
+typedef struct swashConfig_s {
+    uint8_t swash_type;                                 // swashType_e, needs the HELI_120_CCPM mixer
+    int16_t swash_phase;                                // cyclic phase correction in 0.1 degrees
+} swashConfig_t;
+
+PG_DECLARE(swashConfig_t, swashConfig);
+
+void swashInit(void);
+uint8_t swashGetServoCount(void);
+uint32_t swashGetServoMask(void);
+void swashMix(float roll, float pitch, float collective, float *output);
@@ -0,0 +1,374 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * System identification. While the SYSTEM ID mode is on, a logarithmic chirp
+ * is added to the setpoint of one axis. A bank of single frequency DFTs runs
+ * over the whole sweep on the setpoint, the gyro and the PID output, at about
+ * 1kHz. Their ratios are the closed loop response (gyro / setpoint) and the
+ * plant with the actuators (gyro / PID output). The open loop is the measured
+ * plant times the P, I and D gains of the axis.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_SYSTEM_ID
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/maths.h"
+
+#include "fc/rc.h"
+
+#include "flight/pid.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "sensors/gyro.h"
+
+#include "sysid.h"
+
+#define SYSID_SAMPLE_HZ             1000        // of the DFT bank, the PID loop samples are averaged down to this
+#define SYSID_ABORT_DEFLECTION      0.3f        // stick input on any axis ends the run
+#define SYSID_BANDWIDTH_GAIN        0.7071f     // -3dB
+
+typedef struct sysidComplex_s {
+    float re;
+    float im;
+} sysidComplex_t;
+
+// Single frequency DFT of the setpoint, the gyro and the PID output
+typedef struct sysidBinState_s {
+    float re;                           // reference phasor
+    float im;
+    float stepRe;
+    float stepIm;
+    float setpoint[2];                  // sum of sample * re and sample * im
+    float gyro[2];
+    float output[2];
+} sysidBinState_t;
+
+PG_REGISTER_WITH_RESET_TEMPLATE(sysidConfig_t, sysidConfig, PG_SYSID_CONFIG, 0);
+
+PG_RESET_TEMPLATE(sysidConfig_t, sysidConfig,
+    .sysid_axis = FD_ROLL,
+    .sysid_amplitude = 30,
+    .sysid_min_hz = 2,
+    .sysid_max_hz = 40,
+    .sysid_duration = 20,
+);
+
+static FAST_RAM_ZERO_INIT sysidBinState_t sysidBin[SYSID_BIN_COUNT];
+static FAST_RAM_ZERO_INIT volatile bool sysidRunning;
+static FAST_RAM_ZERO_INIT uint8_t sysidAxis;
+static FAST_RAM_ZERO_INIT float sysidAmplitude;
+static FAST_RAM_ZERO_INIT float sysidChirpPhase;       // rad, -pi..pi
+static FAST_RAM_ZERO_INIT float sysidChirpStep;        // rad per axis cycle
+static FAST_RAM_ZERO_INIT float sysidChirpGrowth;      // of the step per axis cycle
+static FAST_RAM_ZERO_INIT uint32_t sysidChirpCycles;   // axis cycles left in the sweep
+static FAST_RAM_ZERO_INIT float sysidSetpoint;         // with the chirp, of this PID cycle
+static FAST_RAM_ZERO_INIT uint8_t sysidDecimation;
+static FAST_RAM_ZERO_INIT uint8_t sysidDecimationCount;
+static FAST_RAM_ZERO_INIT float sysidSum[3];           // setpoint, gyro and output of the decimation period
+
+// PID gains of the run, the open loop is computed with the controller that was measured
+static float sysidKp;
+static float sysidKi;
+static float sysidKd;
+
+static sysidResult_t sysidResult;
+static bool sysidResultPending;
+static bool sysidModeActive;
+
+static void sysidStart(void)
+{
+    const sysidConfig_t *config = sysidConfig();
+    const float minHz = MAX(config->sysid_min_hz, 1);
+    const float maxHz = MAX(config->sysid_max_hz, minHz + 1);
+    const float duration = MAX(config->sysid_duration, 1);
+    const float dT = pidGetDT();
+
+    sysidAxis = MIN(config->sysid_axis, FD_YAW);
+    // the chirp steps when its axis runs, the DFT bank samples every PID loop
+    const float axisDT = pidGetAxisDT(sysidAxis);
+    sysidAmplitude = config->sysid_amplitude;
+    pidGetCoefficients(sysidAxis, &sysidKp, &sysidKi, &sysidKd);
+
+    sysidDecimation = constrain(lrintf(1.0f / (dT * SYSID_SAMPLE_HZ)), 1, UINT8_MAX);
+    sysidDecimationCount = 0;
+    memset(sysidSum, 0, sizeof(sysidSum));
+
+    memset(&sysidResult, 0, sizeof(sysidResult));
+    sysidResult.axis = sysidAxis;
+    sysidResult.state = SYSID_STATE_RUNNING;
+    sysidResultPending = false;
+
+    // Log spaced bins, each in the middle of its share of the sweep
+    const float sampleDT = dT * sysidDecimation;
+    for (int bin = 0; bin < SYSID_BIN_COUNT; bin++) {
+        const float frequency = minHz * powf(maxHz / minHz, (bin + 0.5f) / SYSID_BIN_COUNT);
+        sysidBinState_t *state = &sysidBin[bin];
+        memset(state, 0, sizeof(*state));
+        state->re = 1.0f;
+        state->stepRe = cosf(2 * M_PIf * frequency * sampleDT);
+        state->stepIm = sinf(2 * M_PIf * frequency * sampleDT);
+        sysidResult.bins[bin].frequency = frequency;
+    }
+
+    sysidChirpPhase = 0.0f;
+    sysidChirpStep = 2 * M_PIf * minHz * axisDT;
+    sysidChirpGrowth = expf(logf(maxHz / minHz) * axisDT / duration);
+    sysidChirpCycles = lrintf(duration / axisDT);
+
+    sysidRunning = true;
+}
+
+static void sysidStop(sysidState_e state)
+{
+    sysidRunning = false;
+    sysidResult.state = state;
+}
+
+// At RC rate, the run starts when the mode goes on and ends when it goes off or the pilot takes over
+void sysidUpdateMode(bool active)
+{
+    if (active && !sysidModeActive) {
+        sysidStart();
+    } else if (!active && sysidRunning) {
+        sysidStop(SYSID_STATE_ABORTED);
+    }
+    sysidModeActive = active;
+
+    if (sysidRunning) {
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            if (getRcDeflectionAbs(axis) > SYSID_ABORT_DEFLECTION) {
+                sysidStop(SYSID_STATE_ABORTED);
+            }
+        }
+    }
+}
+
+// Adds the chirp to the setpoint of the axis under test, each time the axis runs
+FAST_CODE float sysidApply(int axis, float setpoint)
+{
+    if (!sysidRunning || axis != sysidAxis) {
+        return setpoint;
+    }
+
+    sysidChirpPhase += sysidChirpStep;
+    sysidChirpStep *= sysidChirpGrowth;
+    if (sysidChirpPhase >= M_PIf) {
+        sysidChirpPhase -= 2 * M_PIf;
+        // the sweep ends on a zero crossing, so the setpoint doesn't step
+        if (sysidChirpCycles == 0) {
+            sysidResultPending = true;
+            sysidStop(SYSID_STATE_DONE);
+            return setpoint;
+        }
+    }
+    if (sysidChirpCycles) {
+        sysidChirpCycles--;
+    }
+
+    const float excitation = sysidAmplitude * sin_approx(sysidChirpPhase);
+    sysidSetpoint = setpoint + excitation;
+
+    DEBUG_SET(DEBUG_SYSID, 0, lrintf(excitation));
+    DEBUG_SET(DEBUG_SYSID, 1, lrintf(sysidChirpStep / (pidGetAxisDT(sysidAxis) * 2 * M_PIf) * 10));
+
+    return sysidSetpoint;
+}
+
+// After the PID sums, once per PID cycle
+FAST_CODE void sysidUpdate(void)
+{
+    if (!sysidRunning) {
+        return;
+    }
+
+    // The average of the decimation period, the same lowpass and delay on all three is no error in their ratios
+    sysidSum[0] += sysidSetpoint;
+    sysidSum[1] += gyro.gyroADCf[sysidAxis];
+    sysidSum[2] += pidData[sysidAxis].Sum;
+    if (++sysidDecimationCount < sysidDecimation) {
+        return;
+    }
+
+    DEBUG_SET(DEBUG_SYSID, 2, lrintf(sysidSum[0] / sysidDecimation));
+    DEBUG_SET(DEBUG_SYSID, 3, lrintf(sysidSum[1] / sysidDecimation));
+
+    for (int bin = 0; bin < SYSID_BIN_COUNT; bin++) {
+        sysidBinState_t *state = &sysidBin[bin];
+
+        state->setpoint[0] += sysidSum[0] * state->re;
+        state->setpoint[1] += sysidSum[0] * state->im;
+        state->gyro[0] += sysidSum[1] * state->re;
+        state->gyro[1] += sysidSum[1] * state->im;
+        state->output[0] += sysidSum[2] * state->re;
+        state->output[1] += sysidSum[2] * state->im;
+
+        const float re = state->re * state->stepRe - state->im * state->stepIm;
+        const float im = state->re * state->stepIm + state->im * state->stepRe;
+        const float norm = 1.5f - 0.5f * (sq(re) + sq(im));
+        state->re = re * norm;
+        state->im = im * norm;
+    }
+
+    memset(sysidSum, 0, sizeof(sysidSum));
+    sysidDecimationCount = 0;
+}
+
+// The DFT is the sum of sample * e^(-j*w*t)
+static sysidComplex_t sysidSpectrum(const float *sums)
+{
+    const sysidComplex_t value = { sums[0], -sums[1] };
+    return value;
+}
+
+static sysidComplex_t sysidDivide(sysidComplex_t a, sysidComplex_t b)
+{
+    const float norm = sq(b.re) + sq(b.im);
+    sysidComplex_t value = { 0, 0 };
+    if (norm > 0) {
+        value.re = (a.re * b.re + a.im * b.im) / norm;
+        value.im = (a.im * b.re - a.re * b.im) / norm;
+    }
+    return value;
+}
+
+static sysidComplex_t sysidMultiply(sysidComplex_t a, sysidComplex_t b)
+{
+    const sysidComplex_t value = { a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+    return value;
+}
+
+static float sysidMagnitude(sysidComplex_t a)
+{
+    return sqrtf(sq(a.re) + sq(a.im));
+}
+
+static float sysidPhase(sysidComplex_t a)
+{
+    return atan2_approx(a.im, a.re) / RAD;
+}
+
+// Continues the phase of the previous bin without the 360 degree jumps
+static float sysidUnwrap(float phase, float previous)
+{
+    while (phase - previous > 180.0f) {
+        phase -= 360.0f;
+    }
+    while (phase - previous < -180.0f) {
+        phase += 360.0f;
+    }
+    return phase;
+}
+
+// Log frequency where a value between the bins crosses the level
+static float sysidCrossing(int bin, const float *value, float level)
+{
+    const float fraction = (value[bin - 1] - level) / (value[bin - 1] - value[bin]);
+    const float low = sysidResult.bins[bin - 1].frequency;
+    return low * powf(sysidResult.bins[bin].frequency / low, fraction);
+}
+
+static void sysidProcess(void)
+{
+    float closedGain[SYSID_BIN_COUNT];
+    float openGain[SYSID_BIN_COUNT];
+    float openPhase[SYSID_BIN_COUNT];
+    float plantPhase[SYSID_BIN_COUNT];
+
+    for (int bin = 0; bin < SYSID_BIN_COUNT; bin++) {
+        const sysidBinState_t *state = &sysidBin[bin];
+        const float omega = 2 * M_PIf * sysidResult.bins[bin].frequency;
+
+        const sysidComplex_t setpoint = sysidSpectrum(state->setpoint);
+        const sysidComplex_t gyroRate = sysidSpectrum(state->gyro);
+        const sysidComplex_t output = sysidSpectrum(state->output);
+
+        const sysidComplex_t closedLoop = sysidDivide(gyroRate, setpoint);
+        const sysidComplex_t plant = sysidDivide(gyroRate, output);
+        const sysidComplex_t controller = { sysidKp, omega * sysidKd - sysidKi / omega };
+        const sysidComplex_t openLoop = sysidMultiply(plant, controller);
+
+        closedGain[bin] = sysidMagnitude(closedLoop);
+        openGain[bin] = sysidMagnitude(openLoop);
+        openPhase[bin] = sysidPhase(openLoop);
+        plantPhase[bin] = sysidPhase(plant);
+        if (bin > 0) {
+            openPhase[bin] = sysidUnwrap(openPhase[bin], openPhase[bin - 1]);
+            plantPhase[bin] = sysidUnwrap(plantPhase[bin], plantPhase[bin - 1]);
+        }
+
+        sysidResult.bins[bin].gain = closedGain[bin];
+        sysidResult.bins[bin].phase = sysidPhase(closedLoop);
+    }
+
+    for (int bin = 1; bin < SYSID_BIN_COUNT; bin++) {
+        if (!sysidResult.bandwidthHz && closedGain[bin - 1] >= SYSID_BANDWIDTH_GAIN && closedGain[bin] < SYSID_BANDWIDTH_GAIN) {
+            sysidResult.bandwidthHz = sysidCrossing(bin, closedGain, SYSID_BANDWIDTH_GAIN);
+        }
+        if (!sysidResult.crossoverHz && openGain[bin - 1] >= 1.0f && openGain[bin] < 1.0f) {
+            const float fraction = (openGain[bin - 1] - 1.0f) / (openGain[bin - 1] - openGain[bin]);
+            sysidResult.crossoverHz = sysidCrossing(bin, openGain, 1.0f);
+            sysidResult.phaseMarginDeg = 180.0f + openPhase[bin - 1] + (openPhase[bin] - openPhase[bin - 1]) * fraction;
+        }
+    }
+
+    // Least squares slope of the plant phase over the upper half of the sweep, where the delay dominates it
+    float sumW = 0, sumP = 0, sumWW = 0, sumWP = 0;
+    const int first = SYSID_BIN_COUNT / 2;
+    const int count = SYSID_BIN_COUNT - first;
+    for (int bin = first; bin < SYSID_BIN_COUNT; bin++) {
+        const float omega = 2 * M_PIf * sysidResult.bins[bin].frequency;
+        const float phase = plantPhase[bin] * RAD;
+        sumW += omega;
+        sumP += phase;
+        sumWW += omega * omega;
+        sumWP += omega * phase;
+    }
+    const float slope = (count * sumWP - sumW * sumP) / (count * sumWW - sumW * sumW);
+    sysidResult.deadTimeMs = MAX(-slope * 1000.0f, 0.0f);
+}
+
+bool sysidIsRunning(void)
+{
+    return sysidRunning;
+}
+
+const sysidResult_t *sysidGetResult(void)
+{
+    if (sysidResultPending && !sysidRunning) {
+        // the analysis takes too long for the PID loop, it is done for the first reader
+        sysidProcess();
+        sysidResultPending = false;
+    }
+    return &sysidResult;
+}
+
+#endif
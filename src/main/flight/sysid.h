@@ -0,0 +1,68 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pg/pg.h"
+
+#define SYSID_BIN_COUNT             16
+
+typedef enum {
+    SYSID_STATE_IDLE = 0,
+    SYSID_STATE_RUNNING,
+    SYSID_STATE_DONE,
+    SYSID_STATE_ABORTED,
+} sysidState_e;
+
+typedef struct sysidConfig_s {
+    uint8_t  sysid_axis;                // FD_ROLL, FD_PITCH or FD_YAW
+    uint16_t sysid_amplitude;           // of the chirp added to the setpoint, deg/s
+    uint8_t  sysid_min_hz;              // sweep start
+    uint8_t  sysid_max_hz;              // sweep end
+    uint8_t  sysid_duration;            // of the sweep, seconds
+} sysidConfig_t;
+
+PG_DECLARE(sysidConfig_t, sysidConfig);
+
+typedef struct sysidBin_s {
+    float frequency;                    // Hz
+    float gain;                         // closed loop, gyro / setpoint
+    float phase;                        // closed loop, degrees
+} sysidBin_t;
+
+typedef struct sysidResult_s {
+    sysidState_e state;
+    uint8_t axis;
+    float bandwidthHz;                  // closed loop -3dB point, 0 outside the sweep
+    float crossoverHz;                  // open loop unity gain, 0 outside the sweep
+    float phaseMarginDeg;               // at the crossover
+    float deadTimeMs;                   // from the phase slope of the measured plant
+    sysidBin_t bins[SYSID_BIN_COUNT];
+} sysidResult_t;
+
+void sysidUpdateMode(bool active);
+float sysidApply(int axis, float setpoint);
+void sysidUpdate(void);
+
+bool sysidIsRunning(void);
+const sysidResult_t *sysidGetResult(void);
@@ -0,0 +1,135 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+
+#include "sensors/rpm_source.h"
+
+#include "tailmotor.h"
+
+#define TAIL_RPM_LPF_HZ                 250         // just enough to clean the telemetry, the speed loop needs the bandwidth
+#define TAIL_I_LIMIT                    0.25f
+
+// Thrust demand -> normalised tail rpm. Thrust goes with rpm^2, the interpolated map keeps a finite gain near zero thrust.
+static FAST_RAM_ZERO_INIT float tailThrustMap[TAIL_THRUST_MAP_POINTS];
+
+static FAST_RAM_ZERO_INIT bool tailClosedLoop;
+static FAST_RAM_ZERO_INIT float tailRpmMax;
+static FAST_RAM_ZERO_INIT float tailKp;
+static FAST_RAM_ZERO_INIT float tailKi;
+static FAST_RAM_ZERO_INIT float tailDT;
+static FAST_RAM_ZERO_INIT pt1Filter_t tailRpmFilter;
+static FAST_RAM_ZERO_INIT float tailI;
+
+// The speed loop gains alone, they can be adjusted in flight
+void tailMotorInitGains(void)
+{
+    // tail_rpm_p_gain = 10 (tailKp = 1) gives 1% change in throttle for 1% error in tail rpm, tail_rpm_i_gain the same after 1 second
+    tailKp = mixerConfig()->tail_rpm_p_gain / 10.0f;
+    tailKi = mixerConfig()->tail_rpm_i_gain / 10.0f;
+}
+
+// Called when the PID loop rate is set, the speed loop runs every PID cycle
+void tailMotorInit(void)
+{
+    tailRpmMax = mixerConfig()->tail_rpm_max;
+    tailClosedLoop = (tailRpmMax > 0);
+
+    tailMotorInitGains();
+    tailDT = pidGetDT();
+
+    pt1FilterInit(&tailRpmFilter, pt1FilterGain(TAIL_RPM_LPF_HZ, tailDT));
+    tailI = 0.0f;
+
+    for (int i = 0; i < TAIL_THRUST_MAP_POINTS; i++) {
+        tailThrustMap[i] = sqrtf((float)i / (TAIL_THRUST_MAP_POINTS - 1));
+    }
+}
+
+bool tailMotorIsClosedLoop(void)
+{
+    return tailClosedLoop;
+}
+
+static float tailThrustToRpm(float thrust)
+{
+    const float pos = constrainf(thrust, 0.0f, 1.0f) * (TAIL_THRUST_MAP_POINTS - 1);
+    const int index = MIN((int)pos, TAIL_THRUST_MAP_POINTS - 2);
+
+    return tailThrustMap[index] + (pos - index) * (tailThrustMap[index + 1] - tailThrustMap[index]);
+}
+
+// Thrust demand from the yaw mix in, tail motor throttle out, both 0..1.
+// The demand is mapped to a tail rpm setpoint, the throttle is the rpm feedforward plus a PI on the tail rpm.
+float tailMotorUpdate(float thrustDemand)
+{
+    const float tailRpm = pt1FilterApply(&tailRpmFilter, getMotorRPM(TAIL_MOTOR_INDEX));
+
+    if (!tailClosedLoop) {
+        return thrustDemand;
+    }
+
+    // Tail stopped: negative demand is left to the idle clamp of the mixer
+    if (thrustDemand <= 0.0f || !ARMING_FLAG(ARMED)) {
+        tailI = 0.0f;
+        return thrustDemand;
+    }
+
+    const float setpoint = tailThrustToRpm(thrustDemand);
+    float output = setpoint;
+
+    // Without an rpm reading (motor not started yet or telemetry lost) run on the feedforward alone
+    if (tailRpm > 0.0f) {
+        const float error = setpoint - tailRpm / tailRpmMax;
+        const float iChange = tailKi * error * tailDT;
+        tailI = constrainf(tailI + iChange, -TAIL_I_LIMIT, TAIL_I_LIMIT);
+        output += tailKp * error + tailI;
+
+        // Remove the last I-term addition if it was winding up into the limit
+        if ((output > 1.0f && error > 0.0f) || (output < 0.0f && error < 0.0f)) {
+            tailI -= iChange;
+        }
+    } else {
+        tailI = 0.0f;
+    }
+
+    output = constrainf(output, 0.0f, 1.0f);
+
+    DEBUG_SET(DEBUG_TAIL_MOTOR, 0, lrintf(thrustDemand * 1000));
+    DEBUG_SET(DEBUG_TAIL_MOTOR, 1, lrintf(setpoint * tailRpmMax));
+    DEBUG_SET(DEBUG_TAIL_MOTOR, 2, lrintf(tailRpm));
+    DEBUG_SET(DEBUG_TAIL_MOTOR, 3, lrintf(output * 1000));
+
+    return output;
+}
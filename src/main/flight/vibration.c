@@ -0,0 +1,306 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Rotor vibration monitor. One synchronous detector per rotor harmonic mixes
+ * the unfiltered gyro and the raw acc with a reference phasor turning at the
+ * harmonic frequency of the rpm source, and lowpasses the products. What is
+ * left is the in-phase and the quadrature part of the vibration at exactly
+ * that frequency, for a few multiply-adds per sample instead of an FFT.
+ *
+ * There is no once-per-revolution index, so the phase is that of the pitch
+ * axis relative to the roll axis: a disc imbalance turning with the rotor
+ * shows near +-90 degrees, a vibration along a fixed direction near 0 or 180.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_VIBRATION_MONITOR
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+#include "flight/tailmotor.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "sensors/acceleration.h"
+#include "sensors/rpm_source.h"
+#include "sensors/sensors.h"
+
+#include "vibration.h"
+
+#define VIBRATION_MIN_HZ            10.0f       // the mixing product at twice the frequency must stay well above the bandwidth
+#define VIBRATION_MAX_CYCLES        0.4f        // of the harmonic per sample, clear of Nyquist
+#define VIBRATION_SETTLE_TAU        5           // lowpass time constants before a new detector output is used
+
+typedef struct vibrationDetector_s {
+    float re;                           // reference phasor, cos and sin of the harmonic phase
+    float im;
+    float stepRe;                       // rotation of the reference per sample
+    float stepIm;
+    float gain;                         // of the I/Q lowpass
+    float i[XYZ_AXIS_COUNT];            // lowpassed sample * re
+    float q[XYZ_AXIS_COUNT];            // lowpassed sample * im
+    bool active;
+} vibrationDetector_t;
+
+PG_REGISTER_WITH_RESET_TEMPLATE(vibrationConfig_t, vibrationConfig, PG_VIBRATION_CONFIG, 0);
+
+PG_RESET_TEMPLATE(vibrationConfig_t, vibrationConfig,
+    .vibration_monitor = false,
+    .vibration_tail_ratio = 0,
+    .vibration_bandwidth = 10,
+);
+
+static FAST_RAM_ZERO_INIT vibrationDetector_t vibDetector[VIBRATION_SOURCE_COUNT][VIBRATION_HARMONIC_COUNT];
+static FAST_RAM_ZERO_INIT bool vibEnabled;
+
+static float vibSampleDT[VIBRATION_SOURCE_COUNT];      // 0 = source not available
+static float vibAmplitude[VIBRATION_SOURCE_COUNT][VIBRATION_HARMONIC_COUNT];   // deg/s, g
+static float vibPhase[VIBRATION_SOURCE_COUNT][VIBRATION_HARMONIC_COUNT];       // deg
+static uint16_t vibSettleUpdates;
+static uint16_t vibSettle[VIBRATION_HARMONIC_COUNT];
+
+// Since vibrationResetFlight(), for the persistent stats
+static float vibFlightMax[VIBRATION_HARMONIC_COUNT];
+
+void vibrationInit(void)
+{
+    memset(vibDetector, 0, sizeof(vibDetector));
+    memset(vibAmplitude, 0, sizeof(vibAmplitude));
+    memset(vibPhase, 0, sizeof(vibPhase));
+
+    vibEnabled = vibrationConfig()->vibration_monitor;
+
+    vibSampleDT[VIBRATION_SOURCE_GYRO] = pidGetDT();
+#ifdef USE_ACC
+    vibSampleDT[VIBRATION_SOURCE_ACC] = sensors(SENSOR_ACC) ? acc.accSamplingInterval * 1e-6f : 0.0f;
+#else
+    vibSampleDT[VIBRATION_SOURCE_ACC] = 0.0f;
+#endif
+
+    const float bandwidth = MAX(vibrationConfig()->vibration_bandwidth, 1) / 10.0f;
+    for (int source = 0; source < VIBRATION_SOURCE_COUNT; source++) {
+        for (int harmonic = 0; harmonic < VIBRATION_HARMONIC_COUNT; harmonic++) {
+            if (vibSampleDT[source] > 0) {
+                vibDetector[source][harmonic].gain = pt1FilterGain(bandwidth, vibSampleDT[source]);
+            }
+        }
+    }
+
+    vibSettleUpdates = lrintf(VIBRATION_SETTLE_TAU * VIBRATION_UPDATE_HZ / (2 * M_PIf * bandwidth));
+    for (int harmonic = 0; harmonic < VIBRATION_HARMONIC_COUNT; harmonic++) {
+        vibSettle[harmonic] = vibSettleUpdates;
+    }
+}
+
+static FAST_CODE void vibrationDetectorApply(vibrationDetector_t *detector, const float *sample)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        detector->i[axis] += detector->gain * (sample[axis] * detector->re - detector->i[axis]);
+        detector->q[axis] += detector->gain * (sample[axis] * detector->im - detector->q[axis]);
+    }
+
+    // Advance the reference, the first order renormalisation keeps it on the unit circle
+    const float re = detector->re * detector->stepRe - detector->im * detector->stepIm;
+    const float im = detector->re * detector->stepIm + detector->im * detector->stepRe;
+    const float norm = 1.5f - 0.5f * (sq(re) + sq(im));
+    detector->re = re * norm;
+    detector->im = im * norm;
+}
+
+static FAST_CODE void vibrationApplySource(vibrationSource_e source, const float *sample)
+{
+    for (int harmonic = 0; harmonic < VIBRATION_HARMONIC_COUNT; harmonic++) {
+        vibrationDetector_t *detector = &vibDetector[source][harmonic];
+        if (detector->active) {
+            vibrationDetectorApply(detector, sample);
+        }
+    }
+}
+
+// Every PID cycle, with the aligned but unfiltered gyro
+FAST_CODE void vibrationUpdateGyro(const float *gyroADC)
+{
+    if (vibEnabled) {
+        vibrationApplySource(VIBRATION_SOURCE_GYRO, gyroADC);
+    }
+}
+
+// Every acc sample, in sensor axes before the acc lowpass and the RPM filter take the harmonics out
+void vibrationUpdateAcc(const float *accADC)
+{
+    if (vibEnabled) {
+        vibrationApplySource(VIBRATION_SOURCE_ACC, accADC);
+    }
+}
+
+static void vibrationDetectorSetFrequency(vibrationDetector_t *detector, float frequency, float dT)
+{
+    const float cycles = frequency * dT;
+
+    if (frequency < VIBRATION_MIN_HZ || cycles > VIBRATION_MAX_CYCLES) {
+        if (detector->active) {
+            detector->active = false;
+            memset(detector->i, 0, sizeof(detector->i));
+            memset(detector->q, 0, sizeof(detector->q));
+        }
+        return;
+    }
+
+    sin_cos_approx(2 * M_PIf * cycles, &detector->stepIm, &detector->stepRe);
+
+    if (!detector->active) {
+        detector->re = 1.0f;
+        detector->im = 0.0f;
+        detector->active = true;
+    }
+}
+
+static float vibrationTailHz(float mainHz)
+{
+    const uint16_t ratio = vibrationConfig()->vibration_tail_ratio;
+
+    if (ratio) {
+        return mainHz * ratio / 1000.0f;
+    }
+    if (getMotorCount() > TAIL_MOTOR_INDEX) {
+        return getFilteredMotorRPM(TAIL_MOTOR_INDEX) / 60.0f;
+    }
+    return 0.0f;
+}
+
+// Root sum square of the axis amplitudes, and the phase of the pitch axis relative to the roll axis
+static void vibrationDetectorResult(const float *i, const float *q, float *amplitude, float *phase)
+{
+    *amplitude = 2.0f * sqrtf(sq(i[X]) + sq(q[X]) + sq(i[Y]) + sq(q[Y]) + sq(i[Z]) + sq(q[Z]));
+    *phase = atan2_approx(i[Y] * q[X] - q[Y] * i[X], i[X] * i[Y] + q[X] * q[Y]) / RAD;
+}
+
+static void vibrationUpdateResults(vibrationSource_e source, vibrationHarmonic_e harmonic)
+{
+    const vibrationDetector_t *detector = &vibDetector[source][harmonic];
+
+    if (!detector->active) {
+        vibAmplitude[source][harmonic] = 0.0f;
+        vibPhase[source][harmonic] = 0.0f;
+        return;
+    }
+
+    float i[XYZ_AXIS_COUNT];
+    float q[XYZ_AXIS_COUNT];
+    memcpy(i, detector->i, sizeof(i));
+    memcpy(q, detector->q, sizeof(q));
+
+    float scale = 1.0f;
+#ifdef USE_ACC
+    if (source == VIBRATION_SOURCE_ACC) {
+        // the detection is linear, so turning the I and Q vectors into body axes is the same as turning every sample
+        applyRotation(i, &acc.dev.rotationMatrix);
+        applyRotation(q, &acc.dev.rotationMatrix);
+        scale = acc.dev.acc_1G_rec;
+    }
+#endif
+
+    vibrationDetectorResult(i, q, &vibAmplitude[source][harmonic], &vibPhase[source][harmonic]);
+    vibAmplitude[source][harmonic] *= scale;
+}
+
+void vibrationUpdate(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    const float mainHz = getHeadspeedRPM() / 60.0f;
+    const float frequency[VIBRATION_HARMONIC_COUNT] = {
+        [VIBRATION_MAIN_1X] = mainHz,
+        [VIBRATION_MAIN_2X] = 2 * mainHz,
+        [VIBRATION_TAIL_1X] = vibrationTailHz(mainHz),
+    };
+
+    for (int harmonic = 0; harmonic < VIBRATION_HARMONIC_COUNT; harmonic++) {
+        for (int source = 0; source < VIBRATION_SOURCE_COUNT; source++) {
+            if (vibSampleDT[source] > 0) {
+                vibrationDetectorSetFrequency(&vibDetector[source][harmonic], frequency[harmonic], vibSampleDT[source]);
+            }
+            vibrationUpdateResults(source, harmonic);
+        }
+
+        if (!vibDetector[VIBRATION_SOURCE_GYRO][harmonic].active) {
+            vibSettle[harmonic] = vibSettleUpdates;
+        } else if (vibSettle[harmonic]) {
+            vibSettle[harmonic]--;
+        }
+
+        if (ARMING_FLAG(ARMED) && vibrationIsActive(harmonic)) {
+            vibFlightMax[harmonic] = MAX(vibFlightMax[harmonic], vibAmplitude[VIBRATION_SOURCE_GYRO][harmonic]);
+        }
+    }
+
+    DEBUG_SET(DEBUG_VIBRATION, 0, lrintf(vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_1X) * 10));
+    DEBUG_SET(DEBUG_VIBRATION, 1, lrintf(vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_2X) * 10));
+    DEBUG_SET(DEBUG_VIBRATION, 2, lrintf(vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, VIBRATION_TAIL_1X) * 10));
+    DEBUG_SET(DEBUG_VIBRATION, 3, lrintf(vibrationGetPhase(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_1X)));
+}
+
+// The harmonic is in range and its detectors have settled
+bool vibrationIsActive(vibrationHarmonic_e harmonic)
+{
+    return vibEnabled && vibDetector[VIBRATION_SOURCE_GYRO][harmonic].active && vibSettle[harmonic] == 0;
+}
+
+// deg/s for the gyro, g for the acc, 0 while the harmonic is not active
+float vibrationGetAmplitude(vibrationSource_e source, vibrationHarmonic_e harmonic)
+{
+    return vibrationIsActive(harmonic) ? vibAmplitude[source][harmonic] : 0.0f;
+}
+
+// -180..180 degrees, pitch relative to roll
+float vibrationGetPhase(vibrationSource_e source, vibrationHarmonic_e harmonic)
+{
+    return vibrationIsActive(harmonic) ? vibPhase[source][harmonic] : 0.0f;
+}
+
+void vibrationResetFlight(void)
+{
+    memset(vibFlightMax, 0, sizeof(vibFlightMax));
+}
+
+void vibrationGetFlight(vibrationFlight_t *flight)
+{
+    for (int harmonic = 0; harmonic < VIBRATION_HARMONIC_COUNT; harmonic++) {
+        flight->maxGyro[harmonic] = lrintf(constrainf(vibFlightMax[harmonic] * 10, 0, UINT16_MAX));
+    }
+}
+
+#endif
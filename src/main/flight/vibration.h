@@ -0,0 +1,67 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#include "pg/pg.h"
+
+#define VIBRATION_UPDATE_HZ         50
+
+typedef enum {
+    VIBRATION_MAIN_1X = 0,
+    VIBRATION_MAIN_2X,
+    VIBRATION_TAIL_1X,
+    VIBRATION_HARMONIC_COUNT
+} vibrationHarmonic_e;
+
+typedef enum {
+    VIBRATION_SOURCE_GYRO = 0,
+    VIBRATION_SOURCE_ACC,
+    VIBRATION_SOURCE_COUNT
+} vibrationSource_e;
+
+typedef struct vibrationConfig_s {
+    uint8_t  vibration_monitor;         // on/off
+    uint16_t vibration_tail_ratio;      // tail rotor/main rotor speed *1000, 0 = direct drive tail motor
+    uint8_t  vibration_bandwidth;       // detector bandwidth in 0.1Hz
+} vibrationConfig_t;
+
+PG_DECLARE(vibrationConfig_t, vibrationConfig);
+
+typedef struct vibrationFlight_s {
+    uint16_t maxGyro[VIBRATION_HARMONIC_COUNT];     // worst gyro amplitude of each harmonic, 0.1 deg/s
+} vibrationFlight_t;
+
+void vibrationInit(void);
+void vibrationUpdateGyro(const float *gyroADC);
+void vibrationUpdateAcc(const float *accADC);
+void vibrationUpdate(timeUs_t currentTimeUs);
+
+bool vibrationIsActive(vibrationHarmonic_e harmonic);
+float vibrationGetAmplitude(vibrationSource_e source, vibrationHarmonic_e harmonic);
+float vibrationGetPhase(vibrationSource_e source, vibrationHarmonic_e harmonic);
+
+void vibrationResetFlight(void);
+void vibrationGetFlight(vibrationFlight_t *flight);
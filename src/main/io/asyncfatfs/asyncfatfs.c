@@ -58,7 +58,17 @@
     #define ONLY_EXPOSE_FOR_TESTING static
 #endif
 
+/*
+ * Blackbox logging streams sectors through this cache, so a deeper ring lets a multi-block write keep running while
+ * the log writer fills the following sectors. Only the larger MCUs can spare the RAM.
+ */
+#ifndef AFATFS_NUM_CACHE_SECTORS
+#if defined(STM32F7) || defined(STM32H7)
+#define AFATFS_NUM_CACHE_SECTORS 16
+#else
 #define AFATFS_NUM_CACHE_SECTORS 10
+#endif
+#endif
 
 // FAT filesystems are allowed to differ from these parameters, but we choose not to support those weird filesystems:
 #define AFATFS_SECTOR_SIZE  512
@@ -468,6 +478,11 @@ typedef struct afatfs_t {
     int cacheDirtyEntries; // The number of cache entries in the AFATFS_CACHE_STATE_DIRTY state
     bool cacheFlushInProgress;
 
+    /* The sector that would continue the multi-block write we started most recently, or zero if there isn't one. The
+     * MBR is never written, so zero is never a valid continuation.
+     */
+    uint32_t cacheFlushNextSector;
+
     afatfsFile_t openFiles[AFATFS_MAX_OPEN_FILES];
 
 #ifdef AFATFS_USE_FREEFILE
@@ -721,12 +736,14 @@ static void afatfs_cacheFlushSector(int cacheIndex)
             afatfs.cacheDirtyEntries--;
             cacheDescriptor->state = AFATFS_CACHE_STATE_WRITING;
             afatfs.cacheFlushInProgress = true;
+            afatfs.cacheFlushNextSector = cacheDescriptor->sectorIndex + 1;
             break;
 
         case SDCARD_OPERATION_SUCCESS:
             // Buffer is already transmitted
             afatfs.cacheDirtyEntries--;
             cacheDescriptor->state = AFATFS_CACHE_STATE_IN_SYNC;
+            afatfs.cacheFlushNextSector = cacheDescriptor->sectorIndex + 1;
             break;
 
         case SDCARD_OPERATION_BUSY:
@@ -839,16 +856,24 @@ static int afatfs_allocateCacheSector(uint32_t sectorIndex)
 bool afatfs_flush(void)
 {
     if (afatfs.cacheDirtyEntries > 0) {
-        // Flush the oldest flushable sector
+        /*
+         * Flush the sector which continues the previous write if we have it, so an append-mode file keeps the card in
+         * its multi-block write (writing any other sector would end it). Otherwise flush the oldest flushable sector.
+         */
         uint32_t earliestSectorTime = 0xFFFFFFFF;
         int earliestSectorIndex = -1;
 
         for (int i = 0; i < AFATFS_NUM_CACHE_SECTORS; i++) {
-            if (afatfs.cacheDescriptor[i].state == AFATFS_CACHE_STATE_DIRTY && !afatfs.cacheDescriptor[i].locked
-                && (earliestSectorIndex == -1 || afatfs.cacheDescriptor[i].writeTimestamp < earliestSectorTime)
-            ) {
-                earliestSectorIndex = i;
-                earliestSectorTime = afatfs.cacheDescriptor[i].writeTimestamp;
+            if (afatfs.cacheDescriptor[i].state == AFATFS_CACHE_STATE_DIRTY && !afatfs.cacheDescriptor[i].locked) {
+                if (afatfs.cacheFlushNextSector != 0 && afatfs.cacheDescriptor[i].sectorIndex == afatfs.cacheFlushNextSector) {
+                    earliestSectorIndex = i;
+                    break;
+                }
+
+                if (earliestSectorIndex == -1 || afatfs.cacheDescriptor[i].writeTimestamp < earliestSectorTime) {
+                    earliestSectorIndex = i;
+                    earliestSectorTime = afatfs.cacheDescriptor[i].writeTimestamp;
+                }
             }
         }
 
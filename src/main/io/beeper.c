@@ -23,6 +23,7 @@
 
 #include "platform.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "config/feature.h"
@@ -191,6 +192,15 @@ static uint32_t beeperNextToggleTime = 0;
 // Time of last arming beep in microseconds (for blackbox)
 static uint32_t armingBeepTimeMicros = 0;
 
+// The beeper task is due when the sequence is due to change next, without a
+// sequence it only polls the beeper modes at this period
+#define BEEPER_IDLE_PERIOD_US 100000
+
+static timeUs_t beeperTaskDueAt = 0;
+// Set by beeper(), which also runs in the gyro interrupt, so the task is
+// signalled through beeperCheck() and not rescheduled from there
+static volatile bool beeperStartPending = false;
+
 static void beeperProcessCommand(timeUs_t currentTimeUs);
 
 typedef struct beeperTableEntry_s {
@@ -284,6 +294,9 @@ void beeper(beeperMode_e mode)
 
     beeperPos = 0;
     beeperNextToggleTime = 0;
+
+    // start the sequence straight away
+    beeperStartPending = true;
 }
 
 void beeperSilence(void)
@@ -383,7 +396,35 @@ static void beeperGpsStatus(void)
  * Beeper handler function to be called periodically in loop. Updates beeper
  * state via time schedule.
  */
+static void beeperScheduleNext(timeUs_t currentTimeUs)
+{
+    timeDelta_t delay = BEEPER_IDLE_PERIOD_US;
+
+    if (currentBeeperEntry) {
+        delay = constrain(cmpTimeUs(beeperNextToggleTime, currentTimeUs), 0, BEEPER_IDLE_PERIOD_US);
+    }
+
+    beeperTaskDueAt = currentTimeUs + delay;
+}
+
+static void beeperStep(timeUs_t currentTimeUs);
+
+bool beeperCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentDeltaTimeUs);
+
+    return beeperStartPending || cmpTimeUs(currentTimeUs, beeperTaskDueAt) >= 0;
+}
+
 void beeperUpdate(timeUs_t currentTimeUs)
+{
+    beeperStartPending = false;
+
+    beeperStep(currentTimeUs);
+    beeperScheduleNext(currentTimeUs);
+}
+
+static void beeperStep(timeUs_t currentTimeUs)
 {
     // If beeper option from AUX switch has been selected
     if (IS_RC_MODE_ACTIVE(BOXBEEPERON)) {
@@ -95,6 +95,7 @@ typedef enum {
 
 void beeper(beeperMode_e mode);
 void beeperSilence(void);
+bool beeperCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 void beeperUpdate(timeUs_t currentTimeUs);
 void beeperConfirmationBeeps(uint8_t beepCount);
 void beeperWarningBeeps(uint8_t beepCount);
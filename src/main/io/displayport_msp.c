@@ -27,9 +27,11 @@
 
 #ifdef USE_MSP_DISPLAYPORT
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/display.h"
+#include "drivers/time.h"
 
 #include "io/displayport_msp.h"
 
@@ -39,6 +41,47 @@
 
 static displayPort_t mspDisplayPort;
 
+#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
+#define MSP_DISPLAYPORT_MAX_ROWS 13
+#define MSP_DISPLAYPORT_MAX_COLS 30
+#define MSP_DISPLAYPORT_BLANK ' '
+// MSP v1 framing plus the write string header, merging fewer unchanged cells than this into a run is cheaper than a new frame
+#define MSP_DISPLAYPORT_FRAME_OVERHEAD (6 + 4)
+#define MSP_DISPLAYPORT_TX_BURST 512U
+
+/*
+ * The screen is kept locally and only the cells that differ from what the
+ * remote display was sent last go out, as runs of changed cells with the
+ * same attribute, when the screen is drawn. Until the OSD draws the screen
+ * for the first time, writes go out immediately, a CMS only display is never
+ * drawn by the OSD task.
+ */
+typedef struct mspDisplayCell_s {
+    uint8_t c;
+    uint8_t attr;
+} mspDisplayCell_t;
+
+static mspDisplayCell_t screenCells[MSP_DISPLAYPORT_MAX_ROWS][MSP_DISPLAYPORT_MAX_COLS];
+static mspDisplayCell_t shadowCells[MSP_DISPLAYPORT_MAX_ROWS][MSP_DISPLAYPORT_MAX_COLS];
+static uint16_t dirtyRows;
+static bool screenBuffered = false;
+
+/*
+ * Cells are refreshed per class, warning and critical cells can be sent more
+ * often than the rest. All writes share a byte budget that refills at
+ * maxBytesPerSecond, so the OSD cannot saturate the VTX link.
+ */
+typedef enum {
+    MSP_DISPLAYPORT_CLASS_NORMAL = 0,
+    MSP_DISPLAYPORT_CLASS_ALERT,
+    MSP_DISPLAYPORT_CLASS_COUNT
+} mspDisplayClass_e;
+
+static timeUs_t classRefreshedUs[MSP_DISPLAYPORT_CLASS_COUNT];
+static uint32_t txBudget = MSP_DISPLAYPORT_TX_BURST;
+static timeUs_t txBudgetUs;
+static uint8_t flushStartRow;
+
 #ifdef USE_CLI
 extern uint8_t cliMode;
 #endif
@@ -53,7 +96,49 @@ static int output(displayPort_t *displayPort, uint8_t cmd, uint8_t *buf, int len
         return 0;
     }
 #endif
-    return mspSerialPush(displayPortProfileMsp()->displayPortSerial, cmd, buf, len, MSP_DIRECTION_REPLY);
+    const int written = mspSerialPush(displayPortProfileMsp()->displayPortSerial, cmd, buf, len, MSP_DIRECTION_REPLY);
+    txBudget -= MIN(txBudget, (uint32_t)MAX(written, 0));
+
+    return written;
+}
+
+static void txBudgetUpdate(timeUs_t currentTimeUs)
+{
+    const uint16_t maxBytesPerSecond = displayPortProfileMsp()->maxBytesPerSecond;
+
+    if (!maxBytesPerSecond) {
+        // unlimited, flushScreen() ignores the budget
+        txBudget = MSP_DISPLAYPORT_TX_BURST;
+    } else {
+        const uint32_t bytes = (uint64_t)cmpTimeUs(currentTimeUs, txBudgetUs) * maxBytesPerSecond / 1000000;
+        if (bytes) {
+            txBudget = MIN(txBudget + bytes, MSP_DISPLAYPORT_TX_BURST);
+            txBudgetUs = currentTimeUs;
+        }
+    }
+}
+
+static mspDisplayClass_e cellClass(uint8_t attr)
+{
+    return (attr & ~DISPLAYPORT_ATTR_BLINK) >= DISPLAYPORT_ATTR_WARNING ? MSP_DISPLAYPORT_CLASS_ALERT : MSP_DISPLAYPORT_CLASS_NORMAL;
+}
+
+// Returns a mask of the classes due for a refresh
+static uint8_t classesDue(timeUs_t currentTimeUs)
+{
+    const uint8_t refreshHz[MSP_DISPLAYPORT_CLASS_COUNT] = {
+        [MSP_DISPLAYPORT_CLASS_NORMAL] = displayPortProfileMsp()->refreshHz,
+        [MSP_DISPLAYPORT_CLASS_ALERT] = displayPortProfileMsp()->alertRefreshHz,
+    };
+    uint8_t due = 0;
+
+    for (int i = 0; i < MSP_DISPLAYPORT_CLASS_COUNT; i++) {
+        if (!refreshHz[i] || cmpTimeUs(currentTimeUs, classRefreshedUs[i]) >= (timeDelta_t)(1000000 / refreshHz[i])) {
+            due |= 1 << i;
+        }
+    }
+
+    return due;
 }
 
 static int heartbeat(displayPort_t *displayPort)
@@ -78,30 +163,51 @@ static int release(displayPort_t *displayPort)
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
-static int clearScreen(displayPort_t *displayPort)
+static void fillCells(mspDisplayCell_t cells[MSP_DISPLAYPORT_MAX_ROWS][MSP_DISPLAYPORT_MAX_COLS], uint8_t attr)
 {
-    uint8_t subcmd[] = { 2 };
-
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+    for (int row = 0; row < MSP_DISPLAYPORT_MAX_ROWS; row++) {
+        for (int col = 0; col < MSP_DISPLAYPORT_MAX_COLS; col++) {
+            cells[row][col].c = MSP_DISPLAYPORT_BLANK;
+            cells[row][col].attr = attr;
+        }
+    }
 }
 
-static int drawScreen(displayPort_t *displayPort)
+// Clears the remote display, the shadow then matches it
+static int sendClearScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 4 };
+    uint8_t subcmd[] = { 2 };
+
+    fillCells(shadowCells, DISPLAYPORT_ATTR_NONE);
+    dirtyRows = (1 << MSP_DISPLAYPORT_MAX_ROWS) - 1;
+
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
-static int screenSize(const displayPort_t *displayPort)
+static int clearScreen(displayPort_t *displayPort)
 {
-    return displayPort->rows * displayPort->cols;
+    if (!screenBuffered) {
+        fillCells(screenCells, DISPLAYPORT_ATTR_NONE);
+        return sendClearScreen(displayPort);
+    }
+
+    for (int row = 0; row < MSP_DISPLAYPORT_MAX_ROWS; row++) {
+        for (int col = 0; col < MSP_DISPLAYPORT_MAX_COLS; col++) {
+            if (screenCells[row][col].c != MSP_DISPLAYPORT_BLANK || screenCells[row][col].attr != DISPLAYPORT_ATTR_NONE) {
+                screenCells[row][col].c = MSP_DISPLAYPORT_BLANK;
+                screenCells[row][col].attr = DISPLAYPORT_ATTR_NONE;
+                dirtyRows |= 1 << row;
+            }
+        }
+    }
+
+    return 0;
 }
 
-static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, const char *string)
+static int sendString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, const char *string, int len)
 {
-#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
     uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
 
-    int len = strlen(string);
     if (len >= MSP_OSD_MAX_STRING_LENGTH) {
         len = MSP_OSD_MAX_STRING_LENGTH;
     }
@@ -115,6 +221,156 @@ static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, uin
     return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
 }
 
+static bool cellChanged(int row, int col)
+{
+    return screenCells[row][col].c != shadowCells[row][col].c || screenCells[row][col].attr != shadowCells[row][col].attr;
+}
+
+// Sends the runs of changed cells of the due classes. Runs with the same attribute are
+// merged across short gaps of unchanged cells to save frames. Rows that do not fit
+// the TX buffer or the byte budget stay dirty for the next call, and the shadow only
+// takes the cells of the frames the serial port accepted.
+static bool flushScreen(displayPort_t *displayPort, uint8_t classMask)
+{
+    const int rows = MIN(displayPort->rows, MSP_DISPLAYPORT_MAX_ROWS);
+    // without a rate limit only the TX buffer holds a flush back
+    const bool budgeted = displayPortProfileMsp()->maxBytesPerSecond != 0;
+    int firstStarvedRow = -1;
+    bool sent = false;
+    bool txFull = false;
+
+    // start at the first row the budget ran out on last time so the bottom rows are not starved
+    for (int i = 0; i < rows && !txFull; i++) {
+        const int row = (flushStartRow + i) % rows;
+        if (!(dirtyRows & (1 << row))) {
+            continue;
+        }
+
+        if (mspSerialTxBytesFree() < MSP_DISPLAYPORT_MAX_COLS * 2) {
+            break;
+        }
+        dirtyRows &= ~(1 << row);
+
+        const int cols = MIN(displayPort->cols, MSP_DISPLAYPORT_MAX_COLS);
+        int col = 0;
+        while (col < cols) {
+            if (!cellChanged(row, col)) {
+                col++;
+                continue;
+            }
+
+            const uint8_t attr = screenCells[row][col].attr;
+            int end = col + 1;
+            for (int next = end; next < cols && screenCells[row][next].attr == attr && next - end < MSP_DISPLAYPORT_FRAME_OVERHEAD; next++) {
+                if (cellChanged(row, next)) {
+                    end = next + 1;
+                }
+            }
+
+            const bool due = classMask & (1 << cellClass(attr));
+            if (!due || (budgeted && txBudget < (uint32_t)(end - col + MSP_DISPLAYPORT_FRAME_OVERHEAD))) {
+                // not due or over budget, sent by a later refresh
+                if (due && firstStarvedRow < 0) {
+                    firstStarvedRow = row;
+                }
+                dirtyRows |= 1 << row;
+                col = end;
+                continue;
+            }
+
+            char run[MSP_DISPLAYPORT_MAX_COLS];
+            int len = 0;
+            for (int next = col; next < end; next++) {
+                run[len++] = screenCells[row][next].c;
+            }
+
+            if (sendString(displayPort, col, row, attr, run, len) <= 0) {
+                // the frame didn't fit, the rest of the screen waits for the next refresh
+                if (firstStarvedRow < 0) {
+                    firstStarvedRow = row;
+                }
+                dirtyRows |= 1 << row;
+                txFull = true;
+                break;
+            }
+
+            for (; col < end; col++) {
+                shadowCells[row][col] = screenCells[row][col];
+            }
+            sent = true;
+        }
+    }
+
+    if (firstStarvedRow >= 0) {
+        flushStartRow = firstStarvedRow;
+    }
+
+    return sent;
+}
+
+static int drawScreen(displayPort_t *displayPort)
+{
+    uint8_t subcmd[] = { 4 };
+
+    screenBuffered = true;
+
+    const timeUs_t currentTimeUs = micros();
+    const uint8_t due = classesDue(currentTimeUs);
+    txBudgetUpdate(currentTimeUs);
+
+    for (int i = 0; i < MSP_DISPLAYPORT_CLASS_COUNT; i++) {
+        if (due & (1 << i)) {
+            classRefreshedUs[i] = currentTimeUs;
+        }
+    }
+
+    if (!flushScreen(displayPort, due)) {
+        return 0;
+    }
+
+    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+}
+
+static void commitTransaction(displayPort_t *displayPort)
+{
+    if (screenBuffered) {
+        drawScreen(displayPort);
+    }
+}
+
+static int screenSize(const displayPort_t *displayPort)
+{
+    return displayPort->rows * displayPort->cols;
+}
+
+static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, const char *string)
+{
+    if (row < MSP_DISPLAYPORT_MAX_ROWS) {
+        mspDisplayCell_t *cells = screenCells[row];
+        for (int i = 0; string[i] && col + i < MSP_DISPLAYPORT_MAX_COLS; i++) {
+            if (cells[col + i].c != (uint8_t)string[i] || cells[col + i].attr != attr) {
+                cells[col + i].c = string[i];
+                cells[col + i].attr = attr;
+                dirtyRows |= 1 << row;
+            }
+        }
+    }
+
+    if (screenBuffered) {
+        return 0;
+    }
+
+    // not drawn by the OSD task, the remote display is kept in sync straight away
+    const int len = strlen(string);
+    const int written = sendString(displayPort, col, row, attr, string, len);
+    if (written > 0 && row < MSP_DISPLAYPORT_MAX_ROWS) {
+        for (int i = 0; i < len && col + i < MSP_DISPLAYPORT_MAX_COLS; i++) {
+            shadowCells[row][col + i] = screenCells[row][col + i];
+        }
+    }
+    return written;
+}
+
 static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, uint8_t c)
 {
     char buf[2];
@@ -138,9 +394,17 @@ static bool isSynced(const displayPort_t *displayPort)
 
 static void resync(displayPort_t *displayPort)
 {
+    uint8_t subcmd[] = { 4 };
+
     displayPort->rows = 13 + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
     displayPort->cols = 30 + displayPortProfileMsp()->colAdjust;
-    drawScreen(displayPort);
+
+    // the remote display may have been restarted, clear it and send the whole screen again
+    sendClearScreen(displayPort);
+    if (screenBuffered) {
+        flushScreen(displayPort, (1 << MSP_DISPLAYPORT_CLASS_COUNT) - 1);
+    }
+    output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
 static uint32_t txBytesFree(const displayPort_t *displayPort)
@@ -165,6 +429,7 @@ static const displayPortVTable_t mspDisplayPortVTable = {
     .layerSupported = NULL,
     .layerSelect = NULL,
     .layerCopy = NULL,
+    .commitTransaction = commitTransaction,
 };
 
 displayPort_t *displayPortMspInit(void)
@@ -184,6 +449,7 @@ displayPort_t *displayPortMspInit(void)
     }
 #endif
 
+    fillCells(screenCells, DISPLAYPORT_ATTR_NONE);
     displayInit(&mspDisplayPort, &mspDisplayPortVTable);
     resync(&mspDisplayPort);
     return &mspDisplayPort;
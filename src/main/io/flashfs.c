@@ -39,6 +39,7 @@
 #include "platform.h"
 
 #include "common/printf.h"
+#include "common/maths.h"
 #include "drivers/flash.h"
 
 #include "io/flashfs.h"
@@ -56,11 +57,74 @@ static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
  *
  * When the circular buffer is empty, head == tail
  */
-static uint8_t bufferHead = 0, bufferTail = 0;
+static uint16_t bufferHead = 0, bufferTail = 0;
 
 // The position of the buffer's tail in the overall flash address space:
 static uint32_t tailAddress = 0;
 
+// Bytes of asynchronous writes discarded because the buffer was full, since boot
+static uint32_t droppedBytes = 0;
+
+/*
+ * Background erase. A requested erase is queued as a range of sectors which are erased one at a time whenever the
+ * chip is idle, so erasing never blocks the caller for longer than a single sector. While the blackbox is stopped the
+ * sectors just ahead of the tail are erased too, so that the next log doesn't have to wait for or write into an
+ * unerased sector.
+ *
+ * The sectors that are known to be erased are tracked in a bitmap.
+ */
+#define FLASHFS_ERASE_BITMAP_SECTORS 2048
+#define FLASHFS_ERASE_AHEAD_SECTORS 16
+
+static uint32_t erasedSectors[FLASHFS_ERASE_BITMAP_SECTORS / 32];
+
+static flashSector_t eraseStartSector;
+static flashSector_t eraseNextSector;
+static flashSector_t eraseEndSector;   // one past the last sector to erase, eraseNextSector == eraseEndSector when none are queued
+static bool eraseChipPending;          // a whole chip erase was issued and hasn't completed yet
+
+#ifdef USE_FLASHFS_LOG_INDEX
+/*
+ * Log index. Each closed log gets an entry appended to a reserved sector past the end of the flashfs, so the start of
+ * the free space and the log boundaries can be found without searching the logs themselves. Entries are programmed
+ * once into erased slots and the whole index is erased along with the flashfs. NAND pages can't be programmed more
+ * than once, so there each entry takes a page of its own.
+ */
+#define FLASHFS_LOG_INDEX_CHECK 0x4C4F4749 // "LOGI"
+
+static const flashPartition_t *logIndexPartition = NULL;
+static int logIndexCount = 0;
+#endif
+
+static bool flashfsSectorIsErased(flashSector_t sector)
+{
+    return sector < FLASHFS_ERASE_BITMAP_SECTORS && (erasedSectors[sector / 32] & (1U << (sector % 32)));
+}
+
+static void flashfsSetSectorErased(flashSector_t sector, bool erased)
+{
+    if (sector < FLASHFS_ERASE_BITMAP_SECTORS) {
+        if (erased) {
+            erasedSectors[sector / 32] |= 1U << (sector % 32);
+        } else {
+            erasedSectors[sector / 32] &= ~(1U << (sector % 32));
+        }
+    }
+}
+
+static bool flashfsErasePending(void)
+{
+    return eraseNextSector != eraseEndSector || eraseChipPending;
+}
+
+// True if the given address lies in a sector that is still queued for erasing
+static bool flashfsAddressIsErasePending(uint32_t address)
+{
+    const flashSector_t sector = address / flashGeometry->sectorSize;
+
+    return sector >= eraseNextSector && sector < eraseEndSector;
+}
+
 static void flashfsClearBuffer(void)
 {
     bufferTail = bufferHead = 0;
@@ -76,25 +140,142 @@ static void flashfsSetTailAddress(uint32_t address)
     tailAddress = address;
 }
 
+#ifdef USE_FLASHFS_LOG_INDEX
+static uint32_t flashfsLogIndexSlotSize(void)
+{
+    return flashGeometry->flashType == FLASH_TYPE_NAND ? flashGeometry->pageSize : sizeof(flashfsLogIndexEntry_t);
+}
+
+static int flashfsLogIndexCapacity(void)
+{
+    if (!logIndexPartition) {
+        return 0;
+    }
+
+    return FLASH_PARTITION_SECTOR_COUNT(logIndexPartition) * flashGeometry->sectorSize / flashfsLogIndexSlotSize();
+}
+
+static bool flashfsLogIndexReadSlot(int index, flashfsLogIndexEntry_t *entry)
+{
+    const uint32_t address = logIndexPartition->startSector * flashGeometry->sectorSize + index * flashfsLogIndexSlotSize();
+
+    return flashReadBytes(address, (uint8_t *)entry, sizeof(*entry)) == sizeof(*entry);
+}
+
+static uint32_t flashfsLogIndexCheck(const flashfsLogIndexEntry_t *entry)
+{
+    return entry->offset ^ entry->size ^ entry->durationMs ^ FLASHFS_LOG_INDEX_CHECK;
+}
+
+// Entries are appended in order, so the first erased slot can be found with a binary search
+static void flashfsLogIndexInit(void)
+{
+    logIndexPartition = flashPartitionFindByType(FLASH_PARTITION_TYPE_FLASHFS_INDEX);
+
+    int left = 0;
+    // An index that is still queued for erasing is as good as empty
+    int right = flashfsErasePending() ? 0 : flashfsLogIndexCapacity();
+
+    while (left < right) {
+        const int mid = (left + right) / 2;
+        flashfsLogIndexEntry_t entry;
+
+        if (!flashfsLogIndexReadSlot(mid, &entry)) {
+            // Unexpected timeout from flash, so ignore the index
+            right = 0;
+            break;
+        }
+
+        if (entry.offset == 0xFFFFFFFF) {
+            right = mid;
+        } else {
+            left = mid + 1;
+        }
+    }
+
+    logIndexCount = right;
+}
+
+/**
+ * Append an entry for a closed log. The flashfs must be flushed and closed first, the NAND driver only has one program
+ * buffer.
+ */
+bool flashfsLogIndexAppend(uint32_t offset, uint32_t size, uint32_t durationMs)
+{
+    if (logIndexCount >= flashfsLogIndexCapacity() || flashfsErasePending()) {
+        return false;
+    }
+
+    flashfsLogIndexEntry_t entry = {
+        .offset = offset,
+        .size = size,
+        .durationMs = durationMs,
+    };
+    entry.check = flashfsLogIndexCheck(&entry);
+
+    const uint32_t address = logIndexPartition->startSector * flashGeometry->sectorSize + logIndexCount * flashfsLogIndexSlotSize();
+
+    flashPageProgram(address, (const uint8_t *)&entry, sizeof(entry));
+    flashFlush();
+
+    logIndexCount++;
+
+    return true;
+}
+
+int flashfsLogIndexGetCount(void)
+{
+    return logIndexCount;
+}
+
+/**
+ * Read back an index entry, returns false if it's out of range or wasn't programmed completely.
+ */
+bool flashfsLogIndexGetEntry(int index, flashfsLogIndexEntry_t *entry)
+{
+    if (index < 0 || index >= logIndexCount || !flashfsLogIndexReadSlot(index, entry)) {
+        return false;
+    }
+
+    return entry->check == flashfsLogIndexCheck(entry);
+}
+#endif
+
+/**
+ * Erase the whole flashfs partition. This returns immediately, the erase runs in the background until
+ * flashfsIsReady() returns true.
+ */
 void flashfsEraseCompletely(void)
 {
     if (flashGeometry->sectors > 0 && flashPartitionCount() > 0) {
-        // if there's a single FLASHFS partition and it uses the entire flash then do a full erase
-        const bool doFullErase = (flashPartitionCount() == 1) && (FLASH_PARTITION_SECTOR_COUNT(flashPartition) == flashGeometry->sectors);
+        int partitionCount = 1;
+        flashSector_t endSector = flashPartition->endSector;
+
+#ifdef USE_FLASHFS_LOG_INDEX
+        // The index follows the flashfs, so it's erased along with it
+        if (logIndexPartition) {
+            partitionCount++;
+            endSector = logIndexPartition->endSector;
+            logIndexCount = 0;
+        }
+#endif
+
+        // if there's a single FLASHFS partition and it uses the entire NOR flash then do a full erase, the NAND
+        // parts can only erase a block at a time
+        const bool doFullErase = (flashPartitionCount() == partitionCount) && (endSector + 1 - flashPartition->startSector == flashGeometry->sectors)
+            && flashGeometry->flashType == FLASH_TYPE_NOR;
         if (doFullErase) {
             flashEraseCompletely();
-        } else {
 
-            // TODO - the partial sector-based erase needs to be completely reworked.
-            // All calls to flashfsEraseCompletely() currently expect the erase to run
-            // asynchronously and return immediately. The current implementation performs
-            // the erase synchronously and doesn't return until complete. This breaks calls
-            // from MSP and runtime mode-switched erasing.
+            eraseNextSector = eraseEndSector = 0;
+            eraseChipPending = true;
+        } else {
+            eraseStartSector = eraseNextSector = flashPartition->startSector;
+            eraseEndSector = endSector + 1;
+        }
 
-            for (flashSector_t sectorIndex = flashPartition->startSector; sectorIndex <= flashPartition->endSector; sectorIndex++) {
-                uint32_t sectorAddress = sectorIndex * flashGeometry->sectorSize;
-                flashEraseSector(sectorAddress);
-            }
+        for (flashSector_t sectorIndex = flashPartition->startSector; sectorIndex <= flashPartition->endSector; sectorIndex++) {
+            flashfsSetSectorErased(sectorIndex, true);
         }
     }
 
@@ -126,17 +307,83 @@ void flashfsEraseRange(uint32_t start, uint32_t end)
     for (int sectorIndex = startSector; sectorIndex < endSector; sectorIndex++) {
         uint32_t sectorAddress = sectorIndex * flashGeometry->sectorSize;
         flashEraseSector(sectorAddress);
+        flashfsSetSectorErased(sectorIndex, true);
+    }
+
+#ifdef USE_FLASHFS_LOG_INDEX
+    // Logs in the erased range may still be listed in the index, so drop it
+    if (logIndexPartition && logIndexCount > 0) {
+        for (flashSector_t sectorIndex = logIndexPartition->startSector; sectorIndex <= logIndexPartition->endSector; sectorIndex++) {
+            flashEraseSector(sectorIndex * flashGeometry->sectorSize);
+        }
+        logIndexCount = 0;
     }
+#endif
 }
 
 /**
- * Return true if the flash is not currently occupied with an operation.
+ * Issue the next sector erase of a queued erase if the chip is idle. With eraseAhead set and nothing queued, erase
+ * the sectors ahead of the tail instead, which is only safe while nothing is being logged.
+ */
+void flashfsEraseUpdate(bool eraseAhead)
+{
+    if (!flashfsIsSupported() || !flashIsReady()) {
+        return;
+    }
+
+    eraseChipPending = false;
+
+    if (eraseNextSector != eraseEndSector) {
+        flashEraseSector(eraseNextSector * flashGeometry->sectorSize);
+        eraseNextSector++;
+        return;
+    }
+
+    if (!eraseAhead || !flashfsBufferIsEmpty()) {
+        return;
+    }
+
+    // The sector holding the tail can't be erased unless nothing was written to it yet
+    const uint32_t sectorSize = flashGeometry->sectorSize;
+    const flashSector_t firstSector = (tailAddress + sectorSize - 1) / sectorSize;
+    const flashSector_t endSector = MIN((uint32_t)firstSector + FLASHFS_ERASE_AHEAD_SECTORS, flashfsSize / sectorSize);
+
+    for (flashSector_t sector = firstSector; sector < endSector; sector++) {
+        if (!flashfsSectorIsErased(sector)) {
+            flashEraseSector(sector * sectorSize);
+            flashfsSetSectorErased(sector, true);
+            return;
+        }
+    }
+}
+
+/**
+ * Percentage of a requested erase that has been done, 100 when no erase is in progress.
+ */
+uint8_t flashfsGetEraseProgress(void)
+{
+    if (eraseChipPending) {
+        return 0;
+    }
+    if (eraseNextSector == eraseEndSector) {
+        return 100;
+    }
+    return (eraseNextSector - eraseStartSector) * 100 / (eraseEndSector - eraseStartSector);
+}
+
+/**
+ * Return true if the flash is not currently occupied with an operation. Polling this also drives a requested erase.
  */
 bool flashfsIsReady(void)
 {
     // Check for flash chip existence first, then check if ready.
+    if (!flashfsIsSupported()) {
+        return false;
+    }
+
+    flashfsEraseUpdate(false);
 
-    return (flashfsIsSupported() && flashIsReady());
+    return !flashfsErasePending() && flashIsReady();
 }
 
 bool flashfsIsSupported(void)
@@ -206,6 +453,16 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
         return 0;
     }
 
+    // Don't write into a sector that the background erase hasn't got to yet
+    while (flashfsAddressIsErasePending(tailAddress)) {
+        if (!sync) {
+            flashfsEraseUpdate(false);
+            return 0;
+        }
+        flashWaitForReady();
+        flashfsEraseUpdate(false);
+    }
+
     uint32_t bytesTotalRemaining = bytesTotal;
 
     uint16_t pageSize = flashGeometry->pageSize;
@@ -232,6 +489,9 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
             break;
         }
 
+        // The sector is no longer blank once we write into it
+        flashfsSetSectorErased(tailAddress / flashGeometry->sectorSize, false);
+
         flashPageProgramBegin(tailAddress);
 
         bytesRemainThisIteration = bytesTotalThisIteration;
@@ -388,6 +648,11 @@ void flashfsSeekRel(int32_t offset)
     flashfsSetTailAddress(tailAddress + offset);
 }
 
+uint32_t flashfsGetDroppedBytes(void)
+{
+    return droppedBytes;
+}
+
 /**
  * Write the given byte asynchronously to the flash. If the buffer overflows, data is silently discarded.
  */
@@ -456,6 +721,7 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync)
                  * Silently drop the data the user asked to write (i.e. no-op) since we can't buffer it and they
                  * requested async.
                  */
+                droppedBytes += bufferSizes[2];
             }
 
             return;
@@ -550,6 +816,14 @@ int flashfsIdentifyStartOfFreeSpace(void)
     int i;
     bool blockErased;
 
+#ifdef USE_FLASHFS_LOG_INDEX
+    // Everything up to the end of the last indexed log is known to be written, only a log that wasn't closed can follow
+    flashfsLogIndexEntry_t lastLog;
+    if (flashfsLogIndexGetEntry(logIndexCount - 1, &lastLog) && lastLog.offset + lastLog.size <= flashfsSize) {
+        left = (lastLog.offset + lastLog.size) / FREE_BLOCK_SIZE;
+    }
+#endif
+
     while (left < right) {
         mid = (left + right) / 2;
 
@@ -623,6 +897,10 @@ void flashfsInit(void)
 
     flashfsSize = FLASH_PARTITION_SECTOR_COUNT(flashPartition) * flashGeometry->sectorSize;
 
+#ifdef USE_FLASHFS_LOG_INDEX
+    flashfsLogIndexInit();
+#endif
+
     // Start the file pointer off at the beginning of free space so caller can start writing immediately
     flashfsSeekAbs(flashfsIdentifyStartOfFreeSpace());
 }
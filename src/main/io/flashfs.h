@@ -20,19 +20,35 @@
 
 #pragma once
 
+#ifdef USE_FLASH_W25N01G
+// Room for a whole NAND page while the chip programs the previous one out of its own page buffer, so the
+// logging doesn't drop data for the duration of a program execute
+#define FLASHFS_WRITE_BUFFER_SIZE 2048
+#else
 #define FLASHFS_WRITE_BUFFER_SIZE 128
+#endif
 #define FLASHFS_WRITE_BUFFER_USABLE (FLASHFS_WRITE_BUFFER_SIZE - 1)
 
 // Automatically trigger a flush when this much data is in the buffer
 #define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN 64
 
+typedef struct flashfsLogIndexEntry_s {
+    uint32_t offset;        // start of the log within the flashfs volume
+    uint32_t size;          // length of the log in bytes
+    uint32_t durationMs;    // time from opening to closing the log
+    uint32_t check;         // guards against an entry that was only partly programmed
+} flashfsLogIndexEntry_t;
+
 void flashfsEraseCompletely(void);
 void flashfsEraseRange(uint32_t start, uint32_t end);
+void flashfsEraseUpdate(bool eraseAhead);
+uint8_t flashfsGetEraseProgress(void);
 
 uint32_t flashfsGetSize(void);
 uint32_t flashfsGetOffset(void);
 uint32_t flashfsGetWriteBufferFreeSpace(void);
 uint32_t flashfsGetWriteBufferSize(void);
+uint32_t flashfsGetDroppedBytes(void);
 int flashfsIdentifyStartOfFreeSpace(void);
 struct flashGeometry_s;
 const struct flashGeometry_s* flashfsGetGeometry(void);
@@ -57,3 +73,9 @@ bool flashfsIsEOF(void);
 
 bool flashfsVerifyEntireFlash(void);
 
+#ifdef USE_FLASHFS_LOG_INDEX
+bool flashfsLogIndexAppend(uint32_t offset, uint32_t size, uint32_t durationMs);
+int flashfsLogIndexGetCount(void);
+bool flashfsLogIndexGetEntry(int index, flashfsLogIndexEntry_t *entry);
+#endif
+
@@ -65,6 +65,7 @@
 #define LOG_UBLOX_SVINFO 'I'
 #define LOG_UBLOX_POSLLH 'P'
 #define LOG_UBLOX_VELNED 'V'
+#define LOG_UBLOX_PVT    'p'
 
 #define GPS_SV_MAXSATS   16
 
@@ -223,7 +224,7 @@ typedef enum {
 gpsData_t gpsData;
 
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 1);
 
 PG_RESET_TEMPLATE(gpsConfig_t, gpsConfig,
     .provider = GPS_NMEA,
@@ -232,7 +233,9 @@ PG_RESET_TEMPLATE(gpsConfig_t, gpsConfig,
     .autoBaud = GPS_AUTOBAUD_OFF,
     .gps_ublox_use_galileo = false,
     .gps_set_home_point_once = false,
-    .gps_use_3d_speed = false
+    .gps_use_3d_speed = false,
+    .gps_ublox_use_pvt = false,
+    .gps_ublox_nav_hz = 5,
 );
 
 static void shiftPacketLog(void)
@@ -361,6 +364,58 @@ void gpsInitNmea(void)
 #endif // USE_GPS_NMEA
 
 #ifdef USE_GPS_UBLOX
+static void ubloxSendMessage(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint8_t length)
+{
+    const uint8_t header[] = { 0xB5, 0x62, msgClass, msgId, length, 0x00 };
+    uint8_t ckA = 0;
+    uint8_t ckB = 0;
+
+    for (int i = 2; i < (int)sizeof(header); i++) {
+        ckB += (ckA += header[i]);
+    }
+    for (int i = 0; i < length; i++) {
+        ckB += (ckA += payload[i]);
+    }
+    const uint8_t checksum[] = { ckA, ckB };
+
+    serialWriteBuf(gpsPort, header, sizeof(header));
+    serialWriteBuf(gpsPort, payload, length);
+    serialWriteBuf(gpsPort, checksum, sizeof(checksum));
+}
+
+// CFG-MSG rates for the NAV-PVT fast path, the separate NAV messages are replaced by it
+static const uint8_t ubloxPvtMessages[][3] = {
+    { 0x01, 0x02, 0 },          // POSLLH off
+    { 0x01, 0x03, 0 },          // STATUS off
+    { 0x01, 0x06, 0 },          // SOL off
+    { 0x01, 0x12, 0 },          // VELNED off
+    { 0x01, 0x07, 1 },          // PVT every solution
+};
+
+#define UBLOX_PVT_MESSAGE_COUNT ARRAYLEN(ubloxPvtMessages)
+
+// One message per call, the next waits for the transmit buffer to drain
+static bool ubloxConfigureNavRate(uint32_t position)
+{
+    if (gpsConfig()->gps_ublox_use_pvt) {
+        if (position < UBLOX_PVT_MESSAGE_COUNT) {
+            ubloxSendMessage(0x06, 0x01, ubloxPvtMessages[position], 3);
+            return true;
+        }
+        position -= UBLOX_PVT_MESSAGE_COUNT;
+    }
+
+    if (position == 0) {
+        // CFG-RATE: measurement period, one solution per measurement, aligned to GPS time
+        const uint16_t periodMs = 1000 / constrain(gpsConfig()->gps_ublox_nav_hz, 1, GPS_UBLOX_NAV_HZ_MAX);
+        const uint8_t rate[] = { periodMs & 0xFF, periodMs >> 8, 0x01, 0x00, 0x01, 0x00 };
+        ubloxSendMessage(0x06, 0x08, rate, sizeof(rate));
+        return true;
+    }
+
+    return false;
+}
+
 void gpsInitUblox(void)
 {
     uint32_t now;
@@ -455,6 +510,15 @@ void gpsInitUblox(void)
                 }
             }
 
+            if (gpsData.messageState == GPS_MESSAGE_STATE_NAV_RATE) {
+                if (ubloxConfigureNavRate(gpsData.state_position)) {
+                    gpsData.state_position++;
+                } else {
+                    gpsData.state_position = 0;
+                    gpsData.messageState++;
+                }
+            }
+
             if (gpsData.messageState >= GPS_MESSAGE_STATE_ENTRY_COUNT) {
                 // ublox should be initialised, try receiving
                 gpsSetState(GPS_RECEIVING_DATA);
@@ -492,6 +556,31 @@ static void updateGpsIndicator(timeUs_t currentTimeUs)
     }
 }
 
+// A burst of GPS messages is taken as complete once the line has been idle for this long
+#define GPS_FRAME_IDLE_US 500
+
+/*
+ * Signals the GPS task when a burst of messages has come in, detected as an idle gap in the
+ * received bytes, or when GPS data has been sent over MSP.
+ */
+bool gpsFrameReceived(timeUs_t currentTimeUs)
+{
+    static uint32_t lastBytesWaiting = 0;
+    static timeUs_t lastByteAt = 0;
+
+    if (!gpsPort) {
+        return GPS_update & GPS_MSP_UPDATE;
+    }
+
+    const uint32_t bytesWaiting = serialRxBytesWaiting(gpsPort);
+    if (bytesWaiting != lastBytesWaiting) {
+        lastBytesWaiting = bytesWaiting;
+        lastByteAt = currentTimeUs;
+        return false;
+    }
+    return bytesWaiting && cmpTimeUs(currentTimeUs, lastByteAt) >= GPS_FRAME_IDLE_US;
+}
+
 void gpsUpdate(timeUs_t currentTimeUs)
 {
     // read out available GPS bytes
@@ -958,6 +1047,41 @@ typedef struct {
     uint32_t heading_accuracy;
 } ubx_nav_velned;
 
+typedef struct {
+    uint32_t time;              // GPS msToW
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;
+    uint32_t time_accuracy;
+    int32_t time_nsec;
+    uint8_t fix_type;
+    uint8_t fix_status;
+    uint8_t fix_status2;
+    uint8_t satellites;
+    int32_t longitude;
+    int32_t latitude;
+    int32_t altitude_ellipsoid;
+    int32_t altitudeMslMm;
+    uint32_t horizontal_accuracy;
+    uint32_t vertical_accuracy;
+    int32_t ned_north;          // mm/s
+    int32_t ned_east;
+    int32_t ned_down;
+    int32_t speed_2d;
+    int32_t heading_2d;         // deg * 1e5
+    uint32_t speed_accuracy;
+    uint32_t heading_accuracy;
+    uint16_t position_DOP;
+    uint8_t res[6];
+    int32_t heading_vehicle;
+    int16_t mag_declination;
+    uint16_t mag_accuracy;
+} ubx_nav_pvt;
+
 typedef struct {
     uint8_t chn;                // Channel number, 255 for SVx not assigned to channel
     uint8_t svid;               // Satellite ID
@@ -988,6 +1112,7 @@ enum {
     MSG_POSLLH = 0x2,
     MSG_STATUS = 0x3,
     MSG_SOL = 0x6,
+    MSG_PVT = 0x7,
     MSG_VELNED = 0x12,
     MSG_SVINFO = 0x30,
     MSG_CFG_PRT = 0x00,
@@ -1005,6 +1130,12 @@ enum {
     FIX_TIME = 5
 } ubs_nav_fix_type;
 
+enum {
+    NAV_PVT_VALID_DATE = 1,
+    NAV_PVT_VALID_TIME = 2,
+    NAV_PVT_FULLY_RESOLVED = 4
+} ubx_nav_pvt_valid_bits;
+
 enum {
     NAV_STATUS_FIX_VALID = 1,
     NAV_STATUS_TIME_WEEK_VALID = 4,
@@ -1054,6 +1185,7 @@ static union {
     ubx_nav_status status;
     ubx_nav_solution solution;
     ubx_nav_velned velned;
+    ubx_nav_pvt pvt;
     ubx_nav_svinfo svinfo;
     uint8_t bytes[UBLOX_PAYLOAD_SIZE];
 } _buffer;
@@ -1117,6 +1249,41 @@ static bool UBLOX_parse_gps(void)
         gpsSol.groundCourse = (uint16_t) (_buffer.velned.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
         _new_speed = true;
         break;
+    case MSG_PVT:
+        // Position, velocity and fix of one solution, decoded straight from the receive buffer
+        *gpsPacketLogChar = LOG_UBLOX_PVT;
+        next_fix = (_buffer.pvt.fix_status & NAV_STATUS_FIX_VALID) && (_buffer.pvt.fix_type == FIX_3D);
+        if (next_fix) {
+            ENABLE_STATE(GPS_FIX);
+        } else {
+            DISABLE_STATE(GPS_FIX);
+        }
+        gpsSol.llh.lon = _buffer.pvt.longitude;
+        gpsSol.llh.lat = _buffer.pvt.latitude;
+        gpsSol.llh.altCm = _buffer.pvt.altitudeMslMm / 10;  //alt in cm
+        gpsSol.numSat = _buffer.pvt.satellites;
+        gpsSol.hdop = _buffer.pvt.position_DOP;
+        gpsSol.groundSpeed = _buffer.pvt.speed_2d / 10;    // cm/s
+        gpsSol.speed3d = lrintf(sqrtf(sq((float)_buffer.pvt.speed_2d) + sq((float)_buffer.pvt.ned_down)) / 10);
+        gpsSol.groundCourse = (uint16_t) (_buffer.pvt.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+#ifdef USE_RTC_TIME
+        //set clock, when gps time is available
+        if (!rtcHasTime() && (_buffer.pvt.valid & NAV_PVT_VALID_DATE) && (_buffer.pvt.valid & NAV_PVT_VALID_TIME)) {
+            dateTime_t dt = {
+                .year = _buffer.pvt.year,
+                .month = _buffer.pvt.month,
+                .day = _buffer.pvt.day,
+                .hours = _buffer.pvt.hour,
+                .minutes = _buffer.pvt.min,
+                .seconds = _buffer.pvt.sec,
+                .millis = (_buffer.pvt.time_nsec > 0) ? _buffer.pvt.time_nsec / 1000000 : 0,
+            };
+            rtcSetDateTime(&dt);
+        }
+#endif
+        _new_position = true;
+        _new_speed = true;
+        break;
     case MSG_SVINFO:
         *gpsPacketLogChar = LOG_UBLOX_SVINFO;
         GPS_numCh = _buffer.svinfo.numCh;
@@ -1284,7 +1451,7 @@ static void GPS_calculateDistanceFlownVerticalSpeed(bool initialize)
                 int32_t dir;
                 GPS_distance_cm_bearing(&gpsSol.llh.lat, &gpsSol.llh.lon, &lastCoord[LAT], &lastCoord[LON], &dist, &dir);
                 if (gpsConfig()->gps_use_3d_speed) {
-                    dist = sqrtf(powf(gpsSol.llh.altCm - lastAlt, 2.0f) + powf(dist, 2.0f));
+                    dist = sqrtf(sq((float)(gpsSol.llh.altCm - lastAlt)) + sq((float)dist));
                 }
                 GPS_distanceFlownInCm += dist;
             }
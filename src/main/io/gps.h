@@ -68,6 +68,8 @@ typedef enum {
 
 #define GPS_BAUDRATE_MAX GPS_BAUDRATE_9600
 
+#define GPS_UBLOX_NAV_HZ_MAX 25
+
 typedef struct gpsConfig_s {
     gpsProvider_e provider;
     sbasMode_e sbasMode;
@@ -76,6 +78,8 @@ typedef struct gpsConfig_s {
     uint8_t gps_ublox_use_galileo;
     uint8_t gps_set_home_point_once;
     uint8_t gps_use_3d_speed;
+    uint8_t gps_ublox_use_pvt;      // single NAV-PVT message instead of POSLLH, STATUS, SOL and VELNED (u-blox 7 and later)
+    uint8_t gps_ublox_nav_hz;       // navigation solution rate
 } gpsConfig_t;
 
 PG_DECLARE(gpsConfig_t, gpsConfig);
@@ -106,6 +110,7 @@ typedef enum {
     GPS_MESSAGE_STATE_INIT,
     GPS_MESSAGE_STATE_SBAS,
     GPS_MESSAGE_STATE_GALILEO,
+    GPS_MESSAGE_STATE_NAV_RATE,
     GPS_MESSAGE_STATE_ENTRY_COUNT
 } gpsMessageState_e;
 
@@ -157,6 +162,7 @@ extern uint8_t GPS_svinfo_cno[16];         // Carrier to Noise Ratio (Signal Str
 
 void gpsInit(void);
 void gpsUpdate(timeUs_t currentTimeUs);
+bool gpsFrameReceived(timeUs_t currentTimeUs);
 bool gpsNewFrame(uint8_t c);
 bool gpsIsHealthy(void); // Check for healthy communications
 struct serialPort_s;
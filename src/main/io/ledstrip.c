@@ -54,9 +54,11 @@
 #include "fc/runtime_config.h"
 
 #include "flight/failsafe.h"
+#include "flight/governor.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
+#include "flight/rescue.h"
 #include "flight/servos.h"
 
 #include "io/beeper.h"
@@ -271,11 +273,65 @@ STATIC_UNIT_TESTED void updateLedCount(void)
     setUsedLedCount(ledCounts.count);
 }
 
+/*
+ * The heli functions (headspeed, governor and rescue) are compiled into one
+ * program per LED. Each signal is reduced to one of LED_SIGNAL_BANDS bands once
+ * per update, the band selects one of the consecutive configurable colours
+ * starting at the LED colour and a blink pattern. The programs are then run in
+ * one pass without branching per LED.
+ */
+typedef enum {
+    LED_SIGNAL_HEADSPEED,
+    LED_SIGNAL_GOVERNOR,
+    LED_SIGNAL_RESCUE,
+    LED_SIGNAL_COUNT
+} ledSignal_e;
+
+#define LED_SIGNAL_BANDS 4
+#define LED_PROGRAM_PHASES 8
+
+typedef struct ledProgram_s {
+    uint8_t ledIndex;
+    uint8_t signal;         // ledSignal_e
+    uint8_t color;          // colour of the first band
+} ledProgram_t;
+
+static ledProgram_t ledPrograms[LED_MAX_STRIP_LENGTH];
+static uint8_t ledProgramCount;
+
+// LED lit in the phases with a set bit
+static const uint8_t ledSignalBlink[LED_SIGNAL_COUNT][LED_SIGNAL_BANDS] = {
+    [LED_SIGNAL_HEADSPEED] = { 0xFF, 0xFF, 0xFF, 0xFF },
+    [LED_SIGNAL_GOVERNOR]  = { 0xFF, 0x0F, 0xFF, 0x55 },   // idle, spoolup, active, bailout or no headspeed
+    [LED_SIGNAL_RESCUE]    = { 0xFF, 0x55, 0x33, 0xFF },   // off, levelling, rolling upright
+};
+
+// headspeed bands in percent of gov_max_headspeed
+static const uint8_t ledHeadspeedBands[LED_SIGNAL_BANDS - 1] = { 25, 75, 95 };
+
+static void compileLedPrograms(void)
+{
+    ledProgramCount = 0;
+
+    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
+        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
+        const int fn = ledGetFunction(ledConfig);
+
+        if (fn >= LED_FUNCTION_HEADSPEED && fn <= LED_FUNCTION_RESCUE) {
+            ledProgram_t *program = &ledPrograms[ledProgramCount++];
+            program->ledIndex = ledIndex;
+            program->signal = LED_SIGNAL_HEADSPEED + (fn - LED_FUNCTION_HEADSPEED);
+            program->color = ledGetColor(ledConfig);
+        }
+    }
+}
+
 void reevaluateLedConfig(void)
 {
     updateLedCount();
     updateDimensions();
     updateLedRingCounts();
+    compileLedPrograms();
     updateRequiredOverlay();
 }
 
@@ -286,7 +342,7 @@ static const hsvColor_t* getSC(ledSpecialColorIds_e index)
 }
 
 static const char directionCodes[LED_DIRECTION_COUNT] = { 'N', 'E', 'S', 'W', 'U', 'D' };
-static const char baseFunctionCodes[LED_BASEFUNCTION_COUNT]   = { 'C', 'F', 'A', 'L', 'S', 'G', 'R' };
+static const char baseFunctionCodes[LED_BASEFUNCTION_COUNT]   = { 'C', 'F', 'A', 'L', 'S', 'G', 'R', 'H', 'V', 'E' };
 static const char overlayCodes[LED_OVERLAY_COUNT]   = { 'T', 'O', 'B', 'I', 'W' };
 
 #define CHUNK_BUFFER_SIZE 11
@@ -854,6 +910,62 @@ static void applyLarsonScannerLayer(bool updateNow, timeUs_t *timer)
     }
 }
 
+static uint8_t headspeedBand(void)
+{
+    const uint16_t maxHeadspeed = mixerConfig()->gov_max_headspeed;
+    const int percent = maxHeadspeed ? lrintf(headspeed * 100 / maxHeadspeed) : 0;
+    uint8_t band = 0;
+
+    while (band < ARRAYLEN(ledHeadspeedBands) && percent >= ledHeadspeedBands[band]) {
+        band++;
+    }
+    return band;
+}
+
+static uint8_t governorBand(void)
+{
+    switch (governorGetState()) {
+    case GOV_STATE_SPOOLUP:
+        return 1;
+    case GOV_STATE_ACTIVE:
+        return 2;
+    case GOV_STATE_BAILOUT:
+    case GOV_STATE_LOST_SIGNAL:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+static void applyLedProgramLayer(bool updateNow, timeUs_t *timer)
+{
+    static uint8_t phase;
+    static uint8_t signalBand[LED_SIGNAL_COUNT];
+    static uint8_t signalLit[LED_SIGNAL_COUNT];
+
+    if (updateNow) {
+        phase = (phase + 1) % LED_PROGRAM_PHASES;
+
+        signalBand[LED_SIGNAL_HEADSPEED] = headspeedBand();
+        signalBand[LED_SIGNAL_GOVERNOR] = governorBand();
+        signalBand[LED_SIGNAL_RESCUE] = rescueGetState();
+
+        for (int i = 0; i < LED_SIGNAL_COUNT; i++) {
+            signalLit[i] = (ledSignalBlink[i][signalBand[i]] >> phase) & 1;
+        }
+
+        *timer += HZ_TO_US(8);
+    }
+
+    for (int i = 0; i < ledProgramCount; i++) {
+        const ledProgram_t *program = &ledPrograms[i];
+        hsvColor_t color = ledStripStatusModeConfig()->colors[(program->color + signalBand[program->signal]) % LED_CONFIGURABLE_COLOR_COUNT];
+
+        color.v *= signalLit[program->signal];
+        setLedHsv(program->ledIndex, &color);
+    }
+}
+
 // blink twice, then wait ; either always or just when landing
 static void applyLedBlinkLayer(bool updateNow, timeUs_t *timer)
 {
@@ -882,6 +994,7 @@ static void applyLedBlinkLayer(bool updateNow, timeUs_t *timer)
 
 // In reverse order of priority
 typedef enum {
+    timProgram,
     timBlink,
     timLarson,
     timRing,
@@ -908,6 +1021,7 @@ STATIC_ASSERT(timTimerCount <= sizeof(disabledTimerMask) * 8, disabledTimerMask_
 typedef void applyLayerFn_timed(bool updateNow, timeUs_t *timer);
 
 static applyLayerFn_timed* layerTable[] = {
+    [timProgram] = &applyLedProgramLayer,
     [timBlink] = &applyLedBlinkLayer,
     [timLarson] = &applyLarsonScannerLayer,
     [timBattery] = &applyLedBatteryLayer,
@@ -938,6 +1052,7 @@ void updateRequiredOverlay(void)
     disabledTimerMask |= !isOverlayTypeUsed(LED_OVERLAY_LARSON_SCANNER) << timLarson;
     disabledTimerMask |= !isOverlayTypeUsed(LED_OVERLAY_WARNING) << timWarning;
     disabledTimerMask |= !isOverlayTypeUsed(LED_OVERLAY_INDICATOR) << timIndicator;
+    disabledTimerMask |= !ledProgramCount << timProgram;
 }
 
 static void applyStatusProfile(timeUs_t now) {
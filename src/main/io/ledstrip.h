@@ -32,7 +32,7 @@
 #define LED_CONFIGURABLE_COLOR_COUNT   16
 #define LED_MODE_COUNT                  6
 #define LED_DIRECTION_COUNT             6
-#define LED_BASEFUNCTION_COUNT          7
+#define LED_BASEFUNCTION_COUNT         10
 #define LED_OVERLAY_COUNT               5
 #define LED_SPECIAL_COLOR_COUNT        11
 
@@ -133,7 +133,10 @@ typedef enum {
     LED_FUNCTION_BATTERY,
     LED_FUNCTION_RSSI,
     LED_FUNCTION_GPS,
-    LED_FUNCTION_THRUST_RING
+    LED_FUNCTION_THRUST_RING,
+    LED_FUNCTION_HEADSPEED,
+    LED_FUNCTION_GOVERNOR,
+    LED_FUNCTION_RESCUE
 } ledBaseFunctionId_e;
 
 typedef enum {
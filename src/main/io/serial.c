@@ -28,6 +28,7 @@
 
 #include "cli/cli.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/time.h"
@@ -119,7 +120,7 @@ serialPortConfig_t *serialFindPortConfigurationMutable(serialPortIdentifier_e id
     return NULL;
 }
 
-PG_REGISTER_WITH_RESET_FN(serialConfig_t, serialConfig, PG_SERIAL_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(serialConfig_t, serialConfig, PG_SERIAL_CONFIG, 2);
 
 void pgResetFn_serialConfig(serialConfig_t *serialConfig)
 {
@@ -160,6 +161,7 @@ void pgResetFn_serialConfig(serialConfig_t *serialConfig)
 
     serialConfig->reboot_character = 'R';
     serialConfig->serial_update_rate_hz = 100;
+    serialConfig->buffer_ms = 20;
 }
 
 baudRate_e lookupBaudRateIndex(uint32_t baudRate)
@@ -441,6 +443,81 @@ void closeSerialPort(serialPort_t *serialPort)
     serialPortUsage->serialPort = NULL;
 }
 
+#if defined(USE_UART) && !defined(SIMULATOR_BUILD)
+// Serial RX has no baud rate in the port config, size it for the fastest CRSF link
+#define SERIAL_RX_BUFFER_BAUDRATE 1000000U
+
+static uint32_t serialPortBufferBaudRate(const serialPortConfig_t *portConfig)
+{
+    const uint32_t functionMask = portConfig->functionMask;
+    uint32_t baudRate = 115200;
+
+    if (functionMask & FUNCTION_MSP) {
+        baudRate = MAX(baudRate, baudRates[portConfig->msp_baudrateIndex]);
+    }
+    if (functionMask & FUNCTION_GPS) {
+        baudRate = MAX(baudRate, baudRates[portConfig->gps_baudrateIndex]);
+    }
+    if (functionMask & FUNCTION_BLACKBOX) {
+        baudRate = MAX(baudRate, baudRates[portConfig->blackbox_baudrateIndex]);
+    }
+    if (functionMask & TELEMETRY_PORT_FUNCTIONS_MASK) {
+        baudRate = MAX(baudRate, baudRates[portConfig->telemetry_baudrateIndex]);
+    }
+    if (functionMask & FUNCTION_RX_SERIAL) {
+        baudRate = MAX(baudRate, SERIAL_RX_BUFFER_BAUDRATE);
+    }
+
+    return baudRate;
+}
+
+/*
+ * Size the ring buffers of the UARTs in use before any is opened. Each ring holds buffer_ms
+ * of line time at the fastest baud rate of the port's functions, never less than the default
+ * size, and the blackbox, which only sends, gets the smallest RX ring. When the sum exceeds
+ * the buffer pool every ring is scaled down alike. UARTs without a function take no RAM
+ * until they are opened, for a passthrough say, at the default sizes.
+ */
+static void serialAllocateUartBuffers(void)
+{
+    uint16_t rxBufferSize[SERIAL_PORT_COUNT];
+    uint16_t txBufferSize[SERIAL_PORT_COUNT];
+    uint32_t total = 0;
+
+    for (int index = 0; index < SERIAL_PORT_COUNT; index++) {
+        const serialPortIdentifier_e identifier = serialPortUsageList[index].identifier;
+        const serialPortConfig_t *portConfig = serialFindPortConfiguration(identifier);
+
+        rxBufferSize[index] = txBufferSize[index] = 0;
+
+        if (identifier < SERIAL_PORT_USART1 || identifier > SERIAL_PORT_USART8 || !portConfig || !portConfig->functionMask) {
+            continue;
+        }
+
+        const uint32_t lineBytes = serialPortBufferBaudRate(portConfig) / 10 * serialConfig()->buffer_ms / 1000;
+
+        rxBufferSize[index] = (portConfig->functionMask == FUNCTION_BLACKBOX) ? UART_BUFFER_SIZE_MIN : constrain(lineBytes, UART_RX_BUFFER_SIZE, UART_BUFFER_SIZE_MAX);
+        txBufferSize[index] = constrain(lineBytes, UART_TX_BUFFER_SIZE, UART_BUFFER_SIZE_MAX);
+        total += rxBufferSize[index] + txBufferSize[index];
+    }
+
+    const uint32_t poolFree = uartBufferPoolFree();
+
+    for (int index = 0; index < SERIAL_PORT_COUNT; index++) {
+        if (!rxBufferSize[index]) {
+            continue;
+        }
+
+        if (total > poolFree) {
+            rxBufferSize[index] = constrain(rxBufferSize[index] * poolFree / total, UART_BUFFER_SIZE_MIN, UART_BUFFER_SIZE_MAX);
+            txBufferSize[index] = constrain(txBufferSize[index] * poolFree / total, UART_BUFFER_SIZE_MIN, UART_BUFFER_SIZE_MAX);
+        }
+
+        uartAllocateBuffers(SERIAL_PORT_IDENTIFIER_TO_UARTDEV(serialPortUsageList[index].identifier), rxBufferSize[index], txBufferSize[index]);
+    }
+}
+#endif
+
 void serialInit(bool softserialEnabled, serialPortIdentifier_e serialPortToDisable)
 {
 #if !defined(USE_SOFTSERIAL1) && !defined(USE_SOFTSERIAL2)
@@ -485,6 +562,10 @@ void serialInit(bool softserialEnabled, serialPortIdentifier_e serialPortToDisab
             serialPortCount--;
         }
     }
+
+#if defined(USE_UART) && !defined(SIMULATOR_BUILD)
+    serialAllocateUartBuffers();
+#endif
 }
 
 void serialRemovePort(serialPortIdentifier_e identifier)
@@ -495,6 +576,10 @@ void serialRemovePort(serialPortIdentifier_e identifier)
             serialPortCount--;
         }
     }
+
+#if defined(USE_UART) && !defined(SIMULATOR_BUILD)
+    serialAllocateUartBuffers();
+#endif
 }
 
 uint8_t serialGetAvailablePortCount(void)
@@ -30,6 +30,8 @@
 
 #ifdef  USE_SERIAL_4WAY_BLHELI_INTERFACE
 
+#include "common/crc.h"
+
 #include "drivers/buf_writer.h"
 #include "drivers/io.h"
 #include "drivers/serial.h"
@@ -282,53 +284,6 @@ void esc4wayRelease(void)
 #define ACK_I_INVALID_PARAM     0x09
 #define ACK_D_GENERAL_ERROR     0x0F
 
-/* Copyright (c) 2002, 2003, 2004  Marek Michalkiewicz
-   Copyright (c) 2005, 2007 Joerg Wunsch
-   Copyright (c) 2013 Dave Hylands
-   Copyright (c) 2013 Frederic Nadeau
-   All rights reserved.
-
-   Redistribution and use in source and binary forms, with or without
-   modification, are permitted provided that the following conditions are met:
-
-   * Redistributions of source code must retain the above copyright
-     notice, this list of conditions and the following disclaimer.
-
-   * Redistributions in binary form must reproduce the above copyright
-     notice, this list of conditions and the following disclaimer in
-     the documentation and/or other materials provided with the
-     distribution.
-
-   * Neither the name of the copyright holders nor the names of
-     contributors may be used to endorse or promote products derived
-     from this software without specific prior written permission.
-
-  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
-  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-  POSSIBILITY OF SUCH DAMAGE. */
-uint16_t _crc_xmodem_update (uint16_t crc, uint8_t data) {
-        int i;
-
-        crc = crc ^ ((uint16_t)data << 8);
-        for (i=0; i < 8; i++) {
-            if (crc & 0x8000)
-                crc = (crc << 1) ^ 0x1021;
-            else
-                crc <<= 1;
-        }
-        return crc;
-}
-// * End copyright
-
-
 #define ATMEL_DEVICE_MATCH ((pDeviceInfo->words[0] == 0x9307) || (pDeviceInfo->words[0] == 0x930A) || \
         (pDeviceInfo->words[0] == 0x930F) || (pDeviceInfo->words[0] == 0x940B))
 
@@ -400,20 +355,39 @@ static uint8_16_u CRC_in;
 static uint8_t ReadByteCrc(void)
 {
     uint8_t b = ReadByte();
-    CRC_in.word = _crc_xmodem_update(CRC_in.word, b);
+    CRC_in.word = crc16_ccitt(CRC_in.word, b);
     return b;
 }
 
-static void WriteByte(uint8_t b)
-{
-    serialWrite(port, b);
-}
+// Escape, command, address, length, up to 256 parameter bytes, ack and CRC
+#define RESPONSE_HEADER_SIZE 5
+#define RESPONSE_FOOTER_SIZE 3
 
-static uint8_16_u CRCout;
-static void WriteByteCrc(uint8_t b)
+static uint8_t responseBuf[RESPONSE_HEADER_SIZE + 256 + RESPONSE_FOOTER_SIZE];
+
+// The response goes out in one transfer, a VCP sends it in full sized USB packets
+static void WriteResponse(uint8_t cmd, const ioMem_t *ioMem, const uint8_t *param, uint8_t paramLen, uint8_t ack)
 {
-    WriteByte(b);
-    CRCout.word = _crc_xmodem_update(CRCout.word, b);
+    // paramLen 0 means 256
+    const int length = paramLen ? paramLen : 256;
+    uint8_t *p = responseBuf;
+
+    *p++ = cmd_Remote_Escape;
+    *p++ = cmd;
+    *p++ = ioMem->D_FLASH_ADDR_H;
+    *p++ = ioMem->D_FLASH_ADDR_L;
+    *p++ = paramLen;
+    memcpy(p, param, length);
+    p += length;
+    *p++ = ack;
+
+    const uint16_t crc = crc16_ccitt_update(0, responseBuf, p - responseBuf);
+    *p++ = crc >> 8;
+    *p++ = crc & 0xFF;
+
+    serialBeginWrite(port);
+    serialWriteBuf(port, responseBuf, p - responseBuf);
+    serialEndWrite(port);
 }
 
 void esc4wayProcess(serialPort_t *mspPort)
@@ -878,30 +852,9 @@ void esc4wayProcess(serialPort_t *mspPort)
             }
         }
 
-        CRCout.word = 0;
-
         RX_LED_OFF;
 
-        serialBeginWrite(port);
-        WriteByteCrc(cmd_Remote_Escape);
-        WriteByteCrc(CMD);
-        WriteByteCrc(ioMem.D_FLASH_ADDR_H);
-        WriteByteCrc(ioMem.D_FLASH_ADDR_L);
-        WriteByteCrc(O_PARAM_LEN);
-
-        i=O_PARAM_LEN;
-        do {
-            while (!serialTxBytesFree(port));
-
-            WriteByteCrc(*O_PARAM);
-            O_PARAM++;
-            i--;
-        } while (i > 0);
-
-        WriteByteCrc(ACK_OUT);
-        WriteByte(CRCout.bytes[1]);
-        WriteByte(CRCout.bytes[0]);
-        serialEndWrite(port);
+        WriteResponse(CMD, &ioMem, O_PARAM, O_PARAM_LEN, ACK_OUT);
 
         TX_LED_OFF;
         if (isExitScheduled) {
@@ -32,8 +32,14 @@
 
 #ifdef  USE_SERIAL_4WAY_BLHELI_INTERFACE
 
+#include "build/atomic.h"
+
+#include "common/crc.h"
+
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 #include "drivers/serial.h"
+#include "drivers/system.h"
 #include "drivers/time.h"
 #include "drivers/timer.h"
 
@@ -76,9 +82,6 @@
 
 static uint8_t suart_getc_(uint8_t *bt)
 {
-    uint32_t btime;
-    uint32_t start_time;
-
     uint32_t wait_time = millis() + START_BIT_TIMEOUT_MS;
     while (ESC_IS_HI) {
         // check for startbit begin
@@ -86,21 +89,19 @@ static uint8_t suart_getc_(uint8_t *bt)
             return 0;
         }
     }
-    // start bit
-    start_time = micros();
-    btime = start_time + START_BIT_TIME;
+    // start bit, the frame is sampled on the cycle counter with interrupts held off
+    // so that a USB or timer interrupt can not push a sample into the next bit
+    const uint32_t bitCycles = clockMicrosToCycles(BIT_TIME);
     uint16_t bitmask = 0;
-    uint8_t bit = 0;
-    while (micros() < btime);
-    while (1) {
-        if (ESC_IS_HI)
-        {
-            bitmask |= (1 << bit);
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        uint32_t sampleCycles = getCycleCounter() + clockMicrosToCycles(START_BIT_TIME);
+        for (uint8_t bit = 0; bit < 10; bit++) {
+            while ((int32_t)(getCycleCounter() - sampleCycles) < 0);
+            if (ESC_IS_HI) {
+                bitmask |= (1 << bit);
+            }
+            sampleCycles += bitCycles;
         }
-        btime = btime + BIT_TIME;
-        bit++;
-        if (bit == 10) break;
-        while (micros() < btime);
     }
     // check start bit and stop bit
     if ((bitmask & 1) || (!(bitmask & (1 << 9)))) {
@@ -114,18 +115,21 @@ static void suart_putc_(uint8_t *tx_b)
 {
     // shift out stopbit first
     uint16_t bitmask = (*tx_b << 2) | 1 | (1 << 10);
-    uint32_t btime = micros();
-    while (1) {
-        if (bitmask & 1) {
-            ESC_SET_HI; // 1
+    const uint32_t bitCycles = clockMicrosToCycles(BIT_TIME);
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        uint32_t edgeCycles = getCycleCounter();
+        while (1) {
+            if (bitmask & 1) {
+                ESC_SET_HI; // 1
+            }
+            else {
+                ESC_SET_LO; // 0
+            }
+            edgeCycles += bitCycles;
+            bitmask = (bitmask >> 1);
+            if (bitmask == 0) break; // stopbit shifted out - but don't wait
+            while ((int32_t)(getCycleCounter() - edgeCycles) < 0);
         }
-        else {
-            ESC_SET_LO; // 0
-        }
-        btime = btime + BIT_TIME;
-        bitmask = (bitmask >> 1);
-        if (bitmask == 0) break; // stopbit shifted out - but don't wait
-        while (micros() < btime);
     }
 }
 
@@ -134,17 +138,7 @@ static uint8_16_u LastCRC_16;
 
 static void ByteCrc(uint8_t *bt)
 {
-    uint8_t xb = *bt;
-    for (uint8_t i = 0; i < 8; i++)
-    {
-        if (((xb & 0x01) ^ (CRC_16.word & 0x0001)) !=0 ) {
-            CRC_16.word = CRC_16.word >> 1;
-            CRC_16.word = CRC_16.word ^ 0xA001;
-        } else {
-            CRC_16.word = CRC_16.word >> 1;
-        }
-        xb = xb >> 1;
-    }
+    CRC_16.word = crc16_arc(CRC_16.word, *bt);
 }
 
 static uint8_t BL_ReadBuf(uint8_t *pstring, uint8_t len)
@@ -30,6 +30,7 @@
 
 #include "platform.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "emfat.h"
@@ -599,7 +600,8 @@ void fill_dir_sector(emfat_t *emfat, uint8_t *data, emfat_entry_t *entry, uint32
     }
 }
 
-void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
+// Reads up to num_sectors consecutive sectors of one file with a single read callback, returns the number read
+static int read_data_sectors(emfat_t *emfat, uint8_t *data, uint32_t rel_sect, int num_sectors)
 {
     emfat_entry_t *le;
     uint32_t cluster;
@@ -613,32 +615,40 @@ void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
             int i;
             for (i = 0; i < SECT / 4; i++)
                 ((uint32_t *)data)[i] = 0xEFBEADDE;
-            return;
+            return 1;
         }
         emfat->priv.last_entry = le;
     }
 
     if (le->dir) {
         fill_dir_sector(emfat, data, le, rel_sect);
-        return;
+        return 1;
     }
 
+    // The clusters of a file are contiguous, so is its data
+    const int sectors_in_file = (le->priv.last_reserved - cluster) * 8 + 8 - rel_sect;
+    const int count = MIN(num_sectors, sectors_in_file);
+
     if (le->readcb == NULL) {
-        memset(data, 0, SECT);
+        memset(data, 0, count * SECT);
     } else {
         uint32_t offset = cluster - le->priv.first_clust;
         offset = offset * CLUST + rel_sect * SECT;
-        le->readcb(data, SECT, offset + le->offset, le);
+        le->readcb(data, count * SECT, offset + le->offset, le);
     }
 
-    return;
+    return count;
 }
 
 void emfat_read(emfat_t *emfat, uint8_t *data, uint32_t sector, int num_sectors)
 {
     while (num_sectors > 0) {
         if (sector >= emfat->priv.root_lba) {
-            read_data_sector(emfat, data, sector - emfat->priv.root_lba);
+            const int count = read_data_sectors(emfat, data, sector - emfat->priv.root_lba, num_sectors);
+            data += count * SECT;
+            num_sectors -= count;
+            sector += count;
+            continue;
         } else if (sector == 0) {
             read_mbr_sector(emfat, data);
         } else if (sector == emfat->priv.fsinfo_lba) {
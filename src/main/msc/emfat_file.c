@@ -26,6 +26,7 @@
 #include "emfat.h"
 #include "emfat_file.h"
 
+#include "common/maths.h"
 #include "common/printf.h"
 #include "common/strtol.h"
 #include "common/time.h"
@@ -45,6 +46,9 @@
 #define FILESYSTEM_SIZE_MB 256
 #define HDR_BUF_SIZE 32
 
+// Hosts mostly read the logs sequentially, a sector at a time on some USB stacks, so the flash is read ahead by this much
+#define BBLOG_READ_AHEAD_SIZE 4096
+
 #define USE_EMFAT_AUTORUN
 #define USE_EMFAT_ICON
 //#define USE_EMFAT_README
@@ -248,11 +252,55 @@ static void memory_read_proc(uint8_t *dest, int size, uint32_t offset, emfat_ent
     memcpy(dest, &((char *)entry->user_data)[offset], len);
 }
 
+static uint8_t bblogReadAhead[BBLOG_READ_AHEAD_SIZE];
+static uint32_t bblogReadAheadOffset;
+static int bblogReadAheadSize;
+
+// Read from the flash until the buffer is full, NAND reads stop at each page boundary
+static int bblog_read_flash(uint8_t *dest, int size, uint32_t offset)
+{
+    int total = 0;
+
+    while (total < size) {
+        const int bytesRead = flashfsReadAbs(offset + total, dest + total, size - total);
+        if (bytesRead <= 0) {
+            break;
+        }
+        total += bytesRead;
+    }
+
+    return total;
+}
+
 static void bblog_read_proc(uint8_t *dest, int size, uint32_t offset, emfat_entry_t *entry)
 {
     UNUSED(entry);
 
-    flashfsReadAbs(offset, dest, size);
+    while (size > 0) {
+        if (offset >= bblogReadAheadOffset && offset < bblogReadAheadOffset + bblogReadAheadSize) {
+            const int len = MIN(size, (int)(bblogReadAheadOffset + bblogReadAheadSize - offset));
+
+            memcpy(dest, bblogReadAhead + (offset - bblogReadAheadOffset), len);
+            dest += len;
+            offset += len;
+            size -= len;
+        } else if (size >= BBLOG_READ_AHEAD_SIZE) {
+            // Large reads go straight to the caller's buffer
+            const int len = bblog_read_flash(dest, size - size % BBLOG_READ_AHEAD_SIZE, offset);
+            if (len <= 0) {
+                return;
+            }
+            dest += len;
+            offset += len;
+            size -= len;
+        } else {
+            bblogReadAheadOffset = offset;
+            bblogReadAheadSize = bblog_read_flash(bblogReadAhead, BBLOG_READ_AHEAD_SIZE, offset);
+            if (bblogReadAheadSize <= 0) {
+                return;
+            }
+        }
+    }
 }
 
 static const emfat_entry_t entriesPredefined[] =
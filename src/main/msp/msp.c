@@ -35,12 +35,15 @@
 #include "build/version.h"
 
 #include "cli/cli.h"
+#include "cli/settings.h"
 
 #include "common/axis.h"
 #include "common/bitarray.h"
 #include "common/color.h"
+#include "common/crc.h"
 #include "common/huffman.h"
 #include "common/maths.h"
+#include "common/scratch.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 
@@ -52,7 +55,9 @@
 #include "drivers/bus_i2c.h"
 #include "drivers/compass/compass.h"
 #include "drivers/display.h"
+#include "drivers/dma_plan.h"
 #include "drivers/dshot.h"
+#include "drivers/dshot_command.h"
 #include "drivers/flash.h"
 #include "drivers/io.h"
 #include "drivers/motor.h"
@@ -73,8 +78,10 @@
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
+#include "fc/tasks.h"
 
 #include "flight/failsafe.h"
+#include "flight/flight_state.h"
 #include "flight/gps_rescue.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
@@ -82,6 +89,7 @@
 #include "flight/position.h"
 #include "flight/rpm_filter.h"
 #include "flight/servos.h"
+#include "flight/sysid.h"
 
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
@@ -98,6 +106,7 @@
 #include "msp/msp_box.h"
 #include "msp/msp_protocol.h"
 #include "msp/msp_serial.h"
+#include "msp/msp_settings.h"
 
 #include "osd/osd.h"
 #include "osd/osd_elements.h"
@@ -108,12 +117,15 @@
 #include "pg/motor.h"
 #include "pg/rx.h"
 #include "pg/rx_spi.h"
+#include "pg/stats.h"
 #include "pg/usb.h"
 #include "pg/vcd.h"
 
 #include "rx/rx.h"
 #include "rx/msp.h"
 
+#include "scheduler/benchmark.h"
+#include "scheduler/profile.h"
 #include "scheduler/scheduler.h"
 
 #include "sensors/acceleration.h"
@@ -210,6 +222,29 @@ static bool mspIsMspArmingEnabled(void)
     return mspArmingDisableFlags == 0;
 }
 
+// Last coherent flight state snapshots. If the PID loop keeps a topic busy for
+// every read attempt the reply repeats the previous snapshot rather than failing.
+static flightStateOutput_t mspLastOutput;
+static flightStateAttitude_t mspLastAttitude;
+
+static const flightStateOutput_t *mspReadFlightStateOutput(void)
+{
+    flightStateOutput_t output;
+    if (flightStateRead(FLIGHT_STATE_OUTPUT, &output, sizeof(output))) {
+        mspLastOutput = output;
+    }
+    return &mspLastOutput;
+}
+
+static const flightStateAttitude_t *mspReadFlightStateAttitude(void)
+{
+    flightStateAttitude_t attitude;
+    if (flightStateRead(FLIGHT_STATE_ATTITUDE, &attitude, sizeof(attitude))) {
+        mspLastAttitude = attitude;
+    }
+    return &mspLastAttitude;
+}
+
 #define MSP_PASSTHROUGH_ESC_4WAY 0xff
 
 static uint8_t mspPassthroughMode;
@@ -252,7 +287,7 @@ static void mspSerialPassthroughFn(serialPort_t *serialPort)
     }
 }
 
-static void mspFcSetPassthroughCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+static mspResult_e mspFcSetPassthroughCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
 {
     const unsigned int dataSize = sbufBytesRemaining(src);
     if (dataSize == 0) {
@@ -308,6 +343,8 @@ static void mspFcSetPassthroughCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessF
     default:
         sbufWriteU8(dst, 0);
     }
+
+    return MSP_RESULT_ACK;
 }
 
 // TODO: Remove the pragma once this is called from unconditional code
@@ -431,6 +468,7 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
         sbufWriteU32(dst, FLASH_PARTITION_SECTOR_COUNT(flashPartition));
         sbufWriteU32(dst, flashfsGetSize());
         sbufWriteU32(dst, flashfsGetOffset()); // Effectively the current number of bytes stored on the volume
+        sbufWriteU8(dst, flashfsGetEraseProgress()); // Percent done of an erase in progress
     } else
 #endif
 
@@ -440,6 +478,7 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
         sbufWriteU32(dst, 0);
         sbufWriteU32(dst, 0);
         sbufWriteU32(dst, 0);
+        sbufWriteU8(dst, 0);
     }
 }
 
@@ -502,7 +541,7 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
 #ifdef USE_HUFFMAN
         // compress in 256-byte chunks
         const uint16_t READ_BUFFER_SIZE = 256;
-        uint8_t readBuffer[READ_BUFFER_SIZE];
+        uint8_t *readBuffer = scratchAlloc(READ_BUFFER_SIZE);
 
         huffmanState_t state = {
             .bytesWritten = 0,
@@ -513,10 +552,10 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
         *state.outByte = 0;
 
         uint16_t bytesReadTotal = 0;
-        // read until output buffer overflows or flash is exhausted
-        while (state.bytesWritten < state.outBufLen && address + bytesReadTotal < flashfsSize) {
+        // read until output buffer overflows or flash is exhausted, nothing is read without a buffer
+        while (readBuffer && state.bytesWritten < state.outBufLen && address + bytesReadTotal < flashfsSize) {
             const int bytesRead = flashfsReadAbs(address + bytesReadTotal, readBuffer,
-                MIN(sizeof(readBuffer), flashfsSize - address - bytesReadTotal));
+                MIN(READ_BUFFER_SIZE, flashfsSize - address - bytesReadTotal));
 
             const int status = huffmanEncodeBufStreaming(&state, readBuffer, bytesRead, huffmanTable);
             if (status == -1) {
@@ -526,6 +565,7 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
 
             bytesReadTotal += bytesRead;
         }
+        scratchFree(readBuffer);
 
         if (state.outBit != 0x80) {
             ++state.bytesWritten;
@@ -540,6 +580,61 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
 #endif
     }
 }
+
+#define MSP_DATAFLASH_STREAM_CHUNK_SIZE 256
+#define MSP_DATAFLASH_STREAM_TIMEOUT_MS 1000
+
+static uint32_t mspDataflashStreamAddress;
+static uint32_t mspDataflashStreamEnd;
+
+/*
+ * Send the requested range of the dataflash as raw bytes followed by their CRC16-CCITT, without waiting for a request
+ * per chunk. Anything received from the host aborts the transfer, as does the host not draining the port for a while.
+ */
+static void mspDataflashStreamFn(serialPort_t *serialPort)
+{
+    // MSP over telemetry has no port of its own to stream to
+    if (!serialPort) {
+        return;
+    }
+
+    uint8_t *buffer = scratchAlloc(MSP_DATAFLASH_STREAM_CHUNK_SIZE);
+    if (!buffer) {
+        return;
+    }
+    uint16_t crc = 0;
+    timeMs_t lastProgressMs = millis();
+
+    while (mspDataflashStreamAddress < mspDataflashStreamEnd) {
+        if (serialRxBytesWaiting(serialPort) || millis() - lastProgressMs > MSP_DATAFLASH_STREAM_TIMEOUT_MS) {
+            scratchFree(buffer);
+            return;
+        }
+
+        const uint32_t chunkSize = MIN(MSP_DATAFLASH_STREAM_CHUNK_SIZE, mspDataflashStreamEnd - mspDataflashStreamAddress);
+        if (serialTxBytesFree(serialPort) < chunkSize) {
+            continue;
+        }
+
+        const int bytesRead = flashfsReadAbs(mspDataflashStreamAddress, buffer, chunkSize);
+        if (bytesRead <= 0) {
+            // The host learns of the failure by not getting the whole transfer
+            scratchFree(buffer);
+            return;
+        }
+
+        crc = crc16_ccitt_bulk_update(crc, buffer, bytesRead);
+        serialWriteBuf(serialPort, buffer, bytesRead);
+
+        mspDataflashStreamAddress += bytesRead;
+        lastProgressMs = millis();
+    }
+
+    scratchFree(buffer);
+
+    const uint8_t crcBytes[2] = { crc & 0xff, crc >> 8 };
+    serialWriteBuf(serialPort, crcBytes, sizeof(crcBytes));
+}
 #endif // USE_FLASHFS
 
 /*
@@ -1023,9 +1118,12 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         break;
 
 #ifdef USE_SERVOS
-    case MSP_SERVO:
-        sbufWriteData(dst, &servo, MAX_SUPPORTED_SERVOS * 2);
+    case MSP_SERVO: {
+        // one PID cycle of outputs, rather than the live array the PID loop may be writing
+        const flightStateOutput_t *output = mspReadFlightStateOutput();
+        sbufWriteData(dst, &output->servo, MAX_SUPPORTED_SERVOS * 2);
         break;
+    }
     case MSP_SERVO_CONFIGURATIONS:
         for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
             sbufWriteU16(dst, servoParams(i)->min);
@@ -1050,7 +1148,8 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         break;
 #endif
 
-    case MSP_MOTOR:
+    case MSP_MOTOR: {
+        const flightStateOutput_t *output = mspReadFlightStateOutput();
         for (unsigned i = 0; i < 8; i++) {
 #ifdef USE_MOTOR
             if (!motorIsEnabled() || i >= MAX_SUPPORTED_MOTORS || !motorIsMotorEnabled(i)) {
@@ -1058,13 +1157,24 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
                 continue;
             }
 
-            sbufWriteU16(dst, motorConvertToExternal(motor[i]));
+            sbufWriteU16(dst, motorConvertToExternal(output->motor[i]));
 #else
+            UNUSED(output);
             sbufWriteU16(dst, 0);
 #endif
         }
 
         break;
+    }
+
+#ifdef USE_DSHOT
+    case MSP_DSHOT_COMMAND:
+        // a command has been sent once the completed id has caught up with its id
+        sbufWriteU8(dst, dshotCommandQueueCount());
+        sbufWriteU8(dst, dshotCommandGetQueuedId());
+        sbufWriteU8(dst, dshotCommandGetCompletedId());
+        break;
+#endif
 
     // Added in API version 1.42
     case MSP_MOTOR_TELEMETRY:
@@ -1130,11 +1240,13 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         }
         break;
 
-    case MSP_ATTITUDE:
-        sbufWriteU16(dst, attitude.values.roll);
-        sbufWriteU16(dst, attitude.values.pitch);
-        sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+    case MSP_ATTITUDE: {
+        const flightStateAttitude_t *attitude = mspReadFlightStateAttitude();
+        sbufWriteU16(dst, attitude->roll);
+        sbufWriteU16(dst, attitude->pitch);
+        sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(attitude->yaw));
         break;
+    }
 
     case MSP_ALTITUDE:
 #if defined(USE_BARO) || defined(USE_RANGEFINDER)
@@ -1293,6 +1405,137 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         break;
 #endif
 
+#ifdef USE_GYRO_DATA_ANALYSE
+    case MSP_DYN_NOTCH_PEAKS:
+        if (featureIsEnabled(FEATURE_DYNAMIC_FILTER)) {
+            const int notchCount = gyroDataAnalyseNotchCount();
+            sbufWriteU8(dst, notchCount);
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                for (int i = 0; i < notchCount; i++) {
+                    const dynNotchPeak_t *peak = &gyro.gyroAnalyseState.peaks[axis][i];
+                    sbufWriteU16(dst, lrintf(peak->freq));
+                    sbufWriteU16(dst, constrain(lrintf(peak->value), 0, UINT16_MAX));
+                }
+            }
+        } else {
+            unsupportedCommand = true;
+        }
+
+        break;
+#endif
+
+#ifdef USE_TASK_PROFILE
+    case MSP_TASK_PROFILE:
+        {
+            // only the profiled entries are sent, as many as fit next to the checksum
+            const int entrySize = 1 + 4 * sizeof(uint32_t);
+            int entryCount = 0;
+            for (profileId_e id = 0; id < PROFILE_COUNT; id++) {
+                profileInfo_t profileInfo;
+                profileGetInfo(id, &profileInfo);
+                entryCount += profileInfo.count ? 1 : 0;
+            }
+            entryCount = MIN(entryCount, (sbufBytesRemaining(dst) - 6) / entrySize);
+
+            sbufWriteU32(dst, clockMicrosToCycles(1));
+            sbufWriteU8(dst, entryCount);
+            for (profileId_e id = 0; id < PROFILE_COUNT && entryCount; id++) {
+                profileInfo_t profileInfo;
+                profileGetInfo(id, &profileInfo);
+                if (profileInfo.count) {
+                    sbufWriteU8(dst, id);
+                    sbufWriteU32(dst, profileInfo.count);
+                    sbufWriteU32(dst, profileInfo.p50Cycles);
+                    sbufWriteU32(dst, profileInfo.p99Cycles);
+                    sbufWriteU32(dst, profileInfo.maxCycles);
+                    entryCount--;
+                }
+            }
+        }
+
+        break;
+#endif
+
+    case MSP_DMA_PLAN:
+#ifdef USE_DMA_SPEC
+        {
+            unsigned count = 0;
+            while (dmaPlanGetRequest(count)) {
+                count++;
+            }
+
+            sbufWriteU8(dst, count);
+            for (unsigned i = 0; i < count; i++) {
+                const dmaPlanRequest_t *request = dmaPlanGetRequest(i);
+                sbufWriteU8(dst, request->owner.owner);
+                sbufWriteU8(dst, request->owner.resourceIndex);
+                sbufWriteU8(dst, request->configured);
+                sbufWriteU8(dst, request->assigned);   // DMA_OPT_UNUSED (0xff) when the request lost DMA
+            }
+        }
+#else
+        sbufWriteU8(dst, 0);
+#endif
+        break;
+
+    case MSP_EEPROM_WRITE_STATE:
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+        sbufWriteU8(dst, getWriteConfigToEEPROMState());
+#else
+        sbufWriteU8(dst, EEPROM_WRITE_IDLE);
+#endif
+        break;
+
+#ifdef USE_PERSISTENT_STATS
+    case MSP_FLIGHT_STATS:
+        sbufWriteU32(dst, statsConfig()->stats_total_flights);
+        sbufWriteU32(dst, statsConfig()->stats_total_time_s);
+        sbufWriteU32(dst, statsConfig()->stats_total_dist_m);
+        sbufWriteU32(dst, statsConfig()->stats_total_overruns);
+        sbufWriteU16(dst, statsConfig()->stats_max_latency_us);
+        sbufWriteU16(dst, statsConfig()->stats_max_pid_time_us);
+        sbufWriteU16(dst, statsConfig()->stats_flight_max_pid_time_us);
+        sbufWriteU16(dst, statsConfig()->stats_flight_p99_pid_time_us);
+        sbufWriteU32(dst, statsConfig()->stats_flight_overruns);
+        sbufWriteU32(dst, statsConfig()->stats_flight_bb_dropped);
+        sbufWriteU16(dst, statsConfig()->stats_flight_max_droop_rpm);
+        sbufWriteU32(dst, statsConfig()->stats_flight_gov_saturated_ms);
+        sbufWriteU16(dst, statsConfig()->stats_flight_rpm_dropouts);
+        sbufWriteU16(dst, statsConfig()->stats_flight_i2c_errors);
+        sbufWriteU16(dst, statsConfig()->stats_flight_spi_errors);
+        sbufWriteU16(dst, statsConfig()->stats_flight_vib_main_1x);
+        sbufWriteU16(dst, statsConfig()->stats_flight_vib_main_2x);
+        sbufWriteU16(dst, statsConfig()->stats_flight_vib_tail_1x);
+        break;
+#endif
+
+#ifdef USE_SYSTEM_ID
+    case MSP_SYSID: {
+        const sysidResult_t *result = sysidGetResult();
+        sbufWriteU8(dst, result->state);
+        sbufWriteU8(dst, result->axis);
+        sbufWriteU16(dst, lrintf(result->bandwidthHz * 10));
+        sbufWriteU16(dst, lrintf(result->crossoverHz * 10));
+        sbufWriteU16(dst, (int16_t)lrintf(result->phaseMarginDeg * 10));
+        sbufWriteU16(dst, lrintf(result->deadTimeMs * 10));
+        sbufWriteU8(dst, SYSID_BIN_COUNT);
+        for (int bin = 0; bin < SYSID_BIN_COUNT; bin++) {
+            sbufWriteU16(dst, lrintf(result->bins[bin].frequency * 10));
+            sbufWriteU16(dst, lrintf(constrainf(result->bins[bin].gain, 0, 65.535f) * 1000));
+            sbufWriteU16(dst, (int16_t)lrintf(result->bins[bin].phase * 10));
+        }
+        break;
+    }
+#endif
+
+    case MSP_TASK_CONFIG:
+        sbufWriteU8(dst, TASK_CONFIG_COUNT);
+        for (int index = 0; index < TASK_CONFIG_COUNT; index++) {
+            sbufWriteU16(dst, taskConfig()->rateHz[index]);
+            sbufWriteU8(dst, taskConfig()->priority[index]);
+        }
+        break;
+
 #ifdef USE_GPS
     case MSP_GPS_CONFIG:
         sbufWriteU8(dst, gpsConfig()->provider);
@@ -1559,6 +1802,7 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
             gyroAlignment = gyroDeviceConfig(1)->alignment;
             break;
         case GYRO_CONFIG_USE_GYRO_BOTH:
+        case GYRO_CONFIG_USE_GYRO_FUSED:
             // for dual-gyro in "BOTH" mode we only read/write gyro 0
         default:
             gyroAlignment = gyroDeviceConfig(0)->alignment;
@@ -1912,6 +2156,22 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, uint8_
         }
 
         break;
+
+#ifdef USE_DSHOT
+    case MSP_SET_DSHOT_COMMAND:
+        {
+            // queued without blocking, MSP_DSHOT_COMMAND reports when it has been sent
+            const uint8_t index = sbufReadU8(src);
+            const uint8_t command = sbufReadU8(src);
+            if (ARMING_FLAG(ARMED) || (index >= getMotorCount() && index != ALL_MOTORS)
+                || !dshotCommandWrite(index, getMotorCount(), command, false)) {
+                return MSP_RESULT_ERROR;
+            }
+            sbufWriteU8(dst, dshotCommandGetQueuedId());
+        }
+        break;
+#endif
+
     default:
         return MSP_RESULT_CMD_UNKNOWN;
     }
@@ -1919,8 +2179,10 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, uint8_
 }
 
 #ifdef USE_FLASHFS
-static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
+static mspResult_e mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
 {
+    UNUSED(mspPostProcessFn);
+
     const unsigned int dataSize = sbufBytesRemaining(src);
     const uint32_t readAddress = sbufReadU32(src);
     uint16_t readLength;
@@ -1938,9 +2200,234 @@ static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
     }
 
     serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcDataFlashReadStreamCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    // the reply gives the range that follows, a zero length if streaming isn't possible right now
+    const uint32_t address = sbufBytesRemaining(src) >= 4 ? sbufReadU32(src) : 0;
+    const uint32_t length = sbufBytesRemaining(src) >= 4 ? sbufReadU32(src) : 0;
+    const uint32_t flashfsSize = flashfsGetSize();
+
+    uint32_t streamLength = 0;
+    if (!ARMING_FLAG(ARMED) && flashfsIsReady() && address < flashfsSize && mspPostProcessFn) {
+        streamLength = MIN(length, flashfsSize - address);
+    }
+
+    sbufWriteU32(dst, address);
+    sbufWriteU32(dst, streamLength);
+
+    if (streamLength) {
+        mspDataflashStreamAddress = address;
+        mspDataflashStreamEnd = address + streamLength;
+        *mspPostProcessFn = mspDataflashStreamFn;
+    }
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#ifdef USE_FLASHFS_LOG_INDEX
+static mspResult_e mspFcDataFlashIndexCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    // as many entries from the requested one as fit, entries that weren't written completely have zero size
+    const int first = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+    const int count = flashfsLogIndexGetCount();
+    const int entrySize = 3 * sizeof(uint32_t);
+    const int entryCount = constrain(MIN(count - first, (sbufBytesRemaining(dst) - 5) / entrySize), 0, 255);
+
+    sbufWriteU16(dst, count);
+    sbufWriteU16(dst, first);
+    sbufWriteU8(dst, entryCount);
+    for (int i = first; i < first + entryCount; i++) {
+        flashfsLogIndexEntry_t entry;
+        if (!flashfsLogIndexGetEntry(i, &entry)) {
+            entry.offset = entry.size = entry.durationMs = 0;
+        }
+        sbufWriteU32(dst, entry.offset);
+        sbufWriteU32(dst, entry.size);
+        sbufWriteU32(dst, entry.durationMs);
+    }
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#ifdef USE_MSP_SETTINGS
+static mspResult_e mspFcSettingsInfoCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(src);
+    UNUSED(mspPostProcessFn);
+
+    sbufWriteU16(dst, valueTableEntryCount);
+    sbufWriteU32(dst, mspSettingsTableHash());
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcSettingsDescriptorsCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    // as many descriptors from the requested one as fit
+    const int first = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+
+    sbufWriteU16(dst, first);
+    uint8_t *countPtr = sbufPtr(dst);
+    sbufWriteU8(dst, 0);
+
+    int count = 0;
+    while (first + count < valueTableEntryCount && count < 255 && mspSettingsSerializeDescriptor(dst, first + count)) {
+        count++;
+    }
+    *countPtr = count;
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcSettingsGetCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    // as many of the requested values as fit, profile settings from the given or the current profiles
+    const int first = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+    const int requested = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : valueTableEntryCount;
+    const uint8_t pidProfileIndex = sbufBytesRemaining(src) >= 1 ? sbufReadU8(src) : MSP_SETTINGS_CURRENT_PROFILE;
+    const uint8_t rateProfileIndex = sbufBytesRemaining(src) >= 1 ? sbufReadU8(src) : MSP_SETTINGS_CURRENT_PROFILE;
+
+    sbufWriteU16(dst, first);
+    uint8_t *countPtr = sbufPtr(dst);
+    sbufWriteU16(dst, 0);
+
+    int count = 0;
+    while (first + count < valueTableEntryCount && count < requested
+        && mspSettingsSerializeValue(dst, first + count, pidProfileIndex, rateProfileIndex)) {
+        count++;
+    }
+    countPtr[0] = count & 0xFF;
+    countPtr[1] = count >> 8;
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcSetSettingsCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    if (ARMING_FLAG(ARMED) || sbufBytesRemaining(src) < 8) {
+        return MSP_RESULT_ERROR;
+    }
+
+    // refuse values laid out for a different settings table, the changes apply on the next MSP_EEPROM_WRITE
+    const uint32_t hash = sbufReadU32(src);
+    const int first = sbufReadU16(src);
+    const uint8_t pidProfileIndex = sbufReadU8(src);
+    const uint8_t rateProfileIndex = sbufReadU8(src);
+
+    if (hash != mspSettingsTableHash()) {
+        return MSP_RESULT_ERROR;
+    }
+
+    int count = 0;
+    bool valid = true;
+    while (sbufBytesRemaining(src) > 0 && valid) {
+        valid = first + count < valueTableEntryCount
+            && mspSettingsDeserializeValue(src, first + count, pidProfileIndex, rateProfileIndex);
+        if (valid) {
+            count++;
+        }
+    }
+
+    if (count) {
+        setConfigDirty();
+    }
+
+    sbufWriteU16(dst, count);
+
+    return valid ? MSP_RESULT_ACK : MSP_RESULT_ERROR;
+}
+#endif
+
+#ifdef USE_BENCHMARK
+static mspResult_e mspFcBenchmarkCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    const int iterations = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : BENCHMARK_ITERATIONS_DEFAULT;
+
+    if (ARMING_FLAG(ARMED) || iterations < 1 || iterations > BENCHMARK_ITERATIONS_MAX) {
+        return MSP_RESULT_ERROR;
+    }
+
+    // kernels that can't run now are sent with zero iterations
+    sbufWriteU32(dst, clockMicrosToCycles(1));
+    sbufWriteU8(dst, BENCHMARK_COUNT);
+    for (benchmarkId_e id = 0; id < BENCHMARK_COUNT; id++) {
+        benchmarkResult_t result;
+        benchmarkRun(id, iterations, &result);
+        sbufWriteU8(dst, id);
+        sbufWriteU16(dst, result.iterations);
+        sbufWriteU32(dst, result.minCycles);
+        sbufWriteU32(dst, result.medianCycles);
+        sbufWriteU32(dst, result.maxCycles);
+    }
+
+    return MSP_RESULT_ACK;
 }
 #endif
 
+/*
+ * Commands with a handler function of their own, looked up with a binary search before the switch based processing
+ * functions are tried. Keep sorted by command.
+ */
+static const mspCommand_t mspCommands[] = {
+#ifdef USE_FLASHFS
+    { MSP_DATAFLASH_READ,           mspFcDataFlashReadCommand },
+#endif
+#ifdef USE_FLASHFS_LOG_INDEX
+    { MSP_DATAFLASH_INDEX,          mspFcDataFlashIndexCommand },
+#endif
+#ifdef USE_FLASHFS
+    { MSP_DATAFLASH_READ_STREAM,    mspFcDataFlashReadStreamCommand },
+#endif
+#ifdef USE_MSP_SETTINGS
+    { MSP_SETTINGS_INFO,            mspFcSettingsInfoCommand },
+    { MSP_SETTINGS_DESCRIPTORS,     mspFcSettingsDescriptorsCommand },
+    { MSP_SETTINGS_GET,             mspFcSettingsGetCommand },
+#endif
+#ifdef USE_BENCHMARK
+    { MSP_BENCHMARK,                mspFcBenchmarkCommand },
+#endif
+#ifdef USE_MSP_SETTINGS
+    { MSP_SET_SETTINGS,             mspFcSetSettingsCommand },
+#endif
+    { MSP_SET_PASSTHROUGH,          mspFcSetPassthroughCommand },
+};
+
+static const mspCommand_t *mspFindCommand(uint8_t cmdMSP)
+{
+    int left = 0;
+    int right = ARRAYLEN(mspCommands);
+
+    while (left < right) {
+        const int mid = (left + right) / 2;
+
+        if (mspCommands[mid].cmd == cmdMSP) {
+            return &mspCommands[mid];
+        } else if (mspCommands[mid].cmd < cmdMSP) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+
+    return NULL;
+}
+
 static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP, sbuf_t *src)
 {
     uint32_t i;
@@ -2217,6 +2704,7 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
             servoParamsMutable(i)->rate = sbufReadU8(src);
             servoParamsMutable(i)->forwardFromChannel = sbufReadU8(src);
             servoParamsMutable(i)->reversedSources = sbufReadU32(src);
+            servoMixerCompile();
         }
 #endif
         break;
@@ -2227,13 +2715,19 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
         if (i >= MAX_SERVO_RULES) {
             return MSP_RESULT_ERROR;
         } else {
-            customServoMixersMutable(i)->targetChannel = sbufReadU8(src);
-            customServoMixersMutable(i)->inputSource = sbufReadU8(src);
-            customServoMixersMutable(i)->rate = sbufReadU8(src);
-            customServoMixersMutable(i)->speed = sbufReadU8(src);
-            customServoMixersMutable(i)->min = sbufReadU8(src);
-            customServoMixersMutable(i)->max = sbufReadU8(src);
-            customServoMixersMutable(i)->box = sbufReadU8(src);
+            servoMixer_t rule;
+            rule.targetChannel = sbufReadU8(src);
+            rule.inputSource = sbufReadU8(src);
+            rule.rate = sbufReadU8(src);
+            rule.speed = sbufReadU8(src);
+            rule.min = sbufReadU8(src);
+            rule.max = sbufReadU8(src);
+            rule.box = sbufReadU8(src);
+            // same limits as the smix CLI command, the mixer indexes with these
+            if (rule.targetChannel >= MAX_SUPPORTED_SERVOS || rule.inputSource >= INPUT_SOURCE_COUNT || rule.box > MAX_SERVO_BOXES) {
+                return MSP_RESULT_ERROR;
+            }
+            *customServoMixersMutable(i) = rule;
             loadCustomServoMixer();
         }
 #endif
@@ -2252,6 +2746,25 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
         flight3DConfigMutable()->deadband3d_throttle = sbufReadU16(src);
         break;
 
+    case MSP_SET_TASK_CONFIG:
+        {
+            taskConfig_t newTaskConfig = *taskConfig();
+            const int count = MIN(sbufReadU8(src), TASK_CONFIG_COUNT);
+            for (int index = 0; index < count; index++) {
+                newTaskConfig.rateHz[index] = MIN(sbufReadU16(src), TASK_CONFIG_RATE_MAX);
+                newTaskConfig.priority[index] = sbufReadU8(src);
+                if (newTaskConfig.priority[index] >= TASK_CONFIG_PRIORITY_COUNT) {
+                    return MSP_RESULT_ERROR;
+                }
+            }
+            if (!tasksConfigFits(&newTaskConfig)) {
+                return MSP_RESULT_ERROR;
+            }
+            *taskConfigMutable() = newTaskConfig;
+            tasksApplyConfig();
+        }
+        break;
+
     case MSP_SET_RESET_CURR_PID:
         resetPidProfile(currentPidProfile);
         break;
@@ -2285,6 +2798,7 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
                 gyroDeviceConfigMutable(1)->alignment = gyroAlignment;
                 break;
             case GYRO_CONFIG_USE_GYRO_BOTH:
+            case GYRO_CONFIG_USE_GYRO_FUSED:
                 // For dual-gyro in "BOTH" mode we'll only update gyro 0
             default:
                 gyroDeviceConfigMutable(0)->alignment = gyroAlignment;
@@ -2531,6 +3045,12 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
         break;
     case MSP_EEPROM_WRITE:
         if (ARMING_FLAG(ARMED)) {
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+            // appended to the stored config in the background, completion is reported by MSP_EEPROM_WRITE_STATE
+            if (saveConfigInBackground()) {
+                break;
+            }
+#endif
             return MSP_RESULT_ERROR;
         }
 
@@ -2880,6 +3400,19 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
         break;
 #endif
 #endif // USE_BOARD_INFO
+
+    case MSP_SET_PUSH_SUBSCRIPTION:
+        if (dataSize >= 1) {
+            const uint8_t rateHz = sbufReadU8(src);
+            if (!mspSerialSetPushSubscription(srcDesc, rateHz, sbufPtr(src), sbufBytesRemaining(src))) {
+                return MSP_RESULT_ERROR;
+            }
+        } else {
+            return MSP_RESULT_ERROR;
+        }
+
+        break;
+
     default:
         // we do not know how to handle the (valid) message, indicate error MSP $M!
         return MSP_RESULT_ERROR;
@@ -3115,20 +3648,16 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
     // initialize reply by default
     reply->cmd = cmd->cmd;
 
-    if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
+    const mspCommand_t *command = mspFindCommand(cmdMSP);
+
+    if (command) {
+        ret = command->fn(dst, src, mspPostProcessFn);
+    } else if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
         ret = MSP_RESULT_ACK;
     } else if (mspProcessOutCommand(cmdMSP, dst)) {
         ret = MSP_RESULT_ACK;
     } else if ((ret = mspFcProcessOutCommandWithArg(srcDesc, cmdMSP, src, dst, mspPostProcessFn)) != MSP_RESULT_CMD_UNKNOWN) {
         /* ret */;
-    } else if (cmdMSP == MSP_SET_PASSTHROUGH) {
-        mspFcSetPassthroughCommand(dst, src, mspPostProcessFn);
-        ret = MSP_RESULT_ACK;
-#ifdef USE_FLASHFS
-    } else if (cmdMSP == MSP_DATAFLASH_READ) {
-        mspFcDataFlashReadCommand(dst, src);
-        ret = MSP_RESULT_ACK;
-#endif
     } else {
         ret = mspCommonProcessInCommand(srcDesc, cmdMSP, src, mspPostProcessFn);
     }
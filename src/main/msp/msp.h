@@ -46,6 +46,10 @@ typedef enum {
     MSP_DIRECTION_REQUEST = 1
 } mspDirection_e;
 
+// MSP v2 header flags. In a request MSP_FLAG_COMPRESSION tells that the host accepts a compressed reply, in the reply
+// that the payload is [u8 huffmanTableId_e][u16 uncompressed size][huffman code], without the EOF symbol
+#define MSP_FLAG_COMPRESSION    (1 << 1)
+
 typedef struct mspPacket_s {
     sbuf_t buf;
     int16_t cmd;
@@ -61,6 +65,13 @@ typedef void (*mspPostProcessFnPtr)(struct serialPort_s *port); // msp post proc
 typedef mspResult_e (*mspProcessCommandFnPtr)(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
 typedef void (*mspProcessReplyFnPtr)(mspPacket_t *cmd);
 
+typedef mspResult_e (*mspCommandFnPtr)(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn);
+
+typedef struct mspCommand_s {
+    uint8_t cmd;
+    mspCommandFnPtr fn;
+} mspCommand_t;
+
 
 void mspInit(void);
 mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
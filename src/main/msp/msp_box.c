@@ -31,6 +31,7 @@
 #include "config/feature.h"
 
 #include "config/config.h"
+#include "fc/rc_curves.h"
 #include "fc/runtime_config.h"
 
 #include "flight/mixer.h"
@@ -96,6 +97,11 @@ static const box_t boxes[CHECKBOX_ITEM_COUNT] = {
     { BOXACROTRAINER, "ACRO TRAINER", 47 },
     { BOXVTXCONTROLDISABLE, "DISABLE VTX CONTROL", 48},
 //    { BOXLAUNCHCONTROL, "LAUNCH CONTROL", 49 },       // HF3D: Removed.
+    { BOXGOVBAILOUT, "GOV BAILOUT", 50 },
+    { BOXIDLEUP1, "IDLE UP 1", 51 },
+    { BOXIDLEUP2, "IDLE UP 2", 52 },
+    { BOXTHROTTLEHOLD, "THROTTLE HOLD", 53 },
+    { BOXSYSID, "SYSTEM ID", 54 },
 };
 
 // mask of enabled IDs, calculated on startup based on enabled features. boxId_e is used as bit index
@@ -258,6 +264,20 @@ void initActiveBoxIds(void)
 
     BME(BOXPARALYZE);
 
+    if (mixerConfig()->gov_max_headspeed > 0) {
+        BME(BOXGOVBAILOUT);
+    }
+
+    if (rcCurveConfig()->enabled) {
+        BME(BOXIDLEUP1);
+        BME(BOXIDLEUP2);
+        BME(BOXTHROTTLEHOLD);
+    }
+
+#ifdef USE_SYSTEM_ID
+    BME(BOXSYSID);
+#endif
+
 #ifdef USE_PINIOBOX
     // Turn BOXUSERx only if pinioBox facility monitors them, as the facility is the only BOXUSERx observer.
     // Note that pinioBoxConfig can be set to monitor any box.
@@ -284,6 +284,19 @@
 #define MSP_VTXTABLE_BAND        137    //out message         vtxTable band/channel data
 #define MSP_VTXTABLE_POWERLEVEL  138    //out message         vtxTable powerLevel data
 #define MSP_MOTOR_TELEMETRY      139    //out message         Per-motor telemetry data (RPM, packet stats, ESC temp, etc.)
+#define MSP_DYN_NOTCH_PEAKS      140    //out message         Dynamic notch tracked peaks (frequency, magnitude) per axis
+#define MSP_TASK_PROFILE         141    //out message         Per-task and PID loop sub-step cycle percentiles
+#define MSP_TASK_CONFIG          142    //out message         Configurable task rates and priorities
+#define MSP_DATAFLASH_INDEX      143    //out message         Start, size and duration of the logs in the dataflash log index
+#define MSP_DATAFLASH_READ_STREAM 144   //out message         Stream a range of the dataflash as raw bytes and a CRC after the reply
+#define MSP_EEPROM_WRITE_STATE   145    //out message         State of the last config save, saves while armed run in the background
+#define MSP_SETTINGS_INFO        146    //out message         Number of settings and the hash of their descriptors
+#define MSP_SETTINGS_DESCRIPTORS 147    //out message         Name, type and limits of the settings from a given index on
+#define MSP_SETTINGS_GET         148    //out message         Binary values of a range of settings
+#define MSP_DMA_PLAN             149    //out message         DMA requests with their configured and assigned options
+#define MSP_BENCHMARK            151    //out message         Cycles of the hot path kernels at the current config, disarmed only
+#define MSP_FLIGHT_STATS         152    //out message         Persistent totals and the performance and health counters of the last flight
+#define MSP_SYSID                153    //out message         State and frequency response of the last system identification run
 
 #define MSP_SET_RAW_RC           200    //in message          8 rc chan
 #define MSP_SET_RAW_GPS          201    //in message          fix, numsat, lat, lon, alt, speed
@@ -314,6 +327,9 @@
 #define MSP_SET_GPS_RESCUE_PIDS  226    //in message          GPS Rescues's throttleP and velocity PIDS + yaw P
 #define MSP_SET_VTXTABLE_BAND    227    //in message          set vtxTable band/channel data (one band at a time)
 #define MSP_SET_VTXTABLE_POWERLEVEL 228 //in message          set vtxTable powerLevel data (one powerLevel at a time)
+#define MSP_SET_TASK_CONFIG      229    //in message          Configurable task rates and priorities, rejected above the projected load limit
+#define MSP_DSHOT_COMMAND        231    //out message         DShot command queue length, last queued and last completed command id
+#define MSP_SET_DSHOT_COMMAND    232    //in message          Queue a DShot command for a motor or all motors, replies with its id
 
 // #define MSP_BIND                 240    //in message          no param
 // #define MSP_ALARMS               242
@@ -336,6 +352,8 @@
 #define MSP_SET_ACC_TRIM         239    //in message          set acc angle trim values
 #define MSP_SERVO_MIX_RULES      241    //out message         Returns servo mixer configuration
 #define MSP_SET_SERVO_MIX_RULE   242    //in message          Sets servo mixer configuration
+#define MSP_SET_PUSH_SUBSCRIPTION 243   //in message          Rate and list of commands to push as MSP_MULTIPLE_MSP replies, a zero rate stops them
+#define MSP_SET_SETTINGS         244    //in message          Binary values of a range of settings, checked against the descriptor hash
 #define MSP_SET_PASSTHROUGH      245    //in message          Sets up passthrough to different peripherals (4way interface, uart, etc...)
 #define MSP_SET_RTC              246    //in message          Sets the RTC clock
 #define MSP_RTC                  247    //out message         Gets the RTC clock
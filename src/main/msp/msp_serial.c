@@ -28,15 +28,19 @@
 
 #include "cli/cli.h"
 
+#include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 #include "common/crc.h"
+#include "common/huffman.h"
+#include "common/scratch.h"
 
 #include "drivers/system.h"
 
 #include "io/displayport_msp.h"
 
 #include "msp/msp.h"
+#include "msp/msp_protocol.h"
 
 #include "msp_serial.h"
 
@@ -394,10 +398,73 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
     return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen);
 }
 
-static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+// Shared by the replies and the subscription pushes, both are sent from the serial task
+static uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
+
+#ifdef USE_HUFFMAN
+#define MSP_COMPRESS_MIN_SIZE   64
+#define MSP_COMPRESS_INFO_SIZE  (sizeof(uint8_t) + sizeof(uint16_t))
+
+static huffmanTableId_e mspSerialCompressionTable(int16_t cmd)
+{
+    switch (cmd) {
+    case MSP_NAME:
+    case MSP_BOXNAMES:
+    case MSP_SETTINGS_DESCRIPTORS:
+        return HUFFMAN_TABLE_TEXT;
+    default:
+        return HUFFMAN_TABLE_BINARY;
+    }
+}
+
+/*
+ * Replace a large reply in outBuf with its huffman code, the reply is kept as it is if the code would not be smaller.
+ * The dataflash reads are already compressed by their own reply format.
+ */
+static void mspSerialCompressReply(mspPacket_t *reply)
 {
-    static uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
+    const int dataLen = sbufBytesRemaining(&reply->buf);
+    if (dataLen < MSP_COMPRESS_MIN_SIZE || reply->cmd == MSP_DATAFLASH_READ || reply->result == MSP_RESULT_ERROR) {
+        return;
+    }
+
+    // the encoder clears the byte after the last one it fills
+    const int codeLen = MIN(dataLen - (int)MSP_COMPRESS_INFO_SIZE - 1, SCRATCH_SIZE - 1);
+    uint8_t *code = scratchAlloc(codeLen + 1);
+    if (!code) {
+        return;
+    }
+
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = code,
+        .outBufLen = codeLen,
+        .outBit = 0x80,
+    };
+    *state.outByte = 0;
+
+    const huffmanTableId_e tableId = mspSerialCompressionTable(reply->cmd);
+    const int status = huffmanEncodeBufStreaming(&state, reply->buf.ptr, dataLen,
+        tableId == HUFFMAN_TABLE_TEXT ? huffmanTableText : huffmanTable);
+    if (state.outBit != 0x80) {
+        ++state.bytesWritten;
+    }
 
+    if (status == 0 && state.bytesWritten <= codeLen) {
+        sbuf_t *dst = &reply->buf;
+        uint8_t *head = dst->ptr;
+        sbufWriteU8(dst, tableId);
+        sbufWriteU16(dst, dataLen);
+        sbufWriteData(dst, code, state.bytesWritten);
+        sbufSwitchToReader(dst, head);
+        reply->flags |= MSP_FLAG_COMPRESSION;
+    }
+    scratchFree(code);
+}
+#endif
+
+static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+{
     mspPacket_t reply = {
         .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
         .cmd = -1,
@@ -420,12 +487,53 @@ static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspPr
 
     if (status != MSP_RESULT_NO_REPLY) {
         sbufSwitchToReader(&reply.buf, outBufHead); // change streambuf direction
+#ifdef USE_HUFFMAN
+        if ((command.flags & MSP_FLAG_COMPRESSION) && msp->mspVersion != MSP_V1) {
+            mspSerialCompressReply(&reply);
+        }
+#endif
         mspSerialEncode(msp, &reply, msp->mspVersion);
     }
 
     return mspPostProcessFn;
 }
 
+/*
+ * Push the subscribed commands as one MSP_MULTIPLE_MSP reply, in the same format as if the host had requested them
+ * with MSP_MULTIPLE_MSP. A push is skipped if the port can't take it right now.
+ */
+static void mspSerialProcessPushSubscription(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    const timeMs_t now = millis();
+
+    if (!msp->pushCommandCount || cmp32(now, msp->lastPushMs) < (int32_t)msp->pushIntervalMs) {
+        return;
+    }
+    msp->lastPushMs = now;
+
+    mspPacket_t reply = {
+        .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
+        .cmd = -1,
+        .flags = 0,
+        .result = 0,
+        .direction = MSP_DIRECTION_REPLY,
+    };
+    uint8_t *outBufHead = reply.buf.ptr;
+
+    mspPacket_t command = {
+        .buf = { .ptr = msp->pushCommands, .end = msp->pushCommands + msp->pushCommandCount, },
+        .cmd = MSP_MULTIPLE_MSP,
+        .flags = 0,
+        .result = 0,
+        .direction = MSP_DIRECTION_REQUEST,
+    };
+
+    if (mspProcessCommandFn(msp->descriptor, &command, &reply, NULL) == MSP_RESULT_ACK) {
+        sbufSwitchToReader(&reply.buf, outBufHead);
+        mspSerialEncode(msp, &reply, msp->mspVersion);
+    }
+}
+
 static void mspEvaluateNonMspData(mspPort_t * mspPort, uint8_t receivedChar)
 {
    if (receivedChar == serialConfig()->reboot_character) {
@@ -534,6 +642,10 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
         else {
             mspProcessPendingRequest(mspPort);
         }
+
+        if (mspPort->c_state == MSP_IDLE) {
+            mspSerialProcessPushSubscription(mspPort, mspProcessCommandFn);
+        }
     }
 }
 
@@ -583,6 +695,39 @@ int mspSerialPush(serialPortIdentifier_e port, uint8_t cmd, uint8_t *data, int d
 }
 
 
+/*
+ * Set the commands to push on the MSP port with the given descriptor, a zero rate or no commands stop the pushes.
+ * Returns false if the descriptor isn't one of a serial MSP port that can take pushes.
+ */
+bool mspSerialSetPushSubscription(mspDescriptor_t descriptor, uint8_t rateHz, const uint8_t *commands, int commandCount)
+{
+    for (int portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
+        mspPort_t * const mspPort = &mspPorts[portIndex];
+
+        if (!mspPort->port || mspPort->descriptor != descriptor) {
+            continue;
+        }
+
+        // The telemetry owns the port most of the time
+        if (mspPort->sharedWithTelemetry || commandCount > MSP_PUSH_MAX_COMMANDS) {
+            return false;
+        }
+
+        if (rateHz == 0) {
+            commandCount = 0;
+        }
+
+        memcpy(mspPort->pushCommands, commands, commandCount);
+        mspPort->pushCommandCount = commandCount;
+        mspPort->pushIntervalMs = commandCount ? 1000 / MIN(rateHz, MSP_PUSH_MAX_RATE_HZ) : 0;
+        mspPort->lastPushMs = millis();
+
+        return true;
+    }
+
+    return false;
+}
+
 uint32_t mspSerialTxBytesFree(void)
 {
     uint32_t ret = UINT32_MAX;
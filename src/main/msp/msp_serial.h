@@ -97,6 +97,10 @@ typedef struct __attribute__((packed)) {
 
 #define MSP_MAX_HEADER_SIZE     9
 
+// Commands that can be pushed together at a fixed rate, without the host polling for each of them
+#define MSP_PUSH_MAX_COMMANDS   16
+#define MSP_PUSH_MAX_RATE_HZ    100     // the rate of the serial task
+
 struct serialPort_s;
 typedef struct mspPort_s {
     struct serialPort_s *port; // null when port unused.
@@ -114,6 +118,10 @@ typedef struct mspPort_s {
     uint8_t checksum2;
     bool sharedWithTelemetry;
     mspDescriptor_t descriptor;
+    uint8_t pushCommands[MSP_PUSH_MAX_COMMANDS];
+    uint8_t pushCommandCount;
+    timeMs_t pushIntervalMs;
+    timeMs_t lastPushMs;
 } mspPort_t;
 
 void mspSerialInit(void);
@@ -123,4 +131,5 @@ void mspSerialAllocatePorts(void);
 void mspSerialReleasePortIfAllocated(struct serialPort_s *serialPort);
 void mspSerialReleaseSharedTelemetryPorts(void);
 int mspSerialPush(serialPortIdentifier_e port, uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction);
+bool mspSerialSetPushSubscription(mspDescriptor_t descriptor, uint8_t rateHz, const uint8_t *commands, int commandCount);
 uint32_t mspSerialTxBytesFree(void);
@@ -0,0 +1,342 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_MSP_SETTINGS
+
+#include "cli/settings.h"
+
+#include "common/maths.h"
+#include "common/streambuf.h"
+
+#include "config/config.h"
+
+#include "fc/controlrate_profile.h"
+
+#include "flight/pid.h"
+
+#include "pg/pg.h"
+
+#include "msp/msp_settings.h"
+
+// Largest serialized descriptor: name length byte, name, type, value size and min/max
+#define MSP_SETTINGS_DESCRIPTOR_MAX_SIZE (1 + 255 + 1 + 1 + 8)
+
+#define FNV_OFFSET_BASIS 0x811c9dc5
+#define FNV_PRIME        0x01000193
+
+static int settingElementSize(const clivalue_t *value)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_INT8:
+        return 1;
+    case VAR_UINT16:
+    case VAR_INT16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+static int settingValueSize(const clivalue_t *value)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_ARRAY:
+        return value->config.array.length * settingElementSize(value);
+    case MODE_BITSET:
+        return 1;
+    case MODE_STRING:
+        return value->config.string.maxlength;
+    default:
+        return settingElementSize(value);
+    }
+}
+
+static int descriptorConfigSize(const clivalue_t *value)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_DIRECT:
+        return 8;
+    case MODE_LOOKUP:
+        return 2;
+    case MODE_STRING:
+        return 3;
+    default:
+        return 1;
+    }
+}
+
+static void getSettingMinMax(const clivalue_t *value, int32_t *min, int32_t *max)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_UINT16:
+        *min = value->config.minmaxUnsigned.min;
+        *max = value->config.minmaxUnsigned.max;
+        break;
+    case VAR_UINT32:
+        *min = 0;
+        *max = value->config.u32Max;
+        break;
+    default:
+        *min = value->config.minmax.min;
+        *max = value->config.minmax.max;
+        break;
+    }
+}
+
+static uint8_t *getSettingPointer(const clivalue_t *value, uint8_t pidProfileIndex, uint8_t rateProfileIndex)
+{
+    const pgRegistry_t *reg = pgFind(value->pgn);
+    if (!reg) {
+        return NULL;
+    }
+
+    uint16_t offset = value->offset;
+    switch (value->type & VALUE_SECTION_MASK) {
+    case PROFILE_VALUE:
+        if (pidProfileIndex == MSP_SETTINGS_CURRENT_PROFILE) {
+            pidProfileIndex = getCurrentPidProfileIndex();
+        }
+        if (pidProfileIndex >= PID_PROFILE_COUNT) {
+            return NULL;
+        }
+        offset += sizeof(pidProfile_t) * pidProfileIndex;
+        break;
+    case PROFILE_RATE_VALUE:
+        if (rateProfileIndex == MSP_SETTINGS_CURRENT_PROFILE) {
+            rateProfileIndex = getCurrentControlRateProfileIndex();
+        }
+        if (rateProfileIndex >= CONTROL_RATE_PROFILE_COUNT) {
+            return NULL;
+        }
+        offset += sizeof(controlRateConfig_t) * rateProfileIndex;
+        break;
+    }
+
+    return reg->address + offset;
+}
+
+static uint32_t readSettingElement(const uint8_t *ptr, const clivalue_t *value)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_INT8:
+        return *ptr;
+    case VAR_UINT16:
+    case VAR_INT16:
+        return *(uint16_t *)ptr;
+    default:
+        return *(uint32_t *)ptr;
+    }
+}
+
+static void writeSettingElement(uint8_t *ptr, const clivalue_t *value, uint32_t element)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_INT8:
+        *ptr = element;
+        break;
+    case VAR_UINT16:
+    case VAR_INT16:
+        *(uint16_t *)ptr = element;
+        break;
+    default:
+        *(uint32_t *)ptr = element;
+        break;
+    }
+}
+
+static int32_t settingElementToInt(const clivalue_t *value, uint32_t element)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_INT8:
+        return (int8_t)element;
+    case VAR_INT16:
+        return (int16_t)element;
+    default:
+        return element;
+    }
+}
+
+uint32_t mspSettingsTableHash(void)
+{
+    static uint32_t tableHash;
+    static bool tableHashValid;
+
+    if (!tableHashValid) {
+        uint32_t hash = FNV_OFFSET_BASIS;
+        uint8_t buffer[MSP_SETTINGS_DESCRIPTOR_MAX_SIZE];
+
+        for (int i = 0; i < valueTableEntryCount; i++) {
+            sbuf_t descriptor;
+            sbufInit(&descriptor, buffer, buffer + sizeof(buffer));
+            mspSettingsSerializeDescriptor(&descriptor, i);
+
+            for (const uint8_t *p = buffer; p < sbufPtr(&descriptor); p++) {
+                hash = (hash ^ *p) * FNV_PRIME;
+            }
+        }
+
+        tableHash = hash;
+        tableHashValid = true;
+    }
+
+    return tableHash;
+}
+
+// Serializes the descriptor of a setting, returns false without writing anything if it does not fit
+bool mspSettingsSerializeDescriptor(sbuf_t *dst, int index)
+{
+    const clivalue_t *value = &valueTable[index];
+    const int nameLength = MIN(strlen(value->name), 255U);
+
+    if (sbufBytesRemaining(dst) < 1 + nameLength + 2 + descriptorConfigSize(value)) {
+        return false;
+    }
+
+    sbufWriteU8(dst, nameLength);
+    sbufWriteData(dst, value->name, nameLength);
+    sbufWriteU8(dst, value->type);
+    sbufWriteU8(dst, settingValueSize(value));
+
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_DIRECT: {
+        int32_t min, max;
+        getSettingMinMax(value, &min, &max);
+        sbufWriteU32(dst, min);
+        sbufWriteU32(dst, max);
+        break;
+    }
+    case MODE_LOOKUP:
+        sbufWriteU8(dst, value->config.lookup.tableIndex);
+        sbufWriteU8(dst, lookupTables[value->config.lookup.tableIndex].valueCount);
+        break;
+    case MODE_ARRAY:
+        sbufWriteU8(dst, value->config.array.length);
+        break;
+    case MODE_BITSET:
+        sbufWriteU8(dst, value->config.bitpos);
+        break;
+    case MODE_STRING:
+        sbufWriteU8(dst, value->config.string.minlength);
+        sbufWriteU8(dst, value->config.string.maxlength);
+        sbufWriteU8(dst, value->config.string.flags);
+        break;
+    }
+
+    return true;
+}
+
+// Serializes the value of a setting in its stored little endian layout, a bitset as a single 0 or 1 byte
+bool mspSettingsSerializeValue(sbuf_t *dst, int index, uint8_t pidProfileIndex, uint8_t rateProfileIndex)
+{
+    const clivalue_t *value = &valueTable[index];
+    const int size = settingValueSize(value);
+    const uint8_t *ptr = getSettingPointer(value, pidProfileIndex, rateProfileIndex);
+
+    if (!ptr || sbufBytesRemaining(dst) < size) {
+        return false;
+    }
+
+    if ((value->type & VALUE_MODE_MASK) == MODE_BITSET) {
+        sbufWriteU8(dst, (readSettingElement(ptr, value) >> value->config.bitpos) & 1);
+    } else {
+        sbufWriteData(dst, ptr, size);
+    }
+
+    return true;
+}
+
+// Validates and applies the value of a setting, returns false and leaves the setting unchanged if it is invalid
+bool mspSettingsDeserializeValue(sbuf_t *src, int index, uint8_t pidProfileIndex, uint8_t rateProfileIndex)
+{
+    const clivalue_t *value = &valueTable[index];
+    const int size = settingValueSize(value);
+    uint8_t *ptr = getSettingPointer(value, pidProfileIndex, rateProfileIndex);
+
+    if (!ptr || sbufBytesRemaining(src) < size) {
+        return false;
+    }
+
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_DIRECT: {
+        uint32_t element = readSettingElement(sbufPtr(src), value);
+        int32_t min, max;
+        getSettingMinMax(value, &min, &max);
+        if ((value->type & VALUE_TYPE_MASK) == VAR_UINT32) {
+            if (element > value->config.u32Max) {
+                return false;
+            }
+        } else if (settingElementToInt(value, element) < min || settingElementToInt(value, element) > max) {
+            return false;
+        }
+        writeSettingElement(ptr, value, element);
+        break;
+    }
+    case MODE_LOOKUP: {
+        uint32_t element = readSettingElement(sbufPtr(src), value);
+        if (element >= lookupTables[value->config.lookup.tableIndex].valueCount) {
+            return false;
+        }
+        writeSettingElement(ptr, value, element);
+        break;
+    }
+    case MODE_ARRAY:
+        memcpy(ptr, sbufPtr(src), size);
+        break;
+    case MODE_BITSET: {
+        const uint8_t bit = *sbufPtr(src);
+        if (bit > 1) {
+            return false;
+        }
+        const uint32_t mask = 1 << value->config.bitpos;
+        uint32_t element = readSettingElement(ptr, value);
+        writeSettingElement(ptr, value, bit ? (element | mask) : (element & ~mask));
+        break;
+    }
+    case MODE_STRING: {
+        const char *string = (const char *)sbufPtr(src);
+        const int length = strnlen(string, size);
+        if (length > 0 && length < value->config.string.minlength) {
+            return false;
+        }
+        if ((value->config.string.flags & STRING_FLAGS_WRITEONCE) && ptr[0] && strncmp((const char *)ptr, string, size)) {
+            return false;
+        }
+        memset(ptr, 0, size);
+        memcpy(ptr, string, length);
+        break;
+    }
+    }
+
+    sbufAdvance(src, size);
+
+    return true;
+}
+
+#endif
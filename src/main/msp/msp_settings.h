@@ -0,0 +1,33 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MSP_SETTINGS_CURRENT_PROFILE 0xFF   // profile index selecting the active pid or rate profile
+
+struct sbuf_s;
+
+uint32_t mspSettingsTableHash(void);
+bool mspSettingsSerializeDescriptor(struct sbuf_s *dst, int index);
+bool mspSettingsSerializeValue(struct sbuf_s *dst, int index, uint8_t pidProfileIndex, uint8_t rateProfileIndex);
+bool mspSettingsDeserializeValue(struct sbuf_s *src, int index, uint8_t pidProfileIndex, uint8_t rateProfileIndex);
@@ -83,6 +83,8 @@
 
 #include "rx/rx.h"
 
+#include "scheduler/scheduler.h"
+
 #include "sensors/acceleration.h"
 #include "sensors/battery.h"
 #include "sensors/esc_sensor.h"
@@ -129,6 +131,7 @@ static uint8_t osdProfile = 1;
 static displayPort_t *osdDisplayPort;
 static osdDisplayPortDevice_e osdDisplayPortDevice;
 static bool osdIsReady;
+static bool osdDrawPending;             // elements of the current frame are still being drawn
 
 static bool suppressStatsDisplay = false;
 static uint8_t osdStatsRowCount = 0;
@@ -141,9 +144,9 @@ escSensorData_t *osdEscDataCombined;
 
 STATIC_ASSERT(OSD_POS_MAX == OSD_POS(31,31), OSD_POS_MAX_incorrect);
 
-PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 7);
+PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 8);
 
-PG_REGISTER_WITH_RESET_FN(osdElementConfig_t, osdElementConfig, PG_OSD_ELEMENT_CONFIG, 0);
+PG_REGISTER_WITH_RESET_FN(osdElementConfig_t, osdElementConfig, PG_OSD_ELEMENT_CONFIG, 1);
 
 // Controls the display order of the OSD post-flight statistics.
 // Adjust the ordering here to control how the post-flight stats are presented.
@@ -246,12 +249,13 @@ void osdAnalyzeActiveElements(void)
     osdDrawActiveElementsBackground(osdDisplayPort);
 }
 
-static void osdDrawElements(timeUs_t currentTimeUs)
+// Returns false while the elements are still being drawn in scheduler slices
+static bool osdDrawElements(timeUs_t currentTimeUs)
 {
     // Hide OSD when OSDSW mode is active
     if (IS_RC_MODE_ACTIVE(BOXOSD)) {
         displayClearScreen(osdDisplayPort);
-        return;
+        return true;
     }
 
     if (backgroundLayerSupported) {
@@ -264,7 +268,7 @@ static void osdDrawElements(timeUs_t currentTimeUs)
         displayClearScreen(osdDisplayPort);
     }
 
-    osdDrawActiveElements(osdDisplayPort, currentTimeUs);
+    return osdDrawActiveElements(osdDisplayPort, currentTimeUs);
 }
 
 const uint16_t osdTimerDefault[OSD_TIMER_COUNT] = {
@@ -333,6 +337,8 @@ void pgResetFn_osdConfig(osdConfig_t *osdConfig)
 
     osdConfig->camera_frame_width = 24;
     osdConfig->camera_frame_height = 11;
+
+    osdConfig->collective_max_pitch = 120;  // 12 degrees
 }
 
 void pgResetFn_osdElementConfig(osdElementConfig_t *osdElementConfig)
@@ -958,12 +964,37 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
 #endif
     {
         osdUpdateAlarms();
-        osdDrawElements(currentTimeUs);
+        if (!osdDrawElements(currentTimeUs)) {
+            // finished from osdUpdate(), the screen is not sent until the elements are complete
+            osdDrawPending = true;
+            schedulerTaskContinue();
+            return;
+        }
         displayHeartbeat(osdDisplayPort);
     }
     displayCommitTransaction(osdDisplayPort);
 }
 
+static void osdDrawPendingElements(timeUs_t currentTimeUs)
+{
+#ifdef USE_CMS
+    if (displayIsGrabbed(osdDisplayPort)) {
+        // the menu has taken over the display, drop the rest of the frame
+        osdDrawActiveElementsAbort();
+        osdDrawPending = false;
+        displayCommitTransaction(osdDisplayPort);
+        return;
+    }
+#endif
+    if (!osdDrawActiveElements(osdDisplayPort, currentTimeUs)) {
+        schedulerTaskContinue();
+        return;
+    }
+    osdDrawPending = false;
+    displayHeartbeat(osdDisplayPort);
+    displayCommitTransaction(osdDisplayPort);
+}
+
 /*
  * Called periodically by the scheduler
  */
@@ -982,6 +1013,11 @@ void osdUpdate(timeUs_t currentTimeUs)
     }
 #endif // MAX7456_DMA_CHANNEL_TX
 
+    if (osdDrawPending) {
+        osdDrawPendingElements(currentTimeUs);
+        return;
+    }
+
 #ifdef USE_SLOW_MSP_DISPLAYPORT_RATE_WHEN_UNARMED
     static uint32_t idlecounter = 0;
     if (!ARMING_FLAG(ARMED)) {
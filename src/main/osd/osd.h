@@ -143,6 +143,10 @@ typedef enum {
     OSD_RSSI_DBM_VALUE,
     OSD_RC_CHANNELS,
     OSD_CAMERA_FRAME,
+    OSD_HEADSPEED,
+    OSD_GOVERNOR,
+    OSD_COLLECTIVE_PITCH,
+    OSD_SWASH_RING,
     OSD_ITEM_COUNT // MUST BE LAST
 } osd_items_e;
 
@@ -286,6 +290,7 @@ typedef struct osdConfig_s {
     uint8_t logo_on_arming_duration;          // display duration in 0.1s units
     uint8_t camera_frame_width;               // The width of the box for the camera frame element
     uint8_t camera_frame_height;              // The height of the box for the camera frame element
+    uint8_t collective_max_pitch;             // collective pitch at full stick in 0.1 degrees, for the collective pitch element
 } osdConfig_t;
 
 PG_DECLARE(osdConfig_t, osdConfig);
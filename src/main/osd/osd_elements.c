@@ -102,6 +102,7 @@
 #include "flight/gps_rescue.h"
 #include "flight/failsafe.h"
 #include "flight/position.h"
+#include "flight/governor.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
@@ -116,13 +117,18 @@
 
 #include "rx/rx.h"
 
+#include "scheduler/scheduler.h"
+
 #include "sensors/acceleration.h"
 #include "sensors/adcinternal.h"
 #include "sensors/barometer.h"
 #include "sensors/battery.h"
 #include "sensors/esc_sensor.h"
+#include "sensors/rpm_source.h"
 #include "sensors/sensors.h"
 
+#include "telemetry/snapshot.h"
+
 
 #define AH_SYMBOL_COUNT 9
 #define AH_SIDEBAR_WIDTH_POS 7
@@ -1156,6 +1162,102 @@ static void osdElementStickOverlay(osdElementParms_t *element)
 }
 #endif // USE_OSD_STICK_OVERLAY
 
+/*
+ * The heli elements read the telemetry snapshot, taken at most once per
+ * frame, and keep their formatted text until the value changes.
+ */
+#define OSD_HELI_SNAPSHOT_MAX_AGE_US 100000
+#define OSD_HELI_ELEMENT_TEXT_LENGTH 12
+
+typedef struct osdHeliElementCache_s {
+    int32_t value;
+    bool valid;
+    char text[OSD_HELI_ELEMENT_TEXT_LENGTH];
+} osdHeliElementCache_t;
+
+static osdHeliElementCache_t heliElementCache[OSD_SWASH_RING - OSD_HEADSPEED + 1];
+static const telemetrySnapshot_t *heliSnapshot;
+
+static const telemetrySnapshot_t *osdGetHeliSnapshot(void)
+{
+    if (!heliSnapshot) {
+        heliSnapshot = getFreshTelemetrySnapshot(micros(), OSD_HELI_SNAPSHOT_MAX_AGE_US);
+    }
+    return heliSnapshot;
+}
+
+// Returns the cache of the element, its text must be formatted again when the value changed
+static osdHeliElementCache_t *osdHeliElementCache(const osdElementParms_t *element, int32_t value, bool *changed)
+{
+    osdHeliElementCache_t *cache = &heliElementCache[element->item - OSD_HEADSPEED];
+
+    *changed = !cache->valid || cache->value != value;
+    cache->value = value;
+    cache->valid = true;
+
+    return cache;
+}
+
+static void osdElementHeadspeed(osdElementParms_t *element)
+{
+    const int32_t rpm = osdGetHeliSnapshot()->headspeed;
+    bool changed;
+    osdHeliElementCache_t *cache = osdHeliElementCache(element, rpm, &changed);
+
+    if (changed) {
+        tfp_sprintf(cache->text, "%5dR", rpm);
+    }
+    strcpy(element->buff, cache->text);
+}
+
+static void osdElementGovernor(osdElementParms_t *element)
+{
+    const telemetrySnapshot_t *snap = osdGetHeliSnapshot();
+    bool changed;
+    osdHeliElementCache_t *cache = osdHeliElementCache(element, snap->governorThrottle | (snap->governorState << 8), &changed);
+
+    if (changed) {
+        if (snap->governorState == GOV_STATE_IDLE) {
+            tfp_sprintf(cache->text, "G OFF");
+        } else {
+            tfp_sprintf(cache->text, "G%3d%%", snap->governorThrottle);
+        }
+    }
+    strcpy(element->buff, cache->text);
+
+    if (snap->governorState == GOV_STATE_LOST_SIGNAL) {
+        element->attr = DISPLAYPORT_ATTR_WARNING;
+    }
+}
+
+static void osdElementCollectivePitch(osdElementParms_t *element)
+{
+    const int32_t deciDegrees = osdGetHeliSnapshot()->collectivePitch * osdConfig()->collective_max_pitch / 100;
+    bool changed;
+    osdHeliElementCache_t *cache = osdHeliElementCache(element, deciDegrees, &changed);
+
+    if (changed) {
+        tfp_sprintf(cache->text, "%c%c%d.%d", SYM_PITCH, deciDegrees < 0 ? '-' : ' ', abs(deciDegrees) / 10, abs(deciDegrees) % 10);
+    }
+    strcpy(element->buff, cache->text);
+}
+
+static void osdElementSwashRing(osdElementParms_t *element)
+{
+    const int32_t percent = osdGetHeliSnapshot()->swashRing;
+    bool changed;
+    osdHeliElementCache_t *cache = osdHeliElementCache(element, percent, &changed);
+
+    if (changed) {
+        tfp_sprintf(cache->text, "SR%3d%%", percent);
+    }
+    strcpy(element->buff, cache->text);
+
+    if (percent >= 100) {
+        element->attr = DISPLAYPORT_ATTR_WARNING;
+    }
+}
+
 static void osdElementThrottlePosition(osdElementParms_t *element)
 {
     tfp_sprintf(element->buff, "%c%3d", SYM_THR, calculateThrottlePercent());
@@ -1486,6 +1588,10 @@ static const uint8_t osdElementDisplayOrder[] = {
 #endif
     OSD_RC_CHANNELS,
     OSD_CAMERA_FRAME,
+    OSD_HEADSPEED,
+    OSD_GOVERNOR,
+    OSD_COLLECTIVE_PITCH,
+    OSD_SWASH_RING,
 };
 
 // Define the mapping between the OSD element id and the function to draw it
@@ -1590,6 +1696,10 @@ const osdElementDrawFn osdElementDrawFunction[OSD_ITEM_COUNT] = {
     [OSD_RSSI_DBM_VALUE]          = osdElementRssiDbm,
 #endif
     [OSD_RC_CHANNELS]             = osdElementRcChannels,
+    [OSD_HEADSPEED]               = osdElementHeadspeed,
+    [OSD_GOVERNOR]                = osdElementGovernor,
+    [OSD_COLLECTIVE_PITCH]        = osdElementCollectivePitch,
+    [OSD_SWASH_RING]              = osdElementSwashRing,
 };
 
 // Define the mapping between the OSD element id and the function to draw its background (static part)
@@ -1713,29 +1823,49 @@ static void osdDrawSingleElementBackground(displayPort_t *osdDisplayPort, uint8_
     }
 }
 
-void osdDrawActiveElements(displayPort_t *osdDisplayPort, timeUs_t currentTimeUs)
+static unsigned activeElementIndex = 0;
+
+// Draws the active elements in scheduler slices. Returns true once all are drawn, otherwise the
+// next call carries on from the first element not drawn yet.
+bool osdDrawActiveElements(displayPort_t *osdDisplayPort, timeUs_t currentTimeUs)
 {
+    if (activeElementIndex == 0) {
 #ifdef USE_GPS
-    static bool lastGpsSensorState;
-    // Handle the case that the GPS_SENSOR may be delayed in activation
-    // or deactivate if communication is lost with the module.
-    const bool currentGpsSensorState = sensors(SENSOR_GPS);
-    if (lastGpsSensorState != currentGpsSensorState) {
-        lastGpsSensorState = currentGpsSensorState;
-        osdAnalyzeActiveElements();
-    }
+        static bool lastGpsSensorState;
+        // Handle the case that the GPS_SENSOR may be delayed in activation
+        // or deactivate if communication is lost with the module.
+        const bool currentGpsSensorState = sensors(SENSOR_GPS);
+        if (lastGpsSensorState != currentGpsSensorState) {
+            lastGpsSensorState = currentGpsSensorState;
+            osdAnalyzeActiveElements();
+        }
 #endif // USE_GPS
 
-    blinkState = (currentTimeUs / 200000) % 2;
+        blinkState = (currentTimeUs / 200000) % 2;
+        heliSnapshot = NULL;
+    }
 
-    for (unsigned i = 0; i < activeOsdElementCount; i++) {
+    while (activeElementIndex < activeOsdElementCount) {
         if (!backgroundLayerSupported) {
             // If the background layer isn't supported then we
             // have to draw the element's static layer as well.
-            osdDrawSingleElementBackground(osdDisplayPort, activeOsdElementArray[i]);
+            osdDrawSingleElementBackground(osdDisplayPort, activeOsdElementArray[activeElementIndex]);
+        }
+        osdDrawSingleElement(osdDisplayPort, activeOsdElementArray[activeElementIndex]);
+
+        if (++activeElementIndex < activeOsdElementCount && schedulerTaskSliceExpired()) {
+            return false;
         }
-        osdDrawSingleElement(osdDisplayPort, activeOsdElementArray[i]);
     }
+
+    activeElementIndex = 0;
+    return true;
+}
+
+// Drops a frame that is partly drawn, the next call of osdDrawActiveElements() starts a new one
+void osdDrawActiveElementsAbort(void)
+{
+    activeElementIndex = 0;
 }
 
 void osdDrawActiveElementsBackground(displayPort_t *osdDisplayPort)
@@ -1754,6 +1884,7 @@ void osdElementsInit(bool backgroundLayerFlag)
 {
     backgroundLayerSupported = backgroundLayerFlag;
     activeOsdElementCount = 0;
+    memset(heliElementCache, 0, sizeof(heliElementCache));
 }
 
 void osdResetAlarms(void)
@@ -47,6 +47,8 @@ typedef struct adcConfig_s {
     uint16_t tempSensorCalibration2;
 
     int8_t dmaopt[MAX_ADC_SUPPORTED]; // One per ADCDEV_x
+
+    uint8_t motorSync;          // trigger conversions from the motor timer update event
 } adcConfig_t;
 
 PG_DECLARE(adcConfig_t, adcConfig);
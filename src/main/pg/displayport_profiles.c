@@ -19,6 +19,7 @@
  */
 
 #include <stdbool.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -28,13 +29,22 @@
 
 #if defined(USE_MSP_DISPLAYPORT)
 
-PG_REGISTER(displayPortProfile_t, displayPortProfileMsp, PG_DISPLAY_PORT_MSP_CONFIG, 0);
+PG_REGISTER_WITH_RESET_FN(displayPortProfile_t, displayPortProfileMsp, PG_DISPLAY_PORT_MSP_CONFIG, 1);
+
+void pgResetFn_displayPortProfileMsp(displayPortProfile_t *displayPortProfile)
+{
+    memset(displayPortProfile, 0, sizeof(displayPortProfile_t));
+
+    displayPortProfile->refreshHz = 0;
+    displayPortProfile->alertRefreshHz = 0;
+    displayPortProfile->maxBytesPerSecond = 8000;
+}
 
 #endif
 
 #if defined(USE_MAX7456)
 
-PG_REGISTER_WITH_RESET_FN(displayPortProfile_t, displayPortProfileMax7456, PG_DISPLAY_PORT_MAX7456_CONFIG, 0);
+PG_REGISTER_WITH_RESET_FN(displayPortProfile_t, displayPortProfileMax7456, PG_DISPLAY_PORT_MAX7456_CONFIG, 1);
 
 void pgResetFn_displayPortProfileMax7456(displayPortProfile_t *displayPortProfile)
 {
@@ -33,6 +33,11 @@ typedef struct displayPortProfile_s {
     // For attribute-rich OSDs
 
     uint8_t attrValues[4];     // NORMAL, INFORMATIONAL, WARNING, CRITICAL
+
+    // For displays updated over a serial link, 0 means no limit
+    uint8_t refreshHz;         // Refresh rate of normal and informational cells
+    uint8_t alertRefreshHz;    // Refresh rate of warning and critical cells
+    uint16_t maxBytesPerSecond; // Cap on the bytes sent to the display
 #ifdef USE_DISPLAYPORT_MSP_VENDOR_SPECIFIC
     uint8_t vendorInitLength;  // Actual length of vendorInit byte string
     uint8_t vendorInit[253];   // Max 253 bytes of vendor specific initialization byte string
@@ -32,13 +32,14 @@
 
 #include "freq.h"
 
-PG_REGISTER_WITH_RESET_FN(freqConfig_t, freqConfig, PG_FREQ_CONFIG, 0);
+PG_REGISTER_WITH_RESET_FN(freqConfig_t, freqConfig, PG_FREQ_CONFIG, 1);
 
 void pgResetFn_freqConfig(freqConfig_t *freqConfig)
 {
     for (unsigned index = 0; index < FREQ_SENSOR_PORT_COUNT; index++) {
         freqConfig->ioTag[index] = timerioTagGetByUsage(TIM_USE_FREQ, index);
     }
+    freqConfig->captureEdges = 0;
 }
 
 #endif
@@ -27,6 +27,7 @@
 
 typedef struct freqConfig_s {
     ioTag_t ioTag[FREQ_SENSOR_PORT_COUNT];
+    uint8_t captureEdges;           // log2 of the signal periods per input capture, 0..3
 } freqConfig_t;
 
 PG_DECLARE(freqConfig_t, freqConfig);
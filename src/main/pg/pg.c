@@ -74,15 +74,20 @@ bool pgResetCopy(void *copy, pgn_t pgn)
 
 bool pgLoad(const pgRegistry_t* reg, const void *from, int size, int version)
 {
-    pgResetInstance(reg, pgOffset(reg));
     // restore only matching version, keep defaults otherwise
     if (version == pgVersion(reg)) {
         const int take = MIN(size, pgSize(reg));
+        // defaults are only needed for the part the record doesn't cover
+        if (take < pgSize(reg)) {
+            pgResetInstance(reg, pgOffset(reg));
+        }
         memcpy(pgOffset(reg), from, take);
 
         return true;
     }
 
+    pgResetInstance(reg, pgOffset(reg));
+
     return false;
 }
 
@@ -43,6 +43,11 @@ typedef enum {
 // function that resets a single parameter group instance
 typedef void (pgResetFunc)(void * /* base */);
 
+// RAM state of a parameter group, kept up to date by the config store
+typedef struct pgState_s {
+    const void *stored;    // latest stored record of the group, NULL when there is none
+} pgState_t;
+
 typedef struct pgRegistry_s {
     pgn_t pgn;             // The parameter group number, the top 4 bits are reserved for version
     uint8_t length;        // The number of elements in the group 
@@ -54,6 +59,7 @@ typedef struct pgRegistry_s {
         void *ptr;         // Pointer to init template
         pgResetFunc *fn;   // Popinter to pgResetFunc
     } reset;
+    pgState_t *state;      // Address of the group state in RAM.
 } pgRegistry_t;
 
 static inline uint16_t pgN(const pgRegistry_t* reg) {return reg->pgn & PGR_PGN_MASK;}
@@ -118,6 +124,7 @@ extern const uint8_t __pg_resetdata_end[];
 #define PG_REGISTER_I(_type, _name, _pgn, _version, _reset)             \
     _type _name ## _System;                                             \
     _type _name ## _Copy;                                               \
+    pgState_t _name ## _State;                                          \
     /* Force external linkage for g++. Catch multi registration */      \
     extern const pgRegistry_t _name ## _Registry;                       \
     const pgRegistry_t _name ##_Registry PG_REGISTER_ATTRIBUTES = {     \
@@ -128,6 +135,7 @@ extern const uint8_t __pg_resetdata_end[];
         .copy = (uint8_t*)&_name ## _Copy,                              \
         .ptr = 0,                                                       \
         _reset,                                                         \
+        .state = &_name ## _State,                                      \
     }                                                                   \
     /**/
 
@@ -149,6 +157,7 @@ extern const uint8_t __pg_resetdata_end[];
 #define PG_REGISTER_ARRAY_I(_type, _length, _name, _pgn, _version, _reset)  \
     _type _name ## _SystemArray[_length];                               \
     _type _name ## _CopyArray[_length];                                 \
+    pgState_t _name ## _State;                                          \
     extern const pgRegistry_t _name ##_Registry;                        \
     const pgRegistry_t _name ## _Registry PG_REGISTER_ATTRIBUTES = {    \
         .pgn = _pgn | (_version << 12),                                 \
@@ -158,6 +167,7 @@ extern const uint8_t __pg_resetdata_end[];
         .copy = (uint8_t*)&_name ## _CopyArray,                         \
         .ptr = 0,                                                       \
         _reset,                                                         \
+        .state = &_name ## _State,                                      \
     }                                                                   \
     /**/
 
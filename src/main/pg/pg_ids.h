@@ -150,7 +150,14 @@
 #define PG_PULLUP_CONFIG 551
 #define PG_PULLDOWN_CONFIG 552
 #define PG_FREQ_CONFIG 553
-#define PG_BETAFLIGHT_END 553
+#define PG_SWASH_CONFIG 554
+#define PG_TASK_CONFIG 555
+#define PG_RC_CURVE_CONFIG 556
+#define PG_SENSOR_HARDWARE_CACHE 557
+#define PG_GYRO_BIAS_TABLE 558
+#define PG_VIBRATION_CONFIG 559
+#define PG_SYSID_CONFIG 560
+#define PG_BETAFLIGHT_END 560
 
 
 // OSD configuration (subject to change)
@@ -0,0 +1,36 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include "pg/pg.h"
+
+// Sensors found on the last boot, probed first so a boot on unchanged
+// hardware does not walk every driver. Zero if nothing is cached.
+typedef struct sensorHardwareCache_s {
+    uint8_t gyroSpiDetect[MAX_GYRODEV_COUNT];   // 1 + index of the SPI detect function that answered
+    uint8_t baroHardware;                       // baroSensor_e
+    uint8_t magHardware;                        // magSensor_e
+} sensorHardwareCache_t;
+
+PG_DECLARE(sensorHardwareCache_t, sensorHardwareCache);
@@ -27,13 +27,28 @@
 
 #include "stats.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(statsConfig_t, statsConfig, PG_STATS_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(statsConfig_t, statsConfig, PG_STATS_CONFIG, 4);
 
 PG_RESET_TEMPLATE(statsConfig_t, statsConfig,
     .stats_enabled = 0,
     .stats_total_flights = 0,
     .stats_total_time_s = 0,
     .stats_total_dist_m = 0,
+    .stats_total_overruns = 0,
+    .stats_max_latency_us = 0,
+    .stats_max_pid_time_us = 0,
+    .stats_flight_max_pid_time_us = 0,
+    .stats_flight_p99_pid_time_us = 0,
+    .stats_flight_overruns = 0,
+    .stats_flight_bb_dropped = 0,
+    .stats_flight_max_droop_rpm = 0,
+    .stats_flight_gov_saturated_ms = 0,
+    .stats_flight_rpm_dropouts = 0,
+    .stats_flight_i2c_errors = 0,
+    .stats_flight_spi_errors = 0,
+    .stats_flight_vib_main_1x = 0,
+    .stats_flight_vib_main_2x = 0,
+    .stats_flight_vib_tail_1x = 0,
 );
 
 #endif
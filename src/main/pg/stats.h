@@ -27,7 +27,24 @@ typedef struct statsConfig_s {
     uint32_t stats_total_flights;
     uint32_t stats_total_time_s; // [s]
     uint32_t stats_total_dist_m; // [m]
+    uint32_t stats_total_overruns;  // gyro loop overruns
+    uint16_t stats_max_latency_us;  // worst gyro sample to motor write latency of a flight
+    uint16_t stats_max_pid_time_us; // worst PID loop iteration of a flight
     uint8_t  stats_enabled;
+
+    // Last recorded flight
+    uint16_t stats_flight_max_pid_time_us;
+    uint16_t stats_flight_p99_pid_time_us;
+    uint32_t stats_flight_overruns;
+    uint32_t stats_flight_bb_dropped;       // blackbox bytes the device could not take
+    uint16_t stats_flight_max_droop_rpm;    // headspeed below the governor setpoint
+    uint32_t stats_flight_gov_saturated_ms; // governor at full throttle and still below the setpoint
+    uint16_t stats_flight_rpm_dropouts;     // a motor lost all of its rpm sources
+    uint16_t stats_flight_i2c_errors;
+    uint16_t stats_flight_spi_errors;
+    uint16_t stats_flight_vib_main_1x;      // worst gyro vibration at the rotor harmonics, 0.1 deg/s
+    uint16_t stats_flight_vib_main_2x;
+    uint16_t stats_flight_vib_tail_1x;
 } statsConfig_t;
 
 PG_DECLARE(statsConfig_t, statsConfig);
@@ -44,6 +44,9 @@
 
 #include "cc2500_common.h"
 
+// GDO0 edges older than this belong to an earlier packet
+#define CC2500_PACKET_EXTI_MAX_AGE_US 2000
+
 #if defined(USE_RX_CC2500_SPI_PA_LNA)
 static IO_t txEnPin;
 static IO_t rxLnaEnPin;
@@ -100,6 +103,24 @@ void cc2500TxDisable(void)
 }
 #endif
 
+// Time the packet was received, taken from the GDO0 end of packet interrupt.
+// The poll time lags it by the scheduler jitter, which would otherwise end up in the hop timing.
+timeUs_t cc2500GetPacketTimeUs(timeUs_t currentTimeUs)
+{
+    timeUs_t packetTimeUs = currentTimeUs;
+
+    if (rxSpiPollExti()) {
+        const timeUs_t extiTimeUs = rxSpiGetLastExtiTimeUs();
+        const timeDelta_t extiAgeUs = cmpTimeUs(currentTimeUs, extiTimeUs);
+        if (extiAgeUs >= 0 && extiAgeUs < CC2500_PACKET_EXTI_MAX_AGE_US) {
+            packetTimeUs = extiTimeUs;
+        }
+        rxSpiResetExti();
+    }
+
+    return packetTimeUs;
+}
+
 static bool cc2500SpiDetect(void)
 {
     const uint8_t chipPartNum = cc2500ReadReg(CC2500_30_PARTNUM | CC2500_READ_BURST); //CC2500 read registers chip part num
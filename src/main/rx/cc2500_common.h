@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 #include "rx/rx_spi.h"
 
 uint16_t cc2500getRssiDbm(void);
@@ -32,3 +34,4 @@ void cc2500TxEnable(void);
 void cc2500TxDisable(void);
 #endif
 bool cc2500SpiInit(void);
+timeUs_t cc2500GetPacketTimeUs(timeUs_t currentTimeUs);
@@ -230,12 +230,13 @@ rx_spi_received_e frSkyDHandlePacket(uint8_t * const packet, uint8_t * const pro
                     if (packet[0] == 0x11) {
                         if ((packet[1] == rxCc2500SpiConfig()->bindTxId[0]) &&
                             (packet[2] == rxCc2500SpiConfig()->bindTxId[1])) {
+                            const timeUs_t packetTimeUs = cc2500GetPacketTimeUs(currentPacketReceivedTime);
                             rxSpiLedOn();
                             nextChannel(1);
                             cc2500setRssiDbm(packet[18]);
 #if defined(USE_RX_FRSKY_SPI_TELEMETRY)
                             if ((packet[3] % 4) == 2) {
-                                telemetryTimeUs = micros();
+                                telemetryTimeUs = packetTimeUs;
                                 buildTelemetryFrame(packet);
                                 *protocolState = STATE_TELEMETRY;
                             } else
@@ -245,7 +246,7 @@ rx_spi_received_e frSkyDHandlePacket(uint8_t * const packet, uint8_t * const pro
                                 *protocolState = STATE_UPDATE;
                             }
                             ret = RX_SPI_RECEIVED_DATA;
-                            lastPacketReceivedTime = currentPacketReceivedTime;
+                            lastPacketReceivedTime = packetTimeUs;
                         }
                     }
                 }
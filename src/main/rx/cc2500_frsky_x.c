@@ -444,7 +444,7 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
                          receiveTelemetryRetryCount = 0;
                      }
 
-                    packetTimerUs = micros();
+                    packetTimerUs = cc2500GetPacketTimeUs(micros());
                     frameReceived = true; // no need to process frame again.
                 }
                 if (!frameReceived) {
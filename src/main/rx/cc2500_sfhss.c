@@ -353,6 +353,7 @@ rx_spi_received_e sfhssSpiDataReceived(uint8_t *packet)
         case STATE_HUNT:
             if (sfhssRecv(packet)) {
                 if (sfhssPacketParse(packet, true)) {
+                    currentPacketReceivedTime = cc2500GetPacketTimeUs(currentPacketReceivedTime);
                     if (GET_COMMAND(packet) & 0x8) {       /* ch=5-8 */
                         missingPackets = 0;
                         rxSpiLedOn();
@@ -378,6 +379,7 @@ rx_spi_received_e sfhssSpiDataReceived(uint8_t *packet)
         case STATE_SYNC:
             if (sfhssRecv(packet)) {
                 if (sfhssPacketParse(packet, true)) {
+                    currentPacketReceivedTime = cc2500GetPacketTimeUs(currentPacketReceivedTime);
                     missingPackets = 0;
                     if ( GET_COMMAND(packet) & 0x8 ) {
                         nextFrameReceiveStartTime = currentPacketReceivedTime + NEXT_CH_TIME_SYNC2;
@@ -30,6 +30,7 @@
 #include "build/build_config.h"
 #include "build/debug.h"
 
+#include "common/bitarray.h"
 #include "common/crc.h"
 #include "common/maths.h"
 #include "common/utils.h"
@@ -51,6 +52,7 @@
 #define CRSF_TIME_NEEDED_PER_FRAME_US   1100 // 700 ms + 400 ms for potential ad-hoc request
 #define CRSF_TIME_BETWEEN_FRAMES_US     6667 // At fastest, frames are sent by the transmitter every 6.667 milliseconds, 150 Hz
 
+#define CRSF_CHANNEL_BITS 11
 #define CRSF_DIGITAL_CHANNEL_MIN 172
 #define CRSF_DIGITAL_CHANNEL_MAX 1811
 
@@ -58,17 +60,26 @@
 
 #define CRSF_LINK_STATUS_UPDATE_TIMEOUT_US  250000 // 250ms, 4 Hz mode 1 telemetry
 
+#define CRSF_BYTE_GAP_TIMEOUT_US        250 // a pause this long between two bytes starts a new frame, high rate links leave less than CRSF_TIME_NEEDED_PER_FRAME_US between frames
+#define CRSF_FRAME_INTERVAL_MIN_US      500   // 2 kHz
+#define CRSF_FRAME_INTERVAL_MAX_US      50000 // 20 Hz
+#define CRSF_TELEMETRY_GUARD_US         100 // telemetry has to be on the wire this long before the next RC frame is due
+#define CRSF_TIME_PER_BYTES_US(bytes)   ((bytes) * 10 * 1000000 / CRSF_BAUDRATE) // 8N1
+
 STATIC_UNIT_TESTED bool crsfFrameDone = false;
 STATIC_UNIT_TESTED crsfFrame_t crsfFrame;
 STATIC_UNIT_TESTED crsfFrame_t crsfChannelDataFrame;
-STATIC_UNIT_TESTED uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
+STATIC_UNIT_TESTED uint16_t crsfChannelData[CRSF_MAX_CHANNEL];
 
 static serialPort_t *serialPort;
 static timeUs_t crsfFrameStartAtUs = 0;
+static timeUs_t crsfLastByteAtUs = 0;
 static uint8_t telemetryBuf[CRSF_FRAME_SIZE_MAX];
 static uint8_t telemetryBufLen = 0;
 
 static timeUs_t lastRcFrameTimeUs = 0;
+static timeUs_t lastRcFrameEndUs = 0;
+static timeDelta_t crsfFrameIntervalUs = 0; // measured RC frame interval, 0 until frames are received
 
 /*
  * CRSF protocol
@@ -119,6 +130,8 @@ struct crsfPayloadRcChannelsPacked_s {
 
 typedef struct crsfPayloadRcChannelsPacked_s crsfPayloadRcChannelsPacked_t;
 
+STATIC_ASSERT(sizeof(crsfPayloadRcChannelsPacked_t) == (CRSF_MAX_CHANNEL * CRSF_CHANNEL_BITS) / 8, crsf_rc_channels_packed_size);
+
 #if defined(USE_CRSF_LINK_STATISTICS)
 /*
  * 0x14 Link statistics
@@ -220,11 +233,9 @@ static void crsfCheckRssi(uint32_t currentTimeUs) {
 STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
 {
     // CRC includes type and payload
-    uint8_t crc = crc8_dvb_s2(0, crsfFrame.frame.type);
-    for (int ii = 0; ii < crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_TYPE_CRC; ++ii) {
-        crc = crc8_dvb_s2(crc, crsfFrame.frame.payload[ii]);
-    }
-    return crc;
+    const uint8_t crc = crc8_dvb_s2(0, crsfFrame.frame.type);
+    const int payloadLength = crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_TYPE_CRC;
+    return payloadLength > 0 ? crc8_dvb_s2_update(crc, crsfFrame.frame.payload, payloadLength) : crc;
 }
 
 // Receive ISR callback, called back from serial port
@@ -239,11 +250,13 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     debug[2] = currentTimeUs - crsfFrameStartAtUs;
 #endif
 
-    if (cmpTimeUs(currentTimeUs, crsfFrameStartAtUs) > CRSF_TIME_NEEDED_PER_FRAME_US) {
+    if (cmpTimeUs(currentTimeUs, crsfFrameStartAtUs) > CRSF_TIME_NEEDED_PER_FRAME_US
+        || cmpTimeUs(currentTimeUs, crsfLastByteAtUs) > CRSF_BYTE_GAP_TIMEOUT_US) {
         // We've received a character after max time needed to complete a frame,
-        // so this must be the start of a new frame.
+        // or after a pause within the frame, so this must be the start of a new frame.
         crsfFramePosition = 0;
     }
+    crsfLastByteAtUs = currentTimeUs;
 
     if (crsfFramePosition == 0) {
         crsfFrameStartAtUs = currentTimeUs;
@@ -262,6 +275,11 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
                 {
                     case CRSF_FRAMETYPE_RC_CHANNELS_PACKED:
                         if (crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) {
+                            const timeDelta_t frameDeltaUs = cmpTimeUs(currentTimeUs, lastRcFrameEndUs);
+                            if (frameDeltaUs >= CRSF_FRAME_INTERVAL_MIN_US && frameDeltaUs <= CRSF_FRAME_INTERVAL_MAX_US) {
+                                crsfFrameIntervalUs = crsfFrameIntervalUs ? crsfFrameIntervalUs + (frameDeltaUs - crsfFrameIntervalUs) / 8 : frameDeltaUs;
+                            }
+                            lastRcFrameEndUs = currentTimeUs;
                             lastRcFrameTimeUs = currentTimeUs;
                             crsfFrameDone = true;
                             memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
@@ -271,8 +289,10 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
 #if defined(USE_TELEMETRY_CRSF) && defined(USE_MSP_OVER_TELEMETRY)
                     case CRSF_FRAMETYPE_MSP_REQ:
                     case CRSF_FRAMETYPE_MSP_WRITE: {
+                        // radios limited to 8 byte chunks pad them, newer links send up to the full extended frame
                         uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                        if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
+                        const int mspFrameLength = MIN(crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_EXT_TYPE_CRC, CRSF_FRAME_TX_MSP_FRAME_SIZE);
+                        if (mspFrameLength > 0 && bufferCrsfMspFrame(frameStart, mspFrameLength)) {
                             crsfScheduleMspResponse();
                         }
                         break;
@@ -311,32 +331,23 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
 
 STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeState_t *rxRuntimeState)
 {
-    UNUSED(rxRuntimeState);
-
 #if defined(USE_CRSF_LINK_STATISTICS)
     crsfCheckRssi(micros());
 #endif
     if (crsfFrameDone) {
         crsfFrameDone = false;
 
-        // unpack the RC channels
-        const crsfPayloadRcChannelsPacked_t* const rcChannels = (crsfPayloadRcChannelsPacked_t*)&crsfChannelDataFrame.frame.payload;
-        crsfChannelData[0] = rcChannels->chan0;
-        crsfChannelData[1] = rcChannels->chan1;
-        crsfChannelData[2] = rcChannels->chan2;
-        crsfChannelData[3] = rcChannels->chan3;
-        crsfChannelData[4] = rcChannels->chan4;
-        crsfChannelData[5] = rcChannels->chan5;
-        crsfChannelData[6] = rcChannels->chan6;
-        crsfChannelData[7] = rcChannels->chan7;
-        crsfChannelData[8] = rcChannels->chan8;
-        crsfChannelData[9] = rcChannels->chan9;
-        crsfChannelData[10] = rcChannels->chan10;
-        crsfChannelData[11] = rcChannels->chan11;
-        crsfChannelData[12] = rcChannels->chan12;
-        crsfChannelData[13] = rcChannels->chan13;
-        crsfChannelData[14] = rcChannels->chan14;
-        crsfChannelData[15] = rcChannels->chan15;
+        // unpack all the RC channels once per frame
+        bitArrayUnpack(crsfChannelData, &crsfChannelDataFrame.frame.payload, CRSF_MAX_CHANNEL, CRSF_CHANNEL_BITS);
+
+        // follow the link rate, ELRS and CRSF run anywhere between 50 Hz and 1 kHz
+        if (crsfFrameIntervalUs) {
+            rxRuntimeState->rxRefreshRate = crsfFrameIntervalUs;
+        }
+
+        // the telemetry window has just opened
+        crsfRxSendTelemetryData();
+
         return RX_FRAME_COMPLETE;
     }
     return RX_FRAME_PENDING;
@@ -356,17 +367,40 @@ STATIC_UNIT_TESTED uint16_t crsfReadRawRC(const rxRuntimeState_t *rxRuntimeState
     return (0.62477120195241f * crsfChannelData[chan]) + 881;
 }
 
-void crsfRxWriteTelemetryData(const void *data, int len)
+// Telemetry frames are built in place here, and sent once committed
+uint8_t *crsfRxTelemetryBuffer(void)
+{
+    return telemetryBuf;
+}
+
+void crsfRxCommitTelemetryData(int len)
+{
+    telemetryBufLen = MIN(len, (int)sizeof(telemetryBuf));
+}
+
+bool crsfRxTelemetryPending(void)
 {
-    len = MIN(len, (int)sizeof(telemetryBuf));
-    memcpy(telemetryBuf, data, len);
-    telemetryBufLen = len;
+    return telemetryBufLen > 0;
+}
+
+// The receiver expects telemetry between two RC frames, a frame that
+// would still be on the wire when the next RC frame is due waits for
+// the next window
+static bool crsfTelemetryWindowOpen(timeUs_t currentTimeUs)
+{
+    const timeDelta_t sinceRcFrameUs = cmpTimeUs(currentTimeUs, lastRcFrameEndUs);
+    if (!crsfFrameIntervalUs || sinceRcFrameUs > 2 * crsfFrameIntervalUs) {
+        // no RC frames to fit between
+        return true;
+    }
+
+    return sinceRcFrameUs + CRSF_TIME_PER_BYTES_US(telemetryBufLen) + CRSF_TELEMETRY_GUARD_US <= crsfFrameIntervalUs;
 }
 
 void crsfRxSendTelemetryData(void)
 {
     // if there is telemetry data to write
-    if (telemetryBufLen > 0) {
+    if (telemetryBufLen > 0 && crsfTelemetryWindowOpen(micros())) {
         serialWriteBuf(serialPort, telemetryBuf, telemetryBufLen);
         telemetryBufLen = 0; // reset telemetry buffer
     }
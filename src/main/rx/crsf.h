@@ -40,7 +40,9 @@ typedef union crsfFrame_u {
     crsfFrameDef_t frame;
 } crsfFrame_t;
 
-void crsfRxWriteTelemetryData(const void *data, int len);
+uint8_t *crsfRxTelemetryBuffer(void);
+void crsfRxCommitTelemetryData(int len);
+bool crsfRxTelemetryPending(void);
 void crsfRxSendTelemetryData(void);
 
 struct rxConfig_s;
@@ -120,6 +120,7 @@ static const smartPortPayload_t emptySmartPortFrame = { .frameId = 0, .valueId =
 
 #define FPORT_REQUEST_FRAME_LENGTH sizeof(fportFrame_t)
 #define FPORT_RESPONSE_FRAME_LENGTH (sizeof(uint8_t) + sizeof(smartPortPayload_t))
+#define FPORT_TELEMETRY_RESPONSE_BYTES (FPORT_RESPONSE_FRAME_LENGTH + 2) // with the length and checksum bytes
 
 #define FPORT_FRAME_PAYLOAD_LENGTH_CONTROL (sizeof(uint8_t) + sizeof(fportControlData_t))
 #define FPORT_FRAME_PAYLOAD_LENGTH_TELEMETRY_REQUEST (sizeof(uint8_t) + sizeof(smartPortPayload_t))
@@ -130,6 +131,7 @@ static const smartPortPayload_t emptySmartPortFrame = { .frameId = 0, .valueId =
 typedef struct fportBuffer_s {
     uint8_t data[BUFFER_SIZE];
     uint8_t length;
+    timeUs_t frameTimeUs;   // arrival of the end of frame marker
 } fportBuffer_t;
 
 static fportBuffer_t rxBuffer[NUM_RX_BUFFERS];
@@ -144,6 +146,7 @@ static volatile uint8_t framePosition = 0;
 
 static smartPortPayload_t *mspPayload = NULL;
 static timeUs_t lastRcFrameReceivedMs = 0;
+static timeUs_t lastRcFrameTimeUs = 0;
 
 static serialPort_t *fportPort;
 #ifdef USE_TELEMETRY_SMARTPORT
@@ -186,6 +189,7 @@ static void fportDataReceive(uint16_t c, void *data)
             const uint8_t nextWriteIndex = (rxBufferWriteIndex + 1) % NUM_RX_BUFFERS;
             if (nextWriteIndex != rxBufferReadIndex) {
                 rxBuffer[rxBufferWriteIndex].length = framePosition - 1;
+                rxBuffer[rxBufferWriteIndex].frameTimeUs = currentTimeUs;
                 rxBufferWriteIndex = nextWriteIndex;
             }
 
@@ -282,6 +286,7 @@ static uint8_t fportFrameStatus(rxRuntimeState_t *rxRuntimeState)
                         reportFrameError(DEBUG_FPORT_ERROR_TYPE_SIZE);
                     } else {
                         result = sbusChannelsDecode(rxRuntimeState, &frame->data.controlData.channels);
+                        lastRcFrameTimeUs = (result == RX_FRAME_COMPLETE) ? rxBuffer[rxBufferReadIndex].frameTimeUs : 0;
 
                         setRssi(scaleRange(frame->data.controlData.rssi, 0, 100, 0, RSSI_MAX_VALUE), RSSI_SOURCE_RX_PROTOCOL);
 
@@ -371,6 +376,11 @@ static bool fportProcessFrame(const rxRuntimeState_t *rxRuntimeState)
        clearToSend = false;
     }
 
+    // sensor replies share the wire with the RC frames, MSP replies are always sent
+    if (clearToSend && !mspPayload && !telemetryBudgetConsume(FPORT_TELEMETRY_RESPONSE_BYTES)) {
+        clearToSend = false;
+    }
+
     if (clearToSend) {
         processSmartPortTelemetry(mspPayload, &clearToSend, NULL);
 
@@ -390,6 +400,13 @@ static bool fportProcessFrame(const rxRuntimeState_t *rxRuntimeState)
     return true;
 }
 
+static timeUs_t fportFrameTimeUs(void)
+{
+    const timeUs_t result = lastRcFrameTimeUs;
+    lastRcFrameTimeUs = 0;
+    return result;
+}
+
 bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 {
     static uint16_t sbusChannelData[SBUS_MAX_CHANNEL];
@@ -401,6 +418,7 @@ bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcFrameStatusFn = fportFrameStatus;
     rxRuntimeState->rcProcessFrameFn = fportProcessFrame;
+    rxRuntimeState->rcFrameTimeUsFn = fportFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
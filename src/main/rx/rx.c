@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include <string.h>
 
@@ -92,6 +93,8 @@ linkQualitySource_e linkQualitySource;
 
 static bool rxDataProcessingRequired = false;
 static bool auxiliaryProcessingRequired = false;
+static bool rxInlineDecode = false;        // frames are decoded at the start of the PID loop
+static bool rxDecodedFramePending = false; // decoded by the PID loop, not yet seen by processRx()
 
 static bool rxSignalReceived = false;
 static bool rxFlightChannelsValid = false;
@@ -102,6 +105,8 @@ static timeUs_t rxNextUpdateAtUs = 0;
 static uint32_t needRxSignalBefore = 0;
 static uint32_t needRxSignalMaxDelayUs;
 static uint32_t suspendRxSignalUntil = 0;
+static bool rxSignalHoldPending = false;
+static timeUs_t rxSignalHoldUntilUs = 0;
 static uint8_t  skipRxSamples = 0;
 
 static int16_t rcRaw[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
@@ -455,6 +460,7 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
         break;
 #if defined(USE_PWM) || defined(USE_PPM)
     case RX_PROVIDER_PPM:
+        ppmRxProcess();
         if (isPPMDataBeingReceived()) {
             signalReceived = true;
             rxIsInFailsafeMode = false;
@@ -507,7 +513,7 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
         rxDataProcessingRequired = true;
     }
 
-    return rxDataProcessingRequired || auxiliaryProcessingRequired; // data driven or 50Hz
+    return rxDataProcessingRequired || auxiliaryProcessingRequired || rxDecodedFramePending; // data driven or 50Hz
 }
 
 #if defined(USE_PWM) || defined(USE_PPM)
@@ -575,6 +581,11 @@ STATIC_UNIT_TESTED uint16_t applyRxChannelRangeConfiguraton(int sample, const rx
         return PPM_RCVR_TIMEOUT;
     }
 
+    // the default range is an identity mapping, skip the division
+    if (range->min == PWM_RANGE_MIN && range->max == PWM_RANGE_MAX) {
+        return constrain(sample, PWM_PULSE_MIN, PWM_PULSE_MAX);
+    }
+
     sample = scaleRange(sample, range->min, range->max, PWM_RANGE_MIN, PWM_RANGE_MAX);
     sample = constrain(sample, PWM_PULSE_MIN, PWM_PULSE_MAX);
 
@@ -602,7 +613,7 @@ static void readRxChannelsApplyRanges(void)
     }
 }
 
-static void detectAndApplySignalLossBehaviour(void)
+static void detectAndApplySignalLossBehaviour(timeUs_t currentTimeUs)
 {
     const uint32_t currentTimeMs = millis();
 
@@ -611,6 +622,12 @@ static void detectAndApplySignalLossBehaviour(void)
     DEBUG_SET(DEBUG_RX_SIGNAL_LOSS, 0, rxSignalReceived);
     DEBUG_SET(DEBUG_RX_SIGNAL_LOSS, 1, rxIsInFailsafeMode);
 
+    if (useValueFromRx) {
+        // one extra millisecond covers the rounding of the millis() based hold below
+        rxSignalHoldUntilUs = currentTimeUs + (MAX_INVALID_PULS_TIME + 1) * 1000;
+        rxSignalHoldPending = true;
+    }
+
     rxFlightChannelsValid = true;
     for (int channel = 0; channel < rxChannelCount; channel++) {
         uint16_t sample = rcRaw[channel];
@@ -652,12 +669,8 @@ static void detectAndApplySignalLossBehaviour(void)
     DEBUG_SET(DEBUG_RX_SIGNAL_LOSS, 3, rcData[THROTTLE]);
 }
 
-bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
+static bool decodeRxFrame(timeUs_t currentTimeUs)
 {
-    if (auxiliaryProcessingRequired) {
-        auxiliaryProcessingRequired = !rxRuntimeState.rcProcessFrameFn(&rxRuntimeState);
-    }
-
     if (!rxDataProcessingRequired) {
         return false;
     }
@@ -675,13 +688,66 @@ bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
     }
 
     readRxChannelsApplyRanges();
-    detectAndApplySignalLossBehaviour();
+    detectAndApplySignalLossBehaviour(currentTimeUs);
 
     rcSampleIndex++;
 
     return true;
 }
 
+bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
+{
+    if (auxiliaryProcessingRequired) {
+        auxiliaryProcessingRequired = !rxRuntimeState.rcProcessFrameFn(&rxRuntimeState);
+    }
+
+    if (rxInlineDecode) {
+        // the PID loop has already decoded the frame, report it once
+        const bool framePending = rxDecodedFramePending;
+        rxDecodedFramePending = false;
+        return framePending;
+    }
+
+    return decodeRxFrame(currentTimeUs);
+}
+
+void rxSetInlineDecode(bool enabled)
+{
+    rxInlineDecode = enabled;
+}
+
+bool rxInlineDecodeEnabled(void)
+{
+    return rxInlineDecode;
+}
+
+// Called at the start of a PID cycle, decodes a completed frame before the setpoint is calculated
+bool rxDecodeInlineFrame(timeUs_t currentTimeUs)
+{
+    if (decodeRxFrame(currentTimeUs)) {
+        rxDecodedFramePending = true;
+        return true;
+    }
+
+    return false;
+}
+
+// Called at PID rate, only checks the age of the last valid frame. When the frames stop
+// the signal loss behaviour is applied on the next RX update instead of waiting for the
+// 33Hz fallback, and again as soon as the channel hold period is over.
+void rxSignalWatchdog(timeUs_t currentTimeUs)
+{
+    if (rxSignalReceived) {
+        if (cmpTimeUs(currentTimeUs, needRxSignalBefore) >= 0) {
+            rxSignalReceived = false;
+            rxDataProcessingRequired = true;
+        }
+    } else if (rxSignalHoldPending && cmpTimeUs(currentTimeUs, rxSignalHoldUntilUs) >= 0) {
+        rxSignalHoldPending = false;
+        rxDataProcessingRequired = true;
+    }
+}
+
 void parseRcChannels(const char *input, rxConfig_t *rxConfig)
 {
     // map each letter in AETR1234, TAER1234, etc to the proper internal input order
@@ -870,14 +936,52 @@ bool isRssiConfigured(void)
     return rssiSource != RSSI_SOURCE_NONE;
 }
 
+#define RX_FRAME_TIMING_GAIN 0.05f      // frame interval and jitter averaging, about 20 frames
+
+// Arrival time and interval statistics of the RC frames, used to predict the setpoint between frames
+static timeUs_t rxFrameTimeUs;
+static timeUs_t rxProtocolFrameTimeUs;  // arrival timestamp taken by the protocol, 0 if it has none
+static float rxFrameIntervalUs;
+static float rxFrameJitterUs;
+
+void rxFrameTimingUpdate(timeUs_t currentTimeUs, timeDelta_t frameDeltaUs)
+{
+    // prefer the protocol's own arrival timestamp over the time the frame was processed
+    rxFrameTimeUs = rxProtocolFrameTimeUs ? rxProtocolFrameTimeUs : currentTimeUs;
+
+    if (rxFrameIntervalUs == 0.0f) {
+        rxFrameIntervalUs = frameDeltaUs;
+    }
+    rxFrameJitterUs += RX_FRAME_TIMING_GAIN * (fabsf(frameDeltaUs - rxFrameIntervalUs) - rxFrameJitterUs);
+    rxFrameIntervalUs += RX_FRAME_TIMING_GAIN * (frameDeltaUs - rxFrameIntervalUs);
+}
+
+timeUs_t rxGetFrameTimeUs(void)
+{
+    return rxFrameTimeUs;
+}
+
+float rxGetFrameIntervalUs(void)
+{
+    return rxFrameIntervalUs;
+}
+
+float rxGetFrameJitterUs(void)
+{
+    return rxFrameJitterUs;
+}
+
 bool rxGetFrameDelta(timeDelta_t *deltaUs)
 {
     static timeUs_t previousFrameTimeUs = 0;
     bool result = false;
 
     *deltaUs = 0;
+    rxProtocolFrameTimeUs = 0;
     if (rxRuntimeState.rcFrameTimeUsFn) {
+        // the protocol hands its timestamp out once, keep it for rxFrameTimingUpdate()
         const timeUs_t frameTimeUs = rxRuntimeState.rcFrameTimeUsFn();
+        rxProtocolFrameTimeUs = frameTimeUs;
         if (frameTimeUs) {
             if (previousFrameTimeUs) {
                 *deltaUs = cmpTimeUs(frameTimeUs, previousFrameTimeUs);
@@ -178,6 +178,10 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 bool rxIsReceivingSignal(void);
 bool rxAreFlightChannelsValid(void);
 bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs);
+void rxSetInlineDecode(bool enabled);
+bool rxInlineDecodeEnabled(void);
+bool rxDecodeInlineFrame(timeUs_t currentTimeUs);
+void rxSignalWatchdog(timeUs_t currentTimeUs);
 
 struct rxConfig_s;
 
@@ -211,3 +215,7 @@ void resumeRxPwmPpmSignal(void);
 uint16_t rxGetRefreshRate(void);
 
 bool rxGetFrameDelta(timeDelta_t *deltaUs);
+void rxFrameTimingUpdate(timeUs_t currentTimeUs, timeDelta_t frameDeltaUs);
+timeUs_t rxGetFrameTimeUs(void);
+float rxGetFrameIntervalUs(void);
+float rxGetFrameJitterUs(void);
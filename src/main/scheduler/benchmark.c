@@ -0,0 +1,183 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_BENCHMARK
+
+#include "blackbox/blackbox.h"
+
+#include "build/atomic.h"
+
+#include "common/maths.h"
+
+#include "config/config.h"
+
+#include "drivers/nvic.h"
+#include "drivers/system.h"
+#include "drivers/time.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+#include "flight/rpm_filter.h"
+#include "flight/servos.h"
+
+#include "sensors/gyro.h"
+
+#include "scheduler/benchmark.h"
+
+typedef struct benchmarkKernel_s {
+    const char *name;
+    bool (*prepareFn)(void);        // optional, false if the kernel can't run now
+    void (*runFn)(void);
+} benchmarkKernel_t;
+
+// Raw samples, saturated. Only the median needs them, min and max are kept exactly.
+static uint16_t benchmarkSamples[BENCHMARK_ITERATIONS_MAX];
+
+static void benchmarkNone(void)
+{
+}
+
+static void benchmarkGyroFilter(void)
+{
+    gyroFilterBenchmark();
+}
+
+#ifdef USE_RPM_FILTER
+static void benchmarkRpmFilter(void)
+{
+    float values[XYZ_AXIS_COUNT] = { gyro.gyroADCf[X], gyro.gyroADCf[Y], gyro.gyroADCf[Z] };
+
+    rpmFilterGyro(values);
+}
+#endif
+
+static void benchmarkPidController(void)
+{
+    pidController(currentPidProfile, micros());
+}
+
+static void benchmarkMixer(void)
+{
+    mixTable(micros(), currentPidProfile->vbatPidCompensation);
+}
+
+// Kernels left out of the build keep their name, with no runFn
+static const benchmarkKernel_t benchmarkKernels[BENCHMARK_COUNT] = {
+    [BENCHMARK_GYRO_FILTER]         = { "GYRO_FILTER", NULL, benchmarkGyroFilter },
+#ifdef USE_RPM_FILTER
+    [BENCHMARK_RPM_FILTER]          = { "RPM_FILTER", NULL, benchmarkRpmFilter },
+    [BENCHMARK_RPM_FILTER_UPDATE]   = { "RPM_FILTER_UPDATE", NULL, rpmFilterUpdate },
+#else
+    [BENCHMARK_RPM_FILTER]          = { "RPM_FILTER", NULL, NULL },
+    [BENCHMARK_RPM_FILTER_UPDATE]   = { "RPM_FILTER_UPDATE", NULL, NULL },
+#endif
+    [BENCHMARK_PID_CONTROLLER]      = { "PID_CONTROLLER", NULL, benchmarkPidController },
+    [BENCHMARK_MIXER]               = { "MIXER", NULL, benchmarkMixer },
+#ifdef USE_SERVOS
+    [BENCHMARK_SERVO_MIXER]         = { "SERVO_MIXER", NULL, servoMixer },
+#else
+    [BENCHMARK_SERVO_MIXER]         = { "SERVO_MIXER", NULL, NULL },
+#endif
+#ifdef USE_BLACKBOX
+    [BENCHMARK_BLACKBOX_ENCODE]     = { "BLACKBOX_ENCODE", blackboxBenchmarkPrepare, blackboxBenchmarkFrame },
+#else
+    [BENCHMARK_BLACKBOX_ENCODE]     = { "BLACKBOX_ENCODE", NULL, NULL },
+#endif
+};
+
+// Cycles of one call with every interrupt held off, the loop can't be preempted by the gyro interrupt
+// PID loop either, which shares the state of the kernels.
+static uint32_t benchmarkMeasure(void (*runFn)(void))
+{
+    uint32_t cycles = 0;
+
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        const uint32_t start = getCycleCounter();
+        runFn();
+        cycles = getCycleCounter() - start;
+    }
+
+    return cycles;
+}
+
+static uint32_t benchmarkMedian(uint16_t *samples, int count)
+{
+    for (int i = 1; i < count; i++) {
+        const uint16_t sample = samples[i];
+        int j = i;
+        while (j > 0 && samples[j - 1] > sample) {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = sample;
+    }
+
+    return samples[count / 2];
+}
+
+// Runs one kernel 'iterations' times on the current state and config. Disarmed only, the kernels
+// change the flight state: the outputs are not written, the next PID loop recomputes them.
+bool benchmarkRun(benchmarkId_e id, uint16_t iterations, benchmarkResult_t *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    const benchmarkKernel_t *kernel = &benchmarkKernels[id];
+    if (ARMING_FLAG(ARMED) || !kernel->runFn || (kernel->prepareFn && !kernel->prepareFn())) {
+        return false;
+    }
+
+    iterations = constrain(iterations, 1, BENCHMARK_ITERATIONS_MAX);
+
+    // the cost of the measurement itself, the fastest of a few runs
+    uint32_t overhead = UINT32_MAX;
+    for (int i = 0; i < 8; i++) {
+        overhead = MIN(overhead, benchmarkMeasure(benchmarkNone));
+    }
+
+    result->minCycles = UINT32_MAX;
+    for (int i = 0; i < iterations; i++) {
+        const uint32_t measured = benchmarkMeasure(kernel->runFn);
+        const uint32_t cycles = measured > overhead ? measured - overhead : 0;
+
+        result->minCycles = MIN(result->minCycles, cycles);
+        result->maxCycles = MAX(result->maxCycles, cycles);
+        benchmarkSamples[i] = MIN(cycles, UINT16_MAX);
+    }
+
+    result->medianCycles = benchmarkMedian(benchmarkSamples, iterations);
+    result->iterations = iterations;
+
+    return true;
+}
+
+const char *benchmarkGetName(benchmarkId_e id)
+{
+    return benchmarkKernels[id].name;
+}
+
+#endif // USE_BENCHMARK
@@ -0,0 +1,48 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BENCHMARK_ITERATIONS_DEFAULT    256
+#define BENCHMARK_ITERATIONS_MAX        512
+
+typedef enum {
+    BENCHMARK_GYRO_FILTER = 0,
+    BENCHMARK_RPM_FILTER,
+    BENCHMARK_RPM_FILTER_UPDATE,
+    BENCHMARK_PID_CONTROLLER,
+    BENCHMARK_MIXER,
+    BENCHMARK_SERVO_MIXER,
+    BENCHMARK_BLACKBOX_ENCODE,
+    BENCHMARK_COUNT
+} benchmarkId_e;
+
+typedef struct benchmarkResult_s {
+    uint16_t iterations;            // zero if the kernel is not in this build or can't run now
+    uint32_t minCycles;
+    uint32_t medianCycles;
+    uint32_t maxCycles;
+} benchmarkResult_t;
+
+bool benchmarkRun(benchmarkId_e id, uint16_t iterations, benchmarkResult_t *result);
+const char *benchmarkGetName(benchmarkId_e id);
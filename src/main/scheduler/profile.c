@@ -0,0 +1,109 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_TASK_PROFILE
+
+#include "common/maths.h"
+
+#include "drivers/system.h"
+
+#include "scheduler/profile.h"
+
+// Bucket b counts the samples of less than 2^b cycles and at least 2^(b-1). The counts are
+// halved together when one of them saturates, which keeps the shape of the distribution.
+typedef struct profileHistogram_s {
+    uint16_t bucket[PROFILE_BUCKET_COUNT];
+    uint32_t count;
+    uint32_t maxCycles;
+} profileHistogram_t;
+
+static FAST_RAM_ZERO_INIT profileHistogram_t profileHistograms[PROFILE_COUNT];
+
+static const char * const profileSubTaskNames[PROFILE_COUNT - TASK_COUNT] = {
+    [PROFILE_GYRO_UPDATE - TASK_COUNT] = "GYRO_UPDATE",
+    [PROFILE_FILTER_GYRO - TASK_COUNT] = "FILTER_GYRO",
+    [PROFILE_RC_COMMAND - TASK_COUNT] = "RC_COMMAND",
+    [PROFILE_PID_CONTROLLER - TASK_COUNT] = "PID_CONTROLLER",
+    [PROFILE_MOTOR_UPDATE - TASK_COUNT] = "MOTOR_UPDATE",
+};
+
+FAST_CODE void profileRecord(profileId_e id, uint32_t cycles)
+{
+    profileHistogram_t *histogram = &profileHistograms[id];
+    const int bucket = cycles ? MIN(32 - __builtin_clz(cycles), PROFILE_BUCKET_COUNT - 1) : 0;
+
+    if (++histogram->bucket[bucket] == UINT16_MAX) {
+        histogram->count = 0;
+        for (int i = 0; i < PROFILE_BUCKET_COUNT; i++) {
+            histogram->bucket[i] /= 2;
+            histogram->count += histogram->bucket[i];
+        }
+    } else {
+        histogram->count++;
+    }
+    histogram->maxCycles = MAX(histogram->maxCycles, cycles);
+}
+
+static uint32_t profilePercentile(const profileHistogram_t *histogram, unsigned percent)
+{
+    const uint32_t target = (histogram->count * percent + 99) / 100;
+    uint32_t sum = 0;
+    for (int i = 0; i < PROFILE_BUCKET_COUNT; i++) {
+        sum += histogram->bucket[i];
+        if (sum >= target) {
+            return MIN((1U << i) - 1, histogram->maxCycles);
+        }
+    }
+    return histogram->maxCycles;
+}
+
+void profileGetInfo(profileId_e id, profileInfo_t *info)
+{
+    const profileHistogram_t *histogram = &profileHistograms[id];
+
+    info->count = histogram->count;
+    info->maxCycles = histogram->maxCycles;
+    if (histogram->count) {
+        info->p50Cycles = profilePercentile(histogram, 50);
+        info->p99Cycles = profilePercentile(histogram, 99);
+    } else {
+        info->p50Cycles = 0;
+        info->p99Cycles = 0;
+    }
+}
+
+void profileReset(profileId_e id)
+{
+    memset(&profileHistograms[id], 0, sizeof(profileHistogram_t));
+}
+
+// Names of the sub-steps, the tasks use their task names
+const char *profileGetSubTaskName(profileId_e id)
+{
+    return id >= TASK_COUNT ? profileSubTaskNames[id - TASK_COUNT] : NULL;
+}
+
+#endif // USE_TASK_PROFILE
@@ -0,0 +1,57 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "drivers/system.h"
+
+#include "scheduler/scheduler.h"
+
+#define PROFILE_BUCKET_COUNT 32     // log2 buckets of the cycle count
+
+// The tasks are profiled under their own cfTaskId_e, the PID loop sub-steps follow them
+typedef enum {
+    PROFILE_GYRO_UPDATE = TASK_COUNT,
+    PROFILE_FILTER_GYRO,
+    PROFILE_RC_COMMAND,
+    PROFILE_PID_CONTROLLER,
+    PROFILE_MOTOR_UPDATE,
+    PROFILE_COUNT
+} profileId_e;
+
+typedef struct profileInfo_s {
+    uint32_t count;                 // samples in the histogram
+    uint32_t p50Cycles;             // upper edge of the median bucket
+    uint32_t p99Cycles;             // upper edge of the 99th percentile bucket
+    uint32_t maxCycles;
+} profileInfo_t;
+
+#ifdef USE_TASK_PROFILE
+#define PROFILE_BEGIN(id) const uint32_t profileStartCycles_##id = getCycleCounter()
+#define PROFILE_END(id) profileRecord(id, getCycleCounter() - profileStartCycles_##id)
+#else
+#define PROFILE_BEGIN(id)
+#define PROFILE_END(id)
+#endif
+
+void profileRecord(profileId_e id, uint32_t cycles);
+void profileGetInfo(profileId_e id, profileInfo_t *info);
+void profileReset(profileId_e id);
+const char *profileGetSubTaskName(profileId_e id);
@@ -29,6 +29,7 @@
 #include "build/build_config.h"
 #include "build/debug.h"
 
+#include "scheduler/profile.h"
 #include "scheduler/scheduler.h"
 
 #include "config/config_unittest.h"
@@ -37,8 +38,11 @@
 #include "common/time.h"
 #include "common/utils.h"
 
+#include "drivers/stack_check.h"
 #include "drivers/time.h"
 
+#include "fc/loop_timing.h"
+
 // DEBUG_SCHEDULER, timings for:
 // 0 - gyroUpdate()
 // 1 - pidController()
@@ -58,15 +62,185 @@ STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT int taskQueueSize = 0;
 
 static FAST_RAM int periodCalculationBasisOffset = offsetof(cfTask_t, lastExecutedAt);
 
+// Deadline scheduling, tasks are only started when their average execution time fits before the next realtime task
+#define SCHEDULER_DEADLINE_MARGIN_US 2
+
+static FAST_RAM_ZERO_INIT bool deadlineScheduling;
+static FAST_RAM_ZERO_INIT bool realtimeTaskRanLast;
+
+// Task slicing, a task may run until the next realtime task is due, at most SCHEDULER_SLICE_MAX_US
+#define SCHEDULER_SLICE_MAX_US 100
+
+static FAST_RAM_ZERO_INIT timeUs_t taskSliceEndsAt;
+static FAST_RAM_ZERO_INIT bool currentTaskContinues;
+
+// Load shedding, the non-critical tasks have their periods doubled for every level down to their
+// floor rate while the system load stays above the threshold, and restored once it has dropped
+#define LOAD_SHED_LEVEL_MAX 3
+#define LOAD_SHED_HYSTERESIS_PERCENT 20
+
+typedef struct loadShedTask_s {
+    cfTaskId_e taskId;
+    timeDelta_t floorPeriod;
+} loadShedTask_t;
+
+static const loadShedTask_t loadShedTasks[] = {
+#ifdef USE_OSD
+    { TASK_OSD, TASK_PERIOD_HZ(15) },
+#endif
+#ifdef USE_LED_STRIP
+    { TASK_LEDSTRIP, TASK_PERIOD_HZ(25) },
+#endif
+#ifdef USE_TELEMETRY
+    { TASK_TELEMETRY, TASK_PERIOD_HZ(100) },
+#endif
+#ifdef USE_CMS
+    { TASK_CMS, TASK_PERIOD_HZ(15) },
+#endif
+#ifdef USE_BARO
+    { TASK_BARO, TASK_PERIOD_HZ(10) },
+#endif
+};
+
+#define LOAD_SHED_TASK_COUNT ARRAYLEN(loadShedTasks)
+
+static uint8_t loadShedThresholdPercent;
+static uint8_t loadShedLevel;
+static timeDelta_t loadShedNominalPeriod[LOAD_SHED_TASK_COUNT + 1];  // period last asked for by the task owner
+
+static void loadShedUpdate(void);
+
+// The scheduler itself does not walk the queue. Enabled time driven tasks sit in a min-heap
+// keyed on nextExecuteAt, and are moved into the ready mask once they fall due. Event driven
+// tasks are polled through their checkFunc and set their ready bit when signalled.
+
+STATIC_ASSERT(TASK_COUNT <= 32, too_many_tasks_for_ready_mask);
+
+#define TASK_BIT(task) (1U << ((task) - cfTasks))
+
+STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT cfTask_t* taskDueHeap[TASK_COUNT];
+STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT int taskDueHeapSize = 0;
+static FAST_RAM_ZERO_INIT uint8_t taskDueHeapPos[TASK_COUNT];   // heap index + 1, 0 when not in the heap
+
+static FAST_RAM_ZERO_INIT cfTask_t* taskCheckArray[TASK_COUNT];
+static FAST_RAM_ZERO_INIT int taskCheckCount = 0;
+
+static FAST_RAM_ZERO_INIT uint32_t enabledTaskMask;
+static FAST_RAM_ZERO_INIT uint32_t realtimeTaskMask;
+STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT uint32_t readyTaskMask;
+
 // No need for a linked list for the queue, since items are only inserted at startup
 
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT cfTask_t* taskQueueArray[TASK_COUNT + 1]; // extra item for NULL pointer at end of queue
 
+inline static timeUs_t getPeriodCalculationBasis(const cfTask_t* task)
+{
+    if (task->staticPriority == TASK_PRIORITY_REALTIME) {
+        return *(timeUs_t*)((uint8_t*)task + periodCalculationBasisOffset);
+    } else {
+        return task->lastExecutedAt;
+    }
+}
+
+static FAST_CODE void heapSet(int pos, cfTask_t *task)
+{
+    taskDueHeap[pos] = task;
+    taskDueHeapPos[task - cfTasks] = pos + 1;
+}
+
+static FAST_CODE void heapSiftUp(int pos)
+{
+    cfTask_t *task = taskDueHeap[pos];
+    while (pos > 0) {
+        const int parent = (pos - 1) / 2;
+        if (cmpTimeUs(taskDueHeap[parent]->nextExecuteAt, task->nextExecuteAt) <= 0) {
+            break;
+        }
+        heapSet(pos, taskDueHeap[parent]);
+        pos = parent;
+    }
+    heapSet(pos, task);
+}
+
+static FAST_CODE void heapSiftDown(int pos)
+{
+    cfTask_t *task = taskDueHeap[pos];
+    while (true) {
+        int child = 2 * pos + 1;
+        if (child >= taskDueHeapSize) {
+            break;
+        }
+        if (child + 1 < taskDueHeapSize && cmpTimeUs(taskDueHeap[child + 1]->nextExecuteAt, taskDueHeap[child]->nextExecuteAt) < 0) {
+            child++;
+        }
+        if (cmpTimeUs(task->nextExecuteAt, taskDueHeap[child]->nextExecuteAt) <= 0) {
+            break;
+        }
+        heapSet(pos, taskDueHeap[child]);
+        pos = child;
+    }
+    heapSet(pos, task);
+}
+
+static FAST_CODE void heapInsert(cfTask_t *task)
+{
+    task->nextExecuteAt = getPeriodCalculationBasis(task) + task->desiredPeriod;
+    heapSet(taskDueHeapSize++, task);
+    heapSiftUp(taskDueHeapSize - 1);
+}
+
+static void heapRemove(cfTask_t *task)
+{
+    const int pos = taskDueHeapPos[task - cfTasks] - 1;
+    if (pos < 0) {
+        return;
+    }
+    taskDueHeapPos[task - cfTasks] = 0;
+    if (pos == --taskDueHeapSize) {
+        return;
+    }
+    cfTask_t *moved = taskDueHeap[taskDueHeapSize];
+    heapSet(pos, moved);
+    heapSiftUp(pos);
+    heapSiftDown(taskDueHeapPos[moved - cfTasks] - 1);
+}
+
+static void heapUpdate(cfTask_t *task)
+{
+    const int pos = taskDueHeapPos[task - cfTasks] - 1;
+    if (pos >= 0) {
+        task->nextExecuteAt = getPeriodCalculationBasis(task) + task->desiredPeriod;
+        heapSiftUp(pos);
+        heapSiftDown(taskDueHeapPos[task - cfTasks] - 1);
+    }
+}
+
+// Put a task that has just run, or has just been enabled, back into wait for its next event or due time
+static FAST_CODE void taskWait(cfTask_t *task)
+{
+    if (task->checkFunc) {
+        return;
+    }
+    if (taskDueHeapPos[task - cfTasks] == 0) {
+        heapInsert(task);
+    } else {
+        heapUpdate(task);
+    }
+}
+
 void queueClear(void)
 {
     memset(taskQueueArray, 0, sizeof(taskQueueArray));
     taskQueuePos = 0;
     taskQueueSize = 0;
+
+    memset(taskDueHeap, 0, sizeof(taskDueHeap));
+    memset(taskDueHeapPos, 0, sizeof(taskDueHeapPos));
+    taskDueHeapSize = 0;
+    taskCheckCount = 0;
+    enabledTaskMask = 0;
+    realtimeTaskMask = 0;
+    readyTaskMask = 0;
 }
 
 bool queueContains(cfTask_t *task)
@@ -89,6 +263,16 @@ bool queueAdd(cfTask_t *task)
             memmove(&taskQueueArray[ii+1], &taskQueueArray[ii], sizeof(task) * (taskQueueSize - ii));
             taskQueueArray[ii] = task;
             ++taskQueueSize;
+
+            enabledTaskMask |= TASK_BIT(task);
+            if (task->staticPriority >= TASK_PRIORITY_REALTIME) {
+                realtimeTaskMask |= TASK_BIT(task);
+            }
+            if (task->checkFunc) {
+                taskCheckArray[taskCheckCount++] = task;
+            }
+            task->dynamicPriority = 0;
+            taskWait(task);
             return true;
         }
     }
@@ -101,6 +285,17 @@ bool queueRemove(cfTask_t *task)
         if (taskQueueArray[ii] == task) {
             memmove(&taskQueueArray[ii], &taskQueueArray[ii+1], sizeof(task) * (taskQueueSize - ii));
             --taskQueueSize;
+
+            enabledTaskMask &= ~TASK_BIT(task);
+            realtimeTaskMask &= ~TASK_BIT(task);
+            readyTaskMask &= ~TASK_BIT(task);
+            for (int jj = 0; jj < taskCheckCount; ++jj) {
+                if (taskCheckArray[jj] == task) {
+                    taskCheckArray[jj] = taskCheckArray[--taskCheckCount];
+                    break;
+                }
+            }
+            heapRemove(task);
             return true;
         }
     }
@@ -137,6 +332,8 @@ void taskSystemLoad(timeUs_t currentTimeUs)
 #if defined(SIMULATOR_BUILD)
     averageSystemLoadPercent = 0;
 #endif
+
+    loadShedUpdate();
 }
 
 #if defined(USE_TASK_STATISTICS)
@@ -170,19 +367,88 @@ void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t * taskInfo)
     taskInfo->latestDeltaTime = cfTasks[taskId].taskLatestDeltaTime;
     taskInfo->movingAverageCycleTime = cfTasks[taskId].movingAverageCycleTime;
 #endif
+#ifdef USE_TASK_STACK_CHECK
+    taskInfo->maxStackUsage = cfTasks[taskId].maxStackUsage;
+#endif
+}
+
+static timeDelta_t loadShedPeriod(int index)
+{
+    const timeDelta_t nominalPeriod = loadShedNominalPeriod[index];
+    return MAX(nominalPeriod, MIN(nominalPeriod << loadShedLevel, loadShedTasks[index].floorPeriod));
+}
+
+static int loadShedIndex(const cfTask_t *task)
+{
+    for (unsigned i = 0; i < LOAD_SHED_TASK_COUNT; i++) {
+        if (&cfTasks[loadShedTasks[i].taskId] == task) {
+            return i;
+        }
+    }
+    return -1;
 }
 
 void rescheduleTask(cfTaskId_e taskId, uint32_t newPeriodMicros)
 {
+    cfTask_t *task;
     if (taskId == TASK_SELF) {
-        cfTask_t *task = currentTask;
-        task->desiredPeriod = MAX(SCHEDULER_DELAY_LIMIT, (timeDelta_t)newPeriodMicros);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+        task = currentTask;
     } else if (taskId < TASK_COUNT) {
-        cfTask_t *task = &cfTasks[taskId];
-        task->desiredPeriod = MAX(SCHEDULER_DELAY_LIMIT, (timeDelta_t)newPeriodMicros);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+        task = &cfTasks[taskId];
+    } else {
+        return;
+    }
+
+    task->desiredPeriod = MAX(SCHEDULER_DELAY_LIMIT, (timeDelta_t)newPeriodMicros);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+
+    // a shed task keeps the new period as its nominal one and stays slowed down while the load is high
+    const int index = loadShedIndex(task);
+    if (index >= 0) {
+        loadShedNominalPeriod[index] = task->desiredPeriod;
+        task->desiredPeriod = loadShedPeriod(index);
+    }
+
+    heapUpdate(task);
+}
+
+static void loadShedApply(void)
+{
+    for (unsigned i = 0; i < LOAD_SHED_TASK_COUNT; i++) {
+        cfTask_t *task = &cfTasks[loadShedTasks[i].taskId];
+        task->desiredPeriod = loadShedPeriod(i);
+        heapUpdate(task);
+    }
+}
+
+static void loadShedUpdate(void)
+{
+    uint8_t newLevel = loadShedLevel;
+    if (loadShedThresholdPercent == 0) {
+        newLevel = 0;
+    } else if (averageSystemLoadPercent >= loadShedThresholdPercent) {
+        newLevel = MIN(loadShedLevel + 1, LOAD_SHED_LEVEL_MAX);
+    } else if (averageSystemLoadPercent + LOAD_SHED_HYSTERESIS_PERCENT < loadShedThresholdPercent && loadShedLevel > 0) {
+        newLevel = loadShedLevel - 1;
+    }
+
+    if (newLevel != loadShedLevel) {
+        loadShedLevel = newLevel;
+        loadShedApply();
     }
 }
 
+// Threshold of averageSystemLoadPercent above which the non-critical tasks are slowed down, 0 = off
+void schedulerSetLoadShedding(uint8_t thresholdPercent)
+{
+    loadShedThresholdPercent = thresholdPercent;
+    loadShedUpdate();
+}
+
+uint8_t schedulerGetLoadShedLevel(void)
+{
+    return loadShedLevel;
+}
+
 void setTaskEnabled(cfTaskId_e taskId, bool enabled)
 {
     if (taskId == TASK_SELF || taskId < TASK_COUNT) {
@@ -195,6 +461,20 @@ void setTaskEnabled(cfTaskId_e taskId, bool enabled)
     }
 }
 
+// An enabled task is queued again, so that it is ordered by its new priority
+void setTaskPriority(cfTaskId_e taskId, uint8_t staticPriority)
+{
+    if (taskId < TASK_COUNT) {
+        cfTask_t *task = &cfTasks[taskId];
+        const bool enabled = queueContains(task);
+        queueRemove(task);
+        task->staticPriority = staticPriority;
+        if (enabled) {
+            queueAdd(task);
+        }
+    }
+}
+
 timeDelta_t getTaskDeltaTime(cfTaskId_e taskId)
 {
     if (taskId == TASK_SELF) {
@@ -247,21 +527,163 @@ void schedulerInit(void)
 {
     calculateTaskStatistics = true;
     queueClear();
+
+    loadShedLevel = 0;
+    for (unsigned i = 0; i < LOAD_SHED_TASK_COUNT; i++) {
+        loadShedNominalPeriod[i] = cfTasks[loadShedTasks[i].taskId].desiredPeriod;
+    }
     queueAdd(&cfTasks[TASK_SYSTEM]);
 }
 
 void schedulerOptimizeRate(bool optimizeRate)
 {
     periodCalculationBasisOffset = optimizeRate ? offsetof(cfTask_t, lastDesiredAt) : offsetof(cfTask_t, lastExecutedAt);
+
+    for (int ii = 0; ii < TASK_COUNT; ii++) {
+        heapUpdate(&cfTasks[ii]);
+    }
 }
 
-inline static timeUs_t getPeriodCalculationBasis(const cfTask_t* task)
+void schedulerSetDeadline(bool deadline)
 {
-    if (task->staticPriority == TASK_PRIORITY_REALTIME) {
-        return *(timeUs_t*)((uint8_t*)task + periodCalculationBasisOffset);
+    deadlineScheduling = deadline;
+}
+
+// Time left until the first enabled realtime task falls due, INT32_MAX if there is none
+static FAST_CODE timeDelta_t timeToRealtimeTaskUs(timeUs_t currentTimeUs)
+{
+    if (readyTaskMask & realtimeTaskMask) {
+        return 0;
+    }
+    timeDelta_t timeToRealtimeUs = INT32_MAX;
+    for (uint32_t realtimeTasks = realtimeTaskMask; realtimeTasks; realtimeTasks &= realtimeTasks - 1) {
+        const cfTask_t *task = &cfTasks[__builtin_ctz(realtimeTasks)];
+        timeToRealtimeUs = MIN(timeToRealtimeUs, cmpTimeUs(task->nextExecuteAt, currentTimeUs));
+    }
+    return timeToRealtimeUs;
+}
+
+/*
+ * Task slicing. A long task checks schedulerTaskSliceExpired() between its units of work, doing at
+ * least one per call. When the slice is used up it keeps its place in its own state, calls
+ * schedulerTaskContinue() and returns. The scheduler then re-enters it in the next free slot
+ * instead of after its period.
+ */
+FAST_CODE bool schedulerTaskSliceExpired(void)
+{
+    return cmpTimeUs(micros(), taskSliceEndsAt) >= 0;
+}
+
+void schedulerTaskContinue(void)
+{
+    currentTaskContinues = true;
+}
+
+#if defined(USE_TASK_STATISTICS)
+// A task may start if it is expected to finish before the next realtime task is due. Any task
+// may start on the call straight after a realtime task, the window will not get any larger.
+static FAST_CODE bool taskFitsBeforeDeadline(const cfTask_t *task, timeDelta_t timeToDeadlineUs)
+{
+    if (task->staticPriority >= TASK_PRIORITY_REALTIME || realtimeTaskRanLast) {
+        return true;
+    }
+    return (timeDelta_t)(task->movingSumExecutionTime / MOVING_SUM_COUNT) + SCHEDULER_DEADLINE_MARGIN_US <= timeToDeadlineUs;
+}
+#endif
+
+#ifdef USE_LOOP_TIMING
+// The task that ran last besides the gyro loop and for how long, and the last run time of the gyro loop
+static FAST_RAM_ZERO_INIT cfTask_t *loopTimingLastTask;
+static FAST_RAM_ZERO_INIT timeDelta_t loopTimingLastTaskUs;
+static FAST_RAM_ZERO_INIT timeDelta_t loopTimingGyroTaskUs;
+
+// A gyro loop that starts more than half a period late is an overrun. It is blamed on the gyro loop itself if
+// its last run took longer than the period, else on the task running when it fell due: the one interrupted
+// with the gyro loop in the interrupt, or the one that ran just before it.
+static FAST_CODE void taskCheckLoopOverrun(cfTask_t *task, timeUs_t currentTimeUs)
+{
+    const timeDelta_t lateUs = task->taskLatestDeltaTime - task->desiredPeriod;
+    if (lateUs <= task->desiredPeriod / 2) {
+        return;
+    }
+
+    cfTask_t *culprit = loopTimingLastTask;
+    timeDelta_t culpritUs = loopTimingLastTaskUs;
+    if (loopTimingGyroTaskUs >= task->desiredPeriod || !culprit) {
+        culprit = task;
+        culpritUs = loopTimingGyroTaskUs;
+    } else if (currentTask && currentTask != task && currentTask != culprit) {
+        culprit = currentTask;
+        culpritUs = cmpTimeUs(currentTimeUs, currentTask->lastExecutedAt);
+    }
+
+    loopTimingOverrun(culprit - cfTasks, lateUs, culpritUs);
+}
+#endif
+
+static FAST_CODE void taskExecute(cfTask_t *task, timeUs_t currentTimeUs)
+{
+    task->taskLatestDeltaTime = currentTimeUs - task->lastExecutedAt;
+#if defined(USE_TASK_STATISTICS)
+    float period = currentTimeUs - task->lastExecutedAt;
+#endif
+#ifdef USE_LOOP_TIMING
+    const bool gyroTask = task == &cfTasks[TASK_GYROPID];
+    if (gyroTask) {
+        taskCheckLoopOverrun(task, currentTimeUs);
+    }
+#endif
+    task->lastExecutedAt = currentTimeUs;
+    task->lastDesiredAt += (cmpTimeUs(currentTimeUs, task->lastDesiredAt) / task->desiredPeriod) * task->desiredPeriod;
+    task->dynamicPriority = 0;
+
+#ifdef USE_TASK_STACK_CHECK
+    const uint32_t *stackBase = stackPaint();
+#endif
+
+    // Execute task
+#if defined(USE_TASK_STATISTICS)
+    if (calculateTaskStatistics) {
+        const timeUs_t currentTimeBeforeTaskCall = micros();
+#ifdef USE_TASK_PROFILE
+        const uint32_t cyclesBeforeTaskCall = getCycleCounter();
+        task->taskFunc(currentTimeBeforeTaskCall);
+        profileRecord(task - cfTasks, getCycleCounter() - cyclesBeforeTaskCall);
+#else
+        task->taskFunc(currentTimeBeforeTaskCall);
+#endif
+        const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
+        task->movingSumExecutionTime += taskExecutionTime - task->movingSumExecutionTime / MOVING_SUM_COUNT;
+        task->movingSumDeltaTime += task->taskLatestDeltaTime - task->movingSumDeltaTime / MOVING_SUM_COUNT;
+        task->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
+        task->maxExecutionTime = MAX(task->maxExecutionTime, taskExecutionTime);
+        task->movingAverageCycleTime += 0.05f * (period - task->movingAverageCycleTime);
+    } else
+#endif
+    {
+        task->taskFunc(currentTimeUs);
+    }
+
+#ifdef USE_TASK_STACK_CHECK
+    task->maxStackUsage = MAX(task->maxStackUsage, stackMeasure(stackBase));
+#endif
+
+#ifdef USE_LOOP_TIMING
+    const timeDelta_t executionTimeUs = cmpTimeUs(micros(), currentTimeUs);
+    if (gyroTask) {
+        loopTimingGyroTaskUs = executionTimeUs;
     } else {
-        return task->lastExecutedAt;
+        loopTimingLastTask = task;
+        loopTimingLastTaskUs = executionTimeUs;
     }
+#endif
+}
+
+// Runs a task that is driven by an interrupt instead of the queue, with the same timing and
+// statistics. The task must not be enabled in the queue at the same time.
+FAST_CODE void schedulerExecuteIsrTask(cfTaskId_e taskId, timeUs_t currentTimeUs)
+{
+    taskExecute(&cfTasks[taskId], currentTimeUs);
 }
 
 FAST_CODE void scheduler(void)
@@ -269,70 +691,83 @@ FAST_CODE void scheduler(void)
     // Cache currentTime
     const timeUs_t currentTimeUs = micros();
 
-    // Check for realtime tasks
-    bool outsideRealtimeGuardInterval = true;
-    for (const cfTask_t *task = queueFirst(); task != NULL && task->staticPriority >= TASK_PRIORITY_REALTIME; task = queueNext()) {
-        const timeUs_t nextExecuteAt = getPeriodCalculationBasis(task) + task->desiredPeriod;
-        if ((timeDelta_t)(currentTimeUs - nextExecuteAt) >= 0) {
-            outsideRealtimeGuardInterval = false;
-            break;
-        }
+    // Move the time driven tasks that have fallen due into the ready mask
+    while (taskDueHeapSize > 0 && cmpTimeUs(currentTimeUs, taskDueHeap[0]->nextExecuteAt) >= 0) {
+        cfTask_t *task = taskDueHeap[0];
+        heapRemove(task);
+        readyTaskMask |= TASK_BIT(task);
     }
 
-    // The task to be invoked
-    cfTask_t *selectedTask = NULL;
-    uint16_t selectedTaskDynamicPriority = 0;
-
-    // Update task dynamic priorities
-    uint16_t waitingTasks = 0;
-    for (cfTask_t *task = queueFirst(); task != NULL; task = queueNext()) {
-        // Task has checkFunc - event driven
-        if (task->checkFunc) {
+    // Poll the event driven tasks that have not been signalled yet
+    for (int ii = 0; ii < taskCheckCount; ii++) {
+        cfTask_t *task = taskCheckArray[ii];
+        if (readyTaskMask & TASK_BIT(task)) {
+            continue;
+        }
 #if defined(SCHEDULER_DEBUG)
-            const timeUs_t currentTimeBeforeCheckFuncCall = micros();
+        const timeUs_t currentTimeBeforeCheckFuncCall = micros();
 #else
-            const timeUs_t currentTimeBeforeCheckFuncCall = currentTimeUs;
+        const timeUs_t currentTimeBeforeCheckFuncCall = currentTimeUs;
 #endif
-            // Increase priority for event driven tasks
-            if (task->dynamicPriority > 0) {
-                task->taskAgeCycles = 1 + ((currentTimeUs - task->lastSignaledAt) / task->desiredPeriod);
-                task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
-                waitingTasks++;
-            } else if (task->checkFunc(currentTimeBeforeCheckFuncCall, currentTimeBeforeCheckFuncCall - task->lastExecutedAt)) {
+        if (task->checkFunc(currentTimeBeforeCheckFuncCall, currentTimeBeforeCheckFuncCall - task->lastExecutedAt)) {
 #if defined(SCHEDULER_DEBUG)
-                DEBUG_SET(DEBUG_SCHEDULER, 3, micros() - currentTimeBeforeCheckFuncCall);
+            DEBUG_SET(DEBUG_SCHEDULER, 3, micros() - currentTimeBeforeCheckFuncCall);
 #endif
 #if defined(USE_TASK_STATISTICS)
-                if (calculateTaskStatistics) {
-                    const uint32_t checkFuncExecutionTime = micros() - currentTimeBeforeCheckFuncCall;
-                    checkFuncMovingSumExecutionTime += checkFuncExecutionTime - checkFuncMovingSumExecutionTime / MOVING_SUM_COUNT;
-                    checkFuncMovingSumDeltaTime += task->taskLatestDeltaTime - checkFuncMovingSumDeltaTime / MOVING_SUM_COUNT;
-                    checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
-                    checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
-                }
-#endif
-                task->lastSignaledAt = currentTimeBeforeCheckFuncCall;
-                task->taskAgeCycles = 1;
-                task->dynamicPriority = 1 + task->staticPriority;
-                waitingTasks++;
-            } else {
-                task->taskAgeCycles = 0;
+            if (calculateTaskStatistics) {
+                const uint32_t checkFuncExecutionTime = micros() - currentTimeBeforeCheckFuncCall;
+                checkFuncMovingSumExecutionTime += checkFuncExecutionTime - checkFuncMovingSumExecutionTime / MOVING_SUM_COUNT;
+                checkFuncMovingSumDeltaTime += task->taskLatestDeltaTime - checkFuncMovingSumDeltaTime / MOVING_SUM_COUNT;
+                checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
+                checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
             }
+#endif
+            task->lastSignaledAt = currentTimeBeforeCheckFuncCall;
+            readyTaskMask |= TASK_BIT(task);
         } else {
-            // Task is time-driven, dynamicPriority is last execution age (measured in desiredPeriods)
-            // Task age is calculated from last execution
+            task->taskAgeCycles = 0;
+        }
+    }
+
+    // Realtime tasks that are due block the tasks that are less than two periods late
+    const bool outsideRealtimeGuardInterval = !(readyTaskMask & realtimeTaskMask);
+
+#if defined(USE_TASK_STATISTICS)
+    // Time left until the first waiting realtime task falls due
+    const bool checkDeadline = deadlineScheduling && calculateTaskStatistics && outsideRealtimeGuardInterval && realtimeTaskMask;
+    const timeDelta_t timeToDeadlineUs = checkDeadline ? timeToRealtimeTaskUs(currentTimeUs) : INT32_MAX;
+#endif
+
+    // The task to be invoked
+    cfTask_t *selectedTask = NULL;
+    uint16_t selectedTaskDynamicPriority = 0;
+
+    // Update the dynamic priorities of the ready tasks only
+    uint16_t waitingTasks = 0;
+    for (uint32_t readyTasks = readyTaskMask; readyTasks; readyTasks &= readyTasks - 1) {
+        cfTask_t *task = &cfTasks[__builtin_ctz(readyTasks)];
+
+        if (task->checkFunc) {
+            // Event driven, task age is calculated from the event
+            task->taskAgeCycles = 1 + ((currentTimeUs - task->lastSignaledAt) / task->desiredPeriod);
+        } else {
+            // Time driven, task age is calculated from last execution
             task->taskAgeCycles = ((currentTimeUs - getPeriodCalculationBasis(task)) / task->desiredPeriod);
-            if (task->taskAgeCycles > 0) {
-                task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
-                waitingTasks++;
-            }
         }
+        task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
+        waitingTasks++;
 
-        if (task->dynamicPriority > selectedTaskDynamicPriority) {
-            const bool taskCanBeChosenForScheduling =
+        if (task->dynamicPriority > selectedTaskDynamicPriority ||
+            (task->dynamicPriority == selectedTaskDynamicPriority && selectedTask && task->staticPriority > selectedTask->staticPriority)) {
+            bool taskCanBeChosenForScheduling =
                 (outsideRealtimeGuardInterval) ||
                 (task->taskAgeCycles > 1) ||
                 (task->staticPriority == TASK_PRIORITY_REALTIME);
+#if defined(USE_TASK_STATISTICS)
+            if (checkDeadline) {
+                taskCanBeChosenForScheduling = taskFitsBeforeDeadline(task, timeToDeadlineUs);
+            }
+#endif
             if (taskCanBeChosenForScheduling) {
                 selectedTaskDynamicPriority = task->dynamicPriority;
                 selectedTask = task;
@@ -344,32 +779,25 @@ FAST_CODE void scheduler(void)
     totalWaitingTasks += waitingTasks;
 
     currentTask = selectedTask;
+    realtimeTaskRanLast = selectedTask && selectedTask->staticPriority >= TASK_PRIORITY_REALTIME;
 
     if (selectedTask) {
         // Found a task that should be run
-        selectedTask->taskLatestDeltaTime = currentTimeUs - selectedTask->lastExecutedAt;
-#if defined(USE_TASK_STATISTICS)
-        float period = currentTimeUs - selectedTask->lastExecutedAt;
-#endif
-        selectedTask->lastExecutedAt = currentTimeUs;
-        selectedTask->lastDesiredAt += (cmpTimeUs(currentTimeUs, selectedTask->lastDesiredAt) / selectedTask->desiredPeriod) * selectedTask->desiredPeriod;
-        selectedTask->dynamicPriority = 0;
+        readyTaskMask &= ~TASK_BIT(selectedTask);
 
-        // Execute task
-#if defined(USE_TASK_STATISTICS)
-        if (calculateTaskStatistics) {
-            const timeUs_t currentTimeBeforeTaskCall = micros();
-            selectedTask->taskFunc(currentTimeBeforeTaskCall);
-            const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
-            selectedTask->movingSumExecutionTime += taskExecutionTime - selectedTask->movingSumExecutionTime / MOVING_SUM_COUNT;
-            selectedTask->movingSumDeltaTime += selectedTask->taskLatestDeltaTime - selectedTask->movingSumDeltaTime / MOVING_SUM_COUNT;
-            selectedTask->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
-            selectedTask->maxExecutionTime = MAX(selectedTask->maxExecutionTime, taskExecutionTime);
-            selectedTask->movingAverageCycleTime += 0.05f * (period - selectedTask->movingAverageCycleTime);
-        } else
-#endif
-        {
-            selectedTask->taskFunc(currentTimeUs);
+        const timeDelta_t sliceUs = MIN(timeToRealtimeTaskUs(currentTimeUs) - SCHEDULER_DEADLINE_MARGIN_US, SCHEDULER_SLICE_MAX_US);
+        taskSliceEndsAt = currentTimeUs + MAX(sliceUs, 0);
+        currentTaskContinues = false;
+
+        taskExecute(selectedTask, currentTimeUs);
+
+        // The task may have disabled itself while running
+        if (enabledTaskMask & TASK_BIT(selectedTask)) {
+            if (currentTaskContinues) {
+                readyTaskMask |= TASK_BIT(selectedTask);
+            } else {
+                taskWait(selectedTask);
+            }
         }
 
 #if defined(SCHEDULER_DEBUG)
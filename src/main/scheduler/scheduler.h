@@ -57,6 +57,9 @@ typedef struct {
     timeUs_t     averageExecutionTime;
     timeUs_t     averageDeltaTime;
     float        movingAverageCycleTime;
+#ifdef USE_TASK_STACK_CHECK
+    uint32_t     maxStackUsage;
+#endif
 } cfTaskInfo_t;
 
 typedef enum {
@@ -72,6 +75,7 @@ typedef enum {
     TASK_BATTERY_VOLTAGE,
     TASK_BATTERY_CURRENT,
     TASK_BATTERY_ALERTS,
+    TASK_BATTERY_LOAD,
 #ifdef USE_BEEPER
     TASK_BEEPER,
 #endif
@@ -108,6 +112,9 @@ typedef enum {
 #ifdef USE_ESC_SENSOR
     TASK_ESC_SENSOR,
 #endif
+#ifdef USE_SOFTSERIAL_DMA
+    TASK_SOFTSERIAL,
+#endif
 #ifdef USE_CMS
     TASK_CMS,
 #endif
@@ -120,6 +127,22 @@ typedef enum {
     TASK_PINIOBOX,
 #endif
 
+#ifdef USE_BLACKBOX_OFFLOAD
+    TASK_BLACKBOX,
+#endif
+
+#ifdef USE_CONFIG_BACKGROUND_SAVE
+    TASK_CONFIG_SAVE,
+#endif
+
+#ifdef USE_GYRO_TEMP_COMP
+    TASK_GYRO_TEMP_COMP,
+#endif
+
+#ifdef USE_VIBRATION_MONITOR
+    TASK_VIBRATION,
+#endif
+
     /* Count of real tasks */
     TASK_COUNT,
 
@@ -137,7 +160,7 @@ typedef struct {
     bool (*checkFunc)(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
     void (*taskFunc)(timeUs_t currentTimeUs);
     timeDelta_t desiredPeriod;      // target period of execution
-    const uint8_t staticPriority;   // dynamicPriority grows in steps of this size, shouldn't be zero
+    uint8_t staticPriority;         // dynamicPriority grows in steps of this size, shouldn't be zero
 
     // Scheduling
     uint16_t dynamicPriority;       // measurement of how old task was last executed, used to avoid task starvation
@@ -146,6 +169,7 @@ typedef struct {
     timeUs_t lastExecutedAt;        // last time of invocation
     timeUs_t lastSignaledAt;        // time of invocation event for event-driven tasks
     timeUs_t lastDesiredAt;         // time of last desired execution
+    timeUs_t nextExecuteAt;         // due time of time driven tasks, key of the scheduler due heap
 
 #if defined(USE_TASK_STATISTICS)
     // Statistics
@@ -155,6 +179,9 @@ typedef struct {
     timeUs_t maxExecutionTime;
     timeUs_t totalExecutionTime;    // total time consumed by task since boot
 #endif
+#ifdef USE_TASK_STACK_CHECK
+    uint32_t maxStackUsage;         // deepest stack below the scheduler in bytes
+#endif
 } cfTask_t;
 
 extern cfTask_t cfTasks[TASK_COUNT];
@@ -164,6 +191,7 @@ void getCheckFuncInfo(cfCheckFuncInfo_t *checkFuncInfo);
 void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t *taskInfo);
 void rescheduleTask(cfTaskId_e taskId, uint32_t newPeriodMicros);
 void setTaskEnabled(cfTaskId_e taskId, bool newEnabledState);
+void setTaskPriority(cfTaskId_e taskId, uint8_t staticPriority);
 timeDelta_t getTaskDeltaTime(cfTaskId_e taskId);
 void schedulerSetCalulateTaskStatistics(bool calculateTaskStatistics);
 void schedulerResetTaskStatistics(cfTaskId_e taskId);
@@ -171,8 +199,14 @@ void schedulerResetTaskMaxExecutionTime(cfTaskId_e taskId);
 
 void schedulerInit(void);
 void scheduler(void);
+void schedulerExecuteIsrTask(cfTaskId_e taskId, timeUs_t currentTimeUs);
+bool schedulerTaskSliceExpired(void);
+void schedulerTaskContinue(void);
 void taskSystemLoad(timeUs_t currentTime);
 void schedulerOptimizeRate(bool optimizeRate);
+void schedulerSetDeadline(bool deadline);
+void schedulerSetLoadShedding(uint8_t thresholdPercent);
+uint8_t schedulerGetLoadShedLevel(void);
 
 #define LOAD_PERCENTAGE_ONE 100
 
@@ -77,6 +77,9 @@
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
 
+#include "flight/rpm_filter.h"
+#include "flight/vibration.h"
+
 #include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
 #include "sensors/sensors.h"
@@ -124,12 +127,13 @@ void pgResetFn_accelerometerConfig(accelerometerConfig_t *instance)
         .acc_lpf_hz = 10,
         .acc_hardware = ACC_DEFAULT,
         .acc_high_fsr = false,
+        .acc_rpm_filter = true,
     );
     resetRollAndPitchTrims(&instance->accelerometerTrims);
     resetFlightDynamicsTrims(&instance->accZero);
 }
 
-PG_REGISTER_WITH_RESET_FN(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 2);
+PG_REGISTER_WITH_RESET_FN(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 3);
 
 extern uint16_t InflightcalibratingA;
 extern bool AccInflightCalibrationMeasurementDone;
@@ -345,7 +349,7 @@ bool accInit(uint32_t gyroSamplingInverval)
     }
 #endif
     acc.dev.accAlign = alignment;
-    buildRotationMatrixFromAlignment(customAlignment, &acc.dev.rotationMatrix);
+    buildSensorAlignmentMatrix(&acc.dev.rotationMatrix, alignment, customAlignment);
 
     if (!accDetect(&acc.dev, accelerometerConfig()->acc_hardware)) {
         return false;
@@ -365,6 +369,9 @@ bool accInit(uint32_t gyroSamplingInverval)
     default:
         acc.accSamplingInterval = 1000;
     }
+#ifdef USE_GYRO_ACC_BURST
+    acc.gyroBurst = gyroSetAccBurst(&acc.dev, acc.accSamplingInterval);
+#endif
     if (accLpfCutHz) {
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             biquadFilterInitLPF(&accFilter[axis], accLpfCutHz, acc.accSamplingInterval);
@@ -378,6 +385,16 @@ void accStartCalibration(void)
     calibratingA = CALIBRATING_ACC_CYCLES;
 }
 
+// A sample from the gyro reads waits for accUpdate()
+bool accBurstSampleReady(void)
+{
+#ifdef USE_GYRO_ACC_BURST
+    return acc.gyroBurst && acc.dev.burstGyro->accBurstUpdated;
+#else
+    return false;
+#endif
+}
+
 bool accIsCalibrationComplete(void)
 {
     return calibratingA == 0;
@@ -501,17 +518,21 @@ void accUpdate(timeUs_t currentTimeUs, rollAndPitchTrims_t *rollAndPitchTrims)
         acc.accADC[axis] = acc.dev.ADCRaw[axis];
     }
 
+#ifdef USE_VIBRATION_MONITOR
+    vibrationUpdateAcc(acc.accADC);
+#endif
+
     if (accLpfCutHz) {
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             acc.accADC[axis] = biquadFilterApply(&accFilter[axis], acc.accADC[axis]);
         }
     }
 
-    if (acc.dev.accAlign == ALIGN_CUSTOM) {
-        alignSensorViaMatrix(acc.accADC, &acc.dev.rotationMatrix);
-    } else {
-        alignSensorViaRotation(acc.accADC, acc.dev.accAlign);
-    }
+#ifdef USE_RPM_FILTER
+    rpmFilterAcc(acc.accADC);
+#endif
+
+    applyRotation(acc.accADC, &acc.dev.rotationMatrix);
 
     if (!accIsCalibrationComplete()) {
         performAcclerationCalibration(rollAndPitchTrims);
@@ -52,6 +52,7 @@ typedef struct acc_s {
     uint32_t accSamplingInterval;
     float accADC[XYZ_AXIS_COUNT];
     bool isAccelUpdatedAtLeastOnce;
+    bool gyroBurst;                     // the acc data comes with the gyro reads, which signal the acc task
 } acc_t;
 
 extern acc_t acc;
@@ -71,6 +72,7 @@ typedef struct accelerometerConfig_s {
     uint16_t acc_lpf_hz;                    // cutoff frequency for the low pass filter used on the acc z-axis for althold in Hz
     uint8_t acc_hardware;                   // Which acc hardware to use on boards with more than one device
     bool acc_high_fsr;
+    uint8_t acc_rpm_filter;                 // follow the rotor harmonics of the RPM filter with notches on the acc
     flightDynamicsTrims_t accZero;
     rollAndPitchTrims_t accelerometerTrims;
 } accelerometerConfig_t;
@@ -84,6 +86,7 @@ bool accHasBeenCalibrated(void);
 void accStartCalibration(void);
 void resetRollAndPitchTrims(rollAndPitchTrims_t *rollAndPitchTrims);
 void accUpdate(timeUs_t currentTimeUs, rollAndPitchTrims_t *rollAndPitchTrims);
+bool accBurstSampleReady(void);
 bool accGetAccumulationAverage(float *accumulation);
 union flightDynamicsTrims_u;
 void setAccelerationTrims(union flightDynamicsTrims_u *accelerationTrimsToUse);
@@ -46,6 +46,7 @@
 #include "pg/pg_ids.h"
 
 #include "sensors/battery.h"
+#include "sensors/battery_resistance.h"
 
 /**
  * terminology: meter vs sensors
@@ -62,6 +63,7 @@
 
 #define VBAT_STABLE_MAX_DELTA 20
 #define LVC_AFFECT_TIME 10000000 //10 secs for the LVC to slowly kick in
+#define BATTERY_LOAD_LPF_HZ 10 // fast voltage and current for load feedforward, the meter filters are too slow to follow a punch-out
 
 // Battery monitoring stuff
 uint8_t batteryCellCount; // Note: this can be 0 when no battery is detected or when the battery voltage sensor is missing or disabled.
@@ -72,6 +74,15 @@ static lowVoltageCutoff_t lowVoltageCutoff;
 static currentMeter_t currentMeter;
 static voltageMeter_t voltageMeter;
 
+static pt1Filter_t voltageLoadFilter;
+static pt1Filter_t amperageLoadFilter;
+static float voltageLoad;
+static float amperageLoad;
+static timeUs_t loadSampleTimeUs;
+
+static batteryResistance_t batteryResistance;
+static float voltageOpenCircuit;
+
 static batteryState_e batteryState;
 static batteryState_e voltageState;
 static batteryState_e consumptionState;
@@ -92,7 +103,7 @@ static batteryState_e consumptionState;
 #define DEFAULT_VOLTAGE_METER_SOURCE VOLTAGE_METER_NONE
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 3);
+PG_REGISTER_WITH_RESET_TEMPLATE(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 4);
 
 PG_RESET_TEMPLATE(batteryConfig_t, batteryConfig,
     // voltage
@@ -122,6 +133,7 @@ PG_RESET_TEMPLATE(batteryConfig_t, batteryConfig,
     .ibatLpfPeriod = 10,
     .vbatDurationForWarning = 0,
     .vbatDurationForCritical = 0,
+    .vbatSagCompensation = true,
 );
 
 void batteryUpdateVoltage(timeUs_t currentTimeUs)
@@ -148,10 +160,8 @@ void batteryUpdateVoltage(timeUs_t currentTimeUs)
             break;
     }
 
-    if (debugMode == DEBUG_BATTERY) {
-        debug[0] = voltageMeter.unfiltered;
-        debug[1] = voltageMeter.filtered;
-    }
+    DEBUG_SET(DEBUG_BATTERY, 0, voltageMeter.unfiltered);
+    DEBUG_SET(DEBUG_BATTERY, 1, voltageMeter.filtered);
 }
 
 static void updateBatteryBeeperAlert(void)
@@ -172,6 +182,20 @@ static void updateBatteryBeeperAlert(void)
     }
 }
 
+static bool isBatteryResistanceValid(void)
+{
+    return batteryConfig()->vbatSagCompensation && batteryResistanceIsValid(&batteryResistance);
+}
+
+// Filtered meter voltage with the I*R sag of the pack added back, in 0.01V
+static uint16_t getBatteryVoltageCompensated(void)
+{
+    if (!batteryConfig()->vbatSagCompensation) {
+        return voltageMeter.filtered;
+    }
+    return voltageMeter.filtered + lrintf(batteryResistanceSag(&batteryResistance, voltageMeter.filtered, currentMeter.amperage));
+}
+
 static bool isVoltageStable(void)
 {
     return ABS(voltageMeter.filtered - voltageMeter.unfiltered) <= VBAT_STABLE_MAX_DELTA;
@@ -214,6 +238,7 @@ void batteryUpdatePresence(void)
         batteryCriticalVoltage = batteryCellCount * batteryConfig()->vbatmincellvoltage;
         lowVoltageCutoff.percentage = 100;
         lowVoltageCutoff.startTime = 0;
+        batteryResistanceInit(&batteryResistance);
     } else if (
         voltageState != BATTERY_NOT_PRESENT && isVoltageStable() && !isVoltageFromBat()
     ) {
@@ -225,19 +250,21 @@ void batteryUpdatePresence(void)
         batteryWarningVoltage = 0;
         batteryCriticalVoltage = 0;
     }
-    if (debugMode == DEBUG_BATTERY) {
-        debug[2] = batteryCellCount;
-        debug[3] = isVoltageStable();
-    }
+    DEBUG_SET(DEBUG_BATTERY, 2, batteryCellCount);
+    DEBUG_SET(DEBUG_BATTERY, 3, isVoltageStable());
 }
 
 static void batteryUpdateVoltageState(void)
 {
     // alerts are currently used by beeper, osd and other subsystems
     static uint32_t lastVoltageChangeMs;
+    // The warning compares the open circuit voltage, so that the sag of a punch-out doesn't raise it.
+    // Critical, and so the LVC, stay on the measured voltage: the pack must not be run below it
+    // on the strength of the estimate.
+    const uint16_t voltage = getBatteryVoltageCompensated();
     switch (voltageState) {
         case BATTERY_OK:
-            if (voltageMeter.filtered <= (batteryWarningVoltage - batteryConfig()->vbathysteresis)) {
+            if (voltage <= (batteryWarningVoltage - batteryConfig()->vbathysteresis)) {
                 if (cmp32(millis(), lastVoltageChangeMs) >= batteryConfig()->vbatDurationForWarning * 100) {
                     voltageState = BATTERY_WARNING;
                 }
@@ -252,7 +279,7 @@ static void batteryUpdateVoltageState(void)
                     voltageState = BATTERY_CRITICAL;
                 }
             } else {
-                if (voltageMeter.filtered > batteryWarningVoltage) {
+                if (voltage > batteryWarningVoltage) {
                     voltageState = BATTERY_OK;
                 }
                 lastVoltageChangeMs = millis();
@@ -361,6 +388,9 @@ void batteryInit(void)
     lowVoltageCutoff.startTime = 0;
 
     voltageMeterReset(&voltageMeter);
+    pt1FilterInit(&voltageLoadFilter, pt1FilterGain(BATTERY_LOAD_LPF_HZ, HZ_TO_INTERVAL(50)));
+    voltageLoad = 0;
+    loadSampleTimeUs = 0;
     switch (batteryConfig()->voltageMeterSource) {
         case VOLTAGE_METER_ESC:
 #ifdef USE_ESC_SENSOR
@@ -381,6 +411,8 @@ void batteryInit(void)
     //
     consumptionState = BATTERY_OK;
     currentMeterReset(&currentMeter);
+    pt1FilterInit(&amperageLoadFilter, pt1FilterGain(BATTERY_LOAD_LPF_HZ, HZ_TO_INTERVAL(50)));
+    amperageLoad = 0;
     switch (batteryConfig()->currentMeterSource) {
         case CURRENT_METER_ADC:
             currentMeterADCInit();
@@ -459,6 +491,60 @@ void batteryUpdateCurrentMeter(timeUs_t currentTimeUs)
             currentMeterReset(&currentMeter);
             break;
     }
+
+}
+
+/*
+ * Pack internal resistance from the load samples, which go through the same filter so they stay
+ * in phase. Only measured current meters are used, the virtual meter is derived from the throttle
+ * and would fit the motor instead of the pack.
+ */
+static void batteryUpdateResistance(timeDelta_t sampleInterval)
+{
+    const bool currentMeasured = (batteryConfig()->currentMeterSource == CURRENT_METER_ADC || batteryConfig()->currentMeterSource == CURRENT_METER_ESC);
+    if (!currentMeasured || batteryCellCount == 0 || voltageLoad <= 0.0f) {
+        return;
+    }
+
+    batteryResistanceUpdate(&batteryResistance, voltageLoad, amperageLoad, MIN(sampleInterval, HZ_TO_INTERVAL_US(50)) * 1e-6f);
+}
+
+/*
+ * Voltage and current for the governor's sag compensation and load feedforward, sampled at the
+ * battery load task rate (500Hz by default). ADC meters are read straight from the oversampled
+ * ADC, other sources are held at their latest 50Hz meter reading. The filters follow the sample
+ * timestamps so that scheduling jitter doesn't shift their cutoff.
+ */
+void batteryUpdateLoad(timeUs_t currentTimeUs)
+{
+    const timeDelta_t sampleInterval = cmpTimeUs(currentTimeUs, loadSampleTimeUs);
+    loadSampleTimeUs = currentTimeUs;
+
+    if (sampleInterval <= 0) {
+        return;
+    }
+
+    const float gain = pt1FilterGain(BATTERY_LOAD_LPF_HZ, MIN(sampleInterval, HZ_TO_INTERVAL_US(50)) * 1e-6f);
+
+    const uint16_t voltage = (batteryConfig()->voltageMeterSource == VOLTAGE_METER_ADC) ? voltageMeterADCSample(VOLTAGE_SENSOR_ADC_VBAT) : voltageMeter.unfiltered;
+    pt1FilterUpdateCutoff(&voltageLoadFilter, gain);
+    voltageLoad = pt1FilterApply(&voltageLoadFilter, voltage);
+
+    const int32_t amperage = (batteryConfig()->currentMeterSource == CURRENT_METER_ADC) ? currentMeterADCSample() : currentMeter.amperageLatest;
+    pt1FilterUpdateCutoff(&amperageLoadFilter, gain);
+    amperageLoad = pt1FilterApply(&amperageLoadFilter, amperage);
+
+    batteryUpdateResistance(sampleInterval);
+
+    voltageOpenCircuit = voltageLoad;
+    if (batteryConfig()->vbatSagCompensation) {
+        voltageOpenCircuit += batteryResistanceSag(&batteryResistance, voltageLoad, amperageLoad);
+    }
+
+    DEBUG_SET(DEBUG_BATTERY_RESISTANCE, 0, lrintf(batteryResistance.r * 1000.0f));
+    DEBUG_SET(DEBUG_BATTERY_RESISTANCE, 1, lrintf(voltageOpenCircuit));
+    DEBUG_SET(DEBUG_BATTERY_RESISTANCE, 2, lrintf(batteryResistance.voc * 100.0f));
+    DEBUG_SET(DEBUG_BATTERY_RESISTANCE, 3, batteryResistance.samples);
 }
 
 float calculateVbatPidCompensation(void) {
@@ -514,6 +600,24 @@ uint16_t getBatteryVoltageLatest(void)
     return voltageMeter.unfiltered;
 }
 
+// Voltage in 0.01V steps, filtered at BATTERY_LOAD_LPF_HZ for feedforward on load changes
+float getBatteryVoltageLoad(void)
+{
+    return voltageLoad;
+}
+
+// Load voltage with the I*R sag of the pack added back, the same as getBatteryVoltageLoad() until the resistance is known
+float getBatteryVoltageOpenCircuit(void)
+{
+    return voltageOpenCircuit;
+}
+
+// Estimated pack internal resistance in ohm, 0 until enough load changes have been seen
+float getBatteryResistance(void)
+{
+    return isBatteryResistanceValid() ? batteryResistance.r : 0.0f;
+}
+
 uint8_t getBatteryCellCount(void)
 {
     return batteryCellCount;
@@ -538,6 +642,12 @@ int32_t getAmperageLatest(void)
     return currentMeter.amperageLatest;
 }
 
+// Current in 0.01A steps, filtered at BATTERY_LOAD_LPF_HZ for feedforward on load changes
+float getAmperageLoad(void)
+{
+    return amperageLoad;
+}
+
 int32_t getMAhDrawn(void)
 {
     return currentMeter.mAhDrawn;
@@ -65,6 +65,7 @@ typedef struct batteryConfig_s {
     uint8_t ibatLpfPeriod;                  // Period of the cutoff frequency for the Ibat filter (in 0.1 s)
     uint8_t vbatDurationForWarning;      // Period voltage has to sustain before the battery state is set to BATTERY_WARNING (in 0.1 s)
     uint8_t vbatDurationForCritical;         // Period voltage has to sustain before the battery state is set to BATTERY_CRIT (in 0.1 s)
+    bool vbatSagCompensation;               // Add the I*R sag of the estimated pack resistance back for the alarms, LVC and governor
 } batteryConfig_t;
 
 PG_DECLARE(batteryConfig_t, batteryConfig);
@@ -103,14 +104,19 @@ bool isBatteryVoltageConfigured(void);
 uint16_t getBatteryVoltage(void);
 uint16_t getLegacyBatteryVoltage(void);
 uint16_t getBatteryVoltageLatest(void);
+float getBatteryVoltageLoad(void);
+float getBatteryVoltageOpenCircuit(void);
+float getBatteryResistance(void);
 uint8_t getBatteryCellCount(void);
 uint16_t getBatteryAverageCellVoltage(void);
 
 bool isAmperageConfigured(void);
 int32_t getAmperage(void);
 int32_t getAmperageLatest(void);
+float getAmperageLoad(void);
 int32_t getMAhDrawn(void);
 
 void batteryUpdateCurrentMeter(timeUs_t currentTimeUs);
+void batteryUpdateLoad(timeUs_t currentTimeUs);
 
 const lowVoltageCutoff_t *getLowVoltageCutoff(void);
@@ -0,0 +1,100 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Pack internal resistance from the load samples. The caller filters voltage and current the
+ * same way so they stay in phase. A sample only enters the fit when the current is far enough
+ * from its slow mean: at a steady current R and Voc can't be told apart, and forgetting without
+ * excitation would wind up the covariance.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "battery_resistance.h"
+
+void batteryResistanceInit(batteryResistance_t *est)
+{
+    est->voc = 0.0f;
+    est->r = 0.0f;
+    est->p00 = 1000.0f;
+    est->p01 = 0.0f;
+    est->p11 = 0.1f;
+    est->samples = 0;
+    pt1FilterInit(&est->amperageMeanFilter, 0.0f);
+}
+
+void batteryResistanceUpdate(batteryResistance_t *est, float voltage, float amperage, float dT)
+{
+    // start from the first sample, a load present at plug in is not a load step
+    if (est->voc <= 0.0f) {
+        est->voc = voltage * 0.01f;
+        est->amperageMeanFilter.state = amperage;
+    }
+
+    pt1FilterUpdateCutoff(&est->amperageMeanFilter, pt1FilterGain(BATTERY_RESISTANCE_MEAN_HZ, dT));
+    const float amperageMean = pt1FilterApply(&est->amperageMeanFilter, amperage);
+
+    if (fabsf(amperage - amperageMean) < BATTERY_RESISTANCE_MIN_EXCITATION) {
+        return;
+    }
+
+    // Regressor [1, -I]
+    const float v = voltage * 0.01f;
+    const float i = amperage * 0.01f;
+    const float pPhi0 = est->p00 - est->p01 * i;
+    const float pPhi1 = est->p01 - est->p11 * i;
+    const float denom = BATTERY_RESISTANCE_FORGETTING + pPhi0 - i * pPhi1;
+    const float k0 = pPhi0 / denom;
+    const float k1 = pPhi1 / denom;
+    const float error = v - (est->voc - i * est->r);
+
+    est->voc += k0 * error;
+    est->r = constrainf(est->r + k1 * error, 0.0f, BATTERY_RESISTANCE_MAX);
+
+    est->p00 = (est->p00 - k0 * pPhi0) / BATTERY_RESISTANCE_FORGETTING;
+    est->p01 = (est->p01 - k0 * pPhi1) / BATTERY_RESISTANCE_FORGETTING;
+    est->p11 = (est->p11 - k1 * pPhi1) / BATTERY_RESISTANCE_FORGETTING;
+
+    if (est->samples < BATTERY_RESISTANCE_VALID_SAMPLES) {
+        est->samples++;
+    }
+}
+
+bool batteryResistanceIsValid(const batteryResistance_t *est)
+{
+    return est->samples >= BATTERY_RESISTANCE_VALID_SAMPLES;
+}
+
+// The I*R sag to add back to a voltage measured at this current, in 0.01V. Limited to a share
+// of the voltage, so a bad fit can't hide a pack that really is empty.
+float batteryResistanceSag(const batteryResistance_t *est, float voltage, float amperage)
+{
+    if (!batteryResistanceIsValid(est) || amperage <= 0.0f || voltage <= 0.0f) {
+        return 0.0f;
+    }
+    return MIN(amperage * est->r, voltage * BATTERY_SAG_COMPENSATION_MAX_PERCENT / 100);
+}
@@ -0,0 +1,48 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/filter.h"
+
+#define BATTERY_RESISTANCE_FORGETTING       0.998f  // per excited load sample, about 1s of memory at 500Hz
+#define BATTERY_RESISTANCE_MEAN_HZ          0.5f    // slow current the excitation is measured against
+#define BATTERY_RESISTANCE_MIN_EXCITATION   200     // 2A away from the slow current before a sample is used
+#define BATTERY_RESISTANCE_VALID_SAMPLES    250     // excited samples before the estimate is used
+#define BATTERY_RESISTANCE_MAX              0.5f    // ohm, anything higher is a bad fit or a broken connector
+#define BATTERY_SAG_COMPENSATION_MAX_PERCENT 15     // of the measured voltage, the sag added back is never more
+
+// Recursive least squares fit of V = Voc - I * R on the load samples, volts, amps and ohms
+typedef struct batteryResistance_s {
+    float voc;
+    float r;
+    float p00, p01, p11;                // covariance, symmetric
+    pt1Filter_t amperageMeanFilter;
+    uint16_t samples;
+} batteryResistance_t;
+
+// voltage in 0.01V and amperage in 0.01A, as the meters report them
+void batteryResistanceInit(batteryResistance_t *est);
+void batteryResistanceUpdate(batteryResistance_t *est, float voltage, float amperage, float dT);
+bool batteryResistanceIsValid(const batteryResistance_t *est);
+float batteryResistanceSag(const batteryResistance_t *est, float voltage, float amperage);
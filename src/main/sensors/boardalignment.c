@@ -69,6 +69,40 @@ static FAST_CODE void alignBoard(float *vec)
     applyRotation(vec, &boardRotation);
 }
 
+// Builds the complete sensor to body rotation, sensor alignment followed by board alignment,
+// so the sensor update applies one precomputed matrix instead of branching on the alignment.
+void buildSensorAlignmentMatrix(fp_rotationMatrix_t *rm, sensor_align_e alignment, const sensorAlignment_t *customAlignment)
+{
+    fp_rotationMatrix_t sensorRotation;
+
+    if (alignment == ALIGN_CUSTOM) {
+        buildRotationMatrixFromAlignment(customAlignment, &sensorRotation);
+    } else {
+        sensorAlignment_t standardAlignment;
+        buildAlignmentFromStandardAlignment(&standardAlignment, (alignment == ALIGN_DEFAULT) ? CW0_DEG : alignment);
+        buildRotationMatrixFromAlignment(&standardAlignment, &sensorRotation);
+
+        // standard alignments are multiples of 90 degrees, remove the trig rounding
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                sensorRotation.m[i][j] = lrintf(sensorRotation.m[i][j]);
+            }
+        }
+    }
+
+    if (standardBoardAlignment) {
+        *rm = sensorRotation;
+        return;
+    }
+
+    // applyRotation() uses the transposed layout, so sensor then board is sensor * board
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            rm->m[i][j] = sensorRotation.m[i][X] * boardRotation.m[X][j] + sensorRotation.m[i][Y] * boardRotation.m[Y][j] + sensorRotation.m[i][Z] * boardRotation.m[Z][j];
+        }
+    }
+}
+
 FAST_CODE_NOINLINE void alignSensorViaMatrix(float *dest, fp_rotationMatrix_t* sensorRotationMatrix)
 {
     applyRotation(dest, sensorRotationMatrix);
@@ -22,6 +22,7 @@
 
 #include "common/axis.h"
 #include "common/maths.h"
+#include "common/sensor_alignment.h"
 
 #include "pg/pg.h"
 
@@ -33,6 +34,7 @@ typedef struct boardAlignment_s {
 
 PG_DECLARE(boardAlignment_t, boardAlignment);
 
+void buildSensorAlignmentMatrix(fp_rotationMatrix_t *rm, sensor_align_e alignment, const sensorAlignment_t *customAlignment);
 void alignSensorViaMatrix(float *dest, fp_rotationMatrix_t* rotationMatrix);
 void alignSensorViaRotation(float *dest, uint8_t rotation);
 
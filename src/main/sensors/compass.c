@@ -48,6 +48,9 @@
 
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
+#include "pg/sensor_cache.h"
+
+#include "scheduler/scheduler.h"
 
 #include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
@@ -119,7 +122,7 @@ void compassPreInit(void)
 }
 
 #if !defined(SIMULATOR_BUILD)
-bool compassDetect(magDev_t *dev, uint8_t *alignment)
+bool compassDetect(magDev_t *dev, sensor_align_e *alignment, magSensor_e magHardwareToUse)
 {
     *alignment = ALIGN_DEFAULT;  // may be overridden if target specifies MAG_*_ALIGN
 
@@ -173,7 +176,7 @@ bool compassDetect(magDev_t *dev, uint8_t *alignment)
         return false;
     }
 
-    switch (compassConfig()->mag_hardware) {
+    switch (magHardwareToUse) {
     case MAG_DEFAULT:
         FALLTHROUGH;
 
@@ -276,10 +279,11 @@ bool compassDetect(magDev_t *dev, uint8_t *alignment)
     return true;
 }
 #else
-bool compassDetect(magDev_t *dev, sensor_align_e *alignment)
+bool compassDetect(magDev_t *dev, sensor_align_e *alignment, magSensor_e magHardwareToUse)
 {
     UNUSED(dev);
     UNUSED(alignment);
+    UNUSED(magHardwareToUse);
 
     return false;
 }
@@ -292,8 +296,22 @@ bool compassInit(void)
     mag.magneticDeclination = 0.0f; // TODO investigate if this is actually needed if there is no mag sensor or if the value stored in the config should be used.
 
     sensor_align_e alignment;
+    bool magDetected = false;
+
+#ifdef USE_SENSOR_HARDWARE_CACHE
+    // Start with the compass found on the last boot
+    if (compassConfig()->mag_hardware == MAG_DEFAULT && sensorHardwareCache()->magHardware != MAG_DEFAULT) {
+        magDetected = compassDetect(&magDev, &alignment, sensorHardwareCache()->magHardware);
+    }
+#endif
+    if (!magDetected) {
+        magDetected = compassDetect(&magDev, &alignment, compassConfig()->mag_hardware);
+    }
+#ifdef USE_SENSOR_HARDWARE_CACHE
+    sensorHardwareCacheMutable()->magHardware = magDetected ? detectedSensors[SENSOR_INDEX_MAG] : MAG_DEFAULT;
+#endif
 
-    if (!compassDetect(&magDev, &alignment)) {
+    if (!magDetected) {
         return false;
     }
 
@@ -311,7 +329,7 @@ bool compassInit(void)
         magDev.magAlignment = compassConfig()->mag_alignment;
     }
     
-    buildRotationMatrixFromAlignment(&compassConfig()->mag_customAlignment, &magDev.rotationMatrix);
+    buildSensorAlignmentMatrix(&magDev.rotationMatrix, magDev.magAlignment, &compassConfig()->mag_customAlignment);
 
     return true;
 }
@@ -337,18 +355,19 @@ bool compassIsCalibrationComplete(void)
     return tCal == 0;
 }
 
-void compassUpdate(timeUs_t currentTimeUs)
+// Advance the non-blocking read, returns the time until the next call
+uint32_t compassUpdate(timeUs_t currentTimeUs)
 {
+    if (busBusy(&magDev.busdev, NULL) || !magDev.read(&magDev, magADCRaw)) {
+        // transfer in flight or no new sample yet, poll again shortly
+        return COMPASS_POLL_INTERVAL_US;
+    }
+
 
-    magDev.read(&magDev, magADCRaw);
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         mag.magADC[axis] = magADCRaw[axis];
     }
-    if (magDev.magAlignment == ALIGN_CUSTOM) {
-        alignSensorViaMatrix(mag.magADC, &magDev.rotationMatrix);
-    } else {
-        alignSensorViaRotation(mag.magADC, magDev.magAlignment);
-    }
+    applyRotation(mag.magADC, &magDev.rotationMatrix);
 
     flightDynamicsTrims_t *magZero = &compassConfigMutable()->magZero;
     if (magInit) {              // we apply offset only once mag calibration is done
@@ -375,5 +394,7 @@ void compassUpdate(timeUs_t currentTimeUs)
             saveConfigAndNotify();
         }
     }
+
+    return TASK_PERIOD_HZ(COMPASS_TASK_RATE_HZ);
 }
 #endif // USE_MAG
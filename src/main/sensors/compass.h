@@ -63,8 +63,11 @@ typedef struct compassConfig_s {
 
 PG_DECLARE(compassConfig_t, compassConfig);
 
+#define COMPASS_TASK_RATE_HZ     10
+#define COMPASS_POLL_INTERVAL_US 1000   // retry interval while a bus transfer is in flight
+
 bool compassIsHealthy(void);
-void compassUpdate(timeUs_t currentTime);
+uint32_t compassUpdate(timeUs_t currentTime);
 bool compassInit(void);
 void compassPreInit(void);
 void compassStartCalibration(void);
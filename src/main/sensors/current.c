@@ -161,6 +161,16 @@ void currentMeterADCRefresh(int32_t lastUpdateAt)
 #endif
 }
 
+// Latest oversampled reading in 0.01A steps, without the meter filter
+int32_t currentMeterADCSample(void)
+{
+#ifdef USE_ADC
+    return currentMeterADCToCentiamps(adcGetChannel(ADC_CURRENT));
+#else
+    return 0;
+#endif
+}
+
 void currentMeterADCRead(currentMeter_t *meter)
 {
     meter->amperageLatest = currentMeterADCState.amperageLatest;
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #include "platform.h"
@@ -36,6 +37,7 @@
 #include "pg/pg_ids.h"
 #include "pg/motor.h"
 
+#include "common/crc.h"
 #include "common/maths.h"
 #include "common/utils.h"
 
@@ -43,13 +45,17 @@
 #include "drivers/motor.h"
 #include "drivers/dshot.h"
 #include "drivers/dshot_dpwm.h"
+#include "drivers/dshot_command.h"
 #include "drivers/serial.h"
 #include "drivers/serial_uart.h"
+#include "drivers/time.h"
 
 #include "esc_sensor.h"
 
 #include "config/config.h"
 
+#include "fc/runtime_config.h"
+
 #include "flight/mixer.h"
 
 #include "io/serial.h"
@@ -98,6 +104,26 @@ enum {
     DEBUG_ESC_DATA_AGE = 3,
 };
 
+/*
+ * Each telemetry protocol has an entry in escSensorProtocols[], indexed by
+ * esc_sensor_protocol and compiled in with its USE_ESC_SENSOR_* define.
+ * The protocol frames the byte stream in its RX callback and decodes the
+ * frames into escSensorData[] from the ESC sensor task, the getters only
+ * read escSensorData[]. A protocol without an RX callback needs no UART.
+ */
+typedef struct escSensorProtocol_s {
+    uint32_t baudrate;
+    portOptions_e options;
+    serialReceiveCallbackPtr dataReceive;               // RX callback, signals escFrameReceived
+    void (*init)(void);
+    void (*process)(timeUs_t currentTimeUs);            // ESC sensor task
+    bool (*dataValid)(const escSensorData_t *data);     // data age check
+    bool singleStream;                                  // one ESC reports in escSensorData[0] for all motors
+} escSensorProtocol_t;
+
+static const escSensorProtocol_t *escSensorProtocol = NULL;
+
+#ifdef USE_ESC_SENSOR_KISS
 typedef enum {
     ESC_SENSOR_FRAME_PENDING = 0,
     ESC_SENSOR_FRAME_COMPLETE = 1,
@@ -117,6 +143,10 @@ typedef enum {
 #define TELEMETRY_FRAME_SIZE 10
 static uint8_t telemetryBuffer[TELEMETRY_FRAME_SIZE] = { 0, };
 
+static escSensorTriggerState_t escSensorTriggerState = ESC_SENSOR_TRIGGER_STARTUP;
+static uint32_t escTriggerTimestamp;
+#endif
+
 static volatile uint8_t *buffer;
 static volatile uint8_t bufferSize = 0;
 static volatile uint8_t bufferPosition = 0;
@@ -124,9 +154,9 @@ static volatile uint8_t bufferPosition = 0;
 static serialPort_t *escSensorPort = NULL;
 
 static escSensorData_t escSensorData[MAX_SUPPORTED_MOTORS];
+static bool escSensorDataValid[MAX_SUPPORTED_MOTORS];       // updated by the ESC sensor task
+static timeUs_t escSensorRpmTimeUs[MAX_SUPPORTED_MOTORS];    // time the rpm was received
 
-static escSensorTriggerState_t escSensorTriggerState = ESC_SENSOR_TRIGGER_STARTUP;
-static uint32_t escTriggerTimestamp;
 static uint8_t escSensorMotor = 0;      // motor index
 
 static escSensorData_t combinedEscSensorData;
@@ -135,6 +165,29 @@ static bool combinedDataNeedsUpdate = true;
 static uint16_t totalTimeoutCount = 0;
 static uint16_t totalCrcErrorCount = 0;
 
+// Set by the serial RX callbacks once a complete frame is in, signals the ESC sensor task
+static volatile bool escFrameReceived = false;
+
+#ifdef USE_ESC_SENSOR_HOBBYWING
+#define HWV4_FRAME_SIZE 18
+
+// Hobbywing V4 frames are assembled in one buffer while the task decodes the other one
+static uint8_t hwv4Frames[2][HWV4_FRAME_SIZE];
+static uint8_t hwv4WriteFrame = 0;
+static const uint8_t * volatile hwv4Frame = hwv4Frames[1];  // latest complete frame
+static uint8_t bytesRead = 0;
+static uint8_t skipPackets = 0;
+
+// Hobbywing V4 scales, precomputed from the esc_sensor_hobbywing_* settings
+#define HWV4_TEMP_TABLE_BITS    6
+#define HWV4_TEMP_TABLE_STEP    (1 << (12 - HWV4_TEMP_TABLE_BITS))     // 12 bit ADC
+
+static float hwv4VoltScale;
+static float hwv4CurrScale;
+static uint16_t hwv4CurrOffset;
+static float hwv4TempTable[(1 << HWV4_TEMP_TABLE_BITS) + 1];
+#endif
+
 void startEscDataRead(uint8_t *frameBuffer, uint8_t frameLength)
 {
     buffer = frameBuffer;
@@ -147,61 +200,33 @@ uint8_t getNumberEscBytesRead(void)
     return bufferPosition;
 }
 
+#ifdef USE_ESC_SENSOR_KISS
 static bool isFrameComplete(void)
 {
     return bufferPosition == bufferSize;
 }
+#endif
 
 bool isEscSensorActive(void)
 {
-    return escSensorPort != NULL;
+    return escSensorPort != NULL || (escSensorProtocol && !escSensorProtocol->dataReceive);
 }
 
 // HF3D:  Added to provide RPM data to rpm filter and spoolup/governor logic when DSHOT RPM or RPM Sensor isn't available.
 bool isEscSensorValid(uint8_t motorNumber)
 {
-    // First check escSensorPort != NULL
-    if (escSensorPort == NULL) {
-        return 0;
+    if (motorNumber < MAX_SUPPORTED_MOTORS) {
+        return escSensorDataValid[motorNumber];
+    } else if (motorNumber == ESC_SENSOR_COMBINED) {
+        return escSensorProtocol && escSensorProtocol->dataValid(&combinedEscSensorData);
     }
-    
-    if ( escSensorConfig()->escSensorProtocol == ESC_SENSOR_PROTOCOL_KISS ) {
-        // KISS:  Check if dataAge < ESC_BATTERY_AGE_MAX
-        if (motorNumber < getMotorCount()) {
-            return (escSensorData[motorNumber].dataAge <= ESC_BATTERY_AGE_MAX);
-        } else if (motorNumber == ESC_SENSOR_COMBINED) {
-            return (combinedEscSensorData.dataAge <= ESC_BATTERY_AGE_MAX);
-        } else {
-            return 0;
-        }
-    
-    } else if ( escSensorConfig()->escSensorProtocol == ESC_SENSOR_PROTOCOL_HOBBYWINGV4 ) {
-        // HWV4:  dataAge < 100 while throttle=0  or  dataAge < 11 while motor spinning
-        //   Realistically we get these every 40 while throttle=0 and 4 while motor is spinning (rpm>0)
-        uint8_t thisDataAge = 0;
-        uint16_t thisRPM = 0;
-        
-        if (motorNumber < getMotorCount()) {
-            thisDataAge = escSensorData[motorNumber].dataAge;
-            thisRPM = escSensorData[motorNumber].rpm;
-        } else if (motorNumber == ESC_SENSOR_COMBINED) {
-            thisDataAge = combinedEscSensorData.dataAge;
-            thisRPM = combinedEscSensorData.rpm;
-        } else {
-            return 0;
-        }
 
-        // If last RPM value was > 0 (motor spinning) then we should be receiving telemetry every 50ms
-        // HF3D TODO:  This will break if scheduler is changed to increase polling rate of escSensorProcess task beyond 100Hz.
-        if (thisRPM > 0 && thisDataAge < 11) {
-            return 1;
-        } else if (thisRPM == 0 && thisDataAge < 120) {
-            return 1;
-        }
-    
-    }
-    
-    return 0;
+    return false;
+}
+
+timeUs_t getEscSensorRpmTimeUs(uint8_t motorNumber)
+{
+    return motorNumber < MAX_SUPPORTED_MOTORS ? escSensorRpmTimeUs[motorNumber] : 0;
 }
 
 uint16_t getEscSensorRPM(uint8_t motorNumber)
@@ -219,48 +244,11 @@ uint16_t getEscSensorRPM(uint8_t motorNumber)
 
 escSensorData_t *getEscSensorData(uint8_t motorNumber)
 {
-    if (!featureIsEnabled(FEATURE_ESC_SENSOR)) {
+    if (!featureIsEnabled(FEATURE_ESC_SENSOR) || !escSensorProtocol) {
         return NULL;
     }
-    
-    if ( escSensorConfig()->escSensorProtocol == ESC_SENSOR_PROTOCOL_KISS ) {
-        // KISS ESC Telemetry
-        if (motorNumber < getMotorCount()) {
-            return &escSensorData[motorNumber];
-        } else if (motorNumber == ESC_SENSOR_COMBINED) {
-            if (combinedDataNeedsUpdate) {
-                combinedEscSensorData.dataAge = 0;
-                combinedEscSensorData.temperature = 0;
-                combinedEscSensorData.voltage = 0;
-                combinedEscSensorData.current = 0;
-                combinedEscSensorData.consumption = 0;
-                combinedEscSensorData.rpm = 0;
-
-                for (int i = 0; i < getMotorCount(); i = i + 1) {
-                    combinedEscSensorData.dataAge = MAX(combinedEscSensorData.dataAge, escSensorData[i].dataAge);
-                    combinedEscSensorData.temperature = MAX(combinedEscSensorData.temperature, escSensorData[i].temperature);
-                    combinedEscSensorData.voltage += escSensorData[i].voltage;
-                    combinedEscSensorData.current += escSensorData[i].current;
-                    combinedEscSensorData.consumption += escSensorData[i].consumption;
-                    combinedEscSensorData.rpm += escSensorData[i].rpm;
-                }
-
-                combinedEscSensorData.voltage = combinedEscSensorData.voltage / getMotorCount();
-                combinedEscSensorData.rpm = combinedEscSensorData.rpm / getMotorCount();
-
-                combinedDataNeedsUpdate = false;
-
-                DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_DATA_AGE, combinedEscSensorData.dataAge);
-            }
 
-            return &combinedEscSensorData;
-        } else {
-            return NULL;
-        }
-
-    } else if ( escSensorConfig()->escSensorProtocol == ESC_SENSOR_PROTOCOL_HOBBYWINGV4 ) {
-        // Hobbywing V4 Telemetry
-        
+    if (escSensorProtocol->singleStream) {
         if (motorNumber < getMotorCount()) {
             return &escSensorData[0];
         } else if (motorNumber == ESC_SENSOR_COMBINED) {
@@ -269,12 +257,43 @@ escSensorData_t *getEscSensorData(uint8_t motorNumber)
         } else {
             return NULL;
         }
+    }
+
+    if (motorNumber < getMotorCount()) {
+        return &escSensorData[motorNumber];
+    } else if (motorNumber == ESC_SENSOR_COMBINED) {
+        if (combinedDataNeedsUpdate) {
+            combinedEscSensorData.dataAge = 0;
+            combinedEscSensorData.temperature = 0;
+            combinedEscSensorData.voltage = 0;
+            combinedEscSensorData.current = 0;
+            combinedEscSensorData.consumption = 0;
+            combinedEscSensorData.rpm = 0;
+
+            for (int i = 0; i < getMotorCount(); i = i + 1) {
+                combinedEscSensorData.dataAge = MAX(combinedEscSensorData.dataAge, escSensorData[i].dataAge);
+                combinedEscSensorData.temperature = MAX(combinedEscSensorData.temperature, escSensorData[i].temperature);
+                combinedEscSensorData.voltage += escSensorData[i].voltage;
+                combinedEscSensorData.current += escSensorData[i].current;
+                combinedEscSensorData.consumption += escSensorData[i].consumption;
+                combinedEscSensorData.rpm += escSensorData[i].rpm;
+            }
+
+            combinedEscSensorData.voltage = combinedEscSensorData.voltage / getMotorCount();
+            combinedEscSensorData.rpm = combinedEscSensorData.rpm / getMotorCount();
+
+            combinedDataNeedsUpdate = false;
+
+            DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_DATA_AGE, combinedEscSensorData.dataAge);
+        }
+
+        return &combinedEscSensorData;
     } else {
         return NULL;
     }
-        
 }
 
+#ifdef USE_ESC_SENSOR_KISS
 // Receive ISR callback
 static void escSensorDataReceive(uint16_t c, void *data)
 {
@@ -288,71 +307,24 @@ static void escSensorDataReceive(uint16_t c, void *data)
     }
 
     buffer[bufferPosition++] = (uint8_t)c;
-}
-
-bool escSensorInit(void)
-{
-    const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_ESC_SENSOR);
-    if (!portConfig) {
-        return false;
-    }
-
-    if ( escSensorConfig()->escSensorProtocol == ESC_SENSOR_PROTOCOL_KISS ) {
-        portOptions_e options = SERIAL_NOT_INVERTED  | (escSensorConfig()->halfDuplex ? SERIAL_BIDIR : 0);
 
-        // Initialize serial port
-        escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, escSensorDataReceive, NULL, ESC_SENSOR_BAUDRATE, MODE_RX, options);
-
-        for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
-            escSensorData[i].dataAge = ESC_DATA_INVALID;
-        }
-    
-    } else if ( escSensorConfig()->escSensorProtocol == ESC_SENSOR_PROTOCOL_HOBBYWINGV4 ) {
-        /*
-         * Hobbywing V4 protocol
-         *
-         * 19200 baud
-         * not inverted
-         * no parity
-         * 8 Bit
-         * 1 Stop Bit
-         * Big Endian
-         * RX Direction
-        */
-        // leave halfDuplex = 0 (off) unless you're connecting up to a UART TX pin for some strange reason (normal wiring = RX pin)
-        portOptions_e options = (SERIAL_STOPBITS_1 | SERIAL_PARITY_NO | SERIAL_NOT_INVERTED)  | (escSensorConfig()->halfDuplex ? SERIAL_BIDIR : 0);
-
-        // Initialize serial port with no callback.  We will just process the buffer.
-        escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, NULL, NULL, 19200, MODE_RX, options);
-
-        escSensorData[0].dataAge = ESC_DATA_INVALID;
+    if (isFrameComplete()) {
+        escFrameReceived = true;
     }
-    
-    return escSensorPort != NULL;
 }
+#endif
 
-static uint8_t updateCrc8(uint8_t crc, uint8_t crc_seed)
+bool escSensorFrameReceived(void)
 {
-    uint8_t crc_u = crc;
-    crc_u ^= crc_seed;
-
-    for (int i=0; i<8; i++) {
-        crc_u = ( crc_u & 0x80 ) ? 0x7 ^ ( crc_u << 1 ) : ( crc_u << 1 );
-    }
-
-    return (crc_u);
+    return escFrameReceived;
 }
 
 uint8_t calculateCrc8(const uint8_t *Buf, const uint8_t BufLen)
 {
-    uint8_t crc = 0;
-    for (int i = 0; i < BufLen; i++) {
-        crc = updateCrc8(Buf[i], crc);
-    }
-
-    return crc;
+    return crc8_smbus_update(0, Buf, BufLen);
 }
 
+#ifdef USE_ESC_SENSOR_KISS
 static uint8_t decodeEscFrame(void)
 {
     if (!isFrameComplete()) {
@@ -370,6 +342,7 @@ static uint8_t decodeEscFrame(void)
         escSensorData[escSensorMotor].current = telemetryBuffer[3] << 8 | telemetryBuffer[4];
         escSensorData[escSensorMotor].consumption = telemetryBuffer[5] << 8 | telemetryBuffer[6];
         escSensorData[escSensorMotor].rpm = telemetryBuffer[7] << 8 | telemetryBuffer[8];
+        escSensorRpmTimeUs[escSensorMotor] = micros();
 
         combinedDataNeedsUpdate = true;
 
@@ -403,13 +376,103 @@ static void selectNextMotor(void)
     }
 }
 
-// XXX Review ESC sensor under refactored motor handling
+static void kissProcess(timeUs_t currentTimeUs)
+{
+    const timeMs_t currentTimeMs = currentTimeUs / 1000;
 
-uint8_t telemetryData[18] = {0};            // Stores Hobbywing V4 telemetry data during read
-uint8_t bytesRead = 0;
-uint8_t skipPackets = 0;
+    // KISS ESC Telemetry Protocol
+    escFrameReceived = false;
 
-bool processHWv4TelemetryStream(uint8_t dataByte) 
+    switch (escSensorTriggerState) {
+        case ESC_SENSOR_TRIGGER_STARTUP:
+            // Wait period of time before requesting telemetry (let the system boot first)
+            if (currentTimeMs >= ESC_BOOTTIME) {
+                escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+            }
+
+            break;
+        case ESC_SENSOR_TRIGGER_READY:
+            escTriggerTimestamp = currentTimeMs;
+
+            startEscDataRead(telemetryBuffer, TELEMETRY_FRAME_SIZE);
+            motorDmaOutput_t * const motor = getMotorDmaOutput(escSensorMotor);
+            motor->protocolControl.requestTelemetry = true;
+            escSensorTriggerState = ESC_SENSOR_TRIGGER_PENDING;
+
+            DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, escSensorMotor + 1);
+
+            break;
+        case ESC_SENSOR_TRIGGER_PENDING:
+            if (currentTimeMs < escTriggerTimestamp + ESC_REQUEST_TIMEOUT) {
+                uint8_t state = decodeEscFrame();
+                switch (state) {
+                    case ESC_SENSOR_FRAME_COMPLETE:
+                        selectNextMotor();
+                        escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+
+                        break;
+                    case ESC_SENSOR_FRAME_FAILED:
+                        increaseDataAge();
+
+                        selectNextMotor();
+                        escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+
+                        DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_CRC_ERRORS, ++totalCrcErrorCount);
+                        break;
+                    case ESC_SENSOR_FRAME_PENDING:
+                        break;
+                }
+            } else {
+                // Move on to next ESC, we'll come back to this one
+                increaseDataAge();
+
+                selectNextMotor();
+                escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+
+                DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_TIMEOUTS, ++totalTimeoutCount);
+            }
+
+            break;
+    }
+}
+
+static bool kissDataValid(const escSensorData_t *data)
+{
+    return data->dataAge <= ESC_BATTERY_AGE_MAX;
+}
+
+static void kissInit(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
+        escSensorData[i].dataAge = ESC_DATA_INVALID;
+    }
+}
+#endif
+
+#ifdef USE_ESC_SENSOR_HOBBYWING
+static bool processHWv4TelemetryStream(uint8_t dataByte);
+
+// Receive ISR callback, the Hobbywing V4 stream is framed as it comes in
+static void escSensorHWv4DataReceive(uint16_t c, void *data)
+{
+    UNUSED(data);
+
+    if (processHWv4TelemetryStream((uint8_t)c)) {
+        const uint8_t *frame = hwv4Frames[hwv4WriteFrame];
+        hwv4Frame = frame;
+        hwv4WriteFrame ^= 1;
+
+        // publish the rpm right away, the rest of the frame is decoded by the task
+        escSensorData[0].rpm = ((uint32_t)frame[7] << 16 | (uint16_t)frame[8] << 8 | frame[9]) / 100;
+        escSensorRpmTimeUs[0] = microsISR();
+        escFrameReceived = true;
+    }
+
+    // Increment counter every time a new byte is read over the uart
+    totalTimeoutCount++;
+}
+
+static bool processHWv4TelemetryStream(uint8_t dataByte)
 {
     // Hobbywing V4 ESC Telemetry Protocol Data parser
 
@@ -427,7 +490,7 @@ bool processHWv4TelemetryStream(uint8_t dataByte)
         skipPackets = 11;
     } else if (bytesRead > 0) {
         // Store each portion of what looks to be a valid data packet
-        telemetryData[bytesRead-1] = dataByte;
+        hwv4Frames[hwv4WriteFrame][bytesRead-1] = dataByte;
         bytesRead++;
         if (bytesRead == 19) {
             bytesRead = 0;
@@ -437,191 +500,322 @@ bool processHWv4TelemetryStream(uint8_t dataByte)
     return 0;      // No complete telemetry packet ready yet
 }
 
-float calcVoltHW(uint16_t voltRaw)
+static float calcNtcTempHW(uint16_t tempRaw)
 {
     // Credit to:  https://github.com/dgatf/msrc/
-    return (float) ESCHW4_V_REF * voltRaw / ESCHW4_ADC_RESOLUTION * escSensorConfig()->esc_sensor_hobbywing_voltagedivisor;    
+    const float voltage = tempRaw * (float)ESCHW4_V_REF / (float)ESCHW4_ADC_RESOLUTION;
+    const float ntcR_Rref = (voltage * (float)ESCHW4_NTC_R1 / ((float)ESCHW4_V_REF - voltage)) / (float)ESCHW4_NTC_R_REF;
+    const float temperature = 1.0f / (log_approx(ntcR_Rref) / (float)ESCHW4_NTC_BETA + 1.0f / 298.15f) - 273.15f;
+    if (!(temperature > 0)) {
+        return 0;
+    }
+    return temperature;
 }
 
-float calcTempHW(uint16_t tempRaw)
+static void initHWv4Scales(void)
 {
-    // Credit to:  https://github.com/dgatf/msrc/
-    float voltage = tempRaw * ESCHW4_V_REF / ESCHW4_ADC_RESOLUTION;
-    float ntcR_Rref = (voltage * ESCHW4_NTC_R1 / (ESCHW4_V_REF - voltage)) / ESCHW4_NTC_R_REF;
-    // If log() function needs to be faster, just add code!
-    //  https://github.com/chipaudette/OpenAudio_blog/blob/e3ea36ba069b924be81cf68a7279cb9e767bf16d/2017-02-07%20Faster%20Float%20Functions/SpeedOfFloatFunctions/SpeedOfFloatFunctions.ino#L405
-    //  http://openaudio.blogspot.com/2017/02/faster-log10-and-pow.html
-    float temperature = 1.0 / ((float)log(ntcR_Rref) / ESCHW4_NTC_BETA + 1.0 / 298.15) - 273.15;
-    if (temperature < 0) {
-        return 0;
+    hwv4VoltScale = (float)ESCHW4_V_REF / (float)ESCHW4_ADC_RESOLUTION * escSensorConfig()->esc_sensor_hobbywing_voltagedivisor;
+    hwv4CurrScale = (escSensorConfig()->esc_sensor_hobbywing_currscale / 100.0f) * (float)(ESCHW4_V_REF / (ESCHW4_DIFFAMP_GAIN * ESCHW4_DIFFAMP_SHUNT * ESCHW4_ADC_RESOLUTION));
+    hwv4CurrOffset = escSensorConfig()->esc_sensor_hobbywing_curroffset;
+
+    // NTC curve sampled over the ADC range, interpolated by calcTempHW()
+    for (unsigned i = 0; i < ARRAYLEN(hwv4TempTable); i++) {
+        hwv4TempTable[i] = calcNtcTempHW(MIN(i * HWV4_TEMP_TABLE_STEP, (unsigned)ESCHW4_ADC_RESOLUTION - 1));
     }
-    return temperature;
 }
 
-float calcCurrHW(uint16_t currentRaw)
+static float calcVoltHW(uint16_t voltRaw)
 {
-    // Credit to:  https://github.com/dgatf/msrc/
-    if (currentRaw > escSensorConfig()->esc_sensor_hobbywing_curroffset) {
-        return (float)(currentRaw - escSensorConfig()->esc_sensor_hobbywing_curroffset) * (escSensorConfig()->esc_sensor_hobbywing_currscale / 100.0f) * ESCHW4_V_REF / (ESCHW4_DIFFAMP_GAIN * ESCHW4_DIFFAMP_SHUNT * ESCHW4_ADC_RESOLUTION);
+    return voltRaw * hwv4VoltScale;
+}
+
+static float calcTempHW(uint16_t tempRaw)
+{
+    const unsigned raw = MIN(tempRaw, (unsigned)ESCHW4_ADC_RESOLUTION - 1);
+    const unsigned index = raw / HWV4_TEMP_TABLE_STEP;
+    const float frac = (float)(raw % HWV4_TEMP_TABLE_STEP) / HWV4_TEMP_TABLE_STEP;
+
+    return hwv4TempTable[index] + frac * (hwv4TempTable[index + 1] - hwv4TempTable[index]);
+}
+
+static float calcCurrHW(uint16_t currentRaw)
+{
+    if (currentRaw > hwv4CurrOffset) {
+        return (currentRaw - hwv4CurrOffset) * hwv4CurrScale;
     } else {
         return 0;
     }
 }
 
-void escSensorProcess(timeUs_t currentTimeUs)
+static void hwv4Process(timeUs_t currentTimeUs)
 {
-    // Executed from tasks.c at 100Hz with Low priority
-
-    // Variables for Hobbywing V4 telemetry
     static timeUs_t lastProcessTimeUs = 0;
     static float consumption = 0.0f;
+
+    // Hobbywing V4 ESC Telemetry Protocol
+    //  Only supports motor 0 for now
+    escSensorMotor = 0;
+
+    // Increment data aging so we'll know if we don't get a valid data packet on a ESC sensor read
+    if (escSensorData[escSensorMotor].dataAge < ESC_DATA_INVALID) {
+        escSensorData[escSensorMotor].dataAge++;
+    }
     
-    const timeMs_t currentTimeMs = currentTimeUs / 1000;
+    // the RX callback has framed a telemetry packet
+    if (escFrameReceived) {
+        escFrameReceived = false;
+
+        //  Credit to:  https://github.com/dgatf/msrc/
+
+        // If this evaluated true then we have a potentially valid Telemetry data frame waiting for us.  Process it.
+        // uint32_t packetNumber = (uint32_t)data[0] << 16 | (uint16_t)data[1] << 8 | data[2];
+        // HF3D TODO:  Debug log this data, including packet number?  Might be useful to see if we're getting the right data if we up the telemetry process speed in the tasks scheduler.
+        //uint16_t thr = (uint16_t)hwv4Frame[3] << 8 | hwv4Frame[4]; // 0-1024
+        //uint16_t pwm = (uint16_t)hwv4Frame[5] << 8 | hwv4Frame[6]; // 0-1024
+        // the rpm has already been published by the RX callback
+        const uint8_t *frame = hwv4Frame;
+        float voltage = calcVoltHW((uint16_t)frame[10] << 8 | frame[11]);
+        float current = calcCurrHW((uint16_t)frame[12] << 8 | frame[13]);
+        // Debug log the raw current value to the MOTOR_INDEX field for determining offset calculations
+        DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, (uint16_t)frame[12] << 8 | frame[13]);
+        float tempFET = calcTempHW((uint16_t)frame[14] << 8 | frame[15]);
+        //float tempBEC = calcTempHW((uint16_t)frame[16] << 8 | frame[17]);
+
+        // Now store these values into our telemetry data array... with averaging??
+        //   If we don't do averaging we might as well just throw away all the results except for the last one, lol.
+            // uint8_t dataAge;
+            // int8_t temperature;  // C degrees
+            // int16_t voltage;     // 0.01V
+            // int32_t current;     // 0.01A
+            // int32_t consumption; // mAh
+            // int16_t rpm;         // 100 erpm
+        // RPM: 5594.00 Volt: 13.08 Temp1: 33.72 Temp2: 34.35
+        escSensorData[escSensorMotor].dataAge = 0;
+        escSensorData[escSensorMotor].temperature = tempFET;
+        escSensorData[escSensorMotor].voltage = voltage * 100;
+        escSensorData[escSensorMotor].current = current * 100;
 
-    if (!escSensorPort || !motorIsEnabled()) {
-        // Motors are enabled in init.c as soon as everything else is initialized.
-        return;
-        DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, 5);        
+        // HF3D TODO:  Add a debug_ESC parameter for Hobbywing (Packet #, RPM, FET Temp, BEC Temp)
+        // HF3D TODO:  Hopefully we're bringing ESC Voltage and Current into the logs permanently anyway.... and probably should bring ESC Temp in permanently too.
+        if (escSensorMotor < 4) {
+            DEBUG_SET(DEBUG_ESC_SENSOR_RPM, escSensorMotor, calcEscRpm(escSensorMotor, escSensorData[escSensorMotor].rpm) / 10); // output actual rpm/10 to fit in 16bit signed.
+            DEBUG_SET(DEBUG_ESC_SENSOR_TMP, escSensorMotor, escSensorData[escSensorMotor].temperature);
+        }
+        
+        // Increment counter every time we decode a Hobbywing telemetry packet
+        DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_CRC_ERRORS, ++totalCrcErrorCount);
     }
+
+    // Bytes read over the uart by the RX callback
+    DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_TIMEOUTS, totalTimeoutCount);
+
+    // Log the data age to see how old the data gets between HW telemetry packets
+    DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_DATA_AGE, escSensorData[escSensorMotor].dataAge);
     
-    DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, 0); 
-
-    if ( escSensorConfig()->escSensorProtocol == ESC_SENSOR_PROTOCOL_KISS ) {
-        // KISS ESC Telemetry Protocol
-        switch (escSensorTriggerState) {
-            case ESC_SENSOR_TRIGGER_STARTUP:
-                // Wait period of time before requesting telemetry (let the system boot first)
-                if (currentTimeMs >= ESC_BOOTTIME) {
-                    escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
-                }
+    // Hobbywing just reports the last current reading it had when throttle goes to zero.  That's completely useless, so set it to zero.
+    // HF3D TODO:  Consider reading the actual throttle telemetry from the HW ESC protocol instead of RPM to make this more resistant to error?
+    if (escSensorData[escSensorMotor].rpm < 1) {
+        escSensorData[escSensorMotor].current = 0.0f;
+    }
+    
+    // Accumulate consumption (mAh) as a float since we're updating at 100Hz... even 100A for 10ms is only 0.28 mAh.
+    //  Calculate it using the last valid current reading we received
+    consumption += (currentTimeUs - lastProcessTimeUs) * (float) escSensorData[escSensorMotor].current * 10.0f / (1000000.0f * 3600.0f);
+    lastProcessTimeUs = currentTimeUs;
+    escSensorData[escSensorMotor].consumption = (int32_t) consumption;
+}
 
-                break;
-            case ESC_SENSOR_TRIGGER_READY:
-                escTriggerTimestamp = currentTimeMs;
-
-                startEscDataRead(telemetryBuffer, TELEMETRY_FRAME_SIZE);
-                motorDmaOutput_t * const motor = getMotorDmaOutput(escSensorMotor);
-                motor->protocolControl.requestTelemetry = true;
-                escSensorTriggerState = ESC_SENSOR_TRIGGER_PENDING;
-
-                DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, escSensorMotor + 1);
-
-                break;
-            case ESC_SENSOR_TRIGGER_PENDING:
-                if (currentTimeMs < escTriggerTimestamp + ESC_REQUEST_TIMEOUT) {
-                    uint8_t state = decodeEscFrame();
-                    switch (state) {
-                        case ESC_SENSOR_FRAME_COMPLETE:
-                            selectNextMotor();
-                            escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
-
-                            break;
-                        case ESC_SENSOR_FRAME_FAILED:
-                            increaseDataAge();
-
-                            selectNextMotor();
-                            escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
-
-                            DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_CRC_ERRORS, ++totalCrcErrorCount);
-                            break;
-                        case ESC_SENSOR_FRAME_PENDING:
-                            break;
-                    }
-                } else {
-                    // Move on to next ESC, we'll come back to this one
-                    increaseDataAge();
-
-                    selectNextMotor();
-                    escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
-
-                    DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_TIMEOUTS, ++totalTimeoutCount);
-                }
+// HWV4:  dataAge < 100 while throttle=0  or  dataAge < 11 while motor spinning
+//   Realistically we get these every 40 while throttle=0 and 4 while motor is spinning (rpm>0)
+static bool hwv4DataValid(const escSensorData_t *data)
+{
+    // If last RPM value was > 0 (motor spinning) then we should be receiving telemetry every 50ms
+    // HF3D TODO:  This will break if scheduler is changed to increase polling rate of escSensorProcess task beyond 100Hz.
+    if (data->rpm > 0) {
+        return data->dataAge < 11;
+    }
+    return data->dataAge < 120;
+}
+
+static void hwv4Init(void)
+{
+    initHWv4Scales();
+
+    escSensorData[0].dataAge = ESC_DATA_INVALID;
+}
+#endif
+
+#ifdef USE_ESC_SENSOR_DSHOT
+/*
+ * Extended DShot telemetry
+ *
+ * The ESC multiplexes temperature, voltage, current and status frames into the
+ * bidirectional DShot eRPM stream once it has been sent
+ * DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE. The frames are decoded with the eRPM by the
+ * DShot driver, this only converts them for every motor, no UART is used.
+ */
+#define EDT_DATA_AGE_MAX 200        // task cycles, the ESCs send each frame type at a few Hz
+
+static bool edtRequested = false;
+static uint8_t edtFrameCount[MAX_SUPPORTED_MOTORS];
 
-                break;
+static void edtProcess(timeUs_t currentTimeUs)
+{
+    static timeUs_t lastProcessTimeUs = 0;
+    static float consumption[MAX_SUPPORTED_MOTORS];
+
+    if (!edtRequested && dshotCommandsAreEnabled() && !ARMING_FLAG(ARMED)) {
+        dshotCommandWrite(ALL_MOTORS, getMotorCount(), DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE, false);
+        edtRequested = true;
+    }
+
+    const timeDelta_t deltaUs = cmpTimeUs(currentTimeUs, lastProcessTimeUs);
+    lastProcessTimeUs = currentTimeUs;
+
+    for (int i = 0; i < getMotorCount(); i++) {
+        const dshotTelemetryMotorState_t *state = &dshotTelemetryState.motorState[i];
+
+        if (state->edtFrameCount != edtFrameCount[i]) {
+            edtFrameCount[i] = state->edtFrameCount;
+            escSensorData[i].dataAge = 0;
+            escSensorData[i].temperature = MIN(state->edtTemperature, INT8_MAX);
+            escSensorData[i].voltage = state->edtVoltage * 25;
+            escSensorData[i].current = state->edtCurrent * 100;
+
+            combinedDataNeedsUpdate = true;
+        } else if (escSensorData[i].dataAge < ESC_DATA_INVALID) {
+            escSensorData[i].dataAge++;
         }
-        
-    } else if ( escSensorConfig()->escSensorProtocol == ESC_SENSOR_PROTOCOL_HOBBYWINGV4 ) {
-        // Hobbywing V4 ESC Telemetry Protocol
-        //  Only supports motor 0 for now
-        escSensorMotor = 0;
 
-        // Increment data aging so we'll know if we don't get a valid data packet on a ESC sensor read
-        escSensorData[escSensorMotor].dataAge++;
-        
-        // check for any available ESC telemetry bytes in the buffer
-        while (serialRxBytesWaiting(escSensorPort)) {
-
-            // and process them one by one to build a telemetryData packet
-            if (processHWv4TelemetryStream(serialRead(escSensorPort))) {
-
-                //  Credit to:  https://github.com/dgatf/msrc/
-
-                // If this evaluated true then we have a potentially valid Telemetry data frame waiting for us.  Process it.
-                // uint32_t packetNumber = (uint32_t)data[0] << 16 | (uint16_t)data[1] << 8 | data[2];
-                // HF3D TODO:  Debug log this data, including packet number?  Might be useful to see if we're getting the right data if we up the telemetry process speed in the tasks scheduler.
-                //uint16_t thr = (uint16_t)telemetryData[3] << 8 | telemetryData[4]; // 0-1024
-                //uint16_t pwm = (uint16_t)telemetryData[5] << 8 | telemetryData[6]; // 0-1024
-                float rpm = (uint32_t)telemetryData[7] << 16 | (uint16_t)telemetryData[8] << 8 | telemetryData[9];
-                float voltage = calcVoltHW((uint16_t)telemetryData[10] << 8 | telemetryData[11]);
-                float current = calcCurrHW((uint16_t)telemetryData[12] << 8 | telemetryData[13]);
-                // Debug log the raw current value to the MOTOR_INDEX field for determining offset calculations
-                DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, (uint16_t)telemetryData[12] << 8 | telemetryData[13]);
-                float tempFET = calcTempHW((uint16_t)telemetryData[14] << 8 | telemetryData[15]);
-                //float tempBEC = calcTempHW((uint16_t)telemetryData[16] << 8 | telemetryData[17]);
-
-                // Now store these values into our telemetry data array... with averaging??
-                //   If we don't do averaging we might as well just throw away all the results except for the last one, lol.
-                    // uint8_t dataAge;
-                    // int8_t temperature;  // C degrees
-                    // int16_t voltage;     // 0.01V
-                    // int32_t current;     // 0.01A
-                    // int32_t consumption; // mAh
-                    // int16_t rpm;         // 100 erpm
-                // RPM: 5594.00 Volt: 13.08 Temp1: 33.72 Temp2: 34.35
-                escSensorData[escSensorMotor].dataAge = 0;
-                escSensorData[escSensorMotor].temperature = tempFET;
-                escSensorData[escSensorMotor].voltage = voltage * 100;
-                escSensorData[escSensorMotor].current = current * 100;
-                escSensorData[escSensorMotor].rpm = rpm / 100;
-
-                // HF3D TODO:  Add a debug_ESC parameter for Hobbywing (Packet #, RPM, FET Temp, BEC Temp)
-                // HF3D TODO:  Hopefully we're bringing ESC Voltage and Current into the logs permanently anyway.... and probably should bring ESC Temp in permanently too.
-                if (escSensorMotor < 4) {
-                    DEBUG_SET(DEBUG_ESC_SENSOR_RPM, escSensorMotor, calcEscRpm(escSensorMotor, escSensorData[escSensorMotor].rpm) / 10); // output actual rpm/10 to fit in 16bit signed.
-                    DEBUG_SET(DEBUG_ESC_SENSOR_TMP, escSensorMotor, escSensorData[escSensorMotor].temperature);
-                }
-                
-                // Increment counter every time we decode a Hobbywing telemetry packet
-                DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_CRC_ERRORS, ++totalCrcErrorCount);
+        escSensorData[i].rpm = getDshotTelemetry(i);
+        escSensorRpmTimeUs[i] = currentTimeUs;
 
-            }
-            
-            // Increment counter every time a new byte is read over the uart
-            DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_TIMEOUTS, ++totalTimeoutCount);
-            
+        consumption[i] += deltaUs * (float)escSensorData[i].current * 10.0f / (1000000.0f * 3600.0f);
+        escSensorData[i].consumption = (int32_t)consumption[i];
+
+        if (i < 4) {
+            DEBUG_SET(DEBUG_ESC_SENSOR_TMP, i, escSensorData[i].temperature);
         }
+    }
 
-        // Log the data age to see how old the data gets between HW telemetry packets
-        DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_DATA_AGE, escSensorData[escSensorMotor].dataAge);
-        
-        // Hobbywing just reports the last current reading it had when throttle goes to zero.  That's completely useless, so set it to zero.
-        // HF3D TODO:  Consider reading the actual throttle telemetry from the HW ESC protocol instead of RPM to make this more resistant to error?
-        if (escSensorData[escSensorMotor].rpm < 1) {
-            escSensorData[escSensorMotor].current = 0.0f;
+    DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_DATA_AGE, escSensorData[0].dataAge);
+}
+
+static bool edtDataValid(const escSensorData_t *data)
+{
+    return data->dataAge < EDT_DATA_AGE_MAX;
+}
+
+static void edtInit(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        escSensorData[i].dataAge = ESC_DATA_INVALID;
+    }
+}
+#endif
+
+static const escSensorProtocol_t escSensorProtocols[] = {
+#ifdef USE_ESC_SENSOR_KISS
+    [ESC_SENSOR_PROTOCOL_KISS] = {
+        .baudrate = ESC_SENSOR_BAUDRATE,
+        .options = SERIAL_NOT_INVERTED,
+        .dataReceive = escSensorDataReceive,
+        .init = kissInit,
+        .process = kissProcess,
+        .dataValid = kissDataValid,
+        .singleStream = false,
+    },
+#endif
+#ifdef USE_ESC_SENSOR_HOBBYWING
+    /*
+     * Hobbywing V4 protocol
+     *
+     * 19200 baud
+     * not inverted
+     * no parity
+     * 8 Bit
+     * 1 Stop Bit
+     * Big Endian
+     * RX Direction
+     */
+    [ESC_SENSOR_PROTOCOL_HOBBYWINGV4] = {
+        .baudrate = 19200,
+        .options = SERIAL_STOPBITS_1 | SERIAL_PARITY_NO | SERIAL_NOT_INVERTED,
+        .dataReceive = escSensorHWv4DataReceive,
+        .init = hwv4Init,
+        .process = hwv4Process,
+        .dataValid = hwv4DataValid,
+        .singleStream = true,
+    },
+#endif
+#ifdef USE_ESC_SENSOR_DSHOT
+    [ESC_SENSOR_PROTOCOL_DSHOT] = {
+        .init = edtInit,
+        .process = edtProcess,
+        .dataValid = edtDataValid,
+        .singleStream = false,
+    },
+#endif
+};
+
+bool escSensorInit(void)
+{
+    const uint8_t protocolIndex = escSensorConfig()->escSensorProtocol;
+    if (protocolIndex >= ARRAYLEN(escSensorProtocols) || !escSensorProtocols[protocolIndex].process) {
+        // protocol not compiled in
+        return false;
+    }
+
+#ifdef USE_ESC_SENSOR_DSHOT
+    if (protocolIndex == ESC_SENSOR_PROTOCOL_DSHOT) {
+        if (!useDshotTelemetry) {
+            return false;
         }
-        
-        // Accumulate consumption (mAh) as a float since we're updating at 100Hz... even 100A for 10ms is only 0.28 mAh.
-        //  Calculate it using the last valid current reading we received
-        consumption += (currentTimeUs - lastProcessTimeUs) * (float) escSensorData[escSensorMotor].current * 10.0f / (1000000.0f * 3600.0f);
-        lastProcessTimeUs = currentTimeUs;
-        escSensorData[escSensorMotor].consumption = (int32_t) consumption;
-        
-    }  // End of HobbyWing V4 Telemetry
+        escSensorProtocol = &escSensorProtocols[protocolIndex];
+        escSensorProtocol->init();
+
+        return true;
+    }
+#endif
+
+    const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_ESC_SENSOR);
+    if (!portConfig) {
+        return false;
+    }
+    escSensorProtocol = &escSensorProtocols[protocolIndex];
+
+    // leave halfDuplex = 0 (off) unless you're connecting up to a UART TX pin
+    const portOptions_e options = escSensorProtocol->options | (escSensorConfig()->halfDuplex ? SERIAL_BIDIR : 0);
+
+    escSensorProtocol->init();
+
+    escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, escSensorProtocol->dataReceive, NULL, escSensorProtocol->baudrate, MODE_RX, options);
+    if (!escSensorPort) {
+        escSensorProtocol = NULL;
+    }
+
+    return escSensorPort != NULL;
+}
+
+void escSensorProcess(timeUs_t currentTimeUs)
+{
+    // Executed from tasks.c for every frame received, and at the task rate without frames
+
+    if (!escSensorProtocol || !motorIsEnabled()) {
+        // Motors are enabled in init.c as soon as everything else is initialized.
+        return;
+    }
+
+    DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_MOTOR_INDEX, 0);
+
+    escSensorProtocol->process(currentTimeUs);
 
     // Check every motor for invalid dataAge to see if we need to zero out our values
     //   Better to do this here at slower loop rate than in the getRPM function that runs at rpmFilter rate!
     for (int i = 0; i < getMotorCount(); i++) {
-        if (!isEscSensorValid(i)) {
+        const bool valid = (!escSensorProtocol->singleStream || i == 0) && escSensorProtocol->dataValid(&escSensorData[i]);
+        escSensorDataValid[i] = valid;
+        if (!valid) {
             // Reset all the data
             escSensorData[i].voltage = 0;
             escSensorData[i].current = 0;
@@ -631,10 +825,11 @@ void escSensorProcess(timeUs_t currentTimeUs)
             combinedEscSensorData.current = 0;
             combinedEscSensorData.consumption = 0;
             combinedEscSensorData.rpm = 0;
-        }        
+        }
     }
 }
 
+
 int calcEscRpm(uint8_t motorNumber, int erpm)
 {
     int div = motorConfig()->motorPoleCount[motorNumber] / 2;
@@ -37,6 +37,7 @@
 typedef enum {
     ESC_SENSOR_PROTOCOL_KISS = 0,
     ESC_SENSOR_PROTOCOL_HOBBYWINGV4,
+    ESC_SENSOR_PROTOCOL_DSHOT,
 } escSensorProtocols_e;
 
 typedef struct escSensorConfig_s {
@@ -61,8 +62,11 @@ typedef struct {
 
 bool escSensorInit(void);
 void escSensorProcess(timeUs_t currentTime);
+bool escSensorFrameReceived(void);
 bool isEscSensorActive(void);
+bool isEscSensorValid(uint8_t motorNumber);
 uint16_t getEscSensorRPM(uint8_t motorNumber);
+timeUs_t getEscSensorRpmTimeUs(uint8_t motorNumber);
 
 escSensorData_t *getEscSensorData(uint8_t motorNumber);
 
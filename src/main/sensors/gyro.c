@@ -76,10 +76,12 @@
 #include "io/beeper.h"
 #include "io/statusindicator.h"
 
+#include "scheduler/profile.h"
 #include "scheduler/scheduler.h"
 
 #include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_bias.h"
 #include "sensors/sensors.h"
 
 #if ((FLASH_SIZE > 128) && (defined(USE_GYRO_SPI_ICM20601) || defined(USE_GYRO_SPI_ICM20689) || defined(USE_GYRO_SPI_MPU6500)))
@@ -115,17 +117,64 @@ static bool gyroHasOverflowProtection = true;
 static FAST_RAM_ZERO_INIT bool useDualGyroDebugging;
 static FAST_RAM_ZERO_INIT flight_dynamics_index_t gyroDebugAxis;
 
+// The calibration collects windows of samples and drops the ones the model moved in,
+// it completes as soon as the mean of the still samples is known well enough.
+#define GYRO_CALIBRATION_WINDOW_US      100000
+#define GYRO_CALIBRATION_MIN_WINDOWS    3
+#define GYRO_CALIBRATION_MAX_ERROR_DPS  0.05f   // standard error of the offsets
+
 typedef struct gyroCalibration_s {
-    float sum[XYZ_AXIS_COUNT];
-    stdev_t var[XYZ_AXIS_COUNT];
-    int32_t cyclesRemaining;
+    stdev_t var[XYZ_AXIS_COUNT];        // accepted windows
+    stdev_t pending[XYZ_AXIS_COUNT];    // last still window, accepted once the next one is still as well
+    stdev_t window[XYZ_AXIS_COUNT];     // current window
+    int32_t cyclesRemaining;            // the calibration ends at the latest when these run out
 } gyroCalibration_t;
 
 static bool firstArmingCalibrationWasStarted = false;
 
+#ifdef USE_GYRO_TEMP_COMP
+#define GYRO_TEMP_COMP_WINDOW           20      // task runs per ground learning window, 2s
+
+typedef struct gyroTempComp_s {
+    float correction[XYZ_AXIS_COUNT];   // measured zero less the table value, the offset of this power cycle
+    stdev_t window[XYZ_AXIS_COUNT];     // raw samples taken on the ground
+    bool calibrated;                    // a calibration completed, its zero is learned on the next task run
+    bool restore;                       // end the boot calibration with the zero from the table
+} gyroTempComp_t;
+#endif
+
+#ifdef USE_MULTI_GYRO
+// Per-sensor health used by the FUSED mode. Noise is tracked on the sample to sample
+// difference, which is dominated by sensor noise and vibration rather than by the
+// motion of the craft that both sensors see.
+typedef struct gyroFusionState_s {
+    float prevRate[XYZ_AXIS_COUNT];
+    pt1Filter_t noiseVariance[XYZ_AXIS_COUNT];
+    timeUs_t clipTimeUs;
+    bool clipped;
+} gyroFusionState_t;
+#endif
+
 typedef struct gyroSensor_s {
     gyroDev_t gyroDev;
     gyroCalibration_t calibration;
+    // raw sample to body rate: alignment and scale in one matrix, zero offset already rotated
+    float transform[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+    float transformOffset[XYZ_AXIS_COUNT];
+#ifdef USE_GYRO_FIXED_POINT
+    // integer version of the transform, used when the alignment is a signed axis permutation
+    bool fixedPoint;
+    uint8_t fixedAxis[XYZ_AXIS_COUNT];
+    int8_t fixedSign[XYZ_AXIS_COUNT];
+    int32_t fixedOffset[XYZ_AXIS_COUNT];        // aligned zero offset, GYRO_FIXED_POINT_SHIFT fraction bits
+    float fixedScale;
+#endif
+#ifdef USE_MULTI_GYRO
+    gyroFusionState_t fusion;
+#endif
+#ifdef USE_GYRO_TEMP_COMP
+    gyroTempComp_t tempComp;
+#endif
 } gyroSensor_t;
 
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT gyroSensor_t gyroSensor1;
@@ -157,7 +206,21 @@ static void gyroInitLowpassFilterLpf(int slot, int type, uint16_t lpfHz);
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_FN(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 7);
+#ifdef USE_GYRO_DATA_ANALYSE
+STATIC_ASSERT(DYN_NOTCH_COUNT_MAX <= FILTER_CHAIN_SIZE, dyn_notch_chain_too_small);
+#endif
+
+#ifdef USE_GYRO_FIXED_POINT
+#define GYRO_FIXED_POINT_SHIFT 8                // 1/256 LSB zero offset resolution, int16 samples stay below 2^24
+#endif
+
+#ifdef USE_MULTI_GYRO
+#define GYRO_FUSION_NOISE_CUTOFF_HZ     2       // noise variance averaging
+#define GYRO_FUSION_VARIANCE_MIN        1e-3f   // (deg/s)^2, limits the weight of a very quiet sensor
+#define GYRO_FUSION_CLIP_HOLD_US        20000   // a clipped sensor stays excluded for this long
+#endif
+
+PG_REGISTER_WITH_RESET_FN(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 13);
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
@@ -198,6 +261,14 @@ void pgResetFn_gyroConfig(gyroConfig_t *gyroConfig)
     gyroConfig->dyn_notch_q = 120;
     gyroConfig->dyn_notch_min_hz = 150;
     gyroConfig->gyro_filter_debug_axis = FD_ROLL;
+#ifdef USE_GYRO_DATA_ANALYSE
+    gyroConfig->dyn_notch_window = DYN_NOTCH_WINDOW_32;
+    gyroConfig->dyn_notch_count = 1;
+#endif
+    gyroConfig->gyro_fifo_decimation = 1;
+    gyroConfig->gyro_isr_read = false;
+    gyroConfig->gyro_isr_pid = false;
+    gyroConfig->gyro_temp_comp = GYRO_TEMP_COMP_OFF;
 }
 
 #ifdef USE_MULTI_GYRO
@@ -390,6 +461,61 @@ static void gyroPreInitSensor(const gyroDeviceConfig_t *config)
 #endif
 }
 
+// Refreshes the zero offset part of the transform only, the alignment is left alone
+static void gyroSensorUpdateOffset(gyroSensor_t *gyroSensor)
+{
+    const gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->transformOffset[axis] = gyroSensor->transform[axis][X] * gyroDev->gyroZero[X]
+            + gyroSensor->transform[axis][Y] * gyroDev->gyroZero[Y]
+            + gyroSensor->transform[axis][Z] * gyroDev->gyroZero[Z];
+#ifdef USE_GYRO_FIXED_POINT
+        const int input = gyroSensor->fixedAxis[axis];
+        gyroSensor->fixedOffset[axis] = lrintf(gyroSensor->fixedSign[axis] * gyroDev->gyroZero[input] * (1 << GYRO_FIXED_POINT_SHIFT));
+#endif
+    }
+}
+
+// Folds the alignment, the scale and the zero offset into one transform, so the
+// per-sample work is a single multiply-add block per axis
+static void gyroSensorUpdateTransform(gyroSensor_t *gyroSensor)
+{
+    const gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        // rotationMatrix uses the applyRotation() layout, m[input][output]
+        gyroSensor->transform[axis][X] = gyroDev->rotationMatrix.m[X][axis] * gyroDev->scale;
+        gyroSensor->transform[axis][Y] = gyroDev->rotationMatrix.m[Y][axis] * gyroDev->scale;
+        gyroSensor->transform[axis][Z] = gyroDev->rotationMatrix.m[Z][axis] * gyroDev->scale;
+    }
+
+#ifdef USE_GYRO_FIXED_POINT
+    // standard alignments without board alignment only pick and negate axes
+    gyroSensor->fixedPoint = true;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        int nonZero = 0;
+        for (int input = 0; input < XYZ_AXIS_COUNT; input++) {
+            const float m = gyroDev->rotationMatrix.m[input][axis];
+            if (m == 1.0f || m == -1.0f) {
+                gyroSensor->fixedAxis[axis] = input;
+                gyroSensor->fixedSign[axis] = (m > 0) ? 1 : -1;
+                nonZero++;
+            } else if (m != 0.0f) {
+                nonZero = 2;
+            }
+        }
+        if (nonZero != 1) {
+            gyroSensor->fixedPoint = false;
+            break;
+        }
+    }
+    gyroSensor->fixedScale = gyroDev->scale / (1 << GYRO_FIXED_POINT_SHIFT);
+#endif
+
+    gyroSensorUpdateOffset(gyroSensor);
+}
+
 static bool gyroDetectSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t *config)
 {
 #if defined(USE_GYRO_MPU6050) || defined(USE_GYRO_MPU3050) || defined(USE_GYRO_MPU6500) || defined(USE_GYRO_SPI_MPU6500) || defined(USE_GYRO_SPI_MPU6000) \
@@ -418,14 +544,43 @@ static void gyroInitSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t *c
 {
     gyroSensor->gyroDev.gyro_high_fsr = gyroConfig()->gyro_high_fsr;
     gyroSensor->gyroDev.gyroAlign = config->alignment;
-    buildRotationMatrixFromAlignment(&config->customAlignment, &gyroSensor->gyroDev.rotationMatrix);
     gyroSensor->gyroDev.mpuIntExtiTag = config->extiTag;
 
     // Must set gyro targetLooptime before gyroDev.init and initialisation of filters
     gyro.targetLooptime = gyroSetSampleRate(&gyroSensor->gyroDev, gyroConfig()->gyro_hardware_lpf, gyroConfig()->gyro_sync_denom);
+#ifdef USE_GYRO_FIFO
+    // in FIFO mode the loop runs at the decimated rate, the sensor keeps sampling at the full rate
+    gyroSensor->gyroDev.fifoDecimation = 1;
+    if (gyroSensor->gyroDev.fifoSupported && gyroConfig()->gyro_fifo_decimation > 1) {
+        gyroSensor->gyroDev.fifoDecimation = MIN(gyroConfig()->gyro_fifo_decimation, GYRO_FIFO_DECIMATION_MAX);
+        gyro.targetLooptime *= gyroSensor->gyroDev.fifoDecimation;
+    }
+#endif
     gyroSensor->gyroDev.hardware_lpf = gyroConfig()->gyro_hardware_lpf;
     gyroSensor->gyroDev.initFn(&gyroSensor->gyroDev);
 
+    buildSensorAlignmentMatrix(&gyroSensor->gyroDev.rotationMatrix, gyroSensor->gyroDev.gyroAlign, &config->customAlignment);
+    gyroSensorUpdateTransform(gyroSensor);
+
+#ifdef USE_GYRO_ISR_READ
+    if (gyroConfig()->gyro_isr_read) {
+        mpuGyroIsrReadInit(&gyroSensor->gyroDev);
+    }
+#endif
+
+#ifdef USE_MULTI_GYRO
+    memset(&gyroSensor->fusion, 0, sizeof(gyroSensor->fusion));
+    const float noiseGain = pt1FilterGain(GYRO_FUSION_NOISE_CUTOFF_HZ, gyro.targetLooptime * 1e-6f);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pt1FilterInit(&gyroSensor->fusion.noiseVariance[axis], noiseGain);
+    }
+#endif
+
+#ifdef USE_GYRO_TEMP_COMP
+    memset(&gyroSensor->tempComp, 0, sizeof(gyroSensor->tempComp));
+    gyroSensor->tempComp.restore = gyroConfig()->gyro_temp_comp == GYRO_TEMP_COMP_SKIP_CALIBRATION;
+#endif
+
     // As new gyros are supported, be sure to add them below based on whether they are subject to the overflow/inversion bug
     // Any gyro not explicitly defined will default to not having built-in overflow protection as a safe alternative.
     switch (gyroSensor->gyroDev.gyroHardware) {
@@ -498,6 +653,22 @@ bool gyroInit(void)
         useDualGyroDebugging = true;
         break;
     }
+#ifdef USE_DEBUG_CHANNELS
+    // the debug channels may log the filter chain modes as well
+    static const uint8_t filterDebugModes[] = {
+        DEBUG_FFT, DEBUG_FFT_FREQ, DEBUG_GYRO_RAW, DEBUG_GYRO_SCALED, DEBUG_GYRO_FILTERED, DEBUG_DYN_LPF,
+    };
+    for (unsigned i = 0; i < ARRAYLEN(filterDebugModes) && gyroDebugMode == DEBUG_NONE; i++) {
+        if (debugChannelModeActive[filterDebugModes[i]]) {
+            gyroDebugMode = filterDebugModes[i];
+        }
+    }
+    useDualGyroDebugging = useDualGyroDebugging || debugChannelModeActive[DEBUG_DUAL_GYRO_DIFF]
+        || debugChannelModeActive[DEBUG_DUAL_GYRO_RAW] || debugChannelModeActive[DEBUG_DUAL_GYRO_SCALED];
+#endif
+    if (DEBUG_MODE_EXCLUDED(gyroDebugMode)) {
+        gyroDebugMode = DEBUG_NONE;
+    }
     firstArmingCalibrationWasStarted = false;
 
     gyroDetectionFlags = NO_GYROS_DETECTED;
@@ -520,7 +691,7 @@ bool gyroInit(void)
     }
 
 #if defined(USE_MULTI_GYRO)
-    if ((gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH && !((gyroDetectionFlags & DETECTED_BOTH_GYROS) == DETECTED_BOTH_GYROS))
+    if (((gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) && !((gyroDetectionFlags & DETECTED_BOTH_GYROS) == DETECTED_BOTH_GYROS))
         || (gyroToUse == GYRO_CONFIG_USE_GYRO_1 && !(gyroDetectionFlags & DETECTED_GYRO_1))
         || (gyroToUse == GYRO_CONFIG_USE_GYRO_2 && !(gyroDetectionFlags & DETECTED_GYRO_2))) {
         if (gyroDetectionFlags & DETECTED_GYRO_1) {
@@ -535,20 +706,20 @@ bool gyroInit(void)
     // Only allow using both gyros simultaneously if they are the same hardware type.
     if (((gyroDetectionFlags & DETECTED_BOTH_GYROS) == DETECTED_BOTH_GYROS) && gyroSensor1.gyroDev.gyroHardware == gyroSensor2.gyroDev.gyroHardware) {
         gyroDetectionFlags |= DETECTED_DUAL_GYROS;
-    } else if (gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
-        // If the user selected "BOTH" and they are not the same type, then reset to using only the first gyro.
+    } else if (gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
+        // If the user selected "BOTH" or "FUSED" and they are not the same type, then reset to using only the first gyro.
         gyroToUse = GYRO_CONFIG_USE_GYRO_1;
         gyroConfigMutable()->gyro_to_use = gyroToUse;
     }
 
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
         gyroInitSensor(&gyroSensor2, gyroDeviceConfig(1));
         gyroHasOverflowProtection =  gyroHasOverflowProtection && gyroSensor2.gyroDev.gyroHasOverflowProtection;
         detectedSensors[SENSOR_INDEX_GYRO] = gyroSensor2.gyroDev.gyroHardware;
     }
 #endif
 
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
         gyroInitSensor(&gyroSensor1, gyroDeviceConfig(0));
         gyroHasOverflowProtection =  gyroHasOverflowProtection && gyroSensor1.gyroDev.gyroHasOverflowProtection;
         detectedSensors[SENSOR_INDEX_GYRO] = gyroSensor1.gyroDev.gyroHardware;
@@ -576,10 +747,43 @@ gyroDetectionFlags_t getGyroDetectionFlags(void)
     return gyroDetectionFlags;
 }
 
+#ifdef USE_GYRO_ISR_PID
+// Hand the gyro loop to the data ready interrupt of the active gyro, taskFn runs once every
+// gyro.targetLooptime. Fails if that gyro is not read from its interrupt.
+bool gyroSetIsrTask(void (*taskFn)(timeUs_t currentTimeUs))
+{
+    gyroDev_t *gyroDev = &ACTIVE_GYRO->gyroDev;
+    if (!gyroDev->isrRead) {
+        return false;
+    }
+
+    uint8_t denom = gyroConfig()->gyro_sync_denom;
+#ifdef USE_GYRO_FIFO
+    denom *= gyroDev->fifoDecimation;
+#endif
+    gyroDev->isrTaskDenom = MAX(denom, 1);
+    gyroDev->isrTaskCount = 0;
+
+    // set last, the interrupt may fire at any time from here
+    gyroDev->isrTaskFn = taskFn;
+
+    return true;
+}
+#endif
+
+#ifdef USE_GYRO_ACC_BURST
+// Let the reads of the active gyro fetch the acc data, once every accSamplingInterval. Fails if the acc
+// is not on the same chip or the gyro driver can't read both in one transaction.
+bool gyroSetAccBurst(accDev_t *accDev, timeDelta_t accSamplingInterval)
+{
+    const int denom = constrain(accSamplingInterval / gyro.targetLooptime, 1, UINT8_MAX);
+    return mpuAccBurstReadInit(accDev, &ACTIVE_GYRO->gyroDev, denom);
+}
+#endif
+
 #ifdef USE_DYN_LPF
 static FAST_RAM uint8_t dynLpfFilter = DYN_LPF_NONE;
-static FAST_RAM_ZERO_INIT uint16_t dynLpfMin;
-static FAST_RAM_ZERO_INIT uint16_t dynLpfMax;
+static uint16_t dynLpfCutoff[DYN_LPF_STEPS + 1];
 
 static void dynLpfFilterInit()
 {
@@ -598,24 +802,23 @@ static void dynLpfFilterInit()
     } else {
         dynLpfFilter = DYN_LPF_NONE;
     }
-    dynLpfMin = gyroConfig()->dyn_lpf_gyro_min_hz;
-    dynLpfMax = gyroConfig()->dyn_lpf_gyro_max_hz;
+
+    for (int step = 0; step <= DYN_LPF_STEPS; step++) {
+        dynLpfCutoff[step] = MAX(step * gyroConfig()->dyn_lpf_gyro_max_hz / DYN_LPF_STEPS, gyroConfig()->dyn_lpf_gyro_min_hz);
+    }
 }
 #endif
 
 void gyroInitLowpassFilterLpf(int slot, int type, uint16_t lpfHz)
 {
-    filterApplyFnPtr *lowpassFilterApplyFn;
     gyroLowpassFilter_t *lowpassFilter = NULL;
 
     switch (slot) {
     case FILTER_LOWPASS:
-        lowpassFilterApplyFn = &gyro.lowpassFilterApplyFn;
         lowpassFilter = gyro.lowpassFilter;
         break;
 
     case FILTER_LOWPASS2:
-        lowpassFilterApplyFn = &gyro.lowpass2FilterApplyFn;
         lowpassFilter = gyro.lowpass2Filter;
         break;
 
@@ -630,24 +833,20 @@ void gyroInitLowpassFilterLpf(int slot, int type, uint16_t lpfHz)
     // Gain could be calculated a little later as it is specific to the pt1/bqrcf2/fkf branches
     const float gain = pt1FilterGain(lpfHz, gyroDt);
 
-    // Dereference the pointer to null before checking valid cutoff and filter
-    // type. It will be overridden for positive cases.
-    *lowpassFilterApplyFn = nullFilterApply;
-
     // If lowpass cutoff has been specified and is less than the Nyquist frequency
     if (lpfHz && lpfHz <= gyroFrequencyNyquist) {
         switch (type) {
         case FILTER_PT1:
-            *lowpassFilterApplyFn = (filterApplyFnPtr) pt1FilterApply;
+            filterChainAdd(&gyro.filterChain, FILTER_STAGE_PT1, lowpassFilter, sizeof(gyroLowpassFilter_t));
             for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
                 pt1FilterInit(&lowpassFilter[axis].pt1FilterState, gain);
             }
             break;
         case FILTER_BIQUAD:
 #ifdef USE_DYN_LPF
-            *lowpassFilterApplyFn = (filterApplyFnPtr) biquadFilterApplyDF1;
+            filterChainAdd(&gyro.filterChain, FILTER_STAGE_BIQUAD_DF1, lowpassFilter, sizeof(gyroLowpassFilter_t));
 #else
-            *lowpassFilterApplyFn = (filterApplyFnPtr) biquadFilterApply;
+            filterChainAdd(&gyro.filterChain, FILTER_STAGE_BIQUAD, lowpassFilter, sizeof(gyroLowpassFilter_t));
 #endif
             for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
                 biquadFilterInitLPF(&lowpassFilter[axis].biquadFilterState, lpfHz, gyro.targetLooptime);
@@ -682,12 +881,10 @@ void gyroInitSlewLimiter(gyroSensor_t *gyroSensor) {
 
 static void gyroInitFilterNotch1(uint16_t notchHz, uint16_t notchCutoffHz)
 {
-    gyro.notchFilter1ApplyFn = nullFilterApply;
-
     notchHz = calculateNyquistAdjustedNotchHz(notchHz, notchCutoffHz);
 
     if (notchHz != 0 && notchCutoffHz != 0) {
-        gyro.notchFilter1ApplyFn = (filterApplyFnPtr)biquadFilterApply;
+        filterChainAdd(&gyro.filterChain, FILTER_STAGE_BIQUAD, gyro.notchFilter1, sizeof(biquadFilter_t));
         const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             biquadFilterInit(&gyro.notchFilter1[axis], notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
@@ -697,12 +894,10 @@ static void gyroInitFilterNotch1(uint16_t notchHz, uint16_t notchCutoffHz)
 
 static void gyroInitFilterNotch2(uint16_t notchHz, uint16_t notchCutoffHz)
 {
-    gyro.notchFilter2ApplyFn = nullFilterApply;
-
     notchHz = calculateNyquistAdjustedNotchHz(notchHz, notchCutoffHz);
 
     if (notchHz != 0 && notchCutoffHz != 0) {
-        gyro.notchFilter2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
+        filterChainAdd(&gyro.filterChain, FILTER_STAGE_BIQUAD, gyro.notchFilter2, sizeof(biquadFilter_t));
         const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             biquadFilterInit(&gyro.notchFilter2[axis], notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
@@ -718,18 +913,17 @@ static bool isDynamicFilterActive(void)
 
 static void gyroInitFilterDynamicNotch()
 {
-    gyro.notchFilterDynApplyFn = nullFilterApply;
-    gyro.notchFilterDynApplyFn2 = nullFilterApply;
+    gyro.notchFilterDynChain.stageCount = 0;
 
     if (isDynamicFilterActive()) {
-        gyro.notchFilterDynApplyFn = (filterApplyFnPtr)biquadFilterApplyDF1; // must be this function, not DF2
-        if(gyroConfig()->dyn_notch_width_percent != 0) {
-            gyro.notchFilterDynApplyFn2 = (filterApplyFnPtr)biquadFilterApplyDF1; // must be this function, not DF2
-        }
         const float notchQ = filterGetNotchQ(DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, DYNAMIC_NOTCH_DEFAULT_CUTOFF_HZ); // any defaults OK here
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyro.notchFilterDyn[axis], DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, gyro.targetLooptime, notchQ, FILTER_NOTCH);
-            biquadFilterInit(&gyro.notchFilterDyn2[axis], DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+        const int notchCount = gyroDataAnalyseNotchCount();
+        for (int notch = 0; notch < notchCount; notch++) {
+            // must be DF1, not DF2
+            filterChainAdd(&gyro.notchFilterDynChain, FILTER_STAGE_BIQUAD_DF1, gyro.notchFilterDyn[notch], sizeof(biquadFilter_t));
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                biquadFilterInit(&gyro.notchFilterDyn[notch][axis], DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+            }
         }
     }
 }
@@ -754,6 +948,12 @@ void gyroInitFilters(void)
     }
 #endif
 
+    // Stages are applied in the order they are added to the chain
+    gyro.filterChain.stageCount = 0;
+
+    gyroInitFilterNotch1(gyroConfig()->gyro_soft_notch_hz_1, gyroConfig()->gyro_soft_notch_cutoff_1);
+    gyroInitFilterNotch2(gyroConfig()->gyro_soft_notch_hz_2, gyroConfig()->gyro_soft_notch_cutoff_2);
+
     gyroInitLowpassFilterLpf(
       FILTER_LOWPASS,
       gyroConfig()->gyro_lowpass_type,
@@ -765,9 +965,6 @@ void gyroInitFilters(void)
       gyroConfig()->gyro_lowpass2_type,
       gyroConfig()->gyro_lowpass2_hz
     );
-
-    gyroInitFilterNotch1(gyroConfig()->gyro_soft_notch_hz_1, gyroConfig()->gyro_soft_notch_cutoff_1);
-    gyroInitFilterNotch2(gyroConfig()->gyro_soft_notch_hz_2, gyroConfig()->gyro_soft_notch_cutoff_2);
 #ifdef USE_GYRO_DATA_ANALYSE
     gyroInitFilterDynamicNotch();
 #endif
@@ -795,7 +992,8 @@ FAST_CODE bool gyroIsCalibrationComplete(void)
         case GYRO_CONFIG_USE_GYRO_2: {
             return isGyroSensorCalibrationComplete(&gyroSensor2);
         }
-        case GYRO_CONFIG_USE_GYRO_BOTH: {
+        case GYRO_CONFIG_USE_GYRO_BOTH:
+        case GYRO_CONFIG_USE_GYRO_FUSED: {
             return isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2);
         }
 #endif
@@ -849,51 +1047,105 @@ bool isFirstArmingGyroCalibrationRunning(void)
     return firstArmingCalibrationWasStarted && !gyroIsCalibrationComplete();
 }
 
+static int32_t gyroCalibrationWindowCycles(void)
+{
+    return MAX(1, GYRO_CALIBRATION_WINDOW_US / (int32_t)gyro.targetLooptime);
+}
+
+static void gyroCompleteCalibration(gyroSensor_t *gyroSensor)
+{
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        // please take care with exotic boardalignment !!
+        gyroSensor->gyroDev.gyroZero[axis] = calibration->var[axis].m_newM;
+        if (axis == Z) {
+          gyroSensor->gyroDev.gyroZero[axis] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+        }
+    }
+
+    gyroSensorUpdateTransform(gyroSensor);
+#ifdef USE_GYRO_TEMP_COMP
+    gyroSensor->tempComp.calibrated = true;
+#endif
+    schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
+    if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
+        beeper(BEEPER_GYRO_CALIBRATED);
+    }
+
+    calibration->cyclesRemaining = 0;
+}
+
 STATIC_UNIT_TESTED void performGyroCalibration(gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold)
 {
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+
+    if (calibration->cyclesRemaining <= 0) {
+        return;
+    }
+
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         // Reset g[axis] at start of calibration
-        if (isOnFirstGyroCalibrationCycle(&gyroSensor->calibration)) {
-            gyroSensor->calibration.sum[axis] = 0.0f;
-            devClear(&gyroSensor->calibration.var[axis]);
+        if (isOnFirstGyroCalibrationCycle(calibration)) {
+            devClear(&calibration->var[axis]);
+            devClear(&calibration->pending[axis]);
+            devClear(&calibration->window[axis]);
             // gyroZero is set to zero until calibration complete
             gyroSensor->gyroDev.gyroZero[axis] = 0.0f;
         }
 
-        // Sum up CALIBRATING_GYRO_TIME_US readings
-        gyroSensor->calibration.sum[axis] += gyroSensor->gyroDev.gyroADCRaw[axis];
-        devPush(&gyroSensor->calibration.var[axis], gyroSensor->gyroDev.gyroADCRaw[axis]);
+        devPush(&calibration->window[axis], gyroSensor->gyroDev.gyroADCRaw[axis]);
+    }
 
-        if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-            const float stddev = devStandardDeviation(&gyroSensor->calibration.var[axis]);
-            // DEBUG_GYRO_CALIBRATION records the standard deviation of roll
-            // into the spare field - debug[3], in DEBUG_GYRO_RAW
-            if (axis == X) {
-                DEBUG_SET(DEBUG_GYRO_RAW, DEBUG_GYRO_CALIBRATION, lrintf(stddev));
-            }
+    const bool finalCycle = isOnFinalGyroCalibrationCycle(calibration);
+    --calibration->cyclesRemaining;
 
-            // check deviation and startover in case the model was moved
-            if (gyroMovementCalibrationThreshold && stddev > gyroMovementCalibrationThreshold) {
-                gyroSetCalibrationCycles(gyroSensor);
-                return;
-            }
+    if (calibration->window[X].m_n < gyroCalibrationWindowCycles() && !finalCycle) {
+        return;
+    }
 
-            // please take care with exotic boardalignment !!
-            gyroSensor->gyroDev.gyroZero[axis] = gyroSensor->calibration.sum[axis] / gyroCalculateCalibratingCycles();
-            if (axis == Z) {
-              gyroSensor->gyroDev.gyroZero[axis] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
-            }
+    bool still = true;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float stddev = devStandardDeviation(&calibration->window[axis]);
+        // DEBUG_GYRO_CALIBRATION records the standard deviation of roll
+        // into the spare field - debug[3], in DEBUG_GYRO_RAW
+        if (axis == X) {
+            DEBUG_SET(DEBUG_GYRO_RAW, DEBUG_GYRO_CALIBRATION, lrintf(stddev));
+        }
+        if (gyroMovementCalibrationThreshold && stddev > gyroMovementCalibrationThreshold) {
+            still = false;
         }
     }
 
-    if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-        schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
-        if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
-            beeper(BEEPER_GYRO_CALIBRATED);
+    // The model moved: drop this window and the one before, where the movement may have started
+    bool settled = still;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (still) {
+            devMerge(&calibration->var[axis], &calibration->pending[axis]);
+            calibration->pending[axis] = calibration->window[axis];
+        } else {
+            devClear(&calibration->pending[axis]);
         }
+        devClear(&calibration->window[axis]);
+
+        const int samples = calibration->var[axis].m_n;
+        settled = settled && samples >= GYRO_CALIBRATION_MIN_WINDOWS * gyroCalibrationWindowCycles()
+            && devStandardDeviation(&calibration->var[axis]) * gyroSensor->gyroDev.scale < GYRO_CALIBRATION_MAX_ERROR_DPS * sqrtf(samples);
     }
 
-    --gyroSensor->calibration.cyclesRemaining;
+    if (settled || finalCycle) {
+        if (finalCycle) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                devMerge(&calibration->var[axis], &calibration->pending[axis]);
+            }
+            if (calibration->var[X].m_n < gyroCalibrationWindowCycles()) {
+                // less than a window of it was still, start over
+                gyroSetCalibrationCycles(gyroSensor);
+                return;
+            }
+        }
+        gyroCompleteCalibration(gyroSensor);
+    }
 }
 
 #if defined(USE_GYRO_SLEW_LIMITER)
@@ -914,6 +1166,25 @@ FAST_CODE int32_t gyroSlewLimiter(gyroSensor_t *gyroSensor, int axis)
 }
 #endif
 
+#if (defined(USE_GYRO_OVERFLOW_CHECK) && !defined(SIMULATOR_BUILD)) || defined(USE_MULTI_GYRO)
+// axes whose rate is above the overflow trigger rate
+static FAST_CODE gyroOverflow_e gyroOverflowAxes(const float *rate, float triggerRate)
+{
+    gyroOverflow_e overflow = GYRO_OVERFLOW_NONE;
+
+    if (fabsf(rate[X]) > triggerRate) {
+        overflow |= GYRO_OVERFLOW_X;
+    }
+    if (fabsf(rate[Y]) > triggerRate) {
+        overflow |= GYRO_OVERFLOW_Y;
+    }
+    if (fabsf(rate[Z]) > triggerRate) {
+        overflow |= GYRO_OVERFLOW_Z;
+    }
+    return overflow;
+}
+#endif
+
 #ifdef USE_GYRO_OVERFLOW_CHECK
 static FAST_CODE_NOINLINE void handleOverflow(timeUs_t currentTimeUs)
 {
@@ -948,23 +1219,13 @@ static FAST_CODE void checkForOverflow(timeUs_t currentTimeUs)
     } else {
 #ifndef SIMULATOR_BUILD
         // check for overflow in the axes set in overflowAxisMask
-        gyroOverflow_e overflowCheck = GYRO_OVERFLOW_NONE;
-
         // This will need to be revised if we ever allow different sensor types to be 
         // used simultaneously. In that case the scale might be different between sensors.
         // It's complicated by the fact that we're using filtered gyro data here which is
         // after both sensors are scaled and averaged.
         const float gyroOverflowTriggerRate = GYRO_OVERFLOW_TRIGGER_THRESHOLD * gyro.scale;
 
-        if (fabsf(gyro.gyroADCf[X]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_X;
-        }
-        if (fabsf(gyro.gyroADCf[Y]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_Y;
-        }
-        if (fabsf(gyro.gyroADCf[Z]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_Z;
-        }
+        const gyroOverflow_e overflowCheck = gyroOverflowAxes(gyro.gyroADCf, gyroOverflowTriggerRate);
         if (overflowCheck & overflowAxisMask) {
             overflowDetected = true;
             overflowTimeUs = currentTimeUs;
@@ -1016,6 +1277,21 @@ static FAST_CODE void checkForYawSpin(timeUs_t currentTimeUs)
 }
 #endif // USE_YAW_SPIN_RECOVERY
 
+#ifdef USE_GYRO_FIFO
+// Anti-alias and decimate the FIFO samples to one loop sample. The boxcar average
+// over the samples since the last loop puts its first null at the loop rate.
+static FAST_CODE void gyroFifoDecimate(gyroDev_t *gyroDev)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        int32_t sum = 0;
+        for (int i = 0; i < gyroDev->fifoSampleCount; i++) {
+            sum += gyroDev->fifoData[i][axis];
+        }
+        gyroDev->gyroADCRaw[axis] = lrintf((float)sum / gyroDev->fifoSampleCount);
+    }
+}
+#endif
+
 static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t *gyroSensor)
 {
     if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
@@ -1023,40 +1299,105 @@ static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t *gyroSens
     }
     gyroSensor->gyroDev.dataReady = false;
 
+#ifdef USE_GYRO_FIFO
+    if (gyroSensor->gyroDev.fifoSampleCount > 1) {
+        gyroFifoDecimate(&gyroSensor->gyroDev);
+    }
+#endif
+
     if (isGyroSensorCalibrationComplete(gyroSensor)) {
         // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
 
 #if defined(USE_GYRO_SLEW_LIMITER)
-        gyroSensor->gyroDev.gyroADC[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
+        const int32_t x = gyroSlewLimiter(gyroSensor, X);
+        const int32_t y = gyroSlewLimiter(gyroSensor, Y);
+        const int32_t z = gyroSlewLimiter(gyroSensor, Z);
 #else
-        gyroSensor->gyroDev.gyroADC[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
+        const int32_t x = gyroSensor->gyroDev.gyroADCRaw[X];
+        const int32_t y = gyroSensor->gyroDev.gyroADCRaw[Y];
+        const int32_t z = gyroSensor->gyroDev.gyroADCRaw[Z];
 #endif
 
-        if (gyroSensor->gyroDev.gyroAlign == ALIGN_CUSTOM) {
-            alignSensorViaMatrix(gyroSensor->gyroDev.gyroADC, &gyroSensor->gyroDev.rotationMatrix);
-        } else {
-            alignSensorViaRotation(gyroSensor->gyroDev.gyroADC, gyroSensor->gyroDev.gyroAlign);
+#ifdef USE_GYRO_FIXED_POINT
+        if (gyroSensor->fixedPoint) {
+            const int32_t raw[XYZ_AXIS_COUNT] = { x, y, z };
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                const int32_t aligned = gyroSensor->fixedSign[axis] * raw[gyroSensor->fixedAxis[axis]] * (1 << GYRO_FIXED_POINT_SHIFT) - gyroSensor->fixedOffset[axis];
+                gyroSensor->gyroDev.gyroADC[axis] = aligned * gyroSensor->fixedScale;
+            }
+            return;
+        }
+#endif
+        // aligned, calibrated and scaled to deg/s
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroSensor->gyroDev.gyroADC[axis] = gyroSensor->transform[axis][X] * x + gyroSensor->transform[axis][Y] * y + gyroSensor->transform[axis][Z] * z - gyroSensor->transformOffset[axis];
         }
     } else {
         performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
     }
 }
 
-#define GYRO_FILTER_FUNCTION_NAME filterGyro
-#define GYRO_FILTER_DEBUG_SET(mode, index, value) { UNUSED(mode); UNUSED(index); UNUSED(value); }
-#include "gyro_filter_impl.c"
-#undef GYRO_FILTER_FUNCTION_NAME
-#undef GYRO_FILTER_DEBUG_SET
+#ifdef USE_MULTI_GYRO
+static FAST_CODE void gyroFusionUpdateHealth(gyroSensor_t *gyroSensor, const float *rate, timeUs_t currentTimeUs)
+{
+    gyroFusionState_t *fusion = &gyroSensor->fusion;
 
-#define GYRO_FILTER_FUNCTION_NAME filterGyroDebug
-#define GYRO_FILTER_DEBUG_SET DEBUG_SET
-#include "gyro_filter_impl.c"
-#undef GYRO_FILTER_FUNCTION_NAME
-#undef GYRO_FILTER_DEBUG_SET
+    if (gyroOverflowAxes(rate, GYRO_OVERFLOW_TRIGGER_THRESHOLD * gyroSensor->gyroDev.scale) != GYRO_OVERFLOW_NONE) {
+        fusion->clipped = true;
+        fusion->clipTimeUs = currentTimeUs;
+    } else if (fusion->clipped && cmpTimeUs(currentTimeUs, fusion->clipTimeUs) > GYRO_FUSION_CLIP_HOLD_US) {
+        fusion->clipped = false;
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float delta = rate[axis] - fusion->prevRate[axis];
+        fusion->prevRate[axis] = rate[axis];
+        pt1FilterApply(&fusion->noiseVariance[axis], delta * delta);
+    }
+}
+
+// Combines both sensors weighted by the inverse of their noise variance. A sensor
+// that is clipping is dropped while the other one is healthy.
+static FAST_CODE void gyroFuseSensors(timeUs_t currentTimeUs)
+{
+    const float *rate1 = gyroSensor1.gyroDev.gyroADC;
+    const float *rate2 = gyroSensor2.gyroDev.gyroADC;
+
+    gyroFusionUpdateHealth(&gyroSensor1, rate1, currentTimeUs);
+    gyroFusionUpdateHealth(&gyroSensor2, rate2, currentTimeUs);
+
+    const bool clipped1 = gyroSensor1.fusion.clipped;
+    const bool clipped2 = gyroSensor2.fusion.clipped;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (clipped1 && !clipped2) {
+            gyro.gyroADC[axis] = rate2[axis];
+        } else if (clipped2 && !clipped1) {
+            gyro.gyroADC[axis] = rate1[axis];
+        } else {
+            const float weight1 = 1.0f / MAX(gyroSensor1.fusion.noiseVariance[axis].state, GYRO_FUSION_VARIANCE_MIN);
+            const float weight2 = 1.0f / MAX(gyroSensor2.fusion.noiseVariance[axis].state, GYRO_FUSION_VARIANCE_MIN);
+            gyro.gyroADC[axis] = (weight1 * rate1[axis] + weight2 * rate2[axis]) / (weight1 + weight2);
+        }
+    }
+}
+#endif
+
+// filterGyro() and filterGyroDebug()
+#define DEBUG_VARIANT_IMPL "sensors/gyro_filter_impl.c"
+#include "build/debug_variant.h"
+
+#ifdef USE_BENCHMARK
+// Filter the last sample again, the gyro chain of gyroUpdate() without the sensor read
+void gyroFilterBenchmark(void)
+{
+    if (gyroDebugMode == DEBUG_NONE) {
+        filterGyro();
+    } else {
+        filterGyroDebug();
+    }
+}
+#endif
 
 FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
 {
@@ -1065,41 +1406,57 @@ FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
     case GYRO_CONFIG_USE_GYRO_1:
         gyroUpdateSensor(&gyroSensor1);
         if (isGyroSensorCalibrationComplete(&gyroSensor1)) {
-            gyro.gyroADC[X] = gyroSensor1.gyroDev.gyroADC[X] * gyroSensor1.gyroDev.scale;
-            gyro.gyroADC[Y] = gyroSensor1.gyroDev.gyroADC[Y] * gyroSensor1.gyroDev.scale;
-            gyro.gyroADC[Z] = gyroSensor1.gyroDev.gyroADC[Z] * gyroSensor1.gyroDev.scale;
+            gyro.gyroADC[X] = gyroSensor1.gyroDev.gyroADC[X];
+            gyro.gyroADC[Y] = gyroSensor1.gyroDev.gyroADC[Y];
+            gyro.gyroADC[Z] = gyroSensor1.gyroDev.gyroADC[Z];
         }
         break;
 #ifdef USE_MULTI_GYRO
     case GYRO_CONFIG_USE_GYRO_2:
         gyroUpdateSensor(&gyroSensor2);
         if (isGyroSensorCalibrationComplete(&gyroSensor2)) {
-            gyro.gyroADC[X] = gyroSensor2.gyroDev.gyroADC[X] * gyroSensor2.gyroDev.scale;
-            gyro.gyroADC[Y] = gyroSensor2.gyroDev.gyroADC[Y] * gyroSensor2.gyroDev.scale;
-            gyro.gyroADC[Z] = gyroSensor2.gyroDev.gyroADC[Z] * gyroSensor2.gyroDev.scale;
+            gyro.gyroADC[X] = gyroSensor2.gyroDev.gyroADC[X];
+            gyro.gyroADC[Y] = gyroSensor2.gyroDev.gyroADC[Y];
+            gyro.gyroADC[Z] = gyroSensor2.gyroDev.gyroADC[Z];
         }
         break;
     case GYRO_CONFIG_USE_GYRO_BOTH:
         gyroUpdateSensor(&gyroSensor1);
         gyroUpdateSensor(&gyroSensor2);
         if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
-            gyro.gyroADC[X] = ((gyroSensor1.gyroDev.gyroADC[X] * gyroSensor1.gyroDev.scale) + (gyroSensor2.gyroDev.gyroADC[X] * gyroSensor2.gyroDev.scale)) / 2.0f;
-            gyro.gyroADC[Y] = ((gyroSensor1.gyroDev.gyroADC[Y] * gyroSensor1.gyroDev.scale) + (gyroSensor2.gyroDev.gyroADC[Y] * gyroSensor2.gyroDev.scale)) / 2.0f;
-            gyro.gyroADC[Z] = ((gyroSensor1.gyroDev.gyroADC[Z] * gyroSensor1.gyroDev.scale) + (gyroSensor2.gyroDev.gyroADC[Z] * gyroSensor2.gyroDev.scale)) / 2.0f;
+            gyro.gyroADC[X] = (gyroSensor1.gyroDev.gyroADC[X] + gyroSensor2.gyroDev.gyroADC[X]) / 2.0f;
+            gyro.gyroADC[Y] = (gyroSensor1.gyroDev.gyroADC[Y] + gyroSensor2.gyroDev.gyroADC[Y]) / 2.0f;
+            gyro.gyroADC[Z] = (gyroSensor1.gyroDev.gyroADC[Z] + gyroSensor2.gyroDev.gyroADC[Z]) / 2.0f;
+        }
+        break;
+    case GYRO_CONFIG_USE_GYRO_FUSED:
+        gyroUpdateSensor(&gyroSensor1);
+        gyroUpdateSensor(&gyroSensor2);
+        if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
+            gyroFuseSensors(currentTimeUs);
         }
         break;
 #endif
     }
 
+    gyro.sampleTimeUs = currentTimeUs;
+#ifdef USE_GYRO_ISR_READ
+    if (gyro.rawSensorDev->isrRead) {
+        gyro.sampleTimeUs = gyro.rawSensorDev->sampleTimeUs;
+    }
+#endif
+
+    PROFILE_BEGIN(PROFILE_FILTER_GYRO);
     if (gyroDebugMode == DEBUG_NONE) {
         filterGyro();
     } else {
         filterGyroDebug();
     }
+    PROFILE_END(PROFILE_FILTER_GYRO);
 
 #ifdef USE_GYRO_DATA_ANALYSE
     if (isDynamicFilterActive()) {
-        gyroDataAnalyse(&gyro.gyroAnalyseState, gyro.notchFilterDyn, gyro.notchFilterDyn2);
+        gyroDataAnalyse(&gyro.gyroAnalyseState, gyro.notchFilterDyn);
     }
 #endif
 
@@ -1108,30 +1465,31 @@ FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
         case GYRO_CONFIG_USE_GYRO_1:
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 0, gyroSensor1.gyroDev.gyroADCRaw[X]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 1, gyroSensor1.gyroDev.gyroADCRaw[Y]);
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 0, lrintf(gyroSensor1.gyroDev.gyroADC[X] * gyroSensor1.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 1, lrintf(gyroSensor1.gyroDev.gyroADC[Y] * gyroSensor1.gyroDev.scale));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 0, lrintf(gyroSensor1.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 1, lrintf(gyroSensor1.gyroDev.gyroADC[Y]));
             break;
 
 #ifdef USE_MULTI_GYRO
         case GYRO_CONFIG_USE_GYRO_2:
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 2, gyroSensor2.gyroDev.gyroADCRaw[X]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 3, gyroSensor2.gyroDev.gyroADCRaw[Y]);
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 2, lrintf(gyroSensor2.gyroDev.gyroADC[X] * gyroSensor2.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 3, lrintf(gyroSensor2.gyroDev.gyroADC[Y] * gyroSensor2.gyroDev.scale));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 2, lrintf(gyroSensor2.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 3, lrintf(gyroSensor2.gyroDev.gyroADC[Y]));
             break;
 
     case GYRO_CONFIG_USE_GYRO_BOTH:
+    case GYRO_CONFIG_USE_GYRO_FUSED:
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 0, gyroSensor1.gyroDev.gyroADCRaw[X]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 1, gyroSensor1.gyroDev.gyroADCRaw[Y]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 2, gyroSensor2.gyroDev.gyroADCRaw[X]);
             DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 3, gyroSensor2.gyroDev.gyroADCRaw[Y]);
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 0, lrintf(gyroSensor1.gyroDev.gyroADC[X] * gyroSensor1.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 1, lrintf(gyroSensor1.gyroDev.gyroADC[Y] * gyroSensor1.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 2, lrintf(gyroSensor2.gyroDev.gyroADC[X] * gyroSensor2.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 3, lrintf(gyroSensor2.gyroDev.gyroADC[Y] * gyroSensor2.gyroDev.scale));
-            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 0, lrintf((gyroSensor1.gyroDev.gyroADC[X] * gyroSensor1.gyroDev.scale) - (gyroSensor2.gyroDev.gyroADC[X] * gyroSensor2.gyroDev.scale)));
-            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 1, lrintf((gyroSensor1.gyroDev.gyroADC[Y] * gyroSensor1.gyroDev.scale) - (gyroSensor2.gyroDev.gyroADC[Y] * gyroSensor2.gyroDev.scale)));
-            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 2, lrintf((gyroSensor1.gyroDev.gyroADC[Z] * gyroSensor1.gyroDev.scale) - (gyroSensor2.gyroDev.gyroADC[Z] * gyroSensor2.gyroDev.scale)));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 0, lrintf(gyroSensor1.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 1, lrintf(gyroSensor1.gyroDev.gyroADC[Y]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 2, lrintf(gyroSensor2.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_SCALED, 3, lrintf(gyroSensor2.gyroDev.gyroADC[Y]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 0, lrintf(gyroSensor1.gyroDev.gyroADC[X] - gyroSensor2.gyroDev.gyroADC[X]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 1, lrintf(gyroSensor1.gyroDev.gyroADC[Y] - gyroSensor2.gyroDev.gyroADC[Y]));
+            DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 2, lrintf(gyroSensor1.gyroDev.gyroADC[Z] - gyroSensor2.gyroDev.gyroADC[Z]));
             break;
 #endif
         }
@@ -1182,6 +1540,141 @@ bool gyroGetAccumulationAverage(float *accumulationAverage)
     }
 }
 
+#ifdef USE_GYRO_TEMP_COMP
+// Adds a measured zero to the table and takes it as the zero at this temperature
+static void gyroTempCompLearn(gyroSensor_t *gyroSensor, int sensorIndex, int temperature, const float *zero)
+{
+    float bias[XYZ_AXIS_COUNT];
+
+    gyroBiasLearn(sensorIndex, temperature, zero);
+    gyroBiasLookup(sensorIndex, temperature, bias);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->tempComp.correction[axis] = zero[axis] - bias[axis];
+    }
+}
+
+// Averages the raw rate over a window while disarmed, a still window is a zero measurement.
+// It only goes into the table, the zero in use is kept: the correction takes up the change
+// of the table at this temperature.
+static void gyroTempCompLearnOnGround(gyroSensor_t *gyroSensor, int sensorIndex, int temperature)
+{
+    const gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+    gyroTempComp_t *tempComp = &gyroSensor->tempComp;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        devPush(&tempComp->window[axis], gyroDev->gyroADCRaw[axis]);
+    }
+    if (tempComp->window[X].m_n < GYRO_TEMP_COMP_WINDOW) {
+        return;
+    }
+
+    // the same gate as the calibration, a slow turn moves the mean further than the noise
+    const uint8_t threshold = gyroConfig()->gyroMovementCalibrationThreshold;
+    bool still = threshold != 0;
+    float zero[XYZ_AXIS_COUNT];
+    float current[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        zero[axis] = tempComp->window[axis].m_newM;
+        current[axis] = gyroDev->gyroZero[axis];
+        if (axis == Z) {
+            current[axis] += (float)gyroConfig()->gyro_offset_yaw / 100;
+        }
+        if (devStandardDeviation(&tempComp->window[axis]) > threshold
+            || fabsf(zero[axis] - current[axis]) > threshold) {
+            still = false;
+        }
+        devClear(&tempComp->window[axis]);
+    }
+
+    if (still) {
+        float bias[XYZ_AXIS_COUNT];
+        gyroBiasLearn(sensorIndex, temperature, zero);
+        gyroBiasLookup(sensorIndex, temperature, bias);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            tempComp->correction[axis] = current[axis] - bias[axis];
+        }
+    }
+}
+
+static void gyroTempCompUpdateSensor(gyroSensor_t *gyroSensor, int sensorIndex)
+{
+    gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+    gyroTempComp_t *tempComp = &gyroSensor->tempComp;
+    float bias[XYZ_AXIS_COUNT];
+
+    if (!gyroDev->temperatureFn || !gyroDev->temperatureFn(gyroDev, &gyroDev->temperature)) {
+        return;
+    }
+    const int temperature = gyroDev->temperature;
+
+    if (!isGyroSensorCalibrationComplete(gyroSensor)) {
+        // boot without waiting for the calibration, the zero is known from the table
+        if (tempComp->restore && gyroBiasLookup(sensorIndex, temperature, bias)) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                tempComp->correction[axis] = 0.0f;
+            }
+            tempComp->calibrated = false;
+            gyroSensor->calibration.cyclesRemaining = 0;
+            beeper(BEEPER_GYRO_CALIBRATED);
+        } else {
+            tempComp->restore = false;
+            return;
+        }
+    }
+    tempComp->restore = false;
+
+    if (tempComp->calibrated) {
+        tempComp->calibrated = false;
+        float zero[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            zero[axis] = gyroSensor->calibration.var[axis].m_newM;
+            devClear(&tempComp->window[axis]);
+        }
+        gyroTempCompLearn(gyroSensor, sensorIndex, temperature, zero);
+    } else if (!ARMING_FLAG(ARMED)) {
+        gyroTempCompLearnOnGround(gyroSensor, sensorIndex, temperature);
+    } else {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            devClear(&tempComp->window[axis]);
+        }
+    }
+
+    // the zero follows the table from the temperature of the last measurement
+    if (gyroBiasLookup(sensorIndex, temperature, bias)) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroDev->gyroZero[axis] = bias[axis] + tempComp->correction[axis];
+        }
+        gyroDev->gyroZero[Z] -= (float)gyroConfig()->gyro_offset_yaw / 100;
+        gyroSensorUpdateOffset(gyroSensor);
+    }
+}
+
+// Keeps the zero offset on its learned temperature curve. Runs at a low rate, the
+// per-sample cost is nil as the offset is folded into the sensor transform.
+void gyroTempCompUpdate(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    switch (gyroToUse) {
+    case GYRO_CONFIG_USE_GYRO_1:
+        gyroTempCompUpdateSensor(&gyroSensor1, 0);
+        break;
+
+#ifdef USE_MULTI_GYRO
+    case GYRO_CONFIG_USE_GYRO_2:
+        gyroTempCompUpdateSensor(&gyroSensor2, 1);
+        break;
+
+    case GYRO_CONFIG_USE_GYRO_BOTH:
+    case GYRO_CONFIG_USE_GYRO_FUSED:
+        gyroTempCompUpdateSensor(&gyroSensor1, 0);
+        gyroTempCompUpdateSensor(&gyroSensor2, 1);
+        break;
+#endif
+    }
+}
+#endif
+
 int16_t gyroReadSensorTemperature(gyroSensor_t gyroSensor)
 {
     if (gyroSensor.gyroDev.temperatureFn) {
@@ -1253,21 +1746,23 @@ float dynThrottle(float throttle) {
     return throttle * (1 - (throttle * throttle) / 3.0f) * 1.5f;
 }
 
-void dynLpfGyroUpdate(float throttle)
+// step is 0..DYN_LPF_STEPS, the position of the cutoff between dyn_lpf_gyro_min_hz and dyn_lpf_gyro_max_hz
+void dynLpfGyroUpdate(int step)
 {
     if (dynLpfFilter != DYN_LPF_NONE) {
-        const unsigned int cutoffFreq = fmax(dynThrottle(throttle) * dynLpfMax, dynLpfMin);
+        const unsigned int cutoffFreq = dynLpfCutoff[constrain(step, 0, DYN_LPF_STEPS)];
 
         if (dynLpfFilter == DYN_LPF_PT1) {
             DEBUG_SET(DEBUG_DYN_LPF, 2, cutoffFreq);
-            const float gyroDt = gyro.targetLooptime * 1e-6f;
+            const float gain = pt1FilterGain(cutoffFreq, gyro.targetLooptime * 1e-6f);
             for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                pt1FilterUpdateCutoff(&gyro.lowpassFilter[axis].pt1FilterState, pt1FilterGain(cutoffFreq, gyroDt));
+                pt1FilterUpdateCutoff(&gyro.lowpassFilter[axis].pt1FilterState, gain);
             }
         } else if (dynLpfFilter == DYN_LPF_BIQUAD) {
             DEBUG_SET(DEBUG_DYN_LPF, 2, cutoffFreq);
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                biquadFilterUpdateLPF(&gyro.lowpassFilter[axis].biquadFilterState, cutoffFreq, gyro.targetLooptime);
+            biquadFilterUpdateLPF(&gyro.lowpassFilter[X].biquadFilterState, cutoffFreq, gyro.targetLooptime);
+            for (int axis = Y; axis < XYZ_AXIS_COUNT; axis++) {
+                biquadFilterCopyCoefficients(&gyro.lowpassFilter[axis].biquadFilterState, &gyro.lowpassFilter[X].biquadFilterState);
             }
         }
     }
@@ -48,28 +48,27 @@ typedef struct gyro_s {
     float gyroADCf[XYZ_AXIS_COUNT];    // filtered gyro data
 
     gyroDev_t *rawSensorDev;           // pointer to the sensor providing the raw data for DEBUG_GYRO_RAW
+    timeUs_t sampleTimeUs;             // time the latest gyro sample was taken
+
+    // static filters applied in order: notch1, notch2, lowpass, lowpass2
+    filterChain_t filterChain;
+
+    // dynamic notch filters, applied after the FFT analyser input
+    filterChain_t notchFilterDynChain;
 
     // lowpass gyro soft filter
-    filterApplyFnPtr lowpassFilterApplyFn;
     gyroLowpassFilter_t lowpassFilter[XYZ_AXIS_COUNT];
 
     // lowpass2 gyro soft filter
-    filterApplyFnPtr lowpass2FilterApplyFn;
     gyroLowpassFilter_t lowpass2Filter[XYZ_AXIS_COUNT];
 
     // notch filters
-    filterApplyFnPtr notchFilter1ApplyFn;
     biquadFilter_t notchFilter1[XYZ_AXIS_COUNT];
-
-    filterApplyFnPtr notchFilter2ApplyFn;
     biquadFilter_t notchFilter2[XYZ_AXIS_COUNT];
 
-    filterApplyFnPtr notchFilterDynApplyFn;
-    filterApplyFnPtr notchFilterDynApplyFn2;
-    biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT];
-    biquadFilter_t notchFilterDyn2[XYZ_AXIS_COUNT];
-
 #ifdef USE_GYRO_DATA_ANALYSE
+    biquadFilter_t notchFilterDyn[DYN_NOTCH_COUNT_MAX][XYZ_AXIS_COUNT];
+
     gyroAnalyseState_t gyroAnalyseState;
 #endif
 } gyro_t;
@@ -102,6 +101,7 @@ enum {
 #define GYRO_CONFIG_USE_GYRO_1      0
 #define GYRO_CONFIG_USE_GYRO_2      1
 #define GYRO_CONFIG_USE_GYRO_BOTH   2
+#define GYRO_CONFIG_USE_GYRO_FUSED  3   // both gyros, weighted by noise and clipping state
 
 enum {
     FILTER_LOWPASS = 0,
@@ -118,6 +118,12 @@ typedef enum gyroDetectionFlags_e {
 #endif
 } gyroDetectionFlags_t;
 
+typedef enum {
+    GYRO_TEMP_COMP_OFF = 0,
+    GYRO_TEMP_COMP_ON,                  // learn the bias versus temperature and follow it
+    GYRO_TEMP_COMP_SKIP_CALIBRATION,    // as ON, and take the boot zero from the table once it has data
+} gyroTempComp_e;
+
 typedef struct gyroConfig_s {
     uint8_t  gyroMovementCalibrationThreshold; // people keep forgetting that moving model while init results in wrong gyro offsets. and then they never reset gyro. so this is now on by default.
     uint8_t  gyro_sync_denom;                  // Gyro sample divider
@@ -152,6 +158,12 @@ typedef struct gyroConfig_s {
     uint16_t dyn_notch_q;
     uint16_t dyn_notch_min_hz;
     uint8_t  gyro_filter_debug_axis;
+    uint8_t  dyn_notch_window;           // FFT window size, larger windows are analysed with 50% overlap
+    uint8_t  dyn_notch_count;            // notches per axis, more than one tracks several spectral peaks
+    uint8_t  gyro_fifo_decimation;       // sensor samples per gyro loop read from the FIFO, 1 = no FIFO
+    uint8_t  gyro_isr_read;              // read the gyro from its data ready interrupt
+    uint8_t  gyro_isr_pid;               // run the PID loop from the data ready interrupt, needs gyro_isr_read
+    uint8_t  gyro_temp_comp;             // gyroTempComp_e
 } gyroConfig_t;
 
 PG_DECLARE(gyroConfig_t, gyroConfig);
@@ -176,7 +188,22 @@ bool gyroYawSpinDetected(void);
 uint16_t gyroAbsRateDps(int axis);
 uint8_t gyroReadRegister(uint8_t whichSensor, uint8_t reg);
 gyroDetectionFlags_t getGyroDetectionFlags(void);
+#ifdef USE_GYRO_TEMP_COMP
+void gyroTempCompUpdate(timeUs_t currentTimeUs);
+#endif
+#ifdef USE_GYRO_ISR_PID
+bool gyroSetIsrTask(void (*taskFn)(timeUs_t currentTimeUs));
+#endif
+#ifdef USE_GYRO_ACC_BURST
+struct accDev_s;
+bool gyroSetAccBurst(struct accDev_s *accDev, timeDelta_t accSamplingInterval);
+#endif
+#ifdef USE_BENCHMARK
+void gyroFilterBenchmark(void);
+#endif
 #ifdef USE_DYN_LPF
+#define DYN_LPF_STEPS 100           // the cutoffs move in steps of 1% of their range
+
 float dynThrottle(float throttle);
-void dynLpfGyroUpdate(float throttle);
+void dynLpfGyroUpdate(int step);
 #endif
@@ -0,0 +1,112 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Gyro bias versus temperature. Every calibration, and every still period on
+ * the ground, adds the measured zero to the bin of the current temperature.
+ * The lookup interpolates between the closest learned bins on either side and
+ * holds the value of the outermost bin beyond them.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_GYRO_TEMP_COMP
+
+#include "common/maths.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "gyro_bias.h"
+
+PG_REGISTER(gyroBiasTable_t, gyroBiasTable, PG_GYRO_BIAS_TABLE, 0);
+
+static int gyroBiasBin(int temperature)
+{
+    const int bin = (temperature - GYRO_BIAS_TEMP_MIN_C + GYRO_BIAS_TEMP_STEP_C / 2) / GYRO_BIAS_TEMP_STEP_C;
+    return constrain(bin, 0, GYRO_BIAS_TEMP_BINS - 1);
+}
+
+static int gyroBiasBinTemperature(int bin)
+{
+    return GYRO_BIAS_TEMP_MIN_C + bin * GYRO_BIAS_TEMP_STEP_C;
+}
+
+void gyroBiasLearn(int sensorIndex, int temperature, const float *bias)
+{
+    gyroBiasTable_t *table = gyroBiasTableMutable();
+    const int bin = gyroBiasBin(temperature);
+    const int weight = MIN(table->weight[sensorIndex][bin] + 1, GYRO_BIAS_WEIGHT_MAX);
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float value = constrainf(bias[axis] * GYRO_BIAS_SCALE, INT16_MIN, INT16_MAX);
+        const float stored = table->bias[sensorIndex][bin][axis];
+        table->bias[sensorIndex][bin][axis] = lrintf(stored + (value - stored) / weight);
+    }
+    table->weight[sensorIndex][bin] = weight;
+}
+
+bool gyroBiasLookup(int sensorIndex, int temperature, float *bias)
+{
+    const gyroBiasTable_t *table = gyroBiasTable();
+    const uint8_t *weight = table->weight[sensorIndex];
+
+    // closest learned bins at or below and at or above the temperature
+    int below = -1;
+    int above = -1;
+    for (int bin = 0; bin < GYRO_BIAS_TEMP_BINS; bin++) {
+        if (!weight[bin]) {
+            continue;
+        }
+        if (gyroBiasBinTemperature(bin) <= temperature) {
+            below = bin;
+        } else if (above < 0) {
+            above = bin;
+        }
+    }
+
+    if (below < 0 && above < 0) {
+        return false;
+    }
+    if (below < 0) {
+        below = above;
+    } else if (above < 0) {
+        above = below;
+    }
+
+    float fraction = 0.0f;
+    if (above != below) {
+        const int low = gyroBiasBinTemperature(below);
+        fraction = (float)(temperature - low) / (gyroBiasBinTemperature(above) - low);
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float low = table->bias[sensorIndex][below][axis];
+        const float high = table->bias[sensorIndex][above][axis];
+        bias[axis] = (low + (high - low) * fraction) / GYRO_BIAS_SCALE;
+    }
+
+    return true;
+}
+
+#endif
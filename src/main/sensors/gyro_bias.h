@@ -0,0 +1,45 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+
+#include "pg/pg.h"
+
+#define GYRO_BIAS_TEMP_MIN_C        0       // centre of the first bin
+#define GYRO_BIAS_TEMP_STEP_C       5
+#define GYRO_BIAS_TEMP_BINS         16      // 0..75 degC
+#define GYRO_BIAS_SCALE             16      // stored bias units per raw sensor unit
+#define GYRO_BIAS_WEIGHT_MAX        64      // from here on a bin follows the new samples as a moving average
+
+// Learned zero rate offset of each sensor versus its die temperature, in raw sensor units
+typedef struct gyroBiasTable_s {
+    int16_t bias[MAX_GYRODEV_COUNT][GYRO_BIAS_TEMP_BINS][XYZ_AXIS_COUNT];
+    uint8_t weight[MAX_GYRODEV_COUNT][GYRO_BIAS_TEMP_BINS];     // samples averaged into the bin, 0 = empty
+} gyroBiasTable_t;
+
+PG_DECLARE(gyroBiasTable_t, gyroBiasTable);
+
+void gyroBiasLearn(int sensorIndex, int temperature, const float *bias);
+bool gyroBiasLookup(int sensorIndex, int temperature, float *bias);
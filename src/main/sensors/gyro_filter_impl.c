@@ -20,53 +20,53 @@
 
 #include "platform.h"
 
-static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(void)
+static FAST_CODE void DEBUG_VARIANT(filterGyro)(void)
 {
+    float gyroADCf[XYZ_AXIS_COUNT];
+
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_RAW, axis, gyro.rawSensorDev->gyroADCRaw[axis]);
+        DEBUG_VARIANT_SET(DEBUG_GYRO_RAW, axis, gyro.rawSensorDev->gyroADCRaw[axis]);
         // scale gyro output to degrees per second
-        float gyroADCf = gyro.gyroADC[axis];
+        gyroADCf[axis] = gyro.gyroADC[axis];
         // DEBUG_GYRO_SCALED records the unfiltered, scaled gyro output
-        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyroADCf));
+        DEBUG_VARIANT_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyroADCf[axis]));
 
 #ifdef USE_GYRO_DATA_ANALYSE
         if (isDynamicFilterActive()) {
             if (axis == gyroDebugAxis) {
-                GYRO_FILTER_DEBUG_SET(DEBUG_FFT, 0, lrintf(gyroADCf));
-                GYRO_FILTER_DEBUG_SET(DEBUG_FFT_FREQ, 3, lrintf(gyroADCf));
-                GYRO_FILTER_DEBUG_SET(DEBUG_DYN_LPF, 0, lrintf(gyroADCf));
+                DEBUG_VARIANT_SET(DEBUG_FFT, 0, lrintf(gyroADCf[axis]));
+                DEBUG_VARIANT_SET(DEBUG_FFT_FREQ, 3, lrintf(gyroADCf[axis]));
+                DEBUG_VARIANT_SET(DEBUG_DYN_LPF, 0, lrintf(gyroADCf[axis]));
             }
         }
 #endif
+    }
 
 #ifdef USE_RPM_FILTER
-        // Replace the gyro value with the RPM filtered version
-        gyroADCf = rpmFilterGyro(axis, gyroADCf);
+    // Replace the gyro values with the RPM filtered version
+    rpmFilterGyro(gyroADCf);
 #endif
 
-
-        // apply static notch filters and software lowpass filters
-        gyroADCf = gyro.notchFilter1ApplyFn((filter_t *)&gyro.notchFilter1[axis], gyroADCf);
-        gyroADCf = gyro.notchFilter2ApplyFn((filter_t *)&gyro.notchFilter2[axis], gyroADCf);
-        gyroADCf = gyro.lowpassFilterApplyFn((filter_t *)&gyro.lowpassFilter[axis], gyroADCf);
-        gyroADCf = gyro.lowpass2FilterApplyFn((filter_t *)&gyro.lowpass2Filter[axis], gyroADCf);
+    // apply static notch filters and software lowpass filters
+    filterChainApply(&gyro.filterChain, gyroADCf);
 
 #ifdef USE_GYRO_DATA_ANALYSE
-        if (isDynamicFilterActive()) {
-            if (axis == gyroDebugAxis) {
-                GYRO_FILTER_DEBUG_SET(DEBUG_FFT, 1, lrintf(gyroADCf));
-                GYRO_FILTER_DEBUG_SET(DEBUG_FFT_FREQ, 2, lrintf(gyroADCf));
-                GYRO_FILTER_DEBUG_SET(DEBUG_DYN_LPF, 3, lrintf(gyroADCf));
-            }
-            gyroDataAnalysePush(&gyro.gyroAnalyseState, axis, gyroADCf);
-            gyroADCf = gyro.notchFilterDynApplyFn((filter_t *)&gyro.notchFilterDyn[axis], gyroADCf);
-            gyroADCf = gyro.notchFilterDynApplyFn2((filter_t *)&gyro.notchFilterDyn2[axis], gyroADCf);
+    if (isDynamicFilterActive()) {
+        DEBUG_VARIANT_SET(DEBUG_FFT, 1, lrintf(gyroADCf[gyroDebugAxis]));
+        DEBUG_VARIANT_SET(DEBUG_FFT_FREQ, 2, lrintf(gyroADCf[gyroDebugAxis]));
+        DEBUG_VARIANT_SET(DEBUG_DYN_LPF, 3, lrintf(gyroADCf[gyroDebugAxis]));
+
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroDataAnalysePush(&gyro.gyroAnalyseState, axis, gyroADCf[axis]);
         }
+        filterChainApply(&gyro.notchFilterDynChain, gyroADCf);
+    }
 #endif
 
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         // DEBUG_GYRO_FILTERED records the scaled, filtered, after all software filtering has been applied.
-        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_FILTERED, axis, lrintf(gyroADCf));
+        DEBUG_VARIANT_SET(DEBUG_GYRO_FILTERED, axis, lrintf(gyroADCf[axis]));
 
-        gyro.gyroADCf[axis] = gyroADCf;
+        gyro.gyroADCf[axis] = gyroADCf[axis];
     }
 }
@@ -29,6 +29,7 @@
 #include "config/feature.h"
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
+#include "pg/sensor_cache.h"
 
 #include "config/config.h"
 #include "fc/runtime_config.h"
@@ -77,7 +78,19 @@ bool sensorsAutodetect(void)
 #endif
 
 #ifdef USE_BARO
-    baroDetect(&baro.dev, barometerConfig()->baro_hardware);
+    bool baroDetected = false;
+#ifdef USE_SENSOR_HARDWARE_CACHE
+    // Start with the barometer found on the last boot
+    if (barometerConfig()->baro_hardware == BARO_DEFAULT && sensorHardwareCache()->baroHardware != BARO_DEFAULT) {
+        baroDetected = baroDetect(&baro.dev, sensorHardwareCache()->baroHardware);
+    }
+#endif
+    if (!baroDetected) {
+        baroDetected = baroDetect(&baro.dev, barometerConfig()->baro_hardware);
+    }
+#ifdef USE_SENSOR_HARDWARE_CACHE
+    sensorHardwareCacheMutable()->baroHardware = baroDetected ? detectedSensors[SENSOR_INDEX_BARO] : BARO_DEFAULT;
+#endif
 #endif
 
 #ifdef USE_RANGEFINDER
@@ -0,0 +1,251 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Motor RPM service. Every enabled source is sampled once per PID cycle as
+ * (timestamp, rpm, quality), the best source of each motor is extrapolated
+ * to the current time and published, consumers read the cached value.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "config/feature.h"
+
+#include "drivers/dshot.h"
+#include "drivers/freq.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+
+#include "pg/motor.h"
+
+#include "sensors/esc_sensor.h"
+
+#include "rpm_source.h"
+
+#define RPM_QUALITY_MAX         100
+#define RPM_QUALITY_STOPPED     50      // a zero reading may also be a sensor that stopped working
+
+typedef struct rpmSample_s {
+    timeUs_t timeUs;                    // time the value was measured
+    float rpm;
+    uint8_t quality;                    // 0 = no data
+} rpmSample_t;
+
+typedef struct rpmSourceState_s {
+    rpmSample_t sample;
+    float slope;                        // rpm/us between the last two samples
+    timeDelta_t intervalUs;             // time between the last two samples
+} rpmSourceState_t;
+
+static bool rpmSourceEnabled[RPM_SRC_COUNT];
+static rpmSourceState_t rpmSourceState[RPM_SRC_COUNT][MAX_SUPPORTED_MOTORS];
+
+// eRPM/100 to motor rpm, and main motor rpm to headspeed, built once from the config
+static float motorRpmScale[MAX_SUPPORTED_MOTORS];
+static float headspeedScale;
+static float headspeedRpm;
+static float motorRpm[MAX_SUPPORTED_MOTORS];
+static rpmSource_e motorRpmSource[MAX_SUPPORTED_MOTORS];
+static pt1Filter_t motorRpmFilter[MAX_SUPPORTED_MOTORS];
+static uint32_t rpmSourceDropouts;
+
+// called from init at FC startup.
+void rpmSourceInit(void)
+{
+#ifdef USE_DSHOT_TELEMETRY
+    rpmSourceEnabled[RPM_SRC_DSHOT_TELEM] = motorConfig()->dev.useDshotTelemetry;
+#endif
+#ifdef USE_FREQ_SENSOR
+    rpmSourceEnabled[RPM_SRC_FREQ_SENSOR] = featureIsEnabled(FEATURE_FREQ_SENSOR);
+#endif
+#ifdef USE_ESC_SENSOR
+    rpmSourceEnabled[RPM_SRC_ESC_SENSOR] = featureIsEnabled(FEATURE_ESC_SENSOR);
+#endif
+#ifdef SIMULATOR_BUILD
+    rpmSourceEnabled[RPM_SRC_SIMULATOR] = simulatorHasRpmSource();
+#endif
+
+    for (int motor = 0; motor < MAX_SUPPORTED_MOTORS; motor++) {
+        // the sources report eRPM/100
+        motorRpmScale[motor] = 100.0f / MAX(motorConfig()->motorPoleCount[motor] / 2, 1);
+        pt1FilterInit(&motorRpmFilter[motor], pt1FilterGain(mixerConfig()->gov_rpm_lpf, pidGetDT()));
+    }
+
+    // gov_gear_ratio is motor/rotor speed x1000
+    headspeedScale = 1000.0f / MAX(mixerConfig()->gov_gear_ratio, 1);
+}
+
+static void rpmSourceFeed(rpmSource_e source, uint8_t motor, timeUs_t timeUs, float rpm, uint8_t quality)
+{
+    rpmSourceState_t *state = &rpmSourceState[source][motor];
+
+    if (timeUs != state->sample.timeUs) {
+        const timeDelta_t intervalUs = cmpTimeUs(timeUs, state->sample.timeUs);
+        if (state->sample.quality && quality && intervalUs > 0) {
+            state->slope = (rpm - state->sample.rpm) / intervalUs;
+            state->intervalUs = intervalUs;
+        } else {
+            state->slope = 0;
+        }
+    }
+
+    state->sample.timeUs = timeUs;
+    state->sample.rpm = rpm;
+    state->sample.quality = quality;
+}
+
+static void rpmSourceSample(timeUs_t currentTimeUs)
+{
+    const int motorCount = getMotorCount();
+
+#ifdef USE_DSHOT_TELEMETRY
+    if (rpmSourceEnabled[RPM_SRC_DSHOT_TELEM]) {
+        for (int motor = 0; motor < motorCount; motor++) {
+            const bool active = dshotTelemetryState.motorState[motor].telemetryActive;
+            rpmSourceFeed(RPM_SRC_DSHOT_TELEM, motor, currentTimeUs,
+                getDshotTelemetry(motor) * motorRpmScale[motor], active ? RPM_QUALITY_MAX : 0);
+        }
+    }
+#endif
+
+#ifdef USE_FREQ_SENSOR
+    if (rpmSourceEnabled[RPM_SRC_FREQ_SENSOR]) {
+        freqUpdate();
+        // HF3D: The freq sensor number MUST match the motor number.
+        for (int motor = 0; motor < MIN(motorCount, FREQ_SENSOR_PORT_COUNT); motor++) {
+            if (isFreqSensorPortInitialized(motor)) {
+                const float rpm = freqRead(motor) * (60.0f / 100.0f) * motorRpmScale[motor];
+                rpmSourceFeed(RPM_SRC_FREQ_SENSOR, motor, currentTimeUs, rpm, rpm > 0 ? RPM_QUALITY_MAX : RPM_QUALITY_STOPPED);
+            }
+        }
+    }
+#endif
+
+#ifdef USE_ESC_SENSOR
+    if (rpmSourceEnabled[RPM_SRC_ESC_SENSOR]) {
+        for (int motor = 0; motor < motorCount; motor++) {
+            const float rpm = getEscSensorRPM(motor) * motorRpmScale[motor];
+            uint8_t quality = 0;
+            if (isEscSensorValid(motor)) {
+                quality = rpm > 0 ? RPM_QUALITY_MAX : RPM_QUALITY_STOPPED;
+            }
+            // the telemetry frames are slower than the PID loop, the sample keeps the time its frame arrived
+            rpmSourceFeed(RPM_SRC_ESC_SENSOR, motor, getEscSensorRpmTimeUs(motor), rpm, quality);
+        }
+    }
+#endif
+
+#ifdef SIMULATOR_BUILD
+    if (rpmSourceEnabled[RPM_SRC_SIMULATOR]) {
+        for (int motor = 0; motor < motorCount; motor++) {
+            rpmSourceFeed(RPM_SRC_SIMULATOR, motor, currentTimeUs, simulatorGetMotorRpm(motor), RPM_QUALITY_MAX);
+        }
+    }
+#endif
+
+    UNUSED(currentTimeUs);
+    UNUSED(motorCount);
+}
+
+// Sample value extrapolated to the current time, over at most one sample interval
+static float rpmSourcePredict(const rpmSourceState_t *state, timeUs_t currentTimeUs)
+{
+    const timeDelta_t ageUs = cmpTimeUs(currentTimeUs, state->sample.timeUs);
+
+    if (ageUs <= 0 || ageUs > 2 * state->intervalUs) {
+        return state->sample.rpm;
+    }
+
+    return MAX(state->sample.rpm + state->slope * MIN(ageUs, state->intervalUs), 0.0f);
+}
+
+// called once per PID cycle, before the consumers of the motor rpm
+void rpmSourceUpdate(timeUs_t currentTimeUs)
+{
+    rpmSourceSample(currentTimeUs);
+
+    for (int motor = 0; motor < getMotorCount(); motor++) {
+        // the source with the best quality wins, ties go to the first (fastest) source
+        rpmSource_e best = RPM_SRC_NONE;
+        uint8_t bestQuality = 0;
+        for (int source = RPM_SRC_NONE + 1; source < RPM_SRC_COUNT; source++) {
+            const uint8_t quality = rpmSourceState[source][motor].sample.quality;
+            if (rpmSourceEnabled[source] && quality > bestQuality) {
+                best = source;
+                bestQuality = quality;
+            }
+        }
+
+        if (best == RPM_SRC_NONE && motorRpmSource[motor] != RPM_SRC_NONE) {
+            rpmSourceDropouts++;
+        }
+        motorRpmSource[motor] = best;
+        motorRpm[motor] = (best != RPM_SRC_NONE) ? rpmSourcePredict(&rpmSourceState[best][motor], currentTimeUs) : 0.0f;
+
+        pt1FilterApply(&motorRpmFilter[motor], motorRpm[motor]);
+    }
+
+    headspeedRpm = motorRpmFilter[0].state * headspeedScale;
+}
+
+int getMotorRPM(uint8_t motor)
+{
+    return motorRpm[motor];
+}
+
+float getFilteredMotorRPM(uint8_t motor)
+{
+    return motorRpmFilter[motor].state;
+}
+
+// Rotor speed from the filtered main motor rpm
+float getHeadspeedRPM(void)
+{
+    return headspeedRpm;
+}
+
+rpmSource_e getMotorRpmSource(uint8_t motor)
+{
+    return motorRpmSource[motor];
+}
+
+// Times since boot that a motor lost every rpm source it had
+uint32_t getRpmSourceDropouts(void)
+{
+    return rpmSourceDropouts;
+}
+
+bool isRpmSourceActive(void)
+{
+    for (int source = RPM_SRC_NONE + 1; source < RPM_SRC_COUNT; source++) {
+        if (rpmSourceEnabled[source]) {
+            return true;
+        }
+    }
+
+    return false;
+}
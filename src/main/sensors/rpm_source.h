@@ -0,0 +1,43 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/time.h"
+
+typedef enum {
+    RPM_SRC_NONE = 0,
+    RPM_SRC_DSHOT_TELEM,
+    RPM_SRC_FREQ_SENSOR,
+    RPM_SRC_ESC_SENSOR,
+#ifdef SIMULATOR_BUILD
+    RPM_SRC_SIMULATOR,
+#endif
+    RPM_SRC_COUNT
+} rpmSource_e;
+
+void rpmSourceInit(void);
+void rpmSourceUpdate(timeUs_t currentTimeUs);
+int getMotorRPM(uint8_t motor);
+float getFilteredMotorRPM(uint8_t motor);
+float getHeadspeedRPM(void);
+rpmSource_e getMotorRpmSource(uint8_t motor);
+uint32_t getRpmSourceDropouts(void);
+bool isRpmSourceActive(void);
@@ -178,6 +178,17 @@ void voltageMeterADCRefresh(void)
     }
 }
 
+// Latest oversampled reading in 0.01V steps, without the meter filter
+uint16_t voltageMeterADCSample(voltageSensorADC_e adcChannel)
+{
+#ifdef USE_ADC
+    return voltageAdcToVoltage(adcGetChannel(voltageMeterAdcChannelMap[adcChannel]), voltageSensorADCConfig(adcChannel));
+#else
+    UNUSED(adcChannel);
+    return 0;
+#endif
+}
+
 void voltageMeterADCRead(voltageSensorADC_e adcChannel, voltageMeter_t *voltageMeter)
 {
     voltageMeterADCState_t *state = &voltageMeterADCStates[adcChannel];
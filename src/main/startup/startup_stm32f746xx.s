@@ -138,6 +138,19 @@ LoopFillZerofastram_bss:
   cmp  r2, r3
   bcc  FillZerofastram_bss
 
+/* Mark the heap and stack, for the stack usage check */
+  ldr  r2, =_heap_stack_begin
+  b  LoopMarkHeapStack
+
+MarkHeapStack:
+  movs  r3, 0xa5a5a5a5
+  str  r3, [r2], #4
+
+LoopMarkHeapStack:
+  ldr  r3, = _heap_stack_end
+  cmp  r2, r3
+  bcc  MarkHeapStack
+
 /* Call the clock system initialization function.*/
   bl  SystemInit   
 /* Call the application's entry point.*/
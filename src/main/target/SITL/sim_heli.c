@@ -0,0 +1,213 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Built-in helicopter model for SITL. Lumped rotor dynamics, no
+ * horizontal translation: the rotor speed follows the ESC torque against
+ * the blade drag, collective gives thrust and the vertical motion, cyclic
+ * gives a first order roll/pitch rate response scaled by the rotor speed,
+ * and the yaw axis balances the main motor torque against the tail thrust.
+ * The constants are a 550-700 class heli, the speeds scale with
+ * gov_max_headspeed so the governor sees a plausible plant.
+ */
+
+#include <string.h>
+
+#include "common/maths.h"
+
+#include "target/SITL/sim_heli.h"
+
+#define SIM_HELI_GRAVITY            9.80665f
+
+#define SIM_HELI_MASS               3.0f        // kg
+#define SIM_HELI_ROTOR_INERTIA      0.12f       // kg m^2, main rotor and drive train
+#define SIM_HELI_YAW_INERTIA        0.25f       // kg m^2, fuselage around the shaft
+
+#define SIM_HELI_NO_LOAD_SPEED      1.2f        // rotor speed at full throttle without load, x gov_max_headspeed
+#define SIM_HELI_HOVER_SPEED        0.8f        // x gov_max_headspeed
+#define SIM_HELI_HOVER_COLLECTIVE   0.35f
+#define SIM_HELI_HOVER_THROTTLE     0.85f
+#define SIM_HELI_PROFILE_DRAG       0.5f        // share of the hover drag that does not depend on the collective
+
+#define SIM_HELI_SPOOLUP_TAU        0.4f        // s, free rotor speed time constant
+#define SIM_HELI_ESC_TAU            0.03f       // s
+#define SIM_HELI_CYCLIC_RATE        7.0f        // rad/s at full cyclic and hover headspeed
+#define SIM_HELI_CYCLIC_TAU         0.06f       // s
+#define SIM_HELI_TAIL_AUTHORITY     3.0f        // full tail thrust torque, x hover main rotor torque
+#define SIM_HELI_TAIL_DAMPING_TAU   0.1f        // s
+#define SIM_HELI_TAIL_MOTOR_TAU     0.05f       // s
+#define SIM_HELI_TAIL_MOTOR_RPM     20000.0f    // tail motor rpm at full throttle
+
+typedef struct simHeliModel_s {
+    float noLoadSpeed;              // rad/s
+    float hoverSpeed;               // rad/s
+    float motorStallTorque;         // Nm, falls linearly to zero at noLoadSpeed
+    float profileDrag;              // Nm / (rad/s)^2
+    float inducedDrag;              // Nm / (rad/s)^2 at full collective
+    float thrustCoeff;              // N / (rad/s)^2 at full collective
+    float tailTorque;               // Nm at full tail at hover headspeed
+    float yawDamping;               // Nm / (rad/s)
+} simHeliModel_t;
+
+static simHeliModel_t model;
+static simHeliState_t state;
+
+void simHeliInit(float maxHeadspeedRpm)
+{
+    const float maxSpeed = MAX(maxHeadspeedRpm, 100.0f) * (2.0f * M_PIf / 60.0f);
+
+    model.noLoadSpeed = SIM_HELI_NO_LOAD_SPEED * maxSpeed;
+    model.hoverSpeed = SIM_HELI_HOVER_SPEED * maxSpeed;
+    model.motorStallTorque = SIM_HELI_ROTOR_INERTIA * model.noLoadSpeed / SIM_HELI_SPOOLUP_TAU;
+
+    // the hover throttle holds the hover headspeed against the hover drag
+    const float hoverDrag = model.motorStallTorque * (SIM_HELI_HOVER_THROTTLE - model.hoverSpeed / model.noLoadSpeed);
+    const float hoverSpeedSq = sq(model.hoverSpeed);
+    model.profileDrag = SIM_HELI_PROFILE_DRAG * hoverDrag / hoverSpeedSq;
+    model.inducedDrag = (1.0f - SIM_HELI_PROFILE_DRAG) * hoverDrag / (sq(SIM_HELI_HOVER_COLLECTIVE) * hoverSpeedSq);
+    model.thrustCoeff = SIM_HELI_MASS * SIM_HELI_GRAVITY / (SIM_HELI_HOVER_COLLECTIVE * hoverSpeedSq);
+
+    model.tailTorque = SIM_HELI_TAIL_AUTHORITY * hoverDrag;
+    model.yawDamping = SIM_HELI_YAW_INERTIA / SIM_HELI_TAIL_DAMPING_TAU;
+
+    memset(&state, 0, sizeof(state));
+    state.quat[0] = 1.0f;
+    state.specificForce[2] = SIM_HELI_GRAVITY;
+    state.onGround = true;
+}
+
+static void simHeliIntegrateAttitude(float dt)
+{
+    const float gx = 0.5f * dt * state.rates[0];
+    const float gy = 0.5f * dt * state.rates[1];
+    const float gz = 0.5f * dt * state.rates[2];
+    const float w = state.quat[0];
+    const float x = state.quat[1];
+    const float y = state.quat[2];
+    const float z = state.quat[3];
+
+    // same convention as the AHRS integration in flight/imu.c
+    state.quat[0] = w - x * gx - y * gy - z * gz;
+    state.quat[1] = x + w * gx + y * gz - z * gy;
+    state.quat[2] = y + w * gy - x * gz + z * gx;
+    state.quat[3] = z + w * gz + x * gy - y * gx;
+
+    const float norm = sqrtf(sq(state.quat[0]) + sq(state.quat[1]) + sq(state.quat[2]) + sq(state.quat[3]));
+    for (int i = 0; i < 4; i++) {
+        state.quat[i] /= norm;
+    }
+}
+
+// Keep the heading, drop the roll and pitch
+static void simHeliLevelAttitude(void)
+{
+    const float norm = sqrtf(sq(state.quat[0]) + sq(state.quat[3]));
+
+    if (norm > 0) {
+        state.quat[0] /= norm;
+        state.quat[3] /= norm;
+    } else {
+        state.quat[0] = 1.0f;
+    }
+    state.quat[1] = 0;
+    state.quat[2] = 0;
+}
+
+void simHeliStep(const simHeliInput_t *input, float dt)
+{
+    const float collective = constrainf(input->collective, -1.0f, 1.0f);
+    const float speedRatio = state.headspeed / model.hoverSpeed;
+    const float authority = sq(speedRatio);
+
+    // ESC and motor, the ESC does not brake
+    state.escOutput += (constrainf(input->throttle, 0.0f, 1.0f) - state.escOutput) * MIN(dt / SIM_HELI_ESC_TAU, 1.0f);
+    const float motorTorque = MAX(model.motorStallTorque * (state.escOutput - state.headspeed / model.noLoadSpeed), 0.0f);
+
+    // rotor
+    const float dragTorque = (model.profileDrag + model.inducedDrag * sq(collective)) * sq(state.headspeed);
+    state.headspeed = MAX(state.headspeed + (motorTorque - dragTorque) * dt / SIM_HELI_ROTOR_INERTIA, 0.0f);
+    const float thrust = model.thrustCoeff * collective * sq(state.headspeed);
+
+    // roll and pitch follow the cyclic
+    const float cyclicGain = MIN(dt / SIM_HELI_CYCLIC_TAU, 1.0f);
+    state.rates[0] += (constrainf(input->cyclicRoll, -1.0f, 1.0f) * SIM_HELI_CYCLIC_RATE * authority - state.rates[0]) * cyclicGain;
+    state.rates[1] += (constrainf(input->cyclicPitch, -1.0f, 1.0f) * SIM_HELI_CYCLIC_RATE * authority - state.rates[1]) * cyclicGain;
+
+    // yaw balances the main motor reaction torque against the tail
+    float tailTorque;
+    if (input->motorizedTail) {
+        state.tailSpeed += (constrainf(input->tailThrottle, 0.0f, 1.0f) - state.tailSpeed) * MIN(dt / SIM_HELI_TAIL_MOTOR_TAU, 1.0f);
+        tailTorque = model.tailTorque * sq(state.tailSpeed);
+    } else {
+        tailTorque = model.tailTorque * constrainf(input->tailPitch, -1.0f, 1.0f) * authority;
+    }
+    const float yawTorque = tailTorque - motorTorque - model.yawDamping * MAX(speedRatio, 0.1f) * state.rates[2];
+    state.rates[2] += yawTorque * dt / SIM_HELI_YAW_INERTIA;
+
+    // earth up in body axes, from the last row of the rotation matrix
+    const float *q = state.quat;
+    const float up[3] = {
+        2.0f * (q[1] * q[3] - q[0] * q[2]),
+        2.0f * (q[2] * q[3] + q[0] * q[1]),
+        sq(q[0]) - sq(q[1]) - sq(q[2]) + sq(q[3]),
+    };
+
+    // vertical motion, the skids push back while on the ground
+    float normalForce = 0;
+    float climbAccel = thrust * up[2] / SIM_HELI_MASS - SIM_HELI_GRAVITY;
+    state.onGround = state.altitude <= 0 && climbAccel <= 0;
+    if (state.onGround) {
+        normalForce = -climbAccel * SIM_HELI_MASS;
+        climbAccel = 0;
+        state.altitude = 0;
+        state.climbRate = 0;
+    }
+    state.climbRate += climbAccel * dt;
+    state.altitude = MAX(state.altitude + state.climbRate * dt, 0.0f);
+
+    if (state.onGround) {
+        state.rates[0] = 0;
+        state.rates[1] = 0;
+        state.rates[2] = 0;
+        simHeliLevelAttitude();
+    } else {
+        simHeliIntegrateAttitude(dt);
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        state.specificForce[axis] = normalForce * up[axis] / SIM_HELI_MASS;
+    }
+    state.specificForce[2] += thrust / SIM_HELI_MASS;
+}
+
+const simHeliState_t *simHeliGetState(void)
+{
+    return &state;
+}
+
+float simHeliGetHeadspeedRpm(void)
+{
+    return state.headspeed * (60.0f / (2.0f * M_PIf));
+}
+
+float simHeliGetTailMotorRpm(void)
+{
+    return state.tailSpeed * SIM_HELI_TAIL_MOTOR_RPM;
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+// model integration step, the sensors are refreshed at this rate
+#define SIM_HELI_STEP_US    100
+
+typedef struct simHeliInput_s {
+    float throttle;                 // main motor ESC command [0;1]
+    float tailThrottle;             // tail motor ESC command [0;1], used with a motorized tail
+    bool motorizedTail;
+    float collective;               // swash commands [-1;1]
+    float cyclicRoll;
+    float cyclicPitch;
+    float tailPitch;                // tail rotor pitch command [-1;1], used with a servo driven tail
+} simHeliInput_t;
+
+// Firmware body axes: x roll, y pitch, z yaw. The specific force reads +1G on z at rest.
+typedef struct simHeliState_s {
+    float headspeed;                // rad/s
+    float escOutput;                // lagged main motor command [0;1]
+    float tailSpeed;                // motorized tail, fraction of the full throttle speed
+    float rates[3];                 // rad/s
+    float quat[4];                  // w, x, y, z, body to earth
+    float specificForce[3];         // m/s/s
+    float altitude;                 // m above the ground
+    float climbRate;                // m/s
+    bool onGround;
+} simHeliState_t;
+
+void simHeliInit(float maxHeadspeedRpm);
+void simHeliStep(const simHeliInput_t *input, float dt);
+const simHeliState_t *simHeliGetState(void);
+float simHeliGetHeadspeedRpm(void);
+float simHeliGetTailMotorRpm(void);
@@ -0,0 +1,426 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Blackbox replay for SITL. Reads a decoded blackbox log (CSV), drives the
+ * PID loop task (gyroUpdate, pidController, mixTable, the servo mixer) on
+ * the simulated clock with the logged raw gyro, rcCommand and headspeed,
+ * and writes the log back with the fields the firmware computes replaced
+ * by the values of this build and config. The raw gyro is interpolated
+ * between the log rows at the gyro rate. Nothing depends on the wall
+ * clock, the same log and config always give the same output.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+
+#include "drivers/accgyro/accgyro_fake.h"
+
+#include "fc/core.h"
+#include "fc/rc_controls.h"
+#include "fc/runtime_config.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+#include "flight/servos.h"
+
+#include "sensors/gyro.h"
+
+#include "target/SITL/sim_replay.h"
+
+#define REPLAY_MAX_COLUMNS          256
+#define REPLAY_WARMUP_MAX_US        10000000    // gyro calibration before the replay starts
+#define REPLAY_GYRO_SCALE           16.4f       // fake gyro LSB per deg/s
+
+typedef enum {
+    REPLAY_FIELD_NONE = 0,
+    // computed by the firmware, replaced in the output
+    REPLAY_FIELD_GYRO_ADC,
+    REPLAY_FIELD_GYRO_UNFILT,
+    REPLAY_FIELD_AXIS_P,
+    REPLAY_FIELD_AXIS_I,
+    REPLAY_FIELD_AXIS_D,
+    REPLAY_FIELD_AXIS_F,
+    REPLAY_FIELD_SETPOINT,
+    REPLAY_FIELD_MOTOR,
+    REPLAY_FIELD_SERVO,
+    REPLAY_FIELD_DEBUG,
+    REPLAY_FIELD_OUTPUT_COUNT,
+} replayField_e;
+
+typedef struct replayFieldName_s {
+    const char *name;
+    replayField_e field;
+    uint8_t count;
+} replayFieldName_t;
+
+static const replayFieldName_t replayFieldNames[] = {
+    { "gyroADC",    REPLAY_FIELD_GYRO_ADC,    XYZ_AXIS_COUNT },
+    { "gyroUnfilt", REPLAY_FIELD_GYRO_UNFILT, XYZ_AXIS_COUNT },
+    { "axisP",      REPLAY_FIELD_AXIS_P,      XYZ_AXIS_COUNT },
+    { "axisI",      REPLAY_FIELD_AXIS_I,      XYZ_AXIS_COUNT },
+    { "axisD",      REPLAY_FIELD_AXIS_D,      XYZ_AXIS_COUNT },
+    { "axisF",      REPLAY_FIELD_AXIS_F,      XYZ_AXIS_COUNT },
+    { "setpoint",   REPLAY_FIELD_SETPOINT,    4 },
+    { "motor",      REPLAY_FIELD_MOTOR,       MAX_SUPPORTED_MOTORS },
+    { "servo",      REPLAY_FIELD_SERVO,       MAX_SUPPORTED_SERVOS },
+    { "debug",      REPLAY_FIELD_DEBUG,       DEBUG16_VALUE_COUNT },
+};
+
+typedef struct replayColumn_s {
+    replayField_e field;
+    uint8_t index;
+} replayColumn_t;
+
+// one decoded row of the inputs
+typedef struct replaySample_s {
+    uint32_t timeUs;
+    float gyro[XYZ_AXIS_COUNT];     // deg/s
+    float rcCommand[5];
+    float headspeed;
+} replaySample_t;
+
+typedef struct replayState_s {
+    FILE *in;
+    FILE *out;
+    const char *separator;
+    int columnCount;
+    replayColumn_t columns[REPLAY_MAX_COLUMNS];
+    int timeColumn;
+    int gyroColumn[XYZ_AXIS_COUNT];
+    int rcCommandColumn[5];
+    int headspeedColumn;
+    char *line;
+    size_t lineSize;
+    char *tokens[REPLAY_MAX_COLUMNS];
+    replaySample_t sample;
+} replayState_t;
+
+static replayState_t replay;
+
+// Splits the line in place, the separator is a comma with optional spaces
+static int replaySplit(char *line, char **tokens)
+{
+    int count = 0;
+    char *p = line;
+
+    line[strcspn(line, "\r\n")] = 0;
+    while (count < REPLAY_MAX_COLUMNS) {
+        while (*p == ' ') {
+            p++;
+        }
+        tokens[count++] = p;
+        char *comma = strchr(p, ',');
+        if (!comma) {
+            break;
+        }
+        *comma = 0;
+        p = comma + 1;
+    }
+
+    return count;
+}
+
+// "name[index]" or "name"
+static bool replayMatchName(const char *token, const char *name, int *index)
+{
+    const size_t len = strlen(name);
+
+    if (strncmp(token, name, len) != 0) {
+        return false;
+    }
+    if (token[len] == 0 || token[len] == ' ') {
+        *index = -1;
+        return true;
+    }
+    if (token[len] == '[') {
+        *index = atoi(token + len + 1);
+        return true;
+    }
+    return false;
+}
+
+static bool replayParseHeader(void)
+{
+    if (getline(&replay.line, &replay.lineSize, replay.in) <= 0) {
+        return false;
+    }
+    replay.separator = strstr(replay.line, ", ") ? ", " : ",";
+    replay.columnCount = replaySplit(replay.line, replay.tokens);
+
+    int gyroUnfiltColumn[XYZ_AXIS_COUNT];
+    int gyroAdcColumn[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroUnfiltColumn[axis] = gyroAdcColumn[axis] = -1;
+    }
+    for (int i = 0; i < 5; i++) {
+        replay.rcCommandColumn[i] = -1;
+    }
+    replay.timeColumn = -1;
+    replay.headspeedColumn = -1;
+
+    for (int col = 0; col < replay.columnCount; col++) {
+        const char *token = replay.tokens[col];
+        int index;
+
+        replay.columns[col].field = REPLAY_FIELD_NONE;
+        for (unsigned i = 0; i < ARRAYLEN(replayFieldNames); i++) {
+            if (replayMatchName(token, replayFieldNames[i].name, &index) && index >= 0 && index < replayFieldNames[i].count) {
+                replay.columns[col].field = replayFieldNames[i].field;
+                replay.columns[col].index = index;
+                break;
+            }
+        }
+
+        if (replayMatchName(token, "time", &index)) {
+            replay.timeColumn = col;
+        } else if (replayMatchName(token, "headspeed", &index)) {
+            replay.headspeedColumn = col;
+        } else if (replayMatchName(token, "rcCommand", &index) && index >= 0 && index < 5) {
+            replay.rcCommandColumn[index] = col;
+        } else if (replayMatchName(token, "gyroUnfilt", &index) && index >= 0 && index < XYZ_AXIS_COUNT) {
+            gyroUnfiltColumn[index] = col;
+        } else if (replayMatchName(token, "gyroADC", &index) && index >= 0 && index < XYZ_AXIS_COUNT) {
+            gyroAdcColumn[index] = col;
+        }
+    }
+
+    // fall back to the filtered gyro, the filters then run twice
+    const bool haveUnfilt = gyroUnfiltColumn[X] >= 0 && gyroUnfiltColumn[Y] >= 0 && gyroUnfiltColumn[Z] >= 0;
+    if (!haveUnfilt) {
+        fprintf(stderr, "[replay]no gyroUnfilt fields, replaying the filtered gyroADC\n");
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        replay.gyroColumn[axis] = haveUnfilt ? gyroUnfiltColumn[axis] : gyroAdcColumn[axis];
+        if (replay.gyroColumn[axis] < 0) {
+            fprintf(stderr, "[replay]no gyro field for axis %d\n", axis);
+            return false;
+        }
+    }
+    if (replay.timeColumn < 0) {
+        fprintf(stderr, "[replay]no time field\n");
+        return false;
+    }
+
+    // the header goes out unchanged
+    for (int col = 0; col < replay.columnCount; col++) {
+        fprintf(replay.out, "%s%s", col ? replay.separator : "", replay.tokens[col]);
+    }
+    fprintf(replay.out, "\n");
+
+    return true;
+}
+
+static float replayColumnValue(int col, float fallback)
+{
+    if (col < 0 || col >= replay.columnCount || replay.tokens[col][0] == 0) {
+        return fallback;
+    }
+    return strtof(replay.tokens[col], NULL);
+}
+
+static bool replayReadRow(replaySample_t *sample)
+{
+    // skip the event and comment lines some decoders put in between
+    while (getline(&replay.line, &replay.lineSize, replay.in) > 0) {
+        if (replaySplit(replay.line, replay.tokens) < replay.columnCount) {
+            continue;
+        }
+
+        sample->timeUs = strtoul(replay.tokens[replay.timeColumn], NULL, 10);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            sample->gyro[axis] = replayColumnValue(replay.gyroColumn[axis], 0);
+        }
+        for (int i = 0; i < 5; i++) {
+            sample->rcCommand[i] = replayColumnValue(replay.rcCommandColumn[i], i == THROTTLE ? 1000 : 0);
+        }
+        sample->headspeed = replayColumnValue(replay.headspeedColumn, 0);
+        return true;
+    }
+
+    return false;
+}
+
+static int32_t replayOutputValue(const replayColumn_t *column)
+{
+    const int i = column->index;
+
+    switch (column->field) {
+    case REPLAY_FIELD_GYRO_ADC:
+        return lrintf(gyro.gyroADCf[i]);
+    case REPLAY_FIELD_GYRO_UNFILT:
+        return lrintf(gyro.gyroADC[i]);
+    case REPLAY_FIELD_AXIS_P:
+        return lrintf(pidData[i].P);
+    case REPLAY_FIELD_AXIS_I:
+        return lrintf(pidData[i].I);
+    case REPLAY_FIELD_AXIS_D:
+        return lrintf(pidData[i].D);
+    case REPLAY_FIELD_AXIS_F:
+        return lrintf(pidData[i].F);
+    case REPLAY_FIELD_SETPOINT:
+        return (i < XYZ_AXIS_COUNT) ? lrintf(pidGetPreviousSetpoint(i)) : lrintf(mixerGetThrottle() * 1000);
+    case REPLAY_FIELD_MOTOR:
+        return lrintf(motor[i]);
+    case REPLAY_FIELD_SERVO:
+        return servo[i];
+    case REPLAY_FIELD_DEBUG:
+        return debug[i];
+    default:
+        return 0;
+    }
+}
+
+static void replayWriteRow(void)
+{
+    for (int col = 0; col < replay.columnCount; col++) {
+        if (col) {
+            fputs(replay.separator, replay.out);
+        }
+        if (replay.columns[col].field != REPLAY_FIELD_NONE) {
+            fprintf(replay.out, "%d", (int)replayOutputValue(&replay.columns[col]));
+        } else {
+            fputs(replay.tokens[col], replay.out);
+        }
+    }
+    fputc('\n', replay.out);
+}
+
+static void replaySetGyro(const float *gyroDps)
+{
+    fakeGyroSet(fakeGyroDev,
+        constrain(lrintf(gyroDps[X] * REPLAY_GYRO_SCALE), -32767, 32767),
+        constrain(lrintf(gyroDps[Y] * REPLAY_GYRO_SCALE), -32767, 32767),
+        constrain(lrintf(gyroDps[Z] * REPLAY_GYRO_SCALE), -32767, 32767));
+}
+
+static void replaySetRc(const replaySample_t *sample)
+{
+    for (int i = 0; i < 5; i++) {
+        rcCommand[i] = sample->rcCommand[i];
+    }
+    // the setpoints follow on the next PID loop, as after a received frame
+    isRXDataNew = true;
+}
+
+bool simReplayOpen(const char *inFileName, const char *outFileName)
+{
+    replay.in = fopen(inFileName, "r");
+    if (!replay.in) {
+        fprintf(stderr, "[replay]failed to open '%s'\n", inFileName);
+        return false;
+    }
+    replay.out = fopen(outFileName, "w");
+    if (!replay.out) {
+        fprintf(stderr, "[replay]failed to create '%s'\n", outFileName);
+        return false;
+    }
+    if (!replayParseHeader()) {
+        fprintf(stderr, "[replay]'%s' is not a decoded blackbox log\n", inFileName);
+        return false;
+    }
+
+    printf("[replay]'%s' -> '%s'\n", inFileName, outFileName);
+    return true;
+}
+
+bool simReplayHasHeadspeed(void)
+{
+    return replay.headspeedColumn >= 0;
+}
+
+float simReplayGetMotorRpm(uint8_t motor)
+{
+    if (motor == 0) {
+        return replay.sample.headspeed * mixerConfig()->gov_gear_ratio / 1000.0f;
+    }
+    return 0;
+}
+
+void simReplayRun(void)
+{
+    const uint32_t looptimeUs = MAX(gyro.targetLooptime, 1U);
+    uint64_t timeUs = micros64();
+    const uint64_t startRealUs = micros64_real();
+
+    // let the gyro calibrate on a still gyro, disarmed
+    const float still[XYZ_AXIS_COUNT] = { 0, 0, 0 };
+    const uint64_t warmupEndUs = timeUs + REPLAY_WARMUP_MAX_US;
+    while (!gyroIsCalibrationComplete() && timeUs < warmupEndUs) {
+        timeUs += looptimeUs;
+        simulatorSetTimeUs(timeUs);
+        replaySetGyro(still);
+        taskMainPidLoop(timeUs);
+    }
+
+    // the log only covers the armed flight, the arming checks don't apply
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    replaySample_t previous;
+    uint32_t rows = 0;
+    uint64_t logStartUs = 0;
+    const uint64_t replayStartUs = timeUs;
+
+    while (replayReadRow(&replay.sample)) {
+        const replaySample_t *next = &replay.sample;
+
+        if (rows == 0) {
+            logStartUs = next->timeUs;
+            previous = *next;
+            replaySetRc(next);
+        }
+
+        // run the PID loop at the gyro rate up to the row, on the gyro of the row before
+        const uint64_t rowTimeUs = replayStartUs + (next->timeUs - logStartUs);
+        const float spanUs = MAX((float)(next->timeUs - previous.timeUs), 1.0f);
+        while (timeUs + looptimeUs <= rowTimeUs) {
+            timeUs += looptimeUs;
+            const float ratio = constrainf((float)(timeUs - (replayStartUs + (previous.timeUs - logStartUs))) / spanUs, 0.0f, 1.0f);
+            float gyroDps[XYZ_AXIS_COUNT];
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                gyroDps[axis] = previous.gyro[axis] + (next->gyro[axis] - previous.gyro[axis]) * ratio;
+            }
+            simulatorSetTimeUs(timeUs);
+            replaySetGyro(gyroDps);
+            taskMainPidLoop(timeUs);
+        }
+
+        replayWriteRow();
+        replaySetRc(next);
+        previous = *next;
+        rows++;
+    }
+
+    fclose(replay.in);
+    fclose(replay.out);
+
+    const double flightS = (timeUs - replayStartUs) * 1e-6;
+    const double realS = MAX(micros64_real() - startRealUs, 1U) * 1e-6;
+    printf("[replay]%u rows, %.1fs of flight in %.1fs (%.0fx real time)\n", rows, flightS, realS, flightS / realS);
+}
@@ -44,6 +44,8 @@ const timerHardware_t timerHardware[1]; // unused
 
 #include "drivers/accgyro/accgyro_fake.h"
 #include "flight/imu.h"
+#include "flight/mixer.h"
+#include "flight/servos.h"
 
 #include "config/feature.h"
 #include "config/config.h"
@@ -56,6 +58,8 @@ const timerHardware_t timerHardware[1]; // unused
 
 #include "dyad.h"
 #include "target/SITL/udplink.h"
+#include "target/SITL/sim_heli.h"
+#include "target/SITL/sim_replay.h"
 
 uint32_t SystemCoreClock;
 
@@ -70,6 +74,16 @@ static udpLink_t stateLink, pwmLink;
 static pthread_mutex_t updateLock;
 static pthread_mutex_t mainLoopLock;
 
+// The heli and replay modes run the firmware in lock-step with a simulated
+// clock instead of exchanging packets with gazebo in real time.
+#define SIM_LOCKSTEP_TICK_US 10     // simulated time taken by one main loop pass
+
+static bool lockstepMode = false;
+static bool heliMode = false;
+static bool replayMode = false;
+static uint64_t lockstepTimeUs = 0;
+static uint64_t heliModelTimeUs = 0;
+
 int timeval_sub(struct timespec *result, struct timespec *x, struct timespec *y);
 
 int lockMainPID(void) {
@@ -82,27 +96,7 @@ int lockMainPID(void) {
 void sendMotorUpdate() {
     udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
 }
-void updateState(const fdm_packet* pkt) {
-    static double last_timestamp = 0; // in seconds
-    static uint64_t last_realtime = 0; // in uS
-    static struct timespec last_ts; // last packet
-
-    struct timespec now_ts;
-    clock_gettime(CLOCK_MONOTONIC, &now_ts);
-
-    const uint64_t realtime_now = micros64_real();
-    if (realtime_now > last_realtime + 500*1e3) { // 500ms timeout
-        last_timestamp = pkt->timestamp;
-        last_realtime = realtime_now;
-        sendMotorUpdate();
-        return;
-    }
-
-    const double deltaSim = pkt->timestamp - last_timestamp;  // in seconds
-    if (deltaSim < 0) { // don't use old packet
-        return;
-    }
-
+static void updateSensors(const fdm_packet* pkt) {
     int16_t x,y,z;
     x = constrain(-pkt->imu_linear_acceleration_xyz[0] * ACC_SCALE, -32767, 32767);
     y = constrain(-pkt->imu_linear_acceleration_xyz[1] * ACC_SCALE, -32767, 32767);
@@ -146,6 +140,30 @@ void updateState(const fdm_packet* pkt) {
     imuSetAttitudeQuat(pkt->imu_orientation_quat[0], pkt->imu_orientation_quat[1], pkt->imu_orientation_quat[2], pkt->imu_orientation_quat[3]);
 #endif
 #endif
+}
+
+void updateState(const fdm_packet* pkt) {
+    static double last_timestamp = 0; // in seconds
+    static uint64_t last_realtime = 0; // in uS
+    static struct timespec last_ts; // last packet
+
+    struct timespec now_ts;
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+
+    const uint64_t realtime_now = micros64_real();
+    if (realtime_now > last_realtime + 500*1e3) { // 500ms timeout
+        last_timestamp = pkt->timestamp;
+        last_realtime = realtime_now;
+        sendMotorUpdate();
+        return;
+    }
+
+    const double deltaSim = pkt->timestamp - last_timestamp;  // in seconds
+    if (deltaSim < 0) { // don't use old packet
+        return;
+    }
+
+    updateSensors(pkt);
 
 #if defined(SIMULATOR_IMU_SYNC)
     imuSetHasNewData(deltaSim*1e6);
@@ -231,16 +249,32 @@ void systemInit(void) {
         exit(1);
     }
 
-    ret = udpInit(&pwmLink, "127.0.0.1", 9002, false);
-    printf("init PwmOut UDP link...%d\n", ret);
+    const char *heliEnv = getenv("SITL_HELI");
+    const char *replayEnv = getenv("SITL_REPLAY");
+    heliMode = heliEnv && strcmp(heliEnv, "0") != 0;
+    replayMode = replayEnv && replayEnv[0];
+    lockstepMode = heliMode || replayMode;
 
-    ret = udpInit(&stateLink, NULL, 9003, true);
-    printf("start UDP server...%d\n", ret);
+    if (replayMode) {
+        const char *outEnv = getenv("SITL_REPLAY_OUT");
+        if (!simReplayOpen(replayEnv, (outEnv && outEnv[0]) ? outEnv : "replay.csv")) {
+            exit(1);
+        }
+        heliMode = false;
+    } else if (heliMode) {
+        printf("[system]heli model, lock-step %dus per loop\n", SIM_LOCKSTEP_TICK_US);
+    } else {
+        ret = udpInit(&pwmLink, "127.0.0.1", 9002, false);
+        printf("init PwmOut UDP link...%d\n", ret);
 
-    ret = pthread_create(&udpWorker, NULL, udpThread, NULL);
-    if (ret != 0) {
-        printf("Create udpWorker error!\n");
-        exit(1);
+        ret = udpInit(&stateLink, NULL, 9003, true);
+        printf("start UDP server...%d\n", ret);
+
+        ret = pthread_create(&udpWorker, NULL, udpThread, NULL);
+        if (ret != 0) {
+            printf("Create udpWorker error!\n");
+            exit(1);
+        }
     }
 
     // serial can't been slow down
@@ -251,7 +285,9 @@ void systemReset(void){
     printf("[system]Reset!\n");
     workerRunning = false;
     pthread_join(tcpWorker, NULL);
-    pthread_join(udpWorker, NULL);
+    if (!lockstepMode) {
+        pthread_join(udpWorker, NULL);
+    }
     exit(0);
 }
 void systemResetToBootloader(bootloaderRequestType_e requestType) {
@@ -260,7 +296,9 @@ void systemResetToBootloader(bootloaderRequestType_e requestType) {
     printf("[system]ResetToBootloader!\n");
     workerRunning = false;
     pthread_join(tcpWorker, NULL);
-    pthread_join(udpWorker, NULL);
+    if (!lockstepMode) {
+        pthread_join(udpWorker, NULL);
+    }
     exit(0);
 }
 
@@ -307,6 +345,10 @@ uint64_t micros64() {
     static uint64_t out = 0;
     uint64_t now = nanos64_real();
 
+    if (lockstepMode) {
+        return lockstepTimeUs;
+    }
+
     out += (now - last) * simRate;
     last = now;
 
@@ -319,6 +361,10 @@ uint64_t millis64() {
     static uint64_t out = 0;
     uint64_t now = nanos64_real();
 
+    if (lockstepMode) {
+        return lockstepTimeUs / 1000;
+    }
+
     out += (now - last) * simRate;
     last = now;
 
@@ -341,7 +387,13 @@ void microsleep(uint32_t usec) {
     while (nanosleep(&ts, &ts) == -1 && errno == EINTR) ;
 }
 
+static void simulatorAdvance(uint32_t us);
+
 void delayMicroseconds(uint32_t us) {
+    if (lockstepMode) {
+        simulatorAdvance(us);
+        return;
+    }
     microsleep(us / simRate);
 }
 
@@ -350,6 +402,11 @@ void delayMicroseconds_real(uint32_t us) {
 }
 
 void delay(uint32_t ms) {
+    if (lockstepMode) {
+        simulatorAdvance(ms * 1000);
+        return;
+    }
+
     uint64_t start = millis64();
 
     while ((millis64() - start) < ms) {
@@ -458,6 +515,10 @@ static void pwmCompleteMotorUpdate(void)
     pwmPkt.motor_speed[1] = motorsPwm[2] / outScale;
     pwmPkt.motor_speed[2] = motorsPwm[3] / outScale;
 
+    if (lockstepMode) {
+        return;
+    }
+
     // get one "fdm_packet" can only send one "servo_packet"!!
     if (pthread_mutex_trylock(&updateLock) != 0) return;
     udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
@@ -468,6 +529,10 @@ void pwmWriteServo(uint8_t index, float value) {
     servosPwm[index] = value;
 }
 
+void pwmCompleteServoUpdate(uint32_t windowUs) {
+    UNUSED(windowUs);
+}
+
 static motorDevice_t motorPwmDevice = {
     .vTable = {
         .postInit = motorPostInitNull,
@@ -502,9 +567,123 @@ motorDevice_t *motorPwmDevInit(const motorDevConfig_t *motorConfig, uint16_t _id
     motorPwmDevice.initialized = true;
     motorPwmDevice.enabled = false;
 
+    if (heliMode) {
+        // the config is loaded by now
+        simHeliInit(mixerConfig()->gov_max_headspeed);
+    }
+
     return &motorPwmDevice;
 }
 
+// Heli model part
+static float servoDeflection(uint8_t index)
+{
+    if (servosPwm[index] == 0) { // not written yet
+        return 0;
+    }
+    const servoParam_t *param = servoParams(index);
+    return (servosPwm[index] - param->middle) / (0.5f * MAX(param->max - param->min, 1));
+}
+
+// Undo the default 120 degree CCPM HELI_120_CCPM servo rules
+static void simulatorHeliInput(simHeliInput_t *input)
+{
+    const float left = servoDeflection(SERVO_HELI_LEFT);
+    const float right = servoDeflection(SERVO_HELI_RIGHT);
+    const float top = servoDeflection(SERVO_HELI_TOP);
+
+    input->throttle = motorPwmDevice.enabled ? motorsPwm[0] / 1000.0f : 0;
+    input->motorizedTail = motorPwmDevice.count > 1;
+    input->tailThrottle = (input->motorizedTail && motorPwmDevice.enabled) ? motorsPwm[1] / 1000.0f : 0;
+    input->collective = (left + right + top) / 3.0f;
+    input->cyclicPitch = top - input->collective;
+    input->cyclicRoll = (right - left) / 1.74f;
+    input->tailPitch = servoDeflection(SERVO_HELI_RUD);
+}
+
+static void simulatorHeliSensors(void)
+{
+    const simHeliState_t *heli = simHeliGetState();
+    fdm_packet pkt;
+
+    // back to the gazebo conventions expected by updateSensors()
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.timestamp = lockstepTimeUs * 1e-6;
+    pkt.imu_angular_velocity_rpy[0] = heli->rates[0];
+    pkt.imu_angular_velocity_rpy[1] = -heli->rates[1];
+    pkt.imu_angular_velocity_rpy[2] = -heli->rates[2];
+    for (int axis = 0; axis < 3; axis++) {
+        pkt.imu_linear_acceleration_xyz[axis] = -heli->specificForce[axis];
+    }
+    pkt.imu_orientation_quat[0] = heli->quat[0];
+    pkt.imu_orientation_quat[1] = heli->quat[1];
+    pkt.imu_orientation_quat[2] = -heli->quat[2];
+    pkt.imu_orientation_quat[3] = -heli->quat[3];
+    pkt.position_xyz[2] = -heli->altitude;
+    pkt.velocity_xyz[2] = -heli->climbRate;
+
+    updateSensors(&pkt);
+}
+
+// Move the simulated clock, the model catches up in fixed steps
+static void simulatorAdvance(uint32_t us)
+{
+    lockstepTimeUs += us;
+
+    if (!heliMode) {
+        return;
+    }
+
+    if (!motorPwmDevice.initialized || !fakeGyroDev || !fakeAccDev) {
+        heliModelTimeUs = lockstepTimeUs;
+        return;
+    }
+
+    bool stepped = false;
+    while (lockstepTimeUs - heliModelTimeUs >= SIM_HELI_STEP_US) {
+        simHeliInput_t input;
+        simulatorHeliInput(&input);
+        simHeliStep(&input, SIM_HELI_STEP_US * 1e-6f);
+        heliModelTimeUs += SIM_HELI_STEP_US;
+        stepped = true;
+    }
+
+    if (stepped) {
+        simulatorHeliSensors();
+    }
+}
+
+void simulatorSetTimeUs(uint64_t timeUs) {
+    lockstepTimeUs = timeUs;
+}
+
+void simulatorIdle(void) {
+    if (replayMode) {
+        // the replay drives the PID loop on its own, the main loop is not needed
+        simReplayRun();
+        systemReset();
+    } else if (heliMode) {
+        simulatorAdvance(SIM_LOCKSTEP_TICK_US);
+    } else {
+        delayMicroseconds_real(50); // max rate 20kHz
+    }
+}
+
+bool simulatorHasRpmSource(void) {
+    return heliMode || (replayMode && simReplayHasHeadspeed());
+}
+
+float simulatorGetMotorRpm(uint8_t motor) {
+    if (replayMode) {
+        return simReplayGetMotorRpm(motor);
+    } else if (motor == 0) {
+        return simHeliGetHeadspeedRpm() * mixerConfig()->gov_gear_ratio / 1000.0f;
+    } else if (motor == 1) {
+        return simHeliGetTailMotorRpm();
+    }
+    return 0;
+}
+
 // ADC part
 uint16_t adcGetChannel(uint8_t channel) {
     UNUSED(channel);
@@ -564,9 +743,14 @@ void FLASH_Lock(void) {
     }
 }
 
+#define FLASH_ERASE_PAGE_SIZE ((uintptr_t)0x400)
+
 FLASH_Status FLASH_ErasePage(uintptr_t Page_Address) {
-    UNUSED(Page_Address);
 //    printf("[FLASH_ErasePage]%x\n", Page_Address);
+    // erased flash reads back as all ones
+    if ((Page_Address >= (uintptr_t)eepromData) && (Page_Address < (uintptr_t)ARRAYEND(eepromData))) {
+        memset((void *)Page_Address, 0xFF, MIN(FLASH_ERASE_PAGE_SIZE, (uintptr_t)ARRAYEND(eepromData) - Page_Address));
+    }
     return FLASH_COMPLETE;
 }
 
@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 #include "common/utils.h"
 
@@ -255,4 +256,9 @@ uint64_t millis64(void);
 
 int lockMainPID(void);
 
+void simulatorIdle(void);
+void simulatorSetTimeUs(uint64_t timeUs);
+bool simulatorHasRpmSource(void);
+float simulatorGetMotorRpm(uint8_t motor);
+
 
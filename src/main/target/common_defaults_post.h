@@ -459,6 +459,11 @@
 #endif
 #endif
 
+#ifdef USE_HELI_ONLY
+#undef DEFAULT_MIXER
+#define DEFAULT_MIXER    MIXER_HELI_120_CCPM
+#endif
+
 #ifndef DEFAULT_MIXER
 #define DEFAULT_MIXER    MIXER_QUADX
 #endif
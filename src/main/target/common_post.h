@@ -32,8 +32,19 @@
 #undef USE_ESC_SENSOR
 #endif
 
+#if !defined(USE_SOFTSERIAL1) && !defined(USE_SOFTSERIAL2)
+#undef USE_SOFTSERIAL_DMA
+#endif
+
+#if !defined(USE_SERVOS) || defined(USE_QUAD_MIXER_ONLY)
+#undef USE_HELI_ONLY
+#endif
+
 #ifndef USE_ESC_SENSOR
 #undef USE_ESC_SENSOR_TELEMETRY
+#undef USE_ESC_SENSOR_KISS
+#undef USE_ESC_SENSOR_HOBBYWING
+#undef USE_ESC_SENSOR_DSHOT
 #endif
 
 // XXX Remove USE_BARO_BMP280 and USE_BARO_MS5611 if USE_I2C is not defined.
@@ -168,6 +179,10 @@
 #undef USE_FLASHFS
 #endif
 
+#if !defined(USE_FLASHFS) || !defined(USE_BLACKBOX)
+#undef USE_FLASHFS_LOG_INDEX
+#endif
+
 #if (!defined(USE_SDCARD) && !defined(USE_FLASHFS)) || !defined(USE_BLACKBOX)
 #undef USE_USB_MSC
 #endif
@@ -204,6 +219,34 @@
 #define USE_SPI_GYRO
 #endif
 
+// The acc data comes with the SPI reads of the MPU family and ICM42605 gyro drivers
+#if defined(USE_GYRO_ACC_BURST) && !(defined(USE_ACC) && (defined(USE_SPI_GYRO) || defined(USE_GYRO_SPI_ICM42605)))
+#undef USE_GYRO_ACC_BURST
+#endif
+
+// Reading the gyro from the data ready interrupt needs both
+#if defined(USE_GYRO_ISR_READ) && !(defined(USE_SPI_GYRO) && defined(USE_GYRO_EXTI))
+#undef USE_GYRO_ISR_READ
+#endif
+
+// Task profiles are kept next to the task statistics
+#if defined(USE_TASK_PROFILE) && !defined(USE_TASK_STATISTICS)
+#undef USE_TASK_PROFILE
+#endif
+
+// Running the PID loop from the data ready interrupt needs the samples read there
+#if defined(USE_GYRO_ISR_PID) && !defined(USE_GYRO_ISR_READ)
+#undef USE_GYRO_ISR_PID
+#endif
+
+#if defined(USE_BLACKBOX_OFFLOAD) && !defined(USE_BLACKBOX)
+#undef USE_BLACKBOX_OFFLOAD
+#endif
+
+#if defined(USE_BLACKBOX_COMPRESSION) && !(defined(USE_BLACKBOX) && defined(USE_HUFFMAN))
+#undef USE_BLACKBOX_COMPRESSION
+#endif
+
 // CX10 is a special case of SPI RX which requires XN297
 #if defined(USE_RX_CX10)
 #define USE_RX_XN297
@@ -272,6 +315,7 @@
 
 #ifndef USE_DSHOT_TELEMETRY
 #undef USE_DSHOT_TELEMETRY_STATS
+#undef USE_ESC_SENSOR_DSHOT
 #endif
 
 #if !defined(USE_BOARD_INFO)
@@ -341,6 +385,16 @@ extern uint8_t __config_start;   // configured via linker script when building b
 extern uint8_t __config_end;
 #endif
 
+#if !defined(CONFIG_IN_FLASH) && !defined(CONFIG_IN_FILE)
+#undef USE_CONFIG_BACKGROUND_SAVE
+#endif
+
+// Programming a flash bank stalls every fetch from that bank, so saving while armed would stall
+// the code it runs on. Only allowed when the config is in a bank the code doesn't run from.
+#if defined(CONFIG_IN_FLASH) && !defined(CONFIG_IN_SEPARATE_FLASH_BANK) && !defined(RAMBASED)
+#undef USE_CONFIG_BACKGROUND_SAVE
+#endif
+
 #if defined(USE_EXST) && !defined(RAMBASED)
 #define USE_FLASH_BOOT_LOADER
 #endif
@@ -60,8 +60,20 @@
 #define USE_DYN_IDLE
 #define I2C3_OVERCLOCK true
 #define USE_GYRO_DATA_ANALYSE
+#define USE_GYRO_FIFO
+#define USE_GYRO_ISR_READ
+#define USE_GYRO_ACC_BURST
+#define USE_TASK_PROFILE
+#define USE_BENCHMARK
+#define USE_DEBUG_CHANNELS
+#define USE_LOOPTIME_CHECK
+#define USE_LOOP_TIMING
+#define USE_BLACKBOX_OFFLOAD
 #define USE_ADC
 #define USE_ADC_INTERNAL
+#define USE_ADC_MOTOR_SYNC
+#define USE_PPM_DMA
+#define USE_SOFTSERIAL_DMA
 #define USE_USB_CDC_HID
 #define USE_USB_MSC
 #define USE_PERSISTENT_MSC_RTC
@@ -77,6 +89,11 @@
 #define USE_OVERCLOCK
 #endif
 
+#if defined(STM32F411xE)
+// integer gyro front end, samples are converted to float once at the end of it
+#define USE_GYRO_FIXED_POINT
+#endif
+
 #endif // STM32F4
 
 #ifdef STM32F7
@@ -92,8 +109,19 @@
 #define I2C3_OVERCLOCK true
 #define I2C4_OVERCLOCK true
 #define USE_GYRO_DATA_ANALYSE
+#define USE_GYRO_FIFO
+#define USE_GYRO_ISR_READ
+#define USE_GYRO_ACC_BURST
+#define USE_GYRO_ISR_PID
+#define USE_TASK_PROFILE
+#define USE_BENCHMARK
+#define USE_DEBUG_CHANNELS
+#define USE_LOOPTIME_CHECK
+#define USE_LOOP_TIMING
+#define USE_BLACKBOX_OFFLOAD
 #define USE_OVERCLOCK
 #define USE_ADC_INTERNAL
+#define USE_ADC_MOTOR_SYNC
 #define USE_USB_CDC_HID
 #define USE_USB_MSC
 #define USE_PERSISTENT_MSC_RTC
@@ -102,6 +130,7 @@
 #define USE_TIMER_MGMT
 #define USE_PERSISTENT_OBJECTS
 #define USE_CUSTOM_DEFAULTS_ADDRESS
+#define USE_CRC_HW
 // Re-enable this after 4.0 has been released, and remove the define from STM32F4DISCOVERY
 //#define USE_SPI_TRANSACTION
 #endif // STM32F7
@@ -115,15 +144,30 @@
 #define USE_RPM_FILTER
 #define USE_DYN_IDLE
 #define USE_GYRO_DATA_ANALYSE
+#define USE_GYRO_FIFO
+#define USE_GYRO_ISR_READ
+#define USE_GYRO_ACC_BURST
+#define USE_GYRO_ISR_PID
+#define USE_TASK_PROFILE
+#define USE_BENCHMARK
+#define USE_DEBUG_CHANNELS
+#define USE_LOOPTIME_CHECK
+#define USE_LOOP_TIMING
+#define USE_BLACKBOX_OFFLOAD
 #define USE_ADC_INTERNAL
 #define USE_USB_CDC_HID
 #define USE_DMA_SPEC
 #define USE_TIMER_MGMT
 #define USE_PERSISTENT_OBJECTS
 #define USE_DMA_RAM
+#define USE_CRC_HW
 #endif
 
 #if defined(STM32F4) || defined(STM32F7) || defined(STM32H7)
+#if defined(DEBUG)
+// paints the stack before every task and records the depth it reached, costs a few microseconds per task
+#define USE_TASK_STACK_CHECK
+#endif
 #define TASK_GYROPID_DESIRED_PERIOD     125 // 125us = 8kHz
 #define SCHEDULER_DELAY_LIMIT           10
 #else
@@ -214,12 +258,20 @@
 #define USE_RESOURCE_MGMT
 #define USE_RUNAWAY_TAKEOFF     // Runaway Takeoff Prevention (anti-taz)
 #define USE_SERVOS
+#define USE_HELI_ONLY           // heli mixers only, the multirotor, fixed wing and 3D paths are compiled out
 #define USE_TELEMETRY
 #define USE_TELEMETRY_FRSKY_HUB
 #define USE_TELEMETRY_SMARTPORT
 #endif
 
 #if (FLASH_SIZE > 128)
+#define USE_FLASHFS_LOG_INDEX
+#define USE_CONFIG_BACKGROUND_SAVE
+#define USE_SENSOR_HARDWARE_CACHE
+#define USE_GYRO_TEMP_COMP
+#define USE_VIBRATION_MONITOR
+#define USE_SYSTEM_ID
+#define USE_MSP_SETTINGS
 #define USE_GYRO_OVERFLOW_CHECK
 #define USE_YAW_SPIN_RECOVERY
 #define USE_DSHOT_DMAR
@@ -242,6 +294,9 @@
 #if ((FLASH_SIZE > 256) || (FEATURE_CUT_LEVEL < 10))
 #define USE_VIRTUAL_CURRENT_METER
 #define USE_ESC_SENSOR
+#define USE_ESC_SENSOR_KISS
+#define USE_ESC_SENSOR_HOBBYWING
+#define USE_ESC_SENSOR_DSHOT
 #define USE_SERIAL_4WAY_BLHELI_BOOTLOADER
 #endif
 
@@ -272,6 +327,7 @@
 
 #if ((FLASH_SIZE > 256) || (FEATURE_CUT_LEVEL < 4))
 #define USE_HUFFMAN
+#define USE_BLACKBOX_COMPRESSION
 #define USE_PINIO
 #define USE_PINIOBOX
 #endif
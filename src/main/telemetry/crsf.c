@@ -63,6 +63,8 @@
 
 #include "telemetry/telemetry.h"
 #include "telemetry/msp_shared.h"
+#include "telemetry/schedule.h"
+#include "telemetry/snapshot.h"
 
 #include "telemetry/crsf.h"
 
@@ -71,12 +73,12 @@
 #define CRSF_DEVICEINFO_VERSION             0x01
 #define CRSF_DEVICEINFO_PARAMETER_COUNT     0
 
-#define CRSF_MSP_BUFFER_SIZE 96
+// Request chunks the radio may queue ahead of the reply, up to three full extended frames
+#define CRSF_MSP_BUFFER_SIZE 192
 #define CRSF_MSP_LENGTH_OFFSET 1
 
 static bool crsfTelemetryEnabled;
 static bool deviceInfoReplyPending;
-static uint8_t crsfFrame[CRSF_FRAME_SIZE_MAX];
 
 #if defined(USE_MSP_OVER_TELEMETRY)
 typedef struct mspBuffer_s {
@@ -85,10 +87,12 @@ typedef struct mspBuffer_s {
 } mspBuffer_t;
 
 static mspBuffer_t mspRxBuffer;
+static bool mspReplySending;
 
 void initCrsfMspBuffer(void)
 {
     mspRxBuffer.len = 0;
+    mspReplySending = false;
 }
 
 bool bufferCrsfMspFrame(uint8_t *frameStart, int frameLength)
@@ -104,55 +108,72 @@ bool bufferCrsfMspFrame(uint8_t *frameStart, int frameLength)
     }
 }
 
+// Sends at most one reply chunk per call. The reply in progress is finished first, one chunk per
+// telemetry window, then the queued request chunks are fed in until the next request is complete.
+// Chunks behind that request stay queued, so the radio does not have to wait for a reply before
+// sending the next request. Returns true while there is more to send.
 bool handleCrsfMspFrameBuffer(uint8_t payloadSize, mspResponseFnPtr responseFn)
 {
-    bool requestHandled = false;
-    if (!mspRxBuffer.len) {
-        return false;
+    if (mspReplySending) {
+        mspReplySending = sendMspReply(payloadSize, responseFn);
+        return true;
     }
+
     int pos = 0;
-    while (true) {
-        const int mspFrameLength = mspRxBuffer.bytes[pos];
-        if (handleMspFrame(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength, NULL)) {
-            requestHandled |= sendMspReply(payloadSize, responseFn);
-        }
-        pos += CRSF_MSP_LENGTH_OFFSET + mspFrameLength;
+    bool requestComplete = false;
+    while (!requestComplete) {
+        int len;
         ATOMIC_BLOCK(NVIC_PRIO_SERIALUART1) {
-            if (pos >= mspRxBuffer.len) {
-                mspRxBuffer.len = 0;
-                return requestHandled;
-            }
+            len = mspRxBuffer.len;
         }
+        if (pos >= len) {
+            break;
+        }
+        const int mspFrameLength = mspRxBuffer.bytes[pos];
+        requestComplete = handleMspFrame(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength, NULL);
+        pos += CRSF_MSP_LENGTH_OFFSET + mspFrameLength;
+    }
+
+    bool chunksQueued;
+    ATOMIC_BLOCK(NVIC_PRIO_SERIALUART1) {
+        memmove(mspRxBuffer.bytes, mspRxBuffer.bytes + pos, mspRxBuffer.len - pos);
+        mspRxBuffer.len -= pos;
+        chunksQueued = mspRxBuffer.len > 0;
     }
-    return requestHandled;
+
+    if (requestComplete) {
+        mspReplySending = sendMspReply(payloadSize, responseFn);
+        return true;
+    }
+
+    return chunksQueued;
 }
 #endif
 
-static void crsfInitializeFrame(sbuf_t *dst)
+static void crsfInitializeFrameBuf(sbuf_t *dst, uint8_t *frame)
 {
-    dst->ptr = crsfFrame;
-    dst->end = ARRAYEND(crsfFrame);
+    dst->ptr = frame;
+    dst->end = frame + CRSF_FRAME_SIZE_MAX;
 
     sbufWriteU8(dst, CRSF_SYNC_BYTE);
 }
 
-static void crsfFinalize(sbuf_t *dst)
+static int crsfFinalizeBuf(sbuf_t *dst, uint8_t *frame)
 {
-    crc8_dvb_s2_sbuf_append(dst, &crsfFrame[2]); // start at byte 2, since CRC does not include device address and frame length
-    sbufSwitchToReader(dst, crsfFrame);
-    // write the telemetry frame to the receiver.
-    crsfRxWriteTelemetryData(sbufPtr(dst), sbufBytesRemaining(dst));
+    crc8_dvb_s2_sbuf_append(dst, &frame[2]); // start at byte 2, since CRC does not include device address and frame length
+    return dst->ptr - frame;
 }
 
-static int crsfFinalizeBuf(sbuf_t *dst, uint8_t *frame)
+// Telemetry frames are built directly in the receiver's telemetry buffer
+static void crsfInitializeFrame(sbuf_t *dst)
 {
-    crc8_dvb_s2_sbuf_append(dst, &crsfFrame[2]); // start at byte 2, since CRC does not include device address and frame length
-    sbufSwitchToReader(dst, crsfFrame);
-    const int frameSize = sbufBytesRemaining(dst);
-    for (int ii = 0; sbufBytesRemaining(dst); ++ii) {
-        frame[ii] = sbufReadU8(dst);
-    }
-    return frameSize;
+    crsfInitializeFrameBuf(dst, crsfRxTelemetryBuffer());
+}
+
+static void crsfFinalize(sbuf_t *dst)
+{
+    // hand the telemetry frame over to the receiver, it is sent in the next telemetry window
+    crsfRxCommitTelemetryData(crsfFinalizeBuf(dst, crsfRxTelemetryBuffer()));
 }
 
 /*
@@ -176,16 +197,18 @@ uint8_t     Satellites in use ( counter )
 */
 void crsfFrameGps(sbuf_t *dst)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     // use sbufWrite since CRC does not include frame length
     sbufWriteU8(dst, CRSF_FRAME_GPS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
     sbufWriteU8(dst, CRSF_FRAMETYPE_GPS);
-    sbufWriteU32BigEndian(dst, gpsSol.llh.lat); // CRSF and betaflight use same units for degrees
-    sbufWriteU32BigEndian(dst, gpsSol.llh.lon);
-    sbufWriteU16BigEndian(dst, (gpsSol.groundSpeed * 36 + 50) / 100); // gpsSol.groundSpeed is in cm/s
-    sbufWriteU16BigEndian(dst, gpsSol.groundCourse * 10); // gpsSol.groundCourse is degrees * 10
-    const uint16_t altitude = (constrain(getEstimatedAltitudeCm(), 0 * 100, 5000 * 100) / 100) + 1000; // constrain altitude from 0 to 5,000m
+    sbufWriteU32BigEndian(dst, snapshot->gpsLatitude); // CRSF and betaflight use same units for degrees
+    sbufWriteU32BigEndian(dst, snapshot->gpsLongitude);
+    sbufWriteU16BigEndian(dst, (snapshot->gpsGroundSpeed * 36 + 50) / 100); // gpsSol.groundSpeed is in cm/s
+    sbufWriteU16BigEndian(dst, snapshot->gpsGroundCourse * 10); // gpsSol.groundCourse is degrees * 10
+    const uint16_t altitude = (constrain(snapshot->altitude, 0 * 100, 5000 * 100) / 100) + 1000; // constrain altitude from 0 to 5,000m
     sbufWriteU16BigEndian(dst, altitude);
-    sbufWriteU8(dst, gpsSol.numSat);
+    sbufWriteU8(dst, snapshot->gpsNumSat);
 }
 
 /*
@@ -201,20 +224,70 @@ void crsfFrameBatterySensor(sbuf_t *dst)
     // use sbufWrite since CRC does not include frame length
     sbufWriteU8(dst, CRSF_FRAME_BATTERY_SENSOR_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
     sbufWriteU8(dst, CRSF_FRAMETYPE_BATTERY_SENSOR);
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
     if (telemetryConfig()->report_cell_voltage) {
-        sbufWriteU16BigEndian(dst, (getBatteryAverageCellVoltage() + 5) / 10); // vbat is in units of 0.01V
+        sbufWriteU16BigEndian(dst, (snapshot->batteryCellVoltage + 5) / 10); // vbat is in units of 0.01V
     } else {
-        sbufWriteU16BigEndian(dst, getLegacyBatteryVoltage());
+        sbufWriteU16BigEndian(dst, snapshot->batteryLegacyVoltage);
     }
-    sbufWriteU16BigEndian(dst, getAmperage() / 10);
-    const uint32_t mAhDrawn = getMAhDrawn();
-    const uint8_t batteryRemainingPercentage = calculateBatteryPercentageRemaining();
+    sbufWriteU16BigEndian(dst, snapshot->amperage / 10);
+    const uint32_t mAhDrawn = snapshot->mAhDrawn;
+    const uint8_t batteryRemainingPercentage = snapshot->batteryRemaining;
     sbufWriteU8(dst, (mAhDrawn >> 16));
     sbufWriteU8(dst, (mAhDrawn >> 8));
     sbufWriteU8(dst, (uint8_t)mAhDrawn);
     sbufWriteU8(dst, batteryRemainingPercentage);
 }
 
+/*
+0x0C RPM
+Payload:
+uint8_t     Source id ( 0 = main rotor )
+int24_t     Headspeed ( rpm )
+*/
+void crsfFrameHeadspeed(sbuf_t *dst)
+{
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    sbufWriteU8(dst, CRSF_FRAME_RPM_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
+    sbufWriteU8(dst, CRSF_FRAMETYPE_RPM);
+    sbufWriteU8(dst, 0);
+    sbufWriteU8(dst, 0); // top byte of the int24, headspeed fits 16 bits
+    sbufWriteU16BigEndian(dst, snapshot->headspeed);
+}
+
+/*
+0x0D Temperature
+Payload:
+uint8_t     Source id ( 0 = ESC )
+int16_t     Temperature ( degree C * 10 )
+*/
+void crsfFrameEscTemperature(sbuf_t *dst)
+{
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    sbufWriteU8(dst, CRSF_FRAME_TEMP_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
+    sbufWriteU8(dst, CRSF_FRAMETYPE_TEMP);
+    sbufWriteU8(dst, 0);
+    sbufWriteU16BigEndian(dst, snapshot->escTemperatureValid ? snapshot->escTemperature * 10 : 0);
+}
+
+/*
+0x0E Voltages
+Payload:
+uint8_t     Source id ( 0 = BEC )
+uint16_t    Voltage ( mV )
+*/
+void crsfFrameBecVoltage(sbuf_t *dst)
+{
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    sbufWriteU8(dst, CRSF_FRAME_VOLTAGES_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
+    sbufWriteU8(dst, CRSF_FRAMETYPE_VOLTAGES);
+    sbufWriteU8(dst, 0);
+    sbufWriteU16BigEndian(dst, snapshot->becVoltage * 10); // becVoltage is in 0.01V
+}
+
 typedef enum {
     CRSF_ACTIVE_ANTENNA1 = 0,
     CRSF_ACTIVE_ANTENNA2 = 1
@@ -248,11 +321,13 @@ int16_t     Yaw angle ( rad / 10000 )
 
 void crsfFrameAttitude(sbuf_t *dst)
 {
+     const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
      sbufWriteU8(dst, CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
      sbufWriteU8(dst, CRSF_FRAMETYPE_ATTITUDE);
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.pitch));
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.roll));
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.yaw));
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(snapshot->pitch));
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(snapshot->roll));
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(snapshot->yaw));
 }
 
 /*
@@ -369,18 +444,21 @@ static void crsfFrameDisplayPortClear(sbuf_t *dst)
 
 #define BV(x)  (1 << (x)) // bit value
 
-// schedule array to decide how often each type of frame is sent
+// frame types of the telemetry schedule, each with its own rate and priority
 typedef enum {
     CRSF_FRAME_START_INDEX = 0,
     CRSF_FRAME_ATTITUDE_INDEX = CRSF_FRAME_START_INDEX,
     CRSF_FRAME_BATTERY_SENSOR_INDEX,
     CRSF_FRAME_FLIGHT_MODE_INDEX,
     CRSF_FRAME_GPS_INDEX,
+    CRSF_FRAME_HEADSPEED_INDEX,
+    CRSF_FRAME_ESC_TEMPERATURE_INDEX,
+    CRSF_FRAME_BEC_VOLTAGE_INDEX,
     CRSF_SCHEDULE_COUNT_MAX
 } crsfFrameTypeIndex_e;
 
-static uint8_t crsfScheduleCount;
-static uint8_t crsfSchedule[CRSF_SCHEDULE_COUNT_MAX];
+static telemetrySlot_t crsfScheduleSlots[CRSF_SCHEDULE_COUNT_MAX];
+static telemetrySchedule_t crsfSchedule;
 
 #if defined(USE_MSP_OVER_TELEMETRY)
 
@@ -406,39 +484,50 @@ void crsfSendMspResponse(uint8_t *payload)
 }
 #endif
 
-static void processCrsf(void)
+static void processCrsf(timeMs_t currentTimeMs)
 {
-    static uint8_t crsfScheduleIndex = 0;
-
-    const uint8_t currentSchedule = crsfSchedule[crsfScheduleIndex];
-
     sbuf_t crsfPayloadBuf;
     sbuf_t *dst = &crsfPayloadBuf;
 
-    if (currentSchedule & BV(CRSF_FRAME_ATTITUDE_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameAttitude(dst);
-        crsfFinalize(dst);
-    }
-    if (currentSchedule & BV(CRSF_FRAME_BATTERY_SENSOR_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameBatterySensor(dst);
-        crsfFinalize(dst);
-    }
+    // a frame that did not change since it was last sent gives the slot to the next most overdue frame
+    for (int i = 0; i < crsfSchedule.count; i++) {
+        telemetrySlot_t *slot = telemetryScheduleNext(&crsfSchedule, currentTimeMs);
 
-    if (currentSchedule & BV(CRSF_FRAME_FLIGHT_MODE_INDEX)) {
         crsfInitializeFrame(dst);
-        crsfFrameFlightMode(dst);
-        crsfFinalize(dst);
-    }
+        switch (slot->id) {
+        case CRSF_FRAME_ATTITUDE_INDEX:
+            crsfFrameAttitude(dst);
+            break;
+        case CRSF_FRAME_BATTERY_SENSOR_INDEX:
+            crsfFrameBatterySensor(dst);
+            break;
+        case CRSF_FRAME_FLIGHT_MODE_INDEX:
+            crsfFrameFlightMode(dst);
+            break;
 #ifdef USE_GPS
-    if (currentSchedule & BV(CRSF_FRAME_GPS_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameGps(dst);
-        crsfFinalize(dst);
-    }
+        case CRSF_FRAME_GPS_INDEX:
+            crsfFrameGps(dst);
+            break;
 #endif
-    crsfScheduleIndex = (crsfScheduleIndex + 1) % crsfScheduleCount;
+        case CRSF_FRAME_HEADSPEED_INDEX:
+            crsfFrameHeadspeed(dst);
+            break;
+        case CRSF_FRAME_ESC_TEMPERATURE_INDEX:
+            crsfFrameEscTemperature(dst);
+            break;
+        case CRSF_FRAME_BEC_VOLTAGE_INDEX:
+            crsfFrameBecVoltage(dst);
+            break;
+        default:
+            break;
+        }
+
+        const uint8_t *frame = crsfRxTelemetryBuffer();
+        if (telemetryScheduleValueDue(slot, currentTimeMs, crc16_ccitt_update(0, frame, dst->ptr - frame))) {
+            crsfFinalize(dst);
+            return;
+        }
+    }
 }
 
 void crsfScheduleDeviceInfoResponse(void)
@@ -466,22 +555,35 @@ void initCrsfTelemetry(void)
     cmsDisplayPortRegister(displayPortCrsfInit());
 #endif
 
-    int index = 0;
+    // interval in ms and priority of each frame type
+    telemetryScheduleInit(&crsfSchedule, crsfScheduleSlots, CRSF_SCHEDULE_COUNT_MAX);
     if (sensors(SENSOR_ACC) && telemetryIsSensorEnabled(SENSOR_PITCH | SENSOR_ROLL | SENSOR_HEADING)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_ATTITUDE_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_ATTITUDE_INDEX, 100, 1);
     }
     if ((isBatteryVoltageConfigured() && telemetryIsSensorEnabled(SENSOR_VOLTAGE))
         || (isAmperageConfigured() && telemetryIsSensorEnabled(SENSOR_CURRENT | SENSOR_FUEL))) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_BATTERY_SENSOR_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_BATTERY_SENSOR_INDEX, 100, 3);
     }
-    crsfSchedule[index++] = BV(CRSF_FRAME_FLIGHT_MODE_INDEX);
+    telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_FLIGHT_MODE_INDEX, 200, 2);
 #ifdef USE_GPS
     if (featureIsEnabled(FEATURE_GPS)
        && telemetryIsSensorEnabled(SENSOR_ALTITUDE | SENSOR_LAT_LONG | SENSOR_GROUND_SPEED | SENSOR_HEADING)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_GPS_INDEX);
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_GPS_INDEX, 200, 1);
+    }
+#endif
+    if (telemetryIsSensorEnabled(SENSOR_HEADSPEED)) {
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_HEADSPEED_INDEX, 100, 3);
+    }
+#ifdef USE_ESC_SENSOR
+    if (featureIsEnabled(FEATURE_ESC_SENSOR) && telemetryIsSensorEnabled(ESC_SENSOR_TEMPERATURE)) {
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_ESC_TEMPERATURE_INDEX, 1000, 1);
+    }
+#endif
+#ifdef ADC_POWER_5V
+    if (telemetryIsSensorEnabled(SENSOR_BEC_VOLTAGE)) {
+        telemetryScheduleAdd(&crsfSchedule, CRSF_FRAME_BEC_VOLTAGE_INDEX, 500, 2);
     }
 #endif
-    crsfScheduleCount = (uint8_t)index;
  }
 
 bool checkCrsfTelemetryState(void)
@@ -528,13 +630,23 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
     // This needs to be done at high frequency, to enable the RX to send the telemetry frame
     // in between the RX frames.
     crsfRxSendTelemetryData();
+    if (crsfRxTelemetryPending()) {
+        // still waiting for a telemetry window, don't build the next frame over it
+        return;
+    }
 
     // Send ad-hoc response frames as soon as possible
 #if defined(USE_MSP_OVER_TELEMETRY)
     if (mspReplyPending) {
-        mspReplyPending = handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
-        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
-        return;
+        // cleared before handling, a request chunk arriving meanwhile sets it again
+        mspReplyPending = false;
+        if (handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse)) {
+            mspReplyPending = true;
+        }
+        if (crsfRxTelemetryPending()) {
+            crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
+            return;
+        }
     }
 #endif
 
@@ -573,11 +685,11 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
     }
 #endif
 
-    // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
-    // Spread out scheduled frames evenly so each frame is sent at the same frequency.
-    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
+    // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz per frame type.
+    // The slots are spread out evenly, the schedule decides which frame goes into each slot.
+    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfSchedule.count)) {
         crsfLastCycleTime = currentTimeUs;
-        processCrsf();
+        processCrsf(currentTimeUs / 1000);
     }
 }
 
@@ -586,7 +698,9 @@ int getCrsfFrame(uint8_t *frame, crsfFrameType_e frameType)
     sbuf_t crsfFrameBuf;
     sbuf_t *sbuf = &crsfFrameBuf;
 
-    crsfInitializeFrame(sbuf);
+    telemetrySnapshotUpdate();
+
+    crsfInitializeFrameBuf(sbuf, frame);
     switch (frameType) {
     default:
     case CRSF_FRAMETYPE_ATTITUDE:
@@ -603,6 +717,15 @@ int getCrsfFrame(uint8_t *frame, crsfFrameType_e frameType)
         crsfFrameGps(sbuf);
         break;
 #endif
+    case CRSF_FRAMETYPE_RPM:
+        crsfFrameHeadspeed(sbuf);
+        break;
+    case CRSF_FRAMETYPE_TEMP:
+        crsfFrameEscTemperature(sbuf);
+        break;
+    case CRSF_FRAMETYPE_VOLTAGES:
+        crsfFrameBecVoltage(sbuf);
+        break;
     }
     const int frameSize = crsfFinalizeBuf(sbuf, frame);
     return frameSize;
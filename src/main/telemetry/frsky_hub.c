@@ -65,6 +65,7 @@
 
 #include "rx/rx.h"
 
+#include "telemetry/snapshot.h"
 #include "telemetry/telemetry.h"
 
 #if defined(USE_ESC_SENSOR_TELEMETRY)
@@ -207,6 +208,21 @@ static void sendThrottleOrBatterySizeAsRpm(void)
     frSkyHubWriteFrame(ID_RPM, data);
 }
 
+static void sendHeadspeedAsRpm(void)
+{
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    frSkyHubWriteFrame(ID_RPM, snapshot->headspeed / 10); // same scale as the ESC rpm above
+}
+
+// governor state (govState_e) in the thousands, throttle percent below
+static void sendGovernorAsTemperature2(void)
+{
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    frSkyHubWriteFrame(ID_TEMPRATURE2, snapshot->governorState * 1000 + snapshot->governorThrottle);
+}
+
 static void sendTemperature1(void)
 {
     int16_t data = 0;
@@ -271,7 +287,9 @@ static void sendLatLong(int32_t coord[2])
 #if defined(USE_GPS)
 static void sendGpsAltitude(void)
 {
-    int32_t altitudeCm = gpsSol.llh.altCm;
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    int32_t altitudeCm = snapshot->gpsAltitude;
 
     // Send real GPS altitude only if it's reliable (there's a GPS fix)
     if (!STATE(GPS_FIX)) {
@@ -283,10 +301,12 @@ static void sendGpsAltitude(void)
 
 static void sendSatalliteSignalQualityAsTemperature2(uint8_t cycleNum)
 {
-    uint16_t satellite = gpsSol.numSat;
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
 
-    if (gpsSol.hdop > GPS_BAD_QUALITY && ( (cycleNum % 16 ) < 8)) { // Every 1s
-        satellite = constrain(gpsSol.hdop, 0, GPS_MAX_HDOP_VAL);
+    uint16_t satellite = snapshot->gpsNumSat;
+
+    if (snapshot->gpsHdop > GPS_BAD_QUALITY && ( (cycleNum % 16 ) < 8)) { // Every 1s
+        satellite = constrain(snapshot->gpsHdop, 0, GPS_MAX_HDOP_VAL);
     }
     int16_t data;
     if (telemetryConfig()->frsky_unit == FRSKY_UNIT_METRICS) {
@@ -302,13 +322,15 @@ static void sendSatalliteSignalQualityAsTemperature2(uint8_t cycleNum)
 
 static void sendSpeed(void)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     if (!STATE(GPS_FIX)) {
         return;
     }
     // Speed should be sent in knots (GPS speed is in cm/s)
     // convert to knots: 1cm/s = 0.0194384449 knots
-    frSkyHubWriteFrame(ID_GPS_SPEED_BP, gpsSol.groundSpeed * 1944 / 100000);
-    frSkyHubWriteFrame(ID_GPS_SPEED_AP, (gpsSol.groundSpeed * 1944 / 100) % 100);
+    frSkyHubWriteFrame(ID_GPS_SPEED_BP, snapshot->gpsGroundSpeed * 1944 / 100000);
+    frSkyHubWriteFrame(ID_GPS_SPEED_AP, (snapshot->gpsGroundSpeed * 1944 / 100) % 100);
 }
 
 static void sendFakeLatLong(void)
@@ -324,14 +346,16 @@ static void sendFakeLatLong(void)
 
 static void sendGPSLatLong(void)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     static uint8_t gpsFixOccured = 0;
     int32_t coord[2] = {0,0};
 
     if (STATE(GPS_FIX) || gpsFixOccured == 1) {
         // If we have ever had a fix, send the last known lat/long
         gpsFixOccured = 1;
-        coord[LAT] = gpsSol.llh.lat;
-        coord[LON] = gpsSol.llh.lon;
+        coord[LAT] = snapshot->gpsLatitude;
+        coord[LON] = snapshot->gpsLongitude;
         sendLatLong(coord);
     } else {
         // otherwise send fake lat/long in order to display compass value
@@ -350,9 +374,11 @@ static void sendGPSLatLong(void)
  */
 static void sendVoltageCells(void)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     static uint16_t currentCell;
     uint32_t cellVoltage = 0;
-    const uint8_t cellCount = getBatteryCellCount();
+    const uint8_t cellCount = snapshot->batteryCellCount;
 
     if (cellCount) {
         currentCell %= cellCount;
@@ -367,7 +393,7 @@ static void sendVoltageCells(void)
         * The actual value sent for cell voltage has resolution of 0.002 volts
         * Since vbat has resolution of 0.1 volts it has to be multiplied by 50
         */
-        cellVoltage = ((uint32_t)getBatteryVoltage() * 100 + cellCount) / (cellCount * 2);
+        cellVoltage = ((uint32_t)snapshot->batteryVoltage * 100 + cellCount) / (cellCount * 2);
     } else {
         currentCell = 0;
     }
@@ -391,8 +417,10 @@ static void sendVoltageCells(void)
  */
 static void sendVoltageAmp(void)
 {
-    uint16_t voltage = getLegacyBatteryVoltage();
-    const uint8_t cellCount = getBatteryCellCount();
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    uint16_t voltage = snapshot->batteryLegacyVoltage;
+    const uint8_t cellCount = snapshot->batteryCellCount;
 
     if (telemetryConfig()->frsky_vfas_precision == FRSKY_VFAS_PRECISION_HIGH) {
         // Use new ID 0x39 to send voltage directly in 0.1 volts resolution
@@ -414,16 +442,20 @@ static void sendVoltageAmp(void)
 
 static void sendAmperage(void)
 {
-    frSkyHubWriteFrame(ID_CURRENT, (uint16_t)(getAmperage() / 10));
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    frSkyHubWriteFrame(ID_CURRENT, (uint16_t)(snapshot->amperage / 10));
 }
 
 static void sendFuelLevel(void)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     int16_t data;
     if (batteryConfig()->batteryCapacity > 0) {
-        data = (uint16_t)calculateBatteryPercentageRemaining();
+        data = (uint16_t)snapshot->batteryRemaining;
     } else {
-        data = (uint16_t)constrain(getMAhDrawn(), 0, 0xFFFF);
+        data = (uint16_t)constrain(snapshot->mAhDrawn, 0, 0xFFFF);
     }
     frSkyHubWriteFrame(ID_FUEL_LEVEL, data);
 }
@@ -442,7 +474,9 @@ static void sendFakeLatLongThatAllowsHeadingDisplay(void)
 
 static void sendHeading(void)
 {
-    frSkyHubWriteFrame(ID_COURSE_BP, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    frSkyHubWriteFrame(ID_COURSE_BP, DECIDEGREES_TO_DEGREES(snapshot->yaw));
     frSkyHubWriteFrame(ID_COURSE_AP, 0);
 }
 #endif
@@ -511,6 +545,8 @@ void checkFrSkyHubTelemetryState(void)
 
 void processFrSkyHubTelemetry(timeUs_t currentTimeUs)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     static uint32_t frSkyHubLastCycleTime = 0;
     static uint8_t cycleNum = 0;
 
@@ -535,13 +571,13 @@ void processFrSkyHubTelemetry(timeUs_t currentTimeUs)
         // Unit is cm/s
 #ifdef USE_VARIO
         if (telemetryIsSensorEnabled(SENSOR_VARIO)) {
-            frSkyHubWriteFrame(ID_VERT_SPEED, getEstimatedVario());
+            frSkyHubWriteFrame(ID_VERT_SPEED, snapshot->vario);
         }
 #endif
 
         // Sent every 500ms
         if ((cycleNum % 4) == 0 && telemetryIsSensorEnabled(SENSOR_ALTITUDE)) {
-            int32_t altitudeCm = getEstimatedAltitudeCm();
+            int32_t altitudeCm = snapshot->altitude;
 
             /* Allow 5s to boot correctly othervise send zero to prevent OpenTX
              * sensor lost notifications after warm boot. */
@@ -555,6 +591,11 @@ void processFrSkyHubTelemetry(timeUs_t currentTimeUs)
     }
 #endif
 
+    if (telemetryIsSensorEnabled(SENSOR_HEADSPEED)) {
+        // Sent every 125ms
+        sendHeadspeedAsRpm();
+    }
+
 #if defined(USE_MAG)
     if (sensors(SENSOR_MAG) && telemetryIsSensorEnabled(SENSOR_HEADING)) {
         // Sent every 500ms
@@ -567,15 +608,17 @@ void processFrSkyHubTelemetry(timeUs_t currentTimeUs)
     // Sent every 1s
     if ((cycleNum % 8) == 0) {
         sendTemperature1();
-        sendThrottleOrBatterySizeAsRpm();
+        if (!telemetryIsSensorEnabled(SENSOR_HEADSPEED)) {
+            sendThrottleOrBatterySizeAsRpm();
+        }
 
-        if (isBatteryVoltageConfigured()) {
+        if (snapshot->batteryVoltageConfigured) {
             if (telemetryIsSensorEnabled(SENSOR_VOLTAGE)) {
                 sendVoltageCells();
                 sendVoltageAmp();
             }
 
-            if (isAmperageConfigured()) {
+            if (snapshot->amperageConfigured) {
                 if (telemetryIsSensorEnabled(SENSOR_CURRENT)) {
                     sendAmperage();
                 }
@@ -606,6 +649,16 @@ void processFrSkyHubTelemetry(timeUs_t currentTimeUs)
 #else
         {}
 #endif
+
+#if defined(USE_GPS)
+        // the GPS uses temperature 2 for the satellites
+        if (!sensors(SENSOR_GPS))
+#endif
+        {
+            if (telemetryIsSensorEnabled(SENSOR_GOVERNOR)) {
+                sendGovernorAsTemperature2();
+            }
+        }
     }
 
     // Sent every 5s
@@ -87,6 +87,7 @@
 #include "sensors/sensors.h"
 
 #include "telemetry/hott.h"
+#include "telemetry/snapshot.h"
 #include "telemetry/telemetry.h"
 
 #if defined (USE_HOTT_TEXTMODE) && defined (USE_CMS)
@@ -117,6 +118,8 @@ static bool hottIsSending = false;
 static uint8_t *hottMsg = NULL;
 static uint8_t hottMsgRemainingBytesToSendCount;
 static uint8_t hottMsgCrc;
+static uint8_t hottEAMMessageCrc;
+static uint8_t hottGPSMessageCrc;
 
 #define HOTT_CRC_SIZE (sizeof(hottMsgCrc))
 
@@ -132,11 +135,42 @@ static portSharing_e hottPortSharing;
 static HOTT_GPS_MSG_t hottGPSMessage;
 static HOTT_EAM_MSG_t hottEAMMessage;
 
+/*
+ * The messages are templates, the constant parts are set once and the
+ * values are patched in place. A response is copied out with its checksum
+ * already known, so the byte timed transmission only writes bytes and the
+ * templates can change while a response is on the wire.
+ */
+static union {
+    HOTT_EAM_MSG_t eam;
+    HOTT_GPS_MSG_t gps;
+#if defined (USE_HOTT_TEXTMODE) && defined (USE_CMS)
+    hottTextModeMsg_t textMode;
+#endif
+} hottTxMessage;
+
+static uint8_t hottChecksum(const uint8_t *data, size_t size)
+{
+    uint8_t crc = 0;
+    for (size_t i = 0; i < size; i++) {
+        crc += data[i];
+    }
+    return crc;
+}
+
 #if defined (USE_HOTT_TEXTMODE) && defined (USE_CMS)
 static hottTextModeMsg_t hottTextModeMessage;
+static uint8_t hottTextModeMessageCrc;
 static bool textmodeIsAlive = false;
 static int32_t telemetryTaskPeriod = 0;
 
+// the checksum is a plain sum, a changed byte updates it without a full pass
+static void hottTextmodePatch(uint8_t *field, uint8_t value)
+{
+    hottTextModeMessageCrc += value - *field;
+    *field = value;
+}
+
 static void initialiseTextmodeMessage(hottTextModeMsg_t *msg)
 {
     msg->start = HOTT_TEXTMODE_START;
@@ -176,11 +210,14 @@ static void initialiseGPSMessage(HOTT_GPS_MSG_t *msg, size_t size)
 static void initialiseMessages(void)
 {
     initialiseEAMMessage(&hottEAMMessage, sizeof(hottEAMMessage));
+    hottEAMMessageCrc = hottChecksum((uint8_t *)&hottEAMMessage, sizeof(hottEAMMessage));
 #ifdef USE_GPS
     initialiseGPSMessage(&hottGPSMessage, sizeof(hottGPSMessage));
+    hottGPSMessageCrc = hottChecksum((uint8_t *)&hottGPSMessage, sizeof(hottGPSMessage));
 #endif
 #if defined (USE_HOTT_TEXTMODE) && defined (USE_CMS)
     initialiseTextmodeMessage(&hottTextModeMessage);
+    hottTextModeMessageCrc = hottChecksum((uint8_t *)&hottTextModeMessage, sizeof(hottTextModeMessage));
 #endif
 }
 
@@ -320,6 +357,27 @@ static inline void hottEAMUpdateClimbrate(HOTT_EAM_MSG_t *hottEAMMessage)
 }
 #endif
 
+static inline void hottEAMUpdateHeli(HOTT_EAM_MSG_t *hottEAMMessage)
+{
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    if (telemetryIsSensorEnabled(SENSOR_HEADSPEED)) {
+        const uint16_t rpm = snapshot->headspeed / 10;
+        hottEAMMessage->rpm_L = rpm & 0xFF;
+        hottEAMMessage->rpm_H = rpm >> 8;
+    }
+
+    if (telemetryIsSensorEnabled(ESC_SENSOR_TEMPERATURE) && snapshot->escTemperatureValid) {
+        hottEAMMessage->temp1 = snapshot->escTemperature + 20;
+    }
+
+    if (telemetryIsSensorEnabled(SENSOR_BEC_VOLTAGE)) {
+        const uint16_t volt = snapshot->becVoltage / 10;
+        hottEAMMessage->batt2_voltage_L = volt & 0xFF;
+        hottEAMMessage->batt2_voltage_H = volt >> 8;
+    }
+}
+
 void hottPrepareEAMResponse(HOTT_EAM_MSG_t *hottEAMMessage)
 {
     // Reset alarms
@@ -333,6 +391,7 @@ void hottPrepareEAMResponse(HOTT_EAM_MSG_t *hottEAMMessage)
 #ifdef USE_VARIO
     hottEAMUpdateClimbrate(hottEAMMessage);
 #endif
+    hottEAMUpdateHeli(hottEAMMessage);
 }
 
 static void hottSerialWrite(uint8_t c)
@@ -400,7 +459,6 @@ static void hottConfigurePortForTX(void)
         serialSetMode(hottPort, MODE_TX);
     }
     hottIsSending = true;
-    hottMsgCrc = 0;
 }
 
 static void hottConfigurePortForRX(void)
@@ -439,30 +497,35 @@ void configureHoTTTelemetryPort(void)
     hottTelemetryEnabled = true;
 }
 
-static void hottSendResponse(uint8_t *buffer, int length)
+static void hottSendResponse(const uint8_t *buffer, int length, uint8_t crc)
 {
     if (hottIsSending) {
         return;
     }
 
-    hottMsg = buffer;
+    memcpy(&hottTxMessage, buffer, length);
+    hottMsg = (uint8_t *)&hottTxMessage;
+    hottMsgCrc = crc;
     hottMsgRemainingBytesToSendCount = length + HOTT_CRC_SIZE;
 }
 
 static inline void hottSendGPSResponse(void)
 {
-    hottSendResponse((uint8_t *)&hottGPSMessage, sizeof(hottGPSMessage));
+    hottSendResponse((uint8_t *)&hottGPSMessage, sizeof(hottGPSMessage), hottGPSMessageCrc);
 }
 
 static inline void hottSendEAMResponse(void)
 {
-    hottSendResponse((uint8_t *)&hottEAMMessage, sizeof(hottEAMMessage));
+    hottSendResponse((uint8_t *)&hottEAMMessage, sizeof(hottEAMMessage), hottEAMMessageCrc);
 }
 
+// The checksums are refreshed here, outside the response window
 static void hottPrepareMessages(void) {
     hottPrepareEAMResponse(&hottEAMMessage);
+    hottEAMMessageCrc = hottChecksum((uint8_t *)&hottEAMMessage, sizeof(hottEAMMessage));
 #ifdef USE_GPS
     hottPrepareGPSResponse(&hottGPSMessage);
+    hottGPSMessageCrc = hottChecksum((uint8_t *)&hottGPSMessage, sizeof(hottGPSMessage));
 #endif
 }
 
@@ -498,19 +561,19 @@ bool hottTextmodeIsAlive()
 
 void hottTextmodeGrab()
 {
-    hottTextModeMessage.esc = HOTT_EAM_SENSOR_TEXT_ID;
+    hottTextmodePatch(&hottTextModeMessage.esc, HOTT_EAM_SENSOR_TEXT_ID);
 }
 
 void hottTextmodeExit()
 {
-    hottTextModeMessage.esc = HOTT_TEXTMODE_ESC;
+    hottTextmodePatch(&hottTextModeMessage.esc, HOTT_TEXTMODE_ESC);
 }
 
 void hottTextmodeWriteChar(uint8_t column, uint8_t row, char c)
 {
     if (column < HOTT_TEXTMODE_DISPLAY_COLUMNS && row < HOTT_TEXTMODE_DISPLAY_ROWS) {
         if (hottTextModeMessage.txt[row][column] != c)
-            hottTextModeMessage.txt[row][column] = c;
+            hottTextmodePatch(&hottTextModeMessage.txt[row][column], c);
     }
 }
 
@@ -528,7 +591,7 @@ static void processHottTextModeRequest(const uint8_t cmd)
     }
 
     if (setEscBack) {
-        hottTextModeMessage.esc = HOTT_EAM_SENSOR_TEXT_ID;
+        hottTextmodePatch(&hottTextModeMessage.esc, HOTT_EAM_SENSOR_TEXT_ID);
         setEscBack = false;
     }
 
@@ -539,7 +602,7 @@ static void processHottTextModeRequest(const uint8_t cmd)
     }
 
     hottSetCmsKey(cmd & 0x0f, hottTextModeMessage.esc == HOTT_TEXTMODE_ESC);
-    hottSendResponse((uint8_t *)&hottTextModeMessage, sizeof(hottTextModeMessage));
+    hottSendResponse((uint8_t *)&hottTextModeMessage, sizeof(hottTextModeMessage), hottTextModeMessageCrc);
 }
 #endif
 
@@ -650,11 +713,10 @@ static void hottSendTelemetryData(void) {
 
     --hottMsgRemainingBytesToSendCount;
     if (hottMsgRemainingBytesToSendCount == 0) {
-        hottSerialWrite(hottMsgCrc++);
+        hottSerialWrite(hottMsgCrc);
         return;
     }
 
-    hottMsgCrc += *hottMsg;
     hottSerialWrite(*hottMsg++);
 }
 
@@ -55,6 +55,7 @@ static uint16_t calculateChecksum(const uint8_t *ibusPacket);
 #include "flight/imu.h"
 #include "flight/position.h"
 #include "io/gps.h"
+#include "telemetry/snapshot.h"
 
 
 #define IBUS_TEMPERATURE_OFFSET     400
@@ -184,11 +185,9 @@ static uint8_t transmitIbusPacket()
     }
     unsigned payloadLength = frameLength - IBUS_CHECKSUM_SIZE;
     uint16_t checksum = calculateChecksum(sendBuffer);
-    for (unsigned i = 0; i < payloadLength; i++) {
-        serialWrite(ibusSerialPort, sendBuffer[i]);
-    }
-    serialWrite(ibusSerialPort, checksum & 0xFF);
-    serialWrite(ibusSerialPort, checksum >> 8);
+    const uint8_t checksumBuffer[IBUS_CHECKSUM_SIZE] = { checksum & 0xFF, checksum >> 8 };
+    serialWriteBuf(ibusSerialPort, sendBuffer, payloadLength);
+    serialWriteBuf(ibusSerialPort, checksumBuffer, sizeof(checksumBuffer));
     return frameLength;
 }
 
@@ -198,13 +197,30 @@ static void setIbusDiscoverSensorReply(ibusAddress_t address)
     sendBuffer[1] = IBUS_COMMAND_DISCOVER_SENSOR | address;
 }
 
+// The heli sensors are reported as the standard sensor type with the same unit
+static uint8_t getSensorWireType(uint8_t sensorType)
+{
+    switch (sensorType) {
+    case IBUS_SENSOR_TYPE_HEADSPEED:
+        return IBUS_SENSOR_TYPE_RPM_FLYSKY;
+    case IBUS_SENSOR_TYPE_GOV_THROTTLE:
+        return IBUS_SENSOR_TYPE_FUEL;
+    case IBUS_SENSOR_TYPE_ESC_TEMPERATURE:
+        return IBUS_SENSOR_TYPE_TEMPERATURE;
+    case IBUS_SENSOR_TYPE_BEC_VOLTAGE:
+        return IBUS_SENSOR_TYPE_EXTERNAL_VOLTAGE;
+    default:
+        return sensorType;
+    }
+}
+
 static void setIbusSensorType(ibusAddress_t address)
 {
     uint8_t sensorID = getSensorID(address);
     uint8_t sensorLength = getSensorLength(sensorID);
     sendBuffer[0] = IBUS_HEADER_FOOTER_SIZE + 2;
     sendBuffer[1] = IBUS_COMMAND_SENSOR_TYPE | address;
-    sendBuffer[2] = sensorID;
+    sendBuffer[2] = getSensorWireType(sensorID);
     sendBuffer[3] = sensorLength;
 }
 
@@ -414,6 +430,18 @@ static void setValue(uint8_t* bufferPtr, uint8_t sensorType, uint8_t length)
         case IBUS_SENSOR_TYPE_ARMED:
             value.uint16 = ARMING_FLAG(ARMED) ? 1 : 0;
             break;
+        case IBUS_SENSOR_TYPE_HEADSPEED:
+            value.uint16 = getTelemetrySnapshot()->headspeed;
+            break;
+        case IBUS_SENSOR_TYPE_GOV_THROTTLE:
+            value.uint16 = getTelemetrySnapshot()->governorThrottle;
+            break;
+        case IBUS_SENSOR_TYPE_ESC_TEMPERATURE:
+            value.uint16 = getTelemetrySnapshot()->escTemperature * 10 + IBUS_TEMPERATURE_OFFSET;
+            break;
+        case IBUS_SENSOR_TYPE_BEC_VOLTAGE:
+            value.uint16 = getTelemetrySnapshot()->becVoltage;
+            break;
 #if defined(USE_TELEMETRY_IBUS_EXTENDED)
         case IBUS_SENSOR_TYPE_CMP_HEAD:
             value.uint16 = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
@@ -70,6 +70,12 @@ typedef enum {
     IBUS_SENSOR_TYPE_ALT_MAX          = 0x84, //4bytes signed MaxAlt m*100
 
     IBUS_SENSOR_TYPE_ALT_FLYSKY       = 0xf9, // Altitude 2 bytes signed in m
+
+    // heli sensors, configuration only, the receiver sees the standard type in the comment
+    IBUS_SENSOR_TYPE_HEADSPEED        = 0xe0, // RPM_FLYSKY, rpm
+    IBUS_SENSOR_TYPE_GOV_THROTTLE     = 0xe1, // FUEL, governor output in percent
+    IBUS_SENSOR_TYPE_ESC_TEMPERATURE  = 0xe2, // TEMPERATURE
+    IBUS_SENSOR_TYPE_BEC_VOLTAGE      = 0xe3, // EXTERNAL_VOLTAGE
 #if defined(USE_TELEMETRY_IBUS_EXTENDED)
     IBUS_SENSOR_TYPE_GPS_FULL         = 0xfd,
     IBUS_SENSOR_TYPE_VOLT_FULL        = 0xf0,
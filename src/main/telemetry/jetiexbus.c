@@ -53,6 +53,7 @@
 #include "sensors/acceleration.h"
 
 #include "telemetry/jetiexbus.h"
+#include "telemetry/snapshot.h"
 #include "telemetry/telemetry.h"
 
 #define EXTEL_DATA_MSG      (0x40)
@@ -304,76 +305,78 @@ uint32_t calcGpsDDMMmmm(int32_t value, bool isLong)
 
 int32_t getSensorValue(uint8_t sensor)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     switch (sensor) {
     case EX_VOLTAGE:
-        return getLegacyBatteryVoltage();
+        return snapshot->batteryLegacyVoltage;
         break;
 
     case EX_CURRENT:
-        return getAmperage();
+        return snapshot->amperage;
         break;
 
     case EX_ALTITUDE:
-        return getEstimatedAltitudeCm();
+        return snapshot->altitude;
         break;
 
     case EX_CAPACITY:
-        return getMAhDrawn();
+        return snapshot->mAhDrawn;
         break;
 
     case EX_POWER:
-        return (getBatteryVoltage() * getAmperage() / 1000);
+        return (snapshot->batteryVoltage * snapshot->amperage / 1000);
         break;
 
     case EX_ROLL_ANGLE:
-        return attitude.values.roll;
+        return snapshot->roll;
         break;
 
     case EX_PITCH_ANGLE:
-        return attitude.values.pitch;
+        return snapshot->pitch;
         break;
 
     case EX_HEADING:
-        return attitude.values.yaw;
+        return snapshot->yaw;
         break;
 
 #ifdef USE_VARIO
     case EX_VARIO:
-        return getEstimatedVario();
+        return snapshot->vario;
         break;
 #endif
 
 #ifdef USE_GPS
     case EX_GPS_SATS:
-        return gpsSol.numSat;
+        return snapshot->gpsNumSat;
     break;
 
     case EX_GPS_LONG:
-        return calcGpsDDMMmmm(gpsSol.llh.lon, true);
+        return calcGpsDDMMmmm(snapshot->gpsLongitude, true);
     break;
 
     case EX_GPS_LAT:
-        return calcGpsDDMMmmm(gpsSol.llh.lat, false);
+        return calcGpsDDMMmmm(snapshot->gpsLatitude, false);
     break;
 
     case EX_GPS_SPEED:
-        return gpsSol.groundSpeed;
+        return snapshot->gpsGroundSpeed;
     break;
 
     case EX_GPS_DISTANCE_TO_HOME:
-        return GPS_distanceToHome;
+        return snapshot->gpsDistanceToHome;
     break;
 
     case EX_GPS_DIRECTION_TO_HOME:
-        return GPS_directionToHome;
+        return snapshot->gpsDirectionToHome;
     break;
 
     case EX_GPS_HEADING:
-        return gpsSol.groundCourse;
+        return snapshot->gpsGroundCourse;
     break;
 
     case EX_GPS_ALTITUDE:
-        return gpsSol.llh.altCm;
+        return snapshot->gpsAltitude;
     break;
 #endif
 
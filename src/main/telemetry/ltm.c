@@ -78,6 +78,7 @@
 
 #include "telemetry/telemetry.h"
 #include "telemetry/ltm.h"
+#include "telemetry/snapshot.h"
 
 
 #define TELEMETRY_LTM_INITIAL_PORT_MODE MODE_TX
@@ -87,39 +88,60 @@ static serialPort_t *ltmPort;
 static const serialPortConfig_t *portConfig;
 static bool ltmEnabled;
 static portSharing_e ltmPortSharing;
-static uint8_t ltm_crc;
 
-static void ltm_initialise_packet(uint8_t ltm_id)
+#define LTM_HEADER_SIZE         3   // '$', 'T', frame id
+#define LTM_MAX_PAYLOAD_SIZE    14
+
+/*
+ * Each frame type keeps its last frame. The header is written once, the
+ * fields are patched in place and the XOR checksum is updated with the
+ * changed bytes only, so sending is a single buffer write.
+ */
+typedef struct ltmFrame_s {
+    uint8_t data[LTM_HEADER_SIZE + LTM_MAX_PAYLOAD_SIZE + 1];
+    uint8_t payloadSize;
+    uint8_t crc;
+} ltmFrame_t;
+
+static ltmFrame_t ltmGFrame;
+static ltmFrame_t ltmSFrame;
+static ltmFrame_t ltmAFrame;
+static ltmFrame_t ltmOFrame;
+
+static void ltm_initialise_frame(ltmFrame_t *frame, uint8_t ltm_id, uint8_t payloadSize)
 {
-    ltm_crc = 0;
-    serialWrite(ltmPort, '$');
-    serialWrite(ltmPort, 'T');
-    serialWrite(ltmPort, ltm_id);
+    memset(frame, 0, sizeof(*frame));
+    frame->data[0] = '$';
+    frame->data[1] = 'T';
+    frame->data[2] = ltm_id;
+    frame->payloadSize = payloadSize;
 }
 
-static void ltm_serialise_8(uint8_t v)
+static void ltm_patch_8(ltmFrame_t *frame, uint8_t offset, uint8_t v)
 {
-    serialWrite(ltmPort, v);
-    ltm_crc ^= v;
+    uint8_t *field = &frame->data[LTM_HEADER_SIZE + offset];
+    frame->crc ^= *field ^ v;
+    *field = v;
 }
 
-static void ltm_serialise_16(uint16_t v)
+static void ltm_patch_16(ltmFrame_t *frame, uint8_t offset, uint16_t v)
 {
-    ltm_serialise_8((uint8_t)v);
-    ltm_serialise_8((v >> 8));
+    ltm_patch_8(frame, offset, (uint8_t)v);
+    ltm_patch_8(frame, offset + 1, (v >> 8));
 }
 
-static void ltm_serialise_32(uint32_t v)
+static void ltm_patch_32(ltmFrame_t *frame, uint8_t offset, uint32_t v)
 {
-    ltm_serialise_8((uint8_t)v);
-    ltm_serialise_8((v >> 8));
-    ltm_serialise_8((v >> 16));
-    ltm_serialise_8((v >> 24));
+    ltm_patch_8(frame, offset, (uint8_t)v);
+    ltm_patch_8(frame, offset + 1, (v >> 8));
+    ltm_patch_8(frame, offset + 2, (v >> 16));
+    ltm_patch_8(frame, offset + 3, (v >> 24));
 }
 
-static void ltm_finalise(void)
+static void ltm_send(ltmFrame_t *frame)
 {
-    serialWrite(ltmPort, ltm_crc);
+    frame->data[LTM_HEADER_SIZE + frame->payloadSize] = frame->crc;
+    serialWriteBuf(ltmPort, frame->data, LTM_HEADER_SIZE + frame->payloadSize + 1);
 }
 
 /*
@@ -129,6 +151,7 @@ static void ltm_finalise(void)
 static void ltm_gframe(void)
 {
 #if defined(USE_GPS)
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
     uint8_t gps_fix_type = 0;
     int32_t ltm_alt;
 
@@ -137,24 +160,23 @@ static void ltm_gframe(void)
 
     if (!STATE(GPS_FIX))
         gps_fix_type = 1;
-    else if (gpsSol.numSat < 5)
+    else if (snapshot->gpsNumSat < 5)
         gps_fix_type = 2;
     else
         gps_fix_type = 3;
 
-    ltm_initialise_packet('G');
-    ltm_serialise_32(gpsSol.llh.lat);
-    ltm_serialise_32(gpsSol.llh.lon);
-    ltm_serialise_8((uint8_t)(gpsSol.groundSpeed / 100));
+    ltm_patch_32(&ltmGFrame, 0, snapshot->gpsLatitude);
+    ltm_patch_32(&ltmGFrame, 4, snapshot->gpsLongitude);
+    ltm_patch_8(&ltmGFrame, 8, (uint8_t)(snapshot->gpsGroundSpeed / 100));
 
 #if defined(USE_BARO) || defined(USE_RANGEFINDER)
-    ltm_alt = (sensors(SENSOR_RANGEFINDER) || sensors(SENSOR_BARO)) ? getEstimatedAltitudeCm() : gpsSol.llh.altCm;
+    ltm_alt = (sensors(SENSOR_RANGEFINDER) || sensors(SENSOR_BARO)) ? snapshot->altitude : snapshot->gpsAltitude;
 #else
-    ltm_alt = gpsSol.llh.altCm;
+    ltm_alt = snapshot->gpsAltitude;
 #endif
-    ltm_serialise_32(ltm_alt);
-    ltm_serialise_8((gpsSol.numSat << 2) | gps_fix_type);
-    ltm_finalise();
+    ltm_patch_32(&ltmGFrame, 9, ltm_alt);
+    ltm_patch_8(&ltmGFrame, 13, (snapshot->gpsNumSat << 2) | gps_fix_type);
+    ltm_send(&ltmGFrame);
 #endif
 }
 
@@ -171,6 +193,7 @@ static void ltm_gframe(void)
 
 static void ltm_sframe(void)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
     uint8_t lt_flightmode;
     uint8_t lt_statemode;
     if (FLIGHT_MODE(PASSTHRU_MODE))
@@ -187,13 +210,11 @@ static void ltm_sframe(void)
     lt_statemode = (ARMING_FLAG(ARMED)) ? 1 : 0;
     if (failsafeIsActive())
         lt_statemode |= 2;
-    ltm_initialise_packet('S');
-    ltm_serialise_16(getBatteryVoltage() * 10);    //vbat converted to mV
-    ltm_serialise_16(0);             //  current, not implemented
-    ltm_serialise_8(constrain(scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 255), 0, 255));        // scaled RSSI (uchar)
-    ltm_serialise_8(0);              // no airspeed
-    ltm_serialise_8((lt_flightmode << 2) | lt_statemode);
-    ltm_finalise();
+    ltm_patch_16(&ltmSFrame, 0, snapshot->batteryVoltage * 10);    //vbat converted to mV
+    // current (offset 2) not implemented, no airspeed (offset 5)
+    ltm_patch_8(&ltmSFrame, 4, constrain(scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 255), 0, 255));        // scaled RSSI (uchar)
+    ltm_patch_8(&ltmSFrame, 6, (lt_flightmode << 2) | lt_statemode);
+    ltm_send(&ltmSFrame);
 }
 
 /*
@@ -202,11 +223,12 @@ static void ltm_sframe(void)
  */
 static void ltm_aframe(void)
 {
-    ltm_initialise_packet('A');
-    ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.pitch));
-    ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.roll));
-    ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.yaw));
-    ltm_finalise();
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    ltm_patch_16(&ltmAFrame, 0, DECIDEGREES_TO_DEGREES(snapshot->pitch));
+    ltm_patch_16(&ltmAFrame, 2, DECIDEGREES_TO_DEGREES(snapshot->roll));
+    ltm_patch_16(&ltmAFrame, 4, DECIDEGREES_TO_DEGREES(snapshot->yaw));
+    ltm_send(&ltmAFrame);
 }
 
 /*
@@ -216,18 +238,13 @@ static void ltm_aframe(void)
  */
 static void ltm_oframe(void)
 {
-    ltm_initialise_packet('O');
 #if defined(USE_GPS)
-    ltm_serialise_32(GPS_home[LAT]);
-    ltm_serialise_32(GPS_home[LON]);
-#else
-    ltm_serialise_32(0);
-    ltm_serialise_32(0);
+    ltm_patch_32(&ltmOFrame, 0, GPS_home[LAT]);
+    ltm_patch_32(&ltmOFrame, 4, GPS_home[LON]);
 #endif
-    ltm_serialise_32(0);                // Don't have GPS home altitude
-    ltm_serialise_8(1);                 // OSD always ON
-    ltm_serialise_8(STATE(GPS_FIX_HOME) ? 1 : 0);
-    ltm_finalise();
+    // Don't have GPS home altitude (offset 8), OSD always ON (offset 12, set once)
+    ltm_patch_8(&ltmOFrame, 13, STATE(GPS_FIX_HOME) ? 1 : 0);
+    ltm_send(&ltmOFrame);
 }
 
 static void process_ltm(void)
@@ -270,6 +287,12 @@ void initLtmTelemetry(void)
 {
     portConfig = findSerialPortConfig(FUNCTION_TELEMETRY_LTM);
     ltmPortSharing = determinePortSharing(portConfig, FUNCTION_TELEMETRY_LTM);
+
+    ltm_initialise_frame(&ltmGFrame, 'G', 14);
+    ltm_initialise_frame(&ltmSFrame, 'S', 7);
+    ltm_initialise_frame(&ltmAFrame, 'A', 6);
+    ltm_initialise_frame(&ltmOFrame, 'O', 14);
+    ltm_patch_8(&ltmOFrame, 12, 1);
 }
 
 void configureLtmTelemetryPort(void)
@@ -71,6 +71,7 @@
 
 #include "telemetry/telemetry.h"
 #include "telemetry/mavlink.h"
+#include "telemetry/snapshot.h"
 
 // mavlink library uses unnames unions that's causes GCC to complain if -Wpedantic is used
 // until this is resolved in mavlink library - ignore -Wpedantic for mavlink code
@@ -83,6 +84,13 @@
 #define TELEMETRY_MAVLINK_MAXRATE 50
 #define TELEMETRY_MAVLINK_DELAY ((1000 * 1000) / TELEMETRY_MAVLINK_MAXRATE)
 
+#define MAVLINK_V2_STX              0xFD
+#define MAVLINK_V2_HEADER_LEN       10U
+#define MAVLINK_V2_FRAME_LEN(payloadLen) (MAVLINK_V2_HEADER_LEN + (payloadLen) + MAVLINK_NUM_CHECKSUM_BYTES)
+
+// TX buffer space the lower priority streams leave for the HUD and heartbeat
+#define MAVLINK_TX_RESERVE          (MAVLINK_V2_FRAME_LEN(MAVLINK_MSG_ID_VFR_HUD_LEN) + MAVLINK_V2_FRAME_LEN(MAVLINK_MSG_ID_HEARTBEAT_LEN))
+
 extern uint16_t rssi; // FIXME dependency on mw.c
 
 static serialPort_t *mavlinkPort = NULL;
@@ -96,18 +104,20 @@ static const uint8_t mavRates[] = {
     [MAV_DATA_STREAM_EXTENDED_STATUS] = 2, //2Hz
     [MAV_DATA_STREAM_RC_CHANNELS] = 5, //5Hz
     [MAV_DATA_STREAM_POSITION] = 2, //2Hz
-    [MAV_DATA_STREAM_EXTRA1] = 10, //10Hz
-    [MAV_DATA_STREAM_EXTRA2] = 10 //2Hz
+    [MAV_DATA_STREAM_EXTRA1] = 50, //50Hz
+    [MAV_DATA_STREAM_EXTRA2] = 10 //10Hz
 };
 
 #define MAXSTREAMS (sizeof(mavRates) / sizeof(mavRates[0]))
 
 static uint8_t mavTicks[MAXSTREAMS];
 static mavlink_message_t mavMsg;
-static uint8_t mavBuffer[MAVLINK_MAX_PACKET_LEN];
+static uint8_t mavBuffer[MAVLINK_V2_FRAME_LEN(MAVLINK_MAX_PAYLOAD_LEN)];
 static uint32_t lastMavlinkMessage = 0;
 
-static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum)
+// A stream that is due but does not fit the TX buffer stays due and goes out at the next tick,
+// so the stream rates drop to what the link carries.
+static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum, uint32_t frameLength)
 {
     uint8_t rate = (uint8_t) mavRates[streamNum];
     if (rate == 0) {
@@ -115,6 +125,10 @@ static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum)
     }
 
     if (mavTicks[streamNum] == 0) {
+        if (serialTxBytesFree(mavlinkPort) < frameLength) {
+            return 0;
+        }
+
         // we're triggering now, setup the next trigger point
         if (rate > TELEMETRY_MAVLINK_MAXRATE) {
             rate = TELEMETRY_MAVLINK_MAXRATE;
@@ -129,21 +143,55 @@ static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum)
     return 0;
 }
 
-
-static void mavlinkSerialWrite(uint8_t * buf, uint16_t length)
+// Frame the packed message as MAVLink v2 straight into the TX buffer, through mavBuffer when the port can't.
+// Trailing zero bytes of the payload are left out, the receiver fills them in again.
+static void mavlinkSendMessage(const mavlink_message_t *msg, uint8_t crcExtra)
 {
-    for (int i = 0; i < length; i++)
-        serialWrite(mavlinkPort, buf[i]);
+    const uint8_t *payload = (const uint8_t *)_MAV_PAYLOAD(msg);
+    uint8_t length = msg->len;
+    while (length > 1 && payload[length - 1] == 0) {
+        length--;
+    }
+
+    uint32_t available;
+    uint8_t *buffer = serialReserveWrite(mavlinkPort, &available);
+    if (available < MAVLINK_V2_FRAME_LEN(length)) {
+        buffer = mavBuffer;
+    }
+
+    buffer[0] = MAVLINK_V2_STX;
+    buffer[1] = length;
+    buffer[2] = 0; // incompat flags, not signed
+    buffer[3] = 0; // compat flags
+    buffer[4] = msg->seq;
+    buffer[5] = msg->sysid;
+    buffer[6] = msg->compid;
+    buffer[7] = msg->msgid; // 24 bit message id, all common.xml ids we send fit the low byte
+    buffer[8] = 0;
+    buffer[9] = 0;
+    memcpy(&buffer[MAVLINK_V2_HEADER_LEN], payload, length);
+
+    uint16_t checksum = crc_calculate(&buffer[1], MAVLINK_V2_HEADER_LEN - 1 + length);
+    crc_accumulate(crcExtra, &checksum);
+    buffer[MAVLINK_V2_HEADER_LEN + length] = checksum & 0xFF;
+    buffer[MAVLINK_V2_HEADER_LEN + length + 1] = checksum >> 8;
+
+    if (buffer == mavBuffer) {
+        serialWriteBuf(mavlinkPort, mavBuffer, MAVLINK_V2_FRAME_LEN(length));
+    } else {
+        serialCommitWrite(mavlinkPort, MAVLINK_V2_FRAME_LEN(length));
+    }
 }
 
 static int16_t headingOrScaledMilliAmpereHoursDrawn(void)
 {
-    if (isAmperageConfigured() && telemetryConfig()->mavlink_mah_as_heading_divisor > 0) {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+    if (snapshot->amperageConfigured && telemetryConfig()->mavlink_mah_as_heading_divisor > 0) {
         // In the Connex Prosight OSD, this goes between 0 and 999, so it will need to be scaled in that range.
-        return getMAhDrawn() / telemetryConfig()->mavlink_mah_as_heading_divisor;
+        return snapshot->mAhDrawn / telemetryConfig()->mavlink_mah_as_heading_divisor;
     }
     // heading Current heading in degrees, in compass units (0..360, 0=north)
-    return DECIDEGREES_TO_DEGREES(attitude.values.yaw);
+    return DECIDEGREES_TO_DEGREES(snapshot->yaw);
 }
 
 
@@ -204,7 +252,7 @@ void checkMAVLinkTelemetryState(void)
 
 void mavlinkSendSystemStatus(void)
 {
-    uint16_t msgLength;
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
 
     uint32_t onboardControlAndSensors = 35843;
 
@@ -226,10 +274,10 @@ void mavlinkSendSystemStatus(void)
     int16_t batteryAmperage = -1;
     int8_t batteryRemaining = 100;
 
-    if (getBatteryState() < BATTERY_NOT_PRESENT) {
-        batteryVoltage = isBatteryVoltageConfigured() ? getBatteryVoltage() * 10 : batteryVoltage;
-        batteryAmperage = isAmperageConfigured() ? getAmperage() : batteryAmperage;
-        batteryRemaining = isBatteryVoltageConfigured() ? calculateBatteryPercentageRemaining() : batteryRemaining;
+    if (snapshot->batteryState < BATTERY_NOT_PRESENT) {
+        batteryVoltage = snapshot->batteryVoltageConfigured ? snapshot->batteryVoltage * 10 : batteryVoltage;
+        batteryAmperage = snapshot->amperageConfigured ? snapshot->amperage : batteryAmperage;
+        batteryRemaining = snapshot->batteryVoltageConfigured ? snapshot->batteryRemaining : batteryRemaining;
     }
 
     mavlink_msg_sys_status_pack(0, 200, &mavMsg,
@@ -263,13 +311,11 @@ void mavlinkSendSystemStatus(void)
         0,
         // errors_count4 Autopilot-specific errors
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage(&mavMsg, MAVLINK_MSG_ID_SYS_STATUS_CRC);
 }
 
 void mavlinkSendRCChannelsAndRSSI(void)
 {
-    uint16_t msgLength;
     mavlink_msg_rc_channels_raw_pack(0, 200, &mavMsg,
         // time_boot_ms Timestamp (milliseconds since system boot)
         millis(),
@@ -293,14 +339,13 @@ void mavlinkSendRCChannelsAndRSSI(void)
         (rxRuntimeState.channelCount >= 8) ? rcData[7] : 0,
         // rssi Receive signal strength indicator, 0: 0%, 255: 100%
         constrain(scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 255), 0, 255));
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage(&mavMsg, MAVLINK_MSG_ID_RC_CHANNELS_RAW_CRC);
 }
 
 #if defined(USE_GPS)
 void mavlinkSendPosition(void)
 {
-    uint16_t msgLength;
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
     uint8_t gpsFixType = 0;
 
     if (!sensors(SENSOR_GPS))
@@ -310,7 +355,7 @@ void mavlinkSendPosition(void)
         gpsFixType = 1;
     }
     else {
-        if (gpsSol.numSat < 5) {
+        if (snapshot->gpsNumSat < 5) {
             gpsFixType = 2;
         }
         else {
@@ -324,39 +369,38 @@ void mavlinkSendPosition(void)
         // fix_type 0-1: no fix, 2: 2D fix, 3: 3D fix. Some applications will not use the value of this field unless it is at least two, so always correctly fill in the fix.
         gpsFixType,
         // lat Latitude in 1E7 degrees
-        gpsSol.llh.lat,
+        snapshot->gpsLatitude,
         // lon Longitude in 1E7 degrees
-        gpsSol.llh.lon,
+        snapshot->gpsLongitude,
         // alt Altitude in 1E3 meters (millimeters) above MSL
-        gpsSol.llh.altCm * 10,
+        snapshot->gpsAltitude * 10,
         // eph GPS HDOP horizontal dilution of position in cm (m*100). If unknown, set to: 65535
         65535,
         // epv GPS VDOP horizontal dilution of position in cm (m*100). If unknown, set to: 65535
         65535,
         // vel GPS ground speed (m/s * 100). If unknown, set to: 65535
-        gpsSol.groundSpeed,
+        snapshot->gpsGroundSpeed,
         // cog Course over ground (NOT heading, but direction of movement) in degrees * 100, 0.0..359.99 degrees. If unknown, set to: 65535
-        gpsSol.groundCourse * 10,
+        snapshot->gpsGroundCourse * 10,
         // satellites_visible Number of satellites visible. If unknown, set to 255
-        gpsSol.numSat);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+        snapshot->gpsNumSat);
+    mavlinkSendMessage(&mavMsg, MAVLINK_MSG_ID_GPS_RAW_INT_CRC);
 
     // Global position
     mavlink_msg_global_position_int_pack(0, 200, &mavMsg,
         // time_usec Timestamp (microseconds since UNIX epoch or microseconds since system boot)
         micros(),
         // lat Latitude in 1E7 degrees
-        gpsSol.llh.lat,
+        snapshot->gpsLatitude,
         // lon Longitude in 1E7 degrees
-        gpsSol.llh.lon,
+        snapshot->gpsLongitude,
         // alt Altitude in 1E3 meters (millimeters) above MSL
-        gpsSol.llh.altCm * 10,
+        snapshot->gpsAltitude * 10,
         // relative_alt Altitude above ground in meters, expressed as * 1000 (millimeters)
 #if defined(USE_BARO) || defined(USE_RANGEFINDER)
-        (sensors(SENSOR_RANGEFINDER) || sensors(SENSOR_BARO)) ? getEstimatedAltitudeCm() * 10 : gpsSol.llh.altCm * 10,
+        (sensors(SENSOR_RANGEFINDER) || sensors(SENSOR_BARO)) ? snapshot->altitude * 10 : snapshot->gpsAltitude * 10,
 #else
-        gpsSol.llh.altCm * 10,
+        snapshot->gpsAltitude * 10,
 #endif
         // Ground X Speed (Latitude), expressed as m/s * 100
         0,
@@ -367,8 +411,7 @@ void mavlinkSendPosition(void)
         // heading Current heading in degrees, in compass units (0..360, 0=north)
         headingOrScaledMilliAmpereHoursDrawn()
     );
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage(&mavMsg, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_CRC);
 
     mavlink_msg_gps_global_origin_pack(0, 200, &mavMsg,
         // latitude Latitude (WGS84), expressed as * 1E7
@@ -377,36 +420,36 @@ void mavlinkSendPosition(void)
         GPS_home[LON],
         // altitude Altitude(WGS84), expressed as * 1000
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage(&mavMsg, MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN_CRC);
 }
 #endif
 
 void mavlinkSendAttitude(void)
 {
-    uint16_t msgLength;
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
     mavlink_msg_attitude_pack(0, 200, &mavMsg,
         // time_boot_ms Timestamp (milliseconds since system boot)
         millis(),
         // roll Roll angle (rad)
-        DECIDEGREES_TO_RADIANS(attitude.values.roll),
+        DECIDEGREES_TO_RADIANS(snapshot->roll),
         // pitch Pitch angle (rad)
-        DECIDEGREES_TO_RADIANS(-attitude.values.pitch),
+        DECIDEGREES_TO_RADIANS(-snapshot->pitch),
         // yaw Yaw angle (rad)
-        DECIDEGREES_TO_RADIANS(attitude.values.yaw),
+        DECIDEGREES_TO_RADIANS(snapshot->yaw),
         // rollspeed Roll angular speed (rad/s)
         0,
         // pitchspeed Pitch angular speed (rad/s)
         0,
         // yawspeed Yaw angular speed (rad/s)
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage(&mavMsg, MAVLINK_MSG_ID_ATTITUDE_CRC);
 }
 
 void mavlinkSendHUDAndHeartbeat(void)
 {
-    uint16_t msgLength;
+#if defined(USE_GPS) || defined(USE_BARO) || defined(USE_RANGEFINDER)
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+#endif
     float mavAltitude = 0;
     float mavGroundSpeed = 0;
     float mavAirSpeed = 0;
@@ -415,7 +458,7 @@ void mavlinkSendHUDAndHeartbeat(void)
 #if defined(USE_GPS)
     // use ground speed if source available
     if (sensors(SENSOR_GPS)) {
-        mavGroundSpeed = gpsSol.groundSpeed / 100.0f;
+        mavGroundSpeed = snapshot->gpsGroundSpeed / 100.0f;
     }
 #endif
 
@@ -423,18 +466,18 @@ void mavlinkSendHUDAndHeartbeat(void)
 #if defined(USE_BARO) || defined(USE_RANGEFINDER)
     if (sensors(SENSOR_RANGEFINDER) || sensors(SENSOR_BARO)) {
         // Baro or sonar generally is a better estimate of altitude than GPS MSL altitude
-        mavAltitude = getEstimatedAltitudeCm() / 100.0;
+        mavAltitude = snapshot->altitude / 100.0;
     }
 #if defined(USE_GPS)
     else if (sensors(SENSOR_GPS)) {
         // No sonar or baro, just display altitude above MLS
-        mavAltitude = gpsSol.llh.altCm / 100.0;
+        mavAltitude = snapshot->gpsAltitude / 100.0;
     }
 #endif
 #elif defined(USE_GPS)
     if (sensors(SENSOR_GPS)) {
         // No sonar or baro, just display altitude above MLS
-        mavAltitude = gpsSol.llh.altCm / 100.0;
+        mavAltitude = snapshot->gpsAltitude / 100.0;
     }
 #endif
 
@@ -451,8 +494,7 @@ void mavlinkSendHUDAndHeartbeat(void)
         mavAltitude,
         // climb Current climb rate in meters/second
         mavClimbRate);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage(&mavMsg, MAVLINK_MSG_ID_VFR_HUD_CRC);
 
 
     uint8_t mavModes = MAV_MODE_FLAG_MANUAL_INPUT_ENABLED;
@@ -527,34 +569,35 @@ void mavlinkSendHUDAndHeartbeat(void)
         mavCustomMode,
         // system_status System status flag, see MAV_STATE ENUM
         mavSystemState);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage(&mavMsg, MAVLINK_MSG_ID_HEARTBEAT_CRC);
 }
 
 void processMAVLinkTelemetry(void)
 {
     // is executed @ TELEMETRY_MAVLINK_MAXRATE rate
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTENDED_STATUS)) {
+    // HUD and heartbeat go first, the other streams only use the TX buffer beyond MAVLINK_TX_RESERVE
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA2, MAVLINK_TX_RESERVE)) {
+        mavlinkSendHUDAndHeartbeat();
+    }
+
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTENDED_STATUS, MAVLINK_TX_RESERVE + MAVLINK_V2_FRAME_LEN(MAVLINK_MSG_ID_SYS_STATUS_LEN))) {
         mavlinkSendSystemStatus();
     }
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_RC_CHANNELS)) {
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_RC_CHANNELS, MAVLINK_TX_RESERVE + MAVLINK_V2_FRAME_LEN(MAVLINK_MSG_ID_RC_CHANNELS_RAW_LEN))) {
         mavlinkSendRCChannelsAndRSSI();
     }
 
 #ifdef USE_GPS
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_POSITION)) {
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_POSITION, MAVLINK_TX_RESERVE + MAVLINK_V2_FRAME_LEN(MAVLINK_MSG_ID_GPS_RAW_INT_LEN)
+            + MAVLINK_V2_FRAME_LEN(MAVLINK_MSG_ID_GLOBAL_POSITION_INT_LEN) + MAVLINK_V2_FRAME_LEN(MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN_LEN))) {
         mavlinkSendPosition();
     }
 #endif
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA1)) {
+    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA1, MAVLINK_TX_RESERVE + MAVLINK_V2_FRAME_LEN(MAVLINK_MSG_ID_ATTITUDE_LEN))) {
         mavlinkSendAttitude();
     }
-
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA2)) {
-        mavlinkSendHUDAndHeartbeat();
-    }
 }
 
 void handleMAVLinkTelemetry(void)
@@ -0,0 +1,103 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_TELEMETRY
+
+#include "common/maths.h"
+
+#include "telemetry/schedule.h"
+
+// ages beyond this are all equally overdue, keeps the urgency in range
+#define TELEMETRY_SCHEDULE_AGE_MAX_MS   60000
+
+void telemetryScheduleInit(telemetrySchedule_t *schedule, telemetrySlot_t *slots, uint8_t size)
+{
+    memset(slots, 0, sizeof(telemetrySlot_t) * size);
+    schedule->slots = slots;
+    schedule->size = size;
+    schedule->count = 0;
+    schedule->minPriority = 0;
+}
+
+void telemetryScheduleAdd(telemetrySchedule_t *schedule, uint16_t id, uint16_t intervalMs, uint8_t priority)
+{
+    if (schedule->count >= schedule->size) {
+        return;
+    }
+
+    telemetrySlot_t *slot = &schedule->slots[schedule->count++];
+    slot->id = id;
+    slot->intervalMs = MAX(intervalMs, 1);
+    slot->priority = MAX(priority, 1);
+    slot->valueValid = false;
+    slot->lastCheckedMs = 0;
+    slot->lastSentMs = 0;
+}
+
+// Pick the slot with the highest priority weighted age relative to its interval.
+// A slot is handed out even when nothing is due yet, the caller owns the link slot anyway.
+// Slots below the minimum priority are skipped, NULL when none is left.
+telemetrySlot_t *telemetryScheduleNext(telemetrySchedule_t *schedule, timeMs_t currentTimeMs)
+{
+    telemetrySlot_t *next = NULL;
+    uint32_t nextUrgency = 0;
+
+    for (int i = 0; i < schedule->count; i++) {
+        telemetrySlot_t *slot = &schedule->slots[i];
+        if (slot->priority < schedule->minPriority) {
+            continue;
+        }
+        const uint32_t age = MIN(currentTimeMs - slot->lastCheckedMs, (uint32_t)TELEMETRY_SCHEDULE_AGE_MAX_MS);
+        const uint32_t urgency = (age * slot->priority * 256) / slot->intervalMs;
+        if (!next || urgency > nextUrgency) {
+            next = slot;
+            nextUrgency = urgency;
+        }
+    }
+
+    if (next) {
+        next->lastCheckedMs = currentTimeMs;
+    }
+
+    return next;
+}
+
+// Returns true when the value has to be sent: it changed, or it was last sent too long ago
+bool telemetryScheduleValueDue(telemetrySlot_t *slot, timeMs_t currentTimeMs, uint32_t value)
+{
+    if (slot->valueValid && slot->lastValue == value && currentTimeMs - slot->lastSentMs < TELEMETRY_SCHEDULE_REFRESH_MS) {
+        return false;
+    }
+
+    slot->valueValid = true;
+    slot->lastValue = value;
+    slot->lastSentMs = currentTimeMs;
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Sensor scheduler for the polled telemetry protocols. Every sensor has a
+ * target update interval and a priority, each free telemetry slot goes to
+ * the sensor that is most overdue relative to its interval. Values that
+ * did not change since they were last sent are skipped, so the slot goes
+ * to the next sensor, until TELEMETRY_SCHEDULE_REFRESH_MS has passed.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+// unchanged values are still sent this often, so the receiver does not time the sensor out
+#define TELEMETRY_SCHEDULE_REFRESH_MS   1000
+
+typedef struct telemetrySlot_s {
+    uint16_t id;                // protocol specific sensor or frame id
+    uint16_t intervalMs;        // target update interval
+    uint8_t  priority;          // weight of the age, higher is more urgent
+    bool     valueValid;
+    timeMs_t lastCheckedMs;     // last time the slot was picked
+    timeMs_t lastSentMs;        // last time the value was sent
+    uint32_t lastValue;         // value or hash of the frame sent last
+} telemetrySlot_t;
+
+typedef struct telemetrySchedule_s {
+    telemetrySlot_t *slots;
+    uint8_t size;
+    uint8_t count;
+    uint8_t minPriority;        // slots with a lower priority are not handed out
+} telemetrySchedule_t;
+
+void telemetryScheduleInit(telemetrySchedule_t *schedule, telemetrySlot_t *slots, uint8_t size);
+void telemetryScheduleAdd(telemetrySchedule_t *schedule, uint16_t id, uint16_t intervalMs, uint8_t priority);
+telemetrySlot_t *telemetryScheduleNext(telemetrySchedule_t *schedule, timeMs_t currentTimeMs);
+bool telemetryScheduleValueDue(telemetrySlot_t *slot, timeMs_t currentTimeMs, uint32_t value);
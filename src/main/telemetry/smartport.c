@@ -50,10 +50,12 @@
 #include "fc/runtime_config.h"
 
 #include "flight/failsafe.h"
+#include "flight/governor.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/position.h"
+#include "flight/vibration.h"
 
 #include "io/beeper.h"
 #include "io/gps.h"
@@ -79,7 +81,9 @@
 #include "sensors/sensors.h"
 
 #include "telemetry/msp_shared.h"
+#include "telemetry/schedule.h"
 #include "telemetry/smartport.h"
+#include "telemetry/snapshot.h"
 #include "telemetry/telemetry.h"
 
 #define SMARTPORT_MIN_TELEMETRY_RESPONSE_DELAY_US 500
@@ -148,13 +152,20 @@ enum
     FSSP_DATAID_TEMP7      = 0x0B77 ,
     FSSP_DATAID_TEMP8      = 0x0B78 ,
     FSSP_DATAID_A3         = 0x0900 ,
-    FSSP_DATAID_A4         = 0x0910
+    FSSP_DATAID_A4         = 0x0910 ,
+    // DIY range, shown as plain numbers on the radio
+    FSSP_DATAID_GOV_STATE  = 0x5100 ,
+    FSSP_DATAID_GOV_THROTTLE = 0x5101 ,
+    FSSP_DATAID_VIB_MAIN_1X = 0x5110 ,
+    FSSP_DATAID_VIB_MAIN_2X = 0x5111 ,
+    FSSP_DATAID_VIB_TAIL_1X = 0x5112
 };
 
 // if adding more sensors then increase this value (should be equal to the maximum number of ADD_SENSOR calls)
-#define MAX_DATAIDS 20
+#define MAX_DATAIDS 27
 
-static uint16_t frSkyDataIdTable[MAX_DATAIDS];
+static telemetrySlot_t frSkyDataIdSlots[MAX_DATAIDS];
+static telemetrySchedule_t frSkyDataIdSchedule;
 
 #ifdef USE_ESC_SENSOR_TELEMETRY
 // number of sensors to send between sending the ESC sensors
@@ -164,7 +175,6 @@ static uint16_t frSkyDataIdTable[MAX_DATAIDS];
 #define MAX_ESC_DATAIDS 4
 
 static uint16_t frSkyEscDataIdTable[MAX_ESC_DATAIDS];
-#endif
 
 typedef struct frSkyTableInfo_s {
     uint16_t * table;
@@ -172,8 +182,6 @@ typedef struct frSkyTableInfo_s {
     uint8_t index;
 } frSkyTableInfo_t;
 
-static frSkyTableInfo_t frSkyDataIdTableInfo = { frSkyDataIdTable, 0, 0 };
-#ifdef USE_ESC_SENSOR_TELEMETRY
 static frSkyTableInfo_t frSkyEscDataIdTableInfo = {frSkyEscDataIdTable, 0, 0};
 #endif
 
@@ -294,14 +302,42 @@ bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload)
     return payload->frameId == FSSP_MSPC_FRAME_SMARTPORT || payload->frameId == FSSP_MSPC_FRAME_FPORT;
 }
 
+static uint8_t *smartPortEscapeByte(uint8_t *dst, uint8_t c)
+{
+    if (c == FSSP_DLE || c == FSSP_START_STOP) {
+        *dst++ = FSSP_DLE;
+        *dst++ = c ^ FSSP_DLE_XOR;
+    } else {
+        *dst++ = c;
+    }
+
+    return dst;
+}
+
 void smartPortWriteFrameSerial(const smartPortPayload_t *payload, serialPort_t *port, uint16_t checksum)
 {
-    uint8_t *data = (uint8_t *)payload;
+    // Escaped straight into the TX buffer when it has room for the worst case, through a local frame otherwise
+    uint8_t frame[(sizeof(smartPortPayload_t) + 1) * 2];
+    uint32_t available;
+    uint8_t *buffer = serialReserveWrite(port, &available);
+    if (available < sizeof(frame)) {
+        buffer = frame;
+    }
+
+    uint8_t *dst = buffer;
+    const uint8_t *data = (const uint8_t *)payload;
     for (unsigned i = 0; i < sizeof(smartPortPayload_t); i++) {
-        smartPortSendByte(*data++, &checksum, port);
+        checksum += *data;
+        dst = smartPortEscapeByte(dst, *data++);
     }
     checksum = 0xff - ((checksum & 0xff) + (checksum >> 8));
-    smartPortSendByte((uint8_t)checksum, NULL, port);
+    dst = smartPortEscapeByte(dst, (uint8_t)checksum);
+
+    if (buffer == frame) {
+        serialWriteBuf(port, frame, dst - frame);
+    } else {
+        serialCommitWrite(port, dst - buffer);
+    }
 }
 
 static void smartPortWriteFrameInternal(const smartPortPayload_t *payload)
@@ -319,21 +355,60 @@ static void smartPortSendPackage(uint16_t id, uint32_t val)
     smartPortWriteFrame(&payload);
 }
 
-#define ADD_SENSOR(dataId) frSkyDataIdTableInfo.table[frSkyDataIdTableInfo.index++] = dataId
+// Sends the value unless it did not change since it was last sent, then the slot is left to the next sensor.
+// ESC sensors are not scheduled and always sent.
+static void smartPortSendSensor(telemetrySlot_t *slot, uint16_t id, uint32_t val, volatile bool *clearToSend)
+{
+    if (!slot || telemetryScheduleValueDue(slot, millis(), val)) {
+        smartPortSendPackage(id, val);
+        *clearToSend = false;
+    }
+}
+
+// interval in ms and priority of each sensor, see telemetry/schedule.h
+#define ADD_SENSOR(dataId, intervalMs, priority) telemetryScheduleAdd(&frSkyDataIdSchedule, dataId, intervalMs, priority)
 #define ADD_ESC_SENSOR(dataId) frSkyEscDataIdTableInfo.table[frSkyEscDataIdTableInfo.index++] = dataId
 
 static void initSmartPortSensors(void)
 {
-    frSkyDataIdTableInfo.index = 0;
+    telemetryScheduleInit(&frSkyDataIdSchedule, frSkyDataIdSlots, MAX_DATAIDS);
 
     if (telemetryIsSensorEnabled(SENSOR_MODE)) {
-        ADD_SENSOR(FSSP_DATAID_T1);
-        ADD_SENSOR(FSSP_DATAID_T2);
+        ADD_SENSOR(FSSP_DATAID_T1, 500, 2);
+        ADD_SENSOR(FSSP_DATAID_T2, 1000, 1);
     }
 
 #if defined(USE_ADC_INTERNAL)
     if (telemetryIsSensorEnabled(SENSOR_TEMPERATURE)) {
-        ADD_SENSOR(FSSP_DATAID_T11);
+        ADD_SENSOR(FSSP_DATAID_T11, 2000, 1);
+    }
+#endif
+
+    if (telemetryIsSensorEnabled(SENSOR_HEADSPEED)) {
+#ifdef USE_ESC_SENSOR_TELEMETRY
+        if (!telemetryIsSensorEnabled(ESC_SENSOR_RPM))
+#endif
+        {
+            ADD_SENSOR(FSSP_DATAID_RPM, 100, 3);
+        }
+    }
+
+    if (telemetryIsSensorEnabled(SENSOR_GOVERNOR)) {
+        ADD_SENSOR(FSSP_DATAID_GOV_STATE, 500, 2);
+        ADD_SENSOR(FSSP_DATAID_GOV_THROTTLE, 200, 2);
+    }
+
+#ifdef USE_VIBRATION_MONITOR
+    if (vibrationConfig()->vibration_monitor && telemetryIsSensorEnabled(SENSOR_VIBRATION)) {
+        ADD_SENSOR(FSSP_DATAID_VIB_MAIN_1X, 1000, 1);
+        ADD_SENSOR(FSSP_DATAID_VIB_MAIN_2X, 1000, 1);
+        ADD_SENSOR(FSSP_DATAID_VIB_TAIL_1X, 1000, 1);
+    }
+#endif
+
+#ifdef ADC_POWER_5V
+    if (telemetryIsSensorEnabled(SENSOR_BEC_VOLTAGE)) {
+        ADD_SENSOR(FSSP_DATAID_A3, 500, 2);
     }
 #endif
 
@@ -342,10 +417,10 @@ static void initSmartPortSensors(void)
         if (!telemetryIsSensorEnabled(ESC_SENSOR_VOLTAGE))
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_VFAS);
+            ADD_SENSOR(FSSP_DATAID_VFAS, 200, 3);
         }
 
-        ADD_SENSOR(FSSP_DATAID_A4);
+        ADD_SENSOR(FSSP_DATAID_A4, 500, 2);
     }
 
     if (isAmperageConfigured() && telemetryIsSensorEnabled(SENSOR_CURRENT)) {
@@ -353,68 +428,65 @@ static void initSmartPortSensors(void)
         if (!telemetryIsSensorEnabled(ESC_SENSOR_CURRENT))
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_CURRENT);
+            ADD_SENSOR(FSSP_DATAID_CURRENT, 200, 3);
         }
 
         if (telemetryIsSensorEnabled(SENSOR_FUEL)) {
-            ADD_SENSOR(FSSP_DATAID_FUEL);
+            ADD_SENSOR(FSSP_DATAID_FUEL, 1000, 2);
         }
     }
 
     if (telemetryIsSensorEnabled(SENSOR_HEADING)) {
-        ADD_SENSOR(FSSP_DATAID_HEADING);
+        ADD_SENSOR(FSSP_DATAID_HEADING, 200, 1);
     }
 
 #if defined(USE_ACC)
     if (sensors(SENSOR_ACC)) {
         if (telemetryIsSensorEnabled(SENSOR_PITCH)) {
-            ADD_SENSOR(FSSP_DATAID_PITCH);
+            ADD_SENSOR(FSSP_DATAID_PITCH, 200, 1);
         }
         if (telemetryIsSensorEnabled(SENSOR_ROLL)) {
-            ADD_SENSOR(FSSP_DATAID_ROLL);
+            ADD_SENSOR(FSSP_DATAID_ROLL, 200, 1);
         }
         if (telemetryIsSensorEnabled(SENSOR_ACC_X)) {
-            ADD_SENSOR(FSSP_DATAID_ACCX);
+            ADD_SENSOR(FSSP_DATAID_ACCX, 200, 1);
         }
         if (telemetryIsSensorEnabled(SENSOR_ACC_Y)) {
-            ADD_SENSOR(FSSP_DATAID_ACCY);
+            ADD_SENSOR(FSSP_DATAID_ACCY, 200, 1);
         }
         if (telemetryIsSensorEnabled(SENSOR_ACC_Z)) {
-            ADD_SENSOR(FSSP_DATAID_ACCZ);
+            ADD_SENSOR(FSSP_DATAID_ACCZ, 200, 1);
         }
     }
 #endif
 
     if (sensors(SENSOR_BARO)) {
         if (telemetryIsSensorEnabled(SENSOR_ALTITUDE)) {
-            ADD_SENSOR(FSSP_DATAID_ALTITUDE);
+            ADD_SENSOR(FSSP_DATAID_ALTITUDE, 200, 2);
         }
         if (telemetryIsSensorEnabled(SENSOR_VARIO)) {
-            ADD_SENSOR(FSSP_DATAID_VARIO);
+            ADD_SENSOR(FSSP_DATAID_VARIO, 200, 2);
         }
     }
 
 #ifdef USE_GPS
     if (featureIsEnabled(FEATURE_GPS)) {
         if (telemetryIsSensorEnabled(SENSOR_GROUND_SPEED)) {
-            ADD_SENSOR(FSSP_DATAID_SPEED);
+            ADD_SENSOR(FSSP_DATAID_SPEED, 500, 1);
         }
         if (telemetryIsSensorEnabled(SENSOR_LAT_LONG)) {
-            ADD_SENSOR(FSSP_DATAID_LATLONG);
-            ADD_SENSOR(FSSP_DATAID_LATLONG); // twice (one for lat, one for long)
+            ADD_SENSOR(FSSP_DATAID_LATLONG, 1000, 1);
+            ADD_SENSOR(FSSP_DATAID_LATLONG, 1000, 1); // twice (one for lat, one for long)
         }
         if (telemetryIsSensorEnabled(SENSOR_DISTANCE)) {
-            ADD_SENSOR(FSSP_DATAID_HOME_DIST);
+            ADD_SENSOR(FSSP_DATAID_HOME_DIST, 1000, 1);
         }
         if (telemetryIsSensorEnabled(SENSOR_ALTITUDE)) {
-            ADD_SENSOR(FSSP_DATAID_GPS_ALT);
+            ADD_SENSOR(FSSP_DATAID_GPS_ALT, 1000, 1);
         }
     }
 #endif
 
-    frSkyDataIdTableInfo.size = frSkyDataIdTableInfo.index;
-    frSkyDataIdTableInfo.index = 0;
-
 #ifdef USE_ESC_SENSOR_TELEMETRY
     frSkyEscDataIdTableInfo.index = 0;
 
@@ -563,40 +635,35 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
         }
 #endif
 
-        // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
-        frSkyTableInfo_t * tableInfo = &frSkyDataIdTableInfo;
+        // we can send back any data we want, the schedule picks the sensor that is most overdue
+        telemetrySlot_t *slot = NULL;
+        uint16_t id;
 
 #ifdef USE_ESC_SENSOR_TELEMETRY
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            // send ESC sensors
-            tableInfo = &frSkyEscDataIdTableInfo;
-            if (tableInfo->index == tableInfo->size) { // end of ESC table, return to other sensors
-                tableInfo->index = 0;
-                smartPortIdCycleCnt = 0;
-                smartPortIdOffset++;
-                if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
-                    smartPortIdOffset = 0;
-                }
-            }
-        }
-        if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD) {
-            // send other sensors
-            tableInfo = &frSkyDataIdTableInfo;
-#endif
-            if (tableInfo->index == tableInfo->size) { // end of table reached, loop back
-                tableInfo->index = 0;
+        frSkyTableInfo_t * tableInfo = &frSkyEscDataIdTableInfo;
+        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD && tableInfo->index == tableInfo->size) {
+            // end of ESC table, return to other sensors
+            tableInfo->index = 0;
+            smartPortIdCycleCnt = 0;
+            smartPortIdOffset++;
+            if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
+                smartPortIdOffset = 0;
             }
-#ifdef USE_ESC_SENSOR_TELEMETRY
         }
-#endif
-        uint16_t id = tableInfo->table[tableInfo->index];
-#ifdef USE_ESC_SENSOR_TELEMETRY
         if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            id += smartPortIdOffset;
-        }
+            // send ESC sensors
+            id = tableInfo->table[tableInfo->index++] + smartPortIdOffset;
+        } else
 #endif
+        {
+            // low priority sensors wait while the link is poor
+            frSkyDataIdSchedule.minPriority = telemetryBudgetMinPriority();
+            slot = telemetryScheduleNext(&frSkyDataIdSchedule, millis());
+            id = slot ? slot->id : 0; // nothing is sent for an empty schedule
+        }
         smartPortIdCycleCnt++;
-        tableInfo->index++;
+
+        const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
 
         int32_t tmpi;
         uint32_t tmp2 = 0;
@@ -609,13 +676,12 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
 
         switch (id) {
             case FSSP_DATAID_VFAS       :
-                vfasVoltage = getBatteryVoltage();
+                vfasVoltage = snapshot->batteryVoltage;
                 if (telemetryConfig()->report_cell_voltage) {
-                    cellCount = getBatteryCellCount();
-                    vfasVoltage = cellCount ? getBatteryVoltage() / cellCount : 0;
+                    cellCount = snapshot->batteryCellCount;
+                    vfasVoltage = cellCount ? snapshot->batteryVoltage / cellCount : 0;
                 }
-                smartPortSendPackage(id, vfasVoltage); // given in 0.01V, convert to volts
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, vfasVoltage, clearToSend); // given in 0.01V, convert to volts
                 break;
 #ifdef USE_ESC_SENSOR_TELEMETRY
             case FSSP_DATAID_VFAS1      :
@@ -628,14 +694,12 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_VFAS8      :
                 escData = getEscSensorData(id - FSSP_DATAID_VFAS1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, escData->voltage);
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, escData->voltage, clearToSend);
                 }
                 break;
 #endif
             case FSSP_DATAID_CURRENT    :
-                smartPortSendPackage(id, getAmperage() / 10); // given in 10mA steps, unknown requested unit
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, snapshot->amperage / 10, clearToSend); // given in 10mA steps, unknown requested unit
                 break;
 #ifdef USE_ESC_SENSOR_TELEMETRY
             case FSSP_DATAID_CURRENT1   :
@@ -648,17 +712,44 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_CURRENT8   :
                 escData = getEscSensorData(id - FSSP_DATAID_CURRENT1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, escData->current);
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, escData->current, clearToSend);
                 }
                 break;
+#endif
             case FSSP_DATAID_RPM        :
-                escData = getEscSensorData(ESC_SENSOR_COMBINED);
-                if (escData != NULL) {
-                    smartPortSendPackage(id, calcEscRpm(0,escData->rpm)/mixerGetGovGearRatio()); // HF3D: Averate RPM does not make sense
-                    *clearToSend = false;
+#ifdef USE_ESC_SENSOR_TELEMETRY
+                if (!slot) {
+                    // from the ESC table
+                    escData = getEscSensorData(ESC_SENSOR_COMBINED);
+                    if (escData != NULL) {
+                        smartPortSendSensor(slot, id, calcEscRpm(0,escData->rpm)/governorGetGearRatio(), clearToSend); // HF3D: Averate RPM does not make sense
+                    }
+                    break;
                 }
+#endif
+                smartPortSendSensor(slot, id, snapshot->headspeed, clearToSend);
+                break;
+            case FSSP_DATAID_GOV_STATE  :
+                smartPortSendSensor(slot, id, snapshot->governorState, clearToSend); // govState_e
                 break;
+            case FSSP_DATAID_GOV_THROTTLE :
+                smartPortSendSensor(slot, id, snapshot->governorThrottle, clearToSend); // percent
+                break;
+#ifdef USE_VIBRATION_MONITOR
+            case FSSP_DATAID_VIB_MAIN_1X :
+                smartPortSendSensor(slot, id, snapshot->vibration[VIBRATION_MAIN_1X], clearToSend); // 0.1 deg/s
+                break;
+            case FSSP_DATAID_VIB_MAIN_2X :
+                smartPortSendSensor(slot, id, snapshot->vibration[VIBRATION_MAIN_2X], clearToSend);
+                break;
+            case FSSP_DATAID_VIB_TAIL_1X :
+                smartPortSendSensor(slot, id, snapshot->vibration[VIBRATION_TAIL_1X], clearToSend);
+                break;
+#endif
+            case FSSP_DATAID_A3         :
+                smartPortSendSensor(slot, id, snapshot->becVoltage, clearToSend); // given in 0.01V
+                break;
+#ifdef USE_ESC_SENSOR_TELEMETRY
             case FSSP_DATAID_RPM1       :
             case FSSP_DATAID_RPM2       :
             case FSSP_DATAID_RPM3       :
@@ -669,15 +760,13 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_RPM8       :
                 escData = getEscSensorData(id - FSSP_DATAID_RPM1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, calcEscRpm(id - FSSP_DATAID_RPM1, escData->rpm));
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, calcEscRpm(id - FSSP_DATAID_RPM1, escData->rpm), clearToSend);
                 }
                 break;
             case FSSP_DATAID_TEMP        :
                 escData = getEscSensorData(ESC_SENSOR_COMBINED);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, escData->temperature);
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, escData->temperature, clearToSend);
                 }
                 break;
             case FSSP_DATAID_TEMP1      :
@@ -690,47 +779,37 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_TEMP8      :
                 escData = getEscSensorData(id - FSSP_DATAID_TEMP1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, escData->temperature);
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, escData->temperature, clearToSend);
                 }
                 break;
 #endif
             case FSSP_DATAID_ALTITUDE   :
-                smartPortSendPackage(id, getEstimatedAltitudeCm()); // unknown given unit, requested 100 = 1 meter
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, snapshot->altitude, clearToSend); // unknown given unit, requested 100 = 1 meter
                 break;
             case FSSP_DATAID_FUEL       :
-                smartPortSendPackage(id, getMAhDrawn()); // given in mAh, unknown requested unit
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, snapshot->mAhDrawn, clearToSend); // given in mAh, unknown requested unit
                 break;
             case FSSP_DATAID_VARIO      :
-                smartPortSendPackage(id, getEstimatedVario()); // unknown given unit but requested in 100 = 1m/s
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, snapshot->vario, clearToSend); // unknown given unit but requested in 100 = 1m/s
                 break;
             case FSSP_DATAID_HEADING    :
-                smartPortSendPackage(id, attitude.values.yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, snapshot->yaw * 10, clearToSend); // given in 10*deg, requested in 10000 = 100 deg
                 break;
 #if defined(USE_ACC)
             case FSSP_DATAID_PITCH      :
-                smartPortSendPackage(id, attitude.values.pitch); // given in 10*deg
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, snapshot->pitch, clearToSend); // given in 10*deg
                 break;
             case FSSP_DATAID_ROLL       :
-                smartPortSendPackage(id, attitude.values.roll); // given in 10*deg
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, snapshot->roll, clearToSend); // given in 10*deg
                 break;
             case FSSP_DATAID_ACCX       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[X] * acc.dev.acc_1G_rec)); // Multiply by 100 to show as x.xx g on Taranis
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, lrintf(100 * acc.accADC[X] * acc.dev.acc_1G_rec), clearToSend); // Multiply by 100 to show as x.xx g on Taranis
                 break;
             case FSSP_DATAID_ACCY       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[Y] * acc.dev.acc_1G_rec));
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, lrintf(100 * acc.accADC[Y] * acc.dev.acc_1G_rec), clearToSend);
                 break;
             case FSSP_DATAID_ACCZ       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[Z] * acc.dev.acc_1G_rec));
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, lrintf(100 * acc.accADC[Z] * acc.dev.acc_1G_rec), clearToSend);
                 break;
 #endif
             case FSSP_DATAID_T1         :
@@ -772,19 +851,16 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     tmpi += 4000;
                 }
 
-                smartPortSendPackage(id, (uint32_t)tmpi);
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, (uint32_t)tmpi, clearToSend);
                 break;
             case FSSP_DATAID_T2         :
 #ifdef USE_GPS
                 if (sensors(SENSOR_GPS)) {
                     // satellite accuracy HDOP: 0 = worst [HDOP > 5.5m], 9 = best [HDOP <= 1.0m]
-                    uint16_t hdop = constrain(scaleRange(gpsSol.hdop, 100, 550, 9, 0), 0, 9) * 100;
-                    smartPortSendPackage(id, (STATE(GPS_FIX) ? 1000 : 0) + (STATE(GPS_FIX_HOME) ? 2000 : 0) + hdop + gpsSol.numSat);
-                    *clearToSend = false;
+                    uint16_t hdop = constrain(scaleRange(snapshot->gpsHdop, 100, 550, 9, 0), 0, 9) * 100;
+                    smartPortSendSensor(slot, id, (STATE(GPS_FIX) ? 1000 : 0) + (STATE(GPS_FIX_HOME) ? 2000 : 0) + hdop + snapshot->gpsNumSat, clearToSend);
                 } else if (featureIsEnabled(FEATURE_GPS)) {
-                    smartPortSendPackage(id, 0);
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, 0, clearToSend);
                 } else
 #endif
                 if (telemetryConfig()->pidValuesAsTelemetry) {
@@ -815,15 +891,13 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     if (t2Cnt == 4) {
                         t2Cnt = 0;
                     }
-                    smartPortSendPackage(id, tmp2);
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, tmp2, clearToSend);
                 }
 
                 break;
 #if defined(USE_ADC_INTERNAL)
             case FSSP_DATAID_T11        :
-                smartPortSendPackage(id, getCoreTemperatureCelsius());
-                *clearToSend = false;
+                smartPortSendSensor(slot, id, getCoreTemperatureCelsius(), clearToSend);
                 break;
 #endif
 #ifdef USE_GPS
@@ -831,9 +905,8 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 if (STATE(GPS_FIX)) {
                     //convert to knots: 1cm/s = 0.0194384449 knots
                     //Speed should be sent in knots/1000 (GPS speed is in cm/s)
-                    uint32_t tmpui = gpsSol.groundSpeed * 1944 / 100;
-                    smartPortSendPackage(id, tmpui);
-                    *clearToSend = false;
+                    uint32_t tmpui = snapshot->gpsGroundSpeed * 1944 / 100;
+                    smartPortSendSensor(slot, id, tmpui, clearToSend);
                 }
                 break;
             case FSSP_DATAID_LATLONG    :
@@ -842,38 +915,34 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     // the same ID is sent twice, one for longitude, one for latitude
                     // the MSB of the sent uint32_t helps FrSky keep track
                     // the even/odd bit of our counter helps us keep track
-                    if (tableInfo->index & 1) {
-                        tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
+                    if ((slot - frSkyDataIdSlots) & 1) {
+                        tmpui = abs(snapshot->gpsLongitude);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
-                        if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
+                        if (snapshot->gpsLongitude < 0) tmpui |= 0x40000000;
                     }
                     else {
-                        tmpui = abs(gpsSol.llh.lat);  // now we have unsigned value and one bit to spare
+                        tmpui = abs(snapshot->gpsLatitude);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25;  // 6/100 = 1.5/25, division by power of 2 is fast
-                        if (gpsSol.llh.lat < 0) tmpui |= 0x40000000;
+                        if (snapshot->gpsLatitude < 0) tmpui |= 0x40000000;
                     }
-                    smartPortSendPackage(id, tmpui);
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, tmpui, clearToSend);
                 }
                 break;
             case FSSP_DATAID_HOME_DIST  :
                 if (STATE(GPS_FIX)) {
-                    smartPortSendPackage(id, GPS_distanceToHome);
-                     *clearToSend = false;
+                    smartPortSendSensor(slot, id, snapshot->gpsDistanceToHome, clearToSend);
                 }
                 break;
             case FSSP_DATAID_GPS_ALT    :
                 if (STATE(GPS_FIX)) {
-                    smartPortSendPackage(id, gpsSol.llh.altCm); // given in 0.01m
-                    *clearToSend = false;
+                    smartPortSendSensor(slot, id, snapshot->gpsAltitude, clearToSend); // given in 0.01m
                 }
                 break;
 #endif
             case FSSP_DATAID_A4         :
-                cellCount = getBatteryCellCount();
-                vfasVoltage = cellCount ? (getBatteryVoltage() / cellCount) : 0; // given in 0.01V, convert to volts
-                smartPortSendPackage(id, vfasVoltage);
-                *clearToSend = false;
+                cellCount = snapshot->batteryCellCount;
+                vfasVoltage = cellCount ? (snapshot->batteryVoltage / cellCount) : 0; // given in 0.01V, convert to volts
+                smartPortSendSensor(slot, id, vfasVoltage, clearToSend);
                 break;
             default:
                 break;
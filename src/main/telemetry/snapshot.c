@@ -0,0 +1,144 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#if defined(USE_TELEMETRY) || defined(USE_OSD)
+
+#include "common/maths.h"
+
+#include "drivers/time.h"
+
+#include "flight/flight_state.h"
+#include "flight/position.h"
+#include "flight/vibration.h"
+
+#include "io/gps.h"
+
+#include "sensors/battery.h"
+#include "sensors/esc_sensor.h"
+#include "sensors/voltage.h"
+
+#include "telemetry/snapshot.h"
+
+static telemetrySnapshot_t snapshot;
+static timeUs_t snapshotTimeUs;
+static bool snapshotTaken = false;
+
+void telemetrySnapshotUpdate(void)
+{
+    snapshotTimeUs = micros();
+    snapshotTaken = true;
+
+    snapshot.batteryState = getBatteryState();
+    snapshot.batteryVoltageConfigured = isBatteryVoltageConfigured();
+    snapshot.amperageConfigured = isAmperageConfigured();
+
+    snapshot.batteryVoltage = getBatteryVoltage();
+    snapshot.batteryLegacyVoltage = getLegacyBatteryVoltage();
+    snapshot.batteryCellVoltage = getBatteryAverageCellVoltage();
+    snapshot.batteryVoltageOpenCircuit = lrintf(getBatteryVoltageOpenCircuit());
+    snapshot.batteryResistance = lrintf(getBatteryResistance() * 1000.0f);
+    snapshot.batteryCellCount = getBatteryCellCount();
+    snapshot.batteryRemaining = calculateBatteryPercentageRemaining();
+
+    snapshot.amperage = getAmperage();
+    snapshot.mAhDrawn = getMAhDrawn();
+
+#ifdef ADC_POWER_5V
+    voltageMeter_t becMeter;
+    voltageMeterRead(VOLTAGE_METER_ID_5V_1, &becMeter);
+    snapshot.becVoltage = becMeter.filtered;
+#else
+    snapshot.becVoltage = 0;
+#endif
+
+    // The PID loop values come from one PID cycle each, the previous ones are kept if a topic could not be read
+    flightStateHeli_t heli;
+    if (flightStateRead(FLIGHT_STATE_HELI, &heli, sizeof(heli))) {
+        snapshot.governorState = heli.governorState;
+        snapshot.governorThrottle = lrintf(heli.governorOutput * 100);
+        snapshot.headspeed = lrintf(heli.headspeed);
+        snapshot.swashRing = lrintf(heli.swashRing * 100);
+    }
+
+    flightStateCommand_t command;
+    if (flightStateRead(FLIGHT_STATE_COMMAND, &command, sizeof(command))) {
+        snapshot.collectivePitch = lrintf(command.collectivePitch);
+    }
+#ifdef USE_VIBRATION_MONITOR
+    for (int harmonic = 0; harmonic < VIBRATION_HARMONIC_COUNT; harmonic++) {
+        snapshot.vibration[harmonic] = lrintf(constrainf(vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, harmonic) * 10, 0, UINT16_MAX));
+    }
+#endif
+
+    snapshot.escTemperatureValid = false;
+#ifdef USE_ESC_SENSOR
+    const escSensorData_t *escData = getEscSensorData(ESC_SENSOR_COMBINED);
+    if (escData && escData->dataAge < ESC_DATA_INVALID) {
+        snapshot.escTemperature = escData->temperature;
+        snapshot.escTemperatureValid = true;
+    }
+#endif
+
+    flightStateAttitude_t attitude;
+    if (flightStateRead(FLIGHT_STATE_ATTITUDE, &attitude, sizeof(attitude))) {
+        snapshot.roll = attitude.roll;
+        snapshot.pitch = attitude.pitch;
+        snapshot.yaw = attitude.yaw;
+    }
+
+    snapshot.altitude = getEstimatedAltitudeCm();
+    snapshot.vario = getEstimatedVario();
+
+#ifdef USE_GPS
+    snapshot.gpsLatitude = gpsSol.llh.lat;
+    snapshot.gpsLongitude = gpsSol.llh.lon;
+    snapshot.gpsAltitude = gpsSol.llh.altCm;
+    snapshot.gpsGroundSpeed = gpsSol.groundSpeed;
+    snapshot.gpsGroundCourse = gpsSol.groundCourse;
+    snapshot.gpsHdop = gpsSol.hdop;
+    snapshot.gpsNumSat = gpsSol.numSat;
+    snapshot.gpsDistanceToHome = GPS_distanceToHome;
+    snapshot.gpsDirectionToHome = GPS_directionToHome;
+#endif
+}
+
+const telemetrySnapshot_t *getTelemetrySnapshot(void)
+{
+    return &snapshot;
+}
+
+// Returns the snapshot, taking a new one if it is older than maxAgeUs
+const telemetrySnapshot_t *getFreshTelemetrySnapshot(timeUs_t currentTimeUs, timeDelta_t maxAgeUs)
+{
+    if (!snapshotTaken || cmpTimeUs(currentTimeUs, snapshotTimeUs) > maxAgeUs) {
+        telemetrySnapshotUpdate();
+    }
+
+    return &snapshot;
+}
+
+#endif
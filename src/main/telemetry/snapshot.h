@@ -0,0 +1,87 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Sensor values shared by the telemetry protocols. The snapshot is taken
+ * once per telemetry task run, before the protocol handlers, so running
+ * several protocols at once does not read and scale the sensors again
+ * for every frame. The OSD reads the same snapshot, it takes a new one
+ * itself when the telemetry task has not done so recently.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+typedef struct telemetrySnapshot_s {
+    // battery
+    int32_t  amperage;                  // 0.01A
+    int32_t  mAhDrawn;
+    uint16_t batteryVoltage;            // 0.01V
+    uint16_t batteryLegacyVoltage;      // 0.1V
+    uint16_t batteryCellVoltage;        // 0.01V, average per cell
+    uint16_t batteryVoltageOpenCircuit; // 0.01V, with the I*R sag of the pack added back
+    uint16_t batteryResistance;         // mOhm, 0 until estimated
+    uint16_t becVoltage;                // 0.01V, 0 without a 5V meter
+    uint8_t  batteryCellCount;
+    uint8_t  batteryRemaining;          // percent
+    uint8_t  batteryState;              // batteryState_e
+    bool     batteryVoltageConfigured;
+    bool     amperageConfigured;
+
+    // heli
+    uint8_t  governorState;             // govState_e
+    uint8_t  governorThrottle;          // percent, main motor output of the governor
+    uint16_t headspeed;                 // rpm
+    int8_t   escTemperature;            // C, combined ESC sensor data
+    bool     escTemperatureValid;
+    int8_t   collectivePitch;           // signed percent of the collective throw
+    uint8_t  swashRing;                 // percent of the cyclic ring in use
+#ifdef USE_VIBRATION_MONITOR
+    uint16_t vibration[3];              // 0.1 deg/s gyro amplitude at the main 1x, main 2x and tail 1x harmonics
+#endif
+
+    // attitude in decidegrees, yaw 0..3600
+    int16_t  roll;
+    int16_t  pitch;
+    int16_t  yaw;
+
+    int16_t  vario;                     // cm/s
+    int32_t  altitude;                  // cm, estimated
+
+#ifdef USE_GPS
+    int32_t  gpsLatitude;               // degrees * 10^7
+    int32_t  gpsLongitude;
+    int32_t  gpsAltitude;               // cm
+    uint16_t gpsGroundSpeed;            // as gpsSol.groundSpeed
+    uint16_t gpsGroundCourse;           // decidegrees
+    uint16_t gpsHdop;                   // * 100
+    uint16_t gpsDistanceToHome;         // m
+    int16_t  gpsDirectionToHome;        // degrees
+    uint8_t  gpsNumSat;
+#endif
+} telemetrySnapshot_t;
+
+void telemetrySnapshotUpdate(void);
+const telemetrySnapshot_t *getTelemetrySnapshot(void);
+const telemetrySnapshot_t *getFreshTelemetrySnapshot(timeUs_t currentTimeUs, timeDelta_t maxAgeUs);
@@ -61,6 +61,7 @@
 #include "sensors/esc_sensor.h"
 
 #include "telemetry/telemetry.h"
+#include "telemetry/snapshot.h"
 #include "telemetry/srxl.h"
 
 #include "drivers/dshot.h"
@@ -216,6 +217,8 @@ uint16_t getMotorAveragePeriod(void)
 
 bool srxlFrameRpm(sbuf_t *dst, timeUs_t currentTimeUs)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     int16_t coreTemp = SPEKTRUM_TEMP_UNUSED;
 #if defined(USE_ADC_INTERNAL)
     coreTemp = getCoreTemperatureCelsius();
@@ -228,9 +231,9 @@ bool srxlFrameRpm(sbuf_t *dst, timeUs_t currentTimeUs)
     sbufWriteU8(dst, SRXL_FRAMETYPE_SID);
     sbufWriteU16BigEndian(dst, getMotorAveragePeriod());    // pulse leading edges
     if (telemetryConfig()->report_cell_voltage) {
-        sbufWriteU16BigEndian(dst, getBatteryAverageCellVoltage()); // Cell voltage is in units of 0.01V
+        sbufWriteU16BigEndian(dst, snapshot->batteryCellVoltage); // Cell voltage is in units of 0.01V
     } else {
-        sbufWriteU16BigEndian(dst, getBatteryVoltage());   // vbat is in units of 0.01V
+        sbufWriteU16BigEndian(dst, snapshot->batteryVoltage);   // vbat is in units of 0.01V
     }
     sbufWriteU16BigEndian(dst, coreTemp);                   // temperature
     sbufFill(dst, STRU_TELE_RPM_EMPTY_FIELDS_VALUE, STRU_TELE_RPM_EMPTY_FIELDS_COUNT);
@@ -292,42 +295,44 @@ typedef struct
 
 bool srxlFrameGpsLoc(sbuf_t *dst, timeUs_t currentTimeUs)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     UNUSED(currentTimeUs);
     gpsCoordinateDDDMMmmmm_t coordinate;
     uint32_t latitudeBcd, longitudeBcd, altitudeLo;
     uint16_t altitudeLoBcd, groundCourseBcd, hdop;
     uint8_t hdopBcd, gpsFlags;
 
-    if (!featureIsEnabled(FEATURE_GPS) || !STATE(GPS_FIX) || gpsSol.numSat < 6) {
+    if (!featureIsEnabled(FEATURE_GPS) || !STATE(GPS_FIX) || snapshot->gpsNumSat < 6) {
         return false;
     }
 
     // lattitude
-    GPStoDDDMM_MMMM(gpsSol.llh.lat, &coordinate);
+    GPStoDDDMM_MMMM(snapshot->gpsLatitude, &coordinate);
     latitudeBcd  = (dec2bcd(coordinate.dddmm) << 16) | dec2bcd(coordinate.mmmm);
 
     // longitude
-    GPStoDDDMM_MMMM(gpsSol.llh.lon, &coordinate);
+    GPStoDDDMM_MMMM(snapshot->gpsLongitude, &coordinate);
     longitudeBcd = (dec2bcd(coordinate.dddmm) << 16) | dec2bcd(coordinate.mmmm);
 
     // altitude (low order)
-    altitudeLo = ABS(gpsSol.llh.altCm) / 10;
+    altitudeLo = ABS(snapshot->gpsAltitude) / 10;
     altitudeLoBcd = dec2bcd(altitudeLo % 100000);
 
     // Ground course
-    groundCourseBcd = dec2bcd(gpsSol.groundCourse);
+    groundCourseBcd = dec2bcd(snapshot->gpsGroundCourse);
 
     // HDOP
-    hdop = gpsSol.hdop / 10;
+    hdop = snapshot->gpsHdop / 10;
     hdop = (hdop > 99) ? 99 : hdop;
     hdopBcd = dec2bcd(hdop);
 
     // flags
     gpsFlags = GPS_FLAGS_GPS_DATA_RECEIVED_BIT | GPS_FLAGS_GPS_FIX_VALID_BIT | GPS_FLAGS_3D_FIX_BIT;
-    gpsFlags |= (gpsSol.llh.lat > 0) ? GPS_FLAGS_IS_NORTH_BIT : 0;
-    gpsFlags |= (gpsSol.llh.lon > 0) ? GPS_FLAGS_IS_EAST_BIT : 0;
-    gpsFlags |= (gpsSol.llh.altCm < 0) ? GPS_FLAGS_NEGATIVE_ALT_BIT : 0;
-    gpsFlags |= (gpsSol.llh.lon / GPS_DEGREES_DIVIDER > 99) ? GPS_FLAGS_LONGITUDE_GREATER_99_BIT : 0;
+    gpsFlags |= (snapshot->gpsLatitude > 0) ? GPS_FLAGS_IS_NORTH_BIT : 0;
+    gpsFlags |= (snapshot->gpsLongitude > 0) ? GPS_FLAGS_IS_EAST_BIT : 0;
+    gpsFlags |= (snapshot->gpsAltitude < 0) ? GPS_FLAGS_NEGATIVE_ALT_BIT : 0;
+    gpsFlags |= (snapshot->gpsLongitude / GPS_DEGREES_DIVIDER > 99) ? GPS_FLAGS_LONGITUDE_GREATER_99_BIT : 0;
 
     // SRXL frame
     sbufWriteU8(dst, SRXL_FRAMETYPE_GPS_LOC);
@@ -360,22 +365,24 @@ typedef struct
 
 bool srxlFrameGpsStat(sbuf_t *dst, timeUs_t currentTimeUs)
 {
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
     UNUSED(currentTimeUs);
     uint32_t timeBcd;
     uint16_t speedKnotsBcd, speedTmp;
     uint8_t numSatBcd, altitudeHighBcd;
     bool timeProvided = false;
 
-    if (!featureIsEnabled(FEATURE_GPS) || !STATE(GPS_FIX) || gpsSol.numSat < 6) {
+    if (!featureIsEnabled(FEATURE_GPS) || !STATE(GPS_FIX) || snapshot->gpsNumSat < 6) {
         return false;
     }
 
     // Number of sats and altitude (high bits)
-    numSatBcd = (gpsSol.numSat > 99) ? dec2bcd(99) : dec2bcd(gpsSol.numSat);
-    altitudeHighBcd = dec2bcd(gpsSol.llh.altCm / 100000);
+    numSatBcd = (snapshot->gpsNumSat > 99) ? dec2bcd(99) : dec2bcd(snapshot->gpsNumSat);
+    altitudeHighBcd = dec2bcd(snapshot->gpsAltitude / 100000);
 
     // Speed (knots)
-    speedTmp = gpsSol.groundSpeed * 1944 / 1000;
+    speedTmp = snapshot->gpsGroundSpeed * 1944 / 1000;
     speedKnotsBcd = (speedTmp > 9999) ? dec2bcd(9999) : dec2bcd(speedTmp);
 
 #ifdef USE_RTC_TIME
@@ -433,8 +440,10 @@ typedef struct
 
 bool srxlFrameFlightPackCurrent(sbuf_t *dst, timeUs_t currentTimeUs)
 {
-    uint16_t amps = getAmperage() / 10;
-    uint16_t mah  = getMAhDrawn();
+    const telemetrySnapshot_t *snapshot = getTelemetrySnapshot();
+
+    uint16_t amps = snapshot->amperage / 10;
+    uint16_t mah  = snapshot->mAhDrawn;
     static uint16_t sentAmps;
     static uint16_t sentMah;
     static timeUs_t lastTimeSentFPmAh = 0;
@@ -26,6 +26,7 @@
 
 #ifdef USE_TELEMETRY
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "pg/pg.h"
@@ -57,6 +58,20 @@
 #include "telemetry/srxl.h"
 #include "telemetry/ibus.h"
 #include "telemetry/msp_shared.h"
+#include "telemetry/snapshot.h"
+
+// Telemetry bandwidth budget on ports shared with the RC link, in bytes per RC frame at a good link
+#define TELEMETRY_BUDGET_BYTES_PER_RC_FRAME     8
+#define TELEMETRY_BUDGET_BURST_BYTES            32
+// link quality in percent, the budget shrinks below LQ_FULL, low priority sensors wait below LQ_LOW
+#define TELEMETRY_BUDGET_LQ_FULL                80
+#define TELEMETRY_BUDGET_LQ_LOW                 50
+#define TELEMETRY_BUDGET_LQ_CRITICAL            25
+#define TELEMETRY_BUDGET_SHARE_MIN              25
+
+static int32_t telemetryBudgetBytes = TELEMETRY_BUDGET_BURST_BYTES;     // never below -TELEMETRY_BUDGET_BURST_BYTES
+static uint32_t telemetryBudgetRemainder = 0;                            // byte microseconds not credited yet
+static uint8_t telemetryBudgetPriority = 0;
 
 PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 3);
 
@@ -191,8 +206,73 @@ void telemetryCheckState(void)
 #endif
 }
 
+// Refill the telemetry byte budget from the RC frame rate, scaled down with the link quality
+void telemetryBudgetUpdate(timeUs_t currentTimeUs)
+{
+    static timeUs_t lastUpdateUs = 0;
+
+    const timeDelta_t deltaUs = cmpTimeUs(currentTimeUs, lastUpdateUs);
+    lastUpdateUs = currentTimeUs;
+
+    const uint16_t refreshRateUs = rxGetRefreshRate();
+#ifdef USE_RX_LINK_QUALITY_INFO
+    const uint16_t linkQuality = rxIsReceivingSignal() ? rxGetLinkQualityPercent() : 0;
+#else
+    const uint16_t linkQuality = rxIsReceivingSignal() ? 100 : 0;
+#endif
+
+    if (linkQuality < TELEMETRY_BUDGET_LQ_CRITICAL) {
+        telemetryBudgetPriority = 3;
+    } else if (linkQuality < TELEMETRY_BUDGET_LQ_LOW) {
+        telemetryBudgetPriority = 2;
+    } else {
+        telemetryBudgetPriority = 0;
+    }
+
+    if (refreshRateUs == 0 || deltaUs <= 0) {
+        return;
+    }
+
+    const uint32_t share = constrain(linkQuality * 100 / TELEMETRY_BUDGET_LQ_FULL, TELEMETRY_BUDGET_SHARE_MIN, 100);
+    const uint32_t bytesPerSecond = (1000000 / refreshRateUs) * TELEMETRY_BUDGET_BYTES_PER_RC_FRAME * share / 100;
+
+    // 64 bit, bytes per second times a second overflows 32 bit above ~500Hz RC
+    const uint64_t credit = (uint64_t)bytesPerSecond * MIN(deltaUs, 1000000) + telemetryBudgetRemainder;
+    const uint64_t refill = credit / 1000000;
+
+    if (refill >= (uint64_t)(TELEMETRY_BUDGET_BURST_BYTES - telemetryBudgetBytes)) {
+        telemetryBudgetBytes = TELEMETRY_BUDGET_BURST_BYTES;
+        telemetryBudgetRemainder = 0;
+    } else {
+        telemetryBudgetBytes += refill;
+        telemetryBudgetRemainder = credit % 1000000;
+    }
+}
+
+// Take the bytes of one reply from the budget, the reply is skipped when the budget is used up
+bool telemetryBudgetConsume(uint16_t bytes)
+{
+    if (telemetryBudgetBytes <= 0) {
+        return false;
+    }
+
+    telemetryBudgetBytes = MAX(telemetryBudgetBytes - bytes, -TELEMETRY_BUDGET_BURST_BYTES);
+
+    return true;
+}
+
+// Sensors with a lower scheduler priority are deferred while the link is poor
+uint8_t telemetryBudgetMinPriority(void)
+{
+    return telemetryBudgetPriority;
+}
+
 void telemetryProcess(uint32_t currentTime)
 {
+    // Read the sensors once for all the protocols
+    telemetrySnapshotUpdate();
+    telemetryBudgetUpdate(currentTime);
+
 #ifdef USE_TELEMETRY_FRSKY_HUB
     handleFrSkyHubTelemetry(currentTime);
 #else
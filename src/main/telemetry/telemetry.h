@@ -70,7 +70,11 @@ typedef enum {
                             | ESC_SENSOR_RPM \
                             | ESC_SENSOR_TEMPERATURE,
     SENSOR_TEMPERATURE     = 1 << 19,
-    SENSOR_ALL             = (1 << 20) - 1,
+    SENSOR_HEADSPEED       = 1 << 20,
+    SENSOR_GOVERNOR        = 1 << 21,
+    SENSOR_BEC_VOLTAGE     = 1 << 22,
+    SENSOR_VIBRATION       = 1 << 23,
+    SENSOR_ALL             = (1 << 24) - 1,
 } sensor_e;
 
 typedef struct telemetryConfig_s {
@@ -102,3 +106,7 @@ void telemetryProcess(uint32_t currentTime);
 bool telemetryDetermineEnabledState(portSharing_e portSharing);
 
 bool telemetryIsSensorEnabled(sensor_e sensor);
+
+void telemetryBudgetUpdate(timeUs_t currentTimeUs);
+bool telemetryBudgetConsume(uint16_t bytes);
+uint8_t telemetryBudgetMinPriority(void);
@@ -31,6 +31,7 @@
 #include "usbd_def.h"
 
 #include "usbd_cdc.h"
+#include "usbd_cdc_interface.h"
 #include "usbd_hid.h"
 
 #define USB_HID_CDC_CONFIG_DESC_SIZ  (USB_HID_CONFIG_DESC_SIZ - 9 + USB_CDC_CONFIG_DESC_SIZ + 8)
@@ -304,7 +305,7 @@ static uint8_t USBD_HID_CDC_EP0_RxReady  (USBD_HandleTypeDef *pdev)
 static uint8_t USBD_HID_CDC_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
 	if (epnum == (CDC_IN_EP &~ 0x80)) {
-		return USBD_CDC.DataIn(pdev, epnum);
+		return CDC_Itf_DataIn(pdev, epnum);
 	}
 	else {
 		return USBD_HID.DataIn(pdev, epnum);
@@ -57,6 +57,9 @@
 #include "usbd_cdc.h"
 #include "usbd_cdc_interface.h"
 #include "stdbool.h"
+#include "string.h"
+
+#include "common/utils.h"
 
 #include "drivers/nvic.h"
 #include "drivers/serial_usb_vcp.h"
@@ -64,10 +67,14 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define APP_RX_DATA_SIZE  2048
-#define APP_TX_DATA_SIZE  2048
+#define APP_RX_DATA_SIZE  2048        // power of two
+#define APP_TX_DATA_SIZE  4096        // power of two
+
+#define APP_TX_BLOCK_SIZE 1024        // longest IN transfer, the rest of the ring fills meanwhile
 
-#define APP_TX_BLOCK_SIZE 512
+// Masks the TIMusb interrupt and the OTG interrupts, which run at priority 6,
+// or 1 for the OTG_HS core of the H7
+#define CDC_ATOMIC_PRIORITY NVIC_BUILD_PRIORITY(1, 0)
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -81,14 +88,18 @@ USBD_CDC_LineCodingTypeDef LineCoding =
 
 volatile uint8_t UserRxBuffer[APP_RX_DATA_SIZE];/* Received Data over USB are stored in this buffer */
 volatile uint8_t UserTxBuffer[APP_TX_DATA_SIZE];/* Received Data over UART (CDC interface) are stored in this buffer */
-uint32_t BuffLength;
 volatile uint32_t UserTxBufPtrIn = 0;/* Increment this pointer or roll it back to
                                start address when data are received over USART */
 volatile uint32_t UserTxBufPtrOut = 0; /* Increment this pointer or roll it back to
                                  start address when data are sent over USB */
+static uint32_t UserTxBlockSize = 0; /* Length of the IN transfer in flight */
 
-uint32_t rxAvailable = 0;
-uint8_t* rxBuffPtr = NULL;
+// The OUT endpoint receives into the packet buffer, which is copied to the ring from the
+// interrupt, so the next packet is accepted while the application reads the previous ones
+static uint32_t UserRxPacket[CDC_DATA_HS_MAX_PACKET_SIZE / 4];
+static volatile uint32_t UserRxBufPtrIn = 0;
+static volatile uint32_t UserRxBufPtrOut = 0;
+static volatile bool UserRxPaused = false; /* Endpoint not rearmed, the ring has no room for a packet */
 
 /* TIM handler declaration */
 TIM_HandleTypeDef  TimHandle;
@@ -107,6 +118,9 @@ static int8_t CDC_Itf_Receive(uint8_t* pbuf, uint32_t *Len);
 static void TIM_Config(void);
 static void Error_Handler(void);
 
+// USBD_CDC with the end of every IN transfer chained to the next one
+static USBD_ClassTypeDef USBD_CDC_VCP;
+
 USBD_CDC_ItfTypeDef USBD_CDC_fops =
 {
   CDC_Itf_Init,
@@ -144,7 +158,14 @@ static int8_t CDC_Itf_Init(void)
 
   /*##-5- Set Application Buffers ############################################*/
   USBD_CDC_SetTxBuffer(&USBD_Device, (uint8_t *)UserTxBuffer, 0);
-  USBD_CDC_SetRxBuffer(&USBD_Device, (uint8_t *)UserRxBuffer);
+  USBD_CDC_SetRxBuffer(&USBD_Device, (uint8_t *)UserRxPacket);
+
+  UserTxBufPtrIn = 0;
+  UserTxBufPtrOut = 0;
+  UserTxBlockSize = 0;
+  UserRxBufPtrIn = 0;
+  UserRxBufPtrOut = 0;
+  UserRxPaused = false;
 
   ctrlLineStateCb = NULL;
   baudRateCb = NULL;
@@ -242,8 +263,81 @@ static int8_t CDC_Itf_Control (uint8_t cmd, uint8_t* pbuf, uint16_t length)
   return (USBD_OK);
 }
 
+/**
+  * @brief  CDC_Itf_StartTx
+  *         Starts the next block of the ring when the IN endpoint is idle.
+  *         Runs from the OTG and TIMusb interrupts, or with them masked.
+  * @param  None
+  * @retval None
+  */
+static void CDC_Itf_StartTx(void)
+{
+    USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)USBD_Device.pCDC_ClassData;
+
+    if (hcdc == NULL || hcdc->TxState != 0) {
+        return;
+    }
+
+    // endpoint has finished transmitting previous block, including the ZLP after a full packet
+    if (UserTxBlockSize) {
+        UserTxBufPtrOut = (UserTxBufPtrOut + UserTxBlockSize) & (APP_TX_DATA_SIZE - 1);
+        UserTxBlockSize = 0;
+    }
+
+    const uint32_t in = UserTxBufPtrIn;
+    if (UserTxBufPtrOut == in) {
+        return;
+    }
+
+    uint32_t buffsize;
+    if (UserTxBufPtrOut > in) { /* Roll-back */
+        buffsize = APP_TX_DATA_SIZE - UserTxBufPtrOut;
+    } else {
+        buffsize = in - UserTxBufPtrOut;
+    }
+    buffsize = MIN(buffsize, APP_TX_BLOCK_SIZE);
+
+    USBD_CDC_SetTxBuffer(&USBD_Device, (uint8_t*)&UserTxBuffer[UserTxBufPtrOut], buffsize);
+
+    if (USBD_CDC_TransmitPacket(&USBD_Device) == USBD_OK) {
+        UserTxBlockSize = buffsize;
+    }
+}
+
+/**
+  * @brief  CDC_Itf_DataIn
+  *         IN transfer complete, the class sends the ZLP first if the
+  *         transfer ended on a full packet.
+  * @param  pdev: device instance
+  * @param  epnum: endpoint number
+  * @retval status
+  */
+uint8_t CDC_Itf_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
+{
+    const uint8_t status = USBD_CDC.DataIn(pdev, epnum);
+
+    CDC_Itf_StartTx();
+
+    return status;
+}
+
+/**
+  * @brief  CDC_Itf_Class
+  *         The CDC class to register, the composite class calls CDC_Itf_DataIn itself
+  * @param  None
+  * @retval Class
+  */
+USBD_ClassTypeDef *CDC_Itf_Class(void)
+{
+    USBD_CDC_VCP = USBD_CDC;
+    USBD_CDC_VCP.DataIn = CDC_Itf_DataIn;
+
+    return &USBD_CDC_VCP;
+}
+
 /**
   * @brief  TIM period elapsed callback
+  *         Backstop for a block that could not be started from the other paths.
   * @param  htim: TIM handle
   * @retval None
   */
@@ -253,38 +347,19 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
         return;
     }
 
-    uint32_t buffsize;
-    static uint32_t lastBuffsize = 0;
+    ATOMIC_BLOCK(CDC_ATOMIC_PRIORITY) {
+        CDC_Itf_StartTx();
+    }
+}
 
-    USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)USBD_Device.pCDC_ClassData;
+static uint32_t CDC_Itf_RxPacketSize(void)
+{
+    return (USBD_Device.dev_speed == USBD_SPEED_HIGH) ? CDC_DATA_HS_OUT_PACKET_SIZE : CDC_DATA_FS_OUT_PACKET_SIZE;
+}
 
-    if (hcdc->TxState == 0) {
-        // endpoint has finished transmitting previous block
-        if (lastBuffsize) {
-            // move the ring buffer tail based on the previous succesful transmission
-            UserTxBufPtrOut += lastBuffsize;
-            if (UserTxBufPtrOut == APP_TX_DATA_SIZE) {
-                UserTxBufPtrOut = 0;
-            }
-            lastBuffsize = 0;
-        }
-        if (UserTxBufPtrOut != UserTxBufPtrIn) {
-            if (UserTxBufPtrOut > UserTxBufPtrIn) { /* Roll-back */
-                buffsize = APP_TX_DATA_SIZE - UserTxBufPtrOut;
-            } else {
-                buffsize = UserTxBufPtrIn - UserTxBufPtrOut;
-            }
-            if (buffsize > APP_TX_BLOCK_SIZE) {
-                buffsize = APP_TX_BLOCK_SIZE;
-            }
-
-            USBD_CDC_SetTxBuffer(&USBD_Device, (uint8_t*)&UserTxBuffer[UserTxBufPtrOut], buffsize);
-
-            if (USBD_CDC_TransmitPacket(&USBD_Device) == USBD_OK) {
-                lastBuffsize = buffsize;
-            }
-        }
-    }
+static uint32_t CDC_Itf_RxFreeBytes(void)
+{
+    return (UserRxBufPtrOut - UserRxBufPtrIn - 1) & (APP_RX_DATA_SIZE - 1);
 }
 
 /**
@@ -297,8 +372,22 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
   */
 static int8_t CDC_Itf_Receive(uint8_t* Buf, uint32_t *Len)
 {
-    rxAvailable = *Len;
-    rxBuffPtr = Buf;
+    // the endpoint is only armed with room for a full packet in the ring
+    const uint32_t in = UserRxBufPtrIn;
+    const uint32_t len = MIN(*Len, CDC_Itf_RxFreeBytes());
+    const uint32_t first = MIN(len, APP_RX_DATA_SIZE - in);
+
+    memcpy((uint8_t *)&UserRxBuffer[in], Buf, first);
+    memcpy((uint8_t *)UserRxBuffer, Buf + first, len - first);
+    UserRxBufPtrIn = (in + len) & (APP_RX_DATA_SIZE - 1);
+
+    if (CDC_Itf_RxFreeBytes() >= CDC_Itf_RxPacketSize()) {
+        USBD_CDC_ReceivePacket(&USBD_Device);
+    } else {
+        // NAK the host until the application has read enough
+        UserRxPaused = true;
+    }
+
     return (USBD_OK);
 }
 
@@ -351,43 +440,67 @@ static void Error_Handler(void)
 
 uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len)
 {
-    uint32_t count = 0;
-    if ( (rxBuffPtr != NULL))
-    {
-        while ((rxAvailable > 0) && count < len)
-        {
-            recvBuf[count] = rxBuffPtr[0];
-            rxBuffPtr++;
-            rxAvailable--;
-            count++;
-            if (rxAvailable < 1)
-                USBD_CDC_ReceivePacket(&USBD_Device);
+    const uint32_t out = UserRxBufPtrOut;
+    const uint32_t count = MIN(len, CDC_Receive_BytesAvailable());
+    const uint32_t first = MIN(count, APP_RX_DATA_SIZE - out);
+
+    memcpy(recvBuf, (const uint8_t *)&UserRxBuffer[out], first);
+    memcpy(recvBuf + first, (const uint8_t *)UserRxBuffer, count - first);
+    UserRxBufPtrOut = (out + count) & (APP_RX_DATA_SIZE - 1);
+
+    if (UserRxPaused && CDC_Itf_RxFreeBytes() >= CDC_Itf_RxPacketSize()) {
+        ATOMIC_BLOCK(CDC_ATOMIC_PRIORITY) {
+            UserRxPaused = false;
+            USBD_CDC_ReceivePacket(&USBD_Device);
         }
     }
+
     return count;
 }
 
 uint32_t CDC_Receive_BytesAvailable(void)
 {
-    return rxAvailable;
+    return (UserRxBufPtrIn - UserRxBufPtrOut) & (APP_RX_DATA_SIZE - 1);
 }
 
 uint32_t CDC_Send_FreeBytes(void)
 {
-    /*
-        return the bytes free in the circular buffer
+    // single producer and consumer, each index is written by one side only
+    return (UserTxBufPtrOut - UserTxBufPtrIn - 1) & (APP_TX_DATA_SIZE - 1);
+}
 
-        functionally equivalent to:
-        (APP_Rx_ptr_out > APP_Rx_ptr_in ? APP_Rx_ptr_out - APP_Rx_ptr_in : APP_RX_DATA_SIZE - APP_Rx_ptr_in + APP_Rx_ptr_in)
-        but without the impact of the condition check.
-    */
-    uint32_t freeBytes;
+/**
+ * @brief  CDC_Send_Reserve
+ *         Contiguous free space of the ring, to be written in place and
+ *         handed over with CDC_Send_Commit
+ * @param  available: set to the length of the space
+ * @retval Start of the space
+ */
+uint8_t *CDC_Send_Reserve(uint32_t *available)
+{
+    const uint32_t in = UserTxBufPtrIn;
 
-    ATOMIC_BLOCK(NVIC_BUILD_PRIORITY(6, 0)) {
-        freeBytes = ((UserTxBufPtrOut - UserTxBufPtrIn) + (-((int)(UserTxBufPtrOut <= UserTxBufPtrIn)) & APP_TX_DATA_SIZE)) - 1;
-    }
+    *available = MIN(CDC_Send_FreeBytes(), APP_TX_DATA_SIZE - in);
+
+    return (uint8_t *)&UserTxBuffer[in];
+}
+
+/**
+ * @brief  CDC_Send_Commit
+ *         Queues data written to the space returned by CDC_Send_Reserve and
+ *         starts the IN transfer if the endpoint is idle
+ * @param  count: Number of bytes written
+ * @retval None
+ */
+void CDC_Send_Commit(uint32_t count)
+{
+    // the data has to be in memory before the interrupt can see the index move
+    __DMB();
+    UserTxBufPtrIn = (UserTxBufPtrIn + count) & (APP_TX_DATA_SIZE - 1);
 
-    return freeBytes;
+    ATOMIC_BLOCK(CDC_ATOMIC_PRIORITY) {
+        CDC_Itf_StartTx();
+    }
 }
 
 /**
@@ -396,21 +509,26 @@ uint32_t CDC_Send_FreeBytes(void)
  *         this function.
  * @param  ptrBuffer: Buffer of data to be sent
  * @param  sendLength: Number of data to be sent (in bytes)
- * @retval Bytes sent
+ * @retval Bytes queued, less than sendLength when the ring is full
  */
 uint32_t CDC_Send_DATA(const uint8_t *ptrBuffer, uint32_t sendLength)
 {
-    for (uint32_t i = 0; i < sendLength; i++) {
-        while (CDC_Send_FreeBytes() == 0) {
-            // block until there is free space in the ring buffer
-            delay(1);
-        }
-        ATOMIC_BLOCK(NVIC_BUILD_PRIORITY(6, 0)) { // Paranoia
-            UserTxBuffer[UserTxBufPtrIn] = ptrBuffer[i];
-            UserTxBufPtrIn = (UserTxBufPtrIn + 1) % APP_TX_DATA_SIZE;
+    uint32_t count = 0;
+
+    while (count < sendLength) {
+        uint32_t available;
+        uint8_t *buffer = CDC_Send_Reserve(&available);
+        const uint32_t length = MIN(available, sendLength - count);
+
+        if (length == 0) {
+            break;
         }
+        memcpy(buffer, ptrBuffer + count, length);
+        count += length;
+        CDC_Send_Commit(length);
     }
-    return sendLength;
+
+    return count;
 }
 
 
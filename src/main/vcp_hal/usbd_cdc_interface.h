@@ -81,6 +81,10 @@ extern USBD_CDC_ItfTypeDef  USBD_CDC_fops;
 
 uint32_t CDC_Send_DATA(const uint8_t *ptrBuffer, uint32_t sendLength);
 uint32_t CDC_Send_FreeBytes(void);
+uint8_t *CDC_Send_Reserve(uint32_t *available);
+void CDC_Send_Commit(uint32_t count);
+USBD_ClassTypeDef *CDC_Itf_Class(void);
+uint8_t CDC_Itf_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum);
 uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len);
 uint32_t CDC_Receive_BytesAvailable(void);
 uint8_t usbIsConfigured(void);
@@ -21,12 +21,15 @@
 
 /* Includes ------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "platform.h"
 
+#include "common/utils.h"
+
 #include "usbd_cdc_vcp.h"
 #include "stm32f4xx_conf.h"
 #include "stdbool.h"
-#include "drivers/time.h"
 
 #ifdef USB_OTG_HS_INTERNAL_DMA_ENABLED
 #pragma     data_alignment = 4
@@ -36,7 +39,6 @@ __ALIGN_BEGIN USB_OTG_CORE_HANDLE USB_OTG_dev __ALIGN_END;
 
 LINE_CODING g_lc;
 
-extern __IO uint8_t USB_Tx_State;
 __IO uint32_t bDeviceState = UNCONNECTED; /* USB device status */
 
 /* These are external variables imported from CDC core to be used for IN transfer management. */
@@ -181,8 +183,52 @@ static uint16_t VCP_Ctrl(uint32_t Cmd, uint8_t* Buf, uint32_t Len)
  *******************************************************************************/
 uint32_t CDC_Send_DATA(const uint8_t *ptrBuffer, uint32_t sendLength)
 {
-    VCP_DataTx(ptrBuffer, sendLength);
-    return sendLength;
+    uint32_t sent = 0;
+
+    while (sent < sendLength) {
+        uint32_t available;
+        uint8_t *buffer = CDC_Send_Reserve(&available);
+        const uint32_t count = MIN(available, sendLength - sent);
+
+        if (count == 0) {
+            break;
+        }
+
+        memcpy(buffer, ptrBuffer + sent, count);
+        CDC_Send_Commit(count);
+        sent += count;
+    }
+
+    return sent;
+}
+
+/*******************************************************************************
+ * Function Name  : CDC_Send_Reserve
+ * Description    : reserve the contiguous free space of the IN buffer
+ * Input          : where to return the number of bytes that can be written.
+ * Output         : None.
+ * Return         : pointer to write the data to.
+ *******************************************************************************/
+uint8_t *CDC_Send_Reserve(uint32_t *available)
+{
+    *available = MIN(CDC_Send_FreeBytes(), APP_RX_DATA_SIZE - APP_Rx_ptr_in);
+
+    return &APP_Rx_Buffer[APP_Rx_ptr_in];
+}
+
+/*******************************************************************************
+ * Function Name  : CDC_Send_Commit
+ * Description    : queue the bytes written to the reserved space, the CDC core
+ *                  sends them from the next SOF on
+ * Input          : number of bytes written.
+ * Output         : None.
+ * Return         : None.
+ *******************************************************************************/
+void CDC_Send_Commit(uint32_t count)
+{
+    // The data must be in memory before the SOF interrupt sees the new pointer
+    __DMB();
+    APP_Rx_ptr_in = (APP_Rx_ptr_in + count) % APP_RX_DATA_SIZE;
 }
 
 uint32_t CDC_Send_FreeBytes(void)
@@ -202,27 +248,11 @@ uint32_t CDC_Send_FreeBytes(void)
  *         CDC data to be sent to the Host (app) over USB
  * @param  Buf: Buffer of data to be sent
  * @param  Len: Number of data to be sent (in bytes)
- * @retval Result of the operation: USBD_OK if all operations are OK else VCP_FAIL
+ * @retval Result of the operation: USBD_OK if all the data was queued else USBD_FAIL
  */
 static uint16_t VCP_DataTx(const uint8_t* Buf, uint32_t Len)
 {
-    /*
-        make sure that any paragraph end frame is not in play
-        could just check for: USB_CDC_ZLP, but better to be safe
-        and wait for any existing transmission to complete.
-    */
-    while (USB_Tx_State != 0);
-
-    for (uint32_t i = 0; i < Len; i++) {
-        APP_Rx_Buffer[APP_Rx_ptr_in] = Buf[i];
-        APP_Rx_ptr_in = (APP_Rx_ptr_in + 1) % APP_RX_DATA_SIZE;
-
-        while (CDC_Send_FreeBytes() == 0) {
-            delay(1);
-        }
-    }
-
-    return USBD_OK;
+    return CDC_Send_DATA(Buf, Len) == Len ? USBD_OK : USBD_FAIL;
 }
 
 /*******************************************************************************
@@ -236,10 +266,13 @@ uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len)
 {
     uint32_t count = 0;
 
-    while (APP_Tx_ptr_out != APP_Tx_ptr_in && count < len) {
-        recvBuf[count] = APP_Tx_Buffer[APP_Tx_ptr_out];
-        APP_Tx_ptr_out = (APP_Tx_ptr_out + 1) % APP_TX_DATA_SIZE;
-        count++;
+    while (count < len && APP_Tx_ptr_out != APP_Tx_ptr_in) {
+        const uint32_t end = APP_Tx_ptr_out > APP_Tx_ptr_in ? APP_TX_DATA_SIZE : APP_Tx_ptr_in;
+        const uint32_t chunk = MIN(len - count, end - APP_Tx_ptr_out);
+
+        memcpy(recvBuf + count, &APP_Tx_Buffer[APP_Tx_ptr_out], chunk);
+        APP_Tx_ptr_out = (APP_Tx_ptr_out + chunk) % APP_TX_DATA_SIZE;
+        count += chunk;
     }
     return count;
 }
@@ -267,14 +300,15 @@ uint32_t CDC_Receive_BytesAvailable(void)
  */
 static uint16_t VCP_DataRx(uint8_t* Buf, uint32_t Len)
 {
-    if (CDC_Receive_BytesAvailable() + Len > APP_TX_DATA_SIZE) {
+    if (CDC_Receive_BytesAvailable() + Len >= APP_TX_DATA_SIZE) {
         return USBD_FAIL;
     }
 
-    for (uint32_t i = 0; i < Len; i++) {
-        APP_Tx_Buffer[APP_Tx_ptr_in] = Buf[i];
-        APP_Tx_ptr_in = (APP_Tx_ptr_in + 1) % APP_TX_DATA_SIZE;
-    }
+    const uint32_t chunk = MIN(Len, APP_TX_DATA_SIZE - APP_Tx_ptr_in);
+
+    memcpy(&APP_Tx_Buffer[APP_Tx_ptr_in], Buf, chunk);
+    memcpy(APP_Tx_Buffer, Buf + chunk, Len - chunk);
+    APP_Tx_ptr_in = (APP_Tx_ptr_in + Len) % APP_TX_DATA_SIZE;
 
     return USBD_OK;
 }
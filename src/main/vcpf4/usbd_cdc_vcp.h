@@ -38,6 +38,8 @@ extern USB_OTG_CORE_HANDLE USB_OTG_dev;
 
 uint32_t CDC_Send_DATA(const uint8_t *ptrBuffer, uint32_t sendLength);
 uint32_t CDC_Send_FreeBytes(void);
+uint8_t *CDC_Send_Reserve(uint32_t *available);
+void CDC_Send_Commit(uint32_t count);
 uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len);       // HJI
 uint32_t CDC_Receive_BytesAvailable(void);
 
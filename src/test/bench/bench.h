@@ -0,0 +1,76 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Minimal host benchmark harness. A kernel is a function running the code
+ * under test 'count' times. The harness grows the count until one batch
+ * takes BENCH_BATCH_NS, then reports the fastest of BENCH_REPEATS batches.
+ * The fastest batch is the least disturbed by the host, which keeps the
+ * numbers comparable between two builds on the same machine.
+ *
+ * Output lines are "<name> <ns> ns/call", see bench/compare.sh.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_BATCH_NS      20000000ULL
+#define BENCH_REPEATS       10
+
+typedef void benchKernelFn(uint32_t count);
+
+// Kernels store their results here so the compiler can not drop the work
+static volatile float benchSink;
+
+static inline uint64_t benchNowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline uint64_t benchBatchNs(benchKernelFn *kernel, uint32_t count)
+{
+    const uint64_t start = benchNowNs();
+    kernel(count);
+    return benchNowNs() - start;
+}
+
+static inline void benchRun(const char *name, benchKernelFn *kernel)
+{
+    uint32_t count = 16;
+    while (benchBatchNs(kernel, count) < BENCH_BATCH_NS / 2 && count < (1U << 30)) {
+        count *= 2;
+    }
+
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < BENCH_REPEATS; i++) {
+        const uint64_t elapsed = benchBatchNs(kernel, count);
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    printf("%-36s %10.2f ns/call\n", name, (double)best / count);
+    fflush(stdout);
+}
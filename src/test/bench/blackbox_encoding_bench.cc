@@ -0,0 +1,128 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_encoding.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+}
+
+#include "bench.h"
+
+#define VALUE_COUNT         256             // power of two
+
+// Typical P-frame deltas: mostly small, a few large
+static int32_t values[VALUE_COUNT + 8];
+
+static uint32_t bytesWritten;
+
+static void initValues(void)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < VALUE_COUNT + 8; i++) {
+        seed = seed * 1103515245 + 12345;
+        const int32_t r = (int32_t)((seed >> 16) & 0x7fff);
+        values[i] = (i % 16 == 0) ? r - 16384 : (r & 0x3f) - 32;
+    }
+}
+
+static void benchUnsignedVB(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        blackboxWriteUnsignedVB(values[i & (VALUE_COUNT - 1)] & 0xffff);
+    }
+    benchSink = bytesWritten;
+}
+
+static void benchSignedVB(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        blackboxWriteSignedVB(values[i & (VALUE_COUNT - 1)]);
+    }
+    benchSink = bytesWritten;
+}
+
+static void benchTag2_3S32(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t v[3] = { values[i & (VALUE_COUNT - 1)] >> 8, values[(i + 1) & (VALUE_COUNT - 1)], values[(i + 2) & (VALUE_COUNT - 1)] };
+        blackboxWriteTag2_3S32(v);
+    }
+    benchSink = bytesWritten;
+}
+
+static void benchTag8_4S16(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        blackboxWriteTag8_4S16(&values[i & (VALUE_COUNT - 1)]);
+    }
+    benchSink = bytesWritten;
+}
+
+static void benchTag8_8SVB(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        blackboxWriteTag8_8SVB(&values[i & (VALUE_COUNT - 1)], 8);
+    }
+    benchSink = bytesWritten;
+}
+
+int main(void)
+{
+    initValues();
+
+    benchRun("blackboxWriteUnsignedVB", benchUnsignedVB);
+    benchRun("blackboxWriteSignedVB", benchSignedVB);
+    benchRun("blackboxWriteTag2_3S32", benchTag2_3S32);
+    benchRun("blackboxWriteTag8_4S16", benchTag8_4S16);
+    benchRun("blackboxWriteTag8_8SVB", benchTag8_8SVB);
+
+    return 0;
+}
+
+// STUBS
+
+extern "C" {
+PG_REGISTER(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 0);
+int32_t blackboxHeaderBudget;
+void mspSerialAllocatePorts(void) {}
+void blackboxWrite(uint8_t) {bytesWritten++;}
+static uint8_t reserveBuffer[16];
+uint8_t *blackboxReserve(int) {return reserveBuffer;}
+void blackboxCommit(uint8_t *end) {bytesWritten += end - reserveBuffer;}
+void blackboxFrameBegin(void) {}
+void blackboxFrameCommit(void) {}
+int blackboxWriteString(const char *s)
+{
+    const char *pos = s;
+    while (*pos) {
+        pos++;
+    }
+    bytesWritten += pos - s;
+    return pos - s;
+}
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+#
+# Compares two benchmark runs kernel by kernel.
+#
+# usage: compare.sh <before.txt> <after.txt>
+#
+# The inputs are the saved output of `make bench`, for example from two
+# checkouts built on the same machine. Positive changes are slower.
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 <before.txt> <after.txt>" >&2
+    exit 1
+fi
+
+awk '
+    $3 == "ns/call" && FNR == NR { before[$1] = $2; order[++count] = $1; next }
+    $3 == "ns/call" { after[$1] = $2 }
+    END {
+        printf "%-36s %10s %10s %8s\n", "kernel", "before", "after", "change"
+        for (i = 1; i <= count; i++) {
+            name = order[i]
+            if (name in after) {
+                printf "%-36s %10.2f %10.2f %+7.1f%%\n", name, before[name], after[name], (after[name] / before[name] - 1) * 100
+            } else {
+                printf "%-36s %10.2f %10s\n", name, before[name], "-"
+            }
+        }
+    }
+' "$1" "$2"
@@ -0,0 +1,145 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <cmath>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/filter.h"
+    #include "common/maths.h"
+}
+
+#include "bench.h"
+
+#define SAMPLE_RATE_US      125
+#define SAMPLE_COUNT        1024            // power of two
+
+static float samples[SAMPLE_COUNT];
+
+static biquadFilter_t biquad;
+static biquadFilter_t notch;
+static pt1Filter_t pt1;
+
+static biquadFilter_t chainBiquad[XYZ_AXIS_COUNT];
+static biquadFilter_t chainNotch[XYZ_AXIS_COUNT];
+static pt1Filter_t chainPt1[XYZ_AXIS_COUNT];
+static filterChain_t chain;
+
+// Gyro like input: a slow stick movement, motor noise and a little white noise
+static void initSamples(void)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        const float t = i * SAMPLE_RATE_US * 1e-6f;
+        seed = seed * 1103515245 + 12345;
+        samples[i] = 200.0f * sinf(2.0f * M_PIf * 3.0f * t) + 20.0f * sinf(2.0f * M_PIf * 240.0f * t)
+            + (float)((seed >> 16) & 0xff) / 32.0f - 4.0f;
+    }
+}
+
+static void benchBiquadApply(uint32_t count)
+{
+    float out = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        out += biquadFilterApply(&biquad, samples[i & (SAMPLE_COUNT - 1)]);
+    }
+    benchSink = out;
+}
+
+static void benchBiquadApplyDF1(uint32_t count)
+{
+    float out = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        out += biquadFilterApplyDF1(&biquad, samples[i & (SAMPLE_COUNT - 1)]);
+    }
+    benchSink = out;
+}
+
+static void benchNotchApply(uint32_t count)
+{
+    float out = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        out += biquadFilterApply(&notch, samples[i & (SAMPLE_COUNT - 1)]);
+    }
+    benchSink = out;
+}
+
+static void benchPt1Apply(uint32_t count)
+{
+    float out = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        out += pt1FilterApply(&pt1, samples[i & (SAMPLE_COUNT - 1)]);
+    }
+    benchSink = out;
+}
+
+static void benchBiquadUpdate(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        biquadFilterUpdate(&notch, 150.0f + (i & 127), SAMPLE_RATE_US, 3.0f, FILTER_NOTCH);
+    }
+    benchSink = notch.b0;
+}
+
+// Three axes through pt1 + biquad + notch, the shape of the gyro lowpass chain
+static void benchFilterChainApply(uint32_t count)
+{
+    float out = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        float data[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            data[axis] = samples[(i + axis * 64) & (SAMPLE_COUNT - 1)];
+        }
+        filterChainApply(&chain, data);
+        out += data[X] + data[Y] + data[Z];
+    }
+    benchSink = out;
+}
+
+int main(void)
+{
+    initSamples();
+
+    biquadFilterInitLPF(&biquad, 100, SAMPLE_RATE_US);
+    biquadFilterInit(&notch, 200, SAMPLE_RATE_US, filterGetNotchQ(200, 160), FILTER_NOTCH);
+    pt1FilterInit(&pt1, pt1FilterGain(100, SAMPLE_RATE_US * 1e-6f));
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pt1FilterInit(&chainPt1[axis], pt1FilterGain(150, SAMPLE_RATE_US * 1e-6f));
+        biquadFilterInitLPF(&chainBiquad[axis], 100, SAMPLE_RATE_US);
+        biquadFilterInit(&chainNotch[axis], 200, SAMPLE_RATE_US, filterGetNotchQ(200, 160), FILTER_NOTCH);
+    }
+    filterChainAdd(&chain, FILTER_STAGE_PT1, chainPt1, sizeof(chainPt1[0]));
+    filterChainAdd(&chain, FILTER_STAGE_BIQUAD, chainBiquad, sizeof(chainBiquad[0]));
+    filterChainAdd(&chain, FILTER_STAGE_BIQUAD, chainNotch, sizeof(chainNotch[0]));
+
+    benchRun("biquadFilterApply", benchBiquadApply);
+    benchRun("biquadFilterApplyDF1", benchBiquadApplyDF1);
+    benchRun("biquadFilterApply.notch", benchNotchApply);
+    benchRun("pt1FilterApply", benchPt1Apply);
+    benchRun("biquadFilterUpdate.notch", benchBiquadUpdate);
+    benchRun("filterChainApply.3axis.3stage", benchFilterChainApply);
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "drivers/accgyro/accgyro_fake.h"
+    #include "drivers/sensor.h"
+    #include "io/beeper.h"
+    #include "pg/pg.h"
+    #include "scheduler/scheduler.h"
+    #include "sensors/gyro.h"
+    #include "sensors/acceleration.h"
+    #include "sensors/sensors.h"
+
+    STATIC_UNIT_TESTED bool fakeGyroRead(gyroDev_t *gyro);
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+}
+
+#include "bench.h"
+
+extern gyroDev_t * const gyroDevPtr;
+
+#define SAMPLE_COUNT        1024            // power of two
+
+static int16_t samples[SAMPLE_COUNT];
+
+static void initGyro(bool filters)
+{
+    pgResetAll();
+    if (!filters) {
+        gyroConfigMutable()->gyro_lowpass_hz = 0;
+        gyroConfigMutable()->gyro_lowpass2_hz = 0;
+        gyroConfigMutable()->gyro_soft_notch_hz_1 = 0;
+        gyroConfigMutable()->gyro_soft_notch_hz_2 = 0;
+    }
+    gyroInit();
+    gyroDevPtr->readFn = fakeGyroRead;
+
+    gyroStartCalibration(false);
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 0, 0, 0);
+        gyroUpdate(0);
+    }
+}
+
+// Sensor read, alignment, scaling and filterGyro() for one sample
+static void benchGyroUpdate(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        fakeGyroSet(gyroDevPtr, samples[i & (SAMPLE_COUNT - 1)], samples[(i + 64) & (SAMPLE_COUNT - 1)], samples[(i + 128) & (SAMPLE_COUNT - 1)]);
+        gyroUpdate(i);
+    }
+    benchSink = gyro.gyroADCf[X];
+}
+
+int main(void)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        seed = seed * 1103515245 + 12345;
+        samples[i] = (int16_t)((seed >> 16) & 0x7ff) - 1024;
+    }
+
+    initGyro(false);
+    benchRun("gyroUpdate.nofilter", benchGyroUpdate);
+
+    initGyro(true);
+    benchRun("gyroUpdate.defaults", benchGyroUpdate);
+
+    return 0;
+}
+
+// STUBS
+
+extern "C" {
+uint32_t micros(void) {return 0;}
+void beeper(beeperMode_e) {}
+uint8_t detectedSensors[] = { GYRO_NONE, ACC_NONE };
+timeDelta_t getGyroUpdateRate(void) {return gyro.targetLooptime;}
+void sensorsSet(uint32_t) {}
+void schedulerResetTaskStatistics(cfTaskId_e) {}
+int getArmingDisableFlags(void) {return 0;}
+}
@@ -0,0 +1,192 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <cmath>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "config/config.h"
+
+    #include "drivers/motor.h"
+    #include "drivers/pwm_output.h"
+    #include "drivers/time.h"
+    #include "drivers/timer.h"
+
+    #include "fc/controlrate_profile.h"
+    #include "fc/core.h"
+    #include "fc/rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/collective.h"
+    #include "flight/failsafe.h"
+    #include "flight/governor.h"
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/servos.h"
+    #include "flight/swash.h"
+    #include "flight/tailmotor.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/battery.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    attitudeEulerAngles_t attitude;
+    float rcCommand[5];
+    int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    rxRuntimeState_t rxRuntimeState;
+    pidAxisData_t pidData[3];
+    uint32_t targetPidLooptime = 500;
+
+    pidProfile_t *currentPidProfile;
+    controlRateConfig_t *currentControlRateProfile;
+}
+
+#include "bench.h"
+
+#define SAMPLE_COUNT        1024            // power of two
+
+static float samples[SAMPLE_COUNT];
+
+static pidProfile_t pidProfile;
+static controlRateConfig_t controlRateProfile;
+static collective_t collective;
+
+// Single main motor, three swash servos and the tail servo of the 120 CCPM heli mixer
+static void initMixer(uint8_t swashType)
+{
+    pgResetAll();
+
+    pidProfile.pidSumLimit = PIDSUM_LIMIT;
+    pidProfile.pidSumLimitYaw = PIDSUM_LIMIT_YAW;
+    currentPidProfile = &pidProfile;
+    currentControlRateProfile = &controlRateProfile;
+
+    mixerConfigMutable()->mixerMode = MIXER_HELI_120_CCPM;
+    swashConfigMutable()->swash_type = swashType;
+
+    mixerInit(MIXER_HELI_120_CCPM);
+    mixerConfigureOutput();
+    servosInit();
+    servoConfigureOutput();
+
+    ENABLE_ARMING_FLAG(ARMED);
+}
+
+static void setInputs(uint32_t i)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pidData[axis].Sum = samples[(i + axis * 64) & (SAMPLE_COUNT - 1)];
+        rcCommand[axis] = pidData[axis].Sum;
+    }
+    rcCommand[THROTTLE] = 1800;
+    collective.command = samples[(i + 192) & (SAMPLE_COUNT - 1)];
+}
+
+static void benchMixTable(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        setInputs(i);
+        mixTable(i * targetPidLooptime, 0);
+    }
+    benchSink = motor[0];
+}
+
+static void benchServoMixer(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        setInputs(i);
+        servoMixer();
+    }
+    benchSink = servo[0];
+}
+
+int main(void)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        seed = seed * 1103515245 + 12345;
+        samples[i] = 300.0f * sinf(2.0f * M_PIf * i / SAMPLE_COUNT) + (float)((seed >> 16) & 0x3f) - 32.0f;
+    }
+
+    initMixer(SWASH_TYPE_NONE);
+    benchRun("mixTable.heli", benchMixTable);
+    benchRun("servoMixer.smix", benchServoMixer);
+
+    initMixer(SWASH_TYPE_CCPM120);
+    benchRun("servoMixer.swash120", benchServoMixer);
+
+    return 0;
+}
+
+// STUBS
+
+extern "C" {
+PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+
+uint16_t rcModeFlags;
+bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+bool airmodeIsEnabled(void) { return true; }
+void beeperConfirmationBeeps(uint8_t) { }
+float calculateVbatPidCompensation(void) { return 1.0f; }
+const collective_t *collectiveGet(void) { return &collective; }
+bool failsafeIsActive(void) { return false; }
+float failsafeHeliApplyThrottle(float throttle) { return throttle; }
+failsafeHeliAction_e failsafeHeliGetAction(void) { return FAILSAFE_HELI_NONE; }
+float governorUpdate(timeUs_t, float throttle, float) { return throttle; }
+bool isFlipOverAfterCrashActive(void) { return false; }
+uint8_t isHeliSpooledUp(void) { return true; }
+bool isMotorsReversed(void) { return false; }
+void motorInitEndpoints(float outputLimit, float *outputLow, float *outputHigh, float *disarm, float *deadbandMotor3DHigh, float *deadbandMotor3DLow)
+{
+    *outputLow = 1000;
+    *outputHigh = 1000 + 1000 * outputLimit;
+    *disarm = 1000;
+    *deadbandMotor3DHigh = 1500;
+    *deadbandMotor3DLow = 1500;
+}
+void motorWriteAll(float *) { }
+float pidGetDT(void) { return targetPidLooptime * 1e-6f; }
+void pidResetIterm(void) { }
+void pwmCompleteServoUpdate(uint32_t) { }
+void pwmWriteServo(uint8_t, float) { }
+bool tailMotorIsClosedLoop(void) { return false; }
+float tailMotorUpdate(float thrustDemand) { return thrustDemand; }
+ioTag_t timerioTagGetByUsage(timerUsageFlag_e, uint8_t) { return 0; }
+void delay(timeMs_t) { }
+}
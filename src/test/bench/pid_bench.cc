@@ -0,0 +1,149 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <cmath>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "fc/core.h"
+    #include "fc/rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/governor.h"
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/servos.h"
+    #include "flight/tailmotor.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/gyro.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    gyro_t gyro;
+    attitudeEulerAngles_t attitude;
+    float rcCommand[5];
+    float headspeed;
+    float throttleBoost;
+}
+
+#include "bench.h"
+
+#define SAMPLE_COUNT        1024            // power of two
+
+static float gyroSamples[SAMPLE_COUNT];
+static float setpointSamples[SAMPLE_COUNT];
+static uint32_t sampleIndex;
+
+static pidProfile_t *pidProfile;
+
+static void initPid(bool angleMode, uint8_t cyclicDenom)
+{
+    pgResetAll();
+    gyro.targetLooptime = 125;
+    pidConfigMutable()->pid_cyclic_denom = cyclicDenom;
+
+    pidProfile = pidProfilesMutable(0);
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+    if (angleMode) {
+        ENABLE_FLIGHT_MODE(ANGLE_MODE);
+    } else {
+        DISABLE_FLIGHT_MODE(ANGLE_MODE);
+    }
+}
+
+// One PID loop with a moving gyro and setpoint on all three axes
+static void benchPidController(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        sampleIndex = i & (SAMPLE_COUNT - 1);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyro.gyroADCf[axis] = gyroSamples[(sampleIndex + axis * 64) & (SAMPLE_COUNT - 1)];
+        }
+        pidController(pidProfile, i * gyro.targetLooptime);
+    }
+    benchSink = pidData[FD_ROLL].Sum;
+}
+
+int main(void)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        seed = seed * 1103515245 + 12345;
+        setpointSamples[i] = 300.0f * sinf(2.0f * M_PIf * i / SAMPLE_COUNT);
+        gyroSamples[i] = setpointSamples[i] + (float)((seed >> 16) & 0xff) / 8.0f - 16.0f;
+    }
+
+    initPid(false, 1);
+    benchRun("pidController.rate", benchPidController);
+
+    initPid(true, 1);
+    benchRun("pidController.angle", benchPidController);
+
+    initPid(false, 4);
+    benchRun("pidController.cyclic4", benchPidController);
+
+    return 0;
+}
+
+// STUBS
+
+extern "C" {
+PG_REGISTER(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 0);
+PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+
+float getSetpointRate(int axis) { return setpointSamples[(sampleIndex + axis * 64) & (SAMPLE_COUNT - 1)]; }
+float getRcDeflection(int axis) { return getSetpointRate(axis) / 500.0f; }
+float getRcDeflectionAbs(int axis) { return fabsf(getRcDeflection(axis)); }
+float getThrottlePIDAttenuation(void) { return 1.0f; }
+float getMotorMixRange(void) { return 0.0f; }
+bool isAirmodeActivated() { return true; }
+void systemBeep(bool) { }
+bool gyroOverflowDetected(void) { return false; }
+float getCosTiltAngle(void) { return 1.0f; }
+void getUpVector(float *up) { up[0] = 0; up[1] = 0; up[2] = 1; }
+float failsafeHeliApplyCollective(float collective) { return collective; }
+void beeperConfirmationBeeps(uint8_t) { }
+void disarm(void) { }
+float applyFFLimit(int, float value, float, float) { return value; }
+uint8_t calculateThrottlePercentAbs(void) { return 50; }
+void governorInit(void) { }
+uint8_t isHeliSpooledUp(void) { return true; }
+uint16_t mixerGetYawPidsumAssistLimit(void) { return 0; }
+float servosGetSwashRingValue(void) { return 0.0f; }
+void tailMotorInit(void) { }
+}
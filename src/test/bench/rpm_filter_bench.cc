@@ -0,0 +1,128 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/rpm_filter.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/gyro.h"
+    #include "sensors/rpm_source.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    gyro_t gyro;
+    acc_t acc;
+}
+
+#include "bench.h"
+
+#define SAMPLE_COUNT        1024            // power of two
+
+static float samples[SAMPLE_COUNT];
+static int motorRpm[2];
+
+// Main rotor bank on motor 1 and an optional tail bank on motor 2
+static void initRpmFilter(int mainHarmonics, int tailHarmonics)
+{
+    pgResetAll();
+    pidConfigMutable()->pid_process_denom = 1;
+
+    rpmFilterConfig_t *config = rpmFilterConfigMutable();
+    config->filter_bank_motor_index[0] = 1;
+    config->filter_bank_gear_ratio[0] = 10000;
+    config->filter_bank_harmonics[0] = mainHarmonics;
+    config->filter_bank_motor_index[1] = tailHarmonics ? 2 : 0;
+    config->filter_bank_gear_ratio[1] = 2000;
+    config->filter_bank_harmonics[1] = tailHarmonics;
+
+    rpmFilterInit(config);
+}
+
+static void benchRpmFilterGyro(uint32_t count)
+{
+    float out = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        float data[XYZ_AXIS_COUNT] = {
+            samples[i & (SAMPLE_COUNT - 1)],
+            samples[(i + 64) & (SAMPLE_COUNT - 1)],
+            samples[(i + 128) & (SAMPLE_COUNT - 1)],
+        };
+        rpmFilterGyro(data);
+        out += data[X] + data[Y] + data[Z];
+    }
+    benchSink = out;
+}
+
+static void benchRpmFilterUpdate(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        motorRpm[0] = 20000 + (i & 1023);
+        motorRpm[1] = 15000 + (i & 511);
+        rpmFilterUpdate();
+    }
+    benchSink = motorRpm[0];
+}
+
+int main(void)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        seed = seed * 1103515245 + 12345;
+        samples[i] = (float)((seed >> 16) & 0x3ff) / 8.0f - 64.0f;
+    }
+
+    gyro.targetLooptime = 125;
+    motorRpm[0] = 20000;
+    motorRpm[1] = 15000;
+
+    initRpmFilter(1, 0);
+    benchRun("rpmFilterGyro.1notch", benchRpmFilterGyro);
+
+    initRpmFilter(3, 2);
+    benchRun("rpmFilterGyro.5notch", benchRpmFilterGyro);
+    benchRun("rpmFilterUpdate.5notch", benchRpmFilterUpdate);
+
+    return 0;
+}
+
+// STUBS
+
+extern "C" {
+PG_REGISTER(pidConfig_t, pidConfig, PG_PID_CONFIG, 0);
+PG_REGISTER(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 0);
+bool sensors(uint32_t) { return false; }
+uint8_t getMotorCount(void) { return 2; }
+int getMotorRPM(uint8_t motor) { return motorRpm[motor]; }
+}
@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# Replays decoded blackbox logs through the SITL firmware.
+#
+# usage: replay.sh <eeprom.bin> <outdir> <log.csv>...
+#
+# Every log is run with the config in eeprom.bin, the output log with the
+# recomputed gyro, PID, motor and servo fields goes to <outdir>/<log>.
+# Build the firmware first with `make TARGET=SITL`.
+
+set -e
+
+ROOT_DIR=$(cd "$(dirname "$0")/../../.." && pwd)
+SITL_ELF=${SITL_ELF:-$ROOT_DIR/obj/main/betaflight_SITL.elf}
+
+if [ $# -lt 3 ]; then
+    echo "usage: $0 <eeprom.bin> <outdir> <log.csv>..." >&2
+    exit 1
+fi
+
+EEPROM=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+OUT_DIR=$2
+shift 2
+
+mkdir -p "$OUT_DIR"
+OUT_DIR=$(cd "$OUT_DIR" && pwd)
+
+for LOG in "$@"; do
+    LOG_PATH=$(cd "$(dirname "$LOG")" && pwd)/$(basename "$LOG")
+    RUN_DIR=$(mktemp -d)
+    # each run gets its own copy, the firmware may write the config back
+    cp "$EEPROM" "$RUN_DIR/eeprom.bin"
+    (cd "$RUN_DIR" && SITL_REPLAY="$LOG_PATH" SITL_REPLAY_OUT="$OUT_DIR/$(basename "$LOG")" "$SITL_ELF" > replay.log 2>&1) || {
+        echo "$LOG: replay failed" >&2
+        cat "$RUN_DIR/replay.log" >&2
+    }
+    grep "^\[replay\][0-9]" "$RUN_DIR/replay.log" | sed "s|^|$LOG: |"
+    rm -rf "$RUN_DIR"
+done
@@ -283,6 +283,24 @@ TEST(AlignSensorTest, ClockwiseTwoSeventyDegreesFlip)
     testCWFlip(CW270_DEG_FLIP, 270);
 }
 
+TEST(AlignSensorTest, PrecomputedMatrixMatchesStandardRotation)
+{
+    for (int alignment = CW0_DEG; alignment <= CW270_DEG_FLIP; alignment++) {
+        fp_rotationMatrix_t rotationMatrix;
+        buildSensorAlignmentMatrix(&rotationMatrix, (sensor_align_e)alignment, NULL);
+
+        float expected[XYZ_AXIS_COUNT] = { 1.0f, -2.0f, 3.0f };
+        float actual[XYZ_AXIS_COUNT] = { 1.0f, -2.0f, 3.0f };
+        alignSensorViaRotation(expected, alignment);
+        applyRotation(actual, &rotationMatrix);
+
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            // exact, the precomputed standard matrices only hold -1, 0 and 1
+            EXPECT_EQ(expected[axis], actual[axis]) << "alignment: " << alignment << " axis: " << axis;
+        }
+    }
+}
+
 static void testBuildAlignmentWithStandardAlignment(sensor_align_e alignment, sensorAlignment_t expectedSensorAlignment)
 {
     sensorAlignment_t sensorAlignment = SENSOR_ALIGNMENT(6, 6, 6);
@@ -1048,6 +1048,14 @@ extern "C" {
     void writeMotors(void) {};
     void writeServos(void) {};
     bool calculateRxChannelsAndUpdateFailsafe(timeUs_t) { return true; }
+    bool rxInlineDecodeEnabled(void) { return false; }
+    bool rxDecodeInlineFrame(timeUs_t) { return false; }
+    void rxSignalWatchdog(timeUs_t) {}
+    void rpmSourceUpdate(timeUs_t) {}
+    void imuUpdateGyroAttitude(void) {}
+    bool rxGetFrameDelta(timeDelta_t *) { return false; }
+    void rxFrameTimingUpdate(timeUs_t, timeDelta_t) {}
+    uint16_t currentRxRefreshRate;
     bool isMixerUsingServos(void) { return false; }
     void gyroUpdate(timeUs_t) {}
     timeDelta_t getTaskDeltaTime(cfTaskId_e) { return 0; }
@@ -1056,6 +1064,9 @@ extern "C" {
     void failsafeStartMonitoring(void) {}
     void failsafeUpdateState(void) {}
     bool failsafeIsActive(void) { return false; }
+    bool failsafeIsLevelling(void) { return false; }
+    void failsafeHeliUpdate(timeUs_t) {}
+    float failsafeHeliApplyCollective(float collective) { return collective; }
     void pidResetIterm(void) {}
     void updateAdjustmentStates(void) {}
     void processRcAdjustments(controlRateConfig_t *) {}
@@ -1086,9 +1097,11 @@ extern "C" {
     float scaleRangef(float, float, float, float, float) { return 0.0f; }
     bool crashRecoveryModeActive(void) { return false; }
     int32_t getEstimatedAltitudeCm(void) { return 0; }
+    float getEstimatedClimbRateCms(void) { return 0; }
     bool gpsIsHealthy() { return false; }
     bool isAltitudeOffset(void) { return false; }
     float getCosTiltAngle(void) { return 0.0f; }
+    void getUpVector(float *up) { up[0] = 0; up[1] = 0; up[2] = 1; }
     void pidSetItermReset(bool) {}
     void applyAccelerometerTrimsDelta(rollAndPitchTrims_t*) {}
     bool isFixedWing(void) { return false; }
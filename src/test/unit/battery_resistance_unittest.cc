@@ -0,0 +1,110 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "sensors/battery_resistance.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SAMPLE_DT   0.002f      // 500Hz battery load task
+
+// Pack of voc volts and r ohm at a current stepping between low and high amps every half second
+static void feedSteppedLoad(batteryResistance_t *est, float voc, float r, float low, float high, int samples)
+{
+    for (int i = 0; i < samples; i++) {
+        const float amperage = ((i / 250) % 2) ? high : low;
+        batteryResistanceUpdate(est, (voc - amperage * r) * 100, amperage * 100, SAMPLE_DT);
+    }
+}
+
+TEST(BatteryResistanceUnittest, FitsStepLoad)
+{
+    // given
+    batteryResistance_t est;
+    batteryResistanceInit(&est);
+
+    // when
+    feedSteppedLoad(&est, 50.0f, 0.05f, 10.0f, 60.0f, 5000);
+
+    // then
+    EXPECT_TRUE(batteryResistanceIsValid(&est));
+    EXPECT_NEAR(0.05f, est.r, 0.005f);
+    EXPECT_NEAR(50.0f, est.voc, 0.2f);
+}
+
+TEST(BatteryResistanceUnittest, SteadyLoadIsNotFitted)
+{
+    // given
+    batteryResistance_t est;
+    batteryResistanceInit(&est);
+
+    // when
+    feedSteppedLoad(&est, 50.0f, 0.05f, 30.0f, 30.0f, 5000);
+
+    // then
+    EXPECT_FALSE(batteryResistanceIsValid(&est));
+    EXPECT_EQ(0, est.samples);
+    EXPECT_FLOAT_EQ(0.0f, est.r);
+}
+
+TEST(BatteryResistanceUnittest, NoSagUntilValid)
+{
+    // given
+    batteryResistance_t est;
+    batteryResistanceInit(&est);
+    est.r = 0.05f;
+
+    // then
+    EXPECT_FLOAT_EQ(0.0f, batteryResistanceSag(&est, 4500, 5000));
+}
+
+TEST(BatteryResistanceUnittest, SagIsIR)
+{
+    // given
+    batteryResistance_t est;
+    batteryResistanceInit(&est);
+    feedSteppedLoad(&est, 50.0f, 0.05f, 10.0f, 60.0f, 5000);
+
+    // when
+    const float sag = batteryResistanceSag(&est, 4750, 5000);
+
+    // then 50A * 0.05 ohm
+    EXPECT_NEAR(250, sag, 25);
+    EXPECT_FLOAT_EQ(0.0f, batteryResistanceSag(&est, 4750, 0));
+    EXPECT_FLOAT_EQ(0.0f, batteryResistanceSag(&est, 4750, -500));
+}
+
+TEST(BatteryResistanceUnittest, SagIsLimitedToShareOfVoltage)
+{
+    // given a fit gone bad
+    batteryResistance_t est;
+    batteryResistanceInit(&est);
+    est.samples = BATTERY_RESISTANCE_VALID_SAMPLES;
+    est.r = BATTERY_RESISTANCE_MAX;
+
+    // when 100A at 40V
+    const float sag = batteryResistanceSag(&est, 4000, 10000);
+
+    // then
+    EXPECT_FLOAT_EQ(4000 * BATTERY_SAG_COMPENSATION_MAX_PERCENT / 100, sag);
+}
@@ -0,0 +1,211 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "config/config.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "flight/pid.h"
+
+    #include "scheduler/benchmark.h"
+
+    #include "sensors/gyro.h"
+
+    uint8_t armingFlags;
+    gyro_t gyro;
+    pidProfile_t *currentPidProfile;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// every read of the cycle counter costs this much, it is taken off each sample
+#define TEST_MEASURE_OVERHEAD   7
+
+static uint32_t testCycles;
+
+// the cost of each PID controller call, repeats after testCostCount calls
+static uint32_t testCosts[BENCHMARK_ITERATIONS_MAX];
+static int testCostCount;
+static int testCostIndex;
+static int testPidCalls;
+
+static bool testBlackboxReady;
+static int testBlackboxFrames;
+
+static void setCosts(const uint32_t *costs, int count)
+{
+    memcpy(testCosts, costs, count * sizeof(costs[0]));
+    testCostCount = count;
+    testCostIndex = 0;
+    testPidCalls = 0;
+    armingFlags = 0;
+}
+
+TEST(BenchmarkTest, TestMinMedianMax)
+{
+    // given
+    const uint32_t costs[] = { 500, 120, 300, 900, 110 };
+    setCosts(costs, ARRAYLEN(costs));
+
+    // when
+    benchmarkResult_t result;
+    EXPECT_TRUE(benchmarkRun(BENCHMARK_PID_CONTROLLER, ARRAYLEN(costs), &result));
+
+    // then
+    // the measurement overhead is not counted
+    EXPECT_EQ(ARRAYLEN(costs), result.iterations);
+    EXPECT_EQ(110u, result.minCycles);
+    EXPECT_EQ(300u, result.medianCycles);
+    EXPECT_EQ(900u, result.maxCycles);
+    EXPECT_EQ((int)ARRAYLEN(costs), testPidCalls);
+}
+
+TEST(BenchmarkTest, TestLongSamplesSaturateOnlyTheMedian)
+{
+    // given
+    const uint32_t costs[] = { 100000, 200000, 300000 };
+    setCosts(costs, ARRAYLEN(costs));
+
+    // when
+    benchmarkResult_t result;
+    EXPECT_TRUE(benchmarkRun(BENCHMARK_PID_CONTROLLER, ARRAYLEN(costs), &result));
+
+    // then
+    EXPECT_EQ(100000u, result.minCycles);
+    EXPECT_EQ((uint32_t)UINT16_MAX, result.medianCycles);
+    EXPECT_EQ(300000u, result.maxCycles);
+}
+
+TEST(BenchmarkTest, TestIterationsConstrained)
+{
+    // given
+    const uint32_t costs[] = { 50 };
+    setCosts(costs, ARRAYLEN(costs));
+    benchmarkResult_t result;
+
+    // when
+    EXPECT_TRUE(benchmarkRun(BENCHMARK_PID_CONTROLLER, 0, &result));
+
+    // then
+    EXPECT_EQ(1, result.iterations);
+    EXPECT_EQ(1, testPidCalls);
+
+    // when
+    testPidCalls = 0;
+    EXPECT_TRUE(benchmarkRun(BENCHMARK_PID_CONTROLLER, BENCHMARK_ITERATIONS_MAX + 100, &result));
+
+    // then
+    EXPECT_EQ(BENCHMARK_ITERATIONS_MAX, result.iterations);
+    EXPECT_EQ(BENCHMARK_ITERATIONS_MAX, testPidCalls);
+    EXPECT_EQ(50u, result.medianCycles);
+}
+
+TEST(BenchmarkTest, TestNotWhileArmed)
+{
+    // given
+    const uint32_t costs[] = { 50 };
+    setCosts(costs, ARRAYLEN(costs));
+    ENABLE_ARMING_FLAG(ARMED);
+
+    // when
+    benchmarkResult_t result;
+    memset(&result, 0xff, sizeof(result));
+    EXPECT_FALSE(benchmarkRun(BENCHMARK_PID_CONTROLLER, 10, &result));
+
+    // then
+    EXPECT_EQ(0, result.iterations);
+    EXPECT_EQ(0, testPidCalls);
+}
+
+TEST(BenchmarkTest, TestKernelNotInBuild)
+{
+    // given
+    // no USE_RPM_FILTER in this build
+    benchmarkResult_t result;
+
+    // then
+    EXPECT_FALSE(benchmarkRun(BENCHMARK_RPM_FILTER, 10, &result));
+    EXPECT_EQ(0, result.iterations);
+    EXPECT_STREQ("RPM_FILTER", benchmarkGetName(BENCHMARK_RPM_FILTER));
+}
+
+TEST(BenchmarkTest, TestKernelPrepare)
+{
+    // given
+    // the blackbox kernel only runs while not logging
+    armingFlags = 0;
+    testBlackboxReady = false;
+    testBlackboxFrames = 0;
+    benchmarkResult_t result;
+
+    // then
+    EXPECT_FALSE(benchmarkRun(BENCHMARK_BLACKBOX_ENCODE, 10, &result));
+    EXPECT_EQ(0, testBlackboxFrames);
+
+    // when
+    testBlackboxReady = true;
+
+    // then
+    EXPECT_TRUE(benchmarkRun(BENCHMARK_BLACKBOX_ENCODE, 10, &result));
+    EXPECT_EQ(10, testBlackboxFrames);
+    EXPECT_EQ(0u, result.maxCycles);
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t atomic_BASEPRI;
+
+    uint32_t getCycleCounter(void)
+    {
+        testCycles += TEST_MEASURE_OVERHEAD;
+        return testCycles;
+    }
+
+    timeUs_t micros(void) { return 0; }
+
+    void pidController(const pidProfile_t *pidProfile, timeUs_t currentTimeUs)
+    {
+        UNUSED(pidProfile);
+        UNUSED(currentTimeUs);
+        testCycles += testCosts[testCostIndex];
+        testCostIndex = (testCostIndex + 1) % testCostCount;
+        testPidCalls++;
+    }
+
+    void gyroFilterBenchmark(void) {}
+    void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensation)
+    {
+        UNUSED(currentTimeUs);
+        UNUSED(vbatPidCompensation);
+    }
+    void servoMixer(void) {}
+
+    bool blackboxBenchmarkPrepare(void) { return testBlackboxReady; }
+    void blackboxBenchmarkFrame(void) { testBlackboxFrames++; }
+}
@@ -246,6 +246,16 @@ PG_REGISTER(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 0);
 int32_t blackboxHeaderBudget;
 void mspSerialAllocatePorts(void) {}
 void blackboxWrite(uint8_t value) {serialWrite(blackboxPort, value);}
+static uint8_t reserveBuffer[16];
+uint8_t *blackboxReserve(int) {return reserveBuffer;}
+void blackboxCommit(uint8_t *end)
+{
+    for (const uint8_t *pos = reserveBuffer; pos < end; pos++) {
+        serialWrite(blackboxPort, *pos);
+    }
+}
+void blackboxFrameBegin(void) {}
+void blackboxFrameCommit(void) {}
 int blackboxWriteString(const char *s)
 {
     const uint8_t *pos = (uint8_t*)s;
@@ -51,6 +51,8 @@ extern "C" {
 
     extern int16_t blackboxIInterval;
     extern int16_t blackboxPInterval;
+    extern uint8_t blackboxFastInterval;
+    extern uint8_t blackboxHeliInterval;
 }
 
 #include "unittest_macros.h"
@@ -221,6 +223,63 @@ TEST(BlackboxTest, Test_8kHz)
     EXPECT_TRUE(blackboxShouldLogPFrame());
 }
 
+TEST(BlackboxTest, Test_FastFrames)
+{
+    blackboxConfigMutable()->p_ratio = 32;
+    blackboxConfigMutable()->fast_denom = 0;
+    // 8kHz PIDloop
+    targetPidLooptime = 125;
+    blackboxInit();
+    EXPECT_EQ(0, blackboxFastInterval);
+    for (int ii = 0; ii < 16; ++ii) {
+        EXPECT_FALSE(blackboxShouldLogFastFrame());
+        blackboxAdvanceIterationTimers();
+    }
+
+    // fast frames every 2nd loop, independent of the 8 loop P-frame interval
+    blackboxConfigMutable()->fast_denom = 2;
+    blackboxInit();
+    EXPECT_EQ(2, blackboxFastInterval);
+    for (int ii = 0; ii < 16; ++ii) {
+        EXPECT_EQ(ii % 2 == 0, blackboxShouldLogFastFrame());
+        EXPECT_EQ(ii % 8 == 0, blackboxShouldLogPFrame());
+        blackboxAdvanceIterationTimers();
+    }
+
+    // every loop
+    blackboxConfigMutable()->fast_denom = 1;
+    blackboxInit();
+    for (int ii = 0; ii < 16; ++ii) {
+        EXPECT_TRUE(blackboxShouldLogFastFrame());
+        blackboxAdvanceIterationTimers();
+    }
+    blackboxConfigMutable()->fast_denom = 0;
+}
+
+TEST(BlackboxTest, Test_HeliFrames)
+{
+    blackboxConfigMutable()->heli_denom = 0;
+    blackboxInit();
+    EXPECT_EQ(0, blackboxHeliInterval);
+    EXPECT_FALSE(blackboxShouldLogHeliFrame(true));
+    EXPECT_FALSE(blackboxShouldLogHeliFrame(false));
+
+    // every 3rd main frame
+    blackboxConfigMutable()->heli_denom = 3;
+    blackboxInit();
+    EXPECT_EQ(3, blackboxHeliInterval);
+    EXPECT_TRUE(blackboxShouldLogHeliFrame(true));
+    EXPECT_FALSE(blackboxShouldLogHeliFrame(false));
+    EXPECT_FALSE(blackboxShouldLogHeliFrame(false));
+    EXPECT_TRUE(blackboxShouldLogHeliFrame(false));
+    EXPECT_FALSE(blackboxShouldLogHeliFrame(false));
+
+    // an I-frame restarts the sub-rate
+    EXPECT_TRUE(blackboxShouldLogHeliFrame(true));
+    EXPECT_FALSE(blackboxShouldLogHeliFrame(false));
+    blackboxConfigMutable()->heli_denom = 0;
+}
+
 TEST(BlackboxTest, Test_zero_p_ratio)
 {
     blackboxConfigMutable()->p_ratio = 0;
@@ -382,6 +441,8 @@ boxBitmask_t rcModeActivationMask;
 
 void mspSerialAllocatePorts(void) {}
 uint32_t getArmingBeepTimeMicros(void) {return 0;}
+uint16_t averageSystemLoadPercent = 0;
+uint8_t schedulerGetLoadShedLevel(void) {return 0;}
 uint16_t getBatteryVoltageLatest(void) {return 0;}
 uint8_t getMotorCount(void) {return 4;}
 bool areMotorsRunning(void) { return false; }
@@ -390,6 +451,7 @@ bool isModeActivationConditionPresent(boxId_e) {return false;}
 uint32_t millis(void) {return 0;}
 bool sensors(uint32_t) {return false;}
 void serialWrite(serialPort_t *, uint8_t) {}
+void serialWriteBuf(serialPort_t *, const uint8_t *, int) {}
 uint32_t serialTxBytesFree(const serialPort_t *) {return 0;}
 bool isSerialTransmitBufferEmpty(const serialPort_t *) {return false;}
 bool featureIsEnabled(uint32_t) {return false;}
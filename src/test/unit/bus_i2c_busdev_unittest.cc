@@ -0,0 +1,362 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/time.h"
+
+    #include "drivers/bus.h"
+    #include "drivers/bus_i2c.h"
+    #include "drivers/bus_i2c_busdev.h"
+    #include "drivers/bus_i2c_impl.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_TRANSFER_COUNT 8
+
+// the transfers the queue handed to the driver, as the interrupt driven drivers take them
+typedef struct testTransfer_s {
+    I2CDevice device;
+    uint8_t address;
+    uint8_t reg;
+    uint8_t len;
+    bool read;
+} testTransfer_t;
+
+static testTransfer_t testTransfers[TEST_TRANSFER_COUNT];
+static int testTransferCount;
+static bool testAccept;
+static int testInitCount;
+static timeUs_t testTimeUs;
+
+static int testCallbackCount;
+static i2cSequence_t *testCallbackSequence;
+
+static void testCallback(i2cSequence_t *sequence)
+{
+    testCallbackCount++;
+    testCallbackSequence = sequence;
+}
+
+static void resetDriver(void)
+{
+    testTransferCount = 0;
+    testAccept = true;
+    testInitCount = 0;
+    testCallbackCount = 0;
+    testCallbackSequence = NULL;
+}
+
+static busDevice_t testBus(I2CDevice device, uint8_t address)
+{
+    busDevice_t bus;
+    bus.bustype = BUSTYPE_I2C;
+    bus.busdev_u.i2c.device = device;
+    bus.busdev_u.i2c.address = address;
+    return bus;
+}
+
+TEST(BusI2cBusdevTest, TestSequencesRunInOrder)
+{
+    // given
+    resetDriver();
+    const busDevice_t baro = testBus(I2CDEV_1, 0x76);
+    const busDevice_t mag = testBus(I2CDEV_1, 0x1e);
+    uint8_t data[6];
+    const i2cSegment_t baroSegments[] = {
+        { .reg = 0xf4, .data = data, .len = 1, .read = false },
+        { .reg = 0xf7, .data = data, .len = 6, .read = true },
+        { .len = 0 },
+    };
+    const i2cSegment_t magSegments[] = {
+        { .reg = 0x03, .data = data, .len = 6, .read = true },
+        { .len = 0 },
+    };
+    i2cSequence_t baroSequence = { .bus = &baro, .segments = baroSegments, .callback = testCallback };
+    i2cSequence_t magSequence = { .bus = &mag, .segments = magSegments, .callback = testCallback };
+
+    // when
+    EXPECT_TRUE(i2cSequenceStart(&baroSequence));
+    EXPECT_TRUE(i2cSequenceStart(&magSequence));
+
+    // then
+    // only the first segment is handed to the driver, the rest waits for its completion
+    EXPECT_EQ(1, testTransferCount);
+    EXPECT_EQ(0x76, testTransfers[0].address);
+    EXPECT_EQ(0xf4, testTransfers[0].reg);
+    EXPECT_FALSE(testTransfers[0].read);
+    EXPECT_TRUE(i2cSequenceIsPending(&baroSequence));
+    EXPECT_TRUE(i2cSequenceIsPending(&magSequence));
+
+    // when
+    // the completion interrupt starts the next segment
+    i2cSequenceTransferDone(I2CDEV_1, false);
+
+    // then
+    EXPECT_EQ(2, testTransferCount);
+    EXPECT_EQ(0xf7, testTransfers[1].reg);
+    EXPECT_EQ(6, testTransfers[1].len);
+    EXPECT_TRUE(testTransfers[1].read);
+    EXPECT_EQ(0, testCallbackCount);
+
+    // when
+    i2cSequenceTransferDone(I2CDEV_1, false);
+
+    // then
+    EXPECT_EQ(1, testCallbackCount);
+    EXPECT_EQ(&baroSequence, testCallbackSequence);
+    EXPECT_FALSE(i2cSequenceIsPending(&baroSequence));
+    EXPECT_FALSE(baroSequence.error);
+
+    EXPECT_EQ(3, testTransferCount);
+    EXPECT_EQ(0x1e, testTransfers[2].address);
+
+    // when
+    i2cSequenceTransferDone(I2CDEV_1, false);
+
+    // then
+    EXPECT_EQ(2, testCallbackCount);
+    EXPECT_EQ(&magSequence, testCallbackSequence);
+    EXPECT_FALSE(i2cSequenceIsPending(&magSequence));
+    EXPECT_EQ(3, testTransferCount);
+}
+
+TEST(BusI2cBusdevTest, TestErrorSkipsTheRestOfTheSequence)
+{
+    // given
+    resetDriver();
+    const busDevice_t baro = testBus(I2CDEV_2, 0x76);
+    uint8_t data[2];
+    const i2cSegment_t segments[] = {
+        { .reg = 0x10, .data = data, .len = 1, .read = false },
+        { .reg = 0x11, .data = data, .len = 2, .read = true },
+        { .len = 0 },
+    };
+    i2cSequence_t sequence = { .bus = &baro, .segments = segments, .callback = testCallback };
+    EXPECT_TRUE(i2cSequenceStart(&sequence));
+
+    // when
+    i2cSequenceTransferDone(I2CDEV_2, true);
+
+    // then
+    EXPECT_EQ(1, testTransferCount);
+    EXPECT_EQ(1, testCallbackCount);
+    EXPECT_FALSE(i2cSequenceIsPending(&sequence));
+    EXPECT_TRUE(sequence.error);
+
+    // when
+    // a completion nobody waits for is ignored
+    i2cSequenceTransferDone(I2CDEV_2, false);
+
+    // then
+    EXPECT_EQ(1, testCallbackCount);
+}
+
+TEST(BusI2cBusdevTest, TestStartRefused)
+{
+    // given
+    resetDriver();
+    const busDevice_t invalid = testBus(I2CINVALID, 0x76);
+    const busDevice_t baro = testBus(I2CDEV_1, 0x76);
+    uint8_t data;
+    const i2cSegment_t empty[] = { { .len = 0 } };
+    const i2cSegment_t segments[] = {
+        { .reg = 0x10, .data = &data, .len = 1, .read = true },
+        { .len = 0 },
+    };
+    i2cSequence_t sequence = { .bus = &invalid, .segments = segments };
+
+    // then
+    EXPECT_FALSE(i2cSequenceStart(&sequence));
+
+    sequence.bus = &baro;
+    sequence.segments = empty;
+    EXPECT_FALSE(i2cSequenceStart(&sequence));
+
+    // a sequence can't be queued twice
+    sequence.segments = segments;
+    EXPECT_TRUE(i2cSequenceStart(&sequence));
+    EXPECT_FALSE(i2cSequenceStart(&sequence));
+    EXPECT_EQ(1, testTransferCount);
+
+    i2cSequenceTransferDone(I2CDEV_1, false);
+    EXPECT_FALSE(i2cSequenceIsPending(&sequence));
+}
+
+TEST(BusI2cBusdevTest, TestTransferRetriedWhenPolled)
+{
+    // given
+    // a direct user of the i2cRead()/i2cWrite() API holds the bus
+    resetDriver();
+    testAccept = false;
+    const busDevice_t baro = testBus(I2CDEV_1, 0x76);
+    uint8_t data;
+    const i2cSegment_t segments[] = {
+        { .reg = 0x10, .data = &data, .len = 1, .read = true },
+        { .len = 0 },
+    };
+    i2cSequence_t sequence = { .bus = &baro, .segments = segments };
+    EXPECT_TRUE(i2cSequenceStart(&sequence));
+    EXPECT_EQ(1, testTransferCount);
+
+    // when
+    testAccept = true;
+
+    // then
+    EXPECT_TRUE(i2cSequenceIsPending(&sequence));
+    EXPECT_EQ(2, testTransferCount);
+
+    // when
+    i2cSequenceTransferDone(I2CDEV_1, false);
+
+    // then
+    EXPECT_FALSE(i2cSequenceIsPending(&sequence));
+    EXPECT_FALSE(sequence.error);
+}
+
+TEST(BusI2cBusdevTest, TestTimeoutRecoversTheBus)
+{
+    // given
+    resetDriver();
+    const busDevice_t baro = testBus(I2CDEV_3, 0x76);
+    const busDevice_t mag = testBus(I2CDEV_3, 0x1e);
+    uint8_t data;
+    const i2cSegment_t segments[] = {
+        { .reg = 0x10, .data = &data, .len = 1, .read = true },
+        { .len = 0 },
+    };
+    i2cSequence_t baroSequence = { .bus = &baro, .segments = segments, .callback = testCallback };
+    i2cSequence_t magSequence = { .bus = &mag, .segments = segments };
+    EXPECT_TRUE(i2cSequenceStart(&baroSequence));
+    EXPECT_TRUE(i2cSequenceStart(&magSequence));
+
+    // when
+    // the transfer never completes
+    testTimeUs += I2C_SEQUENCE_TIMEOUT_US;
+    EXPECT_TRUE(i2cSequenceIsPending(&baroSequence));
+    EXPECT_EQ(0, testInitCount);
+
+    testTimeUs += 1;
+
+    // then
+    // the bus is reinitialised, the sequence fails and the next one starts
+    EXPECT_FALSE(i2cSequenceIsPending(&baroSequence));
+    EXPECT_TRUE(baroSequence.error);
+    EXPECT_EQ(1, testCallbackCount);
+    EXPECT_EQ(1, testInitCount);
+    EXPECT_EQ(2, testTransferCount);
+    EXPECT_EQ(0x1e, testTransfers[1].address);
+
+    // when
+    i2cSequenceTransferDone(I2CDEV_3, false);
+
+    // then
+    EXPECT_FALSE(i2cSequenceIsPending(&magSequence));
+    EXPECT_FALSE(magSequence.error);
+}
+
+TEST(BusI2cBusdevTest, TestBusdevStartAndBusy)
+{
+    // given
+    resetDriver();
+    const busDevice_t baro = testBus(I2CDEV_4, 0x76);
+    const busDevice_t mag = testBus(I2CDEV_4, 0x1e);
+    uint8_t data[3];
+
+    // when
+    EXPECT_TRUE(i2cBusReadRegisterBufferStart(&baro, 0xf7, data, sizeof(data)));
+    EXPECT_TRUE(i2cBusWriteRegisterStart(&mag, 0x02, 0x01));
+
+    // then
+    // each device has its own transfer, a second one waits for the first to finish
+    EXPECT_FALSE(i2cBusReadRegisterBufferStart(&baro, 0xf7, data, sizeof(data)));
+    bool error = true;
+    EXPECT_TRUE(i2cBusBusy(&baro, &error));
+    EXPECT_FALSE(error);
+    EXPECT_TRUE(i2cBusBusy(&mag, NULL));
+
+    // when
+    i2cSequenceTransferDone(I2CDEV_4, false);
+
+    // then
+    EXPECT_FALSE(i2cBusBusy(&baro, &error));
+    EXPECT_FALSE(error);
+    EXPECT_TRUE(i2cBusBusy(&mag, NULL));
+
+    EXPECT_EQ(2, testTransferCount);
+    EXPECT_FALSE(testTransfers[1].read);
+    EXPECT_EQ(0x02, testTransfers[1].reg);
+
+    // when
+    i2cSequenceTransferDone(I2CDEV_4, true);
+
+    // then
+    EXPECT_FALSE(i2cBusBusy(&mag, &error));
+    EXPECT_TRUE(error);
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t atomic_BASEPRI;
+
+    static const i2cHardware_t testHardware = { .device = I2CDEV_1 };
+    i2cDevice_t i2cDevice[I2CDEV_COUNT] = {
+        { .hardware = &testHardware },
+        { .hardware = &testHardware },
+        { .hardware = &testHardware },
+        { .hardware = &testHardware },
+    };
+
+    timeUs_t micros(void) { return testTimeUs; }
+
+    void i2cInit(I2CDevice device)
+    {
+        UNUSED(device);
+        testInitCount++;
+    }
+
+    static bool testStartTransfer(I2CDevice device, uint8_t addr, uint8_t reg, uint8_t len, bool read)
+    {
+        if (testTransferCount < TEST_TRANSFER_COUNT) {
+            testTransfers[testTransferCount++] = (testTransfer_t) { device, addr, reg, len, read };
+        }
+        return testAccept;
+    }
+
+    bool i2cWriteBuffer(I2CDevice device, uint8_t addr, uint8_t reg, uint8_t len, uint8_t *data)
+    {
+        UNUSED(data);
+        return testStartTransfer(device, addr, reg, len, false);
+    }
+
+    bool i2cReadBuffer(I2CDevice device, uint8_t addr, uint8_t reg, uint8_t len, uint8_t *buf)
+    {
+        UNUSED(buf);
+        return testStartTransfer(device, addr, reg, len, true);
+    }
+}
@@ -34,6 +34,7 @@ extern "C" {
     #include "config/config.h"
     #include "fc/rc_adjustments.h"
     #include "fc/runtime_config.h"
+    #include "fc/tasks.h"
     #include "flight/mixer.h"
     #include "flight/pid.h"
     #include "flight/servos.h"
@@ -84,6 +85,7 @@ extern "C" {
     PG_REGISTER_ARRAY(rxChannelRangeConfig_t, NON_AUX_CHANNEL_COUNT, rxChannelRangeConfigs, PG_RX_CHANNEL_RANGE_CONFIG, 0);
     PG_REGISTER_ARRAY(rxFailsafeChannelConfig_t, MAX_SUPPORTED_RC_CHANNEL_COUNT, rxFailsafeChannelConfigs, PG_RX_FAILSAFE_CHANNEL_CONFIG, 0);
     PG_REGISTER(pidConfig_t, pidConfig, PG_PID_CONFIG, 0);
+    PG_REGISTER(taskConfig_t, taskConfig, PG_TASK_CONFIG, 0);
 
     PG_REGISTER_WITH_RESET_FN(int8_t, unitTestData, PG_RESERVED_FOR_TESTING_1, 0);
 }
@@ -287,6 +289,7 @@ void serialPassthrough(serialPort_t *, serialPort_t *, serialConsumer *, serialC
 uint32_t millis(void) { return 0; }
 uint8_t getBatteryCellCount(void) { return 1; }
 void servoMixerLoadMix(int) {}
+void servoMixerCompile(void) {}
 const char * getBatteryStateString(void){ return "_getBatteryStateString_"; }
 
 uint32_t stackTotalSize(void) { return 0x4000; }
@@ -308,6 +311,7 @@ const char *armingDisableFlagNames[]= {
 void getTaskInfo(cfTaskId_e, cfTaskInfo_t *) {}
 void getCheckFuncInfo(cfCheckFuncInfo_t *) {}
 void schedulerResetTaskMaxExecutionTime(cfTaskId_e) {}
+bool tasksConfigFits(const taskConfig_t *) { return true; }
 
 const char * const targetName = "UNITTEST";
 const char* const buildDate = "Jan 01 2017";
@@ -316,6 +320,7 @@ const char * const shortGitRevision = "MASTER";
 
 uint32_t serialRxBytesWaiting(const serialPort_t *) {return 0;}
 uint8_t serialRead(serialPort_t *){return 0;}
+uint32_t serialTxBytesFree(const serialPort_t *) {return 0;}
 
 void bufWriterAppend(bufWriter_t *, uint8_t ch){ printf("%c", ch); }
 void serialWriteBufShim(void *, const uint8_t *, int) {}
@@ -114,3 +114,134 @@ TEST(FilterUnittest, TestSlewFilter)
     slewFilterApply(&filter, 200.0f);
     EXPECT_EQ(200, filter.state);
 }
+
+TEST(FilterUnittest, TestBiquadSinCos)
+{
+    for (float omega = 0.0f; omega <= (float)M_PI; omega += 0.01f) {
+        float sn, cs;
+        biquadFilterSinCos(omega, &sn, &cs);
+        EXPECT_NEAR(sinf(omega), sn, 1e-6f);
+        EXPECT_NEAR(cosf(omega), cs, 1e-6f);
+    }
+}
+
+TEST(FilterUnittest, TestBiquadRuntimeUpdateMatchesInit)
+{
+    const uint32_t looptime = 125;
+    const float freqs[] = { 20.0f, 120.0f, 500.0f, 1500.0f, 3900.0f };
+
+    for (const float freq : freqs) {
+        for (const biquadFilterType_e type : { FILTER_LPF, FILTER_NOTCH, FILTER_BPF }) {
+            biquadFilter_t init, update;
+            biquadFilterInit(&init, freq, looptime, 2.5f, type);
+            biquadFilterInit(&update, 100.0f, looptime, 2.5f, type);
+            update.x1 = 1.0f;
+            update.y2 = 2.0f;
+
+            biquadFilterUpdate(&update, freq, looptime, 2.5f, type);
+
+            EXPECT_NEAR(init.b0, update.b0, 1e-5f);
+            EXPECT_NEAR(init.b1, update.b1, 1e-5f);
+            EXPECT_NEAR(init.b2, update.b2, 1e-5f);
+            EXPECT_NEAR(init.a1, update.a1, 1e-5f);
+            EXPECT_NEAR(init.a2, update.a2, 1e-5f);
+            // the state is kept
+            EXPECT_EQ(1.0f, update.x1);
+            EXPECT_EQ(2.0f, update.y2);
+        }
+    }
+}
+
+TEST(FilterUnittest, TestBiquadSetNotches)
+{
+    biquadFilter_t a, b, single;
+    biquadFilter_t * const filters[2] = { &a, &b };
+    const float omegas[2] = { 0.3f, 1.2f };
+
+    biquadFilterSetNotches(filters, omegas, 2, 0.2f);
+    biquadFilterSetNotch(&single, 1.2f, 0.2f);
+
+    EXPECT_EQ(single.b0, b.b0);
+    EXPECT_EQ(single.b1, b.b1);
+    EXPECT_EQ(single.a2, b.a2);
+    EXPECT_NE(a.b1, b.b1);
+}
+
+TEST(FilterUnittest, TestBiquadMorphReachesTarget)
+{
+    biquadFilter_t start, target;
+    biquadFilterSetNotch(&start, 0.3f, 0.2f);
+    biquadFilterSetNotch(&target, 0.6f, 0.2f);
+
+    biquadMorphFilter_t filter;
+    biquadMorphFilterInit(&filter, &start);
+    biquadMorphSetTarget(&filter.coeffs, &target, 8);
+
+    // halfway after half the samples
+    for (int i = 0; i < 4; i++) {
+        biquadMorphFilterApply(&filter, 1.0f);
+    }
+    EXPECT_NEAR((start.b1 + target.b1) / 2, filter.coeffs.b1, 1e-6f);
+    EXPECT_NEAR((start.a2 + target.a2) / 2, filter.coeffs.a2, 1e-6f);
+
+    for (int i = 0; i < 10; i++) {
+        biquadMorphFilterApply(&filter, 1.0f);
+    }
+    EXPECT_EQ(0, filter.coeffs.count);
+    EXPECT_NEAR(target.b0, filter.coeffs.b0, 1e-6f);
+    EXPECT_NEAR(target.b1, filter.coeffs.b1, 1e-6f);
+    EXPECT_NEAR(target.b2, filter.coeffs.b2, 1e-6f);
+    EXPECT_NEAR(target.a1, filter.coeffs.a1, 1e-6f);
+    EXPECT_NEAR(target.a2, filter.coeffs.a2, 1e-6f);
+}
+
+TEST(FilterUnittest, TestBiquadMorphMatchesBiquad)
+{
+    biquadFilter_t biquad;
+    biquadFilterInit(&biquad, 200.0f, 125, 2.5f, FILTER_NOTCH);
+
+    biquadMorphFilter_t filter;
+    biquadMorphFilterInit(&filter, &biquad);
+
+    // without a morph in progress the output is the same as the static filter
+    for (int i = 0; i < 100; i++) {
+        const float input = sinf(i * 0.1f) + (i & 3);
+        EXPECT_FLOAT_EQ(biquadFilterApply(&biquad, input), biquadMorphFilterApply(&filter, input));
+    }
+}
+
+// Sharpest bend in the output of a notch swept up every 16 samples while filtering a constant.
+// Coefficient steps show as kinks in the output, the sweep itself only as a slow change.
+static float biquadMorphSweepKink(uint16_t morphSamples)
+{
+    biquadFilter_t coeffs;
+    biquadFilterSetNotch(&coeffs, 0.05f, 0.1f);
+
+    biquadMorphFilter_t filter;
+    biquadMorphFilterInit(&filter, &coeffs);
+    for (int i = 0; i < 1000; i++) {
+        biquadMorphFilterApply(&filter, 1.0f);
+    }
+
+    float y1 = 1.0f, y2 = 1.0f;
+    float maxKink = 0;
+    for (int update = 0; update < 100; update++) {
+        biquadFilterSetNotch(&coeffs, 0.05f + update * 0.02f, 0.1f);
+        biquadMorphSetTarget(&filter.coeffs, &coeffs, morphSamples);
+        for (int i = 0; i < 16; i++) {
+            const float y = biquadMorphFilterApply(&filter, 1.0f);
+            maxKink = fmaxf(maxKink, fabsf(y - 2 * y1 + y2));
+            y2 = y1;
+            y1 = y;
+        }
+    }
+    return maxKink;
+}
+
+TEST(FilterUnittest, TestBiquadMorphSweepIsSmooth)
+{
+    const float stepped = biquadMorphSweepKink(0);
+    const float morphed = biquadMorphSweepKink(16);
+
+    EXPECT_LT(morphed, stepped * 0.5f);
+}
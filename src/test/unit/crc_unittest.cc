@@ -0,0 +1,120 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+
+extern "C" {
+    #include "common/crc.h"
+    #include "common/streambuf.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const uint8_t checkData[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+// Bit by bit references of the table implementations
+static uint16_t crc16CcittBitwise(uint16_t crc, uint8_t a)
+{
+    crc ^= (uint16_t)a << 8;
+    for (int ii = 0; ii < 8; ++ii) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+static uint16_t crc16ArcBitwise(uint16_t crc, uint8_t a)
+{
+    crc ^= a;
+    for (int ii = 0; ii < 8; ++ii) {
+        crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+    return crc;
+}
+
+static uint8_t crc8Bitwise(uint8_t crc, uint8_t a, uint8_t poly)
+{
+    crc ^= a;
+    for (int ii = 0; ii < 8; ++ii) {
+        crc = (crc & 0x80) ? (crc << 1) ^ poly : crc << 1;
+    }
+    return crc;
+}
+
+TEST(CrcTest, CheckValues)
+{
+    EXPECT_EQ(0x31C3, crc16_ccitt_update(0, checkData, sizeof(checkData)));
+    EXPECT_EQ(0x29B1, crc16_ccitt_update(0xFFFF, checkData, sizeof(checkData)));
+    EXPECT_EQ(0xBB3D, crc16_arc_update(0, checkData, sizeof(checkData)));
+    EXPECT_EQ(0xBC, crc8_dvb_s2_update(0, checkData, sizeof(checkData)));
+    EXPECT_EQ(0xF4, crc8_smbus_update(0, checkData, sizeof(checkData)));
+}
+
+TEST(CrcTest, TableMatchesBitwise)
+{
+    for (int crc = 0; crc < 256; crc += 17) {
+        for (int a = 0; a < 256; a++) {
+            EXPECT_EQ(crc16CcittBitwise(crc << 8 | a, a), crc16_ccitt(crc << 8 | a, a));
+            EXPECT_EQ(crc16ArcBitwise(crc << 8 | a, a), crc16_arc(crc << 8 | a, a));
+            EXPECT_EQ(crc8Bitwise(crc, a, 0xD5), crc8_dvb_s2(crc, a));
+
+            const uint8_t byte = a;
+            EXPECT_EQ(crc8Bitwise(crc, a, 0x07), crc8_smbus_update(crc, &byte, 1));
+        }
+    }
+}
+
+TEST(CrcTest, BulkMatchesBytewise)
+{
+    uint8_t data[300];
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = i * 7 + 3;
+    }
+
+    // Unaligned starts and lengths around the hardware threshold
+    for (int offset = 0; offset < 4; offset++) {
+        for (int length = 0; length < 100; length++) {
+            uint16_t crc = 0x1D0F;
+            for (int i = 0; i < length; i++) {
+                crc = crc16_ccitt(crc, data[offset + i]);
+            }
+            EXPECT_EQ(crc, crc16_ccitt_bulk_update(0x1D0F, data + offset, length));
+        }
+    }
+}
+
+TEST(CrcTest, SbufAppend)
+{
+    uint8_t buffer[16];
+    sbuf_t sbuf;
+    sbuf.ptr = buffer;
+    sbuf.end = buffer + sizeof(buffer);
+
+    sbufWriteData(&sbuf, checkData, sizeof(checkData));
+    crc8_dvb_s2_sbuf_append(&sbuf, buffer);
+    EXPECT_EQ(sizeof(checkData) + 1, (unsigned)(sbuf.ptr - buffer));
+    EXPECT_EQ(0xBC, buffer[sizeof(checkData)]);
+
+    sbuf.ptr = buffer;
+    sbufWriteData(&sbuf, checkData, sizeof(checkData));
+    crc16_ccitt_sbuf_append(&sbuf, buffer);
+    EXPECT_EQ(0xC3, buffer[sizeof(checkData)]);
+    EXPECT_EQ(0x31, buffer[sizeof(checkData) + 1]);
+}
@@ -0,0 +1,163 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static uint8_t testModes[DEBUG_CHANNEL_COUNT];
+static uint8_t testSlots[DEBUG_CHANNEL_COUNT];
+
+static void resetChannels(uint8_t mode)
+{
+    debugMode = mode;
+    memset(debug, 0, sizeof(debug));
+    memset(testModes, 0, sizeof(testModes));
+    memset(testSlots, 0, sizeof(testSlots));
+}
+
+TEST(DebugChannelsTest, TestNothingConfigured)
+{
+    // given
+    resetChannels(DEBUG_NONE);
+
+    // when
+    debugInitChannels(testModes, testSlots);
+
+    // then
+    EXPECT_FALSE(debugChannelsActive());
+    EXPECT_FALSE(DEBUG_MODE_ACTIVE(DEBUG_RPM_FILTER));
+
+    DEBUG_SET(DEBUG_RPM_FILTER, 0, 42);
+    for (int i = 0; i < DEBUG_CHANNEL_COUNT; i++) {
+        EXPECT_EQ(0, debugChannel[i]);
+    }
+    EXPECT_EQ(0, debug[0]);
+}
+
+TEST(DebugChannelsTest, TestPairsGoToTheirChannel)
+{
+    // given
+    resetChannels(DEBUG_GYRO_SCALED);
+    testModes[0] = DEBUG_RPM_FILTER;
+    testSlots[0] = 2;
+    testModes[5] = DEBUG_BATTERY;
+    testSlots[5] = 1;
+
+    // when
+    debugInitChannels(testModes, testSlots);
+    DEBUG_SET(DEBUG_RPM_FILTER, 2, 1234);
+    DEBUG_SET(DEBUG_RPM_FILTER, 1, 99);     // not logged
+    DEBUG_SET(DEBUG_BATTERY, 1, -7);
+    DEBUG_SET(DEBUG_GYRO_SCALED, 3, 55);
+
+    // then
+    EXPECT_TRUE(debugChannelsActive());
+    EXPECT_EQ(1234, debugChannel[0]);
+    EXPECT_EQ(-7, debugChannel[5]);
+    for (int i = 1; i < DEBUG_CHANNEL_COUNT; i++) {
+        if (i != 5) {
+            EXPECT_EQ(0, debugChannel[i]);
+        }
+    }
+
+    // debug_mode itself still goes to debug[]
+    EXPECT_EQ(55, debug[3]);
+    EXPECT_EQ(0, debug[2]);
+
+    EXPECT_TRUE(DEBUG_MODE_ACTIVE(DEBUG_RPM_FILTER));
+    EXPECT_TRUE(DEBUG_MODE_ACTIVE(DEBUG_BATTERY));
+    EXPECT_TRUE(DEBUG_MODE_ACTIVE(DEBUG_GYRO_SCALED));
+    EXPECT_FALSE(DEBUG_MODE_ACTIVE(DEBUG_FFT));
+}
+
+TEST(DebugChannelsTest, TestInvalidPairsSkipped)
+{
+    // given
+    resetChannels(DEBUG_GYRO_SCALED);
+    testModes[0] = DEBUG_GYRO_SCALED;       // already in debug[]
+    testSlots[0] = 0;
+    testModes[1] = DEBUG_COUNT;             // no such mode
+    testSlots[1] = 0;
+    testModes[2] = DEBUG_BATTERY;           // no such slot
+    testSlots[2] = DEBUG16_VALUE_COUNT;
+
+    // when
+    debugInitChannels(testModes, testSlots);
+
+    // then
+    EXPECT_FALSE(debugChannelsActive());
+    EXPECT_FALSE(DEBUG_MODE_ACTIVE(DEBUG_BATTERY));
+
+    DEBUG_SET(DEBUG_GYRO_SCALED, 0, 11);
+    EXPECT_EQ(11, debug[0]);
+    EXPECT_EQ(0, debugChannel[0]);
+}
+
+TEST(DebugChannelsTest, TestDuplicatePairGoesToTheFirstChannel)
+{
+    // given
+    resetChannels(DEBUG_NONE);
+    testModes[3] = DEBUG_PIDLOOP;
+    testSlots[3] = 1;
+    testModes[6] = DEBUG_PIDLOOP;
+    testSlots[6] = 1;
+
+    // when
+    debugInitChannels(testModes, testSlots);
+    DEBUG_SET(DEBUG_PIDLOOP, 1, 300);
+
+    // then
+    EXPECT_EQ(300, debugChannel[3]);
+    EXPECT_EQ(0, debugChannel[6]);
+}
+
+TEST(DebugChannelsTest, TestReinitClearsChannels)
+{
+    // given
+    resetChannels(DEBUG_NONE);
+    testModes[0] = DEBUG_PIDLOOP;
+    debugInitChannels(testModes, testSlots);
+    DEBUG_SET(DEBUG_PIDLOOP, 0, 300);
+
+    // when
+    testModes[0] = DEBUG_NONE;
+    debugInitChannels(testModes, testSlots);
+
+    // then
+    EXPECT_FALSE(debugChannelsActive());
+    EXPECT_FALSE(DEBUG_MODE_ACTIVE(DEBUG_PIDLOOP));
+    EXPECT_EQ(0, debugChannel[0]);
+}
+
+// STUBS
+
+extern "C" {
+}
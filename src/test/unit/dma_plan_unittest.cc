@@ -0,0 +1,194 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/dma.h"
+    #include "drivers/dma_plan.h"
+    #include "drivers/dma_reqmap.h"
+    #include "drivers/resource.h"
+    #include "drivers/timer.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_STREAM_COUNT 8
+#define NO_STREAM 0
+
+// Stream identifiers 1..TEST_STREAM_COUNT, the references point into this array
+static uint8_t testStreams[TEST_STREAM_COUNT + 1];
+static dmaChannelSpec_t testSpecs[TEST_STREAM_COUNT + 1];
+
+// Stream of each option of ADC 1..2, UART RX 1..2 and the timer, NO_STREAM where the option doesn't exist
+static const uint8_t adcStreams[2][MAX_PERIPHERAL_DMA_OPTIONS] = { { 1, 2 }, { 1, NO_STREAM } };
+static const uint8_t uartRxStreams[2][MAX_PERIPHERAL_DMA_OPTIONS] = { { 3, 4 }, { 3, 5 } };
+static const uint8_t timerStreams[MAX_TIMER_DMA_OPTIONS] = { 3, 4, 6 };
+
+static TIM_TypeDef testTim;
+static const timerHardware_t testTimer = { .tim = &testTim, .channel = 1 };
+static TIM_TypeDef otherTim;
+static const timerHardware_t otherTimer = { .tim = &otherTim, .channel = 2 };
+
+static const dmaChannelSpec_t *testSpec(uint8_t stream)
+{
+    if (stream == NO_STREAM) {
+        return NULL;
+    }
+    testSpecs[stream].ref = (dmaResource_t *)&testStreams[stream];
+    return &testSpecs[stream];
+}
+
+static const dmaPlanRequest_t *findRequest(resourceOwner_e owner, uint8_t resourceIndex)
+{
+    const dmaPlanRequest_t *request;
+    for (unsigned i = 0; (request = dmaPlanGetRequest(i)); i++) {
+        if (request->owner.owner == owner && request->owner.resourceIndex == resourceIndex) {
+            return request;
+        }
+    }
+    return NULL;
+}
+
+// The plan is solved once per boot, so the tests share it and run in order
+
+TEST(DmaPlanTest, TestSolveByPriority)
+{
+    // given
+    // the LED strip timer asks for stream 3 first but has the lowest priority
+    dmaPlanAddTimer(OWNER_LED_STRIP, 0, &testTimer, 0, DMA_PLAN_PRIORITY_LOW);
+    // both UART RX want stream 3, the second moves to stream 5
+    dmaPlanAddPeripheral(OWNER_SERIAL_RX, 1, DMA_PERIPH_UART_RX, 0, 0, DMA_PLAN_PRIORITY_HIGH);
+    dmaPlanAddPeripheral(OWNER_SERIAL_RX, 2, DMA_PERIPH_UART_RX, 1, 0, DMA_PLAN_PRIORITY_HIGH);
+    // ADC 1 keeps stream 1, ADC 2 has no other option and loses DMA
+    dmaPlanAddPeripheral(OWNER_ADC, 1, DMA_PERIPH_ADC, 0, 0, DMA_PLAN_PRIORITY_HIGH);
+    dmaPlanAddPeripheral(OWNER_ADC, 2, DMA_PERIPH_ADC, 1, 0, DMA_PLAN_PRIORITY_NORMAL);
+    // not a DMA user
+    dmaPlanAddPeripheral(OWNER_SERIAL_TX, 1, DMA_PERIPH_UART_TX, 0, DMA_OPT_UNUSED, DMA_PLAN_PRIORITY_NORMAL);
+
+    // when
+    dmaPlanSolve();
+
+    // then
+    EXPECT_EQ(NULL, findRequest(OWNER_SERIAL_TX, 1));
+
+    const dmaPlanRequest_t *request = findRequest(OWNER_SERIAL_RX, 1);
+    ASSERT_NE((void *)NULL, request);
+    EXPECT_EQ(0, request->configured);
+    EXPECT_EQ(0, request->assigned);
+
+    request = findRequest(OWNER_SERIAL_RX, 2);
+    ASSERT_NE((void *)NULL, request);
+    EXPECT_EQ(0, request->configured);
+    EXPECT_EQ(1, request->assigned);
+
+    request = findRequest(OWNER_ADC, 1);
+    ASSERT_NE((void *)NULL, request);
+    EXPECT_EQ(0, request->assigned);
+
+    request = findRequest(OWNER_ADC, 2);
+    ASSERT_NE((void *)NULL, request);
+    EXPECT_EQ(DMA_OPT_UNUSED, request->assigned);
+
+    // stream 3 is taken by the time the timer is placed, it gets the first free alternative
+    request = findRequest(OWNER_LED_STRIP, 0);
+    ASSERT_NE((void *)NULL, request);
+    EXPECT_EQ(0, request->configured);
+    EXPECT_EQ(1, request->assigned);
+}
+
+TEST(DmaPlanTest, TestDriverLookup)
+{
+    // planned users get the planned option
+    EXPECT_EQ(1, dmaPlanPeripheralOption(DMA_PERIPH_UART_RX, 1, 0));
+    EXPECT_EQ(DMA_OPT_UNUSED, dmaPlanPeripheralOption(DMA_PERIPH_ADC, 1, 0));
+    EXPECT_EQ(1, dmaPlanTimerOption(&testTimer, 0));
+
+    // unplanned users keep their own option
+    EXPECT_EQ(1, dmaPlanPeripheralOption(DMA_PERIPH_UART_TX, 0, 1));
+    EXPECT_EQ(1, dmaPlanTimerOption(&otherTimer, 1));
+}
+
+TEST(DmaPlanTest, TestReservedStreams)
+{
+    EXPECT_TRUE(dmaPlanIsReserved((dmaIdentifier_e)1));
+    EXPECT_FALSE(dmaPlanIsReserved((dmaIdentifier_e)2));
+    EXPECT_TRUE(dmaPlanIsReserved((dmaIdentifier_e)3));
+    EXPECT_TRUE(dmaPlanIsReserved((dmaIdentifier_e)4));
+    EXPECT_TRUE(dmaPlanIsReserved((dmaIdentifier_e)5));
+    EXPECT_FALSE(dmaPlanIsReserved((dmaIdentifier_e)6));
+    EXPECT_FALSE(dmaPlanIsReserved((dmaIdentifier_e)7));
+}
+
+TEST(DmaPlanTest, TestNoRequestsAfterSolve)
+{
+    // given
+    const dmaPlanRequest_t *request;
+    unsigned count = 0;
+    while (dmaPlanGetRequest(count)) {
+        count++;
+    }
+
+    // when
+    dmaPlanAddPeripheral(OWNER_SERIAL_TX, 2, DMA_PERIPH_UART_TX, 1, 0, DMA_PLAN_PRIORITY_HIGH);
+
+    // then
+    request = dmaPlanGetRequest(count);
+    EXPECT_EQ(NULL, request);
+    EXPECT_EQ(0, dmaPlanPeripheralOption(DMA_PERIPH_UART_TX, 1, 0));
+}
+
+// STUBS
+
+extern "C" {
+    const dmaChannelSpec_t *dmaGetChannelSpecByPeripheral(dmaPeripheral_e device, uint8_t index, int8_t opt)
+    {
+        if (opt < 0 || opt >= MAX_PERIPHERAL_DMA_OPTIONS || index >= 2) {
+            return NULL;
+        }
+
+        switch (device) {
+        case DMA_PERIPH_ADC:
+            return testSpec(adcStreams[index][opt]);
+        case DMA_PERIPH_UART_RX:
+            return testSpec(uartRxStreams[index][opt]);
+        default:
+            return NULL;
+        }
+    }
+
+    const dmaChannelSpec_t *dmaGetChannelSpecByTimerValue(TIM_TypeDef *tim, uint8_t channel, dmaoptValue_t dmaopt)
+    {
+        if (tim != &testTim || channel != 1 || dmaopt < 0 || dmaopt >= MAX_TIMER_DMA_OPTIONS) {
+            return NULL;
+        }
+        return testSpec(timerStreams[dmaopt]);
+    }
+
+    dmaIdentifier_e dmaGetIdentifier(const dmaResource_t *stream)
+    {
+        return (dmaIdentifier_e)((const uint8_t *)stream - testStreams);
+    }
+}
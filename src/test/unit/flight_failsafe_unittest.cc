@@ -37,12 +37,16 @@ extern "C" {
     #include "fc/rc_controls.h"
 
     #include "flight/failsafe.h"
+    #include "flight/governor.h"
+    #include "flight/position.h"
 
     #include "io/beeper.h"
 
     #include "drivers/io.h"
     #include "rx/rx.h"
 
+    #include "sensors/sensors.h"
+
     extern boxBitmask_t rcModeActivationMask;
 }
 
@@ -73,6 +77,11 @@ void resetCallCounters(void) {
 
 uint32_t sysTickUptime;
 
+float headspeed;
+bool testSpooledUp;
+int32_t testAltitudeCm;
+bool testRxSignal;
+
 void configureFailsafe(void)
 {
     rxConfigMutable()->midrc = TEST_MID_RC;
@@ -539,11 +548,195 @@ TEST(FlightFailsafeTest, TestFailsafeNotActivatedWhenDisarmedAndRXLossIsDetected
     EXPECT_FALSE(isArmingDisabled());
 }
 
+/****************************************************************************************/
+TEST(FlightFailsafeTest, TestFailsafeHeliRecovery)
+{
+    // given
+    resetCallCounters();
+    configureFailsafe();
+    failsafeConfigMutable()->failsafe_procedure = FAILSAFE_PROCEDURE_HELI;
+    failsafeConfigMutable()->failsafe_heli_hold_time = 10;                  // 1 second
+    failsafeConfigMutable()->failsafe_heli_min_headspeed = 1000;
+    failsafeConfigMutable()->failsafe_heli_flare_alt = 3;
+    failsafeConfigMutable()->failsafe_heli_autorotation_collective = -100;
+    failsafeConfigMutable()->failsafe_heli_flare_collective = 300;
+    failsafeReset();
+    sensorsSet(SENSOR_ACC | SENSOR_BARO);
+
+    // and
+    testSpooledUp = true;
+    headspeed = 1500;
+    testAltitudeCm = 5000;
+    testRxSignal = true;
+    ENABLE_ARMING_FLAG(ARMED);
+    failsafeStartMonitoring();
+    throttleStatus = THROTTLE_HIGH;
+    failsafeOnValidDataReceived();
+
+    // when
+    failsafeHeliUpdate(0);
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI_NONE, failsafeHeliGetAction());
+    EXPECT_FLOAT_EQ(0.6f, failsafeHeliApplyThrottle(0.6f));                 // latches the last good commands
+    EXPECT_FLOAT_EQ(200, failsafeHeliApplyCollective(200));
+
+    // given
+    testRxSignal = false;
+    for (sysTickUptime = 0; sysTickUptime <= (uint32_t)(PERIOD_RXDATA_FAILURE + failsafeConfig()->failsafe_delay * MILLIS_PER_TENTH_SECOND); sysTickUptime++) {
+        failsafeOnValidDataFailed();
+        failsafeUpdateState();
+    }
+    sysTickUptime++;
+    failsafeOnValidDataFailed();
+    failsafeUpdateState();
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI, failsafePhase());
+    EXPECT_TRUE(failsafeIsActive());
+
+    // when
+    timeUs_t currentTimeUs = 1000000;
+    failsafeHeliUpdate(currentTimeUs);
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI_HOLD, failsafeHeliGetAction());
+    EXPECT_FALSE(failsafeIsLevelling());
+    EXPECT_FLOAT_EQ(0.6f, failsafeHeliApplyThrottle(0));
+    EXPECT_FLOAT_EQ(200, failsafeHeliApplyCollective(0));
+
+    // when
+    currentTimeUs += 1000000;
+    failsafeHeliUpdate(currentTimeUs);
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI_RESCUE, failsafeHeliGetAction());
+    EXPECT_TRUE(failsafeIsLevelling());
+    EXPECT_FLOAT_EQ(0.6f, failsafeHeliApplyThrottle(0));
+    EXPECT_FLOAT_EQ(150, failsafeHeliApplyCollective(150));                 // rescue collective
+
+    // when
+    headspeed = 500;
+    failsafeHeliUpdate(currentTimeUs);
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI_AUTOROTATE, failsafeHeliGetAction());
+    EXPECT_TRUE(failsafeIsLevelling());
+    EXPECT_FLOAT_EQ(0, failsafeHeliApplyThrottle(0.6f));
+    EXPECT_FLOAT_EQ(-100, failsafeHeliApplyCollective(150));
+
+    // when
+    headspeed = 1500;                                                       // no return to power
+    failsafeHeliUpdate(currentTimeUs);
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI_AUTOROTATE, failsafeHeliGetAction());
+
+    // when
+    testAltitudeCm = 200;
+    failsafeHeliUpdate(currentTimeUs);
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI_FLARE, failsafeHeliGetAction());
+    EXPECT_FLOAT_EQ(0, failsafeHeliApplyThrottle(0.6f));
+    EXPECT_FLOAT_EQ(300, failsafeHeliApplyCollective(150));
+
+    // when
+    testAltitudeCm = 1000;                                                  // flare is not undone
+    failsafeHeliUpdate(currentTimeUs);
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI_FLARE, failsafeHeliGetAction());
+
+    // when
+    DISABLE_ARMING_FLAG(ARMED);
+    failsafeUpdateState();
+    failsafeHeliUpdate(currentTimeUs);
+
+    // then
+    EXPECT_EQ(FAILSAFE_RX_LOSS_MONITORING, failsafePhase());
+    EXPECT_EQ(1, CALL_COUNTER(COUNTER_MW_DISARM));
+    EXPECT_EQ(FAILSAFE_HELI_NONE, failsafeHeliGetAction());
+}
+
+/****************************************************************************************/
+TEST(FlightFailsafeTest, TestFailsafeHeliLandingTime)
+{
+    // given
+    resetCallCounters();
+    configureFailsafe();                                                    // failsafe_off_delay of 5 seconds
+    failsafeConfigMutable()->failsafe_procedure = FAILSAFE_PROCEDURE_HELI;
+    failsafeConfigMutable()->failsafe_heli_hold_time = 10;                  // 1 second
+    failsafeConfigMutable()->failsafe_heli_min_headspeed = 1000;
+    failsafeConfigMutable()->failsafe_heli_flare_alt = 0;
+    failsafeConfigMutable()->failsafe_heli_landing_time = 10;               // 10 seconds
+    failsafeReset();
+    sensorsSet(SENSOR_ACC);
+
+    // and
+    testSpooledUp = true;
+    headspeed = 1500;
+    testRxSignal = false;
+    ENABLE_ARMING_FLAG(ARMED);
+    failsafeStartMonitoring();
+    throttleStatus = THROTTLE_HIGH;
+    failsafeOnValidDataReceived();
+
+    // when
+    for (sysTickUptime = 0; failsafePhase() != FAILSAFE_HELI; sysTickUptime++) {
+        failsafeOnValidDataFailed();
+        failsafeUpdateState();
+        failsafeHeliUpdate(sysTickUptime * 1000);
+    }
+    const uint32_t activatedAt = sysTickUptime;
+
+    // and
+    for (; sysTickUptime < activatedAt + 20 * MILLIS_PER_SECOND; sysTickUptime++) {   // past the off delay and the landing time
+        failsafeOnValidDataFailed();
+        failsafeUpdateState();
+        failsafeHeliUpdate(sysTickUptime * 1000);
+    }
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI, failsafePhase());                              // a powered rescue is not disarmed on time
+    EXPECT_EQ(FAILSAFE_HELI_RESCUE, failsafeHeliGetAction());
+    EXPECT_EQ(0, CALL_COUNTER(COUNTER_MW_DISARM));
+
+    // when
+    headspeed = 500;
+    failsafeHeliUpdate(sysTickUptime * 1000);
+    const uint32_t cutAt = sysTickUptime;
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI_AUTOROTATE, failsafeHeliGetAction());
+
+    // when
+    for (; sysTickUptime <= cutAt + 9 * MILLIS_PER_SECOND; sysTickUptime++) {   // landing time less the hold
+        failsafeOnValidDataFailed();
+        failsafeUpdateState();
+        failsafeHeliUpdate(sysTickUptime * 1000);
+    }
+
+    // then
+    EXPECT_EQ(FAILSAFE_HELI, failsafePhase());
+    EXPECT_EQ(0, CALL_COUNTER(COUNTER_MW_DISARM));
+
+    // when
+    sysTickUptime++;
+    failsafeOnValidDataFailed();
+    failsafeUpdateState();
+
+    // then
+    EXPECT_EQ(FAILSAFE_RX_LOSS_MONITORING, failsafePhase());
+    EXPECT_EQ(1, CALL_COUNTER(COUNTER_MW_DISARM));
+    EXPECT_TRUE(isArmingDisabled());
+}
+
 // STUBS
 
 extern "C" {
 int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
-float rcCommand[4];
+float rcCommand[5];
 int16_t debug[DEBUG16_VALUE_COUNT];
 bool isUsingSticksToArm = true;
 
@@ -597,4 +790,10 @@ bool areSticksActive(uint8_t stickPercentLimit) {
 void beeperConfirmationBeeps(uint8_t beepCount) { UNUSED(beepCount); }
 
 bool crashRecoveryModeActive(void) { return false; }
+
+uint8_t isHeliSpooledUp(void) { return testSpooledUp; }
+
+int32_t getEstimatedAltitudeCm(void) { return testAltitudeCm; }
+
+bool rxIsReceivingSignal(void) { return testRxSignal; }
 }
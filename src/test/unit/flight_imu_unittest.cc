@@ -199,6 +199,31 @@ TEST(FlightImuTest, TestSmallAngle)
     EXPECT_FALSE(isUpright());
 }
 
+TEST(FlightImuTest, TestGyroAttitudeUpdate)
+{
+    // given
+    targetPidLooptime = 1000;
+    imuConfigMutable()->gyro_update_hz = 500;
+    imuInit();
+    acc.isAccelUpdatedAtLeastOnce = true;
+    q = QUATERNION_INITIALIZE;
+
+    // when rolling at 45 deg/s for one second of 1kHz PID loops
+    gyro.gyroADCf[X] = 45;
+    gyro.gyroADCf[Y] = 0;
+    gyro.gyroADCf[Z] = 0;
+    for (int i = 0; i < 1000; i++) {
+        imuUpdateGyroAttitude();
+    }
+
+    // expect
+    EXPECT_NEAR(450, attitude.values.roll, 5);
+    EXPECT_EQ(0, attitude.values.pitch);
+
+    imuConfigMutable()->gyro_update_hz = 0;
+    imuInit();
+}
+
 // STUBS
 
 extern "C" {
@@ -221,6 +246,7 @@ uint16_t flightModeFlags;
 uint8_t armingFlags;
 
 pidProfile_t *currentPidProfile;
+uint32_t targetPidLooptime;
 
 uint16_t enableFlightMode(flightModeFlags_e mask)
 {
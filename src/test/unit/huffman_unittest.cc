@@ -546,6 +546,37 @@ TEST(HuffmanUnittest, TestHuffmanDecode)
     EXPECT_EQ(0x07, (int)outBuf[7]);
 }
 
+TEST(HuffmanUnittest, TestHuffmanTableTextIsPrefixFree)
+{
+    // a complete prefix code: the code space is used exactly, and no code is the start of another
+    uint32_t kraft = 0;
+    for (int i = 0; i < HUFFMAN_TABLE_SIZE; i++) {
+        const int len = huffmanTableText[i].codeLen;
+        ASSERT_GE(len, 1);
+        ASSERT_LE(len, 16);
+        EXPECT_EQ(0, huffmanTableText[i].code & (0xffff >> len));
+        kraft += 0x10000 >> len;
+        for (int j = 0; j < HUFFMAN_TABLE_SIZE; j++) {
+            if (i != j && huffmanTableText[j].codeLen >= len) {
+                EXPECT_NE(huffmanTableText[i].code >> (16 - len), huffmanTableText[j].code >> (16 - len));
+            }
+        }
+    }
+    EXPECT_EQ(0x10000U, kraft);
+}
+
+TEST(HuffmanUnittest, TestHuffmanTableTextCompressesNames)
+{
+    const char names[] = "ARM;ANGLE;HORIZON;HEADFREE;BEEPER;LEDLOW;OSD DISABLE;TELEMETRY;BLACKBOX;FAILSAFE;";
+    const int inLen = sizeof(names) - 1;
+
+    int textLen = huffmanEncodeBuf(outBuf, OUTBUF_LEN, (const uint8_t *)names, inLen, huffmanTableText);
+    int binaryLen = huffmanEncodeBuf(outBuf, OUTBUF_LEN, (const uint8_t *)names, inLen, huffmanTable);
+    EXPECT_GT(textLen, 0);
+    EXPECT_LT(textLen, inLen * 4 / 5);
+    EXPECT_LT(textLen, binaryLen);
+}
+
 // STUBS
 
 extern "C" {
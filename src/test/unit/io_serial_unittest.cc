@@ -41,6 +41,37 @@ extern "C" {
 #include "unittest_macros.h"
 #include "gtest/gtest.h"
 
+static uint16_t rxBufferSize[SERIAL_PORT_COUNT];
+static uint16_t txBufferSize[SERIAL_PORT_COUNT];
+static uint32_t bufferPoolFree;
+
+static void configureUartPorts(void)
+{
+    memset(rxBufferSize, 0, sizeof(rxBufferSize));
+    memset(txBufferSize, 0, sizeof(txBufferSize));
+
+    pgResetFn_serialConfig(serialConfigMutable());
+    serialConfigMutable()->buffer_ms = 20;
+
+    // UART1..UART4 have pins, UART4 has no function
+    for (int index = 0; index < 4; index++) {
+        serialPinConfigMutable()->ioTagTx[index] = 1;
+    }
+
+    serialPortConfig_t *portConfig = serialFindPortConfigurationMutable(SERIAL_PORT_USART1);
+    portConfig->functionMask = FUNCTION_MSP;
+    portConfig->msp_baudrateIndex = BAUD_115200;
+
+    portConfig = serialFindPortConfigurationMutable(SERIAL_PORT_USART2);
+    portConfig->functionMask = FUNCTION_RX_SERIAL;
+
+    portConfig = serialFindPortConfigurationMutable(SERIAL_PORT_USART3);
+    portConfig->functionMask = FUNCTION_BLACKBOX;
+    portConfig->blackbox_baudrateIndex = BAUD_115200;
+
+    serialFindPortConfigurationMutable(SERIAL_PORT_UART4)->functionMask = FUNCTION_NONE;
+}
+
 TEST(IoSerialTest, TestFindPortConfig)
 {
     // given
@@ -53,6 +84,45 @@ TEST(IoSerialTest, TestFindPortConfig)
     EXPECT_EQ(NULL, portConfig);
 }
 
+TEST(IoSerialTest, TestUartBufferSizes)
+{
+    // given
+    configureUartPorts();
+    bufferPoolFree = 10000;
+
+    // when
+    serialInit(false, SERIAL_PORT_NONE);
+
+    // then
+    EXPECT_EQ(230, rxBufferSize[UARTDEV_1]);        // 20ms at 115200
+    EXPECT_EQ(UART_TX_BUFFER_SIZE, txBufferSize[UARTDEV_1]);
+    EXPECT_EQ(2000, rxBufferSize[UARTDEV_2]);       // 20ms of CRSF at 1M
+    EXPECT_EQ(2000, txBufferSize[UARTDEV_2]);
+    EXPECT_EQ(UART_BUFFER_SIZE_MIN, rxBufferSize[UARTDEV_3]);
+    EXPECT_EQ(UART_TX_BUFFER_SIZE, txBufferSize[UARTDEV_3]);
+    EXPECT_EQ(0, rxBufferSize[UARTDEV_4]);          // no function, no buffers until opened
+    EXPECT_EQ(0, txBufferSize[UARTDEV_4]);
+}
+
+TEST(IoSerialTest, TestUartBufferSizesScaledToPool)
+{
+    // given
+    configureUartPorts();
+    bufferPoolFree = (230 + 256 + 2000 + 2000 + 32 + 256) / 2;
+
+    // when
+    serialInit(false, SERIAL_PORT_NONE);
+
+    // then
+    EXPECT_EQ(115, rxBufferSize[UARTDEV_1]);
+    EXPECT_EQ(128, txBufferSize[UARTDEV_1]);
+    EXPECT_EQ(1000, rxBufferSize[UARTDEV_2]);
+    EXPECT_EQ(1000, txBufferSize[UARTDEV_2]);
+    EXPECT_EQ(UART_BUFFER_SIZE_MIN, rxBufferSize[UARTDEV_3]);
+    EXPECT_EQ(128, txBufferSize[UARTDEV_3]);
+    EXPECT_EQ(0, rxBufferSize[UARTDEV_4]);
+}
+
 
 // STUBS
 extern "C" {
@@ -74,6 +144,14 @@ extern "C" {
       return NULL;
     }
 
+    bool uartAllocateBuffers(UARTDevice_e device, uint16_t rxSize, uint16_t txSize) {
+        rxBufferSize[device] = rxSize;
+        txBufferSize[device] = txSize;
+        return true;
+    }
+
+    uint32_t uartBufferPoolFree(void) { return bufferPoolFree; }
+
     serialPort_t *openSoftSerial(softSerialPortIndex_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {
       return NULL;
     }
@@ -417,6 +417,8 @@ extern "C" {
     bool featureIsEnabled(uint32_t) { return true; }
     void beeperConfirmationBeeps(uint8_t) {}
     bool isBeeperOn() { return false; }
+    bool schedulerTaskSliceExpired(void) { return false; }
+    void schedulerTaskContinue(void) { }
     uint8_t getCurrentPidProfileIndex() { return 0; }
     uint8_t getCurrentControlRateProfileIndex() { return 0; }
     batteryState_e getBatteryState() { return BATTERY_OK; }
@@ -452,6 +454,7 @@ extern "C" {
     bool isPPMDataBeingReceived(void) { return false; }
     bool isPWMDataBeingReceived(void) { return false; }
     void resetPPMDataReceivedState(void){ }
+    void ppmRxProcess(void) {}
     void failsafeOnValidDataReceived(void) { }
     void failsafeOnValidDataFailed(void) { }
 
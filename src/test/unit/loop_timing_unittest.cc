@@ -0,0 +1,300 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "fc/loop_timing.h"
+    #include "fc/runtime_config.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_LOOP_US    125
+
+static timeUs_t testTimeUs;
+
+static void armAndReset(void)
+{
+    loopTimingInit();
+    ENABLE_ARMING_FLAG(ARMED);
+    loopTimingOnArm();
+    testTimeUs = 0;
+}
+
+static void runLoops(int count, timeDelta_t pidTimeUs)
+{
+    for (int i = 0; i < count; i++) {
+        testTimeUs += TEST_LOOP_US;
+        loopTimingSample(testTimeUs, 1, pidTimeUs);
+    }
+}
+
+TEST(LoopTimingTest, NoSamplesNoPercentile)
+{
+    // given
+    armAndReset();
+
+    // when
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+
+    // then
+    EXPECT_EQ(0, flight.p99PidTimeUs);
+    EXPECT_EQ(0, flight.maxPidTimeUs);
+}
+
+TEST(LoopTimingTest, P99IgnoresTheSlowestPercent)
+{
+    // given
+    armAndReset();
+
+    // when
+    runLoops(990, 10);              // 8..12us bin
+    runLoops(10, 50);               // the slowest 1%
+
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+
+    // then
+    EXPECT_EQ(12, flight.p99PidTimeUs);
+    EXPECT_EQ(50, flight.maxPidTimeUs);
+}
+
+TEST(LoopTimingTest, P99IncludesMoreThanOnePercent)
+{
+    // given
+    armAndReset();
+
+    // when
+    runLoops(980, 10);
+    runLoops(20, 50);               // 48..52us bin
+
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+
+    // then
+    EXPECT_EQ(52, flight.p99PidTimeUs);
+}
+
+TEST(LoopTimingTest, P99BeyondTheHistogramIsTheMaximum)
+{
+    // given
+    armAndReset();
+
+    // when
+    runLoops(100, 300);
+    runLoops(1, 400);
+
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+
+    // then
+    EXPECT_EQ(400, flight.p99PidTimeUs);
+}
+
+TEST(LoopTimingTest, MaximaIncludeTheOpenWindow)
+{
+    // given
+    armAndReset();
+    runLoops(LOOP_TIMING_WINDOW_US / TEST_LOOP_US + 1, 20);
+
+    // when
+    runLoops(1, 90);                // less than a window before disarm
+
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+
+    // then
+    EXPECT_EQ(90, flight.maxPidTimeUs);
+}
+
+TEST(LoopTimingTest, NotSampledWhileDisarmed)
+{
+    // given
+    armAndReset();
+    DISABLE_ARMING_FLAG(ARMED);
+
+    // when
+    runLoops(100, 20);
+
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+
+    // then
+    EXPECT_EQ(0, flight.p99PidTimeUs);
+}
+
+// counts the queued events and drops them
+static int countEvents(void)
+{
+    int count = 0;
+    while (loopTimingPeekEvent()) {
+        loopTimingReleaseEvent();
+        count++;
+    }
+    return count;
+}
+
+TEST(LoopTimingTest, SummaryEveryWindow)
+{
+    // given
+    armAndReset();
+    runLoops(LOOP_TIMING_WINDOW_US / TEST_LOOP_US, 10);
+
+    // then
+    // the first sample opens the window, it is not over yet
+    EXPECT_EQ(NULL, loopTimingPeekEvent());
+
+    // when
+    testTimeUs += TEST_LOOP_US;
+    loopTimingSample(testTimeUs, 30, 40);
+
+    // then
+    const loopTimingEvent_t *event = loopTimingPeekEvent();
+    ASSERT_NE((void *)NULL, event);
+    EXPECT_EQ(LOOP_TIMING_EVENT_SUMMARY, event->type);
+    EXPECT_EQ(0, event->overruns);
+    EXPECT_EQ(1, event->avgLatencyUs);
+    EXPECT_EQ(30, event->maxLatencyUs);
+    EXPECT_EQ(10, event->avgPidTimeUs);
+    EXPECT_EQ(40, event->maxPidTimeUs);
+    loopTimingReleaseEvent();
+    EXPECT_EQ(NULL, loopTimingPeekEvent());
+
+    // when
+    // the next window starts over, again opened by its first sample
+    runLoops(LOOP_TIMING_WINDOW_US / TEST_LOOP_US + 1, 20);
+
+    // then
+    event = loopTimingPeekEvent();
+    ASSERT_NE((void *)NULL, event);
+    EXPECT_EQ(20, event->avgPidTimeUs);
+    EXPECT_EQ(20, event->maxPidTimeUs);
+    EXPECT_EQ(1, countEvents());
+}
+
+TEST(LoopTimingTest, OverrunEvents)
+{
+    // given
+    armAndReset();
+    runLoops(1, 10);
+
+    // when
+    loopTimingOverrun(TASK_SERIAL, 70000, -5);
+    loopTimingOverrun(TASK_RX, 20, 300);
+
+    // then
+    // the lateness and the task time are saturated to their fields
+    const loopTimingEvent_t *event = loopTimingPeekEvent();
+    ASSERT_NE((void *)NULL, event);
+    EXPECT_EQ(LOOP_TIMING_EVENT_OVERRUN, event->type);
+    EXPECT_EQ(TASK_SERIAL, event->taskId);
+    EXPECT_EQ(UINT16_MAX, event->lateUs);
+    EXPECT_EQ(0, event->taskTimeUs);
+    loopTimingReleaseEvent();
+
+    event = loopTimingPeekEvent();
+    ASSERT_NE((void *)NULL, event);
+    EXPECT_EQ(LOOP_TIMING_EVENT_OVERRUN, event->type);
+    EXPECT_EQ(TASK_RX, event->taskId);
+    EXPECT_EQ(20, event->lateUs);
+    EXPECT_EQ(300, event->taskTimeUs);
+    loopTimingReleaseEvent();
+
+    // when
+    runLoops(LOOP_TIMING_WINDOW_US / TEST_LOOP_US, 10);
+
+    // then
+    // the summary counts the overruns of its window
+    event = loopTimingPeekEvent();
+    ASSERT_NE((void *)NULL, event);
+    EXPECT_EQ(LOOP_TIMING_EVENT_SUMMARY, event->type);
+    EXPECT_EQ(2, event->overruns);
+
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+    EXPECT_EQ(2u, flight.overruns);
+}
+
+TEST(LoopTimingTest, FullQueueDropsEventsButCountsOverruns)
+{
+    // given
+    armAndReset();
+    runLoops(1, 10);
+
+    // when
+    for (int i = 0; i < LOOP_TIMING_EVENT_COUNT + 4; i++) {
+        loopTimingOverrun(TASK_SERIAL, 10, 10);
+    }
+
+    // then
+    EXPECT_EQ(LOOP_TIMING_EVENT_COUNT, countEvents());
+
+    // when
+    runLoops(LOOP_TIMING_WINDOW_US / TEST_LOOP_US, 10);
+
+    // then
+    const loopTimingEvent_t *event = loopTimingPeekEvent();
+    ASSERT_NE((void *)NULL, event);
+    EXPECT_EQ(LOOP_TIMING_EVENT_COUNT + 4, event->overruns);
+
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+    EXPECT_EQ((uint32_t)LOOP_TIMING_EVENT_COUNT + 4, flight.overruns);
+}
+
+TEST(LoopTimingTest, DropEvents)
+{
+    // given
+    armAndReset();
+    runLoops(1, 10);
+    loopTimingOverrun(TASK_SERIAL, 10, 10);
+    loopTimingOverrun(TASK_RX, 10, 10);
+
+    // when
+    loopTimingDropEvents();
+
+    // then
+    EXPECT_EQ(NULL, loopTimingPeekEvent());
+}
+
+TEST(LoopTimingTest, NoOverrunsWhileDisarmed)
+{
+    // given
+    armAndReset();
+    DISABLE_ARMING_FLAG(ARMED);
+
+    // when
+    loopTimingOverrun(TASK_SERIAL, 10, 10);
+
+    // then
+    EXPECT_EQ(NULL, loopTimingPeekEvent());
+
+    loopTimingFlight_t flight;
+    loopTimingGetFlight(&flight);
+    EXPECT_EQ(0u, flight.overruns);
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t armingFlags;
+}
@@ -225,6 +225,32 @@ TEST(MathsUnittest, TestRotateVectorAroundAxis)
     expectVectorsAreEqual(&vector, &expected_result, 1e-5);
 }
 
+TEST(MathsUnittest, TestDevMerge)
+{
+    stdev_t all, first, second;
+    devClear(&all);
+    devClear(&first);
+    devClear(&second);
+
+    for (int i = 0; i < 100; i++) {
+        const float x = 10.0f + (i % 7) - 0.5f * (i % 3);
+        devPush(&all, x);
+        devPush(i < 30 ? &first : &second, x);
+    }
+    devMerge(&first, &second);
+
+    EXPECT_EQ(all.m_n, first.m_n);
+    EXPECT_NEAR(all.m_newM, first.m_newM, 1e-5);
+    EXPECT_NEAR(devVariance(&all), devVariance(&first), 1e-4);
+
+    // merging into an empty one copies
+    stdev_t empty;
+    devClear(&empty);
+    devMerge(&empty, &all);
+    EXPECT_EQ(all.m_n, empty.m_n);
+    EXPECT_FLOAT_EQ(devVariance(&all), devVariance(&empty));
+}
+
 #if defined(FAST_MATH) || defined(VERY_FAST_MATH)
 TEST(MathsUnittest, TestFastTrigonometrySinCos)
 {
@@ -247,6 +273,21 @@ TEST(MathsUnittest, TestFastTrigonometrySinCos)
     EXPECT_LE(cosError, 3.5e-6);
 }
 
+TEST(MathsUnittest, TestFastTrigonometrySinCosPair)
+{
+    double sinError = 0;
+    double cosError = 0;
+    for (float x = -10 * M_PI; x < 10 * M_PI; x += M_PI / 300) {
+        float sinResult, cosResult;
+        sin_cos_approx(x, &sinResult, &cosResult);
+        sinError = MAX(sinError, fabs(sinResult - sinf(x)));
+        cosError = MAX(cosError, fabs(cosResult - cosf(x)));
+    }
+    printf("sin_cos_approx maximum absolute error = %e, %e\n", sinError, cosError);
+    EXPECT_LE(sinError, 3e-6);
+    EXPECT_LE(cosError, 3.5e-6);
+}
+
 TEST(MathsUnittest, TestFastTrigonometryATan2)
 {
     double error = 0;
@@ -272,4 +313,14 @@ TEST(MathsUnittest, TestFastTrigonometryACos)
     printf("acos_approx maximum absolute error = %e rads (%e degree)\n", error, error / M_PI * 180.0f);
     EXPECT_LE(error, 1e-4);
 }
+
+TEST(MathsUnittest, TestInvSqrt)
+{
+    double error = 0;
+    for (float x = 0.01f; x < 100.0f; x *= 1.01f) {
+        error = MAX(error, fabs(invSqrt(x) * sqrt(x) - 1.0));
+    }
+    printf("invSqrt maximum relative error = %e\n", error);
+    EXPECT_LE(error, 1e-6);
+}
 #endif
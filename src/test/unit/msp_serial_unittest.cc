@@ -0,0 +1,329 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/huffman.h"
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+    #include "drivers/system.h"
+
+    #include "io/serial.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_protocol.h"
+    #include "msp/msp_serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    PG_REGISTER(serialConfig_t, serialConfig, PG_SERIAL_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SERIAL_BUFFER_SIZE 512
+
+static serialPort_t serialTestPort;
+static serialPortConfig_t serialTestPortConfig;
+
+static uint8_t serialRxBuffer[SERIAL_BUFFER_SIZE];
+static int serialRxLen;
+static int serialRxPos;
+
+static uint8_t serialTxBuffer[SERIAL_BUFFER_SIZE];
+static int serialTxLen;
+
+static uint8_t replyData[MSP_PORT_OUTBUF_SIZE];
+static int replyDataLen;
+
+static mspResult_e testProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(srcDesc);
+    UNUSED(mspPostProcessFn);
+
+    reply->cmd = cmd->cmd;
+    sbufWriteData(&reply->buf, replyData, replyDataLen);
+    return MSP_RESULT_ACK;
+}
+
+static void sendRequestV2(uint8_t flags, uint16_t cmd)
+{
+    const uint8_t header[] = { flags, (uint8_t)(cmd & 0xff), (uint8_t)(cmd >> 8), 0, 0 };
+
+    serialRxLen = 0;
+    serialRxPos = 0;
+    serialRxBuffer[serialRxLen++] = '$';
+    serialRxBuffer[serialRxLen++] = 'X';
+    serialRxBuffer[serialRxLen++] = '<';
+    memcpy(&serialRxBuffer[serialRxLen], header, sizeof(header));
+    serialRxLen += sizeof(header);
+    serialRxBuffer[serialRxLen++] = crc8_dvb_s2_update(0, header, sizeof(header));
+
+    serialTxLen = 0;
+    mspSerialProcess(MSP_SKIP_NON_MSP_DATA, testProcessCommand, NULL);
+}
+
+// returns the reply payload of the MSP v2 frame in serialTxBuffer, after checking its header and checksum
+static const uint8_t *receiveReplyV2(uint16_t cmd, uint8_t *flags, int *size)
+{
+    EXPECT_GE(serialTxLen, 9);
+    EXPECT_EQ('$', serialTxBuffer[0]);
+    EXPECT_EQ('X', serialTxBuffer[1]);
+    EXPECT_EQ('>', serialTxBuffer[2]);
+
+    const uint8_t *header = &serialTxBuffer[3];
+    *flags = header[0];
+    EXPECT_EQ(cmd, header[1] | (header[2] << 8));
+    *size = header[3] | (header[4] << 8);
+    EXPECT_EQ(serialTxLen, 3 + 5 + *size + 1);
+    EXPECT_EQ(crc8_dvb_s2_update(0, header, 5 + *size), serialTxBuffer[serialTxLen - 1]);
+
+    return header + 5;
+}
+
+// decodes inLen bytes of huffman code without an EOF symbol into outLen bytes
+static bool huffmanDecodeTable(uint8_t *out, int outLen, const uint8_t *in, int inLen, const huffmanTable_t *table)
+{
+    int inBit = 0;
+    for (int outCount = 0; outCount < outLen; outCount++) {
+        uint16_t code = 0;
+        int codeLen = 0;
+        int value = -1;
+        while (value < 0) {
+            if (inBit >= inLen * 8 || codeLen == 16) {
+                return false;
+            }
+            code |= ((in[inBit / 8] >> (7 - inBit % 8)) & 0x01) << (15 - codeLen);
+            ++inBit;
+            ++codeLen;
+            for (int i = 0; i < HUFFMAN_TABLE_SIZE; i++) {
+                if (table[i].codeLen == codeLen && table[i].code == code) {
+                    value = i;
+                    break;
+                }
+            }
+        }
+        if (value == HUFFMAN_TABLE_SIZE - 1) {
+            // the EOF symbol isn't sent
+            return false;
+        }
+        out[outCount] = value;
+    }
+    return true;
+}
+
+static void setupPort(void)
+{
+    memset(&serialTestPort, 0, sizeof(serialTestPort));
+    serialTestPort.identifier = SERIAL_PORT_USART1;
+    mspSerialInit();
+}
+
+TEST(MspSerialTest, TestCompressedReplyRoundTrip)
+{
+    // given
+    setupPort();
+    const char names[] = "ARM;ANGLE;HORIZON;HEADFREE;BEEPER;LEDLOW;OSD DISABLE;TELEMETRY;BLACKBOX;FAILSAFE;"
+        "AIR MODE;FPV ANGLE MIX;BLACKBOX ERASE;CAMERA CONTROL 1;FLIP OVER AFTER CRASH;PREARM;";
+    replyDataLen = sizeof(names) - 1;
+    memcpy(replyData, names, replyDataLen);
+
+    // when
+    sendRequestV2(MSP_FLAG_COMPRESSION, MSP_BOXNAMES);
+
+    // then
+    uint8_t flags;
+    int size;
+    const uint8_t *payload = receiveReplyV2(MSP_BOXNAMES, &flags, &size);
+    EXPECT_TRUE(flags & MSP_FLAG_COMPRESSION);
+    EXPECT_LT(size, replyDataLen);
+
+    ASSERT_GE(size, 3);
+    EXPECT_EQ(HUFFMAN_TABLE_TEXT, payload[0]);
+    const int uncompressedSize = payload[1] | (payload[2] << 8);
+    EXPECT_EQ(replyDataLen, uncompressedSize);
+
+    uint8_t decoded[MSP_PORT_OUTBUF_SIZE];
+    EXPECT_TRUE(huffmanDecodeTable(decoded, uncompressedSize, payload + 3, size - 3, huffmanTableText));
+    EXPECT_EQ(0, memcmp(decoded, names, replyDataLen));
+}
+
+TEST(MspSerialTest, TestCompressedBinaryReplyRoundTrip)
+{
+    // given
+    setupPort();
+    replyDataLen = 120;
+    for (int i = 0; i < replyDataLen; i++) {
+        replyData[i] = (i % 8 == 0) ? i : 0;
+    }
+
+    // when
+    sendRequestV2(MSP_FLAG_COMPRESSION, MSP_MOTOR);
+
+    // then
+    uint8_t flags;
+    int size;
+    const uint8_t *payload = receiveReplyV2(MSP_MOTOR, &flags, &size);
+    EXPECT_TRUE(flags & MSP_FLAG_COMPRESSION);
+    ASSERT_GE(size, 3);
+    EXPECT_EQ(HUFFMAN_TABLE_BINARY, payload[0]);
+    EXPECT_EQ(replyDataLen, payload[1] | (payload[2] << 8));
+
+    uint8_t decoded[MSP_PORT_OUTBUF_SIZE];
+    EXPECT_TRUE(huffmanDecodeTable(decoded, replyDataLen, payload + 3, size - 3, huffmanTable));
+    EXPECT_EQ(0, memcmp(decoded, replyData, replyDataLen));
+}
+
+TEST(MspSerialTest, TestReplyIsPlainWithoutCompressionFlag)
+{
+    // given
+    setupPort();
+    const char names[] = "ARM;ANGLE;HORIZON;HEADFREE;BEEPER;LEDLOW;OSD DISABLE;TELEMETRY;BLACKBOX;FAILSAFE;";
+    replyDataLen = sizeof(names) - 1;
+    memcpy(replyData, names, replyDataLen);
+
+    // when
+    sendRequestV2(0, MSP_BOXNAMES);
+
+    // then
+    uint8_t flags;
+    int size;
+    const uint8_t *payload = receiveReplyV2(MSP_BOXNAMES, &flags, &size);
+    EXPECT_FALSE(flags & MSP_FLAG_COMPRESSION);
+    EXPECT_EQ(replyDataLen, size);
+    EXPECT_EQ(0, memcmp(payload, names, replyDataLen));
+}
+
+TEST(MspSerialTest, TestIncompressibleReplyIsPlain)
+{
+    // given
+    setupPort();
+    replyDataLen = 100;
+    for (int i = 0; i < replyDataLen; i++) {
+        // bytes with long codes in the default table
+        replyData[i] = 0x80 + (i * 37) % 0x7f;
+    }
+
+    // when
+    sendRequestV2(MSP_FLAG_COMPRESSION, MSP_MOTOR);
+
+    // then
+    uint8_t flags;
+    int size;
+    const uint8_t *payload = receiveReplyV2(MSP_MOTOR, &flags, &size);
+    EXPECT_FALSE(flags & MSP_FLAG_COMPRESSION);
+    EXPECT_EQ(replyDataLen, size);
+    EXPECT_EQ(0, memcmp(payload, replyData, replyDataLen));
+}
+
+// STUBS
+
+extern "C" {
+    const uint32_t baudRates[] = {0, 9600, 19200, 38400, 57600, 115200, 230400, 250000,
+            400000, 460800, 500000, 921600, 1000000, 1500000, 2000000, 2470000}; // see baudRate_e
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
+    {
+        UNUSED(function);
+        return &serialTestPortConfig;
+    }
+
+    const serialPortConfig_t *findNextSerialPortConfig(serialPortFunction_e function)
+    {
+        UNUSED(function);
+        return NULL;
+    }
+
+    serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function,
+        serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baudRate, portMode_e mode, portOptions_e options)
+    {
+        UNUSED(identifier);
+        UNUSED(function);
+        UNUSED(rxCallback);
+        UNUSED(rxCallbackData);
+        UNUSED(baudRate);
+        UNUSED(mode);
+        UNUSED(options);
+        return &serialTestPort;
+    }
+
+    void closeSerialPort(serialPort_t *serialPort) { UNUSED(serialPort); }
+
+    bool isSerialPortShared(const serialPortConfig_t *portConfig, uint16_t functionMask, serialPortFunction_e sharedWithFunction)
+    {
+        UNUSED(portConfig);
+        UNUSED(functionMask);
+        UNUSED(sharedWithFunction);
+        return false;
+    }
+
+    uint32_t serialRxBytesWaiting(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return serialRxLen - serialRxPos;
+    }
+
+    uint8_t serialRead(serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return serialRxBuffer[serialRxPos++];
+    }
+
+    bool isSerialTransmitBufferEmpty(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return true;
+    }
+
+    uint32_t serialTxBytesFree(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return SERIAL_BUFFER_SIZE - serialTxLen;
+    }
+
+    void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+    {
+        UNUSED(instance);
+        memcpy(&serialTxBuffer[serialTxLen], data, count);
+        serialTxLen += count;
+    }
+
+    void serialBeginWrite(serialPort_t *instance) { UNUSED(instance); }
+    void serialEndWrite(serialPort_t *instance) { UNUSED(instance); }
+    void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort) { UNUSED(serialPort); }
+
+    mspDescriptor_t mspDescriptorAlloc(void) { return 0; }
+
+    uint32_t millis(void) { return 0; }
+
+    void cliEnter(serialPort_t *serialPort) { UNUSED(serialPort); }
+
+    void systemResetToBootloader(bootloaderRequestType_e requestType) { UNUSED(requestType); }
+}
@@ -1154,6 +1154,12 @@ extern "C" {
         return micros() / 1000;
     }
 
+    bool schedulerTaskSliceExpired(void) {
+        return false;
+    }
+
+    void schedulerTaskContinue(void) { }
+
     bool isBeeperOn() {
         return false;
     }
@@ -84,6 +84,31 @@ TEST(ParameterGroupsfTest, Test_pgFind)
     EXPECT_EQ(400, motorConfig3.dev.motorPwmRate);
 }
 
+TEST(ParameterGroupsfTest, Test_pgLoad)
+{
+    const pgRegistry_t *pgRegistry = pgFind(PG_MOTOR_CONFIG);
+
+    // a record covering the whole group is taken as stored
+    motorConfig_t motorConfig2;
+    memset(&motorConfig2, 0, sizeof(motorConfig_t));
+    motorConfig2.minthrottle = 1100;
+    EXPECT_TRUE(pgLoad(pgRegistry, &motorConfig2, sizeof(motorConfig_t), 1));
+    EXPECT_EQ(1100, motorConfig()->minthrottle);
+    EXPECT_EQ(0, motorConfig()->maxthrottle);
+
+    // a shorter record keeps the defaults for the rest of the group
+    motorConfig2.dev.motorPwmRate = 480;
+    EXPECT_TRUE(pgLoad(pgRegistry, &motorConfig2, offsetof(motorConfig_t, maxthrottle), 1));
+    EXPECT_EQ(1100, motorConfig()->minthrottle);
+    EXPECT_EQ(1850, motorConfig()->maxthrottle);
+    EXPECT_EQ(480, motorConfig()->dev.motorPwmRate);
+
+    // a record of another version is ignored
+    EXPECT_FALSE(pgLoad(pgRegistry, &motorConfig2, sizeof(motorConfig_t), 0));
+    EXPECT_EQ(1150, motorConfig()->minthrottle);
+    EXPECT_EQ(400, motorConfig()->dev.motorPwmRate);
+}
+
 // STUBS
 
 extern "C" {
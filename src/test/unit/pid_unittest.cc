@@ -74,6 +74,9 @@ extern "C" {
     void systemBeep(bool) { }
     bool gyroOverflowDetected(void) { return false; }
     float getRcDeflection(int axis) { return simulatedRcDeflection[axis]; }
+    float getCosTiltAngle(void) { return 1.0f; }
+    void getUpVector(float *up) { up[0] = 0; up[1] = 0; up[2] = 1; }
+    float failsafeHeliApplyCollective(float collective) { return collective; }
     void beeperConfirmationBeeps(uint8_t) { }
     void disarm(void) { }
     float applyFFLimit(int axis, float value, float Kp, float currentPidSetpoint) {
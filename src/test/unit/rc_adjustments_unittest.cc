@@ -0,0 +1,189 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <limits.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "config/config.h"
+
+    #include "fc/controlrate_profile.h"
+    #include "fc/rc.h"
+    #include "fc/rc_adjustments.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/battery.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static controlRateConfig_t controlRateProfile;
+static pidProfile_t pidProfile;
+
+static int pidInitGainCalls;
+static int pidInitGainAxis[2];
+static pidGain_e pidInitGainGain[2];
+
+static void configureAdjustment(adjustmentFunction_e adjustmentFunction)
+{
+    pgResetAll();
+    memset(&pidProfile, 0, sizeof(pidProfile));
+    currentPidProfile = &pidProfile;
+    pidInitGainCalls = 0;
+
+    controlRateProfile.rates_type = RATES_TYPE_BETAFLIGHT;
+    controlRateProfile.thrMid8 = 50;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        controlRateProfile.rcRates[axis] = 100;
+        controlRateProfile.rcExpo[axis] = 0;
+        controlRateProfile.rates[axis] = 70;
+    }
+    currentControlRateProfile = &controlRateProfile;
+    initRcProcessing();
+
+    // AUX2 sets the setting directly, 0..100 over the stick travel
+    adjustmentRange_t *range = adjustmentRangesMutable(0);
+    range->auxChannelIndex = 0;
+    range->range.startStep = MIN_MODE_RANGE_STEP;
+    range->range.endStep = MAX_MODE_RANGE_STEP;
+    range->adjustmentConfig = adjustmentFunction;
+    range->auxSwitchChannelIndex = 1;
+    range->adjustmentCenter = 50;
+    range->adjustmentScale = 50;
+    activeAdjustmentRangeReset();
+
+    for (int i = 0; i < MAX_SUPPORTED_RC_CHANNEL_COUNT; i++) {
+        rcData[i] = PWM_RANGE_MIDDLE;
+    }
+}
+
+TEST(RcAdjustmentsTest, ExpoAdjustmentRebuildsRateCurve)
+{
+    // given
+    configureAdjustment(ADJUSTMENT_RC_EXPO);
+    const float linearRate = applyCurve(FD_ROLL, 0.5f);
+
+    // when
+    rcData[NON_AUX_CHANNEL_COUNT + 1] = PWM_RANGE_MAX;
+    processRcAdjustments(currentControlRateProfile);
+
+    // then
+    EXPECT_EQ(100, controlRateProfile.rcExpo[FD_ROLL]);
+    EXPECT_EQ(100, controlRateProfile.rcExpo[FD_PITCH]);
+    const float adjustedRate = applyCurve(FD_ROLL, 0.5f);
+    EXPECT_LT(adjustedRate, linearRate);
+
+    // and the curve is the one a full rebuild gives for the new expo
+    initRcProcessing();
+    EXPECT_FLOAT_EQ(applyCurve(FD_ROLL, 0.5f), adjustedRate);
+    EXPECT_FLOAT_EQ(adjustedRate, applyCurve(FD_PITCH, 0.5f));
+    EXPECT_FLOAT_EQ(linearRate, applyCurve(FD_YAW, 0.5f));
+}
+
+TEST(RcAdjustmentsTest, GainAdjustmentRefreshesOnlyItsGains)
+{
+    // given
+    configureAdjustment(ADJUSTMENT_PITCH_ROLL_I);
+
+    // when
+    rcData[NON_AUX_CHANNEL_COUNT + 1] = PWM_RANGE_MAX;
+    processRcAdjustments(currentControlRateProfile);
+
+    // then
+    EXPECT_EQ(100, pidProfile.pid[PID_PITCH].I);
+    EXPECT_EQ(100, pidProfile.pid[PID_ROLL].I);
+    EXPECT_EQ(0, pidProfile.pid[PID_YAW].I);
+
+    // and each gain is refreshed through pidInitGain(), which keeps the headspeed schedule
+    ASSERT_EQ(2, pidInitGainCalls);
+    EXPECT_EQ(PID_PITCH, pidInitGainAxis[0]);
+    EXPECT_EQ(PID_GAIN_I, pidInitGainGain[0]);
+    EXPECT_EQ(PID_ROLL, pidInitGainAxis[1]);
+    EXPECT_EQ(PID_GAIN_I, pidInitGainGain[1]);
+}
+
+// STUBS
+
+extern "C" {
+PG_REGISTER(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 0);
+PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+PG_REGISTER(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+PG_REGISTER(rcControlsConfig_t, rcControlsConfig, PG_RC_CONTROLS_CONFIG, 0);
+PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+PG_REGISTER(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 0);
+
+uint8_t debugMode;
+int16_t debug[DEBUG16_VALUE_COUNT];
+int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+float rcCommand[5];
+bool isRXDataNew;
+uint32_t targetPidLooptime = 500;
+controlRateConfig_t *currentControlRateProfile;
+pidProfile_t *currentPidProfile;
+
+bool rxIsReceivingSignal(void) { return true; }
+uint16_t rxGetRefreshRate(void) { return 20000; }
+uint32_t millis(void) { return 0; }
+uint32_t micros(void) { return 0; }
+bool featureIsEnabled(uint32_t) { return false; }
+bool failsafeIsActive(void) { return false; }
+void beeperConfirmationBeeps(uint8_t) { }
+void blackboxLogEvent(FlightLogEvent, union flightLogEventData_u *) { }
+void setConfigDirty(void) { }
+void changeControlRateProfile(uint8_t) { }
+uint8_t getCurrentControlRateProfileIndex(void) { return 0; }
+uint8_t getLedProfile(void) { return 0; }
+void setLedProfile(uint8_t) { }
+const lowVoltageCutoff_t *getLowVoltageCutoff(void) { static lowVoltageCutoff_t lvc; return &lvc; }
+void imuQuaternionHeadfreeTransformVectorEarthToBody(t_fp_vector_def *) { }
+float rescueGetCollective(void) { return 0; }
+void pidInitGain(const pidProfile_t *, int axis, pidGain_e gain)
+{
+    if (pidInitGainCalls < 2) {
+        pidInitGainAxis[pidInitGainCalls] = axis;
+        pidInitGainGain[pidInitGainCalls] = gain;
+    }
+    pidInitGainCalls++;
+}
+void pidInitFeedForwardTransition(const pidProfile_t *) { }
+void pidInitLevelGains(const pidProfile_t *) { }
+void governorInitGains(void) { }
+void tailMotorInitGains(void) { }
+}
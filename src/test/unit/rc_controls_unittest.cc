@@ -43,6 +43,7 @@ extern "C" {
 
     #include "rx/rx.h"
 
+    #include "flight/mixer.h"
     #include "flight/pid.h"
 
     #include "config/config.h"
@@ -191,6 +192,89 @@ TEST_F(RcControlsModesTest, updateActivatedModesUsingValidAuxConfigurationAndRXV
     }
 }
 
+TEST_F(RcControlsModesTest, updateActivatedModesWithAndOrAndLinkedConditions)
+{
+    // given
+    memset(modeActivationConditionsMutable(0), 0, sizeof(modeActivationCondition_t) * MAX_MODE_ACTIVATION_CONDITION_COUNT);
+
+    // BOXANGLE: OR of AUX1 high and AUX2 high
+    modeActivationConditionsMutable(0)->modeId = BOXANGLE;
+    modeActivationConditionsMutable(0)->auxChannelIndex = AUX1 - NON_AUX_CHANNEL_COUNT;
+    modeActivationConditionsMutable(0)->range.startStep = CHANNEL_VALUE_TO_STEP(1700);
+    modeActivationConditionsMutable(0)->range.endStep = CHANNEL_VALUE_TO_STEP(2100);
+    modeActivationConditionsMutable(1)->modeId = BOXANGLE;
+    modeActivationConditionsMutable(1)->auxChannelIndex = AUX2 - NON_AUX_CHANNEL_COUNT;
+    modeActivationConditionsMutable(1)->range.startStep = CHANNEL_VALUE_TO_STEP(1700);
+    modeActivationConditionsMutable(1)->range.endStep = CHANNEL_VALUE_TO_STEP(2100);
+
+    // BOXHORIZON: AND of AUX1 mid-high and AUX3 low, on overlapping ranges of AUX1
+    modeActivationConditionsMutable(2)->modeId = BOXHORIZON;
+    modeActivationConditionsMutable(2)->auxChannelIndex = AUX1 - NON_AUX_CHANNEL_COUNT;
+    modeActivationConditionsMutable(2)->range.startStep = CHANNEL_VALUE_TO_STEP(1400);
+    modeActivationConditionsMutable(2)->range.endStep = CHANNEL_VALUE_TO_STEP(1900);
+    modeActivationConditionsMutable(2)->modeLogic = MODELOGIC_AND;
+    modeActivationConditionsMutable(3)->modeId = BOXHORIZON;
+    modeActivationConditionsMutable(3)->auxChannelIndex = AUX3 - NON_AUX_CHANNEL_COUNT;
+    modeActivationConditionsMutable(3)->range.startStep = CHANNEL_VALUE_TO_STEP(900);
+    modeActivationConditionsMutable(3)->range.endStep = CHANNEL_VALUE_TO_STEP(1300);
+    modeActivationConditionsMutable(3)->modeLogic = MODELOGIC_AND;
+
+    // BOX3D follows BOXHORIZON
+    modeActivationConditionsMutable(4)->modeId = BOX3D;
+    modeActivationConditionsMutable(4)->linkedTo = BOXHORIZON;
+
+    boxBitmask_t mask;
+    memset(&mask, 0, sizeof(mask));
+    rcModeUpdate(&mask);
+
+    for (int index = AUX1; index < MAX_SUPPORTED_RC_CHANNEL_COUNT; index++) {
+        rcData[index] = PWM_RANGE_MIN;
+    }
+
+    analyzeModeActivationConditions();
+
+    // when, then
+    updateActivatedModes();
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOXANGLE));
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOXHORIZON));
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOX3D));
+    EXPECT_FALSE(RC_MODE_FLAG(RC_MODE_FLAG_3D));
+
+    rcData[AUX2] = 1800;
+    updateActivatedModes();
+    EXPECT_TRUE(IS_RC_MODE_ACTIVE(BOXANGLE));
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOXHORIZON));
+
+    rcData[AUX1] = 1500;
+    updateActivatedModes();
+    EXPECT_TRUE(IS_RC_MODE_ACTIVE(BOXANGLE));
+    EXPECT_TRUE(IS_RC_MODE_ACTIVE(BOXHORIZON));
+    EXPECT_TRUE(IS_RC_MODE_ACTIVE(BOX3D));
+    EXPECT_TRUE(RC_MODE_FLAG(RC_MODE_FLAG_3D));
+
+    rcData[AUX2] = 1500;
+    rcData[AUX1] = 1800;
+    updateActivatedModes();
+    EXPECT_TRUE(IS_RC_MODE_ACTIVE(BOXANGLE));
+    EXPECT_TRUE(IS_RC_MODE_ACTIVE(BOXHORIZON));
+
+    rcData[AUX1] = 1950;
+    updateActivatedModes();
+    EXPECT_TRUE(IS_RC_MODE_ACTIVE(BOXANGLE));
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOXHORIZON));
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOX3D));
+
+    rcData[AUX1] = 1500;
+    rcData[AUX3] = 1500;
+    updateActivatedModes();
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOXANGLE));
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOXHORIZON));
+    EXPECT_FALSE(IS_RC_MODE_ACTIVE(BOX3D));
+
+    memset(modeActivationConditionsMutable(0), 0, sizeof(modeActivationCondition_t) * MAX_MODE_ACTIVATION_CONDITION_COUNT);
+    analyzeModeActivationConditions();
+}
+
 enum {
     COUNTER_QUEUE_CONFIRMATION_BEEP,
     COUNTER_CHANGE_CONTROL_RATE_PROFILE
@@ -610,6 +694,11 @@ void saveConfigAndNotify(void) {}
 void initRcProcessing(void) {}
 void changePidProfile(uint8_t) {}
 void pidInitConfig(const pidProfile_t *) {}
+void pidInitGain(const pidProfile_t *, int, pidGain_e) {}
+void pidInitFeedForwardTransition(const pidProfile_t *) {}
+void pidInitLevelGains(const pidProfile_t *) {}
+void governorInitGains(void) {}
+void tailMotorInitGains(void) {}
 void accStartCalibration(void) {}
 void gyroStartCalibration(bool isFirstArmingCalibration)
 {
@@ -643,6 +732,7 @@ pidProfile_t *currentPidProfile;
 rxRuntimeState_t rxRuntimeState;
 PG_REGISTER(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 0);
 PG_REGISTER(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 2);
+PG_REGISTER(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
 void resetArmingDisabled(void) {}
 timeDelta_t getTaskDeltaTime(cfTaskId_e) { return 20000; }
 armingDisableFlags_e getArmingDisableFlags(void) {
@@ -45,15 +45,16 @@ extern "C" {
 
     void crsfDataReceive(uint16_t c);
     uint8_t crsfFrameCRC(void);
-    uint8_t crsfFrameStatus(void);
+    uint8_t crsfFrameStatus(rxRuntimeState_t *rxRuntimeState);
     uint16_t crsfReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t chan);
 
     extern bool crsfFrameDone;
     extern crsfFrame_t crsfFrame;
     extern crsfFrame_t crsfChannelDataFrame;
-    extern uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
+    extern uint16_t crsfChannelData[CRSF_MAX_CHANNEL];
 
     uint32_t dummyTimeUs;
+    rxRuntimeState_t rxRuntimeState;
 
     PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
 }
@@ -129,7 +130,7 @@ TEST(CrossFireTest, TestCrsfFrameStatus)
     const uint8_t crc = crsfFrameCRC();
     crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE] = crc;
 
-    const uint8_t status = crsfFrameStatus();
+    const uint8_t status = crsfFrameStatus(&rxRuntimeState);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
     EXPECT_FALSE(crsfFrameDone);
 
@@ -180,7 +181,7 @@ TEST(CrossFireTest, TestCrsfFrameStatusUnpacking)
     crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE] = crc;
 
     memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
-    const uint8_t status = crsfFrameStatus();
+    const uint8_t status = crsfFrameStatus(&rxRuntimeState);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
     EXPECT_FALSE(crsfFrameDone);
 
@@ -225,7 +226,7 @@ TEST(CrossFireTest, TestCapturedData)
     crsfFrame = *(const crsfFrame_t*)framePtr;
     crsfFrameDone = true;
     memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
-    uint8_t status = crsfFrameStatus();
+    uint8_t status = crsfFrameStatus(&rxRuntimeState);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
     EXPECT_FALSE(crsfFrameDone);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
@@ -248,7 +249,7 @@ TEST(CrossFireTest, TestCapturedData)
     crsfFrame = *(const crsfFrame_t*)framePtr;
     crsfFrameDone = true;
     memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
-    status = crsfFrameStatus();
+    status = crsfFrameStatus(&rxRuntimeState);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
     EXPECT_FALSE(crsfFrameDone);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
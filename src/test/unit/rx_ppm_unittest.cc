@@ -0,0 +1,207 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/rx/rx_ppm.h"
+    #include "drivers/rx/rx_pwm.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_CHANNEL_COUNT  8
+#define TEST_SYNC_US        9000
+#define TEST_FRAME_US       22500
+
+// more than the frames the decoder needs to settle on the channel count
+#define TEST_SETTLE_FRAMES  30
+
+static timeUs_t testTimeUs;
+static uint16_t testCapture;
+static uint8_t testCaptureHead;
+
+static uint16_t testChannelWidth(int channel)
+{
+    return 1000 + channel * 100;
+}
+
+// pulse widths, as the edge ISR measures them
+static void queueFrame(int channelCount)
+{
+    for (int i = 0; i < channelCount; i++) {
+        ppmQueuePulse(testChannelWidth(i));
+    }
+    ppmQueuePulse(TEST_SYNC_US);
+}
+
+static void decodeFrames(int frameCount, int channelCount)
+{
+    for (int frame = 0; frame < frameCount; frame++) {
+        queueFrame(channelCount);
+        testTimeUs += TEST_FRAME_US;
+        ppmDecodePulses(testTimeUs);
+    }
+}
+
+// raw 16 bit timer captures, as the input capture DMA writes them
+static void captureEdge(uint16_t widthUs)
+{
+    testCapture += widthUs;
+    ppmCaptureRing()[testCaptureHead] = testCapture;
+    testCaptureHead = (testCaptureHead + 1) & PPM_RING_MASK;
+}
+
+static void decodeCapturedFrames(int frameCount, int channelCount)
+{
+    for (int frame = 0; frame < frameCount; frame++) {
+        for (int i = 0; i < channelCount; i++) {
+            captureEdge(testChannelWidth(i));
+        }
+        captureEdge(TEST_SYNC_US);
+        testTimeUs += TEST_FRAME_US;
+        ppmDecodeCaptures(testCaptureHead, testTimeUs);
+    }
+}
+
+static void resetDecoder(void)
+{
+    ppmDecoderReset();
+    resetPPMDataReceivedState();
+    testTimeUs = 0;
+    testCapture = 0;
+    testCaptureHead = 0;
+}
+
+TEST(RxPpmTest, TestFramesAfterChannelCountSettles)
+{
+    // given
+    resetDecoder();
+
+    // when
+    decodeFrames(TEST_SETTLE_FRAMES, TEST_CHANNEL_COUNT);
+
+    // then
+    EXPECT_TRUE(isPPMDataBeingReceived());
+    for (int i = 0; i < TEST_CHANNEL_COUNT; i++) {
+        EXPECT_EQ(testChannelWidth(i), ppmRead(i));
+    }
+    for (int i = TEST_CHANNEL_COUNT; i < PPM_CAPTURE_COUNT; i++) {
+        EXPECT_EQ(PPM_RCVR_TIMEOUT, ppmRead(i));
+    }
+}
+
+TEST(RxPpmTest, TestNoFramesBeforeChannelCountSettles)
+{
+    // given
+    resetDecoder();
+    decodeFrames(TEST_SETTLE_FRAMES, TEST_CHANNEL_COUNT);
+    resetPPMDataReceivedState();
+
+    // when
+    // the channel count changes, it takes stable frames again before they are used
+    decodeFrames(5, TEST_CHANNEL_COUNT - 2);
+
+    // then
+    EXPECT_FALSE(isPPMDataBeingReceived());
+}
+
+TEST(RxPpmTest, TestInvalidPulseDropsFrame)
+{
+    // given
+    resetDecoder();
+    decodeFrames(TEST_SETTLE_FRAMES, TEST_CHANNEL_COUNT);
+    resetPPMDataReceivedState();
+
+    // when
+    // a glitch in the middle of the frame
+    for (int i = 0; i < TEST_CHANNEL_COUNT; i++) {
+        ppmQueuePulse(i == 3 ? 300 : testChannelWidth(i));
+    }
+    ppmQueuePulse(TEST_SYNC_US);
+    testTimeUs += TEST_FRAME_US;
+    ppmDecodePulses(testTimeUs);
+
+    // then
+    EXPECT_FALSE(isPPMDataBeingReceived());
+
+    // when
+    // the next good frame is used again
+    decodeFrames(1, TEST_CHANNEL_COUNT);
+
+    // then
+    EXPECT_TRUE(isPPMDataBeingReceived());
+}
+
+TEST(RxPpmTest, TestDmaCapturesWrapAround)
+{
+    // given
+    resetDecoder();
+    // the first capture only sets the reference
+    testCapture = 0xFF00;
+    captureEdge(0);
+
+    // when
+    // the 16 bit capture wraps several times over these frames
+    decodeCapturedFrames(TEST_SETTLE_FRAMES, TEST_CHANNEL_COUNT);
+
+    // then
+    EXPECT_TRUE(isPPMDataBeingReceived());
+    for (int i = 0; i < TEST_CHANNEL_COUNT; i++) {
+        EXPECT_EQ(testChannelWidth(i), ppmRead(i));
+    }
+}
+
+TEST(RxPpmTest, TestDmaCapturesResyncAfterSignalGap)
+{
+    // given
+    resetDecoder();
+    captureEdge(0);
+    decodeCapturedFrames(TEST_SETTLE_FRAMES, TEST_CHANNEL_COUNT);
+
+    // when
+    // no edges for longer than the capture counter takes to wrap
+    testTimeUs += 100000;
+    ppmDecodeCaptures(testCaptureHead, testTimeUs);
+    testCapture += 0x1234;
+    resetPPMDataReceivedState();
+
+    // the first edge after the gap is only a reference, the sync that follows starts tracking again
+    captureEdge(0);
+    captureEdge(TEST_SYNC_US);
+    testTimeUs += TEST_FRAME_US;
+    ppmDecodeCaptures(testCaptureHead, testTimeUs);
+    decodeCapturedFrames(1, TEST_CHANNEL_COUNT);
+
+    // then
+    EXPECT_TRUE(isPPMDataBeingReceived());
+    for (int i = 0; i < TEST_CHANNEL_COUNT; i++) {
+        EXPECT_EQ(testChannelWidth(i), ppmRead(i));
+    }
+}
+
+// STUBS
+
+extern "C" {
+}
@@ -215,6 +215,10 @@ void resetPPMDataReceivedState(void)
 {
 }
 
+void ppmRxProcess(void)
+{
+}
+
 void failsafeOnValidDataReceived(void)
 {
 }
@@ -223,6 +223,7 @@ extern "C" {
     }
 
     void resetPPMDataReceivedState(void) {}
+    void ppmRxProcess(void) {}
     bool rxMspFrameComplete(void) { return false; }
 
     void crsfRxInit(const rxConfig_t *, rxRuntimeState_t *) {}
@@ -49,7 +49,13 @@ extern "C" {
     // set up tasks to take a simulated representative time to execute
     void taskMainPidLoop(timeUs_t) { simulatedTime += TEST_PID_LOOP_TIME; }
     void taskUpdateAccelerometer(timeUs_t) { simulatedTime += TEST_UPDATE_ACCEL_TIME; }
-    void taskHandleSerial(timeUs_t) { simulatedTime += TEST_HANDLE_SERIAL_TIME; }
+    bool serialTaskContinues = false;
+    void taskHandleSerial(timeUs_t) {
+        simulatedTime += TEST_HANDLE_SERIAL_TIME;
+        if (serialTaskContinues) {
+            schedulerTaskContinue();
+        }
+    }
     void taskUpdateBatteryVoltage(timeUs_t) { simulatedTime += TEST_UPDATE_BATTERY_TIME; }
     bool rxUpdateCheck(timeUs_t, timeDelta_t) { simulatedTime += TEST_UPDATE_RX_CHECK_TIME; return false; }
     void taskUpdateRxMain(timeUs_t) { simulatedTime += TEST_UPDATE_RX_MAIN_TIME; }
@@ -58,6 +64,8 @@ extern "C" {
 
     extern int taskQueueSize;
     extern cfTask_t* taskQueueArray[];
+    extern int taskDueHeapSize;
+    extern cfTask_t* taskDueHeap[];
 
     extern void queueClear(void);
     extern bool queueContains(cfTask_t *task);
@@ -393,3 +401,108 @@ TEST(SchedulerUnittest, TestTwoTasks)
     scheduler();
     EXPECT_EQ(&cfTasks[TASK_ACCEL], unittest_scheduler_selectedTask);
 }
+
+TEST(SchedulerUnittest, TestDueHeap)
+{
+    queueClear();
+
+    // the tasks are enabled with their last execution time staggered
+    simulatedTime = 20000;
+    cfTasks[TASK_GYROPID].lastExecutedAt = simulatedTime - 200;            // due at 20800
+    cfTasks[TASK_ACCEL].lastExecutedAt = simulatedTime - 9000;             // due at 21000
+    cfTasks[TASK_ATTITUDE].lastExecutedAt = simulatedTime - 9800;          // due at 20200
+    cfTasks[TASK_BATTERY_VOLTAGE].lastExecutedAt = simulatedTime - 19900;  // due at 20100
+    setTaskEnabled(TASK_GYROPID, true);
+    setTaskEnabled(TASK_ACCEL, true);
+    setTaskEnabled(TASK_ATTITUDE, true);
+    setTaskEnabled(TASK_BATTERY_VOLTAGE, true);
+    EXPECT_EQ(4, taskDueHeapSize);
+    EXPECT_EQ(&cfTasks[TASK_BATTERY_VOLTAGE], taskDueHeap[0]);
+
+    // the earliest due task is taken out of the heap and run once due
+    simulatedTime = 20100;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_BATTERY_VOLTAGE], unittest_scheduler_selectedTask);
+    EXPECT_EQ(4, taskDueHeapSize);
+    EXPECT_EQ(&cfTasks[TASK_ATTITUDE], taskDueHeap[0]);
+
+    // rescheduling moves a task within the heap
+    rescheduleTask(TASK_ATTITUDE, 20000);
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], taskDueHeap[0]);
+
+    // disabled tasks leave the heap
+    setTaskEnabled(TASK_GYROPID, false);
+    EXPECT_EQ(3, taskDueHeapSize);
+    EXPECT_EQ(&cfTasks[TASK_ACCEL], taskDueHeap[0]);
+    simulatedTime = 20900;
+    scheduler();
+    EXPECT_EQ(NULL, unittest_scheduler_selectedTask);
+    EXPECT_EQ(0, unittest_scheduler_waitingTasks);
+
+    simulatedTime = 21000;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_ACCEL], unittest_scheduler_selectedTask);
+}
+
+TEST(SchedulerUnittest, TestDeadline)
+{
+    schedulerInit();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<cfTaskId_e>(taskId), false);
+    }
+    schedulerSetDeadline(true);
+
+    // TASK_ACCEL is due, but only 100us are left before TASK_GYROPID
+    simulatedTime = 30000;
+    cfTasks[TASK_GYROPID].lastExecutedAt = simulatedTime - 900;
+    cfTasks[TASK_ACCEL].lastExecutedAt = simulatedTime - 10000;
+    cfTasks[TASK_ACCEL].movingSumExecutionTime = TEST_UPDATE_ACCEL_TIME * 32;
+    setTaskEnabled(TASK_GYROPID, true);
+    setTaskEnabled(TASK_ACCEL, true);
+
+    // which is not enough to run TASK_ACCEL
+    scheduler();
+    EXPECT_EQ(NULL, unittest_scheduler_selectedTask);
+    EXPECT_EQ(1, unittest_scheduler_waitingTasks);
+
+    simulatedTime += 100;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], unittest_scheduler_selectedTask);
+
+    // TASK_ACCEL runs straight after TASK_GYROPID
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_ACCEL], unittest_scheduler_selectedTask);
+
+    schedulerSetDeadline(false);
+}
+
+TEST(SchedulerUnittest, TestTaskContinue)
+{
+    schedulerInit();
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<cfTaskId_e>(taskId), false);
+    }
+
+    simulatedTime = 50000;
+    cfTasks[TASK_SERIAL].lastExecutedAt = simulatedTime - TASK_PERIOD_HZ(100);
+    setTaskEnabled(TASK_SERIAL, true);
+
+    // a task that asks to continue is re-entered in the next free slot
+    serialTaskContinues = true;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+    EXPECT_FALSE(schedulerTaskSliceExpired());
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+
+    // and waits for its period again once it is done
+    serialTaskContinues = false;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+    scheduler();
+    EXPECT_EQ(NULL, unittest_scheduler_selectedTask);
+
+    // the slice ends after SCHEDULER_SLICE_MAX_US without a realtime task
+    simulatedTime += 100;
+    EXPECT_TRUE(schedulerTaskSliceExpired());
+}
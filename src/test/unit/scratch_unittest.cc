@@ -0,0 +1,64 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+
+extern "C" {
+    #include "common/scratch.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(ScratchTest, AllocAlignsAndFreesInReverse)
+{
+    uint8_t *a = (uint8_t *)scratchAlloc(3);
+    uint8_t *b = (uint8_t *)scratchAlloc(8);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    EXPECT_EQ(a + 4, b);
+    EXPECT_EQ(12u, scratchUsed());
+
+    scratchFree(b);
+    EXPECT_EQ(4u, scratchUsed());
+    scratchFree(a);
+    EXPECT_EQ(0u, scratchUsed());
+    EXPECT_EQ(12u, scratchMaxUsed());
+}
+
+TEST(ScratchTest, FreeReleasesLaterAllocations)
+{
+    void *a = scratchAlloc(16);
+    scratchAlloc(16);
+    scratchFree(a);
+    EXPECT_EQ(0u, scratchUsed());
+
+    // NULL from a failed allocation is ignored
+    scratchFree(NULL);
+    EXPECT_EQ(0u, scratchUsed());
+}
+
+TEST(ScratchTest, AllocFailsWhenFull)
+{
+    void *all = scratchAlloc(SCRATCH_SIZE);
+    ASSERT_NE(nullptr, all);
+    EXPECT_EQ(nullptr, scratchAlloc(1));
+    scratchFree(all);
+
+    EXPECT_EQ(nullptr, scratchAlloc(SCRATCH_SIZE + 1));
+    EXPECT_EQ(0u, scratchUsed());
+    EXPECT_EQ((unsigned)SCRATCH_SIZE, scratchMaxUsed());
+}
@@ -37,6 +37,7 @@ extern "C" {
     #include "pg/pg_ids.h"
     #include "scheduler/scheduler.h"
     #include "sensors/gyro.h"
+    #include "sensors/gyro_bias.h"
     #include "sensors/acceleration.h"
     #include "sensors/sensors.h"
 
@@ -110,6 +111,53 @@ TEST(SensorGyro, Calibrate)
     EXPECT_EQ(7, gyroDevPtr->gyroZero[Z]);
 }
 
+TEST(SensorGyro, CalibrateCompletesEarlyWhenStill)
+{
+    pgResetAll();
+    gyroInit();
+    static const int gyroMovementCalibrationThreshold = 32;
+    const int maxCycles = gyroConfig()->gyroCalibrationDuration * 10000 / gyro.targetLooptime;
+
+    gyroStartCalibration(false);
+    int cycles = 0;
+    while (!gyroIsCalibrationComplete()) {
+        // a few counts of noise around the offsets
+        fakeGyroSet(gyroDevPtr, 5 + (cycles % 3) - 1, 6 - (cycles % 2), 7 + (cycles % 5) - 2);
+        gyroDevPtr->readFn(gyroDevPtr);
+        performGyroCalibration(gyroSensorPtr, gyroMovementCalibrationThreshold);
+        cycles++;
+    }
+    EXPECT_LT(cycles, maxCycles / 2);
+    EXPECT_NEAR(5, gyroDevPtr->gyroZero[X], 0.1);
+    EXPECT_NEAR(5.5, gyroDevPtr->gyroZero[Y], 0.1);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[Z], 0.1);
+}
+
+TEST(SensorGyro, CalibrateDropsMovement)
+{
+    pgResetAll();
+    gyroInit();
+    static const int gyroMovementCalibrationThreshold = 32;
+    const int maxCycles = gyroConfig()->gyroCalibrationDuration * 10000 / gyro.targetLooptime;
+
+    gyroStartCalibration(false);
+    int cycles = 0;
+    while (!gyroIsCalibrationComplete()) {
+        // the model is bumped a little way into the calibration
+        const int16_t bump = (cycles >= 1000 && cycles < 1200) ? ((cycles & 8) ? 400 : -300) : 0;
+        fakeGyroSet(gyroDevPtr, 5 + bump, 6, 7);
+        gyroDevPtr->readFn(gyroDevPtr);
+        performGyroCalibration(gyroSensorPtr, gyroMovementCalibrationThreshold);
+        cycles++;
+    }
+    // only the windows around the bump are dropped, it does not start over
+    EXPECT_GT(cycles, 1200);
+    EXPECT_LT(cycles, maxCycles);
+    EXPECT_FLOAT_EQ(5, gyroDevPtr->gyroZero[X]);
+    EXPECT_FLOAT_EQ(6, gyroDevPtr->gyroZero[Y]);
+    EXPECT_FLOAT_EQ(7, gyroDevPtr->gyroZero[Z]);
+}
+
 TEST(SensorGyro, Update)
 {
     pgResetAll();
@@ -149,6 +197,122 @@ TEST(SensorGyro, Update)
     EXPECT_NEAR(90 * gyroDevPtr->scale, gyro.gyroADCf[Z], 1e-3);
 }
 
+TEST(SensorGyro, BiasTableInterpolates)
+{
+    pgResetAll();
+    float bias[XYZ_AXIS_COUNT];
+    EXPECT_FALSE(gyroBiasLookup(0, 25, bias));
+
+    const float cold[XYZ_AXIS_COUNT] = { 10, 20, 30 };
+    const float warm[XYZ_AXIS_COUNT] = { 20, 40, -60 };
+    gyroBiasLearn(0, 20, cold);
+    gyroBiasLearn(0, 40, warm);
+
+    EXPECT_TRUE(gyroBiasLookup(0, 30, bias));
+    EXPECT_NEAR(15, bias[X], 0.1);
+    EXPECT_NEAR(30, bias[Y], 0.1);
+    EXPECT_NEAR(-15, bias[Z], 0.1);
+
+    // beyond the learned range the outermost bin holds
+    gyroBiasLookup(0, 5, bias);
+    EXPECT_NEAR(10, bias[X], 0.1);
+    gyroBiasLookup(0, 70, bias);
+    EXPECT_NEAR(20, bias[X], 0.1);
+
+    // repeated samples of a bin are averaged
+    const float cold2[XYZ_AXIS_COUNT] = { 12, 20, 30 };
+    gyroBiasLearn(0, 21, cold2);
+    gyroBiasLookup(0, 20, bias);
+    EXPECT_NEAR(11, bias[X], 0.1);
+}
+
+TEST(SensorGyro, TempCompFollowsTable)
+{
+    pgResetAll();
+    gyroConfigMutable()->gyro_temp_comp = GYRO_TEMP_COMP_ON;
+    gyroInit();
+    gyroDevPtr->temperature = 20;
+
+    gyroStartCalibration(false);
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroDevPtr->readFn(gyroDevPtr);
+        performGyroCalibration(gyroSensorPtr, 32);
+    }
+    // the calibration is learned at its temperature
+    gyroTempCompUpdate(0);
+    float bias[XYZ_AXIS_COUNT];
+    EXPECT_TRUE(gyroBiasLookup(0, 20, bias));
+    EXPECT_NEAR(5, bias[X], 0.1);
+
+    const float warm[XYZ_AXIS_COUNT] = { 9, 10, 11 };
+    gyroBiasLearn(0, 40, warm);
+    gyroDevPtr->temperature = 30;
+    gyroTempCompUpdate(0);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[X], 0.1);
+    EXPECT_NEAR(8, gyroDevPtr->gyroZero[Y], 0.1);
+    EXPECT_NEAR(9, gyroDevPtr->gyroZero[Z], 0.1);
+}
+
+TEST(SensorGyro, TempCompLearnsOnGroundWithoutMovingZero)
+{
+    pgResetAll();
+    gyroConfigMutable()->gyro_temp_comp = GYRO_TEMP_COMP_ON;
+    gyroInit();
+    gyroDevPtr->temperature = 20;
+
+    gyroStartCalibration(false);
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroDevPtr->readFn(gyroDevPtr);
+        performGyroCalibration(gyroSensorPtr, 32);
+    }
+    gyroTempCompUpdate(0);
+
+    // a still window goes into the table, the zero in use stays
+    for (int i = 0; i < 20; i++) {
+        fakeGyroSet(gyroDevPtr, 7, 8, 9);
+        gyroDevPtr->readFn(gyroDevPtr);
+        gyroTempCompUpdate(0);
+    }
+    float bias[XYZ_AXIS_COUNT];
+    gyroBiasLookup(0, 20, bias);
+    EXPECT_NEAR(6, bias[X], 0.1);
+    EXPECT_NEAR(7, bias[Y], 0.1);
+    EXPECT_NEAR(8, bias[Z], 0.1);
+    EXPECT_NEAR(5, gyroDevPtr->gyroZero[X], 0.1);
+    EXPECT_NEAR(6, gyroDevPtr->gyroZero[Y], 0.1);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[Z], 0.1);
+
+    // a slow steady turn is not learned
+    for (int i = 0; i < 20; i++) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7 + 100);
+        gyroDevPtr->readFn(gyroDevPtr);
+        gyroTempCompUpdate(0);
+    }
+    gyroBiasLookup(0, 20, bias);
+    EXPECT_NEAR(8, bias[Z], 0.1);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[Z], 0.1);
+}
+
+TEST(SensorGyro, TempCompSkipsCalibration)
+{
+    pgResetAll();
+    gyroConfigMutable()->gyro_temp_comp = GYRO_TEMP_COMP_SKIP_CALIBRATION;
+    const float zero[XYZ_AXIS_COUNT] = { 3, 4, 5 };
+    gyroBiasLearn(0, 25, zero);
+    gyroInit();
+    gyroDevPtr->temperature = 25;
+
+    gyroStartCalibration(false);
+    EXPECT_FALSE(gyroIsCalibrationComplete());
+    gyroTempCompUpdate(0);
+    EXPECT_TRUE(gyroIsCalibrationComplete());
+    EXPECT_NEAR(3, gyroDevPtr->gyroZero[X], 0.1);
+    EXPECT_NEAR(4, gyroDevPtr->gyroZero[Y], 0.1);
+    EXPECT_NEAR(5, gyroDevPtr->gyroZero[Z], 0.1);
+}
+
 // STUBS
 
 extern "C" {
@@ -160,4 +324,5 @@ timeDelta_t getGyroUpdateRate(void) {return gyro.targetLooptime;}
 void sensorsSet(uint32_t) {}
 void schedulerResetTaskStatistics(cfTaskId_e) {}
 int getArmingDisableFlags(void) {return 0;}
+uint8_t armingFlags = 0;
 }
@@ -0,0 +1,102 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+
+extern "C" {
+    #include "common/seqlock.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+typedef struct testTopic_s {
+    uint32_t a;
+    uint32_t b;
+} testTopic_t;
+
+static seqlock_t lock;
+static testTopic_t topic;
+
+static void publish(uint32_t value)
+{
+    seqlockWriteBegin(&lock);
+    topic.a = value;
+    topic.b = ~value;
+    seqlockWriteEnd(&lock);
+}
+
+TEST(SeqlockTest, ReadsPublishedData)
+{
+    // given
+    seqlockInit(&lock);
+    publish(42);
+
+    // when
+    testTopic_t copy;
+    const bool valid = seqlockRead(&lock, &copy, &topic, sizeof(copy));
+
+    // then
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(42, copy.a);
+    EXPECT_EQ(~42u, copy.b);
+}
+
+TEST(SeqlockTest, VersionCountsCompletedWrites)
+{
+    // given
+    seqlockInit(&lock);
+    EXPECT_EQ(0, seqlockVersion(&lock));
+
+    // when
+    publish(1);
+    publish(2);
+    seqlockWriteBegin(&lock);
+
+    // then
+    EXPECT_EQ(2, seqlockVersion(&lock));
+
+    // when
+    seqlockWriteEnd(&lock);
+
+    // then
+    EXPECT_EQ(3, seqlockVersion(&lock));
+}
+
+TEST(SeqlockTest, WriteInProgressIsNotRead)
+{
+    // given
+    seqlockInit(&lock);
+    publish(7);
+
+    // when
+    seqlockWriteBegin(&lock);
+    topic.a = 8;                    // b not written yet
+    testTopic_t copy = { 0, 0 };
+    const bool valid = seqlockRead(&lock, &copy, &topic, sizeof(copy));
+
+    // then
+    EXPECT_FALSE(valid);
+
+    // when
+    topic.b = ~8u;
+    seqlockWriteEnd(&lock);
+
+    // then
+    EXPECT_TRUE(seqlockRead(&lock, &copy, &topic, sizeof(copy)));
+    EXPECT_EQ(8, copy.a);
+    EXPECT_EQ(~8u, copy.b);
+}
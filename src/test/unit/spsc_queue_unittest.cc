@@ -0,0 +1,138 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+
+extern "C" {
+    #include "common/spsc_queue.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_QUEUE_SIZE 4
+
+static spscQueue_t queue;
+static uint32_t queueBuffer[TEST_QUEUE_SIZE];
+
+static bool push(uint32_t value)
+{
+    uint32_t *slot = (uint32_t *)spscQueueProducerSlot(&queue);
+    if (!slot) {
+        return false;
+    }
+    *slot = value;
+    spscQueueProducerCommit(&queue);
+    return true;
+}
+
+static bool pop(uint32_t *value)
+{
+    const uint32_t *slot = (const uint32_t *)spscQueueConsumerPeek(&queue);
+    if (!slot) {
+        return false;
+    }
+    *value = *slot;
+    spscQueueConsumerRelease(&queue);
+    return true;
+}
+
+TEST(SpscQueueTest, Empty)
+{
+    // given
+    spscQueueInit(&queue, queueBuffer, sizeof(queueBuffer[0]), TEST_QUEUE_SIZE);
+
+    // expect
+    uint32_t value;
+    EXPECT_EQ(0, spscQueueCount(&queue));
+    EXPECT_EQ(NULL, spscQueueConsumerPeek(&queue));
+    EXPECT_FALSE(pop(&value));
+}
+
+TEST(SpscQueueTest, FullQueueRejectsProducer)
+{
+    // given
+    spscQueueInit(&queue, queueBuffer, sizeof(queueBuffer[0]), TEST_QUEUE_SIZE);
+
+    // when
+    for (uint32_t i = 0; i < TEST_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(push(i));
+    }
+
+    // then
+    EXPECT_EQ(TEST_QUEUE_SIZE, spscQueueCount(&queue));
+    EXPECT_EQ(NULL, spscQueueProducerSlot(&queue));
+    EXPECT_FALSE(push(99));
+
+    // and
+    uint32_t value;
+    EXPECT_TRUE(pop(&value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(push(99));
+}
+
+TEST(SpscQueueTest, OrderIsKeptAcrossIndexWrap)
+{
+    // given
+    spscQueueInit(&queue, queueBuffer, sizeof(queueBuffer[0]), TEST_QUEUE_SIZE);
+
+    // when
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < 70000; i++) {
+        EXPECT_TRUE(push(i));
+        if (i % 3 == 2) {
+            EXPECT_TRUE(push(i + 1000000));
+        }
+
+        uint32_t value;
+        while (spscQueueCount(&queue) > 1) {
+            EXPECT_TRUE(pop(&value));
+            EXPECT_TRUE(value == expected || value >= 1000000);
+            if (value < 1000000) {
+                expected++;
+            }
+        }
+    }
+
+    // then
+    uint32_t value;
+    EXPECT_TRUE(pop(&value));
+    EXPECT_FALSE(pop(&value));
+}
+
+TEST(SpscQueueTest, MaxCountKeepsHighWater)
+{
+    // given
+    spscQueueInit(&queue, queueBuffer, sizeof(queueBuffer[0]), TEST_QUEUE_SIZE);
+
+    // when
+    uint32_t value;
+    EXPECT_TRUE(push(1));
+    EXPECT_TRUE(push(2));
+    EXPECT_TRUE(push(3));
+    EXPECT_TRUE(pop(&value));
+    EXPECT_TRUE(pop(&value));
+    EXPECT_TRUE(push(4));
+
+    // then
+    EXPECT_EQ(TEST_QUEUE_SIZE, spscQueueSize(&queue));
+    EXPECT_EQ(2, spscQueueCount(&queue));
+    EXPECT_EQ(3, spscQueueMaxCount(&queue));
+
+    // and
+    spscQueueInit(&queue, queueBuffer, sizeof(queueBuffer[0]), TEST_QUEUE_SIZE);
+    EXPECT_EQ(0, spscQueueMaxCount(&queue));
+}
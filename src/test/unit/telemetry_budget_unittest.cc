@@ -0,0 +1,176 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "fc/rc_modes.h"
+
+    #include "telemetry/telemetry.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_BURST_BYTES     32      // TELEMETRY_BUDGET_BURST_BYTES
+#define TEST_REPLY_BYTES     10
+
+static uint16_t testRefreshRateUs;
+static bool testReceivingSignal;
+static timeUs_t testTimeUs;
+
+// Spend the budget down to the saturated debt, with the RC link gone so nothing is refilled
+static void drainBudget(void)
+{
+    testRefreshRateUs = 0;
+    for (int i = 0; i < 100; i++) {
+        telemetryBudgetConsume(UINT16_MAX);
+    }
+}
+
+static int countReplies(void)
+{
+    int replies = 0;
+    while (telemetryBudgetConsume(TEST_REPLY_BYTES)) {
+        replies++;
+    }
+    return replies;
+}
+
+static void advance(timeDelta_t deltaUs)
+{
+    testTimeUs += deltaUs;
+    telemetryBudgetUpdate(testTimeUs);
+}
+
+TEST(TelemetryBudgetTest, RepliesSkippedOnceSpent)
+{
+    // given
+    testReceivingSignal = true;
+    testRefreshRateUs = 9000;
+    advance(1000000);               // fills the burst
+
+    // expect
+    EXPECT_EQ((TEST_BURST_BYTES + TEST_REPLY_BYTES - 1) / TEST_REPLY_BYTES, countReplies());
+    EXPECT_FALSE(telemetryBudgetConsume(1));
+}
+
+TEST(TelemetryBudgetTest, DebtSaturates)
+{
+    // given
+    testReceivingSignal = true;
+    drainBudget();
+
+    // when
+    testRefreshRateUs = 1000;       // 8000 bytes per second
+    advance(8000);                  // 64 bytes, just enough to pay a full burst of debt
+
+    // then
+    EXPECT_TRUE(telemetryBudgetConsume(1));
+}
+
+TEST(TelemetryBudgetTest, FastRcRateDoesNotOverflow)
+{
+    // given
+    testReceivingSignal = true;
+    drainBudget();
+
+    // when
+    testRefreshRateUs = 500;        // 16000 bytes per second, times a second overflows 32 bit
+    advance(1000000);
+
+    // then
+    EXPECT_EQ((TEST_BURST_BYTES + TEST_REPLY_BYTES - 1) / TEST_REPLY_BYTES, countReplies());
+}
+
+TEST(TelemetryBudgetTest, ShortUpdatesAddUp)
+{
+    // given
+    testReceivingSignal = true;
+    drainBudget();
+
+    // when
+    testRefreshRateUs = 20000;      // 400 bytes per second, 0.4 bytes per 1ms update
+    for (int i = 0; i < 161; i++) {
+        advance(1000);              // 64.4 bytes in total
+    }
+
+    // then
+    EXPECT_TRUE(telemetryBudgetConsume(1));
+}
+
+TEST(TelemetryBudgetTest, LowPrioritySensorsWaitOnAPoorLink)
+{
+    // given
+    testRefreshRateUs = 9000;
+
+    // when
+    testReceivingSignal = true;
+    advance(1000);
+
+    // then
+    EXPECT_EQ(0, telemetryBudgetMinPriority());
+
+    // when
+    testReceivingSignal = false;
+    advance(1000);
+
+    // then
+    EXPECT_EQ(3, telemetryBudgetMinPriority());
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t armingFlags;
+
+    uint16_t rxGetRefreshRate(void) { return testRefreshRateUs; }
+    bool rxIsReceivingSignal(void) { return testReceivingSignal; }
+    uint16_t rxGetLinkQualityPercent(void) { return testReceivingSignal ? 100 : 0; }
+
+    bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+    bool isModeActivationConditionPresent(boxId_e) { return false; }
+
+    void telemetrySnapshotUpdate(void) {}
+
+    void initFrSkyHubTelemetry(void) {}
+    void checkFrSkyHubTelemetryState(void) {}
+    void handleFrSkyHubTelemetry(timeUs_t) {}
+    void initHoTTTelemetry(void) {}
+    void checkHoTTTelemetryState(void) {}
+    void handleHoTTTelemetry(timeUs_t) {}
+    bool initSmartPortTelemetry(void) { return false; }
+    void checkSmartPortTelemetryState(void) {}
+    void handleSmartPortTelemetry(void) {}
+    void initLtmTelemetry(void) {}
+    void checkLtmTelemetryState(void) {}
+    void handleLtmTelemetry(void) {}
+    void initJetiExBusTelemetry(void) {}
+    void checkJetiExBusTelemetryState(void) {}
+    void handleJetiExBusTelemetry(void) {}
+    void initMAVLinkTelemetry(void) {}
+    void checkMAVLinkTelemetryState(void) {}
+    void handleMAVLinkTelemetry(void) {}
+    void initCrsfTelemetry(void) {}
+    bool checkCrsfTelemetryState(void) { return false; }
+    void handleCrsfTelemetry(timeUs_t) {}
+    void initIbusTelemetry(void) {}
+    void checkIbusTelemetryState(void) {}
+    void handleIbusTelemetry(void) {}
+}
@@ -45,6 +45,7 @@ extern "C" {
 
     #include "fc/runtime_config.h"
     #include "config/config.h"
+    #include "flight/flight_state.h"
     #include "flight/imu.h"
 
     #include "io/serial.h"
@@ -268,6 +269,8 @@ extern "C" {
     uint16_t getBatteryAverageCellVoltage(void) {
         return 0;
     }
+    float getBatteryVoltageOpenCircuit(void) { return 0.0f; }
+    float getBatteryResistance(void) { return 0.0f; }
     bool isAmperageConfigured(void) { return true; }
     int32_t getAmperage(void) {
         return testAmperage;
@@ -317,4 +320,11 @@ extern "C" {
         return true;
     }
 
+    batteryState_e getBatteryState(void) { return BATTERY_OK; }
+    uint8_t getBatteryCellCount(void) { return 1; }
+    int16_t getEstimatedVario(void) { return 0; }
+    uint16_t GPS_distanceToHome;
+    int16_t GPS_directionToHome;
+    bool flightStateRead(flightStateTopic_e, void *, unsigned) { return false; }
+
 }
@@ -45,6 +45,7 @@ extern "C" {
     #include "fc/runtime_config.h"
 
     #include "flight/pid.h"
+    #include "flight/flight_state.h"
     #include "flight/imu.h"
 
     #include "io/gps.h"
@@ -353,6 +354,14 @@ uint16_t getBatteryAverageCellVoltage(void) {
     return 0;
 }
 
+float getBatteryVoltageOpenCircuit(void) {
+    return 0.0f;
+}
+
+float getBatteryResistance(void) {
+    return 0.0f;
+}
+
 batteryState_e getBatteryState(void) {
     return BATTERY_OK;
 }
@@ -375,4 +384,19 @@ void crsfScheduleMspResponse(void) {};
 bool isBatteryVoltageConfigured(void) { return true; }
 bool isAmperageConfigured(void) { return true; }
 
+uint8_t getBatteryCellCount(void) { return 1; }
+int16_t getEstimatedVario(void) { return 0; }
+int16_t GPS_directionToHome;
+bool flightStateRead(flightStateTopic_e topic, void *dst, unsigned)
+{
+    if (topic != FLIGHT_STATE_ATTITUDE) {
+        return false;
+    }
+    flightStateAttitude_t *state = (flightStateAttitude_t *)dst;
+    state->roll = attitude.values.roll;
+    state->pitch = attitude.values.pitch;
+    state->yaw = attitude.values.yaw;
+    return true;
+}
+
 }
@@ -0,0 +1,363 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Telemetry encoder conformance and cost harness.
+ *
+ * Recorded sensor snapshots are replayed through the snapshot based
+ * encoders, every frame is compared byte by byte against its golden frame
+ * and the time per frame is reported, so encoder changes can be checked
+ * for both correctness and cost. A record is replayed again after another
+ * one, which catches encoders that patch their previous frame wrongly.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <initializer_list>
+
+extern "C" {
+    #include <platform.h>
+
+    #include "build/debug.h"
+
+    #include "common/maths.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "drivers/serial.h"
+    #include "drivers/system.h"
+
+    #include "config/config.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/governor.h"
+
+    #include "io/gps.h"
+    #include "io/serial.h"
+
+    #include "rx/rx.h"
+    #include "rx/crsf.h"
+
+    #include "sensors/battery.h"
+    #include "sensors/sensors.h"
+
+    #include "telemetry/crsf.h"
+    #include "telemetry/ltm.h"
+    #include "telemetry/msp_shared.h"
+    #include "telemetry/snapshot.h"
+    #include "telemetry/telemetry.h"
+
+    rssiSource_e rssiSource;
+
+    serialPort_t *telemetrySharedPort;
+    PG_REGISTER(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 0);
+    PG_REGISTER(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 0);
+    PG_REGISTER(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 0);
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define MAX_FRAME_SIZE      64
+#define BENCHMARK_RUNS      10000
+
+typedef struct goldenFrame_s {
+    uint8_t size;
+    uint8_t data[MAX_FRAME_SIZE];
+} goldenFrame_t;
+
+#define FRAME(...) { (uint8_t)std::initializer_list<uint8_t>{ __VA_ARGS__ }.size(), { __VA_ARGS__ } }
+
+static telemetrySnapshot_t testSnapshot;
+
+// Recorded snapshots, only the fields the encoders under test read
+static telemetrySnapshot_t recordedSnapshots[2];
+
+static void initRecordedSnapshots(void)
+{
+    telemetrySnapshot_t *s = &recordedSnapshots[0];
+    s->pitch = 100;
+    s->roll = -50;
+    s->yaw = 900;
+    s->batteryLegacyVoltage = 168;
+    s->batteryVoltage = 1680;
+    s->amperage = 1234;
+    s->mAhDrawn = 456;
+    s->batteryRemaining = 67;
+    s->gpsLatitude = 473977418;
+    s->gpsLongitude = 85455940;
+    s->gpsGroundSpeed = 500;
+    s->gpsGroundCourse = 1234;
+    s->altitude = 5000;
+    s->gpsNumSat = 12;
+    s->headspeed = 1500;
+    s->escTemperature = 45;
+    s->escTemperatureValid = true;
+    s->becVoltage = 810;
+
+    s = &recordedSnapshots[1];
+    s->pitch = -300;
+    s->roll = 250;
+    s->yaw = 1800;
+    s->batteryLegacyVoltage = 150;
+    s->batteryVoltage = 1500;
+    s->amperage = 4000;
+    s->mAhDrawn = 1200;
+    s->batteryRemaining = 40;
+    s->gpsLatitude = -337000000;
+    s->gpsLongitude = 1512000000;
+    s->gpsGroundSpeed = 1000;
+    s->gpsGroundCourse = 900;
+    s->altitude = 12000;
+    s->gpsNumSat = 4;
+    s->headspeed = 2100;
+    s->escTemperature = 60;
+    s->escTemperatureValid = true;
+    s->becVoltage = 790;
+}
+
+static const crsfFrameType_e crsfFrameTypes[] = {
+    CRSF_FRAMETYPE_ATTITUDE,
+    CRSF_FRAMETYPE_BATTERY_SENSOR,
+    CRSF_FRAMETYPE_GPS,
+    CRSF_FRAMETYPE_FLIGHT_MODE,
+    CRSF_FRAMETYPE_RPM,
+    CRSF_FRAMETYPE_TEMP,
+    CRSF_FRAMETYPE_VOLTAGES,
+};
+
+#define CRSF_FRAME_TYPE_COUNT ARRAYLEN(crsfFrameTypes)
+
+static const goldenFrame_t crsfGoldenFrames[][CRSF_FRAME_TYPE_COUNT] = {
+    {
+        FRAME(0xC8, 0x08, 0x1E, 0x06, 0xD1, 0xFC, 0x98, 0x3D, 0x5B, 0xD9),
+        FRAME(0xC8, 0x0A, 0x08, 0x00, 0xA8, 0x00, 0x7B, 0x00, 0x01, 0xC8, 0x43, 0xEF),
+        FRAME(0xC8, 0x11, 0x02, 0x1C, 0x40, 0x52, 0x4A, 0x05, 0x17, 0xF4, 0x44, 0x00, 0xB4, 0x30, 0x34, 0x04, 0x1A, 0x0C, 0x13),
+        FRAME(0xC8, 0x08, 0x21, 0x57, 0x41, 0x49, 0x54, 0x2A, 0x00, 0xB2),
+        FRAME(0xC8, 0x06, 0x0C, 0x00, 0x00, 0x05, 0xDC, 0xEC),
+        FRAME(0xC8, 0x05, 0x0D, 0x00, 0x01, 0xC2, 0xD5),
+        FRAME(0xC8, 0x05, 0x0E, 0x00, 0x1F, 0xA4, 0x70),
+    },
+    {
+        FRAME(0xC8, 0x08, 0x1E, 0xEB, 0x8D, 0x11, 0x0B, 0x7A, 0xB7, 0xC6),
+        FRAME(0xC8, 0x0A, 0x08, 0x00, 0x96, 0x01, 0x90, 0x00, 0x04, 0xB0, 0x28, 0xAF),
+        FRAME(0xC8, 0x11, 0x02, 0xEB, 0xE9, 0xC9, 0xC0, 0x5A, 0x1F, 0x4A, 0x00, 0x01, 0x68, 0x23, 0x28, 0x04, 0x60, 0x04, 0x7F),
+        FRAME(0xC8, 0x08, 0x21, 0x57, 0x41, 0x49, 0x54, 0x2A, 0x00, 0xB2),
+        FRAME(0xC8, 0x06, 0x0C, 0x00, 0x00, 0x08, 0x34, 0x6C),
+        FRAME(0xC8, 0x05, 0x0D, 0x00, 0x02, 0x58, 0x23),
+        FRAME(0xC8, 0x05, 0x0E, 0x00, 0x1E, 0xDC, 0x39),
+    },
+};
+
+static const uint8_t ltmFrameIds[] = { 'A', 'S', 'G', 'O' };
+
+#define LTM_FRAME_TYPE_COUNT ARRAYLEN(ltmFrameIds)
+
+static const goldenFrame_t ltmGoldenFrames[][LTM_FRAME_TYPE_COUNT] = {
+    {
+        FRAME(0x24, 0x54, 0x41, 0x0A, 0x00, 0xFB, 0xFF, 0x5A, 0x00, 0x54),
+        FRAME(0x24, 0x54, 0x53, 0xA0, 0x41, 0x00, 0x00, 0xFF, 0x00, 0x04, 0x1A),
+        FRAME(0x24, 0x54, 0x47, 0x4A, 0x52, 0x40, 0x1C, 0x44, 0xF4, 0x17, 0x05, 0x05, 0x88, 0x13, 0x00, 0x00, 0x33, 0x4B),
+        FRAME(0x24, 0x54, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01),
+    },
+    {
+        FRAME(0x24, 0x54, 0x41, 0xE2, 0xFF, 0x19, 0x00, 0xB4, 0x00, 0xB0),
+        FRAME(0x24, 0x54, 0x53, 0x98, 0x3A, 0x00, 0x00, 0xFF, 0x00, 0x04, 0x59),
+        FRAME(0x24, 0x54, 0x47, 0xC0, 0xC9, 0xE9, 0xEB, 0x00, 0x4A, 0x1F, 0x5A, 0x0A, 0xE0, 0x2E, 0x00, 0x00, 0x12, 0xD2),
+        FRAME(0x24, 0x54, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01),
+    },
+};
+
+// replay order, the first record comes back after the second
+static const int replayOrder[] = { 0, 1, 0, 1 };
+
+// The cycle count shim, nanoseconds on the host
+static uint64_t cycleCount(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void expectFrame(const goldenFrame_t *golden, const uint8_t *frame, int frameSize)
+{
+    ASSERT_EQ(golden->size, frameSize);
+    for (int i = 0; i < frameSize; i++) {
+        EXPECT_EQ(golden->data[i], frame[i]) << "byte " << i;
+    }
+}
+
+static void initRecordedState(void)
+{
+    initRecordedSnapshots();
+    stateFlags = 0;
+    ENABLE_STATE(GPS_FIX);
+    sensorsSet(SENSOR_GPS | SENSOR_BARO);
+}
+
+TEST(TelemetryEncodersTest, Crsf)
+{
+    initRecordedState();
+
+    for (unsigned r = 0; r < ARRAYLEN(replayOrder); r++) {
+        const int record = replayOrder[r];
+        testSnapshot = recordedSnapshots[record];
+
+        for (unsigned i = 0; i < CRSF_FRAME_TYPE_COUNT; i++) {
+            uint8_t frame[CRSF_FRAME_SIZE_MAX];
+            const int frameSize = getCrsfFrame(frame, crsfFrameTypes[i]);
+            SCOPED_TRACE(testing::Message() << "record " << record << " frame type " << crsfFrameTypes[i]);
+            expectFrame(&crsfGoldenFrames[record][i], frame, frameSize);
+        }
+    }
+
+    for (unsigned i = 0; i < CRSF_FRAME_TYPE_COUNT; i++) {
+        uint8_t frame[CRSF_FRAME_SIZE_MAX];
+        const uint64_t start = cycleCount();
+        for (int run = 0; run < BENCHMARK_RUNS; run++) {
+            testSnapshot = recordedSnapshots[run & 1];
+            getCrsfFrame(frame, crsfFrameTypes[i]);
+        }
+        printf("[ BENCH    ] crsf frame type 0x%02x: %llu ns/frame\n", crsfFrameTypes[i], (unsigned long long)((cycleCount() - start) / BENCHMARK_RUNS));
+    }
+}
+
+// LTM frames are captured from the serial port, the last frame of each type is kept
+static serialPort_t ltmTestPort;
+static goldenFrame_t ltmSentFrames[LTM_FRAME_TYPE_COUNT];
+static uint32_t testMillis;
+
+static void resetLtmSentFrames(void)
+{
+    memset(ltmSentFrames, 0, sizeof(ltmSentFrames));
+}
+
+static void runLtmCycle(void)
+{
+    // a full scheduler cycle sends every frame type
+    for (int i = 0; i < 10; i++) {
+        testMillis += 100;
+        handleLtmTelemetry();
+    }
+}
+
+TEST(TelemetryEncodersTest, Ltm)
+{
+    initRecordedState();
+
+    initLtmTelemetry();
+    checkLtmTelemetryState();
+
+    for (unsigned r = 0; r < ARRAYLEN(replayOrder); r++) {
+        const int record = replayOrder[r];
+        testSnapshot = recordedSnapshots[record];
+
+        resetLtmSentFrames();
+        runLtmCycle();
+
+        for (unsigned i = 0; i < LTM_FRAME_TYPE_COUNT; i++) {
+            SCOPED_TRACE(testing::Message() << "record " << record << " frame " << ltmFrameIds[i]);
+            expectFrame(&ltmGoldenFrames[record][i], ltmSentFrames[i].data, ltmSentFrames[i].size);
+        }
+    }
+
+    const uint64_t start = cycleCount();
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        testSnapshot = recordedSnapshots[run & 1];
+        runLtmCycle();
+    }
+    printf("[ BENCH    ] ltm cycle of 21 frames: %llu ns/frame\n", (unsigned long long)((cycleCount() - start) / BENCHMARK_RUNS / 21));
+}
+
+// STUBS
+
+extern "C" {
+
+int16_t debug[DEBUG16_VALUE_COUNT];
+
+const uint32_t baudRates[] = {0, 9600, 19200, 38400, 57600, 115200, 230400, 250000, 400000}; // see baudRate_e
+
+int32_t GPS_home[2];
+uint16_t GPS_distanceToHome;
+int16_t GPS_directionToHome;
+gpsSolutionData_t gpsSol;
+float headspeed;
+rxRuntimeState_t rxRuntimeState;
+
+static const serialPortConfig_t ltmTestPortConfig = { .identifier = SERIAL_PORT_USART1 };
+
+const telemetrySnapshot_t *getTelemetrySnapshot(void) { return &testSnapshot; }
+void telemetrySnapshotUpdate(void) {}
+
+uint32_t millis(void) { return testMillis; }
+uint32_t micros(void) { return 0; }
+uint32_t microsISR(void) { return micros(); }
+
+bool featureIsEnabled(uint32_t) { return true; }
+bool airmodeIsEnabled(void) { return false; }
+bool failsafeIsActive(void) { return false; }
+uint16_t getRssi(void) { return RSSI_MAX_VALUE; }
+void beeperConfirmationBeeps(uint8_t) {}
+
+bool isBatteryVoltageConfigured(void) { return true; }
+bool isAmperageConfigured(void) { return true; }
+
+uint32_t serialRxBytesWaiting(const serialPort_t *) { return 0; }
+uint32_t serialTxBytesFree(const serialPort_t *) { return 0; }
+uint8_t serialRead(serialPort_t *) { return 0; }
+void serialWrite(serialPort_t *, uint8_t) {}
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    if (instance != &ltmTestPort || count < 3 || count > MAX_FRAME_SIZE) {
+        return;
+    }
+    for (unsigned i = 0; i < LTM_FRAME_TYPE_COUNT; i++) {
+        if (data[2] == ltmFrameIds[i]) {
+            ltmSentFrames[i].size = count;
+            memcpy(ltmSentFrames[i].data, data, count);
+        }
+    }
+}
+void serialSetMode(serialPort_t *, portMode_e) {}
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return &ltmTestPort; }
+void closeSerialPort(serialPort_t *) {}
+bool isSerialTransmitBufferEmpty(const serialPort_t *) { return true; }
+
+const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) { return &ltmTestPortConfig; }
+portSharing_e determinePortSharing(const serialPortConfig_t *, serialPortFunction_e) { return PORTSHARING_NOT_SHARED; }
+
+bool telemetryDetermineEnabledState(portSharing_e) { return true; }
+bool telemetryCheckRxPortShared(const serialPortConfig_t *, SerialRXType) { return false; }
+bool telemetryIsSensorEnabled(sensor_e) { return true; }
+
+bool sendMspReply(uint8_t, mspResponseFnPtr) { return false; }
+bool handleMspFrame(uint8_t *, int, uint8_t *) { return false; }
+
+govState_e governorGetState(void) { return GOV_STATE_IDLE; }
+float governorGetOutput(void) { return 0; }
+
+}
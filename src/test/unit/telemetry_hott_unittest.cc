@@ -49,6 +49,7 @@ extern "C" {
 
     #include "telemetry/telemetry.h"
     #include "telemetry/hott.h"
+    #include "telemetry/snapshot.h"
 
     PG_REGISTER(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 0);
 
@@ -260,6 +261,12 @@ bool telemetryIsSensorEnabled(sensor_e sensor) {
     return true;
 }
 
+static telemetrySnapshot_t testSnapshot;
+const telemetrySnapshot_t *getTelemetrySnapshot(void)
+{
+    return &testSnapshot;
+}
+
 portSharing_e determinePortSharing(const serialPortConfig_t *, serialPortFunction_e)
 {
     return PORTSHARING_NOT_SHARED;
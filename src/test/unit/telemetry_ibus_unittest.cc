@@ -30,6 +30,7 @@ extern "C" {
 #include "fc/rc_controls.h"
 #include "telemetry/telemetry.h"
 #include "telemetry/ibus.h"
+#include "telemetry/snapshot.h"
 #include "sensors/gyro.h"
 #include "sensors/battery.h"
 #include "sensors/barometer.h"
@@ -189,6 +190,12 @@ bool telemetryIsSensorEnabled(sensor_e sensor) {
     return true;
 }
 
+static telemetrySnapshot_t testSnapshot;
+const telemetrySnapshot_t *getTelemetrySnapshot(void)
+{
+    return &testSnapshot;
+}
+
 
 bool isSerialPortShared(const serialPortConfig_t *portConfig,
                         uint16_t functionMask,
@@ -245,6 +252,14 @@ void serialWrite(serialPort_t *instance, uint8_t ch)
 }
 
 
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    while (count--) {
+        serialWrite(instance, *data++);
+    }
+}
+
+
 uint32_t serialRxBytesWaiting(const serialPort_t *instance)
 {
     EXPECT_EQ(&serialTestInstance, instance);
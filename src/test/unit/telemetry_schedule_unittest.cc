@@ -0,0 +1,174 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "telemetry/schedule.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_SLOT_COUNT 4
+#define TEST_LINK_SLOT_MS 10
+
+static telemetrySlot_t testSlots[TEST_SLOT_COUNT];
+static telemetrySchedule_t testSchedule;
+
+// hands out the link slots of durationMs and counts how often each sensor got one
+static void runSchedule(timeMs_t startMs, timeMs_t durationMs, int *picks)
+{
+    for (timeMs_t t = startMs; t != startMs + durationMs; t += TEST_LINK_SLOT_MS) {
+        telemetrySlot_t *slot = telemetryScheduleNext(&testSchedule, t);
+        ASSERT_NE((void *)NULL, slot);
+        picks[slot - testSlots]++;
+    }
+}
+
+TEST(TelemetryScheduleTest, TestAdd)
+{
+    // given
+    telemetryScheduleInit(&testSchedule, testSlots, TEST_SLOT_COUNT);
+
+    // when
+    for (int i = 0; i < TEST_SLOT_COUNT + 2; i++) {
+        telemetryScheduleAdd(&testSchedule, 0x100 + i, 0, 0);
+    }
+
+    // then
+    // extra sensors are dropped, a zero interval or priority is raised to 1
+    EXPECT_EQ(TEST_SLOT_COUNT, testSchedule.count);
+    for (int i = 0; i < TEST_SLOT_COUNT; i++) {
+        EXPECT_EQ(0x100 + i, testSlots[i].id);
+        EXPECT_EQ(1, testSlots[i].intervalMs);
+        EXPECT_EQ(1, testSlots[i].priority);
+        EXPECT_FALSE(testSlots[i].valueValid);
+    }
+}
+
+TEST(TelemetryScheduleTest, TestSlotsFollowInterval)
+{
+    // given
+    telemetryScheduleInit(&testSchedule, testSlots, TEST_SLOT_COUNT);
+    telemetryScheduleAdd(&testSchedule, 1, 50, 1);
+    telemetryScheduleAdd(&testSchedule, 2, 500, 1);
+
+    // when
+    int picks[TEST_SLOT_COUNT] = { 0 };
+    runSchedule(1000, 10000, picks);
+
+    // then
+    // the fast sensor gets about ten times the slots of the slow one, the slow one is not starved
+    EXPECT_GT(picks[1], 0);
+    EXPECT_GT(picks[0], picks[1] * 6);
+    EXPECT_EQ(1000, picks[0] + picks[1]);
+}
+
+TEST(TelemetryScheduleTest, TestPriorityWeightsAge)
+{
+    // given
+    telemetryScheduleInit(&testSchedule, testSlots, TEST_SLOT_COUNT);
+    telemetryScheduleAdd(&testSchedule, 1, 100, 1);
+    telemetryScheduleAdd(&testSchedule, 2, 100, 3);
+
+    // when
+    int picks[TEST_SLOT_COUNT] = { 0 };
+    runSchedule(1000, 10000, picks);
+
+    // then
+    EXPECT_GT(picks[0], 0);
+    EXPECT_GT(picks[1], picks[0] * 2);
+}
+
+TEST(TelemetryScheduleTest, TestMinPriority)
+{
+    // given
+    telemetryScheduleInit(&testSchedule, testSlots, TEST_SLOT_COUNT);
+    telemetryScheduleAdd(&testSchedule, 1, 10, 1);
+    telemetryScheduleAdd(&testSchedule, 2, 1000, 2);
+
+    // when
+    testSchedule.minPriority = 2;
+
+    // then
+    // the most overdue sensor is below the minimum priority
+    for (timeMs_t t = 1000; t < 2000; t += TEST_LINK_SLOT_MS) {
+        EXPECT_EQ(&testSlots[1], telemetryScheduleNext(&testSchedule, t));
+    }
+
+    // when
+    testSchedule.minPriority = 3;
+
+    // then
+    EXPECT_EQ(NULL, telemetryScheduleNext(&testSchedule, 2000));
+}
+
+TEST(TelemetryScheduleTest, TestClockWrap)
+{
+    // given
+    telemetryScheduleInit(&testSchedule, testSlots, TEST_SLOT_COUNT);
+    telemetryScheduleAdd(&testSchedule, 1, 50, 1);
+    telemetryScheduleAdd(&testSchedule, 2, 500, 1);
+    int picks[TEST_SLOT_COUNT] = { 0 };
+    runSchedule(UINT32_MAX - 20000 + 1, 20000, picks);
+
+    // when
+    // the millisecond clock wraps around
+    picks[0] = picks[1] = 0;
+    runSchedule(0, 10000, picks);
+
+    // then
+    EXPECT_GT(picks[1], 0);
+    EXPECT_GT(picks[0], picks[1] * 6);
+}
+
+TEST(TelemetryScheduleTest, TestValueDue)
+{
+    // given
+    telemetryScheduleInit(&testSchedule, testSlots, TEST_SLOT_COUNT);
+    telemetryScheduleAdd(&testSchedule, 1, 100, 1);
+    telemetrySlot_t *slot = &testSlots[0];
+
+    // then
+    // the first value is always sent
+    EXPECT_TRUE(telemetryScheduleValueDue(slot, 1000, 42));
+    EXPECT_EQ(1000u, slot->lastSentMs);
+
+    // an unchanged value gives its slot away
+    EXPECT_FALSE(telemetryScheduleValueDue(slot, 1100, 42));
+    EXPECT_FALSE(telemetryScheduleValueDue(slot, 1000 + TELEMETRY_SCHEDULE_REFRESH_MS - 1, 42));
+
+    // a changed value is sent
+    EXPECT_TRUE(telemetryScheduleValueDue(slot, 1200, 43));
+    EXPECT_EQ(1200u, slot->lastSentMs);
+
+    // an unchanged value is resent once the refresh interval has passed
+    EXPECT_FALSE(telemetryScheduleValueDue(slot, 1200 + TELEMETRY_SCHEDULE_REFRESH_MS - 1, 43));
+    EXPECT_TRUE(telemetryScheduleValueDue(slot, 1200 + TELEMETRY_SCHEDULE_REFRESH_MS, 43));
+}
+
+// STUBS
+
+extern "C" {
+}
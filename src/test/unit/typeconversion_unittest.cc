@@ -0,0 +1,86 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <limits.h>
+
+extern "C" {
+    #include "common/typeconversion.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(TypeConversionTest, UnsignedDecimal)
+{
+    char buf[24];
+    char expected[24];
+
+    const unsigned values[] = { 0, 1, 9, 10, 99, 100, 12345, 999999999, 1000000000, UINT_MAX };
+    for (unsigned value : values) {
+        ui2a(value, 10, 0, buf);
+        snprintf(expected, sizeof(expected), "%u", value);
+        EXPECT_STREQ(expected, buf);
+    }
+}
+
+TEST(TypeConversionTest, UnsignedHex)
+{
+    char buf[24];
+
+    ui2a(0, 16, 0, buf);
+    EXPECT_STREQ("0", buf);
+    ui2a(0xdeadbeef, 16, 0, buf);
+    EXPECT_STREQ("deadbeef", buf);
+    ui2a(0xdeadbeef, 16, 1, buf);
+    EXPECT_STREQ("DEADBEEF", buf);
+    ui2a(0x10, 16, 0, buf);
+    EXPECT_STREQ("10", buf);
+}
+
+TEST(TypeConversionTest, SignedDecimal)
+{
+    char buf[24];
+
+    i2a(0, buf);
+    EXPECT_STREQ("0", buf);
+    i2a(-1, buf);
+    EXPECT_STREQ("-1", buf);
+    i2a(-2147483647, buf);
+    EXPECT_STREQ("-2147483647", buf);
+    li2a(-123456789L, buf);
+    EXPECT_STREQ("-123456789", buf);
+    uli2a(4000000000UL, 10, 0, buf);
+    EXPECT_STREQ("4000000000", buf);
+}
+
+TEST(TypeConversionTest, Itoa)
+{
+    char buf[40];
+
+    EXPECT_STREQ("-42", itoa(-42, buf, 10));
+    EXPECT_STREQ("101010", itoa(42, buf, 2));
+    EXPECT_STREQ("7FFFFFFF", itoa(INT_MAX, buf, 16));
+    EXPECT_STREQ("Z", itoa(35, buf, 36));
+    EXPECT_STREQ("-80000000", itoa(INT_MIN, buf, 16));
+    EXPECT_STREQ("123", itoa(123, buf, 99)); // bad radix is base 10
+}
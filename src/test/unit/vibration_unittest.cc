@@ -0,0 +1,215 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "flight/vibration.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/acceleration.h"
+
+    uint8_t armingFlags;
+    acc_t acc;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_PID_HZ         1000
+#define TEST_HEADSPEED_RPM  1800        // 30Hz main rotor
+#define TEST_AMPLITUDE      20.0f       // deg/s
+
+static float testHeadspeedRPM;
+static uint32_t testSample;
+
+static void initMonitor(bool enabled)
+{
+    vibrationConfigMutable()->vibration_monitor = enabled;
+    vibrationConfigMutable()->vibration_tail_ratio = 0;
+    vibrationConfigMutable()->vibration_bandwidth = 10;
+    armingFlags = 0;
+    testHeadspeedRPM = TEST_HEADSPEED_RPM;
+    testSample = 0;
+    vibrationInit();
+    vibrationResetFlight();
+}
+
+// the gyro sees a vibration at the main rotor frequency, the pitch axis lags the roll axis by pitchLagDeg
+static void runSeconds(float seconds, float pitchLagDeg)
+{
+    const float omega = 2 * M_PIf * testHeadspeedRPM / 60.0f;
+    const int updates = lrintf(seconds * VIBRATION_UPDATE_HZ);
+
+    for (int update = 0; update < updates; update++) {
+        vibrationUpdate(0);
+        for (int i = 0; i < TEST_PID_HZ / VIBRATION_UPDATE_HZ; i++) {
+            const float t = (float)testSample++ / TEST_PID_HZ;
+            const float gyroADC[XYZ_AXIS_COUNT] = {
+                TEST_AMPLITUDE * cosf(omega * t),
+                TEST_AMPLITUDE * cosf(omega * t - pitchLagDeg * RAD),
+                0,
+            };
+            vibrationUpdateGyro(gyroADC);
+        }
+    }
+}
+
+TEST(VibrationTest, TestRotatingImbalance)
+{
+    // given
+    initMonitor(true);
+
+    // when
+    runSeconds(3, 90);
+
+    // then
+    // the root sum square of the two axes, with pitch a quarter turn behind roll
+    EXPECT_TRUE(vibrationIsActive(VIBRATION_MAIN_1X));
+    EXPECT_NEAR(sqrtf(2) * TEST_AMPLITUDE, vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_1X), 0.5f);
+    EXPECT_NEAR(90, fabsf(vibrationGetPhase(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_1X)), 3);
+
+    // nothing at twice the rotor frequency, but the 1x ripple the detector lowpass lets through
+    EXPECT_TRUE(vibrationIsActive(VIBRATION_MAIN_2X));
+    EXPECT_LT(vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_2X), 0.1f * TEST_AMPLITUDE);
+
+    // no tail motor
+    EXPECT_FALSE(vibrationIsActive(VIBRATION_TAIL_1X));
+}
+
+TEST(VibrationTest, TestFixedDirection)
+{
+    // given
+    initMonitor(true);
+
+    // when
+    runSeconds(3, 0);
+
+    // then
+    EXPECT_NEAR(0, vibrationGetPhase(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_1X), 3);
+}
+
+TEST(VibrationTest, TestNotActiveBeforeSettled)
+{
+    // given
+    initMonitor(true);
+
+    // when
+    runSeconds(0.2f, 90);
+
+    // then
+    EXPECT_FALSE(vibrationIsActive(VIBRATION_MAIN_1X));
+    EXPECT_EQ(0, vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_1X));
+}
+
+TEST(VibrationTest, TestHeadspeedOutOfRange)
+{
+    // given
+    initMonitor(true);
+    runSeconds(3, 90);
+
+    // when
+    // too slow for the detector bandwidth
+    testHeadspeedRPM = 300;
+    runSeconds(0.1f, 90);
+
+    // then
+    EXPECT_FALSE(vibrationIsActive(VIBRATION_MAIN_1X));
+    EXPECT_EQ(0, vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_1X));
+}
+
+TEST(VibrationTest, TestDisabled)
+{
+    // given
+    initMonitor(false);
+
+    // when
+    runSeconds(3, 90);
+
+    // then
+    EXPECT_FALSE(vibrationIsActive(VIBRATION_MAIN_1X));
+    EXPECT_EQ(0, vibrationGetAmplitude(VIBRATION_SOURCE_GYRO, VIBRATION_MAIN_1X));
+}
+
+TEST(VibrationTest, TestFlightMaximumWhileArmed)
+{
+    // given
+    initMonitor(true);
+    runSeconds(3, 90);
+
+    vibrationFlight_t flight;
+    vibrationGetFlight(&flight);
+    EXPECT_EQ(0, flight.maxGyro[VIBRATION_MAIN_1X]);
+
+    // when
+    ENABLE_ARMING_FLAG(ARMED);
+    runSeconds(1, 90);
+
+    // then
+    // in 0.1 deg/s
+    vibrationGetFlight(&flight);
+    EXPECT_NEAR(sqrtf(2) * TEST_AMPLITUDE * 10, flight.maxGyro[VIBRATION_MAIN_1X], 10);
+    EXPECT_EQ(0, flight.maxGyro[VIBRATION_TAIL_1X]);
+
+    // when
+    vibrationResetFlight();
+
+    // then
+    vibrationGetFlight(&flight);
+    EXPECT_EQ(0, flight.maxGyro[VIBRATION_MAIN_1X]);
+}
+
+// STUBS
+
+extern "C" {
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+
+    float pidGetDT(void) { return 1.0f / TEST_PID_HZ; }
+
+    bool sensors(uint32_t mask)
+    {
+        UNUSED(mask);
+        return false;
+    }
+
+    float getHeadspeedRPM(void) { return testHeadspeedRPM; }
+    float getFilteredMotorRPM(uint8_t motor)
+    {
+        UNUSED(motor);
+        return 0;
+    }
+
+    uint8_t getMotorCount(void) { return 1; }
+}
@@ -75,10 +75,63 @@ TEST(WS2812, updateDMABuffer) {
     byteIndex++;
 }
 
+TEST(WS2812, updateDMABufferWithCompareValues) {
+    // given
+    BIT_COMPARE_1 = 40;
+    BIT_COMPARE_0 = 20;
+    rgbColor24bpp_t color1 = { .raw = {0x01,0x80,0x00} };
+
+    // when
+    updateLEDDMABuffer(LED_RGB, &color1, 1);
+
+    // then
+    const unsigned offset = WS2811_BITS_PER_LED;
+    for (unsigned bit = 0; bit < WS2811_BITS_PER_LED; bit++) {
+        // r = 0x01, g = 0x80, b = 0x00
+        const bool set = bit == 7 || bit == 8;
+        EXPECT_EQ(set ? BIT_COMPARE_1 : BIT_COMPARE_0, ledStripDMABuffer[offset + bit]);
+    }
+}
+
+static int hsvToRgb24Calls = 0;
+
+TEST(WS2812, updateStripEncodesChangedLedsOnly) {
+    // given
+    ws2811LedStripEnable();
+    setUsedLedCount(4);
+
+    // when
+    ws2811UpdateStrip(LED_GRB);
+
+    // then
+    EXPECT_EQ(WS2811_DATA_BUFFER_SIZE, hsvToRgb24Calls);
+
+    // when
+    ws2811LedDataTransferInProgress = false;
+    hsvToRgb24Calls = 0;
+    const hsvColor_t red = { 0, 255, 255 };
+    setLedHsv(2, &red);
+    ws2811UpdateStrip(LED_GRB);
+
+    // then
+    EXPECT_EQ(1, hsvToRgb24Calls);
+
+    // when the format changes every used LED is encoded again
+    ws2811LedDataTransferInProgress = false;
+    hsvToRgb24Calls = 0;
+    ws2811UpdateStrip(LED_RGB);
+
+    // then
+    EXPECT_EQ(4, hsvToRgb24Calls);
+}
+
 extern "C" {
 rgbColor24bpp_t* hsvToRgb24(const hsvColor_t *c) {
+    static rgbColor24bpp_t rgb;
+
     UNUSED(c);
-    return NULL;
+    hsvToRgb24Calls++;
+    return &rgb;
 }
 
 bool ws2811LedStripHardwareInit(ioTag_t ioTag) {
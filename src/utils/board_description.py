@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+#
+# Binary board description of a unified target, from the output of the
+# 'defaults compile' CLI command.
+#
+# Flash the target with its text custom defaults and run 'defaults compile'
+# in the CLI, then save the output to a file. The '#bd' lines hold the PG
+# changes of the text defaults in the layout of that firmware build, which
+# the firmware applies straight from flash without parsing. The binary goes
+# where the text custom defaults would, for instance through make_config_hex.sh.
+#
+# Usage:
+#   board_description.py <cli output> <binary file>
+#
+
+import struct
+import sys
+
+MAGIC = 0x44424648
+HEADER = struct.Struct('<IHHH')
+
+
+def crc16_ccitt(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+        crc &= 0xffff
+    return crc
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit('usage: board_description.py <cli output> <binary file>')
+
+    data = bytearray()
+    with open(sys.argv[1]) as capture:
+        for line in capture:
+            line = line.strip()
+            if line.startswith('#bd '):
+                data += bytes.fromhex(line[4:])
+
+    if len(data) < HEADER.size:
+        sys.exit('no board description found')
+
+    magic, _, length, crc = HEADER.unpack_from(data)
+    records = data[len(data) - length:]
+    if magic != MAGIC or crc16_ccitt(records) != crc:
+        sys.exit('board description is damaged')
+
+    with open(sys.argv[2], 'wb') as output:
+        output.write(data)
+
+    print('%s: %d bytes' % (sys.argv[2], len(data)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+#
+# Static RAM use of a build, per subsystem.
+#
+# Every symbol placed in RAM (.data, .bss, .fastram_data, .fastram_bss,
+# .tcm_code, .sram2, DMA RAM sections ...) is attributed to the directory of
+# src/main its source file is in: blackbox, cli, drivers, io, osd ...
+# The source file is taken, in this order, from the debug info of the ELF
+# (DEBUG=INFO builds), from the object file of the map when it is not an LTO
+# partition, or from the definitions found in the source tree by name.
+#
+# Usage:
+#   memory_report.py <mapfile> [<elf> <nm>]
+#       without the ELF only the map is used, and the sizes of symbols that
+#       the LTO merged into one input section are not known
+#
+
+import os
+import re
+import subprocess
+import sys
+
+SRC_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'main'))
+
+# Used when the map has no memory regions, as the SITL build
+RAM_SECTIONS = ['.data', '.bss', '.fastram_data', '.fastram_bss', '.tcm_code', '.sram2', '.DMA_RAM', '.DMA_RW_AXI']
+
+STACK_SECTION = '._user_heap_stack'
+
+TOP_SYMBOLS = 25
+
+
+def read_map(path):
+    """Return the RAM regions, the RAM output sections and the input sections of the map file."""
+    regions = []
+    outputs = []
+    inputs = []
+
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    i = 0
+    while i < len(lines) and not lines[i].startswith('Memory Configuration'):
+        i += 1
+    while i < len(lines) and not lines[i].startswith('Linker script and memory map'):
+        match = re.match(r'^(\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)', lines[i])
+        if match and match.group(1) != '*default*' and not match.group(1).startswith('FLASH'):
+            regions.append((match.group(1), int(match.group(2), 16), int(match.group(3), 16)))
+        i += 1
+
+    section = None
+    pending = None
+    for line in lines[i:]:
+        if line.startswith('Cross Reference Table'):
+            break
+
+        # output section, the address and size are on the next line for long names
+        match = re.match(r'^(\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+))?', line)
+        if match:
+            section = match.group(1)
+            pending = None
+            if match.group(3):
+                outputs.append([section, int(match.group(2), 16), int(match.group(3), 16)])
+            else:
+                pending = ('output', section)
+            continue
+
+        # input section, same
+        match = re.match(r'^ (\.\S+|COMMON)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.*))?$', line)
+        if match:
+            pending = None
+            if match.group(3):
+                inputs.append([section, match.group(1), int(match.group(2), 16), int(match.group(3), 16), match.group(4).strip()])
+            else:
+                pending = ('input', match.group(1))
+            continue
+
+        if pending:
+            match = re.match(r'^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(?:\s+(.*))?$', line)
+            if match:
+                if pending[0] == 'output':
+                    outputs.append([pending[1], int(match.group(1), 16), int(match.group(2), 16)])
+                else:
+                    inputs.append([section, pending[1], int(match.group(1), 16), int(match.group(2), 16), (match.group(3) or '').strip()])
+            pending = None
+
+    def in_ram(address):
+        return any(origin <= address < origin + length for _, origin, length in regions)
+
+    if regions:
+        ram = [(name, address, size) for name, address, size in outputs if size and in_ram(address)]
+    else:
+        ram = [(name, address, size) for name, address, size in outputs if size and name in RAM_SECTIONS]
+
+    used = []
+    for name, origin, length in regions:
+        size = sum(s for _, address, s in ram if origin <= address < origin + length)
+        used.append((name, size, length))
+
+    return used, ram, [entry for entry in inputs if entry[3]]
+
+
+def read_symbols(elf, nm):
+    """Return (address, size, name, file) of the sized symbols of the ELF, file is None without debug info."""
+    output = subprocess.run([nm, '-S', '-l', '--defined-only', elf], stdout=subprocess.PIPE,
+                            universal_newlines=True, check=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        location = None
+        if '\t' in line:
+            line, location = line.split('\t', 1)
+        fields = line.split()
+        if len(fields) != 4 or fields[2] not in 'bBdDtTrR':
+            continue
+        if location:
+            location = location.rsplit(':', 1)[0]
+        symbols.append((int(fields[0], 16), int(fields[1], 16), fields[3], location))
+    return symbols
+
+
+def base_name(symbol):
+    # LTO and the optimiser add suffixes: cliBuffer.lto_priv.0, buffer.4021, servoMixer.constprop.0
+    return symbol.split('.', 1)[0]
+
+
+def index_sources():
+    """Map the names of the variables and functions defined in src/main to their source file."""
+    definition = re.compile(r'^(?!extern|typedef|#|static inline|return)[A-Za-z_][^;(]*?\b([A-Za-z_]\w*)\s*(?:\[[^\]]*\]\s*)*(?:=|;|\[|\()')
+    local_static = re.compile(r'^\s+static\s+[^;(]*?\b([A-Za-z_]\w*)\s*(?:\[[^\]]*\]\s*)*(?:=|;)')
+    struct_end = re.compile(r'^}\s*([A-Za-z_]\w*)\s*(?:\[[^\]]*\]\s*)*(?:=|;)')
+    pg_register = re.compile(r'PG_REGISTER\w*\(\s*[^,]+,\s*(?:[^,]+,\s*)?(\w+)\s*,\s*PG_')
+
+    index = {}
+    for root, dirs, files in os.walk(SRC_DIR):
+        dirs[:] = [d for d in dirs if d != 'lib']
+        for name in files:
+            if not name.endswith('.c'):
+                continue
+            path = os.path.join(root, name)
+            with open(path, errors='replace') as f:
+                for line in f:
+                    for pattern in (definition, local_static, struct_end):
+                        match = pattern.match(line)
+                        if match:
+                            index.setdefault(match.group(1), path)
+                    match = pg_register.search(line)
+                    if match:
+                        for suffix in ('_System', '_Copy', '_SystemArray', '_CopyArray'):
+                            index.setdefault(match.group(1) + suffix, path)
+    return index
+
+
+def subsystem_of(path):
+    path = os.path.normpath(path)
+    if path.startswith(SRC_DIR + os.sep):
+        parts = os.path.relpath(path, SRC_DIR).split(os.sep)
+        return parts[0] if len(parts) > 1 else os.path.splitext(parts[0])[0]
+
+    # objects of the build: obj/main/<TARGET>/<subsystem>/...
+    match = re.search(r'obj/main/[^/]+/([^/(]+)/', path)
+    if match:
+        return match.group(1)
+    match = re.search(r'/lib(\w+?)(?:_nano)?\.a\(', path)
+    if match:
+        return 'lib' + match.group(1)
+    return None
+
+
+def is_lto_partition(path):
+    return 'ltrans' in path or not path
+
+
+def report(mapfile, elf=None, nm=None):
+    used, ram, inputs = read_map(mapfile)
+    symbols = read_symbols(elf, nm) if elf else []
+    index = None
+
+    sections = [name for name, _, _ in ram]
+    totals = {}
+    placed = []
+
+    def add(subsystem, section, size):
+        row = totals.setdefault(subsystem, dict.fromkeys(sections, 0))
+        row[section] += size
+
+    def resolve(name):
+        nonlocal index
+        if index is None:
+            index = index_sources()
+        path = index.get(base_name(name))
+        return subsystem_of(path) if path else None
+
+    for section, address, size in ram:
+        end = address + size
+        attributed = 0
+
+        if section == STACK_SECTION:
+            add('(stack)', section, size)
+            continue
+
+        section_inputs = [entry for entry in inputs if entry[0] == section]
+        section_symbols = sorted(s for s in symbols if address <= s[0] < end and s[1])
+
+        for _, name, start, length, path in section_inputs:
+            contained = [s for s in section_symbols if start <= s[0] < start + length]
+            if not is_lto_partition(path) and not any(s[3] for s in contained):
+                subsystem = subsystem_of(path) or '(toolchain)'
+                add(subsystem, section, length)
+                attributed += length
+                for s in contained:
+                    placed.append((s[1], s[2], section, subsystem))
+                continue
+
+            if not contained:
+                if name.count('.') < 2:
+                    # merged by the LTO, the symbol sizes are only known from the ELF
+                    add('(lto)', section, length)
+                    attributed += length
+                    continue
+                # -fdata-sections: .bss.<symbol>
+                contained = [(start, length, name.split('.', 2)[2], None)]
+
+            for s_address, s_size, s_name, s_file in contained:
+                subsystem = (subsystem_of(s_file) if s_file else None) or resolve(s_name) or '(unresolved)'
+                add(subsystem, section, s_size)
+                attributed += s_size
+                placed.append((s_size, s_name, section, subsystem))
+
+        if size > attributed:
+            add('(padding)', section, size - attributed)
+
+    print('# Static RAM use from %s' % mapfile)
+    if not symbols:
+        print('# no ELF symbols, symbols merged by the LTO are not attributed')
+
+    if used:
+        print('\n%-14s %8s %8s' % ('Region', 'Used', 'Size'))
+        for name, size, length in used:
+            print('%-14s %8d %8d  %3d%%' % (name, size, length, 100 * size // length if length else 0))
+
+    width = max([14] + [len(s) + 1 for s in sections])
+    print('\n%-14s' % 'Subsystem' + ''.join('%*s' % (width, s) for s in sections) + '%*s' % (width, 'total'))
+    for subsystem, row in sorted(totals.items(), key=lambda item: -sum(item[1].values())):
+        print('%-14s' % subsystem + ''.join('%*d' % (width, row[s]) for s in sections) + '%*d' % (width, sum(row.values())))
+    print('%-14s' % '(total)' + ''.join('%*d' % (width, size) for _, _, size in ram) + '%*d' % (width, sum(size for _, _, size in ram)))
+
+    print('\nLargest symbols:')
+    for size, name, section, subsystem in sorted(placed, reverse=True)[:TOP_SYMBOLS]:
+        print('  %7d  %-40s %-14s %s' % (size, name, section, subsystem))
+
+
+def main(argv):
+    if len(argv) == 2:
+        report(argv[1])
+    elif len(argv) == 4:
+        report(argv[1], argv[2], argv[3])
+    else:
+        sys.exit(__doc__ or 'usage: memory_report.py <mapfile> [<elf> <nm>]')
+
+
+if __name__ == '__main__':
+    main(sys.argv)
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+#
+# ITCM / DTCM placement profile for the STM32F7 and STM32H7 builds.
+#
+# The profile lists the functions and variables that the linker moves into
+# the tightly coupled memories, in addition to the FAST_CODE / FAST_RAM
+# annotations. It is only used when the build asks for it with TCM_PROFILE,
+# the linker scripts in src/link are left as they are. Each line is
+# "<kind> <symbol>", kind is one of
+#
+#   code   function, placed in .tcm_code (ITCM)
+#   data   initialised variable, placed in .fastram_data (DTCM)
+#   bss    zero initialised variable, placed in .fastram_bss (DTCM)
+#
+# Usage:
+#   tcm_profile.py ld <profile> <script> <linkerdir> <output>
+#       write a copy of the linker script with its INCLUDEs from linkerdir
+#       inlined, the TCM sections moved ahead of .text and .data so that
+#       their patterns match first, and the profile patterns added to them
+#   tcm_profile.py report <mapfile>
+#       print how full ITCM and DTCM are, and the largest placed functions
+#   tcm_profile.py generate <capture.csv> <mapfile> [budget]
+#       write a code profile from a DWT cycle capture ("symbol,cycles" per line),
+#       hottest functions first until the ITCM budget in bytes is used up
+#
+
+import re
+import sys
+
+KINDS = {
+    'code': ('.text', '*(.tcm_code*)'),
+    'data': ('.data', '*(.fastram_data*)'),
+    'bss':  ('.bss',  '*(SORT_BY_ALIGNMENT(.fastram_bss*))'),
+}
+
+TCM_SECTIONS = {
+    '.tcm_code': 'ITCM_RAM',
+    '.fastram_data': 'DTCM_RAM',
+    '.fastram_bss': 'DTCM_RAM',
+}
+
+DEFAULT_BUDGET = 4096
+
+
+def read_profile(path):
+    entries = {kind: [] for kind in KINDS}
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if len(fields) != 2 or fields[0] not in KINDS:
+                sys.exit('%s:%d: expected "<code|data|bss> <symbol>"' % (path, number))
+            entries[fields[0]].append(fields[1])
+    return entries
+
+
+def read_script(path, linker_dir):
+    lines = []
+    with open(path) as f:
+        for line in f.read().splitlines():
+            match = re.match(r'^INCLUDE\s+"(\S+)"', line)
+            if match:
+                lines += read_script('%s/%s' % (linker_dir, match.group(1)), linker_dir)
+            else:
+                lines.append(line)
+    return lines
+
+
+def find_line(path, lines, start, pattern):
+    for i in range(start, len(lines)):
+        if re.match(pattern, lines[i]):
+            return i
+    sys.exit('%s: no line matching "%s"' % (path, pattern))
+
+
+def move_block(path, lines, first, within, last, before):
+    """Move the lines from the one matching first up to the one matching last after within, ahead of the line matching before."""
+    start = find_line(path, lines, 0, first)
+    end = find_line(path, lines, find_line(path, lines, start, within), last) + 1
+    block = lines[start:end] + ['']
+    del lines[start:end]
+    at = find_line(path, lines, 0, before)
+    lines[at:at] = block
+
+
+def write_linker_script(profile, script, linker_dir, output):
+    entries = read_profile(profile)
+    lines = read_script(script, linker_dir)
+
+    move_block(script, lines, r'^\s*/\* Critical program code goes into ITCM RAM', r'^\s*\.tcm_code', r'^\s*\} >ITCM_RAM',
+               r'^\s*/\* The program code and other data goes into')
+    move_block(script, lines, r'^\s*/\* used during startup to initialized fastram_data', r'^\s*\.fastram_bss', r'^\s*\} >FASTRAM\s*$',
+               r'^\s*/\* used by the startup to initialize data')
+
+    for kind, (prefix, anchor) in KINDS.items():
+        at = find_line(script, lines, 0, r'^\s*' + re.escape(anchor)) + 1
+        # LTO and the optimiser add suffixes such as .lto_priv.0 or .constprop.0
+        lines[at:at] = ['    *(%s.%s %s.%s.*)' % (prefix, symbol, prefix, symbol) for symbol in entries[kind]]
+
+    with open(output, 'w') as f:
+        f.write('/* Generated from %s and %s, do not edit */\n' % (script, profile))
+        f.write('\n'.join(lines) + '\n')
+
+
+def read_map(path):
+    """Return the memory regions, the output section sizes and the input sections of the map file."""
+    regions = {}
+    outputs = {}
+    inputs = []
+
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    i = 0
+    while i < len(lines) and not lines[i].startswith('Memory Configuration'):
+        i += 1
+    while i < len(lines) and not lines[i].startswith('Linker script and memory map'):
+        match = re.match(r'^(\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)', lines[i])
+        if match:
+            regions[match.group(1)] = int(match.group(3), 16)
+        i += 1
+
+    section = None
+    pending = None
+    for line in lines[i:]:
+        match = re.match(r'^(\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+))?', line)
+        if match:
+            section = match.group(1)
+            if match.group(3):
+                outputs[section] = int(match.group(3), 16)
+            else:
+                pending = section
+            continue
+
+        if pending:
+            match = re.match(r'^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)', line)
+            if match:
+                outputs[pending] = int(match.group(2), 16)
+            pending = None
+            continue
+
+        match = re.match(r'^ (\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+))?', line)
+        if match:
+            inputs.append([section, match.group(1), int(match.group(3), 16) if match.group(3) else None])
+            continue
+
+        match = re.match(r'^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+\S', line)
+        if match and inputs and inputs[-1][2] is None:
+            inputs[-1][2] = int(match.group(2), 16)
+
+    return regions, outputs, [(s, name, size) for s, name, size in inputs if size]
+
+
+def symbol_of(name):
+    # .text.servoMixer.lto_priv.0 -> servoMixer
+    parts = name.split('.')
+    return parts[2] if len(parts) > 2 else name
+
+
+def report(mapfile):
+    regions, outputs, inputs = read_map(mapfile)
+
+    used = {}
+    for section, region in TCM_SECTIONS.items():
+        used[region] = used.get(region, 0) + outputs.get(section, 0)
+
+    for region, size in sorted(used.items()):
+        length = regions.get(region)
+        if length:
+            print('%-10s %7d of %7d bytes (%d%%)' % (region, size, length, 100 * size // length))
+        else:
+            print('%-10s %7d bytes' % (region, size))
+
+    for section in TCM_SECTIONS:
+        print('\n%s:' % section)
+        placed = sorted((size, name) for s, name, size in inputs if s == section)
+        for size, name in reversed(placed[-20:]):
+            print('  %6d  %s' % (size, name))
+
+
+def generate(capture, mapfile, budget):
+    _, _, inputs = read_map(mapfile)
+
+    sizes = {}
+    for section, name, size in inputs:
+        if name.startswith('.text.') or section == '.tcm_code':
+            symbol = symbol_of(name)
+            sizes[symbol] = sizes.get(symbol, 0) + size
+
+    samples = []
+    with open(capture) as f:
+        for line in f:
+            fields = line.strip().split(',')
+            if len(fields) >= 2 and fields[1].strip().isdigit():
+                samples.append((int(fields[1]), fields[0].strip()))
+
+    print('# Generated by tcm_profile.py from %s, ITCM budget %d bytes' % (capture, budget))
+    for cycles, symbol in sorted(samples, reverse=True):
+        size = sizes.get(symbol)
+        if not size or size > budget:
+            continue
+        budget -= size
+        print('code %-40s # %d cycles, %d bytes' % (symbol, cycles, size))
+
+
+def main(argv):
+    if len(argv) == 6 and argv[1] == 'ld':
+        write_linker_script(argv[2], argv[3], argv[4], argv[5])
+    elif len(argv) == 3 and argv[1] == 'report':
+        report(argv[2])
+    elif len(argv) in (4, 5) and argv[1] == 'generate':
+        generate(argv[2], argv[3], int(argv[4]) if len(argv) == 5 else DEFAULT_BUDGET)
+    else:
+        sys.exit(__doc__ or 'usage: tcm_profile.py ld|report|generate ...')
+
+
+if __name__ == '__main__':
+    main(sys.argv)